@@ -0,0 +1,352 @@
+// 多设备连接扩展性基准测试
+// 本进程内启动 N 台模拟点胶机（TCP 服务端，在单独的设备线程中运行），上位机对每台建立一个 TcpCommunication，
+// N 从 1 翻倍到 --max-devices。每一轮分别测量两种线程模型：
+//   dedicated  每个连接一个专用网络线程，定时器为各自的 QTimer
+//   group      所有连接分配到 --io-threads 个 I/O 线程（ConnectionGroup），定时器挂在每线程一个的时间轮上
+// 输出每轮的接收帧率、心跳往返时间 P50/P99、进程 CPU 占用和线程数。未能全部连上时返回非零。
+//
+// 参数：--max-devices=N 最大设备数（默认 64）  --io-threads=N 连接组线程数（默认 4）
+//       --seconds=N 每轮测量时长（默认 5）  --rate=N 每台设备的传感器帧率（默认 200）
+//       --heartbeat-ms=N 心跳间隔（默认 100）  --base-port=N 模拟设备起始端口（默认 26000）
+//       --mode=dedicated|group|both（默认 both）  --json=<路径> 把结果写成JSON
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <vector>
+#include "communication/tcpcommunication.h"
+#include "communication/connectiongroup.h"
+#include "utils/hdrhistogram.h"
+#include "simulateddevice.h"
+#include "simulatorlinks.h"
+
+namespace {
+
+constexpr int DEFAULT_MAX_DEVICES = 64;
+constexpr int DEFAULT_IO_THREADS = 4;
+constexpr int DEFAULT_SECONDS = 5;
+constexpr double DEFAULT_SENSOR_RATE = 200.0;
+constexpr int DEFAULT_HEARTBEAT_MS = 100;
+constexpr int DEFAULT_BASE_PORT = 26000;
+constexpr int CONNECT_TIMEOUT_MS = 10000;
+constexpr int WARMUP_MS = 500;
+
+QString optionValue(const QString& argument, const QString& name)
+{
+    const QString prefix = "--" + name + "=";
+    return argument.startsWith(prefix) ? argument.mid(prefix.size()) : QString();
+}
+
+// 进程所有线程的 CPU 时间
+qint64 processCpuNs()
+{
+    return static_cast<qint64>(std::clock()) * (1000000000LL / CLOCKS_PER_SEC);
+}
+
+int processThreadCount()
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const QByteArray& line : status.readAll().split('\n')) {
+            if (line.startsWith("Threads:")) {
+                return line.mid(8).trimmed().toInt();
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+struct BenchOptions {
+    int maxDevices = DEFAULT_MAX_DEVICES;
+    int ioThreads = DEFAULT_IO_THREADS;
+    int seconds = DEFAULT_SECONDS;
+    double sensorRate = DEFAULT_SENSOR_RATE;
+    int heartbeatMs = DEFAULT_HEARTBEAT_MS;
+    int basePort = DEFAULT_BASE_PORT;
+    bool dedicated = true;
+    bool group = true;
+};
+
+struct RoundResult {
+    QString mode;
+    int devices = 0;
+    int connected = 0;
+    int threads = 0;
+    double framesPerSecond = 0.0;
+    double expectedFramesPerSecond = 0.0;
+    double cpuPercent = 0.0;        // 单核百分比
+    HdrHistogram heartbeatRtt;
+    qint64 heartbeatTimeouts = 0;
+};
+
+// 模拟设备全部在一个线程中运行，不与上位机的线程争用事件循环
+class DeviceFarm
+{
+public:
+    explicit DeviceFarm(const BenchOptions& options) : m_options(options)
+    {
+        m_thread.setObjectName("SimulatedDevices");
+        m_thread.start();
+        m_context->moveToThread(&m_thread);
+    }
+
+    ~DeviceFarm()
+    {
+        stop();
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    bool start(int count, QString* error)
+    {
+        bool ok = true;
+        QMetaObject::invokeMethod(m_context.get(), [this, count, error, &ok]() {
+            SimulatorTrafficConfig traffic;
+            traffic.sensorRateHz = m_options.sensorRate;
+            traffic.motionRateHz = 0.0;
+            traffic.glueRateHz = 0.0;
+            traffic.heartbeatRateHz = 0.0;
+            for (int i = 0; i < count && ok; ++i) {
+                auto* device = new SimulatedDevice(i + 1, traffic, quint64(i + 1));
+                auto* link = new TcpServerLink(device, ChecksumType::CRC16_MODBUS, "127.0.0.1",
+                                               quint16(m_options.basePort + i), device);
+                ok = link->open(error);
+                device->start();
+                m_devices.push_back(device);
+            }
+        }, Qt::BlockingQueuedConnection);
+        return ok;
+    }
+
+    void stop()
+    {
+        QMetaObject::invokeMethod(m_context.get(), [this]() {
+            for (SimulatedDevice* device : m_devices) {
+                device->stop();
+                delete device;
+            }
+            m_devices.clear();
+        }, Qt::BlockingQueuedConnection);
+    }
+
+private:
+    const BenchOptions& m_options;
+    QThread m_thread;
+    std::unique_ptr<QObject> m_context = std::make_unique<QObject>();
+    std::vector<SimulatedDevice*> m_devices;
+};
+
+RoundResult runRound(const BenchOptions& options, DeviceFarm& farm, int devices, bool useGroup)
+{
+    RoundResult result;
+    result.mode = useGroup ? "group" : "dedicated";
+    result.devices = devices;
+    result.expectedFramesPerSecond = options.sensorRate * devices;
+
+    QString error;
+    if (!farm.start(devices, &error)) {
+        QTextStream(stderr) << "模拟设备启动失败: " << error << Qt::endl;
+        farm.stop();
+        return result;
+    }
+
+    std::unique_ptr<ConnectionGroup> group;
+    if (useGroup) {
+        group = std::make_unique<ConnectionGroup>(options.ioThreads);
+        group->start();
+    }
+
+    std::atomic<qint64> frames{0};
+    std::atomic<int> connected{0};
+    std::atomic<qint64> timeouts{0};
+    std::atomic<bool> measuring{false};
+
+    std::vector<std::unique_ptr<TcpCommunication>> links;
+    for (int i = 0; i < devices; ++i) {
+        auto link = std::make_unique<TcpCommunication>();
+        const bool placed = useGroup ? group->assign(link.get()) : link->setDedicatedNetworkThread(true);
+        if (!placed) {
+            continue;
+        }
+
+        // 回调在连接所在线程直接执行，只做计数
+        QObject::connect(link.get(), &TcpCommunication::framesReceived, link.get(),
+                         [&frames, &measuring](const FrameBatch& batch) {
+                             if (measuring.load(std::memory_order_relaxed)) {
+                                 frames.fetch_add(batch.size(), std::memory_order_relaxed);
+                             }
+                         }, Qt::DirectConnection);
+        QObject::connect(link.get(), &ICommunication::connected, link.get(),
+                         [&connected]() { connected.fetch_add(1); }, Qt::DirectConnection);
+        QObject::connect(link.get(), &ICommunication::heartbeatTimeout, link.get(),
+                         [&timeouts]() { timeouts.fetch_add(1); }, Qt::DirectConnection);
+
+        TcpConfig config;
+        config.name = QString("Device-%1").arg(i + 1, 2, 10, QChar('0'));
+        config.hostAddress = "127.0.0.1";
+        config.port = quint16(options.basePort + i);
+        config.autoReconnect = false;
+        config.enableHeartbeat = true;
+        config.heartbeatInterval = options.heartbeatMs;
+        config.compressionEnabled = false;
+        link->connect(config);
+        links.push_back(std::move(link));
+    }
+
+    QElapsedTimer wait;
+    wait.start();
+    while (connected.load() < devices && wait.elapsed() < CONNECT_TIMEOUT_MS) {
+        QThread::msleep(10);
+    }
+    result.connected = connected.load();
+    QThread::msleep(WARMUP_MS);
+
+    // 心跳往返时间取各连接直方图在测量区间内的增量
+    std::vector<HdrHistogram> rttBefore;
+    for (const auto& link : links) {
+        rttBefore.push_back(link->getHeartbeatHistogram());
+    }
+    const qint64 cpuStart = processCpuNs();
+    QElapsedTimer clock;
+    clock.start();
+    measuring.store(true);
+    QThread::msleep(static_cast<unsigned long>(options.seconds) * 1000);
+    measuring.store(false);
+    const qint64 wallNs = clock.nsecsElapsed();
+    const qint64 cpuNs = processCpuNs() - cpuStart;
+
+    result.threads = processThreadCount();
+    result.framesPerSecond = frames.load() * 1e9 / qMax<qint64>(1, wallNs);
+    result.cpuPercent = 100.0 * cpuNs / qMax<qint64>(1, wallNs);
+    result.heartbeatTimeouts = timeouts.load();
+    for (size_t i = 0; i < links.size(); ++i) {
+        result.heartbeatRtt.merge(links[i]->getHeartbeatHistogram().since(rttBefore[i]));
+    }
+
+    // 先断开并离开 I/O 线程，再停模拟设备
+    for (auto& link : links) {
+        link->disconnect();
+    }
+    links.clear();
+    if (group) {
+        group->stop();
+    }
+    farm.stop();
+    return result;
+}
+
+QJsonObject toJson(const RoundResult& result)
+{
+    QJsonObject object;
+    object["mode"] = result.mode;
+    object["devices"] = result.devices;
+    object["connected"] = result.connected;
+    object["threads"] = result.threads;
+    object["frames_per_second"] = result.framesPerSecond;
+    object["expected_frames_per_second"] = result.expectedFramesPerSecond;
+    object["cpu_percent"] = result.cpuPercent;
+    object["heartbeat_samples"] = result.heartbeatRtt.count();
+    object["heartbeat_p50_ns"] = result.heartbeatRtt.percentileNs(50.0);
+    object["heartbeat_p99_ns"] = result.heartbeatRtt.percentileNs(99.0);
+    object["heartbeat_max_ns"] = result.heartbeatRtt.maxNs();
+    object["heartbeat_timeouts"] = result.heartbeatTimeouts;
+    return object;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    BenchOptions options;
+    QString jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        QString value;
+        if (!(value = optionValue(argument, "max-devices")).isEmpty()) {
+            options.maxDevices = qBound(1, value.toInt(), 1024);
+        } else if (!(value = optionValue(argument, "io-threads")).isEmpty()) {
+            options.ioThreads = qMax(1, value.toInt());
+        } else if (!(value = optionValue(argument, "seconds")).isEmpty()) {
+            options.seconds = qMax(1, value.toInt());
+        } else if (!(value = optionValue(argument, "rate")).isEmpty()) {
+            options.sensorRate = qMax(0.0, value.toDouble());
+        } else if (!(value = optionValue(argument, "heartbeat-ms")).isEmpty()) {
+            options.heartbeatMs = qMax(10, value.toInt());
+        } else if (!(value = optionValue(argument, "base-port")).isEmpty()) {
+            options.basePort = qBound(1, value.toInt(), 65535 - options.maxDevices);
+        } else if (!(value = optionValue(argument, "mode")).isEmpty()) {
+            options.dedicated = value != "group";
+            options.group = value != "dedicated";
+        } else if (!(value = optionValue(argument, "json")).isEmpty()) {
+            jsonPath = value;
+        }
+    }
+
+    DeviceFarm farm(options);
+
+    out << QString("连接扩展性基准测试 - 每台 %1 帧/秒，心跳 %2 ms，每轮 %3 秒，连接组 %4 个I/O线程")
+               .arg(options.sensorRate).arg(options.heartbeatMs).arg(options.seconds).arg(options.ioThreads)
+        << Qt::endl;
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+               .arg("模式", -10).arg("设备", 5).arg("线程", 5).arg("帧/秒", 10).arg("期望", 10)
+               .arg("CPU%", 7).arg("心跳P50", 10).arg("心跳P99", 10)
+        << Qt::endl;
+
+    QJsonArray rounds;
+    int failures = 0;
+    for (int devices = 1; devices <= options.maxDevices; devices *= 2) {
+        for (bool useGroup : {false, true}) {
+            if ((useGroup && !options.group) || (!useGroup && !options.dedicated)) {
+                continue;
+            }
+            const RoundResult result = runRound(options, farm, devices, useGroup);
+            if (result.connected < devices) {
+                ++failures;
+            }
+            out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                       .arg(result.mode, -10).arg(result.devices, 5).arg(result.threads, 5)
+                       .arg(result.framesPerSecond, 10, 'f', 0).arg(result.expectedFramesPerSecond, 10, 'f', 0)
+                       .arg(result.cpuPercent, 7, 'f', 1)
+                       .arg(HdrHistogram::formatNs(result.heartbeatRtt.percentileNs(50.0)), 10)
+                       .arg(HdrHistogram::formatNs(result.heartbeatRtt.percentileNs(99.0)), 10);
+            if (result.connected < devices) {
+                out << QString("  (仅 %1/%2 连接成功)").arg(result.connected).arg(devices);
+            }
+            if (result.heartbeatTimeouts > 0) {
+                out << QString("  (心跳超时 %1 次)").arg(result.heartbeatTimeouts);
+            }
+            out << Qt::endl;
+            rounds.append(toJson(result));
+        }
+    }
+
+    if (!jsonPath.isEmpty()) {
+        QJsonObject report;
+        report["sensor_rate_hz"] = options.sensorRate;
+        report["heartbeat_ms"] = options.heartbeatMs;
+        report["seconds"] = options.seconds;
+        report["io_threads"] = options.ioThreads;
+        report["rounds"] = rounds;
+        QFile file(jsonPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "无法写入 " << jsonPath << Qt::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    return failures == 0 ? 0 : 1;
+}
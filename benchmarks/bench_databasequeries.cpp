@@ -0,0 +1,449 @@
+// 报警和生产历史查询基准测试
+// 按真实表结构写入千万级报警记录和相应规模的生产数据，检查各历史查询的执行计划
+// 没有全表扫描和临时排序，并测量查询耗时的中位数和 P95；有计划退化或超出预算时返回非零。
+//
+// 参数：--rows=N 报警记录数（默认 10000000，批次为 N/100、质量数据为 N/10）
+//       --db=DIR 数据库目录（默认临时目录）  --budget-ms=N P95 预算（默认 50）
+//       --keep 保留数据库文件，再次运行时跳过写入
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include "core/databaseschema.h"
+
+namespace {
+
+constexpr qint64 DEFAULT_ROWS = 10000000;
+constexpr int DEFAULT_BUDGET_MS = 50;
+constexpr int SEED_TRANSACTION_ROWS = 100000;   // 每个写入事务的行数
+constexpr int ITERATIONS = 50;                  // 每个查询的测量次数
+constexpr int PAGE_WALK = 20;                   // 连续翻页的页数
+constexpr int HISTORY_DAYS = 180;               // 数据覆盖的天数
+constexpr int DEVICE_COUNT = 32;
+
+const QStringList PRODUCT_TYPES = {"A型", "B型", "C型", "D型", "E型", "F型", "G型", "H型"};
+const QDateTime HISTORY_END = QDateTime(QDate(2024, 1, 1), QTime(0, 0));
+const QDateTime HISTORY_START = HISTORY_END.addDays(-HISTORY_DAYS);
+
+QString optionValue(const QString& argument, const QString& name)
+{
+    const QString prefix = "--" + name + "=";
+    return argument.startsWith(prefix) ? argument.mid(prefix.size()) : QString();
+}
+
+QString deviceName(int index)
+{
+    return QString("Device-%1").arg(index, 2, 10, QChar('0'));
+}
+
+// 时间在整个范围内均匀递增，与现场按时间顺序写入一致
+QDateTime timeAt(qint64 row, qint64 rows)
+{
+    const qint64 spanMs = HISTORY_START.msecsTo(HISTORY_END);
+    return HISTORY_START.addMSecs(spanMs * row / qMax<qint64>(1, rows));
+}
+
+QList<SchemaMigration> migrationsUpTo(const QList<SchemaMigration>& migrations, int version)
+{
+    QList<SchemaMigration> result;
+    for (const SchemaMigration& migration : migrations) {
+        if (migration.version <= version) {
+            result.append(migration);
+        }
+    }
+    return result;
+}
+
+bool seed(QSqlDatabase& database, const QString& sql, qint64 rows,
+          const std::function<void(QSqlQuery&, qint64)>& bind, QTextStream& out)
+{
+    QSqlQuery query(database);
+    if (!query.prepare(sql)) {
+        out << "准备写入语句失败: " << query.lastError().text() << Qt::endl;
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 row = 0; row < rows; ++row) {
+        if (row % SEED_TRANSACTION_ROWS == 0) {
+            if (row > 0) database.commit();
+            database.transaction();
+        }
+        bind(query, row);
+        if (!query.exec()) {
+            out << "写入失败: " << query.lastError().text() << Qt::endl;
+            database.rollback();
+            return false;
+        }
+    }
+    database.commit();
+
+    const double seconds = qMax<qint64>(timer.elapsed(), 1) / 1000.0;
+    out << QString("  写入 %1 行，%2 s，%3 行/s").arg(rows).arg(seconds, 0, 'f', 1).arg(rows / seconds, 0, 'f', 0) << Qt::endl;
+    return true;
+}
+
+// 先建表写入数据，再执行后续迁移，同时测量在已有大表上建组合索引的耗时
+bool prepareDatabase(QSqlDatabase& database, const QList<SchemaMigration>& migrations, const QString& countTable,
+                     const std::function<bool()>& seedTables, QTextStream& out)
+{
+    QString error;
+    if (!DatabaseSchema::migrate(database, migrationsUpTo(migrations, 1), &error)) {
+        out << error << Qt::endl;
+        return false;
+    }
+
+    QSqlQuery query(database);
+    query.exec("SELECT COUNT(*) FROM " + countTable);
+    const bool seeded = query.next() && query.value(0).toLongLong() > 0;
+    if (!seeded && !seedTables()) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const int before = DatabaseSchema::version(database);
+    if (!DatabaseSchema::migrate(database, migrations, &error)) {
+        out << error << Qt::endl;
+        return false;
+    }
+    if (DatabaseSchema::version(database) != before) {
+        out << QString("  结构迁移 %1 -> %2，%3 ms").arg(before).arg(DatabaseSchema::version(database)).arg(timer.elapsed())
+            << Qt::endl;
+    }
+    return true;
+}
+
+class QueryBenchmark
+{
+public:
+    QueryBenchmark(QSqlDatabase& database, QTextStream& out, double budgetMs)
+        : m_database(database), m_out(out), m_budgetMs(budgetMs), m_failures(0) {}
+
+    // parameters 每次测量生成一组参数；页查询只允许按索引顺序读取，不能有临时排序
+    void run(const QString& name, const QString& sql, const std::function<QVariantList(int)>& parameters,
+             bool allowSort = false, double budgetMs = 0)
+    {
+        const QStringList plan = DatabaseSchema::queryPlan(m_database, sql, parameters(0));
+        bool regressed = DatabaseSchema::hasFullScan(plan);
+        if (!allowSort && plan.join('\n').contains("TEMP B-TREE")) {
+            regressed = true;
+        }
+
+        QList<double> samples;
+        qint64 rows = 0;
+        QSqlQuery query(m_database);
+        query.setForwardOnly(true);
+        query.prepare(sql);
+        for (int i = 0; i < ITERATIONS; ++i) {
+            const QVariantList values = parameters(i);
+            QElapsedTimer timer;
+            timer.start();
+            for (const QVariant& value : values) {
+                query.addBindValue(value);
+            }
+            query.exec();
+            while (query.next()) {
+                ++rows;
+            }
+            samples.append(timer.nsecsElapsed() / 1e6);
+        }
+        report(name, plan, samples, rows / ITERATIONS, regressed, budgetMs > 0 ? budgetMs : m_budgetMs);
+    }
+
+    // 从第一页开始按游标连续翻页，测量每一页的耗时
+    void runPageWalk(const QString& name, HistoryPageQuery page)
+    {
+        QList<double> samples;
+        qint64 rows = 0;
+        QStringList plan;
+        QSqlQuery query(m_database);
+        query.setForwardOnly(true);
+        for (int i = 0; i < PAGE_WALK; ++i) {
+            const QString sql = DatabaseSchema::alarmHistoryPageSql(page);
+            const QVariantList values = DatabaseSchema::alarmHistoryPageValues(page);
+            if (i == 1) {
+                plan = DatabaseSchema::queryPlan(m_database, sql, values);
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            query.prepare(sql);
+            for (const QVariant& value : values) {
+                query.addBindValue(value);
+            }
+            query.exec();
+            int pageRows = 0;
+            while (query.next()) {
+                page.cursorTime = query.value("timestamp").toDateTime();
+                page.cursorId = query.value("alarm_id").toLongLong();
+                ++pageRows;
+            }
+            samples.append(timer.nsecsElapsed() / 1e6);
+            rows += pageRows;
+            if (pageRows < page.pageSize) break;
+        }
+        const bool regressed = DatabaseSchema::hasFullScan(plan) || plan.join('\n').contains("TEMP B-TREE");
+        report(name, plan, samples, rows / qMax<qsizetype>(1, samples.size()), regressed, m_budgetMs);
+    }
+
+    int failures() const { return m_failures; }
+
+private:
+    void report(const QString& name, const QStringList& plan, QList<double> samples, qint64 rowsPerQuery,
+                bool regressed, double budgetMs)
+    {
+        std::sort(samples.begin(), samples.end());
+        const double median = samples[samples.size() / 2];
+        const double p95 = samples[qMin<qsizetype>(samples.size() - 1, samples.size() * 95 / 100)];
+        const bool overBudget = p95 > budgetMs;
+
+        QString status = "OK";
+        if (regressed) status = "计划退化";
+        else if (overBudget) status = "超出预算";
+        if (regressed || overBudget) ++m_failures;
+
+        m_out << QString("  %1 中位数 %2 ms  P95 %3 ms  (%4 行/次, 预算 %5 ms)  %6")
+                 .arg(name, -28)
+                 .arg(median, 8, 'f', 2)
+                 .arg(p95, 8, 'f', 2)
+                 .arg(rowsPerQuery)
+                 .arg(budgetMs, 0, 'f', 0)
+                 .arg(status)
+              << Qt::endl;
+        for (const QString& step : plan) {
+            m_out << "      " << step << Qt::endl;
+        }
+    }
+
+    QSqlDatabase& m_database;
+    QTextStream& m_out;
+    double m_budgetMs;
+    int m_failures;
+};
+
+QDateTime randomWindowStart(int days)
+{
+    const qint64 spanMs = HISTORY_START.msecsTo(HISTORY_END.addDays(-days));
+    return HISTORY_START.addMSecs(QRandomGenerator::global()->bounded(qMax<qint64>(1, spanMs)));
+}
+
+int benchmarkAlarms(const QString& directory, qint64 rows, double budgetMs, QTextStream& out)
+{
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "AlarmBench");
+    database.setDatabaseName(directory + "/alarm_bench.db");
+    if (!database.open()) {
+        out << "无法打开数据库: " << database.lastError().text() << Qt::endl;
+        return 1;
+    }
+    QSqlQuery(database).exec("PRAGMA journal_mode = WAL");
+    QSqlQuery(database).exec("PRAGMA synchronous = OFF");
+
+    out << "报警数据库 (" << rows << " 行)" << Qt::endl;
+    const bool prepared = prepareDatabase(database, DatabaseSchema::alarmMigrations(), "alarm_records", [&]() {
+        return seed(database, R"(
+            INSERT INTO alarm_records (alarm_type, alarm_level, alarm_status, alarm_code, alarm_message,
+                                       device_name, parameter_name, parameter_value, threshold_value, timestamp)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        )", rows, [rows](QSqlQuery& query, qint64 row) {
+            QRandomGenerator* random = QRandomGenerator::global();
+            const int type = random->bounded(10);
+            query.addBindValue(type);
+            query.addBindValue(random->bounded(5));
+            query.addBindValue(random->bounded(4));
+            query.addBindValue(QString("ALM-%1").arg(type * 100 + random->bounded(100)));
+            query.addBindValue(QStringLiteral("参数超出阈值"));
+            query.addBindValue(deviceName(random->bounded(DEVICE_COUNT)));
+            query.addBindValue(QStringLiteral("temperature"));
+            query.addBindValue(random->bounded(1000) / 10.0);
+            query.addBindValue(80.0);
+            query.addBindValue(timeAt(row, rows));
+        }, out);
+    }, out);
+    if (!prepared) {
+        return 1;
+    }
+
+    QueryBenchmark benchmark(database, out, budgetMs);
+    const auto pageValues = [](int days, int type, int level, bool device) {
+        return [=](int) {
+            HistoryPageQuery page;
+            page.startTime = randomWindowStart(days);
+            page.endTime = page.startTime.addDays(days);
+            page.alarmType = type;
+            page.alarmLevel = level;
+            if (device) page.deviceName = deviceName(QRandomGenerator::global()->bounded(DEVICE_COUNT));
+            return DatabaseSchema::alarmHistoryPageValues(page);
+        };
+    };
+    const auto pageSql = [](int type, int level, bool device) {
+        HistoryPageQuery page;
+        page.alarmType = type;
+        page.alarmLevel = level;
+        if (device) page.deviceName = deviceName(0);
+        return DatabaseSchema::alarmHistoryPageSql(page);
+    };
+
+    benchmark.run("历史首页 (7天)", pageSql(-1, -1, false), pageValues(7, -1, -1, false));
+    benchmark.run("历史首页 按级别 (30天)", pageSql(-1, 3, false), pageValues(30, -1, 3, false));
+    benchmark.run("历史首页 按类型 (30天)", pageSql(2, -1, false), pageValues(30, 2, -1, false));
+    benchmark.run("历史首页 按设备 (30天)", pageSql(-1, -1, true), pageValues(30, -1, -1, true));
+
+    HistoryPageQuery walk;
+    walk.startTime = HISTORY_START;
+    walk.endTime = HISTORY_END;
+    walk.pageSize = 500;
+    benchmark.runPageWalk(QString("连续翻页 %1 页").arg(PAGE_WALK), walk);
+
+    HistoryPageQuery count;
+    count.alarmLevel = 3;
+    benchmark.run("记录数 按级别 (7天)", DatabaseSchema::alarmHistoryCountSql(count), [](int) {
+        HistoryPageQuery page;
+        page.alarmLevel = 3;
+        page.startTime = randomWindowStart(7);
+        page.endTime = page.startTime.addDays(7);
+        return DatabaseSchema::alarmHistoryCountValues(page);
+    });
+
+    // 全量统计读取整个索引而不是表，单独给出更宽的预算
+    benchmark.run("按级别统计 (全部)", "SELECT alarm_level, COUNT(*) FROM alarm_records GROUP BY alarm_level",
+                  [](int) { return QVariantList(); }, true, budgetMs * 100);
+    benchmark.run("激活报警", "SELECT * FROM alarm_records WHERE alarm_status IN (0, 1, 3) ORDER BY timestamp DESC LIMIT 500",
+                  [](int) { return QVariantList(); }, true, budgetMs * 10);
+
+    const int failures = benchmark.failures();
+    database.close();
+    return failures;
+}
+
+int benchmarkProduction(const QString& directory, qint64 rows, double budgetMs, QTextStream& out)
+{
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "ProductionBench");
+    database.setDatabaseName(directory + "/production_bench.db");
+    if (!database.open()) {
+        out << "无法打开数据库: " << database.lastError().text() << Qt::endl;
+        return 1;
+    }
+    QSqlQuery(database).exec("PRAGMA journal_mode = WAL");
+    QSqlQuery(database).exec("PRAGMA synchronous = OFF");
+
+    const qint64 batches = qMax<qint64>(1, rows / 100);
+    const qint64 qualityRows = qMax<qint64>(1, rows / 10);
+    out << "生产数据库 (" << batches << " 个批次, " << qualityRows << " 条质量数据)" << Qt::endl;
+
+    const bool prepared = prepareDatabase(database, DatabaseSchema::productionMigrations(), "production_batches", [&]() {
+        return seed(database, R"(
+            INSERT INTO production_batches (batch_name, product_type, start_time, end_time,
+                                            total_count, qualified_count, defect_count, quality_rate)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+        )", batches, [batches](QSqlQuery& query, qint64 row) {
+            const QDateTime start = timeAt(row, batches);
+            query.addBindValue(QString("Batch-%1").arg(row));
+            query.addBindValue(PRODUCT_TYPES[QRandomGenerator::global()->bounded(PRODUCT_TYPES.size())]);
+            query.addBindValue(start);
+            query.addBindValue(start.addSecs(3600));
+            query.addBindValue(100);
+            query.addBindValue(98);
+            query.addBindValue(2);
+            query.addBindValue(98.0);
+        }, out) && seed(database, R"(
+            INSERT INTO quality_data (batch_id, timestamp, position_x, position_y, position_z, glue_volume,
+                                      pressure, temperature, speed, quality_level, is_qualified)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        )", qualityRows, [batches, qualityRows](QSqlQuery& query, qint64 row) {
+            query.addBindValue(row * batches / qualityRows + 1);
+            query.addBindValue(timeAt(row, qualityRows));
+            for (int i = 0; i < 7; ++i) {
+                query.addBindValue(QRandomGenerator::global()->bounded(1000) / 10.0);
+            }
+            query.addBindValue(QStringLiteral("A"));
+            query.addBindValue(true);
+        }, out);
+    }, out);
+    if (!prepared) {
+        return 1;
+    }
+
+    QueryBenchmark benchmark(database, out, budgetMs);
+    benchmark.run("批次 按时间 (7天)",
+                  "SELECT * FROM production_batches WHERE start_time BETWEEN ? AND ? ORDER BY start_time DESC, batch_id DESC",
+                  [](int) {
+        const QDateTime start = randomWindowStart(7);
+        return QVariantList{start, start.addDays(7)};
+    });
+    benchmark.run("批次 按产品类型 (30天)",
+                  "SELECT * FROM production_batches WHERE product_type = ? AND start_time BETWEEN ? AND ? "
+                  "ORDER BY start_time DESC, batch_id DESC",
+                  [](int) {
+        const QDateTime start = randomWindowStart(30);
+        return QVariantList{PRODUCT_TYPES[QRandomGenerator::global()->bounded(PRODUCT_TYPES.size())],
+                            start, start.addDays(30)};
+    });
+    benchmark.run("质量数据 按批次", "SELECT * FROM quality_data WHERE batch_id = ? ORDER BY timestamp",
+                  [batches](int) { return QVariantList{QRandomGenerator::global()->bounded(batches) + 1}; });
+
+    const int failures = benchmark.failures();
+    database.close();
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    qint64 rows = DEFAULT_ROWS;
+    double budgetMs = DEFAULT_BUDGET_MS;
+    QString directory;
+    bool keep = false;
+    for (int i = 1; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        QString value;
+        if (!(value = optionValue(argument, "rows")).isEmpty()) {
+            rows = qMax<qint64>(1, value.toLongLong());
+        } else if (!(value = optionValue(argument, "db")).isEmpty()) {
+            directory = value;
+        } else if (!(value = optionValue(argument, "budget-ms")).isEmpty()) {
+            budgetMs = qMax(1.0, value.toDouble());
+        } else if (argument == "--keep") {
+            keep = true;
+        }
+    }
+
+    QTemporaryDir temporary;
+    if (directory.isEmpty()) {
+        directory = temporary.path();
+        keep = false;
+    }
+    QDir().mkpath(directory);
+
+    out << "历史查询基准测试 - 数据库目录: " << directory << Qt::endl;
+    int failures = benchmarkAlarms(directory, rows, budgetMs, out);
+    failures += benchmarkProduction(directory, rows, budgetMs, out);
+
+    QSqlDatabase::removeDatabase("AlarmBench");
+    QSqlDatabase::removeDatabase("ProductionBench");
+    if (!keep) {
+        for (const QString& name : {"alarm_bench.db", "production_bench.db"}) {
+            QFile::remove(directory + "/" + name);
+            QFile::remove(directory + "/" + name + "-wal");
+            QFile::remove(directory + "/" + name + "-shm");
+        }
+    }
+
+    out << (failures == 0 ? "全部查询通过" : QString("%1 个查询未通过").arg(failures)) << Qt::endl;
+    return failures == 0 ? 0 : 1;
+}
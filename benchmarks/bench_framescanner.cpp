@@ -0,0 +1,124 @@
+// 帧头扫描内核基准测试
+// 分别在"干净"(连续有效帧)和"噪声"(长段随机垃圾数据)两种数据流上
+// 测量各SIMD内核的帧头定位吞吐量(MB/s)
+
+#include <QCoreApplication>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "constants.h"
+#include "utils/bytescanner.h"
+
+namespace {
+
+constexpr int STREAM_SIZE = 16 * 1024 * 1024;   // 每个数据流16MB
+constexpr int ITERATIONS = 20;                  // 每个内核重复次数
+constexpr int PAYLOAD_SIZE = 16;                // 有效帧数据长度
+constexpr int NOISE_RUN_BYTES = 4096;           // 噪声流中两帧之间的垃圾字节数
+
+void appendFrame(QByteArray& stream)
+{
+    stream.append(static_cast<char>(Protocol::FRAME_HEADER >> 8));
+    stream.append(static_cast<char>(Protocol::FRAME_HEADER & 0xFF));
+    stream.append(static_cast<char>(0x20));
+    stream.append(static_cast<char>(PAYLOAD_SIZE));
+    quint8 checksum = 0x20 + PAYLOAD_SIZE;
+    for (int i = 0; i < PAYLOAD_SIZE; ++i) {
+        stream.append(static_cast<char>(i));
+        checksum += static_cast<quint8>(i);
+    }
+    stream.append(static_cast<char>(checksum));
+    stream.append(static_cast<char>(Protocol::FRAME_TAIL));
+}
+
+QByteArray buildCleanStream()
+{
+    QByteArray stream;
+    stream.reserve(STREAM_SIZE + Protocol::MAX_FRAME_SIZE);
+    while (stream.size() < STREAM_SIZE) {
+        appendFrame(stream);
+    }
+    return stream;
+}
+
+QByteArray buildNoisyStream()
+{
+    QByteArray stream;
+    stream.reserve(STREAM_SIZE + NOISE_RUN_BYTES + Protocol::MAX_FRAME_SIZE);
+    QRandomGenerator* random = QRandomGenerator::global();
+    while (stream.size() < STREAM_SIZE) {
+        // 随机垃圾数据，避免意外形成帧头，但保留大量孤立的0xAA干扰字节
+        for (int i = 0; i < NOISE_RUN_BYTES; ++i) {
+            quint8 byte = static_cast<quint8>(random->bounded(256));
+            if (byte == 0x55 && !stream.isEmpty() && static_cast<quint8>(stream.back()) == 0xAA) {
+                byte = 0x56;
+            }
+            stream.append(static_cast<char>(byte));
+        }
+        appendFrame(stream);
+    }
+    return stream;
+}
+
+// 模拟解析器的重同步过程：定位帧头后跳过整帧继续搜索
+qint64 scanStream(const QByteArray& stream)
+{
+    const char* data = stream.constData();
+    const int size = stream.size();
+    qint64 framesFound = 0;
+    int pos = 0;
+    while (pos < size) {
+        const int hit = ByteScanner::findHeader(data + pos, size - pos, Protocol::FRAME_HEADER);
+        if (hit < 0) break;
+        pos += hit;
+        if (pos + 3 >= size) break;
+        pos += Protocol::MIN_FRAME_SIZE + static_cast<quint8>(data[pos + 3]);
+        ++framesFound;
+    }
+    return framesFound;
+}
+
+void runBenchmark(QTextStream& out, const QString& streamName, const QByteArray& stream)
+{
+    for (ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::SSE2, ScanKernel::AVX2, ScanKernel::NEON}) {
+        if (!ByteScanner::setKernel(kernel)) {
+            continue;
+        }
+
+        qint64 frames = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            frames += scanStream(stream);
+        }
+        const qint64 elapsedNs = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+        const double megabytes = static_cast<double>(stream.size()) * ITERATIONS / (1024.0 * 1024.0);
+        const double throughput = megabytes / (static_cast<double>(elapsedNs) / 1e9);
+
+        out << QString("%1 %2 %3 MB/s  (%4 帧/轮)")
+               .arg(streamName, -8)
+               .arg(ByteScanner::kernelToString(kernel), -8)
+               .arg(throughput, 10, 'f', 1)
+               .arg(frames / ITERATIONS)
+            << Qt::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    out << "帧头扫描基准测试 - 默认内核: "
+        << ByteScanner::kernelToString(ByteScanner::detectBestKernel()) << Qt::endl;
+
+    runBenchmark(out, "clean", buildCleanStream());
+    runBenchmark(out, "noisy", buildNoisyStream());
+
+    ByteScanner::setKernel(ByteScanner::detectBestKernel());
+    return 0;
+}
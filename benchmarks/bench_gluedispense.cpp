@@ -0,0 +1,697 @@
+// 通讯、校验与缓冲池热路径微基准测试
+// 覆盖 ProtocolParser::parseData、EnhancedChecksum 各算法、CommunicationBufferPool、
+// MonotonicArena 批内存区、EventCoordinator 主题事件、WorkStealingPool 提交与窃取、LogManager::log、UIUpdateOptimizer::requestUpdate、
+// NumericKernels 统计内核（与原先按数据点逐项提取、逐元素循环的写法对比）、参数快照读取（与加锁查表对比）、
+// 各工作负载配置档下的帧处理链路和 TCP 链路压缩（LZ4 块编解码），输出 ns/op、MB/s 和 allocs/op。
+//
+// 典型用法:
+//   GlueDispenseBench --json=bench_<commit>.json
+//   GlueDispenseBench --json=new.json --baseline=bench_<commit>.json
+//   GlueDispenseBench --filter=Checksum --min-time-ms=500
+//   GlueDispenseBench --baseline=bench_<commit>.json --fail-on-allocation-regression
+
+#include <QApplication>
+#include <QCoreApplication>
+#include <QByteArray>
+#include <QDir>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include "benchmarkharness.h"
+#include "constants.h"
+#include "communication/protocolparser.h"
+#include "communication/communicationbufferpool.h"
+#include "communication/icommunication.h"
+#include "communication/linkcompression.h"
+#include "core/eventcoordinator.h"
+#include "logger/logmanager.h"
+#include "ui/uiupdateoptimizer.h"
+#include "utils/bytescanner.h"
+#include "utils/checksum.h"
+#include "utils/configsnapshot.h"
+#include "utils/lz4block.h"
+#include "utils/monotonicarena.h"
+#include "utils/numerickernels.h"
+#include "utils/workloadprofile.h"
+#include "utils/workstealingpool.h"
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+constexpr int PARSE_CHUNK_SIZE = 1024;          // 每次 parseData 送入的字节数（典型串口读取块）
+constexpr int PARSE_STREAM_SIZE = 1024 * 1024;  // 预生成的帧流大小
+constexpr int FRAME_PAYLOAD_SIZE = 24;
+constexpr int UI_WIDGET_COUNT = 256;
+constexpr int ARENA_BATCH_SIZE = 64;            // 每批的临时对象数（DataProcessWorker 的批大小量级）
+constexpr int EVENT_BATCH_SIZE = 64;            // 每轮事件循环之间投递的事件数
+constexpr int POOL_BATCH_SIZE = 256;            // 每次从外部线程提交、等待全部完成的任务数
+constexpr int NUMERIC_SERIES_SIZE = 4096;       // 统计内核的序列长度
+constexpr int NUMERIC_FEATURE_POINTS = 1024;    // 特征提取的数据点数
+constexpr int MOVING_AVERAGE_WINDOW = 32;
+constexpr int CONFIG_PARAMETER_COUNT = 16;      // 参数快照中的参数数（AdaptiveConfigManager 的量级）
+constexpr int PROFILE_MAX_HELD_BUFFERS = 256;   // 帧处理链路中同时持有的缓冲区上限（配置档批大小之上截断）
+
+// 由解析器自身构建帧，保证校验方式与解析路径一致
+QByteArray buildFrameStream(ProtocolParser& parser)
+{
+    QByteArray payload(FRAME_PAYLOAD_SIZE, Qt::Uninitialized);
+    for (int i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>(i * 7);
+    }
+    const QByteArray frame = parser.buildFrame(ProtocolCommand::ReadSensorData, payload);
+
+    QByteArray stream;
+    stream.reserve(PARSE_STREAM_SIZE + frame.size());
+    while (stream.size() < PARSE_STREAM_SIZE) {
+        stream.append(frame);
+    }
+    stream.truncate(PARSE_STREAM_SIZE - PARSE_STREAM_SIZE % PARSE_CHUNK_SIZE);
+    return stream;
+}
+
+// 按块喂入预生成的帧流；块不拷贝，直接引用流中的数据
+void benchmarkParser(BenchmarkRunner& runner, const QString& name, ProtocolParser& parser)
+{
+    const QByteArray stream = buildFrameStream(parser);
+    const int chunkCount = stream.size() / PARSE_CHUNK_SIZE;
+
+    runner.run(name, PARSE_CHUNK_SIZE, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            const int chunk = static_cast<int>(i % chunkCount);
+            parser.parseData(QByteArray::fromRawData(stream.constData() + chunk * PARSE_CHUNK_SIZE,
+                                                     PARSE_CHUNK_SIZE));
+        }
+        parser.flushFrameBatch();
+    }, [&]() {
+        parser.clearBuffer();
+    });
+}
+
+void benchmarkProtocolParser(BenchmarkRunner& runner)
+{
+    {
+        ProtocolParser parser;
+        benchmarkParser(runner, "ProtocolParser::parseData/linear", parser);
+    }
+    {
+        ProtocolParser parser;
+        parser.setRingBufferMode(true);
+        benchmarkParser(runner, "ProtocolParser::parseData/ring", parser);
+    }
+    {
+        // 帧视图处理器直接消费，不构建 ProtocolFrame
+        ProtocolParser parser;
+        parser.setRingBufferMode(true);
+        qint64 frames = 0;
+        parser.setFrameViewHandler([&frames](const FrameView&) {
+            ++frames;
+            return true;
+        });
+        benchmarkParser(runner, "ProtocolParser::parseData/ring+view", parser);
+        doNotOptimize(frames);
+    }
+    {
+        ProtocolParser parser;
+        parser.setRingBufferMode(true);
+        parser.setBatchDelivery(true);
+        benchmarkParser(runner, "ProtocolParser::parseData/ring+batch", parser);
+    }
+}
+
+void benchmarkChecksums(BenchmarkRunner& runner)
+{
+    const QList<ChecksumType> types = {
+        ChecksumType::Simple, ChecksumType::XOR, ChecksumType::CRC8,
+        ChecksumType::CRC16_IBM, ChecksumType::CRC16_CCITT, ChecksumType::CRC16_MODBUS,
+        ChecksumType::CRC32, ChecksumType::CRC32C, ChecksumType::MD5,
+        ChecksumType::SHA1, ChecksumType::SHA256
+    };
+
+    QRandomGenerator random(0x5EED);
+    for (int size : {16, 256, 4096}) {
+        QByteArray data(size, Qt::Uninitialized);
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(random.bounded(256));
+        }
+
+        for (ChecksumType type : types) {
+            const QString name = QString("EnhancedChecksum::calculate/%1/%2")
+                                     .arg(EnhancedChecksum::checksumTypeToString(type))
+                                     .arg(size);
+            runner.run(name, size, [&](qint64 iterations) {
+                for (qint64 i = 0; i < iterations; ++i) {
+                    const ChecksumResult result = EnhancedChecksum::calculate(data, type);
+                    doNotOptimize(result);
+                }
+            });
+        }
+
+        // 协议默认使用的单字节累加校验的直接入口
+        runner.run(QString("EnhancedChecksum::calculateSimple/%1").arg(size), size, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                doNotOptimize(EnhancedChecksum::calculateSimple(data));
+            }
+        });
+        runner.run(QString("EnhancedChecksum::calculateCRC16_Modbus/%1").arg(size), size, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                doNotOptimize(EnhancedChecksum::calculateCRC16_Modbus(data));
+            }
+        });
+    }
+}
+
+void benchmarkBufferPool(BenchmarkRunner& runner)
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    pool->initialize();
+
+    for (int size : {256, 4096, 65536}) {
+        runner.run(QString("CommunicationBufferPool::acquire+release/%1").arg(size), 0, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                QByteArray* buffer = pool->acquireBuffer(size);
+                doNotOptimize(buffer);
+                pool->releaseBuffer(buffer);
+            }
+        });
+    }
+
+    // 同时持有多个缓冲区，穿透线程弹匣走到全局队列
+    runner.run("CommunicationBufferPool::acquire+release/256x64", 0, [&](qint64 iterations) {
+        QByteArray* buffers[64];
+        for (qint64 done = 0; done < iterations;) {
+            const int held = static_cast<int>(qMin<qint64>(64, iterations - done));
+            for (int i = 0; i < held; ++i) {
+                buffers[i] = pool->acquireBuffer(256);
+            }
+            for (int i = 0; i < held; ++i) {
+                pool->releaseBuffer(buffers[i]);
+            }
+            done += held;
+        }
+    });
+
+    runner.run("CommunicationBufferPool::acquireBlock+releaseBlock/256", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            void* block = pool->acquireBlock(256);
+            doNotOptimize(block);
+            pool->releaseBlock(block);
+        }
+    });
+
+    // 对照组：直接分配
+    runner.run("QByteArray::QByteArray/256 (reference)", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            QByteArray buffer(256, Qt::Uninitialized);
+            doNotOptimize(buffer);
+        }
+    });
+}
+
+// 一批临时对象：每个对象带一个小数组，模拟批内的统计和解码结果
+template <typename Vector, typename MakeVector>
+void fillBatch(Vector& batch, MakeVector makeVector)
+{
+    batch.reserve(ARENA_BATCH_SIZE);
+    for (int i = 0; i < ARENA_BATCH_SIZE; ++i) {
+        batch.push_back(makeVector());
+        batch.back().assign(8, i);
+    }
+    doNotOptimize(batch.data());
+}
+
+void benchmarkMonotonicArena(BenchmarkRunner& runner)
+{
+    MonotonicArena arena(64 * 1024);
+
+    runner.run(QString("MonotonicArena::batch/%1").arg(ARENA_BATCH_SIZE), 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            ArenaScope scope(arena);
+            std::pmr::vector<std::pmr::vector<int>> batch(&arena);
+            fillBatch(batch, [&]() { return std::pmr::vector<int>(&arena); });
+        }
+    });
+
+    // 对照组：每批从堆上分配、逐个释放
+    runner.run(QString("std::vector::batch/%1 (reference)").arg(ARENA_BATCH_SIZE), 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            std::vector<std::vector<int>> batch;
+            fillBatch(batch, []() { return std::vector<int>(); });
+        }
+    });
+}
+
+// 投递一批事件后运行一次事件循环，由 drainLanes 批量分发给订阅者
+void benchmarkEventCoordinator(BenchmarkRunner& runner)
+{
+    EventCoordinator coordinator;
+    const EventCoordinator::TopicId topic = EventCoordinator::internTopic("bench.sensor");
+    qint64 delivered = 0;
+    coordinator.subscribeTopic(topic, &coordinator, [&delivered](const EventCoordinator::TopicEvent&) {
+        ++delivered;
+    });
+
+    const QVariant payload(42.0);
+    runner.run(QString("EventCoordinator::post+drain/%1").arg(EVENT_BATCH_SIZE), 0, [&](qint64 iterations) {
+        for (qint64 done = 0; done < iterations;) {
+            const qint64 batch = qMin<qint64>(EVENT_BATCH_SIZE, iterations - done);
+            for (qint64 i = 0; i < batch; ++i) {
+                coordinator.post(topic, payload, EventCoordinator::EventPriority::Normal);
+            }
+            QCoreApplication::processEvents();
+            done += batch;
+        }
+    });
+    doNotOptimize(delivered);
+}
+
+// 外部线程提交一批小任务并等待全部完成，衡量收件箱、双端队列和窃取的开销
+void benchmarkWorkStealingPool(BenchmarkRunner& runner)
+{
+    WorkStealingPool pool(qMax(2, QThread::idealThreadCount()), "BenchPool");
+    std::atomic<qint64> completed{0};
+
+    runner.run(QString("WorkStealingPool::submit+run/%1").arg(POOL_BATCH_SIZE), 0, [&](qint64 iterations) {
+        for (qint64 done = 0; done < iterations;) {
+            const qint64 batch = qMin<qint64>(POOL_BATCH_SIZE, iterations - done);
+            const qint64 target = completed.load(std::memory_order_relaxed) + batch;
+            for (qint64 i = 0; i < batch; ++i) {
+                pool.submit([&completed]() { completed.fetch_add(1, std::memory_order_relaxed); },
+                            static_cast<int>(i % WorkStealingPool::PRIORITY_BANDS));
+            }
+            while (completed.load(std::memory_order_acquire) < target) {
+                QThread::yieldCurrentThread();
+            }
+            done += batch;
+        }
+    });
+}
+
+void benchmarkLogManager(BenchmarkRunner& runner)
+{
+    LogManager* logManager = LogManager::getInstance();
+    logManager->setConsoleOutput(false);
+    logManager->setLogFile(QDir::temp().filePath("gluedispense_bench.log"));
+
+    // 采样之间落盘，避免队列无限增长
+    const auto drainQueue = [logManager]() {
+        QMetaObject::invokeMethod(logManager, "processLogQueue", Qt::DirectConnection);
+    };
+
+    const QString message = QStringLiteral("收到数据帧: 命令=0x20, 长度=24");
+    const QString category = QStringLiteral("Protocol");
+
+    logManager->setLogLevel(LogLevel::Warning);
+    runner.run("LogManager::log/filtered", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            logManager->log(LogLevel::Debug, category, message);
+        }
+    }, drainQueue);
+
+    logManager->setLogLevel(LogLevel::Debug);
+    runner.run("LogManager::log/enqueued", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            logManager->log(LogLevel::Info, category, message);
+        }
+    }, drainQueue);
+
+    logManager->setLogLevel(LogLevel::Info);
+    drainQueue();
+}
+
+void benchmarkUIUpdateOptimizer(BenchmarkRunner& runner)
+{
+    UIUpdateOptimizer optimizer;
+    optimizer.setUpdateInterval(UIUpdateType::RealTimeData, 0);
+
+    QStringList widgetIds;
+    for (int i = 0; i < UI_WIDGET_COUNT; ++i) {
+        widgetIds.append(QString("sensor_%1").arg(i));
+    }
+    const auto clearQueue = [&optimizer]() { optimizer.clearPendingUpdates(); };
+
+    // 同一控件同一数据反复请求，走合并/跳过路径；计时包含任务构建
+    runner.run("UIUpdateOptimizer::requestUpdate/coalesced", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            optimizer.requestUpdate(UIUpdateTask(UIUpdateType::StatusBar, widgetIds.first(), 42));
+        }
+    }, clearQueue);
+
+    // 多个控件、数据不断变化，每次都进入队列（队列满时淘汰低优先级任务）
+    runner.run("UIUpdateOptimizer::requestUpdate/distinct", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            optimizer.requestUpdate(UIUpdateTask(UIUpdateType::RealTimeData,
+                                                 widgetIds.at(static_cast<int>(i % UI_WIDGET_COUNT)),
+                                                 static_cast<qlonglong>(i),
+                                                 static_cast<int>(i & 3)));
+        }
+    }, clearQueue);
+}
+
+// 原先的写法：按数据点从 QHash 取特征再逐项累加
+QHash<QString, QList<double>> legacyFeatureColumns(const QList<QHash<QString, double>>& points)
+{
+    QHash<QString, QList<double>> columns;
+    for (const auto& point : points) {
+        for (auto it = point.constBegin(); it != point.constEnd(); ++it) {
+            columns[it.key()].append(it.value());
+        }
+    }
+    return columns;
+}
+
+double legacyMeanVariance(const QList<double>& values)
+{
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    const double mean = sum / values.size();
+    double variance = 0.0;
+    for (double value : values) {
+        variance += (value - mean) * (value - mean);
+    }
+    return mean + variance / values.size();
+}
+
+void benchmarkNumericKernels(BenchmarkRunner& runner)
+{
+    QRandomGenerator random(0x5EED);
+    std::vector<double> x(NUMERIC_SERIES_SIZE);
+    std::vector<double> y(NUMERIC_SERIES_SIZE);
+    std::vector<double> out(NUMERIC_SERIES_SIZE);
+    for (int i = 0; i < NUMERIC_SERIES_SIZE; ++i) {
+        x[i] = random.generateDouble() * 100.0;
+        y[i] = 0.5 * i + random.generateDouble();
+    }
+    const QList<double> series(x.begin(), x.end());
+    const qint64 seriesBytes = NUMERIC_SERIES_SIZE * static_cast<qint64>(sizeof(double));
+
+    const QStringList featureNames = {"cpu_usage", "memory_usage", "db_response", "ui_response",
+                                      "comm_latency", "throughput", "queue_depth", "error_rate"};
+    QList<QHash<QString, double>> points;
+    for (int i = 0; i < NUMERIC_FEATURE_POINTS; ++i) {
+        QHash<QString, double> point;
+        for (const QString& name : featureNames) {
+            point.insert(name, random.generateDouble());
+        }
+        points.append(point);
+    }
+
+    runner.run("NumericKernels::moments/legacy", seriesBytes, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            doNotOptimize(legacyMeanVariance(series));
+        }
+    });
+    runner.run(QString("NumericKernels::movingAverage/legacy/%1").arg(MOVING_AVERAGE_WINDOW), seriesBytes,
+               [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            for (int j = 0; j < NUMERIC_SERIES_SIZE; ++j) {
+                const int start = qMax(0, j - MOVING_AVERAGE_WINDOW + 1);
+                double sum = 0.0;
+                for (int k = start; k <= j; ++k) {
+                    sum += x[k];
+                }
+                out[j] = sum / (j - start + 1);
+            }
+            doNotOptimize(out.back());
+        }
+    });
+    runner.run("FeatureColumns::extract/legacy", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            doNotOptimize(legacyFeatureColumns(points).size());
+        }
+    });
+    runner.run("FeatureColumns::extract/columns", 0, [&](qint64 iterations) {
+        FeatureColumns columns;
+        for (qint64 i = 0; i < iterations; ++i) {
+            columns.clear();
+            for (const auto& point : points) {
+                columns.appendAll(point);
+            }
+            doNotOptimize(columns.columnCount());
+        }
+    });
+
+    for (ScanKernel kernel : {ScanKernel::Scalar, ScanKernel::SSE2, ScanKernel::AVX2, ScanKernel::NEON}) {
+        if (!NumericKernels::setKernel(kernel)) {
+            continue;
+        }
+        const QString kernelName = ByteScanner::kernelToString(kernel);
+
+        runner.run(QString("NumericKernels::moments/%1").arg(kernelName), seriesBytes, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                doNotOptimize(NumericKernels::moments(x.data(), NUMERIC_SERIES_SIZE).variance);
+            }
+        });
+        runner.run(QString("NumericKernels::dot/%1").arg(kernelName), 2 * seriesBytes, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                doNotOptimize(NumericKernels::dot(x.data(), y.data(), NUMERIC_SERIES_SIZE));
+            }
+        });
+        runner.run(QString("NumericKernels::linearTrend/%1").arg(kernelName), seriesBytes, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                doNotOptimize(NumericKernels::linearTrend(y.data(), NUMERIC_SERIES_SIZE).slope);
+            }
+        });
+        runner.run(QString("NumericKernels::movingAverage/%1/%2").arg(kernelName).arg(MOVING_AVERAGE_WINDOW),
+                   seriesBytes, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                NumericKernels::movingAverage(x.data(), NUMERIC_SERIES_SIZE, MOVING_AVERAGE_WINDOW, out.data());
+                doNotOptimize(out.back());
+            }
+        });
+    }
+    NumericKernels::setKernel(ByteScanner::detectBestKernel());
+}
+
+// 热路径每批读取 3 个参数：原先加锁查参数表，改为快照后版本未变时只读一次原子变量
+void benchmarkConfigSnapshot(BenchmarkRunner& runner)
+{
+    const QStringList keys{System::CONFIG_DATA_BATCH_SIZE, System::CONFIG_BUFFER_POOL_SIZE, System::CONFIG_UI_UPDATE_INTERVAL};
+    ConfigSnapshot snapshot;
+    for (int i = 0; i < CONFIG_PARAMETER_COUNT - keys.size(); ++i) {
+        snapshot.values.insert(QString("parameter_%1").arg(i), i);
+    }
+    for (const QString& key : keys) {
+        snapshot.values.insert(key, 10);
+    }
+
+    QMutex mutex;
+    const QHash<QString, QVariant> parameters = snapshot.values;
+    runner.run("ConfigSnapshot/locked-lookup", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            int sum = 0;
+            for (const QString& key : keys) {
+                QMutexLocker locker(&mutex);
+                sum += parameters.value(key).toInt();
+            }
+            doNotOptimize(sum);
+        }
+    });
+
+    ConfigSnapshotPublisher publisher(snapshot);
+    ConfigSnapshotReader reader;
+    reader.attach(&publisher);
+    int cached = 0;
+    runner.run("ConfigSnapshot/reader-refresh", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            if (reader.refresh()) {
+                cached = 0;
+                for (const QString& key : keys) {
+                    cached += reader->intValue(key, 0);
+                }
+            }
+            doNotOptimize(cached);
+        }
+    });
+
+    runner.run("ConfigSnapshot/publish", 0, [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            publisher.publish(snapshot);
+            reader.refresh();
+        }
+    });
+    reader.detach();
+}
+
+// 每个配置档下的同步帧处理链路：解析一块数据，每帧取缓冲区拷贝并记一条 Info 日志、请求一次实时数据刷新，
+// 按配置档的批大小攒满一批再归还缓冲区，每块之后执行一次界面刷新。数据处理线程的排队不在计时范围内
+void benchmarkWorkloadProfiles(BenchmarkRunner& runner)
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    pool->initialize();
+    const PoolConfig originalPoolConfig = pool->getPoolConfig();
+
+    LogManager* logManager = LogManager::getInstance();
+    const LogLevel originalLogLevel = logManager->getLogLevel();
+    const auto drainLogQueue = [logManager]() {
+        QMetaObject::invokeMethod(logManager, "processLogQueue", Qt::DirectConnection);
+    };
+
+    QStringList widgetIds;
+    for (int i = 0; i < UI_WIDGET_COUNT; ++i) {
+        widgetIds.append(QString("sensor_%1").arg(i));
+    }
+    const QString category = QStringLiteral("Protocol");
+    const QString message = QStringLiteral("收到数据帧");
+
+    for (const WorkloadProfile& profile : WorkloadProfile::builtinProfiles()) {
+        UIUpdateOptimizer optimizer;
+        pool->applyWorkloadProfile(profile);
+        optimizer.applyWorkloadProfile(profile);
+        logManager->setLogLevel(profile.logLevel);
+        drainLogQueue();
+
+        const int batchSize = qMin(profile.dataBatchSize, PROFILE_MAX_HELD_BUFFERS);
+        std::vector<QByteArray*> held;
+        held.reserve(batchSize);
+        qint64 frameIndex = 0;
+
+        ProtocolParser parser;
+        parser.setRingBufferMode(true);
+        parser.setFrameViewHandler([&](const FrameView& view) {
+            QByteArray* buffer = pool->acquireBuffer(view.size());
+            buffer->resize(view.size());
+            view.copyTo(buffer->data());
+            held.push_back(buffer);
+            if (static_cast<int>(held.size()) >= batchSize) {
+                for (QByteArray* heldBuffer : held) {
+                    pool->releaseBuffer(heldBuffer);
+                }
+                held.clear();
+            }
+
+            logManager->log(LogLevel::Info, category, message);
+            optimizer.requestUpdate(UIUpdateTask(UIUpdateType::RealTimeData,
+                                                 widgetIds.at(static_cast<int>(frameIndex % UI_WIDGET_COUNT)),
+                                                 static_cast<qlonglong>(frameIndex)));
+            ++frameIndex;
+            return true;
+        });
+
+        const QByteArray stream = buildFrameStream(parser);
+        const int chunkCount = stream.size() / PARSE_CHUNK_SIZE;
+        runner.run(QString("WorkloadProfile/%1").arg(profile.name), PARSE_CHUNK_SIZE, [&](qint64 iterations) {
+            for (qint64 i = 0; i < iterations; ++i) {
+                const int chunk = static_cast<int>(i % chunkCount);
+                parser.parseData(QByteArray::fromRawData(stream.constData() + chunk * PARSE_CHUNK_SIZE,
+                                                         PARSE_CHUNK_SIZE));
+                QMetaObject::invokeMethod(&optimizer, "processUpdates", Qt::DirectConnection);
+            }
+        }, [&]() {
+            for (QByteArray* heldBuffer : held) {
+                pool->releaseBuffer(heldBuffer);
+            }
+            held.clear();
+            parser.clearBuffer();
+            optimizer.clearPendingUpdates();
+            drainLogQueue();
+        });
+
+        for (QByteArray* heldBuffer : held) {
+            pool->releaseBuffer(heldBuffer);
+        }
+    }
+
+    pool->setPoolConfig(originalPoolConfig);
+    logManager->setLogLevel(originalLogLevel);
+    drainLogQueue();
+}
+
+// 一个压缩块的批量传感器帧：相邻采样缓慢变化，接近 ReadAllSensors 历史数据的可压缩性
+QByteArray buildSensorBlock(ProtocolParser& parser)
+{
+    QRandomGenerator random(0x5EED);
+    QByteArray payload(FRAME_PAYLOAD_SIZE, Qt::Uninitialized);
+    QVector<quint16> channels(FRAME_PAYLOAD_SIZE / 2, 2048);
+
+    QByteArray block;
+    block.reserve(Communication::LINK_COMPRESSION_MAX_BLOCK);
+    while (true) {
+        for (int c = 0; c < channels.size(); ++c) {
+            channels[c] = static_cast<quint16>(channels[c] + random.bounded(7) - 3);
+            payload[c * 2] = static_cast<char>(channels[c] >> 8);
+            payload[c * 2 + 1] = static_cast<char>(channels[c] & 0xFF);
+        }
+        const QByteArray frame = parser.buildFrame(ProtocolCommand::ReadAllSensors, payload);
+        if (block.size() + frame.size() > Communication::LINK_COMPRESSION_MAX_BLOCK) {
+            break;
+        }
+        block.append(frame);
+    }
+    return block;
+}
+
+void benchmarkLinkCompression(BenchmarkRunner& runner)
+{
+    ProtocolParser parser;
+    const QByteArray frames = buildSensorBlock(parser);
+    LinkCompression compression([&parser](int dataLength) { return parser.requiredFrameSize(dataLength); });
+    const QByteArray block = compression.encode(frames);
+
+    QTextStream(stdout) << QString("LinkCompression: %1 -> %2 bytes (%3%)")
+                               .arg(frames.size()).arg(block.size())
+                               .arg(100.0 * block.size() / frames.size(), 0, 'f', 1) << Qt::endl;
+
+    QByteArray output(Lz4Block::compressBound(frames.size()), Qt::Uninitialized);
+    runner.run(QString("Lz4Block::compress/%1").arg(frames.size()), frames.size(), [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            doNotOptimize(Lz4Block::compress(frames.constData(), frames.size(), output.data(), output.size()));
+        }
+    });
+    runner.run(QString("LinkCompression::encode/%1").arg(frames.size()), frames.size(), [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            doNotOptimize(compression.encode(frames));
+        }
+    });
+
+    // 接收端：压缩块和未压缩的帧交替到达，按压缩前的字节数计吞吐
+    CommunicationStats stats;
+    qint64 decodedBytes = 0;
+    const LinkCompression::Sink sink = [&decodedBytes](const char*, int length) { decodedBytes += length; };
+    const QByteArray plainFrames = frames.left(parser.requiredFrameSize(FRAME_PAYLOAD_SIZE) * 8);
+    runner.run(QString("LinkCompression::decode/%1").arg(frames.size()), frames.size() + plainFrames.size(), [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            compression.decode(block.constData(), block.size(), sink, stats);
+            compression.decode(plainFrames.constData(), plainFrames.size(), sink, stats);
+        }
+    });
+    doNotOptimize(decodedBytes);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // UIUpdateOptimizer 依赖 QApplication，基准测试无需显示
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    BenchmarkRunner runner(argc, argv);
+
+    QTextStream(stdout) << "GlueDispenseBench - Qt " << qVersion() << Qt::endl;
+
+    benchmarkProtocolParser(runner);
+    benchmarkChecksums(runner);
+    benchmarkBufferPool(runner);
+    benchmarkMonotonicArena(runner);
+    benchmarkEventCoordinator(runner);
+    benchmarkWorkStealingPool(runner);
+    benchmarkLogManager(runner);
+    benchmarkUIUpdateOptimizer(runner);
+    benchmarkNumericKernels(runner);
+    benchmarkConfigSnapshot(runner);
+    benchmarkWorkloadProfiles(runner);
+    benchmarkLinkCompression(runner);
+
+    const int allocationRegressions = runner.printBaselineComparison();
+    if (!runner.writeJson()) {
+        return 1;
+    }
+    return allocationRegressions > 0 && runner.failOnAllocationRegression() ? 2 : 0;
+}
@@ -0,0 +1,218 @@
+// 点胶程序加载基准测试
+// 生成指定点数的程序，分别保存为 JSON 和二进制格式，比较三种加载方式的耗时中位数和 P95：
+//   JSON 解析      读文件 + QJsonDocument 解析 + 转换为 GlueProgram（导入路径）
+//   二进制拷贝     映射 + 校验 + 拷贝为 GlueProgram（参数页打开程序的路径）
+//   二进制映射     映射后直接遍历轨迹数组求路径长度，不校验、不拷贝
+// 加载结果与原程序逐字段比较，不一致时返回非零。
+//
+// 参数：--points=N 轨迹点数（默认 200000）  --iterations=N 每种方式的测量次数（默认 20）
+//       --dir=DIR 文件目录（默认临时目录）
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "data/programfile.h"
+
+namespace {
+
+constexpr qint64 DEFAULT_POINTS = 200000;
+constexpr int DEFAULT_ITERATIONS = 20;
+
+QString optionValue(const QString& argument, const QString& name)
+{
+    const QString prefix = "--" + name + "=";
+    return argument.startsWith(prefix) ? argument.mid(prefix.size()) : QString();
+}
+
+// 蛇形扫描轨迹，每行末尾一个不点胶的换行点
+GlueProgram makeProgram(qint64 points)
+{
+    GlueProgram program;
+    program.name = "基准程序";
+    program.description = QString("%1 个点").arg(points);
+    program.params.volume = 0.8;
+    program.params.pressure = 2.5;
+
+    QRandomGenerator random(20240101);
+    const int columns = 500;
+    program.trajectory.reserve(points);
+    for (qint64 i = 0; i < points; ++i) {
+        const qint64 row = i / columns;
+        const qint64 column = (row % 2 == 0) ? i % columns : columns - 1 - i % columns;
+        GlueProgram::TrajectoryPoint point;
+        point.x = column * 0.5 + random.bounded(1.0) * 0.01;
+        point.y = row * 0.5;
+        point.z = 2.0 + random.bounded(1.0) * 0.05;
+        point.speed = 20.0 + random.bounded(30);
+        point.volume = 0.01 * (1 + random.bounded(20));
+        point.dwellTime = 10 + random.bounded(90);
+        point.isGluePoint = (i % columns) != columns - 1;
+        program.trajectory.append(point);
+    }
+    return program;
+}
+
+bool sameProgram(const GlueProgram& a, const GlueProgram& b)
+{
+    if (a.name != b.name || a.version != b.version || a.description != b.description ||
+        a.params.volume != b.params.volume || a.params.speed != b.params.speed ||
+        a.params.pressure != b.params.pressure || a.params.temperature != b.params.temperature ||
+        a.params.dwellTime != b.params.dwellTime || a.params.riseTime != b.params.riseTime ||
+        a.params.fallTime != b.params.fallTime || a.trajectory.size() != b.trajectory.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < a.trajectory.size(); ++i) {
+        const GlueProgram::TrajectoryPoint& p = a.trajectory.at(i);
+        const GlueProgram::TrajectoryPoint& q = b.trajectory.at(i);
+        if (p.x != q.x || p.y != q.y || p.z != q.z || p.speed != q.speed || p.volume != q.volume ||
+            p.dwellTime != q.dwellTime || p.isGluePoint != q.isGluePoint) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 返回值防止遍历被优化掉
+double measure(const QString& name, int iterations, const std::function<double()>& body, QTextStream& out,
+               double* medianMs)
+{
+    QList<double> samples;
+    double sink = 0;
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        sink += body();
+        samples.append(timer.nsecsElapsed() / 1e6);
+    }
+    std::sort(samples.begin(), samples.end());
+    *medianMs = samples[samples.size() / 2];
+    const double p95 = samples[qMin<qsizetype>(samples.size() - 1, samples.size() * 95 / 100)];
+    out << QString("  %1 中位数 %2 ms  P95 %3 ms")
+               .arg(name, -16)
+               .arg(*medianMs, 10, 'f', 3)
+               .arg(p95, 10, 'f', 3)
+        << Qt::endl;
+    return sink;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    qint64 points = DEFAULT_POINTS;
+    int iterations = DEFAULT_ITERATIONS;
+    QString directory;
+    for (int i = 1; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        QString value;
+        if (!(value = optionValue(argument, "points")).isEmpty()) {
+            points = qMax<qint64>(1, value.toLongLong());
+        } else if (!(value = optionValue(argument, "iterations")).isEmpty()) {
+            iterations = qMax(1, value.toInt());
+        } else if (!(value = optionValue(argument, "dir")).isEmpty()) {
+            directory = value;
+        }
+    }
+
+    QTemporaryDir temporary;
+    if (directory.isEmpty()) {
+        directory = temporary.path();
+    }
+    QDir().mkpath(directory);
+    const QString jsonPath = directory + "/program_bench.json";
+    const QString binaryPath = directory + "/program_bench." + ProgramFile::SUFFIX;
+
+    out << QString("程序加载基准测试 - %1 个点, 目录: %2").arg(points).arg(directory) << Qt::endl;
+    const GlueProgram program = makeProgram(points);
+
+    QElapsedTimer timer;
+    timer.start();
+    QFile jsonFile(jsonPath);
+    if (!jsonFile.open(QIODevice::WriteOnly) ||
+        jsonFile.write(QJsonDocument(ProgramFile::toJson(program)).toJson()) < 0) {
+        out << "无法写入 JSON 文件: " << jsonFile.errorString() << Qt::endl;
+        return 1;
+    }
+    jsonFile.close();
+    const qint64 jsonWriteMs = timer.restart();
+
+    QString error;
+    if (!ProgramFile::write(binaryPath, program, &error)) {
+        out << error << Qt::endl;
+        return 1;
+    }
+    const qint64 binaryWriteMs = timer.elapsed();
+
+    out << QString("  JSON   %1 KB, 保存 %2 ms").arg(QFileInfo(jsonPath).size() / 1024).arg(jsonWriteMs) << Qt::endl;
+    out << QString("  二进制 %1 KB, 保存 %2 ms").arg(QFileInfo(binaryPath).size() / 1024).arg(binaryWriteMs)
+        << Qt::endl;
+
+    // 先各加载一次检查结果一致；JSON 的时间按秒存放，只比较其余字段
+    GlueProgram fromJson;
+    {
+        QFile file(jsonPath);
+        file.open(QIODevice::ReadOnly);
+        fromJson = ProgramFile::fromJson(QJsonDocument::fromJson(file.readAll()).object());
+    }
+    GlueProgram fromBinary;
+    if (!ProgramFile::read(binaryPath, &fromBinary, &error)) {
+        out << error << Qt::endl;
+        return 1;
+    }
+    const bool binaryExact = sameProgram(program, fromBinary) &&
+                             fromBinary.createTime == program.createTime &&
+                             fromBinary.modifyTime == program.modifyTime;
+    if (!sameProgram(program, fromJson) || !binaryExact) {
+        out << "加载结果与原程序不一致" << Qt::endl;
+        return 1;
+    }
+
+    double jsonMs = 0;
+    double copyMs = 0;
+    double mappedMs = 0;
+    double sink = measure("JSON 解析", iterations, [&]() {
+        QFile file(jsonPath);
+        file.open(QIODevice::ReadOnly);
+        const GlueProgram loaded = ProgramFile::fromJson(QJsonDocument::fromJson(file.readAll()).object());
+        return static_cast<double>(loaded.trajectory.size());
+    }, out, &jsonMs);
+    sink += measure("二进制拷贝", iterations, [&]() {
+        GlueProgram loaded;
+        ProgramFile::read(binaryPath, &loaded);
+        return static_cast<double>(loaded.trajectory.size());
+    }, out, &copyMs);
+    sink += measure("二进制映射", iterations, [&]() {
+        ProgramFile file;
+        if (!file.open(binaryPath)) {
+            return 0.0;
+        }
+        const ProgramFilePoint* data = file.points();
+        double length = 0;
+        for (quint64 i = 1; i < file.pointCount(); ++i) {
+            length += std::hypot(data[i].x - data[i - 1].x, data[i].y - data[i - 1].y);
+        }
+        return length;
+    }, out, &mappedMs);
+
+    out << QString("  二进制拷贝比 JSON 快 %1 倍，映射遍历快 %2 倍 (累计 %3)")
+               .arg(jsonMs / qMax(copyMs, 1e-6), 0, 'f', 1)
+               .arg(jsonMs / qMax(mappedMs, 1e-6), 0, 'f', 1)
+               .arg(sink, 0, 'g', 6)
+        << Qt::endl;
+
+    QFile::remove(jsonPath);
+    QFile::remove(binaryPath);
+    return 0;
+}
@@ -0,0 +1,350 @@
+// 串口回环延迟基准测试
+// 每隔 --interval-ms 写出一个 --bytes 字节的探测包，在接收端的 readyRead 回调中记录
+// 首字节回调延迟（写出到第一次回调）和整包回调延迟（写出到整包收齐的回调），
+// 分别在驱动默认设置和低延迟串口模式（SerialLatency）下测量。整包延迟包含线路传输时间，一并打印以便对照。
+//
+// 接线：--port 单独给出时需要回环插头（TX 与 RX 短接）；同时给出 --peer 时 --port 发送、--peer 接收（零调制解调器线）。
+// Linux 下 --pty 使用伪终端对自测，不需要硬件，只能验证测量流程（伪终端不支持 ASYNC_LOW_LATENCY）。
+// ASYNC_LOW_LATENCY 和 FTDI 延迟定时器在串口关闭后仍然保留，所以先测默认设置；
+// 之前运行过低延迟模式时，需重新插拔适配器才能得到真正的默认值。
+//
+// 参数：--port=<串口>  --peer=<串口>  --pty  --baud=N（默认 115200）  --probes=N 每种模式的探测次数（默认 1000）
+//       --bytes=N 探测包字节数（默认 8）  --interval-ms=N 探测间隔（默认 5）
+//       --mode=default|low|both（默认 both）  --json=<路径> 把结果写成JSON
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSerialPort>
+#include <QTextStream>
+#include <QTimer>
+#include <functional>
+#include "communication/seriallatency.h"
+#include "utils/hdrhistogram.h"
+#include "utils/monotonicclock.h"
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr qint32 DEFAULT_BAUD = 115200;
+constexpr int DEFAULT_PROBES = 1000;
+constexpr int DEFAULT_PROBE_BYTES = 8;
+constexpr int DEFAULT_INTERVAL_MS = 5;
+constexpr int PROBE_TIMEOUT_MS = 1000;
+constexpr int WARMUP_PROBES = 10;
+
+QString optionValue(const QString& argument, const QString& name)
+{
+    const QString prefix = "--" + name + "=";
+    return argument.startsWith(prefix) ? argument.mid(prefix.size()) : QString();
+}
+
+struct BenchOptions {
+    QString port;
+    QString peer;
+    bool pty = false;
+    qint32 baudRate = DEFAULT_BAUD;
+    int probes = DEFAULT_PROBES;
+    int probeBytes = DEFAULT_PROBE_BYTES;
+    int intervalMs = DEFAULT_INTERVAL_MS;
+    bool runDefault = true;
+    bool runLow = true;
+};
+
+struct ModeResult {
+    QString mode;
+    bool opened = false;
+    QString latencySummary;         // 低延迟模式的设置结果
+    HdrHistogram firstByte;
+    HdrHistogram fullProbe;
+    int lost = 0;
+    qint64 wireNs = 0;              // 探测包的理论线路传输时间
+};
+
+// 伪终端对：主设备端由基准直接写入，从设备端由 QSerialPort 打开
+class PseudoTerminal
+{
+public:
+    ~PseudoTerminal()
+    {
+#if defined(Q_OS_LINUX)
+        if (m_master >= 0) {
+            ::close(m_master);
+        }
+#endif
+    }
+
+    bool open(QString* error)
+    {
+#if defined(Q_OS_LINUX)
+        m_master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0) {
+            *error = "无法创建伪终端";
+            return false;
+        }
+        m_slavePath = QString::fromLocal8Bit(ptsname(m_master));
+        return true;
+#else
+        *error = "当前平台不支持 --pty";
+        return false;
+#endif
+    }
+
+    bool write(const QByteArray& data)
+    {
+#if defined(Q_OS_LINUX)
+        return ::write(m_master, data.constData(), static_cast<size_t>(data.size())) == data.size();
+#else
+        Q_UNUSED(data)
+        return false;
+#endif
+    }
+
+    QString slavePath() const { return m_slavePath; }
+
+private:
+    int m_master = -1;
+    QString m_slavePath;
+};
+
+bool openPort(QSerialPort& port, const QString& name, qint32 baudRate, QString* error)
+{
+    port.setPortName(name);
+    port.setBaudRate(baudRate);
+    port.setDataBits(QSerialPort::Data8);
+    port.setParity(QSerialPort::NoParity);
+    port.setStopBits(QSerialPort::OneStop);
+    port.setFlowControl(QSerialPort::NoFlowControl);
+    if (!port.open(QIODevice::ReadWrite)) {
+        *error = QString("无法打开 %1: %2").arg(name, port.errorString());
+        return false;
+    }
+    port.clear();
+    return true;
+}
+
+ModeResult runMode(const BenchOptions& options, bool lowLatency)
+{
+    ModeResult result;
+    result.mode = lowLatency ? "low" : "default";
+
+    PseudoTerminal pty;
+    QSerialPort reader;
+    QSerialPort writerPort;
+    QString error;
+    bool ok = true;
+    if (options.pty) {
+        ok = pty.open(&error) && openPort(reader, pty.slavePath(), options.baudRate, &error);
+    } else {
+        ok = openPort(reader, options.peer.isEmpty() ? options.port : options.peer, options.baudRate, &error);
+        if (ok && !options.peer.isEmpty()) {
+            ok = openPort(writerPort, options.port, options.baudRate, &error);
+        }
+    }
+    if (!ok) {
+        QTextStream(stderr) << error << Qt::endl;
+        return result;
+    }
+    result.opened = true;
+
+    if (lowLatency) {
+        result.latencySummary = SerialLatency::apply(&reader).summary();
+        if (writerPort.isOpen()) {
+            SerialLatency::apply(&writerPort);
+        }
+    }
+    result.wireNs = qint64(options.probeBytes) * SerialLatency::bitsPerCharacter(&reader) * 1000000000LL
+                    / options.baudRate;
+
+    QSerialPort* writer = writerPort.isOpen() ? &writerPort : &reader;
+    const std::function<bool(const QByteArray&)> send = [&](const QByteArray& probe) {
+        if (options.pty) {
+            return pty.write(probe);
+        }
+        if (writer->write(probe) != probe.size()) {
+            return false;
+        }
+        writer->flush();
+        return true;
+    };
+
+    QEventLoop loop;
+    QTimer ticker;
+    ticker.setTimerType(Qt::PreciseTimer);
+    ticker.setInterval(options.intervalMs);
+
+    const int totalProbes = WARMUP_PROBES + options.probes;
+    int sent = 0;
+    int received = 0;               // 当前探测包已收到的字节数
+    bool inFlight = false;
+    qint64 sentNs = 0;
+
+    QObject::connect(&reader, &QSerialPort::readyRead, &loop, [&]() {
+        const qint64 nowNs = MonotonicClock::nowNs();
+        const qint64 size = reader.readAll().size();
+        if (!inFlight || size == 0) {
+            return;     // 超时探测包的迟到字节
+        }
+        const bool measured = sent > WARMUP_PROBES;
+        if (received == 0 && measured) {
+            result.firstByte.record(nowNs - sentNs);
+        }
+        received += static_cast<int>(size);
+        if (received >= options.probeBytes) {
+            if (measured) {
+                result.fullProbe.record(nowNs - sentNs);
+            }
+            inFlight = false;
+            if (sent >= totalProbes) {
+                loop.quit();
+            }
+        }
+    });
+
+    QObject::connect(&ticker, &QTimer::timeout, &loop, [&]() {
+        if (inFlight) {
+            if ((MonotonicClock::nowNs() - sentNs) / 1000000 < PROBE_TIMEOUT_MS) {
+                return;
+            }
+            if (sent > WARMUP_PROBES) {
+                ++result.lost;
+            }
+            inFlight = false;
+        }
+        if (sent >= totalProbes) {
+            loop.quit();
+            return;
+        }
+        QByteArray probe(options.probeBytes, '\0');
+        probe[0] = static_cast<char>(sent & 0xFF);
+        received = 0;
+        inFlight = true;
+        ++sent;
+        sentNs = MonotonicClock::nowNs();
+        if (!send(probe)) {
+            QTextStream(stderr) << "写入失败" << Qt::endl;
+            loop.quit();
+        }
+    });
+
+    ticker.start();
+    loop.exec();
+    ticker.stop();
+    return result;
+}
+
+QJsonObject toJson(const ModeResult& result)
+{
+    QJsonObject object;
+    object["mode"] = result.mode;
+    object["opened"] = result.opened;
+    object["settings"] = result.latencySummary;
+    object["wire_ns"] = result.wireNs;
+    object["samples"] = result.fullProbe.count();
+    object["lost"] = result.lost;
+    object["first_byte_p50_ns"] = result.firstByte.percentileNs(50.0);
+    object["first_byte_p99_ns"] = result.firstByte.percentileNs(99.0);
+    object["first_byte_max_ns"] = result.firstByte.maxNs();
+    object["full_probe_p50_ns"] = result.fullProbe.percentileNs(50.0);
+    object["full_probe_p99_ns"] = result.fullProbe.percentileNs(99.0);
+    object["full_probe_max_ns"] = result.fullProbe.maxNs();
+    return object;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    BenchOptions options;
+    QString jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        QString value;
+        if (argument == "--pty") {
+            options.pty = true;
+        } else if (!(value = optionValue(argument, "port")).isEmpty()) {
+            options.port = value;
+        } else if (!(value = optionValue(argument, "peer")).isEmpty()) {
+            options.peer = value;
+        } else if (!(value = optionValue(argument, "baud")).isEmpty()) {
+            options.baudRate = qMax(300, value.toInt());
+        } else if (!(value = optionValue(argument, "probes")).isEmpty()) {
+            options.probes = qMax(1, value.toInt());
+        } else if (!(value = optionValue(argument, "bytes")).isEmpty()) {
+            options.probeBytes = qBound(1, value.toInt(), 4096);
+        } else if (!(value = optionValue(argument, "interval-ms")).isEmpty()) {
+            options.intervalMs = qMax(1, value.toInt());
+        } else if (!(value = optionValue(argument, "mode")).isEmpty()) {
+            options.runDefault = value != "low";
+            options.runLow = value != "default";
+        } else if (!(value = optionValue(argument, "json")).isEmpty()) {
+            jsonPath = value;
+        }
+    }
+    if (options.port.isEmpty() && !options.pty) {
+        QTextStream(stderr) << "需要 --port=<串口>（回环插头）或 --pty" << Qt::endl;
+        return 2;
+    }
+
+    out << QString("串口回环延迟基准测试 - %1 @ %2，探测包 %3 字节，间隔 %4 ms，每种模式 %5 次")
+               .arg(options.pty ? QString("伪终端") : options.port + (options.peer.isEmpty() ? "" : " → " + options.peer))
+               .arg(options.baudRate).arg(options.probeBytes).arg(options.intervalMs).arg(options.probes)
+        << Qt::endl;
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+               .arg("模式", -8).arg("样本", 6).arg("丢失", 5).arg("首字节P50", 10).arg("首字节P99", 10)
+               .arg("整包P50", 10).arg("整包P99", 10).arg("线路时间", 10)
+        << Qt::endl;
+
+    QJsonArray modes;
+    int failures = 0;
+    for (bool lowLatency : {false, true}) {
+        if ((lowLatency && !options.runLow) || (!lowLatency && !options.runDefault)) {
+            continue;
+        }
+        const ModeResult result = runMode(options, lowLatency);
+        if (!result.opened || result.fullProbe.count() == 0) {
+            ++failures;
+        }
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                   .arg(result.mode, -8).arg(result.fullProbe.count(), 6).arg(result.lost, 5)
+                   .arg(HdrHistogram::formatNs(result.firstByte.percentileNs(50.0)), 10)
+                   .arg(HdrHistogram::formatNs(result.firstByte.percentileNs(99.0)), 10)
+                   .arg(HdrHistogram::formatNs(result.fullProbe.percentileNs(50.0)), 10)
+                   .arg(HdrHistogram::formatNs(result.fullProbe.percentileNs(99.0)), 10)
+                   .arg(HdrHistogram::formatNs(result.wireNs), 10)
+            << Qt::endl;
+        if (!result.latencySummary.isEmpty()) {
+            out << "  " << result.latencySummary << Qt::endl;
+        }
+        modes.append(toJson(result));
+    }
+
+    if (!jsonPath.isEmpty()) {
+        QJsonObject report;
+        report["port"] = options.pty ? QString("pty") : options.port;
+        report["peer"] = options.peer;
+        report["baud_rate"] = options.baudRate;
+        report["probe_bytes"] = options.probeBytes;
+        report["interval_ms"] = options.intervalMs;
+        report["modes"] = modes;
+
+        QFile file(jsonPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "无法写入 " << jsonPath << Qt::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+    return failures == 0 ? 0 : 1;
+}
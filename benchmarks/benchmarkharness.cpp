@@ -0,0 +1,267 @@
+#include "benchmarkharness.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QStringList>
+#include <QSysInfo>
+#include <QTextStream>
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 DEFAULT_MIN_TIME_NS = 200 * 1000 * 1000;
+constexpr int DEFAULT_SAMPLES = 5;
+constexpr int TOP_SITE_COUNT = 3;                   // 每个用例输出的分配最多的作用域数
+constexpr double ALLOCATION_REGRESSION_MARGIN = 0.01;   // 每次操作分配次数增加超过此值视为回归
+
+QString optionValue(const QString& argument, const QString& name)
+{
+    const QString prefix = QString("--%1=").arg(name);
+    return argument.startsWith(prefix) ? argument.mid(prefix.size()) : QString();
+}
+
+} // namespace
+
+BenchmarkRunner::BenchmarkRunner(int argc, char* argv[])
+    : m_minTimeNs(DEFAULT_MIN_TIME_NS)
+    , m_samples(DEFAULT_SAMPLES)
+    , m_failOnAllocationRegression(false)
+{
+    if (!AllocationTracker::isAvailable()) {
+        QTextStream(stderr) << "未以 ALLOCATION_TRACKING 编译，allocs/op 均为0" << Qt::endl;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        QString value;
+        if (!(value = optionValue(argument, "filter")).isEmpty()) {
+            m_filter = value;
+        } else if (!(value = optionValue(argument, "min-time-ms")).isEmpty()) {
+            m_minTimeNs = qMax<qint64>(1, value.toLongLong()) * 1000 * 1000;
+        } else if (!(value = optionValue(argument, "samples")).isEmpty()) {
+            m_samples = qMax(1, value.toInt());
+        } else if (!(value = optionValue(argument, "json")).isEmpty()) {
+            m_jsonPath = value;
+        } else if (!(value = optionValue(argument, "baseline")).isEmpty()) {
+            m_baselinePath = value;
+        } else if (argument == "--fail-on-allocation-regression") {
+            m_failOnAllocationRegression = true;
+        }
+    }
+}
+
+void BenchmarkRunner::run(const QString& name, qint64 bytesPerOp, const Body& body, const Reset& reset)
+{
+    if (!m_filter.isEmpty() && !name.contains(m_filter)) {
+        return;
+    }
+
+    const qint64 iterations = calibrate(body, reset);
+
+    QList<double> samples;
+    samples.reserve(m_samples);
+    qint64 totalOps = 0;
+    AllocationTracker::Counters allocations;
+    qint64 frames = 0;
+    AllocationTracker::Snapshot firstSnapshot;
+    AllocationTracker::Snapshot lastSnapshot;
+
+    for (int sample = 0; sample < m_samples; ++sample) {
+        if (reset) {
+            reset();
+        }
+        // 快照本身会分配内存，只在第一次采样前和每次采样后各取一次，计数用不分配内存的 current()
+        if (sample == 0) {
+            firstSnapshot = AllocationTracker::snapshot();
+        }
+        const AllocationTracker::Counters before = AllocationTracker::current();
+        const qint64 framesBefore = AllocationTracker::frameCount();
+        QElapsedTimer timer;
+        timer.start();
+        body(iterations);
+        const qint64 elapsedNs = qMax<qint64>(timer.nsecsElapsed(), 1);
+        const AllocationTracker::Counters after = AllocationTracker::current();
+        const qint64 framesAfter = AllocationTracker::frameCount();
+        lastSnapshot = AllocationTracker::snapshot();
+
+        samples.append(static_cast<double>(elapsedNs) / iterations);
+        allocations.count += after.count - before.count;
+        allocations.bytes += after.bytes - before.bytes;
+        frames += framesAfter - framesBefore;
+        totalOps += iterations;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = samples.at(samples.size() / 2);
+    result.minNsPerOp = samples.first();
+    result.maxNsPerOp = samples.last();
+    result.bytesPerSecond = bytesPerOp > 0 ? bytesPerOp * 1e9 / result.nsPerOp : 0.0;
+    result.allocsPerOp = static_cast<double>(allocations.count) / totalOps;
+    result.allocatedBytesPerOp = static_cast<double>(allocations.bytes) / totalOps;
+    result.frames = frames;
+    result.allocsPerFrame = frames > 0 ? static_cast<double>(allocations.count) / frames : 0.0;
+    result.topSites = AllocationTracker::difference(firstSnapshot, lastSnapshot, TOP_SITE_COUNT).topSites;
+
+    printResult(result);
+    m_results.append(result);
+}
+
+qint64 BenchmarkRunner::calibrate(const Body& body, const Reset& reset) const
+{
+    // 迭代次数按10倍递增，直到一次运行达到目标时间的1/10，再按比例外推
+    qint64 iterations = 1;
+    while (true) {
+        if (reset) {
+            reset();
+        }
+        QElapsedTimer timer;
+        timer.start();
+        body(iterations);
+        const qint64 elapsedNs = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+        if (elapsedNs >= m_minTimeNs / 10 || iterations >= (Q_INT64_C(1) << 40)) {
+            const double scale = static_cast<double>(m_minTimeNs) / elapsedNs;
+            return qMax<qint64>(1, static_cast<qint64>(iterations * scale));
+        }
+        iterations *= 10;
+    }
+}
+
+void BenchmarkRunner::printResult(const BenchmarkResult& result) const
+{
+    QTextStream out(stdout);
+    QString line = QString("%1 %2 ns/op").arg(result.name, -44).arg(result.nsPerOp, 12, 'f', 1);
+    if (result.bytesPerSecond > 0.0) {
+        line += QString("  %1 MB/s").arg(result.bytesPerSecond / (1024.0 * 1024.0), 10, 'f', 1);
+    } else {
+        line += QString(16, ' ');
+    }
+    line += QString("  %1 allocs/op  %2 B/op")
+                .arg(result.allocsPerOp, 8, 'f', 2)
+                .arg(result.allocatedBytesPerOp, 10, 'f', 1);
+    if (result.frames > 0) {
+        line += QString("  %1 allocs/frame").arg(result.allocsPerFrame, 0, 'f', 2);
+    }
+    out << line << Qt::endl;
+    
+    // 有分配时列出分配最多的作用域，便于定位回归来源
+    if (result.allocsPerOp > 0.0 && !result.topSites.isEmpty()) {
+        QStringList sites;
+        for (const AllocationTracker::NamedCounters& site : result.topSites) {
+            sites << QString("%1 %2").arg(site.name).arg(site.counters.count);
+        }
+        out << QString("%1   分配来源: %2").arg(QString(), -44).arg(sites.join(", ")) << Qt::endl;
+    }
+}
+
+bool BenchmarkRunner::writeJson() const
+{
+    if (m_jsonPath.isEmpty()) {
+        return true;
+    }
+
+    QJsonArray results;
+    for (const BenchmarkResult& result : m_results) {
+        QJsonObject item;
+        item["name"] = result.name;
+        item["iterations"] = result.iterations;
+        item["nsPerOp"] = result.nsPerOp;
+        item["minNsPerOp"] = result.minNsPerOp;
+        item["maxNsPerOp"] = result.maxNsPerOp;
+        item["bytesPerSecond"] = result.bytesPerSecond;
+        item["allocsPerOp"] = result.allocsPerOp;
+        item["allocatedBytesPerOp"] = result.allocatedBytesPerOp;
+        if (result.frames > 0) {
+            item["frames"] = result.frames;
+            item["allocsPerFrame"] = result.allocsPerFrame;
+        }
+        QJsonArray sites;
+        for (const AllocationTracker::NamedCounters& site : result.topSites) {
+            QJsonObject entry;
+            entry["name"] = site.name;
+            entry["allocations"] = site.counters.count;
+            entry["bytes"] = site.counters.bytes;
+            sites.append(entry);
+        }
+        item["topAllocationSites"] = sites;
+        results.append(item);
+    }
+
+    QJsonObject root;
+    root["suite"] = "GlueDispenseBench";
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["qtVersion"] = QString::fromLatin1(qVersion());
+    root["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    root["kernel"] = QSysInfo::kernelType() + " " + QSysInfo::kernelVersion();
+    root["samples"] = m_samples;
+    root["minTimeMs"] = m_minTimeNs / 1000000;
+    root["results"] = results;
+
+    QFile file(m_jsonPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream(stderr) << "无法写入结果文件: " << m_jsonPath << Qt::endl;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+int BenchmarkRunner::printBaselineComparison() const
+{
+    if (m_baselinePath.isEmpty()) {
+        return 0;
+    }
+
+    QTextStream out(stdout);
+    QFile file(m_baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        out << "无法读取基线文件: " << m_baselinePath << Qt::endl;
+        return 0;
+    }
+
+    QHash<QString, QJsonObject> baseline;
+    const QJsonArray items = QJsonDocument::fromJson(file.readAll()).object().value("results").toArray();
+    for (const QJsonValue& value : items) {
+        const QJsonObject item = value.toObject();
+        baseline.insert(item.value("name").toString(), item);
+    }
+
+    out << Qt::endl << "与基线对比: " << m_baselinePath << Qt::endl;
+    int regressions = 0;
+    for (const BenchmarkResult& result : m_results) {
+        const auto it = baseline.constFind(result.name);
+        if (it == baseline.constEnd()) {
+            out << QString("%1 (基线中不存在)").arg(result.name, -44) << Qt::endl;
+            continue;
+        }
+        const double baseNs = it->value("nsPerOp").toDouble();
+        const double baseAllocs = it->value("allocsPerOp").toDouble();
+        const double change = baseNs > 0.0 ? (result.nsPerOp - baseNs) * 100.0 / baseNs : 0.0;
+        out << QString("%1 %2 -> %3 ns/op (%4%5%)  allocs/op %6 -> %7")
+                   .arg(result.name, -44)
+                   .arg(baseNs, 10, 'f', 1)
+                   .arg(result.nsPerOp, 10, 'f', 1)
+                   .arg(change >= 0.0 ? "+" : "")
+                   .arg(change, 0, 'f', 1)
+                   .arg(baseAllocs, 0, 'f', 2)
+                   .arg(result.allocsPerOp, 0, 'f', 2);
+        if (result.allocsPerOp > baseAllocs + ALLOCATION_REGRESSION_MARGIN) {
+            out << "  <- 分配增加";
+            regressions++;
+        }
+        out << Qt::endl;
+    }
+    
+    if (regressions > 0) {
+        out << QString("%1 个用例每次操作的分配次数比基线增加").arg(regressions) << Qt::endl;
+    }
+    return regressions;
+}
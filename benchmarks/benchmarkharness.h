@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <functional>
+#include "utils/allocationtracker.h"
+
+// 微基准测试框架 - 自动标定迭代次数，统计每次操作耗时(ns/op)、吞吐量(bytes/s)
+// 和每次操作的堆分配次数(allocs/op)，结果可写成JSON以便在不同提交之间对比。
+//
+// 命令行参数:
+//   --filter=<子串>      只运行名称包含该子串的用例
+//   --min-time-ms=<毫秒> 每个采样的最短运行时间（默认200）
+//   --samples=<次数>     每个用例的采样次数，取中位数（默认5）
+//   --json=<路径>        把结果写成JSON
+//   --baseline=<路径>    读取之前的JSON结果，逐项打印变化百分比，标出每次操作分配次数增加的用例
+//   --fail-on-allocation-regression  存在分配次数增加的用例时以非零状态退出
+
+struct BenchmarkResult {
+    QString name;
+    qint64 iterations = 0;          // 最终采样的迭代次数
+    double nsPerOp = 0.0;           // 各采样的中位数
+    double minNsPerOp = 0.0;
+    double maxNsPerOp = 0.0;
+    double bytesPerSecond = 0.0;    // 未指定每次操作字节数时为0
+    double allocsPerOp = 0.0;
+    double allocatedBytesPerOp = 0.0;
+    qint64 frames = 0;              // 被测体经过协议解析器校验的帧数（ALLOCATION_COUNT_FRAMES）
+    double allocsPerFrame = 0.0;    // 没有帧时为0
+    QList<AllocationTracker::NamedCounters> topSites;   // 全部采样中分配最多的作用域
+};
+
+class BenchmarkRunner
+{
+public:
+    // 被测体执行 iterations 次操作；reset 在两次采样之间调用，不计时
+    using Body = std::function<void(qint64 iterations)>;
+    using Reset = std::function<void()>;
+
+    BenchmarkRunner(int argc, char* argv[]);
+
+    void run(const QString& name, qint64 bytesPerOp, const Body& body, const Reset& reset = Reset());
+
+    bool writeJson() const;
+    // 返回每次操作分配次数比基线增加的用例数
+    int printBaselineComparison() const;
+    bool failOnAllocationRegression() const { return m_failOnAllocationRegression; }
+
+    const QList<BenchmarkResult>& results() const { return m_results; }
+
+private:
+    qint64 calibrate(const Body& body, const Reset& reset) const;
+    void printResult(const BenchmarkResult& result) const;
+
+    QString m_filter;
+    qint64 m_minTimeNs;
+    int m_samples;
+    QString m_jsonPath;
+    QString m_baselinePath;
+    bool m_failOnAllocationRegression;
+    QList<BenchmarkResult> m_results;
+};
+
+// 防止被测结果被编译器优化掉
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
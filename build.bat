@@ -78,6 +78,7 @@ if %errorlevel% neq 0 (
 rem 配置项目
 echo 配置项目...
 set CMAKE_ARGS=-DCMAKE_BUILD_TYPE=%BUILD_TYPE% %GENERATOR%
+if "%2"=="test" set CMAKE_ARGS=%CMAKE_ARGS% -DBUILD_TESTS=ON
 
 echo 执行CMake配置: cmake %CMAKE_ARGS% ..
 cmake %CMAKE_ARGS% ..
@@ -135,7 +136,7 @@ echo ==========================================
 rem 可选：运行测试
 if "%2"=="test" (
     echo 运行测试...
-    ctest --output-on-failure
+    ctest -C %BUILD_TYPE% --output-on-failure
     if %errorlevel% neq 0 (
         echo 警告: 测试失败
     ) else (
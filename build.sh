@@ -52,6 +52,11 @@ echo "CMake版本: $CMAKE_VERSION"
 echo "配置项目..."
 cmake_args="-DCMAKE_BUILD_TYPE=$BUILD_TYPE"
 
+# 运行测试时一并构建单元测试和性能回归测试
+if [ "$2" = "test" ]; then
+    cmake_args="$cmake_args -DBUILD_TESTS=ON"
+fi
+
 # 根据操作系统添加特定配置
 case $OS in
     "Darwin")
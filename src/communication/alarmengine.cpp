@@ -0,0 +1,393 @@
+#include "alarmengine.h"
+#include "logmanager.h"
+#include <QMutexLocker>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AlarmEngine* AlarmEngine::instance = nullptr;
+QMutex AlarmEngine::mutex;
+
+namespace {
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr int SENSOR_FRAME_MIN_LENGTH = 32;     // 7 个 float + 状态字节，与 DataMonitorWidget 的解析一致
+
+// 保留状态用的键：组名和报警名都不含换行
+inline QString stateKey(const QString& group, const QString& name)
+{
+    return group + QLatin1Char('\n') + name;
+}
+
+inline qint8 severity(qint8 state)
+{
+    return state < 0 ? qint8(-state) : state;
+}
+}
+
+AlarmEngine::AlarmEngine()
+    : QObject(nullptr)
+    , m_evaluatedRows(0)
+    , m_transitionCount(0)
+{
+    qRegisterMetaType<AlarmTransitionBatch>("AlarmTransitionBatch");
+
+    // 内置传感器通道，序号与 SensorInput 一致
+    registerInput("positionX");
+    registerInput("positionY");
+    registerInput("positionZ");
+    registerInput("velocity");
+    registerInput("pressure");
+    registerInput("temperature");
+    registerInput("glueVolume");
+}
+
+AlarmEngine* AlarmEngine::getInstance()
+{
+    QMutexLocker locker(&mutex);
+    if (!instance) {
+        instance = new AlarmEngine();
+    }
+    return instance;
+}
+
+int AlarmEngine::registerInput(const QString& name)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_inputIndex.constFind(name);
+    if (it != m_inputIndex.constEnd()) {
+        return it.value();
+    }
+    const int index = m_inputs.size();
+    m_inputs.append(name);
+    m_inputIndex.insert(name, index);
+    // 之前因输入通道不存在而被忽略的限值现在可能生效
+    if (!m_groups.isEmpty()) {
+        rebuildLocked(m_groups);
+    }
+    return index;
+}
+
+int AlarmEngine::inputIndex(const QString& name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inputIndex.value(name, -1);
+}
+
+int AlarmEngine::inputCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inputs.size();
+}
+
+int AlarmEngine::setLimits(const QString& group, const QList<AlarmLimit>& limits)
+{
+    QMutexLocker locker(&m_mutex);
+    if (limits.isEmpty()) {
+        m_groups.remove(group);
+    } else {
+        m_groups.insert(group, limits);
+    }
+    rebuildLocked(m_groups);
+
+    int count = 0;
+    for (const LimitInfo& info : m_info) {
+        if (info.group == group) {
+            ++count;
+        }
+    }
+    LOG_DEBUG("AlarmEngine", QString("报警限值组 %1 已更新: %2/%3 个生效").arg(group).arg(count).arg(limits.size()));
+    return count;
+}
+
+void AlarmEngine::clearLimits(const QString& group)
+{
+    setLimits(group, QList<AlarmLimit>());
+}
+
+int AlarmEngine::limitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_info.size());
+}
+
+AlarmLimitState AlarmEngine::state(const QString& group, const QString& name) const
+{
+    QMutexLocker locker(&m_mutex);
+    for (size_t i = 0; i < m_info.size(); ++i) {
+        if (m_info[i].group == group && m_info[i].name == name) {
+            return static_cast<AlarmLimitState>(m_state[i]);
+        }
+    }
+    return AlarmLimitState::Normal;
+}
+
+void AlarmEngine::rebuildLocked(const QHash<QString, QList<AlarmLimit>>& groups)
+{
+    // 记录当前状态，重建后按组名和报警名恢复
+    struct SavedState {
+        qint8 state;
+        qint8 pending;
+        qint64 pendingSinceNs;
+    };
+    QHash<QString, SavedState> saved;
+    saved.reserve(static_cast<int>(m_info.size()));
+    for (size_t i = 0; i < m_info.size(); ++i) {
+        saved.insert(stateKey(m_info[i].group, m_info[i].name), SavedState{m_state[i], m_pending[i], m_pendingSinceNs[i]});
+    }
+
+    m_input.clear();
+    m_highHigh.clear();
+    m_high.clear();
+    m_low.clear();
+    m_lowLow.clear();
+    m_highHighHold.clear();
+    m_highHold.clear();
+    m_lowHold.clear();
+    m_lowLowHold.clear();
+    m_delayNs.clear();
+    m_state.clear();
+    m_pending.clear();
+    m_pendingSinceNs.clear();
+    m_info.clear();
+
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        for (const AlarmLimit& limit : it.value()) {
+            const int input = m_inputIndex.value(limit.input, -1);
+            if (input < 0 || !(limit.enableHighHigh || limit.enableHigh || limit.enableLow || limit.enableLowLow)) {
+                continue;
+            }
+
+            // 只启用了高高限（或低低限）时，越过它直接进入高高（低低）状态
+            const double highHigh = limit.enableHighHigh ? limit.highHigh : INF;
+            const double high = limit.enableHigh ? limit.high : highHigh;
+            const double lowLow = limit.enableLowLow ? limit.lowLow : -INF;
+            const double low = limit.enableLow ? limit.low : lowLow;
+            const double deadband = std::max(0.0, limit.deadband);
+
+            m_input.push_back(input);
+            m_highHigh.push_back(highHigh);
+            m_high.push_back(high);
+            m_low.push_back(low);
+            m_lowLow.push_back(lowLow);
+            m_highHighHold.push_back(highHigh - deadband);
+            m_highHold.push_back(high - deadband);
+            m_lowHold.push_back(low + deadband);
+            m_lowLowHold.push_back(lowLow + deadband);
+            m_delayNs.push_back(qint64(std::max(0, limit.delayMs)) * 1000000);
+
+            const SavedState previous = saved.value(stateKey(it.key(), limit.name), SavedState{0, 0, 0});
+            m_state.push_back(previous.state);
+            m_pending.push_back(previous.pending);
+            m_pendingSinceNs.push_back(previous.pendingSinceNs);
+            m_info.push_back(LimitInfo{it.key(), limit.name, limit.alarmType, limit.alarmLevel});
+        }
+    }
+
+    const size_t count = m_info.size();
+    if (m_values.size() < count) {
+        m_values.resize(count);
+        m_enter.resize(count);
+        m_hold.resize(count);
+    }
+}
+
+void AlarmEngine::evaluate(const double* rows, int rowCount, int stride, const qint64* timestampsNs)
+{
+    if (!rows || rowCount <= 0 || stride <= 0) {
+        return;
+    }
+
+    AlarmTransitionBatch batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        evaluateLocked(rows, rowCount, stride, timestampsNs);
+        batch = takeTransitionsLocked();
+    }
+    if (!batch.isEmpty()) {
+        emit transitionsReady(batch);
+    }
+}
+
+AlarmTransitionBatch AlarmEngine::takeTransitionsLocked()
+{
+    // 只有出现状态变化时才分配，临时数组保留容量
+    AlarmTransitionBatch batch;
+    if (m_transitions.empty()) {
+        return batch;
+    }
+    batch.reserve(static_cast<int>(m_transitions.size()));
+    for (AlarmTransition& transition : m_transitions) {
+        batch.append(std::move(transition));
+    }
+    m_transitions.clear();
+    return batch;
+}
+
+void AlarmEngine::evaluateLocked(const double* rows, int rowCount, int stride, const qint64* timestampsNs)
+{
+    m_evaluatedRows += rowCount;
+    const size_t count = m_info.size();
+    if (count == 0) {
+        return;
+    }
+
+    const int* input = m_input.data();
+    const double* highHigh = m_highHigh.data();
+    const double* high = m_high.data();
+    const double* low = m_low.data();
+    const double* lowLow = m_lowLow.data();
+    const double* highHighHold = m_highHighHold.data();
+    const double* highHold = m_highHold.data();
+    const double* lowHold = m_lowHold.data();
+    const double* lowLowHold = m_lowLowHold.data();
+    double* values = m_values.data();
+    qint8* enter = m_enter.data();
+    qint8* hold = m_hold.data();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    for (int r = 0; r < rowCount; ++r) {
+        const double* row = rows + qint64(r) * stride;
+        const qint64 timestampNs = timestampsNs ? timestampsNs[r] : ProtocolFrame::currentTimestampNs();
+
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = input[i] < stride ? row[input[i]] : nan;
+        }
+
+        // 无分支比较：越限等级为 -2..2，NaN 与任何值比较都为假，得到 0
+        for (size_t i = 0; i < count; ++i) {
+            const double v = values[i];
+            enter[i] = qint8(int(v > high[i]) + int(v > highHigh[i]) - int(v < low[i]) - int(v < lowLow[i]));
+            hold[i] = qint8(int(v > highHold[i]) + int(v > highHighHold[i]) - int(v < lowHold[i]) - int(v < lowLowHold[i]));
+        }
+
+        // 状态机：只在回差范围内保持当前状态，升级需要持续 delay，降级立即生效
+        for (size_t i = 0; i < count; ++i) {
+            const double v = values[i];
+            if (std::isnan(v)) {
+                continue;
+            }
+            const qint8 current = m_state[i];
+            const qint8 desired = current >= 0 ? std::max(enter[i], std::min(hold[i], current))
+                                               : std::min(enter[i], std::max(hold[i], current));
+            if (desired == current) {
+                m_pending[i] = current;
+                continue;
+            }
+
+            const bool escalate = desired != 0
+                && (severity(desired) > severity(current) || (desired > 0) != (current > 0));
+            if (escalate && m_delayNs[i] > 0) {
+                if (m_pending[i] != desired) {
+                    m_pending[i] = desired;
+                    m_pendingSinceNs[i] = timestampNs;
+                    continue;
+                }
+                if (timestampNs - m_pendingSinceNs[i] < m_delayNs[i]) {
+                    continue;
+                }
+            }
+
+            m_state[i] = desired;
+            m_pending[i] = desired;
+            ++m_transitionCount;
+
+            const LimitInfo& info = m_info[i];
+            AlarmTransition transition;
+            transition.group = info.group;
+            transition.name = info.name;
+            transition.from = static_cast<AlarmLimitState>(current);
+            transition.to = static_cast<AlarmLimitState>(desired);
+            transition.value = v;
+            transition.limit = limitFor(i, desired != 0 ? desired : current);
+            transition.timestampNs = timestampNs;
+            transition.alarmType = info.alarmType;
+            transition.alarmLevel = info.alarmLevel;
+            m_transitions.push_back(std::move(transition));
+        }
+    }
+}
+
+double AlarmEngine::limitFor(size_t index, qint8 state) const
+{
+    switch (static_cast<AlarmLimitState>(state)) {
+    case AlarmLimitState::HighHigh:
+        return m_highHigh[index];
+    case AlarmLimitState::High:
+        return m_high[index];
+    case AlarmLimitState::Low:
+        return m_low[index];
+    case AlarmLimitState::LowLow:
+        return m_lowLow[index];
+    case AlarmLimitState::Normal:
+        break;
+    }
+    return 0;
+}
+
+void AlarmEngine::evaluateFrames(const FrameBatch& frames)
+{
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    AlarmTransitionBatch batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        const size_t needed = size_t(frames.size());
+        if (m_frameTimes.size() < needed) {
+            m_frameRows.resize(needed * SensorInputCount);
+            m_frameTimes.resize(needed);
+        }
+        int rowCount = 0;
+        for (const ProtocolFrame& frame : frames) {
+            if (decodeSensorFrame(frame, m_frameRows.data() + size_t(rowCount) * SensorInputCount)) {
+                m_frameTimes[size_t(rowCount)] = frame.timestampNs > 0 ? frame.timestampNs
+                                                                       : ProtocolFrame::currentTimestampNs();
+                ++rowCount;
+            }
+        }
+        if (rowCount == 0) {
+            return;
+        }
+        evaluateLocked(m_frameRows.data(), rowCount, SensorInputCount, m_frameTimes.data());
+        batch = takeTransitionsLocked();
+    }
+    if (!batch.isEmpty()) {
+        emit transitionsReady(batch);
+    }
+}
+
+void AlarmEngine::evaluateFrame(const ProtocolFrame& frame)
+{
+    double values[SensorInputCount];
+    if (!decodeSensorFrame(frame, values)) {
+        return;
+    }
+    const qint64 timestampNs = frame.timestampNs > 0 ? frame.timestampNs : ProtocolFrame::currentTimestampNs();
+    evaluate(values, 1, SensorInputCount, &timestampNs);
+}
+
+bool AlarmEngine::decodeSensorFrame(const ProtocolFrame& frame, double* values)
+{
+    if (frame.command != ProtocolCommand::ReadSensorData || frame.dataLength < SENSOR_FRAME_MIN_LENGTH) {
+        return false;
+    }
+    const uchar* data = reinterpret_cast<const uchar*>(frame.data);
+    for (int i = 0; i < SensorInputCount; ++i) {
+        values[i] = qFromLittleEndian<float>(data + i * sizeof(float));
+    }
+    return true;
+}
+
+qint64 AlarmEngine::evaluatedRows() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_evaluatedRows;
+}
+
+qint64 AlarmEngine::transitionCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_transitionCount;
+}
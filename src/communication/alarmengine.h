@@ -0,0 +1,158 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+#include "protocolparser.h"
+
+// 一个通道上的报警限值（由报警页的阈值或监控页的告警阈值转换而来）
+struct AlarmLimit {
+    QString name;                   // 报警名称（通常为参数名），在同一组内唯一
+    QString input;                  // 输入通道名，见 AlarmEngine::registerInput()
+    int alarmType = 0;
+    int alarmLevel = 1;
+    double highHigh = 0;
+    double high = 0;
+    double low = 0;
+    double lowLow = 0;
+    bool enableHighHigh = false;
+    bool enableHigh = false;
+    bool enableLow = false;
+    bool enableLowLow = false;
+    double deadband = 0;            // 回差：离开报警状态时必须回到限值以内这么多
+    int delayMs = 0;                // 进入或升级报警状态前必须持续的时间
+};
+
+// 限值状态，绝对值越大越严重
+enum class AlarmLimitState : qint8 {
+    LowLow = -2,
+    Low = -1,
+    Normal = 0,
+    High = 1,
+    HighHigh = 2
+};
+
+// 一次状态变化
+struct AlarmTransition {
+    QString group;
+    QString name;
+    AlarmLimitState from = AlarmLimitState::Normal;
+    AlarmLimitState to = AlarmLimitState::Normal;
+    double value = 0;               // 触发变化的采样值
+    double limit = 0;               // 越过的限值；回到正常时为离开的那个限值
+    qint64 timestampNs = 0;         // 采样的单调时钟时间
+    int alarmType = 0;
+    int alarmLevel = 1;
+};
+using AlarmTransitionBatch = QVector<AlarmTransition>;
+Q_DECLARE_METATYPE(AlarmTransitionBatch)
+
+// 报警评估引擎
+//
+// 在数据处理侧（接收线程）评估所有限值，界面只收到状态变化。限值按结构数组存放（每个字段一个连续数组，
+// 禁用的限值为正负无穷），一批采样的每一行先用一遍无分支的比较算出所有限值的越限等级和保持等级，
+// 这一遍可以被编译器向量化；之后逐个限值运行回差和延时状态机，只读写预先分配的数组，
+// 稳定运行时评估不分配内存。有变化时整批通过 transitionsReady 发出（跨线程为排队连接）。
+// 限值按组整体替换（报警页、监控页各一组），替换时保留同组同名限值的当前状态。可在任意线程调用。
+class AlarmEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 传感器帧各字段对应的内置输入通道，顺序与帧数据区一致
+    enum SensorInput {
+        PositionX = 0,
+        PositionY,
+        PositionZ,
+        Velocity,
+        Pressure,
+        Temperature,
+        GlueVolume,
+        SensorInputCount
+    };
+
+    static AlarmEngine* getInstance();
+
+    // 输入通道：返回序号，已存在时返回原序号；evaluate() 每行第 i 个值属于序号为 i 的通道
+    int registerInput(const QString& name);
+    int inputIndex(const QString& name) const;
+    int inputCount() const;
+
+    // 替换一组限值；输入通道不存在的限值被忽略，返回实际生效的个数
+    int setLimits(const QString& group, const QList<AlarmLimit>& limits);
+    void clearLimits(const QString& group);
+    int limitCount() const;
+    AlarmLimitState state(const QString& group, const QString& name) const;
+
+    // rows 为 rowCount 行、每行 stride 个值，按输入通道序号排列；NaN 表示该行没有这个通道的值
+    void evaluate(const double* rows, int rowCount, int stride, const qint64* timestampsNs);
+    // 解析传感器数据帧（ReadSensorData）后评估，其他帧被跳过
+    void evaluateFrames(const FrameBatch& frames);
+    void evaluateFrame(const ProtocolFrame& frame);
+
+    // 把传感器帧数据区解码为 SensorInputCount 个值，不是传感器数据帧时返回 false
+    static bool decodeSensorFrame(const ProtocolFrame& frame, double* values);
+
+    qint64 evaluatedRows() const;
+    qint64 transitionCount() const;
+
+signals:
+    void transitionsReady(const AlarmTransitionBatch& transitions);
+
+private:
+    struct LimitInfo {
+        QString group;
+        QString name;
+        int alarmType;
+        int alarmLevel;
+    };
+
+    AlarmEngine();
+
+    // 以下在持有 m_mutex 时调用
+    void rebuildLocked(const QHash<QString, QList<AlarmLimit>>& groups);
+    void evaluateLocked(const double* rows, int rowCount, int stride, const qint64* timestampsNs);
+    double limitFor(size_t index, qint8 state) const;
+    AlarmTransitionBatch takeTransitionsLocked();
+
+    mutable QMutex m_mutex;
+    QStringList m_inputs;
+    QHash<QString, int> m_inputIndex;
+    QHash<QString, QList<AlarmLimit>> m_groups;     // 按组保存的原始配置，重建时使用
+
+    // 每个限值一项的结构数组
+    std::vector<int> m_input;
+    std::vector<double> m_highHigh;         // 进入判断用的有效限值，禁用时为正负无穷
+    std::vector<double> m_high;
+    std::vector<double> m_low;
+    std::vector<double> m_lowLow;
+    std::vector<double> m_highHighHold;     // 保持判断用的限值（扣除回差）
+    std::vector<double> m_highHold;
+    std::vector<double> m_lowHold;
+    std::vector<double> m_lowLowHold;
+    std::vector<qint64> m_delayNs;
+    std::vector<qint8> m_state;
+    std::vector<qint8> m_pending;           // 等待延时到期的目标状态
+    std::vector<qint64> m_pendingSinceNs;
+    std::vector<LimitInfo> m_info;
+
+    // 评估用的临时数组，只增不减
+    std::vector<double> m_values;
+    std::vector<qint8> m_enter;
+    std::vector<qint8> m_hold;
+    std::vector<double> m_frameRows;
+    std::vector<qint64> m_frameTimes;
+    std::vector<AlarmTransition> m_transitions;
+
+    qint64 m_evaluatedRows;
+    qint64 m_transitionCount;
+
+    static AlarmEngine* instance;
+    static QMutex mutex;
+};
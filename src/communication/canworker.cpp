@@ -1,10 +1,14 @@
 #include "canworker.h"
+#include "utils/allocationtracker.h"
+#include "utils/threadpolicy.h"
 #include <QCanBus>
 #include <QCanBusDeviceInfo>
 #include <QCanBusFrame>
 #include <QDebug>
 #include <QJsonDocument>
 #include <QLoggingCategory>
+#include <QMetaMethod>
+#include <vector>
 
 Q_LOGGING_CATEGORY(canWorker, "communication.can")
 
@@ -13,6 +17,13 @@ CanWorker::CanWorker(QObject *parent)
     , m_canDevice(nullptr)
     , m_bitrate(250000)
     , m_deviceStatus(CanDeviceStatus::Disconnected)
+    , m_acceptAllMessages(true)
+    , m_txSequence(0)
+    , m_txPumpTimer(new QTimer(this))
+    , m_busLoadTimer(new QTimer(this))
+    , m_busBitsInWindow(0)
+    , m_busUtilization(0.0)
+    , m_batchArena(Communication::CAN_RX_ARENA_SIZE)
     , m_heartbeatTimer(new QTimer(this))
     , m_timeoutTimer(new QTimer(this))
     , m_reconnectTimer(new QTimer(this))
@@ -24,15 +35,18 @@ CanWorker::CanWorker(QObject *parent)
     , m_sentMessageCount(0)
     , m_receivedMessageCount(0)
     , m_errorCount(0)
+    , m_lastMessageNs(0)
     , m_isRunning(false)
     , m_isConnected(false)
     , m_reconnectAttempts(0)
 {
+    m_txClock.start();
     setupTimers();
 }
 
 CanWorker::~CanWorker()
 {
+    m_captureWriter.reset();
     stopWorker();
     disconnectFromDevice();
 }
@@ -68,6 +82,8 @@ bool CanWorker::connectToDevice(const QString& plugin, const QString& interface,
             this, &CanWorker::onErrorOccurred);
     connect(m_canDevice, &QCanBusDevice::stateChanged,
             this, &CanWorker::onStateChanged);
+    connect(m_canDevice, &QCanBusDevice::framesWritten,
+            this, &CanWorker::pumpTxQueue);
 
     // 连接设备
     if (!m_canDevice->connectDevice()) {
@@ -82,6 +98,9 @@ bool CanWorker::connectToDevice(const QString& plugin, const QString& interface,
     m_isConnected = true;
     m_deviceStatus = CanDeviceStatus::Connected;
     m_reconnectAttempts = 0;
+    m_busBitsInWindow = 0;
+    m_busUtilization = 0.0;
+    m_busLoadTimer->start(Communication::CAN_BUS_LOAD_WINDOW_MS);
     
     qCInfo(canWorker, "Connected to CAN device: %s %s at %d bps", qPrintable(plugin), qPrintable(interface), bitrate);
     emit deviceConnected(QString("%1:%2").arg(plugin, interface));
@@ -91,6 +110,9 @@ bool CanWorker::connectToDevice(const QString& plugin, const QString& interface,
 
 void CanWorker::disconnectFromDevice()
 {
+    clearTxQueue();
+    m_busLoadTimer->stop();
+    
     if (m_canDevice) {
         m_canDevice->disconnectDevice();
         delete m_canDevice;
@@ -121,8 +143,54 @@ bool CanWorker::sendMessage(quint32 canId, const QByteArray& data, bool isExtend
         return false;
     }
 
-    QCanBusFrame frame(canId, data);
-    frame.setExtendedFrameFormat(isExtended);
+    CanMessage message;
+    message.canId = canId;
+    message.data = data;
+    message.timestampNs = MonotonicClock::nowNs();
+    message.isExtended = isExtended;
+    message.isRemote = false;
+    message.isError = false;
+    
+    const CanTxClass txClass = txClassOf(canId);
+    
+    // 紧急停止不排队，直接写入驱动
+    if (txClass == CanTxClass::Emergency) {
+        return writeCanMessage(message);
+    }
+    
+    // 心跳只保留同ID的最新一帧
+    if (txClass == CanTxClass::Heartbeat) {
+        auto pending = m_pendingHeartbeats.constFind(canId);
+        if (pending != m_pendingHeartbeats.constEnd()) {
+            m_txQueue[pending.value()].message = message;
+            m_txMetrics.coalescedFrames++;
+            return true;
+        }
+    }
+    
+    if (m_txQueue.size() >= Communication::CAN_TX_MAX_PENDING) {
+        m_txMetrics.droppedFrames++;
+        qCWarning(canWorker, "CAN TX queue full, frame 0x%x rejected", canId);
+        return false;
+    }
+    
+    const quint64 key = (static_cast<quint64>(txClass) << 61)
+                      | (static_cast<quint64>(canId & CAN_ID_MASK) << 32)
+                      | m_txSequence++;
+    m_txQueue.insert(key, PendingTxFrame{message, m_txClock.elapsed(), false});
+    if (txClass == CanTxClass::Heartbeat) {
+        m_pendingHeartbeats.insert(canId, key);
+    }
+    m_txMetrics.peakQueueDepth = qMax(m_txMetrics.peakQueueDepth, static_cast<int>(m_txQueue.size()));
+    
+    pumpTxQueue();
+    return true;
+}
+
+bool CanWorker::writeCanMessage(const CanMessage& message)
+{
+    QCanBusFrame frame(message.canId, message.data);
+    frame.setExtendedFrameFormat(message.isExtended);
     
     if (!m_canDevice->writeFrame(frame)) {
         qCWarning(canWorker, "Failed to write CAN frame: %s", qPrintable(m_canDevice->errorString()));
@@ -130,15 +198,13 @@ bool CanWorker::sendMessage(quint32 canId, const QByteArray& data, bool isExtend
         return false;
     }
     
+    m_busBitsInWindow += estimateFrameBits(message.data.size(), message.isExtended);
     updateStatistics(true, false);
     
-    CanMessage message;
-    message.canId = canId;
-    message.data = data;
-    message.timestamp = QDateTime::currentDateTime();
-    message.isExtended = isExtended;
-    message.isRemote = false;
-    message.isError = false;
+    if (m_captureWriter) {
+        m_captureWriter->recordCanFrame(message.canId, message.data,
+            CaptureFlags::Transmit | (message.isExtended ? CaptureFlags::Extended : 0));
+    }
     
     logMessage(message, true);
     emit messageSent(message);
@@ -146,6 +212,106 @@ bool CanWorker::sendMessage(quint32 canId, const QByteArray& data, bool isExtend
     return true;
 }
 
+void CanWorker::pumpTxQueue()
+{
+    if (m_txQueue.isEmpty() || !isConnected()) {
+        return;
+    }
+    
+    const qint64 now = m_txClock.elapsed();
+    const bool busBusy = m_busUtilization > Communication::CAN_TX_DEFER_LOAD;
+    
+    while (!m_txQueue.isEmpty()
+           && m_canDevice->framesToWrite() < Communication::CAN_TX_DEVICE_QUEUE_LIMIT) {
+        auto it = m_txQueue.begin();
+        
+        // 可推迟类排在最后：总线繁忙时只放行等待超过上限的帧，其余等负载回落
+        if (busBusy && static_cast<CanTxClass>(it.key() >> 61) >= CanTxClass::Parameter) {
+            for (; it != m_txQueue.end(); ++it) {
+                if (now - it->enqueuedMs >= Communication::CAN_TX_MAX_DEFER_MS) {
+                    break;
+                }
+                if (!it->deferred) {
+                    it->deferred = true;
+                    m_txMetrics.deferredFrames++;
+                }
+            }
+            if (it == m_txQueue.end()) {
+                break;
+            }
+        }
+        
+        const CanMessage message = it->message;
+        if (static_cast<CanTxClass>(it.key() >> 61) == CanTxClass::Heartbeat) {
+            m_pendingHeartbeats.remove(message.canId);
+        }
+        m_txQueue.erase(it);
+        
+        writeCanMessage(message);
+    }
+    
+    // 驱动队列满或有帧被推迟时稍后再试（framesWritten 也会触发）
+    if (!m_txQueue.isEmpty() && !m_txPumpTimer->isActive()) {
+        m_txPumpTimer->start(busBusy ? Communication::CAN_BUS_LOAD_WINDOW_MS / 10 : 1);
+    }
+}
+
+void CanWorker::clearTxQueue()
+{
+    m_txQueue.clear();
+    m_pendingHeartbeats.clear();
+    m_txPumpTimer->stop();
+}
+
+void CanWorker::onBusLoadTimer()
+{
+    // 窗口内收发位数 / 窗口容量，做一阶平滑
+    const double capacity = m_bitrate * Communication::CAN_BUS_LOAD_WINDOW_MS / 1000.0;
+    const double load = capacity > 0 ? qMin(1.0, m_busBitsInWindow / capacity) : 0.0;
+    m_busUtilization = m_busUtilization * 0.5 + load * 0.5;
+    m_busBitsInWindow = 0;
+    
+    pumpTxQueue();
+}
+
+CanTxMetrics CanWorker::getTxMetrics() const
+{
+    CanTxMetrics metrics = m_txMetrics;
+    metrics.queueDepth = m_txQueue.size();
+    metrics.busUtilization = m_busUtilization;
+    return metrics;
+}
+
+CanMessageType CanWorker::messageTypeOf(quint32 canId)
+{
+    // 紧急停止使用 0x080 段，高字节为0，需单独识别
+    if ((canId & 0xFF00) == 0 && (canId & 0xFF80) == static_cast<quint32>(CanMessageType::Emergency)) {
+        return CanMessageType::Emergency;
+    }
+    return static_cast<CanMessageType>(canId & 0xFF00);
+}
+
+CanTxClass CanWorker::txClassOf(quint32 canId)
+{
+    switch (messageTypeOf(canId)) {
+    case CanMessageType::Emergency:     return CanTxClass::Emergency;
+    case CanMessageType::MotionControl: return CanTxClass::Motion;
+    case CanMessageType::GlueControl:   return CanTxClass::Glue;
+    case CanMessageType::AlarmReport:   return CanTxClass::Alarm;
+    case CanMessageType::ParameterSet:  return CanTxClass::Parameter;
+    case CanMessageType::Heartbeat:     return CanTxClass::Heartbeat;
+    default:                            return CanTxClass::Status;
+    }
+}
+
+int CanWorker::estimateFrameBits(int dataLength, bool isExtended)
+{
+    // 帧头/CRC/ACK/EOF/帧间隔固定位 + 数据位 + 可填充区域的最坏填充位
+    const int fixedBits = isExtended ? 67 : 47;
+    const int stuffableBits = (isExtended ? 54 : 34) + 8 * dataLength;
+    return fixedBits + 8 * dataLength + (stuffableBits - 1) / 4;
+}
+
 bool CanWorker::sendMotionControl(quint8 deviceId, quint8 command, const QByteArray& parameters)
 {
     quint32 canId = static_cast<quint32>(CanMessageType::MotionControl) + deviceId;
@@ -192,6 +358,9 @@ void CanWorker::startWorker()
     
     m_isRunning = true;
     
+    // 移入独立线程时在此应用调度策略，留在主线程时不调整
+    ThreadPolicy::getInstance()->applyToCurrentThread(ThreadRole::CanIo);
+    
     if (m_autoReconnect) {
         m_heartbeatTimer->start(m_heartbeatInterval);
         m_timeoutTimer->start(m_timeoutInterval);
@@ -221,29 +390,67 @@ void CanWorker::onFramesReceived()
         return;
     }
     
-    while (m_canDevice->framesAvailable()) {
-        QCanBusFrame frame = m_canDevice->readFrame();
+    // 一次取出驱动缓冲中的全部帧，整批处理
+    const QList<QCanBusFrame> frames = m_canDevice->readAllFrames();
+    if (frames.isEmpty()) {
+        return;
+    }
+    
+    // 本批的临时数据在批结束时随内存区一起回收
+    ArenaScope batchScope(m_batchArena);
+    ALLOCATION_SCOPE("can.receive");
+    
+    // 同一批帧由一次读取得到，共用一个时间戳
+    const qint64 timestampNs = MonotonicClock::nowNs();
+    QList<CanMessage> messages;
+    messages.reserve(frames.size());
+    int errorFrames = 0;
+    
+    for (const QCanBusFrame& frame : frames) {
+        if (frame.frameType() == QCanBusFrame::ErrorFrame) {
+            qCWarning(canWorker, "Received CAN error frame: %s", qPrintable(frame.toString()));
+            ++errorFrames;
+            continue;
+        }
+        
+        m_busBitsInWindow += estimateFrameBits(frame.payload().size(), frame.hasExtendedFrameFormat());
+        
+        if (m_captureWriter) {
+            quint8 flags = frame.hasExtendedFrameFormat() ? CaptureFlags::Extended : 0;
+            if (frame.frameType() == QCanBusFrame::RemoteRequestFrame) {
+                flags |= CaptureFlags::Remote;
+            }
+            m_captureWriter->recordCanFrame(frame.frameId(), frame.payload(), flags);
+        }
         
         CanMessage message;
         message.canId = frame.frameId();
         message.data = frame.payload();
-        message.timestamp = QDateTime::currentDateTime();
+        message.timestampNs = timestampNs;
         message.isExtended = frame.hasExtendedFrameFormat();
         message.isRemote = frame.frameType() == QCanBusFrame::RemoteRequestFrame;
-        message.isError = frame.frameType() == QCanBusFrame::ErrorFrame;
+        message.isError = false;
         
-        if (message.isError) {
-            qCWarning(canWorker, "Received CAN error frame: %s", qPrintable(frame.toString()));
-            updateStatistics(false, true);
-            continue;
-        }
-        
-        updateStatistics(false, false);
         logMessage(message, false);
-        
-        emit messageReceived(message);
-        processMessage(message);
+        messages.append(message);
+    }
+    
+    updateReceiveStatistics(messages.size(), errorFrames);
+    if (messages.isEmpty()) {
+        return;
+    }
+    
+    emit messagesReceived(messages);
+    
+    // 逐条信号只在有接收者时发出
+    static const QMetaMethod messageReceivedSignal = QMetaMethod::fromSignal(&CanWorker::messageReceived);
+    if (isSignalConnected(messageReceivedSignal)) {
+        for (const CanMessage& message : messages) {
+            emit messageReceived(message);
+        }
     }
+    
+    processMessages(messages);
 }
 
 void CanWorker::onErrorOccurred(QCanBusDevice::CanBusError error)
@@ -296,32 +503,91 @@ void CanWorker::processMessage(const CanMessage& message)
         return;
     }
     
-    // 根据消息类型处理
-    CanMessageType msgType = static_cast<CanMessageType>(message.canId & 0xFF00);
-    quint8 deviceId = static_cast<quint8>(message.canId & 0xFF);
+    dispatchMessage(message, decodeMessage(message));
+}
+
+void CanWorker::processMessages(const QList<CanMessage>& messages)
+{
+    // 整批只加一次过滤器锁；分发在锁外进行，避免直连槽函数修改过滤器时死锁
+    ArenaScope batchScope(m_batchArena);
+    std::pmr::vector<const CanMessage*> accepted(&m_batchArena);
+    accepted.reserve(messages.size());
+    {
+        QMutexLocker locker(&m_filtersMutex);
+        for (const CanMessage& message : messages) {
+            if (acceptsCanIdLocked(message.canId)) {
+                accepted.push_back(&message);
+            }
+        }
+    }
+    
+    for (const CanMessage* message : accepted) {
+        if (validateMessage(*message)) {
+            dispatchMessage(*message, decodeMessage(*message));
+        }
+    }
+}
+
+CanParsedMessage CanWorker::decodeMessage(const CanMessage& message)
+{
+    CanParsedMessage parsed;
+    parsed.type = messageTypeOf(message.canId);
+    parsed.deviceId = static_cast<quint8>(message.canId & (parsed.type == CanMessageType::Emergency ? 0x7F : 0xFF));
+    
+    parsed.command = message.data.isEmpty() ? 0 : static_cast<quint8>(message.data.at(0));
+    parsed.data = message.data;
+    return parsed;
+}
+
+void CanWorker::parseMessages(const QList<CanMessage>& messages, QList<CanParsedMessage>& parsed)
+{
+    parsed.reserve(parsed.size() + messages.size());
+    for (const CanMessage& message : messages) {
+        parsed.append(decodeMessage(message));
+    }
+}
+
+QJsonObject CanWorker::parseMessage(const CanMessage& message)
+{
+    const CanParsedMessage parsed = decodeMessage(message);
     
-    switch (msgType) {
+    QJsonObject json;
+    json["canId"] = formatCanId(message.canId);
+    json["type"] = getMessageTypeString(parsed.type);
+    json["deviceId"] = parsed.deviceId;
+    json["command"] = parsed.command;
+    json["data"] = formatData(message.data);
+    json["timestamp"] = MonotonicClock::dateTimeAt(message.timestampNs).toString(Qt::ISODateWithMs);
+    json["extended"] = message.isExtended;
+    json["remote"] = message.isRemote;
+    return json;
+}
+
+void CanWorker::dispatchMessage(const CanMessage& message, const CanParsedMessage& parsed)
+{
+    // 根据消息类型处理
+    switch (parsed.type) {
     case CanMessageType::MotionControl:
         processMotionControlMessage(message);
-        emit motionControlReceived(deviceId, message.data.at(0), message.data.mid(1));
+        emit motionControlReceived(parsed.deviceId, parsed.command, parsed.payload().toByteArray());
         break;
     case CanMessageType::GlueControl:
         processGlueControlMessage(message);
-        emit glueControlReceived(deviceId, message.data.at(0), message.data.mid(1));
+        emit glueControlReceived(parsed.deviceId, parsed.command, parsed.payload().toByteArray());
         break;
     case CanMessageType::SystemStatus:
         processSystemStatusMessage(message);
         break;
     case CanMessageType::Heartbeat:
         processHeartbeatMessage(message);
-        emit heartbeatReceived(deviceId);
+        emit heartbeatReceived(parsed.deviceId);
         break;
     case CanMessageType::Emergency:
         processEmergencyMessage(message);
-        emit emergencyStopReceived(deviceId);
+        emit emergencyStopReceived(parsed.deviceId);
         break;
     default:
-        qCDebug(canWorker, "Unknown message type: %d", static_cast<int>(msgType));
+        qCDebug(canWorker, "Unknown message type: %d", static_cast<int>(parsed.type));
         break;
     }
 }
@@ -341,6 +607,12 @@ void CanWorker::setupTimers()
     
     // 重连定时器
     connect(m_reconnectTimer, &QTimer::timeout, this, &CanWorker::onReconnectTimer);
+    
+    // 发送调度与总线负载统计
+    m_txPumpTimer->setSingleShot(true);
+    m_txPumpTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_txPumpTimer, &QTimer::timeout, this, &CanWorker::pumpTxQueue);
+    connect(m_busLoadTimer, &QTimer::timeout, this, &CanWorker::onBusLoadTimer);
 }
 
 void CanWorker::onHeartbeatTimer()
@@ -395,13 +667,21 @@ bool CanWorker::validateMessage(const CanMessage& message)
 bool CanWorker::checkMessageFilter(quint32 canId)
 {
     QMutexLocker locker(&m_filtersMutex);
+    return acceptsCanIdLocked(canId);
+}
+
+bool CanWorker::acceptsCanIdLocked(quint32 canId) const
+{
+    if (m_acceptAllMessages) {
+        return true;
+    }
     
-    if (m_messageFilters.isEmpty()) {
-        return true; // 没有过滤器，接受所有消息
+    if (m_exactFilterIds.contains(canId & CAN_ID_MASK)) {
+        return true;
     }
     
-    for (const auto& filter : m_messageFilters) {
-        if ((canId & filter.second) == (filter.first & filter.second)) {
+    for (const auto& rule : m_maskFilterRules) {
+        if ((canId & rule.second) == rule.first) {
             return true;
         }
     }
@@ -409,6 +689,43 @@ bool CanWorker::checkMessageFilter(quint32 canId)
     return false;
 }
 
+void CanWorker::rebuildMessageFilters()
+{
+    m_exactFilterIds.clear();
+    m_maskFilterRules.clear();
+    
+    // 没有过滤器，接受所有消息
+    m_acceptAllMessages = m_messageFilters.isEmpty();
+    
+    for (const auto& filter : m_messageFilters) {
+        const quint32 mask = filter.second;
+        if ((mask & CAN_ID_MASK) == 0) {
+            m_acceptAllMessages = true;
+        } else if ((mask & CAN_ID_MASK) == CAN_ID_MASK) {
+            m_exactFilterIds.insert(filter.first & CAN_ID_MASK);
+        } else {
+            const QPair<quint32, quint32> rule(filter.first & mask, mask);
+            if (!m_maskFilterRules.contains(rule)) {
+                m_maskFilterRules.append(rule);
+            }
+        }
+    }
+}
+
+void CanWorker::updateReceiveStatistics(int received, int errors)
+{
+    if (received + errors == 0) {
+        return;
+    }
+    
+    // 错误帧同样计入接收数，与 updateStatistics(false, true) 保持一致
+    m_receivedMessageCount += received + errors;
+    m_errorCount += errors;
+    m_lastMessageNs = MonotonicClock::nowNs();
+    
+    emit statisticsUpdated(m_sentMessageCount, m_receivedMessageCount, m_errorCount);
+}
+
 void CanWorker::updateStatistics(bool sent, bool error)
 {
     if (sent) {
@@ -421,7 +738,7 @@ void CanWorker::updateStatistics(bool sent, bool error)
         m_errorCount++;
     }
     
-    m_lastMessageTime = QDateTime::currentDateTime();
+    m_lastMessageNs = MonotonicClock::nowNs();
     
     emit statisticsUpdated(m_sentMessageCount, m_receivedMessageCount, m_errorCount);
 }
@@ -458,6 +775,26 @@ QString CanWorker::formatData(const QByteArray& data)
     return result;
 }
 
+QString CanWorker::formatCanId(quint32 canId)
+{
+    return "0x" + QString("%1").arg(canId, 3, 16, QChar('0')).toUpper();
+}
+
+QString CanWorker::getMessageTypeString(CanMessageType type)
+{
+    switch (type) {
+    case CanMessageType::MotionControl: return "运动控制";
+    case CanMessageType::GlueControl:   return "点胶控制";
+    case CanMessageType::SystemStatus:  return "系统状态";
+    case CanMessageType::ParameterSet:  return "参数设置";
+    case CanMessageType::DataQuery:     return "数据查询";
+    case CanMessageType::AlarmReport:   return "报警上报";
+    case CanMessageType::Heartbeat:     return "心跳包";
+    case CanMessageType::Emergency:     return "紧急停止";
+    }
+    return "未知";
+}
+
 void CanWorker::processMotionControlMessage(const CanMessage& message)
 {
     // 处理运动控制消息的具体逻辑
@@ -493,13 +830,47 @@ void CanWorker::resetStatistics()
     m_sentMessageCount = 0;
     m_receivedMessageCount = 0;
     m_errorCount = 0;
-    m_lastMessageTime = QDateTime::currentDateTime();
+    m_lastMessageNs = MonotonicClock::nowNs();
+}
+
+bool CanWorker::startCapture(const QString& filePath)
+{
+    // 写入器只在工作线程使用
+    if (QThread::currentThread() != thread()) {
+        bool result = false;
+        QMetaObject::invokeMethod(this, [this, &result, filePath]() { result = startCapture(filePath); },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+
+    auto writer = std::make_unique<LinkCaptureWriter>();
+    if (!writer->open(filePath, CaptureLinkType::Can, QString("%1/%2").arg(m_plugin, m_interface))) {
+        qCWarning(canWorker, "Failed to start CAN capture: %s", qPrintable(writer->lastError()));
+        return false;
+    }
+    m_captureWriter = std::move(writer);
+    return true;
+}
+
+void CanWorker::stopCapture()
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() { stopCapture(); }, Qt::BlockingQueuedConnection);
+        return;
+    }
+    m_captureWriter.reset();
+}
+
+bool CanWorker::isCapturing() const
+{
+    return m_captureWriter != nullptr;
 }
 
 void CanWorker::addMessageFilter(quint32 canId, quint32 mask)
 {
     QMutexLocker locker(&m_filtersMutex);
     m_messageFilters.append(qMakePair(canId, mask));
+    rebuildMessageFilters();
 }
 
 void CanWorker::removeMessageFilter(quint32 canId)
@@ -511,10 +882,12 @@ void CanWorker::removeMessageFilter(quint32 canId)
             break;
         }
     }
+    rebuildMessageFilters();
 }
 
 void CanWorker::clearMessageFilters()
 {
     QMutexLocker locker(&m_filtersMutex);
     m_messageFilters.clear();
+    rebuildMessageFilters();
 } 
\ No newline at end of file
@@ -7,6 +7,9 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QQueue>
+#include <QSet>
+#include <QList>
+#include <QByteArrayView>
 #include <QCanBusDevice>
 #include <QCanBusFrame>
 #include <QCanBusDeviceInfo>
@@ -14,6 +17,14 @@
 #include <QJsonDocument>
 #include <QDateTime>
 #include <QLoggingCategory>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QHash>
+#include <memory>
+#include "constants.h"
+#include "linkcapture.h"
+#include "utils/monotonicarena.h"
+#include "utils/monotonicclock.h"
 
 Q_DECLARE_LOGGING_CATEGORY(canWorker)
 
@@ -42,13 +53,44 @@ enum class CanDeviceStatus {
 struct CanMessage {
     quint32 canId;              // CAN ID
     QByteArray data;            // 数据
-    QDateTime timestamp;        // 时间戳
+    qint64 timestampNs;         // 收发时刻（MonotonicClock::nowNs()）
     bool isExtended;            // 是否扩展帧
     bool isRemote;              // 是否远程帧
     bool isError;               // 是否错误帧
     QString description;        // 消息描述
 };
 
+// 解码后的CAN消息 - 批量处理时使用，不为每帧构建 QJsonObject
+struct CanParsedMessage {
+    CanMessageType type;        // 消息类型
+    quint8 deviceId;            // 设备ID
+    quint8 command;             // 命令字（data[0]，空数据时为0）
+    QByteArray data;            // 原始数据（与源消息隐式共享，不复制）
+    
+    QByteArrayView payload() const { return QByteArrayView(data).sliced(qMin<qsizetype>(1, data.size())); }
+};
+
+// CAN发送优先级分类（数值越小越先发送，同类内按CAN ID仲裁顺序）
+enum class CanTxClass {
+    Emergency = 0,              // 紧急停止，绕过队列立即发送
+    Motion,                     // 运动控制
+    Glue,                       // 点胶控制
+    Alarm,                      // 报警上报
+    Status,                     // 状态/查询
+    Parameter,                  // 参数设置（总线繁忙时可推迟）
+    Heartbeat                   // 心跳（总线繁忙时可推迟，同ID只保留最新一帧）
+};
+
+// CAN发送调度指标
+struct CanTxMetrics {
+    int queueDepth = 0;         // 当前待发送帧数
+    int peakQueueDepth = 0;     // 峰值队列深度
+    double busUtilization = 0.0;// 总线利用率（0-1，收发合计）
+    qint64 deferredFrames = 0;  // 因负载被推迟过的帧数
+    qint64 droppedFrames = 0;   // 队列满被拒绝的帧数
+    qint64 coalescedFrames = 0; // 被同ID新帧替换的心跳数
+};
+
 // CAN设备信息
 struct CanDeviceInfo {
     QString name;               // 设备名称
@@ -100,6 +142,8 @@ public:
     
     // 数据处理
     QJsonObject parseMessage(const CanMessage& message);
+    static CanParsedMessage decodeMessage(const CanMessage& message);
+    static void parseMessages(const QList<CanMessage>& messages, QList<CanParsedMessage>& parsed);
     CanMessage createMessage(CanMessageType type, quint8 deviceId, const QByteArray& data);
     QByteArray encodeMotionCommand(quint8 command, double positionX, double positionY, double positionZ, double speed);
     QByteArray encodeGlueCommand(quint8 command, double volume, double pressure, double temperature);
@@ -111,16 +155,29 @@ public:
     int getErrorCount() const { return m_errorCount; }
     void resetStatistics();
     
+    // 发送调度
+    CanTxMetrics getTxMetrics() const;
+    int getTxQueueDepth() const { return m_txQueue.size(); }
+    double getBusUtilization() const { return m_busUtilization; }
+    static CanTxClass txClassOf(quint32 canId);
+    static int estimateFrameBits(int dataLength, bool isExtended);   // 含最坏位填充
+    
     // 配置管理
     void setHeartbeatInterval(int interval) { m_heartbeatInterval = interval; }
     void setTimeoutInterval(int interval) { m_timeoutInterval = interval; }
     void setAutoReconnect(bool enable) { m_autoReconnect = enable; }
     void setLogLevel(int level) { m_logLevel = level; }
+    
+    // 链路抓包：收发帧带时间戳写入抓包文件，从其他线程调用时同步转到工作线程执行
+    bool startCapture(const QString& filePath);
+    void stopCapture();
+    bool isCapturing() const;
 
 public slots:
     void startWorker();
     void stopWorker();
     void processMessage(const CanMessage& message);
+    void processMessages(const QList<CanMessage>& messages);
     void onDeviceTimeout(const QString& deviceName);
     void onHeartbeatTimer();
     void onReconnectTimer();
@@ -129,6 +186,8 @@ private slots:
     void onFramesReceived();
     void onErrorOccurred(QCanBusDevice::CanBusError error);
     void onStateChanged(QCanBusDevice::CanBusDeviceState state);
+    void pumpTxQueue();
+    void onBusLoadTimer();
 
 private:
     void initializeDevice();
@@ -146,6 +205,13 @@ private:
     
     bool validateMessage(const CanMessage& message);
     bool checkMessageFilter(quint32 canId);
+    bool acceptsCanIdLocked(quint32 canId) const;
+    void rebuildMessageFilters();
+    static CanMessageType messageTypeOf(quint32 canId);
+    void dispatchMessage(const CanMessage& message, const CanParsedMessage& parsed);
+    void updateReceiveStatistics(int received, int errors);
+    bool writeCanMessage(const CanMessage& message);
+    void clearTxQueue();
     void updateStatistics(bool sent, bool error = false);
     void logMessage(const CanMessage& message, bool sent);
     void handleDeviceError(const QString& error);
@@ -181,9 +247,39 @@ private:
     QWaitCondition m_sendCondition;
     
     // 消息过滤
+    // m_messageFilters 保存用户添加的原始规则；接收路径只查编译结果：
+    // 掩码覆盖全部29位ID的规则进入哈希表精确匹配，其余按掩码逐条比较
+    static constexpr quint32 CAN_ID_MASK = 0x1FFFFFFF;
     QList<QPair<quint32, quint32>> m_messageFilters; // ID, Mask
+    QSet<quint32> m_exactFilterIds;
+    QList<QPair<quint32, quint32>> m_maskFilterRules; // ID&Mask, Mask
+    bool m_acceptAllMessages;                        // 存在全通规则（掩码为0）
     QMutex m_filtersMutex;
     
+    // 发送调度：键为 类别(3位)|CAN ID(29位)|序号(32位)，QMap 的有序遍历即发送顺序
+    struct PendingTxFrame {
+        CanMessage message;
+        qint64 enqueuedMs;
+        bool deferred;                              // 已计入推迟统计
+    };
+    QMap<quint64, PendingTxFrame> m_txQueue;
+    QHash<quint32, quint64> m_pendingHeartbeats;    // CAN ID -> 队列键
+    quint32 m_txSequence;
+    QTimer* m_txPumpTimer;
+    QElapsedTimer m_txClock;
+    CanTxMetrics m_txMetrics;
+    
+    // 总线负载
+    QTimer* m_busLoadTimer;
+    qint64 m_busBitsInWindow;
+    double m_busUtilization;
+    
+    // 接收批内存区：一次读取的整批消息处理期间的临时数据（只在工作线程访问）
+    MonotonicArena m_batchArena;
+    
+    // 链路抓包（只在工作线程访问）
+    std::unique_ptr<LinkCaptureWriter> m_captureWriter;
+    
     // 定时器
     QTimer* m_heartbeatTimer;
     QTimer* m_timeoutTimer;
@@ -200,7 +296,7 @@ private:
     int m_sentMessageCount;
     int m_receivedMessageCount;
     int m_errorCount;
-    QDateTime m_lastMessageTime;
+    qint64 m_lastMessageNs;     // 单调时钟
     
     // 状态变量
     bool m_isRunning;
@@ -218,6 +314,7 @@ signals:
     void deviceError(const QString& deviceName, const QString& error);
     void deviceTimeout(const QString& deviceName);
     void messageReceived(const CanMessage& message);
+    void messagesReceived(const QList<CanMessage>& messages);   // 每次读取的整批消息
     void messageSent(const CanMessage& message);
     void motionControlReceived(quint8 deviceId, quint8 command, const QByteArray& data);
     void glueControlReceived(quint8 deviceId, quint8 command, const QByteArray& data);
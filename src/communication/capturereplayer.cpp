@@ -0,0 +1,217 @@
+#include "capturereplayer.h"
+#include "protocolparser.h"
+#include "dataprocessworker.h"
+#include "logmanager.h"
+#include <QMetaMethod>
+
+namespace {
+constexpr int FAST_REPLAY_BATCH = 256;      // 连续回放时每轮事件循环处理的记录数
+}
+
+CaptureReplayer::CaptureReplayer(QObject* parent)
+    : QObject(parent)
+    , m_mode(Mode::OriginalTiming)
+    , m_speedFactor(1.0)
+    , m_includeSent(false)
+    , m_replayTimer(new QTimer(this))
+    , m_firstTimestampNs(0)
+    , m_hasNext(false)
+    , m_running(false)
+{
+    qRegisterMetaType<ReplayStatistics>("ReplayStatistics");
+
+    m_replayTimer->setSingleShot(true);
+    m_replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_replayTimer, &QTimer::timeout, this, &CaptureReplayer::onReplayTimer);
+}
+
+CaptureReplayer::~CaptureReplayer()
+{
+    stop();
+}
+
+bool CaptureReplayer::open(const QString& filePath)
+{
+    stop();
+    if (!m_reader.open(filePath)) {
+        LogManager::getInstance()->error(m_reader.lastError(), "Replay");
+        return false;
+    }
+
+    LogManager::getInstance()->info(
+        QString("打开抓包: %1, 来源=%2, 大小=%3字节")
+        .arg(filePath, m_reader.source())
+        .arg(m_reader.fileSize()),
+        "Replay"
+    );
+    return true;
+}
+
+void CaptureReplayer::close()
+{
+    stop();
+    m_reader.close();
+}
+
+void CaptureReplayer::setParser(ProtocolParser* parser)
+{
+    m_parser = parser;
+}
+
+void CaptureReplayer::setDataProcessWorker(DataProcessWorker* worker)
+{
+    m_worker = worker;
+}
+
+void CaptureReplayer::start()
+{
+    if (!m_reader.isOpen() || m_running) {
+        return;
+    }
+
+    m_reader.rewind();
+    m_statistics = ReplayStatistics();
+    m_running = true;
+    m_hasNext = readNext();
+    m_firstTimestampNs = m_hasNext ? m_nextRecord.timestampNs : 0;
+    m_clock.start();
+    m_replayTimer->start(0);
+}
+
+void CaptureReplayer::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_replayTimer->stop();
+    m_running = false;
+    m_statistics.elapsedNs = m_clock.nsecsElapsed();
+}
+
+ReplayStatistics CaptureReplayer::replayAll()
+{
+    stop();
+    if (!m_reader.isOpen()) {
+        return ReplayStatistics();
+    }
+
+    m_reader.rewind();
+    m_statistics = ReplayStatistics();
+    m_hasNext = readNext();
+    m_firstTimestampNs = m_hasNext ? m_nextRecord.timestampNs : 0;
+    m_clock.start();
+
+    while (m_hasNext) {
+        deliver(m_nextRecord);
+        m_hasNext = readNext();
+    }
+
+    if (m_parser) {
+        m_parser->flushFrameBatch();
+    }
+    m_statistics.elapsedNs = m_clock.nsecsElapsed();
+    m_statistics.truncated = m_reader.isTruncated();
+    return m_statistics;
+}
+
+void CaptureReplayer::onReplayTimer()
+{
+    if (!m_running) {
+        return;
+    }
+
+    if (m_mode == Mode::AsFastAsPossible) {
+        for (int i = 0; i < FAST_REPLAY_BATCH && m_hasNext; ++i) {
+            deliver(m_nextRecord);
+            m_hasNext = readNext();
+        }
+    } else {
+        // 交付所有已到期的记录，然后定时到下一条
+        const qint64 elapsedNs = m_clock.nsecsElapsed();
+        while (m_hasNext) {
+            const qint64 dueNs = static_cast<qint64>((m_nextRecord.timestampNs - m_firstTimestampNs) / m_speedFactor);
+            if (dueNs > elapsedNs) {
+                break;
+            }
+            deliver(m_nextRecord);
+            m_hasNext = readNext();
+        }
+    }
+
+    // 本轮解析出的帧立即投递
+    if (m_parser) {
+        m_parser->flushFrameBatch();
+    }
+
+    if (!m_hasNext) {
+        finish();
+        return;
+    }
+
+    int waitMs = 0;
+    if (m_mode == Mode::OriginalTiming) {
+        const qint64 dueNs = static_cast<qint64>((m_nextRecord.timestampNs - m_firstTimestampNs) / m_speedFactor);
+        waitMs = static_cast<int>(qBound<qint64>(0, (dueNs - m_clock.nsecsElapsed()) / 1000000, 60000));
+    }
+    m_replayTimer->start(waitMs);
+}
+
+bool CaptureReplayer::readNext()
+{
+    while (m_reader.next(m_nextRecord)) {
+        if (m_nextRecord.kind == CaptureRecordKind::Sent && !m_includeSent) {
+            continue;
+        }
+        if (m_nextRecord.kind == CaptureRecordKind::CanFrame
+            && (m_nextRecord.flags & CaptureFlags::Transmit) && !m_includeSent) {
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+void CaptureReplayer::deliver(const CaptureRecord& record)
+{
+    m_statistics.records++;
+    m_statistics.bytes += record.length;
+    m_statistics.captureDurationNs = record.timestampNs - m_firstTimestampNs;
+
+    if (record.kind == CaptureRecordKind::CanFrame) {
+        emit canFrameReplayed(record.canId, QByteArray(record.data, record.length), record.flags);
+        return;
+    }
+
+    const bool sent = record.kind == CaptureRecordKind::Sent;
+    if (!sent && m_parser) {
+        // 解析器同步消费数据，直接使用映射内存的视图
+        m_parser->parseData(record.bytes());
+    }
+    if (!sent && m_worker) {
+        // 任务异步处理，必须持有数据副本
+        m_worker->processData(QByteArray(record.data, record.length));
+    }
+
+    static const QMetaMethod dataReplayedSignal = QMetaMethod::fromSignal(&CaptureReplayer::dataReplayed);
+    if (isSignalConnected(dataReplayedSignal)) {
+        emit dataReplayed(QByteArray(record.data, record.length), sent);
+    }
+}
+
+void CaptureReplayer::finish()
+{
+    m_running = false;
+    m_statistics.elapsedNs = m_clock.nsecsElapsed();
+    m_statistics.truncated = m_reader.isTruncated();
+
+    LogManager::getInstance()->info(
+        QString("回放完成: 记录=%1, 字节=%2, 耗时=%3ms, 吞吐=%4MB/s, 加速比=%5")
+        .arg(m_statistics.records)
+        .arg(m_statistics.bytes)
+        .arg(m_statistics.elapsedNs / 1000000.0, 0, 'f', 1)
+        .arg(m_statistics.throughputMBps(), 0, 'f', 2)
+        .arg(m_statistics.speedup(), 0, 'f', 1),
+        "Replay"
+    );
+    emit finished(m_statistics);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include "linkcapture.h"
+
+class ProtocolParser;
+class DataProcessWorker;
+
+// 回放统计
+struct ReplayStatistics {
+    qint64 records = 0;             // 已回放记录数
+    qint64 bytes = 0;               // 已回放字节数
+    qint64 captureDurationNs = 0;   // 已回放部分在抓包中跨越的时间
+    qint64 elapsedNs = 0;           // 回放实际耗时
+    bool truncated = false;         // 抓包末尾不完整
+
+    double throughputMBps() const {
+        return elapsedNs > 0 ? bytes * 1000.0 / elapsedNs : 0.0;
+    }
+    // 相对原始节奏的加速比
+    double speedup() const {
+        return elapsedNs > 0 ? static_cast<double>(captureDurationNs) / elapsedNs : 0.0;
+    }
+};
+
+// 抓包回放驱动 - 把抓包中的接收数据按原始节奏或尽可能快地送入
+// ProtocolParser 和/或 DataProcessWorker，CAN帧通过 canFrameReplayed 信号发出。
+// 默认只回放接收方向，发送方向可选。回放在所属线程的事件循环中进行，
+// replayAll() 则同步地一次跑完，适合基准测试和回归测试。
+class CaptureReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        OriginalTiming,     // 按抓包时间戳回放（可配合速度倍率）
+        AsFastAsPossible    // 不等待，连续回放
+    };
+
+    explicit CaptureReplayer(QObject* parent = nullptr);
+    ~CaptureReplayer();
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const { return m_reader.isOpen(); }
+    const LinkCaptureReader& reader() const { return m_reader; }
+    QString lastError() const { return m_reader.lastError(); }
+
+    // 回放目标（不持有所有权）
+    void setParser(ProtocolParser* parser);
+    void setDataProcessWorker(DataProcessWorker* worker);
+
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode mode() const { return m_mode; }
+    void setSpeedFactor(double factor) { m_speedFactor = factor > 0.0 ? factor : 1.0; }
+    double speedFactor() const { return m_speedFactor; }
+    void setIncludeSent(bool include) { m_includeSent = include; }
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    ReplayStatistics replayAll();
+    ReplayStatistics statistics() const { return m_statistics; }
+
+signals:
+    void dataReplayed(const QByteArray& data, bool sent);
+    void canFrameReplayed(quint32 canId, const QByteArray& payload, quint8 flags);
+    void finished(const ReplayStatistics& statistics);
+
+private slots:
+    void onReplayTimer();
+
+private:
+    bool readNext();
+    void deliver(const CaptureRecord& record);
+    void finish();
+
+    LinkCaptureReader m_reader;
+    QPointer<ProtocolParser> m_parser;
+    QPointer<DataProcessWorker> m_worker;
+    Mode m_mode;
+    double m_speedFactor;
+    bool m_includeSent;
+
+    QTimer* m_replayTimer;
+    QElapsedTimer m_clock;
+    CaptureRecord m_nextRecord;
+    qint64 m_firstTimestampNs;
+    bool m_hasNext;
+    bool m_running;
+    ReplayStatistics m_statistics;
+};
+
+Q_DECLARE_METATYPE(ReplayStatistics)
@@ -0,0 +1,261 @@
+#include "commandpipeline.h"
+#include "logger/logmanager.h"
+
+CommandPipeline::CommandPipeline(ProtocolParser* parser, FrameSender sender, QObject* parent)
+    : QObject(parent)
+    , m_parser(parser)
+    , m_sender(std::move(sender))
+    , m_windowSize(Protocol::PIPELINE_WINDOW_SIZE)
+    , m_nextSequenceId(1)
+{
+    qRegisterMetaType<CommandResult>("CommandResult");
+    
+    m_timeoutTimer = new QTimer(this);
+    m_timeoutTimer->setSingleShot(true);
+    m_timeoutTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &CommandPipeline::onTimeoutTimer);
+}
+
+CommandPipeline::~CommandPipeline()
+{
+    // 析构时不再执行回调，回调捕获的对象可能已经销毁
+    m_pending.clear();
+    m_inFlight.clear();
+}
+
+quint32 CommandPipeline::submit(ProtocolCommand command, const QByteArray& data,
+                                ResponseCallback callback, int timeoutMs)
+{
+    // 安全指令不排队、不受在途窗口限制
+    const bool safety = ProtocolParser::isSafetyCommand(command);
+    if (!safety && m_pending.size() >= Protocol::PIPELINE_MAX_PENDING) {
+        LogManager::getInstance()->warning("命令管线排队已满，拒绝新请求", "CommandPipeline");
+        return 0;
+    }
+    
+    QByteArray frame = m_parser->buildFrame(command, data);
+    if (frame.isEmpty()) {
+        LogManager::getInstance()->error("构建协议帧失败", "CommandPipeline");
+        return 0;
+    }
+    
+    Request request;
+    request.sequenceId = m_nextSequenceId++;
+    if (m_nextSequenceId == 0) {
+        m_nextSequenceId = 1;   // 0 保留表示提交失败
+    }
+    request.command = command;
+    request.frame = std::move(frame);
+    request.callback = std::move(callback);
+    request.timeoutMs = qMax(1, timeoutMs);
+    request.sentNs = 0;
+    request.deadlineNs = 0;
+    
+    const quint32 sequenceId = request.sequenceId;
+    if (safety) {
+        // 立即发送，仍进入在途列表以匹配响应和超时
+        if (sendRequest(std::move(request))) {
+            rearmTimeoutTimer();
+        }
+        return sequenceId;
+    }
+    m_pending.enqueue(std::move(request));
+    pump();
+    return sequenceId;
+}
+
+void CommandPipeline::setWindowSize(int windowSize)
+{
+    m_windowSize = qMax(1, windowSize);
+    pump();
+}
+
+int CommandPipeline::windowSize() const
+{
+    return m_windowSize;
+}
+
+int CommandPipeline::inFlightCount() const
+{
+    return m_inFlight.size();
+}
+
+int CommandPipeline::pendingCount() const
+{
+    return m_pending.size();
+}
+
+const LatencyHistogram& CommandPipeline::roundTripLatency() const
+{
+    return m_roundTrip;
+}
+
+void CommandPipeline::cancelAll()
+{
+    m_timeoutTimer->stop();
+    
+    // 先整体取出，回调中重新提交的请求不受影响
+    QList<Request> cancelled;
+    cancelled.swap(m_inFlight);
+    while (!m_pending.isEmpty()) {
+        cancelled.append(m_pending.dequeue());
+    }
+    
+    for (Request& request : cancelled) {
+        complete(std::move(request), CommandStatus::Cancelled);
+    }
+}
+
+bool CommandPipeline::handleFrame(const ProtocolFrame& frame)
+{
+    if (m_inFlight.isEmpty()) {
+        return false;
+    }
+    
+    int index = -1;
+    CommandStatus status = CommandStatus::Success;
+    ProtocolError error = ProtocolError::None;
+    
+    if (frame.command == ProtocolCommand::Response) {
+        if (frame.dataLength == 0) {
+            return false;
+        }
+        // 同命令的在途请求中最早发送的一个
+        const ProtocolCommand originalCommand = static_cast<ProtocolCommand>(static_cast<quint8>(frame.data[0]));
+        for (int i = 0; i < m_inFlight.size(); ++i) {
+            if (m_inFlight[i].command == originalCommand) {
+                index = i;
+                break;
+            }
+        }
+    } else if (frame.command == ProtocolCommand::Error) {
+        status = CommandStatus::DeviceError;
+        error = frame.dataLength > 0 ? static_cast<ProtocolError>(static_cast<quint8>(frame.data[0])) : ProtocolError::UnknownError;
+        if (m_inFlight.size() == 1) {
+            index = 0;
+        } else {
+            // 错误帧无法对应到具体请求，不能让最早的请求替别的请求失败：全部在途请求以设备错误结束
+            QList<Request> failed;
+            failed.swap(m_inFlight);
+            for (Request& request : failed) {
+                complete(std::move(request), status, error);
+            }
+            pump();
+            rearmTimeoutTimer();
+            return true;
+        }
+    }
+    
+    if (index < 0) {
+        return false;
+    }
+    
+    // 数据区首字节为原始命令码或错误码，其后为响应数据
+    const QByteArray responseData = frame.dataLength > 1
+        ? QByteArray(frame.data + 1, frame.dataLength - 1)
+        : QByteArray();
+    
+    complete(m_inFlight.takeAt(index), status, error, responseData);
+    pump();
+    rearmTimeoutTimer();
+    return true;
+}
+
+void CommandPipeline::handleFrames(const FrameBatch& frames)
+{
+    for (const ProtocolFrame& frame : frames) {
+        handleFrame(frame);
+    }
+}
+
+void CommandPipeline::onTimeoutTimer()
+{
+    const qint64 now = ProtocolFrame::currentTimestampNs();
+    
+    QList<Request> expired;
+    for (int i = m_inFlight.size() - 1; i >= 0; --i) {
+        if (m_inFlight[i].deadlineNs <= now) {
+            expired.prepend(m_inFlight.takeAt(i));
+        }
+    }
+    
+    for (Request& request : expired) {
+        LogManager::getInstance()->warning(
+            QString("命令响应超时: %1 (序号 %2, %3ms)")
+            .arg(ProtocolParser::commandToString(request.command))
+            .arg(request.sequenceId)
+            .arg(request.timeoutMs),
+            "CommandPipeline"
+        );
+        complete(std::move(request), CommandStatus::Timeout);
+    }
+    
+    pump();
+    rearmTimeoutTimer();
+}
+
+void CommandPipeline::pump()
+{
+    bool sent = false;
+    while (m_inFlight.size() < m_windowSize && !m_pending.isEmpty()) {
+        sent |= sendRequest(m_pending.dequeue());
+    }
+    
+    if (sent) {
+        rearmTimeoutTimer();
+    }
+}
+
+bool CommandPipeline::sendRequest(Request request)
+{
+    request.sentNs = ProtocolFrame::currentTimestampNs();
+    request.deadlineNs = request.sentNs + static_cast<qint64>(request.timeoutMs) * 1000000LL;
+    
+    if (!m_sender || !m_sender(request.frame)) {
+        complete(std::move(request), CommandStatus::SendFailed);
+        return false;
+    }
+    
+    request.frame.clear();  // 已发送，释放帧数据
+    m_inFlight.append(std::move(request));
+    return true;
+}
+
+void CommandPipeline::complete(Request request, CommandStatus status, ProtocolError error,
+                               const QByteArray& responseData)
+{
+    CommandResult result;
+    result.sequenceId = request.sequenceId;
+    result.command = request.command;
+    result.status = status;
+    result.error = error;
+    result.responseData = responseData;
+    result.roundTripNs = request.sentNs > 0 ? ProtocolFrame::currentTimestampNs() - request.sentNs : 0;
+    
+    if (status == CommandStatus::Success || status == CommandStatus::DeviceError) {
+        m_roundTrip.record(result.roundTripNs);
+    }
+    
+    if (request.callback) {
+        request.callback(result);
+    }
+    emit commandCompleted(result);
+}
+
+void CommandPipeline::rearmTimeoutTimer()
+{
+    if (m_inFlight.isEmpty()) {
+        m_timeoutTimer->stop();
+        return;
+    }
+    
+    qint64 earliest = m_inFlight.first().deadlineNs;
+    for (const Request& request : m_inFlight) {
+        earliest = qMin(earliest, request.deadlineNs);
+    }
+    
+    // 向上取整到毫秒，保证定时器触发时请求已经超时
+    const qint64 remainingNs = earliest - ProtocolFrame::currentTimestampNs();
+    const int remainingMs = remainingNs > 0 ? static_cast<int>((remainingNs + 999999) / 1000000) : 0;
+    m_timeoutTimer->start(remainingMs);
+}
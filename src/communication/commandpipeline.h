@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QQueue>
+#include <QTimer>
+#include <functional>
+#include "constants.h"
+#include "protocolparser.h"
+#include "utils/latencyhistogram.h"
+
+// 命令执行状态
+enum class CommandStatus {
+    Success,        // 收到匹配的响应帧
+    DeviceError,    // 设备返回错误帧
+    Timeout,        // 超时未收到响应
+    SendFailed,     // 发送失败
+    Cancelled       // 连接关闭等原因被取消
+};
+
+// 命令执行结果
+struct CommandResult {
+    quint32 sequenceId = 0;                         // 请求序号（主机侧分配）
+    ProtocolCommand command = ProtocolCommand::DeviceStatus;
+    CommandStatus status = CommandStatus::Cancelled;
+    ProtocolError error = ProtocolError::None;      // 设备错误码（仅 DeviceError）
+    QByteArray responseData;                        // 响应数据（不含原始命令码）
+    qint64 roundTripNs = 0;                         // 发送到完成的耗时
+
+    bool isSuccess() const { return status == CommandStatus::Success; }
+};
+
+Q_DECLARE_METATYPE(CommandResult)
+
+// 命令管线 - 异步请求/响应，在途窗口内连续发送，不必逐条等待响应
+//
+// 帧格式中没有序号字段，管线为每个请求分配主机侧序号，
+// 并按照响应帧携带的原始命令码（Response 数据区首字节）在同命令的在途请求中按发送顺序匹配；
+// 错误帧只携带错误码、不携带命令码：只有一个在途请求时由它承担错误；有多个在途请求时无法判断
+// 是哪一个出错，全部以 DeviceError 结束（其余请求随后到达的响应不再匹配）。
+// 串口主从通讯和TCP都保证响应按序到达。
+// 回调在管线所属线程中执行。
+class CommandPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    using FrameSender = std::function<bool(const QByteArray& frame)>;
+    using ResponseCallback = std::function<void(const CommandResult& result)>;
+
+    CommandPipeline(ProtocolParser* parser, FrameSender sender, QObject* parent = nullptr);
+    ~CommandPipeline();
+
+    // 提交命令，返回请求序号；窗口已满时排队等待，队列已满返回0。
+    // 安全指令（ProtocolParser::isSafetyCommand）越过排队和窗口立即发送
+    quint32 submit(ProtocolCommand command, const QByteArray& data = QByteArray(),
+                   ResponseCallback callback = ResponseCallback(),
+                   int timeoutMs = Protocol::PIPELINE_REQUEST_TIMEOUT);
+
+    // 在途窗口大小（同时等待响应的最大请求数）
+    void setWindowSize(int windowSize);
+    int windowSize() const;
+
+    int inFlightCount() const;
+    int pendingCount() const;
+
+    // 取消所有在途和排队的请求（回调以 Cancelled 状态执行）
+    void cancelAll();
+
+    // 往返延迟统计
+    const LatencyHistogram& roundTripLatency() const;
+
+public slots:
+    // 处理接收到的帧，匹配到在途请求时返回true
+    bool handleFrame(const ProtocolFrame& frame);
+    void handleFrames(const FrameBatch& frames);
+
+signals:
+    void commandCompleted(const CommandResult& result);
+
+private slots:
+    void onTimeoutTimer();
+
+private:
+    struct Request {
+        quint32 sequenceId;
+        ProtocolCommand command;
+        QByteArray frame;
+        ResponseCallback callback;
+        int timeoutMs;
+        qint64 sentNs;
+        qint64 deadlineNs;
+    };
+
+    void pump();
+    bool sendRequest(Request request);
+    void complete(Request request, CommandStatus status, ProtocolError error = ProtocolError::None,
+                  const QByteArray& responseData = QByteArray());
+    void rearmTimeoutTimer();
+
+    ProtocolParser* m_parser;
+    FrameSender m_sender;
+    QQueue<Request> m_pending;          // 等待进入窗口的请求
+    QList<Request> m_inFlight;          // 已发送、等待响应的请求（按发送顺序）
+    int m_windowSize;
+    quint32 m_nextSequenceId;
+    QTimer* m_timeoutTimer;
+    LatencyHistogram m_roundTrip;
+};
@@ -1,24 +1,114 @@
 #include "communicationbufferpool.h"
 #include "logmanager.h"
 #include "../core/errorhandler.h"
+#include "../constants.h"
+#include "../utils/metricsregistry.h"
+#include "../utils/workloadprofile.h"
 #include <QDateTime>
 #include <QCoreApplication>
 #include <QDebug>
 #include <algorithm>
+#include <new>
+
+namespace {
+constexpr quint32 POOLED_BUFFER_MAGIC = 0x4250554Cu;   // 池化缓冲区标记
+constexpr int SIZE_CLASS_COUNT = CommunicationBufferPool::SIZE_CLASS_COUNT;
+constexpr int MAX_MAGAZINE_CAPACITY = 64;
+
+// 计数器只由所属线程写入，用读+写代替读改写指令，汇总线程只做读取
+inline void bumpCounter(QAtomicInteger<qint64>& counter, qint64 delta = 1)
+{
+    counter.storeRelaxed(counter.loadRelaxed() + delta);
+}
+}
+
+// 池化缓冲区 - QByteArray 与元数据放在同一个块分配器节点中，释放时由地址直接取得元数据
+struct CommunicationBufferPool::PooledBuffer : public QByteArray {
+    BufferInfo info;
+    int sizeClass = -1;         // -1 为不入池的超大缓冲区
+    quint32 magic = 0;
+};
+
+// 线程缓存 - 每个线程每个池一份，弹匣与计数只由所属线程修改
+struct CommunicationBufferPool::ThreadCache {
+    CommunicationBufferPool* pool = nullptr;    // 池析构后置空（受 s_threadCacheMutex 保护）
+    quint32 epoch = 0;
+    PooledBuffer* slots[SIZE_CLASS_COUNT][MAX_MAGAZINE_CAPACITY] = {};
+    int depth[SIZE_CLASS_COUNT] = {};
+    QAtomicInt publishedDepth[SIZE_CLASS_COUNT];   // 供其他线程统计可用数量
+
+    QAtomicInteger<qint64> acquired[SIZE_CLASS_COUNT];
+    QAtomicInteger<qint64> released[SIZE_CLASS_COUNT];
+    QAtomicInteger<qint64> hits;
+    QAtomicInteger<qint64> misses;
+    QAtomicInteger<qint64> localHits;
+    QAtomicInteger<qint64> refills;
+    QAtomicInteger<qint64> spills;
+
+    void setDepth(int sizeClass, int value) {
+        depth[sizeClass] = value;
+        publishedDepth[sizeClass].storeRelaxed(value);
+    }
+
+    // 由 QThreadStorage 在线程退出时调用：弹匣归还全局池，计数并入退役计数
+    ~ThreadCache() {
+        QMutexLocker locker(&CommunicationBufferPool::s_threadCacheMutex);
+        if (pool) {
+            pool->retireThreadCache(this);
+        }
+    }
+};
+
+void CommunicationBufferPool::CacheCounters::add(const ThreadCache& cache)
+{
+    for (int i = 0; i < SIZE_CLASS_COUNT; ++i) {
+        acquired[i] += cache.acquired[i].loadRelaxed();
+        released[i] += cache.released[i].loadRelaxed();
+    }
+    hits += cache.hits.loadRelaxed();
+    misses += cache.misses.loadRelaxed();
+    localHits += cache.localHits.loadRelaxed();
+    refills += cache.refills.loadRelaxed();
+    spills += cache.spills.loadRelaxed();
+}
+
+void CommunicationBufferPool::CacheCounters::add(const CacheCounters& other)
+{
+    for (int i = 0; i < SIZE_CLASS_COUNT; ++i) {
+        acquired[i] += other.acquired[i];
+        released[i] += other.released[i];
+    }
+    hits += other.hits;
+    misses += other.misses;
+    localHits += other.localHits;
+    refills += other.refills;
+    spills += other.spills;
+}
 
 // 静态成员初始化
 CommunicationBufferPool* CommunicationBufferPool::s_instance = nullptr;
 QMutex CommunicationBufferPool::s_instanceMutex;
+QMutex CommunicationBufferPool::s_threadCacheMutex;
 
 CommunicationBufferPool::CommunicationBufferPool(QObject* parent)
     : QObject(parent)
+    , m_cacheEpoch(0)
     , m_cleanupTimer(new QTimer(this))
     , m_statisticsTimer(new QTimer(this))
     , m_initialized(false)
     , m_shutdown(false)
     , m_memoryThreshold(100 * 1024 * 1024) // 100MB默认阈值
     , m_lastCleanupTime(0)
+    , m_configPoolSize(-1)
+    , m_hitsMetric(MetricsRegistry::counter("glue_buffer_pool_hits_total", "缓冲池命中次数（含线程弹匣）"))
+    , m_missesMetric(MetricsRegistry::counter("glue_buffer_pool_misses_total", "缓冲池未命中、新分配的次数"))
+    , m_localHitsMetric(MetricsRegistry::counter("glue_buffer_pool_local_hits_total", "线程弹匣直接命中次数"))
+    , m_hitRatioMetric(MetricsRegistry::gauge("glue_buffer_pool_hit_ratio", "缓冲池累计命中率"))
+    , m_inUseMetric(MetricsRegistry::gauge("glue_buffer_pool_in_use", "使用中的缓冲区数"))
+    , m_memoryMetric(MetricsRegistry::gauge("glue_buffer_pool_memory_bytes", "缓冲池估算的内存占用"))
 {
+    updateMagazineCapacities();
+
     // 连接定时器信号
     connect(m_cleanupTimer, &QTimer::timeout, this, &CommunicationBufferPool::onCleanupTimer);
     connect(m_statisticsTimer, &QTimer::timeout, this, &CommunicationBufferPool::onStatisticsTimer);
@@ -29,6 +119,33 @@ CommunicationBufferPool::CommunicationBufferPool(QObject* parent)
 CommunicationBufferPool::~CommunicationBufferPool()
 {
     shutdown();
+
+    // 当前线程的缓存由 QThreadStorage 删除（析构中会注销自身）
+    if (m_threadCacheStorage.hasLocalData()) {
+        m_threadCacheStorage.setLocalData(nullptr);
+    }
+
+    // 其他线程的缓存：回收弹匣中的缓冲区并断开与本池的关联。
+    // 缓存对象本身归各线程的 QThreadStorage 所有，这里不删除
+    {
+        QMutexLocker registryLocker(&s_threadCacheMutex);
+        for (ThreadCache* cache : m_threadCaches) {
+            for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+                for (int i = 0; i < cache->depth[sizeClass]; ++i) {
+                    destroyBuffer(cache->slots[sizeClass][i]);
+                }
+                cache->setDepth(sizeClass, 0);
+            }
+            cache->pool = nullptr;
+        }
+        m_threadCaches.clear();
+    }
+
+    {
+        QMutexLocker locker(&m_poolMutex);
+        forceCleanupLocked();
+    }
+
     LogManager::getInstance()->info("通信缓冲池管理器已销毁", "CommunicationBufferPool");
 }
 
@@ -57,8 +174,9 @@ bool CommunicationBufferPool::initialize(const PoolConfig& config)
         // 预分配初始缓冲区
         for (int type = 0; type < 4; ++type) {
             BufferType bufferType = static_cast<BufferType>(type);
-            preallocateBuffers(bufferType, m_config.initialPoolSize / 4);
+            preallocateBuffersLocked(bufferType, m_config.initialPoolSize / 4);
         }
+        updateMagazineCapacities();
         
         // 设置定时器
         if (m_config.enableAutoCleanup) {
@@ -108,8 +226,8 @@ void CommunicationBufferPool::shutdown()
     m_cleanupTimer->stop();
     m_statisticsTimer->stop();
     
-    // 强制清理所有缓冲区
-    forceCleanup();
+    // 强制清理所有缓冲区（各线程弹匣在下次访问或线程退出时归还）
+    forceCleanupLocked();
     
     m_initialized = false;
     
@@ -119,60 +237,67 @@ void CommunicationBufferPool::shutdown()
 QByteArray* CommunicationBufferPool::acquireBuffer(int size, BufferType type)
 {
     if (!m_initialized || m_shutdown) {
-        LogManager::getInstance()->error("缓冲池未初始化或已关闭", "CommunicationBufferPool");
+        LOG_ERROR("CommunicationBufferPool", "缓冲池未初始化或已关闭");
         return nullptr;
     }
     
-    QMutexLocker locker(&m_poolMutex);
-    
-    // 根据大小自动确定类型
-    if (type == BufferType::Small && size > getBufferSize(BufferType::Small)) {
-        type = determineBufferType(size);
+    // 默认按所需大小取尺寸等级；显式指定更大的类型时至少取该类型的标称大小
+    int capacity = qMax(size, 0);
+    if (type != BufferType::Small) {
+        capacity = qMax(capacity, getBufferSize(type));
     }
     
-    int typeIndex = static_cast<int>(type);
-    BufferInfo* bufferInfo = nullptr;
+    const int sizeClass = sizeClassOf(capacity);
+    const int counterIndex = sizeClass >= 0 ? sizeClass : SIZE_CLASS_COUNT - 1;
+    ThreadCache* cache = localCache();
+    PooledBuffer* pooled = nullptr;
+    
+    // 超出最大等级的缓冲区按实际大小分配且不入池
+    if (sizeClass >= 0 && m_magazineCapacity[sizeClass].loadRelaxed() > 0) {
+        // 常规路径：本线程弹匣，为空时批量补充一次
+        if (cache->depth[sizeClass] > 0) {
+            bumpCounter(cache->localHits);
+        } else {
+            refillMagazine(cache, sizeClass);
+        }
+        if (cache->depth[sizeClass] > 0) {
+            const int depth = cache->depth[sizeClass] - 1;
+            pooled = cache->slots[sizeClass][depth];
+            cache->setDepth(sizeClass, depth);
+        }
+    } else if (sizeClass >= 0) {
+        // 不缓存的等级直接走全局池
+        QMutexLocker locker(&m_poolMutex);
+        if (!m_availableBuffers[sizeClass].isEmpty()) {
+            pooled = m_availableBuffers[sizeClass].dequeue();
+        }
+    }
     
-    // 尝试从可用池中获取
-    if (!m_availableBuffers[typeIndex].isEmpty()) {
-        bufferInfo = m_availableBuffers[typeIndex].dequeue();
-        m_statistics.hitCount.fetchAndAddOrdered(1);
+    if (pooled) {
+        bumpCounter(cache->hits);
     } else {
         // 创建新缓冲区
-        bufferInfo = createBuffer(type);
-        if (!bufferInfo) {
-            m_statistics.missCount.fetchAndAddOrdered(1);
-            LogManager::getInstance()->error("无法创建新缓冲区", "CommunicationBufferPool");
+        bumpCounter(cache->misses);
+        pooled = createBuffer(sizeClass, sizeClass >= 0 ? sizeClassBytes(sizeClass) : capacity);
+        if (!pooled) {
+            LOG_ERROR("CommunicationBufferPool", "无法创建新缓冲区");
             return nullptr;
         }
-        m_statistics.missCount.fetchAndAddOrdered(1);
     }
     
     // 更新缓冲区信息
-    bufferInfo->inUse = true;
-    bufferInfo->lastUsedTime = QDateTime::currentMSecsSinceEpoch();
-    bufferInfo->useCount++;
-    bufferInfo->ownerThread = QThread::currentThread();
+    BufferInfo& info = pooled->info;
+    info.inUse = true;
+    info.useCount++;
+    info.ownerThread = QThread::currentThread();
     
     // 确保缓冲区大小足够
-    if (bufferInfo->buffer->size() < size) {
-        bufferInfo->buffer->resize(size);
-    }
-    
-    // 添加到使用中列表
-    m_inUseBuffers.append(bufferInfo);
-    m_bufferMap[bufferInfo->buffer] = bufferInfo;
-    
-    // 更新统计
-    m_statistics.totalAllocated.fetchAndAddOrdered(1);
-    m_statistics.currentInUse.fetchAndAddOrdered(1);
-    
-    int currentInUse = m_statistics.currentInUse.loadAcquire();
-    if (currentInUse > m_statistics.peakUsage.loadAcquire()) {
-        m_statistics.peakUsage.storeRelease(currentInUse);
+    if (pooled->size() < size) {
+        pooled->resize(size);
     }
     
-    return bufferInfo->buffer;
+    bumpCounter(cache->acquired[counterIndex]);
+    return pooled;
 }
 
 void CommunicationBufferPool::releaseBuffer(QByteArray* buffer)
@@ -181,62 +306,216 @@ void CommunicationBufferPool::releaseBuffer(QByteArray* buffer)
         return;
     }
     
-    QMutexLocker locker(&m_poolMutex);
+    // 只接受本池 acquireBuffer 返回的指针：节点必须来自本池的块分配器且未被销毁
+    if (!m_nodeAllocator.owns(buffer)) {
+        LOG_WARNING("CommunicationBufferPool", "尝试释放未知缓冲区");
+        return;
+    }
     
-    auto it = m_bufferMap.find(buffer);
-    if (it == m_bufferMap.end()) {
-        LogManager::getInstance()->warning("尝试释放未知缓冲区", "CommunicationBufferPool");
+    PooledBuffer* pooled = static_cast<PooledBuffer*>(buffer);
+    BufferInfo& info = pooled->info;
+    if (pooled->magic != POOLED_BUFFER_MAGIC || !info.inUse) {
+        LOG_WARNING("CommunicationBufferPool", "缓冲区重复释放");
         return;
     }
     
-    BufferInfo* bufferInfo = it.value();
+    // 重置缓冲区状态
+    info.inUse = false;
+    info.lastUsedTime = QDateTime::currentMSecsSinceEpoch();
+    info.ownerThread = nullptr;
+    
+    // 清空缓冲区内容（resize(0) 保留已分配容量，clear() 会释放内存使池化失去意义）
+    pooled->resize(0);
+    
+    const int sizeClass = pooled->sizeClass;
+    ThreadCache* cache = localCache();
+    bumpCounter(cache->released[sizeClass >= 0 ? sizeClass : SIZE_CLASS_COUNT - 1]);
+    
+    const int capacity = sizeClass >= 0 ? m_magazineCapacity[sizeClass].loadRelaxed() : 0;
+    if (capacity > 0) {
+        // 弹匣满时归还一半，保留的一半留给后续释放
+        if (cache->depth[sizeClass] >= capacity) {
+            spillMagazine(cache, sizeClass, capacity / 2);
+        }
+        const int depth = cache->depth[sizeClass];
+        cache->slots[sizeClass][depth] = pooled;
+        cache->setDepth(sizeClass, depth + 1);
+    } else {
+        QMutexLocker locker(&m_poolMutex);
+        returnToGlobalLocked(pooled);
+    }
+}
+
+void* CommunicationBufferPool::acquireBlock(int size, int* capacity)
+{
+    if (!m_initialized || m_shutdown) {
+        LOG_ERROR("CommunicationBufferPool", "缓冲池未初始化或已关闭");
+        return nullptr;
+    }
     
-    // 从使用中列表移除
-    m_inUseBuffers.removeOne(bufferInfo);
-    m_bufferMap.remove(buffer);
+    void* block = m_blockAllocator.allocate(size, capacity);
+    if (!block) {
+        LOG_WARNING("CommunicationBufferPool",
+            QString("内存块分配失败: %1字节（上限%2字节）").arg(size).arg(SlabAllocator::MAX_BLOCK_SIZE));
+    }
+    return block;
+}
+
+void CommunicationBufferPool::releaseBlock(void* block)
+{
+    if (!block) {
+        return;
+    }
     
-    // 重置缓冲区状态
-    bufferInfo->inUse = false;
-    bufferInfo->lastUsedTime = QDateTime::currentMSecsSinceEpoch();
-    bufferInfo->ownerThread = nullptr;
+    if (!m_blockAllocator.owns(block)) {
+        LOG_WARNING("CommunicationBufferPool", "尝试释放未知内存块");
+        return;
+    }
+    m_blockAllocator.deallocate(block);
+}
+
+int CommunicationBufferPool::sizeClassOf(int size)
+{
+    if (size <= (1 << MIN_SIZE_CLASS_SHIFT)) {
+        return 0;
+    }
+    if (size > sizeClassBytes(SIZE_CLASS_COUNT - 1)) {
+        return -1;
+    }
+    // ceil(log2(size)) - MIN_SIZE_CLASS_SHIFT
+    return 32 - qCountLeadingZeroBits(static_cast<quint32>(size - 1)) - MIN_SIZE_CLASS_SHIFT;
+}
+
+CommunicationBufferPool::ThreadCache* CommunicationBufferPool::localCache()
+{
+    ThreadCache* cache = m_threadCacheStorage.localData();
+    if (Q_UNLIKELY(!cache)) {
+        cache = new ThreadCache();
+        cache->pool = this;
+        cache->epoch = m_cacheEpoch.loadAcquire();
+        {
+            QMutexLocker registryLocker(&s_threadCacheMutex);
+            m_threadCaches.append(cache);
+        }
+        m_threadCacheStorage.setLocalData(cache);
+        return cache;
+    }
     
-    // 清空缓冲区内容
-    bufferInfo->buffer->clear();
+    // 强制清理或配置变化后，各线程在下次访问时自行清空弹匣
+    const quint32 epoch = m_cacheEpoch.loadAcquire();
+    if (Q_UNLIKELY(cache->epoch != epoch)) {
+        flushThreadCache(cache);
+        cache->epoch = epoch;
+    }
+    return cache;
+}
+
+void CommunicationBufferPool::refillMagazine(ThreadCache* cache, int sizeClass)
+{
+    const int batch = qMax(1, m_magazineCapacity[sizeClass].loadRelaxed() / 2);
+    int count = 0;
+    {
+        QMutexLocker locker(&m_poolMutex);
+        QQueue<PooledBuffer*>& queue = m_availableBuffers[sizeClass];
+        while (count < batch && !queue.isEmpty()) {
+            cache->slots[sizeClass][count++] = queue.dequeue();
+        }
+    }
+    cache->setDepth(sizeClass, count);
+    if (count > 0) {
+        bumpCounter(cache->refills);
+    }
+}
+
+void CommunicationBufferPool::spillMagazine(ThreadCache* cache, int sizeClass, int keep)
+{
+    const int depth = cache->depth[sizeClass];
+    const int spillCount = depth - qMax(0, keep);
+    if (spillCount <= 0) {
+        return;
+    }
     
-    // 检查池大小限制
-    int typeIndex = static_cast<int>(bufferInfo->type);
-    if (m_availableBuffers[typeIndex].size() < m_config.maxPoolSize / 4) {
+    PooledBuffer** slots = cache->slots[sizeClass];
+    {
+        // 归还栈底较早放入的缓冲区，栈顶的热缓冲区留在本线程
+        QMutexLocker locker(&m_poolMutex);
+        for (int i = 0; i < spillCount; ++i) {
+            returnToGlobalLocked(slots[i]);
+        }
+    }
+    std::move(slots + spillCount, slots + depth, slots);
+    cache->setDepth(sizeClass, depth - spillCount);
+    bumpCounter(cache->spills);
+}
+
+void CommunicationBufferPool::flushThreadCache(ThreadCache* cache)
+{
+    for (int type = 0; type < SIZE_CLASS_COUNT; ++type) {
+        spillMagazine(cache, type, 0);
+    }
+}
+
+void CommunicationBufferPool::retireThreadCache(ThreadCache* cache)
+{
+    flushThreadCache(cache);
+    m_retiredCounters.add(*cache);
+    m_threadCaches.removeOne(cache);
+    cache->pool = nullptr;
+}
+
+void CommunicationBufferPool::returnToGlobalLocked(PooledBuffer* pooled)
+{
+    // 检查池大小限制（超大缓冲区不入池）
+    const int sizeClass = pooled->sizeClass;
+    if (!m_shutdown && sizeClass >= 0 && m_availableBuffers[sizeClass].size() < m_config.maxPoolSize / 4) {
         // 返回到可用池
-        m_availableBuffers[typeIndex].enqueue(bufferInfo);
+        m_availableBuffers[sizeClass].enqueue(pooled);
     } else {
         // 池已满，销毁缓冲区
-        destroyBuffer(bufferInfo);
+        destroyBuffer(pooled);
+    }
+}
+
+void CommunicationBufferPool::updateMagazineCapacities()
+{
+    const int size = m_config.enableThreadCache ? qBound(0, m_config.magazineSize, MAX_MAGAZINE_CAPACITY) : 0;
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        const int bytes = sizeClassBytes(sizeClass);
+        int capacity = 0;
+        if (bytes <= m_config.mediumBufferSize) {
+            capacity = size;
+        } else if (bytes <= m_config.largeBufferSize) {
+            capacity = size / 4;
+        }
+        // 超大缓冲区不在线程间囤积
+        m_magazineCapacity[sizeClass].storeRelaxed(capacity);
     }
-    
-    // 更新统计
-    m_statistics.totalReleased.fetchAndAddOrdered(1);
-    m_statistics.currentInUse.fetchAndSubOrdered(1);
 }
 
 void CommunicationBufferPool::preallocateBuffers(BufferType type, int count)
 {
     QMutexLocker locker(&m_poolMutex);
-    
-    int typeIndex = static_cast<int>(type);
+    preallocateBuffersLocked(type, count);
+}
+
+void CommunicationBufferPool::preallocateBuffersLocked(BufferType type, int count)
+{
+    const int sizeClass = sizeClassOf(getBufferSize(type));
+    if (sizeClass < 0) {
+        return;
+    }
     
     for (int i = 0; i < count; ++i) {
-        BufferInfo* bufferInfo = createBuffer(type);
-        if (bufferInfo) {
-            m_availableBuffers[typeIndex].enqueue(bufferInfo);
+        PooledBuffer* pooled = createBuffer(sizeClass, sizeClassBytes(sizeClass));
+        if (pooled) {
+            m_availableBuffers[sizeClass].enqueue(pooled);
         }
     }
     
-    LogManager::getInstance()->debug(
+    LOG_DEBUG("CommunicationBufferPool",
         QString("预分配缓冲区 - 类型: %1, 数量: %2")
         .arg(static_cast<int>(type))
-        .arg(count),
-        "CommunicationBufferPool"
-    );
+        .arg(count));
 }
 
 void CommunicationBufferPool::cleanupIdleBuffers()
@@ -248,56 +527,62 @@ void CommunicationBufferPool::cleanupIdleBuffers()
     
     int cleanedCount = 0;
     
-    // 清理各类型的空闲缓冲区
-    for (int type = 0; type < 4; ++type) {
-        QQueue<BufferInfo*>& queue = m_availableBuffers[type];
-        QQueue<BufferInfo*> tempQueue;
+    // 清理各等级的空闲缓冲区
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        QQueue<PooledBuffer*>& queue = m_availableBuffers[sizeClass];
+        QQueue<PooledBuffer*> tempQueue;
         
         while (!queue.isEmpty()) {
-            BufferInfo* bufferInfo = queue.dequeue();
+            PooledBuffer* pooled = queue.dequeue();
             
-            if (currentTime - bufferInfo->lastUsedTime > idleThreshold) {
+            if (currentTime - pooled->info.lastUsedTime > idleThreshold) {
                 // 缓冲区空闲时间过长，销毁它
-                destroyBuffer(bufferInfo);
+                destroyBuffer(pooled);
                 cleanedCount++;
             } else {
                 // 保留缓冲区
-                tempQueue.enqueue(bufferInfo);
+                tempQueue.enqueue(pooled);
             }
         }
         
         queue = tempQueue;
     }
     
+    // 销毁缓冲区后可能留下全空整块
+    m_nodeAllocator.releaseEmptySlabs();
+    m_blockAllocator.releaseEmptySlabs();
+    
     m_lastCleanupTime = currentTime;
     
     if (cleanedCount > 0) {
-        LogManager::getInstance()->debug(
-            QString("清理空闲缓冲区: %1个").arg(cleanedCount),
-            "CommunicationBufferPool"
-        );
+        LOG_DEBUG("CommunicationBufferPool", QString("清理空闲缓冲区: %1个").arg(cleanedCount));
     }
 }
 
 void CommunicationBufferPool::forceCleanup()
 {
     QMutexLocker locker(&m_poolMutex);
-    
+    forceCleanupLocked();
+}
+
+void CommunicationBufferPool::forceCleanupLocked()
+{
     int cleanedCount = 0;
     
     // 清理所有可用缓冲区
-    for (int type = 0; type < 4; ++type) {
-        while (!m_availableBuffers[type].isEmpty()) {
-            BufferInfo* bufferInfo = m_availableBuffers[type].dequeue();
-            destroyBuffer(bufferInfo);
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        while (!m_availableBuffers[sizeClass].isEmpty()) {
+            PooledBuffer* pooled = m_availableBuffers[sizeClass].dequeue();
+            destroyBuffer(pooled);
             cleanedCount++;
         }
     }
+    m_nodeAllocator.releaseEmptySlabs();
     
-    // 清理使用中的缓冲区映射
-    m_bufferMap.clear();
+    // 线程弹匣只能由所属线程操作，推进代号让各线程下次访问时自行清空
+    m_cacheEpoch.fetchAndAddRelease(1);
     
-    // 注意：不清理m_inUseBuffers，因为这些缓冲区可能仍在使用
+    // 注意：使用中的缓冲区不清理，它们可能仍在使用
     
     LogManager::getInstance()->info(
         QString("强制清理缓冲区: %1个").arg(cleanedCount),
@@ -305,23 +590,37 @@ void CommunicationBufferPool::forceCleanup()
     );
 }
 
-BufferInfo* CommunicationBufferPool::createBuffer(BufferType type)
+CommunicationBufferPool::PooledBuffer* CommunicationBufferPool::createBuffer(int sizeClass, int capacity)
 {
+    void* memory = m_nodeAllocator.allocate(sizeof(PooledBuffer));
+    if (!memory) {
+        ErrorHandler::getInstance()->reportError(
+            ErrorLevel::Error,
+            "CommunicationBufferPool",
+            "创建缓冲区失败: 元数据节点分配失败",
+            "CommunicationBufferPool::createBuffer"
+        );
+        return nullptr;
+    }
+    
+    PooledBuffer* pooled = new (memory) PooledBuffer();
+    pooled->sizeClass = sizeClass;
+    pooled->magic = POOLED_BUFFER_MAGIC;
+    
+    BufferInfo& info = pooled->info;
+    info.buffer = pooled;
+    info.type = determineBufferType(capacity);
+    info.allocatedTime = QDateTime::currentMSecsSinceEpoch();
+    info.lastUsedTime = info.allocatedTime;
+    info.useCount = 0;
+    info.inUse = false;
+    
     try {
-        BufferInfo* info = new BufferInfo();
-        info->type = type;
-        info->allocatedTime = QDateTime::currentMSecsSinceEpoch();
-        info->lastUsedTime = info->allocatedTime;
-        info->useCount = 0;
-        info->inUse = false;
-        
-        int bufferSize = getBufferSize(type);
-        info->buffer = new QByteArray();
-        info->buffer->reserve(bufferSize);
-        
-        return info;
+        pooled->reserve(capacity);
+        return pooled;
     }
     catch (const std::exception& e) {
+        destroyBuffer(pooled);
         ErrorHandler::getInstance()->reportError(
             ErrorLevel::Error,
             "CommunicationBufferPool",
@@ -332,11 +631,12 @@ BufferInfo* CommunicationBufferPool::createBuffer(BufferType type)
     }
 }
 
-void CommunicationBufferPool::destroyBuffer(BufferInfo* info)
+void CommunicationBufferPool::destroyBuffer(PooledBuffer* pooled)
 {
-    if (info) {
-        delete info->buffer;
-        delete info;
+    if (pooled) {
+        pooled->magic = 0;
+        pooled->~PooledBuffer();
+        m_nodeAllocator.deallocate(pooled);
     }
 }
 
@@ -369,29 +669,92 @@ int CommunicationBufferPool::getBufferSize(BufferType type) const
     }
 }
 
+CommunicationBufferPool::CacheCounters CommunicationBufferPool::collectCounters() const
+{
+    QMutexLocker registryLocker(&s_threadCacheMutex);
+    CacheCounters counters = m_retiredCounters;
+    for (const ThreadCache* cache : m_threadCaches) {
+        counters.add(*cache);
+    }
+    return counters;
+}
+
 void CommunicationBufferPool::updateStatistics()
 {
+    // 汇总各线程计数（弹匣深度同时读取，用于内存估算）
+    CacheCounters counters;
+    int magazineDepth[SIZE_CLASS_COUNT] = {};
+    int cacheCount = 0;
+    {
+        QMutexLocker registryLocker(&s_threadCacheMutex);
+        counters = m_retiredCounters;
+        for (const ThreadCache* cache : m_threadCaches) {
+            counters.add(*cache);
+            for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+                magazineDepth[sizeClass] += cache->publishedDepth[sizeClass].loadRelaxed();
+            }
+        }
+        cacheCount = m_threadCaches.size();
+    }
+    
+    QMutexLocker locker(&m_poolMutex);
+    const CacheCounters& base = m_statisticsBaseline;
+    
+    qint64 acquired = 0;
+    qint64 released = 0;
+    qint64 inUse[SIZE_CLASS_COUNT] = {};
+    qint64 totalInUse = 0;
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        acquired += counters.acquired[sizeClass] - base.acquired[sizeClass];
+        released += counters.released[sizeClass] - base.released[sizeClass];
+        inUse[sizeClass] = counters.acquired[sizeClass] - counters.released[sizeClass];
+        totalInUse += inUse[sizeClass];
+    }
+    
+    const int currentInUse = static_cast<int>(totalInUse);
+    m_statistics.totalAllocated.storeRelaxed(static_cast<int>(acquired));
+    m_statistics.totalReleased.storeRelaxed(static_cast<int>(released));
+    m_statistics.currentInUse.storeRelaxed(currentInUse);
+    m_statistics.hitCount.storeRelaxed(static_cast<int>(counters.hits - base.hits));
+    m_statistics.missCount.storeRelaxed(static_cast<int>(counters.misses - base.misses));
+    m_statistics.localHitCount.storeRelaxed(static_cast<int>(counters.localHits - base.localHits));
+    m_statistics.refillCount.storeRelaxed(static_cast<int>(counters.refills - base.refills));
+    m_statistics.spillCount.storeRelaxed(static_cast<int>(counters.spills - base.spills));
+    m_statistics.threadCacheCount.storeRelaxed(cacheCount);
+    
+    // 峰值按采样时刻估算
+    if (currentInUse > m_statistics.peakUsage.loadRelaxed()) {
+        m_statistics.peakUsage.storeRelaxed(currentInUse);
+    }
+    
     // 计算命中率
-    int totalRequests = m_statistics.hitCount.loadAcquire() + m_statistics.missCount.loadAcquire();
+    int totalRequests = m_statistics.hitCount.loadRelaxed() + m_statistics.missCount.loadRelaxed();
     if (totalRequests > 0) {
-        m_statistics.hitRatio = static_cast<double>(m_statistics.hitCount.loadAcquire()) / totalRequests;
+        m_statistics.hitRatio = static_cast<double>(m_statistics.hitCount.loadRelaxed()) / totalRequests;
     }
     
-    // 计算总内存使用量
+    // 计算总内存使用量（全局队列、线程弹匣与使用中的缓冲区按等级容量估算，另加块分配器整块）
     qint64 totalMemory = 0;
-    for (int type = 0; type < 4; ++type) {
-        BufferType bufferType = static_cast<BufferType>(type);
-        int bufferSize = getBufferSize(bufferType);
-        totalMemory += m_availableBuffers[type].size() * bufferSize;
-    }
-    
-    // 添加使用中缓冲区的内存
-    for (const BufferInfo* info : m_inUseBuffers) {
-        totalMemory += info->buffer->capacity();
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        const qint64 bufferSize = sizeClassBytes(sizeClass);
+        totalMemory += (m_availableBuffers[sizeClass].size() + magazineDepth[sizeClass]
+                        + qMax<qint64>(0, inUse[sizeClass])) * bufferSize;
     }
     
+    m_statistics.slabMemoryUsage = m_nodeAllocator.statistics().reservedBytes
+                                 + m_blockAllocator.statistics().reservedBytes;
+    totalMemory += m_statistics.slabMemoryUsage;
     m_statistics.totalMemoryUsage = totalMemory;
     
+    m_hitsMetric->set(counters.hits);
+    m_missesMetric->set(counters.misses);
+    m_localHitsMetric->set(counters.localHits);
+    if (counters.hits + counters.misses > 0) {
+        m_hitRatioMetric->set(static_cast<double>(counters.hits) / (counters.hits + counters.misses));
+    }
+    m_inUseMetric->set(currentInUse);
+    m_memoryMetric->set(static_cast<double>(totalMemory));
+    
     if (totalMemory > m_statistics.peakMemoryUsage) {
         m_statistics.peakMemoryUsage = totalMemory;
     }
@@ -409,28 +772,46 @@ void CommunicationBufferPool::checkMemoryUsage()
 
 PoolStatistics CommunicationBufferPool::getStatistics()
 {
+    updateStatistics();
     QMutexLocker locker(&m_poolMutex);
     return m_statistics;
 }
 
 int CommunicationBufferPool::getAvailableCount(BufferType type) const
 {
+    // 按等级容量归入对应的粗分类
+    int count = 0;
+    {
+        QMutexLocker registryLocker(&s_threadCacheMutex);
+        for (const ThreadCache* cache : m_threadCaches) {
+            for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+                if (determineBufferType(sizeClassBytes(sizeClass)) == type) {
+                    count += cache->publishedDepth[sizeClass].loadRelaxed();
+                }
+            }
+        }
+    }
+    
     QMutexLocker locker(&m_poolMutex);
-    int typeIndex = static_cast<int>(type);
-    return m_availableBuffers[typeIndex].size();
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        if (determineBufferType(sizeClassBytes(sizeClass)) == type) {
+            count += m_availableBuffers[sizeClass].size();
+        }
+    }
+    return count;
 }
 
 int CommunicationBufferPool::getInUseCount(BufferType type) const
 {
-    QMutexLocker locker(&m_poolMutex);
-    
-    int count = 0;
-    for (const BufferInfo* info : m_inUseBuffers) {
-        if (info->type == type) {
-            count++;
+    // 跨线程释放时单个线程的差值可能为负，汇总后才有意义
+    const CacheCounters counters = collectCounters();
+    qint64 count = 0;
+    for (int sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        if (determineBufferType(sizeClassBytes(sizeClass)) == type) {
+            count += counters.acquired[sizeClass] - counters.released[sizeClass];
         }
     }
-    return count;
+    return static_cast<int>(count);
 }
 
 qint64 CommunicationBufferPool::getTotalMemoryUsage() const
@@ -438,6 +819,11 @@ qint64 CommunicationBufferPool::getTotalMemoryUsage() const
     return m_statistics.totalMemoryUsage;
 }
 
+bool CommunicationBufferPool::isInitialized() const
+{
+    return m_initialized && !m_shutdown;
+}
+
 bool CommunicationBufferPool::isHealthy() const
 {
     // 检查各种健康指标
@@ -463,13 +849,20 @@ bool CommunicationBufferPool::isHealthy() const
 
 void CommunicationBufferPool::resetStatistics()
 {
+    // 其他线程的计数不可从外部清零，记录当前汇总值作为基线
+    const CacheCounters counters = collectCounters();
+    
     QMutexLocker locker(&m_poolMutex);
+    m_statisticsBaseline = counters;
     
     m_statistics.totalAllocated = 0;
     m_statistics.totalReleased = 0;
     m_statistics.peakUsage = 0;
     m_statistics.hitCount = 0;
     m_statistics.missCount = 0;
+    m_statistics.localHitCount = 0;
+    m_statistics.refillCount = 0;
+    m_statistics.spillCount = 0;
     m_statistics.peakMemoryUsage = 0;
     m_statistics.hitRatio = 0.0;
     
@@ -487,6 +880,10 @@ void CommunicationBufferPool::onCleanupTimer()
 void CommunicationBufferPool::onStatisticsTimer()
 {
     if (!m_shutdown) {
+        if (m_configReader.refresh()) {
+            applyConfigSnapshot();
+        }
+        
         updateStatistics();
         emit statisticsUpdated(m_statistics);
         
@@ -505,6 +902,10 @@ void CommunicationBufferPool::setPoolConfig(const PoolConfig& config)
     QMutexLocker locker(&m_poolMutex);
     m_config = config;
     
+    // 弹匣容量可能变化，让各线程清空现有弹匣后按新容量缓存
+    updateMagazineCapacities();
+    m_cacheEpoch.fetchAndAddRelease(1);
+    
     // 更新定时器间隔
     if (m_config.enableAutoCleanup) {
         m_cleanupTimer->setInterval(m_config.cleanupInterval * 1000);
@@ -517,4 +918,36 @@ PoolConfig CommunicationBufferPool::getPoolConfig() const
 {
     QMutexLocker locker(&m_poolMutex);
     return m_config;
+}
+
+void CommunicationBufferPool::attachConfigSnapshots(ConfigSnapshotPublisher* publisher)
+{
+    m_configReader.attach(publisher);
+    m_configPoolSize = -1;
+}
+
+void CommunicationBufferPool::applyWorkloadProfile(const WorkloadProfile& profile)
+{
+    PoolConfig config = getPoolConfig();
+    config.maxPoolSize = profile.bufferMaxPoolSize;
+    config.enableThreadCache = profile.bufferMagazineSize > 0;
+    if (config.enableThreadCache) {
+        config.magazineSize = profile.bufferMagazineSize;
+    }
+    setPoolConfig(config);
+}
+
+void CommunicationBufferPool::applyConfigSnapshot()
+{
+    const int poolSize = m_configReader->intValue(System::CONFIG_BUFFER_POOL_SIZE, -1);
+    if (poolSize <= 0 || poolSize == m_configPoolSize) {
+        return;
+    }
+    m_configPoolSize = poolSize;
+    
+    PoolConfig config = getPoolConfig();
+    if (config.maxPoolSize != poolSize) {
+        config.maxPoolSize = poolSize;
+        setPoolConfig(config);
+    }
 }
\ No newline at end of file
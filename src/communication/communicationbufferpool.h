@@ -10,7 +10,16 @@
 #include <QThread>
 #include <QWaitCondition>
 #include <QHash>
+#include <QThreadStorage>
+#include <QAtomicInteger>
 #include <memory>
+#include "slaballocator.h"
+#include "../utils/configsnapshot.h"
+
+class MetricCounter;
+class MetricGauge;
+
+struct WorkloadProfile;
 
 /**
  * @brief 缓冲区类型枚举
@@ -49,13 +58,19 @@ struct PoolStatistics {
     QAtomicInt peakUsage;           // 峰值使用量
     QAtomicInt hitCount;            // 命中次数
     QAtomicInt missCount;           // 未命中次数
+    QAtomicInt localHitCount;       // 线程本地弹匣直接命中次数（无锁路径）
+    QAtomicInt refillCount;         // 弹匣从全局池批量补充次数
+    QAtomicInt spillCount;          // 弹匣向全局池批量归还次数
+    QAtomicInt threadCacheCount;    // 活跃的线程缓存数
     qint64 totalMemoryUsage;        // 总内存使用量
     qint64 peakMemoryUsage;         // 峰值内存使用量
+    qint64 slabMemoryUsage;         // 块分配器向系统申请的内存
     double hitRatio;                // 命中率
     
     PoolStatistics() : totalAllocated(0), totalReleased(0), currentInUse(0),
                       peakUsage(0), hitCount(0), missCount(0),
-                      totalMemoryUsage(0), peakMemoryUsage(0), hitRatio(0.0) {}
+                      localHitCount(0), refillCount(0), spillCount(0), threadCacheCount(0),
+                      totalMemoryUsage(0), peakMemoryUsage(0), slabMemoryUsage(0), hitRatio(0.0) {}
 };
 
 /**
@@ -71,6 +86,8 @@ struct PoolConfig {
     bool enableThreadSafety;        // 启用线程安全
     int growthFactor;               // 增长因子
     int shrinkThreshold;            // 收缩阈值
+    bool enableThreadCache;         // 启用线程本地弹匣
+    int magazineSize;               // 弹匣容量（大缓冲区取1/4，超大缓冲区不缓存）
     
     // 各类型缓冲区的大小配置
     int smallBufferSize;            // 小缓冲区大小
@@ -81,6 +98,7 @@ struct PoolConfig {
     PoolConfig() : maxPoolSize(1000), initialPoolSize(50), maxIdleTime(300),
                    cleanupInterval(60), enableAutoCleanup(true), enableStatistics(true),
                    enableThreadSafety(true), growthFactor(2), shrinkThreshold(10),
+                   enableThreadCache(true), magazineSize(16),
                    smallBufferSize(512), mediumBufferSize(4096), 
                    largeBufferSize(65536), hugeBufferSize(1048576) {}
 };
@@ -90,12 +108,24 @@ struct PoolConfig {
  * 
  * 提供高效的缓冲区分配和回收机制，支持多种大小的缓冲区类型，
  * 具备自动清理、统计监控、线程安全等功能
+ *
+ * 每个线程持有各类型的本地弹匣（小型空闲栈），常规获取/释放只操作本线程弹匣；
+ * 弹匣空时从全局池批量补充一半容量，满时把一半归还全局池，只有这两步需要加锁。
+ * 统计计数按线程累加，查询时汇总。
+ *
+ * 空闲缓冲区按容量分为2的幂尺寸等级（32B起，至 1MB），小帧只占用贴合其大小的缓冲区；
+ * BufferType 仅作为对外的粗分类。缓冲区元数据节点从块分配器（SlabAllocator）的连续整块中切分，
+ * 释放时先查块分配器的整块地址表确认归属，外来、过期的指针和重复释放只记录警告。
+ * acquireBlock()/releaseBlock() 直接提供块分配器中的原始内存，可配合 FrameWriter 在其中组帧。
  */
 class CommunicationBufferPool : public QObject
 {
     Q_OBJECT
 
 public:
+    static constexpr int MIN_SIZE_CLASS_SHIFT = 5;      // 最小等级 32B
+    static constexpr int SIZE_CLASS_COUNT = 16;         // 32B ... 1MB
+
     explicit CommunicationBufferPool(QObject* parent = nullptr);
     ~CommunicationBufferPool();
 
@@ -131,6 +161,30 @@ public:
      */
     void releaseBuffer(QByteArray* buffer);
 
+    /**
+     * @brief 获取原始内存块（来自块分配器，最大 SlabAllocator::MAX_BLOCK_SIZE）
+     * @param size 所需大小
+     * @param capacity 返回块的实际容量(可选)
+     * @return 内存块，失败返回nullptr
+     */
+    void* acquireBlock(int size, int* capacity = nullptr);
+
+    /**
+     * @brief 释放原始内存块
+     * @param block acquireBlock() 返回的指针
+     */
+    void releaseBlock(void* block);
+
+    /**
+     * @brief 尺寸等级：容量向上取整到2的幂后的下标，超出最大等级返回-1
+     */
+    static int sizeClassOf(int size);
+
+    /**
+     * @brief 尺寸等级对应的容量
+     */
+    static int sizeClassBytes(int sizeClass) { return 1 << (MIN_SIZE_CLASS_SHIFT + sizeClass); }
+
     /**
      * @brief 预分配缓冲区
      * @param type 缓冲区类型
@@ -160,6 +214,18 @@ public:
      */
     PoolConfig getPoolConfig() const;
 
+    /**
+     * @brief 接入 AdaptiveConfigManager 的参数快照，在统计定时器中应用新版本
+     * @param publisher 快照发布器，nullptr 断开；须在发布器析构前断开，与定时器同一线程调用
+     */
+    void attachConfigSnapshots(ConfigSnapshotPublisher* publisher);
+
+    /**
+     * @brief 应用工作负载配置档中的池大小和线程弹匣容量
+     * @param profile 配置档
+     */
+    void applyWorkloadProfile(const WorkloadProfile& profile);
+
     /**
      * @brief 获取池统计信息
      * @return 统计信息
@@ -186,6 +252,12 @@ public:
      */
     qint64 getTotalMemoryUsage() const;
 
+    /**
+     * @brief 是否已初始化
+     * @return 已初始化且未关闭时为true
+     */
+    bool isInitialized() const;
+
     /**
      * @brief 检查池健康状态
      * @return 是否健康
@@ -229,18 +301,81 @@ signals:
     void statisticsUpdated(const PoolStatistics& stats);
 
 private:
+    struct PooledBuffer;
+    struct ThreadCache;
+
+    /**
+     * @brief 按线程累加的计数器汇总值
+     */
+    struct CacheCounters {
+        qint64 acquired[SIZE_CLASS_COUNT] = {};
+        qint64 released[SIZE_CLASS_COUNT] = {};
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 localHits = 0;
+        qint64 refills = 0;
+        qint64 spills = 0;
+
+        void add(const ThreadCache& cache);
+        void add(const CacheCounters& other);
+    };
+
     /**
      * @brief 创建新缓冲区
-     * @param type 缓冲区类型
-     * @return 缓冲区信息
+     * @param sizeClass 尺寸等级，-1表示不入池的超大缓冲区
+     * @param capacity 预留容量
+     * @return 缓冲区（元数据节点来自块分配器）
      */
-    BufferInfo* createBuffer(BufferType type);
+    PooledBuffer* createBuffer(int sizeClass, int capacity);
 
     /**
      * @brief 销毁缓冲区
-     * @param info 缓冲区信息
+     * @param pooled 缓冲区
+     */
+    void destroyBuffer(PooledBuffer* pooled);
+
+    /**
+     * @brief 获取当前线程的缓存，首次调用时创建并登记
+     */
+    ThreadCache* localCache();
+
+    /**
+     * @brief 从全局池补充弹匣（需在弹匣为空时调用）
+     */
+    void refillMagazine(ThreadCache* cache, int sizeClass);
+
+    /**
+     * @brief 把弹匣中较早放入的缓冲区归还全局池，只保留 keep 个
      */
-    void destroyBuffer(BufferInfo* info);
+    void spillMagazine(ThreadCache* cache, int sizeClass, int keep);
+
+    /**
+     * @brief 清空线程缓存的全部弹匣
+     */
+    void flushThreadCache(ThreadCache* cache);
+
+    /**
+     * @brief 线程退出时注销缓存并合并计数（调用方持有 s_threadCacheMutex）
+     */
+    void retireThreadCache(ThreadCache* cache);
+
+    /**
+     * @brief 缓冲区归还全局队列，超出上限时销毁（调用方持有 m_poolMutex）
+     */
+    void returnToGlobalLocked(PooledBuffer* pooled);
+
+    /**
+     * @brief 汇总所有线程的计数
+     */
+    CacheCounters collectCounters() const;
+
+    /**
+     * @brief 按配置刷新各等级弹匣容量
+     */
+    void updateMagazineCapacities();
+
+    void preallocateBuffersLocked(BufferType type, int count);
+    void forceCleanupLocked();
 
     /**
      * @brief 根据大小确定缓冲区类型
@@ -278,14 +413,29 @@ private:
      */
     void shrinkPool(BufferType type);
 
+    /**
+     * @brief 应用参数快照中变化了的参数
+     */
+    void applyConfigSnapshot();
+
 private:
     static CommunicationBufferPool* s_instance;     // 单例实例
     static QMutex s_instanceMutex;                  // 实例互斥锁
     
+    static QMutex s_threadCacheMutex;               // 线程缓存登记锁（先于 m_poolMutex 获取）
+    
     // 缓冲区池 - 按类型分组
-    QQueue<BufferInfo*> m_availableBuffers[4];      // 可用缓冲区队列
-    QList<BufferInfo*> m_inUseBuffers;              // 使用中缓冲区列表
-    QHash<QByteArray*, BufferInfo*> m_bufferMap;    // 缓冲区映射表
+    QQueue<PooledBuffer*> m_availableBuffers[SIZE_CLASS_COUNT];  // 全局可用缓冲区队列（按尺寸等级）
+    SlabAllocator m_nodeAllocator;                  // 缓冲区元数据节点
+    SlabAllocator m_blockAllocator;                 // acquireBlock() 的原始内存块
+    
+    // 线程本地弹匣
+    QThreadStorage<ThreadCache*> m_threadCacheStorage;  // 当前线程的缓存
+    QList<ThreadCache*> m_threadCaches;             // 全部存活线程缓存（受 s_threadCacheMutex 保护）
+    CacheCounters m_retiredCounters;                // 已退出线程的计数（受 s_threadCacheMutex 保护）
+    CacheCounters m_statisticsBaseline;             // 重置统计时的计数基线
+    QAtomicInt m_magazineCapacity[SIZE_CLASS_COUNT];    // 各等级弹匣容量，0表示不缓存
+    QAtomicInteger<quint32> m_cacheEpoch;           // 清理代号，变化后各线程清空弹匣
     
     mutable QMutex m_poolMutex;                     // 池互斥锁
     QWaitCondition m_waitCondition;                 // 等待条件
@@ -301,6 +451,17 @@ private:
     
     qint64 m_memoryThreshold;                       // 内存阈值
     qint64 m_lastCleanupTime;                       // 最后清理时间
+    
+    ConfigSnapshotReader m_configReader;            // 参数快照，只在定时器线程读取
+    int m_configPoolSize;                           // 上次应用的 System::CONFIG_BUFFER_POOL_SIZE，-1 表示未应用
+    
+    // 指标端点的序列（累计值，不随 resetStatistics 清零），由统计定时器更新
+    MetricCounter* m_hitsMetric;
+    MetricCounter* m_missesMetric;
+    MetricCounter* m_localHitsMetric;
+    MetricGauge* m_hitRatioMetric;
+    MetricGauge* m_inUseMetric;
+    MetricGauge* m_memoryMetric;
 };
 
 #endif // COMMUNICATIONBUFFERPOOL_H
\ No newline at end of file
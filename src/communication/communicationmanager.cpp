@@ -3,6 +3,12 @@
 #include "../core/errorhandler.h"
 #include "serialcommunication.h"
 #include "tcpcommunication.h"
+#include "connectiongroup.h"
+#include "framewriter.h"
+#include "reconnectscheduler.h"
+#include "../utils/fastlane.h"
+#include "../utils/metricsregistry.h"
+#include "../utils/threadpolicy.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -11,6 +17,8 @@
 #include <QCoreApplication>
 #include <QThread>
 #include <QDebug>
+#include <memory>
+#include <algorithm>
 
 // 静态成员初始化
 CommunicationManager* CommunicationManager::s_instance = nullptr;
@@ -32,14 +40,22 @@ CommunicationManager::CommunicationManager(QObject* parent)
     , m_connectionPoolingEnabled(false)
     , m_monitoringEnabled(false)
     , m_globalTimeout(5000)
-    , m_maxConnections(10)
+    , m_maxConnections(Communication::MAX_CONNECTIONS_DEFAULT)
     , m_monitoringInterval(1000)
     , m_monitoringTimer(new QTimer(this))
     , m_healthCheckTimer(new QTimer(this))
     , m_cleanupTimer(new QTimer(this))
     , m_workerThread(new QThread(this))
+    , m_connectionGroup(nullptr)
     , m_bufferPool(nullptr)
+    , m_broadcastSequence(0)
 {
+    qRegisterMetaType<BroadcastReport>("BroadcastReport");
+    
+    // 空连接表快照，读者始终能拿到有效指针
+    m_nextHandle = 0;
+    m_snapshot.storeRelease(new ConnectionSnapshot());
+    
     // 初始化缓冲池
     m_bufferPool = new CommunicationBufferPool(this);
     
@@ -89,7 +105,11 @@ CommunicationManager::CommunicationManager(QObject* parent)
     connect(m_healthCheckTimer, &QTimer::timeout, this, &CommunicationManager::onHealthCheckTimer);
     connect(m_cleanupTimer, &QTimer::timeout, this, &CommunicationManager::onCleanupTimer);
     
-    // 启动工作线程
+    // 启动工作线程，串口等连接在其中运行；started 在新线程中发出
+    m_workerThread->setObjectName("CommunicationWorker");
+    connect(m_workerThread, &QThread::started, []() {
+        ThreadPolicy::getInstance()->applyToCurrentThread(ThreadRole::SerialIo);
+    });
     m_workerThread->start();
     
     // 启动清理定时器
@@ -115,6 +135,15 @@ CommunicationManager::~CommunicationManager()
     }
     m_connections.clear();
     
+    // 析构时已无读者，快照与连接槽直接释放
+    reclaimRetiredSnapshotsLocked(true);
+    qDeleteAll(m_connectionSlots);
+    qDeleteAll(m_pendingRemovedSlots);
+    m_connectionSlots.clear();
+    m_pendingRemovedSlots.clear();
+    delete m_snapshot.fetchAndStoreOrdered(nullptr);
+    locker.unlock();
+    
     // 关闭缓冲池
     if (m_bufferPool) {
         m_bufferPool->shutdown();
@@ -122,6 +151,10 @@ CommunicationManager::~CommunicationManager()
         m_bufferPool = nullptr;
     }
     
+    // 连接已在各自的 I/O 线程中延迟删除，线程结束前会先处理完
+    delete m_connectionGroup;
+    m_connectionGroup = nullptr;
+    
     // 停止工作线程
     if (m_workerThread) {
         m_workerThread->quit();
@@ -195,11 +228,16 @@ QString CommunicationManager::createConnection(CommunicationType type, const QSt
     info.isActive = false;
     info.priority = m_connections.size(); // 默认优先级
     
+    // 指标序列在连接移到工作线程之前注册
+    communication->attachMetrics(connectionName);
+    
     // 设置连接
     setupConnection(info);
     
     // 存储连接
     m_connections[connectionName] = info;
+    addSlotLocked(info);
+    publishSnapshotLocked();
     
     emit connectionCreated(connectionName, type);
     
@@ -226,11 +264,13 @@ bool CommunicationManager::removeConnection(const QString& name)
         info.communication->disconnect();
     }
     
-    // 清理连接
-    cleanupConnection(info);
+    // 通信对象交给快照回收，宽限期内仍持有旧快照的发送方不会访问已释放对象
+    info.communication = nullptr;
+    retireSlotLocked(name);
     
     // 移除连接
     m_connections.remove(name);
+    publishSnapshotLocked();
     
     emit connectionRemoved(name);
     
@@ -242,64 +282,428 @@ bool CommunicationManager::removeConnection(const QString& name)
     return true;
 }
 
-bool CommunicationManager::sendData(const QString& connectionName, const QByteArray& data)
+bool CommunicationManager::connectToDevice(const QString& name, const CommunicationConfig& config)
+{
+    ICommunication* communication = getConnection(name);
+    if (!communication) {
+        LogManager::getInstance()->warning(QString("连接不存在: %1").arg(name), "CommunicationManager");
+        return false;
+    }
+
+    // 通信对象属于工作线程，串口和套接字必须在它所在的线程中打开；阻塞调用期间 config 一直有效
+    bool ok = false;
+    if (communication->thread() == QThread::currentThread()) {
+        ok = communication->connect(config);
+    } else {
+        QMetaObject::invokeMethod(communication, [communication, &config, &ok]() {
+            ok = communication->connect(config);
+        }, Qt::BlockingQueuedConnection);
+    }
+    return ok;
+}
+
+bool CommunicationManager::disconnectFromDevice(const QString& name)
+{
+    ICommunication* communication = getConnection(name);
+    if (!communication) {
+        return false;
+    }
+    if (communication->thread() == QThread::currentThread()) {
+        communication->disconnect();
+    } else {
+        QMetaObject::invokeMethod(communication, [communication]() { communication->disconnect(); },
+                                  Qt::BlockingQueuedConnection);
+    }
+    return true;
+}
+
+ICommunication* CommunicationManager::getConnection(const QString& name) const
 {
     QMutexLocker locker(&m_connectionsMutex);
+    const auto it = m_connections.constFind(name);
+    return it != m_connections.constEnd() ? it->communication : nullptr;
+}
+
+bool CommunicationManager::sendData(const QString& connectionName, const QByteArray& data)
+{
+    return sendThroughSlot(m_snapshot.loadAcquire()->byName.value(connectionName, nullptr), data);
+}
+
+bool CommunicationManager::sendFrame(const QString& connectionName, ProtocolCommand command, const QByteArray& data)
+{
+    return sendFrame(getConnectionHandle(connectionName), command, data);
+}
+
+bool CommunicationManager::sendData(ConnectionHandle handle, const QByteArray& data)
+{
+    return sendThroughSlot(findSlot(handle), data);
+}
+
+bool CommunicationManager::sendFrame(ConnectionHandle handle, ProtocolCommand command, const QByteArray& data)
+{
+    ConnectionSlot* slot = findSlot(handle);
+    if (!slot || !slot->communication
+        || slot->state.loadAcquire() != static_cast<int>(ConnectionState::Connected)) {
+        return false;
+    }
     
-    if (!m_connections.contains(connectionName)) {
+    if (!slot->communication->sendFrame(command, data)) {
         return false;
     }
     
-    ConnectionInfo& info = m_connections[connectionName];
-    if (!info.communication || info.state != ConnectionState::Connected) {
+    slot->lastActiveMs.storeRelaxed(QDateTime::currentMSecsSinceEpoch());
+    m_framesSentCounter.fetchAndAddRelaxed(1);
+    return true;
+}
+
+bool CommunicationManager::sendThroughSlot(ConnectionSlot* slot, const QByteArray& data)
+{
+    // 热路径：快照加载 + 原子状态读取，不加锁
+    if (!slot || !slot->communication
+        || slot->state.loadAcquire() != static_cast<int>(ConnectionState::Connected)) {
         return false;
     }
     
-    // 使用缓冲池分配缓冲区
-    QByteArray* buffer = nullptr;
-    if (m_bufferPool) {
-        BufferType bufferType = BufferType::Small;
-        if (data.size() > 4096) {
-            bufferType = BufferType::Huge;
-        } else if (data.size() > 1024) {
-            bufferType = BufferType::Large;
-        } else if (data.size() > 256) {
-            bufferType = BufferType::Medium;
+    if (!slot->communication->sendData(data)) {
+        return false;
+    }
+    
+    slot->lastActiveMs.storeRelaxed(QDateTime::currentMSecsSinceEpoch());
+    m_bytesSentCounter.fetchAndAddRelaxed(data.size());
+    m_framesSentCounter.fetchAndAddRelaxed(1);
+    emit dataSent(slot->name, data);
+    
+    return true;
+}
+
+ConnectionHandle CommunicationManager::getConnectionHandle(const QString& name) const
+{
+    const ConnectionSlot* slot = m_snapshot.loadAcquire()->byName.value(name, nullptr);
+    return slot ? slot->handle : InvalidConnectionHandle;
+}
+
+QString CommunicationManager::getConnectionName(ConnectionHandle handle) const
+{
+    const ConnectionSlot* slot = findSlot(handle);
+    return slot ? slot->name : QString();
+}
+
+bool CommunicationManager::isConnected(const QString& name) const
+{
+    const ConnectionSlot* slot = m_snapshot.loadAcquire()->byName.value(name, nullptr);
+    return slot && slot->state.loadAcquire() == static_cast<int>(ConnectionState::Connected);
+}
+
+bool CommunicationManager::isConnected(ConnectionHandle handle) const
+{
+    const ConnectionSlot* slot = findSlot(handle);
+    return slot && slot->state.loadAcquire() == static_cast<int>(ConnectionState::Connected);
+}
+
+ConnectionHandle CommunicationManager::getPrimaryConnectionHandle() const
+{
+    // 按优先级顺序取第一个已连接的连接
+    for (const ConnectionSlot* slot : m_snapshot.loadAcquire()->byPriority) {
+        if (slot->state.loadAcquire() == static_cast<int>(ConnectionState::Connected)) {
+            return slot->handle;
         }
-        
-        int size = 256;
-        switch (bufferType) {
-            case BufferType::Small: size = 512; break;
-            case BufferType::Medium: size = 4096; break;
-            case BufferType::Large: size = 65536; break;
-            case BufferType::Huge: size = 1048576; break;
+    }
+    return InvalidConnectionHandle;
+}
+
+QString CommunicationManager::getPrimaryConnection() const
+{
+    return getConnectionName(getPrimaryConnectionHandle());
+}
+
+void CommunicationManager::setConnectionPriority(const QString& name, int priority)
+{
+    QString previousPrimary;
+    QString currentPrimary;
+    {
+        QMutexLocker locker(&m_connectionsMutex);
+        auto it = m_connections.find(name);
+        if (it == m_connections.end() || it->priority == priority) {
+            return;
         }
-        buffer = m_bufferPool->acquireBuffer(size, bufferType);
-        if (buffer) {
-            *buffer = data;
+        previousPrimary = getPrimaryConnection();
+        it->priority = priority;
+        publishSnapshotLocked();
+        currentPrimary = getPrimaryConnection();
+    }
+    
+    if (previousPrimary != currentPrimary) {
+        emit primaryConnectionChanged(currentPrimary);
+    }
+}
+
+int CommunicationManager::getConnectionPriority(const QString& name) const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    auto it = m_connections.constFind(name);
+    return it != m_connections.constEnd() ? it->priority : -1;
+}
+
+QStringList CommunicationManager::getConnectionsByPriority() const
+{
+    QStringList names;
+    for (const ConnectionSlot* slot : m_snapshot.loadAcquire()->byPriority) {
+        names.append(slot->name);
+    }
+    return names;
+}
+
+QStringList CommunicationManager::getConnectionNames() const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    return m_connections.keys();
+}
+
+QList<ConnectionInfo> CommunicationManager::getAllConnections() const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    return m_connections.values();
+}
+
+CommunicationStats CommunicationManager::getConnectionStatistics(const QString& name) const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    auto it = m_connections.constFind(name);
+    if (it == m_connections.constEnd() || !it->communication) {
+        return CommunicationStats();
+    }
+    return it->communication->getStatistics();
+}
+
+QString CommunicationManager::generateDiagnosticReport() const
+{
+    QStringList lines;
+    lines << QString("通讯诊断报告 (%1)").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+    
+    {
+        QMutexLocker locker(&m_connectionsMutex);
+        lines << QString("连接数: %1").arg(m_connections.size());
+        for (const auto& info : m_connections) {
+            lines << QString("[%1] 类型=%2, 状态=%3, 优先级=%4")
+                         .arg(info.name)
+                         .arg(communicationTypeToString(info.type))
+                         .arg(connectionStateToString(info.state))
+                         .arg(info.priority);
+            if (!info.communication) {
+                continue;
+            }
+            
+            const CommunicationStats stats = info.communication->getStatistics();
+            lines << QString("  发送: %1字节/%2帧, 接收: %3字节/%4帧, 错误: %5, 重连: %6")
+                         .arg(stats.bytesSent)
+                         .arg(stats.framesSent)
+                         .arg(stats.bytesReceived)
+                         .arg(stats.framesReceived)
+                         .arg(stats.errorCount)
+                         .arg(stats.reconnectCount);
+            if (stats.reconnectCount > 0) {
+                lines << QString("  重连恢复: 最近 %1 ms, 最长 %2 ms").arg(stats.lastRecoveryMs).arg(stats.maxRecoveryMs);
+            }
+            lines << QString("  心跳往返: %1").arg(info.communication->getHeartbeatHistogram().summary());
         }
     }
     
-    bool success = false;
-    if (buffer) {
-        success = info.communication->sendData(*buffer);
-        // 释放缓冲区
-        m_bufferPool->releaseBuffer(buffer);
-    } else {
-        success = info.communication->sendData(data);
+    lines << "快速通道:";
+    lines << FastLaneMonitor::getInstance()->report();
+    return lines.join('\n');
+}
+
+CommunicationManager::ConnectionSlot* CommunicationManager::findSlot(ConnectionHandle handle) const
+{
+    const ConnectionSnapshot* snapshot = m_snapshot.loadAcquire();
+    if (handle < 0 || handle >= snapshot->entries.size()) {
+        return nullptr;
     }
+    return snapshot->entries.at(handle);
+}
+
+CommunicationManager::ConnectionSlot* CommunicationManager::addSlotLocked(const ConnectionInfo& info)
+{
+    ConnectionSlot* slot = new ConnectionSlot();
+    slot->handle = m_nextHandle++;
+    slot->name = info.name;
+    slot->communication = info.communication;
+    slot->state.storeRelaxed(static_cast<int>(info.state));
+    slot->lastActiveMs.storeRelaxed(info.lastActiveTime.toMSecsSinceEpoch());
+    m_connectionSlots.insert(info.name, slot);
+    return slot;
+}
+
+void CommunicationManager::retireSlotLocked(const QString& name)
+{
+    ConnectionSlot* slot = m_connectionSlots.take(name);
+    if (slot) {
+        slot->state.storeRelease(static_cast<int>(ConnectionState::Disconnected));
+        m_pendingRemovedSlots.append(slot);
+    }
+    MetricsRegistry::retire(MetricsRegistry::label("connection", name));
+}
+
+void CommunicationManager::publishSnapshotLocked()
+{
+    ConnectionSnapshot* snapshot = new ConnectionSnapshot();
+    for (ConnectionSlot* slot : std::as_const(m_connectionSlots)) {
+        if (snapshot->entries.size() <= slot->handle) {
+            snapshot->entries.resize(slot->handle + 1);
+        }
+        snapshot->entries[slot->handle] = slot;
+        snapshot->byName.insert(slot->name, slot);
+        snapshot->byPriority.append(slot);
+    }
+    std::sort(snapshot->byPriority.begin(), snapshot->byPriority.end(),
+              [this](const ConnectionSlot* a, const ConnectionSlot* b) {
+        const int priorityA = m_connections.value(a->name).priority;
+        const int priorityB = m_connections.value(b->name).priority;
+        return priorityA != priorityB ? priorityA < priorityB : a->handle < b->handle;
+    });
     
-    if (success) {
-        updateConnectionActivity(connectionName);
-        emit dataSent(connectionName, data);
+    const ConnectionSnapshot* previous = m_snapshot.fetchAndStoreOrdered(snapshot);
+    if (previous) {
+        // 被移除的槽跟随最后一个引用它的快照一起回收
+        m_retiredSnapshots.append({previous, m_pendingRemovedSlots, QDateTime::currentMSecsSinceEpoch()});
+        m_pendingRemovedSlots.clear();
+    }
+    
+    reclaimRetiredSnapshotsLocked();
+}
+
+void CommunicationManager::reclaimRetiredSnapshotsLocked(bool force)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (!m_retiredSnapshots.isEmpty()) {
+        const RetiredSnapshot& retired = m_retiredSnapshots.first();
+        if (!force && now - retired.retiredMs < Communication::CONNECTION_SNAPSHOT_GRACE_MS) {
+            break;   // 按退役时间排列，后面的更新
+        }
+        delete retired.snapshot;
+        for (ConnectionSlot* slot : retired.removedSlots) {
+            if (slot->communication) {
+                slot->communication->deleteLater();
+            }
+            delete slot;
+        }
+        m_retiredSnapshots.removeFirst();
+    }
+}
+
+bool CommunicationManager::broadcastData(const QByteArray& data)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+    return dispatchBroadcast(data);
+}
+
+bool CommunicationManager::broadcastFrame(ProtocolCommand command, const QByteArray& data)
+{
+    if (data.size() > Protocol::MAX_DATA_SIZE) {
+        LogManager::getInstance()->error("广播数据长度超过最大限制", "CommunicationManager");
+        return false;
+    }
+    
+    // 帧只构建一次，所有连接共享同一份只读缓冲区
+    QByteArray frame(FrameWriter::requiredSize(data.size()), Qt::Uninitialized);
+    FrameWriter writer(frame.data(), frame.size());
+    if (!writer.begin(static_cast<quint8>(command), data.size())) {
+        return false;
+    }
+    writer.writeBytes(data);
+    if (writer.finish().isEmpty()) {
+        return false;
+    }
+    frame.resize(writer.size());
+    
+    return dispatchBroadcast(frame);
+}
+
+bool CommunicationManager::dispatchBroadcast(const QByteArray& payload)
+{
+    // 锁内只做快照，发送在各连接线程中进行
+    QList<QPair<QString, ICommunication*>> targets;
+    {
+        QMutexLocker locker(&m_connectionsMutex);
+        for (auto it = m_connections.cbegin(); it != m_connections.cend(); ++it) {
+            if (it->communication && it->state == ConnectionState::Connected) {
+                targets.append(qMakePair(it.key(), it->communication));
+            }
+        }
+    }
+    
+    if (targets.isEmpty()) {
+        return false;
+    }
+    
+    struct BroadcastTracker {
+        QMutex mutex;
+        BroadcastReport report;
+        int remaining;
+    };
+    auto tracker = std::make_shared<BroadcastTracker>();
+    tracker->report.broadcastId = ++m_broadcastSequence;
+    tracker->report.targetCount = targets.size();
+    tracker->report.dispatchNs = ProtocolFrame::currentTimestampNs();
+    tracker->remaining = targets.size();
+    
+    auto sendOne = [this, tracker, payload](const QString& name, ICommunication* communication) {
+        const bool success = communication->sendData(payload);
+        const qint64 sentNs = ProtocolFrame::currentTimestampNs();
+        
+        if (success) {
+            updateConnectionActivity(name);
+            emit dataSent(name, payload);
+            m_bytesSentCounter.fetchAndAddRelaxed(payload.size());
+            m_framesSentCounter.fetchAndAddRelaxed(1);
+        }
+        
+        QMutexLocker locker(&tracker->mutex);
+        BroadcastReport& report = tracker->report;
+        if (report.firstSendNs == 0 || sentNs < report.firstSendNs) report.firstSendNs = sentNs;
+        if (sentNs > report.lastSendNs) report.lastSendNs = sentNs;
+        if (success) report.successCount++;
         
-        // 更新统计信息
-        QMutexLocker statsLocker(&m_statsMutex);
-        m_totalStats.bytesSent += data.size();
-        m_totalStats.framesSent++;
+        if (--tracker->remaining == 0) {
+            const BroadcastReport finished = report;
+            QMetaObject::invokeMethod(this, [this, finished]() {
+                m_lastBroadcastReport = finished;
+                emit broadcastCompleted(finished);
+                if (finished.successCount < finished.targetCount) {
+                    LogManager::getInstance()->warning(
+                        QString("广播 #%1 部分失败: %2/%3")
+                            .arg(finished.broadcastId).arg(finished.successCount).arg(finished.targetCount),
+                        "CommunicationManager");
+                }
+            }, Qt::QueuedConnection);
+        }
+    };
+    
+    // 先投递到其他线程的连接，使它们与本线程的连接同时发送
+    QList<QPair<QString, ICommunication*>> localTargets;
+    for (const auto& target : targets) {
+        ICommunication* communication = target.second;
+        if (communication->thread() == QThread::currentThread()) {
+            localTargets.append(target);
+            continue;
+        }
+        const QString name = target.first;
+        QMetaObject::invokeMethod(communication, [sendOne, name, communication]() {
+            sendOne(name, communication);
+        }, Qt::QueuedConnection);
+    }
+    for (const auto& target : localTargets) {
+        sendOne(target.first, target.second);
     }
     
-    return success;
+    return true;
+}
+
+BroadcastReport CommunicationManager::getLastBroadcastReport() const
+{
+    return m_lastBroadcastReport;
 }
 
 // 缓冲池管理方法实现
@@ -393,6 +797,54 @@ void CommunicationManager::enableBufferPool(bool enabled)
     }
 }
 
+void CommunicationManager::setMaxConnections(int maxCount)
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    m_maxConnections = qMax(1, maxCount);
+}
+
+int CommunicationManager::getMaxConnections() const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    return m_maxConnections;
+}
+
+bool CommunicationManager::setIoThreadCount(int count)
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    if (!m_connections.isEmpty()) {
+        LogManager::getInstance()->warning("已有连接时不能修改I/O线程数", "CommunicationManager");
+        return false;
+    }
+    
+    count = qMax(0, count);
+    if (count == (m_connectionGroup ? m_connectionGroup->threadCount() : 0)) {
+        return true;
+    }
+    
+    delete m_connectionGroup;
+    m_connectionGroup = nullptr;
+    if (count > 0) {
+        m_connectionGroup = new ConnectionGroup(count);
+        m_connectionGroup->start();
+    }
+    
+    LogManager::getInstance()->info(QString("I/O线程数: %1").arg(count), "CommunicationManager");
+    return true;
+}
+
+int CommunicationManager::getIoThreadCount() const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    return m_connectionGroup ? m_connectionGroup->threadCount() : 0;
+}
+
+QList<int> CommunicationManager::getIoThreadLoads() const
+{
+    QMutexLocker locker(&m_connectionsMutex);
+    return m_connectionGroup ? m_connectionGroup->connectionCounts() : QList<int>();
+}
+
 // 辅助方法实现
 QString CommunicationManager::generateUniqueConnectionName(CommunicationType type) const
 {
@@ -433,9 +885,21 @@ void CommunicationManager::setupConnection(ConnectionInfo& info)
             this, &CommunicationManager::onConnectionStateChanged);
     connect(info.communication, &ICommunication::connectionError,
             this, &CommunicationManager::onConnectionError);
+    connect(info.communication, &ICommunication::recovered,
+            this, &CommunicationManager::onConnectionRecovered);
     connect(info.communication, &ICommunication::dataReceived,
             this, &CommunicationManager::onDataReceived);
     
+    // 启用连接组时 TCP 连接分配到 I/O 线程，批量帧在该线程直接转发
+    TcpCommunication* tcp = qobject_cast<TcpCommunication*>(info.communication);
+    if (m_connectionGroup && tcp && m_connectionGroup->assign(tcp)) {
+        const QString name = info.name;
+        connect(tcp, &TcpCommunication::framesReceived, this,
+                [this, name](const FrameBatch& frames) { emit framesReceived(name, frames); },
+                Qt::DirectConnection);
+        return;
+    }
+    
     // 移动到工作线程
     moveToWorkerThread(info.communication);
 }
@@ -451,10 +915,10 @@ void CommunicationManager::cleanupConnection(ConnectionInfo& info)
 
 void CommunicationManager::updateConnectionActivity(const QString& name)
 {
-    QMutexLocker locker(&m_connectionsMutex);
-    if (m_connections.contains(name)) {
-        m_connections[name].lastActiveTime = QDateTime::currentDateTime();
-        m_connections[name].isActive = true;
+    // 只写连接槽的原子时间戳，持有 m_connectionsMutex 的调用方也可安全调用
+    ConnectionSlot* slot = m_snapshot.loadAcquire()->byName.value(name, nullptr);
+    if (slot) {
+        slot->lastActiveMs.storeRelaxed(QDateTime::currentMSecsSinceEpoch());
     }
 }
 
@@ -476,6 +940,9 @@ void CommunicationManager::onConnectionConnected()
         if (info.communication == communication) {
             info.state = ConnectionState::Connected;
             info.isActive = true;
+            if (ConnectionSlot* slot = m_connectionSlots.value(info.name)) {
+                slot->state.storeRelease(static_cast<int>(ConnectionState::Connected));
+            }
             updateConnectionActivity(info.name);
             emit connectionConnected(info.name);
             break;
@@ -493,6 +960,9 @@ void CommunicationManager::onConnectionDisconnected()
         if (info.communication == communication) {
             info.state = ConnectionState::Disconnected;
             info.isActive = false;
+            if (ConnectionSlot* slot = m_connectionSlots.value(info.name)) {
+                slot->state.storeRelease(static_cast<int>(ConnectionState::Disconnected));
+            }
             emit connectionDisconnected(info.name);
             break;
         }
@@ -508,6 +978,9 @@ void CommunicationManager::onConnectionStateChanged(ConnectionState state)
     for (auto& info : m_connections) {
         if (info.communication == communication) {
             info.state = state;
+            if (ConnectionSlot* slot = m_connectionSlots.value(info.name)) {
+                slot->state.storeRelease(static_cast<int>(state));
+            }
             emit connectionStateChanged(info.name, state);
             break;
         }
@@ -532,6 +1005,24 @@ void CommunicationManager::onConnectionError(const QString& error)
     }
 }
 
+void CommunicationManager::onConnectionRecovered(qint64 recoveryMs)
+{
+    ICommunication* communication = qobject_cast<ICommunication*>(sender());
+    if (!communication) return;
+    
+    QMutexLocker locker(&m_connectionsMutex);
+    for (auto& info : m_connections) {
+        if (info.communication == communication) {
+            emit connectionRecovered(info.name, recoveryMs);
+            LogManager::getInstance()->info(
+                QString("连接已恢复 [%1]: 用时 %2 ms").arg(info.name).arg(recoveryMs),
+                "CommunicationManager"
+            );
+            break;
+        }
+    }
+}
+
 void CommunicationManager::onDataReceived(const QByteArray& data)
 {
     ICommunication* communication = qobject_cast<ICommunication*>(sender());
@@ -580,38 +1071,56 @@ void CommunicationManager::onCleanupTimer()
 {
     // 清理不活跃连接
     cleanupInactiveConnections();
+    
+    QMutexLocker locker(&m_connectionsMutex);
+    reclaimRetiredSnapshotsLocked();
 }
 
 void CommunicationManager::calculateTotalStatistics()
 {
     // 计算总体统计信息
     QMutexLocker locker(&m_statsMutex);
+    m_totalStats.bytesSent = m_bytesSentCounter.loadRelaxed();
+    m_totalStats.framesSent = m_framesSentCounter.loadRelaxed();
     // 这里可以添加更复杂的统计计算逻辑
 }
 
 void CommunicationManager::cleanupInactiveConnections()
 {
     QMutexLocker locker(&m_connectionsMutex);
-    QDateTime now = QDateTime::currentDateTime();
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    bool removed = false;
     
     for (auto it = m_connections.begin(); it != m_connections.end();) {
-        const auto& info = it.value();
+        ConnectionInfo& info = it.value();
+        const ConnectionSlot* slot = m_connectionSlots.value(info.name);
+        const qint64 lastActiveMs = slot ? slot->lastActiveMs.loadRelaxed()
+                                         : info.lastActiveTime.toMSecsSinceEpoch();
         
         // 检查连接是否长时间不活跃
         if (info.state == ConnectionState::Disconnected &&
-            info.lastActiveTime.secsTo(now) > 3600) { // 1小时不活跃
+            nowMs - lastActiveMs > 3600 * 1000) { // 1小时不活跃
             
             LogManager::getInstance()->info(
                 QString("清理不活跃连接: %1").arg(info.name),
                 "CommunicationManager"
             );
             
-            cleanupConnection(const_cast<ConnectionInfo&>(info));
+            if (info.communication) {
+                info.communication->disconnect();
+                info.communication = nullptr;
+            }
+            retireSlotLocked(info.name);
             it = m_connections.erase(it);
+            removed = true;
         } else {
             ++it;
         }
     }
+    
+    if (removed) {
+        publishSnapshotLocked();
+    }
 }
 
 void CommunicationManager::disconnectAll()
@@ -627,13 +1136,22 @@ void CommunicationManager::disconnectAll()
 
 void CommunicationManager::reconnectAll()
 {
+    // reconnect() 只安排各连接在自己线程上按退避间隔异步重连，不在此等待建连，
+    // 同时进行的建连尝试数由 ReconnectScheduler 限制
     QMutexLocker locker(&m_connectionsMutex);
+    int count = 0;
     for (auto& info : m_connections) {
-        if (info.communication && info.state == ConnectionState::Disconnected) {
+        if (info.communication
+            && (info.state == ConnectionState::Disconnected || info.state == ConnectionState::Error)) {
             info.communication->reconnect();
+            ++count;
         }
     }
-    LogManager::getInstance()->info("重新连接所有断开的连接", "CommunicationManager");
+    LogManager::getInstance()->info(
+        QString("重新连接所有断开的连接: %1 个，最多同时建连 %2 个")
+            .arg(count).arg(ReconnectScheduler::maxConcurrent()),
+        "CommunicationManager"
+    );
 }
 
 void CommunicationManager::startMonitoring()
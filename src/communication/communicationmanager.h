@@ -5,10 +5,15 @@
 #include <QTimer>
 #include <QMutex>
 #include <QThread>
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QHash>
 #include "icommunication.h"
 #include "constants.h"
 #include "communicationbufferpool.h"
 
+class ConnectionGroup;
+
 // 连接信息结构
 struct ConnectionInfo {
     QString name;
@@ -31,6 +36,24 @@ struct ConnectionInfo {
     {}
 };
 
+// 连接句柄：创建连接时分配的小整数，连接存续期间不变，移除后不复用
+using ConnectionHandle = int;
+constexpr ConnectionHandle InvalidConnectionHandle = -1;
+
+// 广播发送报告：各连接在自己的I/O线程完成发送的时间分布
+struct BroadcastReport {
+    quint64 broadcastId = 0;
+    int targetCount = 0;        // 参与广播的连接数
+    int successCount = 0;       // 发送成功的连接数
+    qint64 dispatchNs = 0;      // 发起时刻（steady_clock纳秒）
+    qint64 firstSendNs = 0;     // 最早完成发送的时刻
+    qint64 lastSendNs = 0;      // 最晚完成发送的时刻
+    
+    qint64 skewNs() const { return lastSendNs - firstSendNs; }       // 首末设备的发送偏差
+    qint64 durationNs() const { return lastSendNs - dispatchNs; }    // 发起到全部完成
+};
+Q_DECLARE_METATYPE(BroadcastReport)
+
 // 通讯管理器类
 class CommunicationManager : public QObject
 {
@@ -60,11 +83,22 @@ public:
     int getConnectionCount() const;
     int getActiveConnectionCount() const;
     
+    // 句柄接口：在连接表快照上无锁查找，供每帧发送等热路径使用
+    ConnectionHandle getConnectionHandle(const QString& name) const;
+    QString getConnectionName(ConnectionHandle handle) const;
+    bool isConnected(ConnectionHandle handle) const;
+    ConnectionHandle getPrimaryConnectionHandle() const;
+    bool sendData(ConnectionHandle handle, const QByteArray& data);
+    bool sendFrame(ConnectionHandle handle, ProtocolCommand command, const QByteArray& data = QByteArray());
+    
     // 数据传输
     bool sendData(const QString& connectionName, const QByteArray& data);
     bool sendFrame(const QString& connectionName, ProtocolCommand command, const QByteArray& data = QByteArray());
+    // 广播：载荷/帧只构建一次并隐式共享，投递到各连接所在线程并行发送，
+    // 全部完成后发出 broadcastCompleted；返回值表示是否至少投递到一个连接
     bool broadcastData(const QByteArray& data);
     bool broadcastFrame(ProtocolCommand command, const QByteArray& data = QByteArray());
+    BroadcastReport getLastBroadcastReport() const;
     
     // 配置管理
     bool setConnectionConfig(const QString& name, const CommunicationConfig& config);
@@ -96,6 +130,13 @@ public:
     bool isConnectionPoolingEnabled() const;
     void setMaxConnections(int maxCount);
     int getMaxConnections() const;
+    
+    // 连接组：count > 0 时之后创建的 TCP 连接分配到 count 个共用的 I/O 线程（见 ConnectionGroup），
+    // 接收数据通过 framesReceived 成批投递；0 表示全部连接共用一个工作线程（默认）。
+    // 只能在没有连接时修改，串口连接始终在工作线程
+    bool setIoThreadCount(int count);
+    int getIoThreadCount() const;
+    QList<int> getIoThreadLoads() const;        // 各 I/O 线程承载的连接数
     bool testAllConnections();
     void flushAllBuffers();
     void clearAllBuffers();
@@ -130,12 +171,15 @@ signals:
     void connectionDisconnected(const QString& name);
     void connectionStateChanged(const QString& name, ConnectionState state);
     void connectionError(const QString& name, const QString& error);
+    void connectionRecovered(const QString& name, qint64 recoveryMs);  // 掉线到自动重连成功的时间
     
     // 数据传输信号
     void dataReceived(const QString& connectionName, const QByteArray& data);
     void dataSent(const QString& connectionName, const QByteArray& data);
     void frameReceived(const QString& connectionName, const ProtocolFrame& frame);
+    void framesReceived(const QString& connectionName, const FrameBatch& frames);   // 连接组中的连接，在其 I/O 线程发出
     void frameSent(const QString& connectionName, const ProtocolFrame& frame);
+    void broadcastCompleted(const BroadcastReport& report);
     
     // 状态监控信号
     void allConnectionsDisconnected();
@@ -165,6 +209,7 @@ private slots:
     void onConnectionDisconnected();
     void onConnectionStateChanged(ConnectionState state);
     void onConnectionError(const QString& error);
+    void onConnectionRecovered(qint64 recoveryMs);
     void onDataReceived(const QByteArray& data);
     void onFrameReceived(const ProtocolFrame& frame);
     
@@ -182,6 +227,32 @@ private:
     QMap<QString, ConnectionInfo> m_connections;
     mutable QMutex m_connectionsMutex;
     
+    // 连接表快照（读-复制-更新）：读者只做一次 acquire 加载，
+    // 创建/移除/优先级变更在 m_connectionsMutex 内复制出新快照后原子发布，
+    // 旧快照及已移除的连接在宽限期后回收
+    struct ConnectionSlot {
+        ConnectionHandle handle;
+        QString name;
+        ICommunication* communication;
+        QAtomicInt state;                       // ConnectionState
+        QAtomicInteger<qint64> lastActiveMs;
+    };
+    struct ConnectionSnapshot {
+        QList<ConnectionSlot*> entries;         // 下标即句柄，已移除为空
+        QHash<QString, ConnectionSlot*> byName;
+        QList<ConnectionSlot*> byPriority;      // 按优先级升序
+    };
+    struct RetiredSnapshot {
+        const ConnectionSnapshot* snapshot;
+        QList<ConnectionSlot*> removedSlots;
+        qint64 retiredMs;
+    };
+    QAtomicPointer<const ConnectionSnapshot> m_snapshot;
+    QHash<QString, ConnectionSlot*> m_connectionSlots;  // 受 m_connectionsMutex 保护
+    QList<ConnectionSlot*> m_pendingRemovedSlots;
+    QList<RetiredSnapshot> m_retiredSnapshots;
+    ConnectionHandle m_nextHandle;
+    
     // 全局设置
     bool m_autoReconnectEnabled;
     bool m_heartbeatEnabled;
@@ -198,14 +269,21 @@ private:
     
     // 线程管理
     QThread* m_workerThread;
+    ConnectionGroup* m_connectionGroup;     // 未启用连接组时为空
     
     // 统计信息
     CommunicationStats m_totalStats;
     mutable QMutex m_statsMutex;
+    QAtomicInteger<qint64> m_bytesSentCounter;          // 发送路径无锁计数，汇总时并入 m_totalStats
+    QAtomicInteger<qint64> m_framesSentCounter;
     
     // 缓冲池管理器
     CommunicationBufferPool* m_bufferPool;
     
+    // 广播
+    QAtomicInteger<quint64> m_broadcastSequence;
+    BroadcastReport m_lastBroadcastReport;
+    
     // 辅助方法
     QString generateUniqueConnectionName(CommunicationType type) const;
     void setupConnection(ConnectionInfo& info);
@@ -214,6 +292,13 @@ private:
     void calculateTotalStatistics();
     bool validateConnectionName(const QString& name) const;
     void moveToWorkerThread(ICommunication* communication);
+    bool dispatchBroadcast(const QByteArray& payload);
+    ConnectionSlot* findSlot(ConnectionHandle handle) const;
+    ConnectionSlot* addSlotLocked(const ConnectionInfo& info);
+    void retireSlotLocked(const QString& name);
+    void publishSnapshotLocked();
+    void reclaimRetiredSnapshotsLocked(bool force = false);
+    bool sendThroughSlot(ConnectionSlot* slot, const QByteArray& data);
     void setupGlobalConnections();
     void saveSettings();
     void loadSettings();
@@ -0,0 +1,300 @@
+#include "connectiongroup.h"
+#include "tcpcommunication.h"
+#include "logger/logmanager.h"
+#include "constants.h"
+#include "../utils/monotonicclock.h"
+#include "../utils/threadpolicy.h"
+#include <QTimer>
+#include <QMutexLocker>
+
+namespace {
+constexpr qint64 NS_PER_MS = 1000000;
+}
+
+// ========== IoThread ==========
+
+IoThread::IoThread(int index, QObject* parent)
+    : QObject(parent)
+    , m_index(index)
+    , m_tickTimer(nullptr)
+    , m_wheel(Communication::IO_TIMER_WHEEL_SLOTS, Communication::IO_TIMER_WHEEL_TICK_MS * NS_PER_MS,
+              MonotonicClock::nowNs())
+    , m_connectionCount(0)
+{
+    m_thread.setObjectName(QString("IoThread-%1").arg(index));
+}
+
+IoThread::~IoThread()
+{
+    stop();
+}
+
+void IoThread::start()
+{
+    if (m_thread.isRunning()) {
+        return;
+    }
+
+    // 带父对象不能迁移线程，IoThread 由 ConnectionGroup 管理生命周期
+    moveToThread(&m_thread);
+    m_thread.start();
+    QMetaObject::invokeMethod(this, [this]() {
+        ThreadPolicy::getInstance()->applyToCurrentThread(ThreadRole::TcpIo);
+        m_tickTimer = new QTimer(this);
+        m_tickTimer->setTimerType(Qt::PreciseTimer);
+        QObject::connect(m_tickTimer, &QTimer::timeout, this, &IoThread::onTick);
+        m_tickTimer->start(Communication::IO_TIMER_WHEEL_TICK_MS);
+    }, Qt::BlockingQueuedConnection);
+}
+
+void IoThread::stop()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+
+    if (m_connectionCount.loadAcquire() > 0) {
+        LogManager::getInstance()->warning(
+            QString("I/O线程 %1 停止时仍有 %2 个连接").arg(m_index).arg(m_connectionCount.loadAcquire()),
+            "ConnectionGroup");
+    }
+
+    // 驱动定时器在本线程创建，也在本线程销毁；之后回到调用线程，线程结束后对象仍可析构
+    QThread* target = QThread::currentThread();
+    QMetaObject::invokeMethod(this, [this, target]() {
+        delete m_tickTimer;
+        m_tickTimer = nullptr;
+        moveToThread(target);
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool IoThread::isRunning() const
+{
+    return m_thread.isRunning();
+}
+
+int IoThread::index() const
+{
+    return m_index;
+}
+
+QThread* IoThread::ioThread()
+{
+    return &m_thread;
+}
+
+TimerWheel* IoThread::timerWheel()
+{
+    return &m_wheel;
+}
+
+int IoThread::connectionCount() const
+{
+    return m_connectionCount.loadAcquire();
+}
+
+void IoThread::addConnection()
+{
+    m_connectionCount.ref();
+}
+
+void IoThread::removeConnection()
+{
+    m_connectionCount.deref();
+}
+
+void IoThread::onTick()
+{
+    m_wheel.advance(MonotonicClock::nowNs());
+}
+
+// ========== ConnectionTimer ==========
+
+ConnectionTimer::ConnectionTimer(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_wheel(nullptr)
+    , m_wheelTimer(TimerWheel::InvalidTimer)
+    , m_intervalMs(0)
+    , m_singleShot(false)
+{
+    QObject::connect(m_timer, &QTimer::timeout, this, &ConnectionTimer::timeout);
+}
+
+ConnectionTimer::~ConnectionTimer()
+{
+    if (m_wheel) {
+        m_wheel->remove(m_wheelTimer);
+    }
+}
+
+void ConnectionTimer::setSingleShot(bool singleShot)
+{
+    m_singleShot = singleShot;
+    m_timer->setSingleShot(singleShot);
+}
+
+bool ConnectionTimer::isSingleShot() const
+{
+    return m_singleShot;
+}
+
+void ConnectionTimer::setInterval(int intervalMs)
+{
+    m_intervalMs = intervalMs;
+    if (!m_wheel) {
+        m_timer->setInterval(intervalMs);
+    } else if (m_wheel->isArmed(m_wheelTimer)) {
+        start();
+    }
+}
+
+int ConnectionTimer::interval() const
+{
+    return m_intervalMs;
+}
+
+void ConnectionTimer::start()
+{
+    if (!m_wheel) {
+        m_timer->start(m_intervalMs);
+        return;
+    }
+    const qint64 intervalNs = qint64(m_intervalMs) * NS_PER_MS;
+    m_wheel->arm(m_wheelTimer, intervalNs, m_singleShot ? 0 : intervalNs, MonotonicClock::nowNs());
+}
+
+void ConnectionTimer::start(int intervalMs)
+{
+    m_intervalMs = intervalMs;
+    start();
+}
+
+void ConnectionTimer::stop()
+{
+    if (m_wheel) {
+        m_wheel->disarm(m_wheelTimer);
+    } else {
+        m_timer->stop();
+    }
+}
+
+bool ConnectionTimer::isActive() const
+{
+    return m_wheel ? m_wheel->isArmed(m_wheelTimer) : m_timer->isActive();
+}
+
+void ConnectionTimer::attachWheel(TimerWheel* wheel)
+{
+    if (wheel == m_wheel) {
+        return;
+    }
+
+    const bool active = isActive();
+    stop();
+    if (m_wheel) {
+        m_wheel->remove(m_wheelTimer);
+        m_wheelTimer = TimerWheel::InvalidTimer;
+    }
+
+    m_wheel = wheel;
+    if (m_wheel) {
+        m_wheelTimer = m_wheel->add([this]() { emit timeout(); });
+    }
+    if (active) {
+        start();
+    }
+}
+
+// ========== ConnectionGroup ==========
+
+ConnectionGroup::ConnectionGroup(int threadCount)
+    : m_running(false)
+{
+    for (int i = 0; i < qMax(1, threadCount); ++i) {
+        m_threads.append(new IoThread(i));
+    }
+}
+
+ConnectionGroup::~ConnectionGroup()
+{
+    stop();
+    qDeleteAll(m_threads);
+}
+
+void ConnectionGroup::start()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_running) {
+        return;
+    }
+    for (IoThread* thread : m_threads) {
+        thread->start();
+    }
+    m_running = true;
+
+    LogManager::getInstance()->info(QString("连接组已启动: %1 个I/O线程").arg(m_threads.size()), "ConnectionGroup");
+}
+
+void ConnectionGroup::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_running) {
+        return;
+    }
+    for (IoThread* thread : m_threads) {
+        thread->stop();
+    }
+    m_running = false;
+}
+
+bool ConnectionGroup::isRunning() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_running;
+}
+
+bool ConnectionGroup::assign(TcpCommunication* connection)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!connection || !m_running) {
+        return false;
+    }
+    IoThread* thread = leastLoadedLocked();
+    return connection->joinIoThread(thread);
+}
+
+void ConnectionGroup::release(TcpCommunication* connection)
+{
+    if (connection) {
+        connection->leaveIoThread();
+    }
+}
+
+int ConnectionGroup::threadCount() const
+{
+    return m_threads.size();
+}
+
+QList<int> ConnectionGroup::connectionCounts() const
+{
+    QList<int> counts;
+    for (const IoThread* thread : m_threads) {
+        counts.append(thread->connectionCount());
+    }
+    return counts;
+}
+
+IoThread* ConnectionGroup::leastLoadedLocked() const
+{
+    IoThread* best = m_threads.first();
+    for (IoThread* thread : m_threads) {
+        if (thread->connectionCount() < best->connectionCount()) {
+            best = thread;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include "../utils/timerwheel.h"
+
+class QTimer;
+class TcpCommunication;
+
+// 连接组 I/O 线程 - 承载多个连接的套接字、协议解析和定时器。
+// 线程内所有连接的心跳、重连、连接超时、统计和 Keep-Alive 定时器都挂在同一个时间轮上，
+// 由一个固定刻度的 QTimer 驱动，线程数和定时器事件数不随连接数增长。
+class IoThread : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IoThread(int index, QObject* parent = nullptr);
+    ~IoThread() override;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    int index() const;
+    QThread* ioThread();
+    // 只能在本线程中使用
+    TimerWheel* timerWheel();
+
+    int connectionCount() const;
+    void addConnection();
+    void removeConnection();
+
+private slots:
+    void onTick();
+
+private:
+    int m_index;
+    QThread m_thread;
+    QTimer* m_tickTimer;
+    TimerWheel m_wheel;
+    QAtomicInt m_connectionCount;
+};
+
+// 连接用定时器 - 接口与 QTimer 相同的子集。未接入 I/O 线程时就是一个 QTimer，
+// 接入后改用所在线程的时间轮，停止/重启不再产生定时器事件。只在所属线程中使用
+class ConnectionTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConnectionTimer(QObject* parent = nullptr);
+    ~ConnectionTimer() override;
+
+    void setSingleShot(bool singleShot);
+    bool isSingleShot() const;
+    // 运行中修改间隔时从现在起重新计时，与 QTimer 一致
+    void setInterval(int intervalMs);
+    int interval() const;
+
+    void start();
+    void start(int intervalMs);
+    void stop();
+    bool isActive() const;
+
+    // 切换到 wheel（为空时回到 QTimer），运行中的定时器按完整间隔重新开始
+    void attachWheel(TimerWheel* wheel);
+
+signals:
+    void timeout();
+
+private:
+    QTimer* m_timer;
+    TimerWheel* m_wheel;
+    TimerWheel::TimerId m_wheelTimer;
+    int m_intervalMs;
+    bool m_singleShot;
+};
+
+// 连接组 - 固定数量的 I/O 线程，新连接分配到当前承载连接最少的线程。
+// 线程数远少于连接数：几十台设备共用几个线程，每个线程一个时间轮。
+// 连接在断开状态下加入，加入后对它的调用同步转到所在 I/O 线程执行（与专用网络线程相同）。
+class ConnectionGroup
+{
+public:
+    explicit ConnectionGroup(int threadCount);
+    ~ConnectionGroup();
+
+    void start();
+    void stop();            // 调用前所有连接必须已经离开
+    bool isRunning() const;
+
+    bool assign(TcpCommunication* connection);
+    void release(TcpCommunication* connection);
+
+    int threadCount() const;
+    QList<int> connectionCounts() const;
+
+private:
+    IoThread* leastLoadedLocked() const;
+
+    QList<IoThread*> m_threads;
+    mutable QMutex m_mutex;
+    bool m_running;
+};
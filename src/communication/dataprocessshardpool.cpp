@@ -0,0 +1,330 @@
+#include "dataprocessshardpool.h"
+#include "communicationmanager.h"
+#include "logger/logmanager.h"
+#include "utils/workloadprofile.h"
+#include <QThread>
+#include <climits>
+
+DataProcessShardPool::DataProcessShardPool(QObject* parent)
+    : QObject(parent)
+    , m_nextCpu(0)
+    , m_running(false)
+    , m_rollupTimer(new QTimer(this))
+{
+    qRegisterMetaType<DataShardRollup>("DataShardRollup");
+
+    m_rollupTimer->setInterval(Communication::DATA_SHARD_ROLLUP_INTERVAL);
+    connect(m_rollupTimer, &QTimer::timeout, this, &DataProcessShardPool::onRollupTimer);
+}
+
+DataProcessShardPool::~DataProcessShardPool()
+{
+    stop();
+
+    // 分片对象在各自线程中，析构时由 DataProcessWorker 负责结束线程
+    QWriteLocker locker(&m_lock);
+    for (const Shard& shard : m_shards) {
+        delete shard.worker;
+    }
+    m_shards.clear();
+    m_routes.clear();
+}
+
+void DataProcessShardPool::setConfig(const DataShardConfig& config)
+{
+    QWriteLocker locker(&m_lock);
+    m_config = config;
+    m_config.maxShards = qMax(1, m_config.maxShards);
+}
+
+DataShardConfig DataProcessShardPool::config() const
+{
+    QReadLocker locker(&m_lock);
+    return m_config;
+}
+
+void DataProcessShardPool::setBatchSize(int batchSize)
+{
+    QWriteLocker locker(&m_lock);
+    m_config.batchSize = qMax(1, batchSize);
+    for (const Shard& shard : m_shards) {
+        shard.worker->setBatchSize(m_config.batchSize);
+    }
+}
+
+void DataProcessShardPool::applyWorkloadProfile(const WorkloadProfile& profile)
+{
+    QWriteLocker locker(&m_lock);
+    m_config.batchSize = qMax(1, profile.dataBatchSize);
+    m_config.maxQueueSize = qMax(1, profile.dataMaxQueueSize);
+    for (const Shard& shard : m_shards) {
+        shard.worker->applyWorkloadProfile(profile);
+    }
+}
+
+void DataProcessShardPool::start()
+{
+    QWriteLocker locker(&m_lock);
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    for (const Shard& shard : m_shards) {
+        shard.worker->startProcessing();
+    }
+    locker.unlock();
+
+    m_rollupTimer->start();
+    LogManager::getInstance()->info(QString("数据处理分片池已启动，分片数=%1").arg(shardCount()), "DataProcessShardPool");
+}
+
+void DataProcessShardPool::stop()
+{
+    QWriteLocker locker(&m_lock);
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    for (const Shard& shard : m_shards) {
+        shard.worker->stopProcessing();
+    }
+    locker.unlock();
+
+    m_rollupTimer->stop();
+    LogManager::getInstance()->info("数据处理分片池已停止", "DataProcessShardPool");
+}
+
+void DataProcessShardPool::attach(CommunicationManager* manager)
+{
+    if (!manager) {
+        return;
+    }
+
+    // 直接在发出信号的线程中路由，入队本身是线程安全的，省去一次跨线程转发
+    connect(manager, &CommunicationManager::dataReceived,
+            this, &DataProcessShardPool::processData, Qt::DirectConnection);
+    connect(manager, &CommunicationManager::connectionRemoved,
+            this, &DataProcessShardPool::releaseConnection, Qt::DirectConnection);
+}
+
+void DataProcessShardPool::detach(CommunicationManager* manager)
+{
+    if (manager) {
+        disconnect(manager, nullptr, this, nullptr);
+    }
+}
+
+DataProcessWorker* DataProcessShardPool::shardFor(const QString& connectionName)
+{
+    {
+        QReadLocker locker(&m_lock);
+        const auto it = m_routes.constFind(connectionName);
+        if (it != m_routes.constEnd()) {
+            return m_shards.at(it.value()).worker;
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    const auto it = m_routes.constFind(connectionName);
+    if (it != m_routes.constEnd()) {
+        return m_shards.at(it.value()).worker;
+    }
+
+    // 优先复用空闲分片，其次新建，达到上限后归入负载最小的分片
+    int index = -1;
+    for (int i = 0; i < m_shards.size(); ++i) {
+        if (m_shards.at(i).connectionCount == 0) {
+            index = i;
+            break;
+        }
+    }
+    bool created = false;
+    if (index < 0 && m_shards.size() < m_config.maxShards) {
+        index = createShardLocked();
+        created = true;
+    }
+    if (index < 0) {
+        index = leastLoadedShardLocked();
+    }
+
+    m_routes.insert(connectionName, index);
+    m_shards[index].connectionCount++;
+    DataProcessWorker* worker = m_shards.at(index).worker;
+    const int cpu = m_shards.at(index).cpu;
+    locker.unlock();
+
+    if (created) {
+        emit shardCreated(index, cpu);
+    }
+    LogManager::getInstance()->debug(QString("连接 %1 分配到数据处理分片 %2").arg(connectionName).arg(index),
+                                     "DataProcessShardPool");
+    return worker;
+}
+
+bool DataProcessShardPool::assignConnection(const QString& connectionName, int shardIndex)
+{
+    QWriteLocker locker(&m_lock);
+
+    // 允许指定下一个新分片的索引，用于显式建组
+    if (shardIndex == m_shards.size() && m_shards.size() < m_config.maxShards) {
+        createShardLocked();
+    }
+    if (shardIndex < 0 || shardIndex >= m_shards.size()) {
+        return false;
+    }
+
+    const auto it = m_routes.find(connectionName);
+    if (it != m_routes.end()) {
+        m_shards[it.value()].connectionCount--;
+        it.value() = shardIndex;
+    } else {
+        m_routes.insert(connectionName, shardIndex);
+    }
+    m_shards[shardIndex].connectionCount++;
+    return true;
+}
+
+void DataProcessShardPool::releaseConnection(const QString& connectionName)
+{
+    QWriteLocker locker(&m_lock);
+    const auto it = m_routes.find(connectionName);
+    if (it == m_routes.end()) {
+        return;
+    }
+    // 分片线程保留，供之后的连接复用
+    m_shards[it.value()].connectionCount--;
+    m_routes.erase(it);
+}
+
+int DataProcessShardPool::shardOf(const QString& connectionName) const
+{
+    QReadLocker locker(&m_lock);
+    return m_routes.value(connectionName, -1);
+}
+
+int DataProcessShardPool::shardCount() const
+{
+    QReadLocker locker(&m_lock);
+    return m_shards.size();
+}
+
+DataProcessWorker* DataProcessShardPool::shardAt(int index) const
+{
+    QReadLocker locker(&m_lock);
+    return (index >= 0 && index < m_shards.size()) ? m_shards.at(index).worker : nullptr;
+}
+
+DataShardRollup DataProcessShardPool::rollup() const
+{
+    DataShardRollup result;
+    double weightedProcessTime = 0.0;
+
+    QReadLocker locker(&m_lock);
+    result.shardCount = m_shards.size();
+    result.connectionCount = m_routes.size();
+
+    for (int i = 0; i < m_shards.size(); ++i) {
+        const Shard& shard = m_shards.at(i);
+        const DataProcessWorker::PerformanceMetrics metrics = shard.worker->getPerformanceMetrics();
+
+        DataShardMetrics item;
+        item.index = i;
+        item.cpu = shard.cpu;
+        item.queueSize = shard.worker->getQueueSize();
+        item.processedTasks = shard.worker->getProcessedTaskCount();
+        item.processedBytes = shard.worker->getProcessedBytes();
+        item.tasksPerSecond = metrics.tasksPerSecond;
+        item.bytesPerSecond = metrics.bytesPerSecond;
+        item.averageProcessTime = shard.worker->getAverageProcessTime();
+        result.shards.append(item);
+
+        result.totalQueueSize += item.queueSize;
+        result.processedTasks += item.processedTasks;
+        result.processedBytes += item.processedBytes;
+        result.tasksPerSecond += item.tasksPerSecond;
+        result.bytesPerSecond += item.bytesPerSecond;
+        weightedProcessTime += item.averageProcessTime * item.processedTasks;
+        if (item.queueSize > result.maxQueueSize || result.busiestShard < 0) {
+            result.maxQueueSize = item.queueSize;
+            result.busiestShard = i;
+        }
+    }
+
+    for (auto it = m_routes.constBegin(); it != m_routes.constEnd(); ++it) {
+        result.shards[it.value()].connections.append(it.key());
+    }
+
+    if (result.processedTasks > 0) {
+        result.averageProcessTime = weightedProcessTime / result.processedTasks;
+    }
+    return result;
+}
+
+void DataProcessShardPool::processData(const QString& connectionName, const QByteArray& data)
+{
+    // 按连接名区分来源，同一分片上的多个连接各用各的解析器
+    shardFor(connectionName)->processSourceData(connectionName, data);
+}
+
+void DataProcessShardPool::processFrames(const QString& connectionName, const FrameBatch& frames)
+{
+    shardFor(connectionName)->processFrames(frames);
+}
+
+void DataProcessShardPool::onRollupTimer()
+{
+    emit rollupUpdated(rollup());
+}
+
+int DataProcessShardPool::createShardLocked()
+{
+    Shard shard;
+    shard.worker = new DataProcessWorker();
+    shard.worker->setMaxQueueSize(m_config.maxQueueSize);
+    shard.worker->setBatchSize(m_config.batchSize);
+    if (m_config.eventDriven) {
+        shard.worker->setEventDriven(true, qMax(m_config.maxQueueSize, Communication::DATA_WORKER_QUEUE_CAPACITY));
+    }
+    if (m_config.configSnapshots) {
+        shard.worker->attachConfigSnapshots(m_config.configSnapshots);
+    }
+    if (m_config.pinToCpu) {
+        shard.cpu = nextCpuLocked();
+        shard.worker->setCpuAffinity(shard.cpu);
+    }
+    // moveToThread 只能由对象当前所在线程调用：运行中直接移入分片线程，
+    // 否则先交给分片池所在线程，由 start() 统一启动
+    if (m_running) {
+        shard.worker->startProcessing();
+    } else {
+        shard.worker->moveToThread(thread());
+    }
+
+    m_shards.append(shard);
+    return m_shards.size() - 1;
+}
+
+int DataProcessShardPool::leastLoadedShardLocked() const
+{
+    int best = 0;
+    int bestConnections = INT_MAX;
+    int bestQueue = INT_MAX;
+    for (int i = 0; i < m_shards.size(); ++i) {
+        const int connections = m_shards.at(i).connectionCount;
+        const int queue = m_shards.at(i).worker->getQueueSize();
+        if (connections < bestConnections || (connections == bestConnections && queue < bestQueue)) {
+            best = i;
+            bestConnections = connections;
+            bestQueue = queue;
+        }
+    }
+    return best;
+}
+
+int DataProcessShardPool::nextCpuLocked()
+{
+    if (!m_config.cpuSet.isEmpty()) {
+        return m_config.cpuSet.at(m_nextCpu++ % m_config.cpuSet.size());
+    }
+    return m_nextCpu++ % qMax(1, QThread::idealThreadCount());
+}
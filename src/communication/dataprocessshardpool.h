@@ -0,0 +1,131 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QTimer>
+#include <QMetaType>
+#include "constants.h"
+#include "dataprocessworker.h"
+
+class CommunicationManager;
+
+// 分片配置
+struct DataShardConfig {
+    int maxShards;              // 分片数上限；连接数超出后按最小负载分组共享
+    bool pinToCpu;              // 把每个分片线程绑定到一个CPU
+    QList<int> cpuSet;          // 可用于绑定的CPU（为空时使用全部逻辑CPU，轮流分配）
+    int maxQueueSize;           // 每个分片的队列上限
+    int batchSize;              // 每个分片单次处理的任务数
+    bool eventDriven;           // 分片使用事件驱动的无锁队列（见 DataProcessWorker::setEventDriven）
+    ConfigSnapshotPublisher* configSnapshots;   // 分片接入的参数快照（见 DataProcessWorker::attachConfigSnapshots），可为空
+
+    DataShardConfig()
+        : maxShards(Communication::DATA_SHARD_MAX_COUNT)
+        , pinToCpu(false)
+        , maxQueueSize(1000)
+        , batchSize(10)
+        , eventDriven(false)
+        , configSnapshots(nullptr)
+    {}
+};
+
+// 单个分片的指标快照
+struct DataShardMetrics {
+    int index = -1;
+    int cpu = -1;                       // 绑定的CPU，-1 表示未绑定
+    QStringList connections;            // 分配到该分片的连接
+    int queueSize = 0;
+    qint64 processedTasks = 0;
+    qint64 processedBytes = 0;
+    qint64 tasksPerSecond = 0;
+    qint64 bytesPerSecond = 0;
+    double averageProcessTime = 0.0;    // 每任务平均耗时(ms)
+};
+
+// 全部分片的汇总
+struct DataShardRollup {
+    int shardCount = 0;
+    int connectionCount = 0;
+    int totalQueueSize = 0;
+    int maxQueueSize = 0;               // 队列最深的分片的队列长度
+    int busiestShard = -1;              // 队列最深的分片
+    qint64 processedTasks = 0;
+    qint64 processedBytes = 0;
+    qint64 tasksPerSecond = 0;
+    qint64 bytesPerSecond = 0;
+    double averageProcessTime = 0.0;    // 按任务数加权
+    QList<DataShardMetrics> shards;
+};
+Q_DECLARE_METATYPE(DataShardRollup)
+
+// 数据处理分片池 - 每个连接（或连接组）一个 DataProcessWorker，各自拥有
+// 独立的任务队列、解析器和线程，某台设备数据泛滥时只会堵塞它自己的分片。
+// 连接首次投递数据时分配分片：分片数未达上限时新建，否则归入负载最小的分片，
+// 也可用 assignConnection() 显式分组。路由表读多写少，投递接口可在任意线程调用。
+class DataProcessShardPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataProcessShardPool(QObject* parent = nullptr);
+    ~DataProcessShardPool();
+
+    // 配置在启动前设置；分片上限和CPU绑定只影响之后创建的分片
+    void setConfig(const DataShardConfig& config);
+    DataShardConfig config() const;
+    // 运行中也可调整，立即作用于已有分片
+    void setBatchSize(int batchSize);
+    void applyWorkloadProfile(const WorkloadProfile& profile);
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // 接入通讯管理器：接收数据按连接名路由，连接移除时释放其分片分配
+    void attach(CommunicationManager* manager);
+    void detach(CommunicationManager* manager);
+
+    // 连接与分片
+    DataProcessWorker* shardFor(const QString& connectionName);
+    bool assignConnection(const QString& connectionName, int shardIndex);
+    void releaseConnection(const QString& connectionName);
+    int shardOf(const QString& connectionName) const;
+    int shardCount() const;
+    DataProcessWorker* shardAt(int index) const;
+
+    // 汇总所有分片的 PerformanceMetrics
+    DataShardRollup rollup() const;
+
+signals:
+    void shardCreated(int index, int cpu);
+    void rollupUpdated(const DataShardRollup& rollup);
+
+public slots:
+    void processData(const QString& connectionName, const QByteArray& data);
+    void processFrames(const QString& connectionName, const FrameBatch& frames);
+
+private slots:
+    void onRollupTimer();
+
+private:
+    struct Shard {
+        DataProcessWorker* worker = nullptr;
+        int cpu = -1;
+        int connectionCount = 0;
+    };
+
+    int createShardLocked();
+    int leastLoadedShardLocked() const;
+    int nextCpuLocked();
+
+    mutable QReadWriteLock m_lock;
+    DataShardConfig m_config;
+    QList<Shard> m_shards;
+    QHash<QString, int> m_routes;       // 连接名 -> 分片索引
+    int m_nextCpu;
+    bool m_running;
+
+    QTimer* m_rollupTimer;
+};
@@ -1,23 +1,63 @@
 #include "dataprocessworker.h"
 #include "logger/logmanager.h"
+#include "utils/fastlane.h"
+#include "utils/tracer.h"
+#include "utils/allocationtracker.h"
+#include "utils/framelatency.h"
+#include "utils/metricsregistry.h"
+#include "utils/workloadprofile.h"
+#include "utils/threadpolicy.h"
 #include <QElapsedTimer>
 #include <QCoreApplication>
 #include <QDebug>
+#include <atomic>
+
+#if defined(Q_PROCESSOR_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+// 事件驱动模式下消费者的状态（m_consumerParked）
+constexpr int CONSUMER_RUNNING = 0;     // 正在处理或忙等
+constexpr int CONSUMER_PARKED = 1;      // 在事件循环中休眠，生产者需投递唤醒
+constexpr int CONSUMER_SUSPENDED = 2;   // 未启动或已暂停，生产者不唤醒
+
+inline void cpuRelax()
+{
+#if defined(Q_PROCESSOR_X86)
+    _mm_pause();
+#elif defined(Q_PROCESSOR_ARM) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+    __asm__ __volatile__("yield");
+#endif
+}
+}
 
 DataProcessWorker::DataProcessWorker(QObject* parent)
     : QObject(parent)
     , m_workerThread(nullptr)
     , m_running(0)
     , m_paused(0)
+    , m_eventDriven(false)
+    , m_consumerParked(CONSUMER_SUSPENDED)
+    , m_priorityTaskCount(0)
+    , m_droppedTaskCount(0)
+    , m_fastLane(new BoundedMpscQueue<FastLaneTask>(Communication::FAST_LANE_QUEUE_CAPACITY))
+    , m_fastLanePosted(0)
     , m_processedTaskCount(0)
+    , m_processedBytes(0)
+    , m_lastPerformanceTaskCount(0)
+    , m_lastPerformanceBytes(0)
     , m_totalProcessTime(0)
     , m_averageProcessTime(0.0)
     , m_maxQueueSize(1000)
     , m_workerThreadCount(2)
     , m_batchSize(10)
+    , m_cpuAffinity(-1)
+    , m_configBatchSize(-1)
     , m_processingTimer(nullptr)
     , m_performanceTimer(nullptr)
     , m_protocolParser(nullptr)
+    , m_batchArena(Communication::DATA_WORKER_ARENA_SIZE)
 {
     // 初始化性能指标
     m_metrics.tasksPerSecond = 0;
@@ -27,6 +67,15 @@ DataProcessWorker::DataProcessWorker(QObject* parent)
     m_metrics.lastUpdate = QDateTime::currentDateTime();
     m_lastPerformanceUpdate = QDateTime::currentDateTime();
     
+    static std::atomic<int> s_workerSequence{0};
+    m_metricLabels = MetricsRegistry::label("worker", QString::number(s_workerSequence.fetch_add(1)));
+    m_queueDepthMetric = MetricsRegistry::gauge("glue_data_worker_queue_depth", "数据处理队列中等待的任务数",
+                                                m_metricLabels);
+    m_processedMetric = MetricsRegistry::counter("glue_data_worker_processed_tasks_total", "已处理的任务数",
+                                                 m_metricLabels);
+    m_droppedMetric = MetricsRegistry::counter("glue_data_worker_dropped_tasks_total", "队列满时丢弃的任务数",
+                                               m_metricLabels);
+    
     // 创建协议解析器
     m_protocolParser = new ProtocolParser(this);
     
@@ -48,6 +97,13 @@ DataProcessWorker::DataProcessWorker(QObject* parent)
 DataProcessWorker::~DataProcessWorker()
 {
     stopProcessing();
+    MetricsRegistry::retire(m_metricLabels);
+    
+    // 任务池中的任务引用本对象，先等它们执行完
+    {
+        QMutexLocker locker(&m_taskPoolMutex);
+        m_taskPool.reset();
+    }
     
     if (m_workerThread) {
         m_workerThread->quit();
@@ -74,9 +130,8 @@ void DataProcessWorker::startProcessing()
         m_workerThread->start();
     }
     
-    // 启动定时器
-    m_processingTimer->start();
-    m_performanceTimer->start();
+    // 定时器属于工作线程，CPU绑定也必须在该线程内设置
+    QMetaObject::invokeMethod(this, [this]() { startTimersInWorkerThread(); }, Qt::QueuedConnection);
     
     LogManager::getInstance()->info("数据处理工作线程已启动", "DataProcessWorker");
 }
@@ -89,10 +144,14 @@ void DataProcessWorker::stopProcessing()
     
     m_running.storeRelease(0);
     m_paused.storeRelease(0);
+    m_consumerParked.testAndSetOrdered(CONSUMER_PARKED, CONSUMER_SUSPENDED);
     
-    // 停止定时器
-    m_processingTimer->stop();
-    m_performanceTimer->stop();
+    // 停止定时器：工作线程仍在运行时由其自身停止
+    if (m_workerThread && m_workerThread->isRunning() && QThread::currentThread() != m_workerThread) {
+        QMetaObject::invokeMethod(this, [this]() { stopTimersInWorkerThread(); }, Qt::BlockingQueuedConnection);
+    } else if (!m_workerThread || QThread::currentThread() == m_workerThread) {
+        stopTimersInWorkerThread();
+    }
     
     // 唤醒等待的线程
     m_taskCondition.wakeAll();
@@ -100,6 +159,51 @@ void DataProcessWorker::stopProcessing()
     LogManager::getInstance()->info("数据处理工作线程已停止", "DataProcessWorker");
 }
 
+void DataProcessWorker::startTimersInWorkerThread()
+{
+    if (!m_running.loadAcquire()) {
+        return;
+    }
+    
+    // 调度策略先应用，分片池指定的 CPU 覆盖策略中的亲和性
+    ThreadPolicy::getInstance()->applyToCurrentThread(ThreadRole::DataProcess);
+    if (m_cpuAffinity >= 0) {
+        if (pinCurrentThreadToCpu(m_cpuAffinity)) {
+            LogManager::getInstance()->info(QString("数据处理线程已绑定到CPU %1").arg(m_cpuAffinity), "DataProcessWorker");
+        } else {
+            LogManager::getInstance()->warning(QString("无法将数据处理线程绑定到CPU %1").arg(m_cpuAffinity), "DataProcessWorker");
+        }
+    }
+    
+    m_performanceTimer->start();
+    
+    if (!m_taskPool && m_workerThreadCount > 0) {
+        resetTaskPool();
+    }
+    
+    if (m_eventDriven) {
+        // 不启动处理定时器，立即处理启动前积压的任务
+        m_consumerParked.storeRelease(CONSUMER_RUNNING);
+        drainTasks();
+    } else {
+        m_processingTimer->start();
+    }
+}
+
+void DataProcessWorker::stopTimersInWorkerThread()
+{
+    m_processingTimer->stop();
+    m_performanceTimer->stop();
+}
+
+bool DataProcessWorker::pinCurrentThreadToCpu(int cpu)
+{
+    if (cpu < 0 || cpu >= 64) {
+        return false;
+    }
+    return ThreadPolicy::setCurrentThreadAffinity(quint64(1) << cpu);
+}
+
 void DataProcessWorker::pauseProcessing()
 {
     if (!m_running.loadAcquire()) {
@@ -118,18 +222,49 @@ void DataProcessWorker::resumeProcessing()
     
     m_paused.storeRelease(0);
     m_taskCondition.wakeAll();
+    if (m_eventDriven) {
+        m_consumerParked.storeRelease(CONSUMER_RUNNING);
+        QMetaObject::invokeMethod(this, &DataProcessWorker::drainTasks, Qt::QueuedConnection);
+    }
     LogManager::getInstance()->info("数据处理工作线程已恢复", "DataProcessWorker");
 }
 
 void DataProcessWorker::addTask(const DataProcessTask& task)
 {
+    if (m_eventDriven) {
+        if (task.priority <= 0) {
+            if (pushLockFree(task)) {
+                wakeConsumer();
+            }
+            return;
+        }
+        {
+            QMutexLocker locker(&m_taskMutex);
+            enqueueTaskLocked(task);
+            m_priorityTaskCount.storeRelease(m_taskQueue.size());
+        }
+        wakeConsumer();
+        return;
+    }
+    
     QMutexLocker locker(&m_taskMutex);
+    enqueueTaskLocked(task);
+    
+    // 唤醒处理线程
+    m_taskCondition.wakeOne();
     
+    // 检查队列状态
+    bool overloaded = m_taskQueue.size() > m_maxQueueSize * 0.8;
+    emit queueStatusChanged(m_taskQueue.size(), overloaded);
+}
+
+void DataProcessWorker::enqueueTaskLocked(const DataProcessTask& task)
+{
     // 检查队列是否已满
     if (m_taskQueue.size() >= m_maxQueueSize) {
         // 移除最旧的任务
         m_taskQueue.dequeue();
-        LogManager::getInstance()->warning("任务队列已满，移除最旧任务", "DataProcessWorker");
+        LOG_WARNING("DataProcessWorker", "任务队列已满，移除最旧任务");
     }
     
     // 按优先级插入任务
@@ -145,33 +280,232 @@ void DataProcessWorker::addTask(const DataProcessTask& task)
     if (!inserted) {
         m_taskQueue.enqueue(task);
     }
+}
+
+bool DataProcessWorker::pushLockFree(const DataProcessTask& task)
+{
+    if (m_lockFreeQueue->tryPush(task)) {
+        return true;
+    }
     
-    // 唤醒处理线程
-    m_taskCondition.wakeOne();
+    // 生产者不能移除最旧任务，队列满时丢弃新任务
+    const qint64 dropped = m_droppedTaskCount.fetchAndAddRelaxed(1) + 1;
+    if (dropped == 1 || dropped % 1000 == 0) {
+        LOG_WARNING("DataProcessWorker", QString("无锁任务队列已满，累计丢弃 %1 个任务").arg(dropped));
+    }
+    emit queueStatusChanged(m_lockFreeQueue->sizeApprox(), true);
+    return false;
+}
+
+void DataProcessWorker::wakeConsumer()
+{
+    // 与消费者"公布休眠后复查队列"配对：入队对消费者可见后才检查休眠标志
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumerParked.loadRelaxed() == CONSUMER_PARKED
+        && m_consumerParked.testAndSetOrdered(CONSUMER_PARKED, CONSUMER_RUNNING)) {
+        QMetaObject::invokeMethod(this, &DataProcessWorker::drainTasks, Qt::QueuedConnection);
+    }
+}
+
+bool DataProcessWorker::hasPendingTasks() const
+{
+    return m_priorityTaskCount.loadAcquire() > 0 || !m_lockFreeQueue->isEmptyApprox();
+}
+
+void DataProcessWorker::drainTasks()
+{
+    if (!m_running.loadAcquire() || m_paused.loadAcquire()) {
+        // resumeProcessing()/startProcessing() 会重新唤醒
+        m_consumerParked.storeRelease(CONSUMER_SUSPENDED);
+        return;
+    }
     
-    // 检查队列状态
-    bool overloaded = m_taskQueue.size() > m_maxQueueSize * 0.8;
-    emit queueStatusChanged(m_taskQueue.size(), overloaded);
+    QElapsedTimer slice;
+    slice.start();
+    int idleRounds = 0;
+    
+    for (;;) {
+        if (drainBatch() > 0) {
+            idleRounds = 0;
+            if (slice.nsecsElapsed() > Communication::DATA_WORKER_SLICE_US * 1000LL) {
+                // 让事件循环处理定时器和排队调用后再继续，期间保持运行状态
+                QMetaObject::invokeMethod(this, &DataProcessWorker::drainTasks, Qt::QueuedConnection);
+                return;
+            }
+            continue;
+        }
+        
+        if (!m_running.loadAcquire() || m_paused.loadAcquire()) {
+            m_consumerParked.storeRelease(CONSUMER_SUSPENDED);
+            return;
+        }
+        
+        // 先忙等，再让出CPU，突发流量的下一批通常在这期间到达
+        if (idleRounds < Communication::DATA_WORKER_SPIN_COUNT) {
+            ++idleRounds;
+            cpuRelax();
+            continue;
+        }
+        if (idleRounds < Communication::DATA_WORKER_SPIN_COUNT + Communication::DATA_WORKER_YIELD_COUNT) {
+            ++idleRounds;
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        
+        // 休眠：先公布状态再复查队列，避免与生产者交错时丢失唤醒
+        m_consumerParked.storeRelease(CONSUMER_PARKED);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!hasPendingTasks()) {
+            return;     // 回到事件循环，由生产者投递的 drainTasks 唤醒
+        }
+        if (!m_consumerParked.testAndSetOrdered(CONSUMER_PARKED, CONSUMER_RUNNING)) {
+            return;     // 生产者已投递唤醒
+        }
+        idleRounds = 0;
+    }
+}
+
+int DataProcessWorker::drainBatch()
+{
+    refreshConfigSnapshot();
+    const int limit = qMax(1, m_batchSize.loadRelaxed());
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 本批任务先取到批内存区上的数组：优先级队列整批只加一次锁，批结束时数组随内存区一起回收
+    ArenaScope batchScope(m_batchArena);
+    std::pmr::vector<DataProcessTask> batch(&m_batchArena);
+    batch.reserve(limit);
+    
+    // 快速通道先于一切，之后每处理一个普通任务检查一次
+    pollFastLane();
+    
+    // 高优先级任务先于无锁队列中的普通任务
+    if (m_priorityTaskCount.loadAcquire() > 0) {
+        QMutexLocker locker(&m_taskMutex);
+        while (!m_taskQueue.isEmpty() && batch.size() < static_cast<size_t>(limit)) {
+            batch.push_back(m_taskQueue.dequeue());
+        }
+        m_priorityTaskCount.storeRelease(m_taskQueue.size());
+    }
+    
+    DataProcessTask task;
+    while (batch.size() < static_cast<size_t>(limit) && m_lockFreeQueue->tryPop(task)) {
+        batch.push_back(std::move(task));
+    }
+    
+    runBatch(batch, timer);
+    return static_cast<int>(batch.size());     // 含交给任务池的任务，用于限制单批数量
+}
+
+void DataProcessWorker::runBatch(const std::pmr::vector<DataProcessTask>& batch, const QElapsedTimer& timer)
+{
+    int processedCount = 0;
+    qint64 processedBytes = 0;
+    
+    for (const DataProcessTask& task : batch) {
+        // 处理任务（重型任务交给任务池），每个任务之前先处理快速通道
+        pollFastLane();
+        if (runOrDispatch(task)) {
+            processedCount++;
+            processedBytes += task.data.size();
+        }
+    }
+    
+    if (processedCount > 0) {
+        QMutexLocker locker(&m_taskMutex);
+        accountProcessedLocked(processedCount, processedBytes, timer.elapsed());
+    }
 }
 
 void DataProcessWorker::addHighPriorityTask(const DataProcessTask& task)
 {
-    DataProcessTask highPriorityTask = task;
-    highPriorityTask.priority = 1000; // 高优先级
-    addTask(highPriorityTask);
+    FastLaneTask entry;
+    entry.task = task;
+    entry.task.priority = 1000; // 高优先级
+    entry.enqueuedNs = ProtocolFrame::currentTimestampNs();
+    
+    if (!m_fastLane->tryPush(std::move(entry))) {
+        // 快速队列满说明处理线程已长时间没有响应，退回优先级队列而不丢弃
+        LOG_WARNING("DataProcessWorker", "快速通道队列已满，任务转入优先级队列");
+        DataProcessTask highPriorityTask = task;
+        highPriorityTask.priority = 1000;
+        addTask(highPriorityTask);
+        return;
+    }
+    postFastLaneDrain();
+}
+
+void DataProcessWorker::postFastLaneDrain()
+{
+    // 与 drainFastLane() 的"清除标志后出队"配对：入队对消费者可见后才检查标志
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_fastLanePosted.loadRelaxed() == 0 && m_fastLanePosted.testAndSetOrdered(0, 1)) {
+        FastLaneCallEvent::post(this, [this]() { drainFastLane(); });
+    }
+}
+
+void DataProcessWorker::drainFastLane()
+{
+    m_fastLanePosted.storeRelease(0);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    int processedCount = 0;
+    qint64 processedBytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 安全任务在处理线程上直接执行，不交给任务池，也不受暂停和批大小限制
+    FastLaneTask entry;
+    while (m_fastLane->tryPop(entry)) {
+        processTask(entry.task);
+        FastLaneMonitor::getInstance()->record(FastLaneStage::WorkerDispatch,
+                                               ProtocolFrame::currentTimestampNs() - entry.enqueuedNs);
+        processedCount++;
+        processedBytes += entry.task.data.size();
+    }
+    
+    if (processedCount > 0) {
+        QMutexLocker locker(&m_taskMutex);
+        accountProcessedLocked(processedCount, processedBytes, timer.elapsed());
+    }
+}
+
+bool DataProcessWorker::event(QEvent* event)
+{
+    if (FastLaneCallEvent::dispatch(event)) {
+        return true;
+    }
+    return QObject::event(event);
 }
 
 void DataProcessWorker::clearTasks()
 {
     QMutexLocker locker(&m_taskMutex);
     m_taskQueue.clear();
+    m_priorityTaskCount.storeRelease(0);
+    locker.unlock();
+    
+    // 无锁队列只能由消费者线程出队
+    if (m_lockFreeQueue) {
+        auto drop = [this]() {
+            DataProcessTask task;
+            while (m_lockFreeQueue->tryPop(task)) {
+            }
+        };
+        if (QThread::currentThread() == thread()) {
+            drop();
+        } else {
+            QMetaObject::invokeMethod(this, drop, Qt::QueuedConnection);
+        }
+    }
     LogManager::getInstance()->info("任务队列已清空", "DataProcessWorker");
 }
 
 int DataProcessWorker::getQueueSize() const
 {
     QMutexLocker locker(&m_taskMutex);
-    return m_taskQueue.size();
+    return m_taskQueue.size() + (m_lockFreeQueue ? m_lockFreeQueue->sizeApprox() : 0);
 }
 
 qint64 DataProcessWorker::getProcessedTaskCount() const
@@ -189,36 +523,176 @@ bool DataProcessWorker::isProcessing() const
     return m_running.loadAcquire() && !m_paused.loadAcquire();
 }
 
+DataProcessWorker::PerformanceMetrics DataProcessWorker::getPerformanceMetrics() const
+{
+    QMutexLocker locker(&m_taskMutex);
+    return m_metrics;
+}
+
+qint64 DataProcessWorker::getProcessedBytes() const
+{
+    QMutexLocker locker(&m_taskMutex);
+    return m_processedBytes;
+}
+
 void DataProcessWorker::setMaxQueueSize(int maxSize)
 {
-    m_maxQueueSize = maxSize;
+    QMutexLocker locker(&m_taskMutex);
+    m_maxQueueSize = qMax(1, maxSize);
 }
 
 void DataProcessWorker::setWorkerThreadCount(int threadCount)
 {
     m_workerThreadCount = threadCount;
+    if (m_running.loadAcquire()) {
+        resetTaskPool();
+    }
+}
+
+void DataProcessWorker::resetTaskPool()
+{
+    // 替换任务池只在处理线程中进行，旧池析构时会先执行完已提交的任务
+    if (m_workerThread && m_workerThread->isRunning() && QThread::currentThread() != m_workerThread) {
+        QMetaObject::invokeMethod(this, [this]() { resetTaskPool(); }, Qt::BlockingQueuedConnection);
+        return;
+    }
+    
+    std::unique_ptr<WorkStealingPool> pool;
+    if (m_workerThreadCount > 0) {
+        pool = std::make_unique<WorkStealingPool>(m_workerThreadCount, "DataProcessPool");
+    }
+    
+    QMutexLocker locker(&m_taskPoolMutex);
+    m_taskPool.swap(pool);
+    locker.unlock();
+    pool.reset();
 }
 
 void DataProcessWorker::setBatchSize(int batchSize)
 {
-    m_batchSize = batchSize;
+    m_batchSize.storeRelaxed(batchSize);
+}
+
+void DataProcessWorker::applyWorkloadProfile(const WorkloadProfile& profile)
+{
+    setBatchSize(profile.dataBatchSize);
+    setMaxQueueSize(profile.dataMaxQueueSize);
+}
+
+void DataProcessWorker::attachConfigSnapshots(ConfigSnapshotPublisher* publisher)
+{
+    m_configReader.attach(publisher);
+    m_configBatchSize = -1;
+}
+
+// 批与批之间是应用新配置的安全点；只应用变化了的参数，调参实验等其他途径的设置不会被覆盖
+void DataProcessWorker::refreshConfigSnapshot()
+{
+    if (!m_configReader.refresh()) {
+        return;
+    }
+    const int batchSize = m_configReader->intValue(System::CONFIG_DATA_BATCH_SIZE, -1);
+    if (batchSize > 0 && batchSize != m_configBatchSize) {
+        m_configBatchSize = batchSize;
+        m_batchSize.storeRelaxed(batchSize);
+    }
+}
+
+void DataProcessWorker::setCpuAffinity(int cpu)
+{
+    m_cpuAffinity = cpu;
+}
+
+void DataProcessWorker::setEventDriven(bool enabled, int queueCapacity)
+{
+    if (m_running.loadAcquire()) {
+        LogManager::getInstance()->warning("处理线程运行中，无法切换事件驱动模式", "DataProcessWorker");
+        return;
+    }
+    
+    m_eventDriven = enabled;
+    m_lockFreeQueue.reset(enabled ? new BoundedMpscQueue<DataProcessTask>(queueCapacity) : nullptr);
 }
 
 void DataProcessWorker::processData(const QByteArray& data)
 {
     DataProcessTask task(DataProcessType::ParseFrame, data);
+    task.receivedNs = ProtocolFrame::currentTimestampNs();
+    addTask(task);
+}
+
+void DataProcessWorker::processSourceData(const QString& source, const QByteArray& data)
+{
+    DataProcessTask task(DataProcessType::ParseFrame, data);
+    task.source = source;
+    task.receivedNs = ProtocolFrame::currentTimestampNs();
     addTask(task);
 }
 
 void DataProcessWorker::processFrame(const ProtocolFrame& frame)
 {
-    DataProcessTask task(DataProcessType::ProcessSensorData);
+    DataProcessTask task = sensorDataTask(frame);
+    if (ProtocolParser::isSafetyCommand(frame.command)) {
+        addHighPriorityTask(task);
+    } else {
+        addTask(task);
+    }
+}
+
+void DataProcessWorker::processFrames(const FrameBatch& frames)
+{
+    if (frames.isEmpty()) return;
+    
+    // 安全指令帧先于同批普通帧进入快速通道
+    int safetyFrames = 0;
+    for (const ProtocolFrame& frame : frames) {
+        if (ProtocolParser::isSafetyCommand(frame.command)) {
+            addHighPriorityTask(sensorDataTask(frame));
+            safetyFrames++;
+        }
+    }
+    if (safetyFrames == frames.size()) return;
+    
+    if (m_eventDriven) {
+        bool pushed = false;
+        for (const ProtocolFrame& frame : frames) {
+            if (ProtocolParser::isSafetyCommand(frame.command)) continue;
+            pushed |= pushLockFree(sensorDataTask(frame));
+        }
+        if (pushed) {
+            wakeConsumer();
+        }
+        return;
+    }
+    
+    // 整批入队：只加锁、唤醒和上报队列状态各一次
+    QMutexLocker locker(&m_taskMutex);
+    for (const ProtocolFrame& frame : frames) {
+        if (ProtocolParser::isSafetyCommand(frame.command)) continue;
+        enqueueTaskLocked(sensorDataTask(frame));
+    }
+    
+    m_taskCondition.wakeAll();
+    
+    bool overloaded = m_taskQueue.size() > m_maxQueueSize * 0.8;
+    emit queueStatusChanged(m_taskQueue.size(), overloaded);
+}
+
+QByteArray DataProcessWorker::serializeFrame(const ProtocolFrame& frame)
+{
     QByteArray frameData;
     QDataStream stream(&frameData, QIODevice::WriteOnly);
     stream << frame.header << static_cast<quint8>(frame.command) 
-           << frame.dataLength << frame.data << frame.checksum << frame.tail;
-    task.data = frameData;
-    addTask(task);
+           << frame.dataLength << frame.payload() << frame.checksum << frame.tail;
+    return frameData;
+}
+
+DataProcessTask DataProcessWorker::sensorDataTask(const ProtocolFrame& frame)
+{
+    DataProcessTask task(DataProcessType::ProcessSensorData, serializeFrame(frame));
+    task.receivedNs = frame.receivedNs;
+    task.parsedNs = frame.timestampNs;
+    return task;
 }
 
 void DataProcessWorker::processStatistics()
@@ -243,8 +717,18 @@ void DataProcessWorker::onPerformanceTimer()
     qint64 elapsedMs = m_lastPerformanceUpdate.msecsTo(now);
     
     if (elapsedMs > 0) {
-        m_metrics.tasksPerSecond = (m_processedTaskCount * 1000) / elapsedMs;
-        m_metrics.lastUpdate = now;
+        {
+            // 按本周期的增量计算速率
+            QMutexLocker locker(&m_taskMutex);
+            m_metrics.tasksPerSecond = ((m_processedTaskCount - m_lastPerformanceTaskCount) * 1000) / elapsedMs;
+            m_metrics.bytesPerSecond = ((m_processedBytes - m_lastPerformanceBytes) * 1000) / elapsedMs;
+            m_metrics.lastUpdate = now;
+            m_lastPerformanceTaskCount = m_processedTaskCount;
+            m_lastPerformanceBytes = m_processedBytes;
+            m_processedMetric->set(m_processedTaskCount);
+        }
+        m_queueDepthMetric->set(getQueueSize());
+        m_droppedMetric->set(m_droppedTaskCount.loadRelaxed());
         
         emit performanceUpdated(m_processedTaskCount, m_averageProcessTime);
         
@@ -255,35 +739,71 @@ void DataProcessWorker::onPerformanceTimer()
 
 void DataProcessWorker::processTasks()
 {
-    QMutexLocker locker(&m_taskMutex);
-    
-    int processedCount = 0;
+    refreshConfigSnapshot();
     QElapsedTimer timer;
     timer.start();
     
-    // 批量处理任务
-    while (!m_taskQueue.isEmpty() && processedCount < m_batchSize) {
-        DataProcessTask task = m_taskQueue.dequeue();
-        locker.unlock();
-        
-        // 处理任务
-        processTask(task);
-        processedCount++;
-        
-        locker.relock();
+    ArenaScope batchScope(m_batchArena);
+    std::pmr::vector<DataProcessTask> batch(&m_batchArena);
+    const int batchSize = qMax(1, m_batchSize.loadRelaxed());
+    batch.reserve(batchSize);
+    
+    // 批量取出任务，处理期间不持有队列锁
+    {
+        QMutexLocker locker(&m_taskMutex);
+        while (!m_taskQueue.isEmpty() && batch.size() < static_cast<size_t>(batchSize)) {
+            batch.push_back(m_taskQueue.dequeue());
+        }
     }
     
-    // 更新性能统计
-    if (processedCount > 0) {
-        qint64 processingTime = timer.elapsed();
-        m_processedTaskCount += processedCount;
-        m_totalProcessTime += processingTime;
-        m_averageProcessTime = static_cast<double>(m_totalProcessTime) / m_processedTaskCount;
+    runBatch(batch, timer);
+}
+
+void DataProcessWorker::accountProcessedLocked(int processedCount, qint64 processedBytes, qint64 elapsedMs)
+{
+    m_processedTaskCount += processedCount;
+    m_processedBytes += processedBytes;
+    m_totalProcessTime += elapsedMs;
+    m_averageProcessTime = static_cast<double>(m_totalProcessTime) / m_processedTaskCount;
+}
+
+bool DataProcessWorker::isHeavyTask(DataProcessType type)
+{
+    return type == DataProcessType::CalculateStatistics
+        || type == DataProcessType::UpdateDatabase
+        || type == DataProcessType::GenerateReport;
+}
+
+bool DataProcessWorker::runOrDispatch(const DataProcessTask& task)
+{
+    // 解析和传感器数据任务始终在处理线程上按入队顺序执行，保证每个连接的帧顺序；
+    // 重型任务之间互不依赖，分散到任务池的多个核上
+    if (!m_taskPool || !isHeavyTask(task.type)) {
+        processTask(task);
+        return true;
     }
+    
+    m_taskPool->submit([this, task]() {
+        QElapsedTimer timer;
+        timer.start();
+        processTask(task);
+        
+        QMutexLocker locker(&m_taskMutex);
+        accountProcessedLocked(1, task.data.size(), timer.elapsed());
+    });
+    return false;
+}
+
+WorkStealingPool::Statistics DataProcessWorker::getTaskPoolStatistics() const
+{
+    QMutexLocker locker(&m_taskPoolMutex);
+    return m_taskPool ? m_taskPool->statistics() : WorkStealingPool::Statistics();
 }
 
 void DataProcessWorker::processTask(const DataProcessTask& task)
 {
+    TRACE_SCOPE("data", "DataProcessWorker::processTask");
+    ALLOCATION_SCOPE("data.processTask");
     try {
         switch (task.type) {
         case DataProcessType::ParseFrame:
@@ -302,12 +822,12 @@ void DataProcessWorker::processTask(const DataProcessTask& task)
             processGenerateReport(task);
             break;
         default:
-            LogManager::getInstance()->warning("未知的任务类型", "DataProcessWorker");
+            LOG_WARNING("DataProcessWorker", "未知的任务类型");
             break;
         }
     } catch (const std::exception& e) {
         QString error = QString("处理任务时发生异常: %1").arg(e.what());
-        LogManager::getInstance()->error(error, "DataProcessWorker");
+        LOG_ERROR("DataProcessWorker", error);
         emit errorOccurred(error);
     }
 }
@@ -315,16 +835,28 @@ void DataProcessWorker::processTask(const DataProcessTask& task)
 void DataProcessWorker::processParseFrame(const DataProcessTask& task)
 {
     // 使用协议解析器解析数据
-    if (m_protocolParser) {
-        m_protocolParser->parseData(task.data);
+    ProtocolParser* parser = task.source.isEmpty() ? m_protocolParser : parserFor(task.source);
+    if (parser) {
+        parser->parseData(task.data, task.receivedNs);
     }
 }
 
+ProtocolParser* DataProcessWorker::parserFor(const QString& source)
+{
+    ProtocolParser*& parser = m_sourceParsers[source];
+    if (!parser) {
+        parser = new ProtocolParser(this);
+        parser->setChecksumType(m_protocolParser->getChecksumType());
+    }
+    return parser;
+}
+
 void DataProcessWorker::processSensorData(const DataProcessTask& task)
 {
     // 处理传感器数据
     // TODO: 实现具体的传感器数据处理逻辑
     emit dataProcessed(task.data);
+    FrameLatencyMonitor::getInstance()->recordSince(FrameLatencyStage::Worker, task.parsedNs);
 }
 
 void DataProcessWorker::processCalculateStats(const DataProcessTask& task)
@@ -337,6 +869,24 @@ void DataProcessWorker::processCalculateStats(const DataProcessTask& task)
     stats["queueSize"] = getQueueSize();
     stats["timestamp"] = QDateTime::currentDateTime();
     
+    // 安全指令快速通道的最坏延迟（全局，含解析、处理和发送阶段）
+    const FastLaneMonitor* fastLane = FastLaneMonitor::getInstance();
+    stats["fastLaneWorstCaseUs"] = fastLane->worstCaseNs() / 1000.0;
+    stats["fastLaneWithinBudget"] = fastLane->withinBudget();
+    
+    const WorkStealingPool::Statistics poolStats = getTaskPoolStatistics();
+    if (!poolStats.threads.isEmpty()) {
+        QVariantList threadUtilization;
+        for (const WorkStealingPool::ThreadStatistics& thread : poolStats.threads) {
+            threadUtilization.append(thread.utilization);
+        }
+        stats["poolThreads"] = poolStats.threads.size();
+        stats["poolExecutedTasks"] = poolStats.executed;
+        stats["poolStolenTasks"] = poolStats.stolen;
+        stats["poolUtilization"] = poolStats.utilization;
+        stats["poolThreadUtilization"] = threadUtilization;
+    }
+    
     emit statisticsUpdated(stats);
 }
 
@@ -359,13 +909,13 @@ void DataProcessWorker::optimizeQueue()
     QMutexLocker locker(&m_taskMutex);
     
     // 移除过期的任务
-    QDateTime now = QDateTime::currentDateTime();
+    const qint64 nowNs = MonotonicClock::nowNs();
     QQueue<DataProcessTask> newQueue;
     
     while (!m_taskQueue.isEmpty()) {
         DataProcessTask task = m_taskQueue.dequeue();
         // 如果任务不超过30秒，保留
-        if (task.timestamp.msecsTo(now) < 30000) {
+        if (nowNs - task.createdNs < qint64(30000) * 1000000) {
             newQueue.enqueue(task);
         }
     }
@@ -7,9 +7,25 @@
 #include <QQueue>
 #include <QTimer>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QAtomicInt>
+#include <QHash>
+#include <QAtomicInteger>
+#include <memory>
+#include <memory_resource>
+#include <vector>
 #include "constants.h"
 #include "protocolparser.h"
+#include "utils/configsnapshot.h"
+#include "utils/monotonicarena.h"
+#include "utils/monotonicclock.h"
+#include "utils/mpscqueue.h"
+#include "utils/workstealingpool.h"
+
+class MetricCounter;
+class MetricGauge;
+
+struct WorkloadProfile;
 
 // 数据处理任务类型
 enum class DataProcessType {
@@ -24,14 +40,17 @@ enum class DataProcessType {
 struct DataProcessTask {
     DataProcessType type;
     QByteArray data;
-    QDateTime timestamp;
+    qint64 createdNs;           // 任务创建时刻（单调时钟），队列整理时据此丢弃过期任务
     int priority;
     QVariant customData;
+    QString source;             // 数据来源（连接名），为空时使用默认解析器
+    qint64 receivedNs = 0;      // 数据的读取时刻（单调时钟），端到端延迟统计用
+    qint64 parsedNs = 0;        // 帧任务：帧校验通过的时刻（ProtocolFrame::timestampNs）
     
     DataProcessTask(DataProcessType t = DataProcessType::ParseFrame, 
                    const QByteArray& d = QByteArray(), 
                    int p = 0)
-        : type(t), data(d), timestamp(QDateTime::currentDateTime()), priority(p)
+        : type(t), data(d), createdNs(MonotonicClock::nowNs()), priority(p)
     {}
 };
 
@@ -44,6 +63,15 @@ public:
     explicit DataProcessWorker(QObject* parent = nullptr);
     ~DataProcessWorker();
     
+    // 性能指标（每个性能周期更新一次）
+    struct PerformanceMetrics {
+        qint64 tasksPerSecond;
+        qint64 bytesPerSecond;
+        double cpuUsage;
+        double memoryUsage;
+        QDateTime lastUpdate;
+    };
+    
     // 线程管理
     void startProcessing();
     void stopProcessing();
@@ -52,6 +80,9 @@ public:
     
     // 任务管理
     void addTask(const DataProcessTask& task);
+    // 快速通道：任务进入独立的无锁队列，以高优先级事件唤醒处理线程，
+    // 处理线程在每个普通任务之间检查该队列；不参与批处理，也不交给任务池。
+    // 暂停期间仍会处理。安全指令帧（ProtocolParser::isSafetyCommand）自动走这里
     void addHighPriorityTask(const DataProcessTask& task);
     void clearTasks();
     
@@ -60,11 +91,39 @@ public:
     qint64 getProcessedTaskCount() const;
     double getAverageProcessTime() const;
     bool isProcessing() const;
+    PerformanceMetrics getPerformanceMetrics() const;
+    qint64 getProcessedBytes() const;
+    qint64 getDroppedTaskCount() const { return m_droppedTaskCount.loadRelaxed(); }
+    // 重型任务池的窃取次数和各线程利用率（未启用任务池时为空）
+    WorkStealingPool::Statistics getTaskPoolStatistics() const;
     
     // 配置
     void setMaxQueueSize(int maxSize);
+    // 重型任务（统计、数据库更新、报告）使用的工作窃取线程数，0 表示在处理线程上执行；
+    // 解析类任务始终留在处理线程上以保持每个连接的帧顺序
     void setWorkerThreadCount(int threadCount);
     void setBatchSize(int batchSize);
+    
+    // 把工作线程绑定到指定CPU（-1 不绑定），在 startProcessing() 之前设置
+    void setCpuAffinity(int cpu);
+    int cpuAffinity() const { return m_cpuAffinity; }
+    
+    // 事件驱动模式（在 startProcessing() 之前设置）：普通任务进入有界无锁队列，
+    // 生产者在消费者休眠时立即唤醒它，不再依赖10ms处理定时器。消费者处理完后先自旋、
+    // 再让出CPU，仍无任务才回到事件循环休眠，空闲时不占CPU。
+    // 高优先级任务仍走加锁的优先级队列并先于普通任务处理；无锁队列满时丢弃新任务并计数
+    void setEventDriven(bool enabled, int queueCapacity = Communication::DATA_WORKER_QUEUE_CAPACITY);
+    bool isEventDriven() const { return m_eventDriven; }
+    
+    // 接入 AdaptiveConfigManager 的参数快照（在 startProcessing() 之前设置），每批任务开始前应用新版本；
+    // 须在发布器析构前停止处理并断开
+    void attachConfigSnapshots(ConfigSnapshotPublisher* publisher);
+    
+    // 应用工作负载配置档中的批大小和队列上限，处理期间可随时调用
+    void applyWorkloadProfile(const WorkloadProfile& profile);
+
+protected:
+    bool event(QEvent* event) override;
 
 signals:
     // 处理完成信号
@@ -79,15 +138,46 @@ signals:
 
 public slots:
     void processData(const QByteArray& data);
+    // 带来源的原始数据：每个来源使用独立的解析器，多个连接共享一个工作线程时字节流互不干扰
+    void processSourceData(const QString& source, const QByteArray& data);
     void processFrame(const ProtocolFrame& frame);
+    void processFrames(const FrameBatch& frames);
     void processStatistics();
 
 private slots:
     void onProcessingTimer();
     void onPerformanceTimer();
+    void drainTasks();
 
 private:
+    // 快速通道任务，enqueuedNs 为入队时的单调时钟时间
+    struct FastLaneTask {
+        DataProcessTask task;
+        qint64 enqueuedNs = 0;
+    };
+    
+    void enqueueTaskLocked(const DataProcessTask& task);
+    void postFastLaneDrain();
+    void drainFastLane();
+    void pollFastLane() { if (!m_fastLane->isEmptyApprox()) drainFastLane(); }
+    bool pushLockFree(const DataProcessTask& task);
+    void wakeConsumer();
+    void refreshConfigSnapshot();
+    bool hasPendingTasks() const;
+    int drainBatch();
+    void runBatch(const std::pmr::vector<DataProcessTask>& batch, const QElapsedTimer& timer);
+    void startTimersInWorkerThread();
+    void stopTimersInWorkerThread();
+    ProtocolParser* parserFor(const QString& source);
+    static bool pinCurrentThreadToCpu(int cpu);
+    static QByteArray serializeFrame(const ProtocolFrame& frame);
+    static DataProcessTask sensorDataTask(const ProtocolFrame& frame);
+    
     void processTasks();
+    static bool isHeavyTask(DataProcessType type);
+    bool runOrDispatch(const DataProcessTask& task);
+    void resetTaskPool();
+    void accountProcessedLocked(int processedCount, qint64 processedBytes, qint64 elapsedMs);
     void processTask(const DataProcessTask& task);
     void processParseFrame(const DataProcessTask& task);
     void processSensorData(const DataProcessTask& task);
@@ -107,8 +197,22 @@ private:
     QAtomicInt m_running;
     QAtomicInt m_paused;
     
+    // 事件驱动模式
+    bool m_eventDriven;
+    std::unique_ptr<BoundedMpscQueue<DataProcessTask>> m_lockFreeQueue;
+    QAtomicInt m_consumerParked;            // 1 表示消费者已休眠，唤醒方负责投递一次 drainTasks
+    QAtomicInt m_priorityTaskCount;         // m_taskQueue 长度的无锁副本，消费者据此跳过加锁
+    QAtomicInteger<qint64> m_droppedTaskCount;
+    
+    // 快速通道
+    std::unique_ptr<BoundedMpscQueue<FastLaneTask>> m_fastLane;
+    QAtomicInt m_fastLanePosted;            // 1 表示已投递唤醒事件、尚未开始处理
+    
     // 性能统计
     qint64 m_processedTaskCount;
+    qint64 m_processedBytes;
+    qint64 m_lastPerformanceTaskCount;
+    qint64 m_lastPerformanceBytes;
     qint64 m_totalProcessTime;
     double m_averageProcessTime;
     QDateTime m_lastPerformanceUpdate;
@@ -116,21 +220,32 @@ private:
     // 配置参数
     int m_maxQueueSize;
     int m_workerThreadCount;
-    int m_batchSize;
+    QAtomicInt m_batchSize;                 // 运行中可由调参实验修改
+    int m_cpuAffinity;
+    ConfigSnapshotReader m_configReader;    // 只在处理线程读取
+    int m_configBatchSize;                  // 上次应用的 System::CONFIG_DATA_BATCH_SIZE，-1 表示未应用
     
     // 定时器
     QTimer* m_processingTimer;
     QTimer* m_performanceTimer;
     
+    // 重型任务池（只在处理线程中替换）
+    std::unique_ptr<WorkStealingPool> m_taskPool;
+    mutable QMutex m_taskPoolMutex;
+    
     // 处理器组件
     ProtocolParser* m_protocolParser;
+    QHash<QString, ProtocolParser*> m_sourceParsers;    // 只在工作线程访问
     
-    // 性能监控
-    struct PerformanceMetrics {
-        qint64 tasksPerSecond;
-        qint64 bytesPerSecond;
-        double cpuUsage;
-        double memoryUsage;
-        QDateTime lastUpdate;
-    } m_metrics;
+    // 批内存区：一批任务处理期间的临时数据，批结束时整体回收（只在处理线程访问）
+    MonotonicArena m_batchArena;
+    
+    // 性能监控（受 m_taskMutex 保护）
+    PerformanceMetrics m_metrics;
+    
+    // 指标端点的序列，标签为 worker="<创建序号>"，由性能定时器更新
+    QString m_metricLabels;
+    MetricGauge* m_queueDepthMetric;
+    MetricCounter* m_processedMetric;
+    MetricCounter* m_droppedMetric;
 }; 
\ No newline at end of file
@@ -0,0 +1,546 @@
+#include "firmwareupgrader.h"
+#include "logger/logmanager.h"
+#include "utils/crcengine.h"
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr int DIGEST_SIZE = 32;     // SHA-256
+
+void appendBigEndian32(QByteArray& bytes, quint32 value)
+{
+    char buffer[4];
+    qToBigEndian(value, buffer);
+    bytes.append(buffer, 4);
+}
+}
+
+FirmwareUpgrader::FirmwareUpgrader(ProtocolParser* parser, FrameSender sender, QObject* parent)
+    : QObject(parent)
+    , m_parser(parser)
+    , m_sender(std::move(sender))
+    , m_image(nullptr)
+    , m_imageSize(0)
+    , m_blockCount(0)
+    , m_imageCrc(0)
+    , m_state(UpgradeState::Idle)
+    , m_confirmed(0)
+    , m_nextToSend(0)
+    , m_recovering(false)
+    , m_windowSize(Protocol::UPGRADE_WINDOW_SIZE)
+    , m_retries(0)
+    , m_retransmitted(0)
+    , m_sessionStartBlock(0)
+{
+    qRegisterMetaType<UpgradeProgress>("UpgradeProgress");
+
+    m_ackTimer = new QTimer(this);
+    m_ackTimer->setSingleShot(true);
+    connect(m_ackTimer, &QTimer::timeout, this, &FirmwareUpgrader::onAckTimeout);
+}
+
+FirmwareUpgrader::~FirmwareUpgrader()
+{
+    m_ackTimer->stop();
+    if (m_image) {
+        m_file.unmap(const_cast<uchar*>(m_image));
+    }
+}
+
+bool FirmwareUpgrader::open(const QString& filePath)
+{
+    if (m_state == UpgradeState::Starting || m_state == UpgradeState::Transferring ||
+        m_state == UpgradeState::Finishing) {
+        LogManager::getInstance()->warning("升级进行中，不能更换固件文件", "FirmwareUpgrader");
+        return false;
+    }
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        LogManager::getInstance()->error(
+            QString("无法打开固件文件: %1 (%2)").arg(filePath, m_file.errorString()), "FirmwareUpgrader");
+        return false;
+    }
+
+    // 镜像长度字段为4字节
+    const qint64 size = m_file.size();
+    if (size <= 0 || size > static_cast<qint64>(std::numeric_limits<quint32>::max())) {
+        LogManager::getInstance()->error(QString("固件文件长度无效: %1").arg(size), "FirmwareUpgrader");
+        m_file.close();
+        return false;
+    }
+
+    // 映射整个文件，发送和重传都直接从映射区取数据，不把镜像读入内存
+    m_image = m_file.map(0, size);
+    if (!m_image) {
+        LogManager::getInstance()->error(
+            QString("固件文件映射失败: %1 (%2)").arg(filePath, m_file.errorString()), "FirmwareUpgrader");
+        m_file.close();
+        return false;
+    }
+
+    m_imageSize = size;
+    m_blockCount = static_cast<quint32>((size + Protocol::UPGRADE_BLOCK_SIZE - 1) / Protocol::UPGRADE_BLOCK_SIZE);
+    m_blockCrcs.resize(static_cast<int>(m_blockCount));
+
+    // 一次遍历：每块的CRC32C在重传时直接复用，镜像CRC32C以增量方式累积
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    uint32_t imageState = 0xFFFFFFFF;
+    for (quint32 i = 0; i < m_blockCount; ++i) {
+        const qint64 offset = static_cast<qint64>(i) * Protocol::UPGRADE_BLOCK_SIZE;
+        const size_t length = static_cast<size_t>(qMin<qint64>(Protocol::UPGRADE_BLOCK_SIZE, size - offset));
+        const uint8_t* block = m_image + offset;
+        m_blockCrcs[static_cast<int>(i)] = CRCEngine::updateCRC32C(0xFFFFFFFF, block, length) ^ 0xFFFFFFFF;
+        imageState = CRCEngine::updateCRC32C(imageState, block, length);
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(block), static_cast<qsizetype>(length)));
+    }
+    m_imageCrc = imageState ^ 0xFFFFFFFF;
+    m_digest = hash.result();
+
+    m_confirmed = 0;
+    m_nextToSend = 0;
+    m_retransmitted = 0;
+    setState(UpgradeState::Ready);
+
+    LogManager::getInstance()->info(
+        QString("固件已映射: %1, %2字节, %3块, CRC32C=%4")
+            .arg(filePath)
+            .arg(m_imageSize)
+            .arg(m_blockCount)
+            .arg(m_imageCrc, 8, 16, QChar('0')),
+        "FirmwareUpgrader");
+    return true;
+}
+
+void FirmwareUpgrader::close()
+{
+    m_ackTimer->stop();
+    if (m_image) {
+        m_file.unmap(const_cast<uchar*>(m_image));
+        m_image = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_imageSize = 0;
+    m_blockCount = 0;
+    m_imageCrc = 0;
+    m_digest.clear();
+    m_blockCrcs.clear();
+    m_confirmed = 0;
+    m_nextToSend = 0;
+    setState(UpgradeState::Idle);
+}
+
+bool FirmwareUpgrader::start()
+{
+    if (!m_image || m_state == UpgradeState::Starting || m_state == UpgradeState::Transferring ||
+        m_state == UpgradeState::Finishing) {
+        return false;
+    }
+
+    m_confirmed = 0;
+    m_nextToSend = 0;
+    m_retransmitted = 0;
+    return beginSession();
+}
+
+bool FirmwareUpgrader::resume()
+{
+    if (!m_image || m_state != UpgradeState::Suspended) {
+        return false;
+    }
+
+    LogManager::getInstance()->info(
+        QString("恢复固件升级，本地已确认 %1/%2 块").arg(m_confirmed).arg(m_blockCount), "FirmwareUpgrader");
+    return beginSession();
+}
+
+void FirmwareUpgrader::suspend()
+{
+    if (m_state == UpgradeState::Starting || m_state == UpgradeState::Transferring ||
+        m_state == UpgradeState::Finishing) {
+        suspendWithReason("链路断开");
+    }
+}
+
+void FirmwareUpgrader::abort()
+{
+    if (m_state == UpgradeState::Idle || m_state == UpgradeState::Ready ||
+        m_state == UpgradeState::Completed || m_state == UpgradeState::Failed) {
+        return;
+    }
+    fail("升级已取消");
+}
+
+void FirmwareUpgrader::setWindowSize(int windowSize)
+{
+    m_windowSize = qMax(1, windowSize);
+    if (m_state == UpgradeState::Transferring) {
+        pump();
+    }
+}
+
+int FirmwareUpgrader::windowSize() const
+{
+    return m_windowSize;
+}
+
+UpgradeState FirmwareUpgrader::state() const
+{
+    return m_state;
+}
+
+UpgradeProgress FirmwareUpgrader::progress() const
+{
+    UpgradeProgress result;
+    result.confirmedBlocks = m_confirmed;
+    result.totalBlocks = m_blockCount;
+    result.confirmedBytes = qMin<qint64>(static_cast<qint64>(m_confirmed) * Protocol::UPGRADE_BLOCK_SIZE, m_imageSize);
+    result.totalBytes = m_imageSize;
+    result.retransmittedBlocks = m_retransmitted;
+
+    const qint64 elapsedNs = m_sessionTimer.isValid() ? m_sessionTimer.nsecsElapsed() : 0;
+    if (elapsedNs > 0 && m_confirmed > m_sessionStartBlock) {
+        const qint64 sessionBytes = result.confirmedBytes
+            - static_cast<qint64>(m_sessionStartBlock) * Protocol::UPGRADE_BLOCK_SIZE;
+        result.bytesPerSecond = sessionBytes * 1e9 / elapsedNs;
+    }
+    return result;
+}
+
+QString FirmwareUpgrader::filePath() const
+{
+    return m_file.fileName();
+}
+
+quint32 FirmwareUpgrader::blockCount() const
+{
+    return m_blockCount;
+}
+
+quint32 FirmwareUpgrader::imageCrc32c() const
+{
+    return m_imageCrc;
+}
+
+QByteArray FirmwareUpgrader::imageDigest() const
+{
+    return m_digest;
+}
+
+QString FirmwareUpgrader::stateToString(UpgradeState state)
+{
+    switch (state) {
+    case UpgradeState::Idle:         return "空闲";
+    case UpgradeState::Ready:        return "就绪";
+    case UpgradeState::Starting:     return "开始升级";
+    case UpgradeState::Transferring: return "传输中";
+    case UpgradeState::Finishing:    return "校验中";
+    case UpgradeState::Suspended:    return "已暂停";
+    case UpgradeState::Completed:    return "已完成";
+    case UpgradeState::Failed:       return "失败";
+    default:                         return "未知";
+    }
+}
+
+bool FirmwareUpgrader::handleFrame(const ProtocolFrame& frame)
+{
+    if (m_state != UpgradeState::Starting && m_state != UpgradeState::Transferring &&
+        m_state != UpgradeState::Finishing) {
+        return false;
+    }
+
+    if (frame.command == ProtocolCommand::Error) {
+        // 升级期间链路专用于升级，错误帧归属当前阶段
+        const ProtocolError error = frame.dataLength > 0
+            ? static_cast<ProtocolError>(static_cast<quint8>(frame.data[0])) : ProtocolError::UnknownError;
+        if (m_state == UpgradeState::Transferring) {
+            retransmitFromBase(QString("设备返回错误 0x%1").arg(static_cast<int>(error), 2, 16, QChar('0')));
+        } else {
+            fail(QString("设备拒绝%1，错误码 0x%2")
+                     .arg(stateToString(m_state))
+                     .arg(static_cast<int>(error), 2, 16, QChar('0')));
+        }
+        return true;
+    }
+
+    if (frame.command != ProtocolCommand::Response || frame.dataLength == 0) {
+        return false;
+    }
+
+    // 数据区首字节为原始命令码，其后为响应数据
+    const ProtocolCommand original = static_cast<ProtocolCommand>(static_cast<quint8>(frame.data[0]));
+    const char* data = frame.data + 1;
+    const int length = frame.dataLength - 1;
+
+    switch (original) {
+    case ProtocolCommand::StartUpgrade:
+        if (m_state != UpgradeState::Starting) return false;
+        handleStartResponse(data, length);
+        return true;
+    case ProtocolCommand::UpgradeData:
+        if (m_state != UpgradeState::Transferring) return false;
+        handleDataAck(data, length);
+        return true;
+    case ProtocolCommand::EndUpgrade:
+        if (m_state != UpgradeState::Finishing) return false;
+        handleEndResponse(data, length);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void FirmwareUpgrader::handleFrames(const FrameBatch& frames)
+{
+    for (const ProtocolFrame& frame : frames) {
+        handleFrame(frame);
+    }
+}
+
+void FirmwareUpgrader::onAckTimeout()
+{
+    switch (m_state) {
+    case UpgradeState::Starting:
+    case UpgradeState::Finishing:
+        suspendWithReason(QString("%1响应超时").arg(stateToString(m_state)));
+        break;
+    case UpgradeState::Transferring:
+        retransmitFromBase(QString("块 %1 确认超时").arg(m_confirmed));
+        break;
+    default:
+        break;
+    }
+}
+
+bool FirmwareUpgrader::beginSession()
+{
+    m_recovering = false;
+    m_retries = 0;
+    setState(UpgradeState::Starting);
+    return sendControl(ProtocolCommand::StartUpgrade, imageDescriptor(), Protocol::UPGRADE_COMMAND_TIMEOUT);
+}
+
+bool FirmwareUpgrader::sendControl(ProtocolCommand command, const QByteArray& data, int timeoutMs)
+{
+    const QByteArray frame = m_parser->buildFrame(command, data);
+    if (frame.isEmpty() || !m_sender || !m_sender(frame)) {
+        suspendWithReason(QString("发送%1失败").arg(ProtocolParser::commandToString(command)));
+        return false;
+    }
+    m_ackTimer->start(timeoutMs);
+    return true;
+}
+
+bool FirmwareUpgrader::sendBlock(quint32 index)
+{
+    const qint64 offset = static_cast<qint64>(index) * Protocol::UPGRADE_BLOCK_SIZE;
+    const int length = static_cast<int>(qMin<qint64>(Protocol::UPGRADE_BLOCK_SIZE, m_imageSize - offset));
+
+    QByteArray payload(Protocol::UPGRADE_BLOCK_HEADER_SIZE + length, Qt::Uninitialized);
+    char* out = payload.data();
+    qToBigEndian(index, out);
+    qToBigEndian(m_blockCrcs[static_cast<int>(index)], out + 4);
+    memcpy(out + Protocol::UPGRADE_BLOCK_HEADER_SIZE, m_image + offset, static_cast<size_t>(length));
+
+    const QByteArray frame = m_parser->buildFrame(ProtocolCommand::UpgradeData, payload);
+    return !frame.isEmpty() && m_sender && m_sender(frame);
+}
+
+void FirmwareUpgrader::pump()
+{
+    while (m_state == UpgradeState::Transferring && m_nextToSend < m_blockCount &&
+           m_nextToSend - m_confirmed < static_cast<quint32>(m_windowSize)) {
+        if (!sendBlock(m_nextToSend)) {
+            suspendWithReason(QString("发送块 %1 失败").arg(m_nextToSend));
+            return;
+        }
+        ++m_nextToSend;
+    }
+
+    // 计时只针对最早的未确认块，基准前移时重新计时
+    if (m_state == UpgradeState::Transferring && m_nextToSend > m_confirmed && !m_ackTimer->isActive()) {
+        m_ackTimer->start(Protocol::UPGRADE_ACK_TIMEOUT);
+    }
+}
+
+void FirmwareUpgrader::retransmitFromBase(const QString& reason)
+{
+    if (++m_retries > Protocol::UPGRADE_MAX_RETRIES) {
+        suspendWithReason(QString("块 %1 重传次数超过上限 (%2)").arg(m_confirmed).arg(reason));
+        return;
+    }
+
+    LogManager::getInstance()->debug(
+        QString("%1，从块 %2 重发 %3 块").arg(reason).arg(m_confirmed).arg(m_nextToSend - m_confirmed),
+        "FirmwareUpgrader");
+
+    m_retransmitted += m_nextToSend - m_confirmed;
+    m_nextToSend = m_confirmed;
+    m_recovering = true;
+    m_ackTimer->stop();
+    pump();
+}
+
+void FirmwareUpgrader::handleStartResponse(const char* data, int length)
+{
+    m_ackTimer->stop();
+    if (length < 5) {
+        fail("开始升级响应长度无效");
+        return;
+    }
+
+    const quint8 status = static_cast<quint8>(data[0]);
+    if (status != 0) {
+        fail(QString("设备拒绝开始升级，状态 0x%1").arg(status, 2, 16, QChar('0')));
+        return;
+    }
+
+    // 以设备回报的位置为准：设备可能保留了比本地记录更多的数据，也可能已经丢失
+    const quint32 deviceNext = qFromBigEndian<quint32>(data + 1);
+    if (deviceNext > m_blockCount) {
+        fail(QString("设备回报的续传位置无效: %1/%2").arg(deviceNext).arg(m_blockCount));
+        return;
+    }
+    if (deviceNext != m_confirmed) {
+        LogManager::getInstance()->info(
+            QString("设备续传位置 %1 (本地记录 %2)").arg(deviceNext).arg(m_confirmed), "FirmwareUpgrader");
+    }
+
+    m_confirmed = deviceNext;
+    m_nextToSend = deviceNext;
+    m_sessionStartBlock = deviceNext;
+    m_sessionTimer.start();
+    setState(UpgradeState::Transferring);
+    emitProgress();
+
+    if (m_confirmed >= m_blockCount) {
+        sendEnd();
+        return;
+    }
+    pump();
+}
+
+void FirmwareUpgrader::handleDataAck(const char* data, int length)
+{
+    if (length < 4) {
+        return;
+    }
+
+    const quint32 next = qFromBigEndian<quint32>(data);
+    if (next > m_nextToSend) {
+        // 确认了尚未发送的块（重发后迟到的旧确认不会越过已发送位置），忽略
+        return;
+    }
+
+    if (next <= m_confirmed) {
+        // 重复确认：基准块丢失或校验失败，每次丢失只重发一轮
+        if (next == m_confirmed && !m_recovering && m_nextToSend > m_confirmed) {
+            retransmitFromBase(QString("块 %1 重复确认").arg(m_confirmed));
+        }
+        return;
+    }
+
+    m_confirmed = next;
+    m_recovering = false;
+    m_retries = 0;
+    m_ackTimer->stop();
+    emitProgress();
+
+    if (m_confirmed >= m_blockCount) {
+        sendEnd();
+        return;
+    }
+    pump();
+}
+
+void FirmwareUpgrader::handleEndResponse(const char* data, int length)
+{
+    m_ackTimer->stop();
+    if (length < 1) {
+        fail("结束升级响应长度无效");
+        return;
+    }
+
+    const quint8 status = static_cast<quint8>(data[0]);
+    if (status != 0) {
+        // 整个镜像校验失败，已确认位置不再可信
+        m_confirmed = 0;
+        m_nextToSend = 0;
+        fail(QString("设备镜像校验失败，状态 0x%1").arg(status, 2, 16, QChar('0')));
+        return;
+    }
+
+    setState(UpgradeState::Completed);
+    const UpgradeProgress current = progress();
+    LogManager::getInstance()->info(
+        QString("固件升级完成: %1块, 重传%2块, %3 KB/s")
+            .arg(current.totalBlocks)
+            .arg(current.retransmittedBlocks)
+            .arg(current.bytesPerSecond / 1024.0, 0, 'f', 1),
+        "FirmwareUpgrader");
+    emit finished(true, "升级完成");
+}
+
+void FirmwareUpgrader::sendEnd()
+{
+    QByteArray data;
+    data.reserve(8 + DIGEST_SIZE);
+    appendBigEndian32(data, m_blockCount);
+    appendBigEndian32(data, m_imageCrc);
+    data.append(m_digest);
+
+    setState(UpgradeState::Finishing);
+    sendControl(ProtocolCommand::EndUpgrade, data, Protocol::UPGRADE_COMMAND_TIMEOUT);
+}
+
+void FirmwareUpgrader::fail(const QString& message)
+{
+    m_ackTimer->stop();
+    setState(UpgradeState::Failed);
+    LogManager::getInstance()->error(QString("固件升级失败: %1").arg(message), "FirmwareUpgrader");
+    emit finished(false, message);
+}
+
+void FirmwareUpgrader::suspendWithReason(const QString& reason)
+{
+    m_ackTimer->stop();
+    // 在途块视为未发送，恢复时与设备重新协商位置
+    m_nextToSend = m_confirmed;
+    setState(UpgradeState::Suspended);
+    LogManager::getInstance()->warning(
+        QString("固件升级暂停: %1，已确认 %2/%3 块").arg(reason).arg(m_confirmed).arg(m_blockCount),
+        "FirmwareUpgrader");
+}
+
+void FirmwareUpgrader::setState(UpgradeState state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged(state);
+    }
+}
+
+void FirmwareUpgrader::emitProgress()
+{
+    emit progressChanged(progress());
+}
+
+QByteArray FirmwareUpgrader::imageDescriptor() const
+{
+    QByteArray data;
+    data.reserve(14 + DIGEST_SIZE);
+    appendBigEndian32(data, static_cast<quint32>(m_imageSize));
+    char blockSize[2];
+    qToBigEndian(static_cast<quint16>(Protocol::UPGRADE_BLOCK_SIZE), blockSize);
+    data.append(blockSize, 2);
+    appendBigEndian32(data, m_blockCount);
+    appendBigEndian32(data, m_imageCrc);
+    data.append(m_digest);
+    return data;
+}
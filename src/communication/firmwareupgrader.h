@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+#include "constants.h"
+#include "protocolparser.h"
+
+// 固件升级状态
+enum class UpgradeState {
+    Idle,           // 未打开镜像或已关闭
+    Ready,          // 镜像已映射，尚未开始
+    Starting,       // 已发送开始升级，等待设备就绪
+    Transferring,   // 滑动窗口传输数据块
+    Finishing,      // 已发送结束升级，等待设备校验整个镜像
+    Suspended,      // 链路断开或重传耗尽，保留已确认位置，可 resume()
+    Completed,      // 设备校验通过
+    Failed          // 设备拒绝或镜像校验失败
+};
+
+// 升级进度
+struct UpgradeProgress {
+    quint32 confirmedBlocks = 0;        // 设备已确认的连续块数
+    quint32 totalBlocks = 0;
+    qint64 confirmedBytes = 0;
+    qint64 totalBytes = 0;
+    quint32 retransmittedBlocks = 0;    // 累计重传块数
+    double bytesPerSecond = 0.0;        // 本次会话的确认吞吐
+};
+
+Q_DECLARE_METATYPE(UpgradeProgress)
+
+// 固件升级引擎 - 映射固件文件，按滑动窗口连续发送数据块，不逐块等待确认
+//
+// 报文格式（多字节字段均为大端）：
+//   StartUpgrade   镜像长度(4) 块长度(2) 块数(4) 镜像CRC32C(4) SHA-256(32)
+//     响应         [0x40] 状态(1) 下一块序号(4)
+//   UpgradeData    块序号(4) 块CRC32C(4) 数据(≤ Protocol::UPGRADE_BLOCK_SIZE)
+//     响应         [0x41] 下一块序号(4)
+//   EndUpgrade     块数(4) 镜像CRC32C(4) SHA-256(32)
+//     响应         [0x42] 状态(1)
+// 状态 0 表示成功。数据块确认是累积的：设备只按序接收，乱序或块校验失败的块被丢弃，
+// 并重复回报期望的下一块；主机收到重复确认或最早未确认块超时后从该块起重发（go-back-N）。
+// 设备保留了相同摘要镜像的部分数据时，在开始升级响应中回报第一个缺失块，主机从该块续传；
+// 断线后调用 resume() 即按这一协商继续，不必从头发送。
+//
+// 对象在所属线程中使用，回调和信号都在该线程中执行。
+class FirmwareUpgrader : public QObject
+{
+    Q_OBJECT
+
+public:
+    using FrameSender = std::function<bool(const QByteArray& frame)>;
+
+    FirmwareUpgrader(ProtocolParser* parser, FrameSender sender, QObject* parent = nullptr);
+    ~FirmwareUpgrader();
+
+    // 映射固件文件并一次遍历计算各块CRC32C、镜像CRC32C和SHA-256
+    bool open(const QString& filePath);
+    void close();
+
+    // 开始升级（重置统计）；resume() 在断线重连后从设备确认的位置继续
+    bool start();
+    bool resume();
+    // 停止发送并保留已确认位置，链路断开时调用
+    void suspend();
+    void abort();
+
+    void setWindowSize(int windowSize);
+    int windowSize() const;
+
+    UpgradeState state() const;
+    UpgradeProgress progress() const;
+    QString filePath() const;
+    quint32 blockCount() const;
+    quint32 imageCrc32c() const;
+    QByteArray imageDigest() const;
+
+    static QString stateToString(UpgradeState state);
+
+public slots:
+    // 处理升级命令的响应帧，被消费时返回true
+    bool handleFrame(const ProtocolFrame& frame);
+    void handleFrames(const FrameBatch& frames);
+
+signals:
+    void stateChanged(UpgradeState state);
+    void progressChanged(const UpgradeProgress& progress);
+    void finished(bool success, const QString& message);
+
+private slots:
+    void onAckTimeout();
+
+private:
+    bool beginSession();
+    bool sendControl(ProtocolCommand command, const QByteArray& data, int timeoutMs);
+    bool sendBlock(quint32 index);
+    void pump();
+    void retransmitFromBase(const QString& reason);
+    void handleStartResponse(const char* data, int length);
+    void handleDataAck(const char* data, int length);
+    void handleEndResponse(const char* data, int length);
+    void sendEnd();
+    void fail(const QString& message);
+    void suspendWithReason(const QString& reason);
+    void setState(UpgradeState state);
+    void emitProgress();
+    QByteArray imageDescriptor() const;
+
+    ProtocolParser* m_parser;
+    FrameSender m_sender;
+    QFile m_file;
+    const uchar* m_image;
+    qint64 m_imageSize;
+    quint32 m_blockCount;
+    quint32 m_imageCrc;
+    QByteArray m_digest;
+    QVector<quint32> m_blockCrcs;
+
+    UpgradeState m_state;
+    quint32 m_confirmed;            // [0, m_confirmed) 已被设备确认
+    quint32 m_nextToSend;           // [m_confirmed, m_nextToSend) 在途
+    bool m_recovering;              // 已从基准块重发，等待基准前移，期间忽略重复确认
+    int m_windowSize;
+    int m_retries;
+    quint32 m_retransmitted;
+    QTimer* m_ackTimer;
+    QElapsedTimer m_sessionTimer;
+    quint32 m_sessionStartBlock;
+};
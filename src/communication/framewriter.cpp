@@ -0,0 +1,137 @@
+#include "framewriter.h"
+#include "constants.h"
+#include "utils/binarycodec.h"
+#include <cstring>
+
+namespace {
+
+// 帧头(2) + 命令(1) + 长度(1)
+constexpr int FRAME_PREFIX_SIZE = 4;
+
+} // namespace
+
+FrameWriter::FrameWriter(char* buffer, int capacity, ChecksumType checksumType)
+    : m_buffer(buffer)
+    , m_capacity(buffer ? capacity : 0)
+    , m_position(0)
+    , m_dataStart(0)
+    , m_dataLength(0)
+    , m_error(true)         // begin() 成功前不允许写入
+    , m_checksum(checksumType)
+{
+}
+
+int FrameWriter::requiredSize(int dataLength, ChecksumType checksumType)
+{
+    return FRAME_PREFIX_SIZE + dataLength + EnhancedChecksum::getChecksumLength(checksumType) + 1;
+}
+
+bool FrameWriter::begin(quint8 command, int dataLength)
+{
+    m_position = 0;
+    m_dataStart = FRAME_PREFIX_SIZE;
+    m_dataLength = dataLength;
+    m_checksum.reset();
+
+    m_error = dataLength < 0 || dataLength > Protocol::MAX_DATA_SIZE ||
+              m_capacity < requiredSize(dataLength, m_checksum.type());
+    if (m_error) {
+        return false;
+    }
+
+    m_buffer[0] = static_cast<char>((Protocol::FRAME_HEADER >> 8) & 0xFF);
+    m_buffer[1] = static_cast<char>(Protocol::FRAME_HEADER & 0xFF);
+    m_buffer[2] = static_cast<char>(command);
+    m_buffer[3] = static_cast<char>(dataLength);
+    m_position = FRAME_PREFIX_SIZE;
+
+    // 校验从命令码开始计算
+    m_checksum.update(reinterpret_cast<const uint8_t*>(m_buffer + 2), 2);
+    return true;
+}
+
+bool FrameWriter::reserve(int length)
+{
+    if (m_error || length < 0 || m_position + length > m_dataStart + m_dataLength) {
+        m_error = true;
+        return false;
+    }
+    return true;
+}
+
+void FrameWriter::append(const char* data, int length)
+{
+    memcpy(m_buffer + m_position, data, static_cast<size_t>(length));
+    m_checksum.update(reinterpret_cast<const uint8_t*>(m_buffer + m_position), static_cast<size_t>(length));
+    m_position += length;
+}
+
+FrameWriter& FrameWriter::writeUInt8(quint8 value)
+{
+    if (reserve(1)) {
+        const char byte = static_cast<char>(value);
+        append(&byte, 1);
+    }
+    return *this;
+}
+
+FrameWriter& FrameWriter::writeUInt32(quint32 value)
+{
+    if (reserve(4)) {
+        char bytes[4];
+        BinaryCodec::store<ByteOrder::BigEndian>(bytes, value);
+        append(bytes, 4);
+    }
+    return *this;
+}
+
+FrameWriter& FrameWriter::writeInt64(qint64 value)
+{
+    if (reserve(8)) {
+        char bytes[8];
+        BinaryCodec::store<ByteOrder::BigEndian>(bytes, value);
+        append(bytes, 8);
+    }
+    return *this;
+}
+
+FrameWriter& FrameWriter::writeFloat(float value)
+{
+    if (reserve(static_cast<int>(sizeof(float)))) {
+        append(reinterpret_cast<const char*>(&value), static_cast<int>(sizeof(float)));
+    }
+    return *this;
+}
+
+FrameWriter& FrameWriter::writeDouble(double value)
+{
+    if (reserve(static_cast<int>(sizeof(double)))) {
+        append(reinterpret_cast<const char*>(&value), static_cast<int>(sizeof(double)));
+    }
+    return *this;
+}
+
+FrameWriter& FrameWriter::writeBytes(const char* data, int length)
+{
+    if (length > 0 && reserve(length)) {
+        append(data, length);
+    }
+    return *this;
+}
+
+FrameView FrameWriter::finish()
+{
+    // 数据区必须与声明长度完全一致
+    if (m_error || m_position != m_dataStart + m_dataLength) {
+        m_error = true;
+        return FrameView();
+    }
+
+    m_position += m_checksum.finalizeTo(reinterpret_cast<uint8_t*>(m_buffer + m_position));
+    m_buffer[m_position++] = static_cast<char>(Protocol::FRAME_TAIL);
+
+    FrameView view;
+    view.first = m_buffer;
+    view.firstLength = m_position;
+    return view;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtGlobal>
+#include "ringbuffer.h"
+#include "utils/checksum.h"
+
+// 协议帧写入器 - 直接把帧序列化到调用方提供的缓冲区（可来自 CommunicationBufferPool）
+//
+// 帧格式: 帧头(2) | 命令(1) | 长度(1) | 数据(N) | 校验(M) | 帧尾(1)
+// 数据长度需在 begin() 时声明，这样命令码和长度字节写入后即可参与校验，
+// 后续每次写入的数据都同步更新校验状态，finish() 时无需再回读或拷贝数据区。
+// 任何一步出错（缓冲区不足、超出声明长度等）后续写入均被忽略，finish() 返回空视图。
+class FrameWriter
+{
+public:
+    FrameWriter(char* buffer, int capacity, ChecksumType checksumType = ChecksumType::Simple);
+
+    // 写入 dataLength 字节数据的帧所需的缓冲区大小
+    static int requiredSize(int dataLength, ChecksumType checksumType = ChecksumType::Simple);
+
+    bool begin(quint8 command, int dataLength);
+
+    // 数据区写入（整数按大端序，浮点按本机字节序，与既有帧构建保持一致）
+    FrameWriter& writeUInt8(quint8 value);
+    FrameWriter& writeUInt32(quint32 value);
+    FrameWriter& writeInt64(qint64 value);
+    FrameWriter& writeFloat(float value);
+    FrameWriter& writeDouble(double value);
+    FrameWriter& writeBytes(const char* data, int length);
+    FrameWriter& writeBytes(const QByteArray& data) { return writeBytes(data.constData(), data.size()); }
+
+    // 写入校验和帧尾，返回指向缓冲区的连续帧视图
+    FrameView finish();
+
+    bool hasError() const { return m_error; }
+    int size() const { return m_position; }
+
+private:
+    bool reserve(int length);
+    void append(const char* data, int length);
+
+private:
+    char* m_buffer;
+    int m_capacity;
+    int m_position;
+    int m_dataStart;        // 数据区起始偏移
+    int m_dataLength;       // begin() 声明的数据长度
+    bool m_error;
+    IncrementalChecksum m_checksum;
+};
@@ -5,6 +5,7 @@
 // #include "cancommunication.h"  // 暂未实现
 // #include "modbuscommunication.h"  // 暂未实现
 #include "logger/logmanager.h"
+#include "utils/metricsregistry.h"
 
 // 工厂类实现
 ICommunication* CommunicationFactory::createCommunication(CommunicationType type, QObject* parent)
@@ -84,6 +85,90 @@ bool CommunicationFactory::isTypeSupported(CommunicationType type)
     }
 }
 
+// 心跳往返时间
+HdrHistogram ICommunication::getHeartbeatHistogram() const
+{
+    QMutexLocker locker(&m_heartbeatMutex);
+    return m_heartbeatRtt;
+}
+
+void ICommunication::recordHeartbeatRtt(qint64 rttNs)
+{
+    if (m_metrics.heartbeatRtt) {
+        m_metrics.heartbeatRtt->observe(rttNs);
+    }
+    
+    QMutexLocker locker(&m_heartbeatMutex);
+    m_heartbeatRtt.record(rttNs);
+    
+    // 百分位随样本更新，统计查询不必遍历直方图
+    m_statistics.heartbeatCount = m_heartbeatRtt.count();
+    m_statistics.heartbeatP50Ns = m_heartbeatRtt.percentileNs(50.0);
+    m_statistics.heartbeatP99Ns = m_heartbeatRtt.percentileNs(99.0);
+    m_statistics.heartbeatP999Ns = m_heartbeatRtt.percentileNs(99.9);
+    m_statistics.heartbeatMaxNs = m_heartbeatRtt.maxNs();
+    m_statistics.averageLatency = m_heartbeatRtt.meanNs() / 1000000.0;
+}
+
+void ICommunication::resetHeartbeatHistogram()
+{
+    QMutexLocker locker(&m_heartbeatMutex);
+    m_heartbeatRtt.reset();
+}
+
+// 指标端点
+void ICommunication::attachMetrics(const QString& connectionName)
+{
+    const QString labels = MetricsRegistry::label("connection", connectionName);
+    m_metrics.bytesReceived = MetricsRegistry::counter("glue_link_received_bytes_total", "线路上接收的字节数", labels);
+    m_metrics.bytesSent = MetricsRegistry::counter("glue_link_sent_bytes_total", "线路上发送的字节数", labels);
+    m_metrics.framesReceived = MetricsRegistry::counter("glue_link_received_frames_total", "接收的协议帧数", labels);
+    m_metrics.framesSent = MetricsRegistry::counter("glue_link_sent_frames_total", "发送的协议帧数", labels);
+    m_metrics.errors = MetricsRegistry::counter("glue_link_errors_total", "通信错误次数", labels);
+    m_metrics.reconnects = MetricsRegistry::counter("glue_link_reconnects_total", "自动重连成功次数", labels);
+    m_metrics.connected = MetricsRegistry::gauge("glue_link_connected", "连接是否处于已连接状态", labels);
+    m_metrics.lastRecoverySeconds = MetricsRegistry::gauge("glue_link_last_recovery_seconds",
+                                                           "最近一次从掉线到重连成功的时间", labels);
+    m_metrics.heartbeatRtt = MetricsRegistry::histogram("glue_link_heartbeat_rtt_seconds", "心跳往返时间",
+                                                        labels, MetricsRegistry::latencyBucketsNs());
+    publishMetrics();
+}
+
+void ICommunication::publishMetrics()
+{
+    if (!m_metrics.connected) {
+        return;
+    }
+    m_metrics.bytesReceived->set(m_statistics.bytesReceived);
+    m_metrics.bytesSent->set(m_statistics.bytesSent);
+    m_metrics.framesReceived->set(m_statistics.framesReceived);
+    m_metrics.framesSent->set(m_statistics.framesSent);
+    m_metrics.errors->set(m_statistics.errorCount);
+    m_metrics.reconnects->set(m_statistics.reconnectCount);
+    m_metrics.connected->set(m_connectionState == ConnectionState::Connected ? 1.0 : 0.0);
+    m_metrics.lastRecoverySeconds->set(m_statistics.lastRecoveryMs / 1000.0);
+}
+
+void ICommunication::markOutage()
+{
+    if (m_outageStartMs == 0) {
+        m_outageStartMs = QDateTime::currentMSecsSinceEpoch();
+    }
+}
+
+void ICommunication::recordRecovery()
+{
+    if (m_outageStartMs == 0) {
+        return;
+    }
+    const qint64 recoveryMs = QDateTime::currentMSecsSinceEpoch() - m_outageStartMs;
+    m_outageStartMs = 0;
+    m_statistics.reconnectCount++;
+    m_statistics.lastRecoveryMs = recoveryMs;
+    m_statistics.maxRecoveryMs = qMax(m_statistics.maxRecoveryMs, recoveryMs);
+    emit recovered(recoveryMs);
+}
+
 // 辅助函数实现
 QString connectionStateToString(ConnectionState state)
 {
@@ -4,8 +4,14 @@
 #include <QByteArray>
 #include <QString>
 #include <QVariant>
+#include <QMutex>
 #include "constants.h"
 #include "protocolparser.h"
+#include "utils/hdrhistogram.h"
+
+class MetricCounter;
+class MetricGauge;
+class MetricHistogram;
 
 // 通讯连接状态枚举
 enum class ConnectionState {
@@ -52,24 +58,46 @@ struct CommunicationConfig {
 
 // 通讯统计信息
 struct CommunicationStats {
-    qint64 bytesReceived;          // 接收字节数
-    qint64 bytesSent;              // 发送字节数
+    qint64 bytesReceived;          // 接收字节数（线路上的字节，含压缩块）
+    qint64 bytesSent;              // 发送字节数（线路上的字节，含压缩块）
+    qint64 compressedBytesReceived;    // 链路压缩：压缩块的线路字节数（含块头）
+    qint64 uncompressedBytesReceived;  // 链路压缩：同一批压缩块解压后的字节数
+    qint64 compressedBytesSent;
+    qint64 uncompressedBytesSent;
     qint64 framesReceived;         // 接收帧数
     qint64 framesSent;             // 发送帧数
     qint64 errorCount;             // 错误次数
     qint64 reconnectCount;         // 重连次数
-    double averageLatency;         // 平均延迟(ms)
+    qint64 lastRecoveryMs;         // 最近一次从掉线到重连成功的时间(ms)
+    qint64 maxRecoveryMs;
+    double averageLatency;         // 平均延迟(ms)，有心跳回送时为心跳往返时间的平均值
+    qint64 heartbeatCount;         // 心跳往返样本数
+    qint64 heartbeatP50Ns;         // 心跳往返时间百分位(ns)
+    qint64 heartbeatP99Ns;
+    qint64 heartbeatP999Ns;
+    qint64 heartbeatMaxNs;
     QDateTime startTime;           // 连接开始时间
     QDateTime lastActivityTime;    // 最后活动时间
     
     CommunicationStats() 
         : bytesReceived(0)
         , bytesSent(0)
+        , compressedBytesReceived(0)
+        , uncompressedBytesReceived(0)
+        , compressedBytesSent(0)
+        , uncompressedBytesSent(0)
         , framesReceived(0)
         , framesSent(0)
         , errorCount(0)
         , reconnectCount(0)
+        , lastRecoveryMs(0)
+        , maxRecoveryMs(0)
         , averageLatency(0.0)
+        , heartbeatCount(0)
+        , heartbeatP50Ns(0)
+        , heartbeatP99Ns(0)
+        , heartbeatP999Ns(0)
+        , heartbeatMaxNs(0)
         , startTime(QDateTime::currentDateTime())
         , lastActivityTime(QDateTime::currentDateTime())
     {}
@@ -77,11 +105,22 @@ struct CommunicationStats {
     void reset() {
         bytesReceived = 0;
         bytesSent = 0;
+        compressedBytesReceived = 0;
+        uncompressedBytesReceived = 0;
+        compressedBytesSent = 0;
+        uncompressedBytesSent = 0;
         framesReceived = 0;
         framesSent = 0;
         errorCount = 0;
         reconnectCount = 0;
+        lastRecoveryMs = 0;
+        maxRecoveryMs = 0;
         averageLatency = 0.0;
+        heartbeatCount = 0;
+        heartbeatP50Ns = 0;
+        heartbeatP99Ns = 0;
+        heartbeatP999Ns = 0;
+        heartbeatMaxNs = 0;
         startTime = QDateTime::currentDateTime();
         lastActivityTime = QDateTime::currentDateTime();
     }
@@ -125,6 +164,13 @@ public:
     virtual void sendHeartbeat() = 0;
     virtual qint64 getLastHeartbeatTime() const = 0;
     
+    // 本连接的心跳往返时间分布（任意线程调用）
+    HdrHistogram getHeartbeatHistogram() const;
+    
+    // 把本连接的统计导出到指标端点，标签为 connection="<name>"。在连接移到所属线程之前调用，
+    // 之后由所属线程在统计定时器和状态变化时更新；连接移除时 MetricsRegistry::retire() 停止导出
+    void attachMetrics(const QString& connectionName);
+    
     // 重连管理
     virtual void enableAutoReconnect(bool enabled) = 0;
     virtual bool isAutoReconnectEnabled() const = 0;
@@ -147,6 +193,7 @@ signals:
     void connectionStateChanged(ConnectionState state);
     void connectionError(const QString& error);
     void reconnectAttempt(int attempt);
+    void recovered(qint64 recoveryMs);           // 自动重连成功，参数为掉线到恢复的时间
     
     // 数据传输信号
     void dataReceived(const QByteArray& data);
@@ -156,7 +203,7 @@ signals:
     void bytesWritten(qint64 bytes);
     
     // 协议相关信号
-    void heartbeatReceived(qint64 delay);
+    void heartbeatReceived(qint64 rttNs);        // 心跳往返时间(ns)
     void heartbeatTimeout();
     void protocolError(const QString& error);
     
@@ -195,6 +242,17 @@ protected:
     virtual bool validateData(const QByteArray& data) const = 0;
     virtual bool isValidFrame(const ProtocolFrame& frame) const = 0;
     
+    // 心跳往返时间：解析器收到回送心跳后调用，更新直方图和 m_statistics 中的百分位
+    void recordHeartbeatRtt(qint64 rttNs);
+    void resetHeartbeatHistogram();
+    
+    // 重连恢复时间：进入重连时 markOutage()，重连成功后 recordRecovery() 计入统计并发出 recovered
+    void markOutage();
+    void recordRecovery();
+    
+    // 把 m_statistics 和连接状态写入指标（attachMetrics 之前不做任何事）
+    void publishMetrics();
+    
     // 内部状态
     ConnectionState m_connectionState = ConnectionState::Disconnected;
     QString m_lastError;
@@ -203,6 +261,25 @@ protected:
     bool m_heartbeatEnabled = true;
     int m_currentReconnectAttempts = 0;
     qint64 m_lastHeartbeatTime = 0;
+    qint64 m_outageStartMs = 0;         // 本次掉线的开始时间，未掉线为0
+    
+    // 心跳往返时间直方图（在连接所在线程记录，读取可来自任意线程）
+    mutable QMutex m_heartbeatMutex;
+    HdrHistogram m_heartbeatRtt;
+    
+    // 指标端点的序列，由 MetricsRegistry 持有
+    struct MetricSeriesSet {
+        MetricCounter* bytesReceived = nullptr;
+        MetricCounter* bytesSent = nullptr;
+        MetricCounter* framesReceived = nullptr;
+        MetricCounter* framesSent = nullptr;
+        MetricCounter* errors = nullptr;
+        MetricCounter* reconnects = nullptr;
+        MetricGauge* connected = nullptr;
+        MetricGauge* lastRecoverySeconds = nullptr;
+        MetricHistogram* heartbeatRtt = nullptr;
+    };
+    MetricSeriesSet m_metrics;
     
 private:
     // 禁用复制构造函数和赋值操作符
@@ -0,0 +1,389 @@
+#include "linkcapture.h"
+#include "logmanager.h"
+#include <QDateTime>
+#include <QtEndian>
+#include <chrono>
+#include <cstring>
+
+namespace {
+constexpr char CAPTURE_MAGIC[8] = {'G', 'D', 'L', 'C', 'A', 'P', '\0', '\0'};
+constexpr quint16 CAPTURE_VERSION = 1;
+constexpr int FILE_HEADER_SIZE = 32;
+constexpr int RECORD_HEADER_SIZE = 8;
+constexpr int MAX_SPARE_BUFFERS = 2;
+
+qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+LinkCaptureWriter::LinkCaptureWriter()
+    : m_open(false)
+    , m_startSteadyNs(0)
+    , m_lastOffsetUs(0)
+    , m_recordCount(0)
+    , m_capturedBytes(0)
+    , m_droppedRecords(0)
+    , m_stopping(false)
+    , m_flushThread(nullptr)
+{
+}
+
+LinkCaptureWriter::~LinkCaptureWriter()
+{
+    close();
+}
+
+bool LinkCaptureWriter::open(const QString& filePath, CaptureLinkType linkType, const QString& source)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMutexLocker locker(&m_mutex);
+        m_lastError = QString("无法创建抓包文件 %1: %2").arg(filePath, m_file.errorString());
+        LogManager::getInstance()->error(m_lastError, "Capture");
+        return false;
+    }
+
+    const QByteArray sourceBytes = source.toUtf8().left(0xFFFF);
+    m_startSteadyNs = steadyNowNs();
+
+    char header[FILE_HEADER_SIZE] = {};
+    memcpy(header, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    qToLittleEndian<quint16>(CAPTURE_VERSION, header + 8);
+    qToLittleEndian<quint16>(static_cast<quint16>(linkType), header + 10);
+    qToLittleEndian<quint16>(static_cast<quint16>(sourceBytes.size()), header + 12);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 16);
+    qToLittleEndian<qint64>(m_startSteadyNs, header + 24);
+
+    if (m_file.write(header, FILE_HEADER_SIZE) != FILE_HEADER_SIZE
+        || m_file.write(sourceBytes) != sourceBytes.size()) {
+        QMutexLocker locker(&m_mutex);
+        m_lastError = QString("写入抓包文件头失败: %1").arg(m_file.errorString());
+        m_file.close();
+        return false;
+    }
+
+    m_lastOffsetUs = 0;
+    m_recordCount = 0;
+    m_capturedBytes = 0;
+    m_droppedRecords.storeRelaxed(0);
+    m_active = QByteArray();
+    m_active.reserve(Communication::CAPTURE_BUFFER_SIZE);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.clear();
+        m_spare.clear();
+        m_stopping = false;
+        m_lastError.clear();
+    }
+
+    m_flushThread = QThread::create([this]() { flushLoop(); });
+    m_flushThread->setObjectName("CaptureFlush");
+    m_flushThread->start(QThread::LowPriority);
+    m_open = true;
+
+    LogManager::getInstance()->info(QString("开始抓包: %1 (%2)").arg(filePath, source), "Capture");
+    return true;
+}
+
+void LinkCaptureWriter::close()
+{
+    if (!m_open) {
+        return;
+    }
+    m_open = false;
+
+    // 剩余数据无视待落盘上限直接提交，确保抓包完整收尾
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_active.isEmpty()) {
+            m_pending.append(m_active);
+        }
+        m_active = QByteArray();
+        m_stopping = true;
+        m_pendingCondition.wakeAll();
+    }
+
+    m_flushThread->wait();
+    delete m_flushThread;
+    m_flushThread = nullptr;
+    m_file.close();
+
+    LogManager::getInstance()->info(
+        QString("抓包结束: %1, 记录=%2, 字节=%3, 丢弃=%4")
+        .arg(m_file.fileName())
+        .arg(m_recordCount)
+        .arg(m_capturedBytes)
+        .arg(droppedRecords()),
+        "Capture"
+    );
+}
+
+QString LinkCaptureWriter::lastError() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lastError;
+}
+
+void LinkCaptureWriter::recordBytes(CaptureRecordKind kind, const char* data, int length)
+{
+    if (!m_open || length <= 0) {
+        return;
+    }
+
+    while (length > 0) {
+        const int chunk = qMin(length, MAX_RECORD_LENGTH);
+        if (beginRecord(kind, 0, chunk)) {
+            appendRaw(data, chunk);
+            m_capturedBytes += chunk;
+        }
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void LinkCaptureWriter::recordCanFrame(quint32 canId, const QByteArray& payload, quint8 flags)
+{
+    if (!m_open) {
+        return;
+    }
+
+    const int length = qMin(static_cast<int>(payload.size()), MAX_RECORD_LENGTH - 4);
+    if (!beginRecord(CaptureRecordKind::CanFrame, flags, 4 + length)) {
+        return;
+    }
+
+    char id[4];
+    qToLittleEndian<quint32>(canId, id);
+    appendRaw(id, 4);
+    appendRaw(payload.constData(), length);
+    m_capturedBytes += length;
+}
+
+bool LinkCaptureWriter::beginRecord(CaptureRecordKind kind, quint8 flags, int length)
+{
+    const qint64 offsetUs = (steadyNowNs() - m_startSteadyNs) / 1000;
+    const qint64 deltaUs = qMax<qint64>(0, offsetUs - m_lastOffsetUs);
+    const bool needSync = deltaUs > 0xFFFFFFFFLL;
+
+    // 同步记录与本条记录要落在同一个缓冲区，避免中途提交时被拆开
+    const int required = RECORD_HEADER_SIZE + length + (needSync ? RECORD_HEADER_SIZE + 8 : 0);
+    if (m_active.size() + required > m_active.capacity()) {
+        submitActiveBuffer();
+        if (m_active.size() + required > m_active.capacity()) {
+            m_droppedRecords.storeRelaxed(m_droppedRecords.loadRelaxed() + 1);
+            return false;
+        }
+    }
+
+    char header[RECORD_HEADER_SIZE];
+    if (needSync) {
+        qToLittleEndian<quint32>(0, header);
+        qToLittleEndian<quint16>(8, header + 4);
+        header[6] = static_cast<char>(CaptureRecordKind::TimeSync);
+        header[7] = 0;
+        appendRaw(header, RECORD_HEADER_SIZE);
+        char absolute[8];
+        qToLittleEndian<qint64>(offsetUs, absolute);
+        appendRaw(absolute, 8);
+    }
+
+    qToLittleEndian<quint32>(needSync ? 0 : static_cast<quint32>(deltaUs), header);
+    qToLittleEndian<quint16>(static_cast<quint16>(length), header + 4);
+    header[6] = static_cast<char>(kind);
+    header[7] = static_cast<char>(flags);
+    appendRaw(header, RECORD_HEADER_SIZE);
+
+    m_lastOffsetUs = offsetUs;
+    m_recordCount++;
+    return true;
+}
+
+void LinkCaptureWriter::appendRaw(const void* data, int length)
+{
+    // 容量已预留，append 只是一次内存拷贝
+    m_active.append(static_cast<const char*>(data), length);
+}
+
+void LinkCaptureWriter::submitActiveBuffer()
+{
+    if (m_active.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_pending.size() >= Communication::CAPTURE_MAX_PENDING_BUFFERS) {
+        // 落盘跟不上：保留当前缓冲区，由调用方丢弃新记录
+        return;
+    }
+
+    m_pending.append(m_active);
+    if (!m_spare.isEmpty()) {
+        m_active = m_spare.takeLast();
+    } else {
+        m_active = QByteArray();
+        m_active.reserve(Communication::CAPTURE_BUFFER_SIZE);
+    }
+    m_pendingCondition.wakeOne();
+}
+
+void LinkCaptureWriter::flushLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    forever {
+        while (m_pending.isEmpty() && !m_stopping) {
+            m_pendingCondition.wait(&m_mutex);
+        }
+        if (m_pending.isEmpty()) {
+            break;
+        }
+
+        QByteArray buffer = m_pending.takeFirst();
+        locker.unlock();
+
+        const qint64 written = m_file.write(buffer);
+        QString error;
+        if (written != buffer.size()) {
+            error = QString("抓包写入失败: %1").arg(m_file.errorString());
+        }
+        buffer.resize(0);
+
+        locker.relock();
+        if (!error.isEmpty()) {
+            m_lastError = error;
+        }
+        if (m_spare.size() < MAX_SPARE_BUFFERS) {
+            m_spare.append(buffer);
+        }
+    }
+    m_file.flush();
+}
+
+LinkCaptureReader::~LinkCaptureReader()
+{
+    close();
+}
+
+bool LinkCaptureReader::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_lastError = QString("无法打开抓包文件 %1: %2").arg(filePath, m_file.errorString());
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < FILE_HEADER_SIZE) {
+        m_lastError = "抓包文件过短";
+        m_file.close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_lastError = QString("无法映射抓包文件: %1").arg(m_file.errorString());
+        m_file.close();
+        return false;
+    }
+
+    const char* header = reinterpret_cast<const char*>(m_data);
+    const quint16 version = qFromLittleEndian<quint16>(header + 8);
+    if (memcmp(header, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 || version != CAPTURE_VERSION) {
+        m_lastError = "不是有效的抓包文件或版本不支持";
+        close();
+        return false;
+    }
+
+    m_linkType = static_cast<CaptureLinkType>(qFromLittleEndian<quint16>(header + 10));
+    const int sourceLength = qFromLittleEndian<quint16>(header + 12);
+    m_startEpochMs = qFromLittleEndian<qint64>(header + 16);
+    if (FILE_HEADER_SIZE + sourceLength > m_size) {
+        m_lastError = "抓包文件头损坏";
+        close();
+        return false;
+    }
+    m_source = QString::fromUtf8(header + FILE_HEADER_SIZE, sourceLength);
+    m_firstRecordOffset = FILE_HEADER_SIZE + sourceLength;
+    rewind();
+    return true;
+}
+
+void LinkCaptureReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+}
+
+void LinkCaptureReader::rewind()
+{
+    m_offset = m_firstRecordOffset;
+    m_timestampNs = 0;
+    m_truncated = false;
+}
+
+bool LinkCaptureReader::next(CaptureRecord& record)
+{
+    if (!m_data) {
+        return false;
+    }
+
+    const char* base = reinterpret_cast<const char*>(m_data);
+    while (m_offset + RECORD_HEADER_SIZE <= m_size) {
+        const char* header = base + m_offset;
+        const quint32 deltaUs = qFromLittleEndian<quint32>(header);
+        const int length = qFromLittleEndian<quint16>(header + 4);
+        const auto kind = static_cast<CaptureRecordKind>(static_cast<quint8>(header[6]));
+        const quint8 flags = static_cast<quint8>(header[7]);
+
+        if (m_offset + RECORD_HEADER_SIZE + length > m_size) {
+            // 抓包未正常结束时最后一条记录可能不完整
+            m_truncated = true;
+            return false;
+        }
+
+        const char* payload = header + RECORD_HEADER_SIZE;
+        m_offset += RECORD_HEADER_SIZE + length;
+        m_timestampNs += static_cast<qint64>(deltaUs) * 1000;
+
+        if (kind == CaptureRecordKind::TimeSync) {
+            if (length == 8) {
+                m_timestampNs = qFromLittleEndian<qint64>(payload) * 1000;
+            }
+            continue;
+        }
+
+        record.timestampNs = m_timestampNs;
+        record.kind = kind;
+        record.flags = flags;
+        record.canId = 0;
+        record.data = payload;
+        record.length = length;
+
+        if (kind == CaptureRecordKind::CanFrame) {
+            if (length < 4) {
+                continue;
+            }
+            record.canId = qFromLittleEndian<quint32>(payload);
+            record.data = payload + 4;
+            record.length = length - 4;
+        }
+        return true;
+    }
+
+    if (m_offset < m_size) {
+        m_truncated = true;
+    }
+    return false;
+}
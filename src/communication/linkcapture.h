@@ -0,0 +1,149 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QThread>
+#include <QAtomicInteger>
+#include "constants.h"
+
+// 链路抓包文件格式（小端序）
+//
+// 文件头(32字节): 魔数"GDLCAP\0\0"(8) | 版本(2) | 链路类型(2) | 来源名长度(2) | 保留(2)
+//                | 起始墙钟时间ms(8) | 起始单调时钟ns(8)，随后是 UTF-8 来源名
+// 记录头(8字节):  距上一条记录的间隔us(4) | 数据长度(2) | 记录类型(1) | 标志(1)，随后是数据
+// CAN记录的数据为 帧ID(4) | 载荷；间隔超出32位时先写入一条时间同步记录（数据为8字节绝对偏移us）
+
+enum class CaptureLinkType : quint16 {
+    Serial = 1,
+    Tcp = 2,
+    Can = 3
+};
+
+enum class CaptureRecordKind : quint8 {
+    Received = 0,       // 接收的原始字节
+    Sent = 1,           // 发送的原始字节
+    CanFrame = 2,       // 一个CAN帧（方向见标志位）
+    TimeSync = 3        // 时间同步（内部使用）
+};
+
+// 记录标志位
+namespace CaptureFlags {
+    static constexpr quint8 Transmit = 0x01;    // CAN帧为发送方向
+    static constexpr quint8 Extended = 0x02;    // 扩展帧
+    static constexpr quint8 Remote = 0x04;      // 远程帧
+}
+
+// 抓包写入器 - I/O线程只把记录追加到内存缓冲区，写满后整块交给落盘线程，
+// 不在接收路径上做系统调用。落盘跟不上时丢弃记录并计数，绝不阻塞I/O线程。
+// 记录接口只允许一个线程调用（即所属I/O线程），open/close 也应在该线程调用。
+class LinkCaptureWriter
+{
+public:
+    static constexpr int MAX_RECORD_LENGTH = 0xFFFF;
+
+    LinkCaptureWriter();
+    ~LinkCaptureWriter();
+
+    LinkCaptureWriter(const LinkCaptureWriter&) = delete;
+    LinkCaptureWriter& operator=(const LinkCaptureWriter&) = delete;
+
+    bool open(const QString& filePath, CaptureLinkType linkType, const QString& source);
+    void close();
+    bool isOpen() const { return m_open; }
+
+    // 超过 MAX_RECORD_LENGTH 的数据拆成多条记录
+    void recordReceived(const char* data, int length) { recordBytes(CaptureRecordKind::Received, data, length); }
+    void recordReceived(const QByteArray& data) { recordReceived(data.constData(), data.size()); }
+    void recordSent(const char* data, int length) { recordBytes(CaptureRecordKind::Sent, data, length); }
+    void recordSent(const QByteArray& data) { recordSent(data.constData(), data.size()); }
+    void recordCanFrame(quint32 canId, const QByteArray& payload, quint8 flags);
+
+    QString filePath() const { return m_file.fileName(); }
+    QString lastError() const;
+    qint64 recordCount() const { return m_recordCount; }
+    qint64 capturedBytes() const { return m_capturedBytes; }
+    qint64 droppedRecords() const { return m_droppedRecords.loadRelaxed(); }
+
+private:
+    void recordBytes(CaptureRecordKind kind, const char* data, int length);
+    bool beginRecord(CaptureRecordKind kind, quint8 flags, int length);
+    void appendRaw(const void* data, int length);
+    void submitActiveBuffer();
+    void flushLoop();
+
+    QFile m_file;
+    bool m_open;
+    qint64 m_startSteadyNs;
+    qint64 m_lastOffsetUs;              // 上一条记录相对起点的偏移
+    qint64 m_recordCount;
+    qint64 m_capturedBytes;
+    QAtomicInteger<qint64> m_droppedRecords;
+
+    QByteArray m_active;                // I/O线程正在写入的缓冲区
+
+    // 落盘线程
+    mutable QMutex m_mutex;
+    QWaitCondition m_pendingCondition;
+    QList<QByteArray> m_pending;        // 待落盘缓冲区（受 m_mutex 保护）
+    QList<QByteArray> m_spare;          // 已落盘可复用的缓冲区（受 m_mutex 保护）
+    bool m_stopping;
+    QString m_lastError;
+    QThread* m_flushThread;
+};
+
+// 抓包中的一条记录，data 指向映射的文件内容，在读取器关闭前有效
+struct CaptureRecord {
+    qint64 timestampNs = 0;         // 相对抓包起点
+    CaptureRecordKind kind = CaptureRecordKind::Received;
+    quint8 flags = 0;
+    quint32 canId = 0;              // 仅CAN记录
+    const char* data = nullptr;
+    int length = 0;
+
+    // 不拷贝的数据视图
+    QByteArray bytes() const { return QByteArray::fromRawData(data, length); }
+};
+
+// 抓包读取器 - 内存映射整个文件，按顺序零拷贝遍历记录
+class LinkCaptureReader
+{
+public:
+    LinkCaptureReader() = default;
+    ~LinkCaptureReader();
+
+    LinkCaptureReader(const LinkCaptureReader&) = delete;
+    LinkCaptureReader& operator=(const LinkCaptureReader&) = delete;
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    CaptureLinkType linkType() const { return m_linkType; }
+    QString source() const { return m_source; }
+    qint64 startEpochMs() const { return m_startEpochMs; }
+    qint64 fileSize() const { return m_size; }
+    QString lastError() const { return m_lastError; }
+
+    // 读取下一条记录，到达末尾或遇到截断的记录时返回false
+    bool next(CaptureRecord& record);
+    void rewind();
+    bool isTruncated() const { return m_truncated; }
+
+private:
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    qint64 m_firstRecordOffset = 0;
+    qint64 m_offset = 0;
+    qint64 m_timestampNs = 0;
+    bool m_truncated = false;
+    CaptureLinkType m_linkType = CaptureLinkType::Serial;
+    QString m_source;
+    qint64 m_startEpochMs = 0;
+    QString m_lastError;
+};
@@ -0,0 +1,172 @@
+#include "linkcompression.h"
+#include "icommunication.h"
+#include "constants.h"
+#include "logger/logmanager.h"
+#include "utils/lz4block.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<bool> s_defaultEnabled(false);
+
+constexpr quint8 FRAME_HEADER_HIGH = static_cast<quint8>(Protocol::FRAME_HEADER >> 8);
+constexpr quint8 FRAME_HEADER_LOW = static_cast<quint8>(Protocol::FRAME_HEADER & 0xFF);
+constexpr quint8 BLOCK_MAGIC_HIGH = static_cast<quint8>(LinkCompression::BLOCK_MAGIC >> 8);
+constexpr quint8 BLOCK_MAGIC_LOW = static_cast<quint8>(LinkCompression::BLOCK_MAGIC & 0xFF);
+constexpr int FRAME_PREFIX_SIZE = 4;    // 帧头(2) + 命令(1) + 长度(1)
+
+inline quint16 readBigEndian16(const char* p)
+{
+    return static_cast<quint16>((static_cast<quint8>(p[0]) << 8) | static_cast<quint8>(p[1]));
+}
+
+inline void writeBigEndian16(char* p, quint16 value)
+{
+    p[0] = static_cast<char>(value >> 8);
+    p[1] = static_cast<char>(value & 0xFF);
+}
+
+}
+
+LinkCompression::LinkCompression(FrameSizeFunction frameSize)
+    : m_frameSize(std::move(frameSize))
+    , m_active(false)
+    , m_frameRemaining(0)
+{
+}
+
+void LinkCompression::setDefaultEnabled(bool enabled)
+{
+    s_defaultEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool LinkCompression::defaultEnabled()
+{
+    return s_defaultEnabled.load(std::memory_order_relaxed);
+}
+
+void LinkCompression::reset()
+{
+    m_active = false;
+    m_frameRemaining = 0;
+    m_pending.clear();
+}
+
+QByteArray LinkCompression::encode(const QByteArray& frames) const
+{
+    const int size = frames.size();
+    if (size == 0 || size > Communication::LINK_COMPRESSION_MAX_BLOCK) {
+        return QByteArray();
+    }
+
+    QByteArray block(BLOCK_HEADER_SIZE + Lz4Block::compressBound(size), Qt::Uninitialized);
+    const int compressed = Lz4Block::compress(frames.constData(), size, block.data() + BLOCK_HEADER_SIZE,
+                                              block.size() - BLOCK_HEADER_SIZE);
+    if (compressed == 0 || BLOCK_HEADER_SIZE + compressed >= size) {
+        return QByteArray();
+    }
+
+    writeBigEndian16(block.data(), BLOCK_MAGIC);
+    writeBigEndian16(block.data() + 2, static_cast<quint16>(size));
+    writeBigEndian16(block.data() + 4, static_cast<quint16>(compressed));
+    block.resize(BLOCK_HEADER_SIZE + compressed);
+    return block;
+}
+
+void LinkCompression::decode(const char* data, int length, const Sink& sink, CommunicationStats& stats)
+{
+    if (m_pending.isEmpty()) {
+        scan(data, length, sink, stats);
+        return;
+    }
+
+    QByteArray buffer = std::move(m_pending);
+    m_pending = QByteArray();
+    buffer.append(data, length);
+    scan(buffer.constData(), buffer.size(), sink, stats);
+}
+
+void LinkCompression::scan(const char* data, int length, const Sink& sink, CommunicationStats& stats)
+{
+    int position = 0;
+    int runStart = 0;   // 原样转交的字节从这里开始
+    auto flushRun = [&](int end) {
+        if (end > runStart) {
+            sink(data + runStart, end - runStart);
+        }
+        runStart = end;
+    };
+    // 块头或帧头不完整，留到下一次读取
+    auto keepRest = [&]() {
+        flushRun(position);
+        m_pending = QByteArray(data + position, length - position);
+    };
+
+    while (position < length) {
+        if (m_frameRemaining > 0) {
+            const int skipped = qMin(m_frameRemaining, length - position);
+            position += skipped;
+            m_frameRemaining -= skipped;
+            continue;
+        }
+
+        const quint8 byte = static_cast<quint8>(data[position]);
+        const int available = length - position;
+
+        if (byte == FRAME_HEADER_HIGH) {
+            if (available >= 2 && static_cast<quint8>(data[position + 1]) != FRAME_HEADER_LOW) {
+                ++position;
+                continue;
+            }
+            if (available < FRAME_PREFIX_SIZE) {
+                keepRest();
+                return;
+            }
+            m_frameRemaining = qMax(FRAME_PREFIX_SIZE, m_frameSize(static_cast<quint8>(data[position + 3])));
+            continue;
+        }
+
+        if (byte == BLOCK_MAGIC_HIGH) {
+            if (available >= 2 && static_cast<quint8>(data[position + 1]) != BLOCK_MAGIC_LOW) {
+                ++position;
+                continue;
+            }
+            if (available < BLOCK_HEADER_SIZE) {
+                keepRest();
+                return;
+            }
+            const int originalSize = readBigEndian16(data + position + 2);
+            const int compressedSize = readBigEndian16(data + position + 4);
+            if (originalSize == 0 || originalSize > Communication::LINK_COMPRESSION_MAX_BLOCK
+                || compressedSize == 0 || compressedSize > Lz4Block::compressBound(originalSize)) {
+                // 不是有效的块头，按普通字节交给协议解析器
+                ++position;
+                continue;
+            }
+            const int blockSize = BLOCK_HEADER_SIZE + compressedSize;
+            if (available < blockSize) {
+                keepRest();
+                return;
+            }
+
+            flushRun(position);
+            QByteArray frames(originalSize, Qt::Uninitialized);
+            if (Lz4Block::decompress(data + position + BLOCK_HEADER_SIZE, compressedSize, frames.data(), originalSize)) {
+                stats.compressedBytesReceived += blockSize;
+                stats.uncompressedBytesReceived += originalSize;
+                sink(frames.constData(), originalSize);
+            } else {
+                stats.errorCount++;
+                LogManager::getInstance()->warning(
+                    QString("压缩块解压失败，已丢弃 %1 字节").arg(blockSize), "LinkCompression");
+            }
+            position += blockSize;
+            runStart = position;
+            continue;
+        }
+
+        ++position;
+    }
+
+    flushRun(length);
+}
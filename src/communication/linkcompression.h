@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <functional>
+
+struct CommunicationStats;
+
+// 链路压缩 - 协商启用后，成批发送的帧整体压缩为 LZ4 块，与未压缩的帧混合在同一字节流中
+//
+// 压缩块(大端序): 魔数 0xA55A(2) | 原始长度(2) | 压缩后长度(2)，随后是 LZ4 块数据（见 Lz4Block），
+// 原始数据由若干完整的协议帧组成。小于阈值或压缩后不更小的数据仍按普通帧发送。
+// 接收端按帧长度跳过普通帧，只在帧边界识别压缩块，帧数据中出现的魔数不会被误判。
+// 编解码状态属于一条连接，只在所属I/O线程使用，断开时 reset()。
+class LinkCompression
+{
+public:
+    static constexpr quint16 BLOCK_MAGIC = 0xA55A;
+    static constexpr int BLOCK_HEADER_SIZE = 6;
+    static constexpr quint8 PROTOCOL_VERSION = 1;
+    static constexpr quint8 ALGORITHM_NONE = 0x00;
+    static constexpr quint8 ALGORITHM_LZ4 = 0x01;
+
+    // 普通帧的总长度（由数据长度和校验方式决定，取自 ProtocolParser::requiredFrameSize）
+    using FrameSizeFunction = std::function<int(int dataLength)>;
+    // 解出的字节流，只在回调期间有效
+    using Sink = std::function<void(const char* data, int length)>;
+
+    explicit LinkCompression(FrameSizeFunction frameSize);
+
+    // 新建 TCP 连接是否请求压缩（启动时由 communication_buffer.compression_enabled 设置）
+    static void setDefaultEnabled(bool enabled);
+    static bool defaultEnabled();
+
+    // 对端同意压缩后发送端才压缩；接收端只要请求过压缩就识别压缩块
+    void setActive(bool active) { m_active = active; }
+    bool isActive() const { return m_active; }
+    void reset();
+
+    // 把若干完整帧压缩为一个块（含块头），压缩后不更小或超过块上限时返回空
+    QByteArray encode(const QByteArray& frames) const;
+
+    // 拆出并解压压缩块，其余字节原样交给 sink；不完整的块留到下一次调用。
+    // 块压缩前后的字节数计入 stats，损坏的块丢弃并计入 errorCount
+    void decode(const char* data, int length, const Sink& sink, CommunicationStats& stats);
+
+private:
+    void scan(const char* data, int length, const Sink& sink, CommunicationStats& stats);
+
+    FrameSizeFunction m_frameSize;
+    bool m_active;
+    int m_frameRemaining;           // 当前普通帧还没收到的字节数
+    QByteArray m_pending;           // 跨读取边界的块头或块数据
+};
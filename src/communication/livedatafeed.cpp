@@ -0,0 +1,302 @@
+#include "livedatafeed.h"
+#include "logmanager.h"
+#include "../constants.h"
+#include "../utils/monotonicclock.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+LiveDataFeed* LiveDataFeed::instance = nullptr;
+QMutex LiveDataFeed::mutex;
+
+namespace {
+constexpr int SENSOR_FRAME_MIN_LENGTH = 32;     // 7 个 float + 状态字节，与 AlarmEngine 的解析一致
+constexpr int SENSOR_STATUS_OFFSET = 28;
+constexpr size_t RECORD_PAYLOAD_OFFSET = sizeof(std::atomic<uint64_t>);     // 顺序锁之后的数据字段
+
+quint32 roundUpPowerOfTwo(int value)
+{
+    quint32 capacity = 1;
+    while (capacity < quint32(value) && capacity < (1u << 30)) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+inline float nativeFloat(const char* data)
+{
+    float value;
+    memcpy(&value, data, sizeof(float));
+    return value;
+}
+}
+
+LiveDataFeed::LiveDataFeed()
+    : QObject(nullptr)
+    , m_running(false)
+    , m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_handle(0)
+    , m_header(nullptr)
+    , m_records(nullptr)
+    , m_mask(0)
+    , m_sequence(0)
+{
+}
+
+LiveDataFeed::~LiveDataFeed()
+{
+    stop();
+}
+
+LiveDataFeed* LiveDataFeed::getInstance()
+{
+    QMutexLocker locker(&mutex);
+    if (!instance) {
+        instance = new LiveDataFeed();
+    }
+    return instance;
+}
+
+bool LiveDataFeed::start(const QString& name, int capacity, QString* error)
+{
+    QMutexLocker locker(&m_writeMutex);
+    if (m_mapping) {
+        unmapLocked();
+    }
+
+    const quint32 recordCount = roundUpPowerOfTwo(qMax(capacity, 2));
+    const size_t size = sizeof(LiveFeed::LiveFeedHeader) + size_t(recordCount) * sizeof(LiveFeed::LiveFeedRecord);
+    QString failure;
+
+#ifdef Q_OS_WIN
+    const QString mappingName = QStringLiteral("Local\\") + name;
+    HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       DWORD(quint64(size) >> 32), DWORD(size & 0xFFFFFFFFu),
+                                       reinterpret_cast<LPCWSTR>(mappingName.utf16()));
+    void* mapping = nullptr;
+    if (!handle) {
+        failure = QString("CreateFileMapping 失败，错误码 %1").arg(GetLastError());
+    } else if (!(mapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size))) {
+        failure = QString("MapViewOfFile 失败，错误码 %1").arg(GetLastError());
+        CloseHandle(handle);
+    } else {
+        m_handle = quintptr(handle);
+    }
+#elif defined(Q_OS_UNIX)
+    // 上次异常退出留下的同名对象直接复用：仍映射着它的读取方会看到 sessionEpochMs 变化
+    const QByteArray shmName = '/' + name.toUtf8();
+    void* mapping = nullptr;
+    const int fd = shm_open(shmName.constData(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        failure = QString("shm_open 失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+    } else {
+        if (ftruncate(fd, off_t(size)) != 0) {
+            failure = QString("ftruncate 失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        } else {
+            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                failure = QString("mmap 失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+            }
+        }
+        close(fd);  // 映射建立后不再需要描述符
+    }
+#else
+    void* mapping = nullptr;
+    failure = "当前平台不支持共享内存发布";
+#endif
+
+    if (!mapping) {
+        const QString message = QString("实时数据共享内存 %1 创建失败: %2").arg(name, failure);
+        LogManager::getInstance()->warning(message, "LiveDataFeed");
+        if (error) *error = message;
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_mappingSize = size;
+    m_name = name;
+    m_header = static_cast<LiveFeed::LiveFeedHeader*>(mapping);
+    m_records = reinterpret_cast<LiveFeed::LiveFeedRecord*>(static_cast<char*>(mapping) + sizeof(LiveFeed::LiveFeedHeader));
+    m_mask = recordCount - 1;
+    m_sequence = 0;
+
+    // 先置为停止并清空记录，最后发布 Running，读取方不会看到半初始化的头部
+    m_header->state.store(LiveFeed::Stopped, std::memory_order_relaxed);
+    m_header->writeSequence.store(0, std::memory_order_relaxed);
+    memset(static_cast<void*>(m_records), 0, size - sizeof(LiveFeed::LiveFeedHeader));
+    m_header->magic = LiveFeed::MAGIC;
+    m_header->version = LiveFeed::VERSION;
+    m_header->headerSize = sizeof(LiveFeed::LiveFeedHeader);
+    m_header->recordSize = sizeof(LiveFeed::LiveFeedRecord);
+    m_header->capacity = recordCount;
+    m_header->sessionEpochMs = MonotonicClock::epochMs();
+    m_header->producerPid = quint32(QCoreApplication::applicationPid());
+    memset(m_header->reserved, 0, sizeof(m_header->reserved));
+    m_header->state.store(LiveFeed::Running, std::memory_order_release);
+    m_running.store(true, std::memory_order_release);
+
+    LogManager::getInstance()->info(
+        QString("实时数据共享内存已创建: %1，%2 条记录").arg(name).arg(recordCount), "LiveDataFeed");
+    return true;
+}
+
+void LiveDataFeed::stop()
+{
+    QMutexLocker locker(&m_writeMutex);
+    if (m_mapping) {
+        unmapLocked();
+        LogManager::getInstance()->info(QString("实时数据共享内存已关闭: %1").arg(m_name), "LiveDataFeed");
+    }
+}
+
+void LiveDataFeed::unmapLocked()
+{
+    m_running.store(false, std::memory_order_release);
+    m_header->state.store(LiveFeed::Stopped, std::memory_order_release);
+
+#ifdef Q_OS_WIN
+    UnmapViewOfFile(m_mapping);
+    CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#elif defined(Q_OS_UNIX)
+    munmap(m_mapping, m_mappingSize);
+    // 删除名称后新的读取方打不开，已映射的读取方仍能读到 Stopped 和剩余数据
+    shm_unlink(('/' + m_name.toUtf8()).constData());
+#endif
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_handle = 0;
+    m_header = nullptr;
+    m_records = nullptr;
+}
+
+bool LiveDataFeed::isRunning() const
+{
+    return m_running.load(std::memory_order_acquire);
+}
+
+QString LiveDataFeed::name() const
+{
+    QMutexLocker locker(&m_writeMutex);
+    return m_name;
+}
+
+quint64 LiveDataFeed::publishedCount() const
+{
+    QMutexLocker locker(&m_writeMutex);
+    return m_sequence;
+}
+
+bool LiveDataFeed::readRecord(quint64 sequence, LiveFeed::LiveFeedRecord& record) const
+{
+    QMutexLocker locker(&m_writeMutex);
+    if (!m_records || sequence >= m_sequence || m_sequence - sequence > quint64(m_mask) + 1) {
+        return false;
+    }
+    // 持有写锁时槽位不会被改写，直接按数据字段复制
+    const LiveFeed::LiveFeedRecord& slot = m_records[sequence & m_mask];
+    record.lock.store(slot.lock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    memcpy(reinterpret_cast<char*>(&record) + RECORD_PAYLOAD_OFFSET,
+           reinterpret_cast<const char*>(&slot) + RECORD_PAYLOAD_OFFSET,
+           sizeof(record) - RECORD_PAYLOAD_OFFSET);
+    return true;
+}
+
+void LiveDataFeed::publishFrame(const ProtocolFrame& frame)
+{
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    QMutexLocker locker(&m_writeMutex);
+    if (m_records) {
+        writeLocked(frame);
+        m_header->writeSequence.store(m_sequence, std::memory_order_release);
+    }
+}
+
+void LiveDataFeed::publishFrames(const FrameBatch& frames)
+{
+    if (frames.isEmpty() || !m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    QMutexLocker locker(&m_writeMutex);
+    if (!m_records) {
+        return;
+    }
+    for (const ProtocolFrame& frame : frames) {
+        writeLocked(frame);
+    }
+    // 一批只在最后发布一次写序号，读取方逐条检查顺序锁，不受影响
+    m_header->writeSequence.store(m_sequence, std::memory_order_release);
+}
+
+bool LiveDataFeed::decodeFrame(const ProtocolFrame& frame, LiveFeed::LiveFeedRecord& record)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(frame.data);
+    switch (frame.command) {
+    case ProtocolCommand::ReadSensorData:
+        if (frame.dataLength < SENSOR_FRAME_MIN_LENGTH) {
+            return false;
+        }
+        record.kind = LiveFeed::SensorSample;
+        for (int i = 0; i < 7; ++i) {
+            record.values[i] = qFromLittleEndian<float>(data + i * sizeof(float));
+        }
+        record.status = data[SENSOR_STATUS_OFFSET];
+        return true;
+    case ProtocolCommand::MoveToPosition:
+        // 轨迹流式下发的应答数据长度不同，不是运动采样
+        if (frame.dataLength != Device::MOTION_DATA_SIZE) {
+            return false;
+        }
+        record.kind = LiveFeed::MotionSample;
+        for (int i = 0; i < 4; ++i) {
+            record.values[i] = nativeFloat(frame.data + i * sizeof(float));
+        }
+        return true;
+    case ProtocolCommand::SetGlueParameters:
+        if (frame.dataLength != Device::GLUE_DATA_SIZE) {
+            return false;
+        }
+        record.kind = LiveFeed::GlueSample;
+        for (int i = 0; i < 3; ++i) {
+            record.values[i] = nativeFloat(frame.data + i * sizeof(float));
+        }
+        record.aux = qint32(qFromBigEndian<quint32>(data + 3 * sizeof(float)));
+        return true;
+    default:
+        return false;
+    }
+}
+
+void LiveDataFeed::writeLocked(const ProtocolFrame& frame)
+{
+    LiveFeed::LiveFeedRecord record;
+    memset(static_cast<void*>(&record), 0, sizeof(record));
+    if (!decodeFrame(frame, record)) {
+        return;
+    }
+    record.monotonicNs = frame.timestampNs > 0 ? frame.timestampNs : ProtocolFrame::currentTimestampNs();
+    record.epochMs = MonotonicClock::toEpochMs(record.monotonicNs);
+
+    const quint64 sequence = m_sequence++;
+    LiveFeed::LiveFeedRecord& slot = m_records[sequence & m_mask];
+    slot.lock.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(reinterpret_cast<char*>(&slot) + RECORD_PAYLOAD_OFFSET,
+           reinterpret_cast<const char*>(&record) + RECORD_PAYLOAD_OFFSET,
+           sizeof(record) - RECORD_PAYLOAD_OFFSET);
+    slot.lock.store(2 * sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QObject>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include "livedatafeedlayout.h"
+#include "protocolparser.h"
+
+// 实时数据共享内存发布 - 把解析后的传感器、运动和点胶采样写入共享内存环形区，供外部程序（数据采集、
+// 视觉、MES 网关等）在同一台机器上直接读取，布局和读取方法见 livedatafeedlayout.h。
+//
+// 在接收线程中以直接连接调用 publishFrame()/publishFrames()：每条记录只做一次解码和 64 字节的写入，
+// 不分配内存、不发信号。多个接收线程同时发布时在写入侧串行化，读取方永远不加锁，也不会拖慢写入方。
+// 未启动时 publish 只检查一个原子标志。可在任意线程调用。
+class LiveDataFeed : public QObject
+{
+    Q_OBJECT
+
+public:
+    static LiveDataFeed* getInstance();
+
+    // capacity 向上取整为 2 的幂；已启动时先停止再按新参数创建
+    bool start(const QString& name, int capacity, QString* error = nullptr);
+    void stop();
+    bool isRunning() const;
+    QString name() const;
+
+    quint64 publishedCount() const;
+
+    // 读取第 sequence 条记录（从 0 开始），已被覆盖或尚未写入时返回 false；供进程内诊断和测试使用
+    bool readRecord(quint64 sequence, LiveFeed::LiveFeedRecord& record) const;
+
+public slots:
+    void publishFrame(const ProtocolFrame& frame);
+    void publishFrames(const FrameBatch& frames);
+
+private:
+    LiveDataFeed();
+    ~LiveDataFeed();
+
+    // 解码为记录的数据字段，不是采样帧时返回 false
+    static bool decodeFrame(const ProtocolFrame& frame, LiveFeed::LiveFeedRecord& record);
+
+    // 以下在持有 m_writeMutex 时调用；writeLocked 不发布写序号，由调用方在一次或一批写完后发布
+    void writeLocked(const ProtocolFrame& frame);
+    void unmapLocked();
+
+    mutable QMutex m_writeMutex;
+    std::atomic<bool> m_running;
+    QString m_name;
+    void* m_mapping;                        // 映射起始地址
+    size_t m_mappingSize;
+    quintptr m_handle;                      // Windows 文件映射句柄
+    LiveFeed::LiveFeedHeader* m_header;
+    LiveFeed::LiveFeedRecord* m_records;
+    quint32 m_mask;
+    quint64 m_sequence;                     // 下一条记录的序号
+
+    static LiveDataFeed* instance;
+    static QMutex mutex;
+};
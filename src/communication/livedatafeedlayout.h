@@ -0,0 +1,72 @@
+#pragma once
+
+// 实时数据共享内存的二进制布局 - 不依赖 Qt，外部读取程序可以直接包含本文件
+//
+// 共享内存名：Windows 为命名文件映射 "Local\<名称>"，Linux 为 POSIX 共享内存 "/<名称>"（shm_open），
+// 名称默认 GlueDispenseLiveFeed（配置 liveDataFeed/name）。上位机启动时创建，退出时 state 置 0 并删除名称，
+// 已映射的读取方仍可读完剩余数据；上位机重启后 sessionEpochMs 变化，读取方据此重新映射。
+//
+// 内存 = LiveFeedHeader（64 字节）+ capacity 个 LiveFeedRecord（各 64 字节），全部小端序。
+// 写入方只有一个（上位机内部串行化），读取方任意多个且互不影响，写入方从不等待读取方：
+//
+//   写第 n 条记录（从 0 开始）到 records[n & (capacity-1)]：
+//     lock = 2n+1（写入中）→ 写数据字段 → lock = 2n+2（release）→ header.writeSequence = n+1（release）
+//
+//   读取方保存下一条要读的序号 r：
+//     w = writeSequence（acquire）；r == w 表示没有新数据；w < r 表示写入方已重启，从 r = 0 重新开始；
+//     w - r > capacity 时已被覆盖，跳到 r = w - capacity
+//     s1 = lock（acquire）；s1 != 2r+2 表示该槽位已被覆盖或正在覆盖，跳过本条
+//     复制数据字段 → atomic_thread_fence(acquire) → s2 = lock；s2 != s1 表示读取期间被覆盖，丢弃本条
+//     r = r + 1
+//
+// 记录就地可读，不需要经过任何复制或系统调用；读取方来不及时只会丢失最旧的记录，不会影响写入方。
+
+#include <atomic>
+#include <cstdint>
+
+namespace LiveFeed {
+
+constexpr uint32_t MAGIC = 0x46444C47;          // "GLDF"
+constexpr uint16_t VERSION = 1;
+constexpr const char* DEFAULT_NAME = "GlueDispenseLiveFeed";
+
+enum RecordKind : uint16_t {
+    SensorSample = 1,   // values: X, Y, Z, 速度, 压力, 温度, 胶量；status 为设备状态
+    MotionSample = 2,   // values: X, Y, Z, 速度
+    GlueSample = 3      // values: 胶量, 压力, 温度；aux 为点胶时间(ms)
+};
+
+enum ProducerState : uint32_t {
+    Stopped = 0,
+    Running = 1
+};
+
+struct alignas(64) LiveFeedHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;                        // sizeof(LiveFeedHeader)
+    uint32_t recordSize;                        // sizeof(LiveFeedRecord)
+    uint32_t capacity;                          // 记录数，2 的幂
+    std::atomic<uint64_t> writeSequence;        // 已写完的记录总数
+    int64_t sessionEpochMs;                     // 本次创建的时间（自 1970 年起的毫秒）
+    uint32_t producerPid;
+    std::atomic<uint32_t> state;                // ProducerState
+    uint8_t reserved[24];
+};
+
+struct alignas(64) LiveFeedRecord {
+    std::atomic<uint64_t> lock;                 // 顺序锁：奇数为写入中，2n+2 为第 n 条记录已写完
+    uint16_t kind;                              // RecordKind
+    uint8_t status;
+    uint8_t reserved;
+    int32_t aux;
+    int64_t monotonicNs;                        // 上位机单调时钟，帧校验通过的时刻
+    int64_t epochMs;                            // 同一时刻的墙钟时间
+    float values[8];                            // 未使用的为 0
+};
+
+static_assert(sizeof(LiveFeedHeader) == 64, "LiveFeedHeader 布局已变化");
+static_assert(sizeof(LiveFeedRecord) == 64, "LiveFeedRecord 布局已变化");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "共享内存中的原子量必须是无锁的");
+
+}
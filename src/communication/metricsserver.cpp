@@ -0,0 +1,158 @@
+#include "metricsserver.h"
+#include "../constants.h"
+#include "../logger/logmanager.h"
+#include "../utils/metricsregistry.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+
+namespace {
+
+struct PendingRequest {
+    QByteArray header;
+    bool answered = false;
+};
+
+}
+
+MetricsServer::MetricsServer(QObject* parent)
+    : QObject(parent)
+    , m_thread(nullptr)
+    , m_server(nullptr)
+    , m_port(0)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+bool MetricsServer::start(const QHostAddress& address, quint16 port, QString* error)
+{
+    if (m_thread) {
+        return true;
+    }
+
+    m_thread = new QThread();
+    m_thread->setObjectName("MetricsServer");
+    m_server = new QTcpServer();
+    m_server->moveToThread(m_thread);
+    m_thread->start();
+
+    bool listening = false;
+    QString listenError;
+    QMetaObject::invokeMethod(m_server, [this, address, port, &listening, &listenError]() {
+        listening = m_server->listen(address, port);
+        if (!listening) {
+            listenError = m_server->errorString();
+            return;
+        }
+        m_port = m_server->serverPort();
+        connect(m_server, &QTcpServer::newConnection, m_server, [this]() { acceptConnections(); });
+    }, Qt::BlockingQueuedConnection);
+
+    if (!listening) {
+        const QString message = QString("指标端点无法监听 %1:%2: %3").arg(address.toString()).arg(port).arg(listenError);
+        LogManager::getInstance()->warning(message, "MetricsServer");
+        if (error) *error = message;
+        stop();
+        return false;
+    }
+
+    LogManager::getInstance()->info(
+        QString("指标端点已启动: http://%1:%2/metrics").arg(address.toString()).arg(m_port), "MetricsServer");
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+    // 监听对象和未结束的连接（其子对象）在所属线程中释放
+    QMetaObject::invokeMethod(m_server, [this]() {
+        m_server->close();
+        delete m_server;
+    }, Qt::BlockingQueuedConnection);
+    m_server = nullptr;
+    m_port = 0;
+
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+bool MetricsServer::isRunning() const
+{
+    return m_thread != nullptr;
+}
+
+quint16 MetricsServer::serverPort() const
+{
+    return m_port;
+}
+
+void MetricsServer::acceptConnections()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        auto request = std::make_shared<PendingRequest>();
+        connect(socket, &QTcpSocket::readyRead, socket, [this, socket, request]() {
+            if (request->answered) {
+                socket->readAll();
+                return;
+            }
+            request->header.append(socket->readAll());
+            if (request->header.contains("\r\n\r\n")) {
+                request->answered = true;
+                handleRequest(socket, request->header);
+            } else if (request->header.size() > Communication::METRICS_REQUEST_MAX_BYTES) {
+                socket->abort();
+            }
+        });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        // 收不齐请求头的连接不占着不放
+        QTimer::singleShot(Communication::METRICS_REQUEST_TIMEOUT, socket, [socket, request]() {
+            if (!request->answered) {
+                socket->abort();
+            }
+        });
+    }
+}
+
+void MetricsServer::handleRequest(QTcpSocket* socket, const QByteArray& header)
+{
+    // 只看请求行："GET /metrics?x=y HTTP/1.1"
+    const QList<QByteArray> requestLine = header.left(header.indexOf("\r\n")).split(' ');
+    const QByteArray method = requestLine.value(0);
+    QByteArray path = requestLine.value(1);
+    const int query = path.indexOf('?');
+    if (query >= 0) {
+        path.truncate(query);
+    }
+
+    if (method != "GET") {
+        writeResponse(socket, "405 Method Not Allowed", "text/plain; charset=utf-8", "Method Not Allowed\n");
+    } else if (path != "/metrics") {
+        writeResponse(socket, "404 Not Found", "text/plain; charset=utf-8", "Not Found\n");
+    } else {
+        writeResponse(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8", MetricsRegistry::render());
+    }
+    socket->disconnectFromHost();
+}
+
+void MetricsServer::writeResponse(QTcpSocket* socket, const char* status, const QByteArray& contentType,
+                                  const QByteArray& body)
+{
+    QByteArray response;
+    response.reserve(body.size() + 128);
+    response.append("HTTP/1.1 ").append(status).append("\r\n");
+    response.append("Content-Type: ").append(contentType).append("\r\n");
+    response.append("Content-Length: ").append(QByteArray::number(body.size())).append("\r\n");
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+    socket->write(response);
+}
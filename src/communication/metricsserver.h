@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QHostAddress>
+#include <QObject>
+#include <QString>
+
+class QTcpServer;
+class QTcpSocket;
+class QThread;
+
+// 指标端点 - 只读的极简 HTTP 服务，GET /metrics 返回 MetricsRegistry::render() 的 Prometheus 文本。
+// 监听和应答都在自己的线程中进行，抓取只读取指标原子量，不经过界面线程，也不和热路径争锁。
+// 每个连接只处理一个请求，应答后关闭；请求头超过 Communication::METRICS_REQUEST_MAX_BYTES
+// 或 Communication::METRICS_REQUEST_TIMEOUT 内未收齐时直接断开
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject* parent = nullptr);
+    ~MetricsServer();
+
+    bool start(const QHostAddress& address, quint16 port, QString* error = nullptr);
+    void stop();
+    bool isRunning() const;
+    quint16 serverPort() const;
+
+private:
+    void acceptConnections();
+    void handleRequest(QTcpSocket* socket, const QByteArray& header);
+    static void writeResponse(QTcpSocket* socket, const char* status, const QByteArray& contentType,
+                              const QByteArray& body);
+
+    QThread* m_thread;
+    QTcpServer* m_server;               // 属于 m_thread
+    quint16 m_port;
+};
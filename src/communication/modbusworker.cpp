@@ -1,11 +1,556 @@
 #include "modbusworker.h"
+#include "logger/logmanager.h"
+#include <QModbusRtuSerialClient>
+#include <QModbusTcpClient>
+#include <QDateTime>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 
-ModbusWorker::ModbusWorker(QObject* parent) : QObject(parent)
+int ModbusPoint::registerCount() const
 {
-    // 占位符实现
+    if (registerType == ModbusRegisterType::Coil || registerType == ModbusRegisterType::DiscreteInput) {
+        return 1;
+    }
+    switch (valueType) {
+    case ModbusValueType::UInt32:
+    case ModbusValueType::Int32:
+    case ModbusValueType::Float32:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+// ModbusBlockPlanner 实现
+int ModbusBlockPlanner::maxBlockLength(ModbusRegisterType type)
+{
+    if (type == ModbusRegisterType::Coil || type == ModbusRegisterType::DiscreteInput) {
+        return Communication::MODBUS_MAX_READ_BITS;
+    }
+    return Communication::MODBUS_MAX_READ_REGISTERS;
+}
+
+QList<ModbusReadBlock> ModbusBlockPlanner::plan(const QList<ModbusPoint>& points, int maxGap)
+{
+    QList<int> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&points](int a, int b) {
+        const ModbusPoint& pa = points.at(a);
+        const ModbusPoint& pb = points.at(b);
+        if (pa.groupId != pb.groupId) return pa.groupId < pb.groupId;
+        if (pa.registerType != pb.registerType) return pa.registerType < pb.registerType;
+        return pa.address < pb.address;
+    });
+
+    QList<ModbusReadBlock> blocks;
+    for (int index : order) {
+        const ModbusPoint& point = points.at(index);
+        const int pointEnd = point.address + point.registerCount();
+
+        if (!blocks.isEmpty()) {
+            ModbusReadBlock& block = blocks.last();
+            const int blockEnd = block.startAddress + block.count;
+            // 位区按字节打包，空洞容忍度按16倍换算，使两类区的报文开销相当
+            const bool bitArea = point.registerType == ModbusRegisterType::Coil
+                              || point.registerType == ModbusRegisterType::DiscreteInput;
+            const int gapLimit = bitArea ? maxGap * 16 : maxGap;
+            const int mergedEnd = qMax(blockEnd, pointEnd);
+
+            if (block.groupId == point.groupId && block.registerType == point.registerType
+                && point.address - blockEnd <= gapLimit
+                && mergedEnd - block.startAddress <= maxBlockLength(point.registerType)) {
+                block.count = mergedEnd - block.startAddress;
+                block.pointIndices.append(index);
+                continue;
+            }
+        }
+
+        ModbusReadBlock block;
+        block.registerType = point.registerType;
+        block.groupId = point.groupId;
+        block.startAddress = point.address;
+        block.count = point.registerCount();
+        block.pointIndices.append(index);
+        blocks.append(block);
+    }
+
+    return blocks;
+}
+
+// ModbusValueCache 实现
+void ModbusValueCache::resize(int pointCount)
+{
+    QWriteLocker locker(&m_lock);
+    m_entries = QList<Entry>(pointCount);
+}
+
+void ModbusValueCache::update(int pointIndex, const QVariant& value, qint64 timestampMs)
+{
+    QWriteLocker locker(&m_lock);
+    if (pointIndex < 0 || pointIndex >= m_entries.size()) {
+        return;
+    }
+    Entry& entry = m_entries[pointIndex];
+    entry.value = value;
+    entry.timestampMs = timestampMs;
+    entry.updateCount++;
+    entry.valid = true;
+}
+
+void ModbusValueCache::invalidate(int pointIndex)
+{
+    QWriteLocker locker(&m_lock);
+    if (pointIndex >= 0 && pointIndex < m_entries.size()) {
+        m_entries[pointIndex].valid = false;
+    }
+}
+
+ModbusValueCache::Entry ModbusValueCache::entry(int pointIndex) const
+{
+    QReadLocker locker(&m_lock);
+    if (pointIndex < 0 || pointIndex >= m_entries.size()) {
+        return Entry();
+    }
+    return m_entries.at(pointIndex);
+}
+
+QVariant ModbusValueCache::value(int pointIndex) const
+{
+    QReadLocker locker(&m_lock);
+    if (pointIndex < 0 || pointIndex >= m_entries.size() || !m_entries.at(pointIndex).valid) {
+        return QVariant();
+    }
+    return m_entries.at(pointIndex).value;
+}
+
+int ModbusValueCache::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_entries.size();
+}
+
+// ModbusWorker 实现
+ModbusWorker::ModbusWorker(QObject* parent)
+    : QObject(parent)
+    , m_client(nullptr)
+    , m_transport(Transport::Tcp)
+    , m_serverAddress(1)
+    , m_timeout(Communication::MODBUS_REQUEST_TIMEOUT)
+    , m_retries(Communication::MAX_SEND_RETRIES)
+    , m_tcpPipelineDepth(Communication::MODBUS_TCP_PIPELINE_DEPTH)
+    , m_gapTolerance(Communication::MODBUS_GAP_TOLERANCE)
+    , m_nextGroupId(0)
+    , m_planGeneration(0)
+    , m_polling(false)
+    , m_requestCount(0)
+    , m_errorCount(0)
+{
+    // 默认轮询组，未指定组的点位归入此组
+    addPollGroup("默认");
 }
 
 ModbusWorker::~ModbusWorker()
 {
-    // 占位符实现
-} 
\ No newline at end of file
+    stopPolling();
+    disconnectDevice();
+}
+
+bool ModbusWorker::connectRtu(const QString& portName, int baudRate, QSerialPort::Parity parity,
+                              int dataBits, int stopBits)
+{
+    createClient(Transport::Rtu);
+    m_client->setConnectionParameter(QModbusDevice::SerialPortNameParameter, portName);
+    m_client->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, baudRate);
+    m_client->setConnectionParameter(QModbusDevice::SerialParityParameter, parity);
+    m_client->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, dataBits);
+    m_client->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, stopBits);
+    return connectClient();
+}
+
+bool ModbusWorker::connectTcp(const QString& host, quint16 port)
+{
+    createClient(Transport::Tcp);
+    m_client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, host);
+    m_client->setConnectionParameter(QModbusDevice::NetworkPortParameter, port);
+    return connectClient();
+}
+
+void ModbusWorker::createClient(Transport transport)
+{
+    disconnectDevice();
+
+    m_transport = transport;
+    if (transport == Transport::Rtu) {
+        m_client = new QModbusRtuSerialClient(this);
+    } else {
+        m_client = new QModbusTcpClient(this);
+    }
+    m_client->setTimeout(m_timeout);
+    m_client->setNumberOfRetries(m_retries);
+
+    connect(m_client, &QModbusDevice::stateChanged, this, &ModbusWorker::onStateChanged);
+    connect(m_client, &QModbusDevice::errorOccurred, this, &ModbusWorker::onErrorOccurred);
+}
+
+bool ModbusWorker::connectClient()
+{
+    if (!m_client->connectDevice()) {
+        const QString error = m_client->errorString();
+        LogManager::getInstance()->error(QString("Modbus连接失败: %1").arg(error), "ModbusWorker");
+        emit errorOccurred(error);
+        return false;
+    }
+    return true;
+}
+
+void ModbusWorker::disconnectDevice()
+{
+    if (!m_client) {
+        return;
+    }
+
+    // 在途应答随客户端一起销毁，不再回调
+    resetRequests();
+
+    m_client->disconnect(this);
+    m_client->disconnectDevice();
+    m_client->deleteLater();
+    m_client = nullptr;
+
+    emit disconnected();
+}
+
+bool ModbusWorker::isConnected() const
+{
+    return m_client && m_client->state() == QModbusDevice::ConnectedState;
+}
+
+void ModbusWorker::setTimeout(int timeoutMs)
+{
+    m_timeout = timeoutMs;
+    if (m_client) {
+        m_client->setTimeout(timeoutMs);
+    }
+}
+
+void ModbusWorker::setNumberOfRetries(int retries)
+{
+    m_retries = retries;
+    if (m_client) {
+        m_client->setNumberOfRetries(retries);
+    }
+}
+
+void ModbusWorker::setPipelineDepth(int depth)
+{
+    m_tcpPipelineDepth = qMax(1, depth);
+    dispatchRequests();
+}
+
+int ModbusWorker::pipelineDepth() const
+{
+    return m_transport == Transport::Rtu ? 1 : m_tcpPipelineDepth;
+}
+
+int ModbusWorker::addPollGroup(const QString& name, int intervalMs)
+{
+    const int groupId = m_nextGroupId++;
+
+    PollGroup group;
+    group.name = name;
+    group.intervalMs = qMax(1, intervalMs);
+    group.timer = new QTimer(this);
+    group.timer->setInterval(group.intervalMs);
+    connect(group.timer, &QTimer::timeout, this, [this, groupId]() { enqueueGroup(groupId); });
+    m_groups.insert(groupId, group);
+
+    if (m_polling && isConnected()) {
+        group.timer->start();
+    }
+    return groupId;
+}
+
+bool ModbusWorker::setPollInterval(int groupId, int intervalMs)
+{
+    auto it = m_groups.find(groupId);
+    if (it == m_groups.end()) {
+        return false;
+    }
+    it->intervalMs = qMax(1, intervalMs);
+    it->timer->setInterval(it->intervalMs);
+    return true;
+}
+
+int ModbusWorker::addPoint(const ModbusPoint& point)
+{
+    if (!m_groups.contains(point.groupId)) {
+        LogManager::getInstance()->warning(
+            QString("点位 %1 的轮询组 %2 不存在").arg(point.name).arg(point.groupId), "ModbusWorker");
+        return -1;
+    }
+    if (m_pointIndexByName.contains(point.name)) {
+        LogManager::getInstance()->warning(QString("点位名称重复: %1").arg(point.name), "ModbusWorker");
+        return -1;
+    }
+
+    const int index = m_points.size();
+    m_points.append(point);
+    m_pointIndexByName.insert(point.name, index);
+    rebuildBlocks();
+    return index;
+}
+
+void ModbusWorker::clearPoints()
+{
+    m_points.clear();
+    m_pointIndexByName.clear();
+    rebuildBlocks();
+}
+
+void ModbusWorker::setGapTolerance(int registers)
+{
+    m_gapTolerance = qMax(0, registers);
+    rebuildBlocks();
+}
+
+void ModbusWorker::rebuildBlocks()
+{
+    m_planGeneration++;
+    m_requestQueue.clear();
+    m_blocks = ModbusBlockPlanner::plan(m_points, m_gapTolerance);
+    m_cache.resize(m_points.size());
+
+    for (auto& group : m_groups) {
+        group.blockIndices.clear();
+    }
+    for (int i = 0; i < m_blocks.size(); ++i) {
+        auto it = m_groups.find(m_blocks.at(i).groupId);
+        if (it != m_groups.end()) {
+            it->blockIndices.append(i);
+        }
+    }
+
+    LogManager::getInstance()->debug(
+        QString("Modbus点表重新规划: %1 个点位合并为 %2 个块读取").arg(m_points.size()).arg(m_blocks.size()),
+        "ModbusWorker");
+}
+
+void ModbusWorker::startPolling()
+{
+    m_polling = true;
+    if (!isConnected()) {
+        return;   // 连接建立后在 onStateChanged 中启动
+    }
+    for (auto it = m_groups.begin(); it != m_groups.end(); ++it) {
+        it->timer->start();
+        enqueueGroup(it.key());
+    }
+}
+
+void ModbusWorker::stopPolling()
+{
+    m_polling = false;
+    for (auto& group : m_groups) {
+        group.timer->stop();
+    }
+}
+
+void ModbusWorker::pollGroupNow(int groupId)
+{
+    enqueueGroup(groupId);
+}
+
+QVariant ModbusWorker::value(const QString& pointName) const
+{
+    return m_cache.value(pointIndex(pointName));
+}
+
+int ModbusWorker::pointIndex(const QString& pointName) const
+{
+    return m_pointIndexByName.value(pointName, -1);
+}
+
+void ModbusWorker::enqueueGroup(int groupId)
+{
+    auto it = m_groups.constFind(groupId);
+    if (it == m_groups.constEnd() || !isConnected()) {
+        return;
+    }
+
+    // 上一轮还未完成的块不重复排队，慢设备上应答跟不上轮询周期时自然降频
+    for (int blockIndex : it->blockIndices) {
+        ModbusReadBlock& block = m_blocks[blockIndex];
+        if (!block.pending) {
+            block.pending = true;
+            m_requestQueue.append(blockIndex);
+        }
+    }
+
+    dispatchRequests();
+}
+
+void ModbusWorker::dispatchRequests()
+{
+    while (isConnected() && m_inFlightReplies.size() < pipelineDepth() && !m_requestQueue.isEmpty()) {
+        const int blockIndex = m_requestQueue.takeFirst();
+        const ModbusReadBlock& block = m_blocks.at(blockIndex);
+
+        const QModbusDataUnit unit(toDataUnitType(block.registerType), block.startAddress,
+                                   static_cast<quint16>(block.count));
+        QModbusReply* reply = m_client->sendReadRequest(unit, m_serverAddress);
+        m_requestCount++;
+
+        if (!reply) {
+            m_errorCount++;
+            m_blocks[blockIndex].pending = false;
+            emit blockReadFailed(block.groupId, block.startAddress, block.count, m_client->errorString());
+            continue;
+        }
+
+        const quint64 generation = m_planGeneration;
+        m_inFlightReplies.insert(reply, blockIndex);
+        if (reply->isFinished()) {
+            handleReply(reply, generation);
+        } else {
+            connect(reply, &QModbusReply::finished, this, [this, reply, generation]() {
+                handleReply(reply, generation);
+            });
+        }
+    }
+}
+
+void ModbusWorker::handleReply(QModbusReply* reply, quint64 generation)
+{
+    reply->deleteLater();
+
+    auto it = m_inFlightReplies.find(reply);
+    if (it == m_inFlightReplies.end()) {
+        return;   // 连接已重置
+    }
+    const int blockIndex = it.value();
+    m_inFlightReplies.erase(it);
+
+    // 点表已重新规划，旧块的应答直接丢弃
+    if (generation != m_planGeneration) {
+        dispatchRequests();
+        return;
+    }
+
+    ModbusReadBlock& block = m_blocks[blockIndex];
+    block.pending = false;
+
+    if (reply->error() == QModbusDevice::NoError) {
+        decodeBlock(block, reply->result(), QDateTime::currentMSecsSinceEpoch());
+        emit valuesUpdated(block.groupId, block.pointIndices);
+    } else {
+        m_errorCount++;
+        for (int pointIndex : block.pointIndices) {
+            m_cache.invalidate(pointIndex);
+        }
+        emit blockReadFailed(block.groupId, block.startAddress, block.count, reply->errorString());
+    }
+
+    dispatchRequests();
+}
+
+void ModbusWorker::resetRequests()
+{
+    for (auto& group : m_groups) {
+        group.timer->stop();
+    }
+    m_requestQueue.clear();
+    m_inFlightReplies.clear();
+    for (auto& block : m_blocks) {
+        block.pending = false;
+    }
+}
+
+void ModbusWorker::decodeBlock(const ModbusReadBlock& block, const QModbusDataUnit& unit, qint64 timestampMs)
+{
+    for (int pointIndex : block.pointIndices) {
+        const ModbusPoint& point = m_points.at(pointIndex);
+        const int offset = point.address - block.startAddress;
+        if (offset < 0 || offset + point.registerCount() > static_cast<int>(unit.valueCount())) {
+            m_cache.invalidate(pointIndex);
+            continue;
+        }
+        m_cache.update(pointIndex, decodePoint(point, unit, offset), timestampMs);
+    }
+}
+
+QVariant ModbusWorker::decodePoint(const ModbusPoint& point, const QModbusDataUnit& unit, int offset) const
+{
+    const quint16 first = unit.value(offset);
+
+    auto scaled = [&point](auto raw) -> QVariant {
+        if (point.scale == 1.0) {
+            return QVariant::fromValue(raw);
+        }
+        return static_cast<double>(raw) * point.scale;
+    };
+
+    switch (point.valueType) {
+    case ModbusValueType::Bool:
+        return first != 0;
+    case ModbusValueType::UInt16:
+        return scaled(first);
+    case ModbusValueType::Int16:
+        return scaled(static_cast<qint16>(first));
+    default:
+        break;
+    }
+
+    const quint16 second = unit.value(offset + 1);
+    const quint32 raw = point.swapWords ? (static_cast<quint32>(second) << 16) | first
+                                        : (static_cast<quint32>(first) << 16) | second;
+    switch (point.valueType) {
+    case ModbusValueType::UInt32:
+        return scaled(raw);
+    case ModbusValueType::Int32:
+        return scaled(static_cast<qint32>(raw));
+    case ModbusValueType::Float32: {
+        float value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return scaled(value);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QModbusDataUnit::RegisterType ModbusWorker::toDataUnitType(ModbusRegisterType type)
+{
+    switch (type) {
+    case ModbusRegisterType::HoldingRegister: return QModbusDataUnit::HoldingRegisters;
+    case ModbusRegisterType::InputRegister:   return QModbusDataUnit::InputRegisters;
+    case ModbusRegisterType::Coil:            return QModbusDataUnit::Coils;
+    case ModbusRegisterType::DiscreteInput:   return QModbusDataUnit::DiscreteInputs;
+    }
+    return QModbusDataUnit::Invalid;
+}
+
+void ModbusWorker::onStateChanged(QModbusDevice::State state)
+{
+    if (state == QModbusDevice::ConnectedState) {
+        LogManager::getInstance()->info(
+            QString("Modbus %1 已连接").arg(m_transport == Transport::Rtu ? "RTU" : "TCP"), "ModbusWorker");
+        emit connected();
+        if (m_polling) {
+            startPolling();
+        }
+    } else if (state == QModbusDevice::UnconnectedState) {
+        resetRequests();
+        emit disconnected();
+    }
+}
+
+void ModbusWorker::onErrorOccurred(QModbusDevice::Error error)
+{
+    if (error == QModbusDevice::NoError || !m_client) {
+        return;
+    }
+    const QString message = m_client->errorString();
+    LogManager::getInstance()->warning(QString("Modbus错误: %1").arg(message), "ModbusWorker");
+    emit errorOccurred(message);
+}
@@ -1,15 +1,203 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
+#include <QList>
+#include <QHash>
+#include <QMap>
+#include <QVariant>
+#include <QReadWriteLock>
+#include <QSerialPort>
+#include <QModbusClient>
+#include <QModbusDataUnit>
+#include <QModbusReply>
+#include "constants.h"
+
+// Modbus寄存器区
+enum class ModbusRegisterType {
+    HoldingRegister,            // 保持寄存器 (功能码03)
+    InputRegister,              // 输入寄存器 (功能码04)
+    Coil,                       // 线圈 (功能码01)
+    DiscreteInput               // 离散输入 (功能码02)
+};
+
+// 点位数据类型（32位类型占两个寄存器，默认高字在前）
+enum class ModbusValueType {
+    Bool,
+    UInt16,
+    Int16,
+    UInt32,
+    Int32,
+    Float32
+};
+
+// 轮询点位定义
+struct ModbusPoint {
+    QString name;               // 点位名称（缓存键）
+    ModbusRegisterType registerType = ModbusRegisterType::HoldingRegister;
+    int address = 0;            // 起始地址
+    ModbusValueType valueType = ModbusValueType::UInt16;
+    int groupId = 0;            // 所属轮询组
+    double scale = 1.0;         // 数值缩放（Bool 类型忽略）
+    bool swapWords = false;     // 32位类型低字在前
+
+    int registerCount() const;
+};
+
+// 合并后的块读取请求
+struct ModbusReadBlock {
+    ModbusRegisterType registerType = ModbusRegisterType::HoldingRegister;
+    int groupId = 0;
+    int startAddress = 0;
+    int count = 0;
+    QList<int> pointIndices;    // 块内点位在点表中的下标
+    bool pending = false;       // 已排队或在途，避免慢速设备上重复排队
+};
+
+// 块读取规划器 - 把同组同区的点位按地址排序后合并为尽量少的块，
+// 相邻点位间空洞不超过 maxGap 且块长度不超过单次PDU上限时合并
+class ModbusBlockPlanner
+{
+public:
+    static QList<ModbusReadBlock> plan(const QList<ModbusPoint>& points,
+                                       int maxGap = Communication::MODBUS_GAP_TOLERANCE);
+    static int maxBlockLength(ModbusRegisterType type);
+
+private:
+    ModbusBlockPlanner() = delete;
+};
+
+// 点位值缓存 - 轮询线程写入，任意线程读取
+class ModbusValueCache
+{
+public:
+    struct Entry {
+        QVariant value;         // 按 ModbusValueType 解码并缩放后的值
+        qint64 timestampMs = 0; // 最近一次更新时间
+        quint32 updateCount = 0;
+        bool valid = false;     // 最近一次读取是否成功
+    };
+
+    void resize(int pointCount);
+    void update(int pointIndex, const QVariant& value, qint64 timestampMs);
+    void invalidate(int pointIndex);
+    Entry entry(int pointIndex) const;
+    QVariant value(int pointIndex) const;
+    int size() const;
+
+private:
+    mutable QReadWriteLock m_lock;
+    QList<Entry> m_entries;
+};
 
 class ModbusWorker : public QObject
 {
     Q_OBJECT
 
 public:
+    enum class Transport {
+        Rtu,
+        Tcp
+    };
+
     explicit ModbusWorker(QObject* parent = nullptr);
     ~ModbusWorker();
 
+    // 连接管理
+    bool connectRtu(const QString& portName, int baudRate = Communication::DEFAULT_BAUD_RATE,
+                    QSerialPort::Parity parity = QSerialPort::NoParity,
+                    int dataBits = Communication::DEFAULT_DATA_BITS,
+                    int stopBits = Communication::DEFAULT_STOP_BITS);
+    bool connectTcp(const QString& host, quint16 port = Communication::DEFAULT_TCP_PORT);
+    void disconnectDevice();
+    bool isConnected() const;
+    Transport transport() const { return m_transport; }
+
+    void setServerAddress(int serverAddress) { m_serverAddress = serverAddress; }
+    int serverAddress() const { return m_serverAddress; }
+    void setTimeout(int timeoutMs);
+    void setNumberOfRetries(int retries);
+
+    // 在途请求上限：RTU 总线只能一问一答，固定为1；TCP 按事务ID并行
+    void setPipelineDepth(int depth);
+    int pipelineDepth() const;
+
+    // 点表与轮询组（修改后自动重新规划）
+    int addPollGroup(const QString& name, int intervalMs = Communication::MODBUS_DEFAULT_POLL_INTERVAL);
+    bool setPollInterval(int groupId, int intervalMs);
+    int addPoint(const ModbusPoint& point);
+    void clearPoints();
+    void setGapTolerance(int registers);
+    int gapTolerance() const { return m_gapTolerance; }
+
+    // 轮询控制
+    void startPolling();
+    void stopPolling();
+    bool isPolling() const { return m_polling; }
+    void pollGroupNow(int groupId);
+
+    // 缓存读取
+    const ModbusValueCache& cache() const { return m_cache; }
+    QVariant value(const QString& pointName) const;
+    int pointIndex(const QString& pointName) const;
+    QList<ModbusPoint> points() const { return m_points; }
+    QList<ModbusReadBlock> readBlocks() const { return m_blocks; }
+
+    // 统计
+    qint64 getRequestCount() const { return m_requestCount; }
+    qint64 getErrorCount() const { return m_errorCount; }
+    int inFlightCount() const { return m_inFlightReplies.size(); }
+    int pendingCount() const { return m_requestQueue.size(); }
+
+signals:
+    void connected();
+    void disconnected();
+    void errorOccurred(const QString& error);
+    void valuesUpdated(int groupId, const QList<int>& pointIndices);   // 每个块读取完成发出一次
+    void blockReadFailed(int groupId, int startAddress, int count, const QString& error);
+
+private slots:
+    void onStateChanged(QModbusDevice::State state);
+    void onErrorOccurred(QModbusDevice::Error error);
+
 private:
-    // 占位符实现
-}; 
\ No newline at end of file
+    struct PollGroup {
+        QString name;
+        int intervalMs;
+        QTimer* timer;
+        QList<int> blockIndices;
+    };
+
+    bool connectClient();
+    void createClient(Transport transport);
+    void rebuildBlocks();
+    void enqueueGroup(int groupId);
+    void dispatchRequests();
+    void handleReply(QModbusReply* reply, quint64 generation);
+    void resetRequests();
+    void decodeBlock(const ModbusReadBlock& block, const QModbusDataUnit& unit, qint64 timestampMs);
+    QVariant decodePoint(const ModbusPoint& point, const QModbusDataUnit& unit, int offset) const;
+    static QModbusDataUnit::RegisterType toDataUnitType(ModbusRegisterType type);
+
+    QModbusClient* m_client;
+    Transport m_transport;
+    int m_serverAddress;
+    int m_timeout;
+    int m_retries;
+    int m_tcpPipelineDepth;
+    int m_gapTolerance;
+
+    QList<ModbusPoint> m_points;
+    QHash<QString, int> m_pointIndexByName;
+    QMap<int, PollGroup> m_groups;
+    int m_nextGroupId;
+    QList<ModbusReadBlock> m_blocks;
+    QList<int> m_requestQueue;   // 待发送块下标（FIFO）
+    QHash<QModbusReply*, int> m_inFlightReplies;   // 在途应答 -> 块下标
+    quint64 m_planGeneration;    // 点表变化后丢弃旧规划的在途应答
+    bool m_polling;
+
+    ModbusValueCache m_cache;
+    qint64 m_requestCount;
+    qint64 m_errorCount;
+};
@@ -0,0 +1,346 @@
+#include "parametersync.h"
+#include "logger/logmanager.h"
+#include "utils/crcengine.h"
+#include <QList>
+#include <QPair>
+#include <QPointer>
+#include <QtEndian>
+
+namespace {
+constexpr quint8 READ_FLAG_SHADOW_VALID = 0x01;
+constexpr int READ_RESPONSE_HEADER_SIZE = 6;    // 设备哈希(4) + 参数总数(2)
+}
+
+ParameterSynchronizer::ParameterSynchronizer(CommandPipeline* pipeline, QObject* parent)
+    : QObject(parent)
+    , m_pipeline(pipeline)
+    , m_shadowValid(false)
+    , m_version(0)
+    , m_confirmedHash(0)
+    , m_pushFrames(0)
+    , m_pushOutstanding(0)
+    , m_pushChanged(0)
+    , m_pushFailed(false)
+    , m_pushHashValid(false)
+    , m_pushDeviceHash(0)
+    , m_reading(false)
+{
+}
+
+void ParameterSynchronizer::setParameter(const QString& name, const QVariant& value)
+{
+    m_desired.insert(name, value);
+}
+
+void ParameterSynchronizer::setParameters(const QVariantMap& parameters)
+{
+    for (auto it = parameters.constBegin(); it != parameters.constEnd(); ++it) {
+        m_desired.insert(it.key(), it.value());
+    }
+}
+
+QVariant ParameterSynchronizer::parameter(const QString& name) const
+{
+    return m_desired.value(name);
+}
+
+QVariantMap ParameterSynchronizer::parameters() const
+{
+    return m_desired;
+}
+
+QStringList ParameterSynchronizer::pendingChanges() const
+{
+    QStringList names;
+    for (auto it = m_desired.constBegin(); it != m_desired.constEnd(); ++it) {
+        auto confirmed = m_confirmed.constFind(it.key());
+        if (confirmed == m_confirmed.constEnd() || confirmed.value() != it.value()) {
+            names.append(it.key());
+        }
+    }
+    return names;
+}
+
+bool ParameterSynchronizer::hasPendingChanges() const
+{
+    return !pendingChanges().isEmpty();
+}
+
+bool ParameterSynchronizer::pushChanges()
+{
+    if (isBusy() || !m_pipeline) {
+        return false;
+    }
+
+    const QStringList changed = pendingChanges();
+    if (changed.isEmpty()) {
+        emit pushCompleted(true, 0, 0);
+        return true;
+    }
+
+    m_pushFailed = false;
+    m_pushHashValid = false;
+    m_pushChanged = changed.size();
+
+    // 按帧上限打包：数据区首字节为条目数，其后依次拼接条目
+    QList<QPair<QByteArray, QVariantMap>> frames;
+    QByteArray payload(1, '\0');
+    QVariantMap entries;
+    auto flush = [&]() {
+        if (!entries.isEmpty()) {
+            payload[0] = static_cast<char>(entries.size());
+            frames.append(qMakePair(payload, entries));
+        }
+        payload = QByteArray(1, '\0');
+        entries.clear();
+    };
+
+    for (const QString& name : changed) {
+        const QVariant value = m_desired.value(name);
+        const QByteArray entry = ProtocolParser::encodeParameterEntry(name, value);
+        if (entry.isEmpty() || entry.size() > Protocol::MAX_DATA_SIZE - 1) {
+            LogManager::getInstance()->error(QString("参数无法编码，跳过同步: %1").arg(name), "ParameterSync");
+            m_pushFailed = true;
+            continue;
+        }
+        if (payload.size() + entry.size() > Protocol::MAX_DATA_SIZE || entries.size() == 255) {
+            flush();
+        }
+        payload.append(entry);
+        entries.insert(name, value);
+    }
+    flush();
+
+    m_pushFrames = frames.size();
+    m_pushOutstanding = frames.size();
+    if (frames.isEmpty()) {
+        finishPush();
+        return false;
+    }
+
+    // 管线按在途窗口连续发送，回调按发送顺序执行
+    QPointer<ParameterSynchronizer> guard(this);
+    for (const auto& frame : frames) {
+        const QVariantMap frameEntries = frame.second;
+        const quint32 sequenceId = m_pipeline->submit(
+            ProtocolCommand::WriteAllParameters, frame.first,
+            [guard, frameEntries](const CommandResult& result) {
+                if (guard) {
+                    guard->handleWriteResult(result, frameEntries);
+                }
+            });
+        if (sequenceId == 0) {
+            m_pushFailed = true;
+            if (--m_pushOutstanding == 0) {
+                finishPush();
+            }
+        }
+    }
+
+    LogManager::getInstance()->debug(
+        QString("参数增量同步: %1个参数, %2帧").arg(m_pushChanged).arg(m_pushFrames), "ParameterSync");
+    return true;
+}
+
+bool ParameterSynchronizer::refresh()
+{
+    if (isBusy() || !m_pipeline) {
+        return false;
+    }
+
+    m_reading = true;
+    m_readBuffer.clear();
+    requestPage(0);
+    return true;
+}
+
+void ParameterSynchronizer::invalidate()
+{
+    m_shadowValid = false;
+}
+
+bool ParameterSynchronizer::isBusy() const
+{
+    return m_pushOutstanding > 0 || m_reading;
+}
+
+bool ParameterSynchronizer::isShadowValid() const
+{
+    return m_shadowValid;
+}
+
+quint32 ParameterSynchronizer::version() const
+{
+    return m_version;
+}
+
+quint32 ParameterSynchronizer::shadowHash() const
+{
+    return m_confirmedHash;
+}
+
+quint32 ParameterSynchronizer::computeHash(const QVariantMap& parameters)
+{
+    // QVariantMap 按键升序遍历
+    uint32_t state = 0xFFFFFFFF;
+    for (auto it = parameters.constBegin(); it != parameters.constEnd(); ++it) {
+        const QByteArray entry = ProtocolParser::encodeParameterEntry(it.key(), it.value());
+        state = CRCEngine::updateCRC32C(state, reinterpret_cast<const uint8_t*>(entry.constData()),
+                                        static_cast<size_t>(entry.size()));
+    }
+    return state ^ 0xFFFFFFFF;
+}
+
+void ParameterSynchronizer::handleWriteResult(const CommandResult& result, const QVariantMap& entries)
+{
+    if (result.isSuccess()) {
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            m_confirmed.insert(it.key(), it.value());
+        }
+        ++m_version;
+        if (result.responseData.size() >= 4) {
+            m_pushDeviceHash = qFromBigEndian<quint32>(result.responseData.constData());
+            m_pushHashValid = true;
+        }
+    } else {
+        // 未确认的参数保留在待同步列表中，下次 pushChanges() 重发
+        m_pushFailed = true;
+    }
+
+    if (--m_pushOutstanding == 0) {
+        finishPush();
+    }
+}
+
+void ParameterSynchronizer::finishPush()
+{
+    m_confirmedHash = computeHash(m_confirmed);
+
+    // 设备哈希与影子副本不一致说明设备上还有主机不知道的差异
+    if (m_pushHashValid && m_pushDeviceHash != m_confirmedHash) {
+        LogManager::getInstance()->warning(
+            QString("设备参数集哈希不一致 (设备 %1, 主机 %2)，下次刷新时全量读取")
+                .arg(m_pushDeviceHash, 8, 16, QChar('0'))
+                .arg(m_confirmedHash, 8, 16, QChar('0')),
+            "ParameterSync");
+        m_shadowValid = false;
+    }
+
+    emit pushCompleted(!m_pushFailed, m_pushChanged, m_pushFrames);
+}
+
+void ParameterSynchronizer::requestPage(int offset)
+{
+    QByteArray payload(7, Qt::Uninitialized);
+    payload[0] = static_cast<char>(m_shadowValid ? READ_FLAG_SHADOW_VALID : 0);
+    qToBigEndian(m_confirmedHash, payload.data() + 1);
+    qToBigEndian(static_cast<quint16>(offset), payload.data() + 5);
+
+    QPointer<ParameterSynchronizer> guard(this);
+    const quint32 sequenceId = m_pipeline->submit(
+        ProtocolCommand::ReadAllParameters, payload,
+        [guard, offset](const CommandResult& result) {
+            if (guard) {
+                guard->handleReadResult(result, offset);
+            }
+        });
+    if (sequenceId == 0) {
+        failRead("请求提交失败");
+    }
+}
+
+void ParameterSynchronizer::handleReadResult(const CommandResult& result, int offset)
+{
+    if (!result.isSuccess()) {
+        failRead(QString("读取参数失败 (状态 %1)").arg(static_cast<int>(result.status)));
+        return;
+    }
+
+    const QByteArray& data = result.responseData;
+    if (data.size() < READ_RESPONSE_HEADER_SIZE) {
+        failRead("读取参数响应长度无效");
+        return;
+    }
+
+    const quint32 deviceHash = qFromBigEndian<quint32>(data.constData());
+    const int total = qFromBigEndian<quint16>(data.constData() + 4);
+
+    if (offset == 0 && m_shadowValid && deviceHash == m_confirmedHash) {
+        m_reading = false;
+        LogManager::getInstance()->debug("设备参数集哈希一致，跳过全量读取", "ParameterSync");
+        emit refreshCompleted(true, true, m_confirmed.size());
+        return;
+    }
+
+    int index = READ_RESPONSE_HEADER_SIZE;
+    int parsed = 0;
+    while (index < data.size()) {
+        QString name;
+        QVariant value;
+        const int consumed = ProtocolParser::decodeParameterEntry(data.constData() + index, data.size() - index,
+                                                                  name, value);
+        if (consumed <= 0) {
+            failRead("参数条目格式错误");
+            return;
+        }
+        m_readBuffer.insert(name, value);
+        index += consumed;
+        ++parsed;
+    }
+
+    const int nextOffset = offset + parsed;
+    if (nextOffset < total) {
+        if (parsed == 0) {
+            failRead("参数分页为空");
+            return;
+        }
+        requestPage(nextOffset);
+        return;
+    }
+    finishRead(deviceHash);
+}
+
+void ParameterSynchronizer::finishRead(quint32 deviceHash)
+{
+    const quint32 hash = computeHash(m_readBuffer);
+    if (hash != deviceHash) {
+        LogManager::getInstance()->warning(
+            QString("读取的参数集哈希与设备回报不一致 (设备 %1, 计算 %2)")
+                .arg(deviceHash, 8, 16, QChar('0'))
+                .arg(hash, 8, 16, QChar('0')),
+            "ParameterSync");
+    }
+
+    // 未修改的期望值跟随设备值，主机侧尚未写入的修改保留
+    QList<QPair<QString, QVariant>> changed;
+    for (auto it = m_readBuffer.constBegin(); it != m_readBuffer.constEnd(); ++it) {
+        const QVariant previous = m_confirmed.value(it.key());
+        if (previous != it.value()) {
+            changed.append(qMakePair(it.key(), it.value()));
+        }
+        auto desired = m_desired.find(it.key());
+        if (desired == m_desired.end() || desired.value() == previous) {
+            m_desired.insert(it.key(), it.value());
+        }
+    }
+
+    m_confirmed = m_readBuffer;
+    m_readBuffer.clear();
+    m_confirmedHash = hash;
+    m_shadowValid = true;
+    ++m_version;
+    m_reading = false;
+
+    for (const auto& item : changed) {
+        emit parameterChanged(item.first, item.second);
+    }
+    emit refreshCompleted(true, false, m_confirmed.size());
+}
+
+void ParameterSynchronizer::failRead(const QString& reason)
+{
+    m_reading = false;
+    m_readBuffer.clear();
+    LogManager::getInstance()->warning(QString("参数刷新失败: %1").arg(reason), "ParameterSync");
+    emit refreshCompleted(false, false, m_confirmed.size());
+}
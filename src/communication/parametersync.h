@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QStringList>
+#include <QVariantMap>
+#include "commandpipeline.h"
+
+// 设备参数同步 - 在主机侧维护设备参数的版本化影子副本，
+// 写入时只发送与影子副本不同的参数，重连时用参数集哈希判断是否需要全量读取
+//
+// 报文格式（多字节字段均为大端，条目编码见 ProtocolParser::encodeParameterEntry）：
+//   WriteAllParameters  条目数(1) 条目...
+//     响应              [0x13] 设备参数集哈希(4)
+//   ReadAllParameters   标志(1) 主机参数集哈希(4) 起始序号(2)
+//     响应              [0x12] 设备参数集哈希(4) 参数总数(2) 本帧条目...
+// 标志 bit0 表示主机影子副本有效；哈希一致时设备不返回条目，主机跳过全量读取。
+// 参数集哈希为各条目编码按参数名升序拼接后的CRC32C。
+// 变更按帧上限打包为尽量少的帧，经命令管线在途窗口连续发出，不逐帧等待。
+//
+// 对象在所属管线的线程中使用
+class ParameterSynchronizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ParameterSynchronizer(CommandPipeline* pipeline, QObject* parent = nullptr);
+
+    // 设置期望值（配方切换时整体设置即可，未变化的参数不会发送）
+    void setParameter(const QString& name, const QVariant& value);
+    void setParameters(const QVariantMap& parameters);
+    QVariant parameter(const QString& name) const;
+    QVariantMap parameters() const;
+
+    // 期望值与设备确认值不同的参数
+    QStringList pendingChanges() const;
+    bool hasPendingChanges() const;
+
+    // 把待同步的参数写入设备，没有变更时直接完成
+    bool pushChanges();
+    // 从设备刷新影子副本；影子副本有效且设备哈希一致时跳过全量读取
+    bool refresh();
+    // 影子副本不再可信（例如设备被其他主机改写），下次 refresh() 全量读取
+    void invalidate();
+
+    bool isBusy() const;
+    bool isShadowValid() const;
+    quint32 version() const;                // 影子副本版本，每次确认的变更加1
+    quint32 shadowHash() const;             // 设备确认值的参数集哈希
+
+    static quint32 computeHash(const QVariantMap& parameters);
+
+signals:
+    void pushCompleted(bool success, int changedCount, int frameCount);
+    void refreshCompleted(bool success, bool skipped, int parameterCount);
+    // 全量读取得到的设备值与影子副本不同
+    void parameterChanged(const QString& name, const QVariant& value);
+
+private:
+    void handleWriteResult(const CommandResult& result, const QVariantMap& entries);
+    void finishPush();
+    void requestPage(int offset);
+    void handleReadResult(const CommandResult& result, int offset);
+    void finishRead(quint32 deviceHash);
+    void failRead(const QString& reason);
+
+    CommandPipeline* m_pipeline;
+    QVariantMap m_desired;                  // 期望值
+    QVariantMap m_confirmed;                // 设备确认值（影子副本）
+    QVariantMap m_readBuffer;               // 全量读取中的分页结果
+    bool m_shadowValid;
+    quint32 m_version;
+    quint32 m_confirmedHash;
+
+    // 写入批次
+    int m_pushFrames;
+    int m_pushOutstanding;
+    int m_pushChanged;
+    bool m_pushFailed;
+    bool m_pushHashValid;
+    quint32 m_pushDeviceHash;           // 最后一个写入响应回报的设备哈希
+    bool m_reading;
+};
@@ -1,23 +1,53 @@
 #include "protocolparser.h"
 #include "logger/logmanager.h"
 #include "constants.h"
+#include "utils/bytescanner.h"
+#include "utils/binarycodec.h"
+#include "framewriter.h"
+#include "utils/fastlane.h"
+#include "utils/tracer.h"
+#include "utils/allocationtracker.h"
+#include "utils/framelatency.h"
 #include <QDebug>
 #include <QElapsedTimer>
 #include <cstring>
 
 ProtocolParser::ProtocolParser(QObject* parent)
     : QObject(parent)
+    , m_receivedNs(0)
     , timeoutMs(5000)
     , m_checksumType(ChecksumType::CRC16_MODBUS)
     , m_enhancedChecksumEnabled(true)
     , m_lastHeaderPos(-1)
     , m_bufferSearchStart(0)
     , m_bufferOptimized(false)
+    , m_batchDelivery(false)
+    , m_batchMaxFrames(Protocol::FRAME_BATCH_SIZE)
+    , m_batchMaxLatencyUs(Protocol::FRAME_BATCH_LATENCY_US)
 {
+    // 跨线程队列信号传递 ProtocolFrame
+    qRegisterMetaType<ProtocolFrame>("ProtocolFrame");
+    qRegisterMetaType<FrameBatch>("FrameBatch");
+    
     timeoutTimer = new QTimer(this);
     timeoutTimer->setSingleShot(true);
     connect(timeoutTimer, &QTimer::timeout, this, &ProtocolParser::onTimeout);
     
+    m_batchTimer = new QTimer(this);
+    m_batchTimer->setSingleShot(true);
+    m_batchTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_batchTimer, &QTimer::timeout, this, &ProtocolParser::flushFrameBatch);
+    
+    // 注册高级帧处理器
+    auto frameHandler = [this](void (ProtocolParser::*method)(const ProtocolFrame&)) {
+        return [this, method](const ProtocolFrame& frame) { (this->*method)(frame); };
+    };
+    registerCommandHandler(ProtocolCommand::Heartbeat, frameHandler(&ProtocolParser::processHeartbeatFrame));
+    registerCommandHandler(ProtocolCommand::MoveToPosition, frameHandler(&ProtocolParser::processMotionFrame));
+    registerCommandHandler(ProtocolCommand::SetGlueParameters, frameHandler(&ProtocolParser::processGlueFrame));
+    registerCommandHandler(ProtocolCommand::ReadParameter, frameHandler(&ProtocolParser::processParameterFrame));
+    registerCommandHandler(ProtocolCommand::WriteParameter, frameHandler(&ProtocolParser::processParameterFrame));
+    
     // 初始化性能统计
     m_perfStats.totalBytesProcessed = 0;
     m_perfStats.totalFramesProcessed = 0;
@@ -29,41 +59,56 @@ ProtocolParser::ProtocolParser(QObject* parent)
     preallocateMemory();
 }
 
-void ProtocolParser::parseData(const QByteArray& data)
+void ProtocolParser::parseData(const QByteArray& data, qint64 receivedNs)
 {
     if (data.isEmpty()) return;
+    TRACE_SCOPE("protocol", "ProtocolParser::parseData");
+    ALLOCATION_SCOPE("protocol.parseData");
+    m_receivedNs = receivedNs > 0 ? receivedNs : ProtocolFrame::currentTimestampNs();
     
     // 性能统计开始
     QElapsedTimer timer;
     timer.start();
     
-    // 添加数据到接收缓冲区
-    receiveBuffer.append(data);
     m_perfStats.totalBytesProcessed += data.size();
     
-    // 如果缓冲区太大，清空防止内存溢出
-    if (receiveBuffer.size() > Protocol::MAX_BUFFER_SIZE) {
-        LogManager::getInstance()->warning("接收缓冲区溢出，清空缓冲区", "Protocol");
-        receiveBuffer.clear();
-        m_lastHeaderPos = -1;
-        m_bufferSearchStart = 0;
-        emit parseError("接收缓冲区溢出");
-        return;
+    if (m_ringBuffer) {
+        // 环形缓冲区模式：原地扫描，按需拷贝
+        parseRingBuffer(data);
+    } else {
+        // 添加数据到接收缓冲区
+        receiveBuffer.append(data);
+        
+        // 如果缓冲区太大，清空防止内存溢出
+        if (receiveBuffer.size() > Protocol::MAX_BUFFER_SIZE) {
+            LogManager::getInstance()->warning("接收缓冲区溢出，清空缓冲区", "Protocol");
+            receiveBuffer.clear();
+            m_lastHeaderPos = -1;
+            m_bufferSearchStart = 0;
+            emit parseError("接收缓冲区溢出");
+            return;
+        }
+        
+        // 优化缓冲区
+        if (!m_bufferOptimized && receiveBuffer.size() > 1024) {
+            optimizeBuffer();
+        }
+        
+        // 尝试解析帧 - 使用优化的查找算法
+        QByteArray frameData;
+        while (findFrameOptimized(frameData)) {
+            ProtocolFrame frame;
+            if (validateFrame(frameData, frame)) {
+                processCompleteFrame(frame);
+                m_perfStats.totalFramesProcessed++;
+                ALLOCATION_COUNT_FRAMES(1);
+            }
+        }
     }
     
-    // 优化缓冲区
-    if (!m_bufferOptimized && receiveBuffer.size() > 1024) {
-        optimizeBuffer();
-    }
-    
-    // 尝试解析帧 - 使用优化的查找算法
-    QByteArray frameData;
-    while (findFrameOptimized(frameData)) {
-        ProtocolFrame frame;
-        if (validateFrame(frameData, frame)) {
-            processCompleteFrame(frame);
-            m_perfStats.totalFramesProcessed++;
-        }
+    // 本次数据处理后批次已超时则立即投递，不必等待定时器
+    if (!m_frameBatch.isEmpty() && m_batchAge.nsecsElapsed() >= m_batchMaxLatencyUs * 1000LL) {
+        flushFrameBatch();
     }
     
     // 性能统计结束
@@ -80,48 +125,12 @@ QByteArray ProtocolParser::buildFrame(ProtocolCommand command, const QByteArray&
         return QByteArray();
     }
     
-    QByteArray frame;
-    
-    // 帧头 (2字节)
-    frame.append(static_cast<char>((Protocol::FRAME_HEADER >> 8) & 0xFF));
-    frame.append(static_cast<char>(Protocol::FRAME_HEADER & 0xFF));
-    
-    // 命令码 (1字节)
-    frame.append(static_cast<char>(command));
-    
-    // 数据长度 (1字节)
-    frame.append(static_cast<char>(data.size()));
-    
-    // 数据区
-    frame.append(data);
-    
-    // 校验和 - 使用配置的校验类型
-    QByteArray checksumData = frame.mid(2); // 从命令码开始计算校验和
-    
-    if (m_enhancedChecksumEnabled) {
-        ChecksumResult checksumResult = EnhancedChecksum::calculate(checksumData, m_checksumType);
-        if (checksumResult.isValid) {
-            frame.append(checksumResult.value);
-            
-            LogManager::getInstance()->debug(
-                QString("使用%1校验，校验值: %2")
-                .arg(EnhancedChecksum::checksumTypeToString(m_checksumType))
-                .arg(ChecksumUtils::formatChecksum(checksumResult)),
-                "Protocol"
-            );
-        } else {
-            // 备用简单校验
-            frame.append(static_cast<char>(calculateChecksum(checksumData)));
-            LogManager::getInstance()->warning("增强校验失败，使用简单校验", "Protocol");
-        }
-    } else {
-        // 传统简单校验
-        frame.append(static_cast<char>(calculateChecksum(checksumData)));
+    // 一次分配到最终大小，由 FrameWriter 直接写入
+    QByteArray frame(requiredFrameSize(data.size()), Qt::Uninitialized);
+    if (writeFrame(frame.data(), frame.size(), command, data.constData(), data.size()).isEmpty()) {
+        return QByteArray();
     }
     
-    // 帧尾 (1字节)
-    frame.append(static_cast<char>(Protocol::FRAME_TAIL));
-    
     LogManager::getInstance()->debug(
         QString("构建协议帧: 命令=%1, 长度=%2").arg(commandToString(command)).arg(data.size()),
         "Protocol"
@@ -157,210 +166,315 @@ QByteArray ProtocolParser::buildErrorFrame(ProtocolError error, const QString& m
 
 QByteArray ProtocolParser::buildHeartbeatFrame()
 {
-    QByteArray data;
-    data.append(static_cast<char>(Protocol::HEARTBEAT_TYPE_PING)); // 心跳标识
-    
-    QDateTime currentTime = QDateTime::currentDateTime();
-    qint64 timestamp = currentTime.toMSecsSinceEpoch();
-    
-    // 添加时间戳 (8字节)
-    for (int i = 7; i >= 0; --i) {
-        data.append(static_cast<char>((timestamp >> (i * 8)) & 0xFF));
+    QByteArray frame(requiredFrameSize(9), Qt::Uninitialized);
+    if (writeHeartbeatFrame(frame.data(), frame.size()).isEmpty()) {
+        return QByteArray();
     }
-    
-    return buildFrame(ProtocolCommand::Heartbeat, data);
+    return frame;
 }
 
 QByteArray ProtocolParser::buildParameterFrame(const QString& paramName, const QVariant& value)
 {
-    QByteArray data;
+    // 参数帧长度取决于参数内容，按最大长度分配后截断（截断不会重新分配）
+    QByteArray frame(requiredFrameSize(Protocol::MAX_DATA_SIZE), Qt::Uninitialized);
+    const FrameView view = writeParameterFrame(frame.data(), frame.size(), paramName, value);
+    if (view.isEmpty()) {
+        return QByteArray();
+    }
+    frame.truncate(view.size());
+    return frame;
+}
+
+QByteArray ProtocolParser::buildMotionFrame(double x, double y, double z, double speed)
+{
+    QByteArray frame(requiredFrameSize(Protocol::MOTION_DATA_SIZE), Qt::Uninitialized);
+    if (writeMotionFrame(frame.data(), frame.size(), x, y, z, speed).isEmpty()) {
+        return QByteArray();
+    }
+    return frame;
+}
+
+QByteArray ProtocolParser::buildGlueFrame(double volume, double pressure, double temperature, int time)
+{
+    QByteArray frame(requiredFrameSize(Protocol::GLUE_DATA_SIZE), Qt::Uninitialized);
+    if (writeGlueFrame(frame.data(), frame.size(), volume, pressure, temperature, time).isEmpty()) {
+        return QByteArray();
+    }
+    return frame;
+}
+
+ChecksumType ProtocolParser::frameChecksumType() const
+{
+    return m_enhancedChecksumEnabled ? m_checksumType : ChecksumType::Simple;
+}
+
+int ProtocolParser::requiredFrameSize(int dataLength) const
+{
+    return FrameWriter::requiredSize(dataLength, frameChecksumType());
+}
+
+FrameView ProtocolParser::writeFrame(char* buffer, int capacity, ProtocolCommand command,
+                                     const char* data, int length)
+{
+    if (length > Protocol::MAX_DATA_SIZE) {
+        LogManager::getInstance()->error("数据长度超过最大限制", "Protocol");
+        return FrameView();
+    }
     
+    FrameWriter writer(buffer, capacity, frameChecksumType());
+    if (!writer.begin(static_cast<quint8>(command), length)) {
+        LogManager::getInstance()->error("帧缓冲区空间不足", "Protocol");
+        return FrameView();
+    }
+    writer.writeBytes(data, length);
+    return writer.finish();
+}
+
+FrameView ProtocolParser::writeHeartbeatFrame(char* buffer, int capacity)
+{
+    FrameWriter writer(buffer, capacity, frameChecksumType());
+    if (!writer.begin(static_cast<quint8>(ProtocolCommand::Heartbeat), 9)) {
+        LogManager::getInstance()->error("帧缓冲区空间不足", "Protocol");
+        return FrameView();
+    }
+    
+    // 心跳标识 (1字节) + 单调时钟时间戳 (8字节，纳秒)，设备原样回送
+    writer.writeUInt8(Protocol::HEARTBEAT_TYPE_PING)
+          .writeInt64(ProtocolFrame::currentTimestampNs());
+    return writer.finish();
+}
+
+FrameView ProtocolParser::writeParameterFrame(char* buffer, int capacity,
+                                              const QString& paramName, const QVariant& value)
+{
     // 参数名长度 (1字节)
-    QByteArray nameData = paramName.toUtf8();
+    const QByteArray nameData = paramName.toUtf8();
     if (nameData.size() > 255) {
         LogManager::getInstance()->error("参数名过长", "Protocol");
-        return QByteArray();
+        return FrameView();
     }
     
-    data.append(static_cast<char>(nameData.size()));
-    data.append(nameData);
-    
-    // 参数值类型 (1字节)
-    QByteArray valueData;
+    // 参数值类型 (1字节)，先确定值长度以便声明帧长度
+    quint8 valueType = 0;
+    int valueLength = 0;
+    QByteArray stringData;
     switch (value.typeId()) {
         case QMetaType::Int:
-        case QMetaType::UInt: {
-            data.append(static_cast<char>(Protocol::PARAM_TYPE_INT)); // 整数类型
-            qint32 intValue = value.toInt();
-            for (int i = 3; i >= 0; --i) {
-                valueData.append(static_cast<char>((intValue >> (i * 8)) & 0xFF));
-            }
+        case QMetaType::UInt:
+            valueType = Protocol::PARAM_TYPE_INT;
+            valueLength = 4;
             break;
-        }
-        case QMetaType::Double: {
-            data.append(static_cast<char>(Protocol::PARAM_TYPE_DOUBLE)); // 浮点类型
-            double doubleValue = value.toDouble();
-            QByteArray doubleBytes(reinterpret_cast<const char*>(&doubleValue), sizeof(double));
-            valueData = doubleBytes;
+        case QMetaType::Double:
+            valueType = Protocol::PARAM_TYPE_DOUBLE;
+            valueLength = static_cast<int>(sizeof(double));
             break;
-        }
-        case QMetaType::QString: {
-            data.append(static_cast<char>(Protocol::PARAM_TYPE_STRING)); // 字符串类型
-            valueData = value.toString().toUtf8();
-            if (valueData.size() > 255) {
+        case QMetaType::QString:
+            valueType = Protocol::PARAM_TYPE_STRING;
+            stringData = value.toString().toUtf8();
+            if (stringData.size() > 255) {
                 LogManager::getInstance()->error("参数值过长", "Protocol");
-                return QByteArray();
+                return FrameView();
             }
-            QByteArray lengthByte;
-            lengthByte.append(static_cast<char>(valueData.size()));
-            valueData.prepend(lengthByte);
+            valueLength = 1 + stringData.size();
             break;
-        }
-        case QMetaType::Bool: {
-            data.append(static_cast<char>(Protocol::PARAM_TYPE_BOOL)); // 布尔类型
-            valueData.append(value.toBool() ? static_cast<char>(0x01) : static_cast<char>(0x00));
+        case QMetaType::Bool:
+            valueType = Protocol::PARAM_TYPE_BOOL;
+            valueLength = 1;
             break;
-        }
         default:
             LogManager::getInstance()->error("不支持的参数类型", "Protocol");
-            return QByteArray();
+            return FrameView();
+    }
+    
+    const int dataLength = 1 + nameData.size() + 1 + valueLength;
+    if (dataLength > Protocol::MAX_DATA_SIZE) {
+        LogManager::getInstance()->error("数据长度超过最大限制", "Protocol");
+        return FrameView();
     }
     
-    data.append(valueData);
+    FrameWriter writer(buffer, capacity, frameChecksumType());
+    if (!writer.begin(static_cast<quint8>(ProtocolCommand::WriteParameter), dataLength)) {
+        LogManager::getInstance()->error("帧缓冲区空间不足", "Protocol");
+        return FrameView();
+    }
     
-    return buildFrame(ProtocolCommand::WriteParameter, data);
+    writer.writeUInt8(static_cast<quint8>(nameData.size()))
+          .writeBytes(nameData)
+          .writeUInt8(valueType);
+    
+    switch (valueType) {
+        case Protocol::PARAM_TYPE_INT:
+            writer.writeUInt32(static_cast<quint32>(value.toInt()));
+            break;
+        case Protocol::PARAM_TYPE_DOUBLE:
+            writer.writeDouble(value.toDouble());
+            break;
+        case Protocol::PARAM_TYPE_STRING:
+            writer.writeUInt8(static_cast<quint8>(stringData.size())).writeBytes(stringData);
+            break;
+        case Protocol::PARAM_TYPE_BOOL:
+            writer.writeUInt8(value.toBool() ? 0x01 : 0x00);
+            break;
+    }
+    
+    return writer.finish();
 }
 
-QByteArray ProtocolParser::buildMotionFrame(double x, double y, double z, double speed)
+FrameView ProtocolParser::writeMotionFrame(char* buffer, int capacity, double x, double y, double z, double speed)
 {
-    QByteArray data;
-    
-    // 位置数据 (每个坐标4字节，共12字节)
-    QList<double> positions = {x, y, z};
-    for (double pos : positions) {
-        float floatPos = static_cast<float>(pos);
-        QByteArray posBytes(reinterpret_cast<const char*>(&floatPos), sizeof(float));
-        data.append(posBytes);
+    FrameWriter writer(buffer, capacity, frameChecksumType());
+    if (!writer.begin(static_cast<quint8>(ProtocolCommand::MoveToPosition), Protocol::MOTION_DATA_SIZE)) {
+        LogManager::getInstance()->error("帧缓冲区空间不足", "Protocol");
+        return FrameView();
     }
     
-    // 速度数据 (4字节)
-    float floatSpeed = static_cast<float>(speed);
-    QByteArray speedBytes(reinterpret_cast<const char*>(&floatSpeed), sizeof(float));
-    data.append(speedBytes);
-    
-    return buildFrame(ProtocolCommand::MoveToPosition, data);
+    // 位置数据 (每个坐标4字节，共12字节) + 速度数据 (4字节)
+    writer.writeFloat(static_cast<float>(x))
+          .writeFloat(static_cast<float>(y))
+          .writeFloat(static_cast<float>(z))
+          .writeFloat(static_cast<float>(speed));
+    return writer.finish();
 }
 
-QByteArray ProtocolParser::buildGlueFrame(double volume, double pressure, double temperature, int time)
+FrameView ProtocolParser::writeGlueFrame(char* buffer, int capacity,
+                                         double volume, double pressure, double temperature, int time)
 {
-    QByteArray data;
+    FrameWriter writer(buffer, capacity, frameChecksumType());
+    if (!writer.begin(static_cast<quint8>(ProtocolCommand::SetGlueParameters), Protocol::GLUE_DATA_SIZE)) {
+        LogManager::getInstance()->error("帧缓冲区空间不足", "Protocol");
+        return FrameView();
+    }
     
-    // 胶量 (4字节)
-    float floatVolume = static_cast<float>(volume);
-    QByteArray volumeBytes(reinterpret_cast<const char*>(&floatVolume), sizeof(float));
-    data.append(volumeBytes);
+    // 胶量、压力、温度 (各4字节) + 时间 (4字节，大端)
+    writer.writeFloat(static_cast<float>(volume))
+          .writeFloat(static_cast<float>(pressure))
+          .writeFloat(static_cast<float>(temperature))
+          .writeUInt32(static_cast<quint32>(time));
+    return writer.finish();
+}
+
+bool ProtocolParser::parseParameterResponse(const QByteArray& data, QString& paramName, QVariant& value)
+{
+    return decodeParameterEntry(data.constData(), data.size(), paramName, value) > 0;
+}
+
+QByteArray ProtocolParser::encodeParameterEntry(const QString& paramName, const QVariant& value)
+{
+    const QByteArray nameData = paramName.toUtf8();
+    if (nameData.size() > 255) {
+        return QByteArray();
+    }
     
-    // 压力 (4字节)
-    float floatPressure = static_cast<float>(pressure);
-    QByteArray pressureBytes(reinterpret_cast<const char*>(&floatPressure), sizeof(float));
-    data.append(pressureBytes);
+    // 先确定值的编码长度，整条参数一次分配
+    QByteArray stringData;
+    int valueSize = 0;
+    quint8 valueType = 0;
+    switch (value.typeId()) {
+        case QMetaType::Int:
+        case QMetaType::UInt:
+            valueType = Protocol::PARAM_TYPE_INT;
+            valueSize = 4;
+            break;
+        case QMetaType::Double:
+            valueType = Protocol::PARAM_TYPE_DOUBLE;
+            valueSize = static_cast<int>(sizeof(double));
+            break;
+        case QMetaType::QString:
+            stringData = value.toString().toUtf8();
+            if (stringData.size() > 255) {
+                return QByteArray();
+            }
+            valueType = Protocol::PARAM_TYPE_STRING;
+            valueSize = 1 + stringData.size();
+            break;
+        case QMetaType::Bool:
+            valueType = Protocol::PARAM_TYPE_BOOL;
+            valueSize = 1;
+            break;
+        default:
+            return QByteArray();
+    }
     
-    // 温度 (4字节)
-    float floatTemperature = static_cast<float>(temperature);
-    QByteArray tempBytes(reinterpret_cast<const char*>(&floatTemperature), sizeof(float));
-    data.append(tempBytes);
+    QByteArray entry(2 + nameData.size() + valueSize, Qt::Uninitialized);
+    BinaryWriter writer(entry.data(), entry.size());
+    writer.writeBig(static_cast<quint8>(nameData.size()))
+          .writeBytes(nameData.constData(), nameData.size())
+          .writeBig(valueType);
     
-    // 时间 (4字节)
-    for (int i = 3; i >= 0; --i) {
-        data.append(static_cast<char>((time >> (i * 8)) & 0xFF));
+    // 与 writeParameterFrame 的数据区编码一致
+    switch (valueType) {
+        case Protocol::PARAM_TYPE_INT:
+            writer.writeBig(static_cast<quint32>(value.toInt()));
+            break;
+        case Protocol::PARAM_TYPE_DOUBLE:
+            writer.writeNative(value.toDouble());
+            break;
+        case Protocol::PARAM_TYPE_STRING:
+            writer.writeBig(static_cast<quint8>(stringData.size()))
+                  .writeBytes(stringData.constData(), stringData.size());
+            break;
+        default:
+            writer.writeBig(static_cast<quint8>(value.toBool() ? 0x01 : 0x00));
+            break;
     }
-    
-    return buildFrame(ProtocolCommand::SetGlueParameters, data);
+    return entry;
 }
 
-bool ProtocolParser::parseParameterResponse(const QByteArray& data, QString& paramName, QVariant& value)
+int ProtocolParser::decodeParameterEntry(const char* data, int length, QString& paramName, QVariant& value)
 {
-    if (data.isEmpty()) return false;
-    
-    int index = 0;
+    if (length <= 0) return -1;
     
-    // 读取参数名长度
-    if (index >= data.size()) return false;
-    quint8 nameLength = static_cast<quint8>(data[index++]);
+    BinaryReader reader(data, length);
     
-    // 读取参数名
-    if (index + nameLength > data.size()) return false;
-    paramName = QString::fromUtf8(data.mid(index, nameLength));
-    index += nameLength;
+    // 参数名长度和参数名
+    const quint8 nameLength = reader.readBig<quint8>();
+    const char* name = reader.readBytes(nameLength);
+    if (!name) return -1;
+    paramName = QString::fromUtf8(name, nameLength);
     
-    // 读取参数值类型
-    if (index >= data.size()) return false;
-    quint8 valueType = static_cast<quint8>(data[index++]);
+    // 参数值类型
+    const quint8 valueType = reader.readBig<quint8>();
+    if (reader.hasError()) return -1;
     
     // 根据类型解析参数值
     switch (valueType) {
-        case Protocol::PARAM_TYPE_INT: { // 整数类型
-            if (index + 4 > data.size()) return false;
-            qint32 intValue = 0;
-            for (int i = 0; i < 4; ++i) {
-                intValue = (intValue << 8) | static_cast<quint8>(data[index++]);
-            }
-            value = intValue;
+        case Protocol::PARAM_TYPE_INT: // 整数类型
+            value = reader.readBig<qint32>();
             break;
-        }
-        case Protocol::PARAM_TYPE_DOUBLE: { // 浮点类型
-            if (index + 8 > data.size()) return false;
-            double doubleValue;
-            memcpy(&doubleValue, data.constData() + index, sizeof(double));
-            value = doubleValue;
-            index += 8;
+        case Protocol::PARAM_TYPE_DOUBLE: // 浮点类型
+            value = reader.readNative<double>();
             break;
-        }
         case Protocol::PARAM_TYPE_STRING: { // 字符串类型
-            if (index >= data.size()) return false;
-            quint8 strLength = static_cast<quint8>(data[index++]);
-            if (index + strLength > data.size()) return false;
-            value = QString::fromUtf8(data.mid(index, strLength));
-            index += strLength;
+            const quint8 strLength = reader.readBig<quint8>();
+            const char* text = reader.readBytes(strLength);
+            if (text) {
+                value = QString::fromUtf8(text, strLength);
+            }
             break;
         }
-        case Protocol::PARAM_TYPE_BOOL: { // 布尔类型
-            if (index >= data.size()) return false;
-            value = (data[index++] != 0);
+        case Protocol::PARAM_TYPE_BOOL: // 布尔类型
+            value = (reader.readBig<quint8>() != 0);
             break;
-        }
         default:
             LogManager::getInstance()->error("未知的参数值类型", "Protocol");
-            return false;
+            return -1;
     }
     
-    return true;
+    return reader.hasError() ? -1 : reader.position();
 }
 
 bool ProtocolParser::parseMotionResponse(const QByteArray& data, double& x, double& y, double& z, double& speed)
 {
     if (data.size() < Device::MOTION_DATA_SIZE) return false; // 需要至少16字节 (3个位置 + 1个速度)
     
-    int index = 0;
-    
-    // 解析位置数据
-    float floatX, floatY, floatZ, floatSpeed;
+    // 位置和速度为本机字节序的 float
+    float values[4];
+    BinaryCodec::loadArray<float, ByteOrder::Native>(data.constData(), values, 4);
     
-    memcpy(&floatX, data.constData() + index, sizeof(float));
-    index += sizeof(float);
-    
-    memcpy(&floatY, data.constData() + index, sizeof(float));
-    index += sizeof(float);
-    
-    memcpy(&floatZ, data.constData() + index, sizeof(float));
-    index += sizeof(float);
-    
-    memcpy(&floatSpeed, data.constData() + index, sizeof(float));
-    
-    x = static_cast<double>(floatX);
-    y = static_cast<double>(floatY);
-    z = static_cast<double>(floatZ);
-    speed = static_cast<double>(floatSpeed);
+    x = static_cast<double>(values[0]);
+    y = static_cast<double>(values[1]);
+    z = static_cast<double>(values[2]);
+    speed = static_cast<double>(values[3]);
     
     return true;
 }
@@ -369,31 +483,13 @@ bool ProtocolParser::parseGlueResponse(const QByteArray& data, double& volume, d
 {
     if (data.size() < Device::GLUE_DATA_SIZE) return false; // 需要至少16字节
     
-    int index = 0;
-    
-    // 解析胶量
-    float floatVolume;
-    memcpy(&floatVolume, data.constData() + index, sizeof(float));
-    volume = static_cast<double>(floatVolume);
-    index += sizeof(float);
+    BinaryReader reader(data.constData(), data.size());
     
-    // 解析压力
-    float floatPressure;
-    memcpy(&floatPressure, data.constData() + index, sizeof(float));
-    pressure = static_cast<double>(floatPressure);
-    index += sizeof(float);
-    
-    // 解析温度
-    float floatTemperature;
-    memcpy(&floatTemperature, data.constData() + index, sizeof(float));
-    temperature = static_cast<double>(floatTemperature);
-    index += sizeof(float);
-    
-    // 解析时间
-    time = 0;
-    for (int i = 0; i < 4; ++i) {
-        time = (time << 8) | static_cast<quint8>(data[index++]);
-    }
+    // 胶量、压力、温度为本机字节序的 float，时间为大端序整数
+    volume = static_cast<double>(reader.readNative<float>());
+    pressure = static_cast<double>(reader.readNative<float>());
+    temperature = static_cast<double>(reader.readNative<float>());
+    time = reader.readBig<qint32>();
     
     return true;
 }
@@ -405,19 +501,14 @@ bool ProtocolParser::validateFrameIntegrity(const ProtocolFrame& frame)
         return false;
     }
     
-    // 检查数据长度一致性
-    if (frame.data.size() != frame.dataLength) {
-        return false;
-    }
-    
     // 检查特定命令的数据长度要求
     switch (frame.command) {
         case ProtocolCommand::MoveToPosition:
-            return frame.data.size() == Device::MOTION_DATA_SIZE; // 4个float值
+            return frame.dataLength == Device::MOTION_DATA_SIZE; // 4个float值
         case ProtocolCommand::SetGlueParameters:
-            return frame.data.size() == Device::GLUE_DATA_SIZE; // 3个float + 1个int
+            return frame.dataLength == Device::GLUE_DATA_SIZE; // 3个float + 1个int
         case ProtocolCommand::Heartbeat:
-            return frame.data.size() >= 1; // 至少包含心跳标识
+            return frame.dataLength >= 1; // 至少包含心跳标识
         default:
             break; // 其他命令暂不检查
     }
@@ -425,67 +516,38 @@ bool ProtocolParser::validateFrameIntegrity(const ProtocolFrame& frame)
     return true;
 }
 
-void ProtocolParser::processAdvancedFrame(const ProtocolFrame& frame)
-{
-    LogManager::getInstance()->debug(
-        QString("处理高级协议帧: 命令=%1, 数据长度=%2")
-        .arg(commandToString(frame.command))
-        .arg(frame.data.size()),
-        "Protocol"
-    );
-    
-    switch (frame.command) {
-        case ProtocolCommand::Heartbeat:
-            processHeartbeatFrame(frame);
-            break;
-        case ProtocolCommand::MoveToPosition:
-            processMotionFrame(frame);
-            break;
-        case ProtocolCommand::SetGlueParameters:
-            processGlueFrame(frame);
-            break;
-        case ProtocolCommand::ReadParameter:
-        case ProtocolCommand::WriteParameter:
-            processParameterFrame(frame);
-            break;
-        default:
-            // 发送给基础处理器
-            emit frameReceived(frame);
-            break;
-    }
-}
-
 void ProtocolParser::processHeartbeatFrame(const ProtocolFrame& frame)
 {
-    if (frame.data.isEmpty()) return;
+    if (frame.dataLength == 0) return;
     
     quint8 heartbeatType = static_cast<quint8>(frame.data[0]);
     
-    if (heartbeatType == Protocol::HEARTBEAT_TYPE_PING && frame.data.size() >= 9) {
-        // 解析时间戳
-        qint64 timestamp = 0;
-        for (int i = 1; i < 9; ++i) {
-            timestamp = (timestamp << 8) | static_cast<quint8>(frame.data[i]);
-        }
+    if ((heartbeatType == Protocol::HEARTBEAT_TYPE_PING || heartbeatType == Protocol::HEARTBEAT_TYPE_PONG)
+        && frame.dataLength >= 9) {
+        // 回送的本机发送时间戳（单调时钟纳秒），帧时间戳为校验通过时刻
+        const qint64 sentNs = BinaryCodec::load<qint64, ByteOrder::BigEndian>(frame.data + 1);
         
-        QDateTime receivedTime = QDateTime::fromMSecsSinceEpoch(timestamp);
-        QDateTime currentTime = QDateTime::currentDateTime();
-        qint64 delay = currentTime.msecsTo(receivedTime);
+        const qint64 rttNs = frame.timestampNs - sentNs;
+        if (rttNs < 0 || rttNs > Protocol::HEARTBEAT_MAX_RTT_MS * 1000000LL) {
+            // 不是本机发出的心跳（设备自己的时钟或进程重启前的心跳），不计入往返时间
+            return;
+        }
         
         LogManager::getInstance()->debug(
-            QString("收到心跳包，延迟: %1ms").arg(delay),
+            QString("收到心跳包，往返时间: %1us").arg(rttNs / 1000.0, 0, 'f', 1),
             "Protocol"
         );
         
-        emit heartbeatReceived(delay);
+        emit heartbeatReceived(rttNs);
     }
 }
 
 void ProtocolParser::processMotionFrame(const ProtocolFrame& frame)
 {
     double x, y, z, speed;
-    if (parseMotionResponse(frame.data, x, y, z, speed)) {
+    if (parseMotionResponse(frame.payload(), x, y, z, speed)) {
         emit motionDataReceived(x, y, z, speed);
+        emit sampleFrameReceived(frame);
     } else {
         LogManager::getInstance()->error("解析运动数据失败", "Protocol");
         emit parseError("运动数据格式错误");
@@ -496,8 +558,9 @@ void ProtocolParser::processGlueFrame(const ProtocolFrame& frame)
 {
     double volume, pressure, temperature;
     int time;
-    if (parseGlueResponse(frame.data, volume, pressure, temperature, time)) {
+    if (parseGlueResponse(frame.payload(), volume, pressure, temperature, time)) {
         emit glueDataReceived(volume, pressure, temperature, time);
+        emit sampleFrameReceived(frame);
     } else {
         LogManager::getInstance()->error("解析点胶数据失败", "Protocol");
         emit parseError("点胶数据格式错误");
@@ -508,7 +571,7 @@ void ProtocolParser::processParameterFrame(const ProtocolFrame& frame)
 {
     QString paramName;
     QVariant value;
-    if (parseParameterResponse(frame.data, paramName, value)) {
+    if (parseParameterResponse(frame.payload(), paramName, value)) {
         emit parameterReceived(paramName, value);
     } else {
         LogManager::getInstance()->error("解析参数数据失败", "Protocol");
@@ -525,6 +588,22 @@ quint8 ProtocolParser::calculateChecksum(const QByteArray& data)
     return checksum;
 }
 
+bool ProtocolParser::isSafetyCommand(ProtocolCommand command)
+{
+    return command == ProtocolCommand::EmergencyStop
+        || command == ProtocolCommand::DeviceStop
+        || command == ProtocolCommand::PauseDevice;
+}
+
+bool ProtocolParser::isSafetyFrame(const QByteArray& frameData)
+{
+    // 命令码位于帧头之后
+    if (frameData.size() < 3) {
+        return false;
+    }
+    return isSafetyCommand(static_cast<ProtocolCommand>(static_cast<quint8>(frameData[2])));
+}
+
 QString ProtocolParser::commandToString(ProtocolCommand command)
 {
     switch (command) {
@@ -550,6 +629,7 @@ QString ProtocolParser::commandToString(ProtocolCommand command)
         case ProtocolCommand::Response: return "响应";
         case ProtocolCommand::Error: return "错误";
         case ProtocolCommand::Heartbeat: return "心跳包";
+        case ProtocolCommand::NegotiateCompression: return "协商链路压缩";
         case ProtocolCommand::MoveToPosition: return "移动到位置";
         case ProtocolCommand::SetGlueParameters: return "设置点胶参数";
         default: return QString("未知命令(0x%1)").arg(static_cast<int>(command), 2, 16, QChar('0')).toUpper();
@@ -579,8 +659,14 @@ void ProtocolParser::setTimeout(int timeout)
 void ProtocolParser::clearBuffer()
 {
     receiveBuffer.clear();
+    if (m_ringBuffer) {
+        m_ringBuffer->clear();
+    }
     frameQueue.clear();
     timeoutTimer->stop();
+    
+    // 已通过校验的帧不丢弃
+    flushFrameBatch();
 }
 
 void ProtocolParser::onTimeout()
@@ -594,7 +680,7 @@ bool ProtocolParser::findFrame(QByteArray& frame)
     // 寻找帧头
     int headerIndex = -1;
     for (int i = 0; i < receiveBuffer.size() - 1; ++i) {
-        quint16 header = (static_cast<quint8>(receiveBuffer[i]) << 8) | static_cast<quint8>(receiveBuffer[i + 1]);
+        const quint16 header = BinaryCodec::load<quint16, ByteOrder::BigEndian>(receiveBuffer.constData() + i);
         if (header == Protocol::FRAME_HEADER) {
             headerIndex = i;
             break;
@@ -643,7 +729,7 @@ bool ProtocolParser::validateFrame(const QByteArray& frameData, ProtocolFrame& f
     }
     
     // 解析帧头
-    frame.header = (static_cast<quint8>(frameData[0]) << 8) | static_cast<quint8>(frameData[1]);
+    frame.header = BinaryCodec::load<quint16, ByteOrder::BigEndian>(frameData.constData());
     if (frame.header != Protocol::FRAME_HEADER) {
         LogManager::getInstance()->warning("帧头错误", "Protocol");
         return false;
@@ -655,10 +741,8 @@ bool ProtocolParser::validateFrame(const QByteArray& frameData, ProtocolFrame& f
     // 解析数据长度
     frame.dataLength = static_cast<quint8>(frameData[3]);
     
-    // 解析数据区
-    if (frame.dataLength > 0) {
-        frame.data = frameData.mid(4, frame.dataLength);
-    }
+    // 解析数据区（内联拷贝，无堆分配）
+    frame.setData(frameData.constData() + 4, frame.dataLength);
     
     // 解析校验和
     frame.checksum = static_cast<quint8>(frameData[4 + frame.dataLength]);
@@ -670,6 +754,9 @@ bool ProtocolParser::validateFrame(const QByteArray& frameData, ProtocolFrame& f
         return false;
     }
     
+    frame.timestampNs = ProtocolFrame::currentTimestampNs();
+    frame.receivedNs = m_receivedNs;
+    
     // 验证校验和 - 支持CRC16和简单校验
     QByteArray checksumData = frameData.mid(2, 2 + frame.dataLength); // 从命令码到数据区结束
     
@@ -706,10 +793,12 @@ bool ProtocolParser::validateFrame(const QByteArray& frameData, ProtocolFrame& f
                         // 可以考虑使用纠正后的数据
                     } else {
                         LogManager::getInstance()->error(errorMsg, "Protocol");
+                        emit frameRejected(ProtocolError::ChecksumError);
                         return false;
                     }
                 } else {
                     LogManager::getInstance()->warning(errorMsg, "Protocol");
+                    emit frameRejected(ProtocolError::ChecksumError);
                     return false;
                 }
             }
@@ -724,6 +813,7 @@ bool ProtocolParser::validateFrame(const QByteArray& frameData, ProtocolFrame& f
                 .arg(frame.checksum, 2, 16, QChar('0')),
                 "Protocol"
             );
+            emit frameRejected(ProtocolError::ChecksumError);
             return false;
         }
     }
@@ -740,9 +830,63 @@ void ProtocolParser::processCompleteFrame(const ProtocolFrame& frame)
         "Protocol"
     );
     
+    FrameLatencyMonitor::getInstance()->record(FrameLatencyStage::Parse, frame.timestampNs - frame.receivedNs);
+    
+    CommandSlot& slot = m_commandSlots[static_cast<quint8>(frame.command)];
+    if (slot.handler) {
+        slot.handler(frame);
+    } else {
+        deliverFrame(frame);
+    }
+    
+    // 帧时间戳在校验通过时记录，即解析结束时刻
+    const qint64 latencyNs = ProtocolFrame::currentTimestampNs() - frame.timestampNs;
+    slot.latency.record(latencyNs);
+    if (isSafetyCommand(frame.command)) {
+        FastLaneMonitor::getInstance()->record(FastLaneStage::ParserDispatch, latencyNs);
+    }
+}
+
+void ProtocolParser::deliverFrame(const ProtocolFrame& frame)
+{
+    if (m_batchDelivery) {
+        if (m_frameBatch.isEmpty()) {
+            m_batchAge.start();
+            m_batchTimer->start(qMax(1, (m_batchMaxLatencyUs + 999) / 1000));
+        }
+        m_frameBatch.append(frame);
+        // 安全指令不等待批次凑满或超时，连同之前的帧立即投递，保持帧顺序
+        if (m_frameBatch.size() >= m_batchMaxFrames || isSafetyCommand(frame.command)) {
+            flushFrameBatch();
+        }
+        return;
+    }
+    
     emit frameReceived(frame);
 }
 
+void ProtocolParser::registerCommandHandler(ProtocolCommand command, CommandHandler handler)
+{
+    m_commandSlots[static_cast<quint8>(command)].handler = std::move(handler);
+}
+
+void ProtocolParser::unregisterCommandHandler(ProtocolCommand command)
+{
+    m_commandSlots[static_cast<quint8>(command)].handler = nullptr;
+}
+
+const LatencyHistogram& ProtocolParser::commandLatency(ProtocolCommand command) const
+{
+    return m_commandSlots[static_cast<quint8>(command)].latency;
+}
+
+void ProtocolParser::resetCommandStats()
+{
+    for (CommandSlot& slot : m_commandSlots) {
+        slot.latency.reset();
+    }
+}
+
 // 增强的帧完整性检查实现
 EnhancedChecksum::FrameIntegrityResult ProtocolParser::checkAdvancedFrameIntegrity(const QByteArray& frameData)
 {
@@ -821,12 +965,13 @@ bool ProtocolParser::findFrameOptimized(QByteArray& frame)
     int searchStart = qMax(m_bufferSearchStart, 0);
     int headerIndex = -1;
     
-    // 优化的帧头搜索 - 使用快速内存比较
-    for (int i = searchStart; i < receiveBuffer.size() - 1; ++i) {
-        if (static_cast<quint8>(receiveBuffer[i]) == (Protocol::FRAME_HEADER >> 8) &&
-            static_cast<quint8>(receiveBuffer[i + 1]) == (Protocol::FRAME_HEADER & 0xFF)) {
-            headerIndex = i;
-            break;
+    // 优化的帧头搜索 - 使用运行时选择的SIMD扫描内核
+    if (searchStart < receiveBuffer.size()) {
+        const int hit = ByteScanner::findHeader(receiveBuffer.constData() + searchStart,
+                                                receiveBuffer.size() - searchStart,
+                                                Protocol::FRAME_HEADER);
+        if (hit >= 0) {
+            headerIndex = searchStart + hit;
         }
     }
     
@@ -877,6 +1022,179 @@ bool ProtocolParser::findFrameOptimized(QByteArray& frame)
     return true;
 }
 
+void ProtocolParser::setRingBufferMode(bool enabled, int capacity)
+{
+    if (enabled) {
+        auto ringBuffer = std::make_unique<ProtocolRingBuffer>(capacity);
+        
+        // 迁移尚未解析的数据，保证切换过程中不丢帧
+        const QByteArray pending = m_ringBuffer
+            ? m_ringBuffer->view(0, m_ringBuffer->size()).toByteArray()
+            : receiveBuffer;
+        if (!ringBuffer->write(pending)) {
+            LogManager::getInstance()->warning("环形缓冲区容量不足，丢弃未解析数据", "Protocol");
+        }
+        
+        m_ringBuffer = std::move(ringBuffer);
+        receiveBuffer.clear();
+        m_bufferSearchStart = 0;
+        m_lastHeaderPos = -1;
+    } else if (m_ringBuffer) {
+        receiveBuffer = m_ringBuffer->view(0, m_ringBuffer->size()).toByteArray();
+        m_ringBuffer.reset();
+        m_bufferSearchStart = 0;
+        m_lastHeaderPos = -1;
+    }
+    
+    LogManager::getInstance()->info(
+        QString("环形缓冲区模式已%1").arg(enabled ? QString("启用，容量: %1").arg(m_ringBuffer->capacity()) : "禁用"),
+        "Protocol"
+    );
+}
+
+bool ProtocolParser::isRingBufferMode() const
+{
+    return m_ringBuffer != nullptr;
+}
+
+void ProtocolParser::setFrameViewHandler(FrameViewHandler handler)
+{
+    m_frameViewHandler = std::move(handler);
+}
+
+void ProtocolParser::setBatchDelivery(bool enabled, int maxFrames, int maxLatencyUs)
+{
+    if (!enabled) {
+        flushFrameBatch();
+    }
+    
+    m_batchDelivery = enabled;
+    m_batchMaxFrames = qMax(1, maxFrames);
+    m_batchMaxLatencyUs = qMax(0, maxLatencyUs);
+    m_frameBatch.reserve(m_batchMaxFrames);
+    
+    LogManager::getInstance()->info(
+        enabled ? QString("批量帧投递已启用，每批最多%1帧，最长等待%2us").arg(m_batchMaxFrames).arg(m_batchMaxLatencyUs)
+                : QString("批量帧投递已禁用"),
+        "Protocol"
+    );
+}
+
+bool ProtocolParser::isBatchDeliveryEnabled() const
+{
+    return m_batchDelivery;
+}
+
+void ProtocolParser::flushFrameBatch()
+{
+    m_batchTimer->stop();
+    if (m_frameBatch.isEmpty()) {
+        return;
+    }
+    
+    // 交换出当前批次：队列连接持有的是共享数据，交换后新批次另行分配
+    FrameBatch batch;
+    batch.swap(m_frameBatch);
+    m_frameBatch.reserve(m_batchMaxFrames);
+    emit framesReceived(batch);
+}
+
+void ProtocolParser::parseRingBuffer(const QByteArray& data)
+{
+    if (!m_ringBuffer->write(data)) {
+        LogManager::getInstance()->warning("环形接收缓冲区溢出，清空缓冲区", "Protocol");
+        m_ringBuffer->clear();
+        emit parseError("接收缓冲区溢出");
+        return;
+    }
+    
+    FrameView frameView;
+    while (findFrameInRing(frameView)) {
+        ProtocolFrame frame;
+        if (validateFrameView(frameView, frame)) {
+            // 零拷贝消费者优先处理，未处理时才拷贝数据构建完整帧
+            if (!m_frameViewHandler || !m_frameViewHandler(frameView)) {
+                frameView.mid(4, frame.dataLength).copyTo(frame.data);
+                processCompleteFrame(frame);
+            }
+            m_perfStats.totalFramesProcessed++;
+            ALLOCATION_COUNT_FRAMES(1);
+        }
+        m_ringBuffer->consume(frameView.size());
+    }
+}
+
+bool ProtocolParser::findFrameInRing(FrameView& frameView)
+{
+    const int headerIndex = m_ringBuffer->indexOfHeader(Protocol::FRAME_HEADER);
+    
+    if (headerIndex == -1) {
+        // 没有找到帧头，只保留最后一个字节（可能是帧头的第一个字节）
+        m_ringBuffer->consume(m_ringBuffer->size() - 1);
+        return false;
+    }
+    
+    // 丢弃帧头之前的无效数据
+    if (headerIndex > 0) {
+        m_ringBuffer->consume(headerIndex);
+    }
+    
+    // 检查是否有足够的数据构成最小帧
+    if (m_ringBuffer->size() < Protocol::MIN_FRAME_SIZE) {
+        return false;
+    }
+    
+    // 读取数据长度
+    const quint8 dataLength = m_ringBuffer->at(3);
+    const int totalFrameSize = Protocol::MIN_FRAME_SIZE + dataLength;
+    
+    // 检查是否有完整的帧
+    if (m_ringBuffer->size() < totalFrameSize) {
+        return false;
+    }
+    
+    frameView = m_ringBuffer->view(0, totalFrameSize);
+    return true;
+}
+
+bool ProtocolParser::validateFrameView(const FrameView& frameView, ProtocolFrame& frame)
+{
+    // 与 validateFrame 的规则保持一致，但直接在视图上校验，不拷贝数据
+    frame.header = static_cast<quint16>((frameView.at(0) << 8) | frameView.at(1));
+    frame.command = static_cast<ProtocolCommand>(frameView.at(2));
+    frame.dataLength = frameView.at(3);
+    frame.checksum = frameView.at(4 + frame.dataLength);
+    frame.tail = frameView.at(5 + frame.dataLength);
+    
+    if (frame.tail != Protocol::FRAME_TAIL) {
+        LogManager::getInstance()->warning("帧尾错误", "Protocol");
+        return false;
+    }
+    
+    frame.timestampNs = ProtocolFrame::currentTimestampNs();
+    frame.receivedNs = m_receivedNs;
+    
+    // 从命令码到数据区结束的简单累加校验
+    quint8 calculatedChecksum = 0;
+    const int checksumEnd = 4 + frame.dataLength;
+    for (int i = 2; i < checksumEnd; ++i) {
+        calculatedChecksum += frameView.at(i);
+    }
+    
+    if (frame.checksum != calculatedChecksum) {
+        LogManager::getInstance()->warning(
+            QString("校验和错误: 期望=0x%1, 实际=0x%2")
+            .arg(calculatedChecksum, 2, 16, QChar('0'))
+            .arg(frame.checksum, 2, 16, QChar('0')),
+            "Protocol"
+        );
+        emit frameRejected(ProtocolError::ChecksumError);
+        return false;
+    }
+    
+    return true;
+}
+
 // 获取性能统计信息
 QString ProtocolParser::getPerformanceStats() const
 {
@@ -886,7 +1204,7 @@ QString ProtocolParser::getPerformanceStats() const
     double throughput = elapsedSecs > 0 ? 
                        static_cast<double>(m_perfStats.totalBytesProcessed) / elapsedSecs : 0;
     
-    return QString(
+    QString stats = QString(
         "协议解析性能统计:\n"
         "总字节数: %1\n"
         "总帧数: %2\n"
@@ -897,5 +1215,24 @@ QString ProtocolParser::getPerformanceStats() const
      .arg(m_perfStats.totalFramesProcessed)
      .arg(m_perfStats.averageParseTime)
      .arg(throughput, 0, 'f', 2)
-     .arg(receiveBuffer.size());
+     .arg(m_ringBuffer ? m_ringBuffer->size() : receiveBuffer.size());
+    
+    // 各命令处理次数及延迟分布（帧解析完成 → 处理结束）
+    bool hasCommandStats = false;
+    for (int command = 0; command < static_cast<int>(m_commandSlots.size()); ++command) {
+        const LatencyHistogram& latency = m_commandSlots[command].latency;
+        if (latency.count() == 0) {
+            continue;
+        }
+        if (!hasCommandStats) {
+            stats += "命令处理统计:\n";
+            hasCommandStats = true;
+        }
+        stats += QString("  %1 (0x%2): %3\n")
+                 .arg(commandToString(static_cast<ProtocolCommand>(command)))
+                 .arg(command, 2, 16, QChar('0'))
+                 .arg(latency.summary());
+    }
+    
+    return stats;
 } 
\ No newline at end of file
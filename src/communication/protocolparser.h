@@ -5,9 +5,20 @@
 #include <QQueue>
 #include <QTimer>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QList>
 #include <QVariant>
+#include <QMetaType>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
 #include "constants.h"
+#include "ringbuffer.h"
 #include "utils/checksum.h"
+#include "utils/latencyhistogram.h"
 
 // 命令码定义
 enum class ProtocolCommand : quint8 {
@@ -51,6 +62,7 @@ enum class ProtocolCommand : quint8 {
     SetDateTime = 0x32,
     GetDateTime = 0x33,
     Heartbeat = 0x34,
+    NegotiateCompression = 0x35,    // 链路压缩协商，数据为 版本(1) | 算法(1)，响应数据为对端同意的算法
     
     // 升级命令
     StartUpgrade = 0x40,
@@ -74,21 +86,48 @@ enum class ProtocolError : quint8 {
     UnknownError = 0xFF
 };
 
-// 协议帧结构
+// 协议帧结构 - 定长、可平凡拷贝，数据区内联存储
+// 跨线程队列信号只需拷贝一块连续内存，没有引用计数和堆分配；
+// 时间戳取自单调时钟，不受系统时间调整影响，也无需时区换算
 struct ProtocolFrame {
-    quint16 header;      // 帧头 0xAA55
-    ProtocolCommand command; // 命令码
-    quint8 dataLength;   // 数据长度
-    QByteArray data;     // 数据区
-    quint8 checksum;     // 校验和
-    quint8 tail;         // 帧尾 0x0D
-    QDateTime timestamp; // 帧时间戳
+    quint16 header = 0;                             // 帧头 0xAA55
+    ProtocolCommand command = ProtocolCommand::DeviceStatus; // 命令码
+    quint8 dataLength = 0;                          // 数据长度
+    quint8 checksum = 0;                            // 校验和
+    quint8 tail = 0;                                // 帧尾 0x0D
+    qint64 timestampNs = 0;                         // 单调时钟时间戳（纳秒），帧校验通过的时刻
+    qint64 receivedNs = 0;                          // 读到该帧最后一个字节的那次读取的时刻，0 表示未知
+    char data[Protocol::MAX_DATA_SIZE];             // 数据区，有效长度为 dataLength
     
     bool isValid() const {
-        return header == 0xAA55 && tail == 0x0D && data.size() == dataLength;
+        return header == 0xAA55 && tail == 0x0D;
+    }
+    
+    // 设置数据区，超出 MAX_DATA_SIZE 的部分被截断
+    void setData(const char* bytes, int length) {
+        dataLength = static_cast<quint8>(qBound(0, length, Protocol::MAX_DATA_SIZE));
+        if (dataLength > 0) {
+            memcpy(data, bytes, dataLength);
+        }
+    }
+    void setData(const QByteArray& bytes) { setData(bytes.constData(), bytes.size()); }
+    
+    // 以 QByteArray 形式访问数据区（不拷贝，仅在帧对象存活期间有效）
+    QByteArray payload() const { return QByteArray::fromRawData(data, dataLength); }
+    
+    // 单调时钟当前时间（纳秒）
+    static qint64 currentTimestampNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
     }
 };
 
+static_assert(std::is_trivially_copyable_v<ProtocolFrame>, "ProtocolFrame must stay trivially copyable");
+Q_DECLARE_METATYPE(ProtocolFrame)
+
+// 批量投递的帧集合，跨线程时整批只产生一次队列事件
+using FrameBatch = QList<ProtocolFrame>;
+
 class ProtocolParser : public QObject
 {
     Q_OBJECT
@@ -96,8 +135,9 @@ class ProtocolParser : public QObject
 public:
     explicit ProtocolParser(QObject* parent = nullptr);
     
-    // 数据解析
-    void parseData(const QByteArray& data);
+    // 数据解析，receivedNs 为读取这段数据的单调时钟时间（0 表示取当前时间），
+    // 记入由这段数据补全的帧的 ProtocolFrame::receivedNs
+    void parseData(const QByteArray& data, qint64 receivedNs = 0);
     
     // 基础帧构建
     QByteArray buildFrame(ProtocolCommand command, const QByteArray& data = QByteArray());
@@ -110,8 +150,23 @@ public:
     QByteArray buildMotionFrame(double x, double y, double z, double speed);
     QByteArray buildGlueFrame(double volume, double pressure, double temperature, int time);
     
+    // 零分配帧构建：直接序列化到调用方缓冲区（可来自 CommunicationBufferPool），
+    // 使用当前配置的校验类型；缓冲区不足或数据非法时返回空视图。
+    // 返回的视图指向 buffer，buffer 大小可用 requiredFrameSize() 计算
+    int requiredFrameSize(int dataLength) const;
+    FrameView writeFrame(char* buffer, int capacity, ProtocolCommand command,
+                         const char* data = nullptr, int length = 0);
+    FrameView writeHeartbeatFrame(char* buffer, int capacity);
+    FrameView writeParameterFrame(char* buffer, int capacity, const QString& paramName, const QVariant& value);
+    FrameView writeMotionFrame(char* buffer, int capacity, double x, double y, double z, double speed);
+    FrameView writeGlueFrame(char* buffer, int capacity, double volume, double pressure, double temperature, int time);
+    
     // 数据解析
     bool parseParameterResponse(const QByteArray& data, QString& paramName, QVariant& value);
+    // 单个参数条目的编解码（参数名长度 + 参数名 + 类型 + 值），批量参数帧按条目依次拼接；
+    // 编码不支持的类型或超长时返回空，解码返回消耗的字节数，失败返回-1
+    static QByteArray encodeParameterEntry(const QString& paramName, const QVariant& value);
+    static int decodeParameterEntry(const char* data, int length, QString& paramName, QVariant& value);
     bool parseMotionResponse(const QByteArray& data, double& x, double& y, double& z, double& speed);
     bool parseGlueResponse(const QByteArray& data, double& volume, double& pressure, double& temperature, int& time);
     
@@ -130,6 +185,11 @@ public:
     // 工具函数
     static quint8 calculateChecksum(const QByteArray& data);
     static QString commandToString(ProtocolCommand command);
+    
+    // 安全指令（EmergencyStop / DeviceStop / PauseDevice）走快速通道：
+    // 跳过批量投递、处理线程队列、命令窗口和写合并
+    static bool isSafetyCommand(ProtocolCommand command);
+    static bool isSafetyFrame(const QByteArray& frameData);
     static QString errorToString(ProtocolError error);
     
     // 设置超时时间
@@ -138,18 +198,49 @@ public:
     // 清空缓冲区
     void clearBuffer();
     
+    // 环形缓冲区模式（零拷贝接收路径）
+    void setRingBufferMode(bool enabled, int capacity = Protocol::RING_BUFFER_CAPACITY);
+    bool isRingBufferMode() const;
+    
+    // 帧视图处理器：环形缓冲区模式下直接获得帧视图，返回true表示已处理，
+    // 解析器不再拷贝数据构建 ProtocolFrame；视图仅在回调期间有效
+    using FrameViewHandler = std::function<bool(const FrameView& frameView)>;
+    void setFrameViewHandler(FrameViewHandler handler);
+    
+    // 命令分发表：按命令字节直接索引，已注册处理器的命令交由处理器，
+    // 其余命令按普通帧投递（frameReceived / framesReceived）
+    using CommandHandler = std::function<void(const ProtocolFrame& frame)>;
+    void registerCommandHandler(ProtocolCommand command, CommandHandler handler);
+    void unregisterCommandHandler(ProtocolCommand command);
+    
+    // 每个命令的处理次数和延迟（帧解析完成 → 处理结束）统计
+    const LatencyHistogram& commandLatency(ProtocolCommand command) const;
+    void resetCommandStats();
+    
+    // 批量帧投递：累计 maxFrames 帧或最早一帧等待超过 maxLatencyUs 微秒后
+    // 通过 framesReceived 一次性发出；启用期间不再逐帧发出 frameReceived
+    void setBatchDelivery(bool enabled, int maxFrames = Protocol::FRAME_BATCH_SIZE,
+                          int maxLatencyUs = Protocol::FRAME_BATCH_LATENCY_US);
+    bool isBatchDeliveryEnabled() const;
+    void flushFrameBatch();
+    
     // 性能统计
     QString getPerformanceStats() const;
 
 signals:
     void frameReceived(const ProtocolFrame& frame);
+    void framesReceived(const FrameBatch& frames);
     void parseError(const QString& error);
+    void frameRejected(ProtocolError error);     // 收到的帧未通过校验（同线程直连使用）
     void timeoutOccurred();
     
     // 高级信号
-    void heartbeatReceived(qint64 delay);
+    void heartbeatReceived(qint64 rttNs);        // 心跳往返时间(ns)
     void motionDataReceived(double x, double y, double z, double speed);
     void glueDataReceived(double volume, double pressure, double temperature, int time);
+    // 解析成功的运动/点胶采样帧：它们由上面的专用处理器消费，不经 frameReceived 投递。
+    // 帧数据只在发出期间有效，须直接连接
+    void sampleFrameReceived(const ProtocolFrame& frame);
     void parameterReceived(const QString& name, const QVariant& value);
 
 private slots:
@@ -159,9 +250,9 @@ private:
     bool findFrame(QByteArray& frame);
     bool validateFrame(const QByteArray& frameData, ProtocolFrame& frame);
     void processCompleteFrame(const ProtocolFrame& frame);
+    void deliverFrame(const ProtocolFrame& frame);
     
-    // 高级帧处理
-    void processAdvancedFrame(const ProtocolFrame& frame);
+    // 高级帧处理（在构造函数中注册到命令分发表）
     void processHeartbeatFrame(const ProtocolFrame& frame);
     void processMotionFrame(const ProtocolFrame& frame);
     void processGlueFrame(const ProtocolFrame& frame);
@@ -172,7 +263,16 @@ private:
     void optimizeBuffer();
     void preallocateMemory();
     
+    // 环形缓冲区模式相关
+    void parseRingBuffer(const QByteArray& data);
+    bool findFrameInRing(FrameView& frameView);
+    bool validateFrameView(const FrameView& frameView, ProtocolFrame& frame);
+    
+    // 帧写入使用的校验类型（增强校验关闭时为简单校验）
+    ChecksumType frameChecksumType() const;
+    
     QByteArray receiveBuffer;
+    qint64 m_receivedNs;           // 当前 parseData() 的数据读取时刻
     QQueue<ProtocolFrame> frameQueue;
     QTimer* timeoutTimer;
     int timeoutMs;
@@ -187,6 +287,25 @@ private:
     QByteArray m_tempFrameBuffer;  // 临时帧缓冲区（预分配）
     bool m_bufferOptimized;        // 缓冲区是否已优化
     
+    // 环形缓冲区模式
+    std::unique_ptr<ProtocolRingBuffer> m_ringBuffer; // 为空表示使用QByteArray缓冲
+    FrameViewHandler m_frameViewHandler;
+    
+    // 命令分发表，下标为命令字节
+    struct CommandSlot {
+        CommandHandler handler;         // 为空时按普通帧投递
+        LatencyHistogram latency;
+    };
+    std::array<CommandSlot, 256> m_commandSlots;
+    
+    // 批量帧投递
+    bool m_batchDelivery;
+    int m_batchMaxFrames;
+    int m_batchMaxLatencyUs;
+    FrameBatch m_frameBatch;
+    QElapsedTimer m_batchAge;      // 当前批次最早一帧的等待时间
+    QTimer* m_batchTimer;          // 数据停止到达时保证按时投递
+    
     // 性能统计
     struct PerformanceStats {
         qint64 totalBytesProcessed;
@@ -0,0 +1,62 @@
+#include "reconnectscheduler.h"
+#include "../constants.h"
+#include <QRandomGenerator>
+#include <atomic>
+
+namespace {
+
+std::atomic<int> s_inFlight{0};
+std::atomic<int> s_maxConcurrent{Communication::RECONNECT_MAX_CONCURRENT};
+
+// [delay/2, delay] 内取随机值
+int jittered(int delayMs)
+{
+    const int half = delayMs / 2;
+    return half + static_cast<int>(QRandomGenerator::global()->bounded(half + 1));
+}
+
+}
+
+int ReconnectScheduler::backoffDelayMs(int baseMs, int attempt)
+{
+    const qint64 base = qBound(1, baseMs, Communication::RECONNECT_BACKOFF_MAX);
+    const int shift = qBound(0, attempt - 1, 16);
+    const qint64 delay = qMin<qint64>(base << shift, Communication::RECONNECT_BACKOFF_MAX);
+    return jittered(static_cast<int>(delay));
+}
+
+int ReconnectScheduler::deferDelayMs()
+{
+    return jittered(Communication::RECONNECT_DEFER_DELAY * 2);
+}
+
+bool ReconnectScheduler::tryAcquire()
+{
+    int current = s_inFlight.load(std::memory_order_relaxed);
+    while (current < s_maxConcurrent.load(std::memory_order_relaxed)) {
+        if (s_inFlight.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReconnectScheduler::release()
+{
+    s_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+int ReconnectScheduler::inFlight()
+{
+    return s_inFlight.load(std::memory_order_relaxed);
+}
+
+void ReconnectScheduler::setMaxConcurrent(int maxConcurrent)
+{
+    s_maxConcurrent.store(qMax(1, maxConcurrent), std::memory_order_relaxed);
+}
+
+int ReconnectScheduler::maxConcurrent()
+{
+    return s_maxConcurrent.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QtGlobal>
+
+// 重连调度 - 所有连接共享的重连节奏与并发名额
+//
+// 第 n 次重连前等待 base * 2^(n-1)（不超过上限），实际取 [间隔/2, 间隔] 内的随机值，
+// 同一次网络中断后掉线的设备不会同时重试；同时进行中的建连尝试不超过并发上限，
+// 拿不到名额的尝试稍后重排，不消耗重连次数。
+// 名额在建连成功、失败或超时后归还，可在任意线程调用。
+class ReconnectScheduler
+{
+public:
+    // 第 attempt 次重连（从1开始）之前的等待时间
+    static int backoffDelayMs(int baseMs, int attempt);
+    // 名额已满时重排的等待时间
+    static int deferDelayMs();
+
+    static bool tryAcquire();
+    static void release();
+    static int inFlight();
+
+    static void setMaxConcurrent(int maxConcurrent);
+    static int maxConcurrent();
+
+private:
+    ReconnectScheduler() = delete;
+};
@@ -0,0 +1,131 @@
+#include "ringbuffer.h"
+#include "utils/bytescanner.h"
+#include <cstring>
+
+FrameView FrameView::mid(int pos, int length) const
+{
+    FrameView result;
+    if (pos < 0 || length <= 0 || pos >= size()) {
+        return result;
+    }
+    length = qMin(length, size() - pos);
+
+    if (pos < firstLength) {
+        result.first = first + pos;
+        result.firstLength = qMin(length, firstLength - pos);
+        if (result.firstLength < length) {
+            result.second = second;
+            result.secondLength = length - result.firstLength;
+        }
+    } else {
+        result.first = second + (pos - firstLength);
+        result.firstLength = length;
+    }
+    return result;
+}
+
+void FrameView::copyTo(char* dest) const
+{
+    if (firstLength > 0) {
+        memcpy(dest, first, firstLength);
+    }
+    if (secondLength > 0) {
+        memcpy(dest + firstLength, second, secondLength);
+    }
+}
+
+QByteArray FrameView::toByteArray() const
+{
+    QByteArray result(size(), Qt::Uninitialized);
+    copyTo(result.data());
+    return result;
+}
+
+ProtocolRingBuffer::ProtocolRingBuffer(int capacity)
+    : m_capacity(1)
+    , m_mask(0)
+    , m_readPos(0)
+    , m_size(0)
+{
+    // 向上取整到2的幂
+    while (m_capacity < qMax(capacity, Protocol::MAX_FRAME_SIZE)) {
+        m_capacity <<= 1;
+    }
+    m_mask = m_capacity - 1;
+    m_storage.resize(m_capacity);
+}
+
+bool ProtocolRingBuffer::write(const char* data, int length)
+{
+    if (length <= 0) return true;
+    if (length > freeSpace()) return false;
+
+    const int writePos = (m_readPos + m_size) & m_mask;
+    const int firstPart = qMin(length, m_capacity - writePos);
+    memcpy(m_storage.data() + writePos, data, firstPart);
+    if (firstPart < length) {
+        memcpy(m_storage.data(), data + firstPart, length - firstPart);
+    }
+    m_size += length;
+    return true;
+}
+
+int ProtocolRingBuffer::indexOfHeader(quint16 header, int from) const
+{
+    const quint8 highByte = static_cast<quint8>((header >> 8) & 0xFF);
+    const quint8 lowByte = static_cast<quint8>(header & 0xFF);
+
+    int offset = qMax(from, 0);
+    while (offset < m_size - 1) {
+        // 按物理连续段调用SIMD扫描内核，避免逐字节取模
+        const int physical = (m_readPos + offset) & m_mask;
+        const int segmentLength = qMin(m_size - offset, m_capacity - physical);
+
+        const int hit = ByteScanner::findPair(m_storage.constData() + physical, segmentLength,
+                                              highByte, lowByte);
+        if (hit >= 0) {
+            return offset + hit;
+        }
+
+        // 检查跨越回绕点的那一对字节
+        offset += segmentLength;
+        if (offset < m_size && at(offset - 1) == highByte && at(offset) == lowByte) {
+            return offset - 1;
+        }
+    }
+    return -1;
+}
+
+FrameView ProtocolRingBuffer::view(int offset, int length) const
+{
+    FrameView result;
+    if (offset < 0 || length <= 0 || offset + length > m_size) {
+        return result;
+    }
+
+    const int physical = (m_readPos + offset) & m_mask;
+    result.first = m_storage.constData() + physical;
+    result.firstLength = qMin(length, m_capacity - physical);
+    if (result.firstLength < length) {
+        result.second = m_storage.constData();
+        result.secondLength = length - result.firstLength;
+    }
+    return result;
+}
+
+void ProtocolRingBuffer::consume(int length)
+{
+    length = qBound(0, length, m_size);
+    m_readPos = (m_readPos + length) & m_mask;
+    m_size -= length;
+    if (m_size == 0) {
+        // 缓冲区为空时复位读位置，减少后续帧跨越回绕点的概率
+        m_readPos = 0;
+    }
+}
+
+void ProtocolRingBuffer::clear()
+{
+    m_readPos = 0;
+    m_size = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include "constants.h"
+
+// 帧视图 - 指向环形缓冲区内的一段数据，可能跨越回绕点分成两段
+// 视图不持有数据，只在缓冲区下一次写入/消费之前有效
+struct FrameView {
+    const char* first = nullptr;    // 第一段起始地址
+    int firstLength = 0;            // 第一段长度
+    const char* second = nullptr;   // 第二段起始地址（回绕部分）
+    int secondLength = 0;           // 第二段长度
+
+    int size() const { return firstLength + secondLength; }
+    bool isEmpty() const { return size() == 0; }
+    bool isContiguous() const { return secondLength == 0; }
+
+    quint8 at(int index) const {
+        return static_cast<quint8>(index < firstLength ? first[index] : second[index - firstLength]);
+    }
+
+    // 截取子视图（不拷贝）
+    FrameView mid(int pos, int length) const;
+
+    // 拷贝到调用方提供的缓冲区，调用方保证 dest 至少有 size() 字节
+    void copyTo(char* dest) const;
+
+    // 需要持有数据时才进行拷贝
+    QByteArray toByteArray() const;
+};
+
+// 固定容量环形缓冲区 - 用于协议解析的零拷贝接收路径
+class ProtocolRingBuffer
+{
+public:
+    // 容量会向上取整到2的幂，便于用掩码回绕
+    explicit ProtocolRingBuffer(int capacity = Protocol::RING_BUFFER_CAPACITY);
+
+    int capacity() const { return m_capacity; }
+    int size() const { return m_size; }
+    int freeSpace() const { return m_capacity - m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // 写入数据，空间不足时不写入并返回false
+    bool write(const char* data, int length);
+    bool write(const QByteArray& data) { return write(data.constData(), data.size()); }
+
+    // 读取指定偏移处的字节（相对于当前读位置）
+    quint8 at(int offset) const {
+        return static_cast<quint8>(m_storage[(m_readPos + offset) & m_mask]);
+    }
+
+    // 在缓冲区中原地查找双字节帧头，返回相对偏移，未找到返回-1
+    int indexOfHeader(quint16 header, int from = 0) const;
+
+    // 获取指定区间的帧视图
+    FrameView view(int offset, int length) const;
+
+    // 消费（丢弃）已处理的数据
+    void consume(int length);
+    void clear();
+
+private:
+    QByteArray m_storage;
+    int m_capacity;
+    int m_mask;
+    int m_readPos;
+    int m_size;
+};
@@ -1,5 +1,8 @@
 #include "serialcommunication.h"
 #include "logger/logmanager.h"
+#include "reconnectscheduler.h"
+#include "seriallatency.h"
+#include "livedatafeed.h"
 #include "constants.h"
 #include <QDebug>
 #include <QDateTime>
@@ -188,8 +191,8 @@ bool SerialCommunication::sendFrame(ProtocolCommand command, const QByteArray& d
     if (sendData(frameData)) {
         ProtocolFrame frame;
         frame.command = command;
-        frame.data = data;
-        frame.timestamp = QDateTime::currentDateTime();
+        frame.setData(data);
+        frame.timestampNs = ProtocolFrame::currentTimestampNs();
         
         emit frameSent(frame);
         return true;
@@ -256,6 +259,9 @@ bool SerialCommunication::updateConfig(const QString& key, const QVariant& value
     } else if (key == "flowControl") {
         m_config.flowControl = static_cast<QSerialPort::FlowControl>(value.toInt());
         updated = true;
+    } else if (key == "lowLatency") {
+        m_config.lowLatency = value.toBool();
+        updated = true;
     } else if (key == "timeout") {
         m_config.timeout = value.toInt();
         updated = true;
@@ -299,6 +305,7 @@ CommunicationStats SerialCommunication::getStatistics() const
 void SerialCommunication::resetStatistics()
 {
     m_statistics.reset();
+    resetHeartbeatHistogram();
     emit statisticsUpdated(m_statistics);
 }
 
@@ -485,10 +492,12 @@ void SerialCommunication::reconnect()
         disconnect();
     }
     
-    // 延迟重连
-    QTimer::singleShot(m_config.reconnectInterval, this, [this]() {
-        connect(m_config);
-    });
+    // 按退避间隔重连
+    stopReconnectTimer();
+    markOutage();
+    resetReconnectAttempts();
+    setState(ConnectionState::Reconnecting);
+    startReconnectTimer();
 }
 
 void SerialCommunication::startHeartbeat()
@@ -514,6 +523,7 @@ void SerialCommunication::stopHeartbeat()
 void SerialCommunication::updateStatistics()
 {
     updateConnectionStatistics();
+    publishMetrics();
     emit statisticsUpdated(m_statistics);
 }
 
@@ -556,15 +566,20 @@ void SerialCommunication::onReconnectTimer()
             if (connect(m_config)) {
                 stopReconnectTimer();
                 resetReconnectAttempts();
+                recordRecovery();
+                logMessage(QString("重连成功，恢复用时 %1 ms").arg(m_statistics.lastRecoveryMs), "INFO");
             } else {
                 // 继续重连
                 startReconnectTimer();
             }
         } else {
-            // 重连次数用完
+            // 重连次数用完，不再经 handleError 触发新一轮重连
             stopReconnectTimer();
+            m_outageStartMs = 0;
             setState(ConnectionState::Disconnected);
-            handleError("重连失败，已达到最大重连次数");
+            m_lastError = "重连失败，已达到最大重连次数";
+            logMessage(m_lastError, "ERROR");
+            emit connectionError(m_lastError);
         }
     }
 }
@@ -637,6 +652,7 @@ void SerialCommunication::setState(ConnectionState state)
 {
     if (m_connectionState != state) {
         m_connectionState = state;
+        publishMetrics();
         emit connectionStateChanged(state);
         
         if (state == ConnectionState::Connected) {
@@ -665,6 +681,7 @@ void SerialCommunication::handleError(const QString& error)
     
     // 自动重连
     if (m_autoReconnectEnabled && m_connectionState != ConnectionState::Reconnecting) {
+        markOutage();
         setState(ConnectionState::Reconnecting);
         startReconnectTimer();
     }
@@ -753,6 +770,12 @@ bool SerialCommunication::openSerialPort()
         return false;
     }
     
+    if (m_config.lowLatency) {
+        const SerialLatency::Report report = SerialLatency::apply(m_serialPort);
+        logMessage(QString("低延迟串口模式 %1: %2").arg(m_config.portName, report.summary()),
+                   report.fullyApplied() ? "INFO" : "WARNING");
+    }
+    
     // 设置连接状态
     setState(ConnectionState::Connected);
     
@@ -796,7 +819,8 @@ void SerialCommunication::stopConnectionTimer()
 void SerialCommunication::startReconnectTimer()
 {
     if (m_reconnectTimer) {
-        m_reconnectTimer->start(m_config.reconnectInterval);
+        m_reconnectTimer->start(
+            ReconnectScheduler::backoffDelayMs(m_config.reconnectInterval, m_currentReconnectAttempts + 1));
     }
 }
 
@@ -870,7 +894,16 @@ void SerialCommunication::connectSignals()
     // 协议解析器信号连接
     QObject::connect(m_protocolParser, &ProtocolParser::frameReceived, this, &ICommunication::frameReceived);
     QObject::connect(m_protocolParser, &ProtocolParser::parseError, this, &ICommunication::protocolError);
-    QObject::connect(m_protocolParser, &ProtocolParser::heartbeatReceived, this, &ICommunication::heartbeatReceived);
+    QObject::connect(m_protocolParser, &ProtocolParser::frameReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
+    QObject::connect(m_protocolParser, &ProtocolParser::framesReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrames, Qt::DirectConnection);
+    QObject::connect(m_protocolParser, &ProtocolParser::sampleFrameReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
+    QObject::connect(m_protocolParser, &ProtocolParser::heartbeatReceived, this, [this](qint64 rttNs) {
+        recordHeartbeatRtt(rttNs);
+        emit heartbeatReceived(rttNs);
+    });
 }
 
 void SerialCommunication::processReceivedData(const QByteArray& data)
@@ -892,8 +925,8 @@ void SerialCommunication::updateConnectionStatistics()
 
 void SerialCommunication::calculateLatency()
 {
-    // 串口通讯延迟计算相对简单，主要基于波特率
-    if (m_config.baudRate > 0) {
+    // 已有心跳往返样本时平均延迟由 recordHeartbeatRtt() 维护，否则按波特率估算
+    if (m_statistics.heartbeatCount == 0 && m_config.baudRate > 0) {
         // 估算延迟 = 数据位数 / 波特率 * 1000 (ms)
         double bitsPerByte = 8 + 1 + 1; // 数据位 + 起始位 + 停止位
         double latency = (bitsPerByte / m_config.baudRate) * 1000;
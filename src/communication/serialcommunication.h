@@ -15,6 +15,7 @@ struct SerialConfig : public CommunicationConfig {
     QSerialPort::Parity parity;
     QSerialPort::StopBits stopBits;
     QSerialPort::FlowControl flowControl;
+    bool lowLatency;            // 打开后应用低延迟串口模式（见 SerialLatency）
     
     SerialConfig() : CommunicationConfig() {
         type = CommunicationType::Serial;
@@ -25,10 +26,15 @@ struct SerialConfig : public CommunicationConfig {
         parity = QSerialPort::NoParity;
         stopBits = static_cast<QSerialPort::StopBits>(Communication::DEFAULT_STOP_BITS);
         flowControl = QSerialPort::NoFlowControl;
+        lowLatency = false;
     }
     
     // 从基类转换
+    // 传入的本身就是 SerialConfig 时保留全部字段
     static SerialConfig fromBase(const CommunicationConfig& base) {
+        if (const SerialConfig* derived = dynamic_cast<const SerialConfig*>(&base)) {
+            return *derived;
+        }
         SerialConfig config;
         config.name = base.name;
         config.autoReconnect = base.autoReconnect;
@@ -0,0 +1,183 @@
+#include "seriallatency.h"
+#include "constants.h"
+
+#if defined(Q_OS_LINUX)
+#include <QFile>
+#include <cerrno>
+#include <cstring>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#elif defined(Q_OS_WIN)
+#include <QSerialPortInfo>
+#include <QSettings>
+#include <windows.h>
+#endif
+
+namespace {
+#if defined(Q_OS_LINUX)
+QString lastSystemError()
+{
+    return QString::fromLocal8Bit(strerror(errno));
+}
+
+// usb-serial 驱动（ftdi_sio 等）在 sysfs 中导出延迟定时器，写入需要 root 或 udev 规则授权
+void applyUsbSerialLatencyTimer(const QSerialPort* port, SerialLatency::Report& report)
+{
+    QFile timer(QString("/sys/bus/usb-serial/devices/%1/latency_timer").arg(port->portName()));
+    if (!timer.exists()) {
+        return;
+    }
+    if (timer.open(QIODevice::ReadOnly)) {
+        report.latencyTimerMs = timer.readAll().trimmed().toInt();
+        timer.close();
+    }
+    if (report.latencyTimerMs >= 0 && report.latencyTimerMs <= Communication::SERIAL_FTDI_LATENCY_TIMER_MS) {
+        return;
+    }
+    if (timer.open(QIODevice::WriteOnly)
+        && timer.write(QByteArray::number(Communication::SERIAL_FTDI_LATENCY_TIMER_MS)) > 0) {
+        report.latencyTimerMs = Communication::SERIAL_FTDI_LATENCY_TIMER_MS;
+    } else {
+        report.notes << QString("无法写入 %1（需要写权限），延迟定时器仍为 %2ms")
+                            .arg(timer.fileName()).arg(report.latencyTimerMs);
+    }
+}
+#endif
+
+#if defined(Q_OS_WIN)
+constexpr quint16 FTDI_VENDOR_ID = 0x0403;
+
+bool isFtdi(const QSerialPort* port)
+{
+    const QSerialPortInfo info(*port);
+    return info.hasVendorIdentifier() && info.vendorIdentifier() == FTDI_VENDOR_ID;
+}
+
+// FTDI VCP 驱动在设备启动时读取注册表 Device Parameters\LatencyTimer
+void applyFtdiRegistryLatencyTimer(const QSerialPort* port, SerialLatency::Report& report)
+{
+    QSettings ftdiBus("HKEY_LOCAL_MACHINE\\SYSTEM\\CurrentControlSet\\Enum\\FTDIBUS", QSettings::NativeFormat);
+    for (const QString& device : ftdiBus.childGroups()) {
+        const QString parameters = device + "/0000/Device Parameters/";
+        if (ftdiBus.value(parameters + "PortName").toString().compare(port->portName(), Qt::CaseInsensitive) != 0) {
+            continue;
+        }
+        report.latencyTimerMs = ftdiBus.value(parameters + "LatencyTimer", -1).toInt();
+        if (report.latencyTimerMs >= 0 && report.latencyTimerMs <= Communication::SERIAL_FTDI_LATENCY_TIMER_MS) {
+            return;
+        }
+        ftdiBus.setValue(parameters + "LatencyTimer", Communication::SERIAL_FTDI_LATENCY_TIMER_MS);
+        ftdiBus.sync();
+        if (ftdiBus.status() == QSettings::NoError) {
+            report.notes << QString("已把 LatencyTimer 由 %1ms 改为 %2ms，重新插拔适配器后生效")
+                                .arg(report.latencyTimerMs).arg(Communication::SERIAL_FTDI_LATENCY_TIMER_MS);
+        } else {
+            report.notes << QString("无法改写 LatencyTimer（需要管理员权限），延迟定时器仍为 %1ms")
+                                .arg(report.latencyTimerMs);
+        }
+        return;
+    }
+    report.notes << "注册表中未找到该 FTDI 串口的 LatencyTimer";
+}
+#endif
+}
+
+QString SerialLatency::Report::summary() const
+{
+    QString text = QString("内核低延迟: %1，读取时序: %2，延迟定时器: %3，读缓冲区: %4 字节")
+                       .arg(kernelLowLatency ? "已设置" : "未设置", readTiming ? "已设置" : "未设置",
+                            latencyTimerMs >= 0 ? QString("%1ms").arg(latencyTimerMs) : QString("未知"))
+                       .arg(readBufferSize);
+    if (!notes.isEmpty()) {
+        text += "；" + notes.join("；");
+    }
+    return text;
+}
+
+SerialLatency::Report SerialLatency::apply(QSerialPort* port)
+{
+    Report report;
+    if (!port || !port->isOpen()) {
+        report.notes << "串口未打开";
+        return report;
+    }
+
+    report.readBufferSize = readBufferSizeFor(port->baudRate(), bitsPerCharacter(port));
+    port->setReadBufferSize(report.readBufferSize);
+
+    applyPlatform(port, report);
+    return report;
+}
+
+int SerialLatency::bitsPerCharacter(const QSerialPort* port)
+{
+    int bits = 1 + static_cast<int>(port->dataBits());
+    if (port->parity() != QSerialPort::NoParity) {
+        ++bits;
+    }
+    bits += port->stopBits() == QSerialPort::OneStop ? 1 : 2;
+    return bits;
+}
+
+qint64 SerialLatency::readBufferSizeFor(qint32 baudRate, int bitsPerCharacter)
+{
+    if (baudRate <= 0 || bitsPerCharacter <= 0) {
+        return Communication::SERIAL_READ_BUFFER_MIN;
+    }
+    const qint64 bytesPerSecond = baudRate / bitsPerCharacter;
+    return qMax<qint64>(Communication::SERIAL_READ_BUFFER_MIN,
+                        bytesPerSecond * Communication::SERIAL_READ_BUFFER_WINDOW_MS / 1000);
+}
+
+void SerialLatency::applyPlatform(QSerialPort* port, Report& report)
+{
+#if defined(Q_OS_LINUX)
+    const int fd = static_cast<int>(port->handle());
+
+    serial_struct serial{};
+    if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        report.kernelLowLatency = ioctl(fd, TIOCSSERIAL, &serial) == 0;
+    }
+    if (!report.kernelLowLatency) {
+        report.notes << QString("ASYNC_LOW_LATENCY 未设置: %1").arg(lastSystemError());
+    }
+
+    // QSerialPort 以非阻塞方式读取，VMIN=1 让可读通知在第一个字节到达时就发出
+    termios tio{};
+    if (tcgetattr(fd, &tio) == 0) {
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        report.readTiming = tcsetattr(fd, TCSANOW, &tio) == 0;
+    }
+    if (!report.readTiming) {
+        report.notes << QString("VMIN/VTIME 未设置: %1").arg(lastSystemError());
+    }
+
+    applyUsbSerialLatencyTimer(port, report);
+#elif defined(Q_OS_WIN)
+    const HANDLE handle = port->handle();
+
+    // 有数据时读请求立即带着已到达的字节完成，没有数据时等到第一个字节；
+    // 空闲超时到期后 QSerialPort 重新发起读请求
+    COMMTIMEOUTS timeouts{};
+    if (GetCommTimeouts(handle, &timeouts)) {
+        timeouts.ReadIntervalTimeout = MAXDWORD;
+        timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+        timeouts.ReadTotalTimeoutConstant = Communication::SERIAL_READ_IDLE_TIMEOUT_MS;
+        report.kernelLowLatency = SetCommTimeouts(handle, &timeouts) != 0;
+    }
+    report.readTiming = report.kernelLowLatency;
+    if (!report.kernelLowLatency) {
+        report.notes << QString("COMMTIMEOUTS 未设置，错误码 %1").arg(GetLastError());
+    }
+
+    if (isFtdi(port)) {
+        applyFtdiRegistryLatencyTimer(port, report);
+    }
+#else
+    Q_UNUSED(port)
+    report.notes << "当前平台不支持低延迟串口设置";
+#endif
+}
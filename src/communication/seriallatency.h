@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringList>
+#include <QSerialPort>
+
+// 低延迟串口模式 - 去掉驱动和适配器在字节到达与 readyRead 之间加入的等待
+//
+// USB 转串口适配器（FTDI 最常见）默认攒满缓冲区或等延迟定时器到期（16ms）才把数据交给主机，
+// 短帧的应答因此最多晚 16ms。在串口打开之后调用 apply()：
+//   Linux    TIOCSSERIAL 设置 ASYNC_LOW_LATENCY（ftdi_sio 据此把延迟定时器降为 1ms），
+//            termios 设为 VMIN=1、VTIME=0，第一个字节即可读，不等字节间定时器；
+//            usb-serial 设备再写 sysfs 的 latency_timer。
+//   Windows  COMMTIMEOUTS 设为读请求在第一个字节到达时完成；
+//            FTDI 适配器检查注册表中的 LatencyTimer，偏大时尝试改写（需要管理员权限，重新打开串口后生效）。
+// 读缓冲区按波特率设为 SERIAL_READ_BUFFER_WINDOW_MS 的线路数据量，消费方短暂停顿时不丢数据，
+// 也不会无限增长。每项调整失败只记录在结果中，串口按驱动默认设置继续工作。
+class SerialLatency
+{
+public:
+    struct Report {
+        bool kernelLowLatency = false;  // ASYNC_LOW_LATENCY / COMMTIMEOUTS 已设置
+        bool readTiming = false;        // VMIN/VTIME 已设置（Windows 与 kernelLowLatency 相同）
+        int latencyTimerMs = -1;        // 适配器延迟定时器的当前值，-1 为未知或不是 FTDI
+        qint64 readBufferSize = 0;
+        QStringList notes;              // 未能调整的项及原因
+
+        bool fullyApplied() const { return kernelLowLatency && readTiming && notes.isEmpty(); }
+        QString summary() const;
+    };
+
+    // port 必须已打开
+    static Report apply(QSerialPort* port);
+
+    // 一字节在线路上占用的位数（起始位 + 数据位 + 校验位 + 停止位）
+    static int bitsPerCharacter(const QSerialPort* port);
+    // 按当前波特率和字符格式计算的读缓冲区大小
+    static qint64 readBufferSizeFor(qint32 baudRate, int bitsPerCharacter);
+
+private:
+    static void applyPlatform(QSerialPort* port, Report& report);
+
+    SerialLatency() = delete;
+};
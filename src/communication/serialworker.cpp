@@ -1,16 +1,33 @@
 #include "serialworker.h"
 #include "logger/logmanager.h"
+#include "reconnectscheduler.h"
+#include "seriallatency.h"
+#include "livedatafeed.h"
 #include "constants.h"
+#include "utils/fastlane.h"
+#include "utils/tracer.h"
+#include "utils/allocationtracker.h"
+#include "utils/threadpolicy.h"
+#include <QDateTime>
 #include <QDebug>
 
 SerialWorker::SerialWorker(QObject* parent)
     : QObject(parent)
     , serialPort(nullptr)
     , protocolParser(nullptr)
+    , commandPipeline(nullptr)
+    , firmwareUpgrader(nullptr)
+    , trajectoryStreamer(nullptr)
+    , parameterSync(nullptr)
+    , writeCoalescing(false)
+    , coalesceByteBudget(Communication::WRITE_COALESCE_BYTE_BUDGET)
+    , coalesceDeadlineUs(Communication::WRITE_COALESCE_DEADLINE_US)
+    , queuedBytes(0)
     , connectionState(SerialConnectionState::Disconnected)
     , maxReconnectAttempts(Protocol::MAX_RECONNECT_ATTEMPTS)  // 默认最多重连3次
     , currentReconnectAttempts(0)
     , silentMode(false)  // 默认非静默模式
+    , outageStartMs(0)
     , bytesReceived(0)
     , bytesSent(0)
 {
@@ -20,6 +37,21 @@ SerialWorker::SerialWorker(QObject* parent)
     // 创建协议解析器
     protocolParser = new ProtocolParser(this);
     
+    // 创建命令管线，响应帧由解析器信号在本线程内直接送入
+    commandPipeline = new CommandPipeline(protocolParser,
+                                          [this](const QByteArray& frame) { return writeFrame(frame); }, this);
+    firmwareUpgrader = new FirmwareUpgrader(protocolParser,
+                                            [this](const QByteArray& frame) { return writeFrame(frame); }, this);
+    trajectoryStreamer = new TrajectoryStreamer(protocolParser,
+                                                [this](const QByteArray& frame) { return writeFrame(frame); }, this);
+    parameterSync = new ParameterSynchronizer(commandPipeline, this);
+    
+    // 写合并截止定时器
+    coalesceTimer = new QTimer(this);
+    coalesceTimer->setSingleShot(true);
+    coalesceTimer->setTimerType(Qt::PreciseTimer);
+    connect(coalesceTimer, &QTimer::timeout, this, &SerialWorker::flushSendQueue);
+    
     // 连接信号
     connect(serialPort, &QSerialPort::readyRead, this, &SerialWorker::onReadyRead);
     connect(serialPort, &QSerialPort::bytesWritten, this, &SerialWorker::onBytesWritten);
@@ -28,8 +60,36 @@ SerialWorker::SerialWorker(QObject* parent)
     
     connect(protocolParser, &ProtocolParser::frameReceived, 
             this, &SerialWorker::onProtocolFrameReceived);
+    connect(protocolParser, &ProtocolParser::framesReceived,
+            this, &SerialWorker::framesReceived);
+    connect(protocolParser, &ProtocolParser::frameReceived,
+            commandPipeline, &CommandPipeline::handleFrame);
+    connect(protocolParser, &ProtocolParser::framesReceived,
+            commandPipeline, &CommandPipeline::handleFrames);
+    connect(protocolParser, &ProtocolParser::frameReceived,
+            firmwareUpgrader, &FirmwareUpgrader::handleFrame);
+    connect(protocolParser, &ProtocolParser::framesReceived,
+            firmwareUpgrader, &FirmwareUpgrader::handleFrames);
+    connect(protocolParser, &ProtocolParser::frameReceived,
+            trajectoryStreamer, &TrajectoryStreamer::handleFrame);
+    connect(protocolParser, &ProtocolParser::framesReceived,
+            trajectoryStreamer, &TrajectoryStreamer::handleFrames);
+    // 实时数据共享内存在接收线程直接写入（发布对象属于主线程，必须显式直接连接）
+    connect(protocolParser, &ProtocolParser::frameReceived,
+            LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
+    connect(protocolParser, &ProtocolParser::framesReceived,
+            LiveDataFeed::getInstance(), &LiveDataFeed::publishFrames, Qt::DirectConnection);
+    connect(protocolParser, &ProtocolParser::sampleFrameReceived,
+            LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
     connect(protocolParser, &ProtocolParser::parseError, 
             this, &SerialWorker::onProtocolParseError);
+    // 校验失败时写出采样模式下缓存的触发前收发记录
+    connect(protocolParser, &ProtocolParser::frameRejected, this, [this](ProtocolError error) {
+        LogManager::getInstance()->triggerCommunicationTrace(config.portName, ProtocolParser::errorToString(error));
+    });
+    
+    // 高帧率下逐帧跨线程投递的事件开销过大，默认按批投递
+    protocolParser->setBatchDelivery(true);
     
     // 创建重连定时器
     reconnectTimer = new QTimer(this);
@@ -51,6 +111,8 @@ SerialWorker::SerialWorker(QObject* parent)
 
 SerialWorker::~SerialWorker()
 {
+    // 析构时工作线程可能已退出，直接结束抓包
+    captureWriter.reset();
     closePort();
     LogManager::getInstance()->info("串口通讯模块已关闭", "Serial");
 }
@@ -65,6 +127,9 @@ bool SerialWorker::openPort(const SerialConfig& config)
     this->config = config;
     setState(SerialConnectionState::Connecting);
     
+    // 移入独立线程时在首次打开串口时应用调度策略，留在主线程时不调整
+    ThreadPolicy::getInstance()->applyToCurrentThread(ThreadRole::SerialIo);
+    
     // 配置串口
     serialPort->setPortName(config.portName);
     serialPort->setBaudRate(config.baudRate);
@@ -81,6 +146,16 @@ bool SerialWorker::openPort(const SerialConfig& config)
         return false;
     }
     
+    if (config.lowLatency) {
+        const SerialLatency::Report report = SerialLatency::apply(serialPort);
+        const QString message = QString("低延迟串口模式 %1: %2").arg(config.portName, report.summary());
+        if (report.fullyApplied()) {
+            LogManager::getInstance()->info(message, "Serial");
+        } else {
+            LogManager::getInstance()->warning(message, "Serial");
+        }
+    }
+    
     // 启动连接超时定时器
     connectionTimer->start(Protocol::CONNECTION_TIMEOUT);
     
@@ -96,6 +171,11 @@ bool SerialWorker::openPort(const SerialConfig& config)
     );
     
     emit connected();
+    
+    // 重连：断开期间设备参数可能被改写，哈希一致时不会全量读取
+    if (parameterSync->isShadowValid()) {
+        parameterSync->refresh();
+    }
     return true;
 }
 
@@ -106,6 +186,17 @@ void SerialWorker::closePort()
         setState(SerialConnectionState::Disconnected);
         stopReconnectTimer();
         connectionTimer->stop();
+        commandPipeline->cancelAll();
+        firmwareUpgrader->suspend();
+        trajectoryStreamer->suspend();
+        
+        // 丢弃尚未写出的合并数据
+        coalesceTimer->stop();
+        {
+            QMutexLocker locker(&dataMutex);
+            sendQueue.clear();
+            queuedBytes = 0;
+        }
         
         LogManager::getInstance()->info(
             QString("串口已关闭: %1").arg(config.portName),
@@ -151,6 +242,10 @@ bool SerialWorker::sendData(const QByteArray& data)
         );
     }
     
+    if (captureWriter) {
+        captureWriter->recordSent(data.constData(), static_cast<int>(bytesWritten));
+    }
+    
     // 记录发送的数据
     LOG_COMM_TX(data, config.portName);
     
@@ -165,7 +260,100 @@ bool SerialWorker::sendFrame(ProtocolCommand command, const QByteArray& data)
         return false;
     }
     
-    return sendData(frame);
+    return writeFrame(frame);
+}
+
+bool SerialWorker::writeFrame(const QByteArray& frame)
+{
+    if (ProtocolParser::isSafetyFrame(frame)) {
+        return sendSafetyFrame(frame);
+    }
+    if (!writeCoalescing) {
+        return sendData(frame);
+    }
+    
+    if (!isConnected()) {
+        LogManager::getInstance()->warning("串口未连接，无法发送数据", "Serial");
+        return false;
+    }
+    
+    bool budgetReached = false;
+    bool firstFrame = false;
+    {
+        QMutexLocker locker(&dataMutex);
+        firstFrame = sendQueue.isEmpty();
+        sendQueue.enqueue(frame);
+        queuedBytes += frame.size();
+        budgetReached = queuedBytes >= coalesceByteBudget;
+    }
+    
+    if (budgetReached) {
+        flushSendQueue();
+    } else if (firstFrame) {
+        // 截止时间从首帧入队开始计算
+        coalesceTimer->start(qMax(1, (coalesceDeadlineUs + 999) / 1000));
+    }
+    return true;
+}
+
+bool SerialWorker::sendSafetyFrame(const QByteArray& frame)
+{
+    // 安全帧越过 sendQueue 中尚未合并写出的帧，写入后立即刷新到驱动，
+    // 不等待事件循环的写通知
+    const qint64 startNs = ProtocolFrame::currentTimestampNs();
+    if (!sendData(frame)) {
+        return false;
+    }
+    serialPort->flush();
+    FastLaneMonitor::getInstance()->record(FastLaneStage::Transport, ProtocolFrame::currentTimestampNs() - startNs);
+    return true;
+}
+
+void SerialWorker::setWriteCoalescing(bool enabled, int byteBudget, int deadlineUs)
+{
+    if (!enabled) {
+        flushSendQueue();
+    }
+    
+    writeCoalescing = enabled;
+    coalesceByteBudget = qBound(Protocol::MAX_FRAME_SIZE, byteBudget, Communication::SEND_BUFFER_SIZE * 64);
+    coalesceDeadlineUs = qMax(0, deadlineUs);
+    
+    LogManager::getInstance()->info(
+        enabled ? QString("写合并已启用，字节上限: %1，截止时间: %2us").arg(coalesceByteBudget).arg(coalesceDeadlineUs)
+                : QString("写合并已禁用"),
+        "Serial"
+    );
+}
+
+bool SerialWorker::isWriteCoalescingEnabled() const
+{
+    return writeCoalescing;
+}
+
+void SerialWorker::flushSendQueue()
+{
+    coalesceTimer->stop();
+    
+    QByteArray batch;
+    {
+        QMutexLocker locker(&dataMutex);
+        if (sendQueue.isEmpty()) {
+            return;
+        }
+        if (sendQueue.size() == 1) {
+            batch = sendQueue.dequeue();
+        } else {
+            batch.reserve(queuedBytes);
+            while (!sendQueue.isEmpty()) {
+                batch.append(sendQueue.dequeue());
+            }
+        }
+        queuedBytes = 0;
+    }
+    
+    // 合并后的数据一次写入串口
+    sendData(batch);
 }
 
 void SerialWorker::setConfig(const SerialConfig& config)
@@ -271,16 +459,58 @@ void SerialWorker::resetStatistics()
     LogManager::getInstance()->info("统计信息已重置", "Serial");
 }
 
+bool SerialWorker::startCapture(const QString& filePath)
+{
+    // 写入器只在串口所在线程使用
+    if (QThread::currentThread() != thread()) {
+        bool result = false;
+        QMetaObject::invokeMethod(this, [this, &result, filePath]() { result = startCapture(filePath); },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+    
+    auto writer = std::make_unique<LinkCaptureWriter>();
+    if (!writer->open(filePath, CaptureLinkType::Serial, config.portName)) {
+        handleError(writer->lastError());
+        return false;
+    }
+    captureWriter = std::move(writer);
+    return true;
+}
+
+void SerialWorker::stopCapture()
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() { stopCapture(); }, Qt::BlockingQueuedConnection);
+        return;
+    }
+    captureWriter.reset();
+}
+
+bool SerialWorker::isCapturing() const
+{
+    return captureWriter != nullptr;
+}
+
 void SerialWorker::onReadyRead()
 {
     if (!serialPort) return;
     
+    TRACE_SCOPE("serial", "SerialWorker::onReadyRead");
+    ALLOCATION_SCOPE("serial.read");
     QByteArray data = serialPort->readAll();
     if (data.isEmpty()) return;
+    // 端到端延迟的起点：这次读取补全的帧都以此为读取时刻
+    const qint64 receivedNs = ProtocolFrame::currentTimestampNs();
+    TRACE_COUNTER("serial", "rxBytes", data.size());
     
     // 更新统计信息
     bytesReceived += data.size();
     
+    if (captureWriter) {
+        captureWriter->recordReceived(data);
+    }
+    
     // 记录接收的数据
     LOG_COMM_RX(data, config.portName);
     
@@ -288,7 +518,7 @@ void SerialWorker::onReadyRead()
     emit dataReceived(data);
     
     // 协议解析
-    protocolParser->parseData(data);
+    protocolParser->parseData(data, receivedNs);
 }
 
 void SerialWorker::onBytesWritten(qint64 bytes)
@@ -355,7 +585,10 @@ void SerialWorker::onReconnectTimer()
         if (openPort(config)) {
             // 重连成功，重置计数器
             currentReconnectAttempts = 0;
-            LogManager::getInstance()->info("串口重连成功", "Serial");
+            const qint64 recoveryMs = outageStartMs > 0 ? QDateTime::currentMSecsSinceEpoch() - outageStartMs : 0;
+            outageStartMs = 0;
+            LogManager::getInstance()->info(QString("串口重连成功，恢复用时 %1 ms").arg(recoveryMs), "Serial");
+            emit recovered(recoveryMs);
         } else {
             // 重连失败，继续尝试（在handleError中会检查次数限制）
             LogManager::getInstance()->warning("串口重连失败", "Serial");
@@ -368,12 +601,49 @@ void SerialWorker::onProtocolFrameReceived(const ProtocolFrame& frame)
     emit frameReceived(frame);
 }
 
+quint32 SerialWorker::sendCommandAsync(ProtocolCommand command, const QByteArray& data,
+                                       CommandPipeline::ResponseCallback callback, int timeoutMs)
+{
+    return commandPipeline->submit(command, data, std::move(callback), timeoutMs);
+}
+
+CommandPipeline* SerialWorker::getCommandPipeline() const
+{
+    return commandPipeline;
+}
+
+FirmwareUpgrader* SerialWorker::getFirmwareUpgrader() const
+{
+    return firmwareUpgrader;
+}
+
+TrajectoryStreamer* SerialWorker::getTrajectoryStreamer() const
+{
+    return trajectoryStreamer;
+}
+
+ParameterSynchronizer* SerialWorker::getParameterSynchronizer() const
+{
+    return parameterSync;
+}
+
+void SerialWorker::setFrameBatching(bool enabled, int maxFrames, int maxLatencyUs)
+{
+    protocolParser->setBatchDelivery(enabled, maxFrames, maxLatencyUs);
+}
+
+bool SerialWorker::isFrameBatchingEnabled() const
+{
+    return protocolParser->isBatchDeliveryEnabled();
+}
+
 void SerialWorker::onProtocolParseError(const QString& error)
 {
     LogManager::getInstance()->warning(
         QString("协议解析错误: %1").arg(error),
         "Serial"
     );
+    LogManager::getInstance()->triggerCommunicationTrace(config.portName, error);
 }
 
 void SerialWorker::onConnectionTimeout()
@@ -429,6 +699,9 @@ void SerialWorker::handleError(const QString& error)
     
     // 如果启用了自动重连，检查重连次数
     if (config.autoReconnect && currentReconnectAttempts < maxReconnectAttempts) {
+        if (outageStartMs == 0) {
+            outageStartMs = QDateTime::currentMSecsSinceEpoch();
+        }
         setState(SerialConnectionState::Reconnecting);
         currentReconnectAttempts++;
         
@@ -449,6 +722,7 @@ void SerialWorker::handleError(const QString& error)
             emit errorOccurred(QString("重连失败: %1 次尝试后仍无法连接").arg(maxReconnectAttempts));
         }
         
+        outageStartMs = 0;
         setState(SerialConnectionState::Disconnected);
         stopReconnectTimer();
     }
@@ -457,9 +731,11 @@ void SerialWorker::handleError(const QString& error)
 void SerialWorker::startReconnectTimer()
 {
     if (!reconnectTimer->isActive()) {
-        reconnectTimer->start(config.reconnectInterval);
+        // 指数退避加随机抖动，同时掉线的多个串口不会同步重试
+        const int delayMs = ReconnectScheduler::backoffDelayMs(config.reconnectInterval, currentReconnectAttempts);
+        reconnectTimer->start(delayMs);
         LogManager::getInstance()->info(
-            QString("将在 %1 秒后尝试重新连接").arg(config.reconnectInterval / 1000),
+            QString("将在 %1 ms 后尝试重新连接").arg(delayMs),
             "Serial"
         );
     }
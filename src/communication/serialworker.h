@@ -8,6 +8,12 @@
 #include <QQueue>
 #include <QThread>
 #include "protocolparser.h"
+#include "commandpipeline.h"
+#include "firmwareupgrader.h"
+#include "trajectorystreamer.h"
+#include "parametersync.h"
+#include "linkcapture.h"
+#include <memory>
 #include "constants.h"
 
 enum class SerialConnectionState {
@@ -37,6 +43,29 @@ public:
     bool sendData(const QByteArray& data);
     bool sendFrame(ProtocolCommand command, const QByteArray& data = QByteArray());
     
+    // 异步命令：经命令管线发送，在途窗口内不等待响应，完成/超时后执行回调
+    quint32 sendCommandAsync(ProtocolCommand command, const QByteArray& data = QByteArray(),
+                             CommandPipeline::ResponseCallback callback = CommandPipeline::ResponseCallback(),
+                             int timeoutMs = Protocol::PIPELINE_REQUEST_TIMEOUT);
+    CommandPipeline* getCommandPipeline() const;
+    
+    // 固件升级引擎：数据块经写合并路径发送，关闭串口时暂停并保留已确认位置
+    FirmwareUpgrader* getFirmwareUpgrader() const;
+    
+    // 轨迹流式下发：批量运动帧经写合并路径发送，关闭串口时暂停并保留控制器已接收位置
+    TrajectoryStreamer* getTrajectoryStreamer() const;
+    
+    // 参数同步：经命令管线增量写入；重新打开串口时若影子副本有效，按参数集哈希校验后才全量读取
+    ParameterSynchronizer* getParameterSynchronizer() const;
+    
+    // 写合并：帧先进入 sendQueue，达到字节上限或等待超过 deadlineUs 后合并为一次写入；
+    // 安全指令帧（见 ProtocolParser::isSafetyCommand）始终立即发送并刷新，不参与合并
+    void setWriteCoalescing(bool enabled,
+                            int byteBudget = Communication::WRITE_COALESCE_BYTE_BUDGET,
+                            int deadlineUs = Communication::WRITE_COALESCE_DEADLINE_US);
+    bool isWriteCoalescingEnabled() const;
+    void flushSendQueue();
+    
     // 配置管理
     void setConfig(const SerialConfig& config);
     SerialConfig getConfig() const;
@@ -62,6 +91,16 @@ public:
     void setSilentMode(bool silent);
     bool getSilentMode() const;
     
+    // 批量帧投递（启用时通过 framesReceived 整批发出，默认启用）
+    void setFrameBatching(bool enabled, int maxFrames = Protocol::FRAME_BATCH_SIZE,
+                          int maxLatencyUs = Protocol::FRAME_BATCH_LATENCY_US);
+    bool isFrameBatchingEnabled() const;
+    
+    // 链路抓包：收发的原始字节带时间戳写入抓包文件，可由 CaptureReplayer 回放
+    bool startCapture(const QString& filePath);
+    void stopCapture();
+    bool isCapturing() const;
+    
     // 统计信息
     qint64 getBytesReceived() const;
     qint64 getBytesSent() const;
@@ -73,9 +112,11 @@ signals:
     void connectionStateChanged(SerialConnectionState state);
     void dataReceived(const QByteArray& data);
     void frameReceived(const ProtocolFrame& frame);
+    void framesReceived(const FrameBatch& frames);
     void errorOccurred(const QString& error);
     void bytesWritten(qint64 bytes);
     void statisticsUpdated(qint64 received, qint64 sent);
+    void recovered(qint64 recoveryMs);              // 自动重连成功，参数为掉线到恢复的时间
 
 private slots:
     void onReadyRead();
@@ -92,9 +133,15 @@ private:
     void startReconnectTimer();
     void stopReconnectTimer();
     void updateStatistics();
+    bool writeFrame(const QByteArray& frame);
+    bool sendSafetyFrame(const QByteArray& frame);
     
     QSerialPort* serialPort;
     ProtocolParser* protocolParser;
+    CommandPipeline* commandPipeline;
+    FirmwareUpgrader* firmwareUpgrader;
+    TrajectoryStreamer* trajectoryStreamer;
+    ParameterSynchronizer* parameterSync;
     SerialConfig config;
     SerialConnectionState connectionState;
     QString lastError;
@@ -105,15 +152,26 @@ private:
     QMutex dataMutex;
     QQueue<QByteArray> sendQueue;
     
+    // 写合并
+    bool writeCoalescing;
+    int coalesceByteBudget;
+    int coalesceDeadlineUs;
+    int queuedBytes;                // sendQueue 中的字节数
+    QTimer* coalesceTimer;
+    
     // 重连控制
     int maxReconnectAttempts;
     int currentReconnectAttempts;
     bool silentMode;
+    qint64 outageStartMs;           // 本次掉线的开始时间，未掉线为0
     
     // 统计信息
     qint64 bytesReceived;
     qint64 bytesSent;
     QTimer* statisticsTimer;
     
+    // 链路抓包（只在本对象所属线程访问）
+    std::unique_ptr<LinkCaptureWriter> captureWriter;
+    
     // 常量已移动到 constants.h
 }; 
\ No newline at end of file
@@ -0,0 +1,276 @@
+#include "slaballocator.h"
+#include <new>
+#include <algorithm>
+#include <initializer_list>
+
+namespace {
+constexpr quint32 SLAB_MAGIC = 0x534C4142u;             // "SLAB"
+constexpr int SLAB_HEADER_SIZE = 64;                    // 块头占一个缓存行，首块从这里开始
+constexpr quintptr SLAB_ADDRESS_MASK = ~static_cast<quintptr>(SlabAllocator::SLAB_SIZE - 1);
+
+// 空闲块内嵌的链表节点
+struct FreeBlock {
+    FreeBlock* next;
+};
+}
+
+struct SlabAllocator::Slab {
+    quint32 magic;
+    const SlabAllocator* owner;
+    int classIndex;
+    int blockSize;
+    int capacity;               // 整块可切出的块数
+    int used;                   // 已分配块数
+    int carved;                 // 游标：已切出过的块数
+    FreeBlock* freeList;        // 已归还的空闲块
+    Slab* prev;                 // 所在等级的部分空闲或用满链表
+    Slab* next;
+
+    char* blockAt(int index) {
+        return reinterpret_cast<char*>(this) + SLAB_HEADER_SIZE + index * blockSize;
+    }
+};
+
+SlabAllocator::~SlabAllocator()
+{
+    // 仍在使用的块随整块一并释放，调用方需保证此时不再访问
+    for (int classIndex = 0; classIndex < CLASS_COUNT; ++classIndex) {
+        for (Slab** head : {&m_partial[classIndex], &m_full[classIndex]}) {
+            while (*head) {
+                Slab* slab = *head;
+                unlinkSlab(slab, *head);
+                destroySlab(slab);
+            }
+        }
+    }
+}
+
+int SlabAllocator::sizeClassOf(int size)
+{
+    if (size > MAX_BLOCK_SIZE) {
+        return -1;
+    }
+    if (size <= (1 << MIN_BLOCK_SHIFT)) {
+        return 0;
+    }
+    // ceil(log2(size)) - MIN_BLOCK_SHIFT
+    const int bits = 32 - qCountLeadingZeroBits(static_cast<quint32>(size - 1));
+    return bits - MIN_BLOCK_SHIFT;
+}
+
+void* SlabAllocator::allocate(int size, int* capacity)
+{
+    const int classIndex = sizeClassOf(qMax(1, size));
+    if (classIndex < 0) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    Slab* slab = m_partial[classIndex];
+    if (!slab) {
+        slab = createSlab(classIndex);
+        if (!slab) {
+            return nullptr;
+        }
+        linkSlab(slab, m_partial[classIndex]);
+        m_emptySlabs[classIndex]++;
+    }
+
+    if (slab->used == 0) {
+        m_emptySlabs[classIndex]--;
+    }
+
+    void* block = nullptr;
+    if (slab->freeList) {
+        FreeBlock* head = slab->freeList;
+        slab->freeList = head->next;
+        block = head;
+    } else {
+        block = slab->blockAt(slab->carved++);
+    }
+
+    // 用满的整块移出部分空闲链表，下次直接取下一个整块
+    if (++slab->used == slab->capacity) {
+        unlinkSlab(slab, m_partial[classIndex]);
+        linkSlab(slab, m_full[classIndex]);
+    }
+
+    m_statistics.blocksInUse++;
+    m_statistics.blocksInUseByClass[classIndex]++;
+    m_statistics.usedBytes += slab->blockSize;
+
+    if (capacity) {
+        *capacity = slab->blockSize;
+    }
+    return block;
+}
+
+void SlabAllocator::deallocate(void* block)
+{
+    if (!block) {
+        return;
+    }
+
+    Slab* slab = slabOf(block);
+
+    QMutexLocker locker(&m_mutex);
+    Q_ASSERT(containsSlabLocked(slab));
+
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = slab->freeList;
+    slab->freeList = freeBlock;
+
+    const int classIndex = slab->classIndex;
+    m_statistics.blocksInUse--;
+    m_statistics.blocksInUseByClass[classIndex]--;
+    m_statistics.usedBytes -= slab->blockSize;
+
+    if (slab->used-- == slab->capacity) {
+        unlinkSlab(slab, m_full[classIndex]);
+        linkSlab(slab, m_partial[classIndex]);
+    }
+
+    if (slab->used == 0) {
+        // 每个等级只保留一个全空整块，避免在边界处反复申请/归还
+        if (m_emptySlabs[classIndex] > 0) {
+            unlinkSlab(slab, m_partial[classIndex]);
+            destroySlab(slab);
+        } else {
+            m_emptySlabs[classIndex]++;
+        }
+    }
+}
+
+bool SlabAllocator::owns(const void* block) const
+{
+    if (!block) {
+        return false;
+    }
+    QMutexLocker locker(&m_mutex);
+    return containsSlabLocked(slabOf(block));
+}
+
+int SlabAllocator::blockCapacity(const void* block) const
+{
+    if (!block) {
+        return 0;
+    }
+    QMutexLocker locker(&m_mutex);
+    const Slab* slab = slabOf(block);
+    return containsSlabLocked(slab) ? slab->blockSize : 0;
+}
+
+int SlabAllocator::releaseEmptySlabs()
+{
+    QMutexLocker locker(&m_mutex);
+
+    int released = 0;
+    for (int classIndex = 0; classIndex < CLASS_COUNT; ++classIndex) {
+        Slab* slab = m_partial[classIndex];
+        while (slab) {
+            Slab* next = slab->next;
+            if (isEmpty(slab)) {
+                unlinkSlab(slab, m_partial[classIndex]);
+                destroySlab(slab);
+                released++;
+            }
+            slab = next;
+        }
+        m_emptySlabs[classIndex] = 0;
+    }
+    return released;
+}
+
+SlabAllocator::Statistics SlabAllocator::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+SlabAllocator::Slab* SlabAllocator::slabOf(const void* block)
+{
+    return reinterpret_cast<Slab*>(reinterpret_cast<quintptr>(block) & SLAB_ADDRESS_MASK);
+}
+
+bool SlabAllocator::containsSlabLocked(const Slab* slab) const
+{
+    // 地址表命中后整块必定仍然有效，此时读块头才是安全的
+    const quintptr address = reinterpret_cast<quintptr>(slab);
+    const auto it = std::lower_bound(m_slabAddresses.begin(), m_slabAddresses.end(), address);
+    if (it == m_slabAddresses.end() || *it != address) {
+        return false;
+    }
+    return slab->magic == SLAB_MAGIC && slab->owner == this;
+}
+
+SlabAllocator::Slab* SlabAllocator::createSlab(int classIndex)
+{
+    static_assert(sizeof(Slab) <= SLAB_HEADER_SIZE, "块头超出预留空间");
+
+    void* memory = ::operator new(SLAB_SIZE, std::align_val_t(SLAB_SIZE), std::nothrow);
+    if (!memory) {
+        return nullptr;
+    }
+
+    Slab* slab = static_cast<Slab*>(memory);
+    slab->magic = SLAB_MAGIC;
+    slab->owner = this;
+    slab->classIndex = classIndex;
+    slab->blockSize = classSize(classIndex);
+    slab->capacity = (SLAB_SIZE - SLAB_HEADER_SIZE) / slab->blockSize;
+    slab->used = 0;
+    slab->carved = 0;
+    slab->freeList = nullptr;
+    slab->prev = nullptr;
+    slab->next = nullptr;
+
+    const quintptr address = reinterpret_cast<quintptr>(slab);
+    m_slabAddresses.insert(std::lower_bound(m_slabAddresses.begin(), m_slabAddresses.end(), address), address);
+
+    m_statistics.slabCount++;
+    m_statistics.reservedBytes += SLAB_SIZE;
+    return slab;
+}
+
+void SlabAllocator::destroySlab(Slab* slab)
+{
+    slab->magic = 0;
+    const quintptr address = reinterpret_cast<quintptr>(slab);
+    const auto it = std::lower_bound(m_slabAddresses.begin(), m_slabAddresses.end(), address);
+    if (it != m_slabAddresses.end() && *it == address) {
+        m_slabAddresses.erase(it);
+    }
+    m_statistics.slabCount--;
+    m_statistics.reservedBytes -= SLAB_SIZE;
+    ::operator delete(slab, std::align_val_t(SLAB_SIZE));
+}
+
+bool SlabAllocator::isEmpty(const Slab* slab)
+{
+    return slab->used == 0;
+}
+
+void SlabAllocator::linkSlab(Slab* slab, Slab*& head)
+{
+    slab->prev = nullptr;
+    slab->next = head;
+    if (head) {
+        head->prev = slab;
+    }
+    head = slab;
+}
+
+void SlabAllocator::unlinkSlab(Slab* slab, Slab*& head)
+{
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        head = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    slab->prev = nullptr;
+    slab->next = nullptr;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QMutex>
+#include <vector>
+
+// 块分配器 - 按2的幂划分尺寸等级（32B起），每个等级从64KB对齐的整块内存中切分小块
+//
+// 每个整块（slab）只服务一个尺寸等级，块头位于整块起始处：
+// 任意块地址按 SLAB_SIZE 向下对齐即得到所属整块及其等级，释放是O(1)。
+// 对齐后的地址不一定可读（外来指针、整块已归还），归属判断先在整块地址表中二分查找，命中才读块头。
+// 空闲块用侵入式单链表串起（指针存放在空闲块自身），未切分的部分按游标顺序切出，
+// 新整块不需要预先建链。每个等级只保留一个全空整块，其余空整块立即归还系统。
+// 只接受由本分配器返回的指针；所有操作线程安全（内部加锁）。
+class SlabAllocator
+{
+public:
+    static constexpr int SLAB_SIZE = 64 * 1024;         // 整块大小，同时是对齐粒度
+    static constexpr int MIN_BLOCK_SHIFT = 5;           // 最小块 32B
+    static constexpr int CLASS_COUNT = 9;               // 32B ... 8KB（8KB块每整块7个，块头浪费不超过1/8）
+    static constexpr int MAX_BLOCK_SIZE = 1 << (MIN_BLOCK_SHIFT + CLASS_COUNT - 1);
+
+    struct Statistics {
+        int slabCount = 0;              // 当前持有的整块数
+        qint64 reservedBytes = 0;       // 向系统申请的总字节数
+        qint64 usedBytes = 0;           // 已分配块按等级大小计的字节数
+        int blocksInUse = 0;
+        int blocksInUseByClass[CLASS_COUNT] = {};
+    };
+
+    SlabAllocator() = default;
+    ~SlabAllocator();
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    // 尺寸等级：size 向上取整到2的幂后的下标，超过 MAX_BLOCK_SIZE 返回-1
+    static int sizeClassOf(int size);
+    static int classSize(int classIndex) { return 1 << (MIN_BLOCK_SHIFT + classIndex); }
+
+    // 分配至少 size 字节，超出最大等级或内存不足时返回 nullptr；capacity 返回块实际大小
+    void* allocate(int size, int* capacity = nullptr);
+    void deallocate(void* block);
+
+    // 由地址判断是否为本分配器的块及其容量；任意指针均可传入，不属于本分配器时返回 false / 0
+    bool owns(const void* block) const;
+    int blockCapacity(const void* block) const;
+
+    // 归还所有全空整块
+    int releaseEmptySlabs();
+
+    Statistics statistics() const;
+
+private:
+    struct Slab;
+
+    static Slab* slabOf(const void* block);
+    bool containsSlabLocked(const Slab* slab) const;
+    Slab* createSlab(int classIndex);
+    void destroySlab(Slab* slab);
+    static bool isEmpty(const Slab* slab);
+    static void linkSlab(Slab* slab, Slab*& head);
+    static void unlinkSlab(Slab* slab, Slab*& head);
+
+    mutable QMutex m_mutex;
+    Slab* m_partial[CLASS_COUNT] = {};      // 各等级尚有空闲块的整块（双向链表）
+    Slab* m_full[CLASS_COUNT] = {};         // 各等级已用满的整块
+    int m_emptySlabs[CLASS_COUNT] = {};     // 各等级在链表中的全空整块数
+    std::vector<quintptr> m_slabAddresses;  // 现存整块的起始地址（升序），随整块创建和归还更新
+    Statistics m_statistics;
+};
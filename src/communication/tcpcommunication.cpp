@@ -1,6 +1,11 @@
 #include "tcpcommunication.h"
+#include "communicationbufferpool.h"
+#include "reconnectscheduler.h"
+#include "livedatafeed.h"
 #include "logger/logmanager.h"
 #include "constants.h"
+#include "utils/fastlane.h"
+#include "utils/threadpolicy.h"
 #include <QDebug>
 #include <QDateTime>
 #include <QThread>
@@ -10,6 +15,10 @@ TcpCommunication::TcpCommunication(QObject* parent)
     : ICommunication(parent)
     , m_tcpSocket(nullptr)
     , m_protocolParser(nullptr)
+    , m_commandPipeline(nullptr)
+    , m_firmwareUpgrader(nullptr)
+    , m_trajectoryStreamer(nullptr)
+    , m_parameterSync(nullptr)
     , m_heartbeatTimer(nullptr)
     , m_reconnectTimer(nullptr)
     , m_connectionTimer(nullptr)
@@ -17,12 +26,25 @@ TcpCommunication::TcpCommunication(QObject* parent)
     , m_keepAliveTimer(nullptr)
     , m_isConnecting(false)
     , m_connectStartTime(0)
+    , m_reconnectInFlight(false)
+    , m_networkThread(nullptr)
+    , m_ioThread(nullptr)
+    , m_compression([this](int dataLength) { return m_protocolParser->requiredFrameSize(dataLength); })
+    , m_compressionRequested(false)
+    , m_compressionFlushScheduled(false)
 {
     // 创建TCP套接字
     m_tcpSocket = new QTcpSocket(this);
     
     // 创建协议解析器
     m_protocolParser = new ProtocolParser(this);
+    m_commandPipeline = new CommandPipeline(m_protocolParser,
+                                            [this](const QByteArray& frame) { return sendData(frame); }, this);
+    m_firmwareUpgrader = new FirmwareUpgrader(m_protocolParser,
+                                              [this](const QByteArray& frame) { return sendData(frame); }, this);
+    m_trajectoryStreamer = new TrajectoryStreamer(m_protocolParser,
+                                                  [this](const QByteArray& frame) { return sendData(frame); }, this);
+    m_parameterSync = new ParameterSynchronizer(m_commandPipeline, this);
     
     // 初始化定时器
     initializeTimers();
@@ -38,12 +60,34 @@ TcpCommunication::TcpCommunication(QObject* parent)
 
 TcpCommunication::~TcpCommunication()
 {
+    // 在其他线程析构时先断开并迁回本线程，使定时器和套接字在所属线程停止
+    if (isForeignThreadCall()) {
+        disconnect();
+        if (m_ioThread) {
+            leaveIoThread();
+        } else {
+            setDedicatedNetworkThread(false);
+        }
+    }
+    
     // 停止心跳
     stopHeartbeat();
+    m_captureWriter.reset();
     
-    // 关闭连接
-    if (isConnected()) {
-        disconnect();
+    // 关闭连接，进行中的重连归还并发名额
+    disconnect();
+    
+    // 在 I/O 线程内析构（deleteLater）时定时器随本对象从时间轮移除，只需归还连接计数
+    if (m_ioThread) {
+        m_ioThread->removeConnection();
+        m_ioThread = nullptr;
+    }
+    
+    // 在网络线程内析构时不能等待自身，线程结束后再回收
+    if (m_networkThread) {
+        QObject::connect(m_networkThread, &QThread::finished, m_networkThread, &QObject::deleteLater);
+        m_networkThread->quit();
+        m_networkThread = nullptr;
     }
     
     LogManager::getInstance()->info("TCP通讯对象已销毁", "TcpCommunication");
@@ -51,6 +95,14 @@ TcpCommunication::~TcpCommunication()
 
 bool TcpCommunication::connect(const CommunicationConfig& config)
 {
+    if (isForeignThreadCall()) {
+        // 按值捕获前先转换，避免 TcpConfig 被切片成基类
+        return invokeInNetworkThread([this, tcpConfig = TcpConfig::fromBase(config)]() { return connect(tcpConfig); });
+    }
+    
+    // 主动连接取代进行中的自动重连
+    cancelReconnect();
+    
     if (isConnected()) {
         LogManager::getInstance()->warning("TCP已连接", "TcpCommunication");
         return true;
@@ -77,19 +129,7 @@ bool TcpCommunication::connect(const CommunicationConfig& config)
     if (connectToHost()) {
         // 重置重连计数
         resetReconnectAttempts();
-        
-        // 启动心跳
-        if (m_config.enableHeartbeat) {
-            startHeartbeat();
-        }
-        
-        // 启动Keep-Alive
-        if (m_config.keepAlive) {
-            m_keepAliveTimer->start(30000); // 30秒发送一次Keep-Alive
-        }
-        
-        // 启动统计定时器
-        m_statisticsTimer->start(System::STATISTICS_UPDATE_INTERVAL);
+        startSessionTimers();
         
         LogManager::getInstance()->info(
             QString("TCP连接成功: %1:%2").arg(m_config.hostAddress).arg(m_config.port),
@@ -105,6 +145,17 @@ bool TcpCommunication::connect(const CommunicationConfig& config)
 
 void TcpCommunication::disconnect()
 {
+    if (!isConnected() && m_connectionState != ConnectionState::Reconnecting) {
+        return;
+    }
+    
+    if (isForeignThreadCall()) {
+        invokeInNetworkThread([this]() { disconnect(); return true; });
+        return;
+    }
+    
+    // 主动断开时停止自动重连
+    cancelReconnect();
     if (!isConnected()) {
         return;
     }
@@ -118,8 +169,18 @@ void TcpCommunication::disconnect()
         m_keepAliveTimer->stop();
     }
     
-    // 关闭TCP连接
+    // 取消等待响应的命令
+    m_commandPipeline->cancelAll();
+    m_firmwareUpgrader->suspend();
+    m_trajectoryStreamer->suspend();
+    
+    // 已合并的帧先发出，再关闭TCP连接
+    {
+        QMutexLocker locker(&m_dataMutex);
+        flushCompressionBufferLocked();
+    }
     disconnectFromHost();
+    resetCompression();
     
     // 设置状态
     setState(ConnectionState::Disconnected);
@@ -160,8 +221,41 @@ bool TcpCommunication::sendData(const QByteArray& data)
         return false;
     }
     
+    // 安全帧从调用时刻开始计时，经快速通道发送
+    const qint64 safetyStartNs = ProtocolParser::isSafetyFrame(data) ? ProtocolFrame::currentTimestampNs() : 0;
+    
+    // 套接字属于网络线程，其他线程的发送排队投递，不阻塞调用方；
+    // 安全帧以高优先级事件投递，排在网络线程已排队的普通发送和读事件之前
+    if (isForeignThreadCall()) {
+        if (safetyStartNs > 0) {
+            FastLaneCallEvent::post(this, [this, data, safetyStartNs]() {
+                if (isConnected()) {
+                    writeToSocket(data, safetyStartNs);
+                }
+            });
+        } else {
+            QMetaObject::invokeMethod(this, [this, data]() { sendData(data); }, Qt::QueuedConnection);
+        }
+        return true;
+    }
+    
+    return writeToSocket(data, safetyStartNs);
+}
+
+bool TcpCommunication::writeToSocket(const QByteArray& data, qint64 safetyStartNs)
+{
     QMutexLocker locker(&m_dataMutex);
     
+    if (m_compression.isActive()) {
+        if (safetyStartNs == 0) {
+            return bufferForCompressionLocked(data);
+        }
+        // 安全帧不等待合并，先发出已合并的帧以保持发送顺序
+        if (!flushCompressionBufferLocked()) {
+            return false;
+        }
+    }
+    
     qint64 bytesWritten = m_tcpSocket->write(data);
     if (bytesWritten == -1) {
         handleError("数据发送失败");
@@ -173,6 +267,16 @@ bool TcpCommunication::sendData(const QByteArray& data)
         return false;
     }
     
+    if (m_captureWriter) {
+        m_captureWriter->recordSent(data);
+    }
+    
+    if (safetyStartNs > 0) {
+        // 立即交给内核，不等待事件循环的写通知
+        m_tcpSocket->flush();
+        FastLaneMonitor::getInstance()->record(FastLaneStage::Transport, ProtocolFrame::currentTimestampNs() - safetyStartNs);
+    }
+    
     // 更新统计信息
     m_statistics.bytesSent += bytesWritten;
     m_statistics.framesSent++;
@@ -183,6 +287,116 @@ bool TcpCommunication::sendData(const QByteArray& data)
     return true;
 }
 
+bool TcpCommunication::bufferForCompressionLocked(const QByteArray& data)
+{
+    if (m_compressionBuffer.size() + data.size() > Communication::LINK_COMPRESSION_MAX_BLOCK
+        && !flushCompressionBufferLocked()) {
+        return false;
+    }
+    
+    m_compressionBuffer.append(data);
+    if (m_captureWriter) {
+        m_captureWriter->recordSent(data);
+    }
+    
+    // 本轮事件循环内发送的帧合并后一起写出
+    if (!m_compressionFlushScheduled) {
+        m_compressionFlushScheduled = true;
+        QMetaObject::invokeMethod(this, [this]() {
+            QMutexLocker locker(&m_dataMutex);
+            flushCompressionBufferLocked();
+        }, Qt::QueuedConnection);
+    }
+    
+    m_statistics.framesSent++;
+    updateLastActivity();
+    
+    emit dataSent(data);
+    
+    return true;
+}
+
+bool TcpCommunication::flushCompressionBufferLocked()
+{
+    m_compressionFlushScheduled = false;
+    if (m_compressionBuffer.isEmpty()) {
+        return true;
+    }
+    
+    QByteArray frames;
+    frames.swap(m_compressionBuffer);
+    
+    QByteArray block;
+    if (frames.size() >= m_config.compressionThreshold) {
+        block = m_compression.encode(frames);
+    }
+    const QByteArray& wire = block.isEmpty() ? frames : block;
+    
+    const qint64 bytesWritten = m_tcpSocket->write(wire);
+    if (bytesWritten != wire.size()) {
+        handleError(bytesWritten == -1 ? "数据发送失败" : "数据发送不完整");
+        return false;
+    }
+    
+    m_statistics.bytesSent += bytesWritten;
+    if (!block.isEmpty()) {
+        m_statistics.compressedBytesSent += block.size();
+        m_statistics.uncompressedBytesSent += frames.size();
+    }
+    return true;
+}
+
+void TcpCommunication::negotiateCompression()
+{
+    m_compressionRequested = true;
+    
+    QByteArray request;
+    request.append(static_cast<char>(LinkCompression::PROTOCOL_VERSION));
+    request.append(static_cast<char>(LinkCompression::ALGORITHM_LZ4));
+    
+    // 不支持该命令的设备回复错误或超时，链路保持不压缩
+    m_commandPipeline->submit(ProtocolCommand::NegotiateCompression, request, [this](const CommandResult& result) {
+        const bool accepted = result.isSuccess() && !result.responseData.isEmpty()
+                              && static_cast<quint8>(result.responseData.at(0)) == LinkCompression::ALGORITHM_LZ4;
+        if (!accepted || !isConnected()) {
+            logMessage("对端未启用链路压缩，按普通帧收发", "INFO");
+            return;
+        }
+        QMutexLocker locker(&m_dataMutex);
+        m_compression.setActive(true);
+        logMessage("链路压缩已启用 (LZ4)", "INFO");
+    });
+}
+
+void TcpCommunication::resetCompression()
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_compressionBuffer.clear();
+    m_compression.reset();
+    m_compressionRequested = false;
+}
+
+QByteArray TcpCommunication::decodeReceived(const QByteArray& data)
+{
+    if (!m_compressionRequested) {
+        return data;
+    }
+    
+    QByteArray decoded;
+    m_compression.decode(data.constData(), data.size(), [&decoded](const char* bytes, int length) {
+        decoded.append(bytes, length);
+    }, m_statistics);
+    return decoded;
+}
+
+bool TcpCommunication::event(QEvent* event)
+{
+    if (FastLaneCallEvent::dispatch(event)) {
+        return true;
+    }
+    return ICommunication::event(event);
+}
+
 bool TcpCommunication::sendFrame(ProtocolCommand command, const QByteArray& data)
 {
     if (!m_protocolParser) {
@@ -199,8 +413,8 @@ bool TcpCommunication::sendFrame(ProtocolCommand command, const QByteArray& data
     if (sendData(frameData)) {
         ProtocolFrame frame;
         frame.command = command;
-        frame.data = data;
-        frame.timestamp = QDateTime::currentDateTime();
+        frame.setData(data);
+        frame.timestampNs = ProtocolFrame::currentTimestampNs();
         
         emit frameSent(frame);
         return true;
@@ -209,6 +423,26 @@ bool TcpCommunication::sendFrame(ProtocolCommand command, const QByteArray& data
     return false;
 }
 
+CommandPipeline* TcpCommunication::getCommandPipeline() const
+{
+    return m_commandPipeline;
+}
+
+FirmwareUpgrader* TcpCommunication::getFirmwareUpgrader() const
+{
+    return m_firmwareUpgrader;
+}
+
+TrajectoryStreamer* TcpCommunication::getTrajectoryStreamer() const
+{
+    return m_trajectoryStreamer;
+}
+
+ParameterSynchronizer* TcpCommunication::getParameterSynchronizer() const
+{
+    return m_parameterSync;
+}
+
 QByteArray TcpCommunication::receiveData()
 {
     if (!isConnected()) {
@@ -224,6 +458,11 @@ QByteArray TcpCommunication::receiveData()
 
 void TcpCommunication::setConfig(const CommunicationConfig& config)
 {
+    if (isForeignThreadCall()) {
+        invokeInNetworkThread([this, tcpConfig = TcpConfig::fromBase(config)]() { setConfig(tcpConfig); return true; });
+        return;
+    }
+    
     // 转换为TCP配置
     if (config.type == CommunicationType::TCP) {
         m_config = TcpConfig::fromBase(config);
@@ -247,6 +486,10 @@ CommunicationConfig TcpCommunication::getConfig() const
 
 bool TcpCommunication::updateConfig(const QString& key, const QVariant& value)
 {
+    if (isForeignThreadCall()) {
+        return invokeInNetworkThread([this, key, value]() { return updateConfig(key, value); });
+    }
+    
     bool updated = false;
     
     if (key == "hostAddress") {
@@ -276,6 +519,13 @@ bool TcpCommunication::updateConfig(const QString& key, const QVariant& value)
             }
         }
         updated = true;
+    } else if (key == "compressionEnabled") {
+        // 下次连接时生效
+        m_config.compressionEnabled = value.toBool();
+        updated = true;
+    } else if (key == "compressionThreshold") {
+        m_config.compressionThreshold = qMax(1, value.toInt());
+        updated = true;
     } else if (key == "timeout") {
         m_config.timeout = value.toInt();
         updated = true;
@@ -319,6 +569,7 @@ CommunicationStats TcpCommunication::getStatistics() const
 void TcpCommunication::resetStatistics()
 {
     m_statistics.reset();
+    resetHeartbeatHistogram();
     emit statisticsUpdated(m_statistics);
 }
 
@@ -387,6 +638,10 @@ void TcpCommunication::resetReconnectAttempts()
 void TcpCommunication::flush()
 {
     if (m_tcpSocket && m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
+        {
+            QMutexLocker locker(&m_dataMutex);
+            flushCompressionBufferLocked();
+        }
         m_tcpSocket->flush();
     }
 }
@@ -396,6 +651,7 @@ void TcpCommunication::clearBuffers()
     QMutexLocker locker(&m_dataMutex);
     m_receiveBuffer.clear();
     m_sendQueue.clear();
+    m_compressionBuffer.clear();
 }
 
 bool TcpCommunication::testConnection()
@@ -506,18 +762,30 @@ quint16 TcpCommunication::getLocalPort() const
 // 公共槽函数
 void TcpCommunication::reconnect()
 {
+    if (isForeignThreadCall()) {
+        QMetaObject::invokeMethod(this, &TcpCommunication::reconnect, Qt::QueuedConnection);
+        return;
+    }
+    
     if (isConnected()) {
         disconnect();
     }
     
-    // 延迟重连
-    QTimer::singleShot(m_config.reconnectInterval, this, [this]() {
-        connect(m_config);
-    });
+    // 按退避间隔异步重连，多个连接同时重连时互不阻塞
+    cancelReconnect();
+    markOutage();
+    resetReconnectAttempts();
+    setState(ConnectionState::Reconnecting);
+    startReconnectTimer();
 }
 
 void TcpCommunication::startHeartbeat()
 {
+    if (isForeignThreadCall()) {
+        QMetaObject::invokeMethod(this, &TcpCommunication::startHeartbeat, Qt::QueuedConnection);
+        return;
+    }
+    
     if (!m_heartbeatTimer) {
         return;
     }
@@ -530,6 +798,11 @@ void TcpCommunication::startHeartbeat()
 
 void TcpCommunication::stopHeartbeat()
 {
+    if (isForeignThreadCall()) {
+        QMetaObject::invokeMethod(this, &TcpCommunication::stopHeartbeat, Qt::QueuedConnection);
+        return;
+    }
+    
     if (m_heartbeatTimer && m_heartbeatTimer->isActive()) {
         m_heartbeatTimer->stop();
         logMessage("心跳检测已停止", "INFO");
@@ -539,6 +812,7 @@ void TcpCommunication::stopHeartbeat()
 void TcpCommunication::updateStatistics()
 {
     updateConnectionStatistics();
+    publishMetrics();
     emit statisticsUpdated(m_statistics);
 }
 
@@ -567,35 +841,53 @@ void TcpCommunication::onHeartbeatTimer()
 
 void TcpCommunication::onReconnectTimer()
 {
-    if (m_connectionState == ConnectionState::Reconnecting) {
-        if (m_currentReconnectAttempts < m_config.maxReconnectAttempts) {
-            m_currentReconnectAttempts++;
-            emit reconnectAttempt(m_currentReconnectAttempts);
-            
-            logMessage(
-                QString("尝试重连 (%1/%2)").arg(m_currentReconnectAttempts).arg(m_config.maxReconnectAttempts),
-                "INFO"
-            );
-            
-            // 尝试重连
-            if (connect(m_config)) {
-                stopReconnectTimer();
-                resetReconnectAttempts();
-            } else {
-                // 继续重连
-                startReconnectTimer();
-            }
-        } else {
-            // 重连次数用完
-            stopReconnectTimer();
-            setState(ConnectionState::Disconnected);
-            handleError("重连失败，已达到最大重连次数");
-        }
+    if (m_connectionState != ConnectionState::Reconnecting || m_reconnectInFlight) {
+        return;
+    }
+    
+    if (m_currentReconnectAttempts >= m_config.maxReconnectAttempts) {
+        // 重连次数用完，不再经 handleError 触发新一轮重连
+        stopReconnectTimer();
+        m_outageStartMs = 0;
+        setState(ConnectionState::Disconnected);
+        m_lastError = "重连失败，已达到最大重连次数";
+        logMessage(m_lastError, "ERROR");
+        emit connectionError(m_lastError);
+        return;
     }
+    
+    // 同时建连的连接数受限，名额已满时稍后再试，不计入重连次数
+    if (!ReconnectScheduler::tryAcquire()) {
+        m_reconnectTimer->start(ReconnectScheduler::deferDelayMs());
+        return;
+    }
+    
+    // 心跳超时等情况下套接字可能仍连着，中止时的断开通知会改写状态
+    m_tcpSocket->abort();
+    setState(ConnectionState::Reconnecting);
+    m_reconnectInFlight = true;
+    m_currentReconnectAttempts++;
+    emit reconnectAttempt(m_currentReconnectAttempts);
+    
+    logMessage(
+        QString("尝试重连 (%1/%2)").arg(m_currentReconnectAttempts).arg(m_config.maxReconnectAttempts),
+        "INFO"
+    );
+    
+    // 异步建连，结果由 connected、errorOccurred 或连接超时定时器处理，不阻塞所在线程
+    m_isConnecting = true;
+    m_connectStartTime = QDateTime::currentMSecsSinceEpoch();
+    startConnectionTimer();
+    m_tcpSocket->connectToHost(m_config.hostAddress, m_config.port);
 }
 
 void TcpCommunication::onConnectionTimeout()
 {
+    if (m_reconnectInFlight) {
+        failReconnectAttempt("连接超时");
+        return;
+    }
+    
     if (m_connectionState == ConnectionState::Connecting) {
         handleError("连接超时");
     }
@@ -621,11 +913,32 @@ void TcpCommunication::onTcpConnected()
     
     // 配置TCP套接字
     configureTcpSocket();
+    
+    // 对端同意之前按普通帧收发
+    if (m_config.compressionEnabled) {
+        negotiateCompression();
+    }
+    
+    // 重连：断开期间设备参数可能被改写，哈希一致时不会全量读取
+    if (m_parameterSync->isShadowValid()) {
+        m_parameterSync->refresh();
+    }
+    
+    if (m_reconnectInFlight) {
+        m_reconnectInFlight = false;
+        ReconnectScheduler::release();
+        stopReconnectTimer();
+        resetReconnectAttempts();
+        startSessionTimers();
+        recordRecovery();
+        logMessage(QString("重连成功，恢复用时 %1 ms").arg(m_statistics.lastRecoveryMs), "INFO");
+    }
 }
 
 void TcpCommunication::onTcpDisconnected()
 {
     setState(ConnectionState::Disconnected);
+    resetCompression();
     
     logMessage("TCP连接已断开", "INFO");
     
@@ -642,22 +955,37 @@ void TcpCommunication::onTcpDataReceived()
         return;
     }
     
-    QByteArray data = m_tcpSocket->readAll();
+    if (usesNetworkThread()) {
+        readIntoPooledBuffers();
+        return;
+    }
+    
+    const QByteArray wire = m_tcpSocket->readAll();
+    if (wire.isEmpty()) {
+        return;
+    }
+    
+    // 更新统计信息
+    m_statistics.bytesReceived += wire.size();
+    m_statistics.framesReceived++;
+    updateLastActivity();
+    
+    // 拆出压缩块；块还不完整时本次没有可处理的数据
+    const QByteArray data = decodeReceived(wire);
     if (data.isEmpty()) {
         return;
     }
     
+    if (m_captureWriter) {
+        m_captureWriter->recordReceived(data);
+    }
+    
     // 更新接收缓冲区
     {
         QMutexLocker locker(&m_dataMutex);
         m_receiveBuffer.append(data);
     }
     
-    // 更新统计信息
-    m_statistics.bytesReceived += data.size();
-    m_statistics.framesReceived++;
-    updateLastActivity();
-    
     // 处理接收到的数据
     processReceivedData(data);
     
@@ -680,6 +1008,10 @@ void TcpCommunication::onTcpErrorOccurred(QAbstractSocket::SocketError error)
     }
     
     QString errorString = tcpErrorToString(error);
+    if (m_reconnectInFlight) {
+        failReconnectAttempt(errorString);
+        return;
+    }
     handleError(errorString);
 }
 
@@ -688,6 +1020,11 @@ void TcpCommunication::onTcpStateChanged(QAbstractSocket::SocketState state)
     QString stateString = tcpStateToString(state);
     logMessage(QString("TCP状态变更: %1").arg(stateString), "DEBUG");
     
+    // 异步重连期间保持重连中状态，建连结果由重连流程处理
+    if (m_reconnectInFlight && state != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    
     switch (state) {
         case QAbstractSocket::ConnectingState:
             setState(ConnectionState::Connecting);
@@ -708,6 +1045,7 @@ void TcpCommunication::setState(ConnectionState state)
 {
     if (m_connectionState != state) {
         m_connectionState = state;
+        publishMetrics();
         emit connectionStateChanged(state);
         
         if (state == ConnectionState::Connected) {
@@ -736,6 +1074,7 @@ void TcpCommunication::handleError(const QString& error)
     
     // 自动重连
     if (m_autoReconnectEnabled && m_connectionState != ConnectionState::Reconnecting) {
+        markOutage();
         setState(ConnectionState::Reconnecting);
         startReconnectTimer();
     }
@@ -867,7 +1206,8 @@ void TcpCommunication::stopConnectionTimer()
 void TcpCommunication::startReconnectTimer()
 {
     if (m_reconnectTimer) {
-        m_reconnectTimer->start(m_config.reconnectInterval);
+        m_reconnectTimer->start(
+            ReconnectScheduler::backoffDelayMs(m_config.reconnectInterval, m_currentReconnectAttempts + 1));
     }
 }
 
@@ -878,6 +1218,57 @@ void TcpCommunication::stopReconnectTimer()
     }
 }
 
+void TcpCommunication::failReconnectAttempt(const QString& reason)
+{
+    // 先中止套接字再清除标记，中止引起的状态变更不会把连接置为已断开
+    stopConnectionTimer();
+    m_tcpSocket->abort();
+    m_reconnectInFlight = false;
+    m_isConnecting = false;
+    ReconnectScheduler::release();
+    
+    m_lastError = reason;
+    m_statistics.errorCount++;
+    logMessage(QString("重连失败 (%1/%2): %3")
+                   .arg(m_currentReconnectAttempts).arg(m_config.maxReconnectAttempts).arg(reason),
+               "WARNING");
+    
+    setState(ConnectionState::Reconnecting);
+    startReconnectTimer();
+}
+
+void TcpCommunication::cancelReconnect()
+{
+    stopReconnectTimer();
+    if (m_reconnectInFlight) {
+        stopConnectionTimer();
+        m_tcpSocket->abort();
+        m_reconnectInFlight = false;
+        m_isConnecting = false;
+        ReconnectScheduler::release();
+    }
+    m_outageStartMs = 0;
+    if (m_connectionState == ConnectionState::Reconnecting) {
+        setState(ConnectionState::Disconnected);
+    }
+}
+
+void TcpCommunication::startSessionTimers()
+{
+    // 启动心跳
+    if (m_config.enableHeartbeat) {
+        startHeartbeat();
+    }
+    
+    // 启动Keep-Alive
+    if (m_config.keepAlive) {
+        m_keepAliveTimer->start(30000); // 30秒发送一次Keep-Alive
+    }
+    
+    // 启动统计定时器
+    m_statisticsTimer->start(System::STATISTICS_UPDATE_INTERVAL);
+}
+
 QString TcpCommunication::tcpErrorToString(QAbstractSocket::SocketError error) const
 {
     switch (error) {
@@ -956,29 +1347,29 @@ QString TcpCommunication::tcpStateToString(QAbstractSocket::SocketState state) c
 void TcpCommunication::initializeTimers()
 {
     // 心跳定时器
-    m_heartbeatTimer = new QTimer(this);
+    m_heartbeatTimer = new ConnectionTimer(this);
     m_heartbeatTimer->setSingleShot(false);
-    QObject::connect(m_heartbeatTimer, &QTimer::timeout, this, &TcpCommunication::onHeartbeatTimer);
+    QObject::connect(m_heartbeatTimer, &ConnectionTimer::timeout, this, &TcpCommunication::onHeartbeatTimer);
     
     // 重连定时器
-    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer = new ConnectionTimer(this);
     m_reconnectTimer->setSingleShot(true);
-    QObject::connect(m_reconnectTimer, &QTimer::timeout, this, &TcpCommunication::onReconnectTimer);
+    QObject::connect(m_reconnectTimer, &ConnectionTimer::timeout, this, &TcpCommunication::onReconnectTimer);
     
     // 连接超时定时器
-    m_connectionTimer = new QTimer(this);
+    m_connectionTimer = new ConnectionTimer(this);
     m_connectionTimer->setSingleShot(true);
-    QObject::connect(m_connectionTimer, &QTimer::timeout, this, &TcpCommunication::onConnectionTimeout);
+    QObject::connect(m_connectionTimer, &ConnectionTimer::timeout, this, &TcpCommunication::onConnectionTimeout);
     
     // 统计定时器
-    m_statisticsTimer = new QTimer(this);
+    m_statisticsTimer = new ConnectionTimer(this);
     m_statisticsTimer->setSingleShot(false);
-    QObject::connect(m_statisticsTimer, &QTimer::timeout, this, &TcpCommunication::updateStatistics);
+    QObject::connect(m_statisticsTimer, &ConnectionTimer::timeout, this, &TcpCommunication::updateStatistics);
     
     // Keep-Alive定时器
-    m_keepAliveTimer = new QTimer(this);
+    m_keepAliveTimer = new ConnectionTimer(this);
     m_keepAliveTimer->setSingleShot(false);
-    QObject::connect(m_keepAliveTimer, &QTimer::timeout, this, &TcpCommunication::sendKeepAlive);
+    QObject::connect(m_keepAliveTimer, &ConnectionTimer::timeout, this, &TcpCommunication::sendKeepAlive);
 }
 
 void TcpCommunication::connectSignals()
@@ -994,8 +1385,25 @@ void TcpCommunication::connectSignals()
     
     // 协议解析器信号连接
     QObject::connect(m_protocolParser, &ProtocolParser::frameReceived, this, &ICommunication::frameReceived);
+    QObject::connect(m_protocolParser, &ProtocolParser::framesReceived, this, &TcpCommunication::framesReceived);
     QObject::connect(m_protocolParser, &ProtocolParser::parseError, this, &ICommunication::protocolError);
-    QObject::connect(m_protocolParser, &ProtocolParser::heartbeatReceived, this, &ICommunication::heartbeatReceived);
+    QObject::connect(m_protocolParser, &ProtocolParser::heartbeatReceived, this, [this](qint64 rttNs) {
+        recordHeartbeatRtt(rttNs);
+        emit heartbeatReceived(rttNs);
+    });
+    QObject::connect(m_protocolParser, &ProtocolParser::frameReceived, m_commandPipeline, &CommandPipeline::handleFrame);
+    QObject::connect(m_protocolParser, &ProtocolParser::framesReceived, m_commandPipeline, &CommandPipeline::handleFrames);
+    QObject::connect(m_protocolParser, &ProtocolParser::frameReceived, m_firmwareUpgrader, &FirmwareUpgrader::handleFrame);
+    QObject::connect(m_protocolParser, &ProtocolParser::framesReceived, m_firmwareUpgrader, &FirmwareUpgrader::handleFrames);
+    QObject::connect(m_protocolParser, &ProtocolParser::frameReceived, m_trajectoryStreamer, &TrajectoryStreamer::handleFrame);
+    QObject::connect(m_protocolParser, &ProtocolParser::framesReceived, m_trajectoryStreamer, &TrajectoryStreamer::handleFrames);
+    // 实时数据共享内存在网络线程直接写入（发布对象属于主线程，必须显式直接连接）
+    QObject::connect(m_protocolParser, &ProtocolParser::frameReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
+    QObject::connect(m_protocolParser, &ProtocolParser::framesReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrames, Qt::DirectConnection);
+    QObject::connect(m_protocolParser, &ProtocolParser::sampleFrameReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
 }
 
 void TcpCommunication::processReceivedData(const QByteArray& data)
@@ -1017,19 +1425,8 @@ void TcpCommunication::updateConnectionStatistics()
 
 void TcpCommunication::calculateLatency()
 {
-    // TCP网络延迟计算可以通过ping或者心跳响应时间来估算
-    // 这里使用简化的方法，基于本地和远程地址计算大概的延迟
-    if (m_lastHeartbeatTime > 0) {
-        qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-        qint64 elapsed = currentTime - m_lastHeartbeatTime;
-        
-        // 更新平均延迟（简单移动平均）
-        if (m_statistics.averageLatency == 0.0) {
-            m_statistics.averageLatency = elapsed;
-        } else {
-            m_statistics.averageLatency = (m_statistics.averageLatency * 0.8) + (elapsed * 0.2);
-        }
-    }
+    // 平均延迟取自心跳往返时间，由 recordHeartbeatRtt() 在收到回送时更新；
+    // 此前按"距上次发送心跳的时间"做移动平均，反映的是心跳间隔而不是网络延迟
 }
 
 void TcpCommunication::sendKeepAlive()
@@ -1047,4 +1444,271 @@ void TcpCommunication::sendKeepAlive()
     } else {
         logMessage("Keep-Alive包发送失败", "WARNING");
     }
-} 
\ No newline at end of file
+} 
+
+void TcpCommunication::readIntoPooledBuffers()
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    qint64 totalBytes = 0;
+    
+    while (m_tcpSocket->bytesAvailable() > 0) {
+        const int chunkSize = static_cast<int>(
+            qMin<qint64>(m_tcpSocket->bytesAvailable(), Communication::TCP_READ_CHUNK_SIZE));
+        
+        QByteArray* buffer = pool->acquireBuffer(chunkSize);
+        if (!buffer) {
+            // 缓冲池不可用时退化为普通读取
+            const QByteArray data = m_tcpSocket->read(chunkSize);
+            if (data.isEmpty()) {
+                break;
+            }
+            totalBytes += data.size();
+            deliverPooledData(data.constData(), data.size());
+            continue;
+        }
+        
+        buffer->resize(chunkSize);
+        const qint64 bytesRead = m_tcpSocket->read(buffer->data(), chunkSize);
+        if (bytesRead > 0) {
+            buffer->resize(static_cast<int>(bytesRead));
+            totalBytes += bytesRead;
+            deliverPooledData(buffer->constData(), buffer->size());
+        }
+        pool->releaseBuffer(buffer);
+        
+        if (bytesRead <= 0) {
+            break;
+        }
+    }
+    
+    if (totalBytes == 0) {
+        return;
+    }
+    
+    m_statistics.bytesReceived += totalBytes;
+    m_statistics.framesReceived++;
+    updateLastActivity();
+    
+    // 本轮读取解析出的帧立即成批投递，不必等批量定时器
+    m_protocolParser->flushFrameBatch();
+}
+
+void TcpCommunication::deliverPooledData(const char* data, int length)
+{
+    auto deliver = [this](const char* bytes, int size) {
+        if (m_captureWriter) {
+            m_captureWriter->recordReceived(bytes, size);
+        }
+        processReceivedData(QByteArray::fromRawData(bytes, size));
+    };
+    
+    if (!m_compressionRequested) {
+        deliver(data, length);
+        return;
+    }
+    m_compression.decode(data, length, deliver, m_statistics);
+}
+
+bool TcpCommunication::setDedicatedNetworkThread(bool enabled)
+{
+    if (enabled == (m_networkThread != nullptr)) {
+        return true;
+    }
+    
+    if (m_ioThread) {
+        LogManager::getInstance()->warning("已加入连接组的TCP通讯对象不能启用专用网络线程", "TcpCommunication");
+        return false;
+    }
+    
+    if (isConnected() || m_connectionState == ConnectionState::Connecting) {
+        LogManager::getInstance()->warning("连接期间不能切换专用网络线程", "TcpCommunication");
+        return false;
+    }
+    
+    if (enabled) {
+        if (parent()) {
+            LogManager::getInstance()->warning("带父对象的TCP通讯对象无法迁移到专用网络线程", "TcpCommunication");
+            return false;
+        }
+        if (QThread::currentThread() != thread()) {
+            LogManager::getInstance()->warning("只能在对象所属线程中启用专用网络线程", "TcpCommunication");
+            return false;
+        }
+        
+        CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+        if (!pool->isInitialized()) {
+            pool->initialize();
+        }
+        
+        m_protocolParser->setBatchDelivery(true);
+        
+        m_networkThread = new QThread();
+        m_networkThread->setObjectName(QString("TcpNetwork-%1").arg(m_config.name));
+        // started 在新线程中发出，调度策略在事件循环运行之前应用
+        QObject::connect(m_networkThread, &QThread::started, []() {
+            ThreadPolicy::getInstance()->applyToCurrentThread(ThreadRole::TcpIo);
+        });
+        m_networkThread->start();
+        moveToThread(m_networkThread);
+        
+        LogManager::getInstance()->info("TCP通讯已迁移到专用网络线程", "TcpCommunication");
+        return true;
+    }
+    
+    if (QThread::currentThread() == m_networkThread) {
+        LogManager::getInstance()->warning("不能在网络线程内部停用专用网络线程", "TcpCommunication");
+        return false;
+    }
+    
+    // moveToThread 只能在对象当前所在线程调用
+    QThread* targetThread = QThread::currentThread();
+    invokeInNetworkThread([this, targetThread]() {
+        m_protocolParser->flushFrameBatch();
+        m_protocolParser->setBatchDelivery(false);
+        moveToThread(targetThread);
+        return true;
+    });
+    
+    QThread* networkThread = m_networkThread;
+    m_networkThread = nullptr;
+    networkThread->quit();
+    networkThread->wait();
+    delete networkThread;
+    
+    LogManager::getInstance()->info("TCP通讯已回到调用线程", "TcpCommunication");
+    return true;
+}
+
+bool TcpCommunication::isDedicatedNetworkThreadEnabled() const
+{
+    return m_networkThread != nullptr;
+}
+
+bool TcpCommunication::joinIoThread(IoThread* ioThread)
+{
+    if (!ioThread || ioThread == m_ioThread) {
+        return ioThread != nullptr;
+    }
+    if (m_ioThread || m_networkThread) {
+        LogManager::getInstance()->warning("TCP通讯对象已在其他网络线程中", "TcpCommunication");
+        return false;
+    }
+    if (isConnected() || m_connectionState == ConnectionState::Connecting) {
+        LogManager::getInstance()->warning("连接期间不能加入连接组", "TcpCommunication");
+        return false;
+    }
+    if (parent()) {
+        LogManager::getInstance()->warning("带父对象的TCP通讯对象无法迁移到I/O线程", "TcpCommunication");
+        return false;
+    }
+    if (QThread::currentThread() != thread()) {
+        LogManager::getInstance()->warning("只能在对象所属线程中加入连接组", "TcpCommunication");
+        return false;
+    }
+    
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    if (!pool->isInitialized()) {
+        pool->initialize();
+    }
+    
+    m_protocolParser->setBatchDelivery(true);
+    ioThread->addConnection();
+    m_ioThread = ioThread;
+    moveToThread(ioThread->ioThread());
+    
+    // 时间轮只能在 I/O 线程中访问
+    invokeInNetworkThread([this]() {
+        attachTimersToWheel(m_ioThread->timerWheel());
+        return true;
+    });
+    
+    LogManager::getInstance()->info(
+        QString("TCP通讯 %1 已加入I/O线程 %2").arg(m_config.name).arg(ioThread->index()), "TcpCommunication");
+    return true;
+}
+
+bool TcpCommunication::leaveIoThread()
+{
+    if (!m_ioThread) {
+        return true;
+    }
+    if (isConnected() || m_connectionState == ConnectionState::Connecting) {
+        LogManager::getInstance()->warning("连接期间不能离开连接组", "TcpCommunication");
+        return false;
+    }
+    
+    // moveToThread 只能在对象当前所在线程调用；在 I/O 线程内调用时留在该线程，只是不再使用时间轮
+    QThread* targetThread = QThread::currentThread();
+    invokeInNetworkThread([this, targetThread]() {
+        attachTimersToWheel(nullptr);
+        m_protocolParser->flushFrameBatch();
+        m_protocolParser->setBatchDelivery(false);
+        moveToThread(targetThread);
+        return true;
+    });
+    
+    m_ioThread->removeConnection();
+    m_ioThread = nullptr;
+    return true;
+}
+
+IoThread* TcpCommunication::ioThread() const
+{
+    return m_ioThread;
+}
+
+void TcpCommunication::attachTimersToWheel(TimerWheel* wheel)
+{
+    for (ConnectionTimer* timer : {m_heartbeatTimer, m_reconnectTimer, m_connectionTimer,
+                                   m_statisticsTimer, m_keepAliveTimer}) {
+        timer->attachWheel(wheel);
+    }
+}
+
+bool TcpCommunication::startCapture(const QString& filePath)
+{
+    return invokeInNetworkThread([this, filePath]() {
+        auto writer = std::make_unique<LinkCaptureWriter>();
+        const QString source = QString("%1:%2").arg(m_config.hostAddress).arg(m_config.port);
+        if (!writer->open(filePath, CaptureLinkType::Tcp, source)) {
+            handleError(writer->lastError());
+            return false;
+        }
+        m_captureWriter = std::move(writer);
+        return true;
+    });
+}
+
+void TcpCommunication::stopCapture()
+{
+    invokeInNetworkThread([this]() {
+        m_captureWriter.reset();
+        return true;
+    });
+}
+
+bool TcpCommunication::isCapturing() const
+{
+    return m_captureWriter != nullptr;
+}
+
+bool TcpCommunication::usesNetworkThread() const
+{
+    return m_networkThread || m_ioThread;
+}
+
+bool TcpCommunication::isForeignThreadCall() const
+{
+    return usesNetworkThread() && QThread::currentThread() != thread();
+}
+
+bool TcpCommunication::invokeInNetworkThread(const std::function<bool()>& task)
+{
+    if (!isForeignThreadCall()) {
+        return task();
+    }
+    
+    bool result = false;
+    QMetaObject::invokeMethod(this, [&result, &task]() { result = task(); }, Qt::BlockingQueuedConnection);
+    return result;
+}
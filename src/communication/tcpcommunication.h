@@ -1,11 +1,21 @@
 #pragma once
 
 #include "icommunication.h"
+#include "commandpipeline.h"
+#include "firmwareupgrader.h"
+#include "trajectorystreamer.h"
+#include "parametersync.h"
+#include "linkcapture.h"
+#include "linkcompression.h"
+#include "connectiongroup.h"
 #include <QTcpSocket>
 #include <QHostAddress>
 #include <QTimer>
 #include <QMutex>
 #include <QQueue>
+#include <QThread>
+#include <functional>
+#include <memory>
 
 // TCP特定配置
 struct TcpConfig : public CommunicationConfig {
@@ -15,6 +25,8 @@ struct TcpConfig : public CommunicationConfig {
     int readTimeout;
     int writeTimeout;
     bool keepAlive;
+    bool compressionEnabled;        // 连接后向对端请求 LZ4 链路压缩
+    int compressionThreshold;       // 成批待发字节达到该值才压缩
     
     TcpConfig() : CommunicationConfig() {
         type = CommunicationType::TCP;
@@ -25,10 +37,16 @@ struct TcpConfig : public CommunicationConfig {
         readTimeout = Communication::TCP_READ_TIMEOUT;
         writeTimeout = Communication::TCP_READ_TIMEOUT;
         keepAlive = true;
+        compressionEnabled = LinkCompression::defaultEnabled();
+        compressionThreshold = Communication::LINK_COMPRESSION_THRESHOLD;
     }
     
     // 从基类转换
+    // 传入的本身就是 TcpConfig 时保留全部字段
     static TcpConfig fromBase(const CommunicationConfig& base) {
+        if (const TcpConfig* derived = dynamic_cast<const TcpConfig*>(&base)) {
+            return *derived;
+        }
         TcpConfig config;
         config.name = base.name;
         config.autoReconnect = base.autoReconnect;
@@ -62,6 +80,15 @@ public:
     bool sendFrame(ProtocolCommand command, const QByteArray& data = QByteArray()) override;
     QByteArray receiveData() override;
     
+    // 异步命令管线（在途窗口内连续发送，按响应匹配请求）
+    CommandPipeline* getCommandPipeline() const;
+    // 固件升级引擎（滑动窗口发送数据块，断开时暂停，重连后 resume() 续传）
+    FirmwareUpgrader* getFirmwareUpgrader() const;
+    // 轨迹流式下发（按控制器缓冲区窗口发送批量运动帧，断开时暂停，重连后 resume() 续传）
+    TrajectoryStreamer* getTrajectoryStreamer() const;
+    // 设备参数影子副本与增量同步（重连后按参数集哈希决定是否全量读取）
+    ParameterSynchronizer* getParameterSynchronizer() const;
+    
     // 配置管理
     void setConfig(const CommunicationConfig& config) override;
     CommunicationConfig getConfig() const override;
@@ -109,6 +136,34 @@ public:
     quint16 getPeerPort() const;
     QString getLocalAddress() const;
     quint16 getLocalPort() const;
+    
+    // 专用网络线程：套接字、协议解析器和心跳/Keep-Alive定时器整体迁移到独立线程，
+    // 接收数据读入 CommunicationBufferPool 的缓冲区并在该线程解析，
+    // 只有批量帧（framesReceived）和状态类信号跨线程投递；此模式下不再发出 dataReceived/frameReceived。
+    // 仅在断开状态下、由对象所属线程调用，且对象不能有父对象
+    bool setDedicatedNetworkThread(bool enabled);
+    bool isDedicatedNetworkThreadEnabled() const;
+    
+    // 连接组 I/O 线程：与专用网络线程相同的接收路径和跨线程调用规则，但线程由多个连接共用，
+    // 五个定时器改挂在该线程的时间轮上。由 ConnectionGroup 调用，条件与 setDedicatedNetworkThread 相同；
+    // 离开时回到调用线程
+    bool joinIoThread(IoThread* ioThread);
+    bool leaveIoThread();
+    IoThread* ioThread() const;
+    
+    // 链路压缩：compressionEnabled 时连接后发送 NegotiateCompression，对端同意后
+    // 同一轮事件循环内发送的普通帧合并，达到 compressionThreshold 时压缩为一个 LZ4 块发送；
+    // 安全帧不参与合并。收发的压缩前后字节数见 CommunicationStats
+    
+    // 链路抓包：收发的原始字节带时间戳写入抓包文件，可由 CaptureReplayer 回放（压缩块记录解压后的字节）。
+    // 写入器在套接字所在线程使用，从其他线程调用时同步转到该线程执行
+    bool startCapture(const QString& filePath);
+    void stopCapture();
+    bool isCapturing() const;
+
+signals:
+    // 专用网络线程或连接组模式下解析出的批量帧
+    void framesReceived(const FrameBatch& frames);
 
 public slots:
     void reconnect() override;
@@ -132,6 +187,7 @@ protected slots:
     void onTcpStateChanged(QAbstractSocket::SocketState state);
 
 protected:
+    bool event(QEvent* event) override;
     void setState(ConnectionState state) override;
     void handleError(const QString& error) override;
     void updateLastActivity() override;
@@ -150,6 +206,9 @@ protected:
     void stopConnectionTimer();
     void startReconnectTimer();
     void stopReconnectTimer();
+    void failReconnectAttempt(const QString& reason);
+    void cancelReconnect();
+    void startSessionTimers();
     QString tcpErrorToString(QAbstractSocket::SocketError error) const;
     QString tcpStateToString(QAbstractSocket::SocketState state) const;
 
@@ -157,16 +216,20 @@ private:
     // TCP对象
     QTcpSocket* m_tcpSocket;
     ProtocolParser* m_protocolParser;
+    CommandPipeline* m_commandPipeline;
+    FirmwareUpgrader* m_firmwareUpgrader;
+    TrajectoryStreamer* m_trajectoryStreamer;
+    ParameterSynchronizer* m_parameterSync;
     
     // 配置
     TcpConfig m_config;
     
-    // 定时器
-    QTimer* m_heartbeatTimer;
-    QTimer* m_reconnectTimer;
-    QTimer* m_connectionTimer;
-    QTimer* m_statisticsTimer;
-    QTimer* m_keepAliveTimer;
+    // 定时器（加入连接组后由 I/O 线程的时间轮驱动）
+    ConnectionTimer* m_heartbeatTimer;
+    ConnectionTimer* m_reconnectTimer;
+    ConnectionTimer* m_connectionTimer;
+    ConnectionTimer* m_statisticsTimer;
+    ConnectionTimer* m_keepAliveTimer;
     
     // 线程安全
     QMutex m_dataMutex;
@@ -179,6 +242,21 @@ private:
     // 状态追踪
     bool m_isConnecting;
     qint64 m_connectStartTime;
+    bool m_reconnectInFlight;       // 异步重连建连中，占用 ReconnectScheduler 的一个名额
+    
+    // 专用网络线程（未启用时为空）
+    QThread* m_networkThread;
+    // 所在的连接组 I/O 线程（未加入时为空），与专用网络线程互斥
+    IoThread* m_ioThread;
+    
+    // 链路抓包（只在套接字所在线程访问）
+    std::unique_ptr<LinkCaptureWriter> m_captureWriter;
+    
+    // 链路压缩（发送状态和合并缓冲区受 m_dataMutex 保护，接收解码只在套接字所在线程）
+    LinkCompression m_compression;
+    bool m_compressionRequested;
+    QByteArray m_compressionBuffer;
+    bool m_compressionFlushScheduled;
     
     // 辅助方法
     void initializeTimers();
@@ -187,4 +265,16 @@ private:
     void updateConnectionStatistics();
     void calculateLatency();
     void sendKeepAlive();
+    void readIntoPooledBuffers();
+    void deliverPooledData(const char* data, int length);
+    bool writeToSocket(const QByteArray& data, qint64 safetyStartNs);
+    bool bufferForCompressionLocked(const QByteArray& data);
+    bool flushCompressionBufferLocked();
+    void negotiateCompression();
+    void resetCompression();
+    QByteArray decodeReceived(const QByteArray& data);
+    bool usesNetworkThread() const;
+    void attachTimersToWheel(TimerWheel* wheel);
+    bool isForeignThreadCall() const;
+    bool invokeInNetworkThread(const std::function<bool()>& task);
 }; 
\ No newline at end of file
@@ -0,0 +1,494 @@
+#include "trajectorystreamer.h"
+#include "logger/logmanager.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr int ACK_SIZE = 9;     // 已接收段数(4) 空闲槽位(2) 缓冲容量(2) 状态(1)
+
+// 梯形速度曲线下走完 length 的时间：从 entry 加速到 feed 巡航，再减速到 exit；距离不够时只加速到峰值
+double segmentTime(double length, double entry, double exit, double feed, double acceleration)
+{
+    if (length <= 0.0) {
+        return 0.0;
+    }
+    const double accelDistance = (feed * feed - entry * entry) / (2.0 * acceleration);
+    const double decelDistance = (feed * feed - exit * exit) / (2.0 * acceleration);
+    if (accelDistance + decelDistance <= length) {
+        return (feed - entry) / acceleration + (feed - exit) / acceleration
+             + (length - accelDistance - decelDistance) / feed;
+    }
+    const double peak = std::sqrt((2.0 * acceleration * length + entry * entry + exit * exit) / 2.0);
+    return (peak - entry) / acceleration + (peak - exit) / acceleration;
+}
+}
+
+TrajectoryStreamer::TrajectoryStreamer(ProtocolParser* parser, FrameSender sender, QObject* parent)
+    : QObject(parent)
+    , m_parser(parser)
+    , m_sender(std::move(sender))
+    , m_plannedSeconds(0.0)
+    , m_maxAcceleration(Device::MAX_ACCELERATION)
+    , m_junctionDeviation(Device::JUNCTION_DEVIATION)
+    , m_state(StreamState::Idle)
+    , m_accepted(0)
+    , m_sent(0)
+    , m_freeSlots(Protocol::MOTION_STREAM_BUFFER_SEGMENTS)
+    , m_capacity(Protocol::MOTION_STREAM_BUFFER_SEGMENTS)
+    , m_resyncing(false)
+    , m_drained(false)
+    , m_retries(0)
+    , m_underruns(0)
+    , m_retransmitted(0)
+{
+    qRegisterMetaType<StreamProgress>("StreamProgress");
+
+    m_ackTimer = new QTimer(this);
+    m_ackTimer->setSingleShot(true);
+    connect(m_ackTimer, &QTimer::timeout, this, &TrajectoryStreamer::onAckTimeout);
+}
+
+TrajectoryStreamer::~TrajectoryStreamer()
+{
+    m_ackTimer->stop();
+}
+
+bool TrajectoryStreamer::plan(const std::vector<Waypoint>& waypoints)
+{
+    if (m_state == StreamState::Streaming || m_state == StreamState::Draining) {
+        LogManager::getInstance()->warning("轨迹下发中，不能更换轨迹", "TrajectoryStreamer");
+        return false;
+    }
+    close();
+    if (waypoints.empty()) {
+        LogManager::getInstance()->warning("轨迹为空", "TrajectoryStreamer");
+        return false;
+    }
+
+    const size_t count = waypoints.size();
+    const double acceleration = m_maxAcceleration;
+    std::vector<double> length(count, 0.0);
+    std::vector<double> feed(count, 0.0);
+    std::vector<double> exit(count, 0.0);
+    std::vector<double> ux(count, 0.0), uy(count, 0.0), uz(count, 0.0);
+
+    // 段 0 从当前位置定位到起点，长度未知，按停在起点处理
+    for (size_t i = 0; i < count; ++i) {
+        feed[i] = std::clamp(waypoints[i].speed, Device::MIN_SPEED, Device::MAX_SPEED);
+        if (i == 0) {
+            continue;
+        }
+        const double dx = waypoints[i].x - waypoints[i - 1].x;
+        const double dy = waypoints[i].y - waypoints[i - 1].y;
+        const double dz = waypoints[i].z - waypoints[i - 1].z;
+        length[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (length[i] > 1e-9) {
+            ux[i] = dx / length[i];
+            uy[i] = dy / length[i];
+            uz[i] = dz / length[i];
+        } else {
+            // 重复点沿用上一段的方向，不形成拐角
+            ux[i] = ux[i - 1];
+            uy[i] = uy[i - 1];
+            uz[i] = uz[i - 1];
+        }
+    }
+
+    // 拐点限速：按拐角偏差算出不停顿通过拐点 i（段 i 与段 i+1 之间）的最大速度
+    for (size_t i = 1; i + 1 < count; ++i) {
+        if (waypoints[i].dwellTime > 0) {
+            continue;           // 停留点必须停下
+        }
+        double limit = std::min(feed[i], feed[i + 1]);
+        const double cosTheta = -(ux[i] * ux[i + 1] + uy[i] * uy[i + 1] + uz[i] * uz[i + 1]);
+        if (cosTheta > 0.999999) {
+            limit = 0.0;        // 原路折返
+        } else if (cosTheta > -0.999999) {
+            const double sinHalf = std::sqrt(0.5 * (1.0 - cosTheta));
+            limit = std::min(limit, std::sqrt(acceleration * m_junctionDeviation * sinHalf / (1.0 - sinHalf)));
+        }
+        exit[i] = limit;
+    }
+
+    // 反向：每段出口速度必须能在下一段内减速到下一段的出口速度；最后一段停止
+    exit[count - 1] = 0.0;
+    for (size_t i = count - 1; i-- > 0;) {
+        exit[i] = std::min(exit[i], std::sqrt(exit[i + 1] * exit[i + 1] + 2.0 * acceleration * length[i + 1]));
+    }
+    // 正向：每段出口速度必须能从入口速度在本段内加速达到
+    double entry = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        exit[i] = std::min(exit[i], std::sqrt(entry * entry + 2.0 * acceleration * length[i]));
+        entry = exit[i];
+    }
+
+    m_segments.resize(count);
+    m_plannedSeconds = 0.0;
+    entry = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const Waypoint& waypoint = waypoints[i];
+        Segment& segment = m_segments[i];
+        segment.x = static_cast<float>(waypoint.x);
+        segment.y = static_cast<float>(waypoint.y);
+        segment.z = static_cast<float>(waypoint.z);
+        segment.feedSpeed = static_cast<float>(feed[i]);
+        segment.exitSpeed = static_cast<float>(exit[i]);
+        segment.dwellTime = static_cast<quint16>(std::clamp(waypoint.dwellTime, 0,
+                                                            int(std::numeric_limits<quint16>::max())));
+        segment.flags = waypoint.isGluePoint ? SEGMENT_GLUE : 0;
+
+        m_plannedSeconds += segmentTime(length[i], entry, exit[i], feed[i], acceleration)
+                          + segment.dwellTime / 1000.0;
+        entry = exit[i];
+    }
+
+    setState(StreamState::Ready);
+    LogManager::getInstance()->info(
+        QString("轨迹已规划: %1段, 每帧%2段, 预计执行%3秒")
+            .arg(count)
+            .arg(Protocol::MOTION_STREAM_SEGMENTS_PER_FRAME)
+            .arg(m_plannedSeconds, 0, 'f', 1),
+        "TrajectoryStreamer");
+    return true;
+}
+
+void TrajectoryStreamer::close()
+{
+    m_ackTimer->stop();
+    m_segments.clear();
+    m_plannedSeconds = 0.0;
+    m_accepted = 0;
+    m_sent = 0;
+    setState(StreamState::Idle);
+}
+
+bool TrajectoryStreamer::start()
+{
+    if (m_segments.empty() || m_state == StreamState::Streaming || m_state == StreamState::Draining) {
+        return false;
+    }
+
+    // 首段序号为 0 的批次让控制器开始一条新轨迹
+    m_accepted = 0;
+    m_sent = 0;
+    m_freeSlots = m_capacity;
+    m_resyncing = false;
+    m_drained = false;
+    m_retries = 0;
+    m_underruns = 0;
+    m_retransmitted = 0;
+    m_sessionTimer.start();
+    setState(StreamState::Streaming);
+    emitProgress();
+    pump();
+    return m_state == StreamState::Streaming;
+}
+
+bool TrajectoryStreamer::resume()
+{
+    if (m_state != StreamState::Suspended) {
+        return false;
+    }
+
+    LogManager::getInstance()->info(
+        QString("恢复轨迹下发，本地已接收 %1/%2 段").arg(m_accepted).arg(m_segments.size()), "TrajectoryStreamer");
+
+    // 先查询控制器的实际接收位置，再从该位置继续
+    m_sent = m_accepted;
+    m_resyncing = true;
+    m_retries = 0;
+    setState(StreamState::Streaming);
+    if (!sendBatch(m_accepted, 0)) {
+        suspendWithReason("发送状态查询失败");
+        return false;
+    }
+    m_ackTimer->start(Protocol::MOTION_STREAM_ACK_TIMEOUT);
+    return true;
+}
+
+void TrajectoryStreamer::suspend()
+{
+    if (m_state == StreamState::Streaming || m_state == StreamState::Draining) {
+        suspendWithReason("链路断开");
+    }
+}
+
+void TrajectoryStreamer::abort()
+{
+    if (m_state == StreamState::Streaming || m_state == StreamState::Draining || m_state == StreamState::Suspended) {
+        fail("下发已取消");
+    }
+}
+
+void TrajectoryStreamer::setMaxAcceleration(double acceleration)
+{
+    m_maxAcceleration = std::max(acceleration, 1.0);
+}
+
+double TrajectoryStreamer::maxAcceleration() const
+{
+    return m_maxAcceleration;
+}
+
+void TrajectoryStreamer::setJunctionDeviation(double deviation)
+{
+    m_junctionDeviation = std::max(deviation, 0.0);
+}
+
+double TrajectoryStreamer::junctionDeviation() const
+{
+    return m_junctionDeviation;
+}
+
+StreamState TrajectoryStreamer::state() const
+{
+    return m_state;
+}
+
+StreamProgress TrajectoryStreamer::progress() const
+{
+    StreamProgress result;
+    result.totalSegments = static_cast<quint32>(m_segments.size());
+    result.sentSegments = m_sent;
+    result.acceptedSegments = m_accepted;
+    result.bufferedSegments = std::max(0, m_capacity - m_freeSlots);
+    result.bufferCapacity = m_capacity;
+    result.underruns = m_underruns;
+    result.retransmittedSegments = m_retransmitted;
+    result.plannedSeconds = m_plannedSeconds;
+    return result;
+}
+
+const std::vector<TrajectoryStreamer::Segment>& TrajectoryStreamer::segments() const
+{
+    return m_segments;
+}
+
+QString TrajectoryStreamer::stateToString(StreamState state)
+{
+    switch (state) {
+    case StreamState::Idle:      return "空闲";
+    case StreamState::Ready:     return "就绪";
+    case StreamState::Streaming: return "下发中";
+    case StreamState::Draining:  return "执行中";
+    case StreamState::Suspended: return "已暂停";
+    case StreamState::Completed: return "已完成";
+    case StreamState::Failed:    return "失败";
+    default:                     return "未知";
+    }
+}
+
+bool TrajectoryStreamer::handleFrame(const ProtocolFrame& frame)
+{
+    if (m_state != StreamState::Streaming && m_state != StreamState::Draining) {
+        return false;
+    }
+    if (frame.command != ProtocolCommand::Response || frame.dataLength == 0) {
+        return false;
+    }
+
+    // 数据区首字节为原始命令码；单点运动帧的响应不足确认长度，不会被当作批量确认
+    const ProtocolCommand original = static_cast<ProtocolCommand>(static_cast<quint8>(frame.data[0]));
+    if (original != ProtocolCommand::MoveToPosition || frame.dataLength - 1 < ACK_SIZE) {
+        return false;
+    }
+    handleAck(frame.data + 1, frame.dataLength - 1);
+    return true;
+}
+
+void TrajectoryStreamer::handleFrames(const FrameBatch& frames)
+{
+    for (const ProtocolFrame& frame : frames) {
+        handleFrame(frame);
+    }
+}
+
+void TrajectoryStreamer::onAckTimeout()
+{
+    if (m_state != StreamState::Streaming && m_state != StreamState::Draining) {
+        return;
+    }
+    if (++m_retries > Protocol::MOTION_STREAM_MAX_RETRIES) {
+        suspendWithReason(QString("控制器连续 %1 次未确认").arg(Protocol::MOTION_STREAM_MAX_RETRIES));
+        return;
+    }
+
+    if (m_state == StreamState::Streaming && !m_resyncing && m_sent > m_accepted) {
+        LogManager::getInstance()->debug(
+            QString("段 %1 确认超时，重发 %2 段").arg(m_accepted).arg(m_sent - m_accepted), "TrajectoryStreamer");
+        m_retransmitted += m_sent - m_accepted;
+        m_sent = m_accepted;
+        pump();
+        return;
+    }
+
+    // 没有在途段：窗口已满或等待执行完毕，查询一次状态
+    if (!sendBatch(m_accepted, 0)) {
+        suspendWithReason("发送状态查询失败");
+        return;
+    }
+    m_ackTimer->start(Protocol::MOTION_STREAM_ACK_TIMEOUT);
+}
+
+bool TrajectoryStreamer::sendBatch(quint32 first, int count)
+{
+    QByteArray payload(Protocol::MOTION_STREAM_HEADER_SIZE + count * Protocol::MOTION_STREAM_SEGMENT_SIZE,
+                       Qt::Uninitialized);
+    char* out = payload.data();
+    qToBigEndian(first, out);
+    out[4] = static_cast<char>(count);
+    out += Protocol::MOTION_STREAM_HEADER_SIZE;
+
+    for (int i = 0; i < count; ++i) {
+        const Segment& segment = m_segments[first + i];
+        memcpy(out, &segment.x, 4);
+        memcpy(out + 4, &segment.y, 4);
+        memcpy(out + 8, &segment.z, 4);
+        memcpy(out + 12, &segment.feedSpeed, 4);
+        memcpy(out + 16, &segment.exitSpeed, 4);
+        qToBigEndian(segment.dwellTime, out + 20);
+        out[22] = static_cast<char>(segment.flags);
+        out += Protocol::MOTION_STREAM_SEGMENT_SIZE;
+    }
+
+    const QByteArray frame = m_parser->buildFrame(ProtocolCommand::MoveToPosition, payload);
+    return !frame.isEmpty() && m_sender && m_sender(frame);
+}
+
+void TrajectoryStreamer::pump()
+{
+    const quint32 total = static_cast<quint32>(m_segments.size());
+    while (m_state == StreamState::Streaming && !m_resyncing && m_sent < total) {
+        const int inFlight = static_cast<int>(m_sent - m_accepted);
+        const int remaining = static_cast<int>(total - m_sent);
+        const int count = std::min({Protocol::MOTION_STREAM_SEGMENTS_PER_FRAME, remaining, m_freeSlots - inFlight});
+        if (count <= 0) {
+            break;
+        }
+        // 窗口不够一整帧且还有在途段时等下一次确认，避免拆成很多小帧
+        if (count < Protocol::MOTION_STREAM_SEGMENTS_PER_FRAME && count < remaining && inFlight > 0) {
+            break;
+        }
+        if (!sendBatch(m_sent, count)) {
+            suspendWithReason(QString("发送段 %1 失败").arg(m_sent));
+            return;
+        }
+        m_sent += static_cast<quint32>(count);
+    }
+
+    // 有在途段时计时最早的未确认段，否则作为状态查询的间隔
+    if ((m_state == StreamState::Streaming || m_state == StreamState::Draining) && !m_ackTimer->isActive()) {
+        m_ackTimer->start(Protocol::MOTION_STREAM_ACK_TIMEOUT);
+    }
+}
+
+void TrajectoryStreamer::handleAck(const char* data, int length)
+{
+    if (length < ACK_SIZE) {
+        return;
+    }
+    const quint32 total = static_cast<quint32>(m_segments.size());
+    const quint32 next = qFromBigEndian<quint32>(data);
+    const int freeSlots = qFromBigEndian<quint16>(data + 4);
+    const int capacity = qFromBigEndian<quint16>(data + 6);
+    const quint8 status = static_cast<quint8>(data[8]);
+    if (capacity > 0) {
+        m_capacity = capacity;
+    }
+
+    if (m_resyncing) {
+        // 以控制器回报的位置为准
+        if (next != m_accepted) {
+            LogManager::getInstance()->info(
+                QString("控制器接收位置 %1 (本地记录 %2)").arg(next).arg(m_accepted), "TrajectoryStreamer");
+        }
+        m_resyncing = false;
+        m_accepted = std::min(next, total);
+        m_sent = m_accepted;
+        m_ackTimer->stop();
+    } else if (next < m_accepted || next > m_sent) {
+        // 过期的确认，或确认了尚未发送的段（重发后迟到的旧确认），忽略
+        return;
+    }
+
+    const bool advanced = next > m_accepted;
+    m_accepted = std::min(next, total);
+    m_freeSlots = freeSlots;
+    if (advanced || m_sent == m_accepted) {
+        m_retries = 0;
+    }
+    if (advanced) {
+        m_ackTimer->stop();
+    }
+
+    // 轨迹还没下发完，控制器却已经执行完缓冲区里的所有段
+    if ((status & STATUS_IDLE) && m_accepted > 0 && m_accepted < total) {
+        if (!m_drained) {
+            m_drained = true;
+            ++m_underruns;
+            LogManager::getInstance()->warning(
+                QString("运动缓冲区欠载: 已接收 %1/%2 段，第 %3 次").arg(m_accepted).arg(total).arg(m_underruns),
+                "TrajectoryStreamer");
+            emit bufferUnderrun(m_accepted);
+        }
+    } else if (!(status & STATUS_IDLE)) {
+        m_drained = false;
+    }
+
+    if (m_accepted >= total) {
+        if (status & STATUS_IDLE) {
+            m_ackTimer->stop();
+            setState(StreamState::Completed);
+            emitProgress();
+            LogManager::getInstance()->info(
+                QString("轨迹执行完成: %1段, 欠载%2次, 重发%3段, 用时%4秒")
+                    .arg(total)
+                    .arg(m_underruns)
+                    .arg(m_retransmitted)
+                    .arg(m_sessionTimer.elapsed() / 1000.0, 0, 'f', 1),
+                "TrajectoryStreamer");
+            emit finished(true, "轨迹执行完成");
+            return;
+        }
+        setState(StreamState::Draining);
+    }
+
+    emitProgress();
+    pump();
+}
+
+void TrajectoryStreamer::fail(const QString& message)
+{
+    m_ackTimer->stop();
+    setState(StreamState::Failed);
+    LogManager::getInstance()->error(QString("轨迹下发失败: %1").arg(message), "TrajectoryStreamer");
+    emit finished(false, message);
+}
+
+void TrajectoryStreamer::suspendWithReason(const QString& reason)
+{
+    m_ackTimer->stop();
+    // 在途段视为未发送，恢复时与控制器重新核对位置
+    m_sent = m_accepted;
+    m_resyncing = false;
+    setState(StreamState::Suspended);
+    LogManager::getInstance()->warning(
+        QString("轨迹下发暂停: %1，已接收 %2/%3 段").arg(reason).arg(m_accepted).arg(m_segments.size()),
+        "TrajectoryStreamer");
+}
+
+void TrajectoryStreamer::setState(StreamState state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged(state);
+    }
+}
+
+void TrajectoryStreamer::emitProgress()
+{
+    emit progressChanged(progress());
+}
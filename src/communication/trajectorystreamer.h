@@ -0,0 +1,160 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <functional>
+#include <vector>
+#include "constants.h"
+#include "protocolparser.h"
+
+// 轨迹下发状态
+enum class StreamState {
+    Idle,           // 未加载轨迹
+    Ready,          // 已规划速度曲线，尚未开始
+    Streaming,      // 按控制器缓冲区窗口发送段
+    Draining,       // 全部段已被接收，等待控制器执行完毕
+    Suspended,      // 链路断开或确认超时，保留已接收位置，可 resume()
+    Completed,      // 控制器执行完最后一段
+    Failed
+};
+
+// 下发进度
+struct StreamProgress {
+    quint32 totalSegments = 0;
+    quint32 sentSegments = 0;
+    quint32 acceptedSegments = 0;       // 控制器已接收的连续段数
+    int bufferedSegments = 0;           // 控制器缓冲区中尚未执行的段数（最近一次确认）
+    int bufferCapacity = 0;
+    quint32 underruns = 0;              // 缓冲区被执行空的次数
+    quint32 retransmittedSegments = 0;
+    double plannedSeconds = 0.0;        // 按速度曲线估算的执行时间（含停留）
+};
+
+Q_DECLARE_METATYPE(StreamProgress)
+
+// 轨迹流式下发引擎 - 主机侧前瞻规划速度曲线，多段打包成一帧，按控制器缓冲区的空闲槽位连续发送
+//
+// 逐点发送单个 MoveToPosition 时控制器每到一个点都要停下来等下一条命令。这里先对整条轨迹做前瞻规划：
+// 按拐角偏差算出每个拐点不停顿能通过的速度，点胶点有停留时间时在该点停止，再用最大加速度做一遍反向
+// 和一遍正向约束，得到每段的出口速度；控制器按段的进给速度和出口速度插补即可连续运动。
+//
+// 报文格式（多字节整数均为大端，浮点为本机字节序，与单点运动帧一致）：
+//   MoveToPosition  首段序号(4) 段数(1) 段×N，每段：X Y Z(各4) 进给速度(4) 出口速度(4) 停留时间ms(2) 标志(1)
+//                   数据长度不等于 Protocol::MOTION_DATA_SIZE，与单点运动帧区分；段数为 0 时只查询状态
+//     响应          [0x15] 已接收段数(4) 空闲槽位(2) 缓冲容量(2) 状态(1)
+// 标志 bit0 为点胶点；状态 bit0 表示已执行完所有接收的段。首段序号为 0 且带段的批次开始一条新轨迹，
+// 此外控制器只按序接收，首段序号不等于已接收段数的批次被丢弃；执行中缓冲区腾出槽位时也主动回报。
+// 主机的可用窗口为 空闲槽位 - 已发送未确认段数，最早未确认段超时后从已接收位置重发（go-back-N）；
+// 窗口为 0 且没有在途段时按超时间隔查询状态。
+// 轨迹未下发完时控制器回报缓冲区为空即记为一次欠载（bufferUnderrun），说明链路跟不上执行速度。
+//
+// 对象在所属线程中使用，回调和信号都在该线程中执行。
+class TrajectoryStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    using FrameSender = std::function<bool(const QByteArray& frame)>;
+
+    // 规划后的一段：从上一段终点运动到 (x, y, z)
+    struct Segment {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+        float feedSpeed = 0;        // 巡航速度 mm/s
+        float exitSpeed = 0;        // 到达终点时的速度 mm/s
+        quint16 dwellTime = 0;      // 到达后停留 ms
+        quint8 flags = 0;
+    };
+
+    static constexpr quint8 SEGMENT_GLUE = 0x01;
+    static constexpr quint8 STATUS_IDLE = 0x01;
+
+    TrajectoryStreamer(ProtocolParser* parser, FrameSender sender, QObject* parent = nullptr);
+    ~TrajectoryStreamer();
+
+    // Points 为支持 size() 和下标访问的容器，元素带 x、y、z、speed、dwellTime、isGluePoint 成员
+    // （GlueProgram::TrajectoryPoint）；加载后立即规划速度曲线
+    template <typename Points>
+    bool load(const Points& points)
+    {
+        std::vector<Waypoint> waypoints;
+        waypoints.reserve(static_cast<size_t>(points.size()));
+        for (const auto& point : points) {
+            waypoints.push_back({point.x, point.y, point.z, point.speed,
+                                 point.isGluePoint ? point.dwellTime : 0, point.isGluePoint});
+        }
+        return plan(waypoints);
+    }
+    void close();
+
+    bool start();
+    bool resume();
+    // 停止发送并保留已接收位置，链路断开时调用
+    void suspend();
+    void abort();
+
+    void setMaxAcceleration(double acceleration);
+    double maxAcceleration() const;
+    void setJunctionDeviation(double deviation);
+    double junctionDeviation() const;
+
+    StreamState state() const;
+    StreamProgress progress() const;
+    const std::vector<Segment>& segments() const;
+
+    static QString stateToString(StreamState state);
+
+public slots:
+    // 处理批量运动帧的响应，被消费时返回true
+    bool handleFrame(const ProtocolFrame& frame);
+    void handleFrames(const FrameBatch& frames);
+
+signals:
+    void stateChanged(StreamState state);
+    void progressChanged(const StreamProgress& progress);
+    void bufferUnderrun(quint32 acceptedSegments);
+    void finished(bool success, const QString& message);
+
+private slots:
+    void onAckTimeout();
+
+private:
+    struct Waypoint {
+        double x, y, z;
+        double speed;
+        int dwellTime;
+        bool isGluePoint;
+    };
+
+    bool plan(const std::vector<Waypoint>& waypoints);
+    bool sendBatch(quint32 first, int count);
+    void pump();
+    void handleAck(const char* data, int length);
+    void fail(const QString& message);
+    void suspendWithReason(const QString& reason);
+    void setState(StreamState state);
+    void emitProgress();
+
+    ProtocolParser* m_parser;
+    FrameSender m_sender;
+    std::vector<Segment> m_segments;
+    double m_plannedSeconds;
+    double m_maxAcceleration;
+    double m_junctionDeviation;
+
+    StreamState m_state;
+    quint32 m_accepted;             // [0, m_accepted) 已被控制器接收
+    quint32 m_sent;                 // [m_accepted, m_sent) 在途
+    int m_freeSlots;                // 最近一次确认时的空闲槽位，已扣除当时已接收的段
+    int m_capacity;
+    bool m_resyncing;               // 恢复后先查询控制器的实际接收位置
+    bool m_drained;                 // 已记录本次欠载，缓冲区重新有段后清除
+    int m_retries;
+    quint32 m_underruns;
+    quint32 m_retransmitted;
+    QTimer* m_ackTimer;
+    QElapsedTimer m_sessionTimer;
+};
@@ -12,6 +12,23 @@
 #include <QRegularExpression>
 #include <QHostAddress>
 #include <QUrl>
+#include <QThread>
+#include <QTimer>
+#include "constants.h"
+
+namespace {
+// INI 文件读回的数值是字符串，与写入时的 int 等类型按文本比较
+bool sameConfigValue(const QVariant& a, const QVariant& b)
+{
+    if (a == b) {
+        return true;
+    }
+    if (a.typeId() == b.typeId() || a.isNull() || b.isNull()) {
+        return false;
+    }
+    return a.canConvert<QString>() && b.canConvert<QString>() && a.toString() == b.toString();
+}
+}
 
 ConfigManager* ConfigManager::instance = nullptr;
 QMutex ConfigManager::mutex;
@@ -28,6 +45,7 @@ ConfigManager* ConfigManager::getInstance()
 ConfigManager::ConfigManager(QObject* parent)
     : QObject(parent)
     , configWatcher(nullptr)
+    , persistTimer(nullptr)
     , encryptionEnabled(false)
     , configChangeCount(0)
     , configMonitoring(false)
@@ -42,6 +60,17 @@ ConfigManager::ConfigManager(QObject* parent)
     
     settings = new QSettings(configPath, QSettings::IniFormat);
     loadDefaults();
+    {
+        QWriteLocker locker(&cacheLock);
+        reloadCacheLocked();
+    }
+    
+    // 连续的修改合并为一次写盘
+    persistTimer = new QTimer(this);
+    persistTimer->setSingleShot(true);
+    persistTimer->setInterval(System::CONFIG_PERSIST_DELAY_MS);
+    connect(persistTimer, &QTimer::timeout, this, &ConfigManager::persistPending);
+    
     setupConfigMonitoring();
     
     // 初始化状态
@@ -52,7 +81,7 @@ ConfigManager::~ConfigManager()
 {
     stopConfigMonitoring();
     if (settings) {
-        settings->sync();
+        sync();
     }
 }
 
@@ -113,6 +142,12 @@ void ConfigManager::loadDefaults()
     if (!settings->contains("Log/MaxSize")) {
         settings->setValue("Log/MaxSize", 10 * 1024 * 1024); // 10MB
     }
+    if (!settings->contains("Log/Format")) {
+        settings->setValue("Log/Format", "Text");
+    }
+    if (!settings->contains("Log/Storage")) {
+        settings->setValue("Log/Storage", "File");
+    }
     
     // 界面默认配置
     if (!settings->contains("UI/Language")) {
@@ -128,200 +163,229 @@ void ConfigManager::loadDefaults()
 // 串口配置
 QString ConfigManager::getSerialPort() const
 {
-    return settings->value("Serial/Port").toString();
+    QReadLocker locker(&cacheLock);
+    return typedValues.serialPort;
 }
 
 void ConfigManager::setSerialPort(const QString& port)
 {
-    settings->setValue("Serial/Port", port);
-    emit configChanged("Serial/Port", port);
+    storeValue("Serial/Port", port);
 }
 
 int ConfigManager::getBaudRate() const
 {
-    return settings->value("Serial/BaudRate").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.baudRate;
 }
 
 void ConfigManager::setBaudRate(int rate)
 {
-    settings->setValue("Serial/BaudRate", rate);
-    emit configChanged("Serial/BaudRate", rate);
+    storeValue("Serial/BaudRate", rate);
 }
 
 int ConfigManager::getDataBits() const
 {
-    return settings->value("Serial/DataBits").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.dataBits;
 }
 
 void ConfigManager::setDataBits(int bits)
 {
-    settings->setValue("Serial/DataBits", bits);
-    emit configChanged("Serial/DataBits", bits);
+    storeValue("Serial/DataBits", bits);
 }
 
 int ConfigManager::getParity() const
 {
-    return settings->value("Serial/Parity").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.parity;
 }
 
 void ConfigManager::setParity(int parity)
 {
-    settings->setValue("Serial/Parity", parity);
-    emit configChanged("Serial/Parity", parity);
+    storeValue("Serial/Parity", parity);
 }
 
 int ConfigManager::getStopBits() const
 {
-    return settings->value("Serial/StopBits").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.stopBits;
 }
 
 void ConfigManager::setStopBits(int bits)
 {
-    settings->setValue("Serial/StopBits", bits);
-    emit configChanged("Serial/StopBits", bits);
+    storeValue("Serial/StopBits", bits);
 }
 
 int ConfigManager::getSerialTimeout() const
 {
-    return settings->value("Serial/Timeout").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.serialTimeout;
 }
 
 void ConfigManager::setSerialTimeout(int timeout)
 {
-    settings->setValue("Serial/Timeout", timeout);
-    emit configChanged("Serial/Timeout", timeout);
+    storeValue("Serial/Timeout", timeout);
 }
 
 // TCP配置
 QString ConfigManager::getTcpHost() const
 {
-    return settings->value("TCP/Host").toString();
+    QReadLocker locker(&cacheLock);
+    return typedValues.tcpHost;
 }
 
 void ConfigManager::setTcpHost(const QString& host)
 {
-    settings->setValue("TCP/Host", host);
-    emit configChanged("TCP/Host", host);
+    storeValue("TCP/Host", host);
 }
 
 int ConfigManager::getTcpPort() const
 {
-    return settings->value("TCP/Port").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.tcpPort;
 }
 
 void ConfigManager::setTcpPort(int port)
 {
-    settings->setValue("TCP/Port", port);
-    emit configChanged("TCP/Port", port);
+    storeValue("TCP/Port", port);
 }
 
 int ConfigManager::getTcpTimeout() const
 {
-    return settings->value("TCP/Timeout").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.tcpTimeout;
 }
 
 void ConfigManager::setTcpTimeout(int timeout)
 {
-    settings->setValue("TCP/Timeout", timeout);
-    emit configChanged("TCP/Timeout", timeout);
+    storeValue("TCP/Timeout", timeout);
 }
 
 // Modbus配置
 int ConfigManager::getModbusSlaveId() const
 {
-    return settings->value("Modbus/SlaveId").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.modbusSlaveId;
 }
 
 void ConfigManager::setModbusSlaveId(int id)
 {
-    settings->setValue("Modbus/SlaveId", id);
-    emit configChanged("Modbus/SlaveId", id);
+    storeValue("Modbus/SlaveId", id);
 }
 
 int ConfigManager::getModbusTimeout() const
 {
-    return settings->value("Modbus/Timeout").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.modbusTimeout;
 }
 
 void ConfigManager::setModbusTimeout(int timeout)
 {
-    settings->setValue("Modbus/Timeout", timeout);
-    emit configChanged("Modbus/Timeout", timeout);
+    storeValue("Modbus/Timeout", timeout);
 }
 
 // 数据库配置
 QString ConfigManager::getDatabasePath() const
 {
-    return settings->value("Database/Path").toString();
+    QReadLocker locker(&cacheLock);
+    return typedValues.databasePath;
 }
 
 void ConfigManager::setDatabasePath(const QString& path)
 {
-    settings->setValue("Database/Path", path);
-    emit configChanged("Database/Path", path);
+    storeValue("Database/Path", path);
 }
 
 // 日志配置
 QString ConfigManager::getLogLevel() const
 {
-    return settings->value("Log/Level").toString();
+    QReadLocker locker(&cacheLock);
+    return typedValues.logLevel;
 }
 
 void ConfigManager::setLogLevel(const QString& level)
 {
-    settings->setValue("Log/Level", level);
-    emit configChanged("Log/Level", level);
+    storeValue("Log/Level", level);
 }
 
 int ConfigManager::getLogMaxFiles() const
 {
-    return settings->value("Log/MaxFiles").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.logMaxFiles;
 }
 
 void ConfigManager::setLogMaxFiles(int maxFiles)
 {
-    settings->setValue("Log/MaxFiles", maxFiles);
-    emit configChanged("Log/MaxFiles", maxFiles);
+    storeValue("Log/MaxFiles", maxFiles);
 }
 
 int ConfigManager::getLogMaxSize() const
 {
-    return settings->value("Log/MaxSize").toInt();
+    QReadLocker locker(&cacheLock);
+    return typedValues.logMaxSize;
 }
 
 void ConfigManager::setLogMaxSize(int maxSize)
 {
-    settings->setValue("Log/MaxSize", maxSize);
-    emit configChanged("Log/MaxSize", maxSize);
+    storeValue("Log/MaxSize", maxSize);
+}
+
+QString ConfigManager::getLogFormat() const
+{
+    QReadLocker locker(&cacheLock);
+    return typedValues.logFormat;
+}
+
+void ConfigManager::setLogFormat(const QString& format)
+{
+    storeValue("Log/Format", format);
+}
+
+QString ConfigManager::getLogStorage() const
+{
+    QReadLocker locker(&cacheLock);
+    return typedValues.logStorage;
+}
+
+void ConfigManager::setLogStorage(const QString& storage)
+{
+    storeValue("Log/Storage", storage);
 }
 
 // 界面配置
 QString ConfigManager::getLanguage() const
 {
-    return settings->value("UI/Language").toString();
+    QReadLocker locker(&cacheLock);
+    return typedValues.language;
 }
 
 void ConfigManager::setLanguage(const QString& language)
 {
-    settings->setValue("UI/Language", language);
-    emit configChanged("UI/Language", language);
+    storeValue("UI/Language", language);
 }
 
 QString ConfigManager::getTheme() const
 {
-    return settings->value("UI/Theme").toString();
+    QReadLocker locker(&cacheLock);
+    return typedValues.theme;
 }
 
 void ConfigManager::setTheme(const QString& theme)
 {
-    settings->setValue("UI/Theme", theme);
-    emit configChanged("UI/Theme", theme);
+    storeValue("UI/Theme", theme);
+}
+
+ConfigValues ConfigManager::values() const
+{
+    QReadLocker locker(&cacheLock);
+    return typedValues;
 }
 
 // 通用配置方法
 QVariant ConfigManager::getValue(const QString& key, const QVariant& defaultValue) const
 {
-    return settings->value(key, defaultValue);
+    QReadLocker locker(&cacheLock);
+    return cachedValues.value(key, defaultValue);
 }
 
 void ConfigManager::setValue(const QString& key, const QVariant& value)
@@ -339,24 +403,188 @@ void ConfigManager::setValue(const QString& key, const QVariant& value)
         finalValue = encryptValue(value.toString());
     }
     
-    settings->setValue(key, finalValue);
-    configChangeCount++;
-    lastConfigChange = QDateTime::currentDateTime();
-    emit configChanged(key, value);
+    // 通知中的值与 getValue() 返回的一致（敏感项为加密后的值）
+    storeValue(key, finalValue);
 }
 
 void ConfigManager::sync()
 {
+    QWriteLocker locker(&cacheLock);
+    writePendingLocked();
     settings->sync();
 }
 
+bool ConfigManager::hasPendingWrites() const
+{
+    QReadLocker locker(&cacheLock);
+    return !pendingKeys.isEmpty();
+}
+
 void ConfigManager::resetToDefaults()
 {
-    settings->clear();
-    loadDefaults();
+    QStringList changedKeys;
+    {
+        QWriteLocker locker(&cacheLock);
+        pendingKeys.clear();
+        settings->clear();
+        loadDefaults();
+        changedKeys = reloadCacheLocked();
+        configChangeCount++;
+        lastConfigChange = QDateTime::currentDateTime();
+    }
+    notifyChanged(changedKeys);
+    qDebug() << "Configuration reset to defaults";
+}
+
+// 缓存实现
+void ConfigManager::storeValue(const QString& key, const QVariant& value)
+{
+    bool changed;
+    {
+        QWriteLocker locker(&cacheLock);
+        changed = storeValueLocked(key, value);
+    }
+    if (changed) {
+        schedulePersist();
+        emit configChanged(key, value);
+        emit configGroupChanged(key.section('/', 0, 0));
+    }
+}
+
+bool ConfigManager::storeValueLocked(const QString& key, const QVariant& value)
+{
+    auto it = cachedValues.find(key);
+    if (it != cachedValues.end() && sameConfigValue(*it, value)) {
+        return false;
+    }
+    if (it != cachedValues.end()) {
+        *it = value;
+    } else {
+        cachedValues.insert(key, value);
+    }
+    pendingKeys.insert(key);
+    refreshTypedValuesLocked();
     configChangeCount++;
     lastConfigChange = QDateTime::currentDateTime();
-    qDebug() << "Configuration reset to defaults";
+    return true;
+}
+
+QStringList ConfigManager::reloadCacheLocked()
+{
+    QHash<QString, QVariant> loaded;
+    const QStringList keys = settings->allKeys();
+    loaded.reserve(keys.size());
+    for (const QString& key : keys) {
+        loaded.insert(key, settings->value(key));
+    }
+    // 尚未写盘的修改（包括删除）优先于文件中的值
+    for (const QString& key : std::as_const(pendingKeys)) {
+        const auto pending = cachedValues.constFind(key);
+        if (pending != cachedValues.constEnd()) {
+            loaded.insert(key, *pending);
+        } else {
+            loaded.remove(key);
+        }
+    }
+    
+    QStringList changedKeys;
+    for (auto it = loaded.begin(); it != loaded.end(); ++it) {
+        const auto old = cachedValues.constFind(it.key());
+        if (old == cachedValues.constEnd()) {
+            changedKeys.append(it.key());
+        } else if (sameConfigValue(*old, it.value())) {
+            it.value() = *old;      // 保留原来的类型
+        } else {
+            changedKeys.append(it.key());
+        }
+    }
+    for (auto it = cachedValues.constBegin(); it != cachedValues.constEnd(); ++it) {
+        if (!loaded.contains(it.key())) {
+            changedKeys.append(it.key());
+        }
+    }
+    
+    cachedValues = std::move(loaded);
+    refreshTypedValuesLocked();
+    return changedKeys;
+}
+
+void ConfigManager::refreshTypedValuesLocked()
+{
+    auto value = [this](const char* key, const QVariant& fallback = QVariant()) {
+        return cachedValues.value(QString::fromLatin1(key), fallback);
+    };
+    
+    typedValues.serialPort = value("Serial/Port").toString();
+    typedValues.baudRate = value("Serial/BaudRate").toInt();
+    typedValues.dataBits = value("Serial/DataBits").toInt();
+    typedValues.parity = value("Serial/Parity").toInt();
+    typedValues.stopBits = value("Serial/StopBits").toInt();
+    typedValues.serialTimeout = value("Serial/Timeout").toInt();
+    typedValues.tcpHost = value("TCP/Host").toString();
+    typedValues.tcpPort = value("TCP/Port").toInt();
+    typedValues.tcpTimeout = value("TCP/Timeout").toInt();
+    typedValues.modbusSlaveId = value("Modbus/SlaveId").toInt();
+    typedValues.modbusTimeout = value("Modbus/Timeout").toInt();
+    typedValues.databasePath = value("Database/Path").toString();
+    typedValues.logLevel = value("Log/Level").toString();
+    typedValues.logMaxFiles = value("Log/MaxFiles").toInt();
+    typedValues.logMaxSize = value("Log/MaxSize").toInt();
+    typedValues.logFormat = value("Log/Format", "Text").toString();
+    typedValues.logStorage = value("Log/Storage", "File").toString();
+    typedValues.language = value("UI/Language").toString();
+    typedValues.theme = value("UI/Theme").toString();
+}
+
+void ConfigManager::writePendingLocked()
+{
+    for (const QString& key : std::as_const(pendingKeys)) {
+        const auto it = cachedValues.constFind(key);
+        if (it != cachedValues.constEnd()) {
+            settings->setValue(key, *it);
+        } else {
+            settings->remove(key);
+        }
+    }
+    pendingKeys.clear();
+}
+
+void ConfigManager::schedulePersist()
+{
+    // 定时器属于管理器所在线程，其他线程的修改投递过去启动
+    if (QThread::currentThread() == thread()) {
+        if (!persistTimer->isActive()) {
+            persistTimer->start();
+        }
+    } else {
+        QMetaObject::invokeMethod(this, [this]() { schedulePersist(); }, Qt::QueuedConnection);
+    }
+}
+
+void ConfigManager::persistPending()
+{
+    QWriteLocker locker(&cacheLock);
+    if (pendingKeys.isEmpty()) {
+        return;
+    }
+    const int keyCount = pendingKeys.size();
+    writePendingLocked();
+    settings->sync();
+    if (settings->status() != QSettings::NoError) {
+        qWarning() << "[ConfigManager] 配置写盘失败:" << settings->fileName() << "键数:" << keyCount;
+    }
+}
+
+void ConfigManager::notifyChanged(const QStringList& keys)
+{
+    QSet<QString> groups;
+    for (const QString& key : keys) {
+        emit configChanged(key, getValue(key));
+        groups.insert(key.section('/', 0, 0));
+    }
+    for (const QString& group : std::as_const(groups)) {
+        emit configGroupChanged(group);
+    }
 }
 
 // 配置验证实现
@@ -444,6 +672,12 @@ bool ConfigManager::validateLogConfig() const
     int maxSize = getLogMaxSize();
     if (maxSize < 1024 || maxSize > 1024*1024*1024) return false; // 1KB - 1GB
     
+    QString format = getLogFormat();
+    if (format != "Text" && format != "Binary") return false;
+    
+    QString storage = getLogStorage();
+    if (storage != "File" && storage != "MappedSegments") return false;
+    
     return true;
 }
 
@@ -792,11 +1026,13 @@ bool ConfigManager::isConfigMonitoring() const
 // 配置统计实现
 int ConfigManager::getConfigChangeCount() const
 {
+    QReadLocker locker(&cacheLock);
     return configChangeCount;
 }
 
 QDateTime ConfigManager::getLastConfigChange() const
 {
+    QReadLocker locker(&cacheLock);
     return lastConfigChange;
 }
 
@@ -814,29 +1050,65 @@ qint64 ConfigManager::getConfigFileSize() const
 // 配置分组管理实现
 QStringList ConfigManager::getConfigGroups() const
 {
-    return settings->childGroups();
+    // 与 QSettings::childGroups() 一致：只列出顶层组
+    QReadLocker locker(&cacheLock);
+    QStringList groups;
+    for (auto it = cachedValues.constBegin(); it != cachedValues.constEnd(); ++it) {
+        const int separator = it.key().indexOf('/');
+        if (separator > 0) {
+            const QString group = it.key().left(separator);
+            if (!groups.contains(group)) {
+                groups.append(group);
+            }
+        }
+    }
+    groups.sort();
+    return groups;
 }
 
 QStringList ConfigManager::getConfigKeys(const QString& group) const
 {
-    settings->beginGroup(group);
-    QStringList keys = settings->childKeys();
-    settings->endGroup();
+    // 与 QSettings::childKeys() 一致：只列出组下的直接子键
+    QReadLocker locker(&cacheLock);
+    const QString prefix = group + "/";
+    QStringList keys;
+    for (auto it = cachedValues.constBegin(); it != cachedValues.constEnd(); ++it) {
+        if (it.key().startsWith(prefix) && it.key().indexOf('/', prefix.size()) < 0) {
+            keys.append(it.key().mid(prefix.size()));
+        }
+    }
+    keys.sort();
     return keys;
 }
 
 bool ConfigManager::hasConfigGroup(const QString& group) const
 {
-    return settings->childGroups().contains(group);
+    return getConfigGroups().contains(group);
 }
 
 bool ConfigManager::removeConfigGroup(const QString& group)
 {
-    settings->beginGroup(group);
-    settings->remove("");
-    settings->endGroup();
-    configChangeCount++;
-    lastConfigChange = QDateTime::currentDateTime();
+    QStringList removedKeys;
+    {
+        QWriteLocker locker(&cacheLock);
+        const QString prefix = group + "/";
+        for (auto it = cachedValues.begin(); it != cachedValues.end();) {
+            if (it.key().startsWith(prefix)) {
+                removedKeys.append(it.key());
+                pendingKeys.insert(it.key());
+                it = cachedValues.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        refreshTypedValuesLocked();
+        configChangeCount++;
+        lastConfigChange = QDateTime::currentDateTime();
+    }
+    if (!removedKeys.isEmpty()) {
+        schedulePersist();
+        notifyChanged(removedKeys);
+    }
     return true;
 }
 
@@ -864,8 +1136,14 @@ void ConfigManager::setupConfigMonitoring()
 
 void ConfigManager::onConfigFileChanged()
 {
-    // 配置文件发生变化时重新加载
-    settings->sync();
+    // 配置文件发生变化时重新加载，只通知值有变化的键（自身写盘触发的变化不会产生通知）
+    QStringList changedKeys;
+    {
+        QWriteLocker locker(&cacheLock);
+        settings->sync();
+        changedKeys = reloadCacheLocked();
+    }
+    notifyChanged(changedKeys);
     emit configFileChanged();
 }
 
@@ -5,9 +5,39 @@
 #include <QVariant>
 #include <QString>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QDateTime>
 #include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
 
+class QTimer;
+
+// 常用配置项的类型化副本，由 ConfigManager 在加载和每次修改后更新
+struct ConfigValues {
+    QString serialPort;
+    int baudRate = 0;
+    int dataBits = 0;
+    int parity = 0;
+    int stopBits = 0;
+    int serialTimeout = 0;
+    QString tcpHost;
+    int tcpPort = 0;
+    int tcpTimeout = 0;
+    int modbusSlaveId = 0;
+    int modbusTimeout = 0;
+    QString databasePath;
+    QString logLevel;
+    int logMaxFiles = 0;
+    int logMaxSize = 0;
+    QString logFormat;
+    QString logStorage;
+    QString language;
+    QString theme;
+};
+
+// 配置管理器 - 启动时把 QSettings 的全部内容读入内存，读取只访问内存缓存（可在任意线程调用）；
+// 修改先写缓存并立即通知，再合并为一次延迟写盘（System::CONFIG_PERSIST_DELAY_MS），sync() 立即写盘
 class ConfigManager : public QObject
 {
     Q_OBJECT
@@ -65,6 +95,12 @@ public:
     int getLogMaxSize() const;
     void setLogMaxSize(int maxSize);
     
+    QString getLogFormat() const;           // "Text" 或 "Binary"
+    void setLogFormat(const QString& format);
+    
+    QString getLogStorage() const;          // "File" 或 "MappedSegments"
+    void setLogStorage(const QString& storage);
+    
     // 界面配置
     QString getLanguage() const;
     void setLanguage(const QString& language);
@@ -72,12 +108,16 @@ public:
     QString getTheme() const;
     void setTheme(const QString& theme);
     
+    // 类型化配置的副本，适合一次取多项
+    ConfigValues values() const;
+    
     // 通用配置方法
     QVariant getValue(const QString& key, const QVariant& defaultValue = QVariant()) const;
     void setValue(const QString& key, const QVariant& value);
     
-    // 保存配置
+    // 立即把尚未写盘的修改写入配置文件
     void sync();
+    bool hasPendingWrites() const;
     
     // 重置配置
     void resetToDefaults();
@@ -132,7 +172,9 @@ public:
     void setEncryptionKey(const QString& key);
 
 signals:
+    // 只在值确实变化时发出；configGroupChanged 在同一组的 configChanged 之后发出（键 "Serial/BaudRate" 的组为 "Serial"）
     void configChanged(const QString& key, const QVariant& value);
+    void configGroupChanged(const QString& group);
     void configValidationFailed(const QString& error);
     void configImported(const QString& filePath);
     void configExported(const QString& filePath);
@@ -149,6 +191,17 @@ private:
     void setupConfigMonitoring();
     void onConfigFileChanged();
     
+    // 缓存：调用方持有 cacheLock 的写锁
+    bool storeValueLocked(const QString& key, const QVariant& value);
+    QStringList reloadCacheLocked();
+    void refreshTypedValuesLocked();
+    void writePendingLocked();
+    
+    void storeValue(const QString& key, const QVariant& value);
+    void schedulePersist();
+    void persistPending();
+    void notifyChanged(const QStringList& keys);
+    
     bool validateValue(const QString& key, const QVariant& value) const;
     QString encryptValue(const QString& value) const;
     QString decryptValue(const QString& value) const;
@@ -162,6 +215,13 @@ private:
     QSettings* settings;
     class QFileSystemWatcher* configWatcher;
     
+    // 内存缓存（受 cacheLock 保护），settings 也只在持有写锁时访问
+    mutable QReadWriteLock cacheLock;
+    QHash<QString, QVariant> cachedValues;      // 完整键名 -> 值，与配置文件中的形式一致（敏感项为加密后的值）
+    ConfigValues typedValues;
+    QSet<QString> pendingKeys;                  // 已修改、尚未写入 settings 的键
+    QTimer* persistTimer;
+    
     // 配置状态
     bool encryptionEnabled;
     QString encryptionKey;
@@ -12,6 +12,12 @@ namespace Protocol {
     static constexpr int MAX_FRAME_SIZE = 261;       // 帧头(2) + 命令(1) + 最大数据长度(255) + 校验(1) + 帧尾(1)
     static constexpr int MAX_DATA_SIZE = 255;       // 最大数据长度
     static constexpr int MAX_BUFFER_SIZE = 2048;    // 最大缓冲区大小
+    static constexpr int RING_BUFFER_CAPACITY = 65536; // 环形接收缓冲区默认容量
+    static constexpr int FRAME_BATCH_SIZE = 64;        // 批量投递每批最大帧数
+    static constexpr int FRAME_BATCH_LATENCY_US = 2000; // 批量投递最大等待时间(us)
+    static constexpr int PIPELINE_WINDOW_SIZE = 4;     // 命令管线默认在途窗口
+    static constexpr int PIPELINE_REQUEST_TIMEOUT = 1000; // 命令管线默认请求超时(ms)
+    static constexpr int PIPELINE_MAX_PENDING = 1024;  // 命令管线最大排队请求数
     
     // 参数类型定义
     static constexpr quint8 PARAM_TYPE_INT = 0x01;
@@ -22,6 +28,7 @@ namespace Protocol {
     // 心跳相关常量
     static constexpr quint8 HEARTBEAT_TYPE_PING = 0x01;
     static constexpr quint8 HEARTBEAT_TYPE_PONG = 0x02;
+    static constexpr int HEARTBEAT_MAX_RTT_MS = 60000;   // 超过该值的往返时间视为无效回送
     
     // 超时设置
     static constexpr int DEFAULT_TIMEOUT = 5000;     // 默认超时时间(ms)
@@ -31,6 +38,22 @@ namespace Protocol {
     // 重连设置
     static constexpr int MAX_RECONNECT_ATTEMPTS = 3;
     static constexpr int RECONNECT_DELAY = 5000;     // 重连延迟(ms)
+    
+    // 固件升级
+    static constexpr int UPGRADE_BLOCK_HEADER_SIZE = 8;  // 块序号(4) + 块CRC32C(4)
+    static constexpr int UPGRADE_BLOCK_SIZE = MAX_DATA_SIZE - UPGRADE_BLOCK_HEADER_SIZE; // 每块固件数据长度
+    static constexpr int UPGRADE_WINDOW_SIZE = 16;       // 未确认块的最大数量
+    static constexpr int UPGRADE_ACK_TIMEOUT = 1000;     // 最早未确认块的确认超时(ms)
+    static constexpr int UPGRADE_MAX_RETRIES = 5;        // 同一位置连续重传上限
+    static constexpr int UPGRADE_COMMAND_TIMEOUT = 10000; // 开始/结束升级的响应超时(ms)，设备可能需要擦写Flash
+    
+    // 轨迹流式下发（批量 MoveToPosition）
+    static constexpr int MOTION_STREAM_HEADER_SIZE = 5;      // 首段序号(4) + 段数(1)
+    static constexpr int MOTION_STREAM_SEGMENT_SIZE = 23;    // 坐标(12) + 进给速度(4) + 出口速度(4) + 停留时间(2) + 标志(1)
+    static constexpr int MOTION_STREAM_SEGMENTS_PER_FRAME = (MAX_DATA_SIZE - MOTION_STREAM_HEADER_SIZE) / MOTION_STREAM_SEGMENT_SIZE;
+    static constexpr int MOTION_STREAM_BUFFER_SEGMENTS = 64; // 首次确认之前假定的控制器运动缓冲区段数
+    static constexpr int MOTION_STREAM_ACK_TIMEOUT = 500;    // 在途段的确认超时，也是等待窗口时的状态查询间隔(ms)
+    static constexpr int MOTION_STREAM_MAX_RETRIES = 5;      // 连续超时上限，超过后暂停
 }
 
 // 系统常量定义
@@ -41,18 +64,105 @@ namespace System {
     // 日志相关
     static constexpr int MAX_LOG_LINES = 1000;
     static constexpr int MAX_LOG_FILE_SIZE = 10 * 1024 * 1024; // 10MB
+    static constexpr int LOG_THREAD_BUFFER_CAPACITY = 1024; // 每个线程的日志环形缓冲区条目数
+    static constexpr int LOG_FLUSH_INTERVAL_MS = 50;         // 日志写入线程的最长等待间隔
+    static constexpr int LOG_SEGMENT_SIZE = 4 * 1024 * 1024; // 内存映射日志段的预分配大小
+    static constexpr bool LOG_COMPRESS_SEALED_SEGMENTS = true; // 写满的日志段在后台压缩
+    static constexpr int TRACE_THREAD_BUFFER_EVENTS = 16384;  // 耗时跟踪每个线程保留的事件数，满后覆盖最旧的事件
+    static constexpr int STARTUP_PROFILE_KEEP = 20;          // 启动、关闭剖析报告各保留的份数
+    static constexpr int METRICS_MAX_FAMILIES = 128;         // 指标端点可注册的指标族数（每族可有任意条标签序列）
+    static constexpr int ALLOCATION_TRACKER_MAX_THREADS = 128; // 分配统计的线程槽位数，超出的线程合并计数
+    static constexpr int ALLOCATION_TRACKER_MAX_SITES = 128;   // 分配统计的作用域槽位数（2的幂）
+    static constexpr int ALLOCATION_METRIC_TOP_SITES = 5;      // 性能监控中列出的分配最多的作用域/线程数
+    
+    // 错误风暴抑制（ErrorHandler）
+    static constexpr int ERROR_STORM_WINDOW_MS = 1000;         // 相同错误的限流窗口
+    static constexpr int ERROR_STORM_BURST = 5;                // 每个窗口内完整记录的相同错误数，其余合并为一条
+    static constexpr int ERROR_STORM_MAX_KEYS = 1024;          // 同时跟踪的不同错误数，超出后不再限流新错误
+    static constexpr int ERROR_COUNTER_MAX_THREADS = 64;       // 错误计数的线程槽位数，超出的线程合并计数
     
     // 数据库相关
     static constexpr int DB_CONNECTION_TIMEOUT = 30000;
     static constexpr int DB_QUERY_TIMEOUT = 10000;
     static constexpr int DB_BACKUP_INTERVAL = 3600;  // 1小时
+    static constexpr int DB_BATCH_MAX_ROWS = 500;       // 单个写入事务的最大行数
+    static constexpr int DB_BATCH_MAX_DELAY_MS = 200;   // 行等待提交的最长时间
+    static constexpr int DB_CACHE_SIZE_KB = 16 * 1024;  // SQLite 页缓存大小
+    static constexpr int DB_STATISTICS_LOG_INTERVAL_MS = 60000; // 写入吞吐量日志间隔
+    static constexpr int DB_HISTORY_PAGE_SIZE = 500;    // 历史记录每页行数（按时间和ID分页）
+    static constexpr int DB_TABLE_CACHED_PAGES = 20;    // 分页表格在内存中保留的页数，超出后淘汰最久未显示的页
+    static constexpr int EXPORT_PROGRESS_ROWS = 5000;   // 导出每写入这么多行报告一次进度
+    static constexpr int EXPORT_BUFFER_BYTES = 256 * 1024; // 导出写缓冲区大小，满后写入文件
+    static constexpr int DB_BACKUP_KEEP = 24;           // 每个数据库保留的备份个数
+    static constexpr int DB_BACKUP_PROGRESS_INTERVAL_MS = 500; // 备份和恢复的进度报告间隔
+    static constexpr int DB_READER_THREADS = 2;          // 每个数据库服务的只读查询线程数，各用一个池连接
+    static constexpr int DB_POOL_VALIDATION_IDLE_MS = 10000; // 池连接空闲超过该时间后，复用前执行验证语句
+    static constexpr int DB_RECORD_RETENTION_DAYS = 365; // 质量数据和生产报警的保留天数，过期按月分区整体删除
+
+    // 传感器历史（列式时间序列存储）
+    static constexpr int HISTORY_CHUNK_MAX_POINTS = 8192;        // 每个压缩块的最大点数
+    static constexpr int HISTORY_CHUNK_MAX_SPAN_MS = 60000;      // 块跨越的最长时间，进程异常退出最多丢失这么久的数据
+    static constexpr qint64 HISTORY_SEGMENT_MAX_BYTES = 64LL * 1024 * 1024; // 单个段文件大小上限
+    static constexpr int HISTORY_RETENTION_DAYS = 180;           // 历史数据保留天数
     
     // 界面更新间隔
     static constexpr int UI_UPDATE_INTERVAL = 100;   // 100ms
     static constexpr int STATUS_UPDATE_INTERVAL = 1000; // 1秒
+    static constexpr double UI_DEFAULT_REFRESH_RATE = 60.0;     // 取不到屏幕刷新率时使用（Hz）
+    static constexpr int UI_FRAME_BUDGET_PERCENT = 50;          // 每帧留给界面更新回调的时间占帧周期的比例
+    static constexpr int UI_MAX_FRAME_DIVIDER = 4;              // 负载过高时最多每 4 帧刷新一次
+    static constexpr int UI_PAGE_WARMUP_INTERVAL_MS = 50;       // 首帧之后在后台逐个创建标签页的间隔，期间处理用户输入
+    static constexpr int STARTUP_PREALLOCATE_BUFFERS = 32;      // 启动时在工作线程为每种缓冲区类型预分配的个数
     
+    // 事件协调器
+    static constexpr int EVENT_LANE_CAPACITY = 1024;            // 每个优先级通道的无锁队列容量
+    static constexpr int EVENT_DISPATCH_BATCH = 256;            // 每轮分发的事件数上限，剩余的下一轮事件循环再分发
+
+    // 工作窃取线程池
+    static constexpr int WORK_STEALING_DEQUE_CAPACITY = 64;     // 每个线程每个优先级的双端队列初始容量，满后翻倍
+    static constexpr int WORK_STEALING_INBOX_CAPACITY = 256;    // 每个线程接收外部提交的无锁队列容量，满后放入共享溢出队列
+    static constexpr int LOAD_BALANCER_COMPLETED_HISTORY = 1024; // 负载均衡器保留的已完成任务记录数，满后覆盖最旧的记录
+    static constexpr int LOAD_BALANCER_TASK_NAME_LIMIT = 256;   // 按任务名汇总统计的名称数上限，超出的合并为"其他"
+
+    // 性能预测器在线学习
+    static constexpr double ML_ONLINE_FORGETTING_FACTOR = 0.995; // 递推最小二乘的遗忘因子，有效记忆约 200 个数据点
+    static constexpr double ML_ONLINE_SMOOTHING_ALPHA = 0.02;   // 指数加权统计和趋势的平滑系数，有效记忆约 50 个数据点
+    static constexpr int ML_ONLINE_MAX_FEATURES = 16;           // 每个预测目标参与回归的特征数上限
+    static constexpr int ML_ONLINE_WARMUP_SAMPLES = 10;         // 在线模型和异常统计至少学习这么多个点后才使用
+
+    // 智能分析器流式统计
+    static constexpr int ANALYZER_SEASONAL_LAG = 12;            // 季节性（自相关）的滞后点数，按 5 分钟采样为 1 小时
+    static constexpr double ANALYZER_EWMA_ALPHA = 0.3;          // 各指标指数平滑的平滑系数
+    static constexpr qint64 ANALYZER_HISTORY_MEMORY_LIMIT = 4LL * 1024 * 1024;  // 列式历史的默认内存上限，按层平均分配
+    static constexpr int ANALYZER_HISTORY_TIERS = 3;            // 原始数据加两级降采样
+    static constexpr int ANALYZER_HISTORY_DOWNSAMPLE_FACTOR = 12;   // 每级降采样把 12 个点合并为 1 个
+    static constexpr int TUNING_EXPERIMENT_WARMUP_SAMPLES = 2;      // 调参实验改值后丢弃的采集周期数
+    static constexpr int TUNING_EXPERIMENT_WINDOW_SAMPLES = 12;     // 调参实验对照/候选窗口各自的有效周期数
+    static constexpr double TUNING_EXPERIMENT_SIGNIFICANCE = 0.05;  // 调参实验的显著性水平
+    static constexpr int TUNING_AUDIT_HISTORY = 100;                // 内存中保留的调参实验记录数
+    // AdaptiveConfigManager 中由热路径组件读取的参数名
+    static constexpr const char* CONFIG_UI_UPDATE_INTERVAL = "ui_update_interval";         // 状态栏类更新间隔(ms)
+    static constexpr const char* CONFIG_BUFFER_POOL_SIZE = "communication_buffer_pool_size";
+    static constexpr const char* CONFIG_DATA_BATCH_SIZE = "data_process_batch_size";
+    static constexpr int CONFIG_PERSIST_DELAY_MS = 500;         // ConfigManager 合并修改后写盘的延迟
+
+    // 图表绘制降采样
+    static constexpr int CHART_DEFAULT_RENDER_COLUMNS = 800;    // 绘图区尚未布局时按此宽度（像素）降采样
+    static constexpr int CHART_MAX_RENDER_POINTS = 4000;        // 每个系列交给 QtCharts 的点数上限
+    static constexpr int CHART_FRAME_INTERVAL_MS = 33;          // 图表合并重绘的帧间隔（约 30 帧/秒）
+    static constexpr int MONITOR_CHART_BUFFER_POINTS = 20000;   // 实时监控每条曲线保留的原始点数
+    static constexpr int STRIP_CHART_MS_PER_COLUMN = 10;        // 条带图每个像素列代表的时间
+    static constexpr int STRIP_CHART_REFRESH_INTERVAL_MS = 33;  // 条带图滚动刷新间隔
+    static constexpr int STRIP_CHART_CHANNEL_POINTS = 60000;    // 条带图每个通道保留的原始点数（1 kHz 下 60 秒）
+    static constexpr int TRAFFIC_MONITOR_RECORDS = 20000;       // 报文监控保留的收发记录数，满后覆盖最旧的记录
+
+    // 界面数据缓存
+    static constexpr qint64 DATA_CACHE_DEFAULT_MAX_BYTES = 64LL * 1024 * 1024;  // 默认总容量
+    static constexpr int DATA_CACHE_DEFAULT_TTL_SECONDS = 300;                  // 默认过期时间
+
     // 性能监控
     static constexpr int PERFORMANCE_MONITOR_INTERVAL = 5000; // 5秒
+    static constexpr int FRAME_LATENCY_ALERT_P99_MS = 50;     // 采集周期内读取到绘制的 P99 超过此值时告警
     
     // 自动保存间隔
     static constexpr int AUTO_SAVE_INTERVAL = 300000; // 5分钟
@@ -67,6 +177,8 @@ namespace Device {
     static constexpr double MIN_POSITION = 0.0;
     static constexpr double MAX_SPEED = 100.0;
     static constexpr double MIN_SPEED = 0.1;
+    static constexpr double MAX_ACCELERATION = 1000.0;    // 前瞻规划使用的加速度(mm/s²)
+    static constexpr double JUNCTION_DEVIATION = 0.05;    // 拐角允许偏离的距离(mm)，决定不停顿通过拐角的速度
     
     // 点胶参数限制
     static constexpr double MAX_VOLUME = 10.0;     // 最大胶量(ml)
@@ -94,22 +206,98 @@ namespace Communication {
     static constexpr int DEFAULT_DATA_BITS = 8;
     static constexpr int DEFAULT_STOP_BITS = 1;
     
+    // 低延迟串口模式
+    static constexpr int SERIAL_FTDI_LATENCY_TIMER_MS = 1;    // FTDI 适配器的延迟定时器（驱动默认 16ms）
+    static constexpr int SERIAL_READ_BUFFER_WINDOW_MS = 500;  // 读缓冲区容纳的线路时间
+    static constexpr int SERIAL_READ_BUFFER_MIN = 4096;       // 读缓冲区下限（字节）
+    static constexpr int SERIAL_READ_IDLE_TIMEOUT_MS = 50;    // Windows 读请求在无数据时的超时，到期后重新发起
+    
     // TCP默认配置
     static constexpr quint16 DEFAULT_TCP_PORT = 502;
     static constexpr int TCP_CONNECT_TIMEOUT = 5000;
     static constexpr int TCP_READ_TIMEOUT = 3000;
+    static constexpr int TCP_READ_CHUNK_SIZE = 4096;          // 专用网络线程单次读取的块大小
+    static constexpr int LINK_COMPRESSION_THRESHOLD = 512;    // 成批待发字节达到该值才压缩
+    static constexpr int LINK_COMPRESSION_MAX_BLOCK = 16384;  // 单个压缩块的原始数据上限
+    
+    // 重连退避
+    static constexpr int RECONNECT_BACKOFF_MAX = 60000;       // 指数退避的间隔上限(ms)
+    static constexpr int RECONNECT_MAX_CONCURRENT = 4;        // 同时进行中的建连尝试上限
+    static constexpr int RECONNECT_DEFER_DELAY = 250;         // 名额已满时重排的基础延迟(ms)
+    
+    // 指标端点（Prometheus 抓取）
+    static constexpr quint16 METRICS_DEFAULT_PORT = 9464;
+    static constexpr int METRICS_REQUEST_MAX_BYTES = 8192;    // 请求头上限，超出直接断开
+    static constexpr int METRICS_REQUEST_TIMEOUT = 5000;      // 请求头未收齐时断开(ms)
+    
+    // 连接组：少量 I/O 线程各自承载多个连接，定时器由每线程一个时间轮驱动
+    static constexpr int IO_TIMER_WHEEL_TICK_MS = 10;         // 时间轮刻度(ms)，定时器精度不高于该值
+    static constexpr int IO_TIMER_WHEEL_SLOTS = 512;          // 槽位数（2 的幂），一圈约 5 秒
+    static constexpr int MAX_CONNECTIONS_DEFAULT = 64;        // CommunicationManager 默认连接数上限
+    
+    // 实时数据共享内存（外部程序读取解析后的采样）
+    static constexpr int LIVE_FEED_DEFAULT_CAPACITY = 8192;   // 环形区记录数，向上取整为 2 的幂
     
     // CAN默认配置
     static constexpr int DEFAULT_CAN_BITRATE = 250000;
     static constexpr int CAN_FRAME_TIMEOUT = 1000;
+    static constexpr int CAN_TX_MAX_PENDING = 256;            // 发送调度队列上限
+    static constexpr int CAN_TX_DEVICE_QUEUE_LIMIT = 4;       // 驱动中允许的未发出帧数
+    static constexpr int CAN_BUS_LOAD_WINDOW_MS = 100;        // 总线负载统计窗口
+    static constexpr double CAN_TX_DEFER_LOAD = 0.7;          // 超过该负载时推迟心跳/参数类帧
+    static constexpr int CAN_TX_MAX_DEFER_MS = 200;           // 可推迟帧的最长等待
+    static constexpr int CAN_RX_ARENA_SIZE = 16 * 1024;       // 接收批内存区初始大小
+    
+    // Modbus轮询配置
+    static constexpr int MODBUS_MAX_READ_REGISTERS = 125;     // 单次读寄存器上限（PDU 253字节）
+    static constexpr int MODBUS_MAX_READ_BITS = 2000;         // 单次读线圈/离散输入上限
+    static constexpr int MODBUS_GAP_TOLERANCE = 8;            // 合并块时允许跨过的空洞寄存器数
+    static constexpr int MODBUS_DEFAULT_POLL_INTERVAL = 100;  // 默认轮询周期(ms)
+    static constexpr int MODBUS_TCP_PIPELINE_DEPTH = 4;       // Modbus TCP 在途事务上限
+    static constexpr int MODBUS_REQUEST_TIMEOUT = 1000;       // 单次请求超时(ms)
+    
+    // 连接表快照旧版本的回收宽限期(ms)，远大于任何读者持有快照的时间
+    static constexpr int CONNECTION_SNAPSHOT_GRACE_MS = 1000;
+    
+    // 链路抓包配置
+    static constexpr int CAPTURE_BUFFER_SIZE = 256 * 1024;    // 单个写入缓冲区大小，写满后交给落盘线程
+    static constexpr int CAPTURE_MAX_PENDING_BUFFERS = 16;    // 待落盘缓冲区上限，超出后丢弃记录而不阻塞I/O线程
+    
+    // 数据处理分片配置
+    static constexpr int DATA_SHARD_MAX_COUNT = 16;           // 分片数上限，超出后连接按组共享分片
+    static constexpr int DATA_SHARD_ROLLUP_INTERVAL = 5000;   // 分片指标汇总周期(ms)
+    
+    // 数据处理工作线程事件驱动模式
+    static constexpr int DATA_WORKER_QUEUE_CAPACITY = 4096;   // 无锁任务队列容量
+    static constexpr int DATA_WORKER_SPIN_COUNT = 2000;       // 队列变空后的忙等次数
+    static constexpr int DATA_WORKER_YIELD_COUNT = 8;         // 忙等后让出CPU的次数，之后休眠
+    static constexpr int DATA_WORKER_SLICE_US = 2000;         // 连续处理超过该时间后让事件循环运行一次
+    static constexpr int DATA_WORKER_ARENA_SIZE = 64 * 1024;  // 批内存区初始大小，一批的临时数据超出后自动扩大
+    
+    // 通讯/处理线程调度策略（performance_config.json 的 threading_policy 节）
+    static constexpr int THREAD_REALTIME_DEFAULT_PRIORITY = 50;   // 未指定时的 SCHED_FIFO 优先级（1-99）
+    static constexpr int THREAD_HIGH_DEFAULT_NICE = 10;           // High 类别未指定时 nice 值降低的量
+    static constexpr int THREAD_JITTER_PROBE_INTERVAL_MS = 10;    // 唤醒抖动探测定时器间隔，0 为不探测
+    
+    // 安全指令（急停/停止/暂停）快速通道
+    static constexpr int FAST_LANE_QUEUE_CAPACITY = 256;      // 处理线程快速队列容量
+    static constexpr int FAST_LANE_LATENCY_BUDGET_US = 1000;  // 每个阶段的主机侧延迟预算(us)
     
     // 缓冲区大小
     static constexpr int SEND_BUFFER_SIZE = 1024;
     static constexpr int RECEIVE_BUFFER_SIZE = 2048;
     
+    // 写合并配置
+    static constexpr int WRITE_COALESCE_BYTE_BUDGET = 512;    // 单次合并写入的字节上限
+    static constexpr int WRITE_COALESCE_DEADLINE_US = 1000;   // 首帧入队后的最长等待(us)
+    
     // 重试配置
     static constexpr int MAX_SEND_RETRIES = 3;
     static constexpr int RETRY_DELAY = 1000;
+    
+    // 报警引擎限值组
+    static constexpr const char* MONITOR_ALARM_GROUP = "monitor";     // 监控页告警阈值
+    static constexpr const char* ALARM_PAGE_GROUP = "alarm";          // 报警页阈值配置
 }
 
 // 错误码定义
@@ -1,6 +1,7 @@
 #include "adaptiveconfigmanager.h"
 #include "continuousoptimizer.h"
 #include "intelligentanalyzer.h"
+#include "../constants.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -78,6 +79,7 @@ bool AdaptiveConfigManager::registerParameter(const ParameterDefinition& definit
     }
     
     m_parameters[definition.name] = definition;
+    publishSnapshotLocked();
     
     qDebug() << "[AdaptiveConfigManager] 已注册参数:" << definition.name 
              << "默认值:" << definition.defaultValue;
@@ -101,6 +103,15 @@ bool AdaptiveConfigManager::setParameterValue(const QString& name, const QVarian
 {
     QMutexLocker locker(&m_parametersMutex);
     
+    if (!setParameterValueLocked(name, value, reason)) {
+        return false;
+    }
+    publishSnapshotLocked();
+    return true;
+}
+
+bool AdaptiveConfigManager::setParameterValueLocked(const QString& name, const QVariant& value, const QString& reason)
+{
     if (!m_parameters.contains(name)) {
         qWarning() << "[AdaptiveConfigManager] 参数不存在:" << name;
         return false;
@@ -274,6 +285,11 @@ int AdaptiveConfigManager::triggerParameterAdjustment(ParameterType parameterTyp
         }
     }
     
+    // 本轮调整的参数在同一个快照版本里生效
+    if (adjustedCount > 0) {
+        publishSnapshotLocked();
+    }
+    
     m_totalAdjustments += adjustedCount;
     m_lastAdjustmentTime = QDateTime::currentDateTime();
     
@@ -436,6 +452,7 @@ bool AdaptiveConfigManager::importConfiguration(const QString& filePath)
                 }
             }
         }
+        publishSnapshotLocked();
     }
     
     // 导入其他设置
@@ -480,6 +497,10 @@ void AdaptiveConfigManager::resetToDefaults()
         }
     }
     
+    if (resetCount > 0) {
+        publishSnapshotLocked();
+    }
+    
     qDebug() << "[AdaptiveConfigManager] 已重置" << resetCount << "个参数为默认值";
 }
 
@@ -539,6 +560,8 @@ void AdaptiveConfigManager::applyIntelligentRecommendations(const QJsonArray& re
 {
     int appliedCount = 0;
     
+    // 一组建议整体发布为一个快照版本
+    QMutexLocker locker(&m_parametersMutex);
     for (const auto& recValue : recommendations) {
         QJsonObject rec = recValue.toObject();
         
@@ -546,10 +569,14 @@ void AdaptiveConfigManager::applyIntelligentRecommendations(const QJsonArray& re
         QVariant recommendedValue = rec["recommended_value"].toVariant();
         QString reason = rec["reason"].toString();
         
-        if (setParameterValue(parameterName, recommendedValue, "智能建议: " + reason)) {
+        if (setParameterValueLocked(parameterName, recommendedValue, "智能建议: " + reason)) {
             appliedCount++;
         }
     }
+    if (appliedCount > 0) {
+        publishSnapshotLocked();
+    }
+    locker.unlock();
     
     qDebug() << "[AdaptiveConfigManager] 应用智能建议完成:" << appliedCount << "/" << recommendations.size();
 }
@@ -579,6 +606,10 @@ int AdaptiveConfigManager::rollbackRecentAdjustments(int count)
         }
     }
     
+    if (rolledBackCount > 0) {
+        publishSnapshotLocked();
+    }
+    
     qDebug() << "[AdaptiveConfigManager] 已回滚" << rolledBackCount << "个调整";
     
     return rolledBackCount;
@@ -783,6 +814,17 @@ bool AdaptiveConfigManager::applyParameterAdjustment(const QString& name, const
     return true;
 }
 
+void AdaptiveConfigManager::publishSnapshotLocked()
+{
+    ConfigSnapshot snapshot;
+    snapshot.values.reserve(m_parameters.size());
+    for (auto it = m_parameters.constBegin(); it != m_parameters.constEnd(); ++it) {
+        snapshot.values.insert(it.key(), it.value().currentValue);
+    }
+    snapshot.publishedAt = QDateTime::currentDateTime();
+    m_snapshots.publish(std::move(snapshot));
+}
+
 double AdaptiveConfigManager::calculatePerformanceImprovement(const PerformanceState& beforeState, 
                                                              const PerformanceState& afterState) const
 {
@@ -924,7 +966,7 @@ void AdaptiveConfigManager::registerDefaultParameters()
     
     // UI相关参数
     ParameterDefinition uiUpdateInterval;
-    uiUpdateInterval.name = "ui_update_interval";
+    uiUpdateInterval.name = System::CONFIG_UI_UPDATE_INTERVAL;
     uiUpdateInterval.type = ParameterType::UI;
     uiUpdateInterval.defaultValue = 100;
     uiUpdateInterval.minValue = 50;
@@ -948,5 +990,30 @@ void AdaptiveConfigManager::registerDefaultParameters()
     commBufferSize.autoAdjust = true;
     registerParameter(commBufferSize);
     
+    ParameterDefinition bufferPoolSize;
+    bufferPoolSize.name = System::CONFIG_BUFFER_POOL_SIZE;
+    bufferPoolSize.type = ParameterType::Communication;
+    bufferPoolSize.defaultValue = 1000;
+    bufferPoolSize.minValue = 100;
+    bufferPoolSize.maxValue = 10000;
+    bufferPoolSize.currentValue = 1000;
+    bufferPoolSize.description = "通信缓冲池最大缓冲区数";
+    bufferPoolSize.sensitivity = 0.4;
+    bufferPoolSize.autoAdjust = true;
+    registerParameter(bufferPoolSize);
+    
+    // 数据处理参数
+    ParameterDefinition batchSize;
+    batchSize.name = System::CONFIG_DATA_BATCH_SIZE;
+    batchSize.type = ParameterType::Performance;
+    batchSize.defaultValue = 10;
+    batchSize.minValue = 1;
+    batchSize.maxValue = 100;
+    batchSize.currentValue = 10;
+    batchSize.description = "数据处理线程单次处理的任务数";
+    batchSize.sensitivity = 0.5;
+    batchSize.autoAdjust = false;
+    registerParameter(batchSize);
+    
     qDebug() << "[AdaptiveConfigManager] 默认参数已注册";
 }
\ No newline at end of file
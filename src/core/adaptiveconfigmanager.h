@@ -10,6 +10,7 @@
 #include <QVariant>
 #include <QHash>
 #include <memory>
+#include "../utils/configsnapshot.h"
 
 class ContinuousOptimizer;
 class IntelligentAnalyzer;
@@ -197,6 +198,21 @@ public:
      */
     bool isRunning() const { return m_isRunning; }
 
+    /**
+     * @brief 参数快照发布器
+     *
+     * 每次修改（包括一次调整多个参数）完成后发布一个包含全部参数的新版本，热路径组件用
+     * ConfigSnapshotReader 无锁读取，在各自的安全点应用新版本。读取方须在本对象析构前 detach
+     * @return 快照发布器
+     */
+    ConfigSnapshotPublisher* configSnapshots() { return &m_snapshots; }
+
+    /**
+     * @brief 当前快照版本
+     * @return 版本号
+     */
+    quint64 configVersion() const { return m_snapshots.version(); }
+
 public slots:
     /**
      * @brief 应用智能分析建议
@@ -281,6 +297,16 @@ private:
      */
     bool applyParameterAdjustment(const QString& name, const QVariant& newValue, const QString& reason);
 
+    /**
+     * @brief 设置参数值（调用方持有 m_parametersMutex，不发布快照）
+     */
+    bool setParameterValueLocked(const QString& name, const QVariant& value, const QString& reason);
+
+    /**
+     * @brief 按当前参数值发布新快照（调用方持有 m_parametersMutex）
+     */
+    void publishSnapshotLocked();
+
     /**
      * @brief 计算性能改善
      * @param beforeState 调整前状态
@@ -346,6 +372,7 @@ private:
     // 参数管理
     QHash<QString, ParameterDefinition> m_parameters;
     mutable QMutex m_parametersMutex;
+    ConfigSnapshotPublisher m_snapshots;    // m_parameters 当前值的不可变快照，修改后在持有 m_parametersMutex 时发布
     
     // 调整历史
     QList<AdjustmentRecord> m_adjustmentHistory;
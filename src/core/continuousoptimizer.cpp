@@ -2,8 +2,12 @@
 #include "performancemonitor.h"
 #include "memoryoptimizer.h"
 #include "performanceconfigmanager.h"
+#include "../constants.h"
 #include "../ui/uiupdateoptimizer.h"
 #include "../communication/communicationbufferpool.h"
+#include "../communication/dataprocessshardpool.h"
+#include "../utils/framelatency.h"
+#include "../utils/monotonicclock.h"
 #include <QDebug>
 #include <QJsonArray>
 #include <QStandardPaths>
@@ -13,6 +17,21 @@
 #include <QtMath>
 #include <QCoreApplication>
 
+namespace {
+
+// m_metricsHistory 的列
+enum MetricsColumn {
+    CpuUsageColumn,
+    MemoryUsageColumn,
+    DbResponseTimeColumn,
+    UiResponseTimeColumn,
+    CommunicationLatencyColumn,
+    ErrorCountColumn,
+    MetricsColumnCount
+};
+
+}
+
 ContinuousOptimizer::ContinuousOptimizer(QObject *parent)
     : QObject(parent)
     , m_performanceMonitor(nullptr)
@@ -20,14 +39,17 @@ ContinuousOptimizer::ContinuousOptimizer(QObject *parent)
     , m_uiOptimizer(nullptr)
     , m_bufferPool(nullptr)
     , m_configManager(nullptr)
+    , m_shardPool(nullptr)
     , m_optimizationTimer(new QTimer(this))
     , m_metricsTimer(new QTimer(this))
     , m_isRunning(false)
     , m_strategy(OptimizationStrategy::Balanced)
+    , m_metricsHistory(MetricsColumnCount, 100)
     , m_optimizationInterval(30000)  // 30秒
     , m_metricsInterval(5000)        // 5秒
     , m_historySize(100)
     , m_performanceThreshold(0.8)
+    , m_latencySnapshotNs(0)
     , m_totalOptimizations(0)
     , m_successfulOptimizations(0)
 {
@@ -64,7 +86,11 @@ bool ContinuousOptimizer::initialize(PerformanceMonitor* performanceMonitor,
     // 从配置管理器加载设置
     m_optimizationInterval = m_configManager->getConfigValue("continuous_optimization.optimization_interval", 30000).toInt();
     m_metricsInterval = m_configManager->getConfigValue("continuous_optimization.metrics_interval", 5000).toInt();
-    m_historySize = m_configManager->getConfigValue("continuous_optimization.history_size", 100).toInt();
+    m_historySize = qMax(1, m_configManager->getConfigValue("continuous_optimization.history_size", 100).toInt());
+    {
+        QMutexLocker locker(&m_metricsMutex);
+        m_metricsHistory.setCapacity(m_historySize);
+    }
     m_performanceThreshold = m_configManager->getConfigValue("continuous_optimization.performance_threshold", 0.8).toDouble();
     
     QString strategyStr = m_configManager->getConfigValue("continuous_optimization.strategy", "balanced").toString();
@@ -78,6 +104,19 @@ bool ContinuousOptimizer::initialize(PerformanceMonitor* performanceMonitor,
         m_strategy = OptimizationStrategy::Balanced;
     }
 
+    TuningExperimentRunner::Settings experimentSettings;
+    experimentSettings.warmupSamples = m_configManager->getConfigValue("continuous_optimization.experiment_warmup_samples",
+                                                                       System::TUNING_EXPERIMENT_WARMUP_SAMPLES).toInt();
+    experimentSettings.windowSamples = m_configManager->getConfigValue("continuous_optimization.experiment_window_samples",
+                                                                       System::TUNING_EXPERIMENT_WINDOW_SAMPLES).toInt();
+    experimentSettings.significance = m_configManager->getConfigValue("continuous_optimization.experiment_significance",
+                                                                      System::TUNING_EXPERIMENT_SIGNIFICANCE).toDouble();
+    {
+        QMutexLocker locker(&m_experimentMutex);
+        m_experimentRunner.setSettings(experimentSettings);
+    }
+    registerDefaultTuningKnobs();
+
     qDebug() << "[ContinuousOptimizer] 初始化成功，策略:" << static_cast<int>(m_strategy)
              << "优化间隔:" << m_optimizationInterval << "ms"
              << "指标间隔:" << m_metricsInterval << "ms";
@@ -117,6 +156,22 @@ void ContinuousOptimizer::stopOptimization()
     m_metricsTimer->stop();
     m_optimizationTimer->stop();
     
+    // 未完成的实验写回原值
+    bool aborted = false;
+    ExperimentRecord record;
+    {
+        QMutexLocker locker(&m_experimentMutex);
+        if (m_experimentRunner.isRunning()) {
+            m_experimentRunner.abort("持续优化已停止");
+            record = m_experimentRunner.lastRecord();
+            aborted = true;
+        }
+        m_latencySnapshotNs = 0;
+    }
+    if (aborted) {
+        recordExperiment(record);
+    }
+    
     qDebug() << "[ContinuousOptimizer] 持续优化已停止";
 }
 
@@ -158,7 +213,7 @@ ContinuousOptimizer::PerformanceMetrics ContinuousOptimizer::getCurrentMetrics()
         return PerformanceMetrics{};
     }
     
-    return m_metricsHistory.last();
+    return historyAt(m_metricsHistory.size() - 1);
 }
 
 QList<ContinuousOptimizer::OptimizationRecommendation> ContinuousOptimizer::getOptimizationRecommendations() const
@@ -227,12 +282,27 @@ QJsonObject ContinuousOptimizer::generatePerformanceReport() const
     metricsObj["performance_score"] = calculatePerformanceScore(currentMetrics);
     report["current_metrics"] = metricsObj;
     
+    // 调参实验
+    QJsonObject experimentsObj;
+    QJsonArray experimentArray;
+    {
+        QMutexLocker experimentLocker(&m_experimentMutex);
+        experimentsObj["running"] = m_experimentRunner.runningKnob();
+        experimentsObj["knobs"] = QJsonArray::fromStringList(m_tuningKnobs.keys());
+        const int firstRecord = qMax(0, m_experimentHistory.size() - 10); // 最近10次实验
+        for (int i = firstRecord; i < m_experimentHistory.size(); ++i) {
+            experimentArray.append(m_experimentHistory.at(i).toJson());
+        }
+    }
+    experimentsObj["history"] = experimentArray;
+    report["tuning_experiments"] = experimentsObj;
+    
     // 历史趋势
     QJsonArray historyArray;
     QMutexLocker locker(&m_metricsMutex);
     int startIndex = qMax(0, m_metricsHistory.size() - 10); // 最近10个数据点
     for (int i = startIndex; i < m_metricsHistory.size(); ++i) {
-        const auto& metrics = m_metricsHistory[i];
+        const PerformanceMetrics metrics = historyAt(i);
         QJsonObject historyPoint;
         historyPoint["timestamp"] = metrics.timestamp.toString(Qt::ISODate);
         historyPoint["performance_score"] = calculatePerformanceScore(metrics);
@@ -318,8 +388,29 @@ void ContinuousOptimizer::performOptimizationAnalysis()
             break;
         }
         
-        if (autoApply) {
-            applyOptimizationRecommendations(recommendations);
+        // 有对应可调参数的建议通过 A/B 实验验证后才保留，一次只做一个实验；
+        // 实验期间不自动应用任何建议，以免干扰对照和候选窗口
+        if (autoApply && isExperimentRunning()) {
+            qDebug() << "[ContinuousOptimizer] 调参实验进行中，暂不自动应用建议";
+        } else if (autoApply) {
+            QList<OptimizationRecommendation> direct;
+            bool experimentStarted = false;
+            for (const auto& recommendation : recommendations) {
+                const QString knob = recommendation.component + "." + recommendation.parameter;
+                bool tunable = false;
+                {
+                    QMutexLocker locker(&m_experimentMutex);
+                    tunable = m_tuningKnobs.contains(knob);
+                }
+                if (!tunable) {
+                    direct.append(recommendation);
+                } else if (!experimentStarted) {
+                    experimentStarted = startTuningExperiment(knob, recommendation.recommendedValue, recommendation.reason);
+                }
+            }
+            if (!direct.isEmpty()) {
+                applyOptimizationRecommendations(direct);
+            }
         }
     }
     
@@ -360,6 +451,21 @@ void ContinuousOptimizer::collectPerformanceMetrics()
     // 保存指标
     savePerformanceHistory(metrics);
     
+    // 调参实验按指标收集周期采样
+    bool experimentFinished = false;
+    ExperimentRecord record;
+    {
+        QMutexLocker locker(&m_experimentMutex);
+        const ExperimentSample sample = sampleFrameLatency();
+        if (m_experimentRunner.addSample(sample)) {
+            record = m_experimentRunner.lastRecord();
+            experimentFinished = true;
+        }
+    }
+    if (experimentFinished) {
+        recordExperiment(record);
+    }
+    
     emit metricsUpdated(metrics);
 }
 
@@ -372,19 +478,11 @@ void ContinuousOptimizer::analyzePerformanceTrends()
     }
     
     // 分析最近的性能趋势
-    int recentCount = qMin(10, m_metricsHistory.size());
-    double avgCpu = 0, avgMemory = 0, avgDbTime = 0;
-    
-    for (int i = m_metricsHistory.size() - recentCount; i < m_metricsHistory.size(); ++i) {
-        const auto& metrics = m_metricsHistory[i];
-        avgCpu += metrics.cpuUsage;
-        avgMemory += metrics.memoryUsage;
-        avgDbTime += metrics.dbResponseTime;
-    }
-    
-    avgCpu /= recentCount;
-    avgMemory /= recentCount;
-    avgDbTime /= recentCount;
+    const int end = m_metricsHistory.size();
+    const int begin = end - qMin(10, end);
+    const double avgCpu = m_metricsHistory.average(CpuUsageColumn, begin, end);
+    const double avgMemory = m_metricsHistory.average(MemoryUsageColumn, begin, end);
+    const double avgDbTime = m_metricsHistory.average(DbResponseTimeColumn, begin, end);
     
     // 检查趋势并发出警告
     if (avgCpu > 80.0) {
@@ -418,11 +516,19 @@ QList<ContinuousOptimizer::OptimizationRecommendation> ContinuousOptimizer::gene
     
     // UI优化建议
     if (metrics.uiResponseTime > 2.0) {
+        int interval = 100;
+        {
+            QMutexLocker locker(&m_experimentMutex);
+            const auto knob = m_tuningKnobs.constFind("ui.update_interval");
+            if (knob != m_tuningKnobs.constEnd()) {
+                interval = qMax(1, knob->read().toInt());
+            }
+        }
         OptimizationRecommendation rec;
         rec.component = "ui";
         rec.parameter = "update_interval";
-        rec.currentValue = 100;
-        rec.recommendedValue = 150;
+        rec.currentValue = interval;
+        rec.recommendedValue = interval + qMax(1, interval / 2);
         rec.reason = "UI响应时间过长，建议增加更新间隔";
         rec.expectedImprovement = 0.20;
         recommendations.append(rec);
@@ -539,10 +645,177 @@ void ContinuousOptimizer::savePerformanceHistory(const PerformanceMetrics& metri
 {
     QMutexLocker locker(&m_metricsMutex);
     
-    m_metricsHistory.append(metrics);
-    
-    // 限制历史数据大小
-    while (m_metricsHistory.size() > m_historySize) {
-        m_metricsHistory.removeFirst();
+    // 容量为 m_historySize，写满后覆盖最旧的数据
+    double row[MetricsColumnCount];
+    row[CpuUsageColumn] = metrics.cpuUsage;
+    row[MemoryUsageColumn] = metrics.memoryUsage;
+    row[DbResponseTimeColumn] = metrics.dbResponseTime;
+    row[UiResponseTimeColumn] = metrics.uiResponseTime;
+    row[CommunicationLatencyColumn] = metrics.communicationLatency;
+    row[ErrorCountColumn] = metrics.errorCount;
+    m_metricsHistory.append(metrics.timestamp.toMSecsSinceEpoch(), row);
+}
+
+ContinuousOptimizer::PerformanceMetrics ContinuousOptimizer::historyAt(int index) const
+{
+    PerformanceMetrics metrics;
+    metrics.cpuUsage = m_metricsHistory.valueAt(CpuUsageColumn, index);
+    metrics.memoryUsage = m_metricsHistory.valueAt(MemoryUsageColumn, index);
+    metrics.dbResponseTime = m_metricsHistory.valueAt(DbResponseTimeColumn, index);
+    metrics.uiResponseTime = m_metricsHistory.valueAt(UiResponseTimeColumn, index);
+    metrics.communicationLatency = m_metricsHistory.valueAt(CommunicationLatencyColumn, index);
+    metrics.errorCount = int(m_metricsHistory.valueAt(ErrorCountColumn, index));
+    metrics.timestamp = QDateTime::fromMSecsSinceEpoch(m_metricsHistory.timestampAt(index));
+    return metrics;
+}
+void ContinuousOptimizer::registerTuningKnob(const TuningKnob& knob)
+{
+    if (knob.name.isEmpty() || !knob.read || !knob.write) {
+        qWarning() << "[ContinuousOptimizer] 可调参数无效:" << knob.name;
+        return;
+    }
+
+    QMutexLocker locker(&m_experimentMutex);
+    if (m_experimentRunner.runningKnob() == knob.name) {
+        qWarning() << "[ContinuousOptimizer] 参数正在实验中，无法替换:" << knob.name;
+        return;
+    }
+    m_tuningKnobs.insert(knob.name, knob);
+}
+
+void ContinuousOptimizer::setDataProcessShardPool(DataProcessShardPool* shardPool)
+{
+    m_shardPool = shardPool;
+    if (!m_shardPool) {
+        return;
+    }
+
+    TuningKnob batchSize;
+    batchSize.name = "data_process.batch_size";
+    batchSize.read = [this]() { return QVariant(m_shardPool->config().batchSize); };
+    batchSize.write = [this](const QVariant& value) {
+        const int size = value.toInt();
+        if (size <= 0) {
+            return false;
+        }
+        m_shardPool->setBatchSize(size);
+        return true;
+    };
+    registerTuningKnob(batchSize);
+}
+
+void ContinuousOptimizer::registerDefaultTuningKnobs()
+{
+    if (m_uiOptimizer) {
+        // 实时数据更新间隔直接决定帧从接收到显示的延迟
+        TuningKnob updateInterval;
+        updateInterval.name = "ui.update_interval";
+        updateInterval.read = [this]() { return QVariant(m_uiOptimizer->getUpdateInterval(UIUpdateType::RealTimeData)); };
+        updateInterval.write = [this](const QVariant& value) {
+            const int interval = value.toInt();
+            if (interval <= 0) {
+                return false;
+            }
+            m_uiOptimizer->setUpdateInterval(UIUpdateType::RealTimeData, interval);
+            return true;
+        };
+        registerTuningKnob(updateInterval);
+    }
+
+    if (m_bufferPool) {
+        TuningKnob poolSize;
+        poolSize.name = "communication.buffer_pool_size";
+        poolSize.read = [this]() { return QVariant(m_bufferPool->getPoolConfig().maxPoolSize); };
+        poolSize.write = [this](const QVariant& value) {
+            PoolConfig config = m_bufferPool->getPoolConfig();
+            const int size = value.toInt();
+            if (size < config.initialPoolSize) {
+                return false;
+            }
+            config.maxPoolSize = size;
+            m_bufferPool->setPoolConfig(config);
+            return true;
+        };
+        registerTuningKnob(poolSize);
+    }
+}
+
+bool ContinuousOptimizer::startTuningExperiment(const QString& knob, const QVariant& candidateValue, const QString& reason)
+{
+    QMutexLocker locker(&m_experimentMutex);
+    const auto it = m_tuningKnobs.constFind(knob);
+    if (it == m_tuningKnobs.constEnd()) {
+        qWarning() << "[ContinuousOptimizer] 未注册的可调参数:" << knob;
+        return false;
+    }
+    return m_experimentRunner.start(*it, candidateValue, reason);
+}
+
+bool ContinuousOptimizer::isExperimentRunning() const
+{
+    QMutexLocker locker(&m_experimentMutex);
+    return m_experimentRunner.isRunning();
+}
+
+QList<ExperimentRecord> ContinuousOptimizer::getExperimentHistory() const
+{
+    QMutexLocker locker(&m_experimentMutex);
+    return m_experimentHistory;
+}
+
+ExperimentSample ContinuousOptimizer::sampleFrameLatency()
+{
+    FrameLatencyMonitor* monitor = FrameLatencyMonitor::getInstance();
+    const HdrHistogram latency = monitor->histogram(FrameLatencyStage::Total);
+    const HdrHistogram worker = monitor->histogram(FrameLatencyStage::Worker);
+    const qint64 nowNs = MonotonicClock::nowNs();
+
+    // 监控器被 reset 后累计值会变小，这一周期只更新快照
+    ExperimentSample sample;
+    if (m_latencySnapshotNs > 0 && nowNs > m_latencySnapshotNs
+        && latency.count() >= m_latencySnapshot.count() && worker.count() >= m_workerSnapshot.count()) {
+        const HdrHistogram window = latency.since(m_latencySnapshot);
+        sample.frames = window.count();
+        sample.p99LatencyMs = window.percentileNs(99.0) / 1000000.0;
+        sample.framesPerSecond = (worker.count() - m_workerSnapshot.count()) * 1e9 / (nowNs - m_latencySnapshotNs);
     }
-}
\ No newline at end of file
+
+    m_latencySnapshot = latency;
+    m_workerSnapshot = worker;
+    m_latencySnapshotNs = nowNs;
+    return sample;
+}
+
+void ContinuousOptimizer::recordExperiment(const ExperimentRecord& record)
+{
+    {
+        QMutexLocker locker(&m_experimentMutex);
+        m_experimentHistory.append(record);
+        while (m_experimentHistory.size() > System::TUNING_AUDIT_HISTORY) {
+            m_experimentHistory.removeFirst();
+        }
+    }
+
+    // 审计文件每行一条 JSON 记录，只追加不改写
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    QFile file(dataDir + "/tuning_audit.jsonl");
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        file.write(QJsonDocument(record.toJson()).toJson(QJsonDocument::Compact));
+        file.write("\n");
+    } else {
+        qWarning() << "[ContinuousOptimizer] 无法写入调参审计文件:" << file.errorString();
+    }
+
+    if (record.outcome == ExperimentRecord::Outcome::Kept) {
+        m_successfulOptimizations++;
+    }
+    m_totalOptimizations++;
+
+    emit tuningExperimentFinished(record);
+    if (record.outcome != ExperimentRecord::Outcome::Kept) {
+        const QString component = record.knob.section('.', 0, 0);
+        emit performanceWarning(component, QString("调参实验未保留 %1=%2：%3")
+                                .arg(record.knob, record.candidateValue.toString(), record.decision), 1);
+    }
+}
@@ -8,13 +8,18 @@
 #include <QDateTime>
 #include <QMutex>
 #include <QThread>
+#include <QHash>
 #include <memory>
+#include "tuningexperiment.h"
+#include "../utils/hdrhistogram.h"
+#include "../utils/metricring.h"
 
 class PerformanceMonitor;
 class MemoryOptimizer;
 class UIUpdateOptimizer;
 class CommunicationBufferPool;
 class PerformanceConfigManager;
+class DataProcessShardPool;
 
 /**
  * @brief 持续优化管理器
@@ -127,6 +132,38 @@ public:
      */
     bool isRunning() const { return m_isRunning; }
 
+    /**
+     * @brief 注册可调参数，同名参数会被替换
+     * @param knob 参数名为 "组件.参数"，自动应用优化建议时按此名称匹配
+     */
+    void registerTuningKnob(const TuningKnob& knob);
+
+    /**
+     * @brief 设置数据处理分片池，注册 data_process.batch_size 参数
+     * @param shardPool 数据处理分片池
+     */
+    void setDataProcessShardPool(DataProcessShardPool* shardPool);
+
+    /**
+     * @brief 启动 A/B 调参实验
+     * @param knob 参数名
+     * @param candidateValue 候选值
+     * @param reason 实验原因，写入审计记录
+     * @return 参数未注册、已有实验在运行或候选值与当前值相同时返回 false
+     */
+    bool startTuningExperiment(const QString& knob, const QVariant& candidateValue, const QString& reason);
+
+    /**
+     * @brief 是否有调参实验正在运行
+     */
+    bool isExperimentRunning() const;
+
+    /**
+     * @brief 获取调参实验审计记录
+     * @return 最近的实验记录，按结束时间排序
+     */
+    QList<ExperimentRecord> getExperimentHistory() const;
+
 public slots:
     /**
      * @brief 手动触发优化分析
@@ -166,6 +203,12 @@ signals:
      */
     void performanceWarning(const QString& component, const QString& message, int severity);
 
+    /**
+     * @brief 调参实验结束信号
+     * @param record 实验记录
+     */
+    void tuningExperimentFinished(const ExperimentRecord& record);
+
 private slots:
     /**
      * @brief 定时优化分析
@@ -231,6 +274,28 @@ private:
      */
     void savePerformanceHistory(const PerformanceMetrics& metrics);
 
+    /**
+     * @brief 读取一条历史数据（调用方持有 m_metricsMutex）
+     * @param index 序号，0 为最旧的数据
+     */
+    PerformanceMetrics historyAt(int index) const;
+
+    /**
+     * @brief 注册 UI 更新间隔和通信缓冲池大小参数
+     */
+    void registerDefaultTuningKnobs();
+
+    /**
+     * @brief 按帧延迟监控器累计直方图的增量生成本周期的实验样本（调用方持有 m_experimentMutex）
+     */
+    ExperimentSample sampleFrameLatency();
+
+    /**
+     * @brief 把实验记录加入审计历史并追加到审计文件
+     * @param record 实验记录
+     */
+    void recordExperiment(const ExperimentRecord& record);
+
 private:
     // 组件引用
     PerformanceMonitor* m_performanceMonitor;
@@ -238,6 +303,7 @@ private:
     UIUpdateOptimizer* m_uiOptimizer;
     CommunicationBufferPool* m_bufferPool;
     PerformanceConfigManager* m_configManager;
+    DataProcessShardPool* m_shardPool;
 
     // 定时器
     QTimer* m_optimizationTimer;
@@ -248,7 +314,7 @@ private:
     OptimizationStrategy m_strategy;
 
     // 性能数据
-    QList<PerformanceMetrics> m_metricsHistory;
+    MetricRing m_metricsHistory;    // 每个数值字段一列，容量为 m_historySize
     QList<OptimizationRecommendation> m_lastRecommendations;
     mutable QMutex m_metricsMutex;
 
@@ -258,6 +324,15 @@ private:
     int m_historySize;              // 历史数据保留数量
     double m_performanceThreshold;  // 性能阈值
 
+    // 调参实验
+    TuningExperimentRunner m_experimentRunner;
+    QHash<QString, TuningKnob> m_tuningKnobs;
+    QList<ExperimentRecord> m_experimentHistory;    // 最多 System::TUNING_AUDIT_HISTORY 条
+    HdrHistogram m_latencySnapshot;                 // 上次采样时的累计直方图（Total 阶段）
+    HdrHistogram m_workerSnapshot;                  // 同上（Worker 阶段）
+    qint64 m_latencySnapshotNs;                     // 上次采样的时间，0 表示还没有快照
+    mutable QMutex m_experimentMutex;
+
     // 统计信息
     int m_totalOptimizations;
     int m_successfulOptimizations;
@@ -0,0 +1,275 @@
+#include "databasebackup.h"
+#include "../constants.h"
+#include "../logger/logmanager.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QTimer>
+
+namespace {
+const char* const BACKUP_TIME_FORMAT = "yyyyMMdd_HHmmss";
+constexpr qint64 COPY_CHUNK_BYTES = 4 * 1024 * 1024;
+
+// 后台线程上的临时连接，离开作用域时关闭并移除
+class ScopedConnection
+{
+public:
+    ScopedConnection(const QString& name, const QString& path)
+        : m_name(name)
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", m_name);
+        database.setDatabaseName(path);
+        database.setConnectOptions("QSQLITE_OPEN_READONLY");
+    }
+
+    ~ScopedConnection()
+    {
+        {
+            QSqlDatabase database = QSqlDatabase::database(m_name, false);
+            if (database.isOpen()) {
+                database.close();
+            }
+        }
+        QSqlDatabase::removeDatabase(m_name);
+    }
+
+    QSqlDatabase database() const { return QSqlDatabase::database(m_name, false); }
+
+private:
+    QString m_name;
+};
+
+// 快照中实际使用的页，VACUUM INTO 不复制空闲页
+qint64 usedBytes(QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+    const auto pragma = [&query](const char* name) -> qint64 {
+        return query.exec(QString("PRAGMA %1").arg(name)) && query.next() ? query.value(0).toLongLong() : 0;
+    };
+    const qint64 pageSize = pragma("page_size");
+    return (pragma("page_count") - pragma("freelist_count")) * pageSize;
+}
+}
+
+DatabaseBackup::DatabaseBackup(QObject* parent)
+    : QObject(parent)
+    , m_thread(nullptr)
+    , m_progressTimer(new QTimer(this))
+    , m_totalBytes(0)
+    , m_running(false)
+{
+    m_progressTimer->setInterval(System::DB_BACKUP_PROGRESS_INTERVAL_MS);
+    connect(m_progressTimer, &QTimer::timeout, this, &DatabaseBackup::reportProgress);
+    // finished 在后台线程发出，排队到这里时任务已经结束
+    connect(this, &DatabaseBackup::finished, m_progressTimer, &QTimer::stop);
+}
+
+DatabaseBackup::~DatabaseBackup()
+{
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+bool DatabaseBackup::backup(const QString& databasePath, const QString& backupFile)
+{
+    return start(backupFile, backupFile + ".part", [this, databasePath, backupFile](QString* error) {
+        return runBackup(databasePath, backupFile, error);
+    });
+}
+
+bool DatabaseBackup::prepareRestore(const QString& backupFile, const QString& stagingFile)
+{
+    return start(stagingFile, stagingFile, [this, backupFile, stagingFile](QString* error) {
+        return runRestore(backupFile, stagingFile, error);
+    });
+}
+
+bool DatabaseBackup::isRunning() const
+{
+    return m_running.load();
+}
+
+QString DatabaseBackup::backupFileName(const QString& directory, const QString& baseName, const QDateTime& time)
+{
+    return QString("%1/%2_%3.db").arg(directory, baseName, time.toString(BACKUP_TIME_FORMAT));
+}
+
+QStringList DatabaseBackup::backups(const QString& directory, const QString& baseName)
+{
+    // 文件名中的时间按字典序即时间顺序
+    QDir dir(directory);
+    QStringList result;
+    const QStringList names = dir.entryList({baseName + "_*.db"}, QDir::Files, QDir::Name | QDir::Reversed);
+    for (const QString& name : names) {
+        const QString stamp = name.mid(baseName.size() + 1).chopped(3);
+        if (QDateTime::fromString(stamp, BACKUP_TIME_FORMAT).isValid()) {
+            result.append(dir.absoluteFilePath(name));
+        }
+    }
+    return result;
+}
+
+QStringList DatabaseBackup::removeOldBackups(const QString& directory, const QString& baseName, int keep)
+{
+    QStringList removed;
+    const QStringList files = backups(directory, baseName);
+    for (int i = qMax(0, keep); i < files.size(); ++i) {
+        if (QFile::remove(files[i])) {
+            removed.append(files[i]);
+        }
+    }
+    return removed;
+}
+
+bool DatabaseBackup::replaceDatabase(const QString& stagingFile, const QString& databasePath, QString* error)
+{
+    // 旧文件先改名保留，换上新文件之后再删除，任何一步失败都能回到原来的数据库
+    const QString previous = databasePath + ".previous";
+    QFile::remove(previous);
+    if (QFile::exists(databasePath) && !QFile::rename(databasePath, previous)) {
+        if (error) *error = "无法移走当前数据库文件: " + databasePath;
+        return false;
+    }
+    if (!QFile::rename(stagingFile, databasePath)) {
+        QFile::rename(previous, databasePath);
+        if (error) *error = "无法替换数据库文件: " + databasePath;
+        return false;
+    }
+    // 旧数据库的 WAL 不属于新文件，留着会在打开时被错误地回放
+    QFile::remove(databasePath + "-wal");
+    QFile::remove(databasePath + "-shm");
+    QFile::remove(previous);
+    return true;
+}
+
+bool DatabaseBackup::start(const QString& filename, const QString& progressFile, std::function<bool(QString*)> task)
+{
+    if (m_running.load()) {
+        return false;
+    }
+    // 上一个任务已经发出 finished，线程即将退出
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+
+    m_running.store(true);
+    m_totalBytes.store(0);
+    m_progressFile = progressFile;
+    m_thread = QThread::create([this, filename, task]() {
+        QString error;
+        const bool success = task(&error);
+        if (success) {
+            LOG_INFO("DatabaseBackup", "数据库文件就绪: " + filename);
+        } else {
+            LOG_WARNING("DatabaseBackup", QString("数据库备份任务失败: %1 (%2)").arg(filename, error));
+        }
+        m_running.store(false);
+        emit finished(success, filename, error);
+    });
+    m_thread->setObjectName("DatabaseBackup");
+    m_thread->start(QThread::LowPriority);
+    m_progressTimer->start();
+    return true;
+}
+
+void DatabaseBackup::reportProgress()
+{
+    if (!m_running.load()) {
+        return;
+    }
+    emit progress(QFileInfo(m_progressFile).size(), m_totalBytes.load());
+}
+
+bool DatabaseBackup::runBackup(const QString& databasePath, const QString& backupFile, QString* error)
+{
+    const QString partFile = backupFile + ".part";
+    QDir().mkpath(QFileInfo(backupFile).absolutePath());
+    QFile::remove(partFile);
+
+    {
+        ScopedConnection connection(QString("DatabaseBackup-%1").arg(reinterpret_cast<quintptr>(this)), databasePath);
+        QSqlDatabase database = connection.database();
+        if (!database.open()) {
+            *error = "无法打开数据库: " + database.lastError().text();
+            return false;
+        }
+        m_totalBytes.store(usedBytes(database));
+
+        QSqlQuery query(database);
+        query.prepare("VACUUM INTO ?");
+        query.addBindValue(partFile);
+        if (!query.exec()) {
+            *error = "写入备份失败: " + query.lastError().text();
+            QFile::remove(partFile);
+            return false;
+        }
+    }
+
+    QFile::remove(backupFile);
+    if (!QFile::rename(partFile, backupFile)) {
+        *error = "无法保存备份文件: " + backupFile;
+        QFile::remove(partFile);
+        return false;
+    }
+    const qint64 size = QFileInfo(backupFile).size();
+    emit progress(size, qMax(size, m_totalBytes.load()));
+    return true;
+}
+
+bool DatabaseBackup::runRestore(const QString& backupFile, const QString& stagingFile, QString* error)
+{
+    // 损坏的备份在替换之前就被拒绝，当前数据库保持不变
+    {
+        ScopedConnection connection(QString("DatabaseRestore-%1").arg(reinterpret_cast<quintptr>(this)), backupFile);
+        QSqlDatabase database = connection.database();
+        if (!database.open()) {
+            *error = "无法打开备份文件: " + database.lastError().text();
+            return false;
+        }
+        QSqlQuery query(database);
+        if (!query.exec("PRAGMA quick_check") || !query.next() || query.value(0).toString() != "ok") {
+            *error = "备份文件校验失败: " + (query.lastError().isValid() ? query.lastError().text()
+                                                                      : query.value(0).toString());
+            return false;
+        }
+    }
+
+    QFile source(backupFile);
+    QFile target(stagingFile);
+    if (!source.open(QIODevice::ReadOnly)) {
+        *error = "无法读取备份文件: " + source.errorString();
+        return false;
+    }
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *error = "无法创建恢复文件: " + target.errorString();
+        return false;
+    }
+    m_totalBytes.store(source.size());
+
+    QByteArray chunk;
+    while (!(chunk = source.read(COPY_CHUNK_BYTES)).isEmpty()) {
+        if (target.write(chunk) != chunk.size()) {
+            *error = "写入恢复文件失败: " + target.errorString();
+            target.close();
+            target.remove();
+            return false;
+        }
+    }
+    if (source.error() != QFileDevice::NoError || !target.flush()) {
+        *error = "复制备份文件失败: " + (source.error() != QFileDevice::NoError ? source.errorString()
+                                                                           : target.errorString());
+        target.close();
+        target.remove();
+        return false;
+    }
+    target.close();
+    emit progress(source.size(), source.size());
+    return true;
+}
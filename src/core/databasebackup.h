@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QObject>
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+
+class QThread;
+class QTimer;
+
+// 数据库在线备份与恢复
+//
+// 备份在后台线程用独立的只读连接执行 VACUUM INTO：在一个读事务中把数据库的一致快照写成
+// 紧凑的新文件，WAL 模式下数据库服务线程的写入照常提交，不会被备份阻塞。
+// 逐页的 sqlite3_backup_step 在源数据库被其他连接写入时会从头重来，对持续写入的生产数据库
+// 可能一直完不成，而快照读不受写入影响。备份先写入 .part 文件，完成后改名，不会留下半个备份。
+// 恢复先在后台校验备份并复制为 stagingFile，调用方关闭所有连接后用 replaceDatabase() 换上。
+// 同一时间只运行一个任务，进度按目标文件的大小定时报告。
+class DatabaseBackup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseBackup(QObject* parent = nullptr);
+    ~DatabaseBackup() override;     // 等待进行中的任务结束
+
+    // 已有任务在进行时返回 false，结果通过 finished 报告
+    bool backup(const QString& databasePath, const QString& backupFile);
+    bool prepareRestore(const QString& backupFile, const QString& stagingFile);
+    bool isRunning() const;
+
+    // <directory>/<baseName>_yyyyMMdd_HHmmss.db
+    static QString backupFileName(const QString& directory, const QString& baseName, const QDateTime& time);
+    // 目录中的备份，从新到旧
+    static QStringList backups(const QString& directory, const QString& baseName);
+    // 只保留最新的 keep 个备份，返回删除的文件
+    static QStringList removeOldBackups(const QString& directory, const QString& baseName, int keep);
+    // 在数据库的所有连接关闭之后调用：用 stagingFile 替换数据库文件，并删除旧的 -wal/-shm 文件
+    static bool replaceDatabase(const QString& stagingFile, const QString& databasePath, QString* error = nullptr);
+
+signals:
+    void progress(qint64 bytes, qint64 totalBytes);     // totalBytes 为 0 表示大小未知
+    void finished(bool success, const QString& filename, const QString& error);
+
+private:
+    bool start(const QString& filename, const QString& progressFile, std::function<bool(QString*)> task);
+    void reportProgress();
+
+    // 以下函数在后台线程执行
+    bool runBackup(const QString& databasePath, const QString& backupFile, QString* error);
+    bool runRestore(const QString& backupFile, const QString& stagingFile, QString* error);
+
+    QThread* m_thread;
+    QTimer* m_progressTimer;
+    QString m_progressFile;
+    std::atomic<qint64> m_totalBytes;
+    std::atomic<bool> m_running;
+};
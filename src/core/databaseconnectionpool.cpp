@@ -0,0 +1,288 @@
+#include "databaseconnectionpool.h"
+#include "../constants.h"
+#include "../logger/logmanager.h"
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <memory>
+
+struct DatabaseConnectionPool::Lease::Connection {
+    QString name;
+    QSqlDatabase database;
+    QThread* thread = nullptr;
+    int leases = 0;
+    QElapsedTimer idleTimer;                    // 最后一次归还后开始计时
+    QMetaObject::Connection finishedHook;       // 所属线程结束时关闭连接
+};
+
+namespace {
+QMutex sharedPoolsMutex;
+
+QHash<QString, std::weak_ptr<DatabaseConnectionPool>>& sharedPools()
+{
+    static QHash<QString, std::weak_ptr<DatabaseConnectionPool>> pools;
+    return pools;
+}
+
+DatabasePoolConfig& defaultPoolConfig()
+{
+    static DatabasePoolConfig config;
+    return config;
+}
+}
+
+DatabaseConnectionPool::Lease::Lease(DatabaseConnectionPool* pool, Connection* connection)
+    : m_pool(pool)
+    , m_connection(connection)
+{
+}
+
+DatabaseConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_connection(other.m_connection)
+{
+    other.m_pool = nullptr;
+    other.m_connection = nullptr;
+}
+
+DatabaseConnectionPool::Lease& DatabaseConnectionPool::Lease::operator=(Lease&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_connection = other.m_connection;
+        other.m_pool = nullptr;
+        other.m_connection = nullptr;
+    }
+    return *this;
+}
+
+DatabaseConnectionPool::Lease::~Lease()
+{
+    release();
+}
+
+QSqlDatabase& DatabaseConnectionPool::Lease::database()
+{
+    Q_ASSERT(m_connection);
+    return m_connection->database;
+}
+
+void DatabaseConnectionPool::Lease::release()
+{
+    if (m_pool && m_connection) {
+        m_pool->release(m_connection);
+    }
+    m_pool = nullptr;
+    m_connection = nullptr;
+}
+
+DatabaseConnectionPool::DatabaseConnectionPool(const QString& databasePath, const DatabasePoolConfig& config)
+    : m_databasePath(databasePath)
+    , m_config(config)
+    , m_connectionPrefix(QString("Pool-%1-%2-").arg(QFileInfo(databasePath).completeBaseName())
+                             .arg(reinterpret_cast<quintptr>(this), 0, 16))
+{
+}
+
+DatabaseConnectionPool::~DatabaseConnectionPool()
+{
+    QMutexLocker locker(&m_mutex);
+    const QList<QThread*> threads = m_connections.keys();
+    for (QThread* thread : threads) {
+        closeConnectionLocked(thread);
+    }
+}
+
+std::shared_ptr<DatabaseConnectionPool> DatabaseConnectionPool::shared(const QString& databasePath)
+{
+    const QString key = QFileInfo(databasePath).absoluteFilePath();
+    QMutexLocker locker(&sharedPoolsMutex);
+    std::shared_ptr<DatabaseConnectionPool> pool = sharedPools().value(key).lock();
+    if (!pool) {
+        pool = std::make_shared<DatabaseConnectionPool>(databasePath, defaultPoolConfig());
+        sharedPools().insert(key, pool);
+    }
+    return pool;
+}
+
+void DatabaseConnectionPool::setDefaultConfig(const DatabasePoolConfig& config)
+{
+    QMutexLocker locker(&sharedPoolsMutex);
+    defaultPoolConfig() = config;
+    defaultPoolConfig().minConnections = qMax(0, config.minConnections);
+    defaultPoolConfig().maxConnections = qMax(1, config.maxConnections);
+}
+
+DatabasePoolConfig DatabaseConnectionPool::defaultConfig()
+{
+    QMutexLocker locker(&sharedPoolsMutex);
+    return defaultPoolConfig();
+}
+
+DatabaseConnectionPool::Lease DatabaseConnectionPool::acquire(QString* error)
+{
+    QThread* thread = QThread::currentThread();
+    QMutexLocker locker(&m_mutex);
+
+    Connection* connection = m_connections.value(thread);
+    const bool reused = connection != nullptr;
+    if (!connection) {
+        if (m_connections.size() >= m_config.maxConnections) {
+            ++m_statistics.waits;
+            QDeadlineTimer deadline(m_config.connectionTimeoutMs);
+            while (m_connections.size() >= m_config.maxConnections) {
+                if (!m_connectionClosed.wait(&m_mutex, deadline)) {
+                    ++m_statistics.timeouts;
+                    if (error) {
+                        *error = QString("数据库连接池已满（%1 个连接），等待超时").arg(m_config.maxConnections);
+                    }
+                    return Lease();
+                }
+            }
+        }
+        connection = openLocked(error);
+        if (!connection) {
+            return Lease();
+        }
+    }
+
+    // 连接只在所属线程使用，验证不需要持有锁
+    const bool needsValidation = reused && connection->leases == 0 && !m_config.validationQuery.isEmpty()
+                                 && connection->idleTimer.isValid()
+                                 && connection->idleTimer.elapsed() >= System::DB_POOL_VALIDATION_IDLE_MS;
+    ++connection->leases;
+    ++m_statistics.acquisitions;
+    locker.unlock();
+
+    if (needsValidation && !validate(connection)) {
+        release(connection);
+        closeThreadConnection();
+        if (error) {
+            *error = "数据库连接验证失败: " + m_databasePath;
+        }
+        return Lease();
+    }
+    return Lease(this, connection);
+}
+
+bool DatabaseConnectionPool::closeIdleConnection()
+{
+    QMutexLocker locker(&m_mutex);
+    Connection* connection = m_connections.value(QThread::currentThread());
+    if (!connection || connection->leases > 0 || m_connections.size() <= m_config.minConnections
+        || !connection->idleTimer.isValid() || connection->idleTimer.elapsed() < m_config.idleTimeoutMs) {
+        return false;
+    }
+    closeConnectionLocked(connection->thread);
+    return true;
+}
+
+void DatabaseConnectionPool::closeThreadConnection()
+{
+    QMutexLocker locker(&m_mutex);
+    Connection* connection = m_connections.value(QThread::currentThread());
+    if (connection && connection->leases == 0) {
+        closeConnectionLocked(connection->thread);
+    }
+}
+
+DatabasePoolStatistics DatabaseConnectionPool::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    DatabasePoolStatistics statistics = m_statistics;
+    statistics.openConnections = m_connections.size();
+    statistics.leasedConnections = 0;
+    for (const Connection* connection : m_connections) {
+        if (connection->leases > 0) {
+            ++statistics.leasedConnections;
+        }
+    }
+    return statistics;
+}
+
+DatabaseConnectionPool::Connection* DatabaseConnectionPool::openLocked(QString* error)
+{
+    auto connection = std::make_unique<Connection>();
+    connection->name = m_connectionPrefix + QString::number(++m_nextConnectionId);
+    connection->thread = QThread::currentThread();
+    connection->database = QSqlDatabase::addDatabase("QSQLITE", connection->name);
+    connection->database.setDatabaseName(m_databasePath);
+    connection->database.setConnectOptions(
+        QString("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=%1").arg(System::DB_QUERY_TIMEOUT));
+
+    if (!connection->database.open()) {
+        const QString message = "无法打开数据库: " + connection->database.lastError().text();
+        LOG_ERROR("DatabaseConnectionPool", message);
+        if (error) {
+            *error = message;
+        }
+        connection->database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connection->name);
+        return nullptr;
+    }
+
+    QThread* thread = connection->thread;
+    connection->finishedHook = QObject::connect(thread, &QThread::finished, thread,
+                                                [this, thread]() { onThreadFinished(thread); },
+                                                Qt::DirectConnection);
+    ++m_statistics.connectionsOpened;
+    Connection* opened = connection.release();
+    m_connections.insert(thread, opened);
+    return opened;
+}
+
+bool DatabaseConnectionPool::validate(Connection* connection)
+{
+    {
+        QSqlQuery query(connection->database);
+        if (query.exec(m_config.validationQuery)) {
+            return true;
+        }
+    }
+
+    // 失效的连接重新打开一次
+    LOG_WARNING("DatabaseConnectionPool", "连接验证失败，重新打开: " + connection->name);
+    connection->database.close();
+    if (connection->database.open()) {
+        QSqlQuery query(connection->database);
+        if (query.exec(m_config.validationQuery)) {
+            return true;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    ++m_statistics.validationFailures;
+    return false;
+}
+
+void DatabaseConnectionPool::release(Connection* connection)
+{
+    QMutexLocker locker(&m_mutex);
+    if (--connection->leases == 0) {
+        connection->idleTimer.start();
+    }
+}
+
+void DatabaseConnectionPool::closeConnectionLocked(QThread* thread)
+{
+    std::unique_ptr<Connection> connection(m_connections.take(thread));
+    if (!connection) {
+        return;
+    }
+    QObject::disconnect(connection->finishedHook);
+    connection->database.close();
+    connection->database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connection->name);
+    m_connectionClosed.wakeAll();
+}
+
+void DatabaseConnectionPool::onThreadFinished(QThread* thread)
+{
+    // 在结束的线程上执行，此时该线程已不再使用连接
+    QMutexLocker locker(&m_mutex);
+    closeConnectionLocked(thread);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QHash>
+#include <QMetaObject>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QString>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <memory>
+
+class QThread;
+
+// 连接池配置，对应 performance_config.json 的 optimization_parameters.database_connection_pool
+struct DatabasePoolConfig {
+    int minConnections = 5;             // 空闲关闭时至少保留的连接数
+    int maxConnections = 20;            // 同时打开的连接数上限
+    int connectionTimeoutMs = 30000;    // 达到上限时等待其他线程关闭连接的最长时间
+    int idleTimeoutMs = 300000;         // 连接空闲超过该时间后可由所属线程关闭（见 closeIdleConnection）
+    QString validationQuery = "SELECT 1";   // 复用空闲较久的连接前执行，失败时重新打开；为空不验证
+};
+
+struct DatabasePoolStatistics {
+    int openConnections = 0;
+    int leasedConnections = 0;          // 正被取用的连接数
+    qint64 acquisitions = 0;
+    qint64 connectionsOpened = 0;
+    qint64 waits = 0;                   // 因达到上限而等待的次数
+    qint64 timeouts = 0;
+    qint64 validationFailures = 0;
+};
+
+// 按线程分配的只读 SQLite 连接池
+//
+// QSqlDatabase 连接只能在创建它的线程使用，所以每个线程最多持有一个池连接，同一线程的多次取用（包括嵌套）
+// 共享它。连接以只读方式打开：WAL 模式下多个读取方并发执行，也不排在数据库服务线程的写入事务之后，
+// 只能读到已提交的数据。打开的连接数达到上限时，新线程最多等待 connectionTimeoutMs。
+// 连接在所属线程结束时关闭；有事件循环的线程可在空闲后调用 closeIdleConnection() 提前释放。
+// 同一数据库文件的各个使用方通过 shared() 共享一个池和它的上限。
+// 池须在使用它的线程都不再取用连接之后析构。
+class DatabaseConnectionPool
+{
+public:
+    // 一次取用，析构时归还；只能在取用它的线程使用
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        bool isValid() const { return m_connection != nullptr; }
+        QSqlDatabase& database();
+
+    private:
+        friend class DatabaseConnectionPool;
+        struct Connection;
+
+        Lease(DatabaseConnectionPool* pool, Connection* connection);
+        void release();
+
+        DatabaseConnectionPool* m_pool = nullptr;
+        Connection* m_connection = nullptr;
+    };
+
+    explicit DatabaseConnectionPool(const QString& databasePath, const DatabasePoolConfig& config = defaultConfig());
+    ~DatabaseConnectionPool();
+
+    DatabaseConnectionPool(const DatabaseConnectionPool&) = delete;
+    DatabaseConnectionPool& operator=(const DatabaseConnectionPool&) = delete;
+
+    // 同一路径共用的池，最后一个使用方释放后关闭
+    static std::shared_ptr<DatabaseConnectionPool> shared(const QString& databasePath);
+    // 之后创建的池使用的配置（启动时由配置文件设置）
+    static void setDefaultConfig(const DatabasePoolConfig& config);
+    static DatabasePoolConfig defaultConfig();
+
+    // 取得当前线程的连接，失败（打开失败或等待超时）时返回无效的 Lease 并写入 error
+    Lease acquire(QString* error = nullptr);
+    // 当前线程的连接未被取用、空闲超过 idleTimeoutMs 且打开的连接数多于 minConnections 时关闭它
+    bool closeIdleConnection();
+    // 关闭当前线程未被取用的连接
+    void closeThreadConnection();
+
+    QString databasePath() const { return m_databasePath; }
+    DatabasePoolConfig config() const { return m_config; }
+    DatabasePoolStatistics statistics() const;
+
+private:
+    using Connection = Lease::Connection;
+
+    Connection* openLocked(QString* error);
+    bool validate(Connection* connection);
+    void release(Connection* connection);
+    void closeConnectionLocked(QThread* thread);
+    void onThreadFinished(QThread* thread);
+
+    const QString m_databasePath;
+    const DatabasePoolConfig m_config;
+    const QString m_connectionPrefix;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_connectionClosed;
+    QHash<QThread*, Connection*> m_connections;
+    quint64 m_nextConnectionId = 0;
+    DatabasePoolStatistics m_statistics;
+};
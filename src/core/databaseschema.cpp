@@ -0,0 +1,402 @@
+#include "databaseschema.h"
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+// 第 1 版是原来建表语句的表结构；已有数据库的 user_version 为 0，
+// 建表语句都带 IF NOT EXISTS，第 1 版对它们不做修改，从第 2 版开始补索引
+const QString CREATE_ALARM_RECORDS = R"(
+    CREATE TABLE IF NOT EXISTS alarm_records (
+        alarm_id INTEGER PRIMARY KEY AUTOINCREMENT,
+        alarm_type INTEGER NOT NULL,
+        alarm_level INTEGER NOT NULL,
+        alarm_status INTEGER NOT NULL,
+        alarm_code TEXT NOT NULL,
+        alarm_message TEXT NOT NULL,
+        device_name TEXT NOT NULL,
+        parameter_name TEXT,
+        parameter_value REAL DEFAULT 0,
+        threshold_value REAL DEFAULT 0,
+        timestamp DATETIME NOT NULL,
+        acknowledge_time DATETIME,
+        resolve_time DATETIME,
+        operator_name TEXT,
+        acknowledge_user TEXT,
+        resolve_user TEXT,
+        solution TEXT,
+        notes TEXT,
+        count INTEGER DEFAULT 1,
+        is_audible BOOLEAN DEFAULT TRUE,
+        is_visible BOOLEAN DEFAULT TRUE,
+        category TEXT,
+        priority INTEGER DEFAULT 1,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    )
+)";
+
+const QString CREATE_ALARM_THRESHOLDS = R"(
+    CREATE TABLE IF NOT EXISTS alarm_thresholds (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        parameter_name TEXT NOT NULL UNIQUE,
+        alarm_type INTEGER NOT NULL,
+        alarm_level INTEGER NOT NULL,
+        high_high REAL DEFAULT 0,
+        high_value REAL DEFAULT 0,
+        low_value REAL DEFAULT 0,
+        low_low REAL DEFAULT 0,
+        enable_high_high BOOLEAN DEFAULT FALSE,
+        enable_high BOOLEAN DEFAULT TRUE,
+        enable_low BOOLEAN DEFAULT TRUE,
+        enable_low_low BOOLEAN DEFAULT FALSE,
+        delay_time INTEGER DEFAULT 0,
+        deadband INTEGER DEFAULT 0,
+        is_enabled BOOLEAN DEFAULT TRUE,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    )
+)";
+
+const QString CREATE_ALARM_CONFIG = R"(
+    CREATE TABLE IF NOT EXISTS alarm_config (
+        id INTEGER PRIMARY KEY,
+        enable_audible BOOLEAN DEFAULT TRUE,
+        enable_visual BOOLEAN DEFAULT TRUE,
+        enable_email BOOLEAN DEFAULT FALSE,
+        enable_sms BOOLEAN DEFAULT FALSE,
+        enable_tray BOOLEAN DEFAULT TRUE,
+        max_active_alarms INTEGER DEFAULT 100,
+        auto_acknowledge_time INTEGER DEFAULT 0,
+        sound_duration INTEGER DEFAULT 5,
+        sound_file TEXT,
+        email_recipients TEXT,
+        sms_recipients TEXT,
+        enable_history BOOLEAN DEFAULT TRUE,
+        max_history_records INTEGER DEFAULT 10000,
+        enable_statistics BOOLEAN DEFAULT TRUE,
+        statistics_update_interval INTEGER DEFAULT 60,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    )
+)";
+
+const QString CREATE_PRODUCTION_BATCHES = R"(
+    CREATE TABLE IF NOT EXISTS production_batches (
+        batch_id INTEGER PRIMARY KEY AUTOINCREMENT,
+        batch_name TEXT NOT NULL,
+        product_type TEXT NOT NULL,
+        start_time DATETIME NOT NULL,
+        end_time DATETIME,
+        total_count INTEGER DEFAULT 0,
+        qualified_count INTEGER DEFAULT 0,
+        defect_count INTEGER DEFAULT 0,
+        quality_rate REAL DEFAULT 0.0,
+        operator_name TEXT,
+        program_name TEXT,
+        notes TEXT,
+        parameters TEXT,
+        quality_data TEXT,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    )
+)";
+
+// 质量数据和生产报警按月分区，建表语句中的 %1 为表名
+const QString CREATE_QUALITY_DATA = R"(
+    CREATE TABLE IF NOT EXISTS %1 (
+        record_id INTEGER PRIMARY KEY AUTOINCREMENT,
+        batch_id INTEGER NOT NULL,
+        timestamp DATETIME NOT NULL,
+        position_x REAL NOT NULL,
+        position_y REAL NOT NULL,
+        position_z REAL NOT NULL,
+        glue_volume REAL NOT NULL,
+        pressure REAL NOT NULL,
+        temperature REAL NOT NULL,
+        speed REAL NOT NULL,
+        quality_level TEXT NOT NULL,
+        is_qualified BOOLEAN NOT NULL,
+        defect_type TEXT,
+        inspector TEXT,
+        notes TEXT,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        FOREIGN KEY (batch_id) REFERENCES production_batches(batch_id)
+    )
+)";
+
+const QString CREATE_PRODUCTION_ALARMS = R"(
+    CREATE TABLE IF NOT EXISTS %1 (
+        alarm_id INTEGER PRIMARY KEY AUTOINCREMENT,
+        timestamp DATETIME NOT NULL,
+        alarm_type TEXT NOT NULL,
+        alarm_level TEXT NOT NULL,
+        alarm_code TEXT NOT NULL,
+        alarm_message TEXT NOT NULL,
+        device_name TEXT NOT NULL,
+        operator_name TEXT,
+        is_acknowledged BOOLEAN DEFAULT FALSE,
+        acknowledge_time DATETIME,
+        acknowledge_user TEXT,
+        solution TEXT,
+        notes TEXT,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    )
+)";
+
+const QString CREATE_STATISTICS_DATA = R"(
+    CREATE TABLE IF NOT EXISTS statistics_data (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        date DATE NOT NULL UNIQUE,
+        total_batches INTEGER DEFAULT 0,
+        total_products INTEGER DEFAULT 0,
+        qualified_products INTEGER DEFAULT 0,
+        defect_products INTEGER DEFAULT 0,
+        quality_rate REAL DEFAULT 0.0,
+        efficiency REAL DEFAULT 0.0,
+        uptime REAL DEFAULT 0.0,
+        downtime REAL DEFAULT 0.0,
+        alarm_count INTEGER DEFAULT 0,
+        top_defect_type TEXT,
+        average_glue_volume REAL DEFAULT 0.0,
+        average_pressure REAL DEFAULT 0.0,
+        average_temperature REAL DEFAULT 0.0,
+        created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+        updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    )
+)";
+
+// 过滤条件和时间范围拼成 WHERE 子句，值按占位符顺序追加到 values
+QString historyWhere(const HistoryPageQuery& page, bool withCursor, QVariantList* values)
+{
+    QString where = "timestamp BETWEEN ? AND ?";
+    values->append(page.startTime);
+    values->append(withCursor && !page.isFirstPage() ? page.cursorTime : page.endTime);
+
+    if (page.alarmType >= 0) {
+        where += " AND alarm_type = ?";
+        values->append(page.alarmType);
+    }
+    if (page.alarmLevel >= 0) {
+        where += " AND alarm_level = ?";
+        values->append(page.alarmLevel);
+    }
+    if (!page.deviceName.isEmpty()) {
+        where += " AND device_name = ?";
+        values->append(page.deviceName);
+    }
+
+    // 同一时刻的多条记录按 ID 继续向前翻；时间上界已经收紧到游标，这里只排除游标本身及之后的行
+    if (withCursor && !page.isFirstPage()) {
+        where += " AND (timestamp < ? OR alarm_id < ?)";
+        values->append(page.cursorTime);
+        values->append(page.cursorId);
+    }
+    return where;
+}
+}
+
+namespace DatabaseSchema {
+
+int version(QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+bool migrate(QSqlDatabase& database, const QList<SchemaMigration>& migrations, QString* error)
+{
+    const int current = version(database);
+    bool migrated = false;
+
+    for (const SchemaMigration& migration : migrations) {
+        if (migration.version <= current) {
+            continue;
+        }
+
+        if (!database.transaction()) {
+            if (error) *error = "无法开始迁移事务: " + database.lastError().text();
+            return false;
+        }
+
+        QSqlQuery query(database);
+        for (const QString& statement : migration.statements) {
+            if (!query.exec(statement)) {
+                if (error) {
+                    *error = QString("结构迁移 %1 (%2) 失败: %3")
+                        .arg(migration.version).arg(migration.description, query.lastError().text());
+                }
+                database.rollback();
+                return false;
+            }
+        }
+
+        // user_version 写在数据库文件头中，随事务一起提交
+        if (!query.exec(QString("PRAGMA user_version = %1").arg(migration.version)) || !database.commit()) {
+            if (error) *error = QString("结构迁移 %1 提交失败: %2").arg(migration.version).arg(database.lastError().text());
+            database.rollback();
+            return false;
+        }
+        migrated = true;
+    }
+
+    // 新索引建好后更新查询计划器的统计信息
+    if (migrated) {
+        QSqlQuery(database).exec("PRAGMA optimize");
+    }
+    return true;
+}
+
+QList<SchemaMigration> alarmMigrations()
+{
+    return {
+        {1, "报警记录、阈值和配置表", {CREATE_ALARM_RECORDS, CREATE_ALARM_THRESHOLDS, CREATE_ALARM_CONFIG}},
+        // 历史查询总是带时间范围并按时间倒序，过滤列在前、时间在后的组合索引可以直接按顺序读取一页；
+        // 单列索引被组合索引的前缀取代，parameter_name 的 UNIQUE 约束本身带索引
+        {2, "报警历史组合索引", {
+            "DROP INDEX IF EXISTS idx_alarm_type",
+            "DROP INDEX IF EXISTS idx_alarm_level",
+            "DROP INDEX IF EXISTS idx_alarm_status",
+            "DROP INDEX IF EXISTS idx_alarm_device",
+            "DROP INDEX IF EXISTS idx_threshold_parameter",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_timestamp ON alarm_records(timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_type_time ON alarm_records(alarm_type, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_level_time ON alarm_records(alarm_level, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_status_time ON alarm_records(alarm_status, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_device_time ON alarm_records(device_name, timestamp)"
+        }}
+    };
+}
+
+QList<SchemaMigration> productionMigrations()
+{
+    return {
+        {1, "生产批次、质量、报警和统计表", {
+            CREATE_PRODUCTION_BATCHES, CREATE_QUALITY_DATA.arg("quality_data"),
+            CREATE_PRODUCTION_ALARMS.arg("alarm_records"), CREATE_STATISTICS_DATA
+        }},
+        // 批次按产品类型和时间查询，质量数据按批次取并按时间排序；date 的 UNIQUE 约束本身带索引
+        {2, "生产历史组合索引", {
+            "DROP INDEX IF EXISTS idx_production_product_type",
+            "DROP INDEX IF EXISTS idx_quality_batch_id",
+            "DROP INDEX IF EXISTS idx_alarm_type",
+            "DROP INDEX IF EXISTS idx_statistics_date",
+            "CREATE INDEX IF NOT EXISTS idx_production_start_time ON production_batches(start_time)",
+            "CREATE INDEX IF NOT EXISTS idx_production_type_time ON production_batches(product_type, start_time)",
+            "CREATE INDEX IF NOT EXISTS idx_quality_timestamp ON quality_data(timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_quality_batch_time ON quality_data(batch_id, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_timestamp ON alarm_records(timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_type_time ON alarm_records(alarm_type, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_level_time ON alarm_records(alarm_level, timestamp)",
+            "CREATE INDEX IF NOT EXISTS idx_alarm_device_time ON alarm_records(device_name, timestamp)"
+        }},
+        // 已有数据整体成为旧数据分区（只改名，不复制），原表名改为合并各分区的视图；
+        // 之后的分区由 TablePartitions::ensure() 按需创建
+        {3, "质量数据和报警记录按月分区", {
+            "ALTER TABLE quality_data RENAME TO quality_data_p0",
+            "CREATE VIEW quality_data AS SELECT * FROM quality_data_p0",
+            "ALTER TABLE alarm_records RENAME TO alarm_records_p0",
+            "CREATE VIEW alarm_records AS SELECT * FROM alarm_records_p0"
+        }}
+    };
+}
+
+TablePartitionSpec qualityDataPartitions()
+{
+    TablePartitionSpec spec;
+    spec.table = "quality_data";
+    spec.timeColumn = "timestamp";
+    spec.idColumn = "record_id";
+    spec.createSql = CREATE_QUALITY_DATA;
+    spec.indexSql = {
+        "CREATE INDEX IF NOT EXISTS idx_%1_timestamp ON %1(timestamp)",
+        "CREATE INDEX IF NOT EXISTS idx_%1_batch_time ON %1(batch_id, timestamp)"
+    };
+    spec.granularity = TablePartitionSpec::Month;
+    return spec;
+}
+
+TablePartitionSpec productionAlarmPartitions()
+{
+    TablePartitionSpec spec;
+    spec.table = "alarm_records";
+    spec.timeColumn = "timestamp";
+    spec.idColumn = "alarm_id";
+    spec.createSql = CREATE_PRODUCTION_ALARMS;
+    spec.indexSql = {
+        "CREATE INDEX IF NOT EXISTS idx_%1_timestamp ON %1(timestamp)",
+        "CREATE INDEX IF NOT EXISTS idx_%1_type_time ON %1(alarm_type, timestamp)",
+        "CREATE INDEX IF NOT EXISTS idx_%1_level_time ON %1(alarm_level, timestamp)",
+        "CREATE INDEX IF NOT EXISTS idx_%1_device_time ON %1(device_name, timestamp)"
+    };
+    spec.granularity = TablePartitionSpec::Month;
+    return spec;
+}
+
+QStringList queryPlan(QSqlDatabase& database, const QString& sql, const QVariantList& values)
+{
+    QStringList plan;
+    QSqlQuery query(database);
+    if (!query.prepare("EXPLAIN QUERY PLAN " + sql)) {
+        return plan;
+    }
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
+    }
+    if (!query.exec()) {
+        return plan;
+    }
+    // 列依次为 id、parent、notused、detail
+    while (query.next()) {
+        plan.append(query.value(3).toString());
+    }
+    return plan;
+}
+
+bool hasFullScan(const QStringList& plan)
+{
+    // "SCAN t"（旧版本为 "SCAN TABLE t"）表示逐行读表；按索引顺序读取时带 USING ... INDEX
+    for (const QString& step : plan) {
+        if (step.startsWith("SCAN") && !step.contains("USING")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString alarmHistoryPageSql(const HistoryPageQuery& page)
+{
+    QVariantList values;
+    return "SELECT * FROM alarm_records WHERE " + historyWhere(page, true, &values)
+        + " ORDER BY timestamp DESC, alarm_id DESC LIMIT ?";
+}
+
+QVariantList alarmHistoryPageValues(const HistoryPageQuery& page)
+{
+    QVariantList values;
+    historyWhere(page, true, &values);
+    values.append(page.pageSize);
+    return values;
+}
+
+QString alarmHistoryCountSql(const HistoryPageQuery& page)
+{
+    QVariantList values;
+    return "SELECT COUNT(*) FROM alarm_records WHERE " + historyWhere(page, false, &values);
+}
+
+QVariantList alarmHistoryCountValues(const HistoryPageQuery& page)
+{
+    QVariantList values;
+    historyWhere(page, false, &values);
+    return values;
+}
+
+QString alarmHistoryFilter(const HistoryPageQuery& page, QVariantList* values)
+{
+    return historyWhere(page, false, values);
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "tablepartitions.h"
+#include <QDateTime>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+
+// 一次结构变更：版本号递增，statements 在同一个事务中执行
+struct SchemaMigration {
+    int version;
+    QString description;
+    QStringList statements;
+};
+
+// 历史记录的一页查询条件
+//
+// 按 (时间, ID) 倒序分页：第一页 cursorId 为 0，之后传入上一页最后一行的时间和 ID。
+// 与 OFFSET 分页相比，翻到第 N 页也只读取一页的索引范围。
+struct HistoryPageQuery {
+    QDateTime startTime;
+    QDateTime endTime;
+    int alarmType = -1;             // 小于 0 表示不过滤
+    int alarmLevel = -1;
+    QString deviceName;             // 为空表示不过滤
+    int pageSize = 500;
+    QDateTime cursorTime;
+    qint64 cursorId = 0;
+
+    bool isFirstPage() const { return cursorId <= 0; }
+};
+
+// 报警和生产数据库的表结构与迁移
+//
+// 当前版本记录在 PRAGMA user_version 中，打开数据库时依次执行更高版本的迁移，
+// 每个迁移单独提交，失败时回滚该迁移并停在上一个版本。
+// 查询语句和它们依赖的索引放在一起维护，基准测试用 queryPlan() 检查它们没有退化为全表扫描。
+namespace DatabaseSchema {
+
+int version(QSqlDatabase& database);
+// 执行 version 之后的迁移；error 可为空
+bool migrate(QSqlDatabase& database, const QList<SchemaMigration>& migrations, QString* error = nullptr);
+
+QList<SchemaMigration> alarmMigrations();
+QList<SchemaMigration> productionMigrations();
+
+// 生产数据库中按时间分区的表（第 3 版迁移之后）
+TablePartitionSpec qualityDataPartitions();
+TablePartitionSpec productionAlarmPartitions();
+
+// EXPLAIN QUERY PLAN 的 detail 列，每个步骤一行
+QStringList queryPlan(QSqlDatabase& database, const QString& sql, const QVariantList& values = QVariantList());
+// 计划中是否存在没有使用索引的表扫描
+bool hasFullScan(const QStringList& plan);
+
+// 报警历史分页查询（报警数据库的 alarm_records）
+QString alarmHistoryPageSql(const HistoryPageQuery& page);
+QVariantList alarmHistoryPageValues(const HistoryPageQuery& page);
+// 同样条件下的总记录数，只读取索引
+QString alarmHistoryCountSql(const HistoryPageQuery& page);
+QVariantList alarmHistoryCountValues(const HistoryPageQuery& page);
+// 同样条件的 WHERE 子句（不含游标），供按页读取的表格模型自行排序和分页
+QString alarmHistoryFilter(const HistoryPageQuery& page, QVariantList* values);
+
+}
@@ -0,0 +1,317 @@
+#include "databaseservice.h"
+#include "../constants.h"
+#include "../logger/logmanager.h"
+#include "../utils/startupprofiler.h"
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QTimer>
+
+DatabaseService::DatabaseService(const QString& connectionName, const QString& databasePath, QObject* parent)
+    : QObject(parent)
+    , m_connectionName(connectionName)
+    , m_databasePath(databasePath)
+    , m_thread(new QThread())
+    , m_worker(new QObject())
+    , m_writesApplied(0)
+    , m_writesSubmitted(0)
+    , m_writesCommitted(0)
+    , m_open(false)
+    , m_readPool(DatabaseConnectionPool::shared(databasePath))
+    , m_nextReader(0)
+{
+    m_thread->setObjectName("Database-" + connectionName);
+    m_worker->moveToThread(m_thread);
+    m_thread->start();
+
+    for (int i = 0; i < System::DB_READER_THREADS; ++i) {
+        Reader reader;
+        reader.thread = new QThread();
+        reader.thread->setObjectName(QString("DatabaseRead-%1-%2").arg(connectionName).arg(i));
+        reader.worker = new QObject();
+        // 空闲超时后释放该线程的池连接，之后的查询会重新打开
+        reader.idleTimer = new QTimer(reader.worker);
+        reader.idleTimer->setSingleShot(true);
+        reader.idleTimer->setInterval(m_readPool->config().idleTimeoutMs);
+        connect(reader.idleTimer, &QTimer::timeout, reader.worker, [this]() { m_readPool->closeIdleConnection(); });
+        reader.worker->moveToThread(reader.thread);
+        reader.thread->start();
+        m_readers.push_back(reader);
+    }
+}
+
+DatabaseService::~DatabaseService()
+{
+    // 服务线程上等待写入提交的查询先派发出去，再结束查询线程
+    QMetaObject::invokeMethod(m_worker, []() {}, Qt::BlockingQueuedConnection);
+
+    // 查询线程先结束，它们的池连接在各自线程上关闭
+    for (const Reader& reader : m_readers) {
+        QMetaObject::invokeMethod(reader.worker, [this]() { m_readPool->closeThreadConnection(); },
+                                  Qt::BlockingQueuedConnection);
+        reader.thread->quit();
+        reader.thread->wait();
+        delete reader.worker;
+        delete reader.thread;
+    }
+    m_readers.clear();
+
+    QMetaObject::invokeMethod(m_worker, [this]() { closeNow(); }, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_worker;
+    delete m_thread;
+}
+
+QFuture<bool> DatabaseService::open(Initializer initializer)
+{
+    auto promise = std::make_shared<QPromise<bool>>();
+    QFuture<bool> future = promise->future();
+    promise->start();
+    post([this, initializer = std::move(initializer), promise]() {
+        STARTUP_PHASE("DatabaseService::open " + m_connectionName);
+        m_database = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+        m_database.setDatabaseName(m_databasePath);
+
+        bool opened = m_database.open();
+        if (!opened) {
+            const QString error = "无法打开数据库: " + m_database.lastError().text();
+            LOG_ERROR("DatabaseService", error);
+            emit databaseError(error);
+        } else {
+            SqlBatchWriter::applyWritePragmas(m_database);
+            if (initializer && !initializer(m_database)) {
+                LOG_ERROR("DatabaseService", "数据库初始化失败: " + m_databasePath);
+                emit databaseError("数据库初始化失败: " + m_databasePath);
+                opened = false;
+            }
+        }
+
+        if (opened) {
+            m_writer = std::make_unique<SqlBatchWriter>(m_database);
+            connect(m_writer.get(), &SqlBatchWriter::writeError, this, &DatabaseService::databaseError);
+            connect(m_writer.get(), &SqlBatchWriter::batchCommitted, m_worker, [this]() {
+                {
+                    QMutexLocker locker(&m_statisticsMutex);
+                    m_statistics = m_writer->statistics();
+                }
+                publishCommitted();
+            });
+            m_open.store(true, std::memory_order_release);
+        }
+        promise->addResult(opened);
+        promise->finish();
+    });
+    return future;
+}
+
+bool DatabaseService::isOpen() const
+{
+    return m_open.load(std::memory_order_acquire);
+}
+
+QString DatabaseService::databasePath() const
+{
+    return m_databasePath;
+}
+
+void DatabaseService::write(const QString& sql, const QVariantList& values)
+{
+    m_writesSubmitted.fetch_add(1, std::memory_order_acq_rel);
+    post([this, sql, values]() {
+        if (!m_writer) {
+            LOG_ERROR("DatabaseService", "数据库未打开，写入被丢弃: " + m_connectionName);
+            emit databaseError("数据库未打开，写入被丢弃");
+            completeWrite();
+            return;
+        }
+        const int statementId = statementFor(sql);
+        if (statementId >= 0) {
+            m_writer->enqueue(statementId, values);
+        }
+        completeWrite();
+    });
+}
+
+void DatabaseService::flush()
+{
+    post([this]() { flushPending(); });
+}
+
+QFuture<DatabaseResult> DatabaseService::execute(const QString& sql, const QVariantList& values)
+{
+    auto promise = std::make_shared<QPromise<DatabaseResult>>();
+    QFuture<DatabaseResult> future = promise->future();
+    promise->start();
+    m_writesSubmitted.fetch_add(1, std::memory_order_acq_rel);
+    post([this, sql, values, promise]() {
+        flushPending();
+        DatabaseResult result = executeNow(sql, values);
+        completeWrite();
+        promise->addResult(std::move(result));
+        promise->finish();
+    });
+    return future;
+}
+
+void DatabaseService::execute(const QString& sql, const QVariantList& values, QObject* context,
+                              std::function<void(const DatabaseResult&)> callback)
+{
+    m_writesSubmitted.fetch_add(1, std::memory_order_acq_rel);
+    post([this, sql, values, context, callback = std::move(callback)]() {
+        flushPending();
+        DatabaseResult result = executeNow(sql, values);
+        completeWrite();
+        QMetaObject::invokeMethod(context, [callback, result]() { callback(result); }, Qt::QueuedConnection);
+    });
+}
+
+void DatabaseService::query(const QString& sql, const QVariantList& values, QObject* context,
+                            std::function<void(const DatabaseResult&)> callback)
+{
+    read<DatabaseResult>([sql, values](QSqlDatabase& database) { return executeOn(database, sql, values); },
+                         context, std::move(callback));
+}
+
+SqlBatchStatistics DatabaseService::writeStatistics() const
+{
+    QMutexLocker locker(&m_statisticsMutex);
+    return m_statistics;
+}
+
+DatabasePoolStatistics DatabaseService::readPoolStatistics() const
+{
+    return m_readPool->statistics();
+}
+
+void DatabaseService::postRead(std::function<void(QSqlDatabase& database)> task)
+{
+    if (m_readers.empty()) {
+        post([this, task = std::move(task)]() {
+            flushPending();
+            task(m_database);
+        });
+        return;
+    }
+
+    // 之前提交的写入还没有全部提交到数据库：先在服务线程按顺序提交，再交给查询线程
+    if (m_writesCommitted.load(std::memory_order_acquire) < m_writesSubmitted.load(std::memory_order_acquire)) {
+        post([this, task = std::move(task)]() mutable {
+            flushPending();
+            dispatchRead(std::move(task));
+        });
+        return;
+    }
+    dispatchRead(std::move(task));
+}
+
+void DatabaseService::dispatchRead(std::function<void(QSqlDatabase& database)> task)
+{
+    const Reader& reader = m_readers[m_nextReader.fetch_add(1, std::memory_order_relaxed) % m_readers.size()];
+    QMetaObject::invokeMethod(reader.worker, [this, idleTimer = reader.idleTimer, task = std::move(task)]() {
+        QString error;
+        DatabaseConnectionPool::Lease lease = m_readPool->acquire(&error);
+        if (!lease.isValid()) {
+            LOG_WARNING("DatabaseService", "取不到只读连接，改在服务线程查询: " + error);
+            post([this, task]() {
+                flushPending();
+                task(m_database);
+            });
+            return;
+        }
+        task(lease.database());
+        lease = DatabaseConnectionPool::Lease();
+        idleTimer->start();
+    }, Qt::QueuedConnection);
+}
+
+void DatabaseService::post(std::function<void()> task)
+{
+    QMetaObject::invokeMethod(m_worker, std::move(task), Qt::QueuedConnection);
+}
+
+void DatabaseService::flushPending()
+{
+    if (m_writer) {
+        m_writer->flush();
+    }
+    publishCommitted();
+}
+
+void DatabaseService::completeWrite()
+{
+    ++m_writesApplied;
+    publishCommitted();
+}
+
+void DatabaseService::publishCommitted()
+{
+    // 排队的行提交失败时队列同样为空，失败通过 databaseError 报告，不再阻挡查询
+    if (!m_writer || !m_writer->hasPending()) {
+        m_writesCommitted.store(m_writesApplied, std::memory_order_release);
+    }
+}
+
+DatabaseResult DatabaseService::executeNow(const QString& sql, const QVariantList& values)
+{
+    return executeOn(m_database, sql, values);
+}
+
+DatabaseResult DatabaseService::executeOn(QSqlDatabase& database, const QString& sql, const QVariantList& values)
+{
+    DatabaseResult result;
+    if (!database.isOpen()) {
+        result.error = "数据库未打开";
+        return result;
+    }
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.prepare(sql)) {
+        result.error = query.lastError().text();
+        return result;
+    }
+    for (int i = 0; i < values.size(); ++i) {
+        query.bindValue(i, values.at(i));
+    }
+    if (!query.exec()) {
+        result.error = query.lastError().text();
+        LOG_WARNING("DatabaseService", "执行语句失败: " + result.error);
+        return result;
+    }
+
+    while (query.next()) {
+        result.rows.append(query.record());
+    }
+    result.success = true;
+    result.rowsAffected = query.numRowsAffected();
+    result.lastInsertId = query.lastInsertId();
+    return result;
+}
+
+int DatabaseService::statementFor(const QString& sql)
+{
+    auto it = m_statements.constFind(sql);
+    if (it != m_statements.constEnd()) {
+        return it.value();
+    }
+    const int statementId = m_writer->prepare(sql);
+    if (statementId >= 0) {
+        m_statements.insert(sql, statementId);
+    }
+    return statementId;
+}
+
+void DatabaseService::closeNow()
+{
+    // 写入器析构时提交剩余的行，预编译语句必须在连接关闭之前释放
+    m_writer.reset();
+    m_statements.clear();
+    m_open.store(false, std::memory_order_release);
+
+    if (m_database.isValid()) {
+        m_database.close();
+        m_database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+}
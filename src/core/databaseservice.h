@@ -0,0 +1,186 @@
+#pragma once
+
+#include "databaseconnectionpool.h"
+#include "sqlbatchwriter.h"
+#include <QObject>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QMutex>
+#include <QPromise>
+#include <QSqlDatabase>
+#include <QSqlRecord>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class QThread;
+class QTimer;
+
+// 单条语句的执行结果
+struct DatabaseResult {
+    bool success = false;
+    QString error;
+    QList<QSqlRecord> rows;         // 查询结果按行拷贝，可以跨线程传递
+    int rowsAffected = -1;
+    QVariant lastInsertId;
+};
+
+// 数据库服务：独立线程和独立连接上的 SQLite 持久化
+//
+// 所有语句都在服务线程按提交顺序执行，界面线程只提交任务，不等待存储：
+// - write() 写后即返回，由 SqlBatchWriter 攒批后在事务中提交；
+// - execute()/run() 先提交排队的写入再执行，保证读到之前写入的数据，
+//   结果通过 QFuture 或回调返回，回调在 context 所在线程执行；
+// - query()/read() 在只读查询线程上用连接池（DatabaseConnectionPool::shared）的连接执行，
+//   与写入和其他查询并发。提交查询时若还有先前提交的写入（write/execute/run）尚未生效，
+//   先经服务线程提交排队的写入再交给查询线程，保证读到之前写入的数据；没有时直接派发。
+// 回调的 context 必须在服务销毁之后才销毁（通常服务是 context 的成员，在析构函数开头删除）。
+class DatabaseService : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Initializer = std::function<bool(QSqlDatabase& database)>;
+    template<typename T>
+    using Job = std::function<T(QSqlDatabase& database)>;
+
+    DatabaseService(const QString& connectionName, const QString& databasePath, QObject* parent = nullptr);
+    ~DatabaseService() override;    // 提交排队的写入、关闭连接并结束线程
+
+    // 在服务线程打开连接、设置写入参数并执行 initializer（建表等）
+    QFuture<bool> open(Initializer initializer = Initializer());
+    bool isOpen() const;
+    QString databasePath() const;
+
+    // 写后即返回，按批在事务中提交；失败通过 databaseError 报告
+    void write(const QString& sql, const QVariantList& values = QVariantList());
+    // 立即提交排队的写入
+    void flush();
+
+    QFuture<DatabaseResult> execute(const QString& sql, const QVariantList& values = QVariantList());
+    void execute(const QString& sql, const QVariantList& values, QObject* context,
+                 std::function<void(const DatabaseResult&)> callback);
+
+    // 在服务线程上运行任意数据库任务（如多条统计查询），结果类型需可拷贝
+    template<typename T>
+    QFuture<T> run(Job<T> job);
+    template<typename T>
+    void run(Job<T> job, QObject* context, std::function<void(const T&)> callback);
+
+    // 只读查询，在查询线程并发执行；取不到池连接时退回服务线程（先提交排队的写入）执行
+    void query(const QString& sql, const QVariantList& values, QObject* context,
+               std::function<void(const DatabaseResult&)> callback);
+    template<typename T>
+    QFuture<T> read(Job<T> job);
+    template<typename T>
+    void read(Job<T> job, QObject* context, std::function<void(const T&)> callback);
+
+    SqlBatchStatistics writeStatistics() const;
+    DatabasePoolStatistics readPoolStatistics() const;
+
+    // 在给定连接上执行单条语句（供其他只读连接的使用方共用）
+    static DatabaseResult executeOn(QSqlDatabase& database, const QString& sql, const QVariantList& values);
+
+signals:
+    void databaseError(const QString& error);
+
+private:
+    // 读取任务在查询线程上用池连接执行，取不到池连接时在服务线程用服务连接执行
+    void postRead(std::function<void(QSqlDatabase& database)> task);
+    void dispatchRead(std::function<void(QSqlDatabase& database)> task);
+
+    // 以下函数只在服务线程调用
+    void post(std::function<void()> task);
+    void flushPending();
+    void completeWrite();           // 一个写入任务已在服务线程执行
+    void publishCommitted();        // 没有排队的行时，已执行的写入对只读连接可见
+    DatabaseResult executeNow(const QString& sql, const QVariantList& values);
+    int statementFor(const QString& sql);
+    void closeNow();
+
+    QString m_connectionName;
+    QString m_databasePath;
+    QThread* m_thread;
+    QObject* m_worker;              // 属于服务线程，任务投递到它的事件队列
+
+    // 只在服务线程访问
+    QSqlDatabase m_database;
+    std::unique_ptr<SqlBatchWriter> m_writer;
+    QHash<QString, int> m_statements;
+    quint64 m_writesApplied;        // 已在服务线程执行（可能仍在批量写入器中排队）的写入任务数
+
+    // 写入任务提交数与已提交到数据库的写入任务数，两者相等时查询可以直接派发到查询线程
+    std::atomic<quint64> m_writesSubmitted;
+    std::atomic<quint64> m_writesCommitted;
+
+    std::atomic<bool> m_open;
+    mutable QMutex m_statisticsMutex;
+    SqlBatchStatistics m_statistics;
+
+    // 只读查询线程，每个线程从池中取用自己的连接
+    struct Reader {
+        QThread* thread = nullptr;
+        QObject* worker = nullptr;
+        QTimer* idleTimer = nullptr;
+    };
+    std::shared_ptr<DatabaseConnectionPool> m_readPool;
+    std::vector<Reader> m_readers;
+    std::atomic<unsigned> m_nextReader;
+};
+
+template<typename T>
+QFuture<T> DatabaseService::run(Job<T> job)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+    m_writesSubmitted.fetch_add(1, std::memory_order_acq_rel);
+    post([this, job = std::move(job), promise]() {
+        flushPending();
+        T result = job(m_database);
+        completeWrite();
+        promise->addResult(std::move(result));
+        promise->finish();
+    });
+    return future;
+}
+
+template<typename T>
+void DatabaseService::run(Job<T> job, QObject* context, std::function<void(const T&)> callback)
+{
+    m_writesSubmitted.fetch_add(1, std::memory_order_acq_rel);
+    post([this, job = std::move(job), context, callback = std::move(callback)]() {
+        flushPending();
+        T result = job(m_database);
+        completeWrite();
+        QMetaObject::invokeMethod(context, [callback, result]() { callback(result); }, Qt::QueuedConnection);
+    });
+}
+
+template<typename T>
+QFuture<T> DatabaseService::read(Job<T> job)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+    postRead([job = std::move(job), promise](QSqlDatabase& database) {
+        promise->addResult(job(database));
+        promise->finish();
+    });
+    return future;
+}
+
+template<typename T>
+void DatabaseService::read(Job<T> job, QObject* context, std::function<void(const T&)> callback)
+{
+    postRead([job = std::move(job), context, callback = std::move(callback)](QSqlDatabase& database) {
+        T result = job(database);
+        QMetaObject::invokeMethod(context, [callback, result]() { callback(result); }, Qt::QueuedConnection);
+    });
+}
@@ -0,0 +1,291 @@
+#include "dataexporter.h"
+#include "../constants.h"
+#include "../logger/logmanager.h"
+#include "../utils/xlsxstreamwriter.h"
+#include "databaseconnectionpool.h"
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QThread>
+#include <memory>
+
+namespace {
+// 导出格式的写入端，行按查询顺序送入
+class ExportSink
+{
+public:
+    virtual ~ExportSink() = default;
+    virtual bool beginSection(const ExportSection& section) = 0;
+    virtual bool writeRow(const QVariantList& values) = 0;
+    virtual bool endSection() = 0;
+    virtual bool finish() = 0;
+    virtual QString errorString() const = 0;
+};
+
+// UTF-8 带 BOM，Excel 直接打开时中文不乱码；多段导出时每段前写标题行，段之间空一行
+class CsvSink : public ExportSink
+{
+public:
+    CsvSink(QIODevice* device, bool titled)
+        : m_device(device), m_titled(titled), m_sections(0), m_buffer("\xEF\xBB\xBF") {}
+
+    bool beginSection(const ExportSection& section) override
+    {
+        if (m_titled) {
+            if (m_sections > 0) {
+                m_buffer.append('\n');
+            }
+            appendField(section.title);
+            m_buffer.append('\n');
+        }
+        ++m_sections;
+
+        for (int i = 0; i < section.headers.size(); ++i) {
+            if (i > 0) m_buffer.append(',');
+            appendField(section.headers[i]);
+        }
+        m_buffer.append('\n');
+        return flush(false);
+    }
+
+    bool writeRow(const QVariantList& values) override
+    {
+        for (int i = 0; i < values.size(); ++i) {
+            if (i > 0) m_buffer.append(',');
+            if (!values[i].isNull()) {
+                appendField(values[i].toString());
+            }
+        }
+        m_buffer.append('\n');
+        return flush(false);
+    }
+
+    bool endSection() override { return flush(true); }
+    bool finish() override { return flush(true); }
+    QString errorString() const override { return m_device->errorString(); }
+
+private:
+    // 含分隔符、引号或换行的字段加引号，内部引号写两次
+    void appendField(const QString& text)
+    {
+        if (text.contains(QLatin1Char(',')) || text.contains(QLatin1Char('"'))
+            || text.contains(QLatin1Char('\n')) || text.contains(QLatin1Char('\r'))) {
+            QString quoted = text;
+            quoted.replace(QLatin1String("\""), QLatin1String("\"\""));
+            m_buffer.append('"');
+            m_buffer.append(quoted.toUtf8());
+            m_buffer.append('"');
+        } else {
+            m_buffer.append(text.toUtf8());
+        }
+    }
+
+    bool flush(bool force)
+    {
+        if (!force && m_buffer.size() < System::EXPORT_BUFFER_BYTES) {
+            return true;
+        }
+        const bool written = m_device->write(m_buffer) == m_buffer.size();
+        m_buffer.clear();
+        return written;
+    }
+
+    QIODevice* m_device;
+    bool m_titled;
+    int m_sections;
+    QByteArray m_buffer;
+};
+
+class XlsxSink : public ExportSink
+{
+public:
+    explicit XlsxSink(QIODevice* device) : m_writer(device) {}
+
+    bool beginSection(const ExportSection& section) override { return m_writer.beginSheet(section.title, section.headers); }
+    bool writeRow(const QVariantList& values) override { return m_writer.writeRow(values); }
+    bool endSection() override { return m_writer.endSheet(); }
+    bool finish() override { return m_writer.finish(); }
+    QString errorString() const override { return m_writer.errorString(); }
+
+private:
+    XlsxStreamWriter m_writer;
+};
+
+void bindValues(QSqlQuery& query, const QVariantList& values)
+{
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
+    }
+}
+}
+
+DataExporter::DataExporter(const QString& databasePath, QObject* parent)
+    : QObject(parent)
+    , m_databasePath(databasePath)
+    , m_thread(nullptr)
+    , m_running(false)
+    , m_cancelled(false)
+{
+}
+
+DataExporter::~DataExporter()
+{
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+bool DataExporter::start(const ExportJob& job)
+{
+    if (m_running.load()) {
+        return false;
+    }
+    // 上一个任务已经发出 finished，线程即将退出
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+
+    m_running.store(true);
+    m_cancelled.store(false);
+    m_thread = QThread::create([this, job]() { run(job); });
+    m_thread->setObjectName("DataExport");
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+void DataExporter::cancel()
+{
+    m_cancelled.store(true);
+}
+
+bool DataExporter::isRunning() const
+{
+    return m_running.load();
+}
+
+ExportJob::Format DataExporter::formatForFile(const QString& filename)
+{
+    const QString suffix = QFileInfo(filename).suffix().toLower();
+    return suffix == "xlsx" ? ExportJob::Xlsx : ExportJob::Csv;
+}
+
+void DataExporter::run(const ExportJob& job)
+{
+    const std::shared_ptr<DatabaseConnectionPool> pool = DatabaseConnectionPool::shared(m_databasePath);
+    qint64 rows = 0;
+    QString error;
+    bool success = false;
+    {
+        DatabaseConnectionPool::Lease lease = pool->acquire(&error);
+        if (lease.isValid()) {
+            success = exportSections(lease.database(), job, &rows, &error);
+        }
+    }
+    // 导出线程随后结束，不必保留连接
+    pool->closeThreadConnection();
+
+    if (success) {
+        LOG_INFO("DataExporter", QString("导出完成: %1 (%2 行)").arg(job.filename).arg(rows));
+    } else {
+        LOG_WARNING("DataExporter", QString("导出未完成: %1 (%2)").arg(job.filename, error));
+    }
+    m_running.store(false);
+    emit finished(success, job.filename, rows, error);
+}
+
+bool DataExporter::exportSections(QSqlDatabase& database, const ExportJob& job, qint64* rows, QString* error)
+{
+    // 总行数只用于进度，计数查询由索引完成
+    qint64 total = 0;
+    for (const ExportSection& section : job.sections) {
+        if (section.countSql.isEmpty()) {
+            continue;
+        }
+        QSqlQuery count(database);
+        if (count.prepare(section.countSql)) {
+            bindValues(count, section.values);
+            if (count.exec() && count.next()) {
+                total += count.value(0).toLongLong();
+            }
+        }
+    }
+    emit progress(0, total);
+
+    // 写入临时文件，commit() 时替换目标文件；未提交时析构即丢弃
+    QSaveFile file(job.filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *error = "无法创建导出文件: " + file.errorString();
+        return false;
+    }
+
+    std::unique_ptr<ExportSink> sink;
+    if (job.format == ExportJob::Xlsx) {
+        sink = std::make_unique<XlsxSink>(&file);
+    } else {
+        sink = std::make_unique<CsvSink>(&file, job.sections.size() > 1);
+    }
+
+    const auto fail = [&](const QString& message) {
+        *error = message;
+        file.cancelWriting();
+        return false;
+    };
+
+    for (const ExportSection& section : job.sections) {
+        // 只进游标：驱动逐行步进 SQLite 语句，不缓存已读过的行
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        if (!query.prepare(section.sql)) {
+            return fail(QString("准备导出查询失败 (%1): %2").arg(section.title, query.lastError().text()));
+        }
+        bindValues(query, section.values);
+        if (!query.exec()) {
+            return fail(QString("导出查询失败 (%1): %2").arg(section.title, query.lastError().text()));
+        }
+        if (!sink->beginSection(section)) {
+            return fail("写入导出文件失败: " + sink->errorString());
+        }
+
+        const int columns = query.record().count();
+        QVariantList values;
+        values.reserve(columns);
+        while (query.next()) {
+            if (m_cancelled.load(std::memory_order_relaxed)) {
+                return fail("导出已取消");
+            }
+
+            values.clear();
+            for (int column = 0; column < columns; ++column) {
+                values.append(query.value(column));
+            }
+            if (!sink->writeRow(values)) {
+                return fail("写入导出文件失败: " + sink->errorString());
+            }
+            if (++*rows % System::EXPORT_PROGRESS_ROWS == 0) {
+                emit progress(*rows, total);
+            }
+        }
+        if (query.lastError().isValid()) {
+            return fail(QString("读取导出数据失败 (%1): %2").arg(section.title, query.lastError().text()));
+        }
+        if (!sink->endSection()) {
+            return fail("写入导出文件失败: " + sink->errorString());
+        }
+    }
+
+    if (!sink->finish()) {
+        return fail("写入导出文件失败: " + sink->errorString());
+    }
+    if (!file.commit()) {
+        *error = "保存导出文件失败: " + file.errorString();
+        return false;
+    }
+    emit progress(*rows, qMax(total, *rows));
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <atomic>
+
+class QSqlDatabase;
+class QThread;
+
+// 导出的一部分：一条查询对应 CSV 中的一段或 Excel 中的一个工作表
+struct ExportSection {
+    QString title;
+    QString sql;
+    QVariantList values;
+    QStringList headers;        // 与查询列一一对应
+    QString countSql;           // 用于进度的总行数查询，参数与 sql 相同；为空时总数未知
+};
+
+struct ExportJob {
+    enum Format {
+        Csv,
+        Xlsx
+    };
+
+    QString filename;
+    Format format = Csv;
+    QList<ExportSection> sections;
+};
+
+// 后台流式导出
+//
+// 每个导出任务在独立线程上用连接池（DatabaseConnectionPool::shared）的只读连接读取数据库
+// （WAL 模式下不阻塞数据库服务线程的写入），
+// 以只进游标逐行读取，经固定大小的缓冲区写入 QSaveFile，内存占用与导出行数无关。
+// 取消或失败时丢弃临时文件，不会留下不完整的导出文件。同一时间只运行一个任务。
+class DataExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataExporter(const QString& databasePath, QObject* parent = nullptr);
+    ~DataExporter() override;       // 取消正在进行的导出并等待线程结束
+
+    // 已有导出在进行时返回 false
+    bool start(const ExportJob& job);
+    void cancel();
+    bool isRunning() const;
+
+    static ExportJob::Format formatForFile(const QString& filename);
+
+signals:
+    void progress(qint64 rows, qint64 totalRows);   // totalRows 为 0 表示总数未知
+    void finished(bool success, const QString& filename, qint64 rows, const QString& error);
+
+private:
+    // 以下函数在导出线程执行
+    void run(const ExportJob& job);
+    bool exportSections(QSqlDatabase& database, const ExportJob& job, qint64* rows, QString* error);
+
+    QString m_databasePath;
+    QThread* m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_cancelled;
+};
@@ -1,10 +1,31 @@
 #include "errorhandler.h"
+#include "../constants.h"
 #include "../logger/logmanager.h"
 #include <QDebug>
 #include <QCoreApplication>
-#include <QMessageBox>
 #include <QMutexLocker>
 
+namespace {
+
+constexpr int LEVEL_COUNT = 5;
+
+// 每个线程一个计数槽位，独占缓存行，报告错误时不争用同一把锁或同一缓存行；
+// 超出槽位数的线程共用最后一个槽位（计数用原子加，合并计数仍然准确）
+struct alignas(64) CounterSlot {
+    std::atomic<qint64> counts[LEVEL_COUNT];
+};
+
+CounterSlot s_counterSlots[System::ERROR_COUNTER_MAX_THREADS];
+std::atomic<int> s_nextCounterSlot{0};
+thread_local CounterSlot* t_counterSlot = nullptr;
+
+int levelIndex(ErrorLevel level)
+{
+    return qBound(0, static_cast<int>(level), LEVEL_COUNT - 1);
+}
+
+}
+
 ErrorHandler* ErrorHandler::instance = nullptr;
 QMutex ErrorHandler::instanceMutex;
 
@@ -19,19 +40,23 @@ ErrorHandler* ErrorHandler::getInstance()
 
 ErrorHandler::ErrorHandler(QObject* parent)
     : QObject(parent)
+    , suppressedTotal(0)
     , maxErrorCount(100)
     , maxHistorySize(1000)
+    , stormBurst(System::ERROR_STORM_BURST)
+    , stormWindowMs(System::ERROR_STORM_WINDOW_MS)
+    , pendingStormSummaries(0)
+    , lastStormSweepMs(0)
     , autoRecoveryEnabled(true)
     , recoveryInProgress(false)
     , recoveryAttempts(0)
     , maxRecoveryAttempts(3)
 {
-    // 初始化错误计数
-    errorCounts[ErrorLevel::Info] = 0;
-    errorCounts[ErrorLevel::Warning] = 0;
-    errorCounts[ErrorLevel::Error] = 0;
-    errorCounts[ErrorLevel::Critical] = 0;
-    errorCounts[ErrorLevel::Fatal] = 0;
+    // 错误计数从当前值开始
+    for (int i = 0; i < LEVEL_COUNT; ++i) {
+        countBaselines[i].store(countedErrors(static_cast<ErrorLevel>(i)), std::memory_order_relaxed);
+    }
+    stormClock.start();
     
     // 设置默认错误阈值
     errorThresholds[ErrorLevel::Warning] = 50;
@@ -73,24 +98,137 @@ void ErrorHandler::reportError(ErrorLevel level, const QString& category,
     entry.details = details;
     entry.handled = false;
     
+    countError(level);
+    
+    // 被限流的错误只计数；上一窗口有被合并的错误时，先输出合并记录
+    QList<ErrorEntry> records;
     {
         QMutexLocker locker(&errorMutex);
-        errorQueue.enqueue(entry);
-        errorCounts[level]++;
-        
-        // 添加到历史记录
-        errorHistory.append(entry);
-        if (errorHistory.size() > maxHistorySize) {
-            errorHistory.removeFirst();
+        admitLocked(entry, stormClock.elapsed(), records);
+    }
+    
+    for (const ErrorEntry& record : records) {
+        // 立即处理致命错误
+        if (record.level == ErrorLevel::Fatal) {
+            processError(record);
         }
+        emit errorReported(record);
+    }
+}
+
+void ErrorHandler::admitLocked(const ErrorEntry& entry, qint64 nowMs, QList<ErrorEntry>& records)
+{
+    // 致命错误不限流
+    if (stormBurst <= 0 || entry.level == ErrorLevel::Fatal) {
+        recordLocked(entry);
+        records.append(entry);
+        return;
     }
     
-    // 立即处理致命错误
-    if (level == ErrorLevel::Fatal) {
-        processError(entry);
+    const StormKey key{entry.level, entry.category, entry.source, entry.message};
+    auto it = stormStates.find(key);
+    if (it == stormStates.end()) {
+        if (stormStates.size() >= System::ERROR_STORM_MAX_KEYS) {
+            recordLocked(entry);
+            records.append(entry);
+            return;
+        }
+        it = stormStates.insert(key, StormState());
+        it->windowStartMs = nowMs;
+    }
+    
+    StormState& state = it.value();
+    if (nowMs - state.windowStartMs >= stormWindowMs) {
+        if (state.suppressed > 0) {
+            const ErrorEntry summary = makeStormSummary(state, nowMs - state.windowStartMs);
+            recordLocked(summary);
+            records.append(summary);
+            --pendingStormSummaries;
+        }
+        state.windowStartMs = nowMs;
+        state.windowCount = 0;
+        state.suppressed = 0;
+    }
+    
+    if (state.windowCount < stormBurst) {
+        ++state.windowCount;
+        recordLocked(entry);
+        records.append(entry);
+        return;
+    }
+    
+    if (state.suppressed++ == 0) {
+        ++pendingStormSummaries;
+    }
+    state.lastSuppressed = entry;
+    suppressedTotal.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ErrorHandler::flushStormSummariesLocked(qint64 nowMs, QList<ErrorEntry>& records)
+{
+    // 没有待输出的合并记录时，每个窗口清理一次已结束的限流状态
+    if (pendingStormSummaries == 0 && nowMs - lastStormSweepMs < stormWindowMs) {
+        return;
+    }
+    lastStormSweepMs = nowMs;
+    
+    for (auto it = stormStates.begin(); it != stormStates.end();) {
+        const StormState& state = it.value();
+        if (nowMs - state.windowStartMs < stormWindowMs) {
+            ++it;
+            continue;
+        }
+        if (state.suppressed > 0) {
+            const ErrorEntry summary = makeStormSummary(state, nowMs - state.windowStartMs);
+            recordLocked(summary);
+            records.append(summary);
+            --pendingStormSummaries;
+        }
+        // 窗口已结束，下次出现时重新开始计数
+        it = stormStates.erase(it);
     }
+}
+
+ErrorEntry ErrorHandler::makeStormSummary(const StormState& state, qint64 windowMs)
+{
+    ErrorEntry summary = state.lastSuppressed;
+    summary.message = QString("%1（另有 %2 次相同错误，%3 ms 内）")
+                          .arg(state.lastSuppressed.message).arg(state.suppressed).arg(windowMs);
+    summary.handled = false;
+    return summary;
+}
+
+void ErrorHandler::recordLocked(const ErrorEntry& entry)
+{
+    errorQueue.enqueue(entry);
     
-    emit errorReported(entry);
+    // 添加到历史记录
+    errorHistory.append(entry);
+    if (errorHistory.size() > maxHistorySize) {
+        errorHistory.removeFirst();
+    }
+}
+
+void ErrorHandler::countError(ErrorLevel level)
+{
+    CounterSlot* slot = t_counterSlot;
+    if (!slot) {
+        const int index = s_nextCounterSlot.fetch_add(1, std::memory_order_relaxed);
+        slot = &s_counterSlots[qMin(index, System::ERROR_COUNTER_MAX_THREADS - 1)];
+        t_counterSlot = slot;
+    }
+    slot->counts[levelIndex(level)].fetch_add(1, std::memory_order_relaxed);
+}
+
+qint64 ErrorHandler::countedErrors(ErrorLevel level)
+{
+    const int slots = qMin(s_nextCounterSlot.load(std::memory_order_relaxed), System::ERROR_COUNTER_MAX_THREADS);
+    const int index = levelIndex(level);
+    qint64 total = 0;
+    for (int i = 0; i < slots; ++i) {
+        total += s_counterSlots[i].counts[index].load(std::memory_order_relaxed);
+    }
+    return total;
 }
 
 void ErrorHandler::reportInfo(const QString& message, const QString& category)
@@ -124,6 +262,13 @@ void ErrorHandler::setErrorThreshold(ErrorLevel level, int count)
     errorThresholds[level] = count;
 }
 
+void ErrorHandler::setStormSuppression(int burstPerWindow, int windowMs)
+{
+    QMutexLocker locker(&errorMutex);
+    stormBurst = qMax(0, burstPerWindow);
+    stormWindowMs = qMax(1, windowMs);
+}
+
 void ErrorHandler::registerErrorCallback(const QString& name, ErrorCallback callback)
 {
     QMutexLocker locker(&errorMutex);
@@ -138,8 +283,13 @@ void ErrorHandler::unregisterErrorCallback(const QString& name)
 
 int ErrorHandler::getErrorCount(ErrorLevel level) const
 {
-    QMutexLocker locker(&errorMutex);
-    return errorCounts.value(level, 0);
+    const qint64 baseline = countBaselines[levelIndex(level)].load(std::memory_order_relaxed);
+    return static_cast<int>(countedErrors(level) - baseline);
+}
+
+qint64 ErrorHandler::getSuppressedCount() const
+{
+    return suppressedTotal.load(std::memory_order_relaxed);
 }
 
 QList<ErrorEntry> ErrorHandler::getRecentErrors(int count) const
@@ -195,40 +345,46 @@ void ErrorHandler::clearErrorHistory()
     
     errorHistory.clear();
     
-    // 重置错误计数
-    for (auto& count : errorCounts) {
-        count = 0;
+    // 重置错误计数：各线程的槽位只由所属线程累加，这里记下当前值作为新的零点
+    for (int i = 0; i < LEVEL_COUNT; ++i) {
+        countBaselines[i].store(countedErrors(static_cast<ErrorLevel>(i)), std::memory_order_relaxed);
     }
 }
 
 void ErrorHandler::triggerRecovery(const QString& reason)
 {
-    if (recoveryInProgress) {
+    // 各线程可能同时越过阈值，只有一个能开始恢复
+    bool expected = false;
+    if (!recoveryInProgress.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
         qWarning() << "Recovery already in progress";
         return;
     }
     
-    recoveryInProgress = true;
     recoveryAttempts++;
     
     qWarning() << "Triggering recovery:" << reason;
     emit recoveryTriggered(reason);
     
-    // 延迟执行恢复操作
-    recoveryTimer->start(1000);
+    // 延迟执行恢复操作（定时器只能在所属线程启动）
+    QMetaObject::invokeMethod(recoveryTimer, [this]() { recoveryTimer->start(1000); });
 }
 
 void ErrorHandler::processErrorQueue()
 {
+    QList<ErrorEntry> summaries;
     QList<ErrorEntry> entriesToProcess;
     
     {
         QMutexLocker locker(&errorMutex);
+        flushStormSummariesLocked(stormClock.elapsed(), summaries);
         while (!errorQueue.isEmpty()) {
             entriesToProcess.append(errorQueue.dequeue());
         }
     }
     
+    for (const ErrorEntry& summary : summaries) {
+        emit errorReported(summary);
+    }
     for (const ErrorEntry& entry : entriesToProcess) {
         processError(entry);
     }
@@ -241,7 +397,7 @@ void ErrorHandler::checkErrorThresholds()
     for (auto it = errorThresholds.begin(); it != errorThresholds.end(); ++it) {
         ErrorLevel level = it.key();
         int threshold = it.value();
-        int currentCount = errorCounts.value(level, 0);
+        int currentCount = getErrorCount(level);
         
         if (currentCount >= threshold) {
             QString message = QString("Error threshold exceeded for level %1: %2/%3")
@@ -252,7 +408,7 @@ void ErrorHandler::checkErrorThresholds()
             qCritical() << message;
             
             // 触发自动恢复
-            if (autoRecoveryEnabled && !recoveryInProgress) {
+            if (autoRecoveryEnabled && !isRecoveryInProgress()) {
                 triggerRecovery(message);
             }
         }
@@ -268,7 +424,7 @@ void ErrorHandler::performAutoRecovery()
         clearErrorHistory();
         
         // 通知恢复完成
-        recoveryInProgress = false;
+        recoveryInProgress.store(false, std::memory_order_release);
         emit recoveryCompleted(true);
         
         qInfo() << "Auto recovery completed successfully";
@@ -280,13 +436,13 @@ void ErrorHandler::performAutoRecovery()
             // 重试恢复
             recoveryTimer->start(5000); // 5秒后重试
         } else {
-            recoveryInProgress = false;
+            recoveryInProgress.store(false, std::memory_order_release);
             emit recoveryCompleted(false);
             qCritical() << "Auto recovery failed after maximum attempts";
         }
     } catch (...) {
         qCritical() << "Auto recovery failed with unknown error";
-        recoveryInProgress = false;
+        recoveryInProgress.store(false, std::memory_order_release);
         emit recoveryCompleted(false);
     }
 }
@@ -355,7 +511,7 @@ void ErrorHandler::checkCriticalConditions()
     if (totalErrors > maxErrorCount) {
         qCritical() << "Too many errors detected:" << totalErrors;
         
-        if (autoRecoveryEnabled && !recoveryInProgress) {
+        if (autoRecoveryEnabled && !isRecoveryInProgress()) {
             triggerRecovery("Too many errors");
         }
     }
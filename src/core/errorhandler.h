@@ -3,9 +3,12 @@
 #include <QObject>
 #include <QString>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMutex>
 #include <QTimer>
 #include <QQueue>
+#include <atomic>
 #include <functional>
 
 /**
@@ -46,6 +49,10 @@ using ErrorCallback = std::function<void(const ErrorEntry&)>;
  * - 自动恢复机制
  * - 错误通知和回调
  * - 错误历史管理
+ * 
+ * 相同的错误（级别、类别、来源和消息都相同）按窗口限流：每个窗口只完整记录前若干次，
+ * 其余只计数，窗口结束后合并为一条"另有 N 次"的记录，拔线等场景下不会被成千上万条
+ * 重复错误拖垮。错误计数在各线程的槽位上无锁累加，读取时汇总；自动恢复同一时间只运行一个。
  */
 class ErrorHandler : public QObject
 {
@@ -69,13 +76,17 @@ public:
     void setMaxErrorCount(int count) { maxErrorCount = count; }
     void setErrorThreshold(ErrorLevel level, int count);
     void setAutoRecoveryEnabled(bool enabled) { autoRecoveryEnabled = enabled; }
+    // 每个窗口完整记录的相同错误数，0 关闭限流
+    void setStormSuppression(int burstPerWindow, int windowMs);
     
     // 错误回调管理
     void registerErrorCallback(const QString& name, ErrorCallback callback);
     void unregisterErrorCallback(const QString& name);
     
     // 错误统计和查询
+    // 包括被限流合并的错误
     int getErrorCount(ErrorLevel level = ErrorLevel::Error) const;
+    qint64 getSuppressedCount() const;
     QList<ErrorEntry> getRecentErrors(int count = 100) const;
     QList<ErrorEntry> getErrorsByCategory(const QString& category) const;
     
@@ -86,7 +97,7 @@ public:
     
     // 自动恢复
     void triggerRecovery(const QString& reason = QString());
-    bool isRecoveryInProgress() const { return recoveryInProgress; }
+    bool isRecoveryInProgress() const { return recoveryInProgress.load(std::memory_order_acquire); }
     
 signals:
     void errorReported(const ErrorEntry& error);
@@ -104,10 +115,40 @@ private:
     explicit ErrorHandler(QObject* parent = nullptr);
     ~ErrorHandler();
     
+    // 限流状态，键为错误的级别、类别、来源和消息
+    struct StormKey {
+        ErrorLevel level;
+        QString category;
+        QString source;
+        QString message;
+        
+        bool operator==(const StormKey& other) const {
+            return level == other.level && category == other.category
+                   && source == other.source && message == other.message;
+        }
+        friend size_t qHash(const StormKey& key, size_t seed = 0) {
+            return qHashMulti(seed, static_cast<int>(key.level), key.category, key.source, key.message);
+        }
+    };
+    struct StormState {
+        qint64 windowStartMs = 0;
+        int windowCount = 0;
+        int suppressed = 0;             // 本窗口内只计数未记录的次数
+        ErrorEntry lastSuppressed;      // 合并记录沿用最后一次的时间和详情
+    };
+    
+    bool admitLocked(const ErrorEntry& entry, qint64 nowMs, QList<ErrorEntry>& records);
+    void flushStormSummariesLocked(qint64 nowMs, QList<ErrorEntry>& records);
+    static ErrorEntry makeStormSummary(const StormState& state, qint64 windowMs);
+    void recordLocked(const ErrorEntry& entry);
+    
     void processError(const ErrorEntry& error);
     void notifyCallbacks(const ErrorEntry& error);
     void checkCriticalConditions();
     
+    static void countError(ErrorLevel level);
+    static qint64 countedErrors(ErrorLevel level);
+    
     static ErrorHandler* instance;
     static QMutex instanceMutex;
     
@@ -118,8 +159,9 @@ private:
     QTimer* processTimer;
     QTimer* thresholdTimer;
     
-    // 错误统计
-    QMap<ErrorLevel, int> errorCounts;
+    // 错误统计（计数本身在线程槽位上，clearErrorHistory() 只记下基准值）
+    std::atomic<qint64> countBaselines[5];
+    std::atomic<qint64> suppressedTotal;
     QMap<ErrorLevel, int> errorThresholds;
     int maxErrorCount;
     int maxHistorySize;
@@ -127,9 +169,17 @@ private:
     // 错误回调
     QMap<QString, ErrorCallback> errorCallbacks;
     
+    // 错误风暴抑制（受 errorMutex 保护）
+    QHash<StormKey, StormState> stormStates;
+    int stormBurst;
+    int stormWindowMs;
+    int pendingStormSummaries;          // 有未输出合并记录的键数
+    qint64 lastStormSweepMs;
+    QElapsedTimer stormClock;
+    
     // 自动恢复
     bool autoRecoveryEnabled;
-    bool recoveryInProgress;
+    std::atomic<bool> recoveryInProgress;
     QTimer* recoveryTimer;
     int recoveryAttempts;
     int maxRecoveryAttempts;
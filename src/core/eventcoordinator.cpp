@@ -1,10 +1,62 @@
 #include "eventcoordinator.h"
+#include "../constants.h"
+#include "../utils/tracer.h"
+#include "../utils/allocationtracker.h"
+#include "../utils/framelatency.h"
+#include "../utils/monotonicclock.h"
 #include <QDebug>
+#include <QMetaMethod>
+#include <QStringList>
 #include <QTimer>
+#include <atomic>
+#include <climits>
+
+namespace {
+// 主题名称表（进程内共享），ID 从 1 开始依次分配，不回收
+QMutex s_topicsMutex;
+QHash<QString, EventCoordinator::TopicId> s_topicIds;
+QStringList s_topicNames;
+std::atomic<qint64> s_eventIdCounter{0};
+
+QString priorityName(int priority)
+{
+    static const char* const names[] = {"critical", "high", "normal", "low", "background"};
+    return QString::fromLatin1(names[priority]);
+}
+}
 
 EventCoordinator::EventCoordinator(QObject* parent)
     : QObject(parent)
+    , uiManager(nullptr)
+    , businessLogicManager(nullptr)
+    , systemManager(nullptr)
+    , eventHistoryEnabled(false)
+    , maxHistorySize(1000)
+    , eventHistoryWritten(0)
+    , eventSubscribers(std::make_shared<const SubscriberTable>())
+    , maxRetryCount(3)
+    , eventProcessingTimer(nullptr)
+    , eventCleanupTimer(nullptr)
+    , eventTimeoutTimer(nullptr)
+    , eventProcessingEnabled(true)
+    , eventLoggingEnabled(false)
+    , eventProcessingInterval(0)
+    , eventCleanupInterval(0)
+    , eventTimeoutInterval(0)
+    , maxEventQueueSize(System::EVENT_LANE_CAPACITY)
+    , eventExpirationTime(0)
+    , initialized(false)
+    , processingEvents(true)
+    , eventIdCounter(0)
+    , m_drainPosted(0)
+    , m_postedCount(0)
+    , m_droppedCount(0)
+    , m_topicTable(std::make_shared<const TopicTable>())
+    , m_nextSubscriptionId(1)
 {
+    for (auto& lane : m_lanes) {
+        lane.reset(new BoundedMpscQueue<TopicEvent>(System::EVENT_LANE_CAPACITY));
+    }
     qDebug() << "EventCoordinator created";
 }
 
@@ -16,14 +68,222 @@ EventCoordinator::~EventCoordinator()
 
 void EventCoordinator::initialize()
 {
+    initialized = true;
     qDebug() << "EventCoordinator initialized";
 }
 
 void EventCoordinator::shutdown()
 {
+    initialized = false;
     qDebug() << "EventCoordinator shutdown";
 }
 
+EventCoordinator::TopicId EventCoordinator::internTopic(const QString& name)
+{
+    QMutexLocker locker(&s_topicsMutex);
+    auto it = s_topicIds.constFind(name);
+    if (it != s_topicIds.constEnd()) {
+        return it.value();
+    }
+    s_topicNames.append(name);
+    const TopicId topic = static_cast<TopicId>(s_topicNames.size());
+    s_topicIds.insert(name, topic);
+    return topic;
+}
+
+QString EventCoordinator::topicName(TopicId topic)
+{
+    QMutexLocker locker(&s_topicsMutex);
+    return topic > 0 && topic <= static_cast<TopicId>(s_topicNames.size()) ? s_topicNames.at(topic - 1) : QString();
+}
+
+bool EventCoordinator::post(TopicId topic, const QVariant& data, EventPriority priority, EventType type, qint64 receivedNs)
+{
+    TopicEvent event;
+    event.topic = topic;
+    event.type = type;
+    event.priority = priority;
+    event.data = data;
+    event.postedNs = MonotonicClock::nowNs();
+    event.receivedNs = receivedNs;
+    return enqueueTopicEvent(std::move(event));
+}
+
+void EventCoordinator::dispatchEvent(const Event& event)
+{
+    if (!isEventPriorityValid(event.priority)) {
+        emit eventFailed(event, "Invalid event priority");
+        return;
+    }
+    
+    auto legacy = std::make_shared<Event>(event);
+    if (legacy->eventId.isEmpty()) {
+        legacy->eventId = generateEventId();
+    }
+    
+    TopicEvent topicEvent;
+    topicEvent.topic = internTopic(event.action);
+    topicEvent.type = event.type;
+    topicEvent.priority = event.priority;
+    topicEvent.data = event.data;
+    topicEvent.postedNs = MonotonicClock::nowNs();
+    topicEvent.receivedNs = event.receivedNs;
+    topicEvent.legacy = std::move(legacy);
+    
+    if (enqueueTopicEvent(std::move(topicEvent))) {
+        emit eventDispatched(event);
+    } else {
+        emit eventFailed(event, "Event queue full");
+    }
+}
+
+void EventCoordinator::dispatchEvent(EventType type, const QString& source, const QString& target,
+                                     const QString& action, const QVariant& data, EventPriority priority)
+{
+    Event event;
+    event.type = type;
+    event.priority = priority;
+    event.source = source;
+    event.target = target;
+    event.action = action;
+    event.data = data;
+    dispatchEvent(event);
+}
+
+bool EventCoordinator::enqueueTopicEvent(TopicEvent&& event)
+{
+    const int lane = static_cast<int>(event.priority);
+    if (!m_lanes[lane]->tryPush(std::move(event))) {
+        m_droppedCount.fetchAndAddRelaxed(1);
+        return false;
+    }
+    m_postedCount.fetchAndAddRelaxed(1);
+    scheduleDrain();
+    return true;
+}
+
+void EventCoordinator::scheduleDrain()
+{
+    // 与 drainLanes() 的"清除标志后出队"配对：入队对消费者可见后才检查标志
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_drainPosted.loadRelaxed() == 0 && m_drainPosted.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, &EventCoordinator::drainLanes, Qt::QueuedConnection);
+    }
+}
+
+void EventCoordinator::drainLanes()
+{
+    m_drainPosted.storeRelease(0);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!processingEvents) {
+        return;     // startEventProcessing() 会重新投递
+    }
+    
+    std::shared_ptr<const TopicTable> table;
+    {
+        QMutexLocker locker(&m_topicMutex);
+        table = m_topicTable;
+    }
+    
+    // 每次都从最高优先级的通道开始找，分发过程中到达的高优先级事件不会排在低优先级的批次之后
+    int budget = System::EVENT_DISPATCH_BATCH;
+    TopicEvent event;
+    while (budget > 0) {
+        int lane = 0;
+        while (lane < PRIORITY_COUNT && !m_lanes[lane]->tryPop(event)) {
+            ++lane;
+        }
+        if (lane == PRIORITY_COUNT) {
+            return;
+        }
+        deliverTopicEvent(event, *table);
+        m_dispatchedCounts[lane].fetchAndAddRelaxed(1);
+        event = TopicEvent();
+        --budget;
+    }
+    
+    // 本轮用完配额，让事件循环处理其他事件后继续
+    scheduleDrain();
+}
+
+void EventCoordinator::deliverTopicEvent(const TopicEvent& event, const TopicTable& table)
+{
+    const qint64 dispatchNs = eventHistoryEnabled ? MonotonicClock::nowNs() : 0;
+    
+    if (event.legacy) {
+        routeEvent(*event.legacy);
+    } else {
+        // 兼容层的接收者只在有连接或有按类型订阅者时才需要构建字符串事件
+        static const QMetaMethod eventProcessedSignal = QMetaMethod::fromSignal(&EventCoordinator::eventProcessed);
+        if (isSignalConnected(eventProcessedSignal) || hasTypeSubscribers(event.type)) {
+            Event compat;
+            compat.type = event.type;
+            compat.priority = event.priority;
+            compat.action = topicName(event.topic);
+            compat.data = event.data;
+            compat.receivedNs = event.receivedNs;
+            routeEvent(compat);
+        } else {
+            FrameLatencyMonitor::getInstance()->recordSince(FrameLatencyStage::Event, event.receivedNs);
+        }
+    }
+    
+    if (event.topic < static_cast<TopicId>(table.size())) {
+        for (const TopicSubscription& subscription : table.at(event.topic)) {
+            if (subscription.context) {
+                subscription.handler(event);
+            }
+        }
+    }
+    
+    if (eventHistoryEnabled) {
+        addEventToHistory(event, dispatchNs, MonotonicClock::nowNs() - dispatchNs);
+    }
+}
+
+bool EventCoordinator::isEventPriorityValid(EventPriority priority) const
+{
+    const int value = static_cast<int>(priority);
+    return value >= 0 && value < PRIORITY_COUNT;
+}
+
+QString EventCoordinator::generateEventId() const
+{
+    return QString("evt-%1").arg(s_eventIdCounter.fetch_add(1, std::memory_order_relaxed) + 1);
+}
+
+int EventCoordinator::subscribeTopic(TopicId topic, QObject* context, TopicHandler handler)
+{
+    if (topic == 0 || !handler) {
+        return 0;
+    }
+    
+    QMutexLocker locker(&m_topicMutex);
+    auto table = std::make_shared<TopicTable>(*m_topicTable);
+    if (table->size() <= static_cast<int>(topic)) {
+        table->resize(static_cast<int>(topic) + 1);
+    }
+    const int id = m_nextSubscriptionId++;
+    (*table)[topic].append(TopicSubscription{id, QPointer<QObject>(context ? context : this), std::move(handler)});
+    m_topicTable = std::move(table);
+    return id;
+}
+
+void EventCoordinator::unsubscribeTopic(int subscriptionId)
+{
+    QMutexLocker locker(&m_topicMutex);
+    auto table = std::make_shared<TopicTable>(*m_topicTable);
+    for (QVector<TopicSubscription>& subscriptions : *table) {
+        for (int i = 0; i < subscriptions.size(); ++i) {
+            if (subscriptions.at(i).id == subscriptionId) {
+                subscriptions.removeAt(i);
+                m_topicTable = std::move(table);
+                return;
+            }
+        }
+    }
+}
+
 void EventCoordinator::registerUIManager(UIManager* manager)
 {
     uiManager = manager;
@@ -44,6 +304,9 @@ void EventCoordinator::registerSystemManager(SystemManager* manager)
 
 void EventCoordinator::routeEvent(const Event& event)
 {
+    TRACE_SCOPE("event", "EventCoordinator::routeEvent");
+    ALLOCATION_SCOPE("event.route");
+    const qint64 startNs = event.receivedNs > 0 ? MonotonicClock::nowNs() : 0;
     // 按事件类型分发
     switch (event.type) {
     case EventType::UIAction:
@@ -68,6 +331,10 @@ void EventCoordinator::routeEvent(const Event& event)
         emit eventFailed(event, "Unknown event type");
         break;
     }
+    
+    routeToSubscribers(event);
+    
+    FrameLatencyMonitor::getInstance()->recordSince(FrameLatencyStage::Event, startNs);
 }
 
 void EventCoordinator::routeUIEvent(const Event& event)
@@ -89,28 +356,237 @@ void EventCoordinator::routeSystemEvent(const Event& event)
     qDebug() << "System event processed:" << event.eventId;
 }
 
-void EventCoordinator::startEventProcessing() { qDebug() << "Event processing started"; }
-void EventCoordinator::stopEventProcessing() { qDebug() << "Event processing stopped"; }
-void EventCoordinator::clearEventQueue() { qDebug() << "Event queue cleared"; }
-int EventCoordinator::getQueueSize() const { return 0; }
+void EventCoordinator::startEventProcessing()
+{
+    processingEvents = true;
+    scheduleDrain();
+    emit eventProcessingStarted();
+}
+
+void EventCoordinator::stopEventProcessing()
+{
+    // 暂停期间事件继续入队，通道满后丢弃
+    processingEvents = false;
+    emit eventProcessingStopped();
+}
+
+void EventCoordinator::clearEventQueue()
+{
+    // 只在协调器所在线程调用（各通道的唯一消费者）
+    TopicEvent event;
+    for (auto& lane : m_lanes) {
+        while (lane->tryPop(event)) {
+        }
+    }
+    emit eventQueueCleared();
+}
+
+int EventCoordinator::getQueueSize() const
+{
+    int size = 0;
+    for (const auto& lane : m_lanes) {
+        size += lane->sizeApprox();
+    }
+    return size;
+}
+
 QList<EventCoordinator::Event> EventCoordinator::getPendingEvents() const { return {}; }
-void EventCoordinator::enableEventHistory(bool enabled) { Q_UNUSED(enabled); }
-QList<EventCoordinator::Event> EventCoordinator::getEventHistory(int) const { return {}; }
-QList<EventCoordinator::Event> EventCoordinator::getEventHistory(EventType, int) const { return {}; }
-void EventCoordinator::clearEventHistory() { }
-QJsonObject EventCoordinator::getEventStatistics() const { return {}; }
+void EventCoordinator::subscribeToEvents(const QString& subscriber, const QList<EventType>& eventTypes)
+{
+    QMutexLocker locker(&subscriptionMutex);
+    auto table = std::make_shared<SubscriberTable>(*eventSubscribers);
+    int index = table->names.indexOf(subscriber);
+    if (index < 0) {
+        index = table->names.size();
+        table->names.append(subscriber);
+    }
+    for (EventType type : eventTypes) {
+        QVector<int>& subscribers = table->byType[static_cast<int>(type)];
+        if (!subscribers.contains(index)) {
+            subscribers.append(index);
+        }
+    }
+    std::atomic_store(&eventSubscribers, std::shared_ptr<const SubscriberTable>(std::move(table)));
+}
+
+void EventCoordinator::unsubscribeFromEvents(const QString& subscriber, const QList<EventType>& eventTypes)
+{
+    QMutexLocker locker(&subscriptionMutex);
+    const int index = eventSubscribers->names.indexOf(subscriber);
+    if (index < 0) {
+        return;
+    }
+    auto table = std::make_shared<SubscriberTable>(*eventSubscribers);
+    for (EventType type : eventTypes) {
+        table->byType[static_cast<int>(type)].removeAll(index);
+    }
+    std::atomic_store(&eventSubscribers, std::shared_ptr<const SubscriberTable>(std::move(table)));
+}
+
+void EventCoordinator::unsubscribeFromAllEvents(const QString& subscriber)
+{
+    QMutexLocker locker(&subscriptionMutex);
+    const int index = eventSubscribers->names.indexOf(subscriber);
+    if (index < 0) {
+        return;
+    }
+    auto table = std::make_shared<SubscriberTable>(*eventSubscribers);
+    for (QVector<int>& subscribers : table->byType) {
+        subscribers.removeAll(index);
+    }
+    std::atomic_store(&eventSubscribers, std::shared_ptr<const SubscriberTable>(std::move(table)));
+}
+
+std::shared_ptr<const EventCoordinator::SubscriberTable> EventCoordinator::subscriberSnapshot() const
+{
+    return std::atomic_load(&eventSubscribers);
+}
+
+bool EventCoordinator::hasTypeSubscribers(EventType type) const
+{
+    return !subscriberSnapshot()->byType[static_cast<int>(type)].isEmpty();
+}
+
+void EventCoordinator::routeToSubscribers(const Event& event)
+{
+    const std::shared_ptr<const SubscriberTable> table = subscriberSnapshot();
+    for (int index : table->byType[static_cast<int>(event.type)]) {
+        emit subscriberEvent(table->names.at(index), event);
+    }
+}
+
+void EventCoordinator::enableEventHistory(bool enabled)
+{
+    QMutexLocker locker(&eventHistoryMutex);
+    if (enabled && eventHistory.empty()) {
+        eventHistory.resize(static_cast<size_t>(qMax(1, maxHistorySize)));
+        eventHistoryWritten = 0;
+    }
+    eventHistoryEnabled = enabled;
+}
+
+void EventCoordinator::addEventToHistory(const TopicEvent& event, qint64 dispatchNs, qint64 durationNs)
+{
+    EventRecord record;
+    record.postedNs = event.postedNs;
+    record.queueUs = static_cast<qint32>(qBound<qint64>(0, (dispatchNs - event.postedNs) / 1000, INT_MAX));
+    record.durationUs = static_cast<qint32>(qBound<qint64>(0, durationNs / 1000, INT_MAX));
+    record.topic = event.topic;
+    record.type = static_cast<quint8>(event.type);
+    record.priority = static_cast<quint8>(event.priority);
+    record.legacy = event.legacy != nullptr;
+    
+    QMutexLocker locker(&eventHistoryMutex);
+    if (eventHistory.empty()) {
+        return;
+    }
+    eventHistory[eventHistoryWritten % eventHistory.size()] = record;
+    ++eventHistoryWritten;
+}
+
+EventCoordinator::Event EventCoordinator::eventFromRecord(const EventRecord& record) const
+{
+    Event event;
+    event.type = static_cast<EventType>(record.type);
+    event.priority = static_cast<EventPriority>(record.priority);
+    event.action = topicName(record.topic);
+    event.timestampNs = record.postedNs;
+    event.processed = true;
+    return event;
+}
+
+QList<EventCoordinator::Event> EventCoordinator::getEventHistory(int maxCount) const
+{
+    QList<EventRecord> records;
+    {
+        QMutexLocker locker(&eventHistoryMutex);
+        const quint64 available = qMin<quint64>(eventHistoryWritten, eventHistory.size());
+        const quint64 count = qMin<quint64>(available, static_cast<quint64>(qMax(0, maxCount)));
+        records.reserve(static_cast<int>(count));
+        for (quint64 i = eventHistoryWritten - count; i < eventHistoryWritten; ++i) {
+            records.append(eventHistory[i % eventHistory.size()]);
+        }
+    }
+    
+    // 还原为 Event 时查主题名称，放在锁外
+    QList<Event> events;
+    events.reserve(records.size());
+    for (const EventRecord& record : records) {
+        events.append(eventFromRecord(record));
+    }
+    return events;
+}
+
+QList<EventCoordinator::Event> EventCoordinator::getEventHistory(EventType type, int maxCount) const
+{
+    QList<EventRecord> records;
+    {
+        QMutexLocker locker(&eventHistoryMutex);
+        const quint64 available = qMin<quint64>(eventHistoryWritten, eventHistory.size());
+        // 从最新的记录往前找，结果按时间先后排列
+        for (quint64 i = 0; i < available && records.size() < maxCount; ++i) {
+            const EventRecord& record = eventHistory[(eventHistoryWritten - 1 - i) % eventHistory.size()];
+            if (record.type == static_cast<quint8>(type)) {
+                records.prepend(record);
+            }
+        }
+    }
+    
+    QList<Event> events;
+    events.reserve(records.size());
+    for (const EventRecord& record : records) {
+        events.append(eventFromRecord(record));
+    }
+    return events;
+}
+
+void EventCoordinator::clearEventHistory()
+{
+    {
+        QMutexLocker locker(&eventHistoryMutex);
+        eventHistoryWritten = 0;
+    }
+    emit eventHistoryCleared();
+}
+QJsonObject EventCoordinator::getEventStatistics() const
+{
+    QJsonObject lanes;
+    for (int i = 0; i < PRIORITY_COUNT; ++i) {
+        QJsonObject lane;
+        lane["queued"] = m_lanes[i]->sizeApprox();
+        lane["dispatched"] = m_dispatchedCounts[i].loadRelaxed();
+        lanes[priorityName(i)] = lane;
+    }
+    
+    QJsonObject statistics;
+    statistics["posted"] = m_postedCount.loadRelaxed();
+    statistics["dropped"] = m_droppedCount.loadRelaxed();
+    statistics["queueSize"] = getQueueSize();
+    statistics["lanes"] = lanes;
+    return statistics;
+}
+
 int EventCoordinator::getEventCount(EventType) const { return 0; }
-int EventCoordinator::getTotalEventCount() const { return 0; }
+
+int EventCoordinator::getTotalEventCount() const
+{
+    qint64 total = 0;
+    for (const auto& count : m_dispatchedCounts) {
+        total += count.loadRelaxed();
+    }
+    return static_cast<int>(total);
+}
+
 double EventCoordinator::getAverageProcessingTime() const { return 0.0; }
 void EventCoordinator::handleEventError(const Event&, const QString&) { }
 void EventCoordinator::retryFailedEvent(const QString&) { }
 void EventCoordinator::clearFailedEvents() { }
-bool EventCoordinator::isProcessingEvents() const { return false; }
-bool EventCoordinator::isEventHistoryEnabled() const { return false; }
+bool EventCoordinator::isProcessingEvents() const { return processingEvents; }
+bool EventCoordinator::isEventHistoryEnabled() const { return eventHistoryEnabled; }
 int EventCoordinator::getMaxRetryCount() const { return 0; }
 void EventCoordinator::setMaxRetryCount(int) { }
 void EventCoordinator::processNextEvent() { }
-void EventCoordinator::processEventQueue() { }
+void EventCoordinator::processEventQueue() { drainLanes(); }
 void EventCoordinator::handleEventTimeout() { }
 void EventCoordinator::onUIActionTriggered(const QString&, const QVariant&) { }
 void EventCoordinator::onUIStateChanged(const QString&, const QVariant&) { }
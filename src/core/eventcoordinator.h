@@ -6,7 +6,17 @@
 #include <QMutex>
 #include <QTimer>
 #include <QVariant>
+#include <QVector>
+#include <QPointer>
+#include <QAtomicInteger>
 #include <QJsonObject>
+#include <QStringList>
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "../utils/mpscqueue.h"
+#include "../utils/monotonicclock.h"
 
 // 前置声明
 class UIManager;
@@ -22,6 +32,16 @@ class SystemManager;
  * - 事件队列管理
  * - 跨模块通信
  * - 事件历史记录
+ *
+ * 快速路径：主题名称先用 internTopic() 换成整数ID，post() 把事件放入对应优先级的无锁队列
+ * （任意线程调用，不构建字符串和墙钟时间）。协调器所在线程每轮事件循环按优先级从高到低
+ * 批量取出事件，交给 subscribeTopic() 注册的处理函数；每取一个事件之前都先检查更高优先级的通道。
+ * 字符串接口 dispatchEvent() 保留为兼容层：事件以 action 为主题进入同样的通道，
+ * 分发时照旧按类型路由并发出 eventProcessed 信号，同时送达该主题的订阅者。
+ *
+ * 按事件类型的订阅（subscribeToEvents）保存为写时复制的快照：每种类型一个订阅者序号的紧凑数组，
+ * 分发时原子地取一次快照后顺序遍历，不加锁、不复制列表。事件历史是定长环形缓冲区，
+ * 每个事件只记录类型、优先级、主题和耗时，查询时再还原为 Event。
  */
 class EventCoordinator : public QObject
 {
@@ -71,16 +91,37 @@ public:
         QString target;
         QString action;
         QVariant data;
-        QDateTime timestamp;
+        qint64 timestampNs;     // 产生时刻（MonotonicClock::nowNs()），显示时用 dateTime() 换算
         bool processed;
         int retryCount;
         QString eventId;
+        qint64 receivedNs;      // 携带接收帧数据时为帧的读取时刻（ProtocolFrame::receivedNs），否则为 0
         
         Event() : type(EventType::Custom), priority(EventPriority::Normal), 
-                 processed(false), retryCount(0) {
-            timestamp = QDateTime::currentDateTime();
-        }
+                 timestampNs(MonotonicClock::nowNs()), processed(false), retryCount(0), receivedNs(0) {}
+        
+        QDateTime dateTime() const { return MonotonicClock::dateTimeAt(timestampNs); }
+    };
+    
+    static constexpr int PRIORITY_COUNT = static_cast<int>(EventPriority::Background) + 1;
+    static constexpr int EVENT_TYPE_COUNT = static_cast<int>(EventType::Custom) + 1;
+    
+    // 主题ID，进程内唯一，0 表示无效
+    using TopicId = quint32;
+    
+    // 快速路径的事件，时间为 MonotonicClock::nowNs()
+    struct TopicEvent {
+        TopicId topic = 0;
+        EventType type = EventType::Custom;
+        EventPriority priority = EventPriority::Normal;
+        QVariant data;
+        qint64 postedNs = 0;
+        qint64 receivedNs = 0;                  // 含义同 Event::receivedNs
+        std::shared_ptr<const Event> legacy;    // 经字符串接口分发时的原始事件
     };
+    
+    // 在协调器所在线程调用
+    using TopicHandler = std::function<void(const TopicEvent& event)>;
 
 public:
     explicit EventCoordinator(QObject* parent = nullptr);
@@ -95,7 +136,19 @@ public:
     void registerBusinessLogicManager(BusinessLogicManager* manager);
     void registerSystemManager(SystemManager* manager);
     
-    // 事件分发
+    // 主题注册（任意线程）：同名返回同一ID
+    static TopicId internTopic(const QString& name);
+    static QString topicName(TopicId topic);
+    
+    // 快速路径分发（任意线程）：通道满时丢弃并返回 false
+    bool post(TopicId topic, const QVariant& data = QVariant(), EventPriority priority = EventPriority::Normal,
+              EventType type = EventType::Custom, qint64 receivedNs = 0);
+    
+    // 订阅主题（任意线程），context 销毁后自动不再调用；返回订阅ID
+    int subscribeTopic(TopicId topic, QObject* context, TopicHandler handler);
+    void unsubscribeTopic(int subscriptionId);
+    
+    // 事件分发（兼容层）
     void dispatchEvent(const Event& event);
     void dispatchEvent(EventType type, const QString& source, const QString& target, 
                       const QString& action, const QVariant& data = QVariant(),
@@ -148,6 +201,9 @@ public slots:
     void processEventQueue();
     void handleEventTimeout();
     
+    // 按优先级批量分发各通道中的事件（协调器所在线程）
+    void drainLanes();
+    
     // UI事件处理
     void onUIActionTriggered(const QString& action, const QVariant& data = QVariant());
     void onUIStateChanged(const QString& state, const QVariant& data = QVariant());
@@ -176,6 +232,8 @@ signals:
     void eventProcessed(const Event& event);
     void eventFailed(const Event& event, const QString& error);
     void eventRetried(const Event& event);
+    // 按类型订阅的订阅者收到的事件（subscribeToEvents），每个订阅者各发一次
+    void subscriberEvent(const QString& subscriber, const Event& event);
     
     // UI事件信号
     void uiActionEvent(const QString& action, const QVariant& data);
@@ -211,7 +269,7 @@ private:
     void setupEventRouting();
     void setupEventTimers();
     void processEvent(const Event& event);
-    void addEventToHistory(const Event& event);
+    void addEventToHistory(const TopicEvent& event, qint64 dispatchNs, qint64 durationNs);
     void updateEventStatistics(const Event& event);
     void cleanupExpiredEvents();
     
@@ -235,6 +293,38 @@ private:
     // 生成事件ID
     QString generateEventId() const;
     
+    // 快速路径内部方法
+    struct TopicSubscription {
+        int id;
+        QPointer<QObject> context;
+        TopicHandler handler;
+    };
+    using TopicTable = QVector<QVector<TopicSubscription>>;    // 以主题ID为下标
+    
+    bool enqueueTopicEvent(TopicEvent&& event);
+    void scheduleDrain();
+    void deliverTopicEvent(const TopicEvent& event, const TopicTable& table);
+    
+    // 按类型订阅的快照：订阅者序号分配后不变，取消订阅只从各类型的数组中移除
+    struct SubscriberTable {
+        QStringList names;                                  // 下标为订阅者序号
+        std::array<QVector<int>, EVENT_TYPE_COUNT> byType;  // 每种事件类型的订阅者序号
+    };
+    std::shared_ptr<const SubscriberTable> subscriberSnapshot() const;
+    bool hasTypeSubscribers(EventType type) const;
+    
+    // 事件历史的紧凑记录（32字节）
+    struct EventRecord {
+        qint64 postedNs;        // 入队时刻
+        qint32 queueUs;         // 在通道中等待的时间
+        qint32 durationUs;      // 路由和处理函数耗时
+        TopicId topic;
+        quint8 type;
+        quint8 priority;
+        bool legacy;            // 经字符串接口分发
+    };
+    Event eventFromRecord(const EventRecord& record) const;
+    
     // 管理器引用
     UIManager* uiManager;
     BusinessLogicManager* businessLogicManager;
@@ -244,14 +334,15 @@ private:
     QQueue<Event> eventQueue;
     QMutex eventQueueMutex;
     
-    // 事件历史
-    QList<Event> eventHistory;
-    QMutex eventHistoryMutex;
+    // 事件历史（定长环形缓冲区，只在协调器所在线程写入）
+    std::vector<EventRecord> eventHistory;
+    mutable QMutex eventHistoryMutex;
     bool eventHistoryEnabled;
     int maxHistorySize;
+    quint64 eventHistoryWritten;        // 累计写入的记录数，下一条写在 written % 容量
     
-    // 事件订阅
-    QHash<QString, QList<EventType>> eventSubscriptions;
+    // 事件订阅（写时复制，修改时持有 subscriptionMutex，读取用 std::atomic_load）
+    std::shared_ptr<const SubscriberTable> eventSubscribers;
     QMutex subscriptionMutex;
     
     // 失败事件管理
@@ -287,4 +378,16 @@ private:
     bool initialized;
     bool processingEvents;
     qint64 eventIdCounter;
+    
+    // 快速路径：每个优先级一个多生产者单消费者队列，消费者为协调器所在线程
+    std::array<std::unique_ptr<BoundedMpscQueue<TopicEvent>>, PRIORITY_COUNT> m_lanes;
+    QAtomicInt m_drainPosted;                       // 1 表示已投递 drainLanes、尚未开始执行
+    QAtomicInteger<qint64> m_postedCount;
+    QAtomicInteger<qint64> m_droppedCount;
+    std::array<QAtomicInteger<qint64>, PRIORITY_COUNT> m_dispatchedCounts;
+    
+    // 订阅表写时复制：分发时每轮只取一次快照，不持锁调用处理函数
+    QMutex m_topicMutex;
+    std::shared_ptr<const TopicTable> m_topicTable;
+    int m_nextSubscriptionId;
 }; 
\ No newline at end of file
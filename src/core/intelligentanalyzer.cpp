@@ -1,4 +1,7 @@
 #include "intelligentanalyzer.h"
+#include "../constants.h"
+#include "memoryoptimizer.h"
+#include "../utils/numerickernels.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QFile>
@@ -9,8 +12,45 @@
 #include <algorithm>
 #include <numeric>
 
+namespace {
+
+struct MetricDescriptor {
+    const char* name;
+    double IntelligentAnalyzer::DataPoint::* field;
+    bool anomalyChecked;        // 综合评分不做异常检测
+};
+
+// 指标表，m_metricStreams 按此顺序存放
+const MetricDescriptor METRICS[] = {
+    {"cpu", &IntelligentAnalyzer::DataPoint::cpuUsage, true},
+    {"memory", &IntelligentAnalyzer::DataPoint::memoryUsage, true},
+    {"database", &IntelligentAnalyzer::DataPoint::dbResponseTime, true},
+    {"ui", &IntelligentAnalyzer::DataPoint::uiResponseTime, true},
+    {"communication", &IntelligentAnalyzer::DataPoint::communicationLatency, true},
+    {"performance", &IntelligentAnalyzer::DataPoint::performanceScore, false},
+};
+constexpr int METRIC_COUNT = static_cast<int>(sizeof(METRICS) / sizeof(METRICS[0]));
+
+// 历史数据的列：各指标按指标表顺序，最后一列是错误计数
+constexpr int ERROR_COUNT_COLUMN = METRIC_COUNT;
+constexpr int HISTORY_COLUMN_COUNT = METRIC_COUNT + 1;
+
+int metricIndex(const QString& metric)
+{
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        if (metric == QLatin1String(METRICS[i].name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
 IntelligentAnalyzer::IntelligentAnalyzer(QObject *parent)
     : QObject(parent)
+    , m_history(HISTORY_COLUMN_COUNT, System::ANALYZER_HISTORY_MEMORY_LIMIT,
+                System::ANALYZER_HISTORY_TIERS, System::ANALYZER_HISTORY_DOWNSAMPLE_FACTOR)
     , m_learningRate(0.1)
     , m_windowSize(20)
     , m_sensitivityThreshold(2.0)
@@ -23,9 +63,18 @@ IntelligentAnalyzer::IntelligentAnalyzer(QObject *parent)
     , m_anomaliesDetected(0)
     , m_recommendationsGenerated(0)
 {
+    const SlidingWindowStatistics window(m_maxHistorySize, m_windowSize,
+                                         System::ANALYZER_SEASONAL_LAG, System::ANALYZER_EWMA_ALPHA);
+    m_metricStreams.reserve(METRIC_COUNT);
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        m_metricStreams.emplace_back(window);
+    }
+    
     // 连接定时器
     connect(m_analysisTimer, &QTimer::timeout, this, &IntelligentAnalyzer::performPeriodicAnalysis);
     
+    reportHistoryMemory();
+    
     qDebug() << "[IntelligentAnalyzer] 智能性能分析器已创建";
 }
 
@@ -60,15 +109,18 @@ void IntelligentAnalyzer::addDataPoint(const DataPoint& dataPoint)
 {
     QMutexLocker locker(&m_dataMutex);
     
-    m_dataHistory.append(dataPoint);
-    
-    // 限制历史数据大小
-    while (m_dataHistory.size() > m_maxHistorySize) {
-        m_dataHistory.removeFirst();
+    // 写入列式历史，原始层写满后较旧的数据逐层降采样，不需要裁剪
+    double values[HISTORY_COLUMN_COUNT];
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        values[i] = dataPoint.*METRICS[i].field;
     }
+    values[ERROR_COUNT_COLUMN] = dataPoint.errorCount;
+    const QDateTime timestamp = dataPoint.timestamp.isValid() ? dataPoint.timestamp : QDateTime::currentDateTime();
+    m_history.append(timestamp.toMSecsSinceEpoch(), values);
+    updateMetricStreams(dataPoint);
     
     // 如果数据足够，触发在线学习
-    if (m_dataHistory.size() >= m_windowSize && m_isRunning) {
+    if (m_history.size() >= m_windowSize && m_isRunning) {
         // 简单的在线学习：更新模型参数
         updateModelOnline(dataPoint);
     }
@@ -77,63 +129,43 @@ void IntelligentAnalyzer::addDataPoint(const DataPoint& dataPoint)
 QList<IntelligentAnalyzer::TrendAnalysis> IntelligentAnalyzer::analyzeTrends(const QString& metric) const
 {
     QMutexLocker locker(&m_dataMutex);
+    return analyzeTrendsLocked(metric);
+}
+
+QList<IntelligentAnalyzer::TrendAnalysis> IntelligentAnalyzer::analyzeTrendsLocked(const QString& metric) const
+{
     QList<TrendAnalysis> trends;
     
-    if (m_dataHistory.size() < m_windowSize) {
+    if (m_history.size() < m_windowSize) {
         return trends;
     }
     
     // 分析各个指标的趋势
-    QStringList metrics = {"cpu", "memory", "database", "ui", "communication", "performance"};
-    
-    if (!metric.isEmpty()) {
-        metrics = {metric};
+    const int requested = metric.isEmpty() ? -1 : metricIndex(metric);
+    if (!metric.isEmpty() && requested < 0) {
+        return trends;
     }
     
-    for (const QString& metricName : metrics) {
-        QVector<double> values;
-        QVector<double> timePoints;
-        
-        // 提取指标数据
-        for (int i = 0; i < m_dataHistory.size(); ++i) {
-            const auto& point = m_dataHistory[i];
-            double value = 0.0;
-            
-            if (metricName == "cpu") {
-                value = point.cpuUsage;
-            } else if (metricName == "memory") {
-                value = point.memoryUsage;
-            } else if (metricName == "database") {
-                value = point.dbResponseTime;
-            } else if (metricName == "ui") {
-                value = point.uiResponseTime;
-            } else if (metricName == "communication") {
-                value = point.communicationLatency;
-            } else if (metricName == "performance") {
-                value = point.performanceScore;
-            }
-            
-            values.append(value);
-            timePoints.append(i);
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        if (requested >= 0 && i != requested) {
+            continue;
         }
+        const QString metricName = QLatin1String(METRICS[i].name);
+        const SlidingWindowStatistics& statistics = m_metricStreams[i].statistics;
         
-        // 计算线性回归
-        auto regression = calculateLinearRegression(timePoints, values);
-        double slope = regression.first;
-        double intercept = regression.second;
-        
-        // 计算置信度
-        double confidence = calculateTrendConfidence(values, slope, intercept);
+        // 窗口内的线性回归，时间点为 0..n-1
+        const auto regression = statistics.linearTrend();
+        const double slope = regression.slope;
         
         // 预测下一个值
-        double predictedValue = slope * m_dataHistory.size() + intercept;
+        double predictedValue = slope * statistics.size() + regression.intercept;
         
         TrendAnalysis trend;
         trend.metric = metricName;
-        trend.currentValue = values.last();
+        trend.currentValue = statistics.last();
         trend.predictedValue = predictedValue;
-        trend.trend = qBound(-1.0, slope / qMax(1.0, qAbs(values.last())), 1.0);
-        trend.confidence = confidence;
+        trend.trend = qBound(-1.0, slope / qMax(1.0, qAbs(statistics.last())), 1.0);
+        trend.confidence = calculateTrendConfidence(slope);
         trend.interpretation = interpretTrend(trend.trend, metricName);
         
         trends.append(trend);
@@ -145,39 +177,22 @@ QList<IntelligentAnalyzer::TrendAnalysis> IntelligentAnalyzer::analyzeTrends(con
 QList<IntelligentAnalyzer::AnomalyDetection> IntelligentAnalyzer::detectAnomalies() const
 {
     QMutexLocker locker(&m_dataMutex);
+    return detectAnomaliesLocked();
+}
+
+QList<IntelligentAnalyzer::AnomalyDetection> IntelligentAnalyzer::detectAnomaliesLocked() const
+{
     QList<AnomalyDetection> anomalies;
     
-    if (m_dataHistory.size() < m_windowSize) {
+    if (m_history.size() < m_windowSize) {
         return anomalies;
     }
     
-    // 检测各个指标的异常
-    QStringList metrics = {"cpu", "memory", "database", "ui", "communication"};
-    
-    for (const QString& metricName : metrics) {
-        QVector<double> values;
-        
-        // 提取指标数据
-        for (const auto& point : m_dataHistory) {
-            double value = 0.0;
-            
-            if (metricName == "cpu") {
-                value = point.cpuUsage;
-            } else if (metricName == "memory") {
-                value = point.memoryUsage;
-            } else if (metricName == "database") {
-                value = point.dbResponseTime;
-            } else if (metricName == "ui") {
-                value = point.uiResponseTime;
-            } else if (metricName == "communication") {
-                value = point.communicationLatency;
-            }
-            
-            values.append(value);
+    // 异常点在数据到达时已判定，这里只收集仍在窗口内的
+    for (const MetricStream& stream : m_metricStreams) {
+        for (const auto& flagged : stream.anomalies) {
+            anomalies.append(flagged.anomaly);
         }
-        
-        auto metricAnomalies = detectMetricAnomalies(values, metricName);
-        anomalies.append(metricAnomalies);
     }
     
     return anomalies;
@@ -185,16 +200,16 @@ QList<IntelligentAnalyzer::AnomalyDetection> IntelligentAnalyzer::detectAnomalie
 
 QList<IntelligentAnalyzer::IntelligentRecommendation> IntelligentAnalyzer::generateIntelligentRecommendations() const
 {
+    QMutexLocker locker(&m_dataMutex);
     QList<IntelligentRecommendation> recommendations;
     
-    if (m_dataHistory.isEmpty()) {
+    if (m_history.isEmpty()) {
         return recommendations;
     }
     
     // 获取当前性能状态
-    auto currentData = m_dataHistory.last();
-    auto trends = analyzeTrends();
-    auto anomalies = detectAnomalies();
+    auto trends = analyzeTrendsLocked(QString());
+    auto anomalies = detectAnomaliesLocked();
     
     // 基于趋势生成建议
     for (const auto& trend : trends) {
@@ -251,7 +266,7 @@ IntelligentAnalyzer::PerformancePrediction IntelligentAnalyzer::predictPerforman
     QMutexLocker locker(&m_dataMutex);
     PerformancePrediction prediction;
     
-    if (m_dataHistory.size() < m_windowSize) {
+    if (m_history.size() < m_windowSize) {
         prediction.confidence = 0.0;
         return prediction;
     }
@@ -261,12 +276,14 @@ IntelligentAnalyzer::PerformancePrediction IntelligentAnalyzer::predictPerforman
     // 使用指数平滑和趋势分析进行预测
     int predictionPoints = hoursAhead * 12; // 每小时12个数据点（5分钟间隔）
     
+    // 趋势只取一次，各预测点共用
+    const auto trends = analyzeTrendsLocked(QString());
+    
     for (int i = 0; i < predictionPoints; ++i) {
-        DataPoint predictedPoint;
+        DataPoint predictedPoint{};
         predictedPoint.timestamp = QDateTime::currentDateTime().addSecs(i * 300); // 5分钟间隔
         
         // 基于历史趋势预测各个指标
-        auto trends = analyzeTrends();
         for (const auto& trend : trends) {
             double predictedValue = trend.currentValue + trend.trend * trend.currentValue * (i + 1) * 0.01;
             
@@ -307,11 +324,13 @@ IntelligentAnalyzer::PerformancePrediction IntelligentAnalyzer::predictPerforman
 
 double IntelligentAnalyzer::calculateHealthScore() const
 {
-    if (m_dataHistory.isEmpty()) {
+    QMutexLocker locker(&m_dataMutex);
+    
+    if (m_history.isEmpty()) {
         return 0.0;
     }
     
-    auto currentData = m_dataHistory.last();
+    const DataPoint currentData = latestDataPoint();
     
     // 计算各个维度的健康度
     double cpuHealth = qMax(0.0, 100.0 - currentData.cpuUsage);
@@ -323,7 +342,7 @@ double IntelligentAnalyzer::calculateHealthScore() const
     
     // 趋势健康度
     double trendHealth = 100.0;
-    auto trends = analyzeTrends();
+    auto trends = analyzeTrendsLocked(QString());
     for (const auto& trend : trends) {
         if (trend.trend > 0.1 && (trend.metric == "cpu" || trend.metric == "memory" || 
                                  trend.metric == "database" || trend.metric == "ui" || 
@@ -335,7 +354,7 @@ double IntelligentAnalyzer::calculateHealthScore() const
     
     // 异常健康度
     double anomalyHealth = 100.0;
-    auto anomalies = detectAnomalies();
+    auto anomalies = detectAnomaliesLocked();
     for (const auto& anomaly : anomalies) {
         anomalyHealth -= anomaly.severity * 15.0;
     }
@@ -355,7 +374,7 @@ QJsonObject IntelligentAnalyzer::getPerformanceInsights() const
     
     // 基本统计
     insights["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    insights["data_points"] = m_dataHistory.size();
+    insights["data_points"] = m_history.size();
     insights["health_score"] = calculateHealthScore();
     insights["model_trained"] = m_modelTrained;
     
@@ -384,6 +403,40 @@ QJsonObject IntelligentAnalyzer::getPerformanceInsights() const
     }
     insights["anomalies"] = anomaliesArray;
     
+    // 流式统计的当前状态
+    {
+        QMutexLocker locker(&m_dataMutex);
+        QJsonObject streaming;
+        for (int i = 0; i < METRIC_COUNT; ++i) {
+            const SlidingWindowStatistics& statistics = m_metricStreams[i].statistics;
+            QJsonObject metricObj;
+            metricObj["mean"] = statistics.mean();
+            metricObj["stddev"] = statistics.stdDeviation();
+            metricObj["moving_average"] = statistics.movingAverage();
+            metricObj["ewma"] = statistics.ewma();
+            metricObj["seasonality"] = statistics.autocorrelation();
+            streaming[QLatin1String(METRICS[i].name)] = metricObj;
+        }
+        insights["streaming"] = streaming;
+        
+        QJsonObject history;
+        QJsonArray tiers;
+        for (int tier = 0; tier < m_history.tierCount(); ++tier) {
+            QJsonObject tierObj;
+            tierObj["points"] = m_history.size(tier);
+            tierObj["capacity"] = m_history.capacity(tier);
+            if (m_history.size(tier) > 0) {
+                tierObj["oldest"] = QDateTime::fromMSecsSinceEpoch(m_history.timestamp(tier, 0)).toString(Qt::ISODate);
+            }
+            tiers.append(tierObj);
+        }
+        history["tiers"] = tiers;
+        history["downsample_factor"] = m_history.downsampleFactor();
+        history["memory_usage"] = m_history.memoryUsage();
+        history["memory_limit"] = m_history.memoryLimit();
+        insights["history"] = history;
+    }
+    
     // 相关性分析
     insights["correlations"] = calculateCorrelationMatrix();
     
@@ -406,11 +459,33 @@ QJsonObject IntelligentAnalyzer::getPerformanceInsights() const
     return insights;
 }
 
+void IntelligentAnalyzer::setHistoryMemoryLimit(qint64 bytes)
+{
+    {
+        QMutexLocker locker(&m_dataMutex);
+        m_history.setMemoryLimit(bytes);
+    }
+    reportHistoryMemory();
+    
+    qDebug() << "[IntelligentAnalyzer] 历史数据内存上限:" << bytes << "字节，每层容量:" << m_history.capacity();
+}
+
+qint64 IntelligentAnalyzer::historyMemoryUsage() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_history.memoryUsage();
+}
+
 void IntelligentAnalyzer::setLearningParameters(double learningRate, int windowSize, double sensitivityThreshold)
 {
+    QMutexLocker locker(&m_dataMutex);
+    
     m_learningRate = learningRate;
     m_windowSize = windowSize;
     m_sensitivityThreshold = sensitivityThreshold;
+    for (MetricStream& stream : m_metricStreams) {
+        stream.statistics.setShortWindow(m_windowSize);
+    }
     
     // 更新模型参数
     m_modelParameters["learning_rate"] = m_learningRate;
@@ -426,7 +501,7 @@ bool IntelligentAnalyzer::trainModel()
 {
     QMutexLocker locker(&m_dataMutex);
     
-    if (m_dataHistory.size() < m_windowSize * 2) {
+    if (m_history.size() < m_windowSize * 2) {
         qWarning() << "[IntelligentAnalyzer] 训练数据不足";
         return false;
     }
@@ -435,56 +510,30 @@ bool IntelligentAnalyzer::trainModel()
     QJsonObject modelData;
     
     // 计算各指标的均值和标准差
-    QStringList metrics = {"cpu", "memory", "database", "ui", "communication", "performance"};
+    QVector<double> values(m_history.size());
     
-    for (const QString& metric : metrics) {
-        QVector<double> values;
-        
-        for (const auto& point : m_dataHistory) {
-            double value = 0.0;
-            
-            if (metric == "cpu") {
-                value = point.cpuUsage;
-            } else if (metric == "memory") {
-                value = point.memoryUsage;
-            } else if (metric == "database") {
-                value = point.dbResponseTime;
-            } else if (metric == "ui") {
-                value = point.uiResponseTime;
-            } else if (metric == "communication") {
-                value = point.communicationLatency;
-            } else if (metric == "performance") {
-                value = point.performanceScore;
-            }
-            
-            values.append(value);
-        }
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        m_history.copyColumn(0, i, values.data());
         
         // 计算统计特征
-        double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
-        double variance = 0.0;
-        for (double value : values) {
-            variance += (value - mean) * (value - mean);
-        }
-        variance /= values.size();
-        double stddev = qSqrt(variance);
+        const auto moments = NumericKernels::moments(values.constData(), values.size());
         
         QJsonObject metricStats;
-        metricStats["mean"] = mean;
-        metricStats["stddev"] = stddev;
-        metricStats["min"] = *std::min_element(values.begin(), values.end());
-        metricStats["max"] = *std::max_element(values.begin(), values.end());
+        metricStats["mean"] = moments.mean;
+        metricStats["stddev"] = qSqrt(moments.variance);
+        metricStats["min"] = moments.minimum;
+        metricStats["max"] = moments.maximum;
         
-        modelData[metric] = metricStats;
+        modelData[QLatin1String(METRICS[i].name)] = metricStats;
     }
     
     m_modelParameters["model_data"] = modelData;
     m_modelParameters["trained_at"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    m_modelParameters["training_samples"] = m_dataHistory.size();
+    m_modelParameters["training_samples"] = m_history.size();
     
     m_modelTrained = true;
     
-    qDebug() << "[IntelligentAnalyzer] 模型训练完成，样本数:" << m_dataHistory.size();
+    qDebug() << "[IntelligentAnalyzer] 模型训练完成，样本数:" << m_history.size();
     
     return true;
 }
@@ -529,7 +578,11 @@ bool IntelligentAnalyzer::loadModel(const QString& filePath)
         m_learningRate = m_modelParameters["learning_rate"].toDouble();
     }
     if (m_modelParameters.contains("window_size")) {
+        QMutexLocker locker(&m_dataMutex);
         m_windowSize = m_modelParameters["window_size"].toInt();
+        for (MetricStream& stream : m_metricStreams) {
+            stream.statistics.setShortWindow(m_windowSize);
+        }
     }
     if (m_modelParameters.contains("sensitivity_threshold")) {
         m_sensitivityThreshold = m_modelParameters["sensitivity_threshold"].toDouble();
@@ -569,7 +622,11 @@ void IntelligentAnalyzer::resetLearningData()
 {
     QMutexLocker locker(&m_dataMutex);
     
-    m_dataHistory.clear();
+    m_history.clear();
+    for (MetricStream& stream : m_metricStreams) {
+        stream.statistics.clear();
+        stream.anomalies.clear();
+    }
     m_modelTrained = false;
     m_modelParameters = QJsonObject();
     
@@ -615,7 +672,7 @@ void IntelligentAnalyzer::performPeriodicAnalysis()
     emit healthScoreUpdated(newHealthScore, healthTrend);
     
     // 如果数据足够且模型未训练，尝试训练
-    if (!m_modelTrained && m_dataHistory.size() >= m_windowSize * 3) {
+    if (!m_modelTrained && m_history.size() >= m_windowSize * 3) {
         trainModel();
     }
     
@@ -625,20 +682,10 @@ void IntelligentAnalyzer::performPeriodicAnalysis()
 // 私有辅助方法的实现
 QVector<double> IntelligentAnalyzer::calculateMovingAverage(const QVector<double>& values, int windowSize) const
 {
-    QVector<double> result;
+    QVector<double> result(values.size());
     
-    for (int i = 0; i < values.size(); ++i) {
-        int start = qMax(0, i - windowSize + 1);
-        double sum = 0.0;
-        int count = 0;
-        
-        for (int j = start; j <= i; ++j) {
-            sum += values[j];
-            count++;
-        }
-        
-        result.append(sum / count);
-    }
+    // 滑动窗口和，O(n)，与窗口大小无关
+    NumericKernels::movingAverage(values.constData(), values.size(), windowSize, result.data());
     
     return result;
 }
@@ -649,76 +696,76 @@ QPair<double, double> IntelligentAnalyzer::calculateLinearRegression(const QVect
         return {0.0, 0.0};
     }
     
-    double sumX = std::accumulate(x.begin(), x.end(), 0.0);
-    double sumY = std::accumulate(y.begin(), y.end(), 0.0);
-    double sumXY = 0.0;
-    double sumXX = 0.0;
+    // x 全部相同时斜率为 0（原先会除以 0）
+    const auto fit = NumericKernels::linearFit(x.constData(), y.constData(), x.size());
     
-    for (int i = 0; i < x.size(); ++i) {
-        sumXY += x[i] * y[i];
-        sumXX += x[i] * x[i];
+    return {fit.slope, fit.intercept};
+}
+
+IntelligentAnalyzer::DataPoint IntelligentAnalyzer::latestDataPoint() const
+{
+    DataPoint point{};
+    point.timestamp = QDateTime::fromMSecsSinceEpoch(m_history.latestTimestamp());
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        point.*METRICS[i].field = m_history.latest(i);
     }
-    
-    int n = x.size();
-    double slope = (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
-    double intercept = (sumY - slope * sumX) / n;
-    
-    return {slope, intercept};
+    point.errorCount = static_cast<int>(m_history.latest(ERROR_COUNT_COLUMN));
+    return point;
 }
 
-QList<IntelligentAnalyzer::AnomalyDetection> IntelligentAnalyzer::detectMetricAnomalies(const QVector<double>& values, const QString& metricName) const
+void IntelligentAnalyzer::reportHistoryMemory() const
 {
-    QList<AnomalyDetection> anomalies;
-    
-    if (values.size() < m_windowSize) {
-        return anomalies;
+    qint64 usage = 0;
+    qint64 limit = 0;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        usage = m_history.memoryUsage();
+        limit = m_history.memoryLimit();
     }
-    
-    // 使用Z-Score方法检测异常
-    auto zScores = calculateZScore(values);
-    
-    for (int i = 0; i < zScores.size(); ++i) {
-        if (qAbs(zScores[i]) > m_sensitivityThreshold) {
-            AnomalyDetection anomaly;
-            anomaly.metric = metricName;
-            anomaly.value = values[i];
-            anomaly.threshold = m_sensitivityThreshold;
-            anomaly.severity = qMin(1.0, qAbs(zScores[i]) / (m_sensitivityThreshold * 2));
-            anomaly.description = QString("%1指标异常: 值=%2, Z-Score=%3")
-                                 .arg(metricName).arg(values[i], 0, 'f', 2).arg(zScores[i], 0, 'f', 2);
-            anomaly.detectedAt = QDateTime::currentDateTime();
-            
-            anomalies.append(anomaly);
+    MemoryOptimizer::getInstance()->reportComponentMemory("IntelligentAnalyzer", usage, limit);
+}
+
+void IntelligentAnalyzer::updateMetricStreams(const DataPoint& dataPoint)
+{
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        MetricStream& stream = m_metricStreams[i];
+        SlidingWindowStatistics& statistics = stream.statistics;
+        const double value = dataPoint.*METRICS[i].field;
+        
+        // 移出窗口的数据点不再报告
+        const qint64 sequence = statistics.totalCount();
+        while (!stream.anomalies.isEmpty() && stream.anomalies.first().sequence <= sequence - statistics.capacity()) {
+            stream.anomalies.removeFirst();
+        }
+        
+        // 使用Z-Score方法检测异常，与加入该点之前的窗口比较
+        if (METRICS[i].anomalyChecked && statistics.size() >= m_windowSize) {
+            const double zScore = statistics.zScore(value);
+            if (qAbs(zScore) > m_sensitivityThreshold) {
+                const QString metricName = QLatin1String(METRICS[i].name);
+                AnomalyDetection anomaly;
+                anomaly.metric = metricName;
+                anomaly.value = value;
+                anomaly.threshold = m_sensitivityThreshold;
+                anomaly.severity = qMin(1.0, qAbs(zScore) / (m_sensitivityThreshold * 2));
+                anomaly.description = QString("%1指标异常: 值=%2, Z-Score=%3")
+                                     .arg(metricName).arg(value, 0, 'f', 2).arg(zScore, 0, 'f', 2);
+                anomaly.detectedAt = dataPoint.timestamp.isValid() ? dataPoint.timestamp : QDateTime::currentDateTime();
+                
+                stream.anomalies.append({sequence, anomaly});
+            }
         }
+        
+        statistics.add(value);
     }
-    
-    return anomalies;
 }
 
 QVector<double> IntelligentAnalyzer::calculateZScore(const QVector<double>& values) const
 {
-    QVector<double> zScores;
-    
-    if (values.isEmpty()) {
-        return zScores;
-    }
+    QVector<double> zScores(values.size());
     
-    // 计算均值
-    double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
-    
-    // 计算标准差
-    double variance = 0.0;
-    for (double value : values) {
-        variance += (value - mean) * (value - mean);
-    }
-    variance /= values.size();
-    double stddev = qSqrt(variance);
-    
-    // 计算Z-Score
-    for (double value : values) {
-        double zScore = stddev > 0 ? (value - mean) / stddev : 0.0;
-        zScores.append(zScore);
-    }
+    // 标准差为 0 时全部为 0
+    NumericKernels::zScores(values.constData(), values.size(), zScores.data());
     
     return zScores;
 }
@@ -769,11 +816,13 @@ QStringList IntelligentAnalyzer::identifyBottlenecks() const
 {
     QStringList bottlenecks;
     
-    if (m_dataHistory.isEmpty()) {
+    QMutexLocker locker(&m_dataMutex);
+    
+    if (m_history.isEmpty()) {
         return bottlenecks;
     }
     
-    auto currentData = m_dataHistory.last();
+    const DataPoint currentData = latestDataPoint();
     
     // 简单的瓶颈识别逻辑
     if (currentData.cpuUsage > 80.0) {
@@ -790,7 +839,7 @@ QStringList IntelligentAnalyzer::identifyBottlenecks() const
 }
 
 // 其他私有方法的占位符实现
-double IntelligentAnalyzer::calculateTrendConfidence(const QVector<double>& values, double slope, double intercept) const
+double IntelligentAnalyzer::calculateTrendConfidence(double slope) const
 {
     // 简化的置信度计算
     return qBound(0.0, 1.0 - qAbs(slope) * 0.1, 1.0);
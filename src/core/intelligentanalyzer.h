@@ -10,12 +10,18 @@
 #include <QVector>
 #include <QPair>
 #include <memory>
+#include <vector>
+#include "../utils/streamingstatistics.h"
+#include "../utils/tieredmetrichistory.h"
 
 /**
  * @brief 智能性能分析器
  * 
  * 使用机器学习算法分析性能数据，预测性能趋势，
- * 提供智能化的优化建议和异常检测
+ * 提供智能化的优化建议和异常检测。
+ * 每个指标维护一份滑动窗口流式统计，新数据点到达时 O(1) 更新并完成异常判定，
+ * 趋势、异常和洞察只读取当前状态，耗时与历史长度无关。
+ * 历史数据按指标分列存放在固定容量的分层缓冲中，较旧的数据逐层降采样，总内存不超过设定的上限
  */
 class IntelligentAnalyzer : public QObject
 {
@@ -137,6 +143,18 @@ public:
      */
     QJsonObject getPerformanceInsights() const;
 
+    /**
+     * @brief 设置历史数据的内存上限，并上报给 MemoryOptimizer
+     * @param bytes 上限(字节)，按层平均分配；缩小时各层只保留最新的数据
+     */
+    void setHistoryMemoryLimit(qint64 bytes);
+
+    /**
+     * @brief 获取历史数据实际占用的内存
+     * @return 字节数
+     */
+    qint64 historyMemoryUsage() const;
+
     /**
      * @brief 设置学习参数
      * @param learningRate 学习率
@@ -237,12 +255,30 @@ private:
     QPair<double, double> calculateLinearRegression(const QVector<double>& x, const QVector<double>& y) const;
 
     /**
-     * @brief 检测单个指标的异常
-     * @param values 指标值序列
-     * @param metricName 指标名称
-     * @return 异常检测结果
+     * @brief 由历史数据的最新一行还原数据点（调用方已持有 m_dataMutex，历史非空）
      */
-    QList<AnomalyDetection> detectMetricAnomalies(const QVector<double>& values, const QString& metricName) const;
+    DataPoint latestDataPoint() const;
+
+    /**
+     * @brief 向 MemoryOptimizer 上报历史数据的内存占用
+     */
+    void reportHistoryMemory() const;
+
+    /**
+     * @brief 用新数据点更新各指标的流式统计，并按更新前的窗口统计判定异常
+     * @param dataPoint 新数据点
+     */
+    void updateMetricStreams(const DataPoint& dataPoint);
+
+    /**
+     * @brief 趋势分析（调用方已持有 m_dataMutex）
+     */
+    QList<TrendAnalysis> analyzeTrendsLocked(const QString& metric) const;
+
+    /**
+     * @brief 异常检测（调用方已持有 m_dataMutex）
+     */
+    QList<AnomalyDetection> detectAnomaliesLocked() const;
 
     /**
      * @brief 计算Z-Score
@@ -299,12 +335,10 @@ private:
 
     /**
      * @brief 计算趋势置信度
-     * @param values 数值序列
      * @param slope 斜率
-     * @param intercept 截距
      * @return 置信度
      */
-    double calculateTrendConfidence(const QVector<double>& values, double slope, double intercept) const;
+    double calculateTrendConfidence(double slope) const;
 
     /**
      * @brief 解释趋势
@@ -378,15 +412,29 @@ private:
     void updateModelOnline(const DataPoint& dataPoint);
 
 private:
+    // 单个指标的流式状态
+    struct MetricStream {
+        struct FlaggedAnomaly {
+            qint64 sequence;            // 数据点在该指标数据流中的序号
+            AnomalyDetection anomaly;
+        };
+
+        explicit MetricStream(const SlidingWindowStatistics& window) : statistics(window) {}
+
+        SlidingWindowStatistics statistics;
+        QList<FlaggedAnomaly> anomalies;    // 仍在窗口内的异常点，按序号递增
+    };
+
     // 数据存储
-    QVector<DataPoint> m_dataHistory;
+    TieredMetricHistory m_history;                  // 各指标一列，最后一列为错误计数
+    std::vector<MetricStream> m_metricStreams;      // 与指标表顺序一致
     mutable QMutex m_dataMutex;
     
     // 分析参数
     double m_learningRate;
     int m_windowSize;
     double m_sensitivityThreshold;
-    int m_maxHistorySize;
+    int m_maxHistorySize;          // 流式统计的窗口长度（点数）
     
     // 模型参数
     QJsonObject m_modelParameters;
@@ -1,6 +1,9 @@
 #include "loadbalancer.h"
 #include "continuousoptimizer.h"
 #include "intelligentanalyzer.h"
+#include "../constants.h"
+#include "../utils/monotonicclock.h"
+#include "../utils/workstealingpool.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -10,37 +13,9 @@
 #include <QtMath>
 #include <QRandomGenerator>
 #include <QCoreApplication>
-#include <QRunnable>
+#include <QElapsedTimer>
 #include <algorithm>
 
-// 任务执行器类
-class TaskRunner : public QRunnable
-{
-public:
-    TaskRunner(const LoadBalancer::TaskInfo& task, LoadBalancer* balancer)
-        : m_task(task), m_balancer(balancer)
-    {
-        setAutoDelete(true);
-    }
-    
-    void run() override
-    {
-        try {
-            if (m_task.task) {
-                m_task.task();
-            }
-        } catch (const std::exception& e) {
-            qWarning() << "[TaskRunner] 任务执行异常:" << e.what();
-        } catch (...) {
-            qWarning() << "[TaskRunner] 任务执行未知异常";
-        }
-    }
-    
-private:
-    LoadBalancer::TaskInfo m_task;
-    LoadBalancer* m_balancer;
-};
-
 LoadBalancer::LoadBalancer(QObject *parent)
     : QObject(parent)
     , m_optimizer(nullptr)
@@ -49,7 +24,14 @@ LoadBalancer::LoadBalancer(QObject *parent)
     , m_monitoringTimer(new QTimer(this))
     , m_metricsTimer(new QTimer(this))
     , m_cleanupTimer(new QTimer(this))
-    , m_threadPool(new QThreadPool(this))
+    , m_nextExecutorThread(0)
+    , m_roundRobinIndex(0)
+    , m_queuedCount(0)
+    , m_activeCount(0)
+    , m_completedTasks(System::LOAD_BALANCER_COMPLETED_HISTORY)
+    , m_completedWritten(0)
+    , m_completedCount(0)
+    , m_dispatching(false)
     , m_strategy(BalancingStrategy::Adaptive)
     , m_maxWorkers(QThread::idealThreadCount())
     , m_taskTimeout(30000)
@@ -61,16 +43,15 @@ LoadBalancer::LoadBalancer(QObject *parent)
     , m_maxRetries(3)
     , m_resourceThreshold(80.0)
     , m_isRunning(false)
-    , m_taskIdCounter(0)
 {
     // 连接定时器
-    connect(m_balancingTimer, &QTimer::timeout, this, &LoadBalancer::processTaskQueue);
+    // 任务提交后直接进入执行器，均衡定时器只负责检查超时
+    connect(m_balancingTimer, &QTimer::timeout, this, &LoadBalancer::handleTaskTimeout);
     connect(m_monitoringTimer, &QTimer::timeout, this, &LoadBalancer::monitorWorkers);
     connect(m_metricsTimer, &QTimer::timeout, this, &LoadBalancer::updateMetrics);
     connect(m_cleanupTimer, &QTimer::timeout, this, &LoadBalancer::cleanupCompletedTasks);
     
-    // 设置线程池
-    m_threadPool->setMaxThreadCount(m_maxWorkers);
+    m_taskSlots.reserve(m_maxQueueSize);
     
     // 初始化指标
     m_startTime = QDateTime::currentDateTime();
@@ -136,8 +117,17 @@ void LoadBalancer::setBalancingStrategy(BalancingStrategy strategy)
 
 void LoadBalancer::setMaxWorkers(int maxWorkers)
 {
-    m_maxWorkers = qMax(1, qMin(maxWorkers, 32));
-    m_threadPool->setMaxThreadCount(m_maxWorkers);
+    const int count = qMax(1, qMin(maxWorkers, 32));
+    if (count == m_maxWorkers) {
+        return;
+    }
+    m_maxWorkers = count;
+    
+    // 执行器线程数在创建时确定，运行中修改需要重建（已分发未开始的任务会重新分发）
+    if (m_isRunning) {
+        stopExecutor();
+        startExecutor();
+    }
     
     qDebug() << "[LoadBalancer] 最大工作线程数已设置为:" << m_maxWorkers;
 }
@@ -170,6 +160,7 @@ bool LoadBalancer::addWorker(const QString& workerId, const QHash<ResourceType,
     worker.capabilities = capabilities;
     worker.efficiency = 1.0;
     worker.enabled = true;
+    worker.executorThread = m_nextExecutorThread++;
     
     m_workers[workerId] = worker;
     
@@ -220,137 +211,140 @@ QList<LoadBalancer::WorkerInfo> LoadBalancer::getWorkers() const
     return m_workers.values();
 }
 
-QString LoadBalancer::submitTask(const QString& taskName, TaskPriority priority, 
-                                ResourceType primaryResource, 
-                                const QHash<ResourceType, double>& requirements,
-                                std::function<void()> task)
+LoadBalancer::TaskHandle LoadBalancer::submitTask(const QString& taskName, TaskPriority priority, 
+                                                 ResourceType primaryResource, 
+                                                 const QHash<ResourceType, double>& requirements,
+                                                 std::function<void()> task)
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    if (m_taskQueue.size() >= m_maxQueueSize) {
+    if (m_queuedCount >= m_maxQueueSize) {
         qWarning() << "[LoadBalancer] 任务队列已满，无法提交任务:" << taskName;
-        return QString();
+        return 0;
     }
     
-    TaskInfo taskInfo;
-    taskInfo.id = generateTaskId();
+    const TaskHandle handle = allocateTaskSlot();
+    TaskSlot& slot = *findTaskSlot(handle);
+    slot.submittedNs = MonotonicClock::nowNs();
+    
+    TaskInfo& taskInfo = slot.info;
+    taskInfo.id = handle;
     taskInfo.name = taskName;
     taskInfo.priority = priority;
     taskInfo.primaryResource = primaryResource;
     taskInfo.resourceRequirements = requirements;
-    taskInfo.task = task;
-    taskInfo.submittedAt = QDateTime::currentDateTime();
+    taskInfo.task = std::move(task);
     taskInfo.retryCount = 0;
     taskInfo.completed = false;
     taskInfo.failed = false;
     taskInfo.estimatedDuration = 1000.0; // 默认1秒
     taskInfo.actualDuration = 0.0;
     
-    // 按优先级插入队列
-    bool inserted = false;
-    for (int i = 0; i < m_taskQueue.size(); ++i) {
-        if (static_cast<int>(priority) > static_cast<int>(m_taskQueue[i].priority)) {
-            m_taskQueue.insert(i, taskInfo);
-            inserted = true;
-            break;
-        }
-    }
-    
-    if (!inserted) {
-        m_taskQueue.enqueue(taskInfo);
+    // 执行器未运行时只记录，启动时再分发
+    if (m_dispatching) {
+        dispatchTask(taskInfo);
     }
     
     m_metrics.totalTasks++;
-    m_metrics.queuedTasks++;
+    m_metrics.queuedTasks = m_queuedCount;
     m_metrics.tasksByPriority[priority]++;
     
-    emit taskSubmitted(taskInfo.id, taskName);
-    
-    qDebug() << "[LoadBalancer] 任务已提交:" << taskInfo.id << taskName;
+    emit taskSubmitted(handle, taskName);
     
-    return taskInfo.id;
+    return handle;
 }
 
-bool LoadBalancer::cancelTask(const QString& taskId)
+bool LoadBalancer::cancelTask(TaskHandle taskId)
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    // 从队列中移除
-    for (int i = 0; i < m_taskQueue.size(); ++i) {
-        if (m_taskQueue[i].id == taskId) {
-            m_taskQueue.removeAt(i);
-            m_metrics.queuedTasks--;
-            qDebug() << "[LoadBalancer] 任务已从队列中取消:" << taskId;
-            return true;
-        }
+    TaskSlot* slot = findTaskSlot(taskId);
+    if (!slot) {
+        qWarning() << "[LoadBalancer] 任务不存在:" << taskId;
+        return false;
     }
     
     // 检查是否在执行中
-    if (m_activeTasks.contains(taskId)) {
+    if (slot->state == TaskState::Active) {
         qWarning() << "[LoadBalancer] 任务正在执行中，无法取消:" << taskId;
         return false;
     }
     
-    qWarning() << "[LoadBalancer] 任务不存在:" << taskId;
-    return false;
+    // 释放槽位；已分发的任务仍在执行器中，轮到时句柄失效，直接返回
+    const QString workerId = slot->info.workerId;
+    releaseTaskSlot(taskId);
+    m_metrics.queuedTasks = m_queuedCount;
+    if (m_dispatching) {
+        releaseWorker(workerId, 0, 0);
+    }
+    
+    qDebug() << "[LoadBalancer] 任务已从队列中取消:" << taskId;
+    return true;
 }
 
-bool LoadBalancer::retryTask(const QString& taskId)
+LoadBalancer::TaskHandle LoadBalancer::retryTask(TaskHandle taskId)
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    if (!m_completedTasks.contains(taskId)) {
+    CompletedTask* record = const_cast<CompletedTask*>(findCompletedTask(taskId));
+    if (!record) {
         qWarning() << "[LoadBalancer] 任务不存在或未完成:" << taskId;
-        return false;
+        return 0;
     }
     
-    auto taskInfo = m_completedTasks[taskId];
-    
-    if (!taskInfo.failed) {
+    if (!record->info.failed) {
         qWarning() << "[LoadBalancer] 任务未失败，无需重试:" << taskId;
-        return false;
+        return 0;
     }
     
-    if (taskInfo.retryCount >= m_maxRetries) {
+    if (record->info.retryCount >= m_maxRetries) {
         qWarning() << "[LoadBalancer] 任务重试次数已达上限:" << taskId;
-        return false;
+        return 0;
     }
     
-    // 重新提交任务
-    taskInfo.id = generateTaskId();
+    // 超时的任务仍在执行，已重试过的任务函数已移交给新任务
+    if (!record->info.task) {
+        qWarning() << "[LoadBalancer] 任务已重试或仍在执行，无法重试:" << taskId;
+        return 0;
+    }
+    
+    // 重新提交任务（记录在另一个容器中，分配槽位不影响它）
+    TaskInfo taskInfo = record->info;
+    taskInfo.task = std::move(record->info.task);
+    const TaskHandle handle = allocateTaskSlot();
+    TaskSlot& slot = *findTaskSlot(handle);
+    slot.submittedNs = MonotonicClock::nowNs();
+    
+    taskInfo.id = handle;
     taskInfo.retryCount++;
     taskInfo.failed = false;
     taskInfo.completed = false;
     taskInfo.errorMessage.clear();
-    taskInfo.submittedAt = QDateTime::currentDateTime();
+    taskInfo.actualDuration = 0.0;
+    slot.info = std::move(taskInfo);
     
-    m_taskQueue.enqueue(taskInfo);
-    m_metrics.queuedTasks++;
+    if (m_dispatching) {
+        dispatchTask(slot.info);
+    }
+    m_metrics.queuedTasks = m_queuedCount;
     
-    qDebug() << "[LoadBalancer] 任务已重新提交:" << taskInfo.id << "(重试" << taskInfo.retryCount << "次)";
+    qDebug() << "[LoadBalancer] 任务已重新提交:" << handle << "(重试" << slot.info.retryCount << "次)";
     
-    return true;
+    return handle;
 }
 
-LoadBalancer::TaskInfo LoadBalancer::getTaskInfo(const QString& taskId) const
+LoadBalancer::TaskInfo LoadBalancer::getTaskInfo(TaskHandle taskId) const
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    // 检查活动任务
-    if (m_activeTasks.contains(taskId)) {
-        return m_activeTasks[taskId];
+    // 检查排队和执行中的任务
+    if (const TaskSlot* slot = findTaskSlot(taskId)) {
+        return taskInfoFromSlot(*slot);
     }
     
     // 检查已完成任务
-    if (m_completedTasks.contains(taskId)) {
-        return m_completedTasks[taskId];
-    }
-    
-    // 检查队列中的任务
-    for (const auto& task : m_taskQueue) {
-        if (task.id == taskId) {
-            return task;
-        }
+    if (const CompletedTask* record = findCompletedTask(taskId)) {
+        return taskInfoFromRecord(*record);
     }
     
     return TaskInfo();
@@ -359,33 +353,62 @@ LoadBalancer::TaskInfo LoadBalancer::getTaskInfo(const QString& taskId) const
 QList<LoadBalancer::TaskInfo> LoadBalancer::getQueuedTasks() const
 {
     QMutexLocker locker(&m_tasksMutex);
-    return m_taskQueue.toList();
+    
+    QList<TaskInfo> tasks;
+    tasks.reserve(m_queuedCount);
+    for (const TaskSlot& slot : m_taskSlots) {
+        if (slot.state == TaskState::Queued) {
+            tasks.append(taskInfoFromSlot(slot));
+        }
+    }
+    
+    // 按优先级和提交时间排序
+    std::sort(tasks.begin(), tasks.end(), [](const TaskInfo& a, const TaskInfo& b) {
+        if (a.priority != b.priority) {
+            return static_cast<int>(a.priority) > static_cast<int>(b.priority);
+        }
+        return a.submittedAt < b.submittedAt;
+    });
+    
+    return tasks;
 }
 
 QList<LoadBalancer::TaskInfo> LoadBalancer::getActiveTasks() const
 {
     QMutexLocker locker(&m_tasksMutex);
-    return m_activeTasks.values();
+    
+    QList<TaskInfo> tasks;
+    tasks.reserve(m_activeCount);
+    for (const TaskSlot& slot : m_taskSlots) {
+        if (slot.state == TaskState::Active) {
+            tasks.append(taskInfoFromSlot(slot));
+        }
+    }
+    return tasks;
 }
 
 QList<LoadBalancer::TaskInfo> LoadBalancer::getCompletedTasks(int limit) const
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    auto tasks = m_completedTasks.values();
-    
-    // 按完成时间排序
-    std::sort(tasks.begin(), tasks.end(), [](const TaskInfo& a, const TaskInfo& b) {
-        return a.completedAt > b.completedAt;
-    });
-    
-    if (limit > 0 && tasks.size() > limit) {
-        tasks = tasks.mid(0, limit);
+    // 环形记录从最新往前取，即按完成时间降序
+    const int count = limit > 0 ? qMin(limit, m_completedCount) : m_completedCount;
+    QList<TaskInfo> tasks;
+    tasks.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const quint64 position = m_completedWritten - 1 - static_cast<quint64>(i);
+        tasks.append(taskInfoFromRecord(m_completedTasks[position % m_completedTasks.size()]));
     }
     
     return tasks;
 }
 
+QList<LoadBalancer::TaskNameStatistics> LoadBalancer::getTaskStatistics() const
+{
+    QMutexLocker locker(&m_tasksMutex);
+    return m_taskStatistics.values();
+}
+
 void LoadBalancer::startBalancing()
 {
     if (m_isRunning) {
@@ -395,6 +418,8 @@ void LoadBalancer::startBalancing()
     
     m_isRunning = true;
     
+    startExecutor();
+    
     // 启动定时器
     m_balancingTimer->start(m_balancingInterval);
     m_monitoringTimer->start(m_monitoringInterval);
@@ -418,8 +443,8 @@ void LoadBalancer::stopBalancing()
     m_metricsTimer->stop();
     m_cleanupTimer->stop();
     
-    // 等待所有任务完成
-    m_threadPool->waitForDone(5000);
+    // 等待正在执行的任务完成，尚未开始的任务留到下次启动
+    stopExecutor();
     
     qDebug() << "[LoadBalancer] 负载均衡已停止";
 }
@@ -492,6 +517,21 @@ QJsonObject LoadBalancer::getPerformanceReport() const
     report["average_wait_time"] = metrics.averageWaitTime;
     report["average_execution_time"] = metrics.averageExecutionTime;
     
+    // 按任务名汇总的等待和执行时间
+    QJsonArray taskStats;
+    for (const TaskNameStatistics& statistics : getTaskStatistics()) {
+        QJsonObject taskObj;
+        taskObj["name"] = statistics.name;
+        taskObj["completed"] = statistics.completed;
+        taskObj["failed"] = statistics.failed;
+        taskObj["average_wait_us"] = statistics.waitTime.averageUs();
+        taskObj["average_execution_us"] = statistics.executionTime.averageUs();
+        taskObj["p99_execution_us"] = statistics.executionTime.percentileUs(99.0);
+        taskObj["max_execution_us"] = statistics.executionTime.maxNs() / 1000.0;
+        taskStats.append(taskObj);
+    }
+    report["task_statistics"] = taskStats;
+    
     // 工作线程统计
     QJsonObject workerStats;
     QMutexLocker workerLocker(&m_workersMutex);
@@ -571,6 +611,30 @@ QJsonObject LoadBalancer::getWorkerStatistics() const
     }
     
     stats["workers"] = workers;
+    
+    // 执行器各线程的实际负载（任务可能被窃取，与放置的工作线程不一定一致）
+    if (m_executor) {
+        const WorkStealingPool::Statistics poolStats = m_executor->statistics();
+        QJsonArray threads;
+        for (const WorkStealingPool::ThreadStatistics& thread : poolStats.threads) {
+            QJsonObject threadObj;
+            threadObj["executed"] = thread.executed;
+            threadObj["stolen"] = thread.stolen;
+            threadObj["queued"] = thread.queued;
+            threadObj["utilization"] = thread.utilization;
+            threads.append(threadObj);
+        }
+        
+        QJsonObject executor;
+        executor["submitted"] = poolStats.submitted;
+        executor["executed"] = poolStats.executed;
+        executor["stolen"] = poolStats.stolen;
+        executor["pending"] = m_executor->pendingCount();
+        executor["utilization"] = poolStats.utilization;
+        executor["threads"] = threads;
+        stats["executor"] = executor;
+    }
+    
     stats["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
     
     return stats;
@@ -793,15 +857,23 @@ void LoadBalancer::resetToDefaults()
     m_maxRetries = 3;
     m_resourceThreshold = 80.0;
     
-    // 清空队列和任务
+    // 清空队列和任务；执行器已停止，槽位逐个释放，旧句柄随代数失效
     QMutexLocker taskLocker(&m_tasksMutex);
-    m_taskQueue.clear();
-    m_activeTasks.clear();
-    m_completedTasks.clear();
+    for (size_t i = 0; i < m_taskSlots.size(); ++i) {
+        const TaskSlot& slot = m_taskSlots[i];
+        if (slot.state != TaskState::Free) {
+            releaseTaskSlot((static_cast<TaskHandle>(slot.generation) << 32) | i);
+        }
+    }
+    for (CompletedTask& record : m_completedTasks) {
+        record = CompletedTask();
+    }
+    m_completedWritten = 0;
+    m_completedCount = 0;
+    m_taskStatistics.clear();
     
     // 重置指标
     m_metrics = BalancingMetrics();
-    m_taskIdCounter = 0;
     
     qDebug() << "[LoadBalancer] 已重置为默认配置";
 }
@@ -827,23 +899,14 @@ void LoadBalancer::optimizeBalancing()
 
 void LoadBalancer::rebalanceTasks()
 {
-    // 重新分配任务到最优工作线程
-    QMutexLocker taskLocker(&m_tasksMutex);
-    QMutexLocker workerLocker(&m_workersMutex);
-    
-    // 简化的重新平衡逻辑
-    for (auto it = m_activeTasks.begin(); it != m_activeTasks.end(); ++it) {
-        auto& task = it.value();
-        
-        // 检查当前工作线程是否仍然是最优选择
-        WorkerInfo* optimalWorker = selectWorker(task);
-        
-        if (optimalWorker && !optimalWorker->busy) {
-            // 可以考虑迁移任务（简化实现中暂不支持）
-        }
+    // 排队的任务由执行器的空闲线程窃取，不需要在这里迁移，只报告负载分布
+    if (!m_executor) {
+        return;
     }
     
-    qDebug() << "[LoadBalancer] 任务重新平衡完成";
+    const WorkStealingPool::Statistics poolStats = m_executor->statistics();
+    qDebug() << "[LoadBalancer] 任务重新平衡完成，已执行" << poolStats.executed
+             << "窃取" << poolStats.stolen << "利用率" << poolStats.utilization;
 }
 
 void LoadBalancer::updateWorkerMetrics()
@@ -871,16 +934,17 @@ void LoadBalancer::cleanupCompletedTasks()
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    // 清理超过一定时间的已完成任务
-    QDateTime cutoffTime = QDateTime::currentDateTime().addSecs(-3600); // 1小时前
+    // 环形记录容量固定，这里只淘汰超过一定时间的记录，释放失败任务保留的任务函数
+    const qint64 cutoffNs = MonotonicClock::nowNs() - 3600LL * 1000 * 1000 * 1000; // 1小时前
     
-    auto it = m_completedTasks.begin();
-    while (it != m_completedTasks.end()) {
-        if (it.value().completedAt < cutoffTime) {
-            it = m_completedTasks.erase(it);
-        } else {
-            ++it;
+    while (m_completedCount > 0) {
+        const quint64 oldest = m_completedWritten - static_cast<quint64>(m_completedCount);
+        CompletedTask& record = m_completedTasks[oldest % m_completedTasks.size()];
+        if (record.completedNs >= cutoffNs) {
+            break;
         }
+        record = CompletedTask();
+        --m_completedCount;
     }
     
     qDebug() << "[LoadBalancer] 已清理过期的已完成任务";
@@ -910,33 +974,6 @@ void LoadBalancer::handleResourceAlert(ResourceType type, double usage)
 }
 
 // 私有槽函数实现
-void LoadBalancer::processTaskQueue()
-{
-    QMutexLocker taskLocker(&m_tasksMutex);
-    
-    if (m_taskQueue.isEmpty()) {
-        return;
-    }
-    
-    // 处理队列中的任务
-    while (!m_taskQueue.isEmpty()) {
-        TaskInfo task = m_taskQueue.dequeue();
-        m_metrics.queuedTasks--;
-        
-        // 选择工作线程
-        WorkerInfo* worker = selectWorker(task);
-        
-        if (worker) {
-            executeTask(task, worker);
-        } else {
-            // 没有可用工作线程，重新放回队列
-            m_taskQueue.prepend(task);
-            m_metrics.queuedTasks++;
-            break;
-        }
-    }
-}
-
 void LoadBalancer::monitorWorkers()
 {
     updateWorkerMetrics();
@@ -957,20 +994,19 @@ void LoadBalancer::updateMetrics()
 {
     QMutexLocker locker(&m_tasksMutex);
     
-    // 更新平均等待时间和执行时间
-    if (m_completedTasks.size() > 0) {
-        double totalWaitTime = 0.0;
-        double totalExecutionTime = 0.0;
-        
-        for (const auto& task : m_completedTasks) {
-            if (task.completed) {
-                totalWaitTime += task.submittedAt.msecsTo(task.startedAt);
-                totalExecutionTime += task.actualDuration;
-            }
-        }
-        
-        m_metrics.averageWaitTime = totalWaitTime / m_completedTasks.size();
-        m_metrics.averageExecutionTime = totalExecutionTime / m_completedTasks.size();
+    // 由按任务名汇总的统计计算平均等待时间和执行时间（毫秒）
+    qint64 samples = 0;
+    double totalWaitUs = 0.0;
+    double totalExecutionUs = 0.0;
+    for (const TaskNameStatistics& statistics : m_taskStatistics) {
+        samples += statistics.executionTime.count();
+        totalWaitUs += statistics.waitTime.averageUs() * statistics.waitTime.count();
+        totalExecutionUs += statistics.executionTime.averageUs() * statistics.executionTime.count();
+    }
+    
+    if (samples > 0) {
+        m_metrics.averageWaitTime = totalWaitUs / samples / 1000.0;
+        m_metrics.averageExecutionTime = totalExecutionUs / samples / 1000.0;
     }
     
     m_metrics.lastUpdated = QDateTime::currentDateTime();
@@ -978,32 +1014,30 @@ void LoadBalancer::updateMetrics()
 
 void LoadBalancer::handleTaskTimeout()
 {
-    QMutexLocker locker(&m_tasksMutex);
-    
-    QDateTime timeoutThreshold = QDateTime::currentDateTime().addMSecs(-m_taskTimeout);
-    
-    // 检查超时的活动任务
-    auto it = m_activeTasks.begin();
-    while (it != m_activeTasks.end()) {
-        auto& task = it.value();
+    QList<QPair<TaskHandle, QString>> timedOut;
+    {
+        QMutexLocker locker(&m_tasksMutex);
         
-        if (task.startedAt < timeoutThreshold) {
-            // 任务超时
-            task.failed = true;
-            task.completed = true;
-            task.completedAt = QDateTime::currentDateTime();
-            task.errorMessage = "任务执行超时";
-            
-            m_completedTasks[task.id] = task;
-            m_metrics.failedTasks++;
-            
-            emit taskFailed(task.id, task.errorMessage);
+        const qint64 nowNs = MonotonicClock::nowNs();
+        const qint64 timeoutNs = static_cast<qint64>(m_taskTimeout) * 1000 * 1000;
+        
+        // 超时的任务仍在执行，先记为失败；执行结束时不再重复记录
+        for (TaskSlot& slot : m_taskSlots) {
+            if (slot.state != TaskState::Active || slot.info.failed || nowNs - slot.startedNs < timeoutNs) {
+                continue;
+            }
+            slot.info.failed = true;
             
-            it = m_activeTasks.erase(it);
-        } else {
-            ++it;
+            TaskInfo info = slot.info;
+            info.task = nullptr;
+            recordCompletedTask(std::move(info), slot.submittedNs, slot.startedNs, nowNs, "任务执行超时");
+            timedOut.append(qMakePair(slot.info.id, QString("任务执行超时")));
         }
     }
+    
+    for (const auto& task : timedOut) {
+        emit taskFailed(task.first, task.second);
+    }
 }
 
 void LoadBalancer::analyzePerformance()
@@ -1022,17 +1056,137 @@ void LoadBalancer::analyzePerformance()
 }
 
 // 私有方法实现
-QString LoadBalancer::generateTaskId()
+LoadBalancer::TaskHandle LoadBalancer::allocateTaskSlot()
+{
+    quint32 index;
+    if (!m_freeTaskSlots.empty()) {
+        index = m_freeTaskSlots.back();
+        m_freeTaskSlots.pop_back();
+    } else {
+        index = static_cast<quint32>(m_taskSlots.size());
+        m_taskSlots.emplace_back();
+    }
+    
+    TaskSlot& slot = m_taskSlots[index];
+    slot.state = TaskState::Queued;
+    slot.startedNs = 0;
+    ++m_queuedCount;
+    return (static_cast<TaskHandle>(slot.generation) << 32) | index;
+}
+
+LoadBalancer::TaskSlot* LoadBalancer::findTaskSlot(TaskHandle handle)
 {
-    return QString("task_%1_%2")
-           .arg(QDateTime::currentMSecsSinceEpoch())
-           .arg(++m_taskIdCounter);
+    const quint32 index = static_cast<quint32>(handle);
+    if (index >= m_taskSlots.size()) {
+        return nullptr;
+    }
+    TaskSlot& slot = m_taskSlots[index];
+    if (slot.state == TaskState::Free || slot.generation != static_cast<quint32>(handle >> 32)) {
+        return nullptr;
+    }
+    return &slot;
 }
 
-LoadBalancer::WorkerInfo* LoadBalancer::selectWorker(const TaskInfo& task)
+const LoadBalancer::TaskSlot* LoadBalancer::findTaskSlot(TaskHandle handle) const
 {
-    QMutexLocker locker(&m_workersMutex);
+    return const_cast<LoadBalancer*>(this)->findTaskSlot(handle);
+}
+
+void LoadBalancer::releaseTaskSlot(TaskHandle handle)
+{
+    const quint32 index = static_cast<quint32>(handle);
+    TaskSlot& slot = m_taskSlots[index];
+    if (slot.state == TaskState::Queued) {
+        --m_queuedCount;
+    } else if (slot.state == TaskState::Active) {
+        --m_activeCount;
+    }
     
+    slot.state = TaskState::Free;
+    slot.info = TaskInfo();
+    // 代数 0 留给无效句柄
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    m_freeTaskSlots.push_back(index);
+}
+
+LoadBalancer::TaskInfo LoadBalancer::taskInfoFromSlot(const TaskSlot& slot) const
+{
+    TaskInfo info = slot.info;
+    info.submittedAt = MonotonicClock::toDateTime(MonotonicClock::toEpochMs(slot.submittedNs));
+    if (slot.startedNs > 0) {
+        info.startedAt = MonotonicClock::toDateTime(MonotonicClock::toEpochMs(slot.startedNs));
+    }
+    return info;
+}
+
+LoadBalancer::TaskInfo LoadBalancer::taskInfoFromRecord(const CompletedTask& record) const
+{
+    TaskInfo info = record.info;
+    info.submittedAt = MonotonicClock::toDateTime(MonotonicClock::toEpochMs(record.submittedNs));
+    info.startedAt = MonotonicClock::toDateTime(MonotonicClock::toEpochMs(record.startedNs));
+    info.completedAt = MonotonicClock::toDateTime(MonotonicClock::toEpochMs(record.completedNs));
+    return info;
+}
+
+const LoadBalancer::CompletedTask* LoadBalancer::findCompletedTask(TaskHandle handle) const
+{
+    if (handle == 0) {
+        return nullptr;
+    }
+    for (int i = 0; i < m_completedCount; ++i) {
+        const quint64 position = m_completedWritten - 1 - static_cast<quint64>(i);
+        const CompletedTask& record = m_completedTasks[position % m_completedTasks.size()];
+        if (record.info.id == handle) {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+void LoadBalancer::recordCompletedTask(TaskInfo info, qint64 submittedNs, qint64 startedNs, qint64 completedNs,
+                                       const QString& error)
+{
+    info.completed = true;
+    info.failed = !error.isEmpty();
+    info.errorMessage = error;
+    info.actualDuration = (completedNs - startedNs) / 1.0e6;
+    
+    // 按任务名汇总；名称过多时合并，避免统计表无限增长
+    auto statistics = m_taskStatistics.find(info.name);
+    if (statistics == m_taskStatistics.end()) {
+        const QString name = m_taskStatistics.size() < System::LOAD_BALANCER_TASK_NAME_LIMIT ? info.name : QString("其他");
+        statistics = m_taskStatistics.find(name);
+        if (statistics == m_taskStatistics.end()) {
+            statistics = m_taskStatistics.insert(name, TaskNameStatistics());
+            statistics->name = name;
+        }
+    }
+    if (info.failed) {
+        statistics->failed++;
+        m_metrics.failedTasks++;
+    } else {
+        statistics->completed++;
+        m_metrics.completedTasks++;
+        // 只有失败的任务需要保留任务函数和资源需求以便重试
+        info.task = nullptr;
+        info.resourceRequirements.clear();
+    }
+    statistics->waitTime.record(startedNs - submittedNs);
+    statistics->executionTime.record(completedNs - startedNs);
+    
+    CompletedTask& record = m_completedTasks[m_completedWritten % m_completedTasks.size()];
+    record.submittedNs = submittedNs;
+    record.startedNs = startedNs;
+    record.completedNs = completedNs;
+    record.info = std::move(info);
+    ++m_completedWritten;
+    m_completedCount = qMin(m_completedCount + 1, static_cast<int>(m_completedTasks.size()));
+}
+
+LoadBalancer::WorkerInfo* LoadBalancer::selectWorker(const TaskInfo& task)
+{
     switch (m_strategy) {
     case BalancingStrategy::RoundRobin:
         return selectWorkerRoundRobin();
@@ -1051,21 +1205,34 @@ LoadBalancer::WorkerInfo* LoadBalancer::selectWorker(const TaskInfo& task)
 
 LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerRoundRobin()
 {
-    static int lastWorkerIndex = 0;
+    if (m_workers.isEmpty()) {
+        return nullptr;
+    }
     
-    auto workers = m_workers.values();
+    // 从上次的位置往后找第一个启用的工作线程，找不到再从头找
+    const int start = m_roundRobinIndex % m_workers.size();
+    WorkerInfo* first = nullptr;
+    int firstIndex = 0;
+    int index = 0;
     
-    for (int i = 0; i < workers.size(); ++i) {
-        int index = (lastWorkerIndex + i) % workers.size();
-        auto& worker = workers[index];
-        
-        if (worker.enabled && !worker.busy) {
-            lastWorkerIndex = (index + 1) % workers.size();
-            return &m_workers[worker.id];
+    for (auto it = m_workers.begin(); it != m_workers.end(); ++it, ++index) {
+        if (!it->enabled) {
+            continue;
+        }
+        if (index >= start) {
+            m_roundRobinIndex = index + 1;
+            return &it.value();
+        }
+        if (!first) {
+            first = &it.value();
+            firstIndex = index;
         }
     }
     
-    return nullptr;
+    if (first) {
+        m_roundRobinIndex = firstIndex + 1;
+    }
+    return first;
 }
 
 LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerLeastLoaded()
@@ -1074,7 +1241,7 @@ LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerLeastLoaded()
     double minLoad = std::numeric_limits<double>::max();
     
     for (auto& worker : m_workers) {
-        if (worker.enabled && !worker.busy) {
+        if (worker.enabled) {
             double load = worker.cpuLoad + worker.memoryUsage * 0.5 + worker.activeTasks * 10.0;
             
             if (load < minLoad) {
@@ -1093,7 +1260,7 @@ LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerWeighted()
     double bestScore = -1.0;
     
     for (auto& worker : m_workers) {
-        if (worker.enabled && !worker.busy) {
+        if (worker.enabled) {
             double score = worker.efficiency * (1.0 - worker.cpuLoad / 100.0);
             
             if (score > bestScore) {
@@ -1112,7 +1279,7 @@ LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerResourceBased(const TaskInfo
     double bestScore = -1.0;
     
     for (auto& worker : m_workers) {
-        if (worker.enabled && !worker.busy) {
+        if (worker.enabled) {
             double score = calculateWorkerScore(worker, task);
             
             if (score > bestScore) {
@@ -1132,7 +1299,7 @@ LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerAdaptive(const TaskInfo& tas
     double bestScore = -1.0;
     
     for (auto& worker : m_workers) {
-        if (worker.enabled && !worker.busy) {
+        if (worker.enabled) {
             // 综合评分
             double resourceScore = calculateWorkerScore(worker, task);
             double efficiencyScore = worker.efficiency;
@@ -1150,33 +1317,174 @@ LoadBalancer::WorkerInfo* LoadBalancer::selectWorkerAdaptive(const TaskInfo& tas
     return bestWorker;
 }
 
-void LoadBalancer::executeTask(const TaskInfo& task, WorkerInfo* worker)
+void LoadBalancer::startExecutor()
 {
-    if (!worker) {
-        return;
+    auto executor = std::make_unique<WorkStealingPool>(m_maxWorkers, "LoadBalancer");
+    
+    QMutexLocker locker(&m_tasksMutex);
+    m_executor = std::move(executor);
+    m_dispatching = true;
+    
+    // 停止期间提交（或停止时尚未开始）的任务按优先级和提交时间分发
+    QList<TaskSlot*> pending;
+    pending.reserve(m_queuedCount);
+    for (TaskSlot& slot : m_taskSlots) {
+        if (slot.state == TaskState::Queued) {
+            pending.append(&slot);
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [](const TaskSlot* a, const TaskSlot* b) {
+        if (a->info.priority != b->info.priority) {
+            return static_cast<int>(a->info.priority) > static_cast<int>(b->info.priority);
+        }
+        return a->submittedNs < b->submittedNs;
+    });
+    for (TaskSlot* slot : pending) {
+        dispatchTask(slot->info);
+    }
+}
+
+void LoadBalancer::stopExecutor()
+{
+    {
+        QMutexLocker locker(&m_tasksMutex);
+        m_dispatching = false;
     }
     
-    // 更新任务状态
-    TaskInfo activeTask = task;
-    activeTask.startedAt = QDateTime::currentDateTime();
+    // 析构时等待正在执行的任务结束；尚未开始的任务看到 m_dispatching 为 false，把任务函数放回槽位后返回
+    m_executor.reset();
     
-    QMutexLocker taskLocker(&m_tasksMutex);
-    m_activeTasks[activeTask.id] = activeTask;
+    QMutexLocker locker(&m_workersMutex);
+    for (auto& worker : m_workers) {
+        worker.activeTasks = 0;
+        worker.busy = false;
+    }
+}
+
+int LoadBalancer::placeTask(TaskInfo& task)
+{
+    QMutexLocker locker(&m_workersMutex);
     
-    // 更新工作线程状态
-    QMutexLocker workerLocker(&m_workersMutex);
-    worker->busy = true;
-    worker->activeTasks++;
+    WorkerInfo* worker = selectWorker(task);
+    if (worker) {
+        worker->activeTasks++;
+        worker->busy = true;
+        task.workerId = worker->id;
+        return worker->executorThread;
+    }
+    
+    // 没有启用的工作线程：按主要资源类型固定放到一个线程，同类任务共享缓存和连接
+    task.workerId.clear();
+    return static_cast<int>(task.primaryResource);
+}
+
+void LoadBalancer::dispatchTask(TaskInfo& task)
+{
+    // 调用者持有 m_tasksMutex，且执行器正在运行。任务函数移入执行器，不复制
+    const int thread = placeTask(task);
+    m_executor->submit([this, handle = task.id, work = std::move(task.task)]() mutable { runTask(handle, work); },
+                       static_cast<int>(task.priority), thread);
+}
+
+void LoadBalancer::runTask(TaskHandle handle, std::function<void()>& work)
+{
+    QString workerId;
+    {
+        QMutexLocker locker(&m_tasksMutex);
+        
+        // 已取消的任务句柄失效
+        TaskSlot* slot = findTaskSlot(handle);
+        if (!slot || slot->state != TaskState::Queued) {
+            return;
+        }
+        // 停止期间轮到的任务放回槽位，下次启动时重新分发
+        if (!m_dispatching) {
+            slot->info.task = std::move(work);
+            return;
+        }
+        
+        slot->state = TaskState::Active;
+        slot->startedNs = MonotonicClock::nowNs();
+        --m_queuedCount;
+        ++m_activeCount;
+        m_metrics.queuedTasks = m_queuedCount;
+        workerId = slot->info.workerId;
+    }
+    
+    emit taskStarted(handle, workerId);
+    
+    QString error;
+    try {
+        if (work) {
+            work();
+        }
+    } catch (const std::exception& e) {
+        error = QString::fromLocal8Bit(e.what());
+        qWarning() << "[LoadBalancer] 任务执行异常:" << handle << e.what();
+    } catch (...) {
+        error = "任务执行未知异常";
+        qWarning() << "[LoadBalancer] 任务执行未知异常:" << handle;
+    }
+    
+    finishTask(handle, work, error);
+}
+
+void LoadBalancer::finishTask(TaskHandle handle, std::function<void()>& work, const QString& error)
+{
+    const qint64 completedNs = MonotonicClock::nowNs();
+    const bool failed = !error.isEmpty();
+    bool recorded = false;
+    double durationMs = 0.0;
+    QString workerId;
+    {
+        QMutexLocker locker(&m_tasksMutex);
+        
+        TaskSlot* slot = findTaskSlot(handle);
+        if (!slot) {
+            return;
+        }
+        workerId = slot->info.workerId;
+        durationMs = (completedNs - slot->startedNs) / 1.0e6;
+        
+        // 超时的任务已由 handleTaskTimeout 记为失败
+        if (!slot->info.failed) {
+            if (failed) {
+                slot->info.task = std::move(work);
+            }
+            recordCompletedTask(std::move(slot->info), slot->submittedNs, slot->startedNs, completedNs, error);
+            recorded = true;
+        }
+        releaseTaskSlot(handle);
+    }
     
-    emit taskStarted(activeTask.id, worker->id);
+    releaseWorker(workerId, failed ? 0 : 1, failed ? 1 : 0);
     
-    // 创建任务执行器
-    TaskRunner* runner = new TaskRunner(activeTask, this);
+    if (!recorded) {
+        return;
+    }
+    if (failed) {
+        emit taskFailed(handle, error);
+    } else {
+        emit taskCompleted(handle, durationMs);
+    }
+}
+
+void LoadBalancer::releaseWorker(const QString& workerId, int completedDelta, int failedDelta)
+{
+    QMutexLocker locker(&m_workersMutex);
     
-    // 提交到线程池
-    m_threadPool->start(runner);
+    auto worker = m_workers.find(workerId);
+    if (worker == m_workers.end()) {
+        return;
+    }
     
-    qDebug() << "[LoadBalancer] 任务已分配给工作线程:" << activeTask.id << "->" << worker->id;
+    worker->activeTasks = qMax(0, worker->activeTasks - 1);
+    worker->busy = worker->activeTasks > 0;
+    worker->completedTasks += completedDelta;
+    worker->failedTasks += failedDelta;
+    if (completedDelta + failedDelta > 0) {
+        worker->lastTaskCompleted = QDateTime::currentDateTime();
+    }
 }
 
 void LoadBalancer::updateWorkerLoad(const QString& workerId, const QHash<ResourceType, double>& load)
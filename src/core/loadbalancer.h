@@ -4,18 +4,27 @@
 #include <QObject>
 #include <QTimer>
 #include <QThread>
-#include <QThreadPool>
 #include <QMutex>
-#include <QQueue>
 #include <QHash>
 #include <QDateTime>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <functional>
+#include <memory>
+#include <vector>
+#include "../utils/latencyhistogram.h"
 
 class ContinuousOptimizer;
 class IntelligentAnalyzer;
+class WorkStealingPool;
 
+// 负载均衡器 - 任务提交后直接交给工作窃取线程池（WorkStealingPool）执行，不经过中心调度循环。
+// 均衡策略只决定放置提示：选中的工作线程对应池中的一个线程，任务放入该线程的队列，
+// 之后由池内空闲线程窃取来平衡负载。任务优先级对应池的优先级档。
+// 任务记录仅用于查询、取消和重试，不参与调度：排队和执行中的任务放在可复用的槽位中，
+// 以 64 位句柄（槽位序号 + 代数）寻址；已完成的任务只在固定容量的环形记录中保留最近一段，
+// 长期统计按任务名汇总。
+// 执行器随 startBalancing() 启动、stopBalancing() 停止，停止期间提交的任务在下次启动时分发
 class LoadBalancer : public QObject
 {
     Q_OBJECT
@@ -44,8 +53,11 @@ public:
         Adaptive = 4
     };
     
+    // 任务句柄：低 32 位为槽位序号，高 32 位为槽位的代数，槽位复用后旧句柄自动失效；0 表示无效
+    using TaskHandle = quint64;
+    
     struct TaskInfo {
-        QString id;
+        TaskHandle id;
         QString name;
         TaskPriority priority;
         ResourceType primaryResource;
@@ -60,6 +72,7 @@ public:
         QString errorMessage;
         double estimatedDuration;
         double actualDuration;
+        QString workerId;           // 放置提示选中的工作线程，可能被其他线程窃取执行
     };
     
     struct WorkerInfo {
@@ -76,6 +89,16 @@ public:
         QHash<ResourceType, double> currentLoad;
         double efficiency;
         bool enabled;
+        int executorThread;         // 对应执行器中的线程（按线程数取模）
+    };
+    
+    // 按任务名汇总的统计，单个任务的记录被环形记录覆盖后仍保留在这里
+    struct TaskNameStatistics {
+        QString name;
+        qint64 completed = 0;
+        qint64 failed = 0;
+        LatencyHistogram waitTime;          // 提交到开始执行
+        LatencyHistogram executionTime;
     };
     
     struct ResourceMetrics {
@@ -119,16 +142,19 @@ explicit LoadBalancer(QObject *parent = nullptr);
     QList<WorkerInfo> getWorkers() const;
     
     // 任务管理
-    QString submitTask(const QString& taskName, TaskPriority priority, 
-                      ResourceType primaryResource, 
-                      const QHash<ResourceType, double>& requirements,
-                      std::function<void()> task);
-    bool cancelTask(const QString& taskId);
-    bool retryTask(const QString& taskId);
-    TaskInfo getTaskInfo(const QString& taskId) const;
+    // 队列已满时返回 0
+    TaskHandle submitTask(const QString& taskName, TaskPriority priority, 
+                          ResourceType primaryResource, 
+                          const QHash<ResourceType, double>& requirements,
+                          std::function<void()> task);
+    bool cancelTask(TaskHandle taskId);
+    // 重新提交失败的任务（须仍在已完成记录中），返回新任务的句柄，失败返回 0
+    TaskHandle retryTask(TaskHandle taskId);
+    TaskInfo getTaskInfo(TaskHandle taskId) const;
     QList<TaskInfo> getQueuedTasks() const;
     QList<TaskInfo> getActiveTasks() const;
     QList<TaskInfo> getCompletedTasks(int limit = 100) const;
+    QList<TaskNameStatistics> getTaskStatistics() const;
     
     // 负载均衡控制
     void startBalancing();
@@ -155,10 +181,10 @@ explicit LoadBalancer(QObject *parent = nullptr);
     void resetToDefaults();
 
 signals:
-    void taskSubmitted(const QString& taskId, const QString& taskName);
-    void taskStarted(const QString& taskId, const QString& workerId);
-    void taskCompleted(const QString& taskId, double duration);
-    void taskFailed(const QString& taskId, const QString& error);
+    void taskSubmitted(LoadBalancer::TaskHandle taskId, const QString& taskName);
+    void taskStarted(LoadBalancer::TaskHandle taskId, const QString& workerId);
+    void taskCompleted(LoadBalancer::TaskHandle taskId, double duration);
+    void taskFailed(LoadBalancer::TaskHandle taskId, const QString& error);
     void workerAdded(const QString& workerId);
     void workerRemoved(const QString& workerId);
     void resourceThresholdExceeded(ResourceType type, double usage);
@@ -173,13 +199,34 @@ public slots:
     void handleResourceAlert(ResourceType type, double usage);
 
 private slots:
-    void processTaskQueue();
     void monitorWorkers();
     void updateMetrics();
     void handleTaskTimeout();
     void analyzePerformance();
 
 private:
+    enum class TaskState : quint8 {
+        Free,
+        Queued,
+        Active
+    };
+    
+    // 排队或执行中任务的槽位，释放后代数加一
+    struct TaskSlot {
+        quint32 generation = 1;
+        TaskState state = TaskState::Free;
+        qint64 submittedNs = 0;         // MonotonicClock，查询时才换算为 QDateTime
+        qint64 startedNs = 0;
+        TaskInfo info{};                // 已分发的任务函数在执行器中，停止时未执行的会放回
+    };
+    
+    struct CompletedTask {
+        qint64 submittedNs = 0;
+        qint64 startedNs = 0;
+        qint64 completedNs = 0;
+        TaskInfo info{};                // 成功的任务不保留任务函数和资源需求
+    };
+    
     // 核心组件
     ContinuousOptimizer* m_optimizer;
     IntelligentAnalyzer* m_analyzer;
@@ -190,16 +237,24 @@ private:
     QTimer* m_metricsTimer;
     QTimer* m_cleanupTimer;
     
-    // 线程池和工作线程
-    QThreadPool* m_threadPool;
+    // 执行器和工作线程
+    std::unique_ptr<WorkStealingPool> m_executor;
     QHash<QString, WorkerInfo> m_workers;
     mutable QMutex m_workersMutex;
+    int m_nextExecutorThread;
+    int m_roundRobinIndex;
     
-    // 任务管理
-    QQueue<TaskInfo> m_taskQueue;
-    QHash<QString, TaskInfo> m_activeTasks;
-    QHash<QString, TaskInfo> m_completedTasks;
+    // 任务管理（锁顺序：先 m_tasksMutex 后 m_workersMutex）
+    std::vector<TaskSlot> m_taskSlots;
+    std::vector<quint32> m_freeTaskSlots;
+    int m_queuedCount;
+    int m_activeCount;
+    std::vector<CompletedTask> m_completedTasks;    // 固定容量的环形记录
+    quint64 m_completedWritten;
+    int m_completedCount;                           // 环中有效的记录数（过期清理后可能小于容量）
+    QHash<QString, TaskNameStatistics> m_taskStatistics;
     mutable QMutex m_tasksMutex;
+    bool m_dispatching;                 // 执行器运行中，受 m_tasksMutex 保护
     
     // 资源监控
     QHash<ResourceType, ResourceMetrics> m_resourceMetrics;
@@ -221,10 +276,18 @@ private:
     // 性能指标
     BalancingMetrics m_metrics;
     QDateTime m_startTime;
-    int m_taskIdCounter;
     
-    // 私有方法
-    QString generateTaskId();
+    // 私有方法（任务槽位和记录相关的函数要求调用者持有 m_tasksMutex）
+    TaskHandle allocateTaskSlot();
+    TaskSlot* findTaskSlot(TaskHandle handle);
+    const TaskSlot* findTaskSlot(TaskHandle handle) const;
+    void releaseTaskSlot(TaskHandle handle);
+    TaskInfo taskInfoFromSlot(const TaskSlot& slot) const;
+    TaskInfo taskInfoFromRecord(const CompletedTask& record) const;
+    const CompletedTask* findCompletedTask(TaskHandle handle) const;
+    void recordCompletedTask(TaskInfo info, qint64 submittedNs, qint64 startedNs, qint64 completedNs,
+                             const QString& error);
+    // 选择工作线程的函数都要求调用者持有 m_workersMutex
     WorkerInfo* selectWorker(const TaskInfo& task);
     WorkerInfo* selectWorkerRoundRobin();
     WorkerInfo* selectWorkerLeastLoaded();
@@ -232,7 +295,13 @@ private:
     WorkerInfo* selectWorkerResourceBased(const TaskInfo& task);
     WorkerInfo* selectWorkerAdaptive(const TaskInfo& task);
     
-    void executeTask(const TaskInfo& task, WorkerInfo* worker);
+    void startExecutor();
+    void stopExecutor();
+    int placeTask(TaskInfo& task);
+    void dispatchTask(TaskInfo& task);
+    void runTask(TaskHandle handle, std::function<void()>& work);
+    void finishTask(TaskHandle handle, std::function<void()>& work, const QString& error);
+    void releaseWorker(const QString& workerId, int completedDelta, int failedDelta);
     void updateWorkerLoad(const QString& workerId, const QHash<ResourceType, double>& load);
     void updateTaskMetrics(const TaskInfo& task);
     void updateResourceMetrics(ResourceType type, double usage, bool updateHistory);
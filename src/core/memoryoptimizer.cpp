@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <vector>
 
 // 静态成员初始化
 MemoryOptimizer* MemoryOptimizer::s_instance = nullptr;
@@ -578,9 +579,38 @@ QString MemoryOptimizer::getMemoryReport() const
     
     report += QString("\n使用中内存块: %1 个\n").arg(m_allocatedBlocks.size());
     
+    // 组件自行管理的内存
+    const auto components = getComponentMemoryUsage();
+    if (!components.isEmpty()) {
+        report += "\n=== 组件内存 ===\n";
+        for (auto it = components.constBegin(); it != components.constEnd(); ++it) {
+            report += QString("%1: %2 MB").arg(it.key()).arg(it.value().bytes / (1024.0 * 1024.0), 0, 'f', 2);
+            if (it.value().limit > 0) {
+                report += QString(" / %1 MB").arg(it.value().limit / (1024.0 * 1024.0), 0, 'f', 2);
+            }
+            report += "\n";
+        }
+    }
+    
     return report;
 }
 
+void MemoryOptimizer::reportComponentMemory(const QString& component, qint64 bytes, qint64 limit)
+{
+    QMutexLocker locker(&m_componentMutex);
+    
+    ComponentMemoryUsage& usage = m_componentMemory[component];
+    usage.bytes = bytes;
+    usage.limit = limit;
+    usage.reportedAt = QDateTime::currentMSecsSinceEpoch();
+}
+
+QHash<QString, ComponentMemoryUsage> MemoryOptimizer::getComponentMemoryUsage() const
+{
+    QMutexLocker locker(&m_componentMutex);
+    return m_componentMemory;
+}
+
 void MemoryOptimizer::onCleanupTimer()
 {
     if (!m_shutdown) {
@@ -623,4 +653,242 @@ MemoryOptimizerConfig MemoryOptimizer::getConfig() const
 {
     QMutexLocker locker(&m_memoryMutex);
     return m_config;
-}
\ No newline at end of file
+}
+// ===================================================================
+// ConcurrentSlotPool
+// ===================================================================
+
+namespace {
+
+constexpr quint64 SLOT_MASK = 0xFFFFFFFFULL;
+
+quint64 taggedHead(quint64 previous, quint32 topPlusOne)
+{
+    return (((previous >> 32) + 1) << 32) | topPlusOne;
+}
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::atomic<quint64> s_nextSlotPoolId{1};
+
+// 存活的池，线程退出时据此判断缓存能否归还
+QMutex s_slotPoolsMutex;
+QHash<quint64, ConcurrentSlotPool*> s_slotPools;
+
+} // namespace
+
+// 一个线程在一个池上的空闲缓存
+struct ConcurrentSlotPool::ThreadCache {
+    quint64 poolId = 0;
+    int count = 0;
+    quint32 slots[THREAD_CACHE_SLOTS];
+};
+
+// 线程退出时把缓存归还给仍然存在的池
+struct ConcurrentSlotPool::ThreadCacheList {
+    std::vector<std::unique_ptr<ThreadCache>> caches;
+    ThreadCache* last = nullptr;
+
+    ~ThreadCacheList()
+    {
+        QMutexLocker locker(&s_slotPoolsMutex);
+        for (const auto& cache : caches) {
+            ConcurrentSlotPool* pool = s_slotPools.value(cache->poolId);
+            if (pool && cache->count > 0) {
+                pool->pushCached(cache->slots, cache->count);
+            }
+        }
+    }
+};
+
+thread_local ConcurrentSlotPool::ThreadCacheList ConcurrentSlotPool::s_threadCaches;
+
+ConcurrentSlotPool::ConcurrentSlotPool(size_t objectSize, size_t objectAlignment, int maxSlots,
+                                       ObjectFunction construct, ObjectFunction destroy)
+    : m_id(s_nextSlotPoolId.fetch_add(1, std::memory_order_relaxed))
+    , m_objectOffset(alignUp(sizeof(SlotHeader), std::max(objectAlignment, alignof(SlotHeader))))
+    , m_slotStride(alignUp(m_objectOffset + objectSize, std::max(objectAlignment, alignof(SlotHeader))))
+    , m_alignment(std::max(objectAlignment, alignof(SlotHeader)))
+    , m_maxChunks(std::max(1, (maxSlots + CHUNK_SLOTS - 1) / CHUNK_SLOTS))
+    , m_construct(construct)
+    , m_destroy(destroy)
+    , m_chunks(new std::atomic<char*>[m_maxChunks])
+    , m_chunkCount(0)
+    , m_head(0)
+{
+    for (int i = 0; i < m_maxChunks; ++i) {
+        m_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    QMutexLocker locker(&s_slotPoolsMutex);
+    s_slotPools.insert(m_id, this);
+}
+
+ConcurrentSlotPool::~ConcurrentSlotPool()
+{
+    {
+        QMutexLocker locker(&s_slotPoolsMutex);
+        s_slotPools.remove(m_id);
+    }
+
+    const int chunkCount = m_chunkCount.load(std::memory_order_acquire);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        char* memory = m_chunks[chunk].load(std::memory_order_relaxed);
+        for (int i = 0; i < CHUNK_SLOTS; ++i) {
+            m_destroy(memory + i * m_slotStride + m_objectOffset);
+        }
+        ::operator delete(memory, std::align_val_t(m_alignment));
+    }
+}
+
+ConcurrentSlotPool::SlotHeader* ConcurrentSlotPool::header(quint32 index) const
+{
+    char* chunk = m_chunks[index / CHUNK_SLOTS].load(std::memory_order_acquire);
+    return reinterpret_cast<SlotHeader*>(chunk + (index % CHUNK_SLOTS) * m_slotStride);
+}
+
+void* ConcurrentSlotPool::objectOf(quint32 index) const
+{
+    return reinterpret_cast<char*>(header(index)) + m_objectOffset;
+}
+
+quint32 ConcurrentSlotPool::indexOf(const void* object) const
+{
+    return reinterpret_cast<const SlotHeader*>(static_cast<const char*>(object) - m_objectOffset)->index;
+}
+
+// 当前线程在该池上的缓存，第一次使用时创建，同时清掉已销毁的池留下的缓存
+ConcurrentSlotPool::ThreadCache* ConcurrentSlotPool::threadCache()
+{
+    ThreadCacheList& list = s_threadCaches;
+    if (list.last && list.last->poolId == m_id) {
+        return list.last;
+    }
+    for (const auto& cache : list.caches) {
+        if (cache->poolId == m_id) {
+            list.last = cache.get();
+            return cache.get();
+        }
+    }
+
+    {
+        QMutexLocker locker(&s_slotPoolsMutex);
+        list.caches.erase(std::remove_if(list.caches.begin(), list.caches.end(),
+                                         [](const std::unique_ptr<ThreadCache>& cache) {
+                                             return !s_slotPools.contains(cache->poolId);
+                                         }),
+                          list.caches.end());
+    }
+    auto cache = std::make_unique<ThreadCache>();
+    cache->poolId = m_id;
+    list.last = cache.get();
+    list.caches.push_back(std::move(cache));
+    return list.last;
+}
+
+void* ConcurrentSlotPool::acquire()
+{
+    ThreadCache* cache = threadCache();
+    quint32 index;
+    if (cache->count > 0) {
+        index = cache->slots[--cache->count];
+    } else if (!pop(&index) && !grow(&index)) {
+        return nullptr;
+    }
+    return objectOf(index);
+}
+
+void ConcurrentSlotPool::release(void* object)
+{
+    if (!object) return;
+
+    ThreadCache* cache = threadCache();
+    if (cache->count == THREAD_CACHE_SLOTS) {
+        // 较早放入的一半归还全局栈，留下的一半仍是最近用过的
+        constexpr int HALF = THREAD_CACHE_SLOTS / 2;
+        pushCached(cache->slots, HALF);
+        std::copy(cache->slots + HALF, cache->slots + THREAD_CACHE_SLOTS, cache->slots);
+        cache->count -= HALF;
+    }
+    cache->slots[cache->count++] = indexOf(object);
+}
+
+void ConcurrentSlotPool::reserve(int count)
+{
+    QMutexLocker locker(&m_growMutex);
+    quint32 index;
+    while (capacity() < count && addChunk(&index)) {
+        pushChain(index, index);
+    }
+}
+
+bool ConcurrentSlotPool::pop(quint32* index)
+{
+    quint64 head = m_head.load(std::memory_order_acquire);
+    for (;;) {
+        const quint32 top = static_cast<quint32>(head & SLOT_MASK);
+        if (top == 0) {
+            return false;
+        }
+        // 槽位内存在池销毁前不会释放，读到的 next 即使已过时，修改计数也会让 CAS 失败
+        const quint32 next = header(top - 1)->next.load(std::memory_order_relaxed);
+        if (m_head.compare_exchange_weak(head, taggedHead(head, next),
+                                         std::memory_order_acquire, std::memory_order_acquire)) {
+            *index = top - 1;
+            return true;
+        }
+    }
+}
+
+void ConcurrentSlotPool::pushChain(quint32 first, quint32 last)
+{
+    SlotHeader* tail = header(last);
+    quint64 head = m_head.load(std::memory_order_relaxed);
+    do {
+        tail->next.store(static_cast<quint32>(head & SLOT_MASK), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, taggedHead(head, first + 1),
+                                           std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ConcurrentSlotPool::pushCached(const quint32* slots, int count)
+{
+    if (count <= 0) return;
+    for (int i = 0; i + 1 < count; ++i) {
+        header(slots[i])->next.store(slots[i + 1] + 1, std::memory_order_relaxed);
+    }
+    pushChain(slots[0], slots[count - 1]);
+}
+
+bool ConcurrentSlotPool::grow(quint32* index)
+{
+    QMutexLocker locker(&m_growMutex);
+
+    // 等锁期间其他线程可能已经扩容或归还
+    return pop(index) || addChunk(index);
+}
+
+// 新增一块（调用方持有 m_growMutex）：第一个槽位交给调用方，其余作为整条链放入全局栈
+bool ConcurrentSlotPool::addChunk(quint32* index)
+{
+    const int chunk = m_chunkCount.load(std::memory_order_relaxed);
+    if (chunk >= m_maxChunks) {
+        return false;
+    }
+
+    char* memory = static_cast<char*>(::operator new(m_slotStride * CHUNK_SLOTS, std::align_val_t(m_alignment)));
+    const quint32 base = static_cast<quint32>(chunk) * CHUNK_SLOTS;
+    for (int i = 0; i < CHUNK_SLOTS; ++i) {
+        auto* slot = new (memory + i * m_slotStride) SlotHeader;
+        slot->index = base + static_cast<quint32>(i);
+        slot->next.store(i + 1 < CHUNK_SLOTS ? base + static_cast<quint32>(i) + 2 : 0, std::memory_order_relaxed);
+        m_construct(memory + i * m_slotStride + m_objectOffset);
+    }
+    m_chunks[chunk].store(memory, std::memory_order_release);
+    m_chunkCount.store(chunk + 1, std::memory_order_release);
+
+    pushChain(base + 1, base + CHUNK_SLOTS - 1);
+    *index = base;
+    return true;
+}
@@ -11,7 +11,11 @@
 #include <QThread>
 #include <QSharedPointer>
 #include <QWeakPointer>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 /**
  * @brief 内存块类型枚举
@@ -124,6 +128,144 @@ private:
     int m_currentSize;
 };
 
+/**
+ * @brief 无锁槽位池（与类型无关的部分）
+ *
+ * 对象按块连续存放，每块 CHUNK_SLOTS 个槽位，槽位头部是序号和空闲链表指针，对象紧随其后，
+ * 池中对象一直保持构造状态，取出和归还都不分配内存。全局空闲链表是 Treiber 栈，
+ * 栈顶为 64 位标记索引：高 32 位是修改计数，每次修改加一，防止 ABA；低 32 位是槽位序号 + 1（0 表示空）。
+ * 用序号代替指针，64 位原子操作在所有平台上都是无锁的，不依赖双字 CAS。
+ * 每个线程在全局栈前有 THREAD_CACHE_SLOTS 个槽位的本地缓存，取出和归还通常只访问本线程缓存；
+ * 缓存满时把一半槽位连成一条链，一次 CAS 归还全局栈。线程退出时缓存归还给仍然存在的池。
+ * 只有全局栈为空时才加锁新增一块。池销毁时析构所有对象，调用方必须先归还全部对象。
+ */
+class ConcurrentSlotPool
+{
+public:
+    using ObjectFunction = void (*)(void* object);
+
+    static constexpr int CHUNK_SLOTS = 64;
+    static constexpr int THREAD_CACHE_SLOTS = 32;
+
+    /**
+     * @param maxSlots 对象数上限，向上取整到整块
+     * @param construct 新增块时在每个槽位上构造对象
+     * @param destroy 池销毁时析构对象
+     */
+    ConcurrentSlotPool(size_t objectSize, size_t objectAlignment, int maxSlots,
+                       ObjectFunction construct, ObjectFunction destroy);
+    ~ConcurrentSlotPool();
+
+    ConcurrentSlotPool(const ConcurrentSlotPool&) = delete;
+    ConcurrentSlotPool& operator=(const ConcurrentSlotPool&) = delete;
+
+    /**
+     * @brief 取出一个对象，池已达上限时返回 nullptr
+     */
+    void* acquire();
+
+    /**
+     * @brief 归还由 acquire() 取出的对象
+     */
+    void release(void* object);
+
+    /**
+     * @brief 预先创建至少 count 个对象
+     */
+    void reserve(int count);
+
+    int capacity() const { return m_chunkCount.load(std::memory_order_acquire) * CHUNK_SLOTS; }
+    int maxSlots() const { return m_maxChunks * CHUNK_SLOTS; }
+    quint64 id() const { return m_id; }
+
+private:
+    struct SlotHeader {
+        quint32 index;                  // 槽位序号
+        std::atomic<quint32> next;      // 空闲链表中下一个槽位的序号 + 1
+    };
+    struct ThreadCache;
+    struct ThreadCacheList;
+    static thread_local ThreadCacheList s_threadCaches;
+
+    ThreadCache* threadCache();
+
+    SlotHeader* header(quint32 index) const;
+    void* objectOf(quint32 index) const;
+    quint32 indexOf(const void* object) const;
+
+    bool pop(quint32* index);
+    void pushChain(quint32 first, quint32 last);   // first..last 已通过 next 连好
+    void pushCached(const quint32* slots, int count);
+    bool grow(quint32* index);
+    bool addChunk(quint32* index);
+
+    const quint64 m_id;
+    const size_t m_objectOffset;        // 对象相对槽位起始的偏移
+    const size_t m_slotStride;
+    const size_t m_alignment;
+    const int m_maxChunks;
+    const ObjectFunction m_construct;
+    const ObjectFunction m_destroy;
+    std::unique_ptr<std::atomic<char*>[]> m_chunks;
+    std::atomic<int> m_chunkCount;
+    std::atomic<quint64> m_head;        // 修改计数(32) | 栈顶序号 + 1(32)
+    QMutex m_growMutex;
+};
+
+/**
+ * @brief 无锁对象池模板类
+ *
+ * 与 ObjectPool 接口相近，但取出和归还不加锁，对象存放在连续的块中，没有逐个对象的堆分配。
+ * 归还时调用重置回调把对象恢复到可复用的状态（未设置时不做处理）。
+ * T 需要可默认构造；对象不超过 maxSize（向上取整到 ConcurrentSlotPool::CHUNK_SLOTS 的整数倍）
+ */
+template<typename T>
+class LockFreeObjectPool {
+public:
+    using ResetHook = std::function<void(T&)>;
+
+    LockFreeObjectPool(int initialSize = 10, int maxSize = 100, ResetHook resetHook = ResetHook())
+        : m_slots(sizeof(T), alignof(T), maxSize, &constructObject, &destroyObject)
+        , m_resetHook(std::move(resetHook)) {
+        m_slots.reserve(initialSize);
+    }
+
+    /**
+     * @brief 取出一个对象，池已满时返回 nullptr
+     */
+    T* acquire() {
+        return static_cast<T*>(m_slots.acquire());
+    }
+
+    /**
+     * @brief 归还对象，先调用重置回调
+     */
+    void release(T* obj) {
+        if (!obj) return;
+        if (m_resetHook) {
+            m_resetHook(*obj);
+        }
+        m_slots.release(obj);
+    }
+
+    /**
+     * @brief 设置重置回调，需在池开始使用前设置
+     */
+    void setResetHook(ResetHook resetHook) {
+        m_resetHook = std::move(resetHook);
+    }
+
+    int size() const { return m_slots.capacity(); }
+    int maxSize() const { return m_slots.maxSlots(); }
+
+private:
+    static void constructObject(void* object) { new (object) T(); }
+    static void destroyObject(void* object) { static_cast<T*>(object)->~T(); }
+
+    ConcurrentSlotPool m_slots;
+    ResetHook m_resetHook;
+};
+
 /**
  * @brief 内存统计信息结构
  */
@@ -149,6 +291,15 @@ struct MemoryStatistics {
                         poolMissCount(0), poolHitRatio(0.0) {}
 };
 
+/**
+ * @brief 组件自行管理的内存（不经过 allocateMemory 的缓冲区、历史数据等）
+ */
+struct ComponentMemoryUsage {
+    qint64 bytes = 0;                   // 当前占用(字节)
+    qint64 limit = 0;                   // 上限(字节)，0 表示无上限
+    qint64 reportedAt = 0;              // 上报时间(毫秒)
+};
+
 /**
  * @brief 内存优化配置结构
  */
@@ -246,6 +397,29 @@ public:
         return static_cast<ObjectPool<T>*>(it.value().get());
     }
 
+    /**
+     * @brief 获取无锁对象池
+     * @tparam T 对象类型
+     * @param resetHook 首次创建池时使用的重置回调
+     * @return 对象池
+     */
+    template<typename T>
+    std::shared_ptr<LockFreeObjectPool<T>> getLockFreeObjectPool(
+        typename LockFreeObjectPool<T>::ResetHook resetHook = typename LockFreeObjectPool<T>::ResetHook()) {
+        const QString typeName = QString("%1#lockfree").arg(typeid(T).name());
+        QMutexLocker locker(&m_poolsMutex);
+        
+        auto it = m_objectPools.find(typeName);
+        if (it == m_objectPools.end()) {
+            auto pool = std::make_shared<LockFreeObjectPool<T>>(m_config.poolInitialSize, m_config.poolMaxSize,
+                                                                std::move(resetHook));
+            m_objectPools[typeName] = pool;
+            return pool;
+        }
+        
+        return std::static_pointer_cast<LockFreeObjectPool<T>>(it.value());
+    }
+
     /**
      * @brief 创建智能指针
      * @tparam T 对象类型
@@ -256,19 +430,17 @@ public:
     template<typename T, typename... Args>
     QSharedPointer<T> createShared(Args&&... args) {
         if (m_config.enableObjectPools) {
-            ObjectPool<T>* pool = getObjectPool<T>();
-            auto obj = pool->acquire();
-            if (obj) {
-                // 使用placement new重新构造对象
-                new (obj.get()) T(std::forward<Args>(args)...);
-                
-                // 创建自定义删除器，将对象返回到池中
-                auto deleter = [pool](T* ptr) {
-                    ptr->~T();
-                    pool->release(std::unique_ptr<T>(ptr));
-                };
-                
-                return QSharedPointer<T>(obj.release(), deleter);
+            // 池中对象始终处于构造状态，带参数时用移动赋值覆盖
+            if constexpr (sizeof...(Args) == 0 || std::is_move_assignable_v<T>) {
+                std::shared_ptr<LockFreeObjectPool<T>> pool = getLockFreeObjectPool<T>();
+                T* obj = pool->acquire();
+                if (obj) {
+                    if constexpr (sizeof...(Args) > 0) {
+                        *obj = T(std::forward<Args>(args)...);
+                    }
+                    // 删除器持有池，池在最后一个对象归还之后才销毁
+                    return QSharedPointer<T>(obj, [pool](T* ptr) { pool->release(ptr); });
+                }
             }
         }
         
@@ -338,6 +510,20 @@ public:
      */
     QString getMemoryReport() const;
 
+    /**
+     * @brief 上报组件自行管理的内存，同名组件覆盖上一次的值
+     * @param component 组件名
+     * @param bytes 当前占用(字节)
+     * @param limit 上限(字节)，0 表示无上限
+     */
+    void reportComponentMemory(const QString& component, qint64 bytes, qint64 limit = 0);
+
+    /**
+     * @brief 获取各组件上报的内存
+     * @return 组件名到内存占用的映射
+     */
+    QHash<QString, ComponentMemoryUsage> getComponentMemoryUsage() const;
+
 public slots:
     /**
      * @brief 定时清理槽
@@ -440,6 +626,9 @@ private:
     
     mutable QMutex m_memoryMutex;               // 内存互斥锁
     
+    QHash<QString, ComponentMemoryUsage> m_componentMemory; // 组件上报的内存
+    mutable QMutex m_componentMutex;            // 组件内存互斥锁
+    
     MemoryOptimizerConfig m_config;             // 配置
     MemoryStatistics m_statistics;              // 统计信息
     
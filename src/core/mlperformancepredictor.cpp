@@ -2,6 +2,8 @@
 #include "continuousoptimizer.h"
 #include "intelligentanalyzer.h"
 #include "loadbalancer.h"
+#include "../constants.h"
+#include "../utils/numerickernels.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -10,6 +12,7 @@
 #include <QDir>
 #include <QtMath>
 #include <QRandomGenerator>
+#include <QThread>
 #include <algorithm>
 #include <numeric>
 
@@ -38,6 +41,8 @@ MLPerformancePredictor::MLPerformancePredictor(QObject *parent)
     , m_accuratePredictions(0)
     , m_totalAnomalies(0)
     , m_confirmedAnomalies(0)
+    , m_trainingThread(nullptr)
+    , m_trainingInProgress(false)
 {
     // 连接定时器
     connect(m_predictionTimer, &QTimer::timeout, this, &MLPerformancePredictor::performPeriodicPrediction);
@@ -59,6 +64,10 @@ MLPerformancePredictor::MLPerformancePredictor(QObject *parent)
 MLPerformancePredictor::~MLPerformancePredictor()
 {
     stopPrediction();
+    if (m_trainingThread) {
+        m_trainingThread->wait();
+        delete m_trainingThread;
+    }
     saveModelState();
     qDebug() << "[MLPerformancePredictor] 机器学习性能预测器已销毁";
 }
@@ -107,18 +116,22 @@ void MLPerformancePredictor::addDataPoint(const DataPoint& dataPoint)
     while (m_trainingData.size() > m_maxDataPoints) {
         m_trainingData.removeFirst();
     }
+    locker.unlock();
+    
+    // 先用更新前的统计量给新点打分，再把它学习进在线模型，每个点 O(特征数²)
+    QMutexLocker onlineLocker(&m_onlineMutex);
+    const AnomalyDetection anomaly = m_anomalyDetectionEnabled ? scoreAgainstStatistics(dataPoint) : AnomalyDetection{};
+    updateOnlineModels(dataPoint);
+    onlineLocker.unlock();
     
     emit dataPointAdded(dataPoint);
     
-    // 如果启用了异常检测，检查新数据点
-    if (m_anomalyDetectionEnabled) {
-        auto anomaly = checkForAnomaly(dataPoint);
-        if (anomaly.severity > m_anomalyThreshold) {
-            QMutexLocker anomalyLocker(&m_predictionMutex);
-            m_anomalies.append(anomaly);
-            m_totalAnomalies++;
-            emit anomalyDetected(anomaly);
-        }
+    if (anomaly.severity > m_anomalyThreshold) {
+        QMutexLocker anomalyLocker(&m_predictionMutex);
+        m_anomalies.append(anomaly);
+        m_totalAnomalies++;
+        anomalyLocker.unlock();
+        emit anomalyDetected(anomaly);
     }
 }
 
@@ -192,52 +205,7 @@ QList<MLPerformancePredictor::FeatureDefinition> MLPerformancePredictor::getFeat
 
 QHash<QString, double> MLPerformancePredictor::extractFeatures(const QList<DataPoint>& data) const
 {
-    QHash<QString, double> features;
-    
-    if (data.isEmpty()) {
-        return features;
-    }
-    
-    // 收集所有数值特征
-    QHash<QString, QList<double>> metricValues;
-    
-    for (const auto& point : data) {
-        for (auto it = point.features.begin(); it != point.features.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
-        for (auto it = point.targets.begin(); it != point.targets.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
-    }
-    
-    // 计算统计特征
-    for (auto it = metricValues.begin(); it != metricValues.end(); ++it) {
-        const auto& values = it.value();
-        
-        if (values.size() > 1) {
-            double sum = std::accumulate(values.begin(), values.end(), 0.0);
-            double mean = sum / values.size();
-            
-            double variance = 0.0;
-            for (double value : values) {
-                variance += (value - mean) * (value - mean);
-            }
-            variance /= values.size();
-            double stdDev = qSqrt(variance);
-            
-            features[it.key() + "_mean"] = mean;
-            features[it.key() + "_std"] = stdDev;
-            features[it.key() + "_min"] = *std::min_element(values.begin(), values.end());
-            features[it.key() + "_max"] = *std::max_element(values.begin(), values.end());
-            features[it.key() + "_range"] = features[it.key() + "_max"] - features[it.key() + "_min"];
-            
-            if (mean != 0) {
-                features[it.key() + "_cv"] = stdDev / qAbs(mean); // 变异系数
-            }
-        }
-    }
-    
-    return features;
+    return extractStatisticalFeatures(data);
 }
 
 QHash<QString, double> MLPerformancePredictor::extractTrendFeatures(const QList<DataPoint>& data) const
@@ -249,32 +217,28 @@ QHash<QString, double> MLPerformancePredictor::extractTrendFeatures(const QList<
     }
     
     // 计算趋势特征
-    QHash<QString, QList<double>> metricValues;
+    FeatureColumns columns;
     
     for (const auto& point : data) {
-        for (auto it = point.features.begin(); it != point.features.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
-        for (auto it = point.targets.begin(); it != point.targets.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
+        columns.appendAll(point.features);
+        columns.appendAll(point.targets);
     }
     
-    for (auto it = metricValues.begin(); it != metricValues.end(); ++it) {
-        const auto& values = it.value();
+    for (int column = 0; column < columns.columnCount(); ++column) {
+        const auto& values = columns.values(column);
+        const int count = static_cast<int>(values.size());
+        const QString& name = columns.name(column);
         
-        if (values.size() >= 3) {
+        if (count >= 3) {
             // 计算线性趋势
-            double slope = calculateLinearTrend(values);
-            features[it.key() + "_trend"] = slope;
+            features[name + "_trend"] = NumericKernels::linearTrend(values.data(), count).slope;
             
             // 计算变化率
-            double changeRate = (values.last() - values.first()) / qMax(1.0, qAbs(values.first()));
-            features[it.key() + "_change_rate"] = changeRate;
+            double changeRate = (values.back() - values.front()) / qMax(1.0, qAbs(values.front()));
+            features[name + "_change_rate"] = changeRate;
             
             // 计算波动性
-            double volatility = calculateVolatility(values);
-            features[it.key() + "_volatility"] = volatility;
+            features[name + "_volatility"] = qSqrt(NumericKernels::moments(values.data(), count).variance);
         }
     }
     
@@ -309,24 +273,20 @@ QHash<QString, double> MLPerformancePredictor::extractCorrelationFeatures(const
     }
     
     // 计算特征间的相关性
-    QHash<QString, QList<double>> metricValues;
+    FeatureColumns columns;
     
     for (const auto& point : data) {
-        for (auto it = point.features.begin(); it != point.features.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
+        columns.appendAll(point.features);
     }
     
-    QStringList metricNames = metricValues.keys();
-    
-    for (int i = 0; i < metricNames.size(); ++i) {
-        for (int j = i + 1; j < metricNames.size(); ++j) {
-            const QString& metric1 = metricNames[i];
-            const QString& metric2 = metricNames[j];
+    for (int i = 0; i < columns.columnCount(); ++i) {
+        for (int j = i + 1; j < columns.columnCount(); ++j) {
+            const auto& values1 = columns.values(i);
+            const auto& values2 = columns.values(j);
             
-            if (metricValues[metric1].size() == metricValues[metric2].size()) {
-                double correlation = calculateCorrelation(metricValues[metric1], metricValues[metric2]);
-                features[metric1 + "_" + metric2 + "_corr"] = correlation;
+            if (values1.size() == values2.size()) {
+                double correlation = NumericKernels::correlation(values1.data(), values2.data(), static_cast<int>(values1.size()));
+                features[columns.name(i) + "_" + columns.name(j) + "_corr"] = correlation;
             }
         }
     }
@@ -335,20 +295,13 @@ QHash<QString, double> MLPerformancePredictor::extractCorrelationFeatures(const
 }
 
 // 模型训练方法实现
-bool MLPerformancePredictor::trainLinearRegression(const QString& modelName, const QList<DataPoint>& data)
+bool MLPerformancePredictor::trainLinearRegression(ModelConfiguration& model, const QList<DataPoint>& data) const
 {
     if (data.size() < 5) {
         return false;
     }
     
-    // 简化的线性回归实现
-    QMutexLocker locker(&m_modelMutex);
-    
-    auto& model = m_models[modelName];
-    
-    // 提取特征和目标值
-    auto features = extractFeatures(data);
-    
+    // 简化的线性回归实现，只在在线模型尚未热身时作为预测的后备
     if (!data.isEmpty() && !data.first().targets.isEmpty()) {
         QString targetName = data.first().targets.keys().first();
         QList<double> targetValues;
@@ -375,22 +328,18 @@ bool MLPerformancePredictor::trainLinearRegression(const QString& modelName, con
     return false;
 }
 
-bool MLPerformancePredictor::trainPolynomialRegression(const QString& modelName, const QList<DataPoint>& data)
+bool MLPerformancePredictor::trainPolynomialRegression(ModelConfiguration& model, const QList<DataPoint>& data) const
 {
     // 简化实现：使用二次多项式
-    return trainLinearRegression(modelName, data);
+    return trainLinearRegression(model, data);
 }
 
-bool MLPerformancePredictor::trainMovingAverage(const QString& modelName, const QList<DataPoint>& data)
+bool MLPerformancePredictor::trainMovingAverage(ModelConfiguration& model, const QList<DataPoint>& data) const
 {
     if (data.size() < 3) {
         return false;
     }
     
-    QMutexLocker locker(&m_modelMutex);
-    
-    auto& model = m_models[modelName];
-    
     int windowSize = qMin(10, data.size() / 2);
     model.parameters["window_size"] = windowSize;
     
@@ -403,16 +352,12 @@ bool MLPerformancePredictor::trainMovingAverage(const QString& modelName, const
     return false;
 }
 
-bool MLPerformancePredictor::trainExponentialSmoothing(const QString& modelName, const QList<DataPoint>& data)
+bool MLPerformancePredictor::trainExponentialSmoothing(ModelConfiguration& model, const QList<DataPoint>& data) const
 {
     if (data.size() < 3) {
         return false;
     }
     
-    QMutexLocker locker(&m_modelMutex);
-    
-    auto& model = m_models[modelName];
-    
     double alpha = 0.3; // 平滑参数
     model.parameters["alpha"] = alpha;
     
@@ -437,14 +382,16 @@ bool MLPerformancePredictor::trainExponentialSmoothing(const QString& modelName,
     return false;
 }
 
-bool MLPerformancePredictor::trainNeuralNetwork(const QString& modelName, const QList<DataPoint>& data)
+bool MLPerformancePredictor::trainNeuralNetwork(ModelConfiguration& model, const QList<DataPoint>& data) const
 {
     // 简化实现：使用线性回归代替
-    return trainLinearRegression(modelName, data);
+    return trainLinearRegression(model, data);
 }
 
 // 预测方法实现
-MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithLinearRegression(const QString& modelName, const QHash<QString, double>& features) const
+MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithLinearRegression(const QString& modelName,
+                                                                                             const QHash<QString, double>& features,
+                                                                                             const QDateTime& targetTime) const
 {
     PredictionResult result;
     
@@ -454,8 +401,39 @@ MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithLine
         return result;
     }
     
-    const auto& model = m_models[modelName];
+    const auto model = m_models[modelName];
+    locker.unlock();
+    
+    // 在线模型：按当前特征做回归，再沿指数加权趋势外推到目标时间
+    QMutexLocker onlineLocker(&m_onlineMutex);
     
+    const double now = secondsSinceStart(QDateTime::currentDateTime());
+    const double horizon = targetTime.isValid() ? qMax(0.0, secondsSinceStart(targetTime) - now) : 0.0;
+    std::vector<double> input;
+    
+    for (auto it = m_onlineModels.cbegin(); it != m_onlineModels.cend(); ++it) {
+        const OnlineModel& online = it.value();
+        if (online.trend.count() < System::ML_ONLINE_WARMUP_SAMPLES) {
+            continue;
+        }
+        
+        if (online.regression.updates() >= System::ML_ONLINE_WARMUP_SAMPLES && fillOnlineInput(online, features, input)) {
+            result.predictions[it.key()] = online.regression.predict(input.data()) + online.trend.slope() * horizon;
+            result.confidence[it.key()] = online.regression.explainedVariance();
+            result.bounds[it.key()] = 2.0 * online.regression.residualStdDeviation();
+        } else {
+            result.predictions[it.key()] = online.trend.predict(now + horizon);
+            result.confidence[it.key()] = model.confidence;
+        }
+    }
+    onlineLocker.unlock();
+    
+    if (!result.predictions.isEmpty()) {
+        result.modelUsed = modelName;
+        return result;
+    }
+    
+    // 在线模型还没有学够数据点时，使用批量训练得到的参数
     if (model.parameters.contains("slope") && model.parameters.contains("intercept")) {
         double slope = model.parameters["slope"].toDouble();
         double intercept = model.parameters["intercept"].toDouble();
@@ -475,9 +453,11 @@ MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithLine
     return result;
 }
 
-MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithPolynomialRegression(const QString& modelName, const QHash<QString, double>& features) const
+MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithPolynomialRegression(const QString& modelName,
+                                                                                                 const QHash<QString, double>& features,
+                                                                                                 const QDateTime& targetTime) const
 {
-    return predictWithLinearRegression(modelName, features);
+    return predictWithLinearRegression(modelName, features, targetTime);
 }
 
 MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithMovingAverage(const QString& modelName, const QList<DataPoint>& data) const
@@ -552,12 +532,15 @@ MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithExpo
     return result;
 }
 
-MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithNeuralNetwork(const QString& modelName, const QHash<QString, double>& features) const
+MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithNeuralNetwork(const QString& modelName,
+                                                                                          const QHash<QString, double>& features,
+                                                                                          const QDateTime& targetTime) const
 {
-    return predictWithLinearRegression(modelName, features);
+    return predictWithLinearRegression(modelName, features, targetTime);
 }
 
-MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithEnsemble(const QHash<QString, double>& features) const
+MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithEnsemble(const QHash<QString, double>& features,
+                                                                                     const QDateTime& targetTime) const
 {
     PredictionResult result;
     
@@ -570,7 +553,7 @@ MLPerformancePredictor::PredictionResult MLPerformancePredictor::predictWithEnse
         if (it.value().enabled && it.value().accuracy > 0.5) {
             locker.unlock();
             
-            auto prediction = predictWithLinearRegression(it.key(), features);
+            auto prediction = predictWithLinearRegression(it.key(), features, targetTime);
             if (!prediction.predictions.isEmpty()) {
                 predictions.append(prediction);
             }
@@ -634,23 +617,7 @@ double MLPerformancePredictor::calculateLinearTrend(const QList<double>& values)
         return 0.0;
     }
     
-    int n = values.size();
-    double sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0;
-    
-    for (int i = 0; i < n; ++i) {
-        sumX += i;
-        sumY += values[i];
-        sumXY += i * values[i];
-        sumX2 += i * i;
-    }
-    
-    double denominator = n * sumX2 - sumX * sumX;
-    
-    if (qAbs(denominator) < 1e-10) {
-        return 0.0;
-    }
-    
-    return (n * sumXY - sumX * sumY) / denominator;
+    return NumericKernels::linearTrend(values.constData(), values.size()).slope;
 }
 
 double MLPerformancePredictor::calculateVolatility(const QList<double>& values) const
@@ -659,14 +626,7 @@ double MLPerformancePredictor::calculateVolatility(const QList<double>& values)
         return 0.0;
     }
     
-    double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
-    double variance = 0.0;
-    
-    for (double value : values) {
-        variance += (value - mean) * (value - mean);
-    }
-    
-    return qSqrt(variance / values.size());
+    return qSqrt(NumericKernels::moments(values.constData(), values.size()).variance);
 }
 
 double MLPerformancePredictor::calculateCorrelation(const QList<double>& x, const QList<double>& y) const
@@ -675,25 +635,7 @@ double MLPerformancePredictor::calculateCorrelation(const QList<double>& x, cons
         return 0.0;
     }
     
-    int n = x.size();
-    double sumX = std::accumulate(x.begin(), x.end(), 0.0);
-    double sumY = std::accumulate(y.begin(), y.end(), 0.0);
-    double sumXY = 0.0, sumX2 = 0.0, sumY2 = 0.0;
-    
-    for (int i = 0; i < n; ++i) {
-        sumXY += x[i] * y[i];
-        sumX2 += x[i] * x[i];
-        sumY2 += y[i] * y[i];
-    }
-    
-    double numerator = n * sumXY - sumX * sumY;
-    double denominator = qSqrt((n * sumX2 - sumX * sumX) * (n * sumY2 - sumY * sumY));
-    
-    if (qAbs(denominator) < 1e-10) {
-        return 0.0;
-    }
-    
-    return numerator / denominator;
+    return NumericKernels::correlation(x.constData(), y.constData(), x.size());
 }
 
 double MLPerformancePredictor::calculateR2Score(const QList<double>& predicted, const QList<double>& actual) const
@@ -702,14 +644,10 @@ double MLPerformancePredictor::calculateR2Score(const QList<double>& predicted,
         return 0.0;
     }
     
-    double actualMean = std::accumulate(actual.begin(), actual.end(), 0.0) / actual.size();
-    double totalSumSquares = 0.0;
-    double residualSumSquares = 0.0;
-    
-    for (int i = 0; i < actual.size(); ++i) {
-        totalSumSquares += (actual[i] - actualMean) * (actual[i] - actualMean);
-        residualSumSquares += (actual[i] - predicted[i]) * (actual[i] - predicted[i]);
-    }
+    const int n = actual.size();
+    const double actualMean = NumericKernels::sum(actual.constData(), n) / n;
+    const double totalSumSquares = NumericKernels::sumSquaredDeviations(actual.constData(), n, actualMean);
+    const double residualSumSquares = NumericKernels::squaredDistance(actual.constData(), predicted.constData(), n);
     
     if (totalSumSquares == 0.0) {
         return 1.0;
@@ -1071,17 +1009,94 @@ bool MLPerformancePredictor::trainModel(const QString& modelName, const QList<Da
         return false;
     }
     
+    // 在副本上训练，训练期间不持有模型锁，预测不受影响
+    ModelConfiguration model = m_models[modelName];
+    locker.unlock();
+    
     if (trainingData.size() < 10) {
         qWarning() << "[MLPerformancePredictor] 训练数据不足:" << trainingData.size();
         return false;
     }
     
-    auto& model = m_models[modelName];
+    TrainingMetrics metrics{};
+    const bool success = fitModel(model, trainingData, metrics);
+    
+    QList<ModelConfiguration> trained;
+    if (success) {
+        trained.append(model);
+    }
+    commitTrainedModels(trained, {metrics});
+    emitTrainingResults(trained, {metrics});
+    
+    return success;
+}
+
+bool MLPerformancePredictor::trainAllModels()
+{
+    QMutexLocker dataLocker(&m_dataMutex);
+    
+    if (m_trainingData.size() < 20) {
+        qWarning() << "[MLPerformancePredictor] 训练数据不足，无法训练所有模型";
+        return false;
+    }
+    
+    auto trainingData = m_trainingData;
+    dataLocker.unlock();
+    
+    auto models = modelsDueForTraining(false);
+    QList<ModelConfiguration> trained;
+    QList<TrainingMetrics> metrics;
+    
+    for (auto& model : models) {
+        TrainingMetrics modelMetrics{};
+        if (fitModel(model, trainingData, modelMetrics)) {
+            trained.append(model);
+        }
+        metrics.append(modelMetrics);
+    }
+    
+    commitTrainedModels(trained, metrics);
+    emitTrainingResults(trained, metrics);
     
-    TrainingMetrics metrics;
-    metrics.modelName = modelName;
+    qDebug() << "[MLPerformancePredictor] 批量训练完成:" << trained.size() << "/" << models.size();
+    
+    return !trained.isEmpty();
+}
+
+bool MLPerformancePredictor::isTraining() const
+{
+    return m_trainingInProgress.load();
+}
+
+QList<MLPerformancePredictor::ModelConfiguration> MLPerformancePredictor::modelsDueForTraining(bool honourSchedule) const
+{
+    QMutexLocker locker(&m_modelMutex);
+    
+    QList<ModelConfiguration> models;
+    const QDateTime now = QDateTime::currentDateTime();
+    
+    for (const auto& model : m_models) {
+        if (!model.enabled) {
+            continue;
+        }
+        // scheduleRetraining 设置的间隔未到时跳过
+        if (honourSchedule && model.trainedAt.isValid() && model.parameters.contains("retrain_interval")) {
+            const qint64 intervalSecs = model.parameters["retrain_interval"].toLongLong() * 3600;
+            if (model.trainedAt.addSecs(intervalSecs) > now) {
+                continue;
+            }
+        }
+        models.append(model);
+    }
+    
+    return models;
+}
+
+bool MLPerformancePredictor::fitModel(ModelConfiguration& model, const QList<DataPoint>& data, TrainingMetrics& metrics)
+{
+    metrics.modelName = model.name;
     metrics.startTime = QDateTime::currentDateTime();
-    metrics.dataPoints = trainingData.size();
+    metrics.dataPoints = data.size();
     metrics.status = "训练中";
     
     bool success = false;
@@ -1089,19 +1104,19 @@ bool MLPerformancePredictor::trainModel(const QString& modelName, const QList<Da
     // 根据模型类型进行训练
     switch (model.type) {
     case ModelType::LinearRegression:
-        success = trainLinearRegression(modelName, trainingData);
+        success = trainLinearRegression(model, data);
         break;
     case ModelType::PolynomialRegression:
-        success = trainPolynomialRegression(modelName, trainingData);
+        success = trainPolynomialRegression(model, data);
         break;
     case ModelType::MovingAverage:
-        success = trainMovingAverage(modelName, trainingData);
+        success = trainMovingAverage(model, data);
         break;
     case ModelType::ExponentialSmoothing:
-        success = trainExponentialSmoothing(modelName, trainingData);
+        success = trainExponentialSmoothing(model, data);
         break;
     case ModelType::NeuralNetwork:
-        success = trainNeuralNetwork(modelName, trainingData);
+        success = trainNeuralNetwork(model, data);
         break;
     default:
         qWarning() << "[MLPerformancePredictor] 不支持的模型类型:" << static_cast<int>(model.type);
@@ -1112,57 +1127,98 @@ bool MLPerformancePredictor::trainModel(const QString& modelName, const QList<Da
     metrics.status = success ? "训练完成" : "训练失败";
     
     if (success) {
-        model.trainedAt = QDateTime::currentDateTime();
-        model.trainingDataSize = trainingData.size();
+        model.trainedAt = metrics.endTime;
+        model.trainingDataSize = data.size();
         
         // 评估模型性能
-        double accuracy = evaluateModel(modelName, trainingData);
-        model.accuracy = accuracy;
-        metrics.accuracy = accuracy;
-        
-        emit modelTrained(modelName, accuracy);
-        qDebug() << "[MLPerformancePredictor] 模型训练完成:" << modelName << "准确率:" << accuracy;
+        model.accuracy = evaluateModel(model.name, data);
+        metrics.accuracy = model.accuracy;
     }
     
-    m_trainingMetrics[modelName] = metrics;
-    emit trainingCompleted(modelName, metrics);
-    
     return success;
 }
 
-bool MLPerformancePredictor::trainAllModels()
+void MLPerformancePredictor::commitTrainedModels(const QList<ModelConfiguration>& models, const QList<TrainingMetrics>& metrics)
 {
-    QMutexLocker dataLocker(&m_dataMutex);
+    // 一次加锁替换全部结果，预测看到的要么全是旧模型，要么全是新模型
+    QMutexLocker locker(&m_modelMutex);
     
-    if (m_trainingData.size() < 20) {
-        qWarning() << "[MLPerformancePredictor] 训练数据不足，无法训练所有模型";
+    for (const auto& trained : models) {
+        auto it = m_models.find(trained.name);
+        if (it == m_models.end()) {
+            continue;   // 训练期间模型被移除
+        }
+        // 启用状态等配置可能在训练期间被修改，只替换训练产出的字段
+        for (auto param = trained.parameters.begin(); param != trained.parameters.end(); ++param) {
+            it->parameters[param.key()] = param.value();
+        }
+        it->accuracy = trained.accuracy;
+        it->trainedAt = trained.trainedAt;
+        it->trainingDataSize = trained.trainingDataSize;
+    }
+    
+    for (const auto& modelMetrics : metrics) {
+        m_trainingMetrics[modelMetrics.modelName] = modelMetrics;
+    }
+}
+
+void MLPerformancePredictor::emitTrainingResults(const QList<ModelConfiguration>& trained, const QList<TrainingMetrics>& metrics)
+{
+    for (const auto& model : trained) {
+        emit modelTrained(model.name, model.accuracy);
+        qDebug() << "[MLPerformancePredictor] 模型训练完成:" << model.name << "准确率:" << model.accuracy;
+    }
+    for (const auto& modelMetrics : metrics) {
+        emit trainingCompleted(modelMetrics.modelName, modelMetrics);
+    }
+}
+
+bool MLPerformancePredictor::startBackgroundTraining()
+{
+    if (m_trainingInProgress.exchange(true)) {
+        qDebug() << "[MLPerformancePredictor] 上一次后台训练尚未完成，跳过本次重训练";
         return false;
     }
+    // 上一次训练已经结束，线程即将退出
+    if (m_trainingThread) {
+        m_trainingThread->wait();
+        delete m_trainingThread;
+    }
     
-    auto trainingData = m_trainingData;
+    m_trainingThread = QThread::create([this]() { runBackgroundTraining(); });
+    m_trainingThread->setObjectName("MLTraining");
+    m_trainingThread->start(QThread::LowPriority);
+    return true;
+}
+
+void MLPerformancePredictor::runBackgroundTraining()
+{
+    // 在本线程内深拷贝，addDataPoint 之后追加数据时不必再复制整个列表
+    QMutexLocker dataLocker(&m_dataMutex);
+    QList<DataPoint> trainingData = m_trainingData;
+    trainingData.detach();
     dataLocker.unlock();
     
-    QMutexLocker modelLocker(&m_modelMutex);
-    
-    int successCount = 0;
-    int totalCount = 0;
+    auto models = modelsDueForTraining(true);
+    QList<ModelConfiguration> trained;
+    QList<TrainingMetrics> metrics;
     
-    for (auto it = m_models.begin(); it != m_models.end(); ++it) {
-        if (it.value().enabled) {
-            totalCount++;
-            modelLocker.unlock();
-            
-            if (trainModel(it.key(), trainingData)) {
-                successCount++;
-            }
-            
-            modelLocker.relock();
+    for (auto& model : models) {
+        TrainingMetrics modelMetrics{};
+        if (fitModel(model, trainingData, modelMetrics)) {
+            trained.append(model);
         }
+        metrics.append(modelMetrics);
     }
     
-    qDebug() << "[MLPerformancePredictor] 批量训练完成:" << successCount << "/" << totalCount;
+    commitTrainedModels(trained, metrics);
+    m_trainingInProgress.store(false);
     
-    return successCount > 0;
+    // 信号回到预测器所在线程发出
+    QMetaObject::invokeMethod(this, [this, trained, metrics, total = models.size()]() {
+        emitTrainingResults(trained, metrics);
+        qDebug() << "[MLPerformancePredictor] 后台训练完成:" << trained.size() << "/" << total;
+    }, Qt::QueuedConnection);
 }
 
 void MLPerformancePredictor::scheduleRetraining(const QString& modelName, int intervalHours)
@@ -1231,16 +1287,16 @@ MLPerformancePredictor::PredictionResult MLPerformancePredictor::predict(Predict
         return result;
     }
     
-    auto& model = m_models[bestModel];
+    const ModelType modelType = m_models[bestModel].type;
     modelLocker.unlock();
     
     // 根据模型类型进行预测
-    switch (model.type) {
+    switch (modelType) {
     case ModelType::LinearRegression:
-        result = predictWithLinearRegression(bestModel, features);
+        result = predictWithLinearRegression(bestModel, features, targetTime);
         break;
     case ModelType::PolynomialRegression:
-        result = predictWithPolynomialRegression(bestModel, features);
+        result = predictWithPolynomialRegression(bestModel, features, targetTime);
         break;
     case ModelType::MovingAverage:
         result = predictWithMovingAverage(bestModel, recentData);
@@ -1249,10 +1305,10 @@ MLPerformancePredictor::PredictionResult MLPerformancePredictor::predict(Predict
         result = predictWithExponentialSmoothing(bestModel, recentData);
         break;
     case ModelType::NeuralNetwork:
-        result = predictWithNeuralNetwork(bestModel, features);
+        result = predictWithNeuralNetwork(bestModel, features, targetTime);
         break;
     case ModelType::Ensemble:
-        result = predictWithEnsemble(features);
+        result = predictWithEnsemble(features, targetTime);
         break;
     default:
         qWarning() << "[MLPerformancePredictor] 不支持的预测模型类型";
@@ -1337,47 +1393,38 @@ QList<MLPerformancePredictor::AnomalyDetection> MLPerformancePredictor::detectAn
     }
     
     // 计算统计基线
-    QHash<QString, QList<double>> metricValues;
+    FeatureColumns columns;
     
     for (const auto& point : data) {
-        for (auto it = point.features.begin(); it != point.features.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
-        for (auto it = point.targets.begin(); it != point.targets.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
+        columns.appendAll(point.features);
+        columns.appendAll(point.targets);
     }
     
     // 检测每个指标的异常
-    for (auto it = metricValues.begin(); it != metricValues.end(); ++it) {
-        const auto& values = it.value();
+    for (int column = 0; column < columns.columnCount(); ++column) {
+        const auto& values = columns.values(column);
         
         if (values.size() < 5) continue;
         
         // 计算均值和标准差
-        double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
-        double variance = 0.0;
-        
-        for (double value : values) {
-            variance += (value - mean) * (value - mean);
-        }
-        variance /= values.size();
-        double stdDev = qSqrt(variance);
+        const auto stats = NumericKernels::moments(values.data(), static_cast<int>(values.size()));
+        double mean = stats.mean;
+        double stdDev = qSqrt(stats.variance);
         
         // 检查最新值是否异常
-        double latestValue = values.last();
+        double latestValue = values.back();
         double zScore = stdDev > 0 ? qAbs(latestValue - mean) / stdDev : 0.0;
         
         if (zScore > m_anomalyThreshold) {
             AnomalyDetection anomaly;
             anomaly.timestamp = data.last().timestamp;
-            anomaly.metric = it.key();
+            anomaly.metric = columns.name(column);
             anomaly.value = latestValue;
             anomaly.expectedValue = mean;
             anomaly.deviation = zScore;
             anomaly.severity = qMin(10.0, zScore);
             anomaly.description = QString("指标 %1 出现异常，偏离正常值 %2 个标准差")
-                                .arg(it.key()).arg(zScore, 0, 'f', 2);
+                                .arg(anomaly.metric).arg(zScore, 0, 'f', 2);
             anomaly.possibleCause = identifyAnomalyCause(anomaly);
             anomaly.recommendations = generateAnomalyRecommendations(anomaly);
             anomaly.confirmed = false;
@@ -1391,19 +1438,120 @@ QList<MLPerformancePredictor::AnomalyDetection> MLPerformancePredictor::detectAn
 
 MLPerformancePredictor::AnomalyDetection MLPerformancePredictor::checkForAnomaly(const DataPoint& dataPoint)
 {
-    QMutexLocker locker(&m_dataMutex);
+    // 与各指标的指数加权统计比较，不再每次扫描最近的历史数据
+    QMutexLocker locker(&m_onlineMutex);
+    return scoreAgainstStatistics(dataPoint);
+}
+
+MLPerformancePredictor::AnomalyDetection MLPerformancePredictor::scoreAgainstStatistics(const DataPoint& dataPoint) const
+{
+    AnomalyDetection anomaly{};
+    const ExponentialStatistics* worstStatistics = nullptr;
+    double worstScore = 0.0;
+    
+    auto score = [&](const QHash<QString, double>& values) {
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            auto statistics = m_metricStatistics.constFind(it.key());
+            if (statistics == m_metricStatistics.constEnd() || statistics->count() < System::ML_ONLINE_WARMUP_SAMPLES) {
+                continue;
+            }
+            const double zScore = statistics->zScore(it.value());
+            if (zScore > worstScore) {
+                worstScore = zScore;
+                worstStatistics = &statistics.value();
+                anomaly.metric = it.key();
+                anomaly.value = it.value();
+            }
+        }
+    };
+    score(dataPoint.features);
+    score(dataPoint.targets);
+    
+    if (!worstStatistics || worstScore <= m_anomalyThreshold) {
+        return AnomalyDetection{};
+    }
     
-    // 获取最近的数据点进行比较
-    auto recentData = getRecentData(30); // 最近30分钟
-    recentData.append(dataPoint);
+    anomaly.timestamp = dataPoint.timestamp;
+    anomaly.expectedValue = worstStatistics->mean();
+    anomaly.deviation = worstScore;
+    anomaly.severity = qMin(10.0, worstScore);
+    anomaly.description = QString("指标 %1 出现异常，偏离正常值 %2 个标准差")
+                        .arg(anomaly.metric).arg(worstScore, 0, 'f', 2);
+    anomaly.possibleCause = identifyAnomalyCause(anomaly);
+    anomaly.recommendations = generateAnomalyRecommendations(anomaly);
+    anomaly.confirmed = false;
     
-    auto anomalies = detectAnomalies(recentData);
+    return anomaly;
+}
+
+void MLPerformancePredictor::updateOnlineModels(const DataPoint& dataPoint)
+{
+    const double seconds = secondsSinceStart(dataPoint.timestamp);
+    
+    for (auto it = dataPoint.targets.begin(); it != dataPoint.targets.end(); ++it) {
+        auto model = m_onlineModels.find(it.key());
+        if (model == m_onlineModels.end()) {
+            // 特征列表按名称排序后固定下来，之后缺失的特征用其统计均值填充
+            QStringList featureNames = dataPoint.features.keys();
+            featureNames.removeAll(it.key());
+            featureNames.sort();
+            featureNames = featureNames.mid(0, System::ML_ONLINE_MAX_FEATURES);
+            
+            OnlineModel created;
+            created.featureNames = featureNames;
+            created.regression = RecursiveLeastSquares(static_cast<int>(featureNames.size()), System::ML_ONLINE_FORGETTING_FACTOR,
+                                                       1000.0, System::ML_ONLINE_SMOOTHING_ALPHA);
+            created.trend = ExponentialTrend(System::ML_ONLINE_SMOOTHING_ALPHA);
+            model = m_onlineModels.insert(it.key(), created);
+        }
+        
+        if (fillOnlineInput(*model, dataPoint.features, model->input)) {
+            model->regression.update(model->input.data(), it.value());
+        }
+        model->trend.add(seconds, it.value());
+    }
+    
+    auto learn = [this](const QHash<QString, double>& values) {
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            auto statistics = m_metricStatistics.find(it.key());
+            if (statistics == m_metricStatistics.end()) {
+                statistics = m_metricStatistics.insert(it.key(), ExponentialStatistics(System::ML_ONLINE_SMOOTHING_ALPHA));
+            }
+            statistics->add(it.value());
+        }
+    };
+    learn(dataPoint.features);
+    learn(dataPoint.targets);
+}
+
+bool MLPerformancePredictor::fillOnlineInput(const OnlineModel& model, const QHash<QString, double>& features,
+                                             std::vector<double>& input) const
+{
+    // 预测时传入的是 extractFeatures 的统计特征，原始特征名找不到时取其均值
+    input.resize(static_cast<size_t>(model.featureNames.size()));
+    bool found = model.featureNames.isEmpty();
     
-    if (!anomalies.isEmpty()) {
-        return anomalies.last(); // 返回最新的异常
+    for (int i = 0; i < model.featureNames.size(); ++i) {
+        const QString& name = model.featureNames[i];
+        auto value = features.constFind(name);
+        if (value == features.constEnd()) {
+            value = features.constFind(name + "_mean");
+        }
+        if (value != features.constEnd()) {
+            input[i] = value.value();
+            found = true;
+        } else {
+            auto statistics = m_metricStatistics.constFind(name);
+            input[i] = statistics != m_metricStatistics.constEnd() ? statistics->mean() : 0.0;
+        }
     }
     
-    return AnomalyDetection();
+    return found;
+}
+
+double MLPerformancePredictor::secondsSinceStart(const QDateTime& time) const
+{
+    return m_startTime.msecsTo(time) / 1000.0;
 }
 
 void MLPerformancePredictor::setAnomalyThreshold(double threshold)
@@ -1514,8 +1662,6 @@ double MLPerformancePredictor::evaluateModel(const QString& modelName, const QLi
     auto testSet = testData.mid(splitIndex);
     
     for (const auto& testPoint : testSet) {
-        auto features = extractFeatures(trainingSet);
-        
         // 简化的预测（使用移动平均）
         if (!trainingSet.isEmpty() && !testPoint.targets.isEmpty()) {
             QString firstTarget = testPoint.targets.keys().first();
@@ -1623,6 +1769,22 @@ QJsonObject MLPerformancePredictor::getAllModelsReport() const
     report["prediction_accuracy_rate"] = m_totalPredictions > 0 ? 
         static_cast<double>(m_accuratePredictions) / m_totalPredictions : 0.0;
     
+    // 在线模型
+    QMutexLocker onlineLocker(&m_onlineMutex);
+    QJsonArray onlineModels;
+    for (auto it = m_onlineModels.cbegin(); it != m_onlineModels.cend(); ++it) {
+        QJsonObject online;
+        online["target"] = it.key();
+        online["features"] = QJsonArray::fromStringList(it.value().featureNames);
+        online["updates"] = it.value().regression.updates();
+        online["explained_variance"] = it.value().regression.explainedVariance();
+        online["residual_std"] = it.value().regression.residualStdDeviation();
+        online["trend_per_hour"] = it.value().trend.slope() * 3600.0;
+        onlineModels.append(online);
+    }
+    report["online_models"] = onlineModels;
+    report["training_in_progress"] = m_trainingInProgress.load();
+    
     return report;
 }
 
@@ -1892,6 +2054,11 @@ void MLPerformancePredictor::resetToDefaults()
 {
     stopPrediction();
     
+    // 等待后台训练结束，避免它把旧模型写回
+    if (m_trainingThread) {
+        m_trainingThread->wait();
+    }
+    
     // 重置配置
     m_predictionInterval = 60000;
     m_trainingInterval = 3600000;
@@ -1913,6 +2080,11 @@ void MLPerformancePredictor::resetToDefaults()
     m_anomalies.clear();
     predictionLocker.unlock();
     
+    QMutexLocker onlineLocker(&m_onlineMutex);
+    m_onlineModels.clear();
+    m_metricStatistics.clear();
+    onlineLocker.unlock();
+    
     // 重置统计
     m_totalPredictions = 0;
     m_accuratePredictions = 0;
@@ -1994,12 +2166,12 @@ void MLPerformancePredictor::performPrediction()
 void MLPerformancePredictor::retrainModels()
 {
     QMutexLocker dataLocker(&m_dataMutex);
+    const bool enoughData = m_trainingData.size() >= 50;
+    dataLocker.unlock();
     
-    if (m_trainingData.size() >= 50) {
-        auto trainingData = m_trainingData;
-        dataLocker.unlock();
-        
-        trainAllModels();
+    // 在线模型已随数据点更新，这里只在后台重训练批量参数
+    if (enoughData) {
+        startBackgroundTraining();
     }
 }
 
@@ -2151,31 +2323,23 @@ void MLPerformancePredictor::normalizeFeatures(QList<DataPoint>& data) const
     }
     
     // 计算每个特征的统计信息
-    QHash<QString, QList<double>> featureValues;
+    FeatureColumns columns;
     
     for (const auto& point : data) {
-        for (auto it = point.features.begin(); it != point.features.end(); ++it) {
-            featureValues[it.key()].append(it.value());
-        }
+        columns.appendAll(point.features);
     }
     
     // 计算均值和标准差，进行标准化
     QHash<QString, QPair<double, double>> normalizationParams;
     
-    for (auto it = featureValues.begin(); it != featureValues.end(); ++it) {
-        const auto& values = it.value();
+    for (int column = 0; column < columns.columnCount(); ++column) {
+        const auto& values = columns.values(column);
         
         if (values.size() > 1) {
-            double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
-            double variance = 0.0;
-            
-            for (double value : values) {
-                variance += (value - mean) * (value - mean);
-            }
-            variance /= values.size();
-            double stdDev = qSqrt(variance);
+            const auto stats = NumericKernels::moments(values.data(), static_cast<int>(values.size()));
+            double stdDev = qSqrt(stats.variance);
             
-            normalizationParams[it.key()] = qMakePair(mean, stdDev > 0 ? stdDev : 1.0);
+            normalizationParams[columns.name(column)] = qMakePair(stats.mean, stdDev > 0 ? stdDev : 1.0);
         }
     }
     
@@ -2212,23 +2376,16 @@ QHash<QString, double> MLPerformancePredictor::calculateStatistics(const QList<D
         return stats;
     }
     
-    // 计算基本统计量
-    std::sort(values.begin(), values.end());
-    
-    double sum = std::accumulate(values.begin(), values.end(), 0.0);
-    double mean = sum / values.size();
-    
-    double variance = 0.0;
-    for (double value : values) {
-        variance += (value - mean) * (value - mean);
-    }
-    variance /= values.size();
+    // 计算基本统计量，中位数只需部分排序
+    const auto moments = NumericKernels::moments(values.constData(), values.size());
+    auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
     
-    stats["mean"] = mean;
-    stats["std_dev"] = qSqrt(variance);
-    stats["min"] = values.first();
-    stats["max"] = values.last();
-    stats["median"] = values[values.size() / 2];
+    stats["mean"] = moments.mean;
+    stats["std_dev"] = qSqrt(moments.variance);
+    stats["min"] = moments.minimum;
+    stats["max"] = moments.maximum;
+    stats["median"] = *middle;
     stats["count"] = values.size();
     
     return stats;
@@ -2284,41 +2441,31 @@ QHash<QString, double> MLPerformancePredictor::extractStatisticalFeatures(const
         return features;
     }
     
-    // 收集所有数值特征
-    QHash<QString, QList<double>> metricValues;
+    // 收集所有数值特征，每个特征一列连续数组
+    FeatureColumns columns;
     
     for (const auto& point : data) {
-        for (auto it = point.features.begin(); it != point.features.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
-        for (auto it = point.targets.begin(); it != point.targets.end(); ++it) {
-            metricValues[it.key()].append(it.value());
-        }
+        columns.appendAll(point.features);
+        columns.appendAll(point.targets);
     }
     
     // 计算统计特征
-    for (auto it = metricValues.begin(); it != metricValues.end(); ++it) {
-        const auto& values = it.value();
+    for (int column = 0; column < columns.columnCount(); ++column) {
+        const auto& values = columns.values(column);
         
         if (values.size() > 1) {
-            double sum = std::accumulate(values.begin(), values.end(), 0.0);
-            double mean = sum / values.size();
-            
-            double variance = 0.0;
-            for (double value : values) {
-                variance += (value - mean) * (value - mean);
-            }
-            variance /= values.size();
-            double stdDev = qSqrt(variance);
+            const auto stats = NumericKernels::moments(values.data(), static_cast<int>(values.size()));
+            const double stdDev = qSqrt(stats.variance);
+            const QString& name = columns.name(column);
             
-            features[it.key() + "_mean"] = mean;
-            features[it.key() + "_std"] = stdDev;
-            features[it.key() + "_min"] = *std::min_element(values.begin(), values.end());
-            features[it.key() + "_max"] = *std::max_element(values.begin(), values.end());
-            features[it.key() + "_range"] = features[it.key() + "_max"] - features[it.key() + "_min"];
+            features[name + "_mean"] = stats.mean;
+            features[name + "_std"] = stdDev;
+            features[name + "_min"] = stats.minimum;
+            features[name + "_max"] = stats.maximum;
+            features[name + "_range"] = stats.maximum - stats.minimum;
             
-            if (mean != 0) {
-                features[it.key() + "_cv"] = stdDev / qAbs(mean); // 变异系数
+            if (stats.mean != 0) {
+                features[name + "_cv"] = stdDev / qAbs(stats.mean); // 变异系数
             }
         }
     }
@@ -10,7 +10,12 @@
 #include <QVector>
 #include <QHash>
 #include <QQueue>
+#include <atomic>
 #include <functional>
+#include <vector>
+#include "../utils/onlineregression.h"
+
+class QThread;
 
 class ContinuousOptimizer;
 class IntelligentAnalyzer;
@@ -166,8 +171,11 @@ explicit MLPerformancePredictor(QObject *parent = nullptr);
     QHash<QString, double> extractFeatures(const QList<DataPoint>& data) const;
     
     // 模型训练
+    // 在线模型随 addDataPoint 增量更新；下面的批量训练在调用线程上同步执行，
+    // 定时重训练（retrainModels）在后台线程执行，完成后一次性替换模型
     bool trainModel(const QString& modelName, const QList<DataPoint>& trainingData);
     bool trainAllModels();
+    bool isTraining() const;
     void scheduleRetraining(const QString& modelName, int intervalHours);
     TrainingMetrics getTrainingMetrics(const QString& modelName) const;
     
@@ -285,6 +293,22 @@ private:
     int m_totalAnomalies;
     int m_confirmedAnomalies;
     
+    // 在线模型：每个预测目标一个，特征列表在第一次见到该目标时确定
+    struct OnlineModel {
+        QStringList featureNames;
+        RecursiveLeastSquares regression;
+        ExponentialTrend trend;             // 目标值对时间（秒）的趋势
+        std::vector<double> input;          // 组装特征向量用，避免每次分配
+    };
+    
+    QHash<QString, OnlineModel> m_onlineModels;
+    QHash<QString, ExponentialStatistics> m_metricStatistics;   // 每个特征和目标的指数加权统计，用于异常检测和缺失特征填充
+    mutable QMutex m_onlineMutex;
+    
+    // 后台批量训练
+    QThread* m_trainingThread;
+    std::atomic<bool> m_trainingInProgress;
+    
     // 私有方法 - 数据处理
     void preprocessData(QList<DataPoint>& data) const;
     void normalizeFeatures(QList<DataPoint>& data) const;
@@ -298,25 +322,44 @@ private:
     QHash<QString, double> extractSeasonalFeatures(const QList<DataPoint>& data) const;
     QHash<QString, double> extractCorrelationFeatures(const QList<DataPoint>& data) const;
     
+    // 私有方法 - 在线学习（调用方持有 m_onlineMutex）
+    void updateOnlineModels(const DataPoint& dataPoint);
+    AnomalyDetection scoreAgainstStatistics(const DataPoint& dataPoint) const;
+    bool fillOnlineInput(const OnlineModel& model, const QHash<QString, double>& features,
+                         std::vector<double>& input) const;
+    double secondsSinceStart(const QDateTime& time) const;
+    
+    // 私有方法 - 批量训练
+    QList<ModelConfiguration> modelsDueForTraining(bool honourSchedule) const;
+    bool fitModel(ModelConfiguration& model, const QList<DataPoint>& data, TrainingMetrics& metrics);
+    void commitTrainedModels(const QList<ModelConfiguration>& models, const QList<TrainingMetrics>& metrics);
+    void emitTrainingResults(const QList<ModelConfiguration>& trained, const QList<TrainingMetrics>& metrics);
+    bool startBackgroundTraining();
+    void runBackgroundTraining();
+    
     // 私有方法 - 模型实现
     PredictionResult predictWithLinearRegression(const QString& modelName, 
-                                                const QHash<QString, double>& features) const;
+                                                const QHash<QString, double>& features,
+                                                const QDateTime& targetTime) const;
     PredictionResult predictWithPolynomialRegression(const QString& modelName, 
-                                                    const QHash<QString, double>& features) const;
+                                                    const QHash<QString, double>& features,
+                                                    const QDateTime& targetTime) const;
     PredictionResult predictWithMovingAverage(const QString& modelName, 
                                              const QList<DataPoint>& recentData) const;
     PredictionResult predictWithExponentialSmoothing(const QString& modelName, 
                                                     const QList<DataPoint>& recentData) const;
     PredictionResult predictWithNeuralNetwork(const QString& modelName, 
-                                             const QHash<QString, double>& features) const;
-    PredictionResult predictWithEnsemble(const QHash<QString, double>& features) const;
-    
-    // 私有方法 - 训练算法
-    bool trainLinearRegression(const QString& modelName, const QList<DataPoint>& data);
-    bool trainPolynomialRegression(const QString& modelName, const QList<DataPoint>& data);
-    bool trainMovingAverage(const QString& modelName, const QList<DataPoint>& data);
-    bool trainExponentialSmoothing(const QString& modelName, const QList<DataPoint>& data);
-    bool trainNeuralNetwork(const QString& modelName, const QList<DataPoint>& data);
+                                             const QHash<QString, double>& features,
+                                             const QDateTime& targetTime) const;
+    PredictionResult predictWithEnsemble(const QHash<QString, double>& features,
+                                         const QDateTime& targetTime) const;
+    
+    // 私有方法 - 训练算法（只修改传入的模型副本，不加锁）
+    bool trainLinearRegression(ModelConfiguration& model, const QList<DataPoint>& data) const;
+    bool trainPolynomialRegression(ModelConfiguration& model, const QList<DataPoint>& data) const;
+    bool trainMovingAverage(ModelConfiguration& model, const QList<DataPoint>& data) const;
+    bool trainExponentialSmoothing(ModelConfiguration& model, const QList<DataPoint>& data) const;
+    bool trainNeuralNetwork(ModelConfiguration& model, const QList<DataPoint>& data) const;
     
     // 私有方法 - 异常检测
     double calculateAnomalyScore(const DataPoint& dataPoint) const;
@@ -1,5 +1,6 @@
 #include "performanceanalyzer.h"
 #include "performancemonitor.h"
+#include "../utils/monotonicclock.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -8,6 +9,57 @@
 #include <QDebug>
 #include <QtMath>
 #include <algorithm>
+#include <iterator>
+
+namespace {
+
+// 增量维护趋势的指标，顺序与 m_trendStates 一致
+const char* const TREND_METRICS[] = {"cpuUsage", "memoryUsage", "diskUsage", "appMemoryUsage"};
+
+// 固定时间窗（小时），升序，最后一个决定保留多久的样本；2 小时供内存泄露检查使用
+const int TREND_HORIZON_HOURS[] = {1, 2, 6, 24};
+
+constexpr int MIN_TREND_SAMPLES = 10;
+constexpr qint64 NS_PER_HOUR = 3600LL * 1000000000LL;
+
+int trendMetricIndex(const QString& metric)
+{
+    for (int i = 0; i < int(std::size(TREND_METRICS)); ++i) {
+        if (metric == QLatin1String(TREND_METRICS[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int trendHorizonIndex(int hours)
+{
+    for (int i = 0; i < int(std::size(TREND_HORIZON_HOURS)); ++i) {
+        if (TREND_HORIZON_HOURS[i] == hours) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// metricIndex 为 TREND_METRICS 的下标
+double trendValue(const PerformanceMetrics& metrics, int metricIndex)
+{
+    switch (metricIndex) {
+    case 0: return metrics.cpuUsage;
+    case 1: return metrics.memoryUsage;
+    case 2: return metrics.diskUsage;
+    default: return double(metrics.appMemoryUsage) / (1024.0 * 1024.0); // 转换为MB
+    }
+}
+
+// 回归的 x：相对时钟锚点的秒数
+double sampleX(qint64 timestampNs)
+{
+    return double(timestampNs - MonotonicClock::anchorMonotonicNs()) / 1e9;
+}
+
+}
 
 PerformanceAnalyzer::PerformanceAnalyzer(QObject* parent)
     : QObject(parent)
@@ -19,6 +71,15 @@ PerformanceAnalyzer::PerformanceAnalyzer(QObject* parent)
     , m_diskUsageThreshold(85.0)
     , m_responseTimeThreshold(100.0)
 {
+    static_assert(int(std::size(TREND_METRICS)) == TREND_METRIC_COUNT, "TREND_METRICS must match m_trendStates");
+    static_assert(int(std::size(TREND_HORIZON_HOURS)) == TREND_HORIZON_COUNT, "TREND_HORIZON_HOURS must match horizons");
+    for (MetricTrendState& state : m_trendStates) {
+        for (int i = 0; i < TREND_HORIZON_COUNT; ++i) {
+            state.horizons[i].spanNs = TREND_HORIZON_HOURS[i] * NS_PER_HOUR;
+        }
+    }
+    seedTrendStates();
+    
     // 连接性能监控器
     connect(PerformanceMonitor::getInstance(), &PerformanceMonitor::metricsUpdated,
             this, &PerformanceAnalyzer::onMetricsUpdated);
@@ -55,16 +116,15 @@ QList<PerformanceAnalyzer::PerformanceTrend> PerformanceAnalyzer::analyzeTrends(
 
 PerformanceAnalyzer::PerformanceTrend PerformanceAnalyzer::getMetricTrend(const QString& metric, int hoursBack) const
 {
-    PerformanceTrend trend;
-    trend.metric = metric;
-    
-    QList<double> values = getMetricValues(metric, hoursBack);
-    if (values.size() < 10) {
-        return trend; // 数据不足
+    const TrendStatistics statistics = trendStatistics(metric, hoursBack);
+    if (statistics.count < MIN_TREND_SAMPLES) {
+        return PerformanceTrend(); // 数据不足
     }
     
-    trend.trend = calculateTrend(values);
-    trend.changeRate = calculateChangeRate(values);
+    PerformanceTrend trend;
+    trend.metric = metric;
+    trend.trend = calculateTrend(statistics);
+    trend.changeRate = statistics.changeRate;
     trend.startTime = QDateTime::currentDateTime().addSecs(-hoursBack * 3600);
     trend.endTime = QDateTime::currentDateTime();
     
@@ -80,7 +140,7 @@ PerformanceAnalyzer::PerformanceTrend PerformanceAnalyzer::getMetricTrend(const
         trend.description = QString("%1 呈下降趋势，下降率: %2%").arg(metric).arg(qAbs(trend.changeRate), 0, 'f', 2);
         break;
     case TrendType::Volatile:
-        trend.description = QString("%1 波动较大，标准差: %2").arg(metric).arg(trend.changeRate, 0, 'f', 2);
+        trend.description = QString("%1 波动较大，标准差: %2").arg(metric).arg(statistics.stdDeviation, 0, 'f', 2);
         break;
     }
     
@@ -299,6 +359,8 @@ QStringList PerformanceAnalyzer::getHealthIssues() const
 
 void PerformanceAnalyzer::onMetricsUpdated(const PerformanceMetrics& metrics)
 {
+    recordMetrics(metrics);
+    
     // 实时检查是否需要触发智能告警
     if (m_smartAlertsEnabled) {
         detectAnomalies();
@@ -328,40 +390,139 @@ void PerformanceAnalyzer::performAnalysis()
 }
 
 // 私有方法实现...
-PerformanceAnalyzer::TrendType PerformanceAnalyzer::calculateTrend(const QList<double>& values) const
+void PerformanceAnalyzer::seedTrendStates()
 {
-    if (values.size() < 3) return TrendType::Stable;
-    
-    double stdDev = getStandardDeviation(values);
-    double mean = getAverageValue(values);
+    // 启动时按监控历史补齐最长时间窗，之后只随 metricsUpdated 增量更新
+    const QDateTime cutoff = QDateTime::currentDateTime().addSecs(
+        -qint64(TREND_HORIZON_HOURS[TREND_HORIZON_COUNT - 1]) * 3600);
+    const QList<PerformanceMetrics> history =
+        PerformanceMonitor::getInstance()->getMetricsByTimeRange(cutoff, QDateTime());
+    for (const PerformanceMetrics& metrics : history) {
+        recordMetrics(metrics);
+    }
+}
+
+void PerformanceAnalyzer::recordMetrics(const PerformanceMetrics& metrics)
+{
+    const qint64 timestampNs = metrics.timestamp.isValid()
+        ? MonotonicClock::fromEpochMs(metrics.timestamp.toMSecsSinceEpoch())
+        : MonotonicClock::nowNs();
+    for (int i = 0; i < TREND_METRIC_COUNT; ++i) {
+        recordSample(m_trendStates[i], timestampNs, trendValue(metrics, i));
+    }
+}
+
+PerformanceAnalyzer::TrendStatistics PerformanceAnalyzer::trendStatistics(const QString& metric, int hoursBack) const
+{
+    TrendStatistics statistics;
+    const int metricIndex = trendMetricIndex(metric);
+    const int horizonIndex = trendHorizonIndex(hoursBack);
     
-    // 如果标准差相对于均值过大，认为是波动
-    if (stdDev / mean > 0.3) {
-        return TrendType::Volatile;
+    if (metricIndex >= 0 && horizonIndex >= 0) {
+        MetricTrendState& state = m_trendStates[metricIndex];
+        expireSamples(state, MonotonicClock::nowNs());
+        
+        const TrendHorizon& horizon = state.horizons[horizonIndex];
+        const RollingRegression& regression = horizon.regression;
+        statistics.count = regression.count();
+        statistics.mean = regression.meanY();
+        statistics.stdDeviation = regression.stdDeviationY();
+        if (regression.count() >= 2) {
+            const MetricSample& first = state.samples[size_t(horizon.firstSequence - state.frontSequence)];
+            const double start = regression.predict(sampleX(first.timestampNs));
+            const double end = regression.predict(sampleX(state.samples.back().timestampNs));
+            statistics.changeRate = qFuzzyIsNull(start) ? 0.0 : (end - start) / start * 100.0;
+        }
+        return statistics;
     }
     
-    // 计算线性趋势
-    double changeRate = calculateChangeRate(values);
+    // 非固定时长：取监控历史现算，样本按等间隔处理
+    const QList<double> values = getMetricValues(metric, hoursBack);
+    RollingRegression regression;
+    for (int i = 0; i < values.size(); ++i) {
+        regression.add(i, values[i]);
+    }
+    statistics.count = regression.count();
+    statistics.mean = regression.meanY();
+    statistics.stdDeviation = regression.stdDeviationY();
+    if (regression.count() >= 2) {
+        const double start = regression.predict(0.0);
+        const double end = regression.predict(values.size() - 1);
+        statistics.changeRate = qFuzzyIsNull(start) ? 0.0 : (end - start) / start * 100.0;
+    }
+    return statistics;
+}
+
+void PerformanceAnalyzer::recordSample(MetricTrendState& state, qint64 timestampNs, double value)
+{
+    // 墙钟回拨时保持样本时间单调，时间窗淘汰依赖这一点
+    if (!state.samples.empty()) {
+        timestampNs = qMax(timestampNs, state.samples.back().timestampNs);
+    }
+    state.samples.push_back({timestampNs, value});
     
-    if (qAbs(changeRate) < 5.0) {
-        return TrendType::Stable;
-    } else if (changeRate > 0) {
-        return TrendType::Increasing;
-    } else {
-        return TrendType::Decreasing;
+    const double x = sampleX(timestampNs);
+    for (TrendHorizon& horizon : state.horizons) {
+        horizon.regression.add(x, value);
     }
+    expireSamples(state, timestampNs);
 }
 
-double PerformanceAnalyzer::calculateChangeRate(const QList<double>& values) const
+void PerformanceAnalyzer::expireSamples(MetricTrendState& state, qint64 nowNs)
 {
-    if (values.size() < 2) return 0.0;
+    const qint64 endSequence = state.frontSequence + qint64(state.samples.size());
+    for (TrendHorizon& horizon : state.horizons) {
+        const qint64 cutoffNs = nowNs - horizon.spanNs;
+        while (horizon.firstSequence < endSequence) {
+            const MetricSample& sample = state.samples[size_t(horizon.firstSequence - state.frontSequence)];
+            if (sample.timestampNs >= cutoffNs) {
+                break;
+            }
+            horizon.regression.removeOldest(sampleX(sample.timestampNs), sample.value);
+            ++horizon.firstSequence;
+            ++horizon.removalsSinceSync;
+        }
+        
+        // 反向更新会累积舍入误差，移除的样本数达到窗口大小时按样本重算一次，均摊仍为 O(1)
+        if (horizon.removalsSinceSync > 0 && horizon.removalsSinceSync >= horizon.regression.count()) {
+            resynchronize(state, horizon);
+        }
+    }
     
-    double first = values.first();
-    double last = values.last();
+    // 最长时间窗之前的样本不再被任何时间窗引用
+    const qint64 oldestSequence = state.horizons[TREND_HORIZON_COUNT - 1].firstSequence;
+    while (state.frontSequence < oldestSequence) {
+        state.samples.pop_front();
+        ++state.frontSequence;
+    }
+}
+
+void PerformanceAnalyzer::resynchronize(const MetricTrendState& state, TrendHorizon& horizon)
+{
+    horizon.regression.clear();
+    for (size_t i = size_t(horizon.firstSequence - state.frontSequence); i < state.samples.size(); ++i) {
+        horizon.regression.add(sampleX(state.samples[i].timestampNs), state.samples[i].value);
+    }
+    horizon.removalsSinceSync = 0;
+}
+
+PerformanceAnalyzer::TrendType PerformanceAnalyzer::calculateTrend(const TrendStatistics& statistics) const
+{
+    if (statistics.count < 3) return TrendType::Stable;
     
-    if (first == 0.0) return 0.0;
+    // 如果标准差相对于均值过大，认为是波动
+    if (statistics.mean > 0.0 && statistics.stdDeviation / statistics.mean > 0.3) {
+        return TrendType::Volatile;
+    }
     
-    return ((last - first) / first) * 100.0;
+    // 回归直线的变化率
+    if (qAbs(statistics.changeRate) < 5.0) {
+        return TrendType::Stable;
+    } else if (statistics.changeRate > 0) {
+        return TrendType::Increasing;
+    } else {
+        return TrendType::Decreasing;
+    }
 }
 
 void PerformanceAnalyzer::detectAnomalies()
@@ -385,12 +546,18 @@ void PerformanceAnalyzer::updatePerformanceScore()
 void PerformanceAnalyzer::checkMemoryLeaks()
 {
     // 检查内存泄露的逻辑
-    QList<double> memoryValues = getMetricValues("memoryUsage", 2); // 2小时内的数据
-    if (memoryValues.size() > 10) {
-        TrendType trend = calculateTrend(memoryValues);
-        double changeRate = calculateChangeRate(memoryValues);
+    const TrendStatistics statistics = trendStatistics("memoryUsage", 2); // 2小时内的数据
+    if (statistics.count > MIN_TREND_SAMPLES) {
+        TrendType trend = calculateTrend(statistics);
         
-        if (trend == TrendType::Increasing && changeRate > 15.0) {
+        if (trend == TrendType::Increasing && statistics.changeRate > 15.0) {
+            // 每次采样都会检查，同类告警处理前不重复产生
+            for (const SmartAlert& active : m_activeAlerts) {
+                if (!active.resolved && active.id.startsWith("memory_leak_")) {
+                    return;
+                }
+            }
+            
             SmartAlert alert;
             alert.id = "memory_leak_" + QDateTime::currentDateTime().toString("yyyyMMddhhmmss");
             alert.message = "检测到可能的内存泄露";
@@ -422,51 +589,15 @@ void PerformanceAnalyzer::checkResponseTime()
 
 QList<double> PerformanceAnalyzer::getMetricValues(const QString& metric, int hoursBack) const
 {
-    QList<double> values;
-    
+    // 历史记录按时间二分定位，只拷贝需要的一列
     QDateTime cutoff = QDateTime::currentDateTime().addSecs(-hoursBack * 3600);
-    QList<PerformanceMetrics> history = PerformanceMonitor::getInstance()->getHistoryMetrics(1000);
+    QList<double> values = PerformanceMonitor::getInstance()->getMetricValues(metric, cutoff);
     
-    for (const auto& metrics : history) {
-        if (metrics.timestamp < cutoff) continue;
-        
-        if (metric == "cpuUsage") {
-            values.append(metrics.cpuUsage);
-        } else if (metric == "memoryUsage") {
-            values.append(metrics.memoryUsage);
-        } else if (metric == "diskUsage") {
-            values.append(metrics.diskUsage);
-        } else if (metric == "appMemoryUsage") {
-            values.append(metrics.appMemoryUsage / (1024.0 * 1024.0)); // 转换为MB
+    if (metric == "appMemoryUsage") {
+        for (double& value : values) {
+            value /= 1024.0 * 1024.0; // 转换为MB
         }
     }
     
     return values;
 }
-
-double PerformanceAnalyzer::getAverageValue(const QList<double>& values) const
-{
-    if (values.isEmpty()) return 0.0;
-    
-    double sum = 0.0;
-    for (double value : values) {
-        sum += value;
-    }
-    
-    return sum / values.size();
-}
-
-double PerformanceAnalyzer::getStandardDeviation(const QList<double>& values) const
-{
-    if (values.size() < 2) return 0.0;
-    
-    double mean = getAverageValue(values);
-    double sumSquaredDiff = 0.0;
-    
-    for (double value : values) {
-        double diff = value - mean;
-        sumSquaredDiff += diff * diff;
-    }
-    
-    return qSqrt(sumSquaredDiff / (values.size() - 1));
-}
\ No newline at end of file
@@ -5,7 +5,9 @@
 #include <QMap>
 #include <QDateTime>
 #include <QStringList>
+#include <deque>
 #include "performancemonitor.h"
+#include "../utils/rollingregression.h"
 
 /**
  * @brief 性能分析器 - 新增功能
@@ -15,6 +17,10 @@
  * - 智能性能预警
  * - 自动性能优化建议
  * - 性能报告生成
+ *
+ * 趋势按样本到达增量维护：每个指标保留最长时间窗内的样本，每个固定时间窗（1/2/6/24 小时）
+ * 各有一份 RollingRegression，样本到达时加入、离开时间窗时移除，analyzeTrends() 和智能预警
+ * 检查直接读取回归结果，不再每次取出历史重新计算。其他时长仍按监控历史现算。
  */
 class PerformanceAnalyzer : public QObject
 {
@@ -55,7 +61,7 @@ public:
     explicit PerformanceAnalyzer(QObject* parent = nullptr);
     ~PerformanceAnalyzer();
 
-    // 趋势分析
+    // 趋势分析（hoursBack 为固定时间窗之一时 O(1)）
     QList<PerformanceTrend> analyzeTrends(int hoursBack = 24) const;
     PerformanceTrend getMetricTrend(const QString& metric, int hoursBack = 24) const;
     
@@ -91,9 +97,46 @@ private slots:
     void performAnalysis();
 
 private:
+    static constexpr int TREND_METRIC_COUNT = 4;
+    static constexpr int TREND_HORIZON_COUNT = 4;
+
+    struct MetricSample {
+        qint64 timestampNs;         // 单调时钟
+        double value;
+    };
+
+    // 一个固定时间窗的回归状态，窗口是 MetricTrendState::samples 的一段后缀
+    struct TrendHorizon {
+        qint64 spanNs = 0;
+        qint64 firstSequence = 0;       // 窗口内最旧样本的序号
+        qint64 removalsSinceSync = 0;
+        RollingRegression regression;
+    };
+
+    struct MetricTrendState {
+        std::deque<MetricSample> samples;   // 最长时间窗内的样本
+        qint64 frontSequence = 0;           // samples.front() 的序号
+        TrendHorizon horizons[TREND_HORIZON_COUNT];
+    };
+
+    // 一个时间窗内的统计结果
+    struct TrendStatistics {
+        qint64 count = 0;
+        double mean = 0.0;
+        double stdDeviation = 0.0;
+        double changeRate = 0.0;        // 回归直线在首尾样本之间的变化率 (%)
+    };
+
+    // 增量趋势状态
+    void seedTrendStates();
+    void recordMetrics(const PerformanceMetrics& metrics);
+    TrendStatistics trendStatistics(const QString& metric, int hoursBack) const;
+    static void recordSample(MetricTrendState& state, qint64 timestampNs, double value);
+    static void expireSamples(MetricTrendState& state, qint64 nowNs);
+    static void resynchronize(const MetricTrendState& state, TrendHorizon& horizon);
+
     // 分析方法
-    TrendType calculateTrend(const QList<double>& values) const;
-    double calculateChangeRate(const QList<double>& values) const;
+    TrendType calculateTrend(const TrendStatistics& statistics) const;
     void detectAnomalies();
     void updatePerformanceScore();
     
@@ -105,8 +148,6 @@ private:
     
     // 数据处理
     QList<double> getMetricValues(const QString& metric, int hoursBack) const;
-    double getAverageValue(const QList<double>& values) const;
-    double getStandardDeviation(const QList<double>& values) const;
 
     QTimer* m_analysisTimer;
     QList<SmartAlert> m_activeAlerts;
@@ -114,6 +155,9 @@ private:
     bool m_smartAlertsEnabled;
     QDateTime m_lastAnalysis;
     
+    // 只在所属线程访问；查询时也会淘汰过期样本，故为 mutable
+    mutable MetricTrendState m_trendStates[TREND_METRIC_COUNT];
+    
     // 阈值配置
     double m_memoryUsageThreshold;
     double m_cpuUsageThreshold;
@@ -1,4 +1,9 @@
 #include "performanceconfigmanager.h"
+#include "performancemonitor.h"
+#include "../communication/communicationbufferpool.h"
+#include "../communication/dataprocessshardpool.h"
+#include "../logger/logmanager.h"
+#include "../ui/uiupdateoptimizer.h"
 #include <QFile>
 #include <QJsonParseError>
 #include <QDebug>
@@ -25,6 +30,12 @@ PerformanceConfigManager::PerformanceConfigManager(QObject *parent)
     m_thresholds["database_query_time_ms"] = 100.0;
     m_thresholds["ui_response_time_ms"] = 50.0;
     m_thresholds["communication_timeout_ms"] = 5000.0;
+    
+    // 内置工作负载配置档，配置文件可覆盖
+    for (const WorkloadProfile &profile : WorkloadProfile::builtinProfiles()) {
+        m_profiles.insert(profile.name, profile);
+        m_profileOrder.append(profile.name);
+    }
 }
 
 PerformanceConfigManager::~PerformanceConfigManager()
@@ -35,6 +46,7 @@ PerformanceConfigManager::~PerformanceConfigManager()
 bool PerformanceConfigManager::loadConfiguration(const QString &configPath)
 {
     QMutexLocker locker(&m_configMutex);
+    m_activeProfile.clear();
     
     QFile file(configPath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -60,6 +72,13 @@ bool PerformanceConfigManager::loadConfiguration(const QString &configPath)
     parseConfiguration(m_config);
     
     qDebug() << "Performance configuration loaded successfully from:" << configPath;
+    
+    // 组件设置在锁外调整
+    const QString activeProfile = m_config["active_workload_profile"].toString();
+    locker.unlock();
+    if (!activeProfile.isEmpty() && !applyWorkloadProfile(activeProfile)) {
+        qWarning() << "Unknown workload profile in performance config:" << activeProfile;
+    }
     return true;
 }
 
@@ -70,6 +89,15 @@ void PerformanceConfigManager::parseConfiguration(const QJsonObject &jsonObj)
     m_monitoringEnabled = perfMonitoring["enabled"].toBool(true);
     m_samplingIntervalMs = perfMonitoring["sampling_interval_ms"].toInt(1000);
     
+    // 指标端点
+    QJsonObject metricsEndpoint = perfMonitoring["metrics_endpoint"].toObject();
+    m_metricsEndpoint.enabled = metricsEndpoint["enabled"].toBool(false);
+    m_metricsEndpoint.bindAddress = metricsEndpoint["bind_address"].toString("0.0.0.0");
+    m_metricsEndpoint.port = metricsEndpoint["port"].toInt(Communication::METRICS_DEFAULT_PORT);
+    
+    // 线程调度策略
+    m_threadingPolicy = ThreadPolicyConfig::fromJson(jsonObj["threading_policy"].toObject());
+    
     // 解析阈值配置
     QJsonObject thresholds = perfMonitoring["thresholds"].toObject();
     for (auto it = thresholds.begin(); it != thresholds.end(); ++it) {
@@ -85,6 +113,7 @@ void PerformanceConfigManager::parseConfiguration(const QJsonObject &jsonObj)
     m_optimizationConfig.dbMaxConnections = dbConfig["max_connections"].toInt(20);
     m_optimizationConfig.dbConnectionTimeoutMs = dbConfig["connection_timeout_ms"].toInt(30000);
     m_optimizationConfig.dbIdleTimeoutMs = dbConfig["idle_timeout_ms"].toInt(300000);
+    m_optimizationConfig.dbValidationQuery = dbConfig["validation_query"].toString("SELECT 1");
     
     // 内存优化器配置
     QJsonObject memConfig = optimizationParams["memory_optimizer"].toObject();
@@ -107,6 +136,21 @@ void PerformanceConfigManager::parseConfiguration(const QJsonObject &jsonObj)
     m_optimizationConfig.commMaxBuffers = commConfig["max_buffers"].toInt(100);
     m_optimizationConfig.commTimeoutMs = commConfig["timeout_ms"].toInt(5000);
     m_optimizationConfig.commCompressionEnabled = commConfig["compression_enabled"].toBool(true);
+    
+    parseWorkloadProfiles(jsonObj);
+}
+
+void PerformanceConfigManager::parseWorkloadProfiles(const QJsonObject &jsonObj)
+{
+    const QJsonObject profiles = jsonObj["workload_profiles"].toObject();
+    for (auto it = profiles.begin(); it != profiles.end(); ++it) {
+        // 同名的内置配置档只覆盖写出的字段，新配置档以默认设置为基础
+        const WorkloadProfile base = m_profiles.value(it.key(), WorkloadProfile());
+        m_profiles.insert(it.key(), WorkloadProfile::fromJson(it.key(), it.value().toObject(), base));
+        if (!m_profileOrder.contains(it.key())) {
+            m_profileOrder.append(it.key());
+        }
+    }
 }
 
 PerformanceConfigManager::OptimizationConfig PerformanceConfigManager::getOptimizationConfig() const
@@ -115,6 +159,18 @@ PerformanceConfigManager::OptimizationConfig PerformanceConfigManager::getOptimi
     return m_optimizationConfig;
 }
 
+PerformanceConfigManager::MetricsEndpointConfig PerformanceConfigManager::getMetricsEndpointConfig() const
+{
+    QMutexLocker locker(&m_configMutex);
+    return m_metricsEndpoint;
+}
+
+ThreadPolicyConfig PerformanceConfigManager::getThreadingPolicyConfig() const
+{
+    QMutexLocker locker(&m_configMutex);
+    return m_threadingPolicy;
+}
+
 void PerformanceConfigManager::updateMetrics(const PerformanceMetrics &metrics)
 {
     QMutexLocker locker(&m_configMutex);
@@ -265,6 +321,93 @@ bool PerformanceConfigManager::saveConfiguration()
     return true;
 }
 
+void PerformanceConfigManager::setProfileTargets(const ProfileTargets &targets)
+{
+    WorkloadProfile profile;
+    bool hasActiveProfile = false;
+    {
+        QMutexLocker locker(&m_configMutex);
+        m_profileTargets = targets;
+        hasActiveProfile = m_profiles.contains(m_activeProfile);
+        if (hasActiveProfile) {
+            profile = m_profiles.value(m_activeProfile);
+        }
+    }
+    
+    if (hasActiveProfile) {
+        applyToTargets(profile, targets);
+    }
+}
+
+bool PerformanceConfigManager::applyWorkloadProfile(const QString &name)
+{
+    WorkloadProfile profile;
+    ProfileTargets targets;
+    {
+        QMutexLocker locker(&m_configMutex);
+        if (!m_profiles.contains(name)) {
+            return false;
+        }
+        profile = m_profiles.value(name);
+        targets = m_profileTargets;
+        m_activeProfile = name;
+        
+        // 模块配置与配置档保持一致，saveConfiguration() 时一并写出
+        m_optimizationConfig.uiBatchSize = profile.uiMaxBatchSize;
+        m_optimizationConfig.uiUpdateIntervalMs = profile.uiRealTimeIntervalMs;
+        m_optimizationConfig.commMaxBuffers = profile.bufferMaxPoolSize;
+        m_config["active_workload_profile"] = name;
+    }
+    
+    applyToTargets(profile, targets);
+    
+    qDebug() << "Workload profile applied:" << name << profile.description;
+    emit workloadProfileApplied(name);
+    return true;
+}
+
+void PerformanceConfigManager::applyToTargets(const WorkloadProfile &profile, const ProfileTargets &targets)
+{
+    if (targets.bufferPool) {
+        targets.bufferPool->applyWorkloadProfile(profile);
+    }
+    if (targets.shardPool) {
+        targets.shardPool->applyWorkloadProfile(profile);
+    }
+    for (const QPointer<DataProcessWorker> &worker : targets.dataWorkers) {
+        if (worker) {
+            worker->applyWorkloadProfile(profile);
+        }
+    }
+    if (targets.uiOptimizer) {
+        targets.uiOptimizer->applyWorkloadProfile(profile);
+    }
+    if (targets.logManager) {
+        targets.logManager->setLogLevel(profile.logLevel);
+    }
+    if (targets.performanceMonitor) {
+        targets.performanceMonitor->setMonitoringInterval(profile.monitorIntervalMs);
+    }
+}
+
+QStringList PerformanceConfigManager::workloadProfileNames() const
+{
+    QMutexLocker locker(&m_configMutex);
+    return m_profileOrder;
+}
+
+WorkloadProfile PerformanceConfigManager::workloadProfile(const QString &name) const
+{
+    QMutexLocker locker(&m_configMutex);
+    return m_profiles.value(name, WorkloadProfile());
+}
+
+QString PerformanceConfigManager::activeWorkloadProfile() const
+{
+    QMutexLocker locker(&m_configMutex);
+    return m_activeProfile;
+}
+
 void PerformanceConfigManager::onMonitoringTimer()
 {
     PerformanceMetrics metrics = collectSystemMetrics();
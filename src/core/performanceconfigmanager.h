@@ -8,12 +8,29 @@
 #include <QMutex>
 #include <QHash>
 #include <QVariant>
+#include <QPointer>
+#include <QStringList>
+#include "../constants.h"
+#include "../utils/workloadprofile.h"
+#include "../utils/threadpolicy.h"
+
+class CommunicationBufferPool;
+class DataProcessShardPool;
+class DataProcessWorker;
+class UIUpdateOptimizer;
+class LogManager;
+class PerformanceMonitor;
 
 /**
  * @brief 性能配置管理器类
  * 
  * 负责加载、管理和应用性能配置参数，
  * 提供实时配置更新和性能监控功能
+ *
+ * 工作负载配置档（见 WorkloadProfile）把各组件的设置组合在一起，
+ * applyWorkloadProfile() 在运行时一次性应用到已登记的组件，无需重启。
+ * 配置文件的 workload_profiles 节可覆盖内置配置档的字段或新增配置档，
+ * active_workload_profile 为加载后应用的配置档
  */
 class PerformanceConfigManager : public QObject
 {
@@ -41,6 +58,7 @@ public:
         int dbMaxConnections;
         int dbConnectionTimeoutMs;
         int dbIdleTimeoutMs;
+        QString dbValidationQuery;
         
         // 内存优化器配置
         bool memoryObjectPoolEnabled;
@@ -62,6 +80,27 @@ public:
         bool commCompressionEnabled;
     };
 
+    /**
+     * @brief 指标端点配置（performance_monitoring.metrics_endpoint），默认关闭
+     */
+    struct MetricsEndpointConfig {
+        bool enabled = false;
+        QString bindAddress = "0.0.0.0";
+        int port = Communication::METRICS_DEFAULT_PORT;
+    };
+
+    /**
+     * @brief 工作负载配置档作用的组件，为空的不调整
+     */
+    struct ProfileTargets {
+        QPointer<CommunicationBufferPool> bufferPool;
+        QPointer<DataProcessShardPool> shardPool;
+        QList<QPointer<DataProcessWorker>> dataWorkers;     ///< 不属于分片池的独立工作线程
+        QPointer<UIUpdateOptimizer> uiOptimizer;
+        QPointer<LogManager> logManager;
+        QPointer<PerformanceMonitor> performanceMonitor;
+    };
+
     explicit PerformanceConfigManager(QObject *parent = nullptr);
     ~PerformanceConfigManager();
 
@@ -78,6 +117,16 @@ public:
      */
     OptimizationConfig getOptimizationConfig() const;
 
+    /**
+     * @brief 获取指标端点配置
+     */
+    MetricsEndpointConfig getMetricsEndpointConfig() const;
+
+    /**
+     * @brief 获取通讯和处理线程的调度策略（threading_policy 节），默认关闭
+     */
+    ThreadPolicyConfig getThreadingPolicyConfig() const;
+
     /**
      * @brief 更新性能指标
      * @param metrics 性能指标数据
@@ -122,6 +171,34 @@ public:
      */
     bool saveConfiguration();
 
+    /**
+     * @brief 登记配置档作用的组件，已有生效的配置档时立即应用到这些组件
+     * @param targets 组件集合
+     */
+    void setProfileTargets(const ProfileTargets &targets);
+
+    /**
+     * @brief 应用工作负载配置档（在组件所在的界面线程调用）
+     * @param name 配置档名称
+     * @return 配置档不存在时返回 false
+     */
+    bool applyWorkloadProfile(const QString &name);
+
+    /**
+     * @brief 获取所有配置档名称（内置的在前）
+     */
+    QStringList workloadProfileNames() const;
+
+    /**
+     * @brief 获取配置档，不存在时返回默认设置
+     */
+    WorkloadProfile workloadProfile(const QString &name) const;
+
+    /**
+     * @brief 当前生效的配置档名称，未应用过时为空
+     */
+    QString activeWorkloadProfile() const;
+
 signals:
     /**
      * @brief 性能警告信号
@@ -144,6 +221,12 @@ signals:
      */
     void metricsUpdated(const PerformanceMetrics &metrics);
 
+    /**
+     * @brief 工作负载配置档已应用
+     * @param name 配置档名称
+     */
+    void workloadProfileApplied(const QString &name);
+
 private slots:
     /**
      * @brief 定时监控槽函数
@@ -157,6 +240,17 @@ private:
      */
     void parseConfiguration(const QJsonObject &jsonObj);
 
+    /**
+     * @brief 解析 workload_profiles 节，覆盖在内置配置档之上
+     * @param jsonObj 整个配置JSON对象
+     */
+    void parseWorkloadProfiles(const QJsonObject &jsonObj);
+
+    /**
+     * @brief 把配置档应用到已登记的组件（不持有配置锁）
+     */
+    void applyToTargets(const WorkloadProfile &profile, const ProfileTargets &targets);
+
     /**
      * @brief 收集系统性能指标
      * @return 性能指标数据
@@ -175,12 +269,18 @@ private:
     QJsonObject m_config;                    ///< 配置JSON对象
     QString m_configPath;                    ///< 配置文件路径
     OptimizationConfig m_optimizationConfig; ///< 优化配置
+    MetricsEndpointConfig m_metricsEndpoint; ///< 指标端点配置
+    ThreadPolicyConfig m_threadingPolicy;    ///< 线程调度策略
     QTimer *m_monitoringTimer;               ///< 监控定时器
     mutable QMutex m_configMutex;            ///< 配置互斥锁
     QHash<QString, double> m_thresholds;     ///< 阈值映射
     QList<PerformanceMetrics> m_metricsHistory; ///< 历史指标数据
     bool m_monitoringEnabled;                ///< 监控是否启用
     int m_samplingIntervalMs;                ///< 采样间隔
+    QHash<QString, WorkloadProfile> m_profiles; ///< 工作负载配置档
+    QStringList m_profileOrder;              ///< 配置档名称（内置的在前）
+    QString m_activeProfile;                 ///< 当前生效的配置档
+    ProfileTargets m_profileTargets;         ///< 配置档作用的组件
 };
 
 #endif // PERFORMANCECONFIGMANAGER_H
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "../logger/logmanager.h"
 #include "errorhandler.h"
 #include "memoryoptimizer.h"
+#include "../utils/monotonicclock.h"
+#include "../utils/framelatency.h"
+#include "../utils/threadpolicy.h"
+#include "../constants.h"
 #include <QDebug>
 #include <QCoreApplication>
 #include <QDir>
@@ -12,19 +16,82 @@
 #include <QStorageInfo>
 #include <QNetworkInterface>
 
-#ifdef Q_OS_WIN
-#include <windows.h>
-#include <psapi.h>
-#include <pdh.h>
-#elif defined(Q_OS_LINUX)
-#include <unistd.h>
-#include <sys/sysinfo.h>
-#include <fstream>
-#elif defined(Q_OS_MAC)
-#include <sys/types.h>
-#include <sys/sysctl.h>
-#include <mach/mach.h>
-#endif
+namespace {
+
+// metricsHistory 的列，顺序与 HISTORY_COLUMN_NAMES 一致
+enum HistoryColumn {
+    CpuUsageColumn,
+    CpuTemperatureColumn,
+    MemoryUsedColumn,
+    MemoryTotalColumn,
+    MemoryUsageColumn,
+    DiskUsedColumn,
+    DiskTotalColumn,
+    DiskUsageColumn,
+    NetworkBytesInColumn,
+    NetworkBytesOutColumn,
+    AppMemoryUsageColumn,
+    AppCpuUsageColumn,
+    ThreadCountColumn,
+    HandleCountColumn,
+    HistoryColumnCount
+};
+
+const char* const HISTORY_COLUMN_NAMES[HistoryColumnCount] = {
+    "cpuUsage", "cpuTemperature", "memoryUsed", "memoryTotal", "memoryUsage",
+    "diskUsed", "diskTotal", "diskUsage", "networkBytesIn", "networkBytesOut",
+    "appMemoryUsage", "appCpuUsage", "threadCount", "handleCount"
+};
+
+int historyColumn(const QString& metric)
+{
+    for (int column = 0; column < HistoryColumnCount; ++column) {
+        if (metric == QLatin1String(HISTORY_COLUMN_NAMES[column])) {
+            return column;
+        }
+    }
+    return -1;
+}
+
+void toHistoryRow(const PerformanceMetrics& metrics, double* row)
+{
+    row[CpuUsageColumn] = metrics.cpuUsage;
+    row[CpuTemperatureColumn] = metrics.cpuTemperature;
+    row[MemoryUsedColumn] = double(metrics.memoryUsed);
+    row[MemoryTotalColumn] = double(metrics.memoryTotal);
+    row[MemoryUsageColumn] = metrics.memoryUsage;
+    row[DiskUsedColumn] = double(metrics.diskUsed);
+    row[DiskTotalColumn] = double(metrics.diskTotal);
+    row[DiskUsageColumn] = metrics.diskUsage;
+    row[NetworkBytesInColumn] = double(metrics.networkBytesIn);
+    row[NetworkBytesOutColumn] = double(metrics.networkBytesOut);
+    row[AppMemoryUsageColumn] = double(metrics.appMemoryUsage);
+    row[AppCpuUsageColumn] = metrics.appCpuUsage;
+    row[ThreadCountColumn] = metrics.threadCount;
+    row[HandleCountColumn] = metrics.handleCount;
+}
+
+PerformanceMetrics fromHistoryRow(const double* row)
+{
+    PerformanceMetrics metrics{};
+    metrics.cpuUsage = row[CpuUsageColumn];
+    metrics.cpuTemperature = row[CpuTemperatureColumn];
+    metrics.memoryUsed = qint64(row[MemoryUsedColumn]);
+    metrics.memoryTotal = qint64(row[MemoryTotalColumn]);
+    metrics.memoryUsage = row[MemoryUsageColumn];
+    metrics.diskUsed = qint64(row[DiskUsedColumn]);
+    metrics.diskTotal = qint64(row[DiskTotalColumn]);
+    metrics.diskUsage = row[DiskUsageColumn];
+    metrics.networkBytesIn = qint64(row[NetworkBytesInColumn]);
+    metrics.networkBytesOut = qint64(row[NetworkBytesOutColumn]);
+    metrics.appMemoryUsage = qint64(row[AppMemoryUsageColumn]);
+    metrics.appCpuUsage = row[AppCpuUsageColumn];
+    metrics.threadCount = int(row[ThreadCountColumn]);
+    metrics.handleCount = int(row[HandleCountColumn]);
+    return metrics;
+}
+
+}
 
 PerformanceMonitor* PerformanceMonitor::instance = nullptr;
 QMutex PerformanceMonitor::instanceMutex;
@@ -45,9 +112,11 @@ PerformanceMonitor::PerformanceMonitor(QObject* parent)
     , alertsEnabled(true)
     , monitoringInterval(1000) // 1秒
     , historySize(3600) // 1小时的数据
+    , metricsHistory(HistoryColumnCount, 3600)
     , m_memoryOptimizer(nullptr)
     , m_memoryThreshold(80.0)
     , systemProcess(nullptr)
+    , systemSampler(new SystemSampler)
     , lastNetworkBytesIn(0)
     , lastNetworkBytesOut(0)
 {
@@ -64,7 +133,7 @@ PerformanceMonitor::PerformanceMonitor(QObject* parent)
     processTimer->start(100); // 每100ms处理一次队列
     
     // 设置默认启用的指标
-    enabledMetrics << "cpu" << "memory" << "disk" << "app";
+    enabledMetrics << "cpu" << "memory" << "disk" << "app" << "threads" << "latency" << "jitter" << "allocations";
     
     // 添加默认告警
     PerformanceAlert cpuAlert;
@@ -85,6 +154,15 @@ PerformanceMonitor::PerformanceMonitor(QObject* parent)
     memoryAlert.action = "warning";
     alerts.append(memoryAlert);
     
+    PerformanceAlert latencyAlert;
+    latencyAlert.name = "High Frame Latency";
+    latencyAlert.metric = FrameLatencyMonitor::metricPrefix(FrameLatencyStage::Total) + ".p99Ms";
+    latencyAlert.threshold = System::FRAME_LATENCY_ALERT_P99_MS;
+    latencyAlert.enabled = true;
+    latencyAlert.duration = 30;
+    latencyAlert.action = "warning";
+    alerts.append(latencyAlert);
+    
     // 初始化内存优化器
     MemoryOptimizerConfig config;
     config.enableObjectPools = true;
@@ -110,6 +188,9 @@ PerformanceMonitor::~PerformanceMonitor()
         m_memoryOptimizer = nullptr;
     }
     
+    delete systemSampler;
+    systemSampler = nullptr;
+    
     qDebug() << "PerformanceMonitor destroyed";
 }
 
@@ -187,8 +268,9 @@ void PerformanceMonitor::setHistorySize(int size)
     historySize = qMax(10, size);
     
     // 如果当前历史记录超过新的大小限制，删除旧记录
-    while (metricsHistory.size() > historySize) {
-        metricsHistory.removeFirst();
+    metricsHistory.setCapacity(historySize);
+    while (customMetricsHistory.size() > historySize) {
+        customMetricsHistory.removeFirst();
     }
 }
 
@@ -199,17 +281,25 @@ void PerformanceMonitor::collectMetrics()
     }
     
     try {
-        PerformanceMetrics metrics;
-        metrics.timestamp = QDateTime::currentDateTime();
+        // 未启用的指标为 0；时间取单调时钟，历史记录的时间戳不会因系统校时而倒退
+        PerformanceMetrics metrics{};
+        const qint64 timestampMs = MonotonicClock::epochMs();
+        metrics.timestamp = MonotonicClock::toDateTime(timestampMs);
+        
+        // 一次读取全部系统计数器；CPU 占用为与上一次采样之间的增量，每次采集只能读取一次
+        const bool perThread = enabledMetrics.contains("threads");
+        SystemSample sample;
+        systemSampler->sample(&sample, perThread);
         
         // 收集系统指标
         if (enabledMetrics.contains("cpu")) {
-            metrics.cpuUsage = getCpuUsage();
-            metrics.cpuTemperature = getCpuTemperature();
+            metrics.cpuUsage = sample.cpuUsage;
+            metrics.cpuTemperature = getCpuTemperature(sample.cpuUsage);
         }
         
         if (enabledMetrics.contains("memory")) {
-            getMemoryInfo(metrics.memoryUsed, metrics.memoryTotal);
+            metrics.memoryUsed = sample.memoryUsed;
+            metrics.memoryTotal = sample.memoryTotal;
             metrics.memoryUsage = (metrics.memoryTotal > 0) ? 
                 (double(metrics.memoryUsed) / metrics.memoryTotal * 100.0) : 0.0;
         }
@@ -225,10 +315,22 @@ void PerformanceMonitor::collectMetrics()
         }
         
         if (enabledMetrics.contains("app")) {
-            metrics.appMemoryUsage = getAppMemoryUsage();
-            metrics.appCpuUsage = getAppCpuUsage();
-            metrics.threadCount = getThreadCount();
-            metrics.handleCount = getHandleCount();
+            metrics.appMemoryUsage = sample.appMemoryUsage;
+            metrics.appCpuUsage = sample.appCpuUsage;
+            metrics.threadCount = sample.threadCount;
+            metrics.handleCount = sample.handleCount;
+        }
+        
+        if (enabledMetrics.contains("latency")) {
+            updateFrameLatencyMetrics();
+        }
+        
+        if (enabledMetrics.contains("jitter")) {
+            updateThreadJitterMetrics();
+        }
+        
+        if (enabledMetrics.contains("allocations")) {
+            updateAllocationMetrics();
         }
         
         // 添加自定义指标
@@ -241,14 +343,22 @@ void PerformanceMonitor::collectMetrics()
         {
             QMutexLocker locker(&metricsMutex);
             currentMetrics = metrics;
+            if (perThread) {
+                threadCpuUsage = systemSampler->threadUsage();
+            } else {
+                threadCpuUsage.clear();
+            }
             
             // 添加到队列
             metricsQueue.enqueue(metrics);
             
             // 添加到历史记录
-            metricsHistory.append(metrics);
-            if (metricsHistory.size() > historySize) {
-                metricsHistory.removeFirst();
+            double row[HistoryColumnCount];
+            toHistoryRow(metrics, row);
+            metricsHistory.append(timestampMs, row);
+            customMetricsHistory.append(metrics.customMetrics);
+            if (customMetricsHistory.size() > historySize) {
+                customMetricsHistory.removeFirst();
             }
         }
         
@@ -386,11 +496,135 @@ QList<PerformanceMetrics> PerformanceMonitor::getHistoryMetrics(int count) const
 {
     QMutexLocker locker(&metricsMutex);
     
-    if (count >= metricsHistory.size()) {
-        return metricsHistory;
+    QList<PerformanceMetrics> result;
+    const int size = metricsHistory.size();
+    const int first = qMax(0, size - qMax(0, count));
+    result.reserve(size - first);
+    for (int i = first; i < size; ++i) {
+        result.append(historyAt(i));
+    }
+    return result;
+}
+
+QList<PerformanceMetrics> PerformanceMonitor::getMetricsByTimeRange(const QDateTime& start, const QDateTime& end) const
+{
+    QMutexLocker locker(&metricsMutex);
+    
+    int begin = 0;
+    int last = 0;
+    historyRange(start, end, &begin, &last);
+    
+    QList<PerformanceMetrics> result;
+    result.reserve(last - begin);
+    for (int i = begin; i < last; ++i) {
+        result.append(historyAt(i));
+    }
+    return result;
+}
+
+QList<double> PerformanceMonitor::getMetricValues(const QString& metric, const QDateTime& start,
+                                                  const QDateTime& end) const
+{
+    const int column = historyColumn(metric);
+    if (column < 0) {
+        return QList<double>();
+    }
+    
+    QMutexLocker locker(&metricsMutex);
+    
+    int begin = 0;
+    int last = 0;
+    historyRange(start, end, &begin, &last);
+    
+    QList<double> values;
+    values.reserve(last - begin);
+    for (int i = begin; i < last; ++i) {
+        values.append(metricsHistory.valueAt(column, i));
     }
+    return values;
+}
+
+PerformanceMetrics PerformanceMonitor::getAverageMetrics(const QDateTime& start, const QDateTime& end) const
+{
+    QMutexLocker locker(&metricsMutex);
+    
+    int begin = 0;
+    int last = 0;
+    historyRange(start, end, &begin, &last);
+    
+    double row[HistoryColumnCount];
+    for (int column = 0; column < HistoryColumnCount; ++column) {
+        row[column] = metricsHistory.average(column, begin, last);
+    }
+    PerformanceMetrics metrics = fromHistoryRow(row);
+    if (begin < last) {
+        metrics.timestamp = MonotonicClock::toDateTime(metricsHistory.timestampAt(last - 1));
+    }
+    return metrics;
+}
+
+PerformanceMetrics PerformanceMonitor::getMaxMetrics(const QDateTime& start, const QDateTime& end) const
+{
+    QMutexLocker locker(&metricsMutex);
+    
+    int begin = 0;
+    int last = 0;
+    historyRange(start, end, &begin, &last);
     
-    return metricsHistory.mid(metricsHistory.size() - count);
+    double row[HistoryColumnCount];
+    for (int column = 0; column < HistoryColumnCount; ++column) {
+        row[column] = metricsHistory.maximum(column, begin, last);
+    }
+    PerformanceMetrics metrics = fromHistoryRow(row);
+    if (begin < last) {
+        metrics.timestamp = MonotonicClock::toDateTime(metricsHistory.timestampAt(last - 1));
+    }
+    return metrics;
+}
+
+PerformanceMetrics PerformanceMonitor::getMinMetrics(const QDateTime& start, const QDateTime& end) const
+{
+    QMutexLocker locker(&metricsMutex);
+    
+    int begin = 0;
+    int last = 0;
+    historyRange(start, end, &begin, &last);
+    
+    double row[HistoryColumnCount];
+    for (int column = 0; column < HistoryColumnCount; ++column) {
+        row[column] = metricsHistory.minimum(column, begin, last);
+    }
+    PerformanceMetrics metrics = fromHistoryRow(row);
+    if (begin < last) {
+        metrics.timestamp = MonotonicClock::toDateTime(metricsHistory.timestampAt(last - 1));
+    }
+    return metrics;
+}
+
+PerformanceMetrics PerformanceMonitor::historyAt(int index) const
+{
+    double row[HistoryColumnCount];
+    for (int column = 0; column < HistoryColumnCount; ++column) {
+        row[column] = metricsHistory.valueAt(column, index);
+    }
+    PerformanceMetrics metrics = fromHistoryRow(row);
+    metrics.timestamp = MonotonicClock::toDateTime(metricsHistory.timestampAt(index));
+    metrics.customMetrics = customMetricsHistory.at(index);
+    return metrics;
+}
+
+// 二分查找时间范围对应的序号区间 [begin, end)
+void PerformanceMonitor::historyRange(const QDateTime& start, const QDateTime& end, int* begin, int* last) const
+{
+    *begin = start.isValid() ? metricsHistory.lowerBound(start.toMSecsSinceEpoch()) : 0;
+    *last = end.isValid() ? metricsHistory.upperBound(end.toMSecsSinceEpoch()) : metricsHistory.size();
+    *last = qMax(*begin, *last);
+}
+
+QList<ThreadCpuUsage> PerformanceMonitor::getThreadCpuUsage() const
+{
+    QMutexLocker locker(&metricsMutex);
+    return threadCpuUsage;
 }
 
 void PerformanceMonitor::addCustomMetric(const QString& name, double value)
@@ -429,123 +663,10 @@ void PerformanceMonitor::unregisterCallback(const QString& name)
     callbacks.remove(name);
 }
 
-// 平台相关的系统指标收集实现
-double PerformanceMonitor::getCpuUsage()
-{
-#ifdef Q_OS_WIN
-    // Windows实现
-    static ULARGE_INTEGER lastCPU, lastSysCPU, lastUserCPU;
-    static int numProcessors = 0;
-    static bool first = true;
-    
-    if (first) {
-        SYSTEM_INFO sysInfo;
-        FILETIME ftime, fsys, fuser;
-        
-        GetSystemInfo(&sysInfo);
-        numProcessors = sysInfo.dwNumberOfProcessors;
-        
-        GetSystemTimeAsFileTime(&ftime);
-        memcpy(&lastCPU, &ftime, sizeof(FILETIME));
-        
-        GetProcessTimes(GetCurrentProcess(), &ftime, &ftime, &fsys, &fuser);
-        memcpy(&lastSysCPU, &fsys, sizeof(FILETIME));
-        memcpy(&lastUserCPU, &fuser, sizeof(FILETIME));
-        
-        first = false;
-        return 0.0;
-    }
-    
-    FILETIME ftime, fsys, fuser;
-    ULARGE_INTEGER now, sys, user;
-    
-    GetSystemTimeAsFileTime(&ftime);
-    memcpy(&now, &ftime, sizeof(FILETIME));
-    
-    GetProcessTimes(GetCurrentProcess(), &ftime, &ftime, &fsys, &fuser);
-    memcpy(&sys, &fsys, sizeof(FILETIME));
-    memcpy(&user, &fuser, sizeof(FILETIME));
-    
-    double percent = (sys.QuadPart - lastSysCPU.QuadPart) + (user.QuadPart - lastUserCPU.QuadPart);
-    percent /= (now.QuadPart - lastCPU.QuadPart);
-    percent /= numProcessors;
-    
-    lastCPU = now;
-    lastUserCPU = user;
-    lastSysCPU = sys;
-    
-    return percent * 100.0;
-    
-#elif defined(Q_OS_LINUX)
-    // Linux实现
-    static unsigned long long lastTotalUser = 0, lastTotalUserLow = 0, lastTotalSys = 0, lastTotalIdle = 0;
-    
-    std::ifstream file("/proc/stat");
-    if (!file.is_open()) {
-        return 0.0;
-    }
-    
-    std::string line;
-    std::getline(file, line);
-    file.close();
-    
-    unsigned long long totalUser, totalUserLow, totalSys, totalIdle, total;
-    sscanf(line.c_str(), "cpu %llu %llu %llu %llu", &totalUser, &totalUserLow, &totalSys, &totalIdle);
-    
-    if (lastTotalUser == 0) {
-        lastTotalUser = totalUser;
-        lastTotalUserLow = totalUserLow;
-        lastTotalSys = totalSys;
-        lastTotalIdle = totalIdle;
-        return 0.0;
-    }
-    
-    total = (totalUser - lastTotalUser) + (totalUserLow - lastTotalUserLow) + (totalSys - lastTotalSys);
-    double percent = total;
-    total += (totalIdle - lastTotalIdle);
-    percent /= total;
-    
-    lastTotalUser = totalUser;
-    lastTotalUserLow = totalUserLow;
-    lastTotalSys = totalSys;
-    lastTotalIdle = totalIdle;
-    
-    return percent * 100.0;
-    
-#else
-    // 其他平台的简化实现
-    return 0.0;
-#endif
-}
-
-double PerformanceMonitor::getCpuTemperature()
-{
-    // 简化实现，返回模拟温度
-    return 45.0 + (getCpuUsage() * 0.3);
-}
-
-void PerformanceMonitor::getMemoryInfo(qint64& used, qint64& total)
+double PerformanceMonitor::getCpuTemperature(double cpuUsage)
 {
-#ifdef Q_OS_WIN
-    MEMORYSTATUSEX memInfo;
-    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    GlobalMemoryStatusEx(&memInfo);
-    
-    total = memInfo.ullTotalPhys;
-    used = total - memInfo.ullAvailPhys;
-    
-#elif defined(Q_OS_LINUX)
-    struct sysinfo memInfo;
-    sysinfo(&memInfo);
-    
-    total = memInfo.totalram * memInfo.mem_unit;
-    used = (memInfo.totalram - memInfo.freeram) * memInfo.mem_unit;
-    
-#else
-    // 其他平台的简化实现
-    total = 8LL * 1024 * 1024 * 1024; // 8GB
-    used = total * 0.6; // 假设使用60%
-#endif
+    // 简化实现，按CPU使用率估算温度
+    return 45.0 + (cpuUsage * 0.3);
 }
 
 void PerformanceMonitor::getDiskInfo(qint64& used, qint64& total)
@@ -573,44 +694,93 @@ void PerformanceMonitor::getNetworkInfo(qint64& bytesIn, qint64& bytesOut)
     }
 }
 
-qint64 PerformanceMonitor::getAppMemoryUsage()
+void PerformanceMonitor::updateFrameLatencyMetrics()
 {
-#ifdef Q_OS_WIN
-    PROCESS_MEMORY_COUNTERS pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize;
-    }
-#elif defined(Q_OS_LINUX)
-    std::ifstream file("/proc/self/status");
-    if (file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            if (line.substr(0, 6) == "VmRSS:") {
-                int value;
-                sscanf(line.c_str(), "VmRSS: %d kB", &value);
-                return value * 1024; // 转换为字节
-            }
+    const FrameLatencyMonitor::Histograms window = FrameLatencyMonitor::getInstance()->takeWindow();
+    
+    QMutexLocker locker(&metricsMutex);
+    for (int i = 0; i < FrameLatencyMonitor::STAGE_COUNT; ++i) {
+        const HdrHistogram& histogram = window[i];
+        const QString prefix = FrameLatencyMonitor::metricPrefix(static_cast<FrameLatencyStage>(i));
+        // 本周期没有经过该阶段的帧时不显示，也不会触发告警
+        if (histogram.count() == 0) {
+            customMetrics.remove(prefix + ".p50Ms");
+            customMetrics.remove(prefix + ".p99Ms");
+            customMetrics.remove(prefix + ".maxMs");
+            continue;
         }
+        customMetrics[prefix + ".p50Ms"] = histogram.percentileNs(50.0) / 1e6;
+        customMetrics[prefix + ".p99Ms"] = histogram.percentileNs(99.0) / 1e6;
+        customMetrics[prefix + ".maxMs"] = histogram.maxNs() / 1e6;
     }
-#endif
-    return 0;
-}
-
-double PerformanceMonitor::getAppCpuUsage()
-{
-    // 简化实现，返回系统CPU使用率的一部分
-    return getCpuUsage() * 0.1;
 }
 
-int PerformanceMonitor::getThreadCount()
+void PerformanceMonitor::updateThreadJitterMetrics()
 {
-    return QThread::idealThreadCount();
+    const ThreadPolicy::Histograms window = ThreadPolicy::getInstance()->takeJitterWindow();
+    
+    QMutexLocker locker(&metricsMutex);
+    for (int i = 0; i < ThreadPolicy::ROLE_COUNT; ++i) {
+        const HdrHistogram& histogram = window[i];
+        const QString prefix = ThreadPolicy::metricPrefix(static_cast<ThreadRole>(i));
+        // 该类线程未应用策略或本周期没有唤醒时不显示
+        if (histogram.count() == 0) {
+            customMetrics.remove(prefix + ".p50Us");
+            customMetrics.remove(prefix + ".p99Us");
+            customMetrics.remove(prefix + ".maxUs");
+            continue;
+        }
+        customMetrics[prefix + ".p50Us"] = histogram.percentileNs(50.0) / 1e3;
+        customMetrics[prefix + ".p99Us"] = histogram.percentileNs(99.0) / 1e3;
+        customMetrics[prefix + ".maxUs"] = histogram.maxNs() / 1e3;
+    }
 }
 
-int PerformanceMonitor::getHandleCount()
+void PerformanceMonitor::updateAllocationMetrics()
 {
-    // 简化实现
-    return 100;
+    if (!AllocationTracker::isAvailable()) {
+        return;
+    }
+    
+    const AllocationTracker::Snapshot snapshot = AllocationTracker::snapshot();
+    const AllocationTracker::Snapshot previous = lastAllocationSnapshot;
+    lastAllocationSnapshot = snapshot;
+    if (previous.timestampNs == 0) {
+        return;     // 第一次采集只记录起点
+    }
+    
+    const AllocationTracker::Window window =
+        AllocationTracker::difference(previous, snapshot, System::ALLOCATION_METRIC_TOP_SITES);
+    
+    QMutexLocker locker(&metricsMutex);
+    // 作用域和线程的排名每个周期都会变化，先清掉上个周期的条目
+    for (auto it = customMetrics.begin(); it != customMetrics.end();) {
+        if (it.key().startsWith("allocations.site.") || it.key().startsWith("allocations.thread.")) {
+            it = customMetrics.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    customMetrics["allocations.perSecond"] = window.allocationsPerSecond;
+    customMetrics["allocations.bytesPerSecond"] = window.bytesPerSecond;
+    // 本周期没有收到帧时不显示每帧指标
+    if (window.frames > 0) {
+        customMetrics["allocations.perFrame"] = window.allocationsPerFrame;
+        customMetrics["allocations.bytesPerFrame"] = window.bytesPerFrame;
+    } else {
+        customMetrics.remove("allocations.perFrame");
+        customMetrics.remove("allocations.bytesPerFrame");
+    }
+    
+    for (const AllocationTracker::NamedCounters& site : window.topSites) {
+        customMetrics[QString("allocations.site.%1.perSecond").arg(site.name)] = site.counters.count / window.seconds;
+    }
+    const int threadCount = qMin<int>(window.threads.size(), System::ALLOCATION_METRIC_TOP_SITES);
+    for (int i = 0; i < threadCount; ++i) {
+        const AllocationTracker::NamedCounters& thread = window.threads.at(i);
+        customMetrics[QString("allocations.thread.%1.perSecond").arg(thread.name)] = thread.counters.count / window.seconds;
+    }
 }
 
 bool PerformanceMonitor::checkAlertCondition(const PerformanceAlert& alert, const PerformanceMetrics& metrics)
@@ -9,6 +9,9 @@
 #include <QThread>
 #include <QProcess>
 #include <functional>
+#include "systemsampler.h"
+#include "../utils/metricring.h"
+#include "../utils/allocationtracker.h"
 
 // 前向声明
 class MemoryOptimizer;
@@ -96,10 +99,15 @@ public:
     void setHistorySize(int size);
     void setMetricsEnabled(const QStringList& metrics);
     
-    // 性能指标获取
+    // 性能指标获取（时间范围两端包含在内，无效的时间表示不限）
     PerformanceMetrics getCurrentMetrics() const;
     QList<PerformanceMetrics> getHistoryMetrics(int count = 100) const;
     QList<PerformanceMetrics> getMetricsByTimeRange(const QDateTime& start, const QDateTime& end) const;
+    // 单个指标在时间范围内的历史值，metric 为 PerformanceMetrics 的字段名，未知的指标返回空列表
+    QList<double> getMetricValues(const QString& metric, const QDateTime& start,
+                                  const QDateTime& end = QDateTime()) const;
+    // 最近一次采样的各线程 CPU 占用（需启用 "threads" 指标）
+    QList<ThreadCpuUsage> getThreadCpuUsage() const;
     
     // 自定义指标
     void addCustomMetric(const QString& name, double value);
@@ -124,7 +132,7 @@ public:
                       const QDateTime& end = QDateTime()) const;
     bool exportAlerts(const QString& filename) const;
     
-    // 统计分析
+    // 统计分析（平均值 O(1)、最大最小值 O(log n)，自定义指标不参与统计）
     PerformanceMetrics getAverageMetrics(const QDateTime& start, const QDateTime& end) const;
     PerformanceMetrics getMaxMetrics(const QDateTime& start, const QDateTime& end) const;
     PerformanceMetrics getMinMetrics(const QDateTime& start, const QDateTime& end) const;
@@ -157,18 +165,16 @@ private:
     explicit PerformanceMonitor(QObject* parent = nullptr);
     ~PerformanceMonitor();
     
-    // 系统指标收集
-    double getCpuUsage();
-    double getCpuTemperature();
-    void getMemoryInfo(qint64& used, qint64& total);
+    // 系统指标收集（CPU、内存和应用程序指标由 SystemSampler 一次采样得到）
+    double getCpuTemperature(double cpuUsage);
     void getDiskInfo(qint64& used, qint64& total);
     void getNetworkInfo(qint64& bytesIn, qint64& bytesOut);
-    
-    // 应用程序指标收集
-    qint64 getAppMemoryUsage();
-    double getAppCpuUsage();
-    int getThreadCount();
-    int getHandleCount();
+    // 端到端帧延迟：取走本周期的窗口，各阶段的 P50 / P99 / 最大值（毫秒）写入自定义指标
+    void updateFrameLatencyMetrics();
+    // 通讯和处理线程的唤醒抖动（见 ThreadPolicy）：各类线程本周期的 P50 / P99 / 最大值（微秒）写入自定义指标
+    void updateThreadJitterMetrics();
+    // 堆分配（需以 ALLOCATION_TRACKING 编译）：本周期每帧分配次数、每秒字节数和分配最多的作用域/线程
+    void updateAllocationMetrics();
     
     // 告警处理
     void processAlert(const PerformanceAlert& alert, const PerformanceMetrics& metrics);
@@ -178,6 +184,10 @@ private:
     void notifyCallbacks(const PerformanceMetrics& metrics);
     void notifyAlertCallbacks(const PerformanceAlert& alert, const PerformanceMetrics& metrics);
     
+    // 历史记录（调用方持有 metricsMutex）
+    PerformanceMetrics historyAt(int index) const;
+    void historyRange(const QDateTime& start, const QDateTime& end, int* begin, int* last) const;
+    
     static PerformanceMonitor* instance;
     static QMutex instanceMutex;
     
@@ -194,11 +204,14 @@ private:
     
     // 性能数据
     QQueue<PerformanceMetrics> metricsQueue;
-    QList<PerformanceMetrics> metricsHistory;
+    MetricRing metricsHistory;                          // 每个数值指标一列，容量为 historySize
+    QList<QMap<QString, double>> customMetricsHistory;  // 与 metricsHistory 的采样一一对应
     PerformanceMetrics currentMetrics;
+    QList<ThreadCpuUsage> threadCpuUsage;
     
     // 自定义指标
     QMap<QString, double> customMetrics;
+    AllocationTracker::Snapshot lastAllocationSnapshot;     // 上一次采集时的分配计数
     
     // 告警配置
     QList<PerformanceAlert> alerts;
@@ -217,6 +230,7 @@ private:
     
     // 系统信息缓存
     QProcess* systemProcess;
+    SystemSampler* systemSampler;
     qint64 lastNetworkBytesIn;
     qint64 lastNetworkBytesOut;
     QDateTime lastNetworkCheck;
@@ -0,0 +1,171 @@
+#include "sqlbatchwriter.h"
+#include "../logger/logmanager.h"
+#include "../constants.h"
+#include <QSqlError>
+#include <QTimer>
+
+namespace {
+constexpr qint64 RATE_WINDOW_MS = 1000;
+}
+
+SqlBatchWriter::SqlBatchWriter(const QSqlDatabase& database, QObject* parent)
+    : QObject(parent)
+    , m_database(database)
+    , m_flushTimer(new QTimer(this))
+    , m_maxRows(System::DB_BATCH_MAX_ROWS)
+    , m_totalCommitMs(0.0)
+    , m_windowRows(0)
+{
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(System::DB_BATCH_MAX_DELAY_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, [this]() { flush(); });
+    m_rateWindow.start();
+    m_logWindow.start();
+}
+
+SqlBatchWriter::~SqlBatchWriter()
+{
+    flush();
+    // 语句必须在连接关闭之前释放
+    m_statements.clear();
+}
+
+void SqlBatchWriter::applyWritePragmas(QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+    query.exec("PRAGMA journal_mode = WAL");
+    query.exec("PRAGMA synchronous = NORMAL");     // WAL 下只在检查点时同步，掉电最多丢失最近的事务
+    query.exec("PRAGMA temp_store = MEMORY");
+    query.exec(QString("PRAGMA cache_size = -%1").arg(System::DB_CACHE_SIZE_KB));
+}
+
+int SqlBatchWriter::prepare(const QString& sql)
+{
+    auto query = std::make_unique<QSqlQuery>(m_database);
+    if (!query->prepare(sql)) {
+        const QString error = "预编译语句失败: " + query->lastError().text();
+        LOG_ERROR("SqlBatchWriter", error);
+        emit writeError(error);
+        return -1;
+    }
+    m_statements.push_back(std::move(query));
+    return static_cast<int>(m_statements.size()) - 1;
+}
+
+void SqlBatchWriter::setBatchLimits(int maxRows, int maxDelayMs)
+{
+    m_maxRows = qMax(1, maxRows);
+    m_flushTimer->setInterval(qMax(0, maxDelayMs));
+}
+
+bool SqlBatchWriter::enqueue(int statementId, const QVariantList& values)
+{
+    if (statementId < 0 || statementId >= static_cast<int>(m_statements.size())) {
+        return false;
+    }
+
+    m_pending.append({statementId, values});
+    if (m_pending.size() >= m_maxRows) {
+        return flush();
+    }
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+    return true;
+}
+
+bool SqlBatchWriter::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty()) {
+        return true;
+    }
+
+    const QVector<PendingRow> rows = std::move(m_pending);
+    m_pending.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool inTransaction = m_database.transaction();
+    if (!inTransaction) {
+        // 无法开启事务时逐行自动提交，不丢弃数据
+        LOG_WARNING("SqlBatchWriter", "无法开启事务: " + m_database.lastError().text());
+    }
+
+    int written = 0;
+    for (const PendingRow& row : rows) {
+        if (execute(row)) {
+            ++written;
+        } else {
+            ++m_statistics.rowsFailed;
+        }
+    }
+
+    if (inTransaction && !m_database.commit()) {
+        const QString error = "提交写入事务失败: " + m_database.lastError().text();
+        m_database.rollback();
+        m_statistics.rowsFailed += written;
+        LOG_ERROR("SqlBatchWriter", error);
+        emit writeError(error);
+        return false;
+    }
+
+    const double commitMs = timer.nsecsElapsed() / 1e6;
+    updateStatistics(written, commitMs);
+    emit batchCommitted(written, commitMs);
+    return written == rows.size();
+}
+
+SqlBatchStatistics SqlBatchWriter::statistics() const
+{
+    SqlBatchStatistics statistics = m_statistics;
+    statistics.pendingRows = m_pending.size();
+    return statistics;
+}
+
+bool SqlBatchWriter::execute(const PendingRow& row)
+{
+    QSqlQuery& query = *m_statements[static_cast<size_t>(row.statementId)];
+    for (int i = 0; i < row.values.size(); ++i) {
+        query.bindValue(i, row.values.at(i));
+    }
+    if (!query.exec()) {
+        // 单行失败（如约束冲突）不影响同一事务中的其他行
+        const QString error = "写入数据失败: " + query.lastError().text();
+        LOG_ERROR("SqlBatchWriter", error);
+        emit writeError(error);
+        return false;
+    }
+    return true;
+}
+
+void SqlBatchWriter::updateStatistics(int rows, double commitMs)
+{
+    m_statistics.rowsWritten += static_cast<quint64>(rows);
+    ++m_statistics.commits;
+    m_statistics.lastCommitMs = commitMs;
+    m_statistics.maxCommitMs = qMax(m_statistics.maxCommitMs, commitMs);
+    m_totalCommitMs += commitMs;
+    m_statistics.averageCommitMs = m_totalCommitMs / m_statistics.commits;
+
+    m_windowRows += static_cast<quint64>(rows);
+    const qint64 elapsedMs = m_rateWindow.elapsed();
+    if (elapsedMs >= RATE_WINDOW_MS) {
+        m_statistics.rowsPerSecond = m_windowRows * 1000.0 / elapsedMs;
+        m_windowRows = 0;
+        m_rateWindow.restart();
+    }
+
+    if (m_logWindow.elapsed() >= System::DB_STATISTICS_LOG_INTERVAL_MS) {
+        m_logWindow.restart();
+        LOG_DEBUG("SqlBatchWriter",
+            QString("%1: 已写入 %2 行，%3 行/秒，提交耗时 平均 %4 ms / 最大 %5 ms，失败 %6 行")
+            .arg(m_database.connectionName())
+            .arg(m_statistics.rowsWritten)
+            .arg(m_statistics.rowsPerSecond, 0, 'f', 1)
+            .arg(m_statistics.averageCommitMs, 0, 'f', 2)
+            .arg(m_statistics.maxCommitMs, 0, 'f', 2)
+            .arg(m_statistics.rowsFailed));
+    }
+}
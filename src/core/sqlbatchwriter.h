@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariantList>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+class QTimer;
+
+// 批量写入统计
+struct SqlBatchStatistics {
+    quint64 rowsWritten = 0;        // 已提交的行数
+    quint64 rowsFailed = 0;         // 执行或提交失败而丢弃的行数
+    quint64 commits = 0;            // 已提交的事务数
+    double rowsPerSecond = 0.0;     // 最近一个统计窗口的写入速度
+    double lastCommitMs = 0.0;      // 事务从开始到提交完成的耗时
+    double averageCommitMs = 0.0;
+    double maxCommitMs = 0.0;
+    int pendingRows = 0;            // 尚未提交的行数
+};
+
+// SQLite 批量写入
+//
+// 预编译的语句只准备一次，之后每行只绑定参数。写入的行先排队，攒够 maxRows 行或
+// 第一行等待超过 maxDelayMs 时在一个事务中按入队顺序执行并提交，避免每行一次自动提交和 fsync。
+// 更新语句也应通过同一个写入器排队，保证与之前的插入按顺序执行；查询前调用 flush()。
+//
+// 与数据库连接属于同一个线程，非线程安全
+class SqlBatchWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SqlBatchWriter(const QSqlDatabase& database, QObject* parent = nullptr);
+    ~SqlBatchWriter() override;
+
+    // WAL 日志、synchronous=NORMAL、内存临时表和较大的页缓存；数据库打开后调用一次
+    static void applyWritePragmas(QSqlDatabase& database);
+
+    // 预编译语句（使用 ? 占位），返回编号；失败返回 -1
+    int prepare(const QString& sql);
+    void setBatchLimits(int maxRows, int maxDelayMs);
+
+    // 排队一行，values 按占位符顺序给出
+    bool enqueue(int statementId, const QVariantList& values);
+    // 立即提交排队的行；全部成功时返回 true
+    bool flush();
+    bool hasPending() const { return !m_pending.isEmpty(); }
+
+    SqlBatchStatistics statistics() const;
+
+signals:
+    void batchCommitted(int rows, double commitMs);
+    void writeError(const QString& error);
+
+private:
+    struct PendingRow {
+        int statementId;
+        QVariantList values;
+    };
+
+    bool execute(const PendingRow& row);
+    void updateStatistics(int rows, double commitMs);
+
+    QSqlDatabase m_database;
+    std::vector<std::unique_ptr<QSqlQuery>> m_statements;
+    QVector<PendingRow> m_pending;
+    QTimer* m_flushTimer;
+    int m_maxRows;
+
+    SqlBatchStatistics m_statistics;
+    double m_totalCommitMs;
+    QElapsedTimer m_rateWindow;     // 写入速度统计窗口
+    quint64 m_windowRows;
+    QElapsedTimer m_logWindow;      // 吞吐量日志间隔
+};
@@ -0,0 +1,291 @@
+#include "startupgraph.h"
+#include "../utils/startupprofiler.h"
+#include <QDebug>
+#include <QEventLoop>
+#include <QtConcurrent/QtConcurrentRun>
+#include <exception>
+
+namespace {
+
+bool runTask(const QString& name, const StartupGraph::Task& task, QString* error)
+{
+    STARTUP_PHASE(name);
+    try {
+        if (task()) {
+            return true;
+        }
+        *error = "初始化返回失败";
+    } catch (const std::exception& e) {
+        *error = QString::fromLocal8Bit(e.what());
+    } catch (...) {
+        *error = "未知异常";
+    }
+    return false;
+}
+
+}
+
+StartupGraph::StartupGraph(QObject* parent)
+    : QObject(parent)
+    , m_unfinished(0)
+    , m_started(false)
+    , m_failed(false)
+{
+}
+
+StartupGraph::~StartupGraph()
+{
+    // 工作线程节点持有 this，全部结束后才能析构；它们排队送回的结果随本对象一起丢弃
+    for (QFuture<void>& future : m_workerFutures) {
+        future.waitForFinished();
+    }
+}
+
+void StartupGraph::addNode(const QString& name, const QStringList& dependencies, Affinity affinity, Task task)
+{
+    if (m_started) {
+        qWarning() << "[StartupGraph] 已开始调度，忽略节点" << name;
+        return;
+    }
+    if (m_nodes.contains(name)) {
+        qWarning() << "[StartupGraph] 重复的节点" << name;
+        return;
+    }
+
+    Node node;
+    node.name = name;
+    node.dependencies = dependencies;
+    node.affinity = affinity;
+    node.task = std::move(task);
+    m_nodes.insert(name, node);
+    m_declarationOrder.append(name);
+}
+
+bool StartupGraph::start()
+{
+    if (m_started) {
+        return !m_failed;
+    }
+    if (!validate()) {
+        qCritical() << "[StartupGraph]" << m_lastError;
+        m_failed = true;
+        return false;
+    }
+
+    m_started = true;
+    m_unfinished = m_nodes.size();
+    m_clock.start();
+
+    // 按声明顺序启动没有依赖的节点，同层节点之间的相对顺序与声明一致
+    for (const QString& name : m_declarationOrder) {
+        Node& node = m_nodes[name];
+        if (node.remainingDependencies == 0) {
+            launch(node);
+        }
+    }
+    if (m_unfinished == 0) {
+        emit finished(true);
+    }
+    return true;
+}
+
+bool StartupGraph::validate()
+{
+    for (const QString& name : m_declarationOrder) {
+        Node& node = m_nodes[name];
+        node.remainingDependencies = node.dependencies.size();
+        for (const QString& dependency : node.dependencies) {
+            auto it = m_nodes.find(dependency);
+            if (it == m_nodes.end()) {
+                m_lastError = QString("节点 %1 依赖未声明的节点 %2").arg(name, dependency);
+                return false;
+            }
+            it->dependents.append(name);
+        }
+    }
+
+    // 拓扑排序能排完所有节点才没有循环依赖
+    QHash<QString, int> remaining;
+    QStringList ready;
+    for (const QString& name : m_declarationOrder) {
+        remaining.insert(name, m_nodes[name].remainingDependencies);
+        if (m_nodes[name].remainingDependencies == 0) {
+            ready.append(name);
+        }
+    }
+    int visited = 0;
+    while (!ready.isEmpty()) {
+        const QString name = ready.takeFirst();
+        ++visited;
+        for (const QString& dependent : m_nodes[name].dependents) {
+            if (--remaining[dependent] == 0) {
+                ready.append(dependent);
+            }
+        }
+    }
+    if (visited != m_nodes.size()) {
+        QStringList cycle;
+        for (const QString& name : m_declarationOrder) {
+            if (remaining[name] > 0) {
+                cycle.append(name);
+            }
+        }
+        m_lastError = QString("启动节点存在循环依赖: %1").arg(cycle.join(", "));
+        return false;
+    }
+    return true;
+}
+
+void StartupGraph::launch(Node& node)
+{
+    node.state = NodeState::Running;
+    const QString name = node.name;
+
+    if (node.affinity == Affinity::MainThread) {
+        // 排队执行，等待中的工作线程节点的完成通知可以先处理
+        QMetaObject::invokeMethod(this, [this, name]() { runMainThreadNode(name); }, Qt::QueuedConnection);
+        return;
+    }
+
+    const Task task = node.task;
+    m_workerFutures.append(QtConcurrent::run([this, name, task]() {
+        const qint64 startMs = m_clock.elapsed();
+        QString error;
+        const bool success = runTask(name, task, &error);
+        const qint64 durationMs = m_clock.elapsed() - startMs;
+        QMetaObject::invokeMethod(this, [this, name, success, error, startMs, durationMs]() {
+            completeNode(name, success, error, startMs, durationMs);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void StartupGraph::runMainThreadNode(const QString& name)
+{
+    const qint64 startMs = m_clock.elapsed();
+    QString error;
+    const bool success = runTask(name, m_nodes[name].task, &error);
+    completeNode(name, success, error, startMs, m_clock.elapsed() - startMs);
+}
+
+void StartupGraph::completeNode(const QString& name, bool success, const QString& error,
+                                qint64 startMs, qint64 durationMs)
+{
+    Node& node = m_nodes[name];
+    node.state = success ? NodeState::Succeeded : NodeState::Failed;
+    node.task = Task();
+    --m_unfinished;
+
+    NodeResult result;
+    result.name = name;
+    result.success = success;
+    result.startMs = startMs;
+    result.durationMs = durationMs;
+    result.error = error;
+    m_results.append(result);
+
+    if (!success) {
+        m_failed = true;
+        m_lastError = QString("%1: %2").arg(name, error);
+        qCritical() << "[StartupGraph] 启动节点失败" << m_lastError;
+    }
+
+    emit nodeFinished(name, success);
+
+    QStringList cancelled;
+    for (const QString& dependentName : node.dependents) {
+        Node& dependent = m_nodes[dependentName];
+        if (dependent.state != NodeState::Pending) {
+            continue;
+        }
+        if (!success) {
+            cancelled.append(dependentName);
+        } else if (--dependent.remainingDependencies == 0) {
+            launch(dependent);
+        }
+    }
+    // 依赖失败的节点不执行，失败沿依赖链传递
+    for (const QString& dependentName : cancelled) {
+        if (m_nodes[dependentName].state == NodeState::Pending) {
+            m_nodes[dependentName].state = NodeState::Running;
+            completeNode(dependentName, false, QString("依赖 %1 失败").arg(name), m_clock.elapsed(), 0);
+        }
+    }
+
+    if (m_unfinished == 0) {
+        qDebug().noquote() << "[StartupGraph]" << summary();
+        emit finished(!m_failed);
+    }
+}
+
+bool StartupGraph::isDone(const QString& name) const
+{
+    auto it = m_nodes.constFind(name);
+    return it == m_nodes.constEnd()
+        || it->state == NodeState::Succeeded || it->state == NodeState::Failed;
+}
+
+bool StartupGraph::waitFor(const QStringList& names)
+{
+    if (!m_started) {
+        return false;
+    }
+
+    auto allDone = [this, &names]() {
+        for (const QString& name : names) {
+            if (!isDone(name)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (!allDone()) {
+        QEventLoop loop;
+        connect(this, &StartupGraph::nodeFinished, &loop, [&loop, &allDone]() {
+            if (allDone()) {
+                loop.quit();
+            }
+        });
+        loop.exec();
+    }
+
+    for (const QString& name : names) {
+        if (!isSucceeded(name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StartupGraph::waitForAll()
+{
+    return waitFor(m_declarationOrder);
+}
+
+bool StartupGraph::isFinished(const QString& name) const
+{
+    return m_nodes.contains(name) && isDone(name);
+}
+
+bool StartupGraph::isSucceeded(const QString& name) const
+{
+    auto it = m_nodes.constFind(name);
+    return it != m_nodes.constEnd() && it->state == NodeState::Succeeded;
+}
+
+QString StartupGraph::summary() const
+{
+    QStringList parts;
+    qint64 totalMs = 0;
+    qint64 serialMs = 0;
+    for (const NodeResult& result : m_results) {
+        parts.append(QString("%1 %2ms@%3%4")
+                         .arg(result.name)
+                         .arg(result.durationMs)
+                         .arg(result.startMs)
+                         .arg(result.success ? "" : " 失败"));
+        totalMs = qMax(totalMs, result.startMs + result.durationMs);
+        serialMs += result.durationMs;
+    }
+    return QString("启动完成 %1ms（逐个执行需 %2ms）: %3").arg(totalMs).arg(serialMs).arg(parts.join(", "));
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <functional>
+
+// 启动依赖图 - 启动步骤声明为带依赖的节点，依赖全部成功的节点立即开始，
+// 互不依赖的工作线程节点在全局线程池上并行执行
+//
+// 主线程节点经事件循环在本对象所在线程执行，创建带定时器的单例和界面对象必须放在这里；
+// 工作线程节点只做与线程无关的工作（读文件、预分配内存），新建的 QObject 在返回前 moveToThread 回主线程。
+// 节点返回false或抛出异常即失败，依赖它的节点不再执行，一并记为失败。
+// 所有状态只在本对象所在线程修改，工作线程的结果以排队调用送回。
+// 日志管理器本身也是启动节点，这里只用 qDebug 输出。
+class StartupGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Affinity {
+        MainThread,
+        Worker
+    };
+    using Task = std::function<bool()>;
+
+    struct NodeResult {
+        QString name;
+        bool success = false;
+        qint64 startMs = 0;         // 相对 start() 的开始时间
+        qint64 durationMs = 0;
+        QString error;
+    };
+
+    explicit StartupGraph(QObject* parent = nullptr);
+    ~StartupGraph();                // 等待执行中的工作线程节点结束
+
+    // 只能在 start() 之前添加，依赖可以引用之后才添加的节点
+    void addNode(const QString& name, const QStringList& dependencies, Affinity affinity, Task task);
+
+    // 检查依赖（未声明的节点、循环依赖）后开始调度，检查失败时不执行任何节点
+    bool start();
+
+    // 在局部事件循环中等待这些节点结束，等待期间主线程节点照常执行；全部成功返回true
+    bool waitFor(const QStringList& names);
+    bool waitForAll();
+
+    bool isFinished(const QString& name) const;
+    bool isSucceeded(const QString& name) const;
+    QString lastError() const { return m_lastError; }
+    QList<NodeResult> results() const { return m_results; }    // 按完成顺序
+    QString summary() const;
+
+signals:
+    void nodeFinished(const QString& name, bool success);
+    void finished(bool success);
+
+private:
+    enum class NodeState {
+        Pending,
+        Running,
+        Succeeded,
+        Failed
+    };
+
+    struct Node {
+        QString name;
+        QStringList dependencies;
+        QStringList dependents;
+        Affinity affinity = Affinity::MainThread;
+        Task task;
+        NodeState state = NodeState::Pending;
+        int remainingDependencies = 0;
+    };
+
+    bool validate();
+    void launch(Node& node);
+    void runMainThreadNode(const QString& name);
+    void completeNode(const QString& name, bool success, const QString& error, qint64 startMs, qint64 durationMs);
+    bool isDone(const QString& name) const;
+
+    QHash<QString, Node> m_nodes;
+    QStringList m_declarationOrder;
+    QList<NodeResult> m_results;
+    QList<QFuture<void>> m_workerFutures;
+    QElapsedTimer m_clock;
+    QString m_lastError;
+    int m_unfinished;
+    bool m_started;
+    bool m_failed;
+};
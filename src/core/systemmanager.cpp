@@ -1,5 +1,9 @@
 #include "systemmanager.h"
+#include "databasebackup.h"
+#include "../constants.h"
 #include <QDebug>
+#include <QDir>
+#include <QStandardPaths>
 #include <QTimer>
 
 SystemManager::SystemManager(QObject* parent)
@@ -14,6 +18,7 @@ SystemManager::SystemManager(QObject* parent)
     , maintenanceTimer(nullptr)
     , sessionTimer(nullptr)
     , healthCheckTimer(nullptr)
+    , databaseBackup(nullptr)
     , initialized(false)
     , monitoringActive(false)
     , backupScheduled(false)
@@ -151,6 +156,56 @@ void SystemManager::checkSystemHealth()
     emit systemHealthChanged(systemHealthy);
 }
 
+void SystemManager::createBackup(const QString& backupPath)
+{
+    if (databaseBackup && (databaseBackup->isRunning() || !pendingBackups.isEmpty())) {
+        emit backupFailed("已有备份正在进行");
+        return;
+    }
+    
+    // 数据目录下的每个数据库依次做在线快照，写入期间各数据库服务照常提交
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QString directory = backupPath;
+    if (directory.isEmpty()) {
+        directory = backupDirectory.isEmpty() ? dataDir + "/" + AppInfo::BACKUP_DIR_NAME : backupDirectory;
+    }
+    const QDateTime now = QDateTime::currentDateTime();
+    const QFileInfoList databases = QDir(dataDir).entryInfoList({"*.db"}, QDir::Files, QDir::Name);
+    for (const QFileInfo& info : databases) {
+        pendingBackups.append({info.absoluteFilePath(),
+                               DatabaseBackup::backupFileName(directory, info.completeBaseName(), now)});
+    }
+    
+    if (!databaseBackup) {
+        databaseBackup = new DatabaseBackup(this);
+        connect(databaseBackup, &DatabaseBackup::finished, this,
+                [this](bool success, const QString& filename, const QString& error) {
+            if (!success) {
+                pendingBackups.clear();
+                qWarning() << "Backup failed:" << filename << error;
+                emit backupFailed(error);
+                emit backupCompleted(false);
+                return;
+            }
+            startNextBackup();
+        });
+    }
+    
+    emit backupStarted();
+    startNextBackup();
+}
+
+void SystemManager::startNextBackup()
+{
+    if (pendingBackups.isEmpty()) {
+        qDebug() << "Backup created";
+        emit backupCompleted(true);
+        return;
+    }
+    const QPair<QString, QString> next = pendingBackups.takeFirst();
+    databaseBackup->backup(next.first, next.second);
+}
+
 // 实现头文件中声明的其他方法（简化版本）
 void SystemManager::loadConfiguration() { qDebug() << "Configuration loaded"; }
 void SystemManager::saveConfiguration() { qDebug() << "Configuration saved"; }
@@ -174,7 +229,6 @@ QStringList SystemManager::getUserPermissions(const QString&) const { return QSt
 bool SystemManager::hasPermission(const QString&) const { return true; }
 void SystemManager::loginUser(const QString&, const QString&) { qDebug() << "User logged in"; }
 void SystemManager::logoutUser() { qDebug() << "User logged out"; }
-void SystemManager::createBackup(const QString&) { qDebug() << "Backup created"; }
 void SystemManager::restoreBackup(const QString&) { qDebug() << "Backup restored"; }
 void SystemManager::scheduleAutoBackup(int) { qDebug() << "Auto backup scheduled"; }
 void SystemManager::cancelAutoBackup() { qDebug() << "Auto backup cancelled"; }
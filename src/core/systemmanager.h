@@ -5,12 +5,15 @@
 #include <QDateTime>
 #include <QTimer>
 #include <QJsonObject>
+#include <QList>
+#include <QPair>
 
 // 前置声明
 class LogManager;
 class ConfigManager;
 class DatabaseManager;
 class SecurityManager;
+class DatabaseBackup;
 
 /**
  * @brief 系统管理器类
@@ -204,6 +207,7 @@ private:
     void createIncrementalBackup(const QString& backupPath);
     void compressBackup(const QString& backupPath);
     void verifyBackup(const QString& backupPath);
+    void startNextBackup();
     
     // 维护内部方法
     void performDatabaseMaintenance();
@@ -225,6 +229,10 @@ private:
     QTimer* sessionTimer;
     QTimer* healthCheckTimer;
     
+    // 备份
+    DatabaseBackup* databaseBackup;
+    QList<QPair<QString, QString>> pendingBackups;  // (数据库, 备份文件)，依次执行
+    
     // 系统状态
     bool initialized;
     bool monitoringActive;
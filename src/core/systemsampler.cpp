@@ -0,0 +1,461 @@
+#include "systemsampler.h"
+#include <algorithm>
+#include <unordered_map>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#elif defined(Q_OS_LINUX)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 两次读数之间的 CPU 占用；分母为 0（采样间隔内时间没有推进）时返回 0
+double percentOf(quint64 part, quint64 total)
+{
+    return total > 0 ? qBound(0.0, 100.0 * double(part) / double(total), 100.0) : 0.0;
+}
+
+#ifdef Q_OS_LINUX
+
+constexpr int BUFFER_SIZE = 4096;
+
+// /proc 文件内容由内核在读取时生成，从偏移 0 重新读即为最新值；返回读到的长度，失败为 -1
+ssize_t readAt(int fd, char* buffer)
+{
+    ssize_t length;
+    do {
+        length = pread(fd, buffer, BUFFER_SIZE - 1, 0);
+    } while (length < 0 && errno == EINTR);
+    if (length >= 0) {
+        buffer[length] = '\0';
+    }
+    return length;
+}
+
+bool parseUnsigned(const char*& p, const char* end, quint64* value)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9') {
+        return false;
+    }
+    quint64 result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + quint64(*p - '0');
+        ++p;
+    }
+    *value = result;
+    return true;
+}
+
+// 跳过 count 个以空格分隔的字段（字段可以带负号）
+void skipFields(const char*& p, const char* end, int count)
+{
+    for (int i = 0; i < count && p < end; ++i) {
+        while (p < end && *p == ' ') {
+            ++p;
+        }
+        while (p < end && *p != ' ') {
+            ++p;
+        }
+    }
+}
+
+// /proc/stat 第一行：cpu user nice system idle iowait irq softirq steal guest guest_nice
+// guest 已计入 user，总时间取前 8 项，空闲取 idle + iowait
+bool parseCpuTotals(const char* p, const char* end, quint64* total, quint64* idle)
+{
+    if (end - p < 4 || strncmp(p, "cpu ", 4) != 0) {
+        return false;
+    }
+    p += 4;
+    quint64 fields[8] = {};
+    int count = 0;
+    while (count < 8 && parseUnsigned(p, end, &fields[count])) {
+        ++count;
+    }
+    if (count < 4) {
+        return false;
+    }
+    *total = 0;
+    for (int i = 0; i < count; ++i) {
+        *total += fields[i];
+    }
+    *idle = fields[3] + fields[4];
+    return true;
+}
+
+// /proc/meminfo 中 "Key:   value kB" 形式的行
+bool findMeminfoValue(const char* begin, const char* end, const char* key, quint64* value)
+{
+    const size_t keyLength = strlen(key);
+    for (const char* line = begin; line < end;) {
+        const char* next = static_cast<const char*>(memchr(line, '\n', size_t(end - line)));
+        const char* lineEnd = next ? next : end;
+        if (size_t(lineEnd - line) > keyLength && memcmp(line, key, keyLength) == 0) {
+            const char* p = line + keyLength;
+            return parseUnsigned(p, lineEnd, value);
+        }
+        line = lineEnd + 1;
+    }
+    return false;
+}
+
+// /proc/<pid>/stat 与 /proc/self/task/<tid>/stat：pid (comm) state ... 第 14、15 项为 utime、stime，
+// 第 20 项为线程数，第 24 项为常驻页数。comm 可能含空格和括号，从最后一个 ')' 之后开始按位置解析
+struct TaskStat {
+    const char* comm = nullptr;
+    int commLength = 0;
+    quint64 cpuTicks = 0;
+    quint64 threads = 0;
+    quint64 residentPages = 0;
+};
+
+bool parseTaskStat(const char* begin, const char* end, TaskStat* stat, bool full)
+{
+    const char* open = static_cast<const char*>(memchr(begin, '(', size_t(end - begin)));
+    const char* close = end;
+    while (close > begin && *(close - 1) != ')') {
+        --close;
+    }
+    if (!open || close <= open + 1) {
+        return false;
+    }
+    stat->comm = open + 1;
+    stat->commLength = int(close - 1 - (open + 1));
+
+    const char* p = close;
+    quint64 utime = 0;
+    quint64 stime = 0;
+    skipFields(p, end, 11);                 // state .. cmajflt（第 3~13 项）
+    if (!parseUnsigned(p, end, &utime) || !parseUnsigned(p, end, &stime)) {
+        return false;
+    }
+    stat->cpuTicks = utime + stime;
+    if (!full) {
+        return true;
+    }
+    skipFields(p, end, 4);                  // cutime cstime priority nice
+    if (!parseUnsigned(p, end, &stat->threads)) {
+        return false;
+    }
+    skipFields(p, end, 3);                  // itrealvalue starttime vsize
+    return parseUnsigned(p, end, &stat->residentPages);
+}
+
+bool isNumeric(const char* name)
+{
+    if (*name == '\0') {
+        return false;
+    }
+    for (; *name; ++name) {
+        if (*name < '0' || *name > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+#elif defined(Q_OS_WIN)
+
+quint64 fileTimeValue(const FILETIME& time)
+{
+    return (quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+}
+
+#endif
+
+}
+
+struct SystemSampler::Handles {
+    struct ThreadState {
+#ifdef Q_OS_WIN
+        HANDLE handle = nullptr;
+#else
+        int fd = -1;
+#endif
+        quint64 lastTime = 0;
+        bool hasLast = false;
+        quint32 generation = 0;
+    };
+
+    int processorCount = 1;
+    quint64 lastTotal = 0;              // 全部核心的时间（Linux 为时钟节拍，Windows 为 100ns）
+    quint64 lastIdle = 0;
+    quint64 lastProcess = 0;
+    bool hasLast = false;
+    quint32 generation = 0;
+    std::unordered_map<qint64, ThreadState> threads;
+
+#ifdef Q_OS_LINUX
+    int statFd = -1;
+    int meminfoFd = -1;
+    int selfStatFd = -1;
+    DIR* taskDir = nullptr;
+    DIR* fdDir = nullptr;
+    long pageSize = 4096;
+    char buffer[BUFFER_SIZE];
+#endif
+};
+
+SystemSampler::SystemSampler()
+    : m_handles(new Handles)
+{
+    Handles& h = *m_handles;
+#ifdef Q_OS_LINUX
+    h.statFd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    h.meminfoFd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    h.selfStatFd = open("/proc/self/stat", O_RDONLY | O_CLOEXEC);
+    h.taskDir = opendir("/proc/self/task");
+    h.fdDir = opendir("/proc/self/fd");
+    h.pageSize = qMax(1L, sysconf(_SC_PAGESIZE));
+    h.processorCount = int(qMax(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+#elif defined(Q_OS_WIN)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    h.processorCount = int(qMax<DWORD>(1, info.dwNumberOfProcessors));
+#endif
+}
+
+SystemSampler::~SystemSampler()
+{
+    Handles& h = *m_handles;
+#ifdef Q_OS_LINUX
+    for (auto& entry : h.threads) {
+        ::close(entry.second.fd);
+    }
+    for (int fd : {h.statFd, h.meminfoFd, h.selfStatFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (h.taskDir) {
+        closedir(h.taskDir);
+    }
+    if (h.fdDir) {
+        closedir(h.fdDir);
+    }
+#elif defined(Q_OS_WIN)
+    for (auto& entry : h.threads) {
+        CloseHandle(entry.second.handle);
+    }
+#endif
+}
+
+const QList<ThreadCpuUsage>& SystemSampler::threadUsage() const
+{
+    return m_threadUsage;
+}
+
+bool SystemSampler::sample(SystemSample* result, bool perThread)
+{
+    Handles& h = *m_handles;
+    *result = SystemSample();
+
+#ifdef Q_OS_LINUX
+    if (h.statFd < 0 || h.selfStatFd < 0) {
+        return false;
+    }
+
+    quint64 total = 0;
+    quint64 idle = 0;
+    ssize_t length = readAt(h.statFd, h.buffer);
+    if (length <= 0 || !parseCpuTotals(h.buffer, h.buffer + length, &total, &idle)) {
+        return false;
+    }
+
+    TaskStat self;
+    length = readAt(h.selfStatFd, h.buffer);
+    if (length <= 0 || !parseTaskStat(h.buffer, h.buffer + length, &self, true)) {
+        return false;
+    }
+    result->threadCount = int(self.threads);
+    result->appMemoryUsage = qint64(self.residentPages) * h.pageSize;
+
+    if (h.meminfoFd >= 0 && (length = readAt(h.meminfoFd, h.buffer)) > 0) {
+        quint64 memTotal = 0;
+        quint64 available = 0;
+        const char* end = h.buffer + length;
+        if (findMeminfoValue(h.buffer, end, "MemTotal:", &memTotal) &&
+            (findMeminfoValue(h.buffer, end, "MemAvailable:", &available) ||
+             findMeminfoValue(h.buffer, end, "MemFree:", &available))) {
+            result->memoryTotal = qint64(memTotal) * 1024;
+            result->memoryUsed = qint64(memTotal - qMin(available, memTotal)) * 1024;
+        }
+    }
+
+    // 目录中包括 opendir 自己的描述符
+    if (h.fdDir) {
+        rewinddir(h.fdDir);
+        int handles = 0;
+        while (const dirent* entry = readdir(h.fdDir)) {
+            if (entry->d_name[0] != '.') {
+                ++handles;
+            }
+        }
+        result->handleCount = qMax(0, handles - 1);
+    }
+
+    const quint64 processTime = self.cpuTicks;
+#elif defined(Q_OS_WIN)
+    FILETIME idleTime, kernelTime, userTime;
+    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
+        return false;
+    }
+    // 内核时间包含空闲时间
+    const quint64 total = fileTimeValue(kernelTime) + fileTimeValue(userTime);
+    const quint64 idle = fileTimeValue(idleTime);
+
+    FILETIME creation, exitTime, processKernel, processUser;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &processKernel, &processUser);
+    const quint64 processTime = fileTimeValue(processKernel) + fileTimeValue(processUser);
+
+    MEMORYSTATUSEX memory;
+    memory.dwLength = sizeof(memory);
+    if (GlobalMemoryStatusEx(&memory)) {
+        result->memoryTotal = qint64(memory.ullTotalPhys);
+        result->memoryUsed = qint64(memory.ullTotalPhys - memory.ullAvailPhys);
+    }
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        result->appMemoryUsage = qint64(counters.WorkingSetSize);
+    }
+
+    DWORD handles = 0;
+    if (GetProcessHandleCount(GetCurrentProcess(), &handles)) {
+        result->handleCount = int(handles);
+    }
+#else
+    Q_UNUSED(perThread)
+    Q_UNUSED(h)
+    return false;
+#endif
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
+    // Linux 的 iowait 计数可能回退，差值按 0 处理
+    const quint64 deltaTotal = h.hasLast && total > h.lastTotal ? total - h.lastTotal : 0;
+    const quint64 deltaIdle = h.hasLast && idle > h.lastIdle ? idle - h.lastIdle : 0;
+    if (h.hasLast) {
+        result->cpuUsage = percentOf(deltaTotal - qMin(deltaTotal, deltaIdle), deltaTotal);
+        result->appCpuUsage = percentOf(processTime - h.lastProcess, deltaTotal);
+    }
+    h.lastTotal = total;
+    h.lastIdle = idle;
+    h.lastProcess = processTime;
+    h.hasLast = true;
+
+    const quint32 generation = ++h.generation;
+    const double perCore = 100.0 * h.processorCount / qMax<quint64>(1, deltaTotal);
+    m_threadUsage.clear();
+
+#ifdef Q_OS_LINUX
+    if (perThread && h.taskDir) {
+        rewinddir(h.taskDir);
+        const int taskFd = dirfd(h.taskDir);
+        while (const dirent* entry = readdir(h.taskDir)) {
+            if (!isNumeric(entry->d_name)) {
+                continue;
+            }
+            const qint64 tid = strtoll(entry->d_name, nullptr, 10);
+            Handles::ThreadState& state = h.threads[tid];
+            if (state.fd < 0) {
+                char path[sizeof(entry->d_name) + 8];
+                snprintf(path, sizeof(path), "%s/stat", entry->d_name);
+                state.fd = openat(taskFd, path, O_RDONLY | O_CLOEXEC);
+                if (state.fd < 0) {
+                    h.threads.erase(tid);
+                    continue;
+                }
+            }
+            // 线程已退出时读取失败，关闭后若线程号被复用下次重新打开
+            TaskStat stat;
+            length = readAt(state.fd, h.buffer);
+            if (length <= 0 || !parseTaskStat(h.buffer, h.buffer + length, &stat, false)) {
+                ::close(state.fd);
+                h.threads.erase(tid);
+                continue;
+            }
+            state.generation = generation;
+            ThreadCpuUsage usage;
+            usage.threadId = tid;
+            usage.name = QString::fromUtf8(stat.comm, stat.commLength);
+            if (state.hasLast && deltaTotal > 0) {
+                usage.cpuUsage = qMin(100.0, double(stat.cpuTicks - state.lastTime) * perCore);
+            }
+            state.lastTime = stat.cpuTicks;
+            state.hasLast = true;
+            m_threadUsage.append(usage);
+        }
+    }
+#elif defined(Q_OS_WIN)
+    const HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (snapshot != INVALID_HANDLE_VALUE) {
+        const DWORD processId = GetCurrentProcessId();
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof(entry);
+        for (BOOL more = Thread32First(snapshot, &entry); more; more = Thread32Next(snapshot, &entry)) {
+            if (entry.th32OwnerProcessID != processId) {
+                continue;
+            }
+            ++result->threadCount;
+            if (!perThread) {
+                continue;
+            }
+            Handles::ThreadState& state = h.threads[entry.th32ThreadID];
+            if (!state.handle) {
+                state.handle = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ThreadID);
+                if (!state.handle) {
+                    h.threads.erase(entry.th32ThreadID);
+                    continue;
+                }
+            }
+            FILETIME threadCreation, threadExit, threadKernel, threadUser;
+            if (!GetThreadTimes(state.handle, &threadCreation, &threadExit, &threadKernel, &threadUser)) {
+                CloseHandle(state.handle);
+                h.threads.erase(entry.th32ThreadID);
+                continue;
+            }
+            state.generation = generation;
+            const quint64 threadTime = fileTimeValue(threadKernel) + fileTimeValue(threadUser);
+            ThreadCpuUsage usage;
+            usage.threadId = entry.th32ThreadID;
+            if (state.hasLast && deltaTotal > 0) {
+                usage.cpuUsage = qMin(100.0, double(threadTime - state.lastTime) * perCore);
+            }
+            state.lastTime = threadTime;
+            state.hasLast = true;
+            m_threadUsage.append(usage);
+        }
+        CloseHandle(snapshot);
+    }
+#endif
+
+    // 本次没有出现的线程已经退出
+    for (auto it = h.threads.begin(); it != h.threads.end();) {
+        if (it->second.generation != generation) {
+#ifdef Q_OS_WIN
+            CloseHandle(it->second.handle);
+#else
+            ::close(it->second.fd);
+#endif
+            it = h.threads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::sort(m_threadUsage.begin(), m_threadUsage.end(),
+              [](const ThreadCpuUsage& a, const ThreadCpuUsage& b) { return a.cpuUsage > b.cpuUsage; });
+    return true;
+#endif
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+
+// 一次采样的系统和本进程指标
+struct SystemSample {
+    double cpuUsage = 0.0;          // 系统 CPU 使用率（%，全部核心）
+    double appCpuUsage = 0.0;       // 本进程 CPU 使用率（%，按全部核心归一）
+    qint64 memoryUsed = 0;          // 系统已用内存，不含可回收的页缓存
+    qint64 memoryTotal = 0;
+    qint64 appMemoryUsage = 0;      // 本进程常驻内存
+    int threadCount = 0;
+    int handleCount = 0;            // 打开的文件描述符 / 句柄数
+};
+
+// 单个线程在两次采样之间的 CPU 占用
+struct ThreadCpuUsage {
+    qint64 threadId = 0;
+    QString name;                   // Linux 为 comm，Windows 不提供
+    double cpuUsage = 0.0;          // 占一个核心的百分比
+};
+
+// 系统计数器采样器（PerformanceMonitor 使用）
+//
+// Linux 下 /proc/stat、/proc/meminfo、/proc/self/stat 在构造时打开并一直保持，每次采样用 pread 从偏移 0
+// 重新读入固定缓冲区，按字段位置手工解析；/proc/self/task 和 /proc/self/fd 的目录句柄同样保持打开，
+// 每个线程的 stat 文件在线程第一次出现时打开、消失时关闭。
+// Windows 下使用 GetSystemTimes、GetProcessTimes、GlobalMemoryStatusEx、K32GetProcessMemoryInfo 和
+// GetProcessHandleCount；线程列表来自 Toolhelp 快照，线程句柄缓存到线程退出。
+// 进程和线程的 CPU 占用都以两次采样之间全部核心的时间增量为分母，第一次采样为 0。
+//
+// 不是线程安全的，由调用方在同一线程中使用。
+class SystemSampler
+{
+public:
+    SystemSampler();
+    ~SystemSampler();
+
+    // perThread 为 true 时同时更新 threadUsage()；不支持的平台返回 false
+    bool sample(SystemSample* result, bool perThread);
+
+    // 最近一次采样的各线程 CPU 占用，按占用从高到低排列
+    const QList<ThreadCpuUsage>& threadUsage() const;
+
+private:
+    Q_DISABLE_COPY(SystemSampler)
+
+    struct Handles;
+    std::unique_ptr<Handles> m_handles;
+    QList<ThreadCpuUsage> m_threadUsage;
+};
@@ -0,0 +1,235 @@
+#include "tablepartitions.h"
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+const QString LEGACY_SUFFIX = "0";
+
+QString partitionPrefix(const TablePartitionSpec& spec)
+{
+    return spec.table + "_p";
+}
+
+QString suffixFormat(const TablePartitionSpec& spec)
+{
+    return spec.granularity == TablePartitionSpec::Day ? "yyyyMMdd" : "yyyyMM";
+}
+
+QDateTime partitionStart(const TablePartitionSpec& spec, const QString& partition)
+{
+    const QDate date = QDate::fromString(partition.mid(partitionPrefix(spec).size()), suffixFormat(spec));
+    return date.isValid() ? date.startOfDay() : QDateTime();
+}
+
+// 分区覆盖的时间上界（不含）
+QDateTime partitionEnd(const TablePartitionSpec& spec, const QString& partition)
+{
+    const QDateTime start = partitionStart(spec, partition);
+    if (!start.isValid()) {
+        return QDateTime();
+    }
+    return spec.granularity == TablePartitionSpec::Day ? start.addDays(1) : start.addMonths(1);
+}
+
+bool exec(QSqlQuery& query, const QString& sql, QString* error)
+{
+    if (query.exec(sql)) {
+        return true;
+    }
+    if (error) {
+        *error = QString("%1 (%2)").arg(query.lastError().text(), sql.simplified());
+    }
+    return false;
+}
+
+bool rollback(QSqlDatabase& database)
+{
+    database.rollback();
+    return false;
+}
+
+// 视图按分区时间顺序列出各分区；SQLite 对 UNION ALL 的分支数有上限（默认 500），按月分区远低于此
+bool rebuildView(QSqlDatabase& database, const TablePartitionSpec& spec, const QStringList& partitions,
+                 QString* error)
+{
+    QStringList selects;
+    for (const QString& partition : partitions) {
+        selects.append("SELECT * FROM " + partition);
+    }
+
+    QSqlQuery query(database);
+    return exec(query, "DROP VIEW IF EXISTS " + spec.table, error)
+        && exec(query, QString("CREATE VIEW %1 AS %2").arg(spec.table, selects.join(" UNION ALL ")), error);
+}
+
+// 行数按主键范围计算，只读取主键 B 树的两端
+qint64 partitionRows(QSqlDatabase& database, const TablePartitionSpec& spec, const QString& partition)
+{
+    QSqlQuery query(database);
+    if (!query.exec(QString("SELECT MAX(%1) - MIN(%1) + 1 FROM %2").arg(spec.idColumn, partition)) || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toLongLong();
+}
+
+// 分区化之前的数据不再写入：为空或最大时间早于 cutoff 时整体过期
+bool legacyExpired(QSqlDatabase& database, const TablePartitionSpec& spec, const QString& partition,
+                   const QDateTime& cutoff)
+{
+    QSqlQuery query(database);
+    if (!query.exec(QString("SELECT MAX(%1) FROM %2").arg(spec.timeColumn, partition)) || !query.next()) {
+        return false;
+    }
+    if (query.isNull(0)) {
+        return true;
+    }
+    const QDateTime newest = query.value(0).toDateTime();
+    return newest.isValid() && newest < cutoff;
+}
+}
+
+namespace TablePartitions {
+
+QString legacyPartition(const TablePartitionSpec& spec)
+{
+    return partitionPrefix(spec) + LEGACY_SUFFIX;
+}
+
+QString partitionFor(const TablePartitionSpec& spec, const QDateTime& time)
+{
+    return partitionPrefix(spec) + time.date().toString(suffixFormat(spec));
+}
+
+QStringList partitions(QSqlDatabase& database, const TablePartitionSpec& spec)
+{
+    QStringList result;
+    const QString prefix = partitionPrefix(spec);
+    QSqlQuery query(database);
+    query.prepare("SELECT name FROM sqlite_master WHERE type = 'table' AND substr(name, 1, ?) = ? ORDER BY name");
+    query.addBindValue(prefix.size());
+    query.addBindValue(prefix);
+    if (!query.exec()) {
+        return result;
+    }
+    // 旧数据分区 _p0 按名称排在最前
+    while (query.next()) {
+        const QString name = query.value(0).toString();
+        if (name == legacyPartition(spec) || partitionStart(spec, name).isValid()) {
+            result.append(name);
+        }
+    }
+    return result;
+}
+
+bool ensure(QSqlDatabase& database, const TablePartitionSpec& spec, const QString& partition, QString* error)
+{
+    if (partitions(database, spec).contains(partition)) {
+        return true;
+    }
+    if (!database.transaction()) {
+        if (error) *error = "无法开始分区事务: " + database.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(database);
+    if (!exec(query, spec.createSql.arg(partition), error)) {
+        return rollback(database);
+    }
+    for (const QString& index : spec.indexSql) {
+        if (!exec(query, index.arg(partition), error)) {
+            return rollback(database);
+        }
+    }
+
+    // 新分区从已有分区用过的最大 ID 继续编号，视图中的 ID 保持唯一
+    const QString prefix = partitionPrefix(spec);
+    query.prepare("SELECT MAX(seq) FROM sqlite_sequence WHERE substr(name, 1, ?) = ?");
+    query.addBindValue(prefix.size());
+    query.addBindValue(prefix);
+    if (query.exec() && query.next() && !query.isNull(0)) {
+        const qint64 seq = query.value(0).toLongLong();
+        query.finish();
+        query.prepare("INSERT INTO sqlite_sequence (name, seq) VALUES (?, ?)");
+        query.addBindValue(partition);
+        query.addBindValue(seq);
+        if (!query.exec()) {
+            if (error) *error = "设置分区起始编号失败: " + query.lastError().text();
+            return rollback(database);
+        }
+    }
+    query.finish();
+
+    if (!rebuildView(database, spec, partitions(database, spec), error)) {
+        return rollback(database);
+    }
+    if (!database.commit()) {
+        if (error) *error = "提交分区失败: " + database.lastError().text();
+        return rollback(database);
+    }
+    return true;
+}
+
+QStringList dropBefore(QSqlDatabase& database, const TablePartitionSpec& spec, const QDateTime& cutoff,
+                       qint64* rows, QString* error)
+{
+    if (rows) {
+        *rows = 0;
+    }
+
+    // 当前分区始终保留，视图不会变成空的
+    const QString current = partitionFor(spec, QDateTime::currentDateTime());
+    if (!ensure(database, spec, current, error)) {
+        return QStringList();
+    }
+
+    QStringList expired;
+    QStringList remaining;
+    qint64 expiredRows = 0;
+    for (const QString& partition : partitions(database, spec)) {
+        bool drop = false;
+        if (partition == legacyPartition(spec)) {
+            drop = legacyExpired(database, spec, partition, cutoff);
+        } else if (partition != current) {
+            drop = partitionEnd(spec, partition) <= cutoff;
+        }
+
+        if (drop) {
+            expired.append(partition);
+            expiredRows += partitionRows(database, spec, partition);
+        } else {
+            remaining.append(partition);
+        }
+    }
+    if (expired.isEmpty()) {
+        return expired;
+    }
+
+    // 先让视图不再引用要删除的分区；DROP TABLE 把页面放回空闲列表，由之后的分区复用
+    if (!database.transaction()) {
+        if (error) *error = "无法开始分区事务: " + database.lastError().text();
+        return QStringList();
+    }
+    QSqlQuery query(database);
+    if (!rebuildView(database, spec, remaining, error)) {
+        rollback(database);
+        return QStringList();
+    }
+    for (const QString& partition : expired) {
+        if (!exec(query, "DROP TABLE " + partition, error)) {
+            rollback(database);
+            return QStringList();
+        }
+    }
+    if (!database.commit()) {
+        if (error) *error = "提交分区删除失败: " + database.lastError().text();
+        rollback(database);
+        return QStringList();
+    }
+
+    if (rows) {
+        *rows = expiredRows;
+    }
+    return expired;
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+// 按时间分区的表
+//
+// 每个分区是一张结构相同的表 <table>_p<yyyyMM>（按天为 <table>_p<yyyyMMdd>），
+// 与逻辑表同名的视图 UNION ALL 合并所有分区，读取语句不需要知道分区；
+// SQLite 把视图展开到各分区上，每个分区按自己的索引读取并按顺序归并。
+// 写入直接插入 partitionFor() 返回的分区表。过期数据按整个分区 DROP TABLE，
+// 不再逐行删除、维护索引并写入大量 WAL。
+// 分区化之前的数据整体改名为 <table>_p0，时间范围取它的最大时间。
+struct TablePartitionSpec {
+    enum Granularity {
+        Day,
+        Month
+    };
+
+    QString table;                  // 逻辑表名，也是视图名
+    QString timeColumn;
+    QString idColumn;               // AUTOINCREMENT 主键，新分区从已有分区的最大值继续编号
+    QString createSql;              // 建表语句，%1 为分区表名
+    QStringList indexSql;           // 索引语句，%1 为分区表名
+    Granularity granularity = Month;
+};
+
+namespace TablePartitions {
+
+QString legacyPartition(const TablePartitionSpec& spec);
+QString partitionFor(const TablePartitionSpec& spec, const QDateTime& time);
+// 已有分区，按时间升序
+QStringList partitions(QSqlDatabase& database, const TablePartitionSpec& spec);
+
+// 分区不存在时建表、建索引并重建视图，在一个事务中完成；error 可为空
+bool ensure(QSqlDatabase& database, const TablePartitionSpec& spec, const QString& partition,
+            QString* error = nullptr);
+
+// 删除时间范围整体早于 cutoff 的分区并重建视图，跨越 cutoff 的分区保留到下一次。
+// 返回删除的分区；rows 为其中的行数（按主键范围计算，分区只追加，ID 连续）
+QStringList dropBefore(QSqlDatabase& database, const TablePartitionSpec& spec, const QDateTime& cutoff,
+                       qint64* rows = nullptr, QString* error = nullptr);
+
+}
@@ -0,0 +1,256 @@
+#include "tuningexperiment.h"
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+QJsonObject ExperimentRecord::toJson() const
+{
+    QJsonObject json;
+    json["knob"] = knob;
+    json["control_value"] = controlValue.toString();
+    json["candidate_value"] = candidateValue.toString();
+    json["reason"] = reason;
+    json["started_at"] = startedAt.toString(Qt::ISODateWithMs);
+    json["finished_at"] = finishedAt.toString(Qt::ISODateWithMs);
+    json["control_samples"] = controlSamples;
+    json["candidate_samples"] = candidateSamples;
+    json["control_p99_ms"] = controlP99Ms;
+    json["candidate_p99_ms"] = candidateP99Ms;
+    json["control_fps"] = controlFps;
+    json["candidate_fps"] = candidateFps;
+    json["latency_p_value"] = latencyPValue;
+    json["throughput_p_value"] = throughputPValue;
+    json["outcome"] = outcomeToString(outcome);
+    json["decision"] = decision;
+    return json;
+}
+
+QString ExperimentRecord::outcomeToString(Outcome outcome)
+{
+    switch (outcome) {
+    case Outcome::Kept:
+        return "kept";
+    case Outcome::RolledBack:
+        return "rolled_back";
+    case Outcome::Aborted:
+        return "aborted";
+    }
+    return "aborted";
+}
+
+void TuningExperimentRunner::setSettings(const Settings& settings)
+{
+    m_settings.warmupSamples = qMax(0, settings.warmupSamples);
+    m_settings.windowSamples = qMax(3, settings.windowSamples);
+    m_settings.significance = qBound(0.001, settings.significance, 0.5);
+}
+
+bool TuningExperimentRunner::start(const TuningKnob& knob, const QVariant& candidateValue, const QString& reason)
+{
+    if (isRunning()) {
+        qWarning() << "[TuningExperiment] 已有实验在运行:" << m_knob.name;
+        return false;
+    }
+    if (!knob.read || !knob.write) {
+        return false;
+    }
+
+    const QVariant controlValue = knob.read();
+    if (!controlValue.isValid() || controlValue == candidateValue) {
+        return false;
+    }
+
+    m_knob = knob;
+    m_record = ExperimentRecord();
+    m_record.knob = knob.name;
+    m_record.controlValue = controlValue;
+    m_record.candidateValue = candidateValue;
+    m_record.reason = reason;
+    m_record.startedAt = QDateTime::currentDateTime();
+    m_controlLatency.clear();
+    m_controlThroughput.clear();
+    m_candidateLatency.clear();
+    m_candidateThroughput.clear();
+    enterPhase(Phase::Control);
+
+    qDebug() << "[TuningExperiment] 开始实验:" << knob.name << controlValue << "->" << candidateValue;
+    return true;
+}
+
+void TuningExperimentRunner::enterPhase(Phase phase)
+{
+    m_phase = phase;
+    m_warmupRemaining = m_settings.warmupSamples;
+    m_phaseTicks = 0;
+}
+
+bool TuningExperimentRunner::addSample(const ExperimentSample& sample)
+{
+    if (!isRunning()) {
+        return false;
+    }
+
+    if (++m_phaseTicks > m_settings.warmupSamples + m_settings.windowSamples * MAX_IDLE_FACTOR) {
+        finish(ExperimentRecord::Outcome::Aborted, "有效样本不足（无帧数据的周期过多）");
+        return true;
+    }
+
+    // 改值后的前几个周期还在过渡，不计入窗口
+    if (m_warmupRemaining > 0) {
+        --m_warmupRemaining;
+        return false;
+    }
+    if (sample.frames <= 0) {
+        return false;
+    }
+
+    if (m_phase == Phase::Control) {
+        m_controlLatency.append(sample.p99LatencyMs);
+        m_controlThroughput.append(sample.framesPerSecond);
+        if (m_controlLatency.size() >= m_settings.windowSamples) {
+            if (!m_knob.write(m_record.candidateValue)) {
+                finish(ExperimentRecord::Outcome::Aborted, "写入候选值失败");
+                return true;
+            }
+            enterPhase(Phase::Candidate);
+        }
+        return false;
+    }
+
+    m_candidateLatency.append(sample.p99LatencyMs);
+    m_candidateThroughput.append(sample.framesPerSecond);
+    if (m_candidateLatency.size() >= m_settings.windowSamples) {
+        decide();
+        return true;
+    }
+    return false;
+}
+
+void TuningExperimentRunner::abort(const QString& why)
+{
+    if (isRunning()) {
+        finish(ExperimentRecord::Outcome::Aborted, why);
+    }
+}
+
+void TuningExperimentRunner::decide()
+{
+    const double alpha = m_settings.significance;
+    const double latencyP = mannWhitneyPValue(m_controlLatency, m_candidateLatency);
+    const double throughputP = mannWhitneyPValue(m_controlThroughput, m_candidateThroughput);
+    const double controlP99 = median(m_controlLatency);
+    const double candidateP99 = median(m_candidateLatency);
+    const double controlFps = median(m_controlThroughput);
+    const double candidateFps = median(m_candidateThroughput);
+
+    const bool latencyBetter = latencyP < alpha && candidateP99 < controlP99;
+    const bool latencyWorse = latencyP < alpha && candidateP99 > controlP99;
+    const bool throughputBetter = throughputP < alpha && candidateFps > controlFps;
+    const bool throughputWorse = throughputP < alpha && candidateFps < controlFps;
+
+    m_record.latencyPValue = latencyP;
+    m_record.throughputPValue = throughputP;
+
+    if ((latencyBetter && !throughputWorse) || (throughputBetter && !latencyWorse)) {
+        finish(ExperimentRecord::Outcome::Kept,
+               latencyBetter ? "P99 延迟显著降低，帧率没有显著下降" : "帧率显著提高，P99 延迟没有显著升高");
+    } else if (latencyWorse || throughputWorse) {
+        finish(ExperimentRecord::Outcome::RolledBack,
+               latencyWorse ? "P99 延迟显著升高" : "帧率显著下降");
+    } else {
+        finish(ExperimentRecord::Outcome::RolledBack, "差异不显著");
+    }
+}
+
+void TuningExperimentRunner::finish(ExperimentRecord::Outcome outcome, const QString& decision)
+{
+    m_record.outcome = outcome;
+    m_record.decision = decision;
+    m_record.finishedAt = QDateTime::currentDateTime();
+    m_record.controlSamples = m_controlLatency.size();
+    m_record.candidateSamples = m_candidateLatency.size();
+    m_record.controlP99Ms = median(m_controlLatency);
+    m_record.candidateP99Ms = median(m_candidateLatency);
+    m_record.controlFps = median(m_controlThroughput);
+    m_record.candidateFps = median(m_candidateThroughput);
+
+    // 对照阶段还没有改值，其余情况不保留时写回原值
+    if (outcome != ExperimentRecord::Outcome::Kept && m_phase == Phase::Candidate
+        && !m_knob.write(m_record.controlValue)) {
+        qWarning() << "[TuningExperiment] 写回原值失败:" << m_knob.name << m_record.controlValue;
+        m_record.decision += "（写回原值失败）";
+    }
+
+    m_phase = Phase::Idle;
+    qDebug() << "[TuningExperiment] 实验结束:" << m_record.knob
+             << ExperimentRecord::outcomeToString(outcome) << m_record.decision
+             << "P99" << m_record.controlP99Ms << "->" << m_record.candidateP99Ms << "ms"
+             << "p=" << m_record.latencyPValue
+             << "帧率" << m_record.controlFps << "->" << m_record.candidateFps
+             << "p=" << m_record.throughputPValue;
+}
+
+double TuningExperimentRunner::median(QVector<double> values)
+{
+    if (values.isEmpty()) {
+        return 0.0;
+    }
+    const int middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    if (values.size() % 2 == 1) {
+        return values[middle];
+    }
+    const double upper = values[middle];
+    return (upper + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+}
+
+double TuningExperimentRunner::mannWhitneyPValue(const QVector<double>& first, const QVector<double>& second)
+{
+    const int n1 = first.size();
+    const int n2 = second.size();
+    if (n1 == 0 || n2 == 0) {
+        return 1.0;
+    }
+
+    // 合并排序后按平均秩处理并列值
+    QVector<QPair<double, int>> combined;
+    combined.reserve(n1 + n2);
+    for (double value : first) {
+        combined.append(qMakePair(value, 0));
+    }
+    for (double value : second) {
+        combined.append(qMakePair(value, 1));
+    }
+    std::sort(combined.begin(), combined.end());
+
+    const double n = n1 + n2;
+    double firstRankSum = 0.0;
+    double tieCorrection = 0.0;     // Σ (t³ - t)
+    for (int i = 0; i < combined.size();) {
+        int j = i + 1;
+        while (j < combined.size() && combined[j].first == combined[i].first) {
+            ++j;
+        }
+        const double averageRank = (i + 1 + j) / 2.0;
+        for (int k = i; k < j; ++k) {
+            if (combined[k].second == 0) {
+                firstRankSum += averageRank;
+            }
+        }
+        const double ties = j - i;
+        tieCorrection += ties * ties * ties - ties;
+        i = j;
+    }
+
+    const double u = firstRankSum - n1 * (n1 + 1) / 2.0;
+    const double meanU = n1 * n2 / 2.0;
+    const double varianceU = n1 * n2 / 12.0 * ((n + 1.0) - tieCorrection / (n * (n - 1.0)));
+    if (varianceU <= 0.0) {
+        return 1.0;
+    }
+
+    // 连续性校正后的正态近似
+    const double z = qMax(0.0, qAbs(u - meanU) - 0.5) / qSqrt(varianceU);
+    return std::erfc(z / M_SQRT2);
+}
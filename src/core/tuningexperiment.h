@@ -0,0 +1,133 @@
+#ifndef TUNINGEXPERIMENT_H
+#define TUNINGEXPERIMENT_H
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <functional>
+
+/**
+ * @brief 可调参数 - 读取当前值和写入新值的回调
+ */
+struct TuningKnob {
+    QString name;                                   // "组件.参数"，与 OptimizationRecommendation 一致，例如 ui.update_interval
+    std::function<QVariant()> read;
+    std::function<bool(const QVariant&)> write;     // 写入失败返回 false
+};
+
+/**
+ * @brief 一个采集周期的观测值
+ */
+struct ExperimentSample {
+    qint64 frames = 0;                  // 本周期处理的帧数，为 0 时该周期不计入窗口
+    double p99LatencyMs = 0.0;          // 本周期端到端延迟 P99
+    double framesPerSecond = 0.0;
+};
+
+/**
+ * @brief 调参实验结果，同时作为审计记录
+ */
+struct ExperimentRecord {
+    enum class Outcome {
+        Kept,           // 候选值显著更好，保留
+        RolledBack,     // 没有显著改善或有退化，写回原值
+        Aborted         // 数据不足或写入失败，写回原值
+    };
+
+    QString knob;
+    QVariant controlValue;
+    QVariant candidateValue;
+    QString reason;                     // 发起实验的原因（通常是优化建议的说明）
+    QDateTime startedAt;
+    QDateTime finishedAt;
+    int controlSamples = 0;
+    int candidateSamples = 0;
+    double controlP99Ms = 0.0;          // 各窗口每周期 P99 的中位数
+    double candidateP99Ms = 0.0;
+    double controlFps = 0.0;            // 各窗口帧率的中位数
+    double candidateFps = 0.0;
+    double latencyPValue = 1.0;
+    double throughputPValue = 1.0;
+    Outcome outcome = Outcome::Aborted;
+    QString decision;                   // 判定说明
+
+    QJsonObject toJson() const;
+    static QString outcomeToString(Outcome outcome);
+};
+
+/**
+ * @brief 闭环 A/B 调参实验
+ *
+ * 一次只运行一个实验：先保持当前值采集对照窗口，再写入候选值采集实验窗口，每次改值后先丢弃
+ * warmupSamples 个周期。两个窗口的每周期 P99 延迟和帧率分别做双侧 Mann-Whitney U 检验（正态近似，
+ * 含并列校正），不要求服从正态分布。延迟显著降低且帧率没有显著下降，或帧率显著提高且延迟没有显著升高时
+ * 保留候选值，否则写回原值。某个阶段超过 windowSamples 的 MAX_IDLE_FACTOR 倍周期仍未凑满样本时中止。
+ * 由持有者按固定周期调用 addSample，非线程安全
+ */
+class TuningExperimentRunner
+{
+public:
+    static constexpr int MAX_IDLE_FACTOR = 4;
+
+    struct Settings {
+        int warmupSamples = 2;          // 改值后丢弃的周期数
+        int windowSamples = 12;         // 每个窗口的有效周期数
+        double significance = 0.05;     // 显著性水平
+    };
+
+    void setSettings(const Settings& settings);
+    Settings settings() const { return m_settings; }
+
+    /**
+     * @brief 开始实验，当前值即对照值
+     * @return 已有实验在运行、读取失败或候选值与当前值相同时返回 false
+     */
+    bool start(const TuningKnob& knob, const QVariant& candidateValue, const QString& reason);
+
+    /**
+     * @brief 记录一个周期的观测值
+     * @return 本次调用结束了实验时返回 true，结果由 lastRecord() 取得
+     */
+    bool addSample(const ExperimentSample& sample);
+
+    /**
+     * @brief 中止实验并写回原值，没有实验时不做处理
+     */
+    void abort(const QString& why);
+
+    bool isRunning() const { return m_phase != Phase::Idle; }
+    QString runningKnob() const { return isRunning() ? m_knob.name : QString(); }
+    const ExperimentRecord& lastRecord() const { return m_record; }
+
+    /**
+     * @brief 双侧 Mann-Whitney U 检验的 p 值，任一组为空或全部并列时为 1
+     */
+    static double mannWhitneyPValue(const QVector<double>& first, const QVector<double>& second);
+
+private:
+    enum class Phase {
+        Idle,
+        Control,
+        Candidate
+    };
+
+    void enterPhase(Phase phase);
+    void finish(ExperimentRecord::Outcome outcome, const QString& decision);
+    void decide();
+    static double median(QVector<double> values);
+
+    Settings m_settings;
+    Phase m_phase = Phase::Idle;
+    TuningKnob m_knob;
+    ExperimentRecord m_record;
+    int m_warmupRemaining = 0;
+    int m_phaseTicks = 0;
+    QVector<double> m_controlLatency;
+    QVector<double> m_controlThroughput;
+    QVector<double> m_candidateLatency;
+    QVector<double> m_candidateThroughput;
+};
+
+#endif // TUNINGEXPERIMENT_H
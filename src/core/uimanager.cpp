@@ -7,7 +7,11 @@
 #include "../ui/datarecordwidget.h"
 #include "../ui/securitywidget.h"
 #include "../ui/communicationwidget.h"
+#include "../constants.h"
+#include "../utils/startupprofiler.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
 #include <QMenuBar>
 #include <QToolBar>
 #include <QStatusBar>
@@ -27,6 +31,16 @@ UIManager::UIManager(QMainWindow* mainWindow, QObject* parent)
     , centralWidget(nullptr)
     , tabWidget(nullptr)
     , mainSplitter(nullptr)
+    , deviceControlWidget(nullptr)
+    , dataMonitorWidget(nullptr)
+    , parameterWidget(nullptr)
+    , alarmWidget(nullptr)
+    , chartWidget(nullptr)
+    , dataRecordWidget(nullptr)
+    , securityWidget(nullptr)
+    , communicationWidget(nullptr)
+    , warmUpTimer(nullptr)
+    , firstFrameSeen(false)
     , isFullScreenMode(false)
     , isMinimizedToTrayMode(false)
 {
@@ -257,49 +271,44 @@ void UIManager::createDockWidgets()
 
 void UIManager::createFunctionalWidgets()
 {
-    // 先创建简单的组件，测试哪个组件导致崩溃
-    
     try {
+        // 设备控制是启动后的首页，数据监控负责采样记录和监控告警，这两页立即创建并一直运行；
+        // 其余页面（连同各自的数据库连接和定时器）在第一次显示或首帧之后的后台预热中创建
         qDebug() << "Creating DeviceControlWidget...";
-        DeviceControlWidget* deviceControlWidget = new DeviceControlWidget(tabWidget);
+        deviceControlWidget = new DeviceControlWidget(tabWidget);
         tabWidget->addTab(deviceControlWidget, "设备控制");
-        qDebug() << "DeviceControlWidget created successfully";
+        lazyPages.append(LazyPage{deviceControlWidget, deviceControlWidget, {}});
         
         qDebug() << "Creating DataMonitorWidget...";
-        DataMonitorWidget* dataMonitorWidget = new DataMonitorWidget(tabWidget);
+        dataMonitorWidget = new DataMonitorWidget(tabWidget);
         tabWidget->addTab(dataMonitorWidget, "数据监控");
-        qDebug() << "DataMonitorWidget created successfully";
-        
-        qDebug() << "Creating ParameterWidget...";
-        ParameterWidget* parameterWidget = new ParameterWidget(tabWidget);
-        tabWidget->addTab(parameterWidget, "参数设置");
-        qDebug() << "ParameterWidget created successfully";
-        
-        qDebug() << "Creating ChartWidget...";
-        ChartWidget* chartWidget = new ChartWidget(tabWidget);
-        tabWidget->addTab(chartWidget, "图表显示");
-        qDebug() << "ChartWidget created successfully";
-        
-        qDebug() << "Creating DataRecordWidget...";
-        DataRecordWidget* dataRecordWidget = new DataRecordWidget(tabWidget);
-        tabWidget->addTab(dataRecordWidget, "数据记录");
-        qDebug() << "DataRecordWidget created successfully";
-        
-        qDebug() << "Creating SecurityWidget...";
-        SecurityWidget* securityWidget = new SecurityWidget(tabWidget);
-        tabWidget->addTab(securityWidget, "安全管理");
-        qDebug() << "SecurityWidget created successfully";
+        lazyPages.append(LazyPage{dataMonitorWidget, dataMonitorWidget, {}});
         
-        qDebug() << "Creating CommunicationWidget...";
-        CommunicationWidget* communicationWidget = new CommunicationWidget(tabWidget);
-        tabWidget->addTab(communicationWidget, "通信管理");
-        qDebug() << "CommunicationWidget created successfully";
-        
-        // 尝试创建简化版本的AlarmWidget
-        qDebug() << "Creating AlarmWidget...";
-        AlarmWidget* alarmWidget = new AlarmWidget(tabWidget);
-        tabWidget->addTab(alarmWidget, "报警管理");
-        qDebug() << "AlarmWidget created successfully";
+        addLazyPage("参数设置", [this](QWidget* parent) {
+            parameterWidget = new ParameterWidget(parent);
+            return parameterWidget;
+        });
+        addLazyPage("图表显示", [this](QWidget* parent) {
+            chartWidget = new ChartWidget(parent);
+            return chartWidget;
+        });
+        addLazyPage("数据记录", [this](QWidget* parent) {
+            dataRecordWidget = new DataRecordWidget(parent);
+            return dataRecordWidget;
+        });
+        addLazyPage("安全管理", [this](QWidget* parent) {
+            securityWidget = new SecurityWidget(parent);
+            return securityWidget;
+        });
+        addLazyPage("通信管理", [this](QWidget* parent) {
+            communicationWidget = new CommunicationWidget(parent);
+            return communicationWidget;
+        });
+        // 报警页加载阈值后才会向报警引擎登记报警页的限值，预热时最先创建
+        addLazyPage("报警管理", [this](QWidget* parent) {
+            alarmWidget = new AlarmWidget(parent);
+            return alarmWidget;
+        }, true);
         
     } catch (const std::exception& e) {
         qCritical() << "Exception creating functional widgets:" << e.what();
@@ -312,11 +321,100 @@ void UIManager::createFunctionalWidgets()
     qDebug() << "Functional widgets created successfully";
 }
 
+void UIManager::addLazyPage(const QString& title, std::function<QWidget*(QWidget*)> factory, bool warmUpFirst)
+{
+    QWidget* container = new QWidget(tabWidget);
+    QVBoxLayout* layout = new QVBoxLayout(container);
+    layout->setContentsMargins(0, 0, 0, 0);
+    
+    const int index = tabWidget->addTab(container, title);
+    lazyPages.append(LazyPage{container, nullptr, std::move(factory)});
+    if (warmUpFirst) {
+        warmUpQueue.prepend(index);
+    } else {
+        warmUpQueue.append(index);
+    }
+}
+
+QWidget* UIManager::page(int index) const
+{
+    return index >= 0 && index < lazyPages.size() ? lazyPages.at(index).page : nullptr;
+}
+
+QWidget* UIManager::ensurePage(int index)
+{
+    if (index < 0 || index >= lazyPages.size()) {
+        return nullptr;
+    }
+    if (lazyPages.at(index).page || !lazyPages.at(index).factory) {
+        return lazyPages.at(index).page;
+    }
+    
+    // 先取走工厂，页面构造过程中再次触发（如切换标签页）时不会重复创建
+    const std::function<QWidget*(QWidget*)> factory = std::move(lazyPages[index].factory);
+    lazyPages[index].factory = nullptr;
+    warmUpQueue.removeAll(index);
+    
+    QWidget* container = lazyPages.at(index).container;
+    QElapsedTimer timer;
+    timer.start();
+    QWidget* created = nullptr;
+    STARTUP_PHASE("页面 " + tabWidget->tabText(index));
+    try {
+        created = factory(container);
+    } catch (const std::exception& e) {
+        qCritical() << "Exception creating page" << tabWidget->tabText(index) << ":" << e.what();
+        return nullptr;
+    } catch (...) {
+        qCritical() << "Unknown exception creating page" << tabWidget->tabText(index);
+        return nullptr;
+    }
+    
+    container->layout()->addWidget(created);
+    lazyPages[index].page = created;
+    qDebug() << "Page created:" << tabWidget->tabText(index) << timer.elapsed() << "ms";
+    emit pageCreated(index, created);
+    return created;
+}
+
+void UIManager::warmUpNextPage()
+{
+    // 每次只创建一页，两页之间回到事件循环处理输入和绘制
+    if (warmUpQueue.isEmpty()) {
+        warmUpTimer->stop();
+        qDebug() << "All pages warmed up";
+        return;
+    }
+    ensurePage(warmUpQueue.first());
+}
+
+bool UIManager::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == tabWidget && event->type() == QEvent::Paint && !firstFrameSeen) {
+        firstFrameSeen = true;
+        tabWidget->removeEventFilter(this);
+        StartupProfiler::mark("FirstPaint");
+        // 排在本次绘制之后：第一帧显示出来再启动后台子系统和页面预热
+        QTimer::singleShot(0, this, [this]() {
+            emit firstFramePainted();
+            warmUpTimer->start();
+        });
+    }
+    return QObject::eventFilter(watched, event);
+}
+
 void UIManager::setupLayoutAndConnections()
 {
     // 连接标签页变化信号
     if (tabWidget) {
         connect(tabWidget, &QTabWidget::currentChanged, this, &UIManager::onTabChanged);
+        
+        // 首帧绘制之后在后台逐个创建尚未显示过的页面
+        warmUpTimer = new QTimer(this);
+        warmUpTimer->setInterval(System::UI_PAGE_WARMUP_INTERVAL_MS);
+        connect(warmUpTimer, &QTimer::timeout, this, &UIManager::warmUpNextPage);
+        tabWidget->installEventFilter(this);
+        ensurePage(tabWidget->currentIndex());
     }
     
     qDebug() << "Layout and connections setup completed";
@@ -452,6 +550,7 @@ void UIManager::onHelpUpdate()
 void UIManager::onTabChanged(int index)
 {
     qDebug() << "Tab changed to index:" << index;
+    ensurePage(index);
     emit tabChanged(index);
 }
 
@@ -16,6 +16,8 @@
 #include <QTextEdit>
 #include <QTableWidget>
 #include <QTimer>
+#include <QList>
+#include <functional>
 
 // 前置声明
 class DeviceControlWidget;
@@ -92,6 +94,9 @@ public:
     QAction* getAction(const QString& name) const;
     QDockWidget* getDockWidget(const QString& name) const;
     QWidget* getWidget(const QString& name) const;
+    // 标签页在第一次显示或后台预热时创建，尚未创建时返回 nullptr；ensurePage() 立即创建
+    QWidget* page(int index) const;
+    QWidget* ensurePage(int index);
     
     // 状态查询
     bool isFullScreen() const { return isFullScreenMode; }
@@ -156,6 +161,13 @@ signals:
     void trayIconActivated();
     void mainWindowRestoreRequested();
     void minimizeToTrayRequested();
+    
+    // 主窗口第一帧绘制完成，之后再启动非关键的后台子系统
+    void firstFramePainted();
+    void pageCreated(int index, QWidget* page);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
     void setupMenuActions();
@@ -165,6 +177,8 @@ private:
     void setupDockWidgets();
     void setupSystemTrayIcon();
     void createFunctionalWidgets();
+    void addLazyPage(const QString& title, std::function<QWidget*(QWidget*)> factory, bool warmUpFirst = false);
+    void warmUpNextPage();
     void setupLayoutAndConnections();
     void loadSettings();
     void saveSettings();
@@ -223,6 +237,17 @@ private:
     SecurityWidget* securityWidget;
     CommunicationWidget* communicationWidget;
     
+    // 延迟创建的标签页：先放一个空容器，第一次切换到该页或后台预热时再创建页面（连同其数据库和定时器）
+    struct LazyPage {
+        QWidget* container = nullptr;
+        QWidget* page = nullptr;
+        std::function<QWidget*(QWidget*)> factory;
+    };
+    QList<LazyPage> lazyPages;          // 下标与标签页一致，立即创建的页 factory 为空
+    QList<int> warmUpQueue;             // 预热顺序
+    QTimer* warmUpTimer;
+    bool firstFrameSeen;
+    
     // 动作映射
     QHash<QString, QAction*> actionMap;
     QHash<QString, QDockWidget*> dockWidgetMap;
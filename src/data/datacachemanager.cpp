@@ -0,0 +1,377 @@
+#include "datacachemanager.h"
+#include "../constants.h"
+#include "../utils/monotonicclock.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStringList>
+
+namespace {
+constexpr qint64 ENTRY_OVERHEAD_BYTES = 96;     // 链表节点、索引和 Entry 本身的大致开销
+
+inline void bump(QAtomicInteger<qint64>& counter)
+{
+    counter.fetchAndAddRelaxed(1);
+}
+}
+
+DataCacheManager* DataCacheManager::instance = nullptr;
+QMutex DataCacheManager::mutex;
+
+DataCacheManager* DataCacheManager::getInstance()
+{
+    QMutexLocker locker(&mutex);
+    if (!instance) {
+        instance = new DataCacheManager();
+    }
+    return instance;
+}
+
+DataCacheManager::DataCacheManager()
+    : m_maxSizeBytes(System::DATA_CACHE_DEFAULT_MAX_BYTES)
+    , m_defaultTTL(System::DATA_CACHE_DEFAULT_TTL_SECONDS)
+    , m_policy(static_cast<int>(CachePolicy::LRU))
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+    , m_expirations(0)
+    , m_loads(0)
+    , m_sharedLoads(0)
+    , m_rejected(0)
+{
+}
+
+void DataCacheManager::setMaxSize(qint64 bytes)
+{
+    m_maxSizeBytes.storeRelaxed(qMax<qint64>(0, bytes));
+    const qint64 capacity = shardCapacity();
+    for (Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        evict(shard, capacity);
+    }
+}
+
+qint64 DataCacheManager::maxSize() const
+{
+    return m_maxSizeBytes.loadRelaxed();
+}
+
+void DataCacheManager::setDefaultTTL(int seconds)
+{
+    m_defaultTTL.storeRelaxed(qMax(0, seconds));
+}
+
+int DataCacheManager::defaultTTL() const
+{
+    return m_defaultTTL.loadRelaxed();
+}
+
+void DataCacheManager::setCachePolicy(CachePolicy policy)
+{
+    m_policy.storeRelaxed(static_cast<int>(policy));
+}
+
+CachePolicy DataCacheManager::cachePolicy() const
+{
+    return static_cast<CachePolicy>(m_policy.loadRelaxed());
+}
+
+QVariant DataCacheManager::get(const QString& key)
+{
+    Shard& shard = shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    QVariant value;
+    lookup(shard, key, &value);
+    return value;
+}
+
+bool DataCacheManager::contains(const QString& key)
+{
+    Shard& shard = shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    auto it = shard.index.constFind(key);
+    if (it == shard.index.constEnd()) {
+        return false;
+    }
+    const qint64 expiresNs = (*it)->expiresNs;
+    return expiresNs == 0 || MonotonicClock::nowNs() < expiresNs;
+}
+
+void DataCacheManager::put(const QString& key, const QVariant& value, CacheItemType type, int ttlSeconds)
+{
+    if (!value.isValid()) {
+        return;
+    }
+    Shard& shard = shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    insert(shard, key, value, type, ttlSeconds);
+}
+
+QVariant DataCacheManager::getOrLoad(const QString& key, const Loader& loader, CacheItemType type, int ttlSeconds)
+{
+    Shard& shard = shardFor(key);
+    std::shared_ptr<PendingLoad> pending;
+    bool owner = false;
+
+    {
+        QMutexLocker locker(&shard.mutex);
+        QVariant value;
+        if (lookup(shard, key, &value)) {
+            return value;
+        }
+
+        auto it = shard.loading.constFind(key);
+        if (it != shard.loading.constEnd()) {
+            pending = it.value();
+            bump(m_sharedLoads);
+        } else {
+            pending = std::make_shared<PendingLoad>();
+            shard.loading.insert(key, pending);
+            owner = true;
+            bump(m_loads);
+        }
+    }
+
+    // 同一个键已经有线程在加载，等待它的结果
+    if (!owner) {
+        QMutexLocker locker(&pending->mutex);
+        while (!pending->done) {
+            pending->finished.wait(&pending->mutex);
+        }
+        return pending->value;
+    }
+
+    // 加载函数在锁外执行；抛出异常时也要唤醒等待方
+    QVariant value;
+    auto finish = [&]() {
+        {
+            QMutexLocker locker(&shard.mutex);
+            if (value.isValid()) {
+                insert(shard, key, value, type, ttlSeconds);
+            }
+            shard.loading.remove(key);
+        }
+        QMutexLocker locker(&pending->mutex);
+        pending->value = value;
+        pending->done = true;
+        pending->finished.wakeAll();
+    };
+
+    try {
+        value = loader ? loader() : QVariant();
+    } catch (...) {
+        value = QVariant();
+        finish();
+        throw;
+    }
+    finish();
+    return value;
+}
+
+bool DataCacheManager::remove(const QString& key)
+{
+    Shard& shard = shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        return false;
+    }
+    erase(shard, it.value());
+    return true;
+}
+
+void DataCacheManager::clear()
+{
+    // 正在进行的加载不受影响，完成后照常写入
+    for (Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+        shard.sizeBytes = 0;
+    }
+}
+
+int DataCacheManager::purgeExpired()
+{
+    const qint64 now = MonotonicClock::nowNs();
+    int purged = 0;
+    for (Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            auto next = std::next(it);
+            if (it->expiresNs != 0 && now >= it->expiresNs) {
+                erase(shard, it);
+                bump(m_expirations);
+                ++purged;
+            }
+            it = next;
+        }
+    }
+    return purged;
+}
+
+CacheStatistics DataCacheManager::statistics() const
+{
+    CacheStatistics stats;
+    stats.hits = m_hits.loadRelaxed();
+    stats.misses = m_misses.loadRelaxed();
+    stats.evictions = m_evictions.loadRelaxed();
+    stats.expirations = m_expirations.loadRelaxed();
+    stats.loads = m_loads.loadRelaxed();
+    stats.sharedLoads = m_sharedLoads.loadRelaxed();
+    stats.rejected = m_rejected.loadRelaxed();
+    stats.maxSizeBytes = m_maxSizeBytes.loadRelaxed();
+    for (const Shard& shard : m_shards) {
+        QMutexLocker locker(&shard.mutex);
+        stats.entries += shard.index.size();
+        stats.sizeBytes += shard.sizeBytes;
+    }
+    return stats;
+}
+
+QJsonObject DataCacheManager::getStatistics() const
+{
+    const CacheStatistics stats = statistics();
+    QJsonObject json;
+    json["hits"] = stats.hits;
+    json["misses"] = stats.misses;
+    json["hitRate"] = stats.hitRate();
+    json["evictions"] = stats.evictions;
+    json["expirations"] = stats.expirations;
+    json["loads"] = stats.loads;
+    json["sharedLoads"] = stats.sharedLoads;
+    json["rejected"] = stats.rejected;
+    json["entries"] = stats.entries;
+    json["sizeBytes"] = stats.sizeBytes;
+    json["maxSizeBytes"] = stats.maxSizeBytes;
+    json["shards"] = SHARD_COUNT;
+    json["policy"] = cachePolicy() == CachePolicy::LRU ? "LRU" : "FIFO";
+    return json;
+}
+
+void DataCacheManager::resetStatistics()
+{
+    for (QAtomicInteger<qint64>* counter : {&m_hits, &m_misses, &m_evictions, &m_expirations,
+                                            &m_loads, &m_sharedLoads, &m_rejected}) {
+        counter->storeRelaxed(0);
+    }
+}
+
+qint64 DataCacheManager::estimateSize(const QVariant& value)
+{
+    qint64 size = sizeof(QVariant);
+    switch (value.typeId()) {
+    case QMetaType::UnknownType:
+        return 0;
+    case QMetaType::QByteArray:
+        return size + value.toByteArray().size();
+    case QMetaType::QString:
+        return size + value.toString().size() * static_cast<qint64>(sizeof(QChar));
+    case QMetaType::QStringList:
+        for (const QString& item : value.toStringList()) {
+            size += sizeof(QString) + item.size() * static_cast<qint64>(sizeof(QChar));
+        }
+        return size;
+    case QMetaType::QVariantList:
+        for (const QVariant& item : value.toList()) {
+            size += estimateSize(item);
+        }
+        return size;
+    case QMetaType::QVariantMap: {
+        const QVariantMap map = value.toMap();
+        for (auto it = map.cbegin(); it != map.cend(); ++it) {
+            size += sizeof(QString) + it.key().size() * static_cast<qint64>(sizeof(QChar)) + estimateSize(it.value());
+        }
+        return size;
+    }
+    case QMetaType::QVariantHash: {
+        const QVariantHash hash = value.toHash();
+        for (auto it = hash.cbegin(); it != hash.cend(); ++it) {
+            size += sizeof(QString) + it.key().size() * static_cast<qint64>(sizeof(QChar)) + estimateSize(it.value());
+        }
+        return size;
+    }
+    case QMetaType::QJsonObject:
+        return size + QJsonDocument(value.toJsonObject()).toJson(QJsonDocument::Compact).size();
+    case QMetaType::QJsonArray:
+        return size + QJsonDocument(value.toJsonArray()).toJson(QJsonDocument::Compact).size();
+    default:
+        // 其他类型按值的大小计算，内部另有堆内存的自定义类型会被低估
+        return size + qMax(0, value.metaType().sizeOf());
+    }
+}
+
+DataCacheManager::Shard& DataCacheManager::shardFor(const QString& key)
+{
+    return m_shards[qHash(key) % SHARD_COUNT];
+}
+
+qint64 DataCacheManager::expiryFor(int ttlSeconds) const
+{
+    const int ttl = ttlSeconds < 0 ? m_defaultTTL.loadRelaxed() : ttlSeconds;
+    return ttl > 0 ? MonotonicClock::nowNs() + ttl * 1000000000LL : 0;
+}
+
+qint64 DataCacheManager::shardCapacity() const
+{
+    return m_maxSizeBytes.loadRelaxed() / SHARD_COUNT;
+}
+
+bool DataCacheManager::lookup(Shard& shard, const QString& key, QVariant* value)
+{
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        bump(m_misses);
+        return false;
+    }
+
+    auto entry = it.value();
+    if (entry->expiresNs != 0 && MonotonicClock::nowNs() >= entry->expiresNs) {
+        erase(shard, entry);
+        bump(m_expirations);
+        bump(m_misses);
+        return false;
+    }
+
+    if (cachePolicy() == CachePolicy::LRU) {
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+    }
+    *value = entry->value;
+    bump(m_hits);
+    return true;
+}
+
+void DataCacheManager::insert(Shard& shard, const QString& key, const QVariant& value, CacheItemType type,
+                              int ttlSeconds)
+{
+    auto existing = shard.index.find(key);
+    if (existing != shard.index.end()) {
+        erase(shard, existing.value());
+    }
+
+    const qint64 capacity = shardCapacity();
+    const qint64 sizeBytes = estimateSize(value) + key.size() * static_cast<qint64>(sizeof(QChar)) + ENTRY_OVERHEAD_BYTES;
+    if (sizeBytes > capacity) {
+        bump(m_rejected);
+        return;
+    }
+
+    shard.entries.push_front(Entry{key, value, sizeBytes, expiryFor(ttlSeconds), type});
+    shard.index.insert(key, shard.entries.begin());
+    shard.sizeBytes += sizeBytes;
+    evict(shard, capacity);
+}
+
+void DataCacheManager::erase(Shard& shard, std::list<Entry>::iterator it)
+{
+    shard.sizeBytes -= it->sizeBytes;
+    shard.index.remove(it->key);
+    shard.entries.erase(it);
+}
+
+void DataCacheManager::evict(Shard& shard, qint64 capacity)
+{
+    while (shard.sizeBytes > capacity && !shard.entries.empty()) {
+        erase(shard, std::prev(shard.entries.end()));
+        bump(m_evictions);
+    }
+}
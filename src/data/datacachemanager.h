@@ -0,0 +1,140 @@
+#pragma once
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+#include <QWaitCondition>
+#include <functional>
+#include <list>
+#include <memory>
+
+// 淘汰策略
+enum class CachePolicy {
+    LRU = 0,        // 最近最少使用
+    FIFO            // 先进先出，读取不改变顺序
+};
+
+// 缓存项类型，由调用方标注
+enum class CacheItemType {
+    General = 0,
+    ChartData,
+    TableData,
+    Statistics,
+    UserData
+};
+
+// 缓存统计
+struct CacheStatistics {
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 evictions = 0;       // 超出容量被淘汰
+    qint64 expirations = 0;     // 超时失效
+    qint64 loads = 0;           // getOrLoad() 实际调用加载函数的次数
+    qint64 sharedLoads = 0;     // 等待其他线程正在进行的加载、没有重复加载的次数
+    qint64 rejected = 0;        // 单项超过分片容量、没有缓存
+    int entries = 0;
+    qint64 sizeBytes = 0;
+    qint64 maxSizeBytes = 0;
+
+    double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+// 界面数据缓存
+//
+// 按键的哈希分成 SHARD_COUNT 个分片，每个分片有自己的锁、LRU 链表和容量（总容量均分），
+// 工作线程并发读写不同的键时基本不会争用同一把锁。每项按估算的实际字节数计入容量，
+// 超出时从该分片的链表尾淘汰。过期时间用单调时钟，读取时惰性检查。
+// getOrLoad() 在未命中时调用加载函数，同一个键的并发未命中只加载一次，其余调用方等待结果。
+class DataCacheManager
+{
+public:
+    using Loader = std::function<QVariant()>;
+
+    static constexpr int SHARD_COUNT = 16;
+
+    static DataCacheManager* getInstance();
+
+    // 总容量（字节）
+    void setMaxSize(qint64 bytes);
+    qint64 maxSize() const;
+    // 默认过期时间（秒），0 表示不过期
+    void setDefaultTTL(int seconds);
+    int defaultTTL() const;
+    void setCachePolicy(CachePolicy policy);
+    CachePolicy cachePolicy() const;
+
+    // 未命中或已过期时返回无效的 QVariant
+    QVariant get(const QString& key);
+    bool contains(const QString& key);
+    // ttlSeconds < 0 使用默认过期时间；无效的 value 不缓存
+    void put(const QString& key, const QVariant& value, CacheItemType type = CacheItemType::General,
+             int ttlSeconds = -1);
+    QVariant getOrLoad(const QString& key, const Loader& loader, CacheItemType type = CacheItemType::General,
+                       int ttlSeconds = -1);
+    bool remove(const QString& key);
+    void clear();
+    // 清理所有分片中已过期的项
+    int purgeExpired();
+
+    CacheStatistics statistics() const;
+    QJsonObject getStatistics() const;
+    void resetStatistics();
+
+    // 估算 QVariant 占用的字节数（容器递归计算）
+    static qint64 estimateSize(const QVariant& value);
+
+private:
+    struct Entry {
+        QString key;
+        QVariant value;
+        qint64 sizeBytes;
+        qint64 expiresNs;       // 0 表示不过期
+        CacheItemType type;
+    };
+
+    // 正在进行的加载，等待方持有共享指针
+    struct PendingLoad {
+        QMutex mutex;
+        QWaitCondition finished;
+        bool done = false;
+        QVariant value;
+    };
+
+    struct Shard {
+        mutable QMutex mutex;
+        std::list<Entry> entries;                           // 表头为最近使用
+        QHash<QString, std::list<Entry>::iterator> index;
+        QHash<QString, std::shared_ptr<PendingLoad>> loading;
+        qint64 sizeBytes = 0;
+    };
+
+    DataCacheManager();
+
+    Shard& shardFor(const QString& key);
+    qint64 expiryFor(int ttlSeconds) const;
+    qint64 shardCapacity() const;
+    // 以下在持有分片锁时调用
+    bool lookup(Shard& shard, const QString& key, QVariant* value);
+    void insert(Shard& shard, const QString& key, const QVariant& value, CacheItemType type, int ttlSeconds);
+    void erase(Shard& shard, std::list<Entry>::iterator it);
+    void evict(Shard& shard, qint64 capacity);
+
+    Shard m_shards[SHARD_COUNT];
+    QAtomicInteger<qint64> m_maxSizeBytes;
+    QAtomicInt m_defaultTTL;
+    QAtomicInt m_policy;
+
+    QAtomicInteger<qint64> m_hits;
+    QAtomicInteger<qint64> m_misses;
+    QAtomicInteger<qint64> m_evictions;
+    QAtomicInteger<qint64> m_expirations;
+    QAtomicInteger<qint64> m_loads;
+    QAtomicInteger<qint64> m_sharedLoads;
+    QAtomicInteger<qint64> m_rejected;
+
+    static DataCacheManager* instance;
+    static QMutex mutex;
+};
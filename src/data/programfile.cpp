@@ -0,0 +1,404 @@
+#include "programfile.h"
+#include "../utils/crcengine.h"
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr quint32 MAGIC = 0x31504447;           // 小端主机上按字节为 "GDP1"
+constexpr qint64 INVALID_TIME = std::numeric_limits<qint64>::min();
+
+void setError(QString* error, const QString& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+qint64 toFileTime(const QDateTime& time)
+{
+    return time.isValid() ? time.toMSecsSinceEpoch() : INVALID_TIME;
+}
+
+QDateTime fromFileTime(qint64 time)
+{
+    return time == INVALID_TIME ? QDateTime() : QDateTime::fromMSecsSinceEpoch(time);
+}
+
+void appendString(QByteArray& out, const QString& text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    const quint32 length = static_cast<quint32>(utf8.size());
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(utf8);
+}
+
+bool readString(const uchar*& cursor, const uchar* end, QString* text)
+{
+    quint32 length = 0;
+    if (end - cursor < static_cast<qptrdiff>(sizeof(length))) {
+        return false;
+    }
+    std::memcpy(&length, cursor, sizeof(length));
+    cursor += sizeof(length);
+    if (static_cast<quint64>(end - cursor) < length) {
+        return false;
+    }
+    *text = QString::fromUtf8(reinterpret_cast<const char*>(cursor), static_cast<qsizetype>(length));
+    cursor += length;
+    return true;
+}
+
+// [0, metaEnd) 的 CRC32C，metaCrc 字段按 0 计
+quint32 metaChecksum(const uchar* data, quint64 metaEnd)
+{
+    static const uchar zero[sizeof(quint32)] = {};
+    const size_t field = offsetof(ProgramFileHeader, metaCrc);
+    uint32_t state = CRCEngine::updateCRC32C(0xFFFFFFFF, data, field);
+    state = CRCEngine::updateCRC32C(state, zero, sizeof(zero));
+    state = CRCEngine::updateCRC32C(state, data + field + sizeof(zero),
+                                    static_cast<size_t>(metaEnd - field - sizeof(zero)));
+    return state ^ 0xFFFFFFFF;
+}
+
+}
+
+ProgramFile::ProgramFile()
+    : m_data(nullptr)
+    , m_size(0)
+{
+}
+
+ProgramFile::~ProgramFile()
+{
+    close();
+}
+
+bool ProgramFile::open(const QString& filePath, QString* error)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setError(error, QString("无法打开程序文件: %1 (%2)").arg(filePath, m_file.errorString()));
+        return false;
+    }
+
+    const auto fail = [&](const QString& message) {
+        setError(error, QString("%1: %2").arg(message, filePath));
+        close();
+        return false;
+    };
+
+    const qint64 size = m_file.size();
+    if (size < static_cast<qint64>(sizeof(ProgramFileHeader) + sizeof(ProgramFileParams))) {
+        return fail("程序文件不完整");
+    }
+    m_data = m_file.map(0, size);
+    if (!m_data) {
+        return fail(QString("程序文件映射失败 (%1)").arg(m_file.errorString()));
+    }
+    m_size = size;
+
+    const ProgramFileHeader& head = header();
+    if (head.magic == qbswap(MAGIC)) {
+        return fail("程序文件由不同字节序的主机写入");
+    }
+    if (head.magic != MAGIC) {
+        return fail("不是点胶程序文件");
+    }
+    if (head.version == 0 || head.version > VERSION) {
+        return fail(QString("程序文件版本 %1 高于支持的版本 %2").arg(head.version).arg(VERSION));
+    }
+    if (head.headerSize < sizeof(ProgramFileHeader) || head.headerSize % alignof(ProgramFileParams) != 0 ||
+        head.pointSize != sizeof(ProgramFilePoint)) {
+        return fail("程序文件头无效");
+    }
+
+    // 长度都按 64 位比较，损坏的字段不会溢出
+    const quint64 fileSize = static_cast<quint64>(size);
+    const quint64 metaEnd = quint64(head.headerSize) + sizeof(ProgramFileParams) + head.stringsSize;
+    if (metaEnd > fileSize || head.pointsOffset > fileSize) {
+        return fail("程序文件不完整");
+    }
+    if (head.pointsOffset < metaEnd || head.pointsOffset % alignof(ProgramFilePoint) != 0) {
+        return fail("程序文件头无效");
+    }
+    if (head.pointCount > (fileSize - head.pointsOffset) / sizeof(ProgramFilePoint)) {
+        return fail("程序文件不完整");
+    }
+    if (metaChecksum(m_data, metaEnd) != head.metaCrc) {
+        return fail("程序文件头校验失败");
+    }
+
+    const uchar* cursor = m_data + head.headerSize + sizeof(ProgramFileParams);
+    const uchar* end = m_data + metaEnd;
+    if (!readString(cursor, end, &m_name) || !readString(cursor, end, &m_version) ||
+        !readString(cursor, end, &m_description)) {
+        return fail("程序文件头无效");
+    }
+    return true;
+}
+
+void ProgramFile::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_name.clear();
+    m_version.clear();
+    m_description.clear();
+}
+
+bool ProgramFile::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+const ProgramFileHeader& ProgramFile::header() const
+{
+    return *reinterpret_cast<const ProgramFileHeader*>(m_data);
+}
+
+const ProgramFileParams& ProgramFile::params() const
+{
+    return *reinterpret_cast<const ProgramFileParams*>(m_data + header().headerSize);
+}
+
+const QString& ProgramFile::name() const
+{
+    return m_name;
+}
+
+const QString& ProgramFile::version() const
+{
+    return m_version;
+}
+
+const QString& ProgramFile::description() const
+{
+    return m_description;
+}
+
+quint64 ProgramFile::pointCount() const
+{
+    return m_data ? header().pointCount : 0;
+}
+
+const ProgramFilePoint* ProgramFile::points() const
+{
+    return m_data ? reinterpret_cast<const ProgramFilePoint*>(m_data + header().pointsOffset) : nullptr;
+}
+
+bool ProgramFile::verifyPoints() const
+{
+    if (!m_data) {
+        return false;
+    }
+    const ProgramFileHeader& head = header();
+    const uint32_t crc = CRCEngine::updateCRC32C(0xFFFFFFFF, m_data + head.pointsOffset,
+                                                 static_cast<size_t>(head.pointCount * sizeof(ProgramFilePoint)));
+    return (crc ^ 0xFFFFFFFF) == head.pointsCrc;
+}
+
+void ProgramFile::toProgram(GlueProgram* program) const
+{
+    const ProgramFileHeader& head = header();
+    program->name = m_name;
+    program->version = m_version;
+    program->description = m_description;
+    program->createTime = fromFileTime(head.createTime);
+    program->modifyTime = fromFileTime(head.modifyTime);
+
+    const ProgramFileParams& source = params();
+    program->params.volume = source.volume;
+    program->params.speed = source.speed;
+    program->params.pressure = source.pressure;
+    program->params.temperature = source.temperature;
+    program->params.dwellTime = source.dwellTime;
+    program->params.riseTime = source.riseTime;
+    program->params.fallTime = source.fallTime;
+
+    const ProgramFilePoint* points = this->points();
+    const qsizetype count = static_cast<qsizetype>(head.pointCount);
+    program->trajectory.resize(count);
+    GlueProgram::TrajectoryPoint* target = program->trajectory.data();
+    for (qsizetype i = 0; i < count; ++i) {
+        const ProgramFilePoint& point = points[i];
+        target[i].x = point.x;
+        target[i].y = point.y;
+        target[i].z = point.z;
+        target[i].speed = point.speed;
+        target[i].volume = point.volume;
+        target[i].dwellTime = point.dwellTime;
+        target[i].isGluePoint = (point.flags & POINT_GLUE) != 0;
+    }
+}
+
+bool ProgramFile::write(const QString& filePath, const GlueProgram& program, QString* error)
+{
+    const qsizetype count = program.trajectory.size();
+    std::vector<ProgramFilePoint> points(static_cast<size_t>(count));
+    for (qsizetype i = 0; i < count; ++i) {
+        const GlueProgram::TrajectoryPoint& source = program.trajectory.at(i);
+        ProgramFilePoint& point = points[static_cast<size_t>(i)];
+        std::memset(&point, 0, sizeof(point));
+        point.x = source.x;
+        point.y = source.y;
+        point.z = source.z;
+        point.speed = source.speed;
+        point.volume = source.volume;
+        point.dwellTime = source.dwellTime;
+        point.flags = source.isGluePoint ? POINT_GLUE : 0;
+    }
+    const size_t pointBytes = points.size() * sizeof(ProgramFilePoint);
+
+    ProgramFileParams params;
+    std::memset(&params, 0, sizeof(params));
+    params.volume = program.params.volume;
+    params.speed = program.params.speed;
+    params.pressure = program.params.pressure;
+    params.temperature = program.params.temperature;
+    params.dwellTime = program.params.dwellTime;
+    params.riseTime = program.params.riseTime;
+    params.fallTime = program.params.fallTime;
+
+    QByteArray strings;
+    appendString(strings, program.name);
+    appendString(strings, program.version);
+    appendString(strings, program.description);
+
+    ProgramFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.headerSize = sizeof(ProgramFileHeader);
+    header.pointSize = sizeof(ProgramFilePoint);
+    header.pointCount = static_cast<quint64>(count);
+    header.createTime = toFileTime(program.createTime);
+    header.modifyTime = toFileTime(program.modifyTime);
+    header.stringsSize = static_cast<quint32>(strings.size());
+    header.pointsCrc = CRCEngine::updateCRC32C(0xFFFFFFFF, reinterpret_cast<const uint8_t*>(points.data()),
+                                               pointBytes) ^ 0xFFFFFFFF;
+
+    const quint64 metaEnd = sizeof(header) + sizeof(params) + static_cast<quint64>(strings.size());
+    header.pointsOffset = (metaEnd + alignof(ProgramFilePoint) - 1) & ~quint64(alignof(ProgramFilePoint) - 1);
+
+    QByteArray meta;
+    meta.reserve(static_cast<qsizetype>(header.pointsOffset));
+    meta.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    meta.append(reinterpret_cast<const char*>(&params), sizeof(params));
+    meta.append(strings);
+    meta.append(static_cast<qsizetype>(header.pointsOffset - metaEnd), '\0');
+    const quint32 crc = metaChecksum(reinterpret_cast<const uchar*>(meta.constData()), metaEnd);
+    std::memcpy(meta.data() + offsetof(ProgramFileHeader, metaCrc), &crc, sizeof(crc));
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(error, QString("无法保存程序文件: %1 (%2)").arg(filePath, file.errorString()));
+        return false;
+    }
+    if (file.write(meta) != meta.size() ||
+        file.write(reinterpret_cast<const char*>(points.data()), static_cast<qint64>(pointBytes)) !=
+            static_cast<qint64>(pointBytes) ||
+        !file.commit()) {
+        setError(error, QString("写入程序文件失败: %1 (%2)").arg(filePath, file.errorString()));
+        file.cancelWriting();
+        return false;
+    }
+    return true;
+}
+
+bool ProgramFile::read(const QString& filePath, GlueProgram* program, QString* error)
+{
+    ProgramFile file;
+    if (!file.open(filePath, error)) {
+        return false;
+    }
+    if (!file.verifyPoints()) {
+        setError(error, QString("程序文件轨迹校验失败: %1").arg(filePath));
+        return false;
+    }
+    file.toProgram(program);
+    return true;
+}
+
+QJsonObject ProgramFile::toJson(const GlueProgram& program)
+{
+    QJsonObject obj;
+    obj["name"] = program.name;
+    obj["version"] = program.version;
+    obj["description"] = program.description;
+    obj["createTime"] = program.createTime.toString(Qt::ISODate);
+    obj["modifyTime"] = program.modifyTime.toString(Qt::ISODate);
+
+    QJsonObject params;
+    params["volume"] = program.params.volume;
+    params["speed"] = program.params.speed;
+    params["pressure"] = program.params.pressure;
+    params["temperature"] = program.params.temperature;
+    params["dwellTime"] = program.params.dwellTime;
+    params["riseTime"] = program.params.riseTime;
+    params["fallTime"] = program.params.fallTime;
+    obj["parameters"] = params;
+
+    QJsonArray trajectory;
+    for (const GlueProgram::TrajectoryPoint& point : program.trajectory) {
+        QJsonObject pointObj;
+        pointObj["x"] = point.x;
+        pointObj["y"] = point.y;
+        pointObj["z"] = point.z;
+        pointObj["speed"] = point.speed;
+        pointObj["volume"] = point.volume;
+        pointObj["dwellTime"] = point.dwellTime;
+        pointObj["isGluePoint"] = point.isGluePoint;
+        trajectory.append(pointObj);
+    }
+    obj["trajectory"] = trajectory;
+    return obj;
+}
+
+GlueProgram ProgramFile::fromJson(const QJsonObject& obj)
+{
+    GlueProgram program;
+    program.name = obj["name"].toString();
+    program.version = obj["version"].toString();
+    program.description = obj["description"].toString();
+    program.createTime = QDateTime::fromString(obj["createTime"].toString(), Qt::ISODate);
+    program.modifyTime = QDateTime::fromString(obj["modifyTime"].toString(), Qt::ISODate);
+
+    const QJsonObject params = obj["parameters"].toObject();
+    program.params.volume = params["volume"].toDouble();
+    program.params.speed = params["speed"].toDouble();
+    program.params.pressure = params["pressure"].toDouble();
+    program.params.temperature = params["temperature"].toDouble();
+    program.params.dwellTime = params["dwellTime"].toInt();
+    program.params.riseTime = params["riseTime"].toInt();
+    program.params.fallTime = params["fallTime"].toInt();
+
+    const QJsonArray trajectory = obj["trajectory"].toArray();
+    program.trajectory.reserve(trajectory.size());
+    for (const QJsonValue& value : trajectory) {
+        const QJsonObject pointObj = value.toObject();
+        GlueProgram::TrajectoryPoint point;
+        point.x = pointObj["x"].toDouble();
+        point.y = pointObj["y"].toDouble();
+        point.z = pointObj["z"].toDouble();
+        point.speed = pointObj["speed"].toDouble();
+        point.volume = pointObj["volume"].toDouble();
+        point.dwellTime = pointObj["dwellTime"].toInt();
+        point.isGluePoint = pointObj["isGluePoint"].toBool();
+        program.trajectory.append(point);
+    }
+    return program;
+}
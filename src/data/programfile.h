@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QFile>
+#include <QJsonObject>
+#include <QString>
+#include <QtGlobal>
+#include "glueprogram.h"
+
+// 点胶程序二进制文件（.gdp）
+//
+// 布局（本机字节序；魔数按本机字节序读出不一致即为其他字节序的主机写出，拒绝打开）：
+//   文件头      ProgramFileHeader，64 字节
+//   参数块      ProgramFileParams，从 headerSize 开始，48 字节
+//   字符串块    名称、版本、描述依次为 长度(4) + UTF-8，共 stringsSize 字节
+//   补齐到 8 字节
+//   轨迹数组    ProgramFilePoint × pointCount，从 pointsOffset 开始
+// metaCrc 为文件头（metaCrc 字段按 0 计）、参数块和字符串块的 CRC32C，pointsCrc 为轨迹数组的 CRC32C。
+//
+// open() 映射整个文件，只校验文件头、长度和 metaCrc，轨迹数组直接在映射区上按结构体数组使用，
+// 不做任何解析；verifyPoints() 按需校验轨迹数组。version 大于本版本的文件拒绝打开。
+// JSON 格式保留用于导入导出，toJson()/fromJson() 与原来参数页的字段一致。
+
+struct ProgramFileHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 headerSize;         // 参数块的偏移，新版本可在文件头末尾追加字段
+    quint32 flags;              // 保留，写 0
+    quint32 pointSize;          // sizeof(ProgramFilePoint)
+    quint64 pointCount;
+    quint64 pointsOffset;
+    qint64 createTime;          // UTC 毫秒，无效时间为 INT64_MIN
+    qint64 modifyTime;
+    quint32 stringsSize;
+    quint32 pointsCrc;
+    quint32 metaCrc;
+    quint32 reserved;
+};
+
+struct ProgramFileParams {
+    double volume;
+    double speed;
+    double pressure;
+    double temperature;
+    qint32 dwellTime;
+    qint32 riseTime;
+    qint32 fallTime;
+    qint32 reserved;
+};
+
+struct ProgramFilePoint {
+    double x;
+    double y;
+    double z;
+    double speed;
+    double volume;
+    qint32 dwellTime;
+    quint8 flags;               // POINT_GLUE
+    quint8 reserved[3];
+};
+
+static_assert(sizeof(ProgramFileHeader) == 64, "ProgramFileHeader 布局已改变");
+static_assert(sizeof(ProgramFileParams) == 48, "ProgramFileParams 布局已改变");
+static_assert(sizeof(ProgramFilePoint) == 48, "ProgramFilePoint 布局已改变");
+
+// 只读映射一个程序文件；写入和 JSON 转换为静态函数
+class ProgramFile
+{
+public:
+    static constexpr quint16 VERSION = 1;
+    static constexpr quint8 POINT_GLUE = 0x01;
+    static constexpr const char* SUFFIX = "gdp";
+
+    ProgramFile();
+    ~ProgramFile();
+
+    bool open(const QString& filePath, QString* error = nullptr);
+    void close();
+    bool isOpen() const;
+
+    const ProgramFileHeader& header() const;
+    const ProgramFileParams& params() const;
+    const QString& name() const;
+    const QString& version() const;
+    const QString& description() const;
+
+    quint64 pointCount() const;
+    // 指向映射区，文件关闭后失效
+    const ProgramFilePoint* points() const;
+    bool verifyPoints() const;
+
+    // 拷贝成可编辑的程序
+    void toProgram(GlueProgram* program) const;
+
+    // 写入临时文件后替换，失败时原文件保持不变
+    static bool write(const QString& filePath, const GlueProgram& program, QString* error = nullptr);
+    // open() + verifyPoints() + toProgram()
+    static bool read(const QString& filePath, GlueProgram* program, QString* error = nullptr);
+
+    static QJsonObject toJson(const GlueProgram& program);
+    static GlueProgram fromJson(const QJsonObject& object);
+
+private:
+    Q_DISABLE_COPY(ProgramFile)
+
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    QString m_name;
+    QString m_version;
+    QString m_description;
+};
@@ -0,0 +1,98 @@
+#include "sensorhistory.h"
+#include "../constants.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+
+namespace {
+const char* const COLUMN_NAMES[SensorHistory::ColumnCount] = {
+    "positionX", "positionY", "positionZ", "velocity", "pressure", "temperature", "glueVolume", "deviceStatus"
+};
+const char* const DISPLAY_NAMES[SensorHistory::ColumnCount] = {
+    "X位置", "Y位置", "Z位置", "速度", "压力", "温度", "胶量", "设备状态"
+};
+const char* const UNITS[SensorHistory::ColumnCount] = {
+    "mm", "mm", "mm", "mm/s", "Bar", "°C", "μL", ""
+};
+
+QString historyDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/" + AppInfo::DATA_DIR_NAME + "/history";
+}
+}
+
+SensorHistory* SensorHistory::instance = nullptr;
+QMutex SensorHistory::mutex;
+
+SensorHistory* SensorHistory::getInstance()
+{
+    QMutexLocker locker(&mutex);
+    if (!instance) {
+        instance = new SensorHistory();
+        if (QCoreApplication* app = QCoreApplication::instance()) {
+            // 单例不会析构，退出前封存活动块
+            QObject::connect(app, &QCoreApplication::aboutToQuit, app, []() {
+                instance->m_rollup.close();
+                instance->m_store.close();
+            });
+        }
+    }
+    return instance;
+}
+
+SensorHistory::SensorHistory()
+    : m_store(historyDirectory(), "sensor", columnNames())
+    , m_rollup(&m_store, historyDirectory() + "/rollup", "sensor")
+{
+    if (m_store.open()) {
+        m_rollup.open();
+    }
+}
+
+bool SensorHistory::append(qint64 timestampMs, const double* values)
+{
+    if (!m_store.append(timestampMs, values)) {
+        return false;
+    }
+    m_rollup.append(timestampMs, values);
+    return true;
+}
+
+TimeSeriesStore* SensorHistory::store()
+{
+    return &m_store;
+}
+
+TimeSeriesRollup* SensorHistory::rollup()
+{
+    return &m_rollup;
+}
+
+QStringList SensorHistory::columnNames()
+{
+    QStringList names;
+    for (const char* name : COLUMN_NAMES) {
+        names.append(QString::fromLatin1(name));
+    }
+    return names;
+}
+
+QString SensorHistory::displayName(int column)
+{
+    return column >= 0 && column < ColumnCount ? QString::fromUtf8(DISPLAY_NAMES[column]) : QString();
+}
+
+QString SensorHistory::unit(int column)
+{
+    return column >= 0 && column < ColumnCount ? QString::fromUtf8(UNITS[column]) : QString();
+}
+
+int SensorHistory::columnForParameter(const QString& parameter)
+{
+    for (int column = 0; column < ColumnCount; ++column) {
+        if (parameter.compare(QLatin1String(COLUMN_NAMES[column]), Qt::CaseInsensitive) == 0
+            || parameter == QString::fromUtf8(DISPLAY_NAMES[column])) {
+            return column;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "timeseriesrollup.h"
+#include "timeseriesstore.h"
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+// 传感器历史数据（X/Y/Z 位置、速度、压力、温度、胶量和设备状态）
+//
+// 数据监控界面按采样追加，图表界面按时间范围查询。原始数据保存在
+// <AppDataLocation>/data/history 下的列式时间序列存储中，1 秒 / 1 分钟 / 1 小时汇总
+// 保存在其下的 rollup 目录，长时间范围的查询走汇总层级。应用退出时封存最后一块。
+class SensorHistory
+{
+public:
+    enum Column {
+        PositionX = 0,
+        PositionY,
+        PositionZ,
+        Velocity,
+        Pressure,
+        Temperature,
+        GlueVolume,
+        DeviceStatus,
+        ColumnCount
+    };
+
+    static SensorHistory* getInstance();
+
+    // 追加一个采样点，同时更新各汇总层级；values 按 Column 顺序排列
+    bool append(qint64 timestampMs, const double* values);
+
+    // 存储打开失败时仍返回对象，追加和查询返回空结果
+    TimeSeriesStore* store();
+    TimeSeriesRollup* rollup();
+
+    static QStringList columnNames();
+    static QString displayName(int column);
+    static QString unit(int column);
+    // 接受列名（如 "temperature"）或显示名（如 "温度"），找不到时返回 -1
+    static int columnForParameter(const QString& parameter);
+
+private:
+    SensorHistory();
+
+    TimeSeriesStore m_store;
+    TimeSeriesRollup m_rollup;     // 引用 m_store，先于它析构
+
+    static SensorHistory* instance;
+    static QMutex mutex;
+};
@@ -0,0 +1,52 @@
+#include "sensorrecorder.h"
+#include "sensorhistory.h"
+#include "../utils/monotonicclock.h"
+#include <QtEndian>
+
+namespace {
+constexpr int SENSOR_FRAME_MIN_LENGTH = 32;     // 7 个 float + 状态字节，与 AlarmEngine 的解析一致
+constexpr int SENSOR_STATUS_OFFSET = 28;
+}
+
+SensorRecorder::SensorRecorder(QObject* parent)
+    : QObject(parent)
+    , m_recorded(0)
+{
+}
+
+qint64 SensorRecorder::recordedCount() const
+{
+    return m_recorded.load(std::memory_order_relaxed);
+}
+
+void SensorRecorder::recordFrame(const ProtocolFrame& frame)
+{
+    if (frame.command != ProtocolCommand::ReadSensorData || frame.dataLength < SENSOR_FRAME_MIN_LENGTH) {
+        return;
+    }
+
+    // 帧数据区的 7 个小端 float 与 SensorHistory 的列顺序一致，最后一列为设备状态
+    const uchar* data = reinterpret_cast<const uchar*>(frame.data);
+    double values[SensorHistory::ColumnCount];
+    for (int i = 0; i < SensorHistory::DeviceStatus; ++i) {
+        values[i] = qFromLittleEndian<float>(data + i * sizeof(float));
+    }
+    values[SensorHistory::DeviceStatus] = data[SENSOR_STATUS_OFFSET];
+
+    const qint64 timestampNs = frame.timestampNs > 0 ? frame.timestampNs : ProtocolFrame::currentTimestampNs();
+    if (SensorHistory::getInstance()->append(MonotonicClock::toEpochMs(timestampNs), values)) {
+        m_recorded.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SensorRecorder::recordFrames(const FrameBatch& frames)
+{
+    for (const ProtocolFrame& frame : frames) {
+        recordFrame(frame);
+    }
+}
+
+void SensorRecorder::flush()
+{
+    SensorHistory::getInstance()->store()->flush();
+}
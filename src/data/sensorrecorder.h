@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include "../communication/protocolparser.h"
+
+// 传感器数据记录 - 把传感器数据帧（ReadSensorData）直接写入 SensorHistory，不经过数据监控界面。
+// 无界面的采集服务用它保存完整历史；界面程序由 DataMonitorWidget 按显示的采样写入。
+// 追加列式存储会写盘，应放在单独的线程中并以排队连接接收帧，不要直接连接在接收线程上
+class SensorRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SensorRecorder(QObject* parent = nullptr);
+
+    qint64 recordedCount() const;
+
+public slots:
+    void recordFrame(const ProtocolFrame& frame);
+    void recordFrames(const FrameBatch& frames);
+    // 封存活动块，停止前调用
+    void flush();
+
+private:
+    std::atomic<qint64> m_recorded;
+};
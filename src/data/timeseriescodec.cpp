@@ -0,0 +1,235 @@
+#include "timeseriescodec.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+inline quint64 lowMask(int count)
+{
+    return count >= 64 ? ~quint64(0) : (quint64(1) << count) - 1;
+}
+
+inline bool fitsSigned(qint64 value, int bits)
+{
+    const qint64 limit = qint64(1) << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+inline qint64 signExtend(quint64 raw, int bits)
+{
+    const int shift = 64 - bits;
+    return static_cast<qint64>(raw << shift) >> shift;
+}
+
+inline quint64 doubleBits(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double bitsToDouble(quint64 bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+}
+
+BitWriter::BitWriter(QByteArray& out)
+    : m_out(out)
+    , m_buffer(0)
+    , m_pending(0)
+{
+}
+
+void BitWriter::writeBits(quint64 value, int count)
+{
+    while (count > 0) {
+        const int take = std::min(count, 64 - m_pending);
+        const quint64 chunk = (value >> (count - take)) & lowMask(take);
+        m_buffer = take == 64 ? chunk : (m_buffer << take) | chunk;
+        m_pending += take;
+        count -= take;
+        if (m_pending == 64) {
+            flushWord();
+        }
+    }
+}
+
+void BitWriter::finish()
+{
+    if (m_pending == 0) {
+        return;
+    }
+    const int bytes = (m_pending + 7) / 8;
+    const quint64 aligned = m_buffer << (bytes * 8 - m_pending);
+    for (int i = bytes - 1; i >= 0; --i) {
+        m_out.append(static_cast<char>((aligned >> (i * 8)) & 0xFF));
+    }
+    m_buffer = 0;
+    m_pending = 0;
+}
+
+void BitWriter::flushWord()
+{
+    for (int i = 7; i >= 0; --i) {
+        m_out.append(static_cast<char>((m_buffer >> (i * 8)) & 0xFF));
+    }
+    m_buffer = 0;
+    m_pending = 0;
+}
+
+BitReader::BitReader(const uchar* data, qsizetype size)
+    : m_data(data)
+    , m_size(size)
+    , m_pos(0)
+    , m_buffer(0)
+    , m_available(0)
+    , m_overrun(false)
+{
+}
+
+quint64 BitReader::readBits(int count)
+{
+    quint64 result = 0;
+    while (count > 0) {
+        if (m_available == 0 && !refill()) {
+            m_overrun = true;
+            return 0;
+        }
+        const int take = std::min(count, m_available);
+        const quint64 chunk = (m_buffer >> (m_available - take)) & lowMask(take);
+        result = take == 64 ? chunk : (result << take) | chunk;
+        m_available -= take;
+        count -= take;
+    }
+    return result;
+}
+
+bool BitReader::refill()
+{
+    m_buffer = 0;
+    int bytes = 0;
+    while (bytes < 8 && m_pos < m_size) {
+        m_buffer = (m_buffer << 8) | m_data[m_pos++];
+        ++bytes;
+    }
+    m_available = bytes * 8;
+    return bytes > 0;
+}
+
+void TimestampEncoder::append(qint64 timestamp)
+{
+    if (m_first) {
+        m_writer.writeBits(static_cast<quint64>(timestamp), 64);
+        m_previous = timestamp;
+        m_first = false;
+        return;
+    }
+
+    const qint64 delta = timestamp - m_previous;
+    const qint64 deltaOfDelta = delta - m_previousDelta;
+    if (deltaOfDelta == 0) {
+        m_writer.writeBit(false);
+    } else if (fitsSigned(deltaOfDelta, 7)) {
+        m_writer.writeBits(0b10, 2);
+        m_writer.writeBits(static_cast<quint64>(deltaOfDelta), 7);
+    } else if (fitsSigned(deltaOfDelta, 9)) {
+        m_writer.writeBits(0b110, 3);
+        m_writer.writeBits(static_cast<quint64>(deltaOfDelta), 9);
+    } else if (fitsSigned(deltaOfDelta, 12)) {
+        m_writer.writeBits(0b1110, 4);
+        m_writer.writeBits(static_cast<quint64>(deltaOfDelta), 12);
+    } else {
+        m_writer.writeBits(0b1111, 4);
+        m_writer.writeBits(static_cast<quint64>(deltaOfDelta), 64);
+    }
+    m_previousDelta = delta;
+    m_previous = timestamp;
+}
+
+qint64 TimestampDecoder::next()
+{
+    if (m_first) {
+        m_previous = static_cast<qint64>(m_reader.readBits(64));
+        m_first = false;
+        return m_previous;
+    }
+
+    // 前缀中 1 的个数决定差值位宽
+    int ones = 0;
+    while (ones < 4 && m_reader.readBit()) {
+        ++ones;
+    }
+    qint64 deltaOfDelta = 0;
+    switch (ones) {
+        case 0: break;
+        case 1: deltaOfDelta = signExtend(m_reader.readBits(7), 7); break;
+        case 2: deltaOfDelta = signExtend(m_reader.readBits(9), 9); break;
+        case 3: deltaOfDelta = signExtend(m_reader.readBits(12), 12); break;
+        default: deltaOfDelta = static_cast<qint64>(m_reader.readBits(64)); break;
+    }
+    m_previousDelta += deltaOfDelta;
+    m_previous += m_previousDelta;
+    return m_previous;
+}
+
+void FloatEncoder::append(double value)
+{
+    const quint64 bits = doubleBits(value);
+    if (m_first) {
+        m_writer.writeBits(bits, 64);
+        m_previous = bits;
+        m_first = false;
+        return;
+    }
+
+    const quint64 xorValue = bits ^ m_previous;
+    m_previous = bits;
+    if (xorValue == 0) {
+        m_writer.writeBit(false);
+        return;
+    }
+
+    const int leading = std::min(31, static_cast<int>(qCountLeadingZeroBits(xorValue)));
+    const int trailing = static_cast<int>(qCountTrailingZeroBits(xorValue));
+    if (m_leading >= 0 && leading >= m_leading && trailing >= m_trailing) {
+        m_writer.writeBits(0b10, 2);
+        m_writer.writeBits(xorValue >> m_trailing, 64 - m_leading - m_trailing);
+        return;
+    }
+
+    const int significant = 64 - leading - trailing;
+    m_writer.writeBits(0b11, 2);
+    m_writer.writeBits(static_cast<quint64>(leading), 5);
+    m_writer.writeBits(static_cast<quint64>(significant & 0x3F), 6);
+    m_writer.writeBits(xorValue >> trailing, significant);
+    m_leading = leading;
+    m_trailing = trailing;
+}
+
+double FloatDecoder::next()
+{
+    if (m_first) {
+        m_previous = m_reader.readBits(64);
+        m_first = false;
+        return bitsToDouble(m_previous);
+    }
+
+    if (!m_reader.readBit()) {
+        return bitsToDouble(m_previous);
+    }
+
+    if (m_reader.readBit()) {
+        m_leading = static_cast<int>(m_reader.readBits(5));
+        int significant = static_cast<int>(m_reader.readBits(6));
+        if (significant == 0) {
+            significant = 64;
+        }
+        m_trailing = 64 - m_leading - significant;
+    }
+    const int significant = 64 - m_leading - m_trailing;
+    m_previous ^= m_reader.readBits(significant) << m_trailing;
+    return bitsToDouble(m_previous);
+}
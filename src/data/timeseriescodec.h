@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// 时间序列列压缩编码（Gorilla 风格）
+//
+// 时间戳列：第一个值写 64 位原值，之后写差值的差值（delta-of-delta）：
+//   0                   '0'
+//   [-64, 63]           '10'   + 7 位
+//   [-256, 255]         '110'  + 9 位
+//   [-2048, 2047]       '1110' + 12 位
+//   其他                '1111' + 64 位
+// 等间隔采样时每点只占 1 位，抖动 1ms 时占 9 位。
+//
+// 浮点列：第一个值写 64 位原值，之后写与前一个值的异或：
+//   异或为 0            '0'
+//   有效位落在上一窗口内 '10' + 窗口内的有效位
+//   否则                '11' + 前导零个数(5 位) + 有效位长度(6 位，64 记为 0) + 有效位
+// 缓慢变化的传感器值大多只需几位到十几位。
+//
+// 位流高位在前，按字节存放；编码结束后调用 finish() 补齐最后一个字节。
+
+class BitWriter
+{
+public:
+    explicit BitWriter(QByteArray& out);
+
+    void writeBit(bool bit) { writeBits(bit ? 1 : 0, 1); }
+    // 写 value 的低 count 位，count 为 1..64
+    void writeBits(quint64 value, int count);
+    void finish();
+
+private:
+    void flushWord();
+
+    QByteArray& m_out;
+    quint64 m_buffer;
+    int m_pending;          // m_buffer 中尚未写出的位数
+};
+
+// 位流读取，直接读取内存映射的数据，不拷贝
+class BitReader
+{
+public:
+    BitReader(const uchar* data, qsizetype size);
+
+    bool readBit() { return readBits(1) != 0; }
+    quint64 readBits(int count);
+    // 读取越过数据末尾时置位，之后读到的都是 0
+    bool overrun() const { return m_overrun; }
+
+private:
+    bool refill();
+
+    const uchar* m_data;
+    qsizetype m_size;
+    qsizetype m_pos;
+    quint64 m_buffer;
+    int m_available;
+    bool m_overrun;
+};
+
+class TimestampEncoder
+{
+public:
+    explicit TimestampEncoder(BitWriter& writer) : m_writer(writer) {}
+    void append(qint64 timestamp);
+
+private:
+    BitWriter& m_writer;
+    qint64 m_previous = 0;
+    qint64 m_previousDelta = 0;
+    bool m_first = true;
+};
+
+class TimestampDecoder
+{
+public:
+    explicit TimestampDecoder(BitReader& reader) : m_reader(reader) {}
+    qint64 next();
+
+private:
+    BitReader& m_reader;
+    qint64 m_previous = 0;
+    qint64 m_previousDelta = 0;
+    bool m_first = true;
+};
+
+class FloatEncoder
+{
+public:
+    explicit FloatEncoder(BitWriter& writer) : m_writer(writer) {}
+    void append(double value);
+
+private:
+    BitWriter& m_writer;
+    quint64 m_previous = 0;
+    int m_leading = -1;     // 上一窗口，-1 表示还没有窗口
+    int m_trailing = 0;
+    bool m_first = true;
+};
+
+class FloatDecoder
+{
+public:
+    explicit FloatDecoder(BitReader& reader) : m_reader(reader) {}
+    double next();
+
+private:
+    BitReader& m_reader;
+    quint64 m_previous = 0;
+    int m_leading = 0;
+    int m_trailing = 0;
+    bool m_first = true;
+};
@@ -0,0 +1,318 @@
+#include "timeseriesrollup.h"
+#include "../logger/logmanager.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <limits>
+
+namespace {
+// 各层级的桶宽、文件名后缀和每块行数（块按行数封存，未结束的块由打开时补齐）
+const qint64 TIER_RESOLUTION_MS[] = {1000, 60 * 1000, 3600 * 1000};
+const char* const TIER_SUFFIXES[] = {"1s", "1m", "1h"};
+const int TIER_CHUNK_ROWS[] = {3600, 1440, 168};
+
+inline qint64 bucketStart(qint64 timestamp, qint64 resolution)
+{
+    const qint64 index = timestamp >= 0 ? timestamp / resolution : (timestamp - resolution + 1) / resolution;
+    return index * resolution;
+}
+}
+
+TimeSeriesRollup::TimeSeriesRollup(TimeSeriesStore* raw, const QString& directory, const QString& baseName)
+    : m_raw(raw)
+    , m_columnCount(raw->columns().size())
+    , m_open(false)
+{
+    QStringList columns;
+    for (const QString& name : raw->columns()) {
+        columns << name + ".min" << name + ".max" << name + ".sum" << name + ".last";
+    }
+    columns << "count";
+
+    for (int level = 0; level < TIER_COUNT; ++level) {
+        m_tiers[level] = std::make_unique<TimeSeriesStore>(directory, baseName + "-" + TIER_SUFFIXES[level], columns);
+        m_tiers[level]->setChunkLimits(TIER_CHUNK_ROWS[level], std::numeric_limits<qint64>::max());
+
+        Bucket& bucket = m_buckets[level];
+        bucket.minimum.resize(m_columnCount);
+        bucket.maximum.resize(m_columnCount);
+        bucket.sum.resize(m_columnCount);
+        bucket.last.resize(m_columnCount);
+    }
+}
+
+TimeSeriesRollup::~TimeSeriesRollup()
+{
+    close();
+}
+
+bool TimeSeriesRollup::open()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open) {
+        return true;
+    }
+
+    for (auto& tier : m_tiers) {
+        if (!tier->open()) {
+            return false;
+        }
+    }
+
+    // 从最粗的层级开始补齐，细层级补齐时结束的桶继续并入已经补齐的上一级
+    QElapsedTimer timer;
+    timer.start();
+    for (int level = TIER_COUNT - 1; level >= 0; --level) {
+        catchUp(level);
+    }
+    m_open = true;
+
+    LOG_INFO("History", QString("历史汇总层级已打开，补齐耗时 %1 ms").arg(timer.elapsed()));
+    return true;
+}
+
+void TimeSeriesRollup::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return;
+    }
+
+    // 未结束的桶不写入，下次打开时重新补齐
+    for (auto& tier : m_tiers) {
+        tier->close();
+    }
+    for (Bucket& bucket : m_buckets) {
+        bucket.count = 0;
+    }
+    m_open = false;
+}
+
+void TimeSeriesRollup::append(qint64 timestampMs, const double* values)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open) {
+        addSample(timestampMs, values);
+    }
+}
+
+std::vector<TimeSeriesRollup::Point> TimeSeriesRollup::query(int column, qint64 startMs, qint64 endMs, int points,
+                                                             Tier* usedTier) const
+{
+    struct Accumulator {
+        qint64 count = 0;
+        double minimum = std::numeric_limits<double>::max();
+        double maximum = std::numeric_limits<double>::lowest();
+        double sum = 0;
+        double last = 0;
+        qint64 firstTimestamp = 0;
+        qint64 lastTimestamp = 0;
+    };
+
+    std::vector<Point> result;
+    if (usedTier) {
+        *usedTier = Raw;
+    }
+    if (column < 0 || column >= m_columnCount) {
+        return result;
+    }
+
+    // 范围收缩到已有数据，避免全范围查询时分段过宽
+    startMs = std::max(startMs, m_raw->firstTimestamp());
+    endMs = std::min(endMs, m_raw->lastTimestamp());
+    if (endMs < startMs) {
+        return result;
+    }
+
+    points = std::max(1, points);
+    const qint64 width = (endMs - startMs) / points + 1;
+    std::vector<Accumulator> buckets(points);
+
+    // timestamp 决定所在的段，center 是这部分数据的时间中点
+    const auto add = [&](qint64 timestamp, qint64 center, qint64 count,
+                         double minimum, double maximum, double sum, double last) {
+        const qint64 index = std::clamp<qint64>((timestamp - startMs) / width, 0, points - 1);
+        Accumulator& bucket = buckets[index];
+        if (bucket.count == 0) {
+            bucket.firstTimestamp = center;
+            bucket.lastTimestamp = center;
+            bucket.last = last;
+        } else {
+            bucket.firstTimestamp = std::min(bucket.firstTimestamp, center);
+            if (center >= bucket.lastTimestamp) {
+                bucket.lastTimestamp = center;
+                bucket.last = last;
+            }
+        }
+        bucket.count += count;
+        bucket.minimum = std::min(bucket.minimum, minimum);
+        bucket.maximum = std::max(bucket.maximum, maximum);
+        bucket.sum += sum;
+    };
+
+    QMutexLocker locker(&m_mutex);
+    const Tier tier = m_open ? chooseTier(width) : Raw;
+    if (tier == Raw) {
+        locker.unlock();
+        m_raw->visit(startMs, endMs, {column}, [&add](qint64 timestamp, const double* values) {
+            add(timestamp, timestamp, 1, values[0], values[0], values[0], values[0]);
+        });
+    } else {
+        // 已封存的行加上各级未结束的桶（越细越新）
+        const int level = tier - Second;
+        const qint64 halfResolution = TIER_RESOLUTION_MS[level] / 2;
+        const int base = column * 4;
+        m_tiers[level]->visit(startMs, endMs, {base, base + 1, base + 2, base + 3, m_columnCount * 4},
+                              [&add, halfResolution](qint64 timestamp, const double* row) {
+            add(timestamp, timestamp + halfResolution, static_cast<qint64>(row[4]), row[0], row[1], row[2], row[3]);
+        });
+        for (int pending = level; pending >= 0; --pending) {
+            const Bucket& bucket = m_buckets[pending];
+            if (bucket.count > 0 && bucket.start >= startMs && bucket.start <= endMs) {
+                add(bucket.start, bucket.start + TIER_RESOLUTION_MS[pending] / 2, bucket.count,
+                    bucket.minimum[column], bucket.maximum[column], bucket.sum[column], bucket.last[column]);
+            }
+        }
+    }
+
+    result.reserve(buckets.size());
+    for (const Accumulator& bucket : buckets) {
+        if (bucket.count == 0) continue;
+        Point point;
+        point.timestampMs = bucket.firstTimestamp + (bucket.lastTimestamp - bucket.firstTimestamp) / 2;
+        point.count = bucket.count;
+        point.minimum = bucket.minimum;
+        point.maximum = bucket.maximum;
+        point.mean = bucket.sum / bucket.count;
+        point.last = bucket.last;
+        result.push_back(point);
+    }
+    if (usedTier) {
+        *usedTier = tier;
+    }
+    return result;
+}
+
+qint64 TimeSeriesRollup::resolution(Tier tier)
+{
+    return tier == Raw ? 0 : TIER_RESOLUTION_MS[tier - Second];
+}
+
+TimeSeriesRollup::Tier TimeSeriesRollup::chooseTier(qint64 bucketWidthMs)
+{
+    for (int level = TIER_COUNT - 1; level >= 0; --level) {
+        if (TIER_RESOLUTION_MS[level] <= bucketWidthMs) {
+            return static_cast<Tier>(Second + level);
+        }
+    }
+    return Raw;
+}
+
+TimeSeriesStore* TimeSeriesRollup::tierStore(Tier tier) const
+{
+    return tier == Raw ? m_raw : m_tiers[tier - Second].get();
+}
+
+void TimeSeriesRollup::addSample(qint64 timestampMs, const double* values)
+{
+    Bucket& bucket = m_buckets[0];
+    const qint64 start = bucketStart(timestampMs, TIER_RESOLUTION_MS[0]);
+    if (bucket.count > 0 && start > bucket.start) {
+        closeBucket(0);
+    }
+    if (bucket.count == 0) {
+        beginBucket(0, start);
+    }
+
+    for (int column = 0; column < m_columnCount; ++column) {
+        const double value = values[column];
+        bucket.minimum[column] = std::min(bucket.minimum[column], value);
+        bucket.maximum[column] = std::max(bucket.maximum[column], value);
+        bucket.sum[column] += value;
+        bucket.last[column] = value;
+    }
+    ++bucket.count;
+}
+
+void TimeSeriesRollup::addRow(int level, qint64 timestampMs, const double* row)
+{
+    Bucket& bucket = m_buckets[level];
+    const qint64 start = bucketStart(timestampMs, TIER_RESOLUTION_MS[level]);
+    if (bucket.count > 0 && start > bucket.start) {
+        closeBucket(level);
+    }
+    if (bucket.count == 0) {
+        beginBucket(level, start);
+    }
+
+    for (int column = 0; column < m_columnCount; ++column) {
+        const double* values = row + column * 4;
+        bucket.minimum[column] = std::min(bucket.minimum[column], values[0]);
+        bucket.maximum[column] = std::max(bucket.maximum[column], values[1]);
+        bucket.sum[column] += values[2];
+        bucket.last[column] = values[3];
+    }
+    bucket.count += static_cast<qint64>(row[m_columnCount * 4]);
+}
+
+void TimeSeriesRollup::beginBucket(int level, qint64 start)
+{
+    Bucket& bucket = m_buckets[level];
+    bucket.start = start;
+    bucket.count = 0;
+    std::fill(bucket.minimum.begin(), bucket.minimum.end(), std::numeric_limits<double>::max());
+    std::fill(bucket.maximum.begin(), bucket.maximum.end(), std::numeric_limits<double>::lowest());
+    std::fill(bucket.sum.begin(), bucket.sum.end(), 0.0);
+    std::fill(bucket.last.begin(), bucket.last.end(), 0.0);
+}
+
+void TimeSeriesRollup::closeBucket(int level)
+{
+    Bucket& bucket = m_buckets[level];
+    std::vector<double> row(rowWidth());
+    for (int column = 0; column < m_columnCount; ++column) {
+        row[column * 4] = bucket.minimum[column];
+        row[column * 4 + 1] = bucket.maximum[column];
+        row[column * 4 + 2] = bucket.sum[column];
+        row[column * 4 + 3] = bucket.last[column];
+    }
+    row[m_columnCount * 4] = static_cast<double>(bucket.count);
+    const qint64 start = bucket.start;
+    bucket.count = 0;
+
+    m_tiers[level]->append(start, row.data());
+    if (level + 1 < TIER_COUNT) {
+        addRow(level + 1, start, row.data());
+    }
+}
+
+void TimeSeriesRollup::catchUp(int level)
+{
+    TimeSeriesStore* target = m_tiers[level].get();
+    const qint64 from = target->statistics().points > 0
+        ? target->lastTimestamp() + TIER_RESOLUTION_MS[level]
+        : std::numeric_limits<qint64>::min();
+    const qint64 to = std::numeric_limits<qint64>::max();
+
+    qint64 visited = 0;
+    if (level == 0) {
+        QList<int> columns;
+        for (int column = 0; column < m_columnCount; ++column) {
+            columns.append(column);
+        }
+        visited = m_raw->visit(from, to, columns, [this](qint64 timestamp, const double* values) {
+            addSample(timestamp, values);
+        });
+    } else {
+        QList<int> columns;
+        for (int column = 0; column < rowWidth(); ++column) {
+            columns.append(column);
+        }
+        visited = m_tiers[level - 1]->visit(from, to, columns, [this, level](qint64 timestamp, const double* row) {
+            addRow(level, timestamp, row);
+        });
+    }
+
+    if (visited > 0) {
+        LOG_DEBUG("History", QString("补齐 %1 汇总: 读取 %2 行").arg(TIER_SUFFIXES[level]).arg(visited));
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "timeseriesstore.h"
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <memory>
+#include <vector>
+
+// 时间序列的 1 秒 / 1 分钟 / 1 小时汇总层级
+//
+// 每个层级是一个独立的 TimeSeriesStore，一行对应一个时间桶（时间戳为桶起点），
+// 每个原始列占四列：最小值、最大值、和、最后值，末尾一列为点数；均值由和与点数求得。
+// 原始点追加到 1 秒层级的当前桶，桶结束时写入存储并作为一行并入上一级的当前桶，逐级向上。
+// 未结束的桶只在内存中，不写入文件；打开时从下一级（1 秒层级从原始数据）补齐
+// 各层级最后一行之后的数据，进程异常退出不会留下缺口。
+// 晚于当前桶起点之前到达的点（时钟回拨）并入当前桶。
+//
+// 查询按请求的点数把时间范围等分，自动选择桶宽不超过分段宽度的最粗层级，
+// 30 天的趋势图读取约 4 万行分钟汇总，而不是数亿个原始点。
+//
+// 线程安全
+class TimeSeriesRollup
+{
+public:
+    enum Tier {
+        Raw = 0,
+        Second,
+        Minute,
+        Hour
+    };
+
+    struct Point {
+        qint64 timestampMs = 0;     // 段内数据的时间中点
+        qint64 count = 0;
+        double minimum = 0;
+        double maximum = 0;
+        double mean = 0;
+        double last = 0;
+    };
+
+    // raw 必须已经打开且生命周期长于本对象
+    TimeSeriesRollup(TimeSeriesStore* raw, const QString& directory, const QString& baseName);
+    ~TimeSeriesRollup();
+
+    TimeSeriesRollup(const TimeSeriesRollup&) = delete;
+    TimeSeriesRollup& operator=(const TimeSeriesRollup&) = delete;
+
+    // 打开各层级存储并补齐缺失的汇总
+    bool open();
+    void close();
+
+    // 原始点写入 raw 之后调用，values 的长度等于 raw 的列数
+    void append(qint64 timestampMs, const double* values);
+
+    // 把 [startMs, endMs] 等分为 points 段，返回有数据的段。usedTier 返回实际使用的层级
+    std::vector<Point> query(int column, qint64 startMs, qint64 endMs, int points, Tier* usedTier = nullptr) const;
+
+    static qint64 resolution(Tier tier);
+    // 桶宽不超过 bucketWidthMs 的最粗层级
+    static Tier chooseTier(qint64 bucketWidthMs);
+    TimeSeriesStore* tierStore(Tier tier) const;
+
+private:
+    static constexpr int TIER_COUNT = 3;    // 不含原始数据
+
+    // 一个层级正在累积的桶
+    struct Bucket {
+        qint64 start = 0;
+        qint64 count = 0;
+        std::vector<double> minimum;
+        std::vector<double> maximum;
+        std::vector<double> sum;
+        std::vector<double> last;
+    };
+
+    // 行布局：第 c 列的最小值/最大值/和/最后值在 4c..4c+3，点数在 4n
+    int rowWidth() const { return m_columnCount * 4 + 1; }
+    void addSample(qint64 timestampMs, const double* values);
+    void addRow(int level, qint64 timestampMs, const double* row);
+    void beginBucket(int level, qint64 start);
+    void closeBucket(int level);
+    // 从 source（原始数据或下一级）补齐 level 层级最后一行之后的数据
+    void catchUp(int level);
+
+    TimeSeriesStore* m_raw;
+    int m_columnCount;
+    std::array<std::unique_ptr<TimeSeriesStore>, TIER_COUNT> m_tiers;
+
+    mutable QMutex m_mutex;
+    bool m_open;
+    std::array<Bucket, TIER_COUNT> m_buckets;
+};
@@ -0,0 +1,702 @@
+#include "timeseriesstore.h"
+#include "timeseriescodec.h"
+#include "../constants.h"
+#include "../logger/logmanager.h"
+#include "../utils/crcengine.h"
+#include <QDateTime>
+#include <QDir>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const char FILE_MAGIC[8] = {'G', 'T', 'S', 'D', 'B', '0', '0', '1'};
+constexpr int FILE_HEADER_SIZE = 16;
+constexpr quint32 CHUNK_MARKER = 0x4B4E4843;    // "CHNK"
+constexpr int CHUNK_FIXED_HEADER_SIZE = 4 * 4 + 8 * 2 + 4;
+constexpr int CHUNK_COLUMN_HEADER_SIZE = 8 * 4 + 4;
+
+template<typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    const T le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+void appendDouble(QByteArray& out, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLittleEndian(out, bits);
+}
+
+template<typename T>
+T readLittleEndian(const uchar*& pos)
+{
+    const T value = qFromLittleEndian<T>(pos);
+    pos += sizeof(T);
+    return value;
+}
+
+double readDouble(const uchar*& pos)
+{
+    const quint64 bits = readLittleEndian<quint64>(pos);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+quint32 payloadChecksum(const uchar* data, qsizetype size)
+{
+    return CRCEngine::updateCRC32C(0xFFFFFFFF, data, static_cast<size_t>(size)) ^ 0xFFFFFFFF;
+}
+
+void accumulate(TimeSeriesStore::Summary& summary, qint64 timestamp, double value)
+{
+    if (summary.count == 0) {
+        summary.firstTimestamp = timestamp;
+        summary.lastTimestamp = timestamp;
+    } else {
+        summary.firstTimestamp = std::min(summary.firstTimestamp, timestamp);
+        summary.lastTimestamp = std::max(summary.lastTimestamp, timestamp);
+    }
+    ++summary.count;
+    summary.minimum = std::min(summary.minimum, value);
+    summary.maximum = std::max(summary.maximum, value);
+    summary.sum += value;
+    summary.sumSquares += value * value;
+}
+}
+
+double TimeSeriesStore::Summary::variance() const
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    const double mean = average();
+    return std::max(0.0, sumSquares / count - mean * mean);
+}
+
+TimeSeriesStore::TimeSeriesStore(const QString& directory, const QString& baseName, const QStringList& columns)
+    : m_directory(directory)
+    , m_baseName(baseName)
+    , m_columns(columns)
+    , m_retentionDays(System::HISTORY_RETENTION_DAYS)
+    , m_chunkMaxPoints(System::HISTORY_CHUNK_MAX_POINTS)
+    , m_chunkMaxSpanMs(System::HISTORY_CHUNK_MAX_SPAN_MS)
+    , m_open(false)
+    , m_nextSequence(1)
+    , m_sealedPoints(0)
+    , m_activeValues(columns.size())
+{
+}
+
+TimeSeriesStore::~TimeSeriesStore()
+{
+    close();
+}
+
+void TimeSeriesStore::setChunkLimits(int maxPoints, qint64 maxSpanMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_chunkMaxPoints = std::max(1, maxPoints);
+    m_chunkMaxSpanMs = std::max<qint64>(1, maxSpanMs);
+}
+
+bool TimeSeriesStore::open()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open) {
+        return true;
+    }
+
+    QDir dir(m_directory);
+    if (!dir.mkpath(".")) {
+        LOG_ERROR("History", "无法创建历史数据目录: " + m_directory);
+        return false;
+    }
+
+    const QStringList files = dir.entryList({m_baseName + ".*.tsc"}, QDir::Files, QDir::Name);
+    for (const QString& fileName : files) {
+        const QString sequenceText = fileName.mid(m_baseName.size() + 1, fileName.size() - m_baseName.size() - 5);
+        bool ok = false;
+        const quint64 sequence = sequenceText.toULongLong(&ok);
+        if (ok) {
+            m_nextSequence = std::max(m_nextSequence, sequence + 1);
+            loadSegment(sequence, dir.filePath(fileName));
+        }
+    }
+
+    if (!m_segments.empty() && m_segments.back()->size < System::HISTORY_SEGMENT_MAX_BYTES) {
+        m_writeFile = std::make_unique<QFile>(m_segments.back()->path);
+        if (!m_writeFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+            LOG_ERROR("History", "无法打开历史段文件: " + m_writeFile->errorString());
+            m_writeFile.reset();
+            return false;
+        }
+    } else if (!startSegment()) {
+        return false;
+    }
+
+    removeSegmentsBefore(QDateTime::currentMSecsSinceEpoch() - qint64(m_retentionDays) * 24 * 3600 * 1000);
+    m_open = true;
+
+    LOG_INFO("History", QString("历史数据存储已打开: %1，%2 个段，%3 个块，%4 个点")
+             .arg(m_directory).arg(m_segments.size()).arg(m_chunks.size()).arg(m_sealedPoints));
+    return true;
+}
+
+void TimeSeriesStore::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return;
+    }
+
+    sealActiveChunk();
+    m_writeFile.reset();
+    for (auto& segment : m_segments) {
+        unmapSegment(*segment);
+    }
+    m_segments.clear();
+    m_chunks.clear();
+    m_columnIndexes.clear();
+    m_sealedPoints = 0;
+    m_open = false;
+}
+
+bool TimeSeriesStore::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_open;
+}
+
+QStringList TimeSeriesStore::columns() const
+{
+    return m_columns;
+}
+
+int TimeSeriesStore::columnIndex(const QString& name) const
+{
+    return m_columns.indexOf(name);
+}
+
+bool TimeSeriesStore::append(qint64 timestampMs, const double* values)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return false;
+    }
+
+    m_activeTimestamps.push_back(timestampMs);
+    for (size_t column = 0; column < m_activeValues.size(); ++column) {
+        m_activeValues[column].push_back(values[column]);
+    }
+
+    if (m_activeTimestamps.size() >= static_cast<size_t>(m_chunkMaxPoints)
+        || timestampMs - m_activeTimestamps.front() >= m_chunkMaxSpanMs) {
+        return sealActiveChunk();
+    }
+    return true;
+}
+
+bool TimeSeriesStore::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_open && sealActiveChunk();
+}
+
+qint64 TimeSeriesStore::visit(qint64 startMs, qint64 endMs, const QList<int>& columns, const Visitor& visitor) const
+{
+    QMutexLocker locker(&m_mutex);
+    for (int column : columns) {
+        if (column < 0 || column >= m_columns.size()) {
+            return 0;
+        }
+    }
+
+    qint64 visited = 0;
+    std::vector<qint64> timestamps;
+    std::vector<double> values;
+    std::vector<double> row(columns.size());
+
+    for (const Chunk& chunk : m_chunks) {
+        if (chunk.maxTimestamp < startMs || chunk.minTimestamp > endMs) {
+            continue;
+        }
+        if (!decodeChunk(chunk, columns, timestamps, values)) {
+            continue;
+        }
+        const size_t count = chunk.pointCount;
+        for (size_t i = 0; i < count; ++i) {
+            if (timestamps[i] < startMs || timestamps[i] > endMs) {
+                continue;
+            }
+            for (int k = 0; k < columns.size(); ++k) {
+                row[k] = values[k * count + i];
+            }
+            visitor(timestamps[i], row.data());
+            ++visited;
+        }
+    }
+
+    for (size_t i = 0; i < m_activeTimestamps.size(); ++i) {
+        if (m_activeTimestamps[i] < startMs || m_activeTimestamps[i] > endMs) {
+            continue;
+        }
+        for (int k = 0; k < columns.size(); ++k) {
+            row[k] = m_activeValues[columns.at(k)][i];
+        }
+        visitor(m_activeTimestamps[i], row.data());
+        ++visited;
+    }
+    return visited;
+}
+
+TimeSeriesStore::Summary TimeSeriesStore::summarize(int column, qint64 startMs, qint64 endMs) const
+{
+    return summarizeBuckets(column, startMs, endMs, 1).front();
+}
+
+std::vector<TimeSeriesStore::Summary> TimeSeriesStore::summarizeBuckets(int column, qint64 startMs, qint64 endMs,
+                                                                        int buckets) const
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<Summary> result(std::max(1, buckets));
+    if (column < 0 || column >= m_columns.size() || endMs < startMs) {
+        return result;
+    }
+
+    // 无符号运算避免全范围查询溢出；只有一段时宽度为 0，所有点都落在第 0 段
+    const quint64 span = static_cast<quint64>(endMs) - static_cast<quint64>(startMs);
+    const quint64 width = result.size() == 1 ? 0 : span / result.size() + 1;
+    const auto bucketOf = [startMs, width](qint64 timestamp) -> size_t {
+        return width == 0 ? 0 : static_cast<size_t>((static_cast<quint64>(timestamp) - static_cast<quint64>(startMs)) / width);
+    };
+
+    std::vector<qint64> timestamps;
+    std::vector<double> values;
+    for (const Chunk& chunk : m_chunks) {
+        if (chunk.maxTimestamp < startMs || chunk.minTimestamp > endMs) {
+            continue;
+        }
+
+        if (chunk.minTimestamp >= startMs && chunk.maxTimestamp <= endMs
+            && bucketOf(chunk.minTimestamp) == bucketOf(chunk.maxTimestamp)) {
+            // 整块落在一段内，直接合并块头的汇总
+            Summary& summary = result[bucketOf(chunk.minTimestamp)];
+            const ColumnIndex& index = m_columnIndexes[chunk.columnIndexStart + column];
+            if (summary.count == 0) {
+                summary.firstTimestamp = chunk.minTimestamp;
+                summary.lastTimestamp = chunk.maxTimestamp;
+            } else {
+                summary.firstTimestamp = std::min(summary.firstTimestamp, chunk.minTimestamp);
+                summary.lastTimestamp = std::max(summary.lastTimestamp, chunk.maxTimestamp);
+            }
+            summary.count += chunk.pointCount;
+            summary.minimum = std::min(summary.minimum, index.minimum);
+            summary.maximum = std::max(summary.maximum, index.maximum);
+            summary.sum += index.sum;
+            summary.sumSquares += index.sumSquares;
+            continue;
+        }
+
+        if (!decodeChunk(chunk, {column}, timestamps, values)) {
+            continue;
+        }
+        for (size_t i = 0; i < chunk.pointCount; ++i) {
+            if (timestamps[i] >= startMs && timestamps[i] <= endMs) {
+                accumulate(result[bucketOf(timestamps[i])], timestamps[i], values[i]);
+            }
+        }
+    }
+
+    const std::vector<double>& activeValues = m_activeValues[column];
+    for (size_t i = 0; i < m_activeTimestamps.size(); ++i) {
+        if (m_activeTimestamps[i] >= startMs && m_activeTimestamps[i] <= endMs) {
+            accumulate(result[bucketOf(m_activeTimestamps[i])], m_activeTimestamps[i], activeValues[i]);
+        }
+    }
+    return result;
+}
+
+void TimeSeriesStore::removeBefore(qint64 cutoffMs)
+{
+    QMutexLocker locker(&m_mutex);
+    removeSegmentsBefore(cutoffMs);
+}
+
+void TimeSeriesStore::setRetentionDays(int days)
+{
+    QMutexLocker locker(&m_mutex);
+    m_retentionDays = std::max(1, days);
+}
+
+qint64 TimeSeriesStore::firstTimestamp() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_chunks.empty()) {
+        return m_chunks.front().minTimestamp;
+    }
+    return m_activeTimestamps.empty() ? 0 : m_activeTimestamps.front();
+}
+
+qint64 TimeSeriesStore::lastTimestamp() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_activeTimestamps.empty()) {
+        return m_activeTimestamps.back();
+    }
+    return m_chunks.empty() ? 0 : m_chunks.back().maxTimestamp;
+}
+
+TimeSeriesStore::Statistics TimeSeriesStore::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    Statistics stats;
+    stats.points = m_sealedPoints + static_cast<qint64>(m_activeTimestamps.size());
+    stats.chunks = static_cast<qint64>(m_chunks.size());
+    stats.segments = static_cast<int>(m_segments.size());
+    for (const auto& segment : m_segments) {
+        stats.diskBytes += segment->size;
+    }
+    stats.rawBytes = m_sealedPoints * 8 * (m_columns.size() + 1);
+    return stats;
+}
+
+int TimeSeriesStore::headerSize() const
+{
+    return CHUNK_FIXED_HEADER_SIZE + CHUNK_COLUMN_HEADER_SIZE * m_columns.size();
+}
+
+bool TimeSeriesStore::loadSegment(quint64 sequence, const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        LOG_WARNING("History", "无法打开历史段文件: " + path);
+        return false;
+    }
+
+    const qint64 fileSize = file.size();
+    uchar* data = fileSize >= FILE_HEADER_SIZE ? file.map(0, fileSize) : nullptr;
+    if (!data || std::memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+        || qFromLittleEndian<quint32>(data + 8) != static_cast<quint32>(m_columns.size())) {
+        if (data) {
+            file.unmap(data);
+        }
+        LOG_WARNING("History", "忽略格式不符的历史段文件: " + path);
+        return false;
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->sequence = sequence;
+    segment->path = path;
+    const int segmentIndex = static_cast<int>(m_segments.size());
+    const int columnCount = m_columns.size();
+    const int chunkHeaderSize = headerSize();
+
+    qint64 offset = FILE_HEADER_SIZE;
+    while (offset + chunkHeaderSize <= fileSize) {
+        const uchar* pos = data + offset;
+        if (readLittleEndian<quint32>(pos) != CHUNK_MARKER) {
+            break;
+        }
+        const quint32 payloadSize = readLittleEndian<quint32>(pos);
+        const quint32 checksum = readLittleEndian<quint32>(pos);
+        const qint64 payloadOffset = offset + chunkHeaderSize;
+        if (payloadOffset + payloadSize > fileSize
+            || payloadChecksum(data + payloadOffset, payloadSize) != checksum) {
+            break;
+        }
+
+        Chunk chunk;
+        chunk.segment = segmentIndex;
+        chunk.payloadOffset = payloadOffset;
+        chunk.pointCount = readLittleEndian<quint32>(pos);
+        chunk.minTimestamp = readLittleEndian<qint64>(pos);
+        chunk.maxTimestamp = readLittleEndian<qint64>(pos);
+        chunk.timestampSize = readLittleEndian<quint32>(pos);
+        chunk.columnIndexStart = static_cast<qint64>(m_columnIndexes.size());
+
+        quint32 columnOffset = chunk.timestampSize;
+        for (int column = 0; column < columnCount; ++column) {
+            ColumnIndex index;
+            index.minimum = readDouble(pos);
+            index.maximum = readDouble(pos);
+            index.sum = readDouble(pos);
+            index.sumSquares = readDouble(pos);
+            index.size = readLittleEndian<quint32>(pos);
+            index.offset = columnOffset;
+            columnOffset += index.size;
+            m_columnIndexes.push_back(index);
+        }
+        if (columnOffset != payloadSize) {
+            m_columnIndexes.resize(chunk.columnIndexStart);
+            break;
+        }
+
+        m_chunks.push_back(chunk);
+        m_sealedPoints += chunk.pointCount;
+        segment->lastTimestamp = std::max(segment->lastTimestamp, chunk.maxTimestamp);
+        offset = payloadOffset + payloadSize;
+    }
+    file.unmap(data);
+
+    if (offset < fileSize) {
+        // 进程异常退出时最后一块可能只写了一部分
+        LOG_WARNING("History", QString("历史段文件 %1 在偏移 %2 处截断，丢弃 %3 字节")
+                    .arg(path).arg(offset).arg(fileSize - offset));
+        file.resize(offset);
+    }
+    segment->size = offset;
+    m_segments.push_back(std::move(segment));
+    return true;
+}
+
+bool TimeSeriesStore::startSegment()
+{
+    const quint64 sequence = m_nextSequence;
+    const QString path = segmentPath(sequence);
+
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR("History", "无法创建历史段文件: " + file->errorString());
+        return false;
+    }
+
+    QByteArray header(FILE_MAGIC, sizeof(FILE_MAGIC));
+    appendLittleEndian<quint32>(header, static_cast<quint32>(m_columns.size()));
+    appendLittleEndian<quint32>(header, 0);
+    if (file->write(header) != header.size() || !file->flush()) {
+        LOG_ERROR("History", "写入历史段文件头失败: " + file->errorString());
+        return false;
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->sequence = sequence;
+    segment->path = path;
+    segment->size = FILE_HEADER_SIZE;
+    ++m_nextSequence;
+    m_segments.push_back(std::move(segment));
+    m_writeFile = std::move(file);
+    return true;
+}
+
+bool TimeSeriesStore::sealActiveChunk()
+{
+    const size_t count = m_activeTimestamps.size();
+    if (count == 0) {
+        return true;
+    }
+    if (!m_writeFile) {
+        return false;
+    }
+
+    QByteArray payload;
+    payload.reserve(static_cast<qsizetype>(count) * (m_columns.size() + 1) * 2);
+    {
+        BitWriter writer(payload);
+        TimestampEncoder encoder(writer);
+        for (qint64 timestamp : m_activeTimestamps) {
+            encoder.append(timestamp);
+        }
+        writer.finish();
+    }
+    const quint32 timestampSize = static_cast<quint32>(payload.size());
+
+    std::vector<ColumnIndex> indexes(m_columns.size());
+    for (size_t column = 0; column < m_activeValues.size(); ++column) {
+        ColumnIndex& index = indexes[column];
+        index.minimum = std::numeric_limits<double>::max();
+        index.maximum = std::numeric_limits<double>::lowest();
+        index.sum = 0;
+        index.sumSquares = 0;
+        index.offset = static_cast<quint32>(payload.size());
+
+        BitWriter writer(payload);
+        FloatEncoder encoder(writer);
+        for (double value : m_activeValues[column]) {
+            encoder.append(value);
+            index.minimum = std::min(index.minimum, value);
+            index.maximum = std::max(index.maximum, value);
+            index.sum += value;
+            index.sumSquares += value * value;
+        }
+        writer.finish();
+        index.size = static_cast<quint32>(payload.size()) - index.offset;
+    }
+
+    const auto [minTimestamp, maxTimestamp] = std::minmax_element(m_activeTimestamps.begin(), m_activeTimestamps.end());
+    QByteArray record;
+    record.reserve(headerSize() + payload.size());
+    appendLittleEndian<quint32>(record, CHUNK_MARKER);
+    appendLittleEndian<quint32>(record, static_cast<quint32>(payload.size()));
+    appendLittleEndian<quint32>(record, payloadChecksum(reinterpret_cast<const uchar*>(payload.constData()), payload.size()));
+    appendLittleEndian<quint32>(record, static_cast<quint32>(count));
+    appendLittleEndian<qint64>(record, *minTimestamp);
+    appendLittleEndian<qint64>(record, *maxTimestamp);
+    appendLittleEndian<quint32>(record, timestampSize);
+    for (const ColumnIndex& index : indexes) {
+        appendDouble(record, index.minimum);
+        appendDouble(record, index.maximum);
+        appendDouble(record, index.sum);
+        appendDouble(record, index.sumSquares);
+        appendLittleEndian<quint32>(record, index.size);
+    }
+    record.append(payload);
+
+    Chunk chunk;
+    chunk.pointCount = static_cast<quint32>(count);
+    chunk.minTimestamp = *minTimestamp;
+    chunk.maxTimestamp = *maxTimestamp;
+    chunk.timestampSize = timestampSize;
+
+    m_activeTimestamps.clear();
+    for (auto& values : m_activeValues) {
+        values.clear();
+    }
+
+    if (m_segments.back()->size > FILE_HEADER_SIZE
+        && m_segments.back()->size + record.size() > System::HISTORY_SEGMENT_MAX_BYTES) {
+        m_writeFile.reset();
+        if (!startSegment()) {
+            LOG_ERROR("History", QString("无法切换历史段文件，丢弃 %1 个点").arg(count));
+            return false;
+        }
+    }
+
+    Segment& segment = *m_segments.back();
+    if (m_writeFile->write(record) != record.size() || !m_writeFile->flush()) {
+        LOG_ERROR("History", QString("写入历史数据块失败，丢弃 %1 个点: %2").arg(count).arg(m_writeFile->errorString()));
+        m_writeFile->resize(segment.size);
+        return false;
+    }
+
+    chunk.segment = static_cast<int>(m_segments.size()) - 1;
+    chunk.payloadOffset = segment.size + headerSize();
+    chunk.columnIndexStart = static_cast<qint64>(m_columnIndexes.size());
+    m_columnIndexes.insert(m_columnIndexes.end(), indexes.begin(), indexes.end());
+    m_chunks.push_back(chunk);
+    m_sealedPoints += chunk.pointCount;
+    segment.size += record.size();
+    segment.lastTimestamp = std::max(segment.lastTimestamp, chunk.maxTimestamp);
+
+    removeSegmentsBefore(QDateTime::currentMSecsSinceEpoch() - qint64(m_retentionDays) * 24 * 3600 * 1000);
+    return true;
+}
+
+const uchar* TimeSeriesStore::mapSegment(int segmentIndex) const
+{
+    Segment& segment = *m_segments[segmentIndex];
+    if (segment.mapped && segment.mappedSize >= segment.size) {
+        return segment.mapped;
+    }
+
+    // 当前写入段增长后重新映射
+    unmapSegment(segment);
+    if (!segment.readFile) {
+        segment.readFile = std::make_unique<QFile>(segment.path);
+        if (!segment.readFile->open(QIODevice::ReadOnly)) {
+            LOG_WARNING("History", "无法读取历史段文件: " + segment.path);
+            segment.readFile.reset();
+            return nullptr;
+        }
+    }
+    segment.mapped = segment.readFile->map(0, segment.size);
+    if (!segment.mapped) {
+        LOG_WARNING("History", "无法映射历史段文件: " + segment.path);
+        return nullptr;
+    }
+    segment.mappedSize = segment.size;
+    return segment.mapped;
+}
+
+void TimeSeriesStore::unmapSegment(Segment& segment) const
+{
+    if (segment.mapped) {
+        segment.readFile->unmap(segment.mapped);
+        segment.mapped = nullptr;
+        segment.mappedSize = 0;
+    }
+}
+
+bool TimeSeriesStore::decodeChunk(const Chunk& chunk, const QList<int>& columns,
+                                  std::vector<qint64>& timestamps, std::vector<double>& values) const
+{
+    const uchar* base = mapSegment(chunk.segment);
+    if (!base) {
+        return false;
+    }
+    const uchar* payload = base + chunk.payloadOffset;
+    const size_t count = chunk.pointCount;
+
+    timestamps.resize(count);
+    BitReader timestampReader(payload, chunk.timestampSize);
+    TimestampDecoder timestampDecoder(timestampReader);
+    for (size_t i = 0; i < count; ++i) {
+        timestamps[i] = timestampDecoder.next();
+    }
+    bool valid = !timestampReader.overrun();
+
+    values.resize(count * columns.size());
+    for (int k = 0; k < columns.size(); ++k) {
+        const ColumnIndex& index = m_columnIndexes[chunk.columnIndexStart + columns.at(k)];
+        BitReader reader(payload + index.offset, index.size);
+        FloatDecoder decoder(reader);
+        double* out = values.data() + k * count;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = decoder.next();
+        }
+        valid = valid && !reader.overrun();
+    }
+
+    if (!valid) {
+        LOG_WARNING("History", QString("历史数据块解码失败: %1 偏移 %2")
+                    .arg(m_segments[chunk.segment]->path).arg(chunk.payloadOffset));
+    }
+    return valid;
+}
+
+void TimeSeriesStore::removeSegmentsBefore(qint64 cutoffMs)
+{
+    // 当前写入段始终保留
+    size_t removed = 0;
+    while (removed + 1 < m_segments.size() && m_segments[removed]->lastTimestamp < cutoffMs) {
+        ++removed;
+    }
+    if (removed == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < removed; ++i) {
+        Segment& segment = *m_segments[i];
+        unmapSegment(segment);
+        segment.readFile.reset();
+        QFile::remove(segment.path);
+    }
+    m_segments.erase(m_segments.begin(), m_segments.begin() + removed);
+
+    const auto firstKept = std::find_if(m_chunks.begin(), m_chunks.end(), [removed](const Chunk& chunk) {
+        return chunk.segment >= static_cast<int>(removed);
+    });
+    for (auto it = m_chunks.begin(); it != firstKept; ++it) {
+        m_sealedPoints -= it->pointCount;
+    }
+    const qint64 indexesRemoved = firstKept == m_chunks.end()
+        ? static_cast<qint64>(m_columnIndexes.size()) : firstKept->columnIndexStart;
+    const size_t chunksRemoved = static_cast<size_t>(firstKept - m_chunks.begin());
+    m_chunks.erase(m_chunks.begin(), firstKept);
+    m_columnIndexes.erase(m_columnIndexes.begin(), m_columnIndexes.begin() + indexesRemoved);
+    for (Chunk& chunk : m_chunks) {
+        chunk.segment -= static_cast<int>(removed);
+        chunk.columnIndexStart -= indexesRemoved;
+    }
+
+    LOG_INFO("History", QString("删除超过保留期的历史段 %1 个（%2 个块）").arg(removed).arg(chunksRemoved));
+}
+
+QString TimeSeriesStore::segmentPath(quint64 sequence) const
+{
+    return QDir(m_directory).filePath(QString("%1.%2.tsc").arg(m_baseName).arg(sequence, 6, 10, QChar('0')));
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// 追加写入、按块压缩的列式时间序列存储
+//
+// 每个采样点是一个毫秒时间戳加固定数量的浮点列。新点先放在内存中的活动块里，
+// 活动块达到点数上限或时间跨度上限时按列压缩（时间戳 delta-of-delta，数值 XOR，见 timeseriescodec.h）
+// 并追加到当前段文件；段文件达到大小上限后开始新段，超过保留期的整段删除。
+//
+// 段文件 <base>.<6位序号>.tsc：16 字节文件头（魔数 "GTSDB001"、列数 u32、保留 u32），其后为连续的块：
+//   标记 "CHNK"(u32) 负载长度(u32) 负载 CRC32C(u32) 点数(u32) 最小/最大时间戳(i64)
+//   时间戳列长度(u32) 每列 { 最小值 最大值 和 平方和(f64) 长度(u32) } 负载（时间戳列，之后各列）
+// 多字节字段均为小端。打开时只扫描块头建立索引，最后一个不完整或校验失败的块被截掉。
+//
+// 读取通过内存映射的段文件进行，只解压与时间范围重叠、且被请求的列；
+// 完全落在范围内的块直接使用块头中的最小值/最大值/和，不解压。
+//
+// 线程安全；访问回调在内部锁内执行，回调中不能再调用本存储
+class TimeSeriesStore
+{
+public:
+    // 一段时间内某一列的汇总
+    struct Summary {
+        qint64 count = 0;
+        double minimum = std::numeric_limits<double>::max();
+        double maximum = std::numeric_limits<double>::lowest();
+        double sum = 0;
+        double sumSquares = 0;
+        qint64 firstTimestamp = 0;
+        qint64 lastTimestamp = 0;
+
+        double average() const { return count > 0 ? sum / count : 0.0; }
+        double variance() const;
+    };
+
+    struct Statistics {
+        qint64 points = 0;
+        qint64 chunks = 0;
+        int segments = 0;
+        qint64 diskBytes = 0;
+        qint64 rawBytes = 0;        // 未压缩时需要的字节数（时间戳和各列各 8 字节）
+    };
+
+    // values 按请求的列顺序排列
+    using Visitor = std::function<void(qint64 timestampMs, const double* values)>;
+
+    TimeSeriesStore(const QString& directory, const QString& baseName, const QStringList& columns);
+    ~TimeSeriesStore();
+
+    TimeSeriesStore(const TimeSeriesStore&) = delete;
+    TimeSeriesStore& operator=(const TimeSeriesStore&) = delete;
+
+    // 活动块封存条件，默认为 System::HISTORY_CHUNK_MAX_POINTS/HISTORY_CHUNK_MAX_SPAN_MS
+    void setChunkLimits(int maxPoints, qint64 maxSpanMs);
+
+    bool open();
+    // 封存活动块并关闭所有文件
+    void close();
+    bool isOpen() const;
+
+    QStringList columns() const;
+    int columnIndex(const QString& name) const;
+
+    // values 的长度必须等于列数
+    bool append(qint64 timestampMs, const double* values);
+    // 立即封存活动块
+    bool flush();
+
+    // 按时间顺序访问 [startMs, endMs] 内的点（含活动块），只解压 columns 指定的列。返回访问的点数
+    qint64 visit(qint64 startMs, qint64 endMs, const QList<int>& columns, const Visitor& visitor) const;
+    Summary summarize(int column, qint64 startMs, qint64 endMs) const;
+    // 把 [startMs, endMs] 等分为 buckets 段分别汇总（图表降采样）。
+    // 整块落在一段内时只读块头，时间跨度远大于块跨度的查询几乎不解压数据
+    std::vector<Summary> summarizeBuckets(int column, qint64 startMs, qint64 endMs, int buckets) const;
+
+    // 删除最后一个点早于 cutoffMs 的整段；当前写入段不删除
+    void removeBefore(qint64 cutoffMs);
+    void setRetentionDays(int days);
+
+    qint64 firstTimestamp() const;
+    qint64 lastTimestamp() const;
+    Statistics statistics() const;
+
+private:
+    struct ColumnIndex {
+        double minimum;
+        double maximum;
+        double sum;
+        double sumSquares;
+        quint32 offset;         // 相对负载起点
+        quint32 size;
+    };
+
+    struct Chunk {
+        int segment;            // m_segments 中的下标
+        qint64 payloadOffset;   // 负载在段文件中的偏移
+        quint32 pointCount;
+        qint64 minTimestamp;
+        qint64 maxTimestamp;
+        quint32 timestampSize;
+        qint64 columnIndexStart; // m_columnIndexes 中的起始下标
+    };
+
+    struct Segment {
+        quint64 sequence = 0;
+        QString path;
+        qint64 size = 0;            // 有效数据长度
+        qint64 lastTimestamp = std::numeric_limits<qint64>::min();
+        std::unique_ptr<QFile> readFile;
+        uchar* mapped = nullptr;
+        qint64 mappedSize = 0;
+    };
+
+    int headerSize() const;
+    bool loadSegment(quint64 sequence, const QString& path);
+    bool startSegment();
+    bool sealActiveChunk();
+    const uchar* mapSegment(int segment) const;
+    void unmapSegment(Segment& segment) const;
+    // 解压块中的时间戳和指定列到 timestamps/values（按列存放，每列 pointCount 个）
+    bool decodeChunk(const Chunk& chunk, const QList<int>& columns,
+                     std::vector<qint64>& timestamps, std::vector<double>& values) const;
+    void removeSegmentsBefore(qint64 cutoffMs);
+    QString segmentPath(quint64 sequence) const;
+
+    QString m_directory;
+    QString m_baseName;
+    QStringList m_columns;
+    int m_retentionDays;
+    int m_chunkMaxPoints;
+    qint64 m_chunkMaxSpanMs;
+
+    mutable QMutex m_mutex;
+    bool m_open;
+    quint64 m_nextSequence;
+    // 段的映射在读取时按需建立或扩大
+    mutable std::vector<std::unique_ptr<Segment>> m_segments;
+    std::vector<Chunk> m_chunks;
+    std::vector<ColumnIndex> m_columnIndexes;   // 每块 m_columns.size() 项
+    std::unique_ptr<QFile> m_writeFile;         // 写入当前（最后一个）段
+    qint64 m_sealedPoints;
+
+    // 活动块，按列存放
+    std::vector<qint64> m_activeTimestamps;
+    std::vector<std::vector<double>> m_activeValues;
+};
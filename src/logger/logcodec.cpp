@@ -0,0 +1,342 @@
+#include "logcodec.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+constexpr char FILE_MAGIC[] = "GLOGBIN1";
+constexpr int FILE_MAGIC_SIZE = 8;
+
+constexpr quint8 TAG_SESSION = 0x01;
+constexpr quint8 TAG_STRING = 0x02;
+constexpr quint8 TAG_ENTRY = 0x03;
+
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void appendUtf8(QByteArray& out, const QByteArray& utf8)
+{
+    appendLittleEndian<quint32>(out, static_cast<quint32>(utf8.size()));
+    out.append(utf8);
+}
+}
+
+namespace LogFormatting {
+
+QString levelToString(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Debug:    return "DEBUG";
+        case LogLevel::Info:     return "INFO";
+        case LogLevel::Warning:  return "WARN";
+        case LogLevel::Error:    return "ERROR";
+        case LogLevel::Critical: return "CRITICAL";
+        default:                 return "UNKNOWN";
+    }
+}
+
+QString formatMessage(const QString& format, const QString& message,
+                      const std::vector<LogArgument>& arguments, const QByteArray& payload)
+{
+    QString text = message;
+    if (!format.isEmpty()) {
+        text = format;
+        for (const LogArgument& argument : arguments) {
+            text = text.arg(argument.toString());
+        }
+    }
+    if (!payload.isEmpty()) {
+        text += ' ';
+        text += QString::fromLatin1(payload.toHex(' ').toUpper());
+    }
+    return text;
+}
+
+QString formatMessage(const LogRecord& record)
+{
+    return formatMessage(record.format ? QString::fromUtf8(record.format) : QString(),
+                         record.message, record.arguments, record.payload);
+}
+
+QString formatEntry(const LogEntry& entry)
+{
+    QString levelStr = levelToString(entry.level);
+    QString timestamp = entry.timestamp.toString("yyyy-MM-dd hh:mm:ss.zzz");
+
+    QString formatted = QString("[%1] [%2] [%3] %4")
+                        .arg(timestamp, levelStr, entry.category, entry.message);
+
+    if (!entry.file.isEmpty() && entry.line > 0) {
+        QString fileName = QFileInfo(entry.file).baseName();
+        formatted += QString(" (%1:%2)").arg(fileName).arg(entry.line);
+    }
+
+    return formatted;
+}
+
+}
+
+QByteArray BinaryLogWriter::fileMagic()
+{
+    return QByteArray(FILE_MAGIC, FILE_MAGIC_SIZE);
+}
+
+void BinaryLogWriter::beginSession(QByteArray& out, qint64 wallAnchorNs, qint64 steadyAnchorNs)
+{
+    m_strings.clear();
+    m_literals.clear();
+    m_nextId = 1;
+
+    out.append(static_cast<char>(TAG_SESSION));
+    appendLittleEndian<qint64>(out, wallAnchorNs);
+    appendLittleEndian<qint64>(out, steadyAnchorNs);
+}
+
+void BinaryLogWriter::encode(const LogRecord& record, QByteArray& out)
+{
+    // 字符串定义必须写在引用它的条目之前
+    const quint32 categoryId = internString(record.category, out);
+    const quint32 formatId = internLiteral(record.format, out);
+    const quint32 fileId = internString(record.file, out);
+    const quint32 functionId = record.function.isEmpty() && record.sourceFunction
+        ? internLiteral(record.sourceFunction, out)
+        : internString(record.function, out);
+
+    out.append(static_cast<char>(TAG_ENTRY));
+    out.append(static_cast<char>(record.level));
+    appendLittleEndian<qint64>(out, record.timestampNs);
+    appendLittleEndian<quint32>(out, categoryId);
+    appendLittleEndian<quint32>(out, formatId);
+    appendLittleEndian<quint32>(out, fileId);
+    appendLittleEndian<qint32>(out, record.line);
+    appendLittleEndian<quint32>(out, functionId);
+
+    if (formatId == 0) {
+        out.append(static_cast<char>(1));
+        out.append(static_cast<char>(LogArgument::Type::String));
+        appendUtf8(out, record.message.toUtf8());
+    } else {
+        const size_t count = qMin<size_t>(record.arguments.size(), 255);
+        out.append(static_cast<char>(count));
+        for (size_t i = 0; i < count; ++i) {
+            const LogArgument& argument = record.arguments[i];
+            out.append(static_cast<char>(argument.type));
+            switch (argument.type) {
+            case LogArgument::Type::Int:
+                appendLittleEndian<qint64>(out, argument.intValue);
+                break;
+            case LogArgument::Type::Double: {
+                quint64 bits;
+                std::memcpy(&bits, &argument.doubleValue, sizeof(bits));
+                appendLittleEndian<quint64>(out, bits);
+                break;
+            }
+            default:
+                appendUtf8(out, argument.stringValue.toUtf8());
+                break;
+            }
+        }
+    }
+
+    appendLittleEndian<quint32>(out, static_cast<quint32>(record.payload.size()));
+    out.append(record.payload);
+}
+
+quint32 BinaryLogWriter::internString(const QString& text, QByteArray& out)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+    auto it = m_strings.constFind(text);
+    if (it != m_strings.constEnd()) {
+        return it.value();
+    }
+    const quint32 id = defineString(text.toUtf8(), out);
+    m_strings.insert(text, id);
+    return id;
+}
+
+quint32 BinaryLogWriter::internLiteral(const char* literal, QByteArray& out)
+{
+    if (!literal) {
+        return 0;
+    }
+    auto it = m_literals.constFind(literal);
+    if (it != m_literals.constEnd()) {
+        return it.value();
+    }
+    const quint32 id = defineString(QByteArray(literal), out);
+    m_literals.insert(literal, id);
+    return id;
+}
+
+quint32 BinaryLogWriter::defineString(const QByteArray& utf8, QByteArray& out)
+{
+    const quint32 id = m_nextId++;
+    out.append(static_cast<char>(TAG_STRING));
+    appendLittleEndian<quint32>(out, id);
+    appendUtf8(out, utf8);
+    return id;
+}
+
+BinaryLogReader::BinaryLogReader(const QByteArray& data)
+    : m_data(data)
+    , m_pos(0)
+    , m_wallAnchorNs(0)
+    , m_steadyAnchorNs(0)
+{
+    if (!m_data.startsWith(BinaryLogWriter::fileMagic())) {
+        m_error = "不是二进制日志文件";
+        m_pos = m_data.size();
+    } else {
+        m_pos = FILE_MAGIC_SIZE;
+    }
+}
+
+bool BinaryLogReader::readNext(LogEntry& entry)
+{
+    const char* data = m_data.constData();
+    const qsizetype size = m_data.size();
+
+    auto readBytes = [&](qsizetype count, const char*& bytes) {
+        if (count < 0 || size - m_pos < count) {
+            return false;
+        }
+        bytes = data + m_pos;
+        m_pos += count;
+        return true;
+    };
+    auto readU8 = [&](quint8& value) {
+        const char* bytes;
+        if (!readBytes(1, bytes)) return false;
+        value = static_cast<quint8>(*bytes);
+        return true;
+    };
+    auto readU32 = [&](quint32& value) {
+        const char* bytes;
+        if (!readBytes(4, bytes)) return false;
+        value = qFromLittleEndian<quint32>(bytes);
+        return true;
+    };
+    auto readI64 = [&](qint64& value) {
+        const char* bytes;
+        if (!readBytes(8, bytes)) return false;
+        value = qFromLittleEndian<qint64>(bytes);
+        return true;
+    };
+    auto readUtf8 = [&](QString& value) {
+        quint32 length;
+        const char* bytes;
+        if (!readU32(length) || !readBytes(static_cast<qsizetype>(length), bytes)) return false;
+        value = QString::fromUtf8(bytes, static_cast<qsizetype>(length));
+        return true;
+    };
+
+    while (m_error.isEmpty() && m_pos < size) {
+        quint8 tag;
+        readU8(tag);
+
+        if (tag == 0) {
+            // 预分配日志段中尚未写入的区域
+            m_pos = size;
+            return false;
+        }
+        if (tag == TAG_SESSION) {
+            if (!readI64(m_wallAnchorNs) || !readI64(m_steadyAnchorNs)) {
+                return fail("会话记录不完整");
+            }
+            m_strings.clear();
+        } else if (tag == TAG_STRING) {
+            quint32 id;
+            QString text;
+            if (!readU32(id) || !readUtf8(text)) {
+                return fail("字符串记录不完整");
+            }
+            m_strings.insert(id, text);
+        } else if (tag == TAG_ENTRY) {
+            quint8 level;
+            qint64 timestampNs;
+            quint32 categoryId, formatId, fileId, line, functionId;
+            quint8 count;
+            if (!readU8(level) || !readI64(timestampNs) || !readU32(categoryId) || !readU32(formatId)
+                || !readU32(fileId) || !readU32(line) || !readU32(functionId) || !readU8(count)) {
+                return fail("日志条目不完整");
+            }
+            if (level > static_cast<quint8>(LogLevel::Critical)) {
+                return fail(QString("日志级别无效: %1").arg(level));
+            }
+
+            std::vector<LogArgument> arguments;
+            arguments.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                quint8 type;
+                if (!readU8(type)) {
+                    return fail("日志参数不完整");
+                }
+                LogArgument argument;
+                if (type == static_cast<quint8>(LogArgument::Type::Int)) {
+                    if (!readI64(argument.intValue)) return fail("日志参数不完整");
+                    argument.type = LogArgument::Type::Int;
+                } else if (type == static_cast<quint8>(LogArgument::Type::Double)) {
+                    qint64 bits;
+                    if (!readI64(bits)) return fail("日志参数不完整");
+                    std::memcpy(&argument.doubleValue, &bits, sizeof(bits));
+                    argument.type = LogArgument::Type::Double;
+                } else if (type == static_cast<quint8>(LogArgument::Type::String)) {
+                    if (!readUtf8(argument.stringValue)) return fail("日志参数不完整");
+                    argument.type = LogArgument::Type::String;
+                } else {
+                    return fail(QString("日志参数类型无效: %1").arg(type));
+                }
+                arguments.push_back(std::move(argument));
+            }
+
+            quint32 payloadSize;
+            const char* payloadBytes;
+            if (!readU32(payloadSize) || !readBytes(static_cast<qsizetype>(payloadSize), payloadBytes)) {
+                return fail("日志负载不完整");
+            }
+
+            QString message;
+            if (formatId == 0 && !arguments.empty()) {
+                message = arguments.front().stringValue;
+                arguments.clear();
+            }
+
+            const qint64 wallNs = m_wallAnchorNs + (timestampNs - m_steadyAnchorNs);
+            entry.timestamp = QDateTime::fromMSecsSinceEpoch(wallNs / 1000000);
+            entry.level = static_cast<LogLevel>(level);
+            entry.category = m_strings.value(categoryId);
+            entry.message = LogFormatting::formatMessage(m_strings.value(formatId), message, arguments,
+                                                         QByteArray::fromRawData(payloadBytes, payloadSize));
+            entry.file = m_strings.value(fileId);
+            entry.line = static_cast<qint32>(line);
+            entry.function = m_strings.value(functionId);
+            return true;
+        } else {
+            return fail(QString("未知记录类型 0x%1").arg(tag, 2, 16, QChar('0')));
+        }
+    }
+    return false;
+}
+
+bool BinaryLogReader::hasError() const
+{
+    return !m_error.isEmpty();
+}
+
+QString BinaryLogReader::errorString() const
+{
+    return m_error;
+}
+
+bool BinaryLogReader::fail(const QString& reason)
+{
+    m_error = QString("%1 (偏移 %2)").arg(reason).arg(m_pos);
+    return false;
+}
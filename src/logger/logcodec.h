@@ -0,0 +1,68 @@
+#pragma once
+
+#include "logrecord.h"
+#include <QHash>
+
+// 日志格式化：文本日志、界面显示、导出和离线解码共用同一套格式
+namespace LogFormatting {
+QString levelToString(LogLevel level);
+// 格式串按 %1..%n 依次替换参数；格式串为空时使用 message；负载非空时追加大写十六进制
+QString formatMessage(const QString& format, const QString& message,
+                      const std::vector<LogArgument>& arguments, const QByteArray& payload);
+QString formatMessage(const LogRecord& record);
+// "[yyyy-MM-dd hh:mm:ss.zzz] [LEVEL] [category] message (file:line)"
+QString formatEntry(const LogEntry& entry);
+}
+
+// 二进制日志编码
+//
+// 文件以 8 字节魔数 "GLOGBIN1" 开头，其后为连续的记录，多字节字段均为小端：
+//   会话   0x01 系统时钟锚点(i64 ns) 单调时钟锚点(i64 ns)        —— 清空字符串表
+//   字符串 0x02 编号(u32) 长度(u32) UTF-8
+//   条目   0x03 级别(u8) 单调时间戳(i64 ns) 分类(u32) 格式串(u32) 文件(u32) 行号(i32)
+//               函数(u32) 参数个数(u8) 参数... 负载长度(u32) 负载
+//   参数   类型(u8) 整数 i64 | 浮点 f64 | 字符串 长度(u32) UTF-8
+// 分类、格式串、文件名和函数名在会话内首次出现时写一次字符串定义，条目中只引用编号（0 表示空）；
+// 格式串编号为 0 时第一个参数即为已格式化的消息。日志文件每次打开或轮转都开始新会话。
+// 记录类型 0 表示预分配日志段的未写入区域，解码到此结束。
+class BinaryLogWriter
+{
+public:
+    static QByteArray fileMagic();
+
+    // 开始新会话并写入时钟锚点，之后的字符串重新定义
+    void beginSession(QByteArray& out, qint64 wallAnchorNs, qint64 steadyAnchorNs);
+    // 把一条记录追加到 out
+    void encode(const LogRecord& record, QByteArray& out);
+
+private:
+    quint32 internString(const QString& text, QByteArray& out);
+    quint32 internLiteral(const char* literal, QByteArray& out);
+    quint32 defineString(const QByteArray& utf8, QByteArray& out);
+
+    QHash<QString, quint32> m_strings;
+    QHash<const char*, quint32> m_literals;    // 格式串和宏记录的函数名为静态字符串，按地址查找
+    quint32 m_nextId = 1;
+};
+
+// 二进制日志解码（日志导出和离线解码工具使用）
+class BinaryLogReader
+{
+public:
+    explicit BinaryLogReader(const QByteArray& data);
+
+    // 读取下一条日志；到达末尾或数据损坏时返回 false
+    bool readNext(LogEntry& entry);
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    bool fail(const QString& reason);
+
+    QByteArray m_data;
+    qsizetype m_pos;
+    QHash<quint32, QString> m_strings;
+    qint64 m_wallAnchorNs;
+    qint64 m_steadyAnchorNs;
+    QString m_error;
+};
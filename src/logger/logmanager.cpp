@@ -1,35 +1,116 @@
 #include "logmanager.h"
+#include "logcodec.h"
+#include "logsegmentwriter.h"
 #include "config/configmanager.h"
+#include "constants.h"
+#include "utils/monotonicclock.h"
+#include "utils/spscqueue.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QMetaMethod>
 #include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <deque>
 #include <iostream>
 
-LogManager* LogManager::instance = nullptr;
+// 单个线程的日志缓冲区：所属线程是唯一生产者，写入线程是唯一消费者
+struct LogThreadBuffer {
+    BoundedSpscQueue<LogRecord> queue{System::LOG_THREAD_BUFFER_CAPACITY};
+    std::atomic<quint64> dropped{0};
+    std::atomic<bool> abandoned{false};     // 所属线程已退出，写完剩余记录后回收
+};
+
+// 单个端口的通讯日志采样状态，由 samplingMutex 保护
+struct CommunicationTraceState {
+    CommunicationTraceConfig config;
+    bool explicitConfig = false;        // 单独配置过，不跟随默认方式
+    quint64 counter = 0;                // OneInN
+    qint64 windowStartNs = 0;           // FirstNPerSecond
+    int windowCount = 0;
+    quint64 windowSuppressed = 0;
+    std::deque<LogRecord> preTrigger;   // TriggerOnError 触发前的记录
+    int postRemaining = 0;
+    quint64 suppressed = 0;             // 累计跳过的记录数
+
+    void reset() {
+        counter = 0;
+        windowStartNs = 0;
+        windowCount = 0;
+        windowSuppressed = 0;
+        preTrigger.clear();
+        postRemaining = 0;
+    }
+};
+
+namespace {
+// 线程退出时标记缓冲区，由写入线程回收
+struct ThreadBufferHolder {
+    std::shared_ptr<LogThreadBuffer> buffer;
+    ~ThreadBufferHolder() {
+        if (buffer) {
+            buffer->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadBufferHolder t_threadBuffer;
+
+// 通讯日志的格式串，方向和端口作为参数，数据作为负载
+constexpr const char* COMMUNICATION_FORMAT = "[%1] %2:";
+constexpr const char* COMMUNICATION_RATE_LIMITED_FORMAT = "[%1] 通讯日志限流，上一秒跳过 %2 次收发";
+constexpr const char* COMMUNICATION_TRIGGERED_FORMAT = "[%1] 通讯跟踪已触发: %2，写出触发前 %3 次收发";
+constexpr qint64 NS_PER_SECOND = 1000000000;
+}
+
+QAtomicPointer<LogManager> LogManager::instance = nullptr;
 QMutex LogManager::mutex;
+std::atomic<int> LogManager::minimumLevel{static_cast<int>(LogLevel::Debug)};
 
 LogManager* LogManager::getInstance()
 {
+    // 每条日志都会调用，创建完成后不再加锁
+    LogManager* manager = instance.loadAcquire();
+    if (manager) {
+        return manager;
+    }
+    
     QMutexLocker locker(&mutex);
-    if (!instance) {
-        instance = new LogManager();
+    if (!instance.loadRelaxed()) {
+        instance.storeRelease(new LogManager());
     }
-    return instance;
+    return instance.loadRelaxed();
 }
 
 LogManager::LogManager(QObject* parent)
     : QObject(parent)
-    , currentLogLevel(LogLevel::Info)
     , logFile(nullptr)
     , logStream(nullptr)
     , consoleOutputEnabled(true)
+    , fileFormat(static_cast<int>(LogFileFormat::Text))
+    , binaryLogFile(nullptr)
+    , binaryWriter(new BinaryLogWriter)
+    , wallAnchorNs(MonotonicClock::anchorEpochNs())
+    , steadyAnchorNs(MonotonicClock::anchorMonotonicNs())
+    , storageMode(static_cast<int>(LogStorage::File))
+    , segmentWriterBinary(false)
+    , writerThread(nullptr)
+    , writerStopping(false)
+    , wakePending(false)
+    , overflowPolicy(static_cast<int>(LogOverflowPolicy::DropAndCount))
+    , droppedTotal(0)
+    , drainRound(0)
     , maxFileSize(10 * 1024 * 1024) // 10MB
     , maxLogFiles(10)
+    , samplingEnabled(false)
     , maxMemoryEntries(5000)
+    , logStore(maxMemoryEntries)
 {
+    qRegisterMetaType<LogEntry>("LogEntry");
+    
     // 设置日志文件路径
     QString logPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs";
     QDir().mkpath(logPath);
@@ -37,10 +118,10 @@ LogManager::LogManager(QObject* parent)
     QString logFilePath = logPath + "/app.log";
     setLogFile(logFilePath);
     
-    // 创建定时器
-    processTimer = new QTimer(this);
-    connect(processTimer, &QTimer::timeout, this, &LogManager::processLogQueue);
-    processTimer->start(100); // 每100ms处理一次日志队列
+    // 专用写入线程：格式化和文件I/O都不占用记录日志的线程和GUI线程
+    writerThread = QThread::create([this]() { writerLoop(); });
+    writerThread->setObjectName("LogWriter");
+    writerThread->start();
     
     fileSizeTimer = new QTimer(this);
     connect(fileSizeTimer, &QTimer::timeout, this, &LogManager::checkFileSize);
@@ -49,26 +130,49 @@ LogManager::LogManager(QObject* parent)
     // 从配置加载设置
     ConfigManager* config = ConfigManager::getInstance();
     QString levelStr = config->getLogLevel();
-    if (levelStr == "Debug") currentLogLevel = LogLevel::Debug;
-    else if (levelStr == "Info") currentLogLevel = LogLevel::Info;
-    else if (levelStr == "Warning") currentLogLevel = LogLevel::Warning;
-    else if (levelStr == "Error") currentLogLevel = LogLevel::Error;
-    else if (levelStr == "Critical") currentLogLevel = LogLevel::Critical;
+    LogLevel level = LogLevel::Info;
+    if (levelStr == "Debug") level = LogLevel::Debug;
+    else if (levelStr == "Info") level = LogLevel::Info;
+    else if (levelStr == "Warning") level = LogLevel::Warning;
+    else if (levelStr == "Error") level = LogLevel::Error;
+    else if (levelStr == "Critical") level = LogLevel::Critical;
+    minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
     
     maxLogFiles = config->getLogMaxFiles();
     maxFileSize = config->getLogMaxSize();
     
     // 记录启动日志
     info("日志管理器已启动");
+    
+    if (config->getLogFormat() == "Binary") {
+        setLogFormat(LogFileFormat::Binary);
+    }
+    if (config->getLogStorage() == "MappedSegments") {
+        setLogStorage(LogStorage::MappedSegments);
+    }
 }
 
 LogManager::~LogManager()
 {
     info("日志管理器正在关闭");
     
-    // 处理剩余的日志队列
+    // 写入线程退出前会写完已有记录，之后在本线程处理剩余的记录
+    writerStopping.store(true, std::memory_order_release);
+    {
+        QMutexLocker locker(&writerMutex);
+        writerCondition.wakeAll();
+    }
+    writerThread->wait();
+    delete writerThread;
+    writerThread = nullptr;
     processLogQueue();
     
+    {
+        QMutexLocker locker(&logMutex);
+        closeBinaryLogFile();
+        closeSegmentWriter();
+    }
+    
     if (logStream) {
         logStream->flush();
         delete logStream;
@@ -83,31 +187,81 @@ LogManager::~LogManager()
 void LogManager::log(LogLevel level, const QString& category, const QString& message, 
                     const QString& file, int line, const QString& function)
 {
-    if (level < currentLogLevel) {
+    if (!isLevelEnabled(level)) {
         return;
     }
     
-    LogEntry entry;
-    entry.timestamp = QDateTime::currentDateTime();
-    entry.level = level;
-    entry.category = category;
-    entry.message = message;
-    entry.file = file;
-    entry.line = line;
-    entry.function = function;
+    // 只拷贝字符串引用并写入本线程缓冲区，不加锁、不分配内存
+    LogRecord record;
+    record.timestampNs = MonotonicClock::nowNs();
+    record.level = level;
+    record.category = category;
+    record.message = message;
+    record.file = file;
+    record.line = line;
+    record.function = function;
+    submitRecord(std::move(record));
+}
+
+void LogManager::logAt(LogLevel level, const QString& category, const QString& message,
+                       const QString& file, int line, const char* function)
+{
+    if (!isLevelEnabled(level)) {
+        return;
+    }
     
-    {
-        QMutexLocker locker(&logMutex);
-        logQueue.enqueue(entry);
-        
-        // 添加到内存中的日志条目
-        logEntries.append(entry);
-        if (logEntries.size() > maxMemoryEntries) {
-            logEntries.removeFirst();
+    // 函数名按指针保存，只在显示或写入文本时转换
+    LogRecord record;
+    record.timestampNs = MonotonicClock::nowNs();
+    record.level = level;
+    record.category = category;
+    record.message = message;
+    record.file = file;
+    record.line = line;
+    record.sourceFunction = function;
+    submitRecord(std::move(record));
+}
+
+void LogManager::logDeferred(LogLevel level, const QString& category, const char* format,
+                             std::initializer_list<LogArgument> arguments)
+{
+    if (!isLevelEnabled(level)) {
+        return;
+    }
+    
+    LogRecord record;
+    record.timestampNs = MonotonicClock::nowNs();
+    record.level = level;
+    record.category = category;
+    record.format = format;
+    record.arguments.assign(arguments.begin(), arguments.end());
+    submitRecord(std::move(record));
+}
+
+void LogManager::submitRecord(LogRecord&& record)
+{
+    const LogLevel level = record.level;
+    LogThreadBuffer* buffer = threadBuffer();
+    if (!buffer->queue.tryPush(std::move(record))) {
+        // 写入线程自己记录日志或正在退出时不能等待，只能丢弃
+        const bool canBlock = overflowPolicy.load(std::memory_order_relaxed) == static_cast<int>(LogOverflowPolicy::Block)
+            && QThread::currentThread() != writerThread
+            && !writerStopping.load(std::memory_order_acquire);
+        if (!canBlock) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            droppedTotal.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
+        do {
+            wakeWriter();
+            QThread::yieldCurrentThread();
+        } while (!buffer->queue.tryPush(std::move(record)));
     }
     
-    emit newLogEntry(entry);
+    // 错误日志尽快落盘；缓冲区过半时提前唤醒，其余情况由写入线程按间隔取出
+    if (level >= LogLevel::Error || buffer->queue.sizeApprox() >= buffer->queue.capacity() / 2) {
+        wakeWriter();
+    }
 }
 
 void LogManager::debug(const QString& message, const QString& category)
@@ -137,20 +291,306 @@ void LogManager::critical(const QString& message, const QString& category)
 
 void LogManager::logCommunication(const QString& direction, const QByteArray& data, const QString& port)
 {
-    QString hexData = data.toHex(' ').toUpper();
-    QString message = QString("[%1] %2: %3").arg(direction, port.isEmpty() ? "Unknown" : port, hexData);
-    log(LogLevel::Debug, "Communication", message);
+    if (!isLevelEnabled(LogLevel::Debug)) {
+        return;
+    }
+    
+    // 数据按隐式共享保存原始字节，十六进制转换推迟到写入线程或查看时
+    const QString portName = port.isEmpty() ? QStringLiteral("Unknown") : port;
+    LogRecord record;
+    record.timestampNs = MonotonicClock::nowNs();
+    record.level = LogLevel::Debug;
+    record.category = QStringLiteral("Communication");
+    record.format = COMMUNICATION_FORMAT;
+    record.arguments.reserve(2);
+    record.arguments.emplace_back(direction);
+    record.arguments.emplace_back(portName);
+    record.payload = data;
+    
+    if (!samplingEnabled.load(std::memory_order_relaxed)) {
+        submitRecord(std::move(record));
+        return;
+    }
+    
+    LogRecord summary;
+    {
+        QMutexLocker locker(&samplingMutex);
+        CommunicationTraceState& state = traceState(portName);
+        switch (state.config.mode) {
+        case CommunicationSampling::All:
+            break;
+        case CommunicationSampling::OneInN:
+            if (state.counter++ % static_cast<quint64>(state.config.rate) != 0) {
+                ++state.suppressed;
+                return;
+            }
+            break;
+        case CommunicationSampling::FirstNPerSecond:
+            if (record.timestampNs - state.windowStartNs >= NS_PER_SECOND) {
+                if (state.windowSuppressed > 0) {
+                    summary.timestampNs = record.timestampNs;
+                    summary.level = LogLevel::Debug;
+                    summary.category = record.category;
+                    summary.format = COMMUNICATION_RATE_LIMITED_FORMAT;
+                    summary.arguments = {LogArgument(portName), LogArgument(state.windowSuppressed)};
+                }
+                state.windowStartNs = record.timestampNs;
+                state.windowCount = 0;
+                state.windowSuppressed = 0;
+            }
+            if (state.windowCount >= state.config.rate) {
+                ++state.windowSuppressed;
+                ++state.suppressed;
+                return;
+            }
+            ++state.windowCount;
+            break;
+        case CommunicationSampling::TriggerOnError:
+            if (state.postRemaining > 0) {
+                --state.postRemaining;
+                break;
+            }
+            // 只保留在内存中，触发时才写出
+            state.preTrigger.push_back(std::move(record));
+            if (static_cast<int>(state.preTrigger.size()) > state.config.preTriggerFrames) {
+                state.preTrigger.pop_front();
+                ++state.suppressed;
+            }
+            return;
+        }
+    }
+    
+    if (summary.format) {
+        submitRecord(std::move(summary));
+    }
+    submitRecord(std::move(record));
+}
+
+void LogManager::setCommunicationSampling(const QString& port, const CommunicationTraceConfig& config)
+{
+    CommunicationTraceConfig sanitized = config;
+    sanitized.rate = qMax(1, sanitized.rate);
+    sanitized.preTriggerFrames = qMax(0, sanitized.preTriggerFrames);
+    sanitized.postTriggerFrames = qMax(0, sanitized.postTriggerFrames);
+    
+    QMutexLocker locker(&samplingMutex);
+    if (port.isEmpty()) {
+        defaultTraceConfig = sanitized;
+        for (const auto& state : std::as_const(traceStates)) {
+            if (!state->explicitConfig) {
+                state->config = sanitized;
+                state->reset();
+            }
+        }
+    } else {
+        CommunicationTraceState& state = traceState(port);
+        state.config = sanitized;
+        state.explicitConfig = true;
+        state.reset();
+    }
+    updateSamplingEnabled();
+}
+
+void LogManager::clearCommunicationSampling(const QString& port)
+{
+    if (port.isEmpty()) {
+        setCommunicationSampling(QString(), CommunicationTraceConfig());
+        return;
+    }
+    
+    QMutexLocker locker(&samplingMutex);
+    auto it = traceStates.find(port);
+    if (it != traceStates.end()) {
+        (*it)->config = defaultTraceConfig;
+        (*it)->explicitConfig = false;
+        (*it)->reset();
+    }
+    updateSamplingEnabled();
+}
+
+CommunicationTraceConfig LogManager::getCommunicationSampling(const QString& port) const
+{
+    QMutexLocker locker(&samplingMutex);
+    auto it = traceStates.constFind(port);
+    if (port.isEmpty() || it == traceStates.constEnd()) {
+        return defaultTraceConfig;
+    }
+    return (*it)->config;
+}
+
+void LogManager::triggerCommunicationTrace(const QString& port, const QString& reason)
+{
+    if (!samplingEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    
+    const QString portName = port.isEmpty() ? QStringLiteral("Unknown") : port;
+    std::deque<LogRecord> pending;
+    {
+        QMutexLocker locker(&samplingMutex);
+        CommunicationTraceState& state = traceState(portName);
+        if (state.config.mode != CommunicationSampling::TriggerOnError) {
+            return;
+        }
+        pending.swap(state.preTrigger);
+        state.postRemaining = state.config.postTriggerFrames;
+    }
+    
+    // 缓存的记录保留各自的时间戳，写入时与同批日志按时间排序
+    logDeferred(LogLevel::Warning, "Communication", COMMUNICATION_TRIGGERED_FORMAT,
+                {portName, reason, static_cast<qint64>(pending.size())});
+    for (LogRecord& record : pending) {
+        submitRecord(std::move(record));
+    }
+}
+
+quint64 LogManager::getSuppressedCommunicationCount(const QString& port) const
+{
+    QMutexLocker locker(&samplingMutex);
+    auto it = traceStates.constFind(port);
+    return it == traceStates.constEnd() ? 0 : (*it)->suppressed;
+}
+
+// 调用方持有 samplingMutex
+void LogManager::updateSamplingEnabled()
+{
+    bool enabled = defaultTraceConfig.mode != CommunicationSampling::All;
+    for (const auto& state : std::as_const(traceStates)) {
+        enabled |= state->config.mode != CommunicationSampling::All;
+    }
+    samplingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// 调用方持有 samplingMutex；端口首次出现时按默认方式创建状态
+CommunicationTraceState& LogManager::traceState(const QString& port)
+{
+    auto it = traceStates.find(port);
+    if (it == traceStates.end()) {
+        auto state = std::make_shared<CommunicationTraceState>();
+        state->config = defaultTraceConfig;
+        it = traceStates.insert(port, state);
+    }
+    return **it;
 }
 
 void LogManager::setLogLevel(LogLevel level)
 {
-    currentLogLevel = level;
-    info(QString("日志级别已设置为: %1").arg(logLevelToString(level)));
+    minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    info(QString("日志级别已设置为: %1").arg(LogFormatting::levelToString(level)));
 }
 
 LogLevel LogManager::getLogLevel() const
 {
-    return currentLogLevel;
+    return static_cast<LogLevel>(minimumLevel.load(std::memory_order_relaxed));
+}
+
+void LogManager::setLogFormat(LogFileFormat format)
+{
+    {
+        QMutexLocker locker(&logMutex);
+        fileFormat.store(static_cast<int>(format), std::memory_order_relaxed);
+        if (format == LogFileFormat::Text) {
+            closeBinaryLogFile();
+        }
+    }
+    info(QString("日志文件格式已设置为: %1").arg(format == LogFileFormat::Binary ? "Binary" : "Text"));
+}
+
+LogFileFormat LogManager::getLogFormat() const
+{
+    return static_cast<LogFileFormat>(fileFormat.load(std::memory_order_relaxed));
+}
+
+QString LogManager::getBinaryLogFile() const
+{
+    QFileInfo fileInfo(logFilename);
+    return QString("%1/%2.blog").arg(fileInfo.path(), fileInfo.baseName());
+}
+
+void LogManager::setLogStorage(LogStorage storage)
+{
+    // 段写入器由写入线程在下一批写出时创建或关闭，封存最后一段的I/O不占用调用线程
+    storageMode.store(static_cast<int>(storage), std::memory_order_relaxed);
+    wakeWriter();
+    info(QString("日志存储方式已设置为: %1").arg(storage == LogStorage::MappedSegments ? "MappedSegments" : "File"));
+}
+
+LogStorage LogManager::getLogStorage() const
+{
+    return static_cast<LogStorage>(storageMode.load(std::memory_order_relaxed));
+}
+
+void LogManager::setOverflowPolicy(LogOverflowPolicy policy)
+{
+    overflowPolicy.store(static_cast<int>(policy), std::memory_order_relaxed);
+}
+
+LogOverflowPolicy LogManager::getOverflowPolicy() const
+{
+    return static_cast<LogOverflowPolicy>(overflowPolicy.load(std::memory_order_relaxed));
+}
+
+quint64 LogManager::getDroppedCount() const
+{
+    return droppedTotal.load(std::memory_order_relaxed);
+}
+
+void LogManager::flush()
+{
+    if (!writerThread || QThread::currentThread() == writerThread) {
+        return;
+    }
+    
+    // 调用时正在进行的一轮可能已经错过新记录，等待下一轮完整的写出
+    QMutexLocker locker(&writerMutex);
+    const quint64 target = drainRound + 2;
+    wakePending.store(true, std::memory_order_release);
+    writerCondition.wakeOne();
+    while (drainRound < target && !writerStopping.load(std::memory_order_acquire)) {
+        drainedCondition.wait(&writerMutex, System::LOG_FLUSH_INTERVAL_MS);
+    }
+}
+
+LogThreadBuffer* LogManager::threadBuffer()
+{
+    if (!t_threadBuffer.buffer) {
+        auto buffer = std::make_shared<LogThreadBuffer>();
+        {
+            QMutexLocker locker(&buffersMutex);
+            threadBuffers.push_back(buffer);
+        }
+        t_threadBuffer.buffer = std::move(buffer);
+    }
+    return t_threadBuffer.buffer.get();
+}
+
+void LogManager::wakeWriter()
+{
+    // 已有未处理的唤醒时不再进入互斥锁
+    if (!wakePending.exchange(true, std::memory_order_acq_rel)) {
+        QMutexLocker locker(&writerMutex);
+        writerCondition.wakeOne();
+    }
+}
+
+void LogManager::writerLoop()
+{
+    while (!writerStopping.load(std::memory_order_acquire)) {
+        processLogQueue();
+        
+        QMutexLocker locker(&writerMutex);
+        ++drainRound;
+        drainedCondition.wakeAll();
+        if (!wakePending.load(std::memory_order_acquire) && !writerStopping.load(std::memory_order_acquire)) {
+            writerCondition.wait(&writerMutex, System::LOG_FLUSH_INTERVAL_MS);
+        }
+        wakePending.store(false, std::memory_order_release);
+    }
+    
+    processLogQueue();
+    QMutexLocker locker(&writerMutex);
+    ++drainRound;
+    drainedCondition.wakeAll();
 }
 
 /**
@@ -180,6 +620,10 @@ void LogManager::setLogFile(const QString& filename)
             logFile = nullptr;
         }
         
+        // 二进制日志和日志段跟随新的文件名，下一批写出时重新打开
+        closeBinaryLogFile();
+        closeSegmentWriter();
+        
         logFilename = filename;
         
         // 确保目录存在
@@ -295,13 +739,35 @@ void LogManager::cleanupOldLogFiles()
 
 QList<LogEntry> LogManager::getLogEntries(int count) const
 {
-    QMutexLocker locker(&logMutex);
-    
-    if (count >= logEntries.size()) {
-        return logEntries;
+    if (count <= 0) {
+        return QList<LogEntry>();
     }
     
-    return logEntries.mid(logEntries.size() - count);
+    const std::vector<LogRecord> records = collectRecords(LogRecordStore::Filter(), count);
+    QList<LogEntry> entries;
+    entries.reserve(static_cast<qsizetype>(records.size()));
+    for (const LogRecord& record : records) {
+        entries.append(toLogEntry(record));
+    }
+    return entries;
+}
+
+QList<LogEntry> LogManager::queryLogEntries(const LogQuery& query) const
+{
+    const LogRecordStore::Filter filter = makeFilter(query.startTime, query.endTime, query.minLevel, query.categories);
+    const std::vector<LogRecord> records = collectRecords(filter, qMax(0, query.limit));
+    QList<LogEntry> entries;
+    entries.reserve(static_cast<qsizetype>(records.size()));
+    for (const LogRecord& record : records) {
+        entries.append(toLogEntry(record));
+    }
+    return entries;
+}
+
+QStringList LogManager::getLogCategories() const
+{
+    QMutexLocker locker(&logMutex);
+    return logStore.categories();
 }
 
 bool LogManager::exportLogs(const QString& filename, const QDateTime& startTime, const QDateTime& endTime) const
@@ -314,74 +780,173 @@ bool LogManager::exportLogs(const QString& filename, const QDateTime& startTime,
     QTextStream out(&file);
     out.setEncoding(QStringConverter::Utf8);
     
-    QMutexLocker locker(&logMutex);
-    
-    for (const LogEntry& entry : logEntries) {
-        bool includeEntry = true;
-        
-        if (startTime.isValid() && entry.timestamp < startTime) {
-            includeEntry = false;
-        }
-        
-        if (endTime.isValid() && entry.timestamp > endTime) {
-            includeEntry = false;
-        }
-        
-        if (includeEntry) {
-            out << formatLogEntry(entry) << "\n";
-        }
+    // 按时间索引筛选，文件写入不占用日志锁
+    const std::vector<LogRecord> records =
+        collectRecords(makeFilter(startTime, endTime, LogLevel::Debug, QStringList()), 0);
+    for (const LogRecord& record : records) {
+        out << formatLogEntry(toLogEntry(record)) << "\n";
     }
     
     return true;
 }
 
+LogRecordStore::Filter LogManager::makeFilter(const QDateTime& startTime, const QDateTime& endTime,
+                                              LogLevel minLevel, const QStringList& categories) const
+{
+    // 时间范围按毫秒比较（含两端），换算为单调时钟时间戳
+    LogRecordStore::Filter filter;
+    if (startTime.isValid()) {
+        filter.startNs = startTime.toMSecsSinceEpoch() * 1000000 - wallAnchorNs + steadyAnchorNs;
+    }
+    if (endTime.isValid()) {
+        filter.endNs = (endTime.toMSecsSinceEpoch() + 1) * 1000000 - 1 - wallAnchorNs + steadyAnchorNs;
+    }
+    filter.levelMask = LogRecordStore::levelMaskFrom(minLevel);
+    filter.categories = categories;
+    return filter;
+}
+
+std::vector<LogRecord> LogManager::collectRecords(const LogRecordStore::Filter& filter, int limit) const
+{
+    std::vector<LogRecord> records;
+    QMutexLocker locker(&logMutex);
+    logStore.visit(filter, limit, [&records](const LogRecord& record) {
+        records.push_back(record);
+    });
+    return records;
+}
+
 /**
  * @brief 处理日志队列
  * 
- * 批量处理日志队列中的条目，提高性能并确保线程安全
+ * 在写入线程中取出所有线程缓冲区的记录，按时间排序后批量写出；
+ * 已退出线程的缓冲区取空后回收
  */
 void LogManager::processLogQueue()
 {
-    QList<LogEntry> entriesToProcess;
-    
-    // 快速获取待处理的日志条目，减少锁定时间
+    std::vector<std::shared_ptr<LogThreadBuffer>> buffers;
     {
-        QMutexLocker locker(&logMutex);
-        while (!logQueue.isEmpty()) {
-            entriesToProcess.append(logQueue.dequeue());
+        QMutexLocker locker(&buffersMutex);
+        buffers = threadBuffers;
+    }
+    
+    std::vector<LogRecord> records;
+    quint64 dropped = 0;
+    bool reclaim = false;
+    for (const auto& buffer : buffers) {
+        // 先读取退出标记：标记之前写入的记录在本轮都能取到
+        const bool abandoned = buffer->abandoned.load(std::memory_order_acquire);
+        for (;;) {
+            LogRecord record;
+            if (!buffer->queue.tryPop(record)) {
+                break;
+            }
+            records.push_back(std::move(record));
         }
+        dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        reclaim |= abandoned;
     }
     
-    // 在锁外处理日志条目，避免长时间锁定
-    for (const LogEntry& entry : entriesToProcess) {
-        // writeToFile内部有自己的锁保护
-        if (logStream) {
-            writeToFile(entry);
+    if (reclaim) {
+        QMutexLocker locker(&buffersMutex);
+        threadBuffers.erase(std::remove_if(threadBuffers.begin(), threadBuffers.end(),
+                                           [](const std::shared_ptr<LogThreadBuffer>& buffer) {
+                                               return buffer->abandoned.load(std::memory_order_acquire)
+                                                   && buffer->queue.isEmptyApprox();
+                                           }),
+                            threadBuffers.end());
+    }
+    
+    if (dropped > 0) {
+        LogRecord record;
+        record.timestampNs = MonotonicClock::nowNs();
+        record.level = LogLevel::Warning;
+        record.category = "LogManager";
+        record.message = QString("日志缓冲区已满，丢弃 %1 条日志").arg(dropped);
+        records.push_back(std::move(record));
+    }
+    
+    if (records.empty()) {
+        return;
+    }
+    
+    // 各线程缓冲区内部有序，合并后按时间排序
+    std::stable_sort(records.begin(), records.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+    
+    // 二进制模式下只有控制台输出或界面订阅时才格式化
+    const bool binary = fileFormat.load(std::memory_order_relaxed) == static_cast<int>(LogFileFormat::Binary);
+    const bool notify = isSignalConnected(QMetaMethod::fromSignal(&LogManager::newLogEntry));
+    QList<LogEntry> entries;
+    if (!binary || consoleOutputEnabled || notify) {
+        entries.reserve(static_cast<qsizetype>(records.size()));
+        for (const LogRecord& record : records) {
+            entries.append(toLogEntry(record));
         }
-        
-        if (consoleOutputEnabled) {
+    }
+    
+    const bool mapped = storageMode.load(std::memory_order_relaxed) == static_cast<int>(LogStorage::MappedSegments);
+    if (mapped) {
+        writeToSegments(records, entries, binary);
+    } else {
+        if (segmentWriter) {
+            QMutexLocker locker(&logMutex);
+            closeSegmentWriter();
+        }
+        if (binary) {
+            writeToBinaryFile(records);
+        } else if (logStream) {
+            writeToFile(entries);
+        }
+    }
+    
+    if (consoleOutputEnabled) {
+        for (const LogEntry& entry : entries) {
             writeToConsole(entry);
         }
     }
+    
+    {
+        QMutexLocker locker(&logMutex);
+        for (LogRecord& record : records) {
+            logStore.append(std::move(record));
+        }
+    }
+    
+    if (notify) {
+        for (const LogEntry& entry : entries) {
+            emit newLogEntry(entry);
+        }
+    }
 }
 
 void LogManager::checkFileSize()
 {
-    if (!logFile) return;
-    
-    if (logFile->size() > maxFileSize) {
+    if (logFile && logFile->size() > maxFileSize) {
         rotateLogFile();
         cleanupOldLogFiles();
     }
+    
+    qint64 binarySize = 0;
+    {
+        QMutexLocker locker(&logMutex);
+        if (binaryLogFile) {
+            binarySize = binaryLogFile->size();
+        }
+    }
+    if (binarySize > maxFileSize) {
+        rotateBinaryLogFile();
+    }
 }
 
 /**
  * @brief 线程安全的文件写入方法
  * 
- * 使用互斥锁确保多线程环境下的文件写入安全
- * @param entry 日志条目
+ * 使用互斥锁确保多线程环境下的文件写入安全，每批只刷新一次
+ * @param entries 日志条目
  */
-void LogManager::writeToFile(const LogEntry& entry)
+void LogManager::writeToFile(const QList<LogEntry>& entries)
 {
     // 使用QMutexLocker确保线程安全的文件写入
     QMutexLocker locker(&logMutex);
@@ -406,7 +971,9 @@ void LogManager::writeToFile(const LogEntry& entry)
             logStream->setEncoding(QStringConverter::Utf8);
         }
         
-        *logStream << formatLogEntry(entry) << "\n";
+        for (const LogEntry& entry : entries) {
+            *logStream << formatLogEntry(entry) << "\n";
+        }
         logStream->flush();
         
         // 确保数据写入磁盘
@@ -421,6 +988,196 @@ void LogManager::writeToFile(const LogEntry& entry)
     }
 }
 
+/**
+ * @brief 写入二进制日志
+ * 
+ * 整批编码到一个缓冲区后一次写出；字符串表按会话维护，文件打开或轮转后重新定义
+ * @param records 按时间排序的原始记录
+ */
+void LogManager::writeToBinaryFile(const std::vector<LogRecord>& records)
+{
+    QMutexLocker locker(&logMutex);
+    
+    if (!binaryLogFile && !openBinaryLogFile()) {
+        return;
+    }
+    
+    QByteArray buffer;
+    buffer.reserve(static_cast<qsizetype>(records.size()) * 64);
+    for (const LogRecord& record : records) {
+        binaryWriter->encode(record, buffer);
+    }
+    
+    if (binaryLogFile->write(buffer) != buffer.size()) {
+        qCritical() << "写入二进制日志文件失败:" << binaryLogFile->errorString();
+    }
+    binaryLogFile->flush();
+}
+
+// 调用方持有 logMutex
+bool LogManager::openBinaryLogFile()
+{
+    // 在写入线程中创建，不设置父对象
+    binaryLogFile = new QFile(getBinaryLogFile());
+    if (!binaryLogFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCritical() << "无法打开二进制日志文件:" << binaryLogFile->fileName() << "错误:" << binaryLogFile->errorString();
+        delete binaryLogFile;
+        binaryLogFile = nullptr;
+        return false;
+    }
+    
+    // 追加到已有文件时不重复写魔数，每次打开都开始新会话
+    QByteArray header;
+    if (binaryLogFile->size() == 0) {
+        header = BinaryLogWriter::fileMagic();
+    }
+    binaryWriter->beginSession(header, wallAnchorNs, steadyAnchorNs);
+    binaryLogFile->write(header);
+    return true;
+}
+
+// 调用方持有 logMutex
+void LogManager::closeBinaryLogFile()
+{
+    if (!binaryLogFile) {
+        return;
+    }
+    binaryLogFile->flush();
+    binaryLogFile->close();
+    delete binaryLogFile;
+    binaryLogFile = nullptr;
+}
+
+void LogManager::rotateBinaryLogFile()
+{
+    QMutexLocker locker(&logMutex);
+    
+    if (!binaryLogFile) {
+        return;
+    }
+    closeBinaryLogFile();
+    
+    const QString binaryFilename = getBinaryLogFile();
+    QString baseName = QFileInfo(binaryFilename).baseName();
+    QString suffix = QFileInfo(binaryFilename).suffix();
+    QString path = QFileInfo(binaryFilename).path();
+    
+    for (int i = maxLogFiles - 1; i > 0; --i) {
+        QString oldName = QString("%1/%2.%3.%4").arg(path, baseName).arg(i).arg(suffix);
+        QString newName = QString("%1/%2.%3.%4").arg(path, baseName).arg(i + 1).arg(suffix);
+        
+        if (QFile::exists(oldName)) {
+            QFile::remove(newName);
+            QFile::rename(oldName, newName);
+        }
+    }
+    
+    QFile::rename(binaryFilename, QString("%1/%2.1.%3").arg(path, baseName, suffix));
+    // 下一批写出时重新创建文件并开始新会话
+}
+
+/**
+ * @brief 写入内存映射日志段
+ * 
+ * 写入只是内存拷贝；当前段放不下时切换到后台已准备好的下一段。
+ * 二进制格式的每个段都以魔数和新会话开头，可以单独解码
+ * @param records 按时间排序的原始记录（二进制格式使用）
+ * @param entries 格式化后的条目（文本格式使用）
+ * @param binary 是否写二进制格式
+ */
+void LogManager::writeToSegments(const std::vector<LogRecord>& records, const QList<LogEntry>& entries, bool binary)
+{
+    QMutexLocker locker(&logMutex);
+    
+    if (!openSegmentWriter(binary)) {
+        return;
+    }
+    
+    QByteArray chunk;
+    if (binary) {
+        for (const LogRecord& record : records) {
+            chunk.resize(0);
+            binaryWriter->encode(record, chunk);
+            if (!segmentWriter->append(chunk)) {
+                if (!rotateSegment(true)) {
+                    return;
+                }
+                // 新段重新定义字符串
+                chunk.resize(0);
+                binaryWriter->encode(record, chunk);
+                if (!segmentWriter->append(chunk)) {
+                    qWarning() << "日志记录超过段大小，已丢弃:" << chunk.size();
+                }
+            }
+        }
+    } else {
+        for (const LogEntry& entry : entries) {
+            chunk = formatLogEntry(entry).toUtf8();
+            chunk.append('\n');
+            if (!segmentWriter->append(chunk)) {
+                if (!rotateSegment(false)) {
+                    return;
+                }
+                if (!segmentWriter->append(chunk)) {
+                    qWarning() << "日志记录超过段大小，已丢弃:" << chunk.size();
+                }
+            }
+        }
+    }
+}
+
+// 调用方持有 logMutex
+bool LogManager::openSegmentWriter(bool binary)
+{
+    if (segmentWriter && segmentWriterBinary == binary) {
+        return true;
+    }
+    closeSegmentWriter();
+    
+    const QFileInfo fileInfo(logFilename);
+    auto writer = std::make_unique<LogSegmentWriter>(fileInfo.path(), fileInfo.baseName(),
+                                                     binary ? QStringLiteral("blog") : fileInfo.suffix(),
+                                                     System::LOG_SEGMENT_SIZE, maxLogFiles,
+                                                     System::LOG_COMPRESS_SEALED_SEGMENTS, binary);
+    if (!writer->open()) {
+        qCritical() << "无法打开日志段:" << fileInfo.path();
+        return false;
+    }
+    segmentWriter = std::move(writer);
+    segmentWriterBinary = binary;
+    
+    if (binary) {
+        QByteArray header = BinaryLogWriter::fileMagic();
+        binaryWriter->beginSession(header, wallAnchorNs, steadyAnchorNs);
+        segmentWriter->append(header);
+    }
+    return true;
+}
+
+// 调用方持有 logMutex
+bool LogManager::rotateSegment(bool binary)
+{
+    if (!segmentWriter->rotate()) {
+        qCritical() << "日志段切换失败，本批日志未写入";
+        return false;
+    }
+    if (binary) {
+        QByteArray header = BinaryLogWriter::fileMagic();
+        binaryWriter->beginSession(header, wallAnchorNs, steadyAnchorNs);
+        segmentWriter->append(header);
+    }
+    return true;
+}
+
+// 调用方持有 logMutex；等待后台线程封存最后一段
+void LogManager::closeSegmentWriter()
+{
+    if (segmentWriter) {
+        segmentWriter->close();
+        segmentWriter.reset();
+    }
+}
+
 void LogManager::writeToConsole(const LogEntry& entry)
 {
     QString formattedEntry = formatLogEntry(entry);
@@ -434,28 +1191,25 @@ void LogManager::writeToConsole(const LogEntry& entry)
 
 QString LogManager::formatLogEntry(const LogEntry& entry) const
 {
-    QString levelStr = logLevelToString(entry.level);
-    QString timestamp = entry.timestamp.toString("yyyy-MM-dd hh:mm:ss.zzz");
-    
-    QString formatted = QString("[%1] [%2] [%3] %4")
-                        .arg(timestamp, levelStr, entry.category, entry.message);
-    
-    if (!entry.file.isEmpty() && entry.line > 0) {
-        QString fileName = QFileInfo(entry.file).baseName();
-        formatted += QString(" (%1:%2)").arg(fileName).arg(entry.line);
-    }
-    
-    return formatted;
+    return LogFormatting::formatEntry(entry);
 }
 
-QString LogManager::logLevelToString(LogLevel level) const
+LogEntry LogManager::toLogEntry(const LogRecord& record) const
 {
-    switch (level) {
-        case LogLevel::Debug:    return "DEBUG";
-        case LogLevel::Info:     return "INFO";
-        case LogLevel::Warning:  return "WARN";
-        case LogLevel::Error:    return "ERROR";
-        case LogLevel::Critical: return "CRITICAL";
-        default:                 return "UNKNOWN";
-    }
-}
\ No newline at end of file
+    LogEntry entry;
+    entry.timestamp = QDateTime::fromMSecsSinceEpoch(toWallMSecs(record.timestampNs));
+    entry.level = record.level;
+    entry.category = record.category;
+    entry.message = LogFormatting::formatMessage(record);
+    entry.file = record.file;
+    entry.line = record.line;
+    entry.function = record.function.isEmpty() && record.sourceFunction
+        ? QString::fromUtf8(record.sourceFunction)
+        : record.function;
+    return entry;
+}
+
+qint64 LogManager::toWallMSecs(qint64 timestampNs) const
+{
+    return (wallAnchorNs + (timestampNs - steadyAnchorNs)) / 1000000;
+}
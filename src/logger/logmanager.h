@@ -6,24 +6,62 @@
 #include <QDateTime>
 #include <QMutex>
 #include <QTimer>
-#include <QQueue>
-
-enum class LogLevel {
-    Debug = 0,
-    Info = 1,
-    Warning = 2,
-    Error = 3,
-    Critical = 4
+#include <QWaitCondition>
+#include <QAtomicPointer>
+#include <QHash>
+#include "logrecord.h"
+#include "logrecordstore.h"
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+class QThread;
+class BinaryLogWriter;
+class LogSegmentWriter;
+struct LogThreadBuffer;
+struct CommunicationTraceState;
+
+// 线程日志缓冲区写满时的处理方式
+enum class LogOverflowPolicy {
+    DropAndCount = 0,   // 丢弃并计数，写入线程随后记录一条丢弃告警（默认，通讯线程不会被日志拖慢）
+    Block = 1           // 等待写入线程腾出空间，不丢日志
+};
+
+// 日志文件格式
+enum class LogFileFormat {
+    Text = 0,           // 写入时格式化为文本行（默认）
+    Binary = 1          // 写入紧凑的二进制记录，查看、导出或离线解码时才格式化
+};
+
+// 日志文件存储方式
+enum class LogStorage {
+    File = 0,           // 追加写入单个文件，定时检查大小后轮转（默认）
+    MappedSegments = 1  // 写入预分配的内存映射段，段满时切换到已准备好的下一段，封存和清理在后台线程
+};
+
+// 通讯日志采样方式（按端口设置）
+enum class CommunicationSampling {
+    All = 0,                // 每次收发都记录（默认）
+    OneInN = 1,             // 每 N 次记录一次
+    FirstNPerSecond = 2,    // 每秒只记录前 N 次，其余计数后在下一秒汇总
+    TriggerOnError = 3      // 平时只在内存中保留最近 K 次，出错时连同之后若干次一起写出
 };
 
-struct LogEntry {
-    QDateTime timestamp;
-    LogLevel level;
-    QString category;
-    QString message;
-    QString file;
-    int line;
-    QString function;
+struct CommunicationTraceConfig {
+    CommunicationSampling mode = CommunicationSampling::All;
+    int rate = 1;                   // OneInN / FirstNPerSecond 的 N
+    int preTriggerFrames = 32;      // TriggerOnError 保留的触发前记录数 K
+    int postTriggerFrames = 32;     // TriggerOnError 触发后继续完整记录的次数
+};
+
+// 内存日志查询条件
+struct LogQuery {
+    QDateTime startTime;            // 无效表示不限
+    QDateTime endTime;
+    LogLevel minLevel = LogLevel::Debug;
+    QStringList categories;         // 为空表示全部分类
+    int limit = 1000;               // 只返回最新的 limit 条，0 表示不限
 };
 
 class LogManager : public QObject
@@ -43,9 +81,30 @@ public:
     void error(const QString& message, const QString& category = "App");
     void critical(const QString& message, const QString& category = "App");
     
-    // 通讯日志
+    // 级别是否开启：不查找单例，供 LOG_* 宏在构造消息之前判断
+    static bool isLevelEnabled(LogLevel level)
+    {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+    // LOG_* 宏使用：file 为字面量构造的字符串，function 必须具有静态存储期
+    void logAt(LogLevel level, const QString& category, const QString& message,
+               const QString& file, int line, const char* function);
+    
+    // 延迟格式化：只保存格式串和原始参数，format 必须是字符串字面量，使用 %1..%n 占位
+    void logDeferred(LogLevel level, const QString& category, const char* format,
+                     std::initializer_list<LogArgument> arguments = {});
+    
+    // 通讯日志（原始字节随记录保存，十六进制在查看或写入文本文件时生成）
     void logCommunication(const QString& direction, const QByteArray& data, const QString& port = QString());
     
+    // 通讯日志采样；port 为空时设置未单独配置的端口使用的默认方式
+    void setCommunicationSampling(const QString& port, const CommunicationTraceConfig& config);
+    void clearCommunicationSampling(const QString& port);
+    CommunicationTraceConfig getCommunicationSampling(const QString& port) const;
+    // 通讯出错（如校验错误）时调用：TriggerOnError 端口写出触发前缓存的记录并开始完整记录
+    void triggerCommunicationTrace(const QString& port, const QString& reason);
+    quint64 getSuppressedCommunicationCount(const QString& port) const;  // 采样跳过的记录数
+    
     // 设置日志级别
     void setLogLevel(LogLevel level);
     LogLevel getLogLevel() const;
@@ -56,12 +115,32 @@ public:
     // 启用/禁用控制台输出
     void setConsoleOutput(bool enabled);
     
+    // 日志文件格式；二进制日志与文本日志同名，扩展名为 .blog
+    void setLogFormat(LogFileFormat format);
+    LogFileFormat getLogFormat() const;
+    QString getBinaryLogFile() const;
+    
+    // 日志文件存储方式；段文件与日志文件同目录，命名为 <base>.<序号>.<扩展名>
+    void setLogStorage(LogStorage storage);
+    LogStorage getLogStorage() const;
+    
     // 日志文件管理
     void rotateLogFile();
     void cleanupOldLogFiles();
     
+    // 线程缓冲区写满时的处理方式
+    void setOverflowPolicy(LogOverflowPolicy policy);
+    LogOverflowPolicy getOverflowPolicy() const;
+    quint64 getDroppedCount() const;        // 累计丢弃的日志条数
+    
+    // 等待写入线程把调用前记录的日志全部写出
+    void flush();
+    
     // 获取日志条目
     QList<LogEntry> getLogEntries(int count = 1000) const;
+    // 按时间范围、级别和分类查询，只格式化命中的条目
+    QList<LogEntry> queryLogEntries(const LogQuery& query) const;
+    QStringList getLogCategories() const;
     
     // 导出日志
     bool exportLogs(const QString& filename, const QDateTime& startTime = QDateTime(), 
@@ -71,46 +150,138 @@ signals:
     void newLogEntry(const LogEntry& entry);
 
 private slots:
-    void processLogQueue();
     void checkFileSize();
 
 private:
     explicit LogManager(QObject* parent = nullptr);
     ~LogManager();
     
-    void writeToFile(const LogEntry& entry);
+    // 每个线程首次记录日志时注册自己的缓冲区，之后记录只写本线程缓冲区，不加锁
+    LogThreadBuffer* threadBuffer();
+    void wakeWriter();
+    void writerLoop();
+    void processLogQueue();                 // 写入线程：取出所有线程缓冲区中的记录并写出
+    void submitRecord(LogRecord&& record);
+    void updateSamplingEnabled();
+    CommunicationTraceState& traceState(const QString& port);
+    
+    void writeToFile(const QList<LogEntry>& entries);
+    void writeToBinaryFile(const std::vector<LogRecord>& records);
+    bool openBinaryLogFile();
+    void closeBinaryLogFile();
+    void rotateBinaryLogFile();
+    void writeToSegments(const std::vector<LogRecord>& records, const QList<LogEntry>& entries, bool binary);
+    bool openSegmentWriter(bool binary);
+    bool rotateSegment(bool binary);
+    void closeSegmentWriter();
     void writeToConsole(const LogEntry& entry);
     QString formatLogEntry(const LogEntry& entry) const;
-    QString logLevelToString(LogLevel level) const;
+    LogEntry toLogEntry(const LogRecord& record) const;
+    qint64 toWallMSecs(qint64 timestampNs) const;
+    LogRecordStore::Filter makeFilter(const QDateTime& startTime, const QDateTime& endTime,
+                                      LogLevel minLevel, const QStringList& categories) const;
+    // 在锁内只拷贝命中的记录（隐式共享），格式化和I/O在锁外进行
+    std::vector<LogRecord> collectRecords(const LogRecordStore::Filter& filter, int limit) const;
     
-    static LogManager* instance;
+    static QAtomicPointer<LogManager> instance;
     static QMutex mutex;
     
-    LogLevel currentLogLevel;
+    static std::atomic<int> minimumLevel;   // 当前日志级别；管理器创建前为 Debug
     QFile* logFile;
     QTextStream* logStream;
     QString logFilename;
     bool consoleOutputEnabled;
     
-    mutable QMutex logMutex;
-    QQueue<LogEntry> logQueue;
-    QTimer* processTimer;
+    // 二进制日志：时间戳取单调时钟，按 MonotonicClock 的锚点换算为系统时间
+    std::atomic<int> fileFormat;
+    QFile* binaryLogFile;
+    std::unique_ptr<BinaryLogWriter> binaryWriter;
+    qint64 wallAnchorNs;
+    qint64 steadyAnchorNs;
+    
+    // 内存映射日志段，在写入线程中按需创建
+    std::atomic<int> storageMode;
+    std::unique_ptr<LogSegmentWriter> segmentWriter;
+    bool segmentWriterBinary;
+    
+    mutable QMutex logMutex;                // 保护日志文件和内存记录
     QTimer* fileSizeTimer;
     
+    // 线程缓冲区和写入线程
+    QMutex buffersMutex;                    // 仅在注册线程和写入线程遍历时持有
+    std::vector<std::shared_ptr<LogThreadBuffer>> threadBuffers;
+    QThread* writerThread;
+    QMutex writerMutex;
+    QWaitCondition writerCondition;         // 唤醒写入线程
+    QWaitCondition drainedCondition;        // 写入线程完成一轮写出
+    std::atomic<bool> writerStopping;
+    std::atomic<bool> wakePending;
+    std::atomic<int> overflowPolicy;
+    std::atomic<quint64> droppedTotal;
+    quint64 drainRound;
+    
     qint64 maxFileSize;
     int maxLogFiles;
     
-    // 内存中的日志条目（用于界面显示）
-    QList<LogEntry> logEntries;
+    // 通讯日志采样：未配置任何采样时 logCommunication 不进入互斥锁
+    mutable QMutex samplingMutex;
+    CommunicationTraceConfig defaultTraceConfig;
+    QHash<QString, std::shared_ptr<CommunicationTraceState>> traceStates;
+    std::atomic<bool> samplingEnabled;
+    
+    // 内存中的原始日志记录（用于界面显示、查询和导出，读取时才格式化）
     int maxMemoryEntries;
+    LogRecordStore logStore;
 };
 
 // 便捷宏定义
-#define LOG_DEBUG(msg) LogManager::getInstance()->debug(msg, __FILE__)
-#define LOG_INFO(msg) LogManager::getInstance()->info(msg, __FILE__)
-#define LOG_WARNING(msg) LogManager::getInstance()->warning(msg, __FILE__)
-#define LOG_ERROR(msg) LogManager::getInstance()->error(msg, __FILE__)
-#define LOG_CRITICAL(msg) LogManager::getInstance()->critical(msg, __FILE__)
+//
+// LOG_INFO("Category", QString("...").arg(x)) 在级别未开启时不计算消息表达式、不查找单例；
+// 分类必须是字符串字面量，文件、行号和函数名自动记录。
+// LOG_COMPILE_MIN_LEVEL（LogLevel 数值，由构建系统定义）以下的宏在编译期整体移除。
+#ifndef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL 0
+#endif
+
+#define LOG_AT_LEVEL(level, category, message) \
+    do { \
+        if (LogManager::isLevelEnabled(level)) { \
+            LogManager::getInstance()->logAt(level, QStringLiteral(category), (message), \
+                                             QStringLiteral(__FILE__), __LINE__, Q_FUNC_INFO); \
+        } \
+    } while (0)
+
+#define LOG_DISABLED(category, message) do { } while (0)
+
+#if LOG_COMPILE_MIN_LEVEL <= 0
+#define LOG_DEBUG(category, message) LOG_AT_LEVEL(LogLevel::Debug, category, message)
+#else
+#define LOG_DEBUG(category, message) LOG_DISABLED(category, message)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 1
+#define LOG_INFO(category, message) LOG_AT_LEVEL(LogLevel::Info, category, message)
+#else
+#define LOG_INFO(category, message) LOG_DISABLED(category, message)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 2
+#define LOG_WARNING(category, message) LOG_AT_LEVEL(LogLevel::Warning, category, message)
+#else
+#define LOG_WARNING(category, message) LOG_DISABLED(category, message)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 3
+#define LOG_ERROR(category, message) LOG_AT_LEVEL(LogLevel::Error, category, message)
+#else
+#define LOG_ERROR(category, message) LOG_DISABLED(category, message)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 4
+#define LOG_CRITICAL(category, message) LOG_AT_LEVEL(LogLevel::Critical, category, message)
+#else
+#define LOG_CRITICAL(category, message) LOG_DISABLED(category, message)
+#endif
 
 #define LOG_COMM_TX(data, port) LogManager::getInstance()->logCommunication("TX", data, port)
 #define LOG_COMM_RX(data, port) LogManager::getInstance()->logCommunication("RX", data, port) 
\ No newline at end of file
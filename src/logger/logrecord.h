@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QDateTime>
+#include <QMetaType>
+#include <QString>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3,
+    Critical = 4
+};
+
+// 格式化后的日志条目（界面显示、导出和文本日志使用）
+struct LogEntry {
+    QDateTime timestamp;
+    LogLevel level;
+    QString category;
+    QString message;
+    QString file;
+    int line;
+    QString function;
+};
+
+Q_DECLARE_METATYPE(LogEntry)
+
+// 延迟格式化的日志参数：保存原始值，查看或导出时才替换到格式串的 %1..%n
+struct LogArgument {
+    enum class Type : quint8 {
+        Int = 1,
+        Double = 2,
+        String = 3
+    };
+
+    Type type = Type::Int;
+    qint64 intValue = 0;
+    double doubleValue = 0.0;
+    QString stringValue;
+
+    LogArgument() = default;
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    LogArgument(T value) : type(Type::Int), intValue(static_cast<qint64>(value)) {}
+    LogArgument(double value) : type(Type::Double), doubleValue(value) {}
+    LogArgument(const QString& value) : type(Type::String), stringValue(value) {}
+    LogArgument(const char* value) : type(Type::String), stringValue(QString::fromUtf8(value)) {}
+
+    QString toString() const {
+        switch (type) {
+        case Type::Int:    return QString::number(intValue);
+        case Type::Double: return QString::number(doubleValue);
+        default:           return stringValue;
+        }
+    }
+};
+
+// 原始日志记录：只保存记录时的原始字段，格式化推迟到写入线程、查看或导出时
+struct LogRecord {
+    qint64 timestampNs = 0;             // 单调时钟（纳秒），按会话锚点换算为系统时间
+    LogLevel level = LogLevel::Info;
+    QString category;
+    const char* format = nullptr;       // 延迟格式化的格式串，必须具有静态存储期（字符串字面量）
+    QString message;                    // 已格式化的消息（format 为空时使用）
+    std::vector<LogArgument> arguments;
+    QByteArray payload;                 // 原始负载（通讯数据），格式化时追加为十六进制
+    QString file;
+    int line = 0;
+    QString function;
+    const char* sourceFunction = nullptr;   // 日志宏记录的函数名（静态存储期），function 为空时使用
+};
@@ -0,0 +1,165 @@
+#include "logrecordstore.h"
+#include <QtAlgorithms>
+
+namespace {
+constexpr quint64 BLOCK_SIZE = 64;
+constexpr quint8 OVERFLOW_CATEGORY = 63;
+}
+
+LogRecordStore::LogRecordStore(int capacity)
+    : m_head(0)
+{
+    // 多留一块：复用最旧的块时仍至少保留 capacity 条
+    m_blockCount = (static_cast<quint64>(qMax(1, capacity)) - 1 + BLOCK_SIZE - 1) / BLOCK_SIZE + 1;
+    m_slots.resize(m_blockCount * BLOCK_SIZE);
+    m_categoryIds.resize(m_slots.size());
+    m_blocks.resize(m_blockCount);
+}
+
+void LogRecordStore::append(LogRecord&& record)
+{
+    const quint64 sequence = m_head++;
+    BlockSummary& block = m_blocks[(sequence / BLOCK_SIZE) % m_blockCount];
+    if (sequence % BLOCK_SIZE == 0) {
+        block = BlockSummary();     // 整块复用，旧记录整体淘汰
+    }
+
+    const quint8 categoryId = internCategory(record.category);
+    if (block.count == 0) {
+        block.minTimestampNs = record.timestampNs;
+        block.maxTimestampNs = record.timestampNs;
+    } else {
+        block.minTimestampNs = qMin(block.minTimestampNs, record.timestampNs);
+        block.maxTimestampNs = qMax(block.maxTimestampNs, record.timestampNs);
+    }
+    block.levelMask |= 1u << static_cast<int>(record.level);
+    block.categoryMask |= quint64(1) << categoryId;
+    ++block.count;
+
+    const size_t slot = static_cast<size_t>(sequence % m_slots.size());
+    m_categoryIds[slot] = categoryId;
+    m_slots[slot] = std::move(record);
+}
+
+int LogRecordStore::visit(const Filter& filter, int limit, const Visitor& visitor) const
+{
+    const quint64 first = firstSequence();
+    if (m_head == first) {
+        return 0;
+    }
+
+    const quint64 categoryMask = categoryMaskFor(filter.categories);
+    if (categoryMask == 0) {
+        return 0;
+    }
+
+    // 从最新的块向前扫描，收集命中的序号后再按写入顺序访问
+    std::vector<quint64> hits;
+    bool full = false;
+    quint64 blockStart = (m_head - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    for (;;) {
+        const BlockSummary& block = m_blocks[(blockStart / BLOCK_SIZE) % m_blockCount];
+        if (block.count > 0
+            && block.maxTimestampNs >= filter.startNs && block.minTimestampNs <= filter.endNs
+            && (block.levelMask & filter.levelMask) != 0
+            && (block.categoryMask & categoryMask) != 0) {
+            const quint64 end = qMin(blockStart + BLOCK_SIZE, m_head);
+            for (quint64 sequence = end; sequence-- > blockStart;) {
+                if (matches(sequence, filter, categoryMask)) {
+                    hits.push_back(sequence);
+                    if (limit > 0 && hits.size() >= static_cast<size_t>(limit)) {
+                        full = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (full || blockStart <= first) {
+            break;
+        }
+        blockStart -= BLOCK_SIZE;
+    }
+
+    for (auto it = hits.rbegin(); it != hits.rend(); ++it) {
+        visitor(m_slots[static_cast<size_t>(*it % m_slots.size())]);
+    }
+    return static_cast<int>(hits.size());
+}
+
+int LogRecordStore::size() const
+{
+    return static_cast<int>(m_head - firstSequence());
+}
+
+QStringList LogRecordStore::categories() const
+{
+    QStringList names = m_categoryNames.keys();
+    names.sort();
+    return names;
+}
+
+quint32 LogRecordStore::levelMaskFrom(LogLevel minLevel)
+{
+    return ~0u << static_cast<int>(minLevel);
+}
+
+quint64 LogRecordStore::firstSequence() const
+{
+    if (m_head == 0) {
+        return 0;
+    }
+    const quint64 currentBlockStart = (m_head - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    const quint64 retained = (m_blockCount - 1) * BLOCK_SIZE;
+    return currentBlockStart >= retained ? currentBlockStart - retained : 0;
+}
+
+quint8 LogRecordStore::internCategory(const QString& category)
+{
+    auto it = m_categoryNames.constFind(category);
+    if (it != m_categoryNames.constEnd()) {
+        return it.value();
+    }
+    if (m_categoryNames.size() >= OVERFLOW_CATEGORY) {
+        return OVERFLOW_CATEGORY;
+    }
+    const quint8 id = static_cast<quint8>(m_categoryNames.size());
+    m_categoryNames.insert(category, id);
+    return id;
+}
+
+quint64 LogRecordStore::categoryMaskFor(const QStringList& categories) const
+{
+    if (categories.isEmpty()) {
+        return ~quint64(0);
+    }
+    quint64 mask = 0;
+    for (const QString& category : categories) {
+        auto it = m_categoryNames.constFind(category);
+        if (it != m_categoryNames.constEnd()) {
+            mask |= quint64(1) << it.value();
+        } else if (m_categoryNames.size() >= OVERFLOW_CATEGORY) {
+            mask |= quint64(1) << OVERFLOW_CATEGORY;
+        }
+    }
+    return mask;
+}
+
+bool LogRecordStore::matches(quint64 sequence, const Filter& filter, quint64 categoryMask) const
+{
+    const size_t slot = static_cast<size_t>(sequence % m_slots.size());
+    const LogRecord& record = m_slots[slot];
+    if (record.timestampNs < filter.startNs || record.timestampNs > filter.endNs) {
+        return false;
+    }
+    if ((filter.levelMask & (1u << static_cast<int>(record.level))) == 0) {
+        return false;
+    }
+    if (filter.categories.isEmpty()) {
+        return true;
+    }
+    const quint8 categoryId = m_categoryIds[slot];
+    if (categoryId == OVERFLOW_CATEGORY) {
+        return filter.categories.contains(record.category);
+    }
+    return (categoryMask & (quint64(1) << categoryId)) != 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "logrecord.h"
+#include <QHash>
+#include <QStringList>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// 定长环形日志存储（界面显示、查询和导出使用）
+//
+// 记录按写入顺序放在环形槽位中，每 64 条为一块，块摘要记录时间范围、级别位图和分类位图。
+// 查询先按块摘要跳过整块，只检查可能命中的块，不拷贝整个列表。
+// 复用一个块时整块淘汰，写满后保留的条数不少于 capacity、不超过 capacity + 127。
+// 分类在首次出现时编号，前 63 个分类各占一位，其余分类共用溢出位并按名称比较。
+//
+// 非线程安全，由调用方加锁
+class LogRecordStore
+{
+public:
+    struct Filter {
+        qint64 startNs = std::numeric_limits<qint64>::min();   // 单调时钟时间戳范围（含两端）
+        qint64 endNs = std::numeric_limits<qint64>::max();
+        quint32 levelMask = ~0u;                                // 第 n 位对应 LogLevel 值 n
+        QStringList categories;                                 // 为空表示全部分类
+    };
+    using Visitor = std::function<void(const LogRecord& record)>;
+
+    explicit LogRecordStore(int capacity);
+
+    void append(LogRecord&& record);
+
+    // 按写入顺序访问满足条件的记录；limit > 0 时只访问最新的 limit 条。返回访问的条数
+    int visit(const Filter& filter, int limit, const Visitor& visitor) const;
+
+    int size() const;
+    QStringList categories() const;
+    static quint32 levelMaskFrom(LogLevel minLevel);
+
+private:
+    struct BlockSummary {
+        qint64 minTimestampNs = 0;
+        qint64 maxTimestampNs = 0;
+        quint32 levelMask = 0;
+        quint64 categoryMask = 0;
+        int count = 0;
+    };
+
+    quint64 firstSequence() const;
+    quint8 internCategory(const QString& category);
+    quint64 categoryMaskFor(const QStringList& categories) const;
+    bool matches(quint64 sequence, const Filter& filter, quint64 categoryMask) const;
+
+    std::vector<LogRecord> m_slots;
+    std::vector<quint8> m_categoryIds;      // 与槽位一一对应
+    std::vector<BlockSummary> m_blocks;
+    quint64 m_blockCount;
+    quint64 m_head;                         // 下一条记录的序号
+    QHash<QString, quint8> m_categoryNames;
+};
@@ -0,0 +1,347 @@
+#include "logsegmentwriter.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr int SEQUENCE_DIGITS = 6;
+constexpr qint64 PAGE_SIZE = 4096;
+constexpr int MIN_SEGMENTS = 3;     // 当前段、预先准备的下一段和至少一个已封存的段
+const QString COMPRESSED_SUFFIX = QStringLiteral(".qz");
+}
+
+LogSegmentWriter::LogSegmentWriter(const QString& directory, const QString& baseName, const QString& suffix,
+                                   qint64 segmentSize, int maxSegments, bool compressSealed, bool binaryContent)
+    : m_directory(directory)
+    , m_baseName(baseName)
+    , m_suffix(suffix)
+    , m_segmentSize(qMax<qint64>(PAGE_SIZE, segmentSize))
+    , m_maxSegments(qMax(MIN_SEGMENTS, maxSegments))
+    , m_compressSealed(compressSealed)
+    , m_binaryContent(binaryContent)
+    , m_thread(nullptr)
+    , m_prepareSequence(0)
+    , m_prepareRequested(false)
+    , m_recoverBefore(0)
+    , m_stopping(false)
+{
+}
+
+LogSegmentWriter::~LogSegmentWriter()
+{
+    close();
+}
+
+bool LogSegmentWriter::open()
+{
+    if (m_thread) {
+        return isOpen();
+    }
+
+    QDir().mkpath(m_directory);
+    const QList<QPair<quint64, QString>> existing = listSegments();
+    const quint64 first = existing.isEmpty() ? 1 : existing.last().first + 1;
+
+    m_current = prepareSegment(first);
+    if (!m_current) {
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_prepareSequence = first + 1;
+        m_prepareRequested = true;
+        m_recoverBefore = existing.isEmpty() ? 0 : first;
+        m_stopping = false;
+    }
+
+    m_thread = QThread::create([this]() { maintenanceLoop(); });
+    m_thread->setObjectName("LogSegmentMaintenance");
+    m_thread->start(QThread::LowestPriority);
+    return true;
+}
+
+bool LogSegmentWriter::append(const char* data, qsizetype size)
+{
+    if (!m_current || m_current->used + size > m_segmentSize) {
+        return false;
+    }
+    std::memcpy(m_current->data + m_current->used, data, static_cast<size_t>(size));
+    m_current->used += size;
+    return true;
+}
+
+bool LogSegmentWriter::rotate()
+{
+    if (!m_thread) {
+        return false;
+    }
+
+    std::unique_ptr<Segment> next;
+    quint64 sequence = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_current) {
+            m_sealQueue.push_back(std::move(m_current));
+        }
+        // 只有写入速度超过后台准备速度时才会在这里等待
+        while (m_prepareRequested && !m_prepared) {
+            m_preparedCondition.wait(&m_mutex);
+        }
+        next = std::move(m_prepared);
+        sequence = m_prepareSequence;
+        m_condition.wakeOne();
+    }
+
+    if (!next) {
+        // 后台准备失败（例如磁盘已满），在本线程重试一次
+        next = prepareSegment(sequence);
+        if (!next) {
+            return false;
+        }
+    }
+    m_current = std::move(next);
+
+    QMutexLocker locker(&m_mutex);
+    m_prepareSequence = m_current->sequence + 1;
+    m_prepareRequested = true;
+    m_condition.wakeOne();
+    return true;
+}
+
+void LogSegmentWriter::close()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_current) {
+            m_sealQueue.push_back(std::move(m_current));
+        }
+        m_stopping = true;
+        m_condition.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    // 预先准备但没有用到的段
+    if (m_prepared) {
+        discardSegment(std::move(m_prepared));
+    }
+}
+
+bool LogSegmentWriter::isOpen() const
+{
+    return m_current != nullptr;
+}
+
+qint64 LogSegmentWriter::segmentSize() const
+{
+    return m_segmentSize;
+}
+
+QString LogSegmentWriter::currentFile() const
+{
+    return m_current ? m_current->file->fileName() : QString();
+}
+
+std::unique_ptr<LogSegmentWriter::Segment> LogSegmentWriter::prepareSegment(quint64 sequence) const
+{
+    auto segment = std::make_unique<Segment>();
+    segment->sequence = sequence;
+    segment->file = std::make_unique<QFile>(segmentPath(sequence));
+
+    if (!segment->file->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qWarning() << "无法创建日志段:" << segment->file->fileName() << segment->file->errorString();
+        return nullptr;
+    }
+    if (!segment->file->resize(m_segmentSize)) {
+        qWarning() << "无法预分配日志段:" << segment->file->fileName() << segment->file->errorString();
+        segment->file->close();
+        segment->file->remove();
+        return nullptr;
+    }
+    segment->data = segment->file->map(0, m_segmentSize);
+    if (!segment->data) {
+        qWarning() << "无法映射日志段:" << segment->file->fileName() << segment->file->errorString();
+        segment->file->close();
+        segment->file->remove();
+        return nullptr;
+    }
+
+    // 逐页写一次，数据块在准备段的线程中分配，写入线程首次写入时不再触发缺页分配
+    for (qint64 offset = 0; offset < m_segmentSize; offset += PAGE_SIZE) {
+        segment->data[offset] = 0;
+    }
+    return segment;
+}
+
+void LogSegmentWriter::discardSegment(std::unique_ptr<Segment> segment) const
+{
+    segment->file->unmap(segment->data);
+    segment->file->close();
+    segment->file->remove();
+}
+
+void LogSegmentWriter::sealSegment(std::unique_ptr<Segment> segment) const
+{
+    const QString path = segment->file->fileName();
+    segment->file->unmap(segment->data);
+    segment->file->resize(segment->used);
+    segment->file->close();
+    segment.reset();
+
+    if (QFileInfo(path).size() == 0) {
+        QFile::remove(path);
+        return;
+    }
+    if (m_compressSealed) {
+        compressFile(path);
+    }
+}
+
+void LogSegmentWriter::compressFile(const QString& path) const
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QByteArray compressed = qCompress(input.readAll());
+    input.close();
+
+    QSaveFile output(path + COMPRESSED_SUFFIX);
+    if (!output.open(QIODevice::WriteOnly) || output.write(compressed) != compressed.size() || !output.commit()) {
+        qWarning() << "压缩日志段失败:" << path << output.errorString();
+        return;
+    }
+    QFile::remove(path);
+}
+
+void LogSegmentWriter::recoverSegments(quint64 beforeSequence) const
+{
+    for (const auto& item : listSegments()) {
+        if (item.first >= beforeSequence) {
+            break;
+        }
+        const QString& path = item.second;
+        if (path.endsWith(COMPRESSED_SUFFIX)) {
+            continue;
+        }
+
+        // 大小等于段大小说明上次没有正常封存，按内容找出实际长度
+        QFile file(path);
+        if (file.size() == m_segmentSize && file.open(QIODevice::ReadWrite)) {
+            qint64 used = m_segmentSize;
+            uchar* data = file.map(0, m_segmentSize);
+            if (data) {
+                if (data[0] == 0) {
+                    used = 0;
+                } else if (!m_binaryContent) {
+                    while (used > 0 && data[used - 1] == 0) {
+                        --used;
+                    }
+                }
+                file.unmap(data);
+            }
+            file.resize(used);
+            file.close();
+            if (used == 0) {
+                QFile::remove(path);
+                continue;
+            }
+        }
+
+        if (m_compressSealed) {
+            compressFile(path);
+        }
+    }
+}
+
+void LogSegmentWriter::cleanup() const
+{
+    const QList<QPair<quint64, QString>> segments = listSegments();
+    for (qsizetype i = 0; i + m_maxSegments < segments.size(); ++i) {
+        QFile::remove(segments.at(i).second);
+    }
+}
+
+void LogSegmentWriter::maintenanceLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        // 准备下一段优先：写入线程可能正在等待
+        if (m_prepareRequested && !m_prepared && !m_stopping) {
+            const quint64 sequence = m_prepareSequence;
+            locker.unlock();
+            std::unique_ptr<Segment> segment = prepareSegment(sequence);
+            locker.relock();
+            m_prepared = std::move(segment);
+            m_prepareRequested = false;
+            m_preparedCondition.wakeAll();
+            continue;
+        }
+
+        if (!m_sealQueue.empty()) {
+            std::unique_ptr<Segment> segment = std::move(m_sealQueue.front());
+            m_sealQueue.pop_front();
+            locker.unlock();
+            sealSegment(std::move(segment));
+            cleanup();
+            locker.relock();
+            continue;
+        }
+
+        if (m_recoverBefore > 0) {
+            const quint64 before = m_recoverBefore;
+            m_recoverBefore = 0;
+            locker.unlock();
+            recoverSegments(before);
+            cleanup();
+            locker.relock();
+            continue;
+        }
+
+        if (m_stopping) {
+            break;
+        }
+        m_condition.wait(&m_mutex);
+    }
+}
+
+QString LogSegmentWriter::segmentPath(quint64 sequence) const
+{
+    return QString("%1/%2.%3.%4").arg(m_directory, m_baseName)
+        .arg(sequence, SEQUENCE_DIGITS, 10, QChar('0'))
+        .arg(m_suffix);
+}
+
+QList<QPair<quint64, QString>> LogSegmentWriter::listSegments() const
+{
+    // 文本日志轮转产生的 <base>.<n>.<suffix> 序号不足6位，不会被当作段文件
+    const QRegularExpression pattern(
+        QString("^%1\\.(\\d{%2,})\\.%3(%4)?$")
+            .arg(QRegularExpression::escape(m_baseName))
+            .arg(SEQUENCE_DIGITS)
+            .arg(QRegularExpression::escape(m_suffix), QRegularExpression::escape(COMPRESSED_SUFFIX)));
+
+    QList<QPair<quint64, QString>> segments;
+    const QDir dir(m_directory);
+    const QStringList names = dir.entryList(QDir::Files);
+    for (const QString& name : names) {
+        const QRegularExpressionMatch match = pattern.match(name);
+        if (match.hasMatch()) {
+            segments.append(qMakePair(match.captured(1).toULongLong(), dir.filePath(name)));
+        }
+    }
+    std::sort(segments.begin(), segments.end(),
+              [](const QPair<quint64, QString>& a, const QPair<quint64, QString>& b) { return a.first < b.first; });
+    return segments;
+}
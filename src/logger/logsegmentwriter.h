@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+
+class QThread;
+
+// 预分配、内存映射的日志段文件
+//
+// 每个段按固定大小预先分配并映射到内存，写入只是一次内存拷贝，不经过文件流和系统调用。
+// 当前段写满时切换到后台线程已经准备好的下一段；写满的段交给后台线程截断到实际长度、
+// 按需压缩为 <段文件名>.qz（qCompress 格式），并删除超出数量的旧段。
+// 后台线程以最低优先级运行，慢速存储上的分配、截断和压缩都不阻塞写入线程。
+//
+// 段文件命名为 <base>.<6位序号>.<suffix>，序号在重启后接着目录中已有的最大序号递增。
+// 进程异常退出时最后一段保留预分配的零字节，下次启动时由后台线程封存
+// （文本段去掉末尾的零字节；二进制段保留原样，解码器把零字节视为结束）。
+//
+// append/rotate/close 只允许在同一个线程调用
+class LogSegmentWriter
+{
+public:
+    // maxSegments 包括当前段和预先准备的下一段；binaryContent 为 true 时恢复遗留段不截断末尾零字节
+    LogSegmentWriter(const QString& directory, const QString& baseName, const QString& suffix,
+                     qint64 segmentSize, int maxSegments, bool compressSealed, bool binaryContent = false);
+    ~LogSegmentWriter();
+
+    LogSegmentWriter(const LogSegmentWriter&) = delete;
+    LogSegmentWriter& operator=(const LogSegmentWriter&) = delete;
+
+    bool open();
+    // 当前段剩余空间不足时返回 false，调用方 rotate() 后重新写入
+    bool append(const char* data, qsizetype size);
+    bool append(const QByteArray& data) { return append(data.constData(), data.size()); }
+    // 切换到下一段，写满的段交给后台线程封存
+    bool rotate();
+    // 封存当前段并等待后台线程完成
+    void close();
+
+    bool isOpen() const;
+    qint64 segmentSize() const;
+    QString currentFile() const;
+
+private:
+    struct Segment {
+        std::unique_ptr<QFile> file;
+        uchar* data = nullptr;
+        qint64 used = 0;
+        quint64 sequence = 0;
+    };
+
+    std::unique_ptr<Segment> prepareSegment(quint64 sequence) const;
+    void discardSegment(std::unique_ptr<Segment> segment) const;
+    void sealSegment(std::unique_ptr<Segment> segment) const;
+    void compressFile(const QString& path) const;
+    void recoverSegments(quint64 beforeSequence) const;
+    void cleanup() const;
+    void maintenanceLoop();
+    QString segmentPath(quint64 sequence) const;
+    // 目录中属于本日志的段文件（含已压缩），按序号升序
+    QList<QPair<quint64, QString>> listSegments() const;
+
+    QString m_directory;
+    QString m_baseName;
+    QString m_suffix;
+    qint64 m_segmentSize;
+    int m_maxSegments;
+    bool m_compressSealed;
+    bool m_binaryContent;
+
+    std::unique_ptr<Segment> m_current;     // 只在写入线程访问
+
+    // 与后台线程共享，由 m_mutex 保护
+    QThread* m_thread;
+    QMutex m_mutex;
+    QWaitCondition m_condition;             // 唤醒后台线程
+    QWaitCondition m_preparedCondition;     // 下一段准备完成
+    std::unique_ptr<Segment> m_prepared;
+    quint64 m_prepareSequence;
+    bool m_prepareRequested;
+    quint64 m_recoverBefore;                // 启动时封存序号小于该值的遗留段，0 表示无需处理
+    std::deque<std::unique_ptr<Segment>> m_sealQueue;
+    bool m_stopping;
+};
@@ -5,14 +5,25 @@
 #include <QLocale>
 #include <QDebug>
 #include <QMessageBox>
+#include <QThread>
 #include <exception>
 #include <stdexcept>
 
 #include "mainwindow.h"
 #include "logger/logmanager.h"
 #include "config/configmanager.h"
+#include "core/databaseconnectionpool.h"
 #include "core/errorhandler.h"
 #include "core/performanceconfigmanager.h"
+#include "core/performancemonitor.h"
+#include "communication/communicationbufferpool.h"
+#include "communication/linkcompression.h"
+#include "communication/livedatafeed.h"
+#include "communication/metricsserver.h"
+#include "core/startupgraph.h"
+#include "utils/startupprofiler.h"
+#include "utils/threadpolicy.h"
+#include "constants.h"
 
 /**
  * @brief 全局异常处理函数
@@ -60,78 +71,174 @@ int main(int argc, char *argv[])
         app.setOrganizationName("Industrial Solutions");
         app.setOrganizationDomain("industrial-solutions.com");
         
+        // 每次启动都写剖析报告，第一帧绘制和延后子系统就绪后由主窗口结束会话
+        StartupProfiler::beginSession(StartupProfiler::Session::Startup);
+        
         // 设置应用程序目录
         QDir::setCurrent(QApplication::applicationDirPath());
         
         // 创建必要的目录
         QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-        if (!QDir().mkpath(dataDir)) {
-            throw std::runtime_error("Failed to create application data directory");
-        }
-        if (!QDir().mkpath(dataDir + "/logs")) {
-            throw std::runtime_error("Failed to create logs directory");
-        }
-        if (!QDir().mkpath(dataDir + "/config")) {
-            throw std::runtime_error("Failed to create config directory");
-        }
-        if (!QDir().mkpath(dataDir + "/data")) {
-            throw std::runtime_error("Failed to create data directory");
+        {
+            STARTUP_PHASE("创建数据目录");
+            if (!QDir().mkpath(dataDir)) {
+                throw std::runtime_error("Failed to create application data directory");
+            }
+            if (!QDir().mkpath(dataDir + "/logs")) {
+                throw std::runtime_error("Failed to create logs directory");
+            }
+            if (!QDir().mkpath(dataDir + "/config")) {
+                throw std::runtime_error("Failed to create config directory");
+            }
+            if (!QDir().mkpath(dataDir + "/data")) {
+                throw std::runtime_error("Failed to create data directory");
+            }
         }
         
-        // 初始化核心组件
-        try {
-            // 初始化日志管理器
-            LogManager* logManager = LogManager::getInstance();
-            if (!logManager) {
+        // 核心组件按依赖图启动：互不依赖的工作线程节点并行执行，
+        // 主窗口只等待它需要的节点，其余节点在窗口创建期间继续
+        StartupGraph startup;
+        PerformanceConfigManager* perfManager = nullptr;
+        bool perfConfigLoaded = false;
+        
+        startup.addNode("ConfigManager", {}, StartupGraph::Affinity::Worker, []() {
+            // 在工作线程读取配置文件，完成后把对象交还主线程，写盘定时器和文件监视在主线程运行
+            ConfigManager* configManager = ConfigManager::getInstance();
+            if (!configManager) {
+                throw std::runtime_error("Failed to initialize ConfigManager");
+            }
+            if (configManager->thread() == QThread::currentThread()) {
+                configManager->moveToThread(QCoreApplication::instance()->thread());
+            }
+            return true;
+        });
+        
+        // 日志管理器构造时读取日志级别配置
+        startup.addNode("LogManager", {"ConfigManager"}, StartupGraph::Affinity::MainThread, []() {
+            if (!LogManager::getInstance()) {
                 throw std::runtime_error("Failed to initialize LogManager");
             }
-            qDebug() << "LogManager initialized successfully";
-            
-            // 初始化错误处理器
-            ErrorHandler* errorHandler = ErrorHandler::getInstance();
-            if (!errorHandler) {
+            return true;
+        });
+        
+        startup.addNode("ErrorHandler", {"LogManager"}, StartupGraph::Affinity::MainThread, []() {
+            if (!ErrorHandler::getInstance()) {
                 throw std::runtime_error("Failed to initialize ErrorHandler");
             }
-            qDebug() << "ErrorHandler initialized successfully";
-            
-            // 初始化配置管理器
-            ConfigManager* configManager = ConfigManager::getInstance();
-            if (!configManager) {
-                throw std::runtime_error("Failed to initialize ConfigManager");
+            return true;
+        });
+        
+        startup.addNode("PerformanceMonitor", {"LogManager"}, StartupGraph::Affinity::MainThread, []() {
+            return PerformanceMonitor::getInstance() != nullptr;
+        });
+        
+        startup.addNode("BufferPool", {"LogManager"}, StartupGraph::Affinity::MainThread, []() {
+            return CommunicationBufferPool::getInstance() != nullptr;
+        });
+        
+        // 预分配只在池锁内操作缓冲区队列，不必占用主线程；首帧之前用不到，窗口不等待它
+        startup.addNode("BufferPoolPreallocation", {"BufferPool"}, StartupGraph::Affinity::Worker, []() {
+            CommunicationBufferPool* bufferPool = CommunicationBufferPool::getInstance();
+            for (BufferType type : {BufferType::Small, BufferType::Medium, BufferType::Large, BufferType::Huge}) {
+                bufferPool->preallocateBuffers(type, System::STARTUP_PREALLOCATE_BUFFERS);
             }
-            qDebug() << "ConfigManager initialized successfully";
-            
-            // 初始化性能配置管理器
-            PerformanceConfigManager* perfManager = new PerformanceConfigManager();
+            return true;
+        });
+        
+        startup.addNode("PerformanceConfig", {"BufferPool", "PerformanceMonitor"}, StartupGraph::Affinity::MainThread,
+                        [&perfManager, &perfConfigLoaded]() {
+            perfManager = new PerformanceConfigManager();
+            // 工作负载配置档作用于各单例组件，配置文件中的 active_workload_profile 在加载时应用
+            PerformanceConfigManager::ProfileTargets profileTargets;
+            profileTargets.bufferPool = CommunicationBufferPool::getInstance();
+            profileTargets.logManager = LogManager::getInstance();
+            profileTargets.performanceMonitor = PerformanceMonitor::getInstance();
+            perfManager->setProfileTargets(profileTargets);
             QString perfConfigPath = QApplication::applicationDirPath() + "/config/performance_config.json";
-            if (perfManager->loadConfiguration(perfConfigPath)) {
-                perfManager->startMonitoring();
-                qDebug() << "PerformanceConfigManager initialized and monitoring started";
+            perfConfigLoaded = perfManager->loadConfiguration(perfConfigPath);
+            if (perfConfigLoaded) {
+                // 数据库服务和数据导出创建的只读连接池使用配置文件中的参数
+                const PerformanceConfigManager::OptimizationConfig optimization = perfManager->getOptimizationConfig();
+                DatabasePoolConfig poolConfig;
+                poolConfig.minConnections = optimization.dbMinConnections;
+                poolConfig.maxConnections = optimization.dbMaxConnections;
+                poolConfig.connectionTimeoutMs = optimization.dbConnectionTimeoutMs;
+                poolConfig.idleTimeoutMs = optimization.dbIdleTimeoutMs;
+                poolConfig.validationQuery = optimization.dbValidationQuery;
+                DatabaseConnectionPool::setDefaultConfig(poolConfig);
+                // 之后建立的 TCP 连接按配置请求链路压缩
+                LinkCompression::setDefaultEnabled(optimization.commCompressionEnabled);
+                // 通讯和处理线程在主窗口创建之后启动，启动时按此策略调整调度和亲和性
+                ThreadPolicy::getInstance()->configure(perfManager->getThreadingPolicyConfig());
+                qDebug() << "PerformanceConfigManager initialized";
             } else {
                 qWarning() << "Failed to load performance configuration, using defaults";
             }
-            
-        } catch (const std::exception& e) {
-            QString errorMsg = QString("Core component initialization failed: %1").arg(e.what());
+            return true;
+        });
+        
+        // 供外部程序读取的实时数据共享内存，配置 liveDataFeed/enabled 开启；创建失败只记录警告
+        startup.addNode("LiveDataFeed", {"LogManager"}, StartupGraph::Affinity::MainThread, []() {
+            ConfigManager* configManager = ConfigManager::getInstance();
+            if (configManager->getValue("liveDataFeed/enabled", false).toBool()) {
+                LiveDataFeed::getInstance()->start(
+                    configManager->getValue("liveDataFeed/name", QString(LiveFeed::DEFAULT_NAME)).toString(),
+                    configManager->getValue("liveDataFeed/capacity", Communication::LIVE_FEED_DEFAULT_CAPACITY).toInt());
+            }
+            return true;
+        });
+        
+        // 主窗口需要的最小集合：数据库服务创建前连接池参数必须就绪
+        bool coreReady = false;
+        {
+            STARTUP_PHASE("等待核心组件");
+            coreReady = startup.start() && startup.waitFor({"ErrorHandler", "PerformanceConfig"});
+        }
+        if (!coreReady) {
+            QString errorMsg = QString("Core component initialization failed: %1").arg(startup.lastError());
             qCritical() << errorMsg;
             QMessageBox::critical(nullptr, "初始化错误", 
-                QString("核心组件初始化失败：%1\n\n程序将退出。").arg(e.what()));
+                QString("核心组件初始化失败：%1\n\n程序将退出。").arg(startup.lastError()));
+            StartupProfiler::finishSession();
             return -1;
         }
         
         qDebug() << "Application started successfully";
         
+        // 集中抓取用的指标端点，配置文件中开启时才监听
+        MetricsServer metricsServer;
+        if (perfConfigLoaded) {
+            const PerformanceConfigManager::MetricsEndpointConfig endpoint = perfManager->getMetricsEndpointConfig();
+            if (endpoint.enabled) {
+                metricsServer.start(QHostAddress(endpoint.bindAddress), static_cast<quint16>(endpoint.port));
+            }
+        }
+        
         // 创建主窗口
         MainWindow* window = nullptr;
         try {
-            window = new MainWindow();
+            {
+                STARTUP_PHASE("MainWindow 构造");
+                window = new MainWindow();
+            }
             if (!window) {
                 throw std::runtime_error("Failed to create MainWindow");
             }
             
-            // 初始化应用程序
-            window->initializeApplication();
-            window->show();
+            // 初始化应用程序，性能监控等分析任务在第一帧绘制之后启动
+            window->setPerformanceConfigManager(perfManager);
+            if (perfConfigLoaded) {
+                QObject::connect(window, &MainWindow::deferredSubsystemsStarted,
+                                 perfManager, &PerformanceConfigManager::startMonitoring);
+            }
+            {
+                STARTUP_PHASE("MainWindow::initializeApplication");
+                window->initializeApplication();
+            }
+            {
+                STARTUP_PHASE("MainWindow::show");
+                window->show();
+            }
             
             qDebug() << "Main window created and shown successfully";
             
@@ -153,10 +260,17 @@ int main(int argc, char *argv[])
         // 运行应用程序事件循环
         exitCode = app.exec();
         
-        // 清理资源
+        // 工作线程上的启动节点可能仍在使用单例，结束后再释放窗口
+        startup.waitForAll();
+        
+        // 清理资源，关闭会话由 MainWindow::shutdownApplication 开始
         if (window) {
+            STARTUP_PHASE("MainWindow 析构");
             delete window;
         }
+        // 通讯线程已随窗口结束，读取方会看到 Stopped
+        LiveDataFeed::getInstance()->stop();
+        StartupProfiler::finishSession();
         
         qDebug() << "Application exited with code:" << exitCode;
         
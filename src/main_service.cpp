@@ -0,0 +1,344 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QThread>
+#include <QDebug>
+#include <memory>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <QSocketNotifier>
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "logger/logmanager.h"
+#include "config/configmanager.h"
+#include "core/errorhandler.h"
+#include "communication/alarmengine.h"
+#include "communication/communicationbufferpool.h"
+#include "communication/communicationmanager.h"
+#include "communication/dataprocessshardpool.h"
+#include "communication/livedatafeed.h"
+#include "communication/metricsserver.h"
+#include "communication/serialcommunication.h"
+#include "communication/tcpcommunication.h"
+#include "data/sensorrecorder.h"
+#include "utils/threadpolicy.h"
+#include "constants.h"
+
+// 无界面采集服务：只运行通讯、数据处理分片、报警评估、历史记录和指标端点，不加载 Widgets/Charts。
+// 配置见 config/service_config.json；解析后的采样通过实时数据共享内存（LiveDataFeed）和
+// 指标端点提供给界面程序及其他读取方。收到 SIGINT/SIGTERM（Windows 为控制台关闭事件）时有序退出。
+
+namespace {
+
+#ifdef Q_OS_UNIX
+int s_signalFds[2] = {-1, -1};
+
+void onTerminationSignal(int)
+{
+    // 信号处理函数中只做异步信号安全的写入，退出在事件循环中进行
+    const char byte = 1;
+    ssize_t written = ::write(s_signalFds[0], &byte, sizeof(byte));
+    Q_UNUSED(written);
+}
+#endif
+
+#ifdef Q_OS_WIN
+BOOL WINAPI onConsoleControl(DWORD)
+{
+    QMetaObject::invokeMethod(QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
+    return TRUE;
+}
+#endif
+
+void installTerminationHandler(QCoreApplication& app)
+{
+#ifdef Q_OS_UNIX
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0) {
+        qWarning() << "[Service] 无法创建信号通知管道，只能强制结束进程";
+        return;
+    }
+    QSocketNotifier* notifier = new QSocketNotifier(s_signalFds[1], QSocketNotifier::Read, &app);
+    QObject::connect(notifier, &QSocketNotifier::activated, &app, [notifier]() {
+        notifier->setEnabled(false);
+        char byte;
+        ssize_t bytesRead = ::read(s_signalFds[1], &byte, sizeof(byte));
+        Q_UNUSED(bytesRead);
+        LogManager::getInstance()->info("收到退出信号，正在停止采集服务", "Service");
+        QCoreApplication::quit();
+    });
+    struct sigaction action = {};
+    action.sa_handler = onTerminationSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+#elif defined(Q_OS_WIN)
+    Q_UNUSED(app);
+    SetConsoleCtrlHandler(onConsoleControl, TRUE);
+#else
+    Q_UNUSED(app);
+#endif
+}
+
+bool loadServiceConfig(const QString& path, QJsonObject& config, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("无法打开服务配置 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        error = QString("服务配置 %1 解析失败: %2").arg(path, parseError.errorString());
+        return false;
+    }
+    config = document.object();
+    return true;
+}
+
+QSerialPort::Parity parityFromString(const QString& parity)
+{
+    if (parity == "even") return QSerialPort::EvenParity;
+    if (parity == "odd") return QSerialPort::OddParity;
+    if (parity == "mark") return QSerialPort::MarkParity;
+    if (parity == "space") return QSerialPort::SpaceParity;
+    return QSerialPort::NoParity;
+}
+
+// 连接配置：type 为 "serial" 或 "tcp"，其余字段缺省时使用 SerialConfig/TcpConfig 的默认值
+std::unique_ptr<CommunicationConfig> connectionConfig(const QJsonObject& object, CommunicationType& type)
+{
+    std::unique_ptr<CommunicationConfig> config;
+    const QString typeName = object.value("type").toString("serial").toLower();
+    if (typeName == "tcp") {
+        type = CommunicationType::TCP;
+        auto tcp = std::make_unique<TcpConfig>();
+        tcp->hostAddress = object.value("host").toString(tcp->hostAddress);
+        tcp->port = static_cast<quint16>(object.value("port").toInt(tcp->port));
+        tcp->compressionEnabled = object.value("compression").toBool(tcp->compressionEnabled);
+        config = std::move(tcp);
+    } else if (typeName == "serial") {
+        type = CommunicationType::Serial;
+        auto serial = std::make_unique<SerialConfig>();
+        serial->portName = object.value("port").toString(serial->portName);
+        serial->baudRate = object.value("baud_rate").toInt(serial->baudRate);
+        serial->dataBits = static_cast<QSerialPort::DataBits>(object.value("data_bits").toInt(serial->dataBits));
+        serial->parity = parityFromString(object.value("parity").toString("none").toLower());
+        serial->stopBits = static_cast<QSerialPort::StopBits>(object.value("stop_bits").toInt(serial->stopBits));
+        config = std::move(serial);
+    } else {
+        return nullptr;
+    }
+    config->name = object.value("name").toString();
+    config->autoReconnect = object.value("auto_reconnect").toBool(config->autoReconnect);
+    config->enableHeartbeat = object.value("heartbeat").toBool(config->enableHeartbeat);
+    config->heartbeatInterval = object.value("heartbeat_interval_ms").toInt(config->heartbeatInterval);
+    return config;
+}
+
+// 报警限值：未配置的上下限不启用
+QList<AlarmLimit> alarmLimits(const QJsonArray& array)
+{
+    QList<AlarmLimit> limits;
+    for (const QJsonValue& value : array) {
+        const QJsonObject object = value.toObject();
+        AlarmLimit limit;
+        limit.name = object.value("name").toString();
+        limit.input = object.value("input").toString(limit.name);
+        limit.alarmLevel = object.value("level").toInt(limit.alarmLevel);
+        limit.enableHighHigh = object.contains("high_high");
+        limit.highHigh = object.value("high_high").toDouble();
+        limit.enableHigh = object.contains("high");
+        limit.high = object.value("high").toDouble();
+        limit.enableLow = object.contains("low");
+        limit.low = object.value("low").toDouble();
+        limit.enableLowLow = object.contains("low_low");
+        limit.lowLow = object.value("low_low").toDouble();
+        limit.deadband = object.value("deadband").toDouble();
+        limit.delayMs = object.value("delay_ms").toInt();
+        limits.append(limit);
+    }
+    return limits;
+}
+
+QString stateName(AlarmLimitState state)
+{
+    switch (state) {
+    case AlarmLimitState::LowLow: return "低低";
+    case AlarmLimitState::Low: return "低";
+    case AlarmLimitState::High: return "高";
+    case AlarmLimitState::HighHigh: return "高高";
+    default: return "正常";
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // 与界面程序相同的应用信息，历史数据和日志写入同一个数据目录
+    app.setApplicationName("IndustrialHostPC");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("Industrial Solutions");
+    app.setOrganizationDomain("industrial-solutions.com");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("点胶设备无界面采集服务");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption configOption({"c", "config"}, "服务配置文件", "file",
+                                    QCoreApplication::applicationDirPath() + "/config/service_config.json");
+    parser.addOption(configOption);
+    parser.process(app);
+
+    QDir::setCurrent(QCoreApplication::applicationDirPath());
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    for (const QString& subDir : {QString(), QString("/logs"), QString("/config"), QString("/data")}) {
+        if (!QDir().mkpath(dataDir + subDir)) {
+            qCritical() << "[Service] 无法创建数据目录:" << dataDir + subDir;
+            return 1;
+        }
+    }
+
+    // 核心单例：配置先于日志（日志级别来自配置）
+    ConfigManager::getInstance();
+    LogManager* log = LogManager::getInstance();
+    ErrorHandler::getInstance();
+    CommunicationBufferPool::getInstance();
+
+    QJsonObject config;
+    QString configError;
+    if (!loadServiceConfig(parser.value(configOption), config, configError)) {
+        log->error(configError, "Service");
+        qCritical() << "[Service]" << configError;
+        return 1;
+    }
+
+    // 在数据分片和通讯线程启动之前设置调度策略；唤醒抖动通过指标端点导出
+    ThreadPolicy::getInstance()->configure(ThreadPolicyConfig::fromJson(config.value("threading_policy").toObject()));
+
+    MetricsServer metricsServer;
+    const QJsonObject metrics = config.value("metrics_endpoint").toObject();
+    if (metrics.value("enabled").toBool(true)) {
+        metricsServer.start(QHostAddress(metrics.value("bind_address").toString("0.0.0.0")),
+                            static_cast<quint16>(metrics.value("port").toInt(Communication::METRICS_DEFAULT_PORT)));
+    }
+
+    LiveDataFeed* liveFeed = LiveDataFeed::getInstance();
+    const QJsonObject feed = config.value("live_data_feed").toObject();
+    if (feed.value("enabled").toBool(true)) {
+        liveFeed->start(feed.value("name").toString(LiveFeed::DEFAULT_NAME),
+                        feed.value("capacity").toInt(Communication::LIVE_FEED_DEFAULT_CAPACITY));
+    }
+
+    // 报警在接收线程评估，状态变化写入日志
+    AlarmEngine* alarms = AlarmEngine::getInstance();
+    alarms->setLimits(Communication::ALARM_PAGE_GROUP, alarmLimits(config.value("alarm_limits").toArray()));
+    QObject::connect(alarms, &AlarmEngine::transitionsReady, &app, [log](const AlarmTransitionBatch& transitions) {
+        for (const AlarmTransition& transition : transitions) {
+            log->warning(QString("报警 %1: %2 -> %3，值 %4，限值 %5")
+                             .arg(transition.name, stateName(transition.from), stateName(transition.to))
+                             .arg(transition.value).arg(transition.limit), "Alarm");
+        }
+    });
+
+    // 历史记录在自己的线程中写盘，不占用接收线程
+    QThread recorderThread;
+    recorderThread.setObjectName("SensorRecorder");
+    SensorRecorder* recorder = nullptr;
+    if (config.value("record_history").toBool(true)) {
+        recorder = new SensorRecorder();
+        recorder->moveToThread(&recorderThread);
+        QObject::connect(&recorderThread, &QThread::finished, recorder, &QObject::deleteLater);
+        recorderThread.start();
+    }
+
+    // 每个连接一个数据处理分片
+    DataProcessShardPool shardPool;
+    const QJsonObject shards = config.value("data_shards").toObject();
+    DataShardConfig shardConfig;
+    shardConfig.maxShards = shards.value("max_shards").toInt(shardConfig.maxShards);
+    shardConfig.pinToCpu = shards.value("pin_to_cpu").toBool(shardConfig.pinToCpu);
+    shardConfig.eventDriven = shards.value("event_driven").toBool(shardConfig.eventDriven);
+    shardConfig.batchSize = shards.value("batch_size").toInt(shardConfig.batchSize);
+    shardPool.setConfig(shardConfig);
+    shardPool.start();
+
+    CommunicationManager* manager = CommunicationManager::getInstance();
+    shardPool.attach(manager);
+
+    // 连接组：TCP 连接共用少量 I/O 线程，数据经 framesReceived 直接送报警和历史记录，不经过数据分片
+    manager->setIoThreadCount(config.value("io_threads").toInt(0));
+
+    int connectedCount = 0;
+    const QJsonArray connections = config.value("connections").toArray();
+    for (const QJsonValue& value : connections) {
+        CommunicationType type = CommunicationType::Serial;
+        std::unique_ptr<CommunicationConfig> connection = connectionConfig(value.toObject(), type);
+        if (!connection) {
+            log->warning(QString("不支持的连接类型: %1").arg(value.toObject().value("type").toString()), "Service");
+            continue;
+        }
+        const QString name = manager->createConnection(type, connection->name);
+        ICommunication* communication = manager->getConnection(name);
+        if (!communication) {
+            continue;
+        }
+        connection->name = name;
+
+        const auto direct = static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection);
+        QObject::connect(communication, &ICommunication::frameReceived, alarms, &AlarmEngine::evaluateFrame, direct);
+        if (recorder) {
+            QObject::connect(communication, &ICommunication::frameReceived, recorder, &SensorRecorder::recordFrame,
+                             Qt::QueuedConnection);
+        }
+        if (TcpCommunication* tcp = qobject_cast<TcpCommunication*>(communication)) {
+            QObject::connect(tcp, &TcpCommunication::framesReceived, alarms, &AlarmEngine::evaluateFrames, direct);
+            if (recorder) {
+                QObject::connect(tcp, &TcpCommunication::framesReceived, recorder, &SensorRecorder::recordFrames,
+                                 Qt::QueuedConnection);
+            }
+        }
+
+        // 首次连接失败时由自动重连继续尝试
+        if (manager->connectToDevice(name, *connection)) {
+            ++connectedCount;
+        } else {
+            log->warning(QString("连接 %1 首次建立失败: %2").arg(name, communication->getLastError()), "Service");
+        }
+    }
+
+    log->info(QString("采集服务已启动: %1 个连接，%2 个已连接").arg(connections.size()).arg(connectedCount), "Service");
+
+    installTerminationHandler(app);
+    const int exitCode = app.exec();
+
+    // 先停数据源，再停下游
+    manager->disconnectAll();
+    shardPool.detach(manager);
+    shardPool.stop();
+    if (recorder) {
+        QMetaObject::invokeMethod(recorder, &SensorRecorder::flush, Qt::BlockingQueuedConnection);
+        recorderThread.quit();
+        recorderThread.wait();
+    }
+    liveFeed->stop();
+    metricsServer.stop();
+
+    log->info(QString("采集服务已退出，代码 %1").arg(exitCode), "Service");
+    return exitCode;
+}
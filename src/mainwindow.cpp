@@ -8,7 +8,14 @@
 #include "core/adaptiveconfigmanager.h"
 #include "core/loadbalancer.h"
 #include "core/mlperformancepredictor.h"
+#include "core/performancemonitor.h"
+#include "core/memoryoptimizer.h"
+#include "core/startupgraph.h"
+#include "communication/communicationbufferpool.h"
 #include "constants.h"
+#include "logger/logmanager.h"
+#include "utils/startupprofiler.h"
+#include "utils/tracer.h"
 
 #include <QApplication>
 #include <QMessageBox>
@@ -20,6 +27,9 @@
 #include <QDebug>
 #include <QDateTime>
 #include <QIcon>
+#include <QShortcut>
+#include <QStandardPaths>
+#include <QDir>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
@@ -32,6 +42,8 @@ MainWindow::MainWindow(QWidget* parent)
     , adaptiveConfigManager(nullptr)
     , loadBalancer(nullptr)
     , mlPerformancePredictor(nullptr)
+    , performanceConfigManager(nullptr)
+    , deferredStartup(nullptr)
     , m_applicationInitialized(false)
     , m_applicationShuttingDown(false)
     , managersInitialized(false)
@@ -94,6 +106,10 @@ MainWindow::~MainWindow()
     }
     
     // 确保管理器按正确顺序释放
+    // 首帧之后的初始化可能仍在工作线程读取模型文件，等它结束后再停止各组件
+    delete deferredStartup;
+    deferredStartup = nullptr;
+    
     // 先停止持续优化组件
     if (continuousOptimizer) {
         continuousOptimizer->stopOptimization();
@@ -107,6 +123,8 @@ MainWindow::~MainWindow()
     
     if (adaptiveConfigManager) {
         adaptiveConfigManager->stopAdaptiveAdjustment();
+        // 快照发布器随 adaptiveConfigManager 销毁，缓冲池单例活得更久，先断开
+        CommunicationBufferPool::getInstance()->attachConfigSnapshots(nullptr);
         adaptiveConfigManager = nullptr;
     }
     
@@ -203,22 +221,36 @@ void MainWindow::shutdownApplication()
     }
     
     m_applicationShuttingDown = true;
+    // 关闭会话在 main() 释放主窗口之后结束
+    StartupProfiler::beginSession(StartupProfiler::Session::Shutdown);
     currentApplicationState = "Shutting Down";
     emit applicationShuttingDown();
     emit applicationStateChanged(currentApplicationState);
     
     try {
         // 准备关闭
-        prepareShutdown();
+        {
+            STARTUP_PHASE("MainWindow::prepareShutdown");
+            prepareShutdown();
+        }
         
         // 停止定时器
-        stopTimers();
+        {
+            STARTUP_PHASE("MainWindow::stopTimers");
+            stopTimers();
+        }
         
         // 保存应用程序状态
-        saveApplicationState();
+        {
+            STARTUP_PHASE("MainWindow::saveApplicationState");
+            saveApplicationState();
+        }
         
         // 关闭管理器
-        shutdownManagers();
+        {
+            STARTUP_PHASE("MainWindow::shutdownManagers");
+            shutdownManagers();
+        }
         
         currentApplicationState = "Closed";
         emit applicationClosed();
@@ -269,6 +301,8 @@ void MainWindow::setupManagerConnections()
             this, [this]() { onUIManagerEvent("FileSave", QVariant()); });
     connect(uiManager, &UIManager::exitRequested, 
             this, [this]() { onUIManagerEvent("Exit", QVariant()); });
+    connect(uiManager, &UIManager::firstFramePainted,
+            this, &MainWindow::startDeferredSubsystems);
     
     // 连接业务逻辑管理器信号
     connect(businessLogicManager, &BusinessLogicManager::deviceStatusChanged,
@@ -295,34 +329,97 @@ void MainWindow::setupManagerConnections()
 void MainWindow::initializeManagers()
 {
     // 初始化事件协调器
-    eventCoordinator->initialize();
+    {
+        STARTUP_PHASE("EventCoordinator::initialize");
+        eventCoordinator->initialize();
+    }
     
     // 初始化系统管理器
-    systemManager->initialize();
+    {
+        STARTUP_PHASE("SystemManager::initialize");
+        systemManager->initialize();
+    }
     
     // 初始化业务逻辑管理器
-    businessLogicManager->initialize();
+    {
+        STARTUP_PHASE("BusinessLogicManager::initialize");
+        businessLogicManager->initialize();
+    }
     
     // 初始化UI管理器
-    uiManager->initializeUI();
-    
-    // 初始化持续优化组件
-    continuousOptimizer->initialize(performanceMonitor, memoryOptimizer, uiUpdateOptimizer, bufferPool, configManager);
-    intelligentAnalyzer->initialize();
-    adaptiveConfigManager->initialize(continuousOptimizer, intelligentAnalyzer);
-    loadBalancer->initialize();
-    mlPerformancePredictor->initialize();
-    
-    // 启动持续优化
-    continuousOptimizer->startOptimization();
-    intelligentAnalyzer->startAnalysis();
-    adaptiveConfigManager->startAdaptiveAdjustment();
-    loadBalancer->startBalancing();
-    // MLPerformancePredictor 没有 startRealTimeMonitoring 方法，移除此调用
+    {
+        STARTUP_PHASE("UIManager::initializeUI");
+        uiManager->initializeUI();
+    }
+    
+    // 持续优化等后台分析组件在第一帧绘制之后才初始化和启动，见 startDeferredSubsystems()
     
     qDebug() << "Managers and optimization components initialized successfully";
 }
 
+void MainWindow::startDeferredSubsystems()
+{
+    if (!managersInitialized || m_applicationShuttingDown || deferredStartup) {
+        return;
+    }
+    
+    // 读取模型文件的节点放在工作线程，组件的定时器在 start*() 中才启动，初始化期间不会被访问
+    deferredStartup = new StartupGraph(this);
+    deferredStartup->addNode("ContinuousOptimizer", {}, StartupGraph::Affinity::MainThread, [this]() {
+        return continuousOptimizer->initialize(PerformanceMonitor::getInstance(), MemoryOptimizer::getInstance(),
+                                               nullptr, CommunicationBufferPool::getInstance(),
+                                               performanceConfigManager);
+    });
+    deferredStartup->addNode("IntelligentAnalyzer", {}, StartupGraph::Affinity::Worker, [this]() {
+        return intelligentAnalyzer->initialize();
+    });
+    deferredStartup->addNode("AdaptiveConfigManager", {"ContinuousOptimizer", "IntelligentAnalyzer"},
+                             StartupGraph::Affinity::MainThread, [this]() {
+        if (!adaptiveConfigManager->initialize(continuousOptimizer, intelligentAnalyzer)) {
+            return false;
+        }
+        // 缓冲池从参数快照读取配置，在统计定时器中应用新版本
+        CommunicationBufferPool::getInstance()->attachConfigSnapshots(adaptiveConfigManager->configSnapshots());
+        return true;
+    });
+    deferredStartup->addNode("LoadBalancer", {}, StartupGraph::Affinity::MainThread, [this]() {
+        return loadBalancer->initialize();
+    });
+    deferredStartup->addNode("MLPerformancePredictor", {}, StartupGraph::Affinity::Worker, [this]() {
+        return mlPerformancePredictor->initialize();
+    });
+    connect(deferredStartup, &StartupGraph::finished, this, &MainWindow::onDeferredSubsystemsInitialized);
+    deferredStartup->start();
+}
+
+void MainWindow::onDeferredSubsystemsInitialized()
+{
+    if (m_applicationShuttingDown) {
+        return;
+    }
+    
+    // 初始化失败的组件不启动，其余照常运行
+    if (deferredStartup->isSucceeded("ContinuousOptimizer")) {
+        continuousOptimizer->startOptimization();
+    }
+    if (deferredStartup->isSucceeded("IntelligentAnalyzer")) {
+        intelligentAnalyzer->startAnalysis();
+    }
+    if (deferredStartup->isSucceeded("AdaptiveConfigManager")) {
+        adaptiveConfigManager->startAdaptiveAdjustment();
+    }
+    if (deferredStartup->isSucceeded("LoadBalancer")) {
+        loadBalancer->startBalancing();
+    }
+    // MLPerformancePredictor 没有 startRealTimeMonitoring 方法，移除此调用
+    
+    emit deferredSubsystemsStarted();
+    qDebug() << "Deferred subsystems started after first frame";
+    
+    // 启动到此结束：第一帧已绘制，延后子系统已就绪
+    StartupProfiler::finishSession();
+}
+
 void MainWindow::setupTimers()
 {
     // 心跳定时器
@@ -614,6 +711,28 @@ void MainWindow::saveApplicationState()
 void MainWindow::setupEventHandling()
 {
     // 设置事件处理
+    // Ctrl+Shift+T 开始耗时跟踪，再按一次停止并导出 Chrome 跟踪文件
+    QShortcut* traceShortcut = new QShortcut(QKeySequence("Ctrl+Shift+T"), this);
+    connect(traceShortcut, &QShortcut::activated, this, [] {
+        if (!Tracer::isEnabled()) {
+            Tracer::setEnabled(true);
+            LogManager::getInstance()->info("耗时跟踪已开始，再按 Ctrl+Shift+T 停止并导出", "Trace");
+            return;
+        }
+        Tracer::setEnabled(false);
+        const QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/traces";
+        QDir().mkpath(directory);
+        const QString path = directory + "/trace_" +
+                             QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".json";
+        QString error;
+        const int events = Tracer::exportChromeTrace(path, &error);
+        if (events < 0) {
+            LogManager::getInstance()->error(error, "Trace");
+        } else {
+            LogManager::getInstance()->info(QString("耗时跟踪已导出 %1 个事件: %2").arg(events).arg(path), "Trace");
+        }
+    });
+    
     qDebug() << "Event handling setup completed";
 }
 
@@ -17,6 +17,8 @@ class IntelligentAnalyzer;
 class AdaptiveConfigManager;
 class LoadBalancer;
 class MLPerformancePredictor;
+class PerformanceConfigManager;
+class StartupGraph;
 
 /**
  * @brief 重构后的MainWindow类
@@ -44,6 +46,9 @@ public:
     void initializeApplication();
     void shutdownApplication();
     
+    // 持续优化读取的性能配置，由启动流程在 initializeApplication() 之前设置
+    void setPerformanceConfigManager(PerformanceConfigManager* manager) { performanceConfigManager = manager; }
+    
     // 管理器访问
     UIManager* getUIManager() const { return uiManager; }
     BusinessLogicManager* getBusinessLogicManager() const { return businessLogicManager; }
@@ -93,6 +98,7 @@ signals:
     // 应用程序生命周期信号
     void applicationInitialized();
     void applicationReady();
+    void deferredSubsystemsStarted();       // 第一帧之后分析组件已初始化并启动
     void applicationShuttingDown();
     void applicationClosed();
     
@@ -109,6 +115,9 @@ private:
     void createManagers();
     void setupManagerConnections();
     void initializeManagers();
+    // 第一帧绘制之后初始化并启动的非关键子系统（持续优化、智能分析、负载均衡、性能预测）
+    void startDeferredSubsystems();
+    void onDeferredSubsystemsInitialized();
     void setupApplication();
     void loadApplicationSettings();
     void saveApplicationSettings();
@@ -144,6 +153,8 @@ private:
     AdaptiveConfigManager* adaptiveConfigManager;
     LoadBalancer* loadBalancer;
     MLPerformancePredictor* mlPerformancePredictor;
+    PerformanceConfigManager* performanceConfigManager;
+    StartupGraph* deferredStartup;          // 首帧之后的分析组件初始化，开始后不为空
     
     // 应用程序状态
     bool m_applicationInitialized;
@@ -98,13 +98,9 @@ void ParameterWidget::resetParameters() {}
 
 // DataRecordWidget 缺失函数实现
 void DataRecordWidget::onShowChart() {}
-void DataRecordWidget::onBackupData() {}
-void DataRecordWidget::onExportData() {}
 void DataRecordWidget::onSearchData() {}
 void DataRecordWidget::onPrintReport() {}
 void DataRecordWidget::onRefreshData() {}
-void DataRecordWidget::onRestoreData() {}
-void DataRecordWidget::onClearOldData() {}
 void DataRecordWidget::onGenerateReport() {}
 void DataRecordWidget::onAcknowledgeAlarm() {}
 void DataRecordWidget::onFilterChanged() {}
@@ -117,13 +113,9 @@ void DataRecordWidget::onBatchStarted(const QString& batchName, const QString& p
 void DataRecordWidget::onBatchCompleted(int batchId) { Q_UNUSED(batchId); }
 void DataRecordWidget::onDataReceived(const QJsonObject& data) { Q_UNUSED(data); }
 void DataRecordWidget::onAlarmTriggered(const QString& alarmType, const QString& message) { Q_UNUSED(alarmType); Q_UNUSED(message); }
-void DataRecordWidget::loadProductionData() {}
-void DataRecordWidget::loadQualityData() {}
-void DataRecordWidget::loadAlarmData() {}
 void DataRecordWidget::loadStatisticsData() {}
 
 // DataMonitorWidget 缺失函数实现
-void DataMonitorWidget::updateCharts() {}
 void DataMonitorWidget::onConfigChanged() {}
 
 // CommunicationWidget 缺失函数实现
@@ -0,0 +1,109 @@
+#include "alarmlistmodel.h"
+#include <algorithm>
+
+AlarmListModel::AlarmListModel(const QStringList& headers, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_headers(headers)
+    , m_sortColumn(-1)
+    , m_sortOrder(Qt::AscendingOrder)
+{
+}
+
+void AlarmListModel::setFormatter(Formatter formatter)
+{
+    m_formatter = std::move(formatter);
+    if (!m_alarms.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_alarms.size() - 1, columnCount() - 1));
+    }
+}
+
+void AlarmListModel::setAlarms(const QList<AlarmRecord>& alarms)
+{
+    beginResetModel();
+    m_alarms = alarms;
+    sortAlarms();
+    endResetModel();
+}
+
+const AlarmRecord& AlarmListModel::alarmAt(int row) const
+{
+    return m_alarms.at(row);
+}
+
+int AlarmListModel::rowOf(int alarmId) const
+{
+    for (int row = 0; row < m_alarms.size(); ++row) {
+        if (m_alarms.at(row).alarmId == alarmId) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+int AlarmListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_alarms.size();
+}
+
+int AlarmListModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_headers.size();
+}
+
+QVariant AlarmListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_alarms.size() || !m_formatter) {
+        return QVariant();
+    }
+    return m_formatter(m_alarms.at(index.row()), index.column(), role);
+}
+
+QVariant AlarmListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < m_headers.size()) {
+        return m_headers.at(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+void AlarmListModel::sort(int column, Qt::SortOrder order)
+{
+    if (column >= m_headers.size()) {
+        return;
+    }
+    m_sortColumn = column;
+    m_sortOrder = order;
+
+    emit layoutAboutToBeChanged();
+    const QModelIndexList previous = persistentIndexList();
+    QList<int> previousIds;
+    previousIds.reserve(previous.size());
+    for (const QModelIndex& index : previous) {
+        previousIds.append(m_alarms.at(index.row()).alarmId);
+    }
+
+    sortAlarms();
+
+    // 选中行跟随报警移动
+    QModelIndexList current;
+    current.reserve(previous.size());
+    for (int i = 0; i < previous.size(); ++i) {
+        current.append(index(rowOf(previousIds.at(i)), previous.at(i).column()));
+    }
+    changePersistentIndexList(previous, current);
+    emit layoutChanged();
+}
+
+void AlarmListModel::sortAlarms()
+{
+    if (m_sortColumn < 0 || !m_formatter) {
+        return;
+    }
+    const int column = m_sortColumn;
+    const bool ascending = m_sortOrder == Qt::AscendingOrder;
+    std::stable_sort(m_alarms.begin(), m_alarms.end(), [this, column, ascending](const AlarmRecord& a, const AlarmRecord& b) {
+        const QPartialOrdering order = QVariant::compare(m_formatter(a, column, Qt::UserRole),
+                                                         m_formatter(b, column, Qt::UserRole));
+        return ascending ? order == QPartialOrdering::Less : order == QPartialOrdering::Greater;
+    });
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QStringList>
+#include <functional>
+#include "data/datamodels.h"
+
+// 内存中报警列表的表格模型（激活报警页）
+//
+// 列表长度受最大激活报警数限制，过滤后的结果通过 setAlarms() 整体替换，不为每个单元格创建对象。
+// 各列的显示内容、颜色和图标由 formatter 提供；Qt::UserRole 返回该列排序用的原始值（数字、时间等），
+// sort() 在内存中按它稳定排序，之后 setAlarms() 的结果保持同样的排序。
+class AlarmListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    using Formatter = std::function<QVariant(const AlarmRecord& alarm, int column, int role)>;
+
+    explicit AlarmListModel(const QStringList& headers, QObject* parent = nullptr);
+
+    void setFormatter(Formatter formatter);
+    void setAlarms(const QList<AlarmRecord>& alarms);
+    // row 必须在 [0, rowCount()) 内
+    const AlarmRecord& alarmAt(int row) const;
+    // 没有该报警时返回 -1
+    int rowOf(int alarmId) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    void sortAlarms();
+
+    QStringList m_headers;
+    QList<AlarmRecord> m_alarms;
+    Formatter m_formatter;
+    int m_sortColumn;           // 小于 0 表示保持传入的顺序
+    Qt::SortOrder m_sortOrder;
+};
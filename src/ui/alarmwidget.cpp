@@ -1,5 +1,11 @@
 #include "alarmwidget.h"
 #include "../logger/logmanager.h"
+#include "../core/databaseservice.h"
+#include "../core/databaseschema.h"
+#include "alarmlistmodel.h"
+#include "sqlpagemodel.h"
+#include "../constants.h"
+#include <QSqlRecord>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -24,9 +30,83 @@
 #include <QTextStream>
 #include <QMutexLocker>
 
+namespace {
+const QString INSERT_ALARM_SQL = R"(
+    INSERT INTO alarm_records (
+        type, level, source, message, trigger_time, status, value,
+        acknowledge_time, acknowledge_user, resolve_time, resolve_user,
+        solution, suppress_reason, is_suppressed
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+const QString UPDATE_ALARM_SQL = R"(
+    UPDATE alarm_records SET
+        type = ?, level = ?, source = ?, message = ?, trigger_time = ?,
+        status = ?, value = ?, acknowledge_time = ?, acknowledge_user = ?,
+        resolve_time = ?, resolve_user = ?, solution = ?, suppress_reason = ?,
+        is_suppressed = ?
+    WHERE id = ?
+)";
+
+QVariantList alarmValues(const AlarmRecord& alarm)
+{
+    return {
+        static_cast<int>(alarm.alarmType),
+        static_cast<int>(alarm.alarmLevel),
+        alarm.deviceName,
+        alarm.alarmMessage,
+        alarm.timestamp,
+        static_cast<int>(alarm.alarmStatus),
+        alarm.parameterValue,
+        alarm.acknowledgeTime,
+        alarm.acknowledgeUser,
+        alarm.resolveTime,
+        alarm.resolveUser,
+        alarm.solution,
+        alarm.notes,
+        false   // isSuppressed 字段不存在，用false代替
+    };
+}
+
+AlarmRecord alarmFromRecord(const QSqlRecord& record)
+{
+    AlarmRecord alarm;
+    alarm.alarmId = record.value("alarm_id").toInt();
+    alarm.alarmType = static_cast<int>(record.value("alarm_type").toInt());
+    alarm.alarmLevel = static_cast<int>(record.value("alarm_level").toInt());
+    alarm.alarmStatus = static_cast<int>(record.value("alarm_status").toInt());
+    alarm.alarmCode = record.value("alarm_code").toString();
+    alarm.alarmMessage = record.value("alarm_message").toString();
+    alarm.deviceName = record.value("device_name").toString();
+    alarm.parameterName = record.value("parameter_name").toString();
+    alarm.parameterValue = record.value("parameter_value").toDouble();
+    alarm.thresholdValue = record.value("threshold_value").toDouble();
+    alarm.timestamp = record.value("timestamp").toDateTime();
+    alarm.acknowledgeTime = record.value("acknowledge_time").toDateTime();
+    alarm.resolveTime = record.value("resolve_time").toDateTime();
+    alarm.operatorName = record.value("operator_name").toString();
+    alarm.acknowledgeUser = record.value("acknowledge_user").toString();
+    alarm.resolveUser = record.value("resolve_user").toString();
+    alarm.solution = record.value("solution").toString();
+    alarm.notes = record.value("notes").toString();
+    return alarm;
+}
+
+QList<AlarmRecord> alarmsFromResult(const DatabaseResult& result)
+{
+    QList<AlarmRecord> alarms;
+    alarms.reserve(result.rows.size());
+    for (const QSqlRecord& record : result.rows) {
+        alarms.append(alarmFromRecord(record));
+    }
+    return alarms;
+}
+}
+
 AlarmWidget::AlarmWidget(QWidget* parent) 
     : QWidget(parent)
     , m_tabWidget(nullptr)
+    , m_databaseService(nullptr)
     , m_alarmSound(nullptr)
     , m_systemTray(nullptr)
     , m_isInitialized(false)
@@ -37,6 +117,10 @@ AlarmWidget::AlarmWidget(QWidget* parent)
     m_configDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/config";
     m_soundDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/sounds";
     m_exportDirectory = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    m_databasePath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/alarms.db";
+    
+    // 数据库服务始终创建；连接在 setupDatabase 中打开，之前的请求返回“数据库未打开”
+    m_databaseService = new DatabaseService("alarm_db", m_databasePath, this);
     
     // 创建目录
     QDir().mkpath(m_configDirectory);
@@ -60,6 +144,10 @@ AlarmWidget::AlarmWidget(QWidget* parent)
     // setupDatabase();
     setupConnections();
     
+    // 与采样通道对应的阈值在接收线程评估，这里只处理状态变化
+    connect(AlarmEngine::getInstance(), &AlarmEngine::transitionsReady,
+            this, &AlarmWidget::onAlarmTransitions);
+    
     // 初始化定时器
     m_updateTimer = new QTimer(this);
     m_updateTimer->setInterval(UPDATE_INTERVAL);
@@ -131,10 +219,9 @@ AlarmWidget::~AlarmWidget()
         m_alarmSound = nullptr;
     }
     
-    // 关闭数据库
-    if (m_database.isOpen()) {
-        m_database.close();
-    }
+    // 关闭数据库：提交排队的写入并等待数据库线程结束，之后不会再有回调
+    delete m_databaseService;
+    m_databaseService = nullptr;
     
     LogManager::getInstance()->info("报警系统已关闭", "AlarmWidget");
 }
@@ -179,12 +266,12 @@ void AlarmWidget::setupUI()
         QTabBar::tab:hover {
             background-color: #F0F0F0;
         }
-        QTableWidget {
+        QTableView {
             gridline-color: #E0E0E0;
             selection-background-color: #3399FF;
             alternate-background-color: #F8F8F8;
         }
-        QTableWidget::item {
+        QTableView::item {
             padding: 4px;
         }
         QGroupBox {
@@ -307,10 +394,15 @@ void AlarmWidget::setupActiveAlarmsTab()
     layout->addWidget(statsPanel);
     
     // 创建报警表格
-    m_activeAlarmsTable = new QTableWidget(0, 15, m_activeAlarmsTab);
     QStringList headers = {"ID", "类型", "级别", "状态", "代码", "信息", "设备", "参数", "当前值", 
                           "阈值", "发生时间", "确认时间", "操作员", "次数", "备注"};
-    m_activeAlarmsTable->setHorizontalHeaderLabels(headers);
+    m_activeAlarmsModel = new AlarmListModel(headers, this);
+    m_activeAlarmsModel->setFormatter([this](const AlarmRecord& alarm, int column, int role) {
+        return activeAlarmData(alarm, column, role);
+    });
+    
+    m_activeAlarmsTable = new QTableView(m_activeAlarmsTab);
+    m_activeAlarmsTable->setModel(m_activeAlarmsModel);
     m_activeAlarmsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_activeAlarmsTable->setAlternatingRowColors(true);
     m_activeAlarmsTable->setSortingEnabled(true);
@@ -318,15 +410,6 @@ void AlarmWidget::setupActiveAlarmsTab()
     m_activeAlarmsTable->horizontalHeader()->setStretchLastSection(true);
     
     layout->addWidget(m_activeAlarmsTable);
-    
-    // 创建数据模型
-    m_activeAlarmsModel = new QStandardItemModel(this);
-    m_activeAlarmsModel->setHorizontalHeaderLabels(headers);
-    
-    m_activeAlarmsProxy = new QSortFilterProxyModel(this);
-    m_activeAlarmsProxy->setSourceModel(m_activeAlarmsModel);
-    m_activeAlarmsProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    m_activeAlarmsProxy->setFilterKeyColumn(-1); // 搜索所有列
 }
 
 void AlarmWidget::setupHistoryTab()
@@ -376,8 +459,12 @@ void AlarmWidget::setupHistoryTab()
     m_historyClearBtn = new QPushButton("清理历史");
     m_historyClearBtn->setIcon(QIcon(":/icons/clear.png"));
     
+    m_historyMoreBtn = new QPushButton("加载更多");
+    m_historyMoreBtn->setEnabled(false);
+    
     historyButtonLayout->addWidget(m_historyExportBtn);
     historyButtonLayout->addWidget(m_historyClearBtn);
+    historyButtonLayout->addWidget(m_historyMoreBtn);
     
     m_historyCountLabel = new QLabel("记录数: 0");
     historyButtonLayout->addWidget(m_historyCountLabel);
@@ -385,26 +472,43 @@ void AlarmWidget::setupHistoryTab()
     
     layout->addWidget(historyButtonPanel);
     
-    // 创建历史记录表格
-    m_historyTable = new QTableWidget(0, 16, m_historyTab);
-    QStringList historyHeaders = {"ID", "类型", "级别", "状态", "代码", "信息", "设备", "参数", "当前值", 
-                                 "阈值", "发生时间", "确认时间", "解决时间", "操作员", "解决方案", "备注"};
-    m_historyTable->setHorizontalHeaderLabels(historyHeaders);
+    // 创建历史记录表格：按页从数据库读取，过滤和排序都在 SQL 中完成
+    // 可为空的列排序时用 IFNULL 包装，保证键集分页的比较有确定的结果
+    const QList<SqlPageColumn> historyColumns = {
+        {"ID", "alarm_id", "alarm_id"},
+        {"类型", "alarm_type", "alarm_type"},
+        {"级别", "alarm_level", "alarm_level"},
+        {"状态", "alarm_status", "alarm_status"},
+        {"代码", "alarm_code", "alarm_code"},
+        {"信息", "alarm_message", "alarm_message"},
+        {"设备", "device_name", "device_name"},
+        {"参数", "parameter_name", "IFNULL(parameter_name, '')"},
+        {"当前值", "parameter_value", "IFNULL(parameter_value, 0)"},
+        {"阈值", "threshold_value", "IFNULL(threshold_value, 0)"},
+        {"发生时间", "timestamp", "timestamp"},
+        {"确认时间", "acknowledge_time", "IFNULL(acknowledge_time, '')"},
+        {"解决时间", "resolve_time", "IFNULL(resolve_time, '')"},
+        {"操作员", "operator_name", "IFNULL(operator_name, '')"},
+        {"解决方案", "solution", "IFNULL(solution, '')"},
+        {"备注", "notes", "IFNULL(notes, '')"}
+    };
+    m_historyModel = new SqlPageModel("alarm_records", "alarm_id", historyColumns, this);
+    m_historyModel->setDatabaseService(m_databaseService);
+    m_historyModel->setPageSize(System::DB_HISTORY_PAGE_SIZE);
+    m_historyModel->setFormatter([this](const QVariantList& row, int column, int role) {
+        return historyData(row, column, role);
+    });
+    
+    m_historyTable = new QTableView(m_historyTab);
+    m_historyTable->setModel(m_historyModel);
     m_historyTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_historyTable->setAlternatingRowColors(true);
     m_historyTable->setSortingEnabled(true);
+    m_historyTable->sortByColumn(HISTORY_TIME_COLUMN, Qt::DescendingOrder);
     m_historyTable->verticalHeader()->setVisible(false);
     m_historyTable->horizontalHeader()->setStretchLastSection(true);
     
     layout->addWidget(m_historyTable);
-    
-    // 创建数据模型
-    m_historyModel = new QStandardItemModel(this);
-    m_historyModel->setHorizontalHeaderLabels(historyHeaders);
-    
-    m_historyProxy = new QSortFilterProxyModel(this);
-    m_historyProxy->setSourceModel(m_historyModel);
-    m_historyProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
 }
 
 void AlarmWidget::setupThresholdsTab()
@@ -506,20 +610,20 @@ void AlarmWidget::setupStatisticsTab()
     
     layout->addWidget(statsControlPanel);
     
-    // 创建统计表格
-    m_statsTable = new QTableWidget(0, 6, m_statisticsTab);
+    // 创建统计表格（只有按类型和级别汇总的十几行）
     QStringList statsHeaders = {"统计项", "总数", "今日", "本周", "本月", "说明"};
-    m_statsTable->setHorizontalHeaderLabels(statsHeaders);
+    m_statisticsModel = new QStandardItemModel(this);
+    m_statisticsModel->setHorizontalHeaderLabels(statsHeaders);
+    
+    m_statsTable = new QTableView(m_statisticsTab);
+    m_statsTable->setModel(m_statisticsModel);
+    m_statsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_statsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_statsTable->setAlternatingRowColors(true);
     m_statsTable->verticalHeader()->setVisible(false);
     m_statsTable->horizontalHeader()->setStretchLastSection(true);
     
     layout->addWidget(m_statsTable);
-    
-    // 创建数据模型
-    m_statisticsModel = new QStandardItemModel(this);
-    m_statisticsModel->setHorizontalHeaderLabels(statsHeaders);
 }
 
 void AlarmWidget::setupConfigTab()
@@ -626,9 +730,6 @@ void AlarmWidget::setupConfigTab()
 
 void AlarmWidget::setupDatabase()
 {
-    // 设置数据库路径
-    m_databasePath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/alarms.db";
-    
     // 确保目录存在
     QDir dir(QFileInfo(m_databasePath).absolutePath());
     if (!dir.exists()) {
@@ -646,124 +747,21 @@ void AlarmWidget::setupDatabase()
 
 bool AlarmWidget::initializeDatabase()
 {
-    // 创建数据库连接
-    m_database = QSqlDatabase::addDatabase("QSQLITE", "alarm_db");
-    m_database.setDatabaseName(m_databasePath);
-    
-    if (!m_database.open()) {
-        LogManager::getInstance()->error("无法打开报警数据库: " + m_database.lastError().text(), "AlarmWidget");
-        return false;
-    }
-    
-    // 创建表格
-    return createTables();
-}
-
-bool AlarmWidget::createTables()
-{
-    QSqlQuery query(m_database);
-    
-    // 创建报警记录表
-    QString createAlarmTable = R"(
-        CREATE TABLE IF NOT EXISTS alarm_records (
-            alarm_id INTEGER PRIMARY KEY AUTOINCREMENT,
-            alarm_type INTEGER NOT NULL,
-            alarm_level INTEGER NOT NULL,
-            alarm_status INTEGER NOT NULL,
-            alarm_code TEXT NOT NULL,
-            alarm_message TEXT NOT NULL,
-            device_name TEXT NOT NULL,
-            parameter_name TEXT,
-            parameter_value REAL DEFAULT 0,
-            threshold_value REAL DEFAULT 0,
-            timestamp DATETIME NOT NULL,
-            acknowledge_time DATETIME,
-            resolve_time DATETIME,
-            operator_name TEXT,
-            acknowledge_user TEXT,
-            resolve_user TEXT,
-            solution TEXT,
-            notes TEXT,
-            count INTEGER DEFAULT 1,
-            is_audible BOOLEAN DEFAULT TRUE,
-            is_visible BOOLEAN DEFAULT TRUE,
-            category TEXT,
-            priority INTEGER DEFAULT 1,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createAlarmTable)) {
-        LogManager::getInstance()->error("创建报警记录表失败: " + query.lastError().text(), "AlarmWidget");
-        return false;
-    }
-    
-    // 创建报警阈值表
-    QString createThresholdTable = R"(
-        CREATE TABLE IF NOT EXISTS alarm_thresholds (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            parameter_name TEXT NOT NULL UNIQUE,
-            alarm_type INTEGER NOT NULL,
-            alarm_level INTEGER NOT NULL,
-            high_high REAL DEFAULT 0,
-            high_value REAL DEFAULT 0,
-            low_value REAL DEFAULT 0,
-            low_low REAL DEFAULT 0,
-            enable_high_high BOOLEAN DEFAULT FALSE,
-            enable_high BOOLEAN DEFAULT TRUE,
-            enable_low BOOLEAN DEFAULT TRUE,
-            enable_low_low BOOLEAN DEFAULT FALSE,
-            delay_time INTEGER DEFAULT 0,
-            deadband INTEGER DEFAULT 0,
-            is_enabled BOOLEAN DEFAULT TRUE,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createThresholdTable)) {
-        LogManager::getInstance()->error("创建报警阈值表失败: " + query.lastError().text(), "AlarmWidget");
-        return false;
-    }
-    
-    // 创建报警配置表
-    QString createConfigTable = R"(
-        CREATE TABLE IF NOT EXISTS alarm_config (
-            id INTEGER PRIMARY KEY,
-            enable_audible BOOLEAN DEFAULT TRUE,
-            enable_visual BOOLEAN DEFAULT TRUE,
-            enable_email BOOLEAN DEFAULT FALSE,
-            enable_sms BOOLEAN DEFAULT FALSE,
-            enable_tray BOOLEAN DEFAULT TRUE,
-            max_active_alarms INTEGER DEFAULT 100,
-            auto_acknowledge_time INTEGER DEFAULT 0,
-            sound_duration INTEGER DEFAULT 5,
-            sound_file TEXT,
-            email_recipients TEXT,
-            sms_recipients TEXT,
-            enable_history BOOLEAN DEFAULT TRUE,
-            max_history_records INTEGER DEFAULT 10000,
-            enable_statistics BOOLEAN DEFAULT TRUE,
-            statistics_update_interval INTEGER DEFAULT 60,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createConfigTable)) {
-        LogManager::getInstance()->error("创建报警配置表失败: " + query.lastError().text(), "AlarmWidget");
+    // 数据库连接属于独立的数据库线程，建表在该线程执行，界面线程不等待
+    m_databaseService->open([](QSqlDatabase& database) { return createTables(database); });
+    return true;
+}
+
+bool AlarmWidget::createTables(QSqlDatabase& database)
+{
+    // 表结构和索引按版本迁移，已有数据库只执行缺少的版本
+    QString error;
+    if (!DatabaseSchema::migrate(database, DatabaseSchema::alarmMigrations(), &error)) {
+        LogManager::getInstance()->error("报警数据库结构迁移失败: " + error, "AlarmWidget");
         return false;
     }
     
-    // 创建索引
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_timestamp ON alarm_records(timestamp)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_type ON alarm_records(alarm_type)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_level ON alarm_records(alarm_level)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_status ON alarm_records(alarm_status)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_device ON alarm_records(device_name)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_threshold_parameter ON alarm_thresholds(parameter_name)");
-    
+    LogManager::getInstance()->debug(QString("报警数据库结构版本: %1").arg(DatabaseSchema::version(database)), "AlarmWidget");
     return true;
 }
 
@@ -919,32 +917,36 @@ QString AlarmWidget::formatDateTime(const QDateTime& dateTime) const
 
 void AlarmWidget::updateAlarmThreshold(const AlarmThreshold& threshold)
 {
-    QSqlQuery query(m_database);
-    query.prepare(R"(
+    const QVariantList values = {
+        static_cast<int>(threshold.type),
+        static_cast<int>(threshold.level),
+        threshold.highHigh,
+        threshold.high,
+        threshold.low,
+        threshold.lowLow,
+        threshold.enableHighHigh,
+        threshold.enableHigh,
+        threshold.enableLow,
+        threshold.enableLowLow,
+        threshold.delayTime,
+        threshold.deadband,
+        threshold.isEnabled,
+        QDateTime::currentDateTime(),
+        threshold.parameterName
+    };
+    
+    m_databaseService->execute(R"(
         UPDATE alarm_thresholds SET
             type = ?, level = ?, high_high = ?, high = ?, low = ?, low_low = ?,
             enable_high_high = ?, enable_high = ?, enable_low = ?, enable_low_low = ?,
             delay_time = ?, deadband = ?, is_enabled = ?, update_time = ?
         WHERE parameter_name = ?
-    )");
-    
-    query.addBindValue(static_cast<int>(threshold.type));
-    query.addBindValue(static_cast<int>(threshold.level));
-    query.addBindValue(threshold.highHigh);
-    query.addBindValue(threshold.high);
-    query.addBindValue(threshold.low);
-    query.addBindValue(threshold.lowLow);
-    query.addBindValue(threshold.enableHighHigh);
-    query.addBindValue(threshold.enableHigh);
-    query.addBindValue(threshold.enableLow);
-    query.addBindValue(threshold.enableLowLow);
-    query.addBindValue(threshold.delayTime);
-    query.addBindValue(threshold.deadband);
-    query.addBindValue(threshold.isEnabled);
-    query.addBindValue(QDateTime::currentDateTime());
-    query.addBindValue(threshold.parameterName);
-    
-    if (query.exec()) {
+    )", values, this, [this, threshold](const DatabaseResult& result) {
+        if (!result.success) {
+            LogManager::getInstance()->error("更新报警阈值失败: " + result.error, "AlarmWidget");
+            return;
+        }
+        
         // 更新内存中的阈值
         for (int i = 0; i < m_alarmThresholds.size(); ++i) {
             if (m_alarmThresholds[i].parameterName == threshold.parameterName) {
@@ -954,82 +956,76 @@ void AlarmWidget::updateAlarmThreshold(const AlarmThreshold& threshold)
         }
         
         updateThresholdsTable();
+        syncAlarmLimits();
         LogManager::getInstance()->info("更新报警阈值: " + threshold.parameterName, "AlarmWidget");
-    } else {
-        LogManager::getInstance()->error("更新报警阈值失败: " + query.lastError().text(), "AlarmWidget");
-    }
+    });
 }
 
-void AlarmWidget::calculateStatistics()
+AlarmStatistics AlarmWidget::calculateStatistics(QSqlDatabase& database)
 {
-    QSqlQuery query(m_database);
+    QSqlQuery query(database);
     
-    // 重置统计数据
-    m_alarmStatistics = AlarmStatistics();
-    m_alarmStatistics.lastUpdateTime = QDateTime::currentDateTime();
+    AlarmStatistics statistics;
+    statistics.lastUpdateTime = QDateTime::currentDateTime();
     
     // 计算总报警数
     query.exec("SELECT COUNT(*) FROM alarm_records");
     if (query.next()) {
-        m_alarmStatistics.totalAlarms = query.value(0).toInt();
-    }
-    
-    // 计算激活报警数
-    query.exec("SELECT COUNT(*) FROM alarm_records WHERE status = 0");
-    if (query.next()) {
-        m_alarmStatistics.activeAlarms = query.value(0).toInt();
+        statistics.totalAlarms = query.value(0).toInt();
     }
     
-    // 计算已确认报警数
-    query.exec("SELECT COUNT(*) FROM alarm_records WHERE status = 1");
-    if (query.next()) {
-        m_alarmStatistics.acknowledgedAlarms = query.value(0).toInt();
-    }
-    
-    // 计算已解决报警数
-    query.exec("SELECT COUNT(*) FROM alarm_records WHERE status = 2");
-    if (query.next()) {
-        m_alarmStatistics.resolvedAlarms = query.value(0).toInt();
+    // 按状态、类型和级别的计数都只读取对应的 (列, timestamp) 组合索引
+    query.exec("SELECT alarm_status, COUNT(*) FROM alarm_records GROUP BY alarm_status");
+    while (query.next()) {
+        const int count = query.value(1).toInt();
+        switch (static_cast<AlarmStatus>(query.value(0).toInt())) {
+        case AlarmStatus::Active: statistics.activeAlarms = count; break;
+        case AlarmStatus::Acknowledged: statistics.acknowledgedAlarms = count; break;
+        case AlarmStatus::Resolved: statistics.resolvedAlarms = count; break;
+        default: break;
+        }
     }
     
     // 计算按类型统计
-    query.exec("SELECT type, COUNT(*) FROM alarm_records GROUP BY type");
+    query.exec("SELECT alarm_type, COUNT(*) FROM alarm_records GROUP BY alarm_type");
     while (query.next()) {
         AlarmType type = static_cast<AlarmType>(query.value(0).toInt());
         int count = query.value(1).toInt();
-        m_alarmStatistics.alarmsByType[type] = count;
+        statistics.alarmsByType[type] = count;
     }
     
     // 计算按级别统计
-    query.exec("SELECT level, COUNT(*) FROM alarm_records GROUP BY level");
+    query.exec("SELECT alarm_level, COUNT(*) FROM alarm_records GROUP BY alarm_level");
     while (query.next()) {
         AlarmLevel level = static_cast<AlarmLevel>(query.value(0).toInt());
         int count = query.value(1).toInt();
-        m_alarmStatistics.alarmsByLevel[level] = count;
+        statistics.alarmsByLevel[level] = count;
     }
     
-    // 计算平均响应时间
-    query.exec("SELECT AVG(acknowledge_time - trigger_time) FROM alarm_records WHERE acknowledge_time IS NOT NULL");
+    // 计算平均响应时间（秒）
+    query.exec("SELECT AVG((julianday(acknowledge_time) - julianday(timestamp)) * 86400) FROM alarm_records WHERE acknowledge_time IS NOT NULL");
     if (query.next()) {
-        m_alarmStatistics.averageResponseTime = query.value(0).toDouble();
+        statistics.averageResponseTime = query.value(0).toDouble();
     }
     
-    // 计算平均解决时间
-    query.exec("SELECT AVG(resolve_time - trigger_time) FROM alarm_records WHERE resolve_time IS NOT NULL");
+    // 计算平均解决时间（秒）
+    query.exec("SELECT AVG((julianday(resolve_time) - julianday(timestamp)) * 86400) FROM alarm_records WHERE resolve_time IS NOT NULL");
     if (query.next()) {
-        m_alarmStatistics.averageResolveTime = query.value(0).toDouble();
+        statistics.averageResolveTime = query.value(0).toDouble();
     }
     
-    LogManager::getInstance()->info("报警统计已更新", "AlarmWidget");
+    return statistics;
 }
 
 void AlarmWidget::removeAlarmThreshold(const QString& parameterName)
 {
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM alarm_thresholds WHERE parameter_name = ?");
-    query.addBindValue(parameterName);
-    
-    if (query.exec()) {
+    m_databaseService->execute("DELETE FROM alarm_thresholds WHERE parameter_name = ?", {parameterName},
+                               this, [this, parameterName](const DatabaseResult& result) {
+        if (!result.success) {
+            LogManager::getInstance()->error("删除报警阈值失败: " + result.error, "AlarmWidget");
+            return;
+        }
+        
         // 从内存中移除
         for (int i = 0; i < m_alarmThresholds.size(); ++i) {
             if (m_alarmThresholds[i].parameterName == parameterName) {
@@ -1039,10 +1035,9 @@ void AlarmWidget::removeAlarmThreshold(const QString& parameterName)
         }
         
         updateThresholdsTable();
+        syncAlarmLimits();
         LogManager::getInstance()->info("删除报警阈值: " + parameterName, "AlarmWidget");
-    } else {
-        LogManager::getInstance()->error("删除报警阈值失败: " + query.lastError().text(), "AlarmWidget");
-    }
+    });
 }
 
 void AlarmWidget::processAlarm(const AlarmRecord& alarm)
@@ -1128,6 +1123,86 @@ void AlarmWidget::checkParameter(const QString& parameterName, double value)
     }
 }
 
+void AlarmWidget::syncAlarmLimits()
+{
+    AlarmEngine* engine = AlarmEngine::getInstance();
+    QList<AlarmLimit> limits;
+    for (const AlarmThreshold& threshold : m_alarmThresholds) {
+        if (!threshold.isEnabled || engine->inputIndex(threshold.parameterName) < 0) {
+            continue;
+        }
+        AlarmLimit limit;
+        limit.name = threshold.parameterName;
+        limit.input = threshold.parameterName;
+        limit.alarmType = static_cast<int>(threshold.type);
+        limit.alarmLevel = static_cast<int>(threshold.level);
+        limit.highHigh = threshold.highHigh;
+        limit.high = threshold.high;
+        limit.low = threshold.low;
+        limit.lowLow = threshold.lowLow;
+        limit.enableHighHigh = threshold.enableHighHigh;
+        limit.enableHigh = threshold.enableHigh;
+        limit.enableLow = threshold.enableLow;
+        limit.enableLowLow = threshold.enableLowLow;
+        limit.deadband = threshold.deadband;
+        limit.delayMs = threshold.delayTime * 1000;
+        limits.append(limit);
+    }
+    engine->setLimits(Communication::ALARM_PAGE_GROUP, limits);
+}
+
+void AlarmWidget::onAlarmTransitions(const AlarmTransitionBatch& transitions)
+{
+    for (const AlarmTransition& transition : transitions) {
+        if (transition.group != Communication::ALARM_PAGE_GROUP) {
+            continue;
+        }
+        
+        if (transition.to == AlarmLimitState::Normal) {
+            LogManager::getInstance()->info(QString("参数 %1 恢复正常: %2").arg(transition.name)
+                                            .arg(transition.value, 0, 'f', 2), "AlarmWidget");
+            continue;
+        }
+        
+        QString code;
+        QString message;
+        switch (transition.to) {
+        case AlarmLimitState::HighHigh:
+            code = "HH";
+            message = QString("参数 %1 超过高高限 (%2 > %3)");
+            break;
+        case AlarmLimitState::High:
+            code = "H";
+            message = QString("参数 %1 超过高限 (%2 > %3)");
+            break;
+        case AlarmLimitState::Low:
+            code = "L";
+            message = QString("参数 %1 低于低限 (%2 < %3)");
+            break;
+        default:
+            code = "LL";
+            message = QString("参数 %1 低于低低限 (%2 < %3)");
+            break;
+        }
+        
+        AlarmRecord alarm;
+        alarm.alarmType = transition.alarmType;
+        alarm.alarmLevel = transition.alarmLevel;
+        alarm.alarmCode = transition.name + "_" + code;
+        alarm.deviceName = transition.name;
+        alarm.parameterName = transition.name;
+        alarm.alarmMessage = message.arg(transition.name)
+                                 .arg(transition.value, 0, 'f', 2)
+                                 .arg(transition.limit, 0, 'f', 2);
+        alarm.timestamp = QDateTime::currentDateTime();
+        alarm.alarmStatus = static_cast<int>(AlarmStatus::Active);
+        alarm.parameterValue = transition.value;
+        alarm.thresholdValue = transition.limit;
+        
+        triggerAlarm(alarm);
+    }
+}
+
 void AlarmWidget::resetStatistics()
 {
     m_alarmStatistics = AlarmStatistics();
@@ -1138,106 +1213,58 @@ void AlarmWidget::resetStatistics()
 
 void AlarmWidget::addAlarmThreshold(const AlarmThreshold& threshold)
 {
-    QSqlQuery query(m_database);
-    query.prepare(R"(
+    const QDateTime now = QDateTime::currentDateTime();
+    const QVariantList values = {
+        threshold.parameterName,
+        static_cast<int>(threshold.type),
+        static_cast<int>(threshold.level),
+        threshold.highHigh,
+        threshold.high,
+        threshold.low,
+        threshold.lowLow,
+        threshold.enableHighHigh,
+        threshold.enableHigh,
+        threshold.enableLow,
+        threshold.enableLowLow,
+        threshold.delayTime,
+        threshold.deadband,
+        threshold.isEnabled,
+        now,
+        now
+    };
+    
+    m_databaseService->execute(R"(
         INSERT INTO alarm_thresholds (
             parameter_name, type, level, high_high, high, low, low_low,
             enable_high_high, enable_high, enable_low, enable_low_low,
             delay_time, deadband, is_enabled, create_time, update_time
         ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )");
-    
-    query.addBindValue(threshold.parameterName);
-    query.addBindValue(static_cast<int>(threshold.type));
-    query.addBindValue(static_cast<int>(threshold.level));
-    query.addBindValue(threshold.highHigh);
-    query.addBindValue(threshold.high);
-    query.addBindValue(threshold.low);
-    query.addBindValue(threshold.lowLow);
-    query.addBindValue(threshold.enableHighHigh);
-    query.addBindValue(threshold.enableHigh);
-    query.addBindValue(threshold.enableLow);
-    query.addBindValue(threshold.enableLowLow);
-    query.addBindValue(threshold.delayTime);
-    query.addBindValue(threshold.deadband);
-    query.addBindValue(threshold.isEnabled);
-    query.addBindValue(QDateTime::currentDateTime());
-    query.addBindValue(QDateTime::currentDateTime());
-    
-    if (query.exec()) {
+    )", values, this, [this, threshold](const DatabaseResult& result) {
+        if (!result.success) {
+            LogManager::getInstance()->error("添加报警阈值失败: " + result.error, "AlarmWidget");
+            return;
+        }
+        
         m_alarmThresholds.append(threshold);
         updateThresholdsTable();
+        syncAlarmLimits();
         LogManager::getInstance()->info("添加报警阈值: " + threshold.parameterName, "AlarmWidget");
-    } else {
-        LogManager::getInstance()->error("添加报警阈值失败: " + query.lastError().text(), "AlarmWidget");
-    }
+    });
 }
 
 bool AlarmWidget::insertAlarmRecord(const AlarmRecord& alarm)
 {
-    QSqlQuery query(m_database);
-    query.prepare(R"(
-        INSERT INTO alarm_records (
-            type, level, source, message, trigger_time, status, value,
-            acknowledge_time, acknowledge_user, resolve_time, resolve_user,
-            solution, suppress_reason, is_suppressed
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )");
-    
-    query.addBindValue(static_cast<int>(alarm.alarmType));
-    query.addBindValue(static_cast<int>(alarm.alarmLevel));
-    query.addBindValue(alarm.deviceName);
-    query.addBindValue(alarm.alarmMessage);
-    query.addBindValue(alarm.timestamp);
-    query.addBindValue(static_cast<int>(alarm.alarmStatus));
-    query.addBindValue(alarm.parameterValue);
-    query.addBindValue(alarm.acknowledgeTime);
-    query.addBindValue(alarm.acknowledgeUser);
-    query.addBindValue(alarm.resolveTime);
-    query.addBindValue(alarm.resolveUser);
-    query.addBindValue(alarm.solution);
-    query.addBindValue(alarm.notes);
-    query.addBindValue(false); // isSuppressed 字段不存在，用false代替
-    
-    if (!query.exec()) {
-        LogManager::getInstance()->error("插入报警记录失败: " + query.lastError().text(), "AlarmWidget");
-        return false;
-    }
+    // 写后即返回，由数据库线程按批在事务中提交
+    m_databaseService->write(INSERT_ALARM_SQL, alarmValues(alarm));
     return true;
 }
 
 bool AlarmWidget::updateAlarmRecord(const AlarmRecord& alarm)
 {
-    QSqlQuery query(m_database);
-    query.prepare(R"(
-        UPDATE alarm_records SET
-            type = ?, level = ?, source = ?, message = ?, trigger_time = ?,
-            status = ?, value = ?, acknowledge_time = ?, acknowledge_user = ?,
-            resolve_time = ?, resolve_user = ?, solution = ?, suppress_reason = ?,
-            is_suppressed = ?
-        WHERE id = ?
-    )");
-    
-    query.addBindValue(static_cast<int>(alarm.alarmType));
-    query.addBindValue(static_cast<int>(alarm.alarmLevel));
-    query.addBindValue(alarm.deviceName);
-    query.addBindValue(alarm.alarmMessage);
-    query.addBindValue(alarm.timestamp);
-    query.addBindValue(static_cast<int>(alarm.alarmStatus));
-    query.addBindValue(alarm.parameterValue);
-    query.addBindValue(alarm.acknowledgeTime);
-    query.addBindValue(alarm.acknowledgeUser);
-    query.addBindValue(alarm.resolveTime);
-    query.addBindValue(alarm.resolveUser);
-    query.addBindValue(alarm.solution);
-    query.addBindValue(alarm.notes);
-    query.addBindValue(false); // isSuppressed 字段不存在，用false代替
-    query.addBindValue(alarm.alarmId);
-    
-    if (!query.exec()) {
-        LogManager::getInstance()->error("更新报警记录失败: " + query.lastError().text(), "AlarmWidget");
-        return false;
-    }
+    // 与插入走同一个写入队列，保证更新在对应的插入之后执行
+    QVariantList values = alarmValues(alarm);
+    values.append(alarm.alarmId);
+    m_databaseService->write(UPDATE_ALARM_SQL, values);
     return true;
 }
 
@@ -1261,12 +1288,12 @@ void AlarmWidget::setupConnections()
     connect(m_exportBtn, &QPushButton::clicked, this, &AlarmWidget::onExportAlarms);
     connect(m_configBtn, &QPushButton::clicked, this, &AlarmWidget::onConfigureAlarms);
     
-    connect(m_activeAlarmsTable, &QTableWidget::itemSelectionChanged, 
+    connect(m_activeAlarmsTable->selectionModel(), &QItemSelectionModel::selectionChanged, 
             this, &AlarmWidget::onAlarmSelectionChanged);
-    connect(m_activeAlarmsTable, &QTableWidget::itemDoubleClicked, 
-            this, [this](QTableWidgetItem* item) {
-                if (item && item->row() >= 0 && item->row() < m_activeAlarms.size()) {
-                    showAlarmDetailsDialog(m_activeAlarms[item->row()]);
+    connect(m_activeAlarmsTable, &QTableView::doubleClicked, 
+            this, [this](const QModelIndex& index) {
+                if (index.isValid() && index.row() < m_activeAlarmsModel->rowCount()) {
+                    showAlarmDetailsDialog(m_activeAlarmsModel->alarmAt(index.row()));
                 }
             });
     
@@ -1274,6 +1301,14 @@ void AlarmWidget::setupConnections()
     connect(m_historySearchBtn, &QPushButton::clicked, this, &AlarmWidget::onShowHistory);
     connect(m_historyExportBtn, &QPushButton::clicked, this, &AlarmWidget::onExportAlarms);
     connect(m_historyClearBtn, &QPushButton::clicked, this, &AlarmWidget::cleanupOldAlarms);
+    connect(m_historyMoreBtn, &QPushButton::clicked, this, &AlarmWidget::loadMoreAlarmHistory);
+    connect(m_historyModel, &SqlPageModel::totalCountChanged, this, &AlarmWidget::updateHistoryTable);
+    connect(m_historyModel, &QAbstractItemModel::rowsInserted, this, &AlarmWidget::updateHistoryTable);
+    connect(m_historyModel, &QAbstractItemModel::modelReset, this, &AlarmWidget::updateHistoryTable);
+    connect(m_historyModel, &SqlPageModel::loadFailed, this, [this](const QString& error) {
+        LogManager::getInstance()->error("加载历史报警失败: " + error, "AlarmWidget");
+        updateHistoryTable();
+    });
     connect(m_historyStartDate, &QDateTimeEdit::dateTimeChanged, this, &AlarmWidget::onShowHistory);
     connect(m_historyEndDate, &QDateTimeEdit::dateTimeChanged, this, &AlarmWidget::onShowHistory);
     connect(m_historyTypeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), 
@@ -1446,8 +1481,8 @@ void AlarmWidget::onAcknowledgeSelected()
     
     for (const QModelIndex& index : selectedRows) {
         int row = index.row();
-        if (row >= 0 && row < m_activeAlarms.size()) {
-            int alarmId = m_activeAlarms[row].alarmId;
+        if (row >= 0 && row < m_activeAlarmsModel->rowCount()) {
+            int alarmId = m_activeAlarmsModel->alarmAt(row).alarmId;
             acknowledgeAlarm(alarmId, user);
         }
     }
@@ -1463,8 +1498,8 @@ void AlarmWidget::onResolveSelected()
     
     for (const QModelIndex& index : selectedRows) {
         int row = index.row();
-        if (row >= 0 && row < m_activeAlarms.size()) {
-            int alarmId = m_activeAlarms[row].alarmId;
+        if (row >= 0 && row < m_activeAlarmsModel->rowCount()) {
+            int alarmId = m_activeAlarmsModel->alarmAt(row).alarmId;
             resolveAlarm(alarmId, user, solution);
         }
     }
@@ -1479,8 +1514,8 @@ void AlarmWidget::onSuppressSelected()
     
     for (const QModelIndex& index : selectedRows) {
         int row = index.row();
-        if (row >= 0 && row < m_activeAlarms.size()) {
-            int alarmId = m_activeAlarms[row].alarmId;
+        if (row >= 0 && row < m_activeAlarmsModel->rowCount()) {
+            int alarmId = m_activeAlarmsModel->alarmAt(row).alarmId;
             suppressAlarm(alarmId, reason);
         }
     }
@@ -1507,8 +1542,8 @@ void AlarmWidget::onClearSelected()
         QList<int> alarmIds;
         for (const QModelIndex& index : selectedRows) {
             int row = index.row();
-            if (row >= 0 && row < m_activeAlarms.size()) {
-                alarmIds.append(m_activeAlarms[row].alarmId);
+            if (row >= 0 && row < m_activeAlarmsModel->rowCount()) {
+                alarmIds.append(m_activeAlarmsModel->alarmAt(row).alarmId);
             }
         }
         
@@ -1541,8 +1576,6 @@ void AlarmWidget::onClearAll()
 void AlarmWidget::onRefreshAlarms()
 {
     loadActiveAlarms();
-    updateActiveAlarmsTable();
-    updateAlarmSummary();
 }
 
 void AlarmWidget::onExportAlarms()
@@ -1563,7 +1596,6 @@ void AlarmWidget::onConfigureAlarms()
 void AlarmWidget::onShowHistory()
 {
     loadAlarmHistory();
-    updateHistoryTable();
 }
 
 void AlarmWidget::onShowStatistics()
@@ -1576,18 +1608,14 @@ void AlarmWidget::updateStatistics()
     m_statsProgress->setVisible(true);
     m_statsProgress->setRange(0, 0);
     
-    // 在单独线程中计算统计数据
-    QThread* thread = QThread::create([this]() {
-        calculateStatistics();
-    });
-    
-    connect(thread, &QThread::finished, this, [this, thread]() {
+    // 在只读查询线程计算统计数据
+    m_databaseService->read<AlarmStatistics>(&AlarmWidget::calculateStatistics, this,
+                                            [this](const AlarmStatistics& statistics) {
+        m_alarmStatistics = statistics;
         m_statsProgress->setVisible(false);
         updateStatisticsDisplay();
-        thread->deleteLater();
+        LogManager::getInstance()->info("报警统计已更新", "AlarmWidget");
     });
-    
-    thread->start();
 }
 
 void AlarmWidget::onThresholdChanged()
@@ -1729,73 +1757,81 @@ void AlarmWidget::playAlarmSound(AlarmLevel level)
 // UI更新函数实现
 void AlarmWidget::updateActiveAlarmsTable()
 {
-    m_activeAlarmsTable->setRowCount(m_activeAlarms.size());
-    
-    for (int i = 0; i < m_activeAlarms.size(); ++i) {
-        const AlarmRecord& alarm = m_activeAlarms[i];
-        
-        m_activeAlarmsTable->setItem(i, 0, new QTableWidgetItem(QString::number(alarm.alarmId)));
-        m_activeAlarmsTable->setItem(i, 1, new QTableWidgetItem(formatAlarmType(static_cast<AlarmType>(alarm.alarmType))));
-        m_activeAlarmsTable->setItem(i, 2, new QTableWidgetItem(formatAlarmLevel(static_cast<AlarmLevel>(alarm.alarmLevel))));
-        m_activeAlarmsTable->setItem(i, 3, new QTableWidgetItem(formatAlarmStatus(static_cast<AlarmStatus>(alarm.alarmStatus))));
-        m_activeAlarmsTable->setItem(i, 4, new QTableWidgetItem(alarm.alarmCode));
-        m_activeAlarmsTable->setItem(i, 5, new QTableWidgetItem(alarm.alarmMessage));
-        m_activeAlarmsTable->setItem(i, 6, new QTableWidgetItem(alarm.deviceName));
-        m_activeAlarmsTable->setItem(i, 7, new QTableWidgetItem(alarm.parameterName));
-        m_activeAlarmsTable->setItem(i, 8, new QTableWidgetItem(QString::number(alarm.parameterValue, 'f', 2)));
-        m_activeAlarmsTable->setItem(i, 9, new QTableWidgetItem(QString::number(alarm.thresholdValue, 'f', 2)));
-        m_activeAlarmsTable->setItem(i, 10, new QTableWidgetItem(formatDateTime(alarm.timestamp)));
-        m_activeAlarmsTable->setItem(i, 11, new QTableWidgetItem(formatDateTime(alarm.acknowledgeTime)));
-        m_activeAlarmsTable->setItem(i, 12, new QTableWidgetItem(alarm.operatorName));
-        m_activeAlarmsTable->setItem(i, 13, new QTableWidgetItem(QString::number(1)));
-        m_activeAlarmsTable->setItem(i, 14, new QTableWidgetItem(alarm.notes));
-        
-        // 设置行颜色
-        QColor color = getAlarmLevelColor(static_cast<AlarmLevel>(alarm.alarmLevel));
-        for (int j = 0; j < m_activeAlarmsTable->columnCount(); ++j) {
-            QTableWidgetItem* item = m_activeAlarmsTable->item(i, j);
-            if (item) {
-                item->setBackground(color.lighter(180));
-                item->setIcon(getAlarmLevelIcon(static_cast<AlarmLevel>(alarm.alarmLevel)));
-            }
-        }
-    }
-    
+    // 过滤后整体替换模型中的列表，排序由模型保持
+    applyAlarmFilters();
     m_activeAlarmsTable->resizeColumnsToContents();
 }
 
 void AlarmWidget::updateHistoryTable()
 {
-    // 获取历史记录
-    QDateTime startTime = m_historyStartDate->dateTime();
-    QDateTime endTime = m_historyEndDate->dateTime();
-    QList<AlarmRecord> history = getAlarmHistory(startTime, endTime);
-    
-    m_historyTable->setRowCount(history.size());
-    
-    for (int i = 0; i < history.size(); ++i) {
-        const AlarmRecord& alarm = history[i];
-        
-        m_historyTable->setItem(i, 0, new QTableWidgetItem(QString::number(alarm.alarmId)));
-        m_historyTable->setItem(i, 1, new QTableWidgetItem(formatAlarmType(static_cast<AlarmType>(alarm.alarmType))));
-        m_historyTable->setItem(i, 2, new QTableWidgetItem(formatAlarmLevel(static_cast<AlarmLevel>(alarm.alarmLevel))));
-        m_historyTable->setItem(i, 3, new QTableWidgetItem(formatAlarmStatus(static_cast<AlarmStatus>(alarm.alarmStatus))));
-        m_historyTable->setItem(i, 4, new QTableWidgetItem(alarm.alarmCode));
-        m_historyTable->setItem(i, 5, new QTableWidgetItem(alarm.alarmMessage));
-        m_historyTable->setItem(i, 6, new QTableWidgetItem(alarm.deviceName));
-        m_historyTable->setItem(i, 7, new QTableWidgetItem(alarm.parameterName));
-        m_historyTable->setItem(i, 8, new QTableWidgetItem(QString::number(alarm.parameterValue, 'f', 2)));
-        m_historyTable->setItem(i, 9, new QTableWidgetItem(QString::number(alarm.thresholdValue, 'f', 2)));
-        m_historyTable->setItem(i, 10, new QTableWidgetItem(formatDateTime(alarm.timestamp)));
-        m_historyTable->setItem(i, 11, new QTableWidgetItem(formatDateTime(alarm.acknowledgeTime)));
-        m_historyTable->setItem(i, 12, new QTableWidgetItem(formatDateTime(alarm.resolveTime)));
-        m_historyTable->setItem(i, 13, new QTableWidgetItem(alarm.operatorName));
-        m_historyTable->setItem(i, 14, new QTableWidgetItem(alarm.solution));
-        m_historyTable->setItem(i, 15, new QTableWidgetItem(alarm.notes));
-    }
-    
-    m_historyCountLabel->setText(QString("记录数: %1").arg(history.size()));
-    m_historyTable->resizeColumnsToContents();
+    // 历史记录由模型按页异步读取，这里只更新计数和按钮
+    m_historyCountLabel->setText(QString("记录数: %1 / %2").arg(m_historyModel->rowCount()).arg(m_historyModel->totalCount()));
+    m_historyMoreBtn->setEnabled(m_historyModel->canFetchMore(QModelIndex()));
+}
+
+QVariant AlarmWidget::activeAlarmData(const AlarmRecord& alarm, int column, int role) const
+{
+    const AlarmLevel level = static_cast<AlarmLevel>(alarm.alarmLevel);
+    switch (role) {
+    case Qt::BackgroundRole:
+        return getAlarmLevelColor(level).lighter(180);
+    case Qt::DecorationRole:
+        return getAlarmLevelIcon(level);
+    case Qt::UserRole:
+        // 排序用的原始值
+        switch (column) {
+        case 0: return alarm.alarmId;
+        case 1: return alarm.alarmType;
+        case 2: return alarm.alarmLevel;
+        case 3: return alarm.alarmStatus;
+        case 8: return alarm.parameterValue;
+        case 9: return alarm.thresholdValue;
+        case 10: return alarm.timestamp;
+        case 11: return alarm.acknowledgeTime;
+        case 13: return 1;
+        default: return activeAlarmData(alarm, column, Qt::DisplayRole);
+        }
+    case Qt::DisplayRole:
+        switch (column) {
+        case 0: return QString::number(alarm.alarmId);
+        case 1: return formatAlarmType(static_cast<AlarmType>(alarm.alarmType));
+        case 2: return formatAlarmLevel(level);
+        case 3: return formatAlarmStatus(static_cast<AlarmStatus>(alarm.alarmStatus));
+        case 4: return alarm.alarmCode;
+        case 5: return alarm.alarmMessage;
+        case 6: return alarm.deviceName;
+        case 7: return alarm.parameterName;
+        case 8: return QString::number(alarm.parameterValue, 'f', 2);
+        case 9: return QString::number(alarm.thresholdValue, 'f', 2);
+        case 10: return formatDateTime(alarm.timestamp);
+        case 11: return formatDateTime(alarm.acknowledgeTime);
+        case 12: return alarm.operatorName;
+        case 13: return QString::number(1);
+        case 14: return alarm.notes;
+        default: return QVariant();
+        }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant AlarmWidget::historyData(const QVariantList& row, int column, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    const QVariant value = row.value(column);
+    switch (column) {
+    case 1: return formatAlarmType(static_cast<AlarmType>(value.toInt()));
+    case 2: return formatAlarmLevel(static_cast<AlarmLevel>(value.toInt()));
+    case 3: return formatAlarmStatus(static_cast<AlarmStatus>(value.toInt()));
+    case 8:
+    case 9: return QString::number(value.toDouble(), 'f', 2);
+    case 10:
+    case 11:
+    case 12: return formatDateTime(value.toDateTime());
+    default: return value.toString();
+    }
 }
 
 void AlarmWidget::updateThresholdsTable()
@@ -1848,32 +1884,25 @@ void AlarmWidget::updateStatisticsDisplay()
     m_statsOverviewLabel->setText(overview);
     
     // 更新统计表格
-    m_statsTable->setRowCount(0);
+    m_statisticsModel->setRowCount(0);
+    auto addStatisticsRow = [this](const QString& name, int count, const QString& note) {
+        QList<QStandardItem*> items = {
+            new QStandardItem(name), new QStandardItem(QString::number(count)),
+            new QStandardItem("-"), new QStandardItem("-"), new QStandardItem("-"), new QStandardItem(note)
+        };
+        m_statisticsModel->appendRow(items);
+    };
     
     // 按类型统计
     for (auto it = m_alarmStatistics.alarmsByType.begin(); 
          it != m_alarmStatistics.alarmsByType.end(); ++it) {
-        int row = m_statsTable->rowCount();
-        m_statsTable->insertRow(row);
-        m_statsTable->setItem(row, 0, new QTableWidgetItem(formatAlarmType(it.key())));
-        m_statsTable->setItem(row, 1, new QTableWidgetItem(QString::number(it.value())));
-        m_statsTable->setItem(row, 2, new QTableWidgetItem("-"));
-        m_statsTable->setItem(row, 3, new QTableWidgetItem("-"));
-        m_statsTable->setItem(row, 4, new QTableWidgetItem("-"));
-        m_statsTable->setItem(row, 5, new QTableWidgetItem("按类型统计"));
+        addStatisticsRow(formatAlarmType(it.key()), it.value(), "按类型统计");
     }
     
     // 按级别统计
     for (auto it = m_alarmStatistics.alarmsByLevel.begin(); 
          it != m_alarmStatistics.alarmsByLevel.end(); ++it) {
-        int row = m_statsTable->rowCount();
-        m_statsTable->insertRow(row);
-        m_statsTable->setItem(row, 0, new QTableWidgetItem(formatAlarmLevel(it.key())));
-        m_statsTable->setItem(row, 1, new QTableWidgetItem(QString::number(it.value())));
-        m_statsTable->setItem(row, 2, new QTableWidgetItem("-"));
-        m_statsTable->setItem(row, 3, new QTableWidgetItem("-"));
-        m_statsTable->setItem(row, 4, new QTableWidgetItem("-"));
-        m_statsTable->setItem(row, 5, new QTableWidgetItem("按级别统计"));
+        addStatisticsRow(formatAlarmLevel(it.key()), it.value(), "按级别统计");
     }
     
     m_statsTable->resizeColumnsToContents();
@@ -1916,155 +1945,127 @@ void AlarmWidget::updateAlarmSummary()
 // 数据加载函数实现
 void AlarmWidget::loadActiveAlarms()
 {
-    m_activeAlarms.clear();
-    
-    QSqlQuery query(m_database);
-    query.exec("SELECT * FROM alarm_records WHERE alarm_status IN (0, 1, 3) ORDER BY timestamp DESC");
-    
-    while (query.next()) {
-        AlarmRecord alarm;
-        alarm.alarmId = query.value("alarm_id").toInt();
-        alarm.alarmType = static_cast<int>(query.value("alarm_type").toInt());
-        alarm.alarmLevel = static_cast<int>(query.value("alarm_level").toInt());
-        alarm.alarmStatus = static_cast<int>(query.value("alarm_status").toInt());
-        alarm.alarmCode = query.value("alarm_code").toString();
-        alarm.alarmMessage = query.value("alarm_message").toString();
-        alarm.deviceName = query.value("device_name").toString();
-        alarm.parameterName = query.value("parameter_name").toString();
-        alarm.parameterValue = query.value("parameter_value").toDouble();
-        alarm.thresholdValue = query.value("threshold_value").toDouble();
-        alarm.timestamp = query.value("timestamp").toDateTime();
-        alarm.acknowledgeTime = query.value("acknowledge_time").toDateTime();
-        alarm.resolveTime = query.value("resolve_time").toDateTime();
-        alarm.operatorName = query.value("operator_name").toString();
-        alarm.acknowledgeUser = query.value("acknowledge_user").toString();
-        alarm.resolveUser = query.value("resolve_user").toString();
-        alarm.solution = query.value("solution").toString();
-        alarm.notes = query.value("notes").toString();
-        // count field not used
-        // alarm.isAudible = query.value("is_audible").toBool();
-        // alarm.isVisible = query.value("is_visible").toBool();
-        // alarm.category = query.value("category").toString();
-        // alarm.priority = query.value("priority").toInt();
+    m_databaseService->execute(
+        "SELECT * FROM alarm_records WHERE alarm_status IN (0, 1, 3) ORDER BY timestamp DESC", {},
+        this, [this](const DatabaseResult& result) {
+        if (!result.success) {
+            LogManager::getInstance()->error("加载激活报警失败: " + result.error, "AlarmWidget");
+            return;
+        }
         
-        m_activeAlarms.append(alarm);
-    }
-    
-    LogManager::getInstance()->info(QString("加载激活报警: %1 个").arg(m_activeAlarms.size()), "AlarmWidget");
+        m_activeAlarms = alarmsFromResult(result);
+        updateActiveAlarmsTable();
+        updateAlarmSummary();
+        LogManager::getInstance()->info(QString("加载激活报警: %1 个").arg(m_activeAlarms.size()), "AlarmWidget");
+    });
 }
 
 void AlarmWidget::loadAlarmHistory()
 {
-    m_alarmHistory.clear();
-    
-    QDateTime startTime = m_historyStartDate->dateTime();
-    QDateTime endTime = m_historyEndDate->dateTime();
-    
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM alarm_records WHERE timestamp BETWEEN ? AND ? ORDER BY timestamp DESC");
-    query.addBindValue(startTime);
-    query.addBindValue(endTime);
-    query.exec();
-    
-    while (query.next()) {
-        AlarmRecord alarm;
-        alarm.alarmId = query.value("alarm_id").toInt();
-        alarm.alarmType = static_cast<int>(query.value("alarm_type").toInt());
-        alarm.alarmLevel = static_cast<int>(query.value("alarm_level").toInt());
-        alarm.alarmStatus = static_cast<int>(query.value("alarm_status").toInt());
-        alarm.alarmCode = query.value("alarm_code").toString();
-        alarm.alarmMessage = query.value("alarm_message").toString();
-        alarm.deviceName = query.value("device_name").toString();
-        alarm.parameterName = query.value("parameter_name").toString();
-        alarm.parameterValue = query.value("parameter_value").toDouble();
-        alarm.thresholdValue = query.value("threshold_value").toDouble();
-        alarm.timestamp = query.value("timestamp").toDateTime();
-        alarm.acknowledgeTime = query.value("acknowledge_time").toDateTime();
-        alarm.resolveTime = query.value("resolve_time").toDateTime();
-        alarm.operatorName = query.value("operator_name").toString();
-        alarm.acknowledgeUser = query.value("acknowledge_user").toString();
-        alarm.resolveUser = query.value("resolve_user").toString();
-        alarm.solution = query.value("solution").toString();
-        alarm.notes = query.value("notes").toString();
-        // count field not used
-        // alarm.isAudible = query.value("is_audible").toBool();
-        // alarm.isVisible = query.value("is_visible").toBool();
-        // alarm.category = query.value("category").toString();
-        // alarm.priority = query.value("priority").toInt();
-        
-        m_alarmHistory.append(alarm);
+    // 模型先读取总数和第一页，更早的记录在滚动到底部或点击"加载更多"时按页读取
+    QVariantList values;
+    const QString where = DatabaseSchema::alarmHistoryFilter(historyPageQuery(), &values);
+    m_historyModel->setFilter(where, values);
+}
+
+void AlarmWidget::loadMoreAlarmHistory()
+{
+    if (m_historyModel->canFetchMore(QModelIndex())) {
+        m_historyModel->fetchMore(QModelIndex());
+        updateHistoryTable();
     }
-    
-    LogManager::getInstance()->info(QString("加载历史报警: %1 个").arg(m_alarmHistory.size()), "AlarmWidget");
+}
+
+HistoryPageQuery AlarmWidget::historyPageQuery() const
+{
+    // 过滤下拉框第 0 项为"全部"，之后的顺序与 AlarmType / AlarmLevel 一致
+    HistoryPageQuery page;
+    page.startTime = m_historyStartDate->dateTime();
+    page.endTime = m_historyEndDate->dateTime();
+    page.alarmType = m_historyTypeFilter->currentIndex() - 1;
+    page.alarmLevel = m_historyLevelFilter->currentIndex() - 1;
+    page.pageSize = System::DB_HISTORY_PAGE_SIZE;
+    return page;
 }
 
 void AlarmWidget::loadAlarmThresholds()
 {
-    m_alarmThresholds.clear();
-    
-    QSqlQuery query(m_database);
-    query.exec("SELECT * FROM alarm_thresholds ORDER BY parameter_name");
-    
-    while (query.next()) {
-        AlarmThreshold threshold;
-        threshold.parameterName = query.value("parameter_name").toString();
-        threshold.type = static_cast<AlarmType>(query.value("alarm_type").toInt());
-        threshold.level = static_cast<AlarmLevel>(query.value("alarm_level").toInt());
-        threshold.highHigh = query.value("high_high").toDouble();
-        threshold.high = query.value("high_value").toDouble();
-        threshold.low = query.value("low_value").toDouble();
-        threshold.lowLow = query.value("low_low").toDouble();
-        threshold.enableHighHigh = query.value("enable_high_high").toBool();
-        threshold.enableHigh = query.value("enable_high").toBool();
-        threshold.enableLow = query.value("enable_low").toBool();
-        threshold.enableLowLow = query.value("enable_low_low").toBool();
-        threshold.delayTime = query.value("delay_time").toInt();
-        threshold.deadband = query.value("deadband").toInt();
-        threshold.isEnabled = query.value("is_enabled").toBool();
+    m_databaseService->execute("SELECT * FROM alarm_thresholds ORDER BY parameter_name", {},
+                               this, [this](const DatabaseResult& result) {
+        if (!result.success) {
+            LogManager::getInstance()->error("加载报警阈值失败: " + result.error, "AlarmWidget");
+            return;
+        }
         
-        m_alarmThresholds.append(threshold);
-    }
-    
-    LogManager::getInstance()->info(QString("加载报警阈值: %1 个").arg(m_alarmThresholds.size()), "AlarmWidget");
+        m_alarmThresholds.clear();
+        for (const QSqlRecord& record : result.rows) {
+            AlarmThreshold threshold;
+            threshold.parameterName = record.value("parameter_name").toString();
+            threshold.type = static_cast<AlarmType>(record.value("alarm_type").toInt());
+            threshold.level = static_cast<AlarmLevel>(record.value("alarm_level").toInt());
+            threshold.highHigh = record.value("high_high").toDouble();
+            threshold.high = record.value("high_value").toDouble();
+            threshold.low = record.value("low_value").toDouble();
+            threshold.lowLow = record.value("low_low").toDouble();
+            threshold.enableHighHigh = record.value("enable_high_high").toBool();
+            threshold.enableHigh = record.value("enable_high").toBool();
+            threshold.enableLow = record.value("enable_low").toBool();
+            threshold.enableLowLow = record.value("enable_low_low").toBool();
+            threshold.delayTime = record.value("delay_time").toInt();
+            threshold.deadband = record.value("deadband").toInt();
+            threshold.isEnabled = record.value("is_enabled").toBool();
+        
+            m_alarmThresholds.append(threshold);
+        }
+        
+        updateThresholdsTable();
+        syncAlarmLimits();
+        LogManager::getInstance()->info(QString("加载报警阈值: %1 个").arg(m_alarmThresholds.size()), "AlarmWidget");
+    });
 }
 
 void AlarmWidget::loadAlarmConfig()
 {
-    QSqlQuery query(m_database);
-    query.exec("SELECT * FROM alarm_config WHERE id = 1");
+    m_databaseService->execute("SELECT * FROM alarm_config WHERE id = 1", {},
+                               this, [this](const DatabaseResult& result) {
+        if (!result.success) {
+            LogManager::getInstance()->error("加载报警配置失败: " + result.error, "AlarmWidget");
+        }
+        
+        if (!result.rows.isEmpty()) {
+            const QSqlRecord& record = result.rows.first();
+            m_alarmConfig.enableAudibleAlarms = record.value("enable_audible").toBool();
+            m_alarmConfig.enableVisualAlarms = record.value("enable_visual").toBool();
+            m_alarmConfig.enableEmailNotification = record.value("enable_email").toBool();
+            m_alarmConfig.enableSMSNotification = record.value("enable_sms").toBool();
+            m_alarmConfig.enableSystemTray = record.value("enable_tray").toBool();
+            m_alarmConfig.maxActiveAlarms = record.value("max_active_alarms").toInt();
+            m_alarmConfig.autoAcknowledgeTime = record.value("auto_acknowledge_time").toInt();
+            m_alarmConfig.alarmSoundDuration = record.value("sound_duration").toInt();
+            m_alarmConfig.alarmSoundFile = record.value("sound_file").toString();
+            m_alarmConfig.emailRecipients = record.value("email_recipients").toString().split('\n');
+            m_alarmConfig.smsRecipients = record.value("sms_recipients").toString().split('\n');
+            m_alarmConfig.enableAlarmHistory = record.value("enable_history").toBool();
+            m_alarmConfig.maxHistoryRecords = record.value("max_history_records").toInt();
+            m_alarmConfig.enableAlarmStatistics = record.value("enable_statistics").toBool();
+            m_alarmConfig.statisticsUpdateInterval = record.value("statistics_update_interval").toInt();
+        }
     
-    if (query.next()) {
-        m_alarmConfig.enableAudibleAlarms = query.value("enable_audible").toBool();
-        m_alarmConfig.enableVisualAlarms = query.value("enable_visual").toBool();
-        m_alarmConfig.enableEmailNotification = query.value("enable_email").toBool();
-        m_alarmConfig.enableSMSNotification = query.value("enable_sms").toBool();
-        m_alarmConfig.enableSystemTray = query.value("enable_tray").toBool();
-        m_alarmConfig.maxActiveAlarms = query.value("max_active_alarms").toInt();
-        m_alarmConfig.autoAcknowledgeTime = query.value("auto_acknowledge_time").toInt();
-        m_alarmConfig.alarmSoundDuration = query.value("sound_duration").toInt();
-        m_alarmConfig.alarmSoundFile = query.value("sound_file").toString();
-        m_alarmConfig.emailRecipients = query.value("email_recipients").toString().split('\n');
-        m_alarmConfig.smsRecipients = query.value("sms_recipients").toString().split('\n');
-        m_alarmConfig.enableAlarmHistory = query.value("enable_history").toBool();
-        m_alarmConfig.maxHistoryRecords = query.value("max_history_records").toInt();
-        m_alarmConfig.enableAlarmStatistics = query.value("enable_statistics").toBool();
-        m_alarmConfig.statisticsUpdateInterval = query.value("statistics_update_interval").toInt();
-    }
-    
-    // 更新UI控件
-    m_enableAudibleCheckBox->setChecked(m_alarmConfig.enableAudibleAlarms);
-    m_enableVisualCheckBox->setChecked(m_alarmConfig.enableVisualAlarms);
-    m_enableEmailCheckBox->setChecked(m_alarmConfig.enableEmailNotification);
-    m_enableSMSCheckBox->setChecked(m_alarmConfig.enableSMSNotification);
-    m_enableTrayCheckBox->setChecked(m_alarmConfig.enableSystemTray);
-    m_maxActiveAlarmsSpinBox->setValue(m_alarmConfig.maxActiveAlarms);
-    m_autoAckTimeSpinBox->setValue(m_alarmConfig.autoAcknowledgeTime);
-    m_soundDurationSpinBox->setValue(m_alarmConfig.alarmSoundDuration);
-    m_soundFileEdit->setText(m_alarmConfig.alarmSoundFile);
-    m_emailRecipientsEdit->setPlainText(m_alarmConfig.emailRecipients.join('\n'));
-    m_smsRecipientsEdit->setPlainText(m_alarmConfig.smsRecipients.join('\n'));
-    
-    LogManager::getInstance()->info("加载报警配置完成", "AlarmWidget");
+        // 更新UI控件
+        m_enableAudibleCheckBox->setChecked(m_alarmConfig.enableAudibleAlarms);
+        m_enableVisualCheckBox->setChecked(m_alarmConfig.enableVisualAlarms);
+        m_enableEmailCheckBox->setChecked(m_alarmConfig.enableEmailNotification);
+        m_enableSMSCheckBox->setChecked(m_alarmConfig.enableSMSNotification);
+        m_enableTrayCheckBox->setChecked(m_alarmConfig.enableSystemTray);
+        m_maxActiveAlarmsSpinBox->setValue(m_alarmConfig.maxActiveAlarms);
+        m_autoAckTimeSpinBox->setValue(m_alarmConfig.autoAcknowledgeTime);
+        m_soundDurationSpinBox->setValue(m_alarmConfig.alarmSoundDuration);
+        m_soundFileEdit->setText(m_alarmConfig.alarmSoundFile);
+        m_emailRecipientsEdit->setPlainText(m_alarmConfig.emailRecipients.join('\n'));
+        m_smsRecipientsEdit->setPlainText(m_alarmConfig.smsRecipients.join('\n'));
+    
+        LogManager::getInstance()->info("加载报警配置完成", "AlarmWidget");
+    });
 }
 
 // 外部接口实现
@@ -2160,14 +2161,12 @@ void AlarmWidget::cleanupOldAlarms()
     
     QDateTime cutoffTime = QDateTime::currentDateTime().addDays(-30); // 保留30天
     
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM alarm_records WHERE timestamp < ? AND alarm_status = 2");
-    query.addBindValue(cutoffTime);
-    
-    if (query.exec()) {
-        int deletedCount = query.numRowsAffected();
-        LogManager::getInstance()->info(QString("清理旧报警记录: %1 条").arg(deletedCount), "AlarmWidget");
-    }
+    m_databaseService->execute("DELETE FROM alarm_records WHERE timestamp < ? AND alarm_status = 2", {cutoffTime},
+                               this, [](const DatabaseResult& result) {
+        if (result.success) {
+            LogManager::getInstance()->info(QString("清理旧报警记录: %1 条").arg(result.rowsAffected), "AlarmWidget");
+        }
+    });
 }
 
 // 报警管理接口实现
@@ -2342,16 +2341,11 @@ AlarmRecord AlarmWidget::getAlarmRecord(int alarmId)
         }
     }
     
-    // 如果在激活报警中没找到，查询数据库
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM alarm_records WHERE alarm_id = ?");
-    query.addBindValue(alarmId);
-    query.exec();
-    
-    if (query.next()) {
-        AlarmRecord alarm;
-        // 解析数据库记录...
-        return alarm;
+    // 如果在激活报警中没找到，查询数据库（同步接口，会等待数据库线程）
+    const DatabaseResult result = m_databaseService->execute(
+        "SELECT * FROM alarm_records WHERE alarm_id = ?", {alarmId}).result();
+    if (!result.rows.isEmpty()) {
+        return alarmFromRecord(result.rows.first());
     }
     
     return AlarmRecord(); // 返回空记录
@@ -2364,44 +2358,19 @@ QList<AlarmRecord> AlarmWidget::getActiveAlarms()
 
 QList<AlarmRecord> AlarmWidget::getAlarmHistory(const QDateTime& startTime, const QDateTime& endTime)
 {
-    QList<AlarmRecord> history;
-    
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM alarm_records WHERE timestamp BETWEEN ? AND ? ORDER BY timestamp DESC");
-    query.addBindValue(startTime);
-    query.addBindValue(endTime);
-    query.exec();
-    
-    while (query.next()) {
-        AlarmRecord alarm;
-        alarm.alarmId = query.value("alarm_id").toInt();
-        alarm.alarmType = static_cast<int>(query.value("alarm_type").toInt());
-        alarm.alarmLevel = static_cast<int>(query.value("alarm_level").toInt());
-        alarm.alarmStatus = static_cast<int>(query.value("alarm_status").toInt());
-        alarm.alarmCode = query.value("alarm_code").toString();
-        alarm.alarmMessage = query.value("alarm_message").toString();
-        alarm.deviceName = query.value("device_name").toString();
-        alarm.parameterName = query.value("parameter_name").toString();
-        alarm.parameterValue = query.value("parameter_value").toDouble();
-        alarm.thresholdValue = query.value("threshold_value").toDouble();
-        alarm.timestamp = query.value("timestamp").toDateTime();
-        alarm.acknowledgeTime = query.value("acknowledge_time").toDateTime();
-        alarm.resolveTime = query.value("resolve_time").toDateTime();
-        alarm.operatorName = query.value("operator_name").toString();
-        alarm.acknowledgeUser = query.value("acknowledge_user").toString();
-        alarm.resolveUser = query.value("resolve_user").toString();
-        alarm.solution = query.value("solution").toString();
-        alarm.notes = query.value("notes").toString();
-        // count field not used
-        // alarm.isAudible = query.value("is_audible").toBool();
-        // alarm.isVisible = query.value("is_visible").toBool();
-        // alarm.category = query.value("category").toString();
-        // alarm.priority = query.value("priority").toInt();
-        
-        history.append(alarm);
-    }
-    
-    return history;
+    // 同步接口，会等待数据库线程；界面刷新使用 loadAlarmHistory
+    const DatabaseResult result = m_databaseService->execute(
+        "SELECT * FROM alarm_records WHERE timestamp BETWEEN ? AND ? ORDER BY timestamp DESC",
+        {startTime, endTime}).result();
+    return alarmsFromResult(result);
+}
+
+QList<AlarmRecord> AlarmWidget::getAlarmHistoryPage(const HistoryPageQuery& page)
+{
+    // 同步接口，会等待数据库线程
+    const DatabaseResult result = m_databaseService->execute(
+        DatabaseSchema::alarmHistoryPageSql(page), DatabaseSchema::alarmHistoryPageValues(page)).result();
+    return alarmsFromResult(result);
 }
 
 QList<AlarmRecord> AlarmWidget::getAlarmsByType(AlarmType type)
@@ -2496,50 +2465,52 @@ void AlarmWidget::applyAlarmFilters()
     QString levelFilter = m_alarmLevelFilter->currentText();
     QString statusFilter = m_alarmStatusFilter->currentText();
     QString searchText = m_alarmSearchEdit->text();
+    const int columnCount = m_activeAlarmsModel->columnCount();
     
-    for (int i = 0; i < m_activeAlarmsTable->rowCount(); ++i) {
-        bool visible = true;
-        
-        // 类型过滤
-        if (typeFilter != "全部") {
-            QString itemType = m_activeAlarmsTable->item(i, 1)->text();
-            if (itemType != typeFilter) {
-                visible = false;
-            }
+    QList<AlarmRecord> visibleAlarms;
+    for (const AlarmRecord& alarm : m_activeAlarms) {
+        // 类型、级别、状态过滤
+        if (typeFilter != "全部" && formatAlarmType(static_cast<AlarmType>(alarm.alarmType)) != typeFilter) {
+            continue;
         }
-        
-        // 级别过滤
-        if (visible && levelFilter != "全部") {
-            QString itemLevel = m_activeAlarmsTable->item(i, 2)->text();
-            if (itemLevel != levelFilter) {
-                visible = false;
-            }
+        if (levelFilter != "全部" && formatAlarmLevel(static_cast<AlarmLevel>(alarm.alarmLevel)) != levelFilter) {
+            continue;
         }
-        
-        // 状态过滤
-        if (visible && statusFilter != "全部") {
-            QString itemStatus = m_activeAlarmsTable->item(i, 3)->text();
-            if (itemStatus != statusFilter) {
-                visible = false;
-            }
+        if (statusFilter != "全部" && formatAlarmStatus(static_cast<AlarmStatus>(alarm.alarmStatus)) != statusFilter) {
+            continue;
         }
         
         // 搜索过滤
-        if (visible && !searchText.isEmpty()) {
+        if (!searchText.isEmpty()) {
             bool found = false;
-            for (int j = 0; j < m_activeAlarmsTable->columnCount(); ++j) {
-                QTableWidgetItem* item = m_activeAlarmsTable->item(i, j);
-                if (item && item->text().contains(searchText, Qt::CaseInsensitive)) {
-                    found = true;
-                    break;
-                }
+            for (int column = 0; column < columnCount && !found; ++column) {
+                found = activeAlarmData(alarm, column, Qt::DisplayRole).toString().contains(searchText, Qt::CaseInsensitive);
             }
             if (!found) {
-                visible = false;
+                continue;
             }
         }
         
-        m_activeAlarmsTable->setRowHidden(i, !visible);
+        visibleAlarms.append(alarm);
+    }
+    
+    // 替换列表后按报警 ID 恢复选中行
+    QList<int> selectedIds;
+    for (const QModelIndex& index : m_activeAlarmsTable->selectionModel()->selectedRows()) {
+        selectedIds.append(m_activeAlarmsModel->alarmAt(index.row()).alarmId);
+    }
+    
+    m_activeAlarmsModel->setAlarms(visibleAlarms);
+    
+    QItemSelection selection;
+    for (int alarmId : selectedIds) {
+        const int row = m_activeAlarmsModel->rowOf(alarmId);
+        if (row >= 0) {
+            selection.select(m_activeAlarmsModel->index(row, 0), m_activeAlarmsModel->index(row, columnCount - 1));
+        }
+    }
+    if (!selection.isEmpty()) {
+        m_activeAlarmsTable->selectionModel()->select(selection, QItemSelectionModel::Select);
     }
 }
 
@@ -2804,37 +2775,38 @@ void AlarmWidget::showStatisticsDialog()
 // 配置保存和加载
 void AlarmWidget::saveAlarmConfig()
 {
-    QSqlQuery query(m_database);
-    query.prepare(R"(
+    const QVariantList values = {
+        m_alarmConfig.enableAudibleAlarms,
+        m_alarmConfig.enableVisualAlarms,
+        m_alarmConfig.enableEmailNotification,
+        m_alarmConfig.enableSMSNotification,
+        m_alarmConfig.enableSystemTray,
+        m_alarmConfig.maxActiveAlarms,
+        m_alarmConfig.autoAcknowledgeTime,
+        m_alarmConfig.alarmSoundDuration,
+        m_alarmConfig.alarmSoundFile,
+        m_alarmConfig.emailRecipients.join('\n'),
+        m_alarmConfig.smsRecipients.join('\n'),
+        m_alarmConfig.enableAlarmHistory,
+        m_alarmConfig.maxHistoryRecords,
+        m_alarmConfig.enableAlarmStatistics,
+        m_alarmConfig.statisticsUpdateInterval
+    };
+    
+    m_databaseService->execute(R"(
         INSERT OR REPLACE INTO alarm_config (
             id, enable_audible, enable_visual, enable_email, enable_sms, enable_tray,
             max_active_alarms, auto_acknowledge_time, sound_duration, sound_file,
             email_recipients, sms_recipients, enable_history, max_history_records,
             enable_statistics, statistics_update_interval
         ) VALUES (1, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )");
-    
-    query.addBindValue(m_alarmConfig.enableAudibleAlarms);
-    query.addBindValue(m_alarmConfig.enableVisualAlarms);
-    query.addBindValue(m_alarmConfig.enableEmailNotification);
-    query.addBindValue(m_alarmConfig.enableSMSNotification);
-    query.addBindValue(m_alarmConfig.enableSystemTray);
-    query.addBindValue(m_alarmConfig.maxActiveAlarms);
-    query.addBindValue(m_alarmConfig.autoAcknowledgeTime);
-    query.addBindValue(m_alarmConfig.alarmSoundDuration);
-    query.addBindValue(m_alarmConfig.alarmSoundFile);
-    query.addBindValue(m_alarmConfig.emailRecipients.join('\n'));
-    query.addBindValue(m_alarmConfig.smsRecipients.join('\n'));
-    query.addBindValue(m_alarmConfig.enableAlarmHistory);
-    query.addBindValue(m_alarmConfig.maxHistoryRecords);
-    query.addBindValue(m_alarmConfig.enableAlarmStatistics);
-    query.addBindValue(m_alarmConfig.statisticsUpdateInterval);
-    
-    if (query.exec()) {
-        LogManager::getInstance()->info("报警配置已保存", "AlarmWidget");
-    } else {
-        LogManager::getInstance()->error("保存报警配置失败: " + query.lastError().text(), "AlarmWidget");
-    }
+    )", values, this, [](const DatabaseResult& result) {
+        if (result.success) {
+            LogManager::getInstance()->info("报警配置已保存", "AlarmWidget");
+        } else {
+            LogManager::getInstance()->error("保存报警配置失败: " + result.error, "AlarmWidget");
+        }
+    });
 }
 
 void AlarmWidget::resetAlarmConfig()
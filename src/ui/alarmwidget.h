@@ -8,6 +8,7 @@
 #include <QGroupBox>
 #include <QTableWidget>
 #include <QTableWidgetItem>
+#include <QTableView>
 #include <QLabel>
 #include <QPushButton>
 #include <QComboBox>
@@ -42,6 +43,12 @@
 #include <QStyle>
 #include <QSoundEffect>
 #include <QSystemTrayIcon>
+#include "../communication/alarmengine.h"
+
+class DatabaseService;
+class AlarmListModel;
+class SqlPageModel;
+struct HistoryPageQuery;
 
 // 报警级别枚举
 enum class AlarmLevel {
@@ -166,6 +173,8 @@ public:
     AlarmRecord getAlarmRecord(int alarmId);
     QList<AlarmRecord> getActiveAlarms();
     QList<AlarmRecord> getAlarmHistory(const QDateTime& startTime, const QDateTime& endTime);
+    // 按时间倒序返回一页，下一页的游标取返回结果最后一条的时间和 ID
+    QList<AlarmRecord> getAlarmHistoryPage(const HistoryPageQuery& page);
     QList<AlarmRecord> getAlarmsByType(AlarmType type);
     QList<AlarmRecord> getAlarmsByLevel(AlarmLevel level);
     QList<AlarmRecord> getAlarmsByDevice(const QString& deviceName);
@@ -219,6 +228,7 @@ private slots:
     void onUpdateTimer();
     void onStatisticsTimer();
     void onAutoAcknowledgeTimer();
+    void onAlarmTransitions(const AlarmTransitionBatch& transitions);
 
 signals:
     void alarmTriggered(const AlarmRecord& alarm);
@@ -243,16 +253,23 @@ private:
     
     void loadActiveAlarms();
     void loadAlarmHistory();
+    void loadMoreAlarmHistory();    // 显示下一页；表格滚动到底部时模型也会自动读取
+    HistoryPageQuery historyPageQuery() const;
     void loadAlarmThresholds();
     void loadAlarmConfig();
     void updateActiveAlarmsTable();
     void updateHistoryTable();
     void updateThresholdsTable();
+    // 把启用的、参数名对应报警引擎输入通道的阈值交给引擎评估
+    void syncAlarmLimits();
     void updateStatisticsDisplay();
     void updateAlarmSummary();
+    // 表格模型各列的内容
+    QVariant activeAlarmData(const AlarmRecord& alarm, int column, int role) const;
+    QVariant historyData(const QVariantList& row, int column, int role) const;
     
     bool initializeDatabase();
-    bool createTables();
+    static bool createTables(QSqlDatabase& database);     // 在数据库线程执行
     bool insertAlarmRecord(const AlarmRecord& alarm);
     bool updateAlarmRecord(const AlarmRecord& alarm);
     bool deleteAlarmRecord(int alarmId);
@@ -292,7 +309,7 @@ private:
     bool checkThresholdViolation(const AlarmThreshold& threshold, double value) const;
     AlarmLevel determineAlarmLevel(const AlarmThreshold& threshold, double value) const;
     
-    void calculateStatistics();
+    static AlarmStatistics calculateStatistics(QSqlDatabase& database);   // 在数据库线程执行
     void updateAlarmCounts();
     void cleanupOldAlarms();
     
@@ -310,7 +327,7 @@ private:
     
     // 激活报警页面
     QWidget* m_activeAlarmsTab;
-    QTableWidget* m_activeAlarmsTable;
+    QTableView* m_activeAlarmsTable;
     QComboBox* m_alarmTypeFilter;
     QComboBox* m_alarmLevelFilter;
     QComboBox* m_alarmStatusFilter;
@@ -330,7 +347,7 @@ private:
     
     // 历史记录页面
     QWidget* m_historyTab;
-    QTableWidget* m_historyTable;
+    QTableView* m_historyTable;
     QDateTimeEdit* m_historyStartDate;
     QDateTimeEdit* m_historyEndDate;
     QComboBox* m_historyTypeFilter;
@@ -338,6 +355,7 @@ private:
     QPushButton* m_historySearchBtn;
     QPushButton* m_historyExportBtn;
     QPushButton* m_historyClearBtn;
+    QPushButton* m_historyMoreBtn;
     QLabel* m_historyCountLabel;
     
     // 阈值配置页面
@@ -353,7 +371,7 @@ private:
     // 统计分析页面
     QWidget* m_statisticsTab;
     QLabel* m_statsOverviewLabel;
-    QTableWidget* m_statsTable;
+    QTableView* m_statsTable;
     QPushButton* m_updateStatsBtn;
     QPushButton* m_resetStatsBtn;
     QPushButton* m_exportStatsBtn;
@@ -382,24 +400,21 @@ private:
     QSpinBox* m_statisticsUpdateIntervalSpinBox;
     
     // 数据模型
-    QStandardItemModel* m_activeAlarmsModel;
-    QStandardItemModel* m_historyModel;
+    AlarmListModel* m_activeAlarmsModel;        // 过滤后的激活报警
+    SqlPageModel* m_historyModel;               // 按页读取 alarm_records，内存中只保留有限的页
     QStandardItemModel* m_thresholdsModel;
     QStandardItemModel* m_statisticsModel;
-    QSortFilterProxyModel* m_activeAlarmsProxy;
-    QSortFilterProxyModel* m_historyProxy;
     QSortFilterProxyModel* m_thresholdsProxy;
     
     // 数据存储
     QList<AlarmRecord> m_activeAlarms;
-    QList<AlarmRecord> m_alarmHistory;
     QList<AlarmThreshold> m_alarmThresholds;
     AlarmConfig m_alarmConfig;
     AlarmStatistics m_alarmStatistics;
     
     // 数据库
-    QSqlDatabase m_database;
     QString m_databasePath;
+    DatabaseService* m_databaseService;         // 独立线程和连接，界面线程不等待存储
     
     // 定时器
     QTimer* m_updateTimer;
@@ -428,6 +443,7 @@ private:
     static const int STATISTICS_INTERVAL = 60000;      // 统计间隔(ms)
     static const int CLEANUP_INTERVAL = 3600000;       // 清理间隔(ms)
     static const int MAX_DISPLAY_ALARMS = 1000;        // 最大显示报警数
+    static const int HISTORY_TIME_COLUMN = 10;         // 历史表格的发生时间列，默认按它倒序
     static const QStringList ALARM_TYPES;
     static const QStringList ALARM_LEVELS;
     static const QStringList ALARM_STATUSES;
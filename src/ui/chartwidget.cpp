@@ -1,5 +1,10 @@
 #include "chartwidget.h"
 #include "logger/logmanager.h"
+#include "data/sensorhistory.h"
+#include "../utils/seriesdecimator.h"
+#include "../utils/metricsregistry.h"
+#include "../utils/tracer.h"
+#include "../constants.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QStandardPaths>
@@ -13,8 +18,32 @@
 #include <QPixmap>
 #include <QBuffer>
 #include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <cmath>
 #include <algorithm>
+#include <limits>
+
+namespace {
+StatisticsData toStatistics(const TimeSeriesStore::Summary& summary)
+{
+    StatisticsData stats;
+    if (summary.count == 0) {
+        return stats;
+    }
+    stats.count = static_cast<int>(std::min<qint64>(summary.count, std::numeric_limits<int>::max()));
+    stats.sum = summary.sum;
+    stats.average = summary.average();
+    stats.minimum = summary.minimum;
+    stats.maximum = summary.maximum;
+    stats.range = summary.maximum - summary.minimum;
+    stats.variance = summary.variance();
+    stats.stdDeviation = std::sqrt(stats.variance);
+    stats.startTime = QDateTime::fromMSecsSinceEpoch(summary.firstTimestamp);
+    stats.endTime = QDateTime::fromMSecsSinceEpoch(summary.lastTimestamp);
+    return stats;
+}
+}
 
 // 静态常量定义
 const QStringList ChartWidget::CHART_THEMES = {"Light", "Dark", "Blue", "Brown", "Qt"};
@@ -26,6 +55,7 @@ ChartWidget::ChartWidget(QWidget* parent)
     , m_mainSplitter(nullptr)
     , m_updateTimer(nullptr)
     , m_refreshTimer(nullptr)
+    , m_frameTimer(nullptr)
     , m_isRealTimeMonitoring(false)
     , m_isPaused(false)
     , m_analysisThread(nullptr)
@@ -50,6 +80,12 @@ ChartWidget::ChartWidget(QWidget* parent)
     m_refreshTimer->setInterval(5000); // 5秒刷新一次
     connect(m_refreshTimer, &QTimer::timeout, this, &ChartWidget::onRefreshData);
     
+    // 帧定时器：一帧内到达的数据只重绘一次
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setInterval(System::CHART_FRAME_INTERVAL_MS);
+    connect(m_frameTimer, &QTimer::timeout, this, &ChartWidget::onFrameTimer);
+    
     // 初始化图表配置
     initializeChartConfigs();
     
@@ -71,6 +107,10 @@ ChartWidget::~ChartWidget()
     if (m_refreshTimer) {
         m_refreshTimer->stop();
     }
+    if (m_frameTimer) {
+        m_frameTimer->stop();
+    }
+    cancelAnalyses();
     
     // 清理图表
     clearAllCharts();
@@ -177,7 +217,7 @@ void ChartWidget::setupControlPanel()
     optionLayout->addWidget(m_autoScaleCheckBox);
     
     m_animationCheckBox = new QCheckBox("启用动画");
-    m_animationCheckBox->setChecked(true);
+    m_animationCheckBox->setChecked(false);
     optionLayout->addWidget(m_animationCheckBox);
     
     m_legendCheckBox = new QCheckBox("显示图例");
@@ -188,6 +228,11 @@ void ChartWidget::setupControlPanel()
     m_gridCheckBox->setChecked(true);
     optionLayout->addWidget(m_gridCheckBox);
     
+    m_openGLCheckBox = new QCheckBox("OpenGL加速");
+    m_openGLCheckBox->setChecked(false);
+    m_openGLCheckBox->setToolTip("折线和散点系列用 OpenGL 绘制，适合高频大数据量曲线");
+    optionLayout->addWidget(m_openGLCheckBox);
+    
     optionLayout->addStretch();
     layout->addLayout(optionLayout, 3, 0, 1, 4);
 }
@@ -285,6 +330,7 @@ void ChartWidget::setupConnections()
     connect(m_animationCheckBox, &QCheckBox::toggled, this, &ChartWidget::onAnimationToggled);
     connect(m_legendCheckBox, &QCheckBox::toggled, this, &ChartWidget::onLegendToggled);
     connect(m_gridCheckBox, &QCheckBox::toggled, this, &ChartWidget::onGridToggled);
+    connect(m_openGLCheckBox, &QCheckBox::toggled, this, &ChartWidget::onOpenGLToggled);
     
     // 统计面板连接
     connect(m_showStatsButton, &QPushButton::clicked, this, &ChartWidget::onShowStatistics);
@@ -630,29 +676,127 @@ void ChartWidget::applyChartTheme(QChart* chart)
 }
 
 // 数据管理功能
-void ChartWidget::addDataPoint(ChartType type, const ChartData& data)
+ChartSeries& ChartWidget::seriesFor(ChartType type, const ChartData& data)
+{
+    // 系列第一次出现时按图表的最大点数一次分配缓冲区，之后追加不再分配
+    QMap<QString, ChartSeries>& seriesMap = m_chartData[type];
+    auto it = seriesMap.find(data.name);
+    if (it == seriesMap.end()) {
+        it = seriesMap.insert(data.name, ChartSeries(data.name, m_chartConfigs[type].maxDataPoints, data.unit));
+        it->category = data.category;
+        it->color = data.color;
+    }
+    return it.value();
+}
+
+QList<QPointF> ChartWidget::renderPoints(ChartType type, const SeriesRingBuffer::View& data) const
 {
-    QMutexLocker locker(&m_dataMutex);
-    
-    if (!m_chartData.contains(type)) {
-        m_chartData[type] = QMap<QString, QList<ChartData>>();
+    if (data.isEmpty()) {
+        return QList<QPointF>();
     }
-    
-    if (!m_chartData[type].contains(data.name)) {
-        m_chartData[type][data.name] = QList<ChartData>();
+
+    // 未缩放时可见范围就是整个缓冲区
+    qint64 startMs = data.timestampAt(0);
+    qint64 endMs = data.timestampAt(data.size() - 1);
+    const auto range = m_viewRanges.constFind(type);
+    if (range != m_viewRanges.constEnd()) {
+        startMs = range->first;
+        endMs = range->second;
     }
+
+    // 每个像素列最多两个点，再多 QtCharts 也画不出区别
+    QChart* chart = m_charts.value(type);
+    const int width = chart ? static_cast<int>(chart->plotArea().width()) : 0;
+    const int columns = std::min(width > 0 ? width : System::CHART_DEFAULT_RENDER_COLUMNS,
+                                 System::CHART_MAX_RENDER_POINTS / 2);
+
+    if (type == ChartType::HistoryTrend || type == ChartType::ComparisonAnalysis) {
+        return SeriesDecimator::lttb(data, startMs, endMs, 2 * columns);
+    }
+    return SeriesDecimator::minMax(data, startMs, endMs, columns);
+}
+
+bool ChartWidget::dataExtent(ChartType type, qint64* startMs, qint64* endMs) const
+{
+    bool found = false;
+    for (const ChartSeries& series : m_chartData.value(type)) {
+        const SeriesRingBuffer::View data = series.points.view();
+        if (data.isEmpty()) continue;
+        const qint64 first = data.timestampAt(0);
+        const qint64 last = data.timestampAt(data.size() - 1);
+        *startMs = found ? std::min(*startMs, first) : first;
+        *endMs = found ? std::max(*endMs, last) : last;
+        found = true;
+    }
+    return found;
+}
+
+void ChartWidget::applyViewRange(ChartType type)
+{
+    const auto range = m_viewRanges.constFind(type);
+    QChart* chart = m_charts.value(type);
+    if (range == m_viewRanges.constEnd() || !chart) return;
+
+    for (QAbstractAxis* axis : chart->axes(Qt::Horizontal)) {
+        if (QDateTimeAxis* timeAxis = qobject_cast<QDateTimeAxis*>(axis)) {
+            timeAxis->setRange(QDateTime::fromMSecsSinceEpoch(range->first),
+                               QDateTime::fromMSecsSinceEpoch(range->second));
+        }
+    }
+}
+
+void ChartWidget::scheduleChartUpdate(ChartType type)
+{
+    if (!m_pendingCharts.contains(type)) {
+        m_pendingCharts.append(type);
+    }
+    if (!m_frameTimer->isActive()) {
+        m_frameTimer->start();
+    }
+}
+
+void ChartWidget::onFrameTimer()
+{
+    TRACE_SCOPE("chart", "ChartWidget::onFrameTimer");
+    QMutexLocker locker(&m_dataMutex);
     
-    // 添加数据点
-    m_chartData[type][data.name].append(data);
+    const QList<ChartType> pending = m_pendingCharts;
+    m_pendingCharts.clear();
     
-    // 限制数据点数量
-    const ChartConfig& config = m_chartConfigs[type];
-    while (m_chartData[type][data.name].size() > config.maxDataPoints) {
-        m_chartData[type][data.name].removeFirst();
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    for (ChartType type : pending) {
+        updateChart(type);
+    }
+    if (!pending.isEmpty()) {
+        static MetricHistogram* const frameMetric = MetricsRegistry::histogram(
+            "glue_ui_frame_seconds", "界面一次刷新的耗时", MetricsRegistry::label("widget", "chart"),
+            MetricsRegistry::frameBucketsNs());
+        const qint64 frameNs = frameTimer.nsecsElapsed();
+        m_frameTimes.record(frameNs);
+        frameMetric->observe(frameNs);
     }
+}
+
+LatencyHistogram ChartWidget::frameTimeHistogram() const
+{
+    return m_frameTimes;
+}
+
+void ChartWidget::resetFrameTimeHistogram()
+{
+    m_frameTimes.reset();
+}
+
+void ChartWidget::addDataPoint(ChartType type, const ChartData& data)
+{
+    QMutexLocker locker(&m_dataMutex);
     
-    // 更新图表
-    updateChart(type);
+    // 满了之后覆盖最旧的点
+    seriesFor(type, data).append(data.timestamp.toMSecsSinceEpoch(), data.value);
+    
+    // 更新图表，同一帧内的数据点合并重绘
+    scheduleChartUpdate(type);
     
     emit chartDataChanged(type, data.name);
 }
@@ -661,24 +805,35 @@ void ChartWidget::addDataSeries(ChartType type, const QString& seriesName, const
 {
     QMutexLocker locker(&m_dataMutex);
     
-    if (!m_chartData.contains(type)) {
-        m_chartData[type] = QMap<QString, QList<ChartData>>();
+    ChartSeries series(seriesName, m_chartConfigs[type].maxDataPoints, data.isEmpty() ? QString() : data.first().unit);
+    if (!data.isEmpty()) {
+        series.category = data.first().category;
+        series.color = data.first().color;
     }
-    
-    m_chartData[type][seriesName] = data;
-    
-    // 限制数据点数量
-    const ChartConfig& config = m_chartConfigs[type];
-    while (m_chartData[type][seriesName].size() > config.maxDataPoints) {
-        m_chartData[type][seriesName].removeFirst();
+    // 超过最大点数时只保留最新的点
+    for (const ChartData& point : data) {
+        series.append(point.timestamp.toMSecsSinceEpoch(), point.value);
     }
+    m_chartData[type].insert(seriesName, series);
     
     // 更新图表
-    updateChart(type);
+    scheduleChartUpdate(type);
     
     emit chartDataChanged(type, seriesName);
 }
 
+SeriesRingBuffer::View ChartWidget::getChartData(ChartType type, const QString& seriesName)
+{
+    QMutexLocker locker(&m_dataMutex);
+    
+    const auto typeIt = m_chartData.constFind(type);
+    if (typeIt == m_chartData.constEnd()) {
+        return SeriesRingBuffer::View();
+    }
+    const auto it = typeIt->constFind(seriesName);
+    return it == typeIt->constEnd() ? SeriesRingBuffer::View() : it->points.view();
+}
+
 void ChartWidget::updateChart(ChartType type)
 {
     if (!m_charts.contains(type)) return;
@@ -713,112 +868,36 @@ void ChartWidget::updateChart(ChartType type)
             updateComparisonChart();
             break;
     }
+    
+    applyViewRange(type);
 }
 
 void ChartWidget::updateRealTimeChart()
 {
-    ChartType type = ChartType::RealTimeMonitor;
-    QChart* chart = m_charts[type];
-    if (!chart) return;
-    
-    // 清除现有系列
-    chart->removeAllSeries();
-    
-    // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QLineSeries* series = new QLineSeries();
-            series->setName(seriesName);
-            series->setPen(QPen(generateSeriesColor(seriesIndex), 2));
-            
-            for (const ChartData& point : data) {
-                series->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-            }
-            
-            chart->addSeries(series);
-            seriesIndex++;
-        }
-    }
-    
-    // 更新坐标轴
-    updateChartAxes(chart, m_chartConfigs[type]);
+    syncXYSeries(ChartType::RealTimeMonitor, [this](int index) -> QXYSeries* {
+        QLineSeries* series = new QLineSeries();
+        series->setPen(QPen(generateSeriesColor(index), 2));
+        return series;
+    });
 }
 
 void ChartWidget::updateHistoryChart()
 {
-    ChartType type = ChartType::HistoryTrend;
-    QChart* chart = m_charts[type];
-    if (!chart) return;
-    
-    // 清除现有系列
-    chart->removeAllSeries();
-    
-    // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QSplineSeries* series = new QSplineSeries();
-            series->setName(seriesName);
-            series->setPen(QPen(generateSeriesColor(seriesIndex), 2));
-            
-            for (const ChartData& point : data) {
-                series->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-            }
-            
-            chart->addSeries(series);
-            seriesIndex++;
-        }
-    }
-    
-    // 更新坐标轴
-    updateChartAxes(chart, m_chartConfigs[type]);
+    syncXYSeries(ChartType::HistoryTrend, [this](int index) -> QXYSeries* {
+        QSplineSeries* series = new QSplineSeries();
+        series->setPen(QPen(generateSeriesColor(index), 2));
+        return series;
+    });
 }
 
 void ChartWidget::updateQualityChart()
 {
-    ChartType type = ChartType::QualityAnalysis;
-    QChart* chart = m_charts[type];
-    if (!chart) return;
-    
-    // 清除现有系列
-    chart->removeAllSeries();
-    
-    // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QScatterSeries* series = new QScatterSeries();
-            series->setName(seriesName);
-            series->setColor(generateSeriesColor(seriesIndex));
-            series->setMarkerSize(8);
-            
-            for (const ChartData& point : data) {
-                series->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-            }
-            
-            chart->addSeries(series);
-            seriesIndex++;
-        }
-    }
-    
-    // 更新坐标轴
-    updateChartAxes(chart, m_chartConfigs[type]);
+    syncXYSeries(ChartType::QualityAnalysis, [this](int index) -> QXYSeries* {
+        QScatterSeries* series = new QScatterSeries();
+        series->setColor(generateSeriesColor(index));
+        series->setMarkerSize(8);
+        return series;
+    });
 }
 
 void ChartWidget::updateProductionChart()
@@ -836,14 +915,12 @@ void ChartWidget::updateProductionChart()
     if (m_chartData.contains(type)) {
         for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
             const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
+            const SeriesRingBuffer::View data = it.value().points.view();
             
             if (data.isEmpty()) continue;
             
             QBarSet* barSet = new QBarSet(seriesName);
-            for (const ChartData& point : data) {
-                *barSet << point.value;
-            }
+            data.forEach([barSet](qint64, double value) { *barSet << value; });
             
             barSeries->append(barSet);
         }
@@ -857,37 +934,11 @@ void ChartWidget::updateProductionChart()
 
 void ChartWidget::updateAlarmChart()
 {
-    ChartType type = ChartType::AlarmAnalysis;
-    QChart* chart = m_charts[type];
-    if (!chart) return;
-    
-    // 清除现有系列
-    chart->removeAllSeries();
-    
-    // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QLineSeries* series = new QLineSeries();
-            series->setName(seriesName);
-            series->setPen(QPen(generateSeriesColor(seriesIndex), 2));
-            
-            for (const ChartData& point : data) {
-                series->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-            }
-            
-            chart->addSeries(series);
-            seriesIndex++;
-        }
-    }
-    
-    // 更新坐标轴
-    updateChartAxes(chart, m_chartConfigs[type]);
+    syncXYSeries(ChartType::AlarmAnalysis, [this](int index) -> QXYSeries* {
+        QLineSeries* series = new QLineSeries();
+        series->setPen(QPen(generateSeriesColor(index), 2));
+        return series;
+    });
 }
 
 void ChartWidget::updatePerformanceChart()
@@ -896,144 +947,173 @@ void ChartWidget::updatePerformanceChart()
     QChart* chart = m_charts[type];
     if (!chart) return;
     
-    // 清除现有系列
-    chart->removeAllSeries();
+    // 已有的面积系列按名称复用，只替换上下边界的数据点
+    QMap<QString, QAreaSeries*> existing;
+    for (QAbstractSeries* series : chart->series()) {
+        if (QAreaSeries* area = qobject_cast<QAreaSeries*>(series)) {
+            existing.insert(area->name(), area);
+        }
+    }
     
     // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QAreaSeries* series = new QAreaSeries();
-            series->setName(seriesName);
-            
-            QLineSeries* upperSeries = new QLineSeries();
-            QLineSeries* lowerSeries = new QLineSeries();
-            
-            for (const ChartData& point : data) {
-                upperSeries->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-                lowerSeries->append(point.timestamp.toMSecsSinceEpoch(), 0);
-            }
-            
-            series->setUpperSeries(upperSeries);
-            series->setLowerSeries(lowerSeries);
+    int seriesIndex = 0;
+    for (auto it = m_chartData[type].cbegin(); it != m_chartData[type].cend(); ++it) {
+        const SeriesRingBuffer::View data = it.value().points.view();
+        if (data.isEmpty()) continue;
+        
+        QAreaSeries* series = existing.take(it.key());
+        if (!series) {
+            series = new QAreaSeries(new QLineSeries(), new QLineSeries());
+            series->setName(it.key());
             series->setColor(generateSeriesColor(seriesIndex));
-            
             chart->addSeries(series);
-            seriesIndex++;
         }
+        
+        const QList<QPointF> points = renderPoints(type, data);
+        QList<QPointF> baseline;
+        baseline.reserve(points.size());
+        for (const QPointF& point : points) {
+            baseline.append(QPointF(point.x(), 0));
+        }
+        series->upperSeries()->replace(points);
+        series->lowerSeries()->replace(baseline);
+        seriesIndex++;
+    }
+    
+    for (QAreaSeries* series : existing) {
+        chart->removeSeries(series);
+        delete series;
     }
     
     // 更新坐标轴
     updateChartAxes(chart, m_chartConfigs[type]);
 }
 
-void ChartWidget::updateProcessChart()
+void ChartWidget::syncXYSeries(ChartType type, const std::function<QXYSeries*(int index)>& create)
 {
-    ChartType type = ChartType::ProcessControl;
-    QChart* chart = m_charts[type];
+    QChart* chart = m_charts.value(type);
     if (!chart) return;
     
-    // 清除现有系列
-    chart->removeAllSeries();
+    QMap<QString, QXYSeries*> existing;
+    for (QAbstractSeries* series : chart->series()) {
+        if (QXYSeries* xySeries = qobject_cast<QXYSeries*>(series)) {
+            existing.insert(xySeries->name(), xySeries);
+        }
+    }
     
-    // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QLineSeries* series = new QLineSeries();
-            series->setName(seriesName);
-            series->setPen(QPen(generateSeriesColor(seriesIndex), 2));
-            
-            for (const ChartData& point : data) {
-                series->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-            }
-            
+    const ChartConfig& config = m_chartConfigs[type];
+    int seriesIndex = 0;
+    for (auto it = m_chartData[type].cbegin(); it != m_chartData[type].cend(); ++it) {
+        const SeriesRingBuffer::View data = it.value().points.view();
+        if (data.isEmpty()) continue;
+        
+        QXYSeries* series = existing.take(it.key());
+        if (!series) {
+            series = create(seriesIndex);
+            series->setName(it.key());
+            series->setUseOpenGL(config.useOpenGL);
             chart->addSeries(series);
-            seriesIndex++;
         }
+        // 整体替换只发出一次 pointsReplaced，不会每个点各触发一次重绘
+        series->replace(renderPoints(type, data));
+        seriesIndex++;
+    }
+    
+    for (QXYSeries* series : existing) {
+        chart->removeSeries(series);
+        delete series;
     }
     
     // 更新坐标轴
-    updateChartAxes(chart, m_chartConfigs[type]);
+    updateChartAxes(chart, config);
+}
+
+void ChartWidget::updateProcessChart()
+{
+    syncXYSeries(ChartType::ProcessControl, [this](int index) -> QXYSeries* {
+        QLineSeries* series = new QLineSeries();
+        series->setPen(QPen(generateSeriesColor(index), 2));
+        return series;
+    });
 }
 
 void ChartWidget::updateComparisonChart()
 {
-    ChartType type = ChartType::ComparisonAnalysis;
-    QChart* chart = m_charts[type];
-    if (!chart) return;
-    
-    // 清除现有系列
-    chart->removeAllSeries();
-    
-    // 添加数据系列
-    if (m_chartData.contains(type)) {
-        int seriesIndex = 0;
-        for (auto it = m_chartData[type].begin(); it != m_chartData[type].end(); ++it) {
-            const QString& seriesName = it.key();
-            const QList<ChartData>& data = it.value();
-            
-            if (data.isEmpty()) continue;
-            
-            QSplineSeries* series = new QSplineSeries();
-            series->setName(seriesName);
-            series->setPen(QPen(generateSeriesColor(seriesIndex), 2));
-            
-            for (const ChartData& point : data) {
-                series->append(point.timestamp.toMSecsSinceEpoch(), point.value);
-            }
-            
-            chart->addSeries(series);
-            seriesIndex++;
-        }
-    }
-    
-    // 更新坐标轴
-    updateChartAxes(chart, m_chartConfigs[type]);
+    syncXYSeries(ChartType::ComparisonAnalysis, [this](int index) -> QXYSeries* {
+        QSplineSeries* series = new QSplineSeries();
+        series->setPen(QPen(generateSeriesColor(index), 2));
+        return series;
+    });
 }
 
 void ChartWidget::updateChartAxes(QChart* chart, const ChartConfig& config)
 {
     if (!chart) return;
     
-    // 移除现有坐标轴
+    // 坐标轴创建一次后复用，每帧只更新范围
+    QDateTimeAxis* xAxis = nullptr;
+    QValueAxis* yAxis = nullptr;
     for (QAbstractAxis* axis : chart->axes()) {
-        chart->removeAxis(axis);
-        delete axis;
+        if (!xAxis && axis->alignment() == Qt::AlignBottom) {
+            xAxis = qobject_cast<QDateTimeAxis*>(axis);
+        } else if (!yAxis && axis->alignment() == Qt::AlignLeft) {
+            yAxis = qobject_cast<QValueAxis*>(axis);
+        }
     }
     
-    // 创建X轴（时间轴）
-    QDateTimeAxis* xAxis = new QDateTimeAxis;
+    if (!xAxis) {
+        // 创建X轴（时间轴）
+        xAxis = new QDateTimeAxis;
+        xAxis->setFormat("hh:mm:ss");
+        xAxis->setTickCount(10);
+        chart->addAxis(xAxis, Qt::AlignBottom);
+    }
+    if (!yAxis) {
+        // 创建Y轴（数值轴）
+        yAxis = new QValueAxis;
+        yAxis->setLabelFormat("%.2f");
+        chart->addAxis(yAxis, Qt::AlignLeft);
+    }
     xAxis->setTitleText(config.xAxisTitle);
-    xAxis->setFormat("hh:mm:ss");
-    xAxis->setTickCount(10);
-    chart->addAxis(xAxis, Qt::AlignBottom);
-    
-    // 创建Y轴（数值轴）
-    QValueAxis* yAxis = new QValueAxis;
     yAxis->setTitleText(config.yAxisTitle);
-    yAxis->setLabelFormat("%.2f");
-    if (config.autoScale) {
-        yAxis->applyNiceNumbers();
-    } else {
-        yAxis->setRange(config.minValue, config.maxValue);
-    }
-    chart->addAxis(yAxis, Qt::AlignLeft);
     
-    // 将系列附加到坐标轴
+    // 将新系列附加到坐标轴，同时统计绘制点的范围
+    qreal minX = std::numeric_limits<qreal>::max();
+    qreal maxX = std::numeric_limits<qreal>::lowest();
+    qreal minY = std::numeric_limits<qreal>::max();
+    qreal maxY = std::numeric_limits<qreal>::lowest();
+    const auto extend = [&](const QXYSeries* series) {
+        for (const QPointF& point : series->points()) {
+            minX = std::min(minX, point.x());
+            maxX = std::max(maxX, point.x());
+            minY = std::min(minY, point.y());
+            maxY = std::max(maxY, point.y());
+        }
+    };
     for (QAbstractSeries* series : chart->series()) {
-        series->attachAxis(xAxis);
-        series->attachAxis(yAxis);
+        if (series->attachedAxes().isEmpty()) {
+            series->attachAxis(xAxis);
+            series->attachAxis(yAxis);
+        }
+        if (const QXYSeries* xySeries = qobject_cast<QXYSeries*>(series)) {
+            extend(xySeries);
+        } else if (const QAreaSeries* area = qobject_cast<QAreaSeries*>(series)) {
+            extend(area->upperSeries());
+            if (area->lowerSeries()) {
+                extend(area->lowerSeries());
+            }
+        }
+    }
+    
+    if (minX <= maxX) {
+        xAxis->setRange(QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(minX)),
+                        QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(maxX)));
+    }
+    if (!config.autoScale) {
+        yAxis->setRange(config.minValue, config.maxValue);
+    } else if (minY <= maxY) {
+        yAxis->setRange(minY, maxY > minY ? maxY : minY + 1);
+        yAxis->applyNiceNumbers();
     }
     
     // 设置网格
@@ -1048,39 +1128,6 @@ void ChartWidget::updateChartAxes(QChart* chart, const ChartConfig& config)
     }
 }
 
-QColor ChartWidget::generateSeriesColor(int index) const
-{
-    // 预定义颜色列表
-    static const QList<QColor> colors = {
-        QColor(31, 119, 180),   // 蓝色
-        QColor(255, 127, 14),   // 橙色
-        QColor(44, 160, 44),    // 绿色
-        QColor(214, 39, 40),    // 红色
-        QColor(148, 103, 189),  // 紫色
-        QColor(140, 86, 75),    // 棕色
-        QColor(227, 119, 194),  // 粉色
-        QColor(127, 127, 127),  // 灰色
-        QColor(188, 189, 34),   // 黄绿色
-        QColor(23, 190, 207)    // 青色
-    };
-    
-    return colors[index % colors.size()];
-}
-
-QString ChartWidget::formatValue(double value, const QString& unit) const
-{
-    if (unit.isEmpty()) {
-        return QString::number(value, 'f', 2);
-    }
-    return QString("%1 %2").arg(value, 0, 'f', 2).arg(unit);
-}
-
-QString ChartWidget::formatTime(const QDateTime& time) const
-{
-    return time.toString("yyyy-MM-dd hh:mm:ss");
-}
-
-// 实时监控功能
 void ChartWidget::startRealTimeMonitoring()
 {
     if (m_isRealTimeMonitoring) return;
@@ -1104,7 +1151,7 @@ void ChartWidget::stopRealTimeMonitoring()
     m_updateTimer->stop();
     m_refreshTimer->stop();
     
-    LogManager::getInstance()->info("停止实时监控", "Chart");
+    LogManager::getInstance()->info("停止实时监控，图表帧耗时: " + m_frameTimes.summary(), "Chart");
 }
 
 void ChartWidget::pauseRealTimeMonitoring()
@@ -1141,39 +1188,55 @@ StatisticsData ChartWidget::calculateStatistics(ChartType type, const QString& s
         return stats;
     }
     
-    const QList<ChartData>& data = m_chartData[type][seriesName];
-    calculateSeriesStatistics(data, stats);
+    // 统计量随数据点增量维护，这里只读取
+    const ChartSeries& series = m_chartData[type][seriesName];
+    const SeriesRingBuffer::View data = series.points.view();
+    if (data.isEmpty()) {
+        return stats;
+    }
+    
+    const RunningStatistics& running = series.statistics;
+    stats.count = static_cast<int>(running.count());
+    stats.sum = running.sum();
+    stats.average = running.mean();
+    stats.minimum = running.minimum();
+    stats.maximum = running.maximum();
+    stats.range = stats.maximum - stats.minimum;
+    stats.variance = running.variance();
+    stats.stdDeviation = running.stdDeviation();
+    stats.startTime = QDateTime::fromMSecsSinceEpoch(data.timestampAt(0));
+    stats.endTime = QDateTime::fromMSecsSinceEpoch(data.timestampAt(data.size() - 1));
     
     return stats;
 }
 
-void ChartWidget::calculateSeriesStatistics(const QList<ChartData>& data, StatisticsData& stats)
+void ChartWidget::calculateSeriesStatistics(const SeriesRingBuffer::View& data, StatisticsData& stats)
 {
     if (data.isEmpty()) return;
     
     stats.count = data.size();
     stats.sum = 0;
-    stats.minimum = data.first().value;
-    stats.maximum = data.first().value;
-    stats.startTime = data.first().timestamp;
-    stats.endTime = data.last().timestamp;
+    stats.minimum = data.valueAt(0);
+    stats.maximum = data.valueAt(0);
+    stats.startTime = QDateTime::fromMSecsSinceEpoch(data.timestampAt(0));
+    stats.endTime = QDateTime::fromMSecsSinceEpoch(data.timestampAt(data.size() - 1));
     
     // 计算基本统计量
-    for (const ChartData& point : data) {
-        stats.sum += point.value;
-        stats.minimum = std::min(stats.minimum, point.value);
-        stats.maximum = std::max(stats.maximum, point.value);
-    }
+    data.forEach([&stats](qint64, double value) {
+        stats.sum += value;
+        stats.minimum = std::min(stats.minimum, value);
+        stats.maximum = std::max(stats.maximum, value);
+    });
     
     stats.average = stats.sum / stats.count;
     stats.range = stats.maximum - stats.minimum;
     
     // 计算方差和标准偏差
     double variance = 0;
-    for (const ChartData& point : data) {
-        double diff = point.value - stats.average;
+    data.forEach([&variance, &stats](qint64, double value) {
+        double diff = value - stats.average;
         variance += diff * diff;
-    }
+    });
     stats.variance = variance / stats.count;
     stats.stdDeviation = std::sqrt(stats.variance);
 }
@@ -1274,6 +1337,13 @@ void ChartWidget::onUpdateTimer()
     // 更新实时监控图表
     updateChart(ChartType::RealTimeMonitor);
     
+    // 趋势预测在后台计算，结果通过 trendPredicted 返回
+    if (m_enableTrendPrediction) {
+        for (const QString& seriesName : m_chartData.value(ChartType::RealTimeMonitor).keys()) {
+            requestTrendPrediction(ChartType::RealTimeMonitor, seriesName);
+        }
+    }
+    
     m_lastUpdateTime = QDateTime::currentDateTime();
 }
 
@@ -1367,6 +1437,21 @@ void ChartWidget::onGridToggled(bool enabled)
     updateChart(type);
 }
 
+void ChartWidget::onOpenGLToggled(bool enabled)
+{
+    int chartIndex = m_tabWidget->currentIndex();
+    ChartType type = static_cast<ChartType>(chartIndex);
+    
+    m_chartConfigs[type].useOpenGL = enabled;
+    
+    // QtCharts 只有折线和散点系列支持 OpenGL，其他系列忽略该设置
+    if (m_charts.contains(type)) {
+        for (QAbstractSeries* series : m_charts[type]->series()) {
+            series->setUseOpenGL(enabled);
+        }
+    }
+}
+
 void ChartWidget::onShowStatistics()
 {
     QString seriesName = m_seriesCombo->currentText();
@@ -1408,7 +1493,12 @@ void ChartWidget::onShowComparison()
 // 图表操作功能
 void ChartWidget::refreshChart(ChartType type)
 {
-    updateChart(type);
+    if (type == ChartType::HistoryTrend) {
+        // 历史图表每次按当前时间范围从存储重新读取
+        loadHistoryData(m_startTimeEdit->dateTime(), m_endTimeEdit->dateTime());
+    } else {
+        updateChart(type);
+    }
     
     // 更新统计信息
     updateStatisticsDisplay(type);
@@ -1470,28 +1560,41 @@ void ChartWidget::printChart(ChartType type)
 
 void ChartWidget::zoomChart(ChartType type, double factor)
 {
-    if (!m_chartViews.contains(type)) return;
+    if (!m_charts.contains(type) || factor <= 0) return;
     
-    QChartView* chartView = m_chartViews[type];
-    if (!chartView) return;
+    // 围绕当前可见范围的中点缩放时间轴，然后按新的范围重新降采样
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    const auto range = m_viewRanges.constFind(type);
+    if (range != m_viewRanges.constEnd()) {
+        startMs = range->first;
+        endMs = range->second;
+    } else if (!dataExtent(type, &startMs, &endMs)) {
+        return;
+    }
     
-    QChart* chart = chartView->chart();
-    if (!chart) return;
+    const qint64 center = startMs + (endMs - startMs) / 2;
+    const qint64 halfSpan = std::max<qint64>(1, static_cast<qint64>((endMs - startMs) / (2 * factor)));
+    const QPair<qint64, qint64> zoomed(center - halfSpan, center + halfSpan);
+    
+    // 缩小到覆盖全部数据时回到未缩放状态，时间轴重新跟随新数据
+    qint64 dataStart = 0;
+    qint64 dataEnd = 0;
+    if (dataExtent(type, &dataStart, &dataEnd) && zoomed.first <= dataStart && zoomed.second >= dataEnd) {
+        m_viewRanges.remove(type);
+    } else {
+        m_viewRanges.insert(type, zoomed);
+    }
     
-    chart->zoom(factor);
+    updateChart(type);
 }
 
 void ChartWidget::resetZoom(ChartType type)
 {
-    if (!m_chartViews.contains(type)) return;
-    
-    QChartView* chartView = m_chartViews[type];
-    if (!chartView) return;
-    
-    QChart* chart = chartView->chart();
-    if (!chart) return;
+    if (!m_charts.contains(type)) return;
     
-    chart->zoomReset();
+    m_viewRanges.remove(type);
+    updateChart(type);
 }
 
 // 辅助功能
@@ -1567,8 +1670,9 @@ void ChartWidget::performTrendAnalysis(ChartType type, const QString& seriesName
         return;
     }
     
-    const QList<ChartData>& data = m_chartData[type][seriesName];
-    if (data.size() < 3) {
+    // 后台线程只读这份快照，界面线程继续追加数据不受影响
+    const SeriesRingBuffer snapshot = m_chartData[type][seriesName].points;
+    if (snapshot.size() < 3) {
         QMessageBox::information(this, "提示", "数据点数量不足，无法进行趋势分析");
         return;
     }
@@ -1578,40 +1682,47 @@ void ChartWidget::performTrendAnalysis(ChartType type, const QString& seriesName
     m_analysisProgress->setRange(0, 100);
     m_analysisProgress->setValue(0);
     
-    // 执行线性回归分析
-    QList<ChartData> trendData;
-    performRegression(data, trendData);
-    
-    m_analysisProgress->setValue(50);
-    
-    // 检测异常值
-    QList<int> anomalies;
-    detectAnomalies(data, anomalies);
-    
-    m_analysisProgress->setValue(100);
-    
-    // 显示分析结果
-    QString analysisText = QString(
-        "趋势分析结果 - %1\n\n"
-        "数据点数: %2\n"
-        "趋势方向: %3\n"
-        "异常点数: %4\n"
-        "数据质量: %5\n"
-    ).arg(seriesName)
-     .arg(data.size())
-     .arg(trendData.size() > 1 && trendData.last().value > trendData.first().value ? "上升" : "下降")
-     .arg(anomalies.size())
-     .arg(anomalies.size() < data.size() * 0.05 ? "良好" : "需要关注");
-    
-    m_analysisResults->setText(analysisText);
-    
-    // 隐藏进度条
-    m_analysisProgress->setVisible(false);
-    
-    LogManager::getInstance()->info("完成趋势分析: " + seriesName, "Chart");
+    const QString key = QString("trend:%1:%2").arg(static_cast<int>(type)).arg(seriesName);
+    startAnalysis(key, [snapshot](QPromise<AnalysisResult>& promise) {
+        const SeriesRingBuffer::View data = snapshot.view();
+        AnalysisResult result;
+        result.pointCount = data.size();
+        
+        // 执行线性回归分析
+        performRegression(data, result.regression);
+        promise.setProgressValue(50);
+        if (promise.isCanceled()) return;
+        
+        // 检测异常值
+        detectAnomalies(data, result.anomalies);
+        promise.addResult(result);
+    }, [this, seriesName](const AnalysisResult& result) {
+        m_analysisProgress->setValue(100);
+        
+        // 显示分析结果
+        const QList<ChartData>& trendData = result.regression;
+        QString analysisText = QString(
+            "趋势分析结果 - %1\n\n"
+            "数据点数: %2\n"
+            "趋势方向: %3\n"
+            "异常点数: %4\n"
+            "数据质量: %5\n"
+        ).arg(seriesName)
+         .arg(result.pointCount)
+         .arg(trendData.size() > 1 && trendData.last().value > trendData.first().value ? "上升" : "下降")
+         .arg(result.anomalies.size())
+         .arg(result.anomalies.size() < result.pointCount * 0.05 ? "良好" : "需要关注");
+        
+        m_analysisResults->setText(analysisText);
+        
+        // 隐藏进度条
+        m_analysisProgress->setVisible(false);
+        
+        LogManager::getInstance()->info("完成趋势分析: " + seriesName, "Chart");
+    });
 }
 
-void ChartWidget::performRegression(const QList<ChartData>& data, QList<ChartData>& regression)
+void ChartWidget::performRegression(const SeriesRingBuffer::View& data, QList<ChartData>& regression)
 {
     if (data.size() < 2) return;
     
@@ -1621,7 +1732,7 @@ void ChartWidget::performRegression(const QList<ChartData>& data, QList<ChartDat
     
     for (int i = 0; i < n; ++i) {
         double x = i; // 使用索引作为X值
-        double y = data[i].value;
+        double y = data.valueAt(i);
         
         sumX += x;
         sumY += y;
@@ -1636,14 +1747,14 @@ void ChartWidget::performRegression(const QList<ChartData>& data, QList<ChartDat
     regression.clear();
     for (int i = 0; i < n; ++i) {
         ChartData point;
-        point.timestamp = data[i].timestamp;
+        point.timestamp = QDateTime::fromMSecsSinceEpoch(data.timestampAt(i));
         point.value = slope * i + intercept;
         point.name = "趋势线";
         regression.append(point);
     }
 }
 
-void ChartWidget::detectAnomalies(const QList<ChartData>& data, QList<int>& anomalies)
+void ChartWidget::detectAnomalies(const SeriesRingBuffer::View& data, QList<int>& anomalies)
 {
     if (data.size() < 3) return;
     
@@ -1655,12 +1766,316 @@ void ChartWidget::detectAnomalies(const QList<ChartData>& data, QList<int>& anom
     
     anomalies.clear();
     for (int i = 0; i < data.size(); ++i) {
-        if (std::abs(data[i].value - stats.average) > threshold) {
+        if (std::abs(data.valueAt(i) - stats.average) > threshold) {
             anomalies.append(i);
         }
     }
 }
 
+QList<ChartData> ChartWidget::extrapolateTrend(const SeriesRingBuffer::View& data, const QString& seriesName,
+                                               int futureHours)
+{
+    QList<ChartData> prediction;
+    if (data.size() < 2 || futureHours <= 0) return prediction;
+    
+    // 以最后一个点为原点、小时为单位做回归，毫秒时间戳相乘不会损失精度
+    const qint64 origin = data.timestampAt(data.size() - 1);
+    const int n = data.size();
+    double sumX = 0, sumY = 0, sumXY = 0, sumX2 = 0;
+    data.forEach([&](qint64 timestamp, double value) {
+        const double x = (timestamp - origin) / 3600000.0;
+        sumX += x;
+        sumY += value;
+        sumXY += x * value;
+        sumX2 += x * x;
+    });
+    
+    const double denominator = n * sumX2 - sumX * sumX;
+    const double slope = std::abs(denominator) < 1e-12 ? 0.0 : (n * sumXY - sumX * sumY) / denominator;
+    const double intercept = (sumY - slope * sumX) / n;
+    
+    prediction.reserve(futureHours);
+    for (int hour = 1; hour <= futureHours; ++hour) {
+        ChartData point;
+        point.name = seriesName;
+        point.timestamp = QDateTime::fromMSecsSinceEpoch(origin + hour * 3600000LL);
+        point.value = intercept + slope * hour;
+        prediction.append(point);
+    }
+    return prediction;
+}
+
+void ChartWidget::startAnalysis(const QString& key, std::function<void(QPromise<AnalysisResult>&)> job,
+                                std::function<void(const AnalysisResult&)> onFinished)
+{
+    // 同一系列的旧请求作废：取消后不再回调，由它自己结束时释放
+    if (QFutureWatcher<AnalysisResult>* previous = m_analysisJobs.take(key)) {
+        previous->disconnect();
+        previous->cancel();
+        if (previous->isFinished()) {
+            previous->deleteLater();
+        } else {
+            connect(previous, &QFutureWatcherBase::finished, previous, &QObject::deleteLater);
+        }
+    }
+    
+    QFutureWatcher<AnalysisResult>* watcher = new QFutureWatcher<AnalysisResult>(this);
+    connect(watcher, &QFutureWatcherBase::progressValueChanged, m_analysisProgress, &QProgressBar::setValue);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, key, watcher, onFinished]() {
+        if (m_analysisJobs.value(key) == watcher) {
+            m_analysisJobs.remove(key);
+        }
+        if (!watcher->isCanceled() && watcher->future().resultCount() > 0) {
+            onFinished(watcher->result());
+        }
+        watcher->deleteLater();
+    });
+    m_analysisJobs.insert(key, watcher);
+    watcher->setFuture(QtConcurrent::run([job](QPromise<AnalysisResult>& promise) { job(promise); }));
+}
+
+void ChartWidget::requestTrendPrediction(ChartType type, const QString& seriesName)
+{
+    const auto typeIt = m_chartData.constFind(type);
+    if (typeIt == m_chartData.constEnd() || !typeIt->contains(seriesName)) return;
+    
+    const SeriesRingBuffer snapshot = typeIt->value(seriesName).points;
+    if (snapshot.size() < 2) return;
+    
+    const int futureHours = m_predictionPeriod;
+    const QString key = QString("prediction:%1:%2").arg(static_cast<int>(type)).arg(seriesName);
+    startAnalysis(key, [snapshot, seriesName, futureHours](QPromise<AnalysisResult>& promise) {
+        AnalysisResult result;
+        result.pointCount = snapshot.size();
+        result.prediction = extrapolateTrend(snapshot.view(), seriesName, futureHours);
+        if (!promise.isCanceled()) {
+            promise.addResult(result);
+        }
+    }, [this, seriesName](const AnalysisResult& result) {
+        emit trendPredicted(seriesName, result.prediction);
+    });
+}
+
+void ChartWidget::cancelAnalyses()
+{
+    // 任务只持有快照，等待结束后界面对象才能安全析构
+    const QList<QFutureWatcher<AnalysisResult>*> watchers = m_analysisJobs.values();
+    m_analysisJobs.clear();
+    for (QFutureWatcher<AnalysisResult>* watcher : watchers) {
+        watcher->disconnect();
+        watcher->cancel();
+        watcher->waitForFinished();
+        delete watcher;
+    }
+}
+
+// 预测分析
+void ChartWidget::enableTrendPrediction(bool enable)
+{
+    m_enableTrendPrediction = enable;
+    LogManager::getInstance()->info(enable ? "启用趋势预测" : "关闭趋势预测", "Chart");
+}
+
+void ChartWidget::setPredictionPeriod(int hours)
+{
+    m_predictionPeriod = std::max(1, hours);
+}
+
+QList<ChartData> ChartWidget::predictTrend(const QString& seriesName, int futurePeriod)
+{
+    // 同步版本，供需要立即得到结果的调用方使用；定时预测走 requestTrendPrediction()
+    for (auto it = m_chartData.cbegin(); it != m_chartData.cend(); ++it) {
+        const auto series = it->constFind(seriesName);
+        if (series != it->constEnd()) {
+            return extrapolateTrend(series->points.view(), seriesName, futurePeriod);
+        }
+    }
+    return QList<ChartData>();
+}
+
+// 历史数据分析
+//
+// 历史数据来自传感器历史存储。按图表最大点数把时间范围等分，每段取均值；
+// 查询自动选择满足点数的最粗汇总层级，30 天的趋势图读取分钟汇总而不是原始点
+ChartSeries ChartWidget::loadHistorySeries(int column, const QDateTime& startTime, const QDateTime& endTime,
+                                           int points) const
+{
+    const std::vector<TimeSeriesRollup::Point> rollupPoints = SensorHistory::getInstance()->rollup()->query(
+        column, startTime.toMSecsSinceEpoch(), endTime.toMSecsSinceEpoch(), points);
+
+    ChartSeries series(SensorHistory::displayName(column),
+                       std::max(points, static_cast<int>(rollupPoints.size())), SensorHistory::unit(column));
+    for (const TimeSeriesRollup::Point& point : rollupPoints) {
+        series.append(point.timestampMs, point.mean);
+    }
+    return series;
+}
+
+void ChartWidget::loadHistoryData(const QDateTime& startTime, const QDateTime& endTime)
+{
+    const ChartType type = ChartType::HistoryTrend;
+    QElapsedTimer timer;
+    timer.start();
+
+    QMap<QString, ChartSeries> seriesData;
+    int pointCount = 0;
+    for (int column = 0; column < SensorHistory::DeviceStatus; ++column) {
+        ChartSeries series = loadHistorySeries(column, startTime, endTime, m_chartConfigs[type].maxDataPoints);
+        pointCount += series.points.size();
+        seriesData.insert(SensorHistory::displayName(column), series);
+    }
+
+    {
+        QMutexLocker locker(&m_dataMutex);
+        m_chartData[type] = seriesData;
+        updateChart(type);
+    }
+    for (auto it = seriesData.constBegin(); it != seriesData.constEnd(); ++it) {
+        emit chartDataChanged(type, it.key());
+    }
+
+    const qint64 bucketWidth = startTime.msecsTo(endTime) / std::max(1, m_chartConfigs[type].maxDataPoints) + 1;
+    const qint64 resolution = TimeSeriesRollup::resolution(TimeSeriesRollup::chooseTier(bucketWidth));
+    LogManager::getInstance()->info(QString("加载历史数据 %1 ~ %2: %3 个点（%4），耗时 %5 ms")
+                                    .arg(formatTime(startTime), formatTime(endTime))
+                                    .arg(pointCount)
+                                    .arg(resolution > 0 ? QString("%1 秒汇总").arg(resolution / 1000) : QString("原始数据"))
+                                    .arg(timer.elapsed()), "Chart");
+}
+
+void ChartWidget::analyzeHistoryTrend(const QString& parameter, const QDateTime& startTime, const QDateTime& endTime)
+{
+    const int column = SensorHistory::columnForParameter(parameter);
+    if (column < 0) {
+        LogManager::getInstance()->warning("未知的历史参数: " + parameter, "Chart");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 整体统计量直接由块索引合并，趋势和异常在降采样后的序列上计算
+    TimeSeriesStore* store = SensorHistory::getInstance()->store();
+    const StatisticsData stats = toStatistics(store->summarize(column, startTime.toMSecsSinceEpoch(),
+                                                               endTime.toMSecsSinceEpoch()));
+    const ChartSeries series = loadHistorySeries(column, startTime, endTime,
+                                                 m_chartConfigs[ChartType::HistoryTrend].maxDataPoints);
+
+    QList<ChartData> regression;
+    performRegression(series.points.view(), regression);
+    QList<int> anomalies;
+    detectAnomalies(series.points.view(), anomalies);
+
+    // 回归按点序号计算，换算为每小时的变化量
+    double slopePerHour = 0;
+    if (regression.size() > 1) {
+        const double hours = regression.first().timestamp.msecsTo(regression.last().timestamp) / 3600000.0;
+        if (hours > 0) {
+            slopePerHour = (regression.last().value - regression.first().value) / hours;
+        }
+    }
+    const QString direction = regression.size() < 2 ? "数据不足"
+                            : (std::abs(slopePerHour) < 1e-9 ? "平稳" : (slopePerHour > 0 ? "上升" : "下降"));
+
+    m_statisticsData[ChartType::HistoryTrend] = stats;
+    updateStatisticsLabels(stats);
+    emit statisticsCalculated(ChartType::HistoryTrend, stats);
+
+    m_analysisResults->setText(QString(
+        "历史趋势分析 - %1\n\n"
+        "时间范围: %2 ~ %3\n"
+        "数据点数: %4\n"
+        "平均值: %5\n"
+        "最小值/最大值: %6 / %7\n"
+        "标准偏差: %8\n"
+        "趋势方向: %9（%10/小时）\n"
+        "异常时段: %11\n"
+    ).arg(SensorHistory::displayName(column))
+     .arg(formatTime(startTime), formatTime(endTime))
+     .arg(stats.count)
+     .arg(formatValue(stats.average, SensorHistory::unit(column)))
+     .arg(formatValue(stats.minimum, SensorHistory::unit(column)), formatValue(stats.maximum, SensorHistory::unit(column)))
+     .arg(stats.stdDeviation, 0, 'f', 3)
+     .arg(direction)
+     .arg(slopePerHour, 0, 'f', 4)
+     .arg(anomalies.size()));
+
+    QJsonObject results;
+    results["parameter"] = SensorHistory::columnNames().at(column);
+    results["startTime"] = startTime.toString(Qt::ISODate);
+    results["endTime"] = endTime.toString(Qt::ISODate);
+    results["count"] = stats.count;
+    results["average"] = stats.average;
+    results["minimum"] = stats.minimum;
+    results["maximum"] = stats.maximum;
+    results["stdDeviation"] = stats.stdDeviation;
+    results["slopePerHour"] = slopePerHour;
+    results["trend"] = direction;
+    results["anomalies"] = anomalies.size();
+    results["elapsedMs"] = timer.elapsed();
+    emit analysisCompleted("historyTrend", results);
+
+    LogManager::getInstance()->info(QString("完成历史趋势分析: %1，%2 个点，耗时 %3 ms")
+                                    .arg(parameter).arg(stats.count).arg(timer.elapsed()), "Chart");
+}
+
+void ChartWidget::compareHistoryData(const QStringList& parameters, const QDateTime& startTime, const QDateTime& endTime)
+{
+    const ChartType type = ChartType::ComparisonAnalysis;
+    QElapsedTimer timer;
+    timer.start();
+
+    TimeSeriesStore* store = SensorHistory::getInstance()->store();
+    QMap<QString, ChartSeries> seriesData;
+    QJsonArray comparison;
+    QString text = QString("历史对比分析\n时间范围: %1 ~ %2\n\n").arg(formatTime(startTime), formatTime(endTime));
+
+    for (const QString& parameter : parameters) {
+        const int column = SensorHistory::columnForParameter(parameter);
+        if (column < 0) {
+            LogManager::getInstance()->warning("未知的历史参数: " + parameter, "Chart");
+            continue;
+        }
+
+        const QString name = SensorHistory::displayName(column);
+        seriesData.insert(name, loadHistorySeries(column, startTime, endTime, m_chartConfigs[type].maxDataPoints));
+
+        const StatisticsData stats = toStatistics(store->summarize(column, startTime.toMSecsSinceEpoch(),
+                                                                   endTime.toMSecsSinceEpoch()));
+        QJsonObject item;
+        item["parameter"] = SensorHistory::columnNames().at(column);
+        item["count"] = stats.count;
+        item["average"] = stats.average;
+        item["minimum"] = stats.minimum;
+        item["maximum"] = stats.maximum;
+        item["stdDeviation"] = stats.stdDeviation;
+        comparison.append(item);
+
+        text += QString("%1: 平均 %2，最小 %3，最大 %4，标准偏差 %5\n")
+                .arg(name, formatValue(stats.average, SensorHistory::unit(column)),
+                     formatValue(stats.minimum, SensorHistory::unit(column)),
+                     formatValue(stats.maximum, SensorHistory::unit(column)))
+                .arg(stats.stdDeviation, 0, 'f', 3);
+    }
+
+    {
+        QMutexLocker locker(&m_dataMutex);
+        m_chartData[type] = seriesData;
+        updateChart(type);
+    }
+    m_analysisResults->setText(text);
+
+    QJsonObject results;
+    results["startTime"] = startTime.toString(Qt::ISODate);
+    results["endTime"] = endTime.toString(Qt::ISODate);
+    results["parameters"] = comparison;
+    results["elapsedMs"] = timer.elapsed();
+    emit analysisCompleted("historyComparison", results);
+
+    LogManager::getInstance()->info(QString("完成历史对比分析: %1，耗时 %2 ms")
+                                    .arg(parameters.join(",")).arg(timer.elapsed()), "Chart");
+}
+
 void ChartWidget::showComparisonDialog()
 {
     QDialog dialog(this);
@@ -36,7 +36,13 @@
 #include <QMutex>
 #include <QThread>
 #include <QProgressBar>
+#include <QFutureWatcher>
+#include <QPromise>
 #include <QTextEdit>
+#include "../utils/seriesringbuffer.h"
+#include "../utils/latencyhistogram.h"
+#include "../utils/runningstatistics.h"
+#include <functional>
 
 // 图表类型枚举
 enum class ChartType {
@@ -50,7 +56,7 @@ enum class ChartType {
     ComparisonAnalysis = 7  // 对比分析图表
 };
 
-// 图表数据结构
+// 图表数据结构：单个数据点的输入和分析结果，图表内部不按此结构存储
 struct ChartData {
     QString name;           // 数据系列名称
     QDateTime timestamp;    // 时间戳
@@ -65,6 +71,36 @@ struct ChartData {
         : name(n), timestamp(t), value(v), unit(u), isValid(true) {}
 };
 
+// 图表数据系列：名称、单位等元数据只保存一份，采样点存放在定长的时间戳/数值环形缓冲区中
+struct ChartSeries {
+    QString name;
+    QString unit;
+    QString category;
+    QColor color;
+    SeriesRingBuffer points;    // 容量为图表的最大数据点数，满了之后覆盖最旧的点；只通过 append()/clear() 修改
+    RunningStatistics statistics;   // 与 points 中的窗口同步更新
+    
+    ChartSeries() = default;
+    ChartSeries(const QString& n, int capacity, const QString& u = "")
+        : name(n), unit(u), points(capacity) {}
+    
+    void append(qint64 timestampMs, double value)
+    {
+        if (points.capacity() == 0) return;
+        if (points.size() == points.capacity()) {
+            statistics.removeOldest(points.view().valueAt(0));
+        }
+        points.append(timestampMs, value);
+        statistics.add(value);
+    }
+    
+    void clear()
+    {
+        points.clear();
+        statistics.clear();
+    }
+};
+
 // 图表配置结构
 struct ChartConfig {
     ChartType type;         // 图表类型
@@ -79,13 +115,14 @@ struct ChartConfig {
     bool showLegend;        // 显示图例
     bool showGrid;          // 显示网格
     bool enableAnimation;   // 启用动画
+    bool useOpenGL;         // 折线/散点系列用 OpenGL 绘制，适合高频大数据量的系列
     QColor backgroundColor; // 背景色
     QColor gridColor;       // 网格颜色
     
     ChartConfig() 
         : type(ChartType::RealTimeMonitor), maxDataPoints(1000), updateInterval(1000)
         , autoScale(true), minValue(0), maxValue(100), showLegend(true)
-        , showGrid(true), enableAnimation(true), backgroundColor(Qt::white)
+        , showGrid(true), enableAnimation(false), useOpenGL(false), backgroundColor(Qt::white)
         , gridColor(Qt::lightGray) {}
 };
 
@@ -106,6 +143,14 @@ struct StatisticsData {
                      , variance(0), count(0), sum(0), range(0) {}
 };
 
+// 后台趋势分析的结果
+struct AnalysisResult {
+    int pointCount = 0;
+    QList<ChartData> regression;    // 回归线
+    QList<int> anomalies;           // 异常点序号
+    QList<ChartData> prediction;    // 外推的趋势
+};
+
 class ChartWidget : public QWidget
 {
     Q_OBJECT
@@ -138,7 +183,8 @@ public:
     
     // 数据分析
     StatisticsData calculateStatistics(ChartType type, const QString& seriesName);
-    QList<ChartData> getChartData(ChartType type, const QString& seriesName);
+    // 按时间顺序的只读视图，不拷贝数据；在该系列下一次修改之前有效，只能在界面线程使用
+    SeriesRingBuffer::View getChartData(ChartType type, const QString& seriesName);
     QStringList getSeriesNames(ChartType type);
     
     // 实时监控
@@ -157,6 +203,10 @@ public:
     void enableTrendPrediction(bool enable);
     void setPredictionPeriod(int hours);
     QList<ChartData> predictTrend(const QString& seriesName, int futurePeriod);
+    
+    // 每帧重绘图表的耗时
+    LatencyHistogram frameTimeHistogram() const;
+    void resetFrameTimeHistogram();
 
 public slots:
     void onDataReceived(const QJsonObject& data);
@@ -185,6 +235,8 @@ private slots:
     void onAnimationToggled(bool enabled);
     void onLegendToggled(bool enabled);
     void onGridToggled(bool enabled);
+    void onOpenGLToggled(bool enabled);
+    void onFrameTimer();
 
 signals:
     void chartDataChanged(ChartType type, const QString& seriesName);
@@ -224,10 +276,36 @@ private:
     void updateChartAxes(QChart* chart, const ChartConfig& config);
     void applyChartTheme(QChart* chart);
     
-    void calculateSeriesStatistics(const QList<ChartData>& data, StatisticsData& stats);
+    // 以下分析函数不访问成员，可以在后台线程对系列快照调用
+    static void calculateSeriesStatistics(const SeriesRingBuffer::View& data, StatisticsData& stats);
     void performTrendAnalysis(const QList<ChartData>& data, QList<ChartData>& trend);
-    void performRegression(const QList<ChartData>& data, QList<ChartData>& regression);
-    void detectAnomalies(const QList<ChartData>& data, QList<int>& anomalies);
+    static void performRegression(const SeriesRingBuffer::View& data, QList<ChartData>& regression);
+    static void detectAnomalies(const SeriesRingBuffer::View& data, QList<int>& anomalies);
+    // 按时间做线性回归，从最后一个点起每小时外推一个点，共 futureHours 个
+    static QList<ChartData> extrapolateTrend(const SeriesRingBuffer::View& data, const QString& seriesName,
+                                             int futureHours);
+    
+    // 后台分析：job 在线程池中处理系列快照，完成后 onFinished 在界面线程收到结果。
+    // 同一 key（分析类型 + 系列）的新请求会取消尚未完成的旧请求，被取消的结果直接丢弃
+    void startAnalysis(const QString& key, std::function<void(QPromise<AnalysisResult>&)> job,
+                       std::function<void(const AnalysisResult&)> onFinished);
+    void requestTrendPrediction(ChartType type, const QString& seriesName);
+    void cancelAnalyses();
+    // 从传感器历史按时间等分读取一列，每段取均值，最多 points 个点
+    ChartSeries loadHistorySeries(int column, const QDateTime& startTime, const QDateTime& endTime, int points) const;
+    // 数据点所属的系列，不存在时按图表的最大点数创建
+    ChartSeries& seriesFor(ChartType type, const ChartData& data);
+    // 交给 QtCharts 的点：按绘图区宽度降采样到可见范围，实时类图表取每列最小/最大值，历史类用 LTTB
+    QList<QPointF> renderPoints(ChartType type, const SeriesRingBuffer::View& data) const;
+    // 图表所有系列的时间范围，没有数据时返回 false
+    bool dataExtent(ChartType type, qint64* startMs, qint64* endMs) const;
+    // 缩放后把时间轴设为可见范围
+    void applyViewRange(ChartType type);
+    // 数据变化后登记重绘，同一帧内的多次变化合并为一次
+    void scheduleChartUpdate(ChartType type);
+    // 按系列名复用图表中已有的折线/样条/散点系列，用 replace() 整体替换数据点；
+    // 新出现的系列由 create 创建，数据已清空的系列从图表移除
+    void syncXYSeries(ChartType type, const std::function<QXYSeries*(int index)>& create);
     
     // 缺少的函数声明
     void initializeChartConfigs();
@@ -270,6 +348,7 @@ private:
     QCheckBox* m_animationCheckBox;
     QCheckBox* m_legendCheckBox;
     QCheckBox* m_gridCheckBox;
+    QCheckBox* m_openGLCheckBox;
     
     // 统计面板
     QGroupBox* m_statisticsPanel;
@@ -286,12 +365,17 @@ private:
     QTextEdit* m_analysisResults;
     
     // 数据存储
-    QMap<ChartType, QMap<QString, QList<ChartData>>> m_chartData;
+    QMap<ChartType, QMap<QString, ChartSeries>> m_chartData;
     QMap<ChartType, StatisticsData> m_statisticsData;
+    QMap<ChartType, QPair<qint64, qint64>> m_viewRanges;   // 缩放后的可见时间范围（毫秒），未缩放时不存在
+    QMap<QString, QFutureWatcher<AnalysisResult>*> m_analysisJobs;  // 进行中的后台分析
     
     // 定时器和状态
     QTimer* m_updateTimer;
     QTimer* m_refreshTimer;
+    QTimer* m_frameTimer;
+    QList<ChartType> m_pendingCharts;      // 等待下一帧重绘的图表
+    LatencyHistogram m_frameTimes;
     bool m_isRealTimeMonitoring;
     bool m_isPaused;
     QDateTime m_lastUpdateTime;
@@ -1,4 +1,7 @@
 #include "communicationwidget.h"
+#include "../communication/communicationmanager.h"
+#include "../communication/protocolparser.h"
+#include "trafficmonitormodel.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -11,10 +14,14 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
+#include <QTableView>
 
 CommunicationWidget::CommunicationWidget(QWidget *parent)
     : QWidget(parent)
     , m_tabWidget(nullptr)
+    , m_statisticsTable(nullptr)
+    , m_trafficModel(nullptr)
+    , m_trafficView(nullptr)
     , m_updateTimer(new QTimer(this))
     , m_autoConnect(false)
     , m_retryCount(3)
@@ -73,10 +80,8 @@ void CommunicationWidget::setupUI()
     deviceLayout->addWidget(new QLabel("设备管理功能"));
     m_tabWidget->addTab(devicePlaceholder, "设备管理");
     
-    QWidget* statsPlaceholder = new QWidget();
-    QVBoxLayout* statsLayout = new QVBoxLayout(statsPlaceholder);
-    statsLayout->addWidget(new QLabel("统计监控功能"));
-    m_tabWidget->addTab(statsPlaceholder, "统计监控");
+    m_tabWidget->addTab(createStatisticsTab(), "统计监控");
+    m_tabWidget->addTab(createTrafficMonitorTab(), "报文监控");
     
     mainLayout->addWidget(m_tabWidget);
 }
@@ -569,33 +574,16 @@ QWidget* CommunicationWidget::createStatisticsTab()
     auto detailStatsGroup = new QGroupBox("详细统计");
     auto detailLayout = new QVBoxLayout(detailStatsGroup);
     
-    auto statsTable = new QTableWidget(0, 7);
-    QStringList headers = {"连接名称", "消息发送", "消息接收", "错误次数", "成功率", "平均延迟", "状态"};
-    statsTable->setHorizontalHeaderLabels(headers);
-    statsTable->setAlternatingRowColors(true);
-    statsTable->horizontalHeader()->setStretchLastSection(true);
+    m_statisticsTable = new QTableWidget(0, 11);
+    QStringList headers = {"连接名称", "消息发送", "消息接收", "错误次数", "成功率", "平均延迟",
+                           "心跳P50", "心跳P99", "心跳P99.9", "心跳最大", "状态"};
+    m_statisticsTable->setHorizontalHeaderLabels(headers);
+    m_statisticsTable->setAlternatingRowColors(true);
+    m_statisticsTable->horizontalHeader()->setStretchLastSection(true);
     
-    // 添加示例数据
-    QStringList connections = {"串口连接1", "TCP连接1", "CAN连接1", "Modbus连接1"};
-    QStringList sendCounts = {"1234", "5678", "9012", "3456"};
-    QStringList receiveCounts = {"1230", "5675", "9010", "3454"};
-    QStringList errorCounts = {"4", "3", "2", "2"};
-    QStringList successRates = {"99.7%", "99.9%", "99.8%", "99.9%"};
-    QStringList avgDelays = {"12ms", "8ms", "5ms", "15ms"};
-    QStringList statuses = {"正常", "正常", "正常", "正常"};
-    
-    for (int i = 0; i < connections.size(); ++i) {
-        statsTable->insertRow(i);
-        statsTable->setItem(i, 0, new QTableWidgetItem(connections[i]));
-        statsTable->setItem(i, 1, new QTableWidgetItem(sendCounts[i]));
-        statsTable->setItem(i, 2, new QTableWidgetItem(receiveCounts[i]));
-        statsTable->setItem(i, 3, new QTableWidgetItem(errorCounts[i]));
-        statsTable->setItem(i, 4, new QTableWidgetItem(successRates[i]));
-        statsTable->setItem(i, 5, new QTableWidgetItem(avgDelays[i]));
-        statsTable->setItem(i, 6, new QTableWidgetItem(statuses[i]));
-    }
+    updateStatisticsDisplay();
     
-    detailLayout->addWidget(statsTable);
+    detailLayout->addWidget(m_statisticsTable);
     
     // 操作按钮
     auto buttonLayout = new QHBoxLayout();
@@ -612,6 +600,8 @@ QWidget* CommunicationWidget::createStatisticsTab()
     buttonLayout->addWidget(exportStatsBtn);
     buttonLayout->addStretch();
     
+    connect(refreshStatsBtn, &QPushButton::clicked, this, &CommunicationWidget::updateStatisticsDisplay);
+    
     // 布局组装
     layout->addWidget(overallStatsGroup);
     layout->addWidget(detailStatsGroup);
@@ -621,6 +611,177 @@ QWidget* CommunicationWidget::createStatisticsTab()
     return statsTab;
 }
 
+QWidget* CommunicationWidget::createTrafficMonitorTab()
+{
+    auto trafficTab = new QWidget();
+    auto layout = new QVBoxLayout(trafficTab);
+    
+    // 工具栏
+    auto toolBar = new QHBoxLayout();
+    m_trafficPauseBtn = new QPushButton("暂停");
+    m_trafficPauseBtn->setCheckable(true);
+    auto clearBtn = new QPushButton("清除");
+    
+    m_trafficCommandCombo = new QComboBox();
+    m_trafficCommandCombo->addItem("全部命令", TrafficMonitorModel::AllCommands);
+    m_trafficCommandCombo->addItem("未识别", TrafficMonitorModel::UnknownCommand);
+    for (int code = 0; code <= 0xFF; ++code) {
+        const QString name = ProtocolParser::commandToString(static_cast<ProtocolCommand>(code));
+        if (!name.startsWith("未知")) {
+            m_trafficCommandCombo->addItem(QString("%1 %2").arg(code, 2, 16, QLatin1Char('0')).toUpper().arg(name), code);
+        }
+    }
+    
+    m_trafficSearchEdit = new QLineEdit();
+    m_trafficSearchEdit->setPlaceholderText("搜索十六进制字节（如 AA 55 20）或文本");
+    auto findPrevBtn = new QPushButton("上一个");
+    auto findNextBtn = new QPushButton("下一个");
+    m_trafficAutoScrollCheck = new QCheckBox("自动滚动");
+    m_trafficAutoScrollCheck->setChecked(true);
+    m_trafficCountLabel = new QLabel();
+    
+    toolBar->addWidget(m_trafficPauseBtn);
+    toolBar->addWidget(clearBtn);
+    toolBar->addWidget(new QLabel("命令:"));
+    toolBar->addWidget(m_trafficCommandCombo);
+    toolBar->addWidget(m_trafficSearchEdit, 1);
+    toolBar->addWidget(findPrevBtn);
+    toolBar->addWidget(findNextBtn);
+    toolBar->addWidget(m_trafficAutoScrollCheck);
+    toolBar->addWidget(m_trafficCountLabel);
+    
+    // 表格只为可见行生成文本；统一行高，滚动时不逐行测量
+    m_trafficModel = new TrafficMonitorModel(System::TRAFFIC_MONITOR_RECORDS, this);
+    m_trafficView = new QTableView();
+    m_trafficView->setModel(m_trafficModel);
+    m_trafficView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_trafficView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_trafficView->setWordWrap(false);
+    m_trafficView->verticalHeader()->setVisible(false);
+    m_trafficView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_trafficView->verticalHeader()->setDefaultSectionSize(m_trafficView->fontMetrics().height() + 4);
+    m_trafficView->horizontalHeader()->setStretchLastSection(true);
+    m_trafficView->setColumnWidth(TrafficMonitorModel::TimeColumn, 100);
+    m_trafficView->setColumnWidth(TrafficMonitorModel::ConnectionColumn, 100);
+    m_trafficView->setColumnWidth(TrafficMonitorModel::DirectionColumn, 50);
+    m_trafficView->setColumnWidth(TrafficMonitorModel::CommandColumn, 140);
+    m_trafficView->setColumnWidth(TrafficMonitorModel::LengthColumn, 50);
+    m_trafficView->setColumnWidth(TrafficMonitorModel::HexColumn, 420);
+    
+    layout->addLayout(toolBar);
+    layout->addWidget(m_trafficView);
+    
+    connect(m_trafficPauseBtn, &QPushButton::toggled, this, &CommunicationWidget::onTrafficPauseToggled);
+    connect(clearBtn, &QPushButton::clicked, m_trafficModel, &TrafficMonitorModel::clear);
+    connect(m_trafficCommandCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &CommunicationWidget::onTrafficCommandFilterChanged);
+    connect(m_trafficSearchEdit, &QLineEdit::returnPressed, this, &CommunicationWidget::onTrafficFindNext);
+    connect(findNextBtn, &QPushButton::clicked, this, &CommunicationWidget::onTrafficFindNext);
+    connect(findPrevBtn, &QPushButton::clicked, this, &CommunicationWidget::onTrafficFindPrevious);
+    connect(m_trafficModel, &TrafficMonitorModel::rowsFlushed, this, &CommunicationWidget::onTrafficRowsFlushed);
+    
+    // 所有连接的收发原始数据
+    CommunicationManager* manager = CommunicationManager::getInstance();
+    connect(manager, &CommunicationManager::dataReceived, this, [this](const QString& name, const QByteArray& data) {
+        m_trafficModel->append(name, TrafficDirection::Received, data);
+    });
+    connect(manager, &CommunicationManager::dataSent, this, [this](const QString& name, const QByteArray& data) {
+        m_trafficModel->append(name, TrafficDirection::Sent, data);
+    });
+    
+    onTrafficRowsFlushed();
+    return trafficTab;
+}
+
+void CommunicationWidget::onTrafficPauseToggled(bool paused)
+{
+    m_trafficPauseBtn->setText(paused ? "继续" : "暂停");
+    m_trafficModel->setPaused(paused);
+    onTrafficRowsFlushed();
+}
+
+void CommunicationWidget::onTrafficCommandFilterChanged()
+{
+    m_trafficModel->setCommandFilter(m_trafficCommandCombo->currentData().toInt());
+}
+
+void CommunicationWidget::onTrafficFindNext()
+{
+    findTraffic(true);
+}
+
+void CommunicationWidget::onTrafficFindPrevious()
+{
+    findTraffic(false);
+}
+
+void CommunicationWidget::findTraffic(bool forward)
+{
+    const QByteArray pattern = TrafficMonitorModel::searchPattern(m_trafficSearchEdit->text());
+    if (pattern.isEmpty()) {
+        return;
+    }
+    const QModelIndex current = m_trafficView->currentIndex();
+    const int row = m_trafficModel->find(pattern, current.isValid() ? current.row() : -1, forward);
+    if (row < 0) {
+        m_trafficCountLabel->setText("未找到匹配的报文");
+        return;
+    }
+    // 找到后停止自动滚动，避免新数据把结果滚走
+    m_trafficAutoScrollCheck->setChecked(false);
+    const QModelIndex index = m_trafficModel->index(row, TrafficMonitorModel::HexColumn);
+    m_trafficView->setCurrentIndex(index);
+    m_trafficView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void CommunicationWidget::onTrafficRowsFlushed()
+{
+    m_trafficCountLabel->setText(QString("显示 %1 / 缓存 %2 / 累计 %3%4")
+                                 .arg(m_trafficModel->rowCount())
+                                 .arg(m_trafficModel->bufferedCount())
+                                 .arg(m_trafficModel->totalCount())
+                                 .arg(m_trafficModel->isPaused() ? "（已暂停）" : ""));
+    if (m_trafficAutoScrollCheck->isChecked() && !m_trafficModel->isPaused()) {
+        m_trafficView->scrollToBottom();
+    }
+}
+
+void CommunicationWidget::updateStatisticsDisplay()
+{
+    if (!m_statisticsTable) {
+        return;
+    }
+    
+    CommunicationManager* manager = CommunicationManager::getInstance();
+    const QList<ConnectionInfo> connections = manager->getAllConnections();
+    m_statisticsTable->setRowCount(0);
+    
+    for (const ConnectionInfo& info : connections) {
+        // 按名称在管理器锁内取统计，连接在刷新期间被移除时得到空统计
+        const CommunicationStats stats = manager->getConnectionStatistics(info.name);
+        const qint64 total = stats.framesSent + stats.framesReceived;
+        const double successRate = total > 0 ? 100.0 * (total - qMin(stats.errorCount, total)) / total : 100.0;
+        // 没有心跳样本时百分位为空，避免把0显示成真实延迟
+        auto formatRtt = [&stats](qint64 ns) {
+            return stats.heartbeatCount > 0 ? HdrHistogram::formatNs(ns) : QString("-");
+        };
+        
+        const int row = m_statisticsTable->rowCount();
+        m_statisticsTable->insertRow(row);
+        m_statisticsTable->setItem(row, 0, new QTableWidgetItem(info.name));
+        m_statisticsTable->setItem(row, 1, new QTableWidgetItem(QString::number(stats.framesSent)));
+        m_statisticsTable->setItem(row, 2, new QTableWidgetItem(QString::number(stats.framesReceived)));
+        m_statisticsTable->setItem(row, 3, new QTableWidgetItem(QString::number(stats.errorCount)));
+        m_statisticsTable->setItem(row, 4, new QTableWidgetItem(QString("%1%").arg(successRate, 0, 'f', 1)));
+        m_statisticsTable->setItem(row, 5, new QTableWidgetItem(QString("%1ms").arg(stats.averageLatency, 0, 'f', 2)));
+        m_statisticsTable->setItem(row, 6, new QTableWidgetItem(formatRtt(stats.heartbeatP50Ns)));
+        m_statisticsTable->setItem(row, 7, new QTableWidgetItem(formatRtt(stats.heartbeatP99Ns)));
+        m_statisticsTable->setItem(row, 8, new QTableWidgetItem(formatRtt(stats.heartbeatP999Ns)));
+        m_statisticsTable->setItem(row, 9, new QTableWidgetItem(formatRtt(stats.heartbeatMaxNs)));
+        m_statisticsTable->setItem(row, 10, new QTableWidgetItem(connectionStateToString(info.state)));
+    }
+}
+
 void CommunicationWidget::setupConnections()
 {
     // 串口相关连接
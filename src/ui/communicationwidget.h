@@ -52,6 +52,9 @@
 #include <QCanBusFrame>
 #include "../communication/canworker.h"
 
+class QTableView;
+class TrafficMonitorModel;
+
 // 通讯协议类型
 enum class ProtocolType {
     SerialPort = 0,             // 串口
@@ -199,6 +202,11 @@ private slots:
     void onModbusConfigChanged();
     void onCanConfigChanged();
     void onMessageFilterChanged();
+    void onTrafficPauseToggled(bool paused);
+    void onTrafficCommandFilterChanged();
+    void onTrafficFindNext();
+    void onTrafficFindPrevious();
+    void onTrafficRowsFlushed();
     
     // 通讯连接槽函数
     void refreshSerialPorts();
@@ -238,6 +246,8 @@ private:
     QWidget* createModbusTab();
     QWidget* createDeviceManagementTab();
     QWidget* createStatisticsTab();
+    QWidget* createTrafficMonitorTab();
+    void findTraffic(bool forward);
     void setupMonitorTab();
     void setupConfigTab();
     
@@ -396,6 +406,15 @@ private:
     QLabel* m_totalMessagesLabel;
     QLabel* m_errorRateLabel;
     
+    // 报文监控
+    TrafficMonitorModel* m_trafficModel;
+    QTableView* m_trafficView;
+    QPushButton* m_trafficPauseBtn;
+    QComboBox* m_trafficCommandCombo;
+    QLineEdit* m_trafficSearchEdit;
+    QCheckBox* m_trafficAutoScrollCheck;
+    QLabel* m_trafficCountLabel;
+    
     // 配置标签页
     QWidget* m_configTab;
     QCheckBox* m_autoConnectCheckBox;
@@ -2,6 +2,12 @@
 #include "communication/serialworker.h"
 #include "communication/protocolparser.h"
 #include "logger/logmanager.h"
+#include "data/sensorhistory.h"
+#include "stripchartwidget.h"
+#include "../utils/seriesdecimator.h"
+#include "../utils/framelatency.h"
+#include "../utils/metricsregistry.h"
+#include "../constants.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QHeaderView>
@@ -10,6 +16,9 @@
 #include <QTextStream>
 #include <QDataStream>
 #include <QSplitter>
+#include <QStackedWidget>
+#include <QCheckBox>
+#include <QElapsedTimer>
 
 DataMonitorWidget::DataMonitorWidget(QWidget* parent) 
     : QWidget(parent)
@@ -17,20 +26,41 @@ DataMonitorWidget::DataMonitorWidget(QWidget* parent)
     , serialWorker(nullptr)
     , isMonitoring(false)
     , isPaused(false)
+    , displayedReceivedNs(0)
+    , displayedNs(0)
 {
     setupUI();
     setupConnections();
     
+    // X 坐标每帧都会变化，它的绘制作为数值显示到屏幕上的时刻
+    positionXLabel->installEventFilter(this);
+    
     // 创建更新定时器
     updateTimer = new QTimer(this);
     connect(updateTimer, &QTimer::timeout, this, &DataMonitorWidget::onUpdateTimer);
     
+    // 图表重绘定时器，原始点缓冲区一次分配
+    chartRenderTimer = new QTimer(this);
+    chartRenderTimer->setSingleShot(true);
+    chartRenderTimer->setInterval(System::UI_UPDATE_INTERVAL);
+    connect(chartRenderTimer, &QTimer::timeout, this, &DataMonitorWidget::renderCharts);
+    for (SeriesRingBuffer* buffer : {&positionXData, &positionYData, &positionZData,
+                                     &velocityData, &pressureData, &temperatureData}) {
+        buffer->setCapacity(System::MONITOR_CHART_BUFFER_POINTS);
+    }
+    
     // 初始化图表
     initializeCharts();
     
     // 设置默认配置
     config = MonitorConfig();
     updateTimer->setInterval(config.updateInterval);
+    historyData.setCapacity(config.historySize);
+    
+    // 告警阈值由报警引擎在接收线程评估，这里只接收状态变化
+    connect(AlarmEngine::getInstance(), &AlarmEngine::transitionsReady,
+            this, &DataMonitorWidget::onAlarmTransitions);
+    syncAlertLimits();
     
     LogManager::getInstance()->info("数据监控界面已创建", "DataMonitor");
 }
@@ -189,10 +219,28 @@ void DataMonitorWidget::setupChartPanel()
     temperatureChartView->setRenderHint(QPainter::Antialiasing);
     
     // 布局设置
-    layout->addWidget(positionChartView, 0, 0);
-    layout->addWidget(velocityChartView, 0, 1);
-    layout->addWidget(pressureChartView, 1, 0);
-    layout->addWidget(temperatureChartView, 1, 1);
+    QWidget* chartPage = new QWidget;
+    QGridLayout* chartLayout = new QGridLayout(chartPage);
+    chartLayout->setContentsMargins(0, 0, 0, 0);
+    chartLayout->addWidget(positionChartView, 0, 0);
+    chartLayout->addWidget(velocityChartView, 0, 1);
+    chartLayout->addWidget(pressureChartView, 1, 0);
+    chartLayout->addWidget(temperatureChartView, 1, 1);
+    
+    // 条带图通道顺序与 addChartData() 中的追加顺序一致
+    stripChart = new StripChartWidget;
+    const int capacity = System::STRIP_CHART_CHANNEL_POINTS;
+    stripChart->addChannel("X轴", Qt::red, Device::MIN_POSITION, Device::MAX_POSITION_X, capacity);
+    stripChart->addChannel("Y轴", Qt::green, Device::MIN_POSITION, Device::MAX_POSITION_Y, capacity);
+    stripChart->addChannel("Z轴", Qt::blue, Device::MIN_POSITION, Device::MAX_POSITION_Z, capacity);
+    stripChart->addChannel("速度", Qt::darkGreen, 0, Device::MAX_SPEED, capacity);
+    stripChart->addChannel("压力", Qt::darkMagenta, Device::MIN_PRESSURE, Device::MAX_PRESSURE, capacity);
+    stripChart->addChannel("温度", Qt::darkRed, Device::MIN_TEMPERATURE, Device::MAX_TEMPERATURE, capacity);
+    
+    chartStack = new QStackedWidget;
+    chartStack->addWidget(chartPage);
+    chartStack->addWidget(stripChart);
+    layout->addWidget(chartStack, 0, 0);
 }
 
 void DataMonitorWidget::setupDataTablePanel()
@@ -260,6 +308,10 @@ void DataMonitorWidget::setupControlPanel()
     layout->addWidget(stopButton);
     layout->addWidget(pauseButton);
     layout->addWidget(configButton);
+    
+    stripChartCheckBox = new QCheckBox("高速条带图");
+    stripChartCheckBox->setToolTip("不经过 QtCharts 直接绘制，适合 kHz 级传感器数据");
+    layout->addWidget(stripChartCheckBox);
     layout->addStretch();
     layout->addWidget(monitoringStatusLabel);
 }
@@ -277,6 +329,10 @@ void DataMonitorWidget::setupConnections()
         }
     });
     connect(configButton, &QPushButton::clicked, this, &DataMonitorWidget::onConfigSettings);
+    connect(stripChartCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        config.useStripChart = checked;
+        applyChartMode();
+    });
     
     // 数据表格按钮信号
     connect(exportButton, &QPushButton::clicked, this, &DataMonitorWidget::onExportData);
@@ -346,6 +402,27 @@ void DataMonitorWidget::initializeCharts()
     temperatureChart->addSeries(temperatureSeries);
     temperatureChart->createDefaultAxes();
     temperatureChartView->setChart(temperatureChart);
+    
+    applyOpenGL();
+}
+
+void DataMonitorWidget::applyChartMode()
+{
+    stripChartCheckBox->setChecked(config.useStripChart);
+    chartStack->setCurrentWidget(config.useStripChart ? static_cast<QWidget*>(stripChart) : chartStack->widget(0));
+    
+    // 切回曲线时按缓冲区中的数据补画
+    if (!config.useStripChart) {
+        updateCharts();
+    }
+}
+
+void DataMonitorWidget::applyOpenGL()
+{
+    for (QLineSeries* series : {positionXSeries, positionYSeries, positionZSeries,
+                                velocitySeries, pressureSeries, temperatureSeries}) {
+        series->setUseOpenGL(config.useOpenGL);
+    }
 }
 
 // 监控控制
@@ -390,8 +467,11 @@ void DataMonitorWidget::stopMonitoring()
     monitoringStatusLabel->setText("监控状态: 已停止");
     monitoringStatusLabel->setStyleSheet("QLabel { font-weight: bold; color: red; }");
     
+    // 封存未满的历史块，停止后的查询和导出直接读文件
+    SensorHistory::getInstance()->store()->flush();
+    
     emit monitoringStateChanged(false);
-    LogManager::getInstance()->info("停止数据监控", "DataMonitor");
+    LogManager::getInstance()->info("停止数据监控，曲线帧耗时: " + frameTimes.summary(), "DataMonitor");
 }
 
 void DataMonitorWidget::pauseMonitoring()
@@ -423,6 +503,16 @@ void DataMonitorWidget::resumeMonitoring()
 }
 
 void DataMonitorWidget::updateRealTimeData(const RealTimeData& data)
+{
+    showRealTimeData(data);
+    
+    // 不是来自串口帧的数据（帧已在接收线程评估过）
+    if (config.enableAlerts) {
+        checkAlerts(data);
+    }
+}
+
+void DataMonitorWidget::showRealTimeData(const RealTimeData& data)
 {
     QMutexLocker locker(&dataMutex);
     currentData = data;
@@ -432,25 +522,24 @@ void DataMonitorWidget::updateRealTimeData(const RealTimeData& data)
     
     // 更新显示
     updateRealTimeDisplay();
+    markDisplayed(data.receivedNs);
     updateCharts();
     
-    // 检查报警
-    if (config.enableAlerts) {
-        checkAlerts(data);
-    }
-    
     emit dataUpdated(data);
 }
 
 void DataMonitorWidget::addDataPoint(const RealTimeData& data)
 {
+    // 完整历史写入列式存储，historyData 只保留表格显示的最近数据
+    const double values[SensorHistory::ColumnCount] = {
+        data.positionX, data.positionY, data.positionZ, data.velocity,
+        data.pressure, data.temperature, data.glueVolume, static_cast<double>(data.deviceStatus)
+    };
+    SensorHistory::getInstance()->append(data.epochMs(), values);
+
+    // 满了之后覆盖最旧的一条
     historyData.append(data);
     
-    // 限制历史数据大小
-    while (historyData.size() > config.historySize) {
-        historyData.removeFirst();
-    }
-    
     // 更新图表数据
     addChartData(data);
     
@@ -495,59 +584,119 @@ void DataMonitorWidget::updateRealTimeDisplay()
                               .arg(statusColor.name()));
 }
 
+// 只统计屏幕上显示的最新数值，同一次绘制之前被覆盖的帧不计入绘制和端到端延迟
+void DataMonitorWidget::markDisplayed(qint64 receivedNs)
+{
+    if (receivedNs <= 0 || !positionXLabel->isVisible()) {
+        displayedNs = 0;    // 隐藏期间不统计，重新显示时的绘制不算作这一帧的延迟
+        return;
+    }
+    displayedReceivedNs = receivedNs;
+    displayedNs = MonotonicClock::nowNs();
+    positionXLabel->update();
+}
+
+bool DataMonitorWidget::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == positionXLabel && event->type() == QEvent::Paint && displayedNs > 0) {
+        FrameLatencyMonitor* latency = FrameLatencyMonitor::getInstance();
+        latency->recordSince(FrameLatencyStage::Paint, displayedNs);
+        latency->recordSince(FrameLatencyStage::Total, displayedReceivedNs);
+        displayedNs = 0;
+        displayedReceivedNs = 0;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
 void DataMonitorWidget::addChartData(const RealTimeData& data)
 {
-    double timeValue = data.timestamp.toMSecsSinceEpoch();
-    
-    // 添加数据点
-    positionXSeries->append(timeValue, data.positionX);
-    positionYSeries->append(timeValue, data.positionY);
-    positionZSeries->append(timeValue, data.positionZ);
-    velocitySeries->append(timeValue, data.velocity);
-    pressureSeries->append(timeValue, data.pressure);
-    temperatureSeries->append(timeValue, data.temperature);
-    
-    // 限制数据点数量
-    if (positionXSeries->count() > MAX_CHART_POINTS) {
-        positionXSeries->removePoints(0, positionXSeries->count() - MAX_CHART_POINTS);
-        positionYSeries->removePoints(0, positionYSeries->count() - MAX_CHART_POINTS);
-        positionZSeries->removePoints(0, positionZSeries->count() - MAX_CHART_POINTS);
-        velocitySeries->removePoints(0, velocitySeries->count() - MAX_CHART_POINTS);
-        pressureSeries->removePoints(0, pressureSeries->count() - MAX_CHART_POINTS);
-        temperatureSeries->removePoints(0, temperatureSeries->count() - MAX_CHART_POINTS);
+    const qint64 timeValue = data.epochMs();
+    
+    // 添加数据点，满了之后覆盖最旧的点
+    positionXData.append(timeValue, data.positionX);
+    positionYData.append(timeValue, data.positionY);
+    positionZData.append(timeValue, data.positionZ);
+    velocityData.append(timeValue, data.velocity);
+    pressureData.append(timeValue, data.pressure);
+    temperatureData.append(timeValue, data.temperature);
+    
+    int channel = 0;
+    for (double value : {data.positionX, data.positionY, data.positionZ,
+                         data.velocity, data.pressure, data.temperature}) {
+        stripChart->append(channel++, timeValue, value);
+    }
+}
+
+void DataMonitorWidget::updateCharts()
+{
+    // 条带图自己按定时器滚动
+    if (config.useStripChart) return;
+    
+    // 定时器运行期间到达的数据在下一次重绘时一起显示
+    if (!chartRenderTimer->isActive()) {
+        chartRenderTimer->start();
     }
+}
+
+void DataMonitorWidget::renderCharts()
+{
+    QMutexLocker locker(&dataMutex);
+    
+    const SeriesRingBuffer::View timeline = positionXData.view();
+    if (timeline.isEmpty()) return;
+    
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    
+    const qint64 startMs = timeline.timestampAt(0);
+    const qint64 endMs = timeline.timestampAt(timeline.size() - 1);
+    
+    // 按各图表绘图区的像素宽度取每列最小/最大值，整条曲线一次替换
+    const auto render = [startMs, endMs](QChart* chart, QLineSeries* series, const SeriesRingBuffer& buffer) {
+        const int width = static_cast<int>(chart->plotArea().width());
+        const int columns = std::min(width > 0 ? width : System::CHART_DEFAULT_RENDER_COLUMNS,
+                                     System::CHART_MAX_RENDER_POINTS / 2);
+        series->replace(SeriesDecimator::minMax(buffer.view(), startMs, endMs, columns));
+    };
+    render(positionChart, positionXSeries, positionXData);
+    render(positionChart, positionYSeries, positionYData);
+    render(positionChart, positionZSeries, positionZData);
+    render(velocityChart, velocitySeries, velocityData);
+    render(pressureChart, pressureSeries, pressureData);
+    render(temperatureChart, temperatureSeries, temperatureData);
     
     // 更新图表范围
-    updateChartRange();
+    updateChartRange(startMs, endMs);
+    static MetricHistogram* const frameMetric = MetricsRegistry::histogram(
+        "glue_ui_frame_seconds", "界面一次刷新的耗时", MetricsRegistry::label("widget", "data_monitor"),
+        MetricsRegistry::frameBucketsNs());
+    const qint64 frameNs = frameTimer.nsecsElapsed();
+    frameTimes.record(frameNs);
+    frameMetric->observe(frameNs);
 }
 
-void DataMonitorWidget::updateChartRange()
+void DataMonitorWidget::updateChartRange(qint64 startMs, qint64 endMs)
 {
-    // 获取最近的时间范围
-    if (positionXSeries->count() > 1) {
-        double minTime = positionXSeries->at(0).x();
-        double maxTime = positionXSeries->at(positionXSeries->count() - 1).x();
-        
-        // 更新X轴范围（时间轴）
-        positionChart->axes(Qt::Horizontal).first()->setRange(QDateTime::fromMSecsSinceEpoch(minTime), 
-                                                             QDateTime::fromMSecsSinceEpoch(maxTime));
-        velocityChart->axes(Qt::Horizontal).first()->setRange(QDateTime::fromMSecsSinceEpoch(minTime), 
-                                                             QDateTime::fromMSecsSinceEpoch(maxTime));
-        pressureChart->axes(Qt::Horizontal).first()->setRange(QDateTime::fromMSecsSinceEpoch(minTime), 
-                                                             QDateTime::fromMSecsSinceEpoch(maxTime));
-        temperatureChart->axes(Qt::Horizontal).first()->setRange(QDateTime::fromMSecsSinceEpoch(minTime), 
-                                                                QDateTime::fromMSecsSinceEpoch(maxTime));
-    }
+    if (endMs <= startMs) return;
+    
+    // 更新X轴范围（时间轴）
+    const QDateTime minTime = QDateTime::fromMSecsSinceEpoch(startMs);
+    const QDateTime maxTime = QDateTime::fromMSecsSinceEpoch(endMs);
+    positionChart->axes(Qt::Horizontal).first()->setRange(minTime, maxTime);
+    velocityChart->axes(Qt::Horizontal).first()->setRange(minTime, maxTime);
+    pressureChart->axes(Qt::Horizontal).first()->setRange(minTime, maxTime);
+    temperatureChart->axes(Qt::Horizontal).first()->setRange(minTime, maxTime);
 }
 
 void DataMonitorWidget::updateDataTable()
 {
-    dataTableWidget->setRowCount(historyData.size());
+    const RingBuffer<RealTimeData>::View history = historyData.view();
+    dataTableWidget->setRowCount(history.size());
     
-    for (int i = 0; i < historyData.size(); ++i) {
-        const RealTimeData& data = historyData[i];
+    for (int i = 0; i < history.size(); ++i) {
+        const RealTimeData& data = history[i];
         
-        dataTableWidget->setItem(i, 0, new QTableWidgetItem(formatTime(data.timestamp)));
+        dataTableWidget->setItem(i, 0, new QTableWidgetItem(formatTime(data.dateTime())));
         dataTableWidget->setItem(i, 1, new QTableWidgetItem(formatValue(data.positionX, "", 3)));
         dataTableWidget->setItem(i, 2, new QTableWidgetItem(formatValue(data.positionY, "", 3)));
         dataTableWidget->setItem(i, 3, new QTableWidgetItem(formatValue(data.positionZ, "", 3)));
@@ -578,25 +727,72 @@ void DataMonitorWidget::updateDataTable()
 
 void DataMonitorWidget::checkAlerts(const RealTimeData& data)
 {
-    QStringList alerts;
-    
-    if (data.temperature > config.alertThresholds.maxTemperature) {
-        alerts << QString("温度过高: %1°C").arg(data.temperature, 0, 'f', 1);
-    }
-    if (data.temperature < config.alertThresholds.minTemperature) {
-        alerts << QString("温度过低: %1°C").arg(data.temperature, 0, 'f', 1);
-    }
-    if (data.pressure > config.alertThresholds.maxPressure) {
-        alerts << QString("压力过高: %1Bar").arg(data.pressure, 0, 'f', 2);
-    }
-    if (data.pressure < config.alertThresholds.minPressure) {
-        alerts << QString("压力过低: %1Bar").arg(data.pressure, 0, 'f', 2);
-    }
-    if (data.velocity > config.alertThresholds.maxVelocity) {
-        alerts << QString("速度过快: %1mm/s").arg(data.velocity, 0, 'f', 2);
+    // 与传感器帧相同的通道顺序交给报警引擎，越限时通过 onAlarmTransitions() 报警
+    const double values[AlarmEngine::SensorInputCount] = {
+        data.positionX, data.positionY, data.positionZ, data.velocity,
+        data.pressure, data.temperature, data.glueVolume
+    };
+    const qint64 timestampNs = MonotonicClock::nowNs();
+    AlarmEngine::getInstance()->evaluate(values, 1, AlarmEngine::SensorInputCount, &timestampNs);
+}
+
+void DataMonitorWidget::syncAlertLimits()
+{
+    if (!config.enableAlerts) {
+        AlarmEngine::getInstance()->clearLimits(Communication::MONITOR_ALARM_GROUP);
+        return;
     }
     
-    for (const QString& alert : alerts) {
+    const MonitorConfig::AlertThresholds& thresholds = config.alertThresholds;
+    QList<AlarmLimit> limits;
+    
+    AlarmLimit temperature;
+    temperature.name = "temperature";
+    temperature.input = "temperature";
+    temperature.high = thresholds.maxTemperature;
+    temperature.low = thresholds.minTemperature;
+    temperature.enableHigh = true;
+    temperature.enableLow = true;
+    limits.append(temperature);
+    
+    AlarmLimit pressure;
+    pressure.name = "pressure";
+    pressure.input = "pressure";
+    pressure.high = thresholds.maxPressure;
+    pressure.low = thresholds.minPressure;
+    pressure.enableHigh = true;
+    pressure.enableLow = true;
+    limits.append(pressure);
+    
+    AlarmLimit velocity;
+    velocity.name = "velocity";
+    velocity.input = "velocity";
+    velocity.high = thresholds.maxVelocity;
+    velocity.enableHigh = true;
+    limits.append(velocity);
+    
+    AlarmEngine::getInstance()->setLimits(Communication::MONITOR_ALARM_GROUP, limits);
+}
+
+void DataMonitorWidget::onAlarmTransitions(const AlarmTransitionBatch& transitions)
+{
+    for (const AlarmTransition& transition : transitions) {
+        if (transition.group != Communication::MONITOR_ALARM_GROUP || transition.to == AlarmLimitState::Normal) {
+            continue;
+        }
+        
+        const bool high = transition.to > AlarmLimitState::Normal;
+        QString alert;
+        if (transition.name == "temperature") {
+            alert = QString(high ? "温度过高: %1°C" : "温度过低: %1°C").arg(transition.value, 0, 'f', 1);
+        } else if (transition.name == "pressure") {
+            alert = QString(high ? "压力过高: %1Bar" : "压力过低: %1Bar").arg(transition.value, 0, 'f', 2);
+        } else if (transition.name == "velocity") {
+            alert = QString("速度过快: %1mm/s").arg(transition.value, 0, 'f', 2);
+        } else {
+            continue;
+        }
+        
         emit alertTriggered(alert);
         LogManager::getInstance()->warning("监控报警: " + alert, "DataMonitor");
     }
@@ -619,7 +815,7 @@ void DataMonitorWidget::onDataReceived()
     time += 0.1;
     
     RealTimeData data;
-    data.timestamp = QDateTime::currentDateTime();
+    data.timestampNs = MonotonicClock::nowNs();
     data.positionX = 10 * sin(time * 0.1);
     data.positionY = 10 * cos(time * 0.1);
     data.positionZ = 2 * sin(time * 0.2);
@@ -634,32 +830,68 @@ void DataMonitorWidget::onDataReceived()
 
 void DataMonitorWidget::onFrameReceived(const ProtocolFrame& frame)
 {
-    // 解析协议帧并更新数据
-    if (frame.command == ProtocolCommand::ReadSensorData) {
-        if (frame.data.size() >= 32) { // 假设数据包大小
-            QDataStream stream(frame.data);
-            stream.setByteOrder(QDataStream::LittleEndian);
-            
-            RealTimeData data;
-            data.timestamp = QDateTime::currentDateTime();
-            
-            float x, y, z, vel, press, temp, vol;
-            quint8 status;
-            
-            stream >> x >> y >> z >> vel >> press >> temp >> vol >> status;
-            
-            data.positionX = x;
-            data.positionY = y;
-            data.positionZ = z;
-            data.velocity = vel;
-            data.pressure = press;
-            data.temperature = temp;
-            data.glueVolume = vol;
-            data.deviceStatus = status;
-            
-            updateRealTimeData(data);
+    FrameLatencyMonitor::getInstance()->recordSince(FrameLatencyStage::Dispatch, frame.timestampNs);
+    RealTimeData data;
+    if (parseSensorFrame(frame, data)) {
+        showRealTimeData(data);
+    }
+}
+
+void DataMonitorWidget::onFramesReceived(const QList<ProtocolFrame>& frames)
+{
+    // 整批数据全部记入历史，但界面和图表只刷新一次
+    QMutexLocker locker(&dataMutex);
+    
+    FrameLatencyMonitor* latency = FrameLatencyMonitor::getInstance();
+    bool hasData = false;
+    for (const ProtocolFrame& frame : frames) {
+        latency->recordSince(FrameLatencyStage::Dispatch, frame.timestampNs);
+        RealTimeData data;
+        if (!parseSensorFrame(frame, data)) {
+            continue;
         }
+        
+        currentData = data;
+        addDataPoint(data);
+        hasData = true;
+    }
+    
+    if (hasData) {
+        updateRealTimeDisplay();
+        markDisplayed(currentData.receivedNs);
+        updateCharts();
+        emit dataUpdated(currentData);
+    }
+}
+
+bool DataMonitorWidget::parseSensorFrame(const ProtocolFrame& frame, RealTimeData& data) const
+{
+    // 解析协议帧数据
+    if (frame.command != ProtocolCommand::ReadSensorData || frame.dataLength < 32) { // 假设数据包大小
+        return false;
     }
+    
+    QDataStream stream(frame.payload());
+    stream.setByteOrder(QDataStream::LittleEndian);
+    
+    // 使用接收线程打上的时间戳，没有时取当前时间
+    data.timestampNs = frame.timestampNs > 0 ? frame.timestampNs : MonotonicClock::nowNs();
+    data.receivedNs = frame.receivedNs;
+    
+    float x, y, z, vel, press, temp, vol;
+    quint8 status;
+    
+    stream >> x >> y >> z >> vel >> press >> temp >> vol >> status;
+    
+    data.positionX = x;
+    data.positionY = y;
+    data.positionZ = z;
+    data.velocity = vel;
+    data.pressure = press;
+    data.temperature = temp;
+    data.glueVolume = vol;
+    data.deviceStatus = status;
+    return true;
 }
 
 void DataMonitorWidget::onExportData()
@@ -726,6 +958,14 @@ void DataMonitorWidget::setSerialWorker(SerialWorker* worker)
     if (serialWorker) {
         connect(serialWorker, &SerialWorker::frameReceived, 
                 this, &DataMonitorWidget::onFrameReceived);
+        connect(serialWorker, &SerialWorker::framesReceived, 
+                this, &DataMonitorWidget::onFramesReceived);
+        
+        // 报警评估直接在接收线程进行，界面线程只处理状态变化
+        AlarmEngine* engine = AlarmEngine::getInstance();
+        const auto type = static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection);
+        connect(serialWorker, &SerialWorker::frameReceived, engine, &AlarmEngine::evaluateFrame, type);
+        connect(serialWorker, &SerialWorker::framesReceived, engine, &AlarmEngine::evaluateFrames, type);
     }
 }
 
@@ -735,6 +975,14 @@ void DataMonitorWidget::clearHistory()
     historyData.clear();
     
     // 清空图表
+    positionXData.clear();
+    positionYData.clear();
+    positionZData.clear();
+    velocityData.clear();
+    pressureData.clear();
+    temperatureData.clear();
+    chartRenderTimer->stop();
+    stripChart->clear();
     positionXSeries->clear();
     positionYSeries->clear();
     positionZSeries->clear();
@@ -763,22 +1011,44 @@ void DataMonitorWidget::exportData(const QString& filePath)
     // 写入表头
     stream << "时间,X位置,Y位置,Z位置,速度,压力,温度,胶量,状态\n";
     
-    // 写入数据
-    for (const RealTimeData& data : historyData) {
-        stream << formatTime(data.timestamp) << ","
-               << data.positionX << ","
-               << data.positionY << ","
-               << data.positionZ << ","
-               << data.velocity << ","
-               << data.pressure << ","
-               << data.temperature << ","
-               << data.glueVolume << ","
-               << data.deviceStatus << "\n";
+    // 写入数据：本次监控开始以来的完整历史从存储读取，未开始过监控时导出表格中的数据
+    qint64 exportedCount = 0;
+    TimeSeriesStore* store = SensorHistory::getInstance()->store();
+    if (startTime.isValid() && store->isOpen()) {
+        QList<int> columns;
+        for (int column = 0; column < SensorHistory::ColumnCount; ++column) {
+            columns.append(column);
+        }
+        exportedCount = store->visit(startTime.toMSecsSinceEpoch(), QDateTime::currentMSecsSinceEpoch(), columns,
+                                     [this, &stream](qint64 timestampMs, const double* values) {
+            stream << formatTime(QDateTime::fromMSecsSinceEpoch(timestampMs)) << ","
+                   << values[SensorHistory::PositionX] << ","
+                   << values[SensorHistory::PositionY] << ","
+                   << values[SensorHistory::PositionZ] << ","
+                   << values[SensorHistory::Velocity] << ","
+                   << values[SensorHistory::Pressure] << ","
+                   << values[SensorHistory::Temperature] << ","
+                   << values[SensorHistory::GlueVolume] << ","
+                   << static_cast<int>(values[SensorHistory::DeviceStatus]) << "\n";
+        });
+    } else {
+        for (const RealTimeData& data : historyData.view()) {
+            stream << formatTime(data.dateTime()) << ","
+                   << data.positionX << ","
+                   << data.positionY << ","
+                   << data.positionZ << ","
+                   << data.velocity << ","
+                   << data.pressure << ","
+                   << data.temperature << ","
+                   << data.glueVolume << ","
+                   << data.deviceStatus << "\n";
+        }
+        exportedCount = historyData.size();
     }
     
     QMessageBox::information(this, "导出完成", 
                             QString("成功导出 %1 条数据到文件：\n%2")
-                            .arg(historyData.size()).arg(filePath));
+                            .arg(exportedCount).arg(filePath));
     
     LogManager::getInstance()->info("导出监控数据: " + filePath, "DataMonitor");
 }
@@ -792,16 +1062,22 @@ void DataMonitorWidget::setMonitorConfig(const MonitorConfig& newConfig)
 {
     config = newConfig;
     updateTimer->setInterval(config.updateInterval);
+    applyOpenGL();
+    applyChartMode();
     
-    // 限制历史数据大小
-    while (historyData.size() > config.historySize) {
-        historyData.removeFirst();
-    }
+    // 保留最新的 historySize 条
+    historyData.setCapacity(config.historySize);
+    syncAlertLimits();
     
     emit onConfigChanged();
 }
 
-QList<RealTimeData> DataMonitorWidget::getHistoryData() const
+LatencyHistogram DataMonitorWidget::frameTimeHistogram() const
+{
+    return frameTimes;
+}
+
+RingBuffer<RealTimeData>::View DataMonitorWidget::getHistoryData() const
 {
-    return historyData;
+    return historyData.view();
 } 
\ No newline at end of file
@@ -14,7 +14,6 @@
 #include <QSplitter>
 #include <QTimer>
 #include <QDateTime>
-#include <QQueue>
 #include <QMutex>
 #include <QPainter>
 #include <QPushButton>
@@ -23,10 +22,15 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QDateTimeAxis>
+#include "../utils/seriesringbuffer.h"
+#include "../utils/latencyhistogram.h"
+#include "../utils/monotonicclock.h"
+#include "../utils/ringbuffer.h"
+#include "../communication/alarmengine.h"
 
 // 实时数据结构
 struct RealTimeData {
-    QDateTime timestamp;        // 时间戳
+    qint64 timestampNs;        // 采样时刻（MonotonicClock 单调时钟）
     double positionX;          // X轴位置
     double positionY;          // Y轴位置
     double positionZ;          // Z轴位置
@@ -35,12 +39,18 @@ struct RealTimeData {
     double temperature;        // 当前温度
     double glueVolume;         // 胶量
     int deviceStatus;          // 设备状态
+    qint64 receivedNs;         // 来自接收帧时为帧的读取时刻（ProtocolFrame::receivedNs），否则为 0
     
+    // 构造时不读时钟，由数据来源填写时间戳
     RealTimeData() 
-        : timestamp(QDateTime::currentDateTime())
+        : timestampNs(0)
         , positionX(0), positionY(0), positionZ(0)
         , velocity(0), pressure(0), temperature(25.0)
-        , glueVolume(0), deviceStatus(0) {}
+        , glueVolume(0), deviceStatus(0), receivedNs(0) {}
+    
+    // 图表横轴和历史存储使用墙钟毫秒，显示使用 QDateTime，都只在需要时换算
+    qint64 epochMs() const { return MonotonicClock::toEpochMs(timestampNs); }
+    QDateTime dateTime() const { return MonotonicClock::dateTimeAt(timestampNs); }
 };
 
 // 监控配置
@@ -49,6 +59,8 @@ struct MonitorConfig {
     int historySize;          // 历史数据大小
     bool enableLogging;       // 是否启用日志
     bool enableAlerts;        // 是否启用报警
+    bool useOpenGL;           // 曲线用 OpenGL 绘制
+    bool useStripChart;       // 用高速条带图代替 QtCharts 曲线
     
     // 报警阈值
     struct AlertThresholds {
@@ -66,10 +78,13 @@ struct MonitorConfig {
     
     MonitorConfig() 
         : updateInterval(100), historySize(1000)
-        , enableLogging(true), enableAlerts(true) {}
+        , enableLogging(true), enableAlerts(true), useOpenGL(false), useStripChart(false) {}
 };
 
 class SerialWorker;
+class StripChartWidget;
+class QStackedWidget;
+class QCheckBox;
 struct ProtocolFrame;
 
 #include <QtCharts/QChartView>
@@ -100,10 +115,14 @@ public:
     // 数据管理
     void clearHistory();
     void exportData(const QString& filePath);
-    QList<RealTimeData> getHistoryData() const;
+    // 最近的 historySize 条数据，按时间顺序；不拷贝，只在界面线程使用，下一次写入前有效
+    RingBuffer<RealTimeData>::View getHistoryData() const;
     
     // 串口通讯
     void setSerialWorker(SerialWorker* worker);
+    
+    // 每帧重绘曲线的耗时
+    LatencyHistogram frameTimeHistogram() const;
 
 public slots:
     void startMonitoring();
@@ -115,6 +134,9 @@ public slots:
     void onUpdateTimer();
     void onConfigChanged();
 
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 signals:
     void dataUpdated(const RealTimeData& data);
     void alertTriggered(const QString& message);
@@ -122,6 +144,8 @@ signals:
 
 private slots:
     void onFrameReceived(const ProtocolFrame& frame);
+    void onFramesReceived(const QList<ProtocolFrame>& frames);
+    void onAlarmTransitions(const AlarmTransitionBatch& transitions);
     void onExportData();
     void onClearHistory();
     void onConfigSettings();
@@ -135,13 +159,20 @@ private:
     void setupConnections();
     
     void updateRealTimeDisplay();
+    void markDisplayed(qint64 receivedNs);
     void updateCharts();
     void updateDataTable();
+    void showRealTimeData(const RealTimeData& data);
     void checkAlerts(const RealTimeData& data);
+    void syncAlertLimits();
+    bool parseSensorFrame(const ProtocolFrame& frame, RealTimeData& data) const;
     
     void initializeCharts();
+    void applyOpenGL();
+    void applyChartMode();
     void addChartData(const RealTimeData& data);
-    void updateChartRange();
+    void renderCharts();
+    void updateChartRange(qint64 startMs, qint64 endMs);
     
     QString formatValue(double value, const QString& unit, int precision = 2) const;
     QString formatTime(const QDateTime& time) const;
@@ -182,6 +213,11 @@ private:
     QLineSeries* pressureSeries;
     QLineSeries* temperatureSeries;
     
+    // 高速条带图，与上面的图表视图二选一显示
+    QStackedWidget* chartStack;
+    StripChartWidget* stripChart;
+    QCheckBox* stripChartCheckBox;
+    
     // 数据表格面板
     QGroupBox* dataTableGroup;
     QTableWidget* dataTableWidget;
@@ -198,7 +234,7 @@ private:
     QLabel* monitoringStatusLabel;
     
     // 数据成员
-    QList<RealTimeData> historyData;
+    RingBuffer<RealTimeData> historyData;
     RealTimeData currentData;
     MonitorConfig config;
     SerialWorker* serialWorker;
@@ -210,15 +246,19 @@ private:
     bool isPaused;
     QDateTime startTime;
     
-    // 图表数据
-    QQueue<double> timeData;
-    QQueue<double> positionXData;
-    QQueue<double> positionYData;
-    QQueue<double> positionZData;
-    QQueue<double> velocityData;
-    QQueue<double> pressureData;
-    QQueue<double> temperatureData;
+    // 图表数据：原始点保存在环形缓冲区，曲线只显示按像素列降采样后的点
+    SeriesRingBuffer positionXData;
+    SeriesRingBuffer positionYData;
+    SeriesRingBuffer positionZData;
+    SeriesRingBuffer velocityData;
+    SeriesRingBuffer pressureData;
+    SeriesRingBuffer temperatureData;
+    QTimer* chartRenderTimer;   // 合并一段时间内的数据更新，每次只重绘一次曲线
+    LatencyHistogram frameTimes;
+    
+    // 端到端延迟：界面更新了来自接收帧的数值、尚未绘制时非 0
+    qint64 displayedReceivedNs;     // 该帧的读取时刻
+    qint64 displayedNs;             // 数值更新的时刻
     
-    static constexpr int MAX_CHART_POINTS = 500;
     static constexpr int TABLE_UPDATE_INTERVAL = 10; // 每10个数据点更新一次表格
 }; 
\ No newline at end of file
@@ -1,4 +1,12 @@
 #include "datarecordwidget.h"
+#include "core/databasebackup.h"
+#include "core/databaseservice.h"
+#include "core/databaseschema.h"
+#include "core/dataexporter.h"
+#include "core/tablepartitions.h"
+#include "logger/logmanager.h"
+#include "sqlpagemodel.h"
+#include "../constants.h"
 #include <QApplication>
 #include <QSplitter>
 #include <QTextStream>
@@ -21,6 +29,212 @@
 #include <QPixmap>
 #include <QBuffer>
 #include <QImageWriter>
+#include <QFile>
+#include <limits>
+
+namespace {
+const QString BACKUP_BASE_NAME = "production_data";
+
+// 写入直接插入按时间选出的分区表（%1），读取使用合并各分区的同名视图
+const QString INSERT_QUALITY_SQL = R"(
+    INSERT INTO %1 (
+        batch_id, timestamp, position_x, position_y, position_z,
+        glue_volume, pressure, temperature, speed, quality_level,
+        is_qualified, defect_type, inspector, notes
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+const QString INSERT_ALARM_SQL = R"(
+    INSERT INTO %1 (
+        timestamp, alarm_type, alarm_level, alarm_code, alarm_message,
+        device_name, operator_name, is_acknowledged, acknowledge_time,
+        acknowledge_user, solution, notes
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+QString formatTableTime(const QVariant& value)
+{
+    const QDateTime time = value.toDateTime();
+    return time.isValid() ? time.toString("yyyy-MM-dd hh:mm:ss") : QString();
+}
+
+// 生产批次表格：第 11 列为派生的状态（结束时间为空表示进行中）
+QVariant productionData(const QVariantList& row, int column, int role)
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    const QVariant value = row.value(column);
+    switch (column) {
+    case 3:
+    case 4: return formatTableTime(value);
+    case 8: return QString::number(value.toDouble(), 'f', 2);
+    case 11: return value.toInt() == 0 ? "进行中" : "已完成";
+    default: return value.toString();
+    }
+}
+
+QVariant qualityData(const QVariantList& row, int column, int role)
+{
+    if (role == Qt::ForegroundRole && column == 11) {
+        return row.value(column).toBool() ? QVariant() : QVariant(QColor(Qt::red));
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    const QVariant value = row.value(column);
+    switch (column) {
+    case 2: return formatTableTime(value);
+    case 3:
+    case 4:
+    case 5: return QString::number(value.toDouble(), 'f', 3);
+    case 6:
+    case 7:
+    case 8:
+    case 9: return QString::number(value.toDouble(), 'f', 2);
+    case 11: return value.toBool() ? "是" : "否";
+    default: return value.toString();
+    }
+}
+
+// 过期分区的删除结果
+struct RetentionResult {
+    QStringList dropped;
+    qint64 rows = 0;
+    QString error;
+};
+
+ProductionBatch batchFromRecord(const QSqlRecord& record)
+{
+    ProductionBatch batch;
+    batch.batchId = record.value("batch_id").toInt();
+    batch.batchName = record.value("batch_name").toString();
+    batch.productType = record.value("product_type").toString();
+    batch.startTime = record.value("start_time").toDateTime();
+    batch.endTime = record.value("end_time").toDateTime();
+    batch.totalCount = record.value("total_count").toInt();
+    batch.qualifiedCount = record.value("qualified_count").toInt();
+    batch.defectCount = record.value("defect_count").toInt();
+    batch.qualityRate = record.value("quality_rate").toDouble();
+    batch.operatorName = record.value("operator_name").toString();
+    batch.programName = record.value("program_name").toString();
+    batch.notes = record.value("notes").toString();
+    batch.parameters = QJsonDocument::fromJson(record.value("parameters").toByteArray()).object();
+    batch.qualityData = QJsonDocument::fromJson(record.value("quality_data").toByteArray()).array();
+    return batch;
+}
+
+QualityData qualityFromRecord(const QSqlRecord& record)
+{
+    QualityData data;
+    data.recordId = record.value("record_id").toInt();
+    data.batchId = record.value("batch_id").toInt();
+    data.timestamp = record.value("timestamp").toDateTime();
+    data.positionX = record.value("position_x").toDouble();
+    data.positionY = record.value("position_y").toDouble();
+    data.positionZ = record.value("position_z").toDouble();
+    data.glueVolume = record.value("glue_volume").toDouble();
+    data.pressure = record.value("pressure").toDouble();
+    data.temperature = record.value("temperature").toDouble();
+    data.speed = record.value("speed").toDouble();
+    data.qualityLevel = record.value("quality_level").toString();
+    data.isQualified = record.value("is_qualified").toBool();
+    data.defectType = record.value("defect_type").toString();
+    data.inspector = record.value("inspector").toString();
+    data.notes = record.value("notes").toString();
+    return data;
+}
+
+DataRecordAlarm alarmFromRecord(const QSqlRecord& record)
+{
+    DataRecordAlarm alarm;
+    alarm.alarmId = record.value("alarm_id").toInt();
+    alarm.timestamp = record.value("timestamp").toDateTime();
+    alarm.alarmType = record.value("alarm_type").toString();
+    alarm.alarmLevel = record.value("alarm_level").toString();
+    alarm.alarmCode = record.value("alarm_code").toString();
+    alarm.alarmMessage = record.value("alarm_message").toString();
+    alarm.deviceName = record.value("device_name").toString();
+    alarm.operatorName = record.value("operator_name").toString();
+    alarm.isAcknowledged = record.value("is_acknowledged").toBool();
+    alarm.acknowledgeTime = record.value("acknowledge_time").toDateTime();
+    alarm.acknowledgeUser = record.value("acknowledge_user").toString();
+    alarm.solution = record.value("solution").toString();
+    alarm.notes = record.value("notes").toString();
+    return alarm;
+}
+
+// 一张表的导出：列和表头一一对应，按时间列（已建索引）升序读取
+struct ExportTable {
+    const char* dataType;
+    const char* table;
+    const char* timeColumn;
+    const char* order;
+    QStringList columns;
+    QStringList headers;
+};
+
+const QList<ExportTable>& exportTables()
+{
+    static const QList<ExportTable> tables = {
+        {"生产数据", "production_batches", "start_time", "start_time, batch_id",
+         {"batch_id", "batch_name", "product_type", "start_time", "end_time", "total_count", "qualified_count",
+          "defect_count", "quality_rate", "operator_name", "program_name", "notes"},
+         {"批次ID", "批次名称", "产品类型", "开始时间", "结束时间", "总数量", "合格数量",
+          "不良数量", "合格率", "操作员", "使用程序", "备注"}},
+        {"质量数据", "quality_data", "timestamp", "timestamp, record_id",
+         {"record_id", "batch_id", "timestamp", "position_x", "position_y", "position_z", "glue_volume", "pressure",
+          "temperature", "speed", "quality_level", "is_qualified", "defect_type", "inspector", "notes"},
+         {"记录ID", "批次ID", "时间", "X坐标", "Y坐标", "Z坐标", "胶量", "压力",
+          "温度", "速度", "质量等级", "是否合格", "缺陷类型", "检测员", "备注"}},
+        {"报警记录", "alarm_records", "timestamp", "timestamp, alarm_id",
+         {"alarm_id", "timestamp", "alarm_type", "alarm_level", "alarm_code", "alarm_message", "device_name",
+          "operator_name", "is_acknowledged", "acknowledge_time", "acknowledge_user", "solution", "notes"},
+         {"报警ID", "时间", "报警类型", "报警等级", "报警代码", "报警信息", "设备名称",
+          "操作员", "是否确认", "确认时间", "确认用户", "解决方案", "备注"}},
+        {"统计数据", "statistics_data", "date", "date",
+         {"date", "total_batches", "total_products", "qualified_products", "defect_products", "quality_rate",
+          "efficiency", "uptime", "downtime", "alarm_count", "top_defect_type", "average_glue_volume",
+          "average_pressure", "average_temperature"},
+         {"日期", "总批次数", "总产品数", "合格产品数", "不良产品数", "合格率",
+          "生产效率", "运行时间", "停机时间", "报警次数", "主要缺陷类型", "平均胶量",
+          "平均压力", "平均温度"}}
+    };
+    return tables;
+}
+
+// dataType 为"全部数据"时导出所有表；时间范围无效时导出整张表
+QList<ExportSection> exportSections(const QString& dataType, const QDateTime& startTime = QDateTime(),
+                                    const QDateTime& endTime = QDateTime())
+{
+    const bool ranged = startTime.isValid() && endTime.isValid();
+    QList<ExportSection> sections;
+    for (const ExportTable& table : exportTables()) {
+        if (dataType != "全部数据" && dataType != QString::fromUtf8(table.dataType)) {
+            continue;
+        }
+
+        ExportSection section;
+        section.title = QString::fromUtf8(table.dataType);
+        section.headers = table.headers;
+        QString where;
+        if (ranged) {
+            where = QString(" WHERE %1 BETWEEN ? AND ?").arg(table.timeColumn);
+            // 统计表按日期存储
+            if (QLatin1String(table.timeColumn) == QLatin1String("date")) {
+                section.values = {startTime.date(), endTime.date()};
+            } else {
+                section.values = {startTime, endTime};
+            }
+        }
+        section.sql = QString("SELECT %1 FROM %2%3 ORDER BY %4")
+            .arg(table.columns.join(", "), table.table, where, table.order);
+        section.countSql = QString("SELECT COUNT(*) FROM %1%2").arg(table.table, where);
+        sections.append(section);
+    }
+    return sections;
+}
+}
 
 DataRecordWidget::DataRecordWidget(QWidget *parent)
     : QWidget(parent)
@@ -78,9 +292,12 @@ DataRecordWidget::DataRecordWidget(QWidget *parent)
     , m_qualityModel(nullptr)
     , m_alarmModel(nullptr)
     , m_statisticsModel(nullptr)
-    , m_productionProxy(nullptr)
-    , m_qualityProxy(nullptr)
     , m_alarmProxy(nullptr)
+    , m_databaseService(nullptr)
+    , m_exporter(nullptr)
+    , m_exportStarting(false)
+    , m_exportCancelled(false)
+    , m_backup(nullptr)
     , m_updateTimer(nullptr)
     , m_backupTimer(nullptr)
     , m_maxRecords(10000)
@@ -110,6 +327,8 @@ DataRecordWidget::DataRecordWidget(QWidget *parent)
     // 加载初始数据
     loadProductionData();
     loadQualityData();
+    updateProductionTable();
+    updateQualityTable();
     loadAlarmData();
     loadStatisticsData();
     
@@ -131,8 +350,196 @@ DataRecordWidget::~DataRecordWidget()
         m_backupTimer->stop();
     }
     
-    if (m_database.isOpen()) {
-        m_database.close();
+    // 取消进行中的导出、等待备份，然后提交排队的写入并等待数据库线程结束，之后不会再有回调
+    delete m_exporter;
+    m_exporter = nullptr;
+    delete m_backup;
+    m_backup = nullptr;
+    delete m_databaseService;
+    m_databaseService = nullptr;
+}
+
+void DataRecordWidget::addQualityData(const QualityData& data)
+{
+    if (!insertQualityData(data)) {
+        return;
+    }
+    
+    m_qualityDataList.append(data);
+    if (m_qualityDataList.size() > m_maxRecords) {
+        m_qualityDataList.removeFirst();
+    }
+    emit qualityDataAdded(data);
+}
+
+void DataRecordWidget::addAlarmRecord(const DataRecordAlarm& alarm)
+{
+    if (!insertAlarmRecord(alarm)) {
+        return;
+    }
+    
+    m_alarmRecords.append(alarm);
+    if (m_alarmRecords.size() > m_maxRecords) {
+        m_alarmRecords.removeFirst();
+    }
+    emit alarmAdded(alarm);
+}
+
+// 查询接口是同步的，会等待数据库线程；各查询都走时间或批次的组合索引
+QList<ProductionBatch> DataRecordWidget::getProductionBatches(const QDateTime& startTime, const QDateTime& endTime)
+{
+    const DatabaseResult result = m_databaseService->execute(
+        "SELECT * FROM production_batches WHERE start_time BETWEEN ? AND ? ORDER BY start_time DESC, batch_id DESC",
+        {startTime, endTime}).result();
+    if (!result.success) {
+        emit databaseError("查询生产批次失败: " + result.error);
+    }
+
+    QList<ProductionBatch> batches;
+    batches.reserve(result.rows.size());
+    for (const QSqlRecord& record : result.rows) {
+        batches.append(batchFromRecord(record));
+    }
+    return batches;
+}
+
+QList<QualityData> DataRecordWidget::getQualityData(int batchId)
+{
+    const DatabaseResult result = m_databaseService->execute(
+        "SELECT * FROM quality_data WHERE batch_id = ? ORDER BY timestamp", {batchId}).result();
+    if (!result.success) {
+        emit databaseError("查询质量数据失败: " + result.error);
+    }
+
+    QList<QualityData> records;
+    records.reserve(result.rows.size());
+    for (const QSqlRecord& record : result.rows) {
+        records.append(qualityFromRecord(record));
+    }
+    return records;
+}
+
+QList<DataRecordAlarm> DataRecordWidget::getAlarmRecords(const QDateTime& startTime, const QDateTime& endTime)
+{
+    const DatabaseResult result = m_databaseService->execute(
+        "SELECT * FROM alarm_records WHERE timestamp BETWEEN ? AND ? ORDER BY timestamp DESC, alarm_id DESC",
+        {startTime, endTime}).result();
+    if (!result.success) {
+        emit databaseError("查询报警记录失败: " + result.error);
+    }
+
+    QList<DataRecordAlarm> alarms;
+    alarms.reserve(result.rows.size());
+    for (const QSqlRecord& record : result.rows) {
+        alarms.append(alarmFromRecord(record));
+    }
+    return alarms;
+}
+
+bool DataRecordWidget::exportToCSV(const QString& filename, const QString& dataType)
+{
+    ExportJob job;
+    job.filename = filename;
+    job.format = ExportJob::Csv;
+    job.sections = exportSections(dataType);
+    return startExport(job);
+}
+
+bool DataRecordWidget::exportToExcel(const QString& filename, const QString& dataType)
+{
+    ExportJob job;
+    job.filename = filename;
+    job.format = ExportJob::Xlsx;
+    job.sections = exportSections(dataType);
+    return startExport(job);
+}
+
+bool DataRecordWidget::exportReport(const QString& filename, const QDateTime& startTime, const QDateTime& endTime)
+{
+    ExportJob job;
+    job.filename = filename;
+    job.format = DataExporter::formatForFile(filename);
+    job.sections = exportSections("全部数据", startTime, endTime);
+    return startExport(job);
+}
+
+bool DataRecordWidget::isExporting() const
+{
+    return m_exportStarting || (m_exporter && m_exporter->isRunning());
+}
+
+void DataRecordWidget::cancelExport()
+{
+    // 还在等待数据库服务时由回调放弃启动
+    if (m_exportStarting) {
+        m_exportCancelled = true;
+    } else if (m_exporter) {
+        m_exporter->cancel();
+    }
+}
+
+bool DataRecordWidget::startExport(const ExportJob& job)
+{
+    if (job.sections.isEmpty() || job.filename.isEmpty()) {
+        emit databaseError("无效的导出请求: " + job.filename);
+        return false;
+    }
+    if (isExporting()) {
+        return false;
+    }
+
+    // 导出使用独立连接，先让数据库服务提交排队的写入，导出才能读到最新数据
+    m_exportStarting = true;
+    m_exportCancelled = false;
+    if (m_exportProgress) {
+        m_exportProgress->setRange(0, 0);
+        m_exportProgress->setFormat("准备导出...");
+        m_exportProgress->setVisible(true);
+    }
+    if (m_exportDataBtn) {
+        m_exportDataBtn->setText("取消导出");
+    }
+    m_databaseService->execute("SELECT 1", {}, this, [this, job](const DatabaseResult&) {
+        m_exportStarting = false;
+        if (m_exportCancelled) {
+            if (m_exportProgress) {
+                m_exportProgress->setVisible(false);
+            }
+            if (m_exportDataBtn) {
+                m_exportDataBtn->setText("导出数据");
+            }
+            emit exportFinished(false, job.filename, "导出已取消");
+            return;
+        }
+        m_exporter->start(job);
+    });
+    return true;
+}
+
+void DataRecordWidget::onExportData()
+{
+    // 导出进行中时按钮用于取消
+    if (isExporting()) {
+        cancelExport();
+        return;
+    }
+
+    QString directory = m_exportPath ? m_exportPath->text().trimmed() : QString();
+    if (directory.isEmpty()) {
+        directory = m_exportDirectory;
+    }
+    QDir().mkpath(directory);
+
+    const QString dataType = m_exportDataType ? m_exportDataType->currentText() : QString("全部数据");
+    const QString format = m_exportFormat ? m_exportFormat->currentText() : QString("CSV");
+    const QString baseName = directory + "/" + dataType + "_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+
+    if (format == "CSV") {
+        exportToCSV(baseName + ".csv", dataType);
+    } else if (format == "Excel") {
+        exportToExcel(baseName + ".xlsx", dataType);
+    } else {
+        QMessageBox::information(this, "数据导出", "大数据量导出目前支持 CSV 和 Excel 格式");
     }
 }
 
@@ -175,16 +582,16 @@ void DataRecordWidget::setupUI()
         QTabBar::tab:hover {
             background-color: #e0e0e0;
         }
-        QTableWidget {
+        QTableView {
             gridline-color: #d0d0d0;
             background-color: white;
             alternate-background-color: #f8f8f8;
         }
-        QTableWidget::item {
+        QTableView::item {
             padding: 4px;
             border: none;
         }
-        QTableWidget::item:selected {
+        QTableView::item:selected {
             background-color: #3daee9;
             color: white;
         }
@@ -327,28 +734,39 @@ void DataRecordWidget::setupProductionTab()
     
     layout->addWidget(statsPanel);
     
-    // 创建数据表格
-    m_productionTable = new QTableWidget(0, 13, m_productionTab);
-    QStringList headers = {"批次ID", "批次名称", "产品类型", "开始时间", "结束时间", 
-                          "总数量", "合格数量", "不良数量", "合格率", "操作员", 
-                          "程序名称", "状态", "备注"};
-    m_productionTable->setHorizontalHeaderLabels(headers);
+    // 创建数据表格：按页从数据库读取，过滤和排序都在 SQL 中完成
+    const QList<SqlPageColumn> columns = {
+        {"批次ID", "batch_id", "batch_id"},
+        {"批次名称", "batch_name", "batch_name"},
+        {"产品类型", "product_type", "product_type"},
+        {"开始时间", "start_time", "start_time"},
+        {"结束时间", "end_time", "IFNULL(end_time, '')"},
+        {"总数量", "total_count", "IFNULL(total_count, 0)"},
+        {"合格数量", "qualified_count", "IFNULL(qualified_count, 0)"},
+        {"不良数量", "defect_count", "IFNULL(defect_count, 0)"},
+        {"合格率", "quality_rate", "IFNULL(quality_rate, 0)"},
+        {"操作员", "operator_name", "IFNULL(operator_name, '')"},
+        {"程序名称", "program_name", "IFNULL(program_name, '')"},
+        {"状态", "end_time IS NOT NULL", "end_time IS NOT NULL"},
+        {"备注", "notes", "IFNULL(notes, '')"}
+    };
+    m_productionModel = new SqlPageModel("production_batches", "batch_id", columns, this);
+    m_productionModel->setFormatter(productionData);
+    connect(m_productionModel, &SqlPageModel::loadFailed, this, [this](const QString& error) {
+        emit databaseError("加载生产批次失败: " + error);
+    });
+    
+    m_productionTable = new QTableView(m_productionTab);
+    m_productionTable->setModel(m_productionModel);
     m_productionTable->setAlternatingRowColors(true);
     m_productionTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_productionTable->setSelectionMode(QAbstractItemView::SingleSelection);
     m_productionTable->setSortingEnabled(true);
+    m_productionTable->sortByColumn(3, Qt::DescendingOrder);
     m_productionTable->horizontalHeader()->setStretchLastSection(true);
     m_productionTable->verticalHeader()->setVisible(false);
     
     layout->addWidget(m_productionTable);
-    
-    // 创建数据模型
-    m_productionModel = new QStandardItemModel(this);
-    m_productionModel->setHorizontalHeaderLabels(headers);
-    
-    m_productionProxy = new QSortFilterProxyModel(this);
-    m_productionProxy->setSourceModel(m_productionModel);
-    m_productionProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
 }
 
 void DataRecordWidget::setupQualityTab()
@@ -395,15 +813,35 @@ void DataRecordWidget::setupQualityTab()
     auto splitter = new QSplitter(Qt::Horizontal, m_qualityTab);
     
     // 创建数据表格
-    m_qualityTable = new QTableWidget(0, 14, splitter);
-    QStringList headers = {"记录ID", "批次ID", "时间戳", "X坐标", "Y坐标", "Z坐标", 
-                          "胶量", "压力", "温度", "速度", "质量等级", "合格", 
-                          "缺陷类型", "检测员"};
-    m_qualityTable->setHorizontalHeaderLabels(headers);
+    const QList<SqlPageColumn> columns = {
+        {"记录ID", "record_id", "record_id"},
+        {"批次ID", "batch_id", "batch_id"},
+        {"时间戳", "timestamp", "timestamp"},
+        {"X坐标", "position_x", "position_x"},
+        {"Y坐标", "position_y", "position_y"},
+        {"Z坐标", "position_z", "position_z"},
+        {"胶量", "glue_volume", "glue_volume"},
+        {"压力", "pressure", "pressure"},
+        {"温度", "temperature", "temperature"},
+        {"速度", "speed", "speed"},
+        {"质量等级", "quality_level", "quality_level"},
+        {"合格", "is_qualified", "is_qualified"},
+        {"缺陷类型", "defect_type", "IFNULL(defect_type, '')"},
+        {"检测员", "inspector", "IFNULL(inspector, '')"}
+    };
+    m_qualityModel = new SqlPageModel("quality_data", "record_id", columns, this);
+    m_qualityModel->setFormatter(qualityData);
+    connect(m_qualityModel, &SqlPageModel::loadFailed, this, [this](const QString& error) {
+        emit databaseError("加载质量数据失败: " + error);
+    });
+    
+    m_qualityTable = new QTableView(splitter);
+    m_qualityTable->setModel(m_qualityModel);
     m_qualityTable->setAlternatingRowColors(true);
     m_qualityTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_qualityTable->setSelectionMode(QAbstractItemView::SingleSelection);
     m_qualityTable->setSortingEnabled(true);
+    m_qualityTable->sortByColumn(2, Qt::DescendingOrder);
     m_qualityTable->verticalHeader()->setVisible(false);
     
     // 创建图表视图
@@ -416,14 +854,6 @@ void DataRecordWidget::setupQualityTab()
     splitter->setStretchFactor(1, 1);
     
     layout->addWidget(splitter);
-    
-    // 创建数据模型
-    m_qualityModel = new QStandardItemModel(this);
-    m_qualityModel->setHorizontalHeaderLabels(headers);
-    
-    m_qualityProxy = new QSortFilterProxyModel(this);
-    m_qualityProxy->setSourceModel(m_qualityModel);
-    m_qualityProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
 }
 
 void DataRecordWidget::setupAlarmTab()
@@ -677,147 +1107,347 @@ void DataRecordWidget::setupDatabase()
     QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(dataDir);
     m_databasePath = dataDir + "/production_data.db";
+    m_backupDirectory = dataDir + "/" + AppInfo::BACKUP_DIR_NAME;
+    openDatabase();
+    
+    m_exporter = new DataExporter(m_databasePath, this);
+    connect(m_exporter, &DataExporter::progress, this, [this](qint64 rows, qint64 totalRows) {
+        if (m_exportProgress) {
+            // 总数未知时显示忙碌状态
+            m_exportProgress->setRange(0, totalRows > 0 ? 1000 : 0);
+            m_exportProgress->setValue(totalRows > 0 ? static_cast<int>(rows * 1000 / totalRows) : 0);
+            m_exportProgress->setFormat(QString("已导出 %1 行").arg(rows));
+        }
+        emit exportProgress(rows, totalRows);
+    });
+    connect(m_exporter, &DataExporter::finished, this,
+            [this](bool success, const QString& filename, qint64 rows, const QString& error) {
+        if (m_exportProgress) {
+            m_exportProgress->setVisible(false);
+        }
+        if (m_exportDataBtn) {
+            m_exportDataBtn->setText("导出数据");
+        }
+        if (success) {
+            LOG_INFO("DataRecordWidget", QString("数据已导出: %1 (%2 行)").arg(filename).arg(rows));
+            emit dataExported(filename);
+        }
+        emit exportFinished(success, filename, error);
+    });
     
-    // 创建数据库连接
-    m_database = QSqlDatabase::addDatabase("QSQLITE", "ProductionDB");
-    m_database.setDatabaseName(m_databasePath);
+    m_backup = new DatabaseBackup(this);
+    connect(m_backup, &DatabaseBackup::progress, this, [this](qint64 bytes, qint64 totalBytes) {
+        // 进度条与导出共用，导出进行中时不显示备份进度
+        if (m_exportProgress && !isExporting()) {
+            m_exportProgress->setRange(0, totalBytes > 0 ? 1000 : 0);
+            m_exportProgress->setValue(totalBytes > 0 ? static_cast<int>(qMin(bytes, totalBytes) * 1000 / totalBytes) : 0);
+            m_exportProgress->setFormat(m_restoreStaging.isEmpty() ? QString("正在备份 %p%") : QString("正在校验和复制备份 %p%"));
+            m_exportProgress->setVisible(true);
+        }
+    });
+    connect(m_backup, &DatabaseBackup::finished, this, [this](bool success, const QString& filename, const QString& error) {
+        if (m_exportProgress && !isExporting()) {
+            m_exportProgress->setVisible(false);
+        }
+        
+        if (!m_restoreStaging.isEmpty()) {
+            m_restoreStaging.clear();
+            if (success) {
+                finishRestore(filename);
+            } else {
+                QFile::remove(filename);
+                emit databaseError("数据恢复失败: " + error);
+            }
+            return;
+        }
+        
+        if (!success) {
+            emit databaseError("数据备份失败: " + error);
+            return;
+        }
+        DatabaseBackup::removeOldBackups(m_backupDirectory, BACKUP_BASE_NAME, System::DB_BACKUP_KEEP);
+        LOG_INFO("DataRecordWidget", "数据已备份: " + filename);
+        emit backupCompleted(filename);
+        // 过期分区总是在有了一份包含它们的备份之后才删除
+        clearExpiredData();
+    });
+}
+
+void DataRecordWidget::openDatabase()
+{
+    // 连接、建表和写入参数都在数据库线程完成，失败通过 databaseError 报告
+    m_databaseService = new DatabaseService("ProductionDB", m_databasePath, this);
+    connect(m_databaseService, &DatabaseService::databaseError, this, &DataRecordWidget::databaseError);
+    m_databaseService->open([](QSqlDatabase& database) { return createTables(database); });
+    m_readyPartitions.clear();
+    // 恢复后换了服务，已加载的表格按原条件重新读取
+    m_productionModel->setDatabaseService(m_databaseService);
+    m_qualityModel->setDatabaseService(m_databaseService);
+}
+
+QString DataRecordWidget::writablePartition(const TablePartitionSpec& spec, const QDateTime& time)
+{
+    const QString partition = TablePartitions::partitionFor(spec, time.isValid() ? time : QDateTime::currentDateTime());
+    if (m_readyPartitions.contains(partition)) {
+        return partition;
+    }
     
-    if (!m_database.open()) {
-        emit databaseError("无法打开数据库: " + m_database.lastError().text());
+    // 建分区排在随后的写入之前，在数据库线程按提交顺序执行
+    m_readyPartitions.insert(partition);
+    m_databaseService->run<QString>([spec, partition](QSqlDatabase& database) {
+        QString error;
+        return TablePartitions::ensure(database, spec, partition, &error) ? QString() : error;
+    }, this, [this, partition](const QString& error) {
+        if (!error.isEmpty()) {
+            // 下一次写入时重试
+            m_readyPartitions.remove(partition);
+            LOG_ERROR("DataRecordWidget", QString("创建分区 %1 失败: %2").arg(partition, error));
+            emit databaseError(error);
+        }
+    });
+    return partition;
+}
+
+void DataRecordWidget::clearExpiredData()
+{
+    const QDateTime cutoff = QDateTime::currentDateTime().addDays(-System::DB_RECORD_RETENTION_DAYS);
+    m_databaseService->run<RetentionResult>([cutoff](QSqlDatabase& database) {
+        RetentionResult result;
+        for (const TablePartitionSpec& spec : {DatabaseSchema::qualityDataPartitions(),
+                                               DatabaseSchema::productionAlarmPartitions()}) {
+            qint64 rows = 0;
+            result.dropped += TablePartitions::dropBefore(database, spec, cutoff, &rows, &result.error);
+            result.rows += rows;
+        }
+        return result;
+    }, this, [this](const RetentionResult& result) {
+        for (const QString& partition : result.dropped) {
+            m_readyPartitions.remove(partition);
+        }
+        if (!result.error.isEmpty()) {
+            LOG_ERROR("DataRecordWidget", "删除过期分区失败: " + result.error);
+            emit databaseError(result.error);
+        }
+        if (result.dropped.isEmpty()) {
+            return;
+        }
+        
+        LOG_INFO("DataRecordWidget", QString("已删除过期分区 %1 (%2 条记录)")
+                 .arg(result.dropped.join(", ")).arg(result.rows));
+        loadQualityData();
+        m_qualityModel->reload();
+        loadAlarmData();
+        emit dataCleared(static_cast<int>(qMin<qint64>(result.rows, std::numeric_limits<int>::max())));
+    });
+}
+
+void DataRecordWidget::finishRestore(const QString& stagingFile)
+{
+    // 关闭数据库（提交排队的写入并结束数据库线程）之后才能替换文件
+    delete m_databaseService;
+    m_databaseService = nullptr;
+    
+    QString error;
+    const bool replaced = DatabaseBackup::replaceDatabase(stagingFile, m_databasePath, &error);
+    openDatabase();
+    if (!replaced) {
+        QFile::remove(stagingFile);
+        LOG_ERROR("DataRecordWidget", "数据恢复失败: " + error);
+        emit databaseError("数据恢复失败: " + error);
         return;
     }
     
-    // 创建表格
-    if (!createTables()) {
-        emit databaseError("无法创建数据表");
+    LOG_INFO("DataRecordWidget", "数据已从备份恢复");
+    loadProductionData();
+    loadQualityData();
+    loadAlarmData();
+    loadStatisticsData();
+    QMessageBox::information(this, "数据恢复", "数据已从备份恢复");
+}
+
+void DataRecordWidget::onBackupData()
+{
+    if (m_backup->isRunning()) {
+        LOG_INFO("DataRecordWidget", "上一次备份或恢复尚未完成，跳过本次备份");
         return;
     }
     
-    // 优化数据库性能
-    QSqlQuery query(m_database);
-    query.exec("PRAGMA synchronous = NORMAL");
-    query.exec("PRAGMA cache_size = 10000");
-    query.exec("PRAGMA temp_store = MEMORY");
-    query.exec("PRAGMA journal_mode = WAL");
-}
-
-bool DataRecordWidget::createTables()
-{
-    QSqlQuery query(m_database);
-    
-    // 创建生产批次表
-    QString createProductionTable = R"(
-        CREATE TABLE IF NOT EXISTS production_batches (
-            batch_id INTEGER PRIMARY KEY AUTOINCREMENT,
-            batch_name TEXT NOT NULL,
-            product_type TEXT NOT NULL,
-            start_time DATETIME NOT NULL,
-            end_time DATETIME,
-            total_count INTEGER DEFAULT 0,
-            qualified_count INTEGER DEFAULT 0,
-            defect_count INTEGER DEFAULT 0,
-            quality_rate REAL DEFAULT 0.0,
-            operator_name TEXT,
-            program_name TEXT,
-            notes TEXT,
-            parameters TEXT,
-            quality_data TEXT,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createProductionTable)) {
-        return false;
+    // 备份使用独立连接，先让数据库服务提交排队的写入，快照才包含到此刻为止的数据
+    const QString backupFile = DatabaseBackup::backupFileName(m_backupDirectory, BACKUP_BASE_NAME,
+                                                              QDateTime::currentDateTime());
+    m_databaseService->execute("SELECT 1", {}, this, [this, backupFile](const DatabaseResult&) {
+        if (!m_backup->backup(m_databasePath, backupFile)) {
+            LOG_INFO("DataRecordWidget", "上一次备份或恢复尚未完成，跳过本次备份");
+        }
+    });
+}
+
+void DataRecordWidget::onRestoreData()
+{
+    if (m_backup->isRunning() || isExporting()) {
+        QMessageBox::information(this, "数据恢复", "备份、恢复或导出正在进行，请稍后再试");
+        return;
     }
     
-    // 创建质量数据表
-    QString createQualityTable = R"(
-        CREATE TABLE IF NOT EXISTS quality_data (
-            record_id INTEGER PRIMARY KEY AUTOINCREMENT,
-            batch_id INTEGER NOT NULL,
-            timestamp DATETIME NOT NULL,
-            position_x REAL NOT NULL,
-            position_y REAL NOT NULL,
-            position_z REAL NOT NULL,
-            glue_volume REAL NOT NULL,
-            pressure REAL NOT NULL,
-            temperature REAL NOT NULL,
-            speed REAL NOT NULL,
-            quality_level TEXT NOT NULL,
-            is_qualified BOOLEAN NOT NULL,
-            defect_type TEXT,
-            inspector TEXT,
-            notes TEXT,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            FOREIGN KEY (batch_id) REFERENCES production_batches(batch_id)
-        )
-    )";
-    
-    if (!query.exec(createQualityTable)) {
-        return false;
+    const QString backupFile = QFileDialog::getOpenFileName(this, "选择备份文件", m_backupDirectory, "数据库备份 (*.db)");
+    if (backupFile.isEmpty()) {
+        return;
     }
-    
-    // 创建报警记录表
-    QString createAlarmTable = R"(
-        CREATE TABLE IF NOT EXISTS alarm_records (
-            alarm_id INTEGER PRIMARY KEY AUTOINCREMENT,
-            timestamp DATETIME NOT NULL,
-            alarm_type TEXT NOT NULL,
-            alarm_level TEXT NOT NULL,
-            alarm_code TEXT NOT NULL,
-            alarm_message TEXT NOT NULL,
-            device_name TEXT NOT NULL,
-            operator_name TEXT,
-            is_acknowledged BOOLEAN DEFAULT FALSE,
-            acknowledge_time DATETIME,
-            acknowledge_user TEXT,
-            solution TEXT,
-            notes TEXT,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createAlarmTable)) {
-        return false;
+    if (QMessageBox::question(this, "数据恢复", "恢复会用备份替换当前的全部生产数据，是否继续？")
+        != QMessageBox::Yes) {
+        return;
     }
     
-    // 创建统计数据表
-    QString createStatisticsTable = R"(
-        CREATE TABLE IF NOT EXISTS statistics_data (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            date DATE NOT NULL UNIQUE,
-            total_batches INTEGER DEFAULT 0,
-            total_products INTEGER DEFAULT 0,
-            qualified_products INTEGER DEFAULT 0,
-            defect_products INTEGER DEFAULT 0,
-            quality_rate REAL DEFAULT 0.0,
-            efficiency REAL DEFAULT 0.0,
-            uptime REAL DEFAULT 0.0,
-            downtime REAL DEFAULT 0.0,
-            alarm_count INTEGER DEFAULT 0,
-            top_defect_type TEXT,
-            average_glue_volume REAL DEFAULT 0.0,
-            average_pressure REAL DEFAULT 0.0,
-            average_temperature REAL DEFAULT 0.0,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
-            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createStatisticsTable)) {
+    // 校验和复制在后台进行，完成后再关闭数据库并换上复制好的文件
+    m_restoreStaging = m_databasePath + ".restore";
+    if (!m_backup->prepareRestore(backupFile, m_restoreStaging)) {
+        m_restoreStaging.clear();
+    }
+}
+
+void DataRecordWidget::onClearOldData()
+{
+    const QString message = QString("删除 %1 天之前的质量数据和报警记录？\n"
+                                    "数据按月分区保存，只删除整个月都已过期的分区。")
+                                .arg(System::DB_RECORD_RETENTION_DAYS);
+    if (QMessageBox::question(this, "清除历史", message) != QMessageBox::Yes) {
+        return;
+    }
+    clearExpiredData();
+}
+
+bool DataRecordWidget::createTables(QSqlDatabase& database)
+{
+    // 表结构和索引按版本迁移，已有数据库只执行缺少的版本
+    QString error;
+    if (!DatabaseSchema::migrate(database, DatabaseSchema::productionMigrations(), &error)) {
+        LOG_ERROR("DataRecordWidget", "生产数据库结构迁移失败: " + error);
         return false;
     }
-    
-    // 创建索引
-    query.exec("CREATE INDEX IF NOT EXISTS idx_production_start_time ON production_batches(start_time)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_production_product_type ON production_batches(product_type)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_quality_batch_id ON quality_data(batch_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_quality_timestamp ON quality_data(timestamp)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_timestamp ON alarm_records(timestamp)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_type ON alarm_records(alarm_type)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_statistics_date ON statistics_data(date)");
-    
+    return true;
+}
+
+void DataRecordWidget::loadProductionData()
+{
+    m_databaseService->query("SELECT * FROM production_batches ORDER BY start_time DESC LIMIT ?", {m_maxRecords},
+                             this, [this](const DatabaseResult& result) {
+        if (!result.success) {
+            emit databaseError("加载生产批次失败: " + result.error);
+            return;
+        }
+        
+        m_productionBatches.clear();
+        for (auto it = result.rows.crbegin(); it != result.rows.crend(); ++it) {
+            m_productionBatches.append(batchFromRecord(*it));
+        }
+    });
+}
+
+void DataRecordWidget::loadQualityData()
+{
+    m_databaseService->query("SELECT * FROM quality_data ORDER BY timestamp DESC LIMIT ?", {m_maxRecords},
+                             this, [this](const DatabaseResult& result) {
+        if (!result.success) {
+            emit databaseError("加载质量数据失败: " + result.error);
+            return;
+        }
+        
+        m_qualityDataList.clear();
+        for (auto it = result.rows.crbegin(); it != result.rows.crend(); ++it) {
+            m_qualityDataList.append(qualityFromRecord(*it));
+        }
+    });
+}
+
+void DataRecordWidget::updateProductionTable()
+{
+    // 开始时间和产品类型都有索引 (product_type, start_time)
+    QString where = "start_time BETWEEN ? AND ?";
+    QVariantList values = {m_startDateEdit->dateTime(), m_endDateEdit->dateTime()};
+    if (m_productTypeFilter->currentIndex() > 0) {
+        where += " AND product_type = ?";
+        values.append(m_productTypeFilter->currentText());
+    }
+    m_productionModel->setFilter(where, values);
+}
+
+void DataRecordWidget::updateQualityTable()
+{
+    QStringList conditions;
+    QVariantList values;
+    if (m_batchFilter->currentIndex() > 0) {
+        // 批次项的数据为批次 ID，没有时按显示文本解析
+        const QVariant batch = m_batchFilter->currentData();
+        conditions.append("batch_id = ?");
+        values.append(batch.isValid() ? batch.toInt() : m_batchFilter->currentText().toInt());
+    }
+    if (m_qualityFilter->currentIndex() > 0) {
+        if (m_qualityFilter->currentText() == "不合格") {
+            conditions.append("is_qualified = 0");
+        } else {
+            conditions.append("quality_level = ?");
+            values.append(m_qualityFilter->currentText());
+        }
+    }
+    m_qualityModel->setFilter(conditions.join(" AND "), values);
+}
+
+void DataRecordWidget::loadAlarmData()
+{
+    m_databaseService->query("SELECT * FROM alarm_records ORDER BY timestamp DESC LIMIT ?", {m_maxRecords},
+                             this, [this](const DatabaseResult& result) {
+        if (!result.success) {
+            emit databaseError("加载报警记录失败: " + result.error);
+            return;
+        }
+        
+        m_alarmRecords.clear();
+        for (auto it = result.rows.crbegin(); it != result.rows.crend(); ++it) {
+            m_alarmRecords.append(alarmFromRecord(*it));
+        }
+    });
+}
+
+bool DataRecordWidget::insertQualityData(const QualityData& data)
+{
+    // 写后即返回，由数据库线程按批在事务中提交
+    const QString partition = writablePartition(DatabaseSchema::qualityDataPartitions(), data.timestamp);
+    m_databaseService->write(INSERT_QUALITY_SQL.arg(partition), {
+        data.batchId,
+        data.timestamp,
+        data.positionX,
+        data.positionY,
+        data.positionZ,
+        data.glueVolume,
+        data.pressure,
+        data.temperature,
+        data.speed,
+        data.qualityLevel,
+        data.isQualified,
+        data.defectType,
+        data.inspector,
+        data.notes
+    });
+    return true;
+}
+
+bool DataRecordWidget::insertAlarmRecord(const DataRecordAlarm& alarm)
+{
+    const QString partition = writablePartition(DatabaseSchema::productionAlarmPartitions(), alarm.timestamp);
+    m_databaseService->write(INSERT_ALARM_SQL.arg(partition), {
+        alarm.timestamp,
+        alarm.alarmType,
+        alarm.alarmLevel,
+        alarm.alarmCode,
+        alarm.alarmMessage,
+        alarm.deviceName,
+        alarm.operatorName,
+        alarm.isAcknowledged,
+        alarm.acknowledgeTime,
+        alarm.acknowledgeUser,
+        alarm.solution,
+        alarm.notes
+    });
     return true;
 }
 
@@ -827,19 +1457,21 @@ void DataRecordWidget::setupConnections()
     connect(m_refreshBtn, &QPushButton::clicked, this, &DataRecordWidget::onRefreshData);
     connect(m_exportBtn, &QPushButton::clicked, this, &DataRecordWidget::onExportData);
     connect(m_productTypeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-            this, &DataRecordWidget::onFilterChanged);
+            this, &DataRecordWidget::updateProductionTable);
     connect(m_startDateEdit, &QDateTimeEdit::dateTimeChanged, this, &DataRecordWidget::onDateRangeChanged);
     connect(m_endDateEdit, &QDateTimeEdit::dateTimeChanged, this, &DataRecordWidget::onDateRangeChanged);
-    connect(m_productionTable, &QTableWidget::itemSelectionChanged, 
+    connect(m_startDateEdit, &QDateTimeEdit::dateTimeChanged, this, &DataRecordWidget::updateProductionTable);
+    connect(m_endDateEdit, &QDateTimeEdit::dateTimeChanged, this, &DataRecordWidget::updateProductionTable);
+    connect(m_productionTable->selectionModel(), &QItemSelectionModel::selectionChanged, 
             this, &DataRecordWidget::onBatchSelectionChanged);
     
     // 质量数据页面连接
     connect(m_batchFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-            this, &DataRecordWidget::onFilterChanged);
+            this, &DataRecordWidget::updateQualityTable);
     connect(m_qualityFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-            this, &DataRecordWidget::onFilterChanged);
+            this, &DataRecordWidget::updateQualityTable);
     connect(m_qualityChartBtn, &QPushButton::clicked, this, &DataRecordWidget::onShowChart);
-    connect(m_qualityTable, &QTableWidget::itemSelectionChanged, 
+    connect(m_qualityTable->selectionModel(), &QItemSelectionModel::selectionChanged, 
             this, &DataRecordWidget::onQualityDataSelectionChanged);
     
     // 报警记录页面连接
@@ -8,6 +8,7 @@
 #include <QGridLayout>
 #include <QTableWidget>
 #include <QTableWidgetItem>
+#include <QTableView>
 #include <QLabel>
 #include <QPushButton>
 #include <QComboBox>
@@ -28,6 +29,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSet>
 #include <QDateTime>
 #include <QDir>
 #include <QStandardPaths>
@@ -54,6 +56,13 @@
 
 // Use QtCharts namespace
 
+class DatabaseService;
+class DatabaseBackup;
+class DataExporter;
+class SqlPageModel;
+struct ExportJob;
+struct TablePartitionSpec;
+
 // 生产批次数据结构
 struct ProductionBatch {
     int batchId;                    // 批次ID
@@ -146,10 +155,14 @@ public:
     QList<DataRecordAlarm> getAlarmRecords(const QDateTime& startTime, const QDateTime& endTime);
     DataRecordStatistics getStatistics(const QDateTime& date);
     
-    // 数据导出接口
+    // 数据导出接口：在后台线程流式导出，返回是否已开始，结果通过 dataExported / exportFinished 报告。
+    // dataType 为导出页的数据类型（生产数据/质量数据/报警记录/统计数据/全部数据）
     bool exportToCSV(const QString& filename, const QString& dataType);
     bool exportToExcel(const QString& filename, const QString& dataType);
+    // 按文件后缀选择 CSV 或 XLSX，包含时间范围内的批次、质量数据、报警和每日统计
     bool exportReport(const QString& filename, const QDateTime& startTime, const QDateTime& endTime);
+    bool isExporting() const;
+    void cancelExport();
 
 public slots:
     void onDataReceived(const QJsonObject& data);
@@ -178,6 +191,7 @@ private slots:
 private:
     void setupUI();
     void setupDatabase();
+    void openDatabase();
     void setupConnections();
     void setupProductionTab();
     void setupQualityTab();
@@ -190,6 +204,12 @@ private:
     void loadQualityData();
     void loadAlarmData();
     void loadStatisticsData();
+    bool startExport(const ExportJob& job);
+    // 返回写入时间所在的分区，不存在时先在数据库线程创建
+    QString writablePartition(const TablePartitionSpec& spec, const QDateTime& time);
+    void clearExpiredData();
+    void finishRestore(const QString& stagingFile);
+    // 按当前过滤条件重新加载分页表格
     void updateProductionTable();
     void updateQualityTable();
     void updateAlarmTable();
@@ -202,7 +222,7 @@ private:
     void createEfficiencyChart();
     
     bool initializeDatabase();
-    bool createTables();
+    static bool createTables(QSqlDatabase& database);     // 在数据库线程执行
     bool insertProductionBatch(const ProductionBatch& batch);
     bool insertQualityData(const QualityData& data);
     bool insertAlarmRecord(const DataRecordAlarm& alarm);
@@ -225,7 +245,7 @@ private:
     
     // 生产数据页面
     QWidget* m_productionTab;
-    QTableWidget* m_productionTable;
+    QTableView* m_productionTable;
     QComboBox* m_productTypeFilter;
     QDateTimeEdit* m_startDateEdit;
     QDateTimeEdit* m_endDateEdit;
@@ -237,7 +257,7 @@ private:
     
     // 质量数据页面
     QWidget* m_qualityTab;
-    QTableWidget* m_qualityTable;
+    QTableView* m_qualityTable;
     QComboBox* m_batchFilter;
     QComboBox* m_qualityFilter;
     QPushButton* m_qualityChartBtn;
@@ -285,17 +305,22 @@ private:
     QProgressBar* m_exportProgress;
     
     // 数据模型
-    QStandardItemModel* m_productionModel;
-    QStandardItemModel* m_qualityModel;
+    SqlPageModel* m_productionModel;            // 按页读取 production_batches
+    SqlPageModel* m_qualityModel;               // 按页读取 quality_data（合并各分区的视图）
     QStandardItemModel* m_alarmModel;
     QStandardItemModel* m_statisticsModel;
-    QSortFilterProxyModel* m_productionProxy;
-    QSortFilterProxyModel* m_qualityProxy;
     QSortFilterProxyModel* m_alarmProxy;
     
     // 数据库
-    QSqlDatabase m_database;
     QString m_databasePath;
+    DatabaseService* m_databaseService;         // 独立线程和连接，界面线程不等待存储
+    DataExporter* m_exporter;                   // 后台导出，使用自己的只读连接
+    bool m_exportStarting;                      // 等待数据库服务提交排队写入后开始导出
+    bool m_exportCancelled;                     // 等待期间被取消
+    DatabaseBackup* m_backup;                   // 后台在线备份和恢复
+    QString m_backupDirectory;
+    QString m_restoreStaging;                   // 正在准备的恢复文件，为空表示没有进行中的恢复
+    QSet<QString> m_readyPartitions;            // 已创建的分区，写入前不用再检查
     
     // 数据缓存
     QList<ProductionBatch> m_productionBatches;
@@ -327,6 +352,8 @@ signals:
     void alarmAdded(const DataRecordAlarm& alarm);
     void statisticsUpdated(const DataRecordStatistics& stats);
     void dataExported(const QString& filename);
+    void exportProgress(qint64 rows, qint64 totalRows);
+    void exportFinished(bool success, const QString& filename, const QString& error);
     void reportGenerated(const QString& filename);
     void databaseError(const QString& error);
     void backupCompleted(const QString& filename);
@@ -557,6 +557,8 @@ void DeviceControlWidget::setSerialWorker(SerialWorker* worker)
     if (serialWorker) {
         connect(serialWorker, &SerialWorker::frameReceived, 
                 this, &DeviceControlWidget::onFrameReceived);
+        connect(serialWorker, &SerialWorker::framesReceived, 
+                this, &DeviceControlWidget::onFramesReceived);
         connect(serialWorker, &SerialWorker::connected, 
                 [this]() { isConnected = true; updateControlButtons(); });
         connect(serialWorker, &SerialWorker::disconnected, 
@@ -879,13 +881,20 @@ void DeviceControlWidget::onUpdateTimer()
     updateDeviceStatus();
 }
 
+void DeviceControlWidget::onFramesReceived(const FrameBatch& frames)
+{
+    for (const ProtocolFrame& frame : frames) {
+        onFrameReceived(frame);
+    }
+}
+
 void DeviceControlWidget::onFrameReceived(const ProtocolFrame& frame)
 {
     // 处理接收到的协议帧
     switch (frame.command) {
         case ProtocolCommand::DeviceStatus:
             // 解析设备状态
-            if (frame.data.size() >= 1) {
+            if (frame.dataLength >= 1) {
                 quint8 status = frame.data[0];
                 DeviceState newState = static_cast<DeviceState>(status);
                 setDeviceState(newState);
@@ -894,9 +903,9 @@ void DeviceControlWidget::onFrameReceived(const ProtocolFrame& frame)
             
         case ProtocolCommand::ReadSensorData:
             // 解析传感器数据
-            if (frame.data.size() >= 12) {
+            if (frame.dataLength >= 12) {
                 // 假设数据格式：X(4字节) Y(4字节) Z(4字节)
-                QDataStream stream(frame.data);
+                QDataStream stream(frame.payload());
                 stream.setByteOrder(QDataStream::LittleEndian);
                 stream >> currentX >> currentY >> currentZ;
                 emit positionChanged(currentX, currentY, currentZ);
@@ -987,10 +996,8 @@ void DeviceControlWidget::emergencyStop()
         return;
     }
     
-    // 紧急停止使用特殊命令
-    QByteArray data;
-    data.append(static_cast<char>(0xFF)); // 紧急停止标志
-    sendCommand(ProtocolCommand::WriteParameter, data);
+    // 使用急停命令码，发送端据此走快速通道，不经过写合并和命令排队
+    sendCommand(ProtocolCommand::EmergencyStop);
     setDeviceState(DeviceState::EmergencyStop);
     logMessage("触发紧急停止");
     emit emergencyStopTriggered();
@@ -1053,23 +1060,30 @@ void DeviceControlWidget::setOrigin()
 
 void DeviceControlWidget::updateGlueParameters()
 {
-    if (!isConnected) return;
-    
-    // 构建点胶参数数据
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    
-    stream << static_cast<float>(glueParams.volume);
-    stream << static_cast<float>(glueParams.speed);
-    stream << static_cast<float>(glueParams.pressure);
-    stream << static_cast<float>(glueParams.temperature);
-    stream << static_cast<quint16>(glueParams.dwellTime);
-    stream << static_cast<quint16>(glueParams.riseTime);
-    stream << static_cast<quint16>(glueParams.fallTime);
-    
-    sendCommand(ProtocolCommand::WriteAllParameters, data);
-    logMessage("更新点胶参数");
+    if (!isConnected || !serialWorker) return;
+    
+    // 配方切换时整体设置期望值，参数同步只发送与设备影子副本不同的参数
+    ParameterSynchronizer* sync = serialWorker->getParameterSynchronizer();
+    sync->setParameters({
+        {"glue.volume", glueParams.volume},
+        {"glue.speed", glueParams.speed},
+        {"glue.pressure", glueParams.pressure},
+        {"glue.temperature", glueParams.temperature},
+        {"glue.dwellTime", glueParams.dwellTime},
+        {"glue.riseTime", glueParams.riseTime},
+        {"glue.fallTime", glueParams.fallTime}
+    });
+    
+    const int changed = sync->pendingChanges().size();
+    if (changed == 0) {
+        logMessage("点胶参数未变化");
+        return;
+    }
+    if (!sync->pushChanges()) {
+        logMessage("参数同步进行中，稍后重试");
+        return;
+    }
+    logMessage(QString("更新点胶参数: %1项变化").arg(changed));
 }
 
 void DeviceControlWidget::updateMotionParameters()
@@ -1376,6 +1390,7 @@ void DeviceControlWidget::connectToDevice()
     config.parity = QSerialPort::NoParity;
     config.stopBits = QSerialPort::OneStop;
     config.flowControl = QSerialPort::NoFlowControl;
+    config.lowLatency = true;
     
     // 连接设备
     serialWorker->openPort(config);
@@ -132,6 +132,7 @@ private slots:
     
     void onUpdateTimer();
     void onFrameReceived(const ProtocolFrame& frame);
+    void onFramesReceived(const FrameBatch& frames);
     
     // 新增的槽函数
     void onConnectionStatusChanged(bool connected);
@@ -1,14 +1,20 @@
 #include "parameterwidget.h"
+#include "trajectorytablemodel.h"
+#include "trajectorypreviewwidget.h"
+#include "../data/programfile.h"
 #include "logger/logmanager.h"
 #include <QMessageBox>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QApplication>
 #include <QStyle>
 #include <QSplitter>
+#include <QTableView>
 #include <cmath>
 #include <limits>
 #include <algorithm>
@@ -16,7 +22,9 @@
 ParameterWidget::ParameterWidget(QWidget* parent) 
     : QWidget(parent)
     , tabWidget(nullptr)
+    , trajectoryModel(nullptr)
     , isModified(false)
+    , autoSaveTimer(nullptr)
 {
     // 设置目录路径
     QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
@@ -32,6 +40,7 @@ ParameterWidget::ParameterWidget(QWidget* parent)
     
     // 初始化验证规则
     initializeValidationRules();
+    updateTrajectoryLimits();
     
     // 加载数据
     loadProgramList();
@@ -208,24 +217,40 @@ void ParameterWidget::setupTrajectoryPanel()
     trajectoryGroup = new QGroupBox("轨迹编辑");
     QVBoxLayout* layout = new QVBoxLayout(trajectoryGroup);
     
-    // 轨迹表格
-    trajectoryTableWidget = new QTableWidget;
-    trajectoryTableWidget->setColumnCount(8);
-    trajectoryTableWidget->setHorizontalHeaderLabels({
-        "序号", "X坐标", "Y坐标", "Z坐标", "速度", "胶量", "停留时间", "点胶"
-    });
-    trajectoryTableWidget->setAlternatingRowColors(true);
-    trajectoryTableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
+    // 轨迹表格：模型直接读写当前程序的轨迹，只为可见行取数据
+    trajectoryModel = new TrajectoryTableModel(this);
+    trajectoryModel->setTrajectory(&currentProgram.trajectory);
+    
+    trajectoryTableView = new QTableView;
+    trajectoryTableView->setModel(trajectoryModel);
+    trajectoryTableView->setAlternatingRowColors(true);
+    trajectoryTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    trajectoryTableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    trajectoryTableView->setWordWrap(false);
+    trajectoryTableView->verticalHeader()->setVisible(false);
+    trajectoryTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    trajectoryTableView->verticalHeader()->setDefaultSectionSize(trajectoryTableView->fontMetrics().height() + 6);
     
     // 设置列宽
-    trajectoryTableWidget->setColumnWidth(0, 50);
-    trajectoryTableWidget->setColumnWidth(1, 80);
-    trajectoryTableWidget->setColumnWidth(2, 80);
-    trajectoryTableWidget->setColumnWidth(3, 80);
-    trajectoryTableWidget->setColumnWidth(4, 80);
-    trajectoryTableWidget->setColumnWidth(5, 80);
-    trajectoryTableWidget->setColumnWidth(6, 80);
-    trajectoryTableWidget->setColumnWidth(7, 60);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::IndexColumn, 60);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::XColumn, 80);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::YColumn, 80);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::ZColumn, 80);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::SpeedColumn, 80);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::VolumeColumn, 80);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::DwellTimeColumn, 80);
+    trajectoryTableView->setColumnWidth(TrajectoryTableModel::GluePointColumn, 60);
+    
+    // 路径预览，与表格共用选择模型
+    trajectoryPreview = new TrajectoryPreviewWidget;
+    trajectoryPreview->setModel(trajectoryModel);
+    trajectoryPreview->setSelectionModel(trajectoryTableView->selectionModel());
+    trajectoryPreview->setToolTip("单击选择最近的轨迹点，拖动框选区域内的轨迹点");
+    
+    QSplitter* editSplitter = new QSplitter(Qt::Horizontal);
+    editSplitter->addWidget(trajectoryTableView);
+    editSplitter->addWidget(trajectoryPreview);
+    editSplitter->setSizes({600, 400});
     
     // 按钮布局
     QHBoxLayout* buttonLayout = new QHBoxLayout;
@@ -248,7 +273,7 @@ void ParameterWidget::setupTrajectoryPanel()
     buttonLayout->addWidget(optimizeTrajectoryButton);
     buttonLayout->addStretch();
     
-    layout->addWidget(trajectoryTableWidget);
+    layout->addWidget(editSplitter);
     layout->addLayout(buttonLayout);
     
     // 轨迹统计面板
@@ -343,10 +368,12 @@ void ParameterWidget::setupConnections()
     connect(clearTrajectoryButton, &QPushButton::clicked, this, &ParameterWidget::onClearTrajectory);
     connect(optimizeTrajectoryButton, &QPushButton::clicked, this, &ParameterWidget::optimizeTrajectory);
     
-    connect(trajectoryTableWidget, &QTableWidget::currentItemChanged, 
+    connect(trajectoryTableView->selectionModel(), &QItemSelectionModel::currentRowChanged, 
             this, &ParameterWidget::onTrajectorySelectionChanged);
-    connect(trajectoryTableWidget, &QTableWidget::itemChanged, 
-            this, &ParameterWidget::onTrajectoryItemChanged);
+    connect(trajectoryModel, &TrajectoryTableModel::trajectoryEdited, 
+            this, &ParameterWidget::onTrajectoryEdited);
+    connect(trajectoryPreview, &TrajectoryPreviewWidget::pointPicked, 
+            this, &ParameterWidget::onTrajectoryPointPicked);
     
     // 模板管理信号
     connect(loadTemplateButton, &QPushButton::clicked, this, &ParameterWidget::onLoadTemplate);
@@ -414,7 +441,7 @@ void ParameterWidget::initializeValidationRules()
 void ParameterWidget::onImportProgram()
 {
     QString fileName = QFileDialog::getOpenFileName(this, 
-        "导入点胶程序", programsDirectory, "JSON文件 (*.json)");
+        "导入点胶程序", programsDirectory, "点胶程序 (*.json *.gdp)");
     
     if (!fileName.isEmpty()) {
         loadProgram(fileName);
@@ -426,7 +453,7 @@ void ParameterWidget::onExportProgram()
 {
     QString fileName = QFileDialog::getSaveFileName(this, 
         "导出点胶程序", programsDirectory + "/" + currentProgram.name + ".json", 
-        "JSON文件 (*.json)");
+        "JSON文件 (*.json);;点胶程序 (*.gdp)");
     
     if (!fileName.isEmpty()) {
         saveProgram(fileName);
@@ -629,19 +656,43 @@ void ParameterWidget::onAddTrajectoryPoint()
 
 void ParameterWidget::onRemoveTrajectoryPoint()
 {
-    int currentRow = trajectoryTableWidget->currentRow();
-    if (currentRow >= 0) {
+    // 按选中的连续区间从后往前删除，框选的大片区域不会逐点删除
+    const QItemSelection selection = trajectoryTableView->selectionModel()->selection();
+    if (selection.isEmpty()) {
+        const int currentRow = trajectoryTableView->currentIndex().row();
+        if (currentRow < 0) {
+            QMessageBox::warning(this, "警告", "请先选择要删除的轨迹点！");
+            return;
+        }
         removeTrajectoryPoint(currentRow);
         LogManager::getInstance()->info("删除轨迹点", "Parameter");
-    } else {
-        QMessageBox::warning(this, "警告", "请先选择要删除的轨迹点！");
+        return;
+    }
+    
+    QList<QPair<int, int>> ranges;
+    for (const QItemSelectionRange& range : selection) {
+        ranges.append({range.top(), range.bottom()});
+    }
+    std::sort(ranges.begin(), ranges.end());
+    
+    int removed = 0;
+    int nextFirst = std::numeric_limits<int>::max();
+    for (auto it = ranges.crbegin(); it != ranges.crend(); ++it) {
+        // 整行选择的各列区间互相重叠，只删除还没删过的部分
+        const int last = std::min(it->second, nextFirst - 1);
+        if (last >= it->first) {
+            trajectoryModel->removePoints(it->first, last - it->first + 1);
+            removed += last - it->first + 1;
+        }
+        nextFirst = std::min(nextFirst, it->first);
     }
+    LogManager::getInstance()->info(QString("删除轨迹点 %1 个").arg(removed), "Parameter");
 }
 
 void ParameterWidget::onEditTrajectoryPoint()
 {
-    int currentRow = trajectoryTableWidget->currentRow();
-    if (currentRow >= 0) {
+    const QModelIndex current = trajectoryTableView->currentIndex();
+    if (current.isValid()) {
         // 这里可以打开一个详细的编辑对话框
         QMessageBox::information(this, "提示", "轨迹点编辑功能待实现");
     } else {
@@ -670,37 +721,25 @@ void ParameterWidget::onClearTrajectory()
 
 void ParameterWidget::onTrajectorySelectionChanged()
 {
-    int currentRow = trajectoryTableWidget->currentRow();
-    removePointButton->setEnabled(currentRow >= 0);
-    editPointButton->setEnabled(currentRow >= 0);
+    const bool hasCurrent = trajectoryTableView->currentIndex().isValid();
+    removePointButton->setEnabled(hasCurrent);
+    editPointButton->setEnabled(hasCurrent);
 }
 
-void ParameterWidget::onTrajectoryItemChanged(QTableWidgetItem* item)
+void ParameterWidget::onTrajectoryEdited()
 {
-    if (!item) return;
-    
-    int row = item->row();
-    int col = item->column();
-    
-    if (row < currentProgram.trajectory.size()) {
-        GlueProgram::TrajectoryPoint& point = currentProgram.trajectory[row];
-        
-        switch (col) {
-            case 1: point.x = item->text().toDouble(); break;
-            case 2: point.y = item->text().toDouble(); break;
-            case 3: point.z = item->text().toDouble(); break;
-            case 4: point.speed = item->text().toDouble(); break;
-            case 5: point.volume = item->text().toDouble(); break;
-            case 6: point.dwellTime = item->text().toInt(); break;
-            case 7: point.isGluePoint = (item->text() == "是"); break;
-            default: break;
-        }
-        
-        calculateTrajectoryTime();
-        isModified = true;
+    // 模型已经增量更新了校验结果和统计值
+    updateTrajectoryStats();
+    isModified = true;
+    if (autoSaveTimer) {
         autoSaveTimer->start();
-        emit trajectoryChanged();
     }
+    emit trajectoryChanged();
+}
+
+void ParameterWidget::onTrajectoryPointPicked(int row)
+{
+    trajectoryTableView->scrollTo(trajectoryModel->index(row, 0), QAbstractItemView::PositionAtCenter);
 }
 
 // 模板管理槽函数
@@ -755,49 +794,29 @@ void ParameterWidget::onDeleteTemplate()
 // 核心功能实现
 void ParameterWidget::loadProgram(const QString& filePath)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(this, "错误", "无法打开文件: " + filePath);
-        return;
-    }
-    
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject obj = doc.object();
-    
-    // 解析程序数据
+    QElapsedTimer timer;
+    timer.start();
+
     GlueProgram program;
-    program.name = obj["name"].toString();
-    program.version = obj["version"].toString();
-    program.description = obj["description"].toString();
-    program.createTime = QDateTime::fromString(obj["createTime"].toString(), Qt::ISODate);
-    program.modifyTime = QDateTime::fromString(obj["modifyTime"].toString(), Qt::ISODate);
-    
-    // 解析参数
-    QJsonObject params = obj["parameters"].toObject();
-    program.params.volume = params["volume"].toDouble();
-    program.params.speed = params["speed"].toDouble();
-    program.params.pressure = params["pressure"].toDouble();
-    program.params.temperature = params["temperature"].toDouble();
-    program.params.dwellTime = params["dwellTime"].toInt();
-    program.params.riseTime = params["riseTime"].toInt();
-    program.params.fallTime = params["fallTime"].toInt();
-    
-    // 解析轨迹
-    QJsonArray trajectory = obj["trajectory"].toArray();
-    program.trajectory.clear();
-    for (const QJsonValue& value : trajectory) {
-        QJsonObject pointObj = value.toObject();
-        GlueProgram::TrajectoryPoint point;
-        point.x = pointObj["x"].toDouble();
-        point.y = pointObj["y"].toDouble();
-        point.z = pointObj["z"].toDouble();
-        point.speed = pointObj["speed"].toDouble();
-        point.volume = pointObj["volume"].toDouble();
-        point.dwellTime = pointObj["dwellTime"].toInt();
-        point.isGluePoint = pointObj["isGluePoint"].toBool();
-        program.trajectory.append(point);
+    if (QFileInfo(filePath).suffix().compare(ProgramFile::SUFFIX, Qt::CaseInsensitive) == 0) {
+        QString error;
+        if (!ProgramFile::read(filePath, &program, &error)) {
+            QMessageBox::warning(this, "错误", error);
+            LogManager::getInstance()->error(error, "Parameter");
+            return;
+        }
+    } else {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            QMessageBox::warning(this, "错误", "无法打开文件: " + filePath);
+            return;
+        }
+        program = ProgramFile::fromJson(QJsonDocument::fromJson(file.readAll()).object());
     }
+
+    LogManager::getInstance()->debug(
+        QString("加载程序 %1: %2个点, %3 ms").arg(filePath).arg(program.trajectory.size()).arg(timer.elapsed()),
+        "Parameter");
     
     setCurrentProgram(program);
     currentProgramPath = filePath;
@@ -822,48 +841,21 @@ void ParameterWidget::loadProgram(const QString& filePath)
 
 void ParameterWidget::saveProgram(const QString& filePath)
 {
-    QJsonObject obj;
-    obj["name"] = currentProgram.name;
-    obj["version"] = currentProgram.version;
-    obj["description"] = currentProgram.description;
-    obj["createTime"] = currentProgram.createTime.toString(Qt::ISODate);
-    obj["modifyTime"] = currentProgram.modifyTime.toString(Qt::ISODate);
-    
-    // 保存参数
-    QJsonObject params;
-    params["volume"] = currentProgram.params.volume;
-    params["speed"] = currentProgram.params.speed;
-    params["pressure"] = currentProgram.params.pressure;
-    params["temperature"] = currentProgram.params.temperature;
-    params["dwellTime"] = currentProgram.params.dwellTime;
-    params["riseTime"] = currentProgram.params.riseTime;
-    params["fallTime"] = currentProgram.params.fallTime;
-    obj["parameters"] = params;
-    
-    // 保存轨迹
-    QJsonArray trajectory;
-    for (const GlueProgram::TrajectoryPoint& point : currentProgram.trajectory) {
-        QJsonObject pointObj;
-        pointObj["x"] = point.x;
-        pointObj["y"] = point.y;
-        pointObj["z"] = point.z;
-        pointObj["speed"] = point.speed;
-        pointObj["volume"] = point.volume;
-        pointObj["dwellTime"] = point.dwellTime;
-        pointObj["isGluePoint"] = point.isGluePoint;
-        trajectory.append(pointObj);
-    }
-    obj["trajectory"] = trajectory;
-    
-    QJsonDocument doc(obj);
-    
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::warning(this, "错误", "无法保存文件: " + filePath);
-        return;
+    if (QFileInfo(filePath).suffix().compare("json", Qt::CaseInsensitive) == 0) {
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            QMessageBox::warning(this, "错误", "无法保存文件: " + filePath);
+            return;
+        }
+        file.write(QJsonDocument(ProgramFile::toJson(currentProgram)).toJson());
+    } else {
+        QString error;
+        if (!ProgramFile::write(filePath, currentProgram, &error)) {
+            QMessageBox::warning(this, "错误", error);
+            LogManager::getInstance()->error(error, "Parameter");
+            return;
+        }
     }
-    
-    file.write(doc.toJson());
     currentProgramPath = filePath;
     isModified = false;
 }
@@ -892,9 +884,9 @@ void ParameterWidget::deleteProgram()
             }
         }
         
-        // 删除文件
-        QString filePath = programsDirectory + "/" + programName + ".json";
-        QFile::remove(filePath);
+        // 删除文件（包括尚未转换的旧版 JSON 文件）
+        QFile::remove(programFilePath(programName));
+        QFile::remove(programsDirectory + "/" + programName + ".json");
         
         updateProgramList();
         
@@ -918,42 +910,30 @@ GlueProgram ParameterWidget::getCurrentProgram() const
     return currentProgram;
 }
 
+// 轨迹的修改都经过模型，模型发出 trajectoryEdited 后在 onTrajectoryEdited() 中统一处理
 void ParameterWidget::addTrajectoryPoint(const GlueProgram::TrajectoryPoint& point)
 {
-    currentProgram.trajectory.append(point);
-    updateTrajectoryDisplay();
-    calculateTrajectoryTime();
-    isModified = true;
-    if (autoSaveTimer) {
-        autoSaveTimer->start();
-    }
-    emit trajectoryChanged();
+    trajectoryModel->appendPoint(point);
 }
 
 void ParameterWidget::removeTrajectoryPoint(int index)
 {
-    if (index >= 0 && index < currentProgram.trajectory.size()) {
-        currentProgram.trajectory.removeAt(index);
-        updateTrajectoryDisplay();
-        calculateTrajectoryTime();
-        isModified = true;
-        if (autoSaveTimer) {
-            autoSaveTimer->start();
-        }
-        emit trajectoryChanged();
-    }
+    trajectoryModel->removePoints(index, 1);
+}
+
+void ParameterWidget::updateTrajectoryPoint(int index, const GlueProgram::TrajectoryPoint& point)
+{
+    trajectoryModel->setPoint(index, point);
 }
 
 void ParameterWidget::clearTrajectory()
 {
-    currentProgram.trajectory.clear();
-    updateTrajectoryDisplay();
-    calculateTrajectoryTime();
-    isModified = true;
-    if (autoSaveTimer) {
-        autoSaveTimer->start();
+    if (currentProgram.trajectory.isEmpty()) {
+        return;
     }
-    emit trajectoryChanged();
+    currentProgram.trajectory.clear();
+    trajectoryModel->resetTrajectory();
+    onTrajectoryEdited();
 }
 
 void ParameterWidget::updateProgramList()
@@ -992,71 +972,44 @@ void ParameterWidget::updateParameterDisplay()
 
 void ParameterWidget::updateTrajectoryDisplay()
 {
-    trajectoryTableWidget->setRowCount(currentProgram.trajectory.size());
-    
-    for (int i = 0; i < currentProgram.trajectory.size(); ++i) {
-        const GlueProgram::TrajectoryPoint& point = currentProgram.trajectory[i];
-        
-        trajectoryTableWidget->setItem(i, 0, new QTableWidgetItem(QString::number(i + 1)));
-        trajectoryTableWidget->setItem(i, 1, new QTableWidgetItem(QString::number(point.x, 'f', 3)));
-        trajectoryTableWidget->setItem(i, 2, new QTableWidgetItem(QString::number(point.y, 'f', 3)));
-        trajectoryTableWidget->setItem(i, 3, new QTableWidgetItem(QString::number(point.z, 'f', 3)));
-        trajectoryTableWidget->setItem(i, 4, new QTableWidgetItem(QString::number(point.speed, 'f', 2)));
-        trajectoryTableWidget->setItem(i, 5, new QTableWidgetItem(QString::number(point.volume, 'f', 3)));
-        trajectoryTableWidget->setItem(i, 6, new QTableWidgetItem(QString::number(point.dwellTime)));
-        trajectoryTableWidget->setItem(i, 7, new QTableWidgetItem(point.isGluePoint ? "是" : "否"));
-        
-        // 设置序号列不可编辑
-        trajectoryTableWidget->item(i, 0)->setFlags(trajectoryTableWidget->item(i, 0)->flags() & ~Qt::ItemIsEditable);
-    }
-    
-    // 更新统计信息
-    totalPointsLabel->setText(QString::number(currentProgram.trajectory.size()));
+    // currentProgram 的轨迹被整体替换或修改过，模型全量重算一次
+    trajectoryModel->resetTrajectory();
+    updateTrajectoryStats();
+}
+
+void ParameterWidget::updateTrajectoryStats()
+{
+    // 统计值由模型随修改增量维护，这里只刷新显示
+    const TrajectoryStats& stats = trajectoryModel->stats();
     
-    double totalVolume = 0;
-    for (const GlueProgram::TrajectoryPoint& point : currentProgram.trajectory) {
-        if (point.isGluePoint) {
-            totalVolume += point.volume;
-        }
+    if (stats.invalidCount > 0) {
+        totalPointsLabel->setText(QString("%1（%2 个点超出范围）").arg(stats.pointCount).arg(stats.invalidCount));
+    } else {
+        totalPointsLabel->setText(QString::number(stats.pointCount));
     }
-    totalVolumeLabel->setText(QString::number(totalVolume, 'f', 3) + " μL");
+    totalDistanceLabel->setText(QString::number(std::max(stats.distance, 0.0), 'f', 3) + " mm");
+    totalTimeLabel->setText(QString::number(std::max(stats.time, 0.0), 'f', 1) + " s");
+    totalVolumeLabel->setText(QString::number(std::max(stats.volume, 0.0), 'f', 3) + " μL");
 }
 
-void ParameterWidget::calculateTrajectoryTime()
+void ParameterWidget::updateTrajectoryLimits()
 {
-    if (currentProgram.trajectory.size() < 2) {
-        totalDistanceLabel->setText("0.000 mm");
-        totalTimeLabel->setText("0.0 s");
-        return;
-    }
-    
-    double totalDistance = 0;
-    double totalTime = 0;
-    
-    for (int i = 1; i < currentProgram.trajectory.size(); ++i) {
-        const GlueProgram::TrajectoryPoint& prev = currentProgram.trajectory[i - 1];
-        const GlueProgram::TrajectoryPoint& curr = currentProgram.trajectory[i];
-        
-        // 计算距离
-        double dx = curr.x - prev.x;
-        double dy = curr.y - prev.y;
-        double dz = curr.z - prev.z;
-        double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
-        totalDistance += distance;
-        
-        // 计算时间
-        double speed = std::max(curr.speed, 1.0); // 避免除零
-        double moveTime = distance / speed;
-        totalTime += moveTime;
-        
-        // 添加停留时间
-        if (curr.isGluePoint) {
-            totalTime += curr.dwellTime / 1000.0; // 转换为秒
+    // 轨迹点使用与程序参数相同的速度、胶量和停留时间范围
+    TrajectoryPointLimits limits;
+    for (const ValidationRule& rule : validationRules) {
+        if (rule.parameter == "点胶速度") {
+            limits.minSpeed = rule.minValue;
+            limits.maxSpeed = rule.maxValue;
+        } else if (rule.parameter == "胶量") {
+            limits.minVolume = rule.minValue;
+            limits.maxVolume = rule.maxValue;
+        } else if (rule.parameter == "停留时间") {
+            limits.minDwellTime = static_cast<int>(rule.minValue);
+            limits.maxDwellTime = static_cast<int>(rule.maxValue);
         }
     }
-    
-    totalDistanceLabel->setText(QString::number(totalDistance, 'f', 3) + " mm");
-    totalTimeLabel->setText(QString::number(totalTime, 'f', 1) + " s");
+    trajectoryModel->setLimits(limits);
+    updateTrajectoryStats();
 }
 
 bool ParameterWidget::validateProgram(const GlueProgram& program, QString& error)
@@ -1089,6 +1042,35 @@ bool ParameterWidget::validateProgram(const GlueProgram& program, QString& error
         return false;
     }
     
+    // 当前程序直接使用模型缓存的逐点校验结果，其他程序逐点检查
+    const TrajectoryPointLimits& limits = trajectoryModel->limits();
+    int invalidRow = -1;
+    int invalidCount = 0;
+    quint8 issues = TrajectoryTableModel::NoIssue;
+    if (&program.trajectory == trajectoryModel->trajectory()) {
+        invalidCount = trajectoryModel->stats().invalidCount;
+        invalidRow = trajectoryModel->firstInvalidRow();
+        issues = trajectoryModel->issuesAt(invalidRow);
+    } else {
+        for (int i = 0; i < program.trajectory.size(); ++i) {
+            const quint8 pointIssues = TrajectoryTableModel::checkPoint(program.trajectory.at(i), limits);
+            if (pointIssues != TrajectoryTableModel::NoIssue) {
+                if (invalidRow < 0) {
+                    invalidRow = i;
+                    issues = pointIssues;
+                }
+                ++invalidCount;
+            }
+        }
+    }
+    if (invalidRow >= 0) {
+        error = QString("轨迹点 %1 %2（共 %3 个点超出范围）")
+                .arg(invalidRow + 1)
+                .arg(TrajectoryTableModel::issueText(issues))
+                .arg(invalidCount);
+        return false;
+    }
+    
     return true;
 }
 
@@ -1097,21 +1079,38 @@ void ParameterWidget::loadProgramList()
     programList.clear();
     
     QDir dir(programsDirectory);
-    QStringList filters;
-    filters << "*.json";
-    QFileInfoList fileList = dir.entryInfoList(filters, QDir::Files);
+    QFileInfoList fileList = dir.entryInfoList(QStringList() << QString("*.") + ProgramFile::SUFFIX, QDir::Files);
     
     for (const QFileInfo& fileInfo : fileList) {
         loadProgram(fileInfo.absoluteFilePath());
     }
     
+    // 旧版本保存的 JSON 程序转换为二进制格式，原文件保留
+    const QFileInfoList legacyList = dir.entryInfoList(QStringList() << "*.json", QDir::Files);
+    for (const QFileInfo& fileInfo : legacyList) {
+        const QString binaryPath = programFilePath(fileInfo.completeBaseName());
+        if (QFileInfo::exists(binaryPath)) {
+            continue;
+        }
+        loadProgram(fileInfo.absoluteFilePath());
+        if (currentProgramPath == fileInfo.absoluteFilePath()) {
+            saveProgram(binaryPath);
+            LogManager::getInstance()->info("程序已转换为二进制格式: " + binaryPath, "Parameter");
+        }
+    }
+    
     updateProgramList();
 }
 
+QString ParameterWidget::programFilePath(const QString& programName) const
+{
+    return programsDirectory + "/" + programName + "." + ProgramFile::SUFFIX;
+}
+
 void ParameterWidget::saveProgramList()
 {
     for (const GlueProgram& program : programList) {
-        QString filePath = programsDirectory + "/" + program.name + ".json";
+        QString filePath = programFilePath(program.name);
         // 这里可以调用saveProgram，但为了避免重复，直接保存当前程序
         if (program.name == currentProgram.name) {
             saveProgram(filePath);
@@ -1326,7 +1325,7 @@ void ParameterWidget::autoSave()
     if (isModified) {
         // 自动保存当前程序
         if (!currentProgram.name.isEmpty()) {
-            QString filePath = programsDirectory + "/" + currentProgram.name + ".json";
+            QString filePath = programFilePath(currentProgram.name);
             saveProgram(filePath);
             LogManager::getInstance()->info("自动保存程序: " + currentProgram.name, "Parameter");
         }
@@ -1465,7 +1464,6 @@ void ParameterWidget::optimizeTrajectory()
     QMessageBox::information(this, "优化结果", result);
     
     updateTrajectoryDisplay();
-    calculateTrajectoryTime();
     isModified = true;
     if (autoSaveTimer) {
         autoSaveTimer->start();
@@ -1549,18 +1547,26 @@ void ParameterWidget::removeDuplicatePoints()
     // 清理重复点
     const double tolerance = 0.01; // 0.01mm容差
     
-    for (int i = currentProgram.trajectory.size() - 1; i > 0; --i) {
-        const GlueProgram::TrajectoryPoint& current = currentProgram.trajectory[i];
-        const GlueProgram::TrajectoryPoint& previous = currentProgram.trajectory[i-1];
+    // 单遍压缩：与原轨迹中的前一个点比较，保留的点依次前移，不逐个 removeAt
+    QList<GlueProgram::TrajectoryPoint>& points = currentProgram.trajectory;
+    if (points.size() < 2) {
+        return;
+    }
+    int kept = 1;
+    GlueProgram::TrajectoryPoint previous = points[0];
+    for (int i = 1; i < points.size(); ++i) {
+        const GlueProgram::TrajectoryPoint current = points[i];
         
         double distance = sqrt(pow(current.x - previous.x, 2) + 
                              pow(current.y - previous.y, 2) + 
                              pow(current.z - previous.z, 2));
         
-        if (distance < tolerance) {
-            currentProgram.trajectory.removeAt(i);
+        if (distance >= tolerance) {
+            points[kept++] = current;
         }
+        previous = current;
     }
+    points.resize(kept);
 }
 
 double ParameterWidget::calculateTotalDistance() const
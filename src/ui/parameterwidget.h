@@ -24,47 +24,11 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include "../data/glueprogram.h"
 
-// 点胶程序结构
-struct GlueProgram {
-    QString name;               // 程序名称
-    QString description;        // 程序描述
-    QString version;            // 版本号
-    QDateTime createTime;       // 创建时间
-    QDateTime modifyTime;       // 修改时间
-    
-    // 程序参数
-    struct ProgramParams {
-        double volume;          // 胶量
-        double speed;           // 速度
-        double pressure;        // 压力
-        double temperature;     // 温度
-        int dwellTime;          // 停留时间
-        int riseTime;           // 上升时间
-        int fallTime;           // 下降时间
-        
-        ProgramParams() : volume(1.0), speed(10.0), pressure(2.0), temperature(25.0)
-                        , dwellTime(100), riseTime(50), fallTime(50) {}
-    } params;
-    
-    // 轨迹点列表
-    struct TrajectoryPoint {
-        double x, y, z;         // 位置坐标
-        double speed;           // 该点速度
-        double volume;          // 该点胶量
-        int dwellTime;          // 该点停留时间
-        bool isGluePoint;       // 是否为点胶点
-        
-        TrajectoryPoint() : x(0), y(0), z(0), speed(10.0), volume(1.0)
-                          , dwellTime(100), isGluePoint(true) {}
-    };
-    
-    QList<TrajectoryPoint> trajectory;
-    
-    GlueProgram() : name("新程序"), description(""), version("1.0")
-                  , createTime(QDateTime::currentDateTime())
-                  , modifyTime(QDateTime::currentDateTime()) {}
-};
+class QTableView;
+class TrajectoryTableModel;
+class TrajectoryPreviewWidget;
 
 // 参数模板结构
 struct ParameterTemplate {
@@ -141,7 +105,8 @@ signals:
 
 private slots:
     void onProgramItemChanged(QTreeWidgetItem* item, int column);
-    void onTrajectoryItemChanged(QTableWidgetItem* item);
+    void onTrajectoryEdited();
+    void onTrajectoryPointPicked(int row);
     void onParameterItemChanged();
 
 private:
@@ -159,12 +124,15 @@ private:
     
     void loadProgramList();
     void saveProgramList();
+    // 程序库中的程序按二进制格式保存，JSON 只用于导入导出
+    QString programFilePath(const QString& programName) const;
     void loadTemplateList();
     void saveTemplateList();
     
     bool validateProgram(const GlueProgram& program, QString& error);
     void optimizeTrajectory();
-    void calculateTrajectoryTime();
+    void updateTrajectoryStats();
+    void updateTrajectoryLimits();
     
     QString formatTime(double seconds) const;
     QString formatDistance(double distance) const;
@@ -206,7 +174,9 @@ private:
     
     // 轨迹编辑面板
     QGroupBox* trajectoryGroup;
-    QTableWidget* trajectoryTableWidget;
+    QTableView* trajectoryTableView;
+    TrajectoryTableModel* trajectoryModel;
+    TrajectoryPreviewWidget* trajectoryPreview;
     QPushButton* addPointButton;
     QPushButton* removePointButton;
     QPushButton* editPointButton;
@@ -0,0 +1,352 @@
+#include "sqlpagemodel.h"
+#include "../core/databaseservice.h"
+#include "../constants.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+namespace {
+bool execQuery(QSqlQuery& query, const QString& sql, const QVariantList& values)
+{
+    if (!query.prepare(sql)) {
+        return false;
+    }
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
+    }
+    return query.exec();
+}
+}
+
+SqlPageModel::SqlPageModel(const QString& from, const QString& keyField, const QList<SqlPageColumn>& columns,
+                           QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_service(nullptr)
+    , m_from(from)
+    , m_keyField(keyField)
+    , m_columns(columns)
+    , m_sortColumn(-1)
+    , m_sortOrder(Qt::DescendingOrder)
+    , m_pageSize(System::DB_HISTORY_PAGE_SIZE)
+    , m_active(false)
+    , m_generation(0)
+    , m_rowCount(0)
+    , m_shownPages(0)
+    , m_totalCount(0)
+    , m_fetching(false)
+    , m_pageStarts(1)
+    , m_pages(System::DB_TABLE_CACHED_PAGES)
+{
+}
+
+void SqlPageModel::setDatabaseService(DatabaseService* service)
+{
+    m_service = service;
+    if (m_active) {
+        reload();
+    }
+}
+
+void SqlPageModel::setFormatter(Formatter formatter)
+{
+    m_formatter = std::move(formatter);
+    if (m_rowCount > 0) {
+        emit dataChanged(index(0, 0), index(m_rowCount - 1, columnCount() - 1));
+    }
+}
+
+void SqlPageModel::setPageSize(int rows)
+{
+    rows = qMax(1, rows);
+    if (rows == m_pageSize) {
+        return;
+    }
+    m_pageSize = rows;
+    if (m_active) {
+        reload();
+    }
+}
+
+int SqlPageModel::pageSize() const
+{
+    return m_pageSize;
+}
+
+void SqlPageModel::setMaxCachedPages(int pages)
+{
+    m_pages.setMaxCost(qMax(1, pages));
+}
+
+void SqlPageModel::setFilter(const QString& where, const QVariantList& values)
+{
+    m_where = where;
+    m_whereValues = values;
+    reload();
+}
+
+void SqlPageModel::reload()
+{
+    m_active = true;
+    ++m_generation;
+
+    beginResetModel();
+    m_rowCount = 0;
+    m_shownPages = 0;
+    m_pageStarts = QVector<PageStart>(1);
+    m_pages.clear();
+    m_pendingPages.clear();
+    m_fetching = m_service != nullptr;
+    const bool countChanged = m_totalCount != 0;
+    m_totalCount = 0;
+    endResetModel();
+
+    if (countChanged) {
+        emit totalCountChanged(0);
+    }
+    requestPage(0, true);
+}
+
+int SqlPageModel::totalCount() const
+{
+    return m_totalCount;
+}
+
+QVariantList SqlPageModel::rowValues(int row) const
+{
+    if (row < 0 || row >= m_rowCount) {
+        return QVariantList();
+    }
+    const Page* page = m_pages.object(row / m_pageSize);
+    const int offset = row % m_pageSize;
+    if (!page || offset >= page->size()) {
+        return QVariantList();
+    }
+    return page->at(offset).mid(0, m_columns.size());
+}
+
+int SqlPageModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int SqlPageModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant SqlPageModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount || index.column() >= m_columns.size()) {
+        return QVariant();
+    }
+
+    const int pageIndex = index.row() / m_pageSize;
+    const Page* page = m_pages.object(pageIndex);
+    if (!page) {
+        // 已被淘汰的页：先显示空行，读取完成后通过 dataChanged 刷新
+        const_cast<SqlPageModel*>(this)->requestPage(pageIndex, false);
+        return QVariant();
+    }
+
+    const int offset = index.row() % m_pageSize;
+    if (offset >= page->size()) {
+        return QVariant();
+    }
+    const QVariantList& row = page->at(offset);
+    if (m_formatter) {
+        return m_formatter(row, index.column(), role);
+    }
+    return role == Qt::DisplayRole ? row.value(index.column()) : QVariant();
+}
+
+QVariant SqlPageModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < m_columns.size()) {
+        return m_columns.at(section).header;
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool SqlPageModel::canFetchMore(const QModelIndex& parent) const
+{
+    // 最后一页读满了才可能还有下一页
+    return !parent.isValid() && m_service && !m_fetching && m_shownPages > 0
+        && m_rowCount == m_shownPages * m_pageSize && m_rowCount < m_totalCount;
+}
+
+void SqlPageModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    m_fetching = true;
+    requestPage(m_shownPages, false);
+}
+
+void SqlPageModel::sort(int column, Qt::SortOrder order)
+{
+    if (column >= m_columns.size() || (column >= 0 && m_columns.at(column).sortExpression.isEmpty())) {
+        return;
+    }
+    if (column == m_sortColumn && order == m_sortOrder) {
+        return;
+    }
+    m_sortColumn = column;
+    m_sortOrder = order;
+    if (m_active) {
+        reload();
+    }
+}
+
+void SqlPageModel::requestPage(int page, bool withCount)
+{
+    if (!m_service || page >= m_pageStarts.size() || m_pendingPages.contains(page)) {
+        return;
+    }
+    m_pendingPages.insert(page);
+
+    QVariantList values;
+    const QString sql = pageSql(page, &values);
+    QString countSql;
+    if (withCount) {
+        countSql = "SELECT COUNT(*) FROM " + m_from;
+        if (!m_where.isEmpty()) {
+            countSql += " WHERE " + m_where;
+        }
+    }
+    const QVariantList countValues = withCount ? m_whereValues : QVariantList();
+    const int columns = m_columns.size();
+    const quint64 generation = m_generation;
+
+    m_service->read<PageResult>([sql, values, countSql, countValues, columns](QSqlDatabase& database) {
+        return fetchPage(database, sql, values, countSql, countValues, columns);
+    }, this, [this, generation, page](const PageResult& result) {
+        onPageLoaded(generation, page, result);
+    });
+}
+
+void SqlPageModel::onPageLoaded(quint64 generation, int page, const PageResult& result)
+{
+    // 等待期间重新加载过（条件、排序或数据库改变），结果已经过时
+    if (generation != m_generation) {
+        return;
+    }
+    m_pendingPages.remove(page);
+    const bool nextPage = page == m_shownPages;
+
+    if (!result.success) {
+        if (nextPage) {
+            m_fetching = false;
+        }
+        emit loadFailed(result.error);
+        return;
+    }
+
+    int totalCount = result.totalCount >= 0 ? result.totalCount : m_totalCount;
+    const int columns = m_columns.size();
+    if (result.rows.size() == m_pageSize && page + 1 == m_pageStarts.size()) {
+        const QVariantList& last = result.rows.last();
+        m_pageStarts.append(PageStart{last.value(columns), last.value(columns + 1)});
+    }
+
+    if (nextPage) {
+        if (!result.rows.isEmpty()) {
+            beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + result.rows.size() - 1);
+            m_pages.insert(page, new Page(result.rows));
+            m_rowCount += result.rows.size();
+            ++m_shownPages;
+            endInsertRows();
+        }
+        // 不满一页说明已经读到末尾，统计之后被删除的行不再计入
+        if (result.rows.size() < m_pageSize) {
+            totalCount = m_rowCount;
+        }
+        m_fetching = false;
+    } else if (page < m_shownPages) {
+        m_pages.insert(page, new Page(result.rows));
+        const int first = page * m_pageSize;
+        const int last = qMin(m_rowCount, first + m_pageSize) - 1;
+        emit dataChanged(index(first, 0), index(last, columns - 1));
+    }
+
+    if (totalCount != m_totalCount) {
+        m_totalCount = totalCount;
+        emit totalCountChanged(m_totalCount);
+    }
+}
+
+QString SqlPageModel::pageSql(int page, QVariantList* values) const
+{
+    const QString sortExpr = sortExpression();
+    const bool ascending = m_sortOrder == Qt::AscendingOrder;
+    const QString direction = ascending ? " ASC" : " DESC";
+
+    QStringList fields;
+    for (const SqlPageColumn& column : m_columns) {
+        fields.append(column.field);
+    }
+    // 每行末尾附带排序值和主键，作为下一页的起点
+    fields.append(sortExpr);
+    fields.append(m_keyField);
+
+    QStringList conditions;
+    if (!m_where.isEmpty()) {
+        conditions.append("(" + m_where + ")");
+        values->append(m_whereValues);
+    }
+    if (page > 0) {
+        const PageStart& start = m_pageStarts.at(page);
+        const QString op = ascending ? " > ?" : " < ?";
+        conditions.append("(" + sortExpr + op + " OR (" + sortExpr + " = ? AND " + m_keyField + op + "))");
+        values->append(start.sortValue);
+        values->append(start.sortValue);
+        values->append(start.key);
+    }
+
+    QString sql = "SELECT " + fields.join(", ") + " FROM " + m_from;
+    if (!conditions.isEmpty()) {
+        sql += " WHERE " + conditions.join(" AND ");
+    }
+    sql += " ORDER BY " + sortExpr + direction + ", " + m_keyField + direction + " LIMIT ?";
+    values->append(m_pageSize);
+    return sql;
+}
+
+QString SqlPageModel::sortExpression() const
+{
+    return m_sortColumn >= 0 ? m_columns.at(m_sortColumn).sortExpression : m_keyField;
+}
+
+SqlPageModel::PageResult SqlPageModel::fetchPage(QSqlDatabase& database, const QString& sql, const QVariantList& values,
+                                                 const QString& countSql, const QVariantList& countValues,
+                                                 int columnCount)
+{
+    PageResult result;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+
+    if (!countSql.isEmpty()) {
+        if (!execQuery(query, countSql, countValues) || !query.next()) {
+            result.error = query.lastError().text();
+            return result;
+        }
+        result.totalCount = query.value(0).toInt();
+    }
+
+    if (!execQuery(query, sql, values)) {
+        result.error = query.lastError().text();
+        return result;
+    }
+    const int fieldCount = columnCount + 2;
+    while (query.next()) {
+        QVariantList row;
+        row.reserve(fieldCount);
+        for (int i = 0; i < fieldCount; ++i) {
+            row.append(query.value(i));
+        }
+        result.rows.append(row);
+    }
+    result.success = true;
+    return result;
+}
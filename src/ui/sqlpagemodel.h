@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QVector>
+#include <functional>
+
+class DatabaseService;
+class QSqlDatabase;
+
+// 分页表格的一列
+struct SqlPageColumn {
+    QString header;
+    QString field;              // SELECT 列表中的表达式
+    QString sortExpression;     // 按该列排序时使用的表达式，为空表示不能排序；可为空值的列用 IFNULL 包装
+};
+
+// 按页从数据库读取的只读表格模型
+//
+// 过滤和排序都在 SQL 中完成，每页按 (排序表达式, 主键) 做键集分页，翻到第 N 页也只读取一页的索引范围。
+// 第一页和总记录数在同一个数据库任务中读取；之后视图滚动到底部时通过 canFetchMore()/fetchMore()
+// 逐页显示。内存中最多保留 maxCachedPages 页（LRU），被淘汰的页再次显示时按记录的页起点重新读取，
+// 行数再多内存也保持不变；每页只额外保留一个起点（排序值和主键）。
+// 所有查询都在 DatabaseService 的只读查询线程执行（见 DatabaseService::read），回调在界面线程；重新加载后，之前发出的查询结果被丢弃。
+class SqlPageModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    // row 为该行 columns 中各字段的值
+    using Formatter = std::function<QVariant(const QVariantList& row, int column, int role)>;
+
+    // from 为表名或视图名，keyField 为唯一且非空的主键，用于同一排序值内的顺序
+    SqlPageModel(const QString& from, const QString& keyField, const QList<SqlPageColumn>& columns,
+                 QObject* parent = nullptr);
+
+    // 服务被替换（如恢复数据库之后）时重新设置，之前的查询结果被丢弃；nullptr 时模型为空
+    void setDatabaseService(DatabaseService* service);
+    // 未设置时 DisplayRole 显示字段原值
+    void setFormatter(Formatter formatter);
+    void setPageSize(int rows);
+    int pageSize() const;
+    void setMaxCachedPages(int pages);
+
+    // where 为不带 WHERE 关键字的条件，values 为其中占位符的值；设置后重新加载
+    void setFilter(const QString& where, const QVariantList& values = QVariantList());
+    void reload();
+
+    // 当前条件下的总记录数，第一页返回之前为 0
+    int totalCount() const;
+    // 该行所在页被淘汰且尚未重新读取时返回空列表
+    QVariantList rowValues(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    // 排序条件改变时重新加载
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+signals:
+    void totalCountChanged(int total);
+    void loadFailed(const QString& error);
+
+private:
+    using Page = QVector<QVariantList>;
+
+    // 页的起点：上一页最后一行的排序值和主键
+    struct PageStart {
+        QVariant sortValue;
+        QVariant key;
+    };
+
+    struct PageResult {
+        bool success = false;
+        QString error;
+        int totalCount = -1;    // 没有统计时为 -1
+        Page rows;
+    };
+
+    void requestPage(int page, bool withCount);
+    void onPageLoaded(quint64 generation, int page, const PageResult& result);
+    QString pageSql(int page, QVariantList* values) const;
+    QString sortExpression() const;
+    static PageResult fetchPage(QSqlDatabase& database, const QString& sql, const QVariantList& values,
+                                const QString& countSql, const QVariantList& countValues, int columnCount);
+
+    DatabaseService* m_service;
+    QString m_from;
+    QString m_keyField;
+    QList<SqlPageColumn> m_columns;
+    Formatter m_formatter;
+
+    QString m_where;
+    QVariantList m_whereValues;
+    int m_sortColumn;           // 小于 0 表示只按主键排序
+    Qt::SortOrder m_sortOrder;
+    int m_pageSize;
+
+    bool m_active;              // 第一次 setFilter()/reload() 之前不查询，排序只记录下来
+    quint64 m_generation;       // 每次重新加载递增，用于丢弃过时的结果
+    int m_rowCount;             // 已显示的行数
+    int m_shownPages;
+    int m_totalCount;
+    bool m_fetching;            // 正在读取下一页
+    QVector<PageStart> m_pageStarts;    // 第 i 页的起点，第 0 页没有起点
+    mutable QCache<int, Page> m_pages;
+    mutable QSet<int> m_pendingPages;
+};
@@ -0,0 +1,316 @@
+#include "stripchartwidget.h"
+#include "../utils/seriesdecimator.h"
+#include "../utils/tracer.h"
+#include "../constants.h"
+#include <QElapsedTimer>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+constexpr int LABEL_WIDTH = 120;            // 左侧通道名称和当前值的宽度
+constexpr int GRID_INTERVAL_MS = 1000;      // 竖直网格线间隔
+constexpr double RANGE_MARGIN = 0.1;        // 量程扩大时两侧留出的比例
+const QColor BACKGROUND_COLOR(Qt::white);
+const QColor GRID_COLOR(Qt::lightGray);
+}
+
+StripChartWidget::StripChartWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_refreshTimer(new QTimer(this))
+    , m_msPerColumn(System::STRIP_CHART_MS_PER_COLUMN)
+    , m_renderedUntilMs(0)
+    , m_fullRedraw(true)
+    , m_lastRenderNs(0)
+{
+    // 整个绘图区都由画布覆盖，不需要先擦除背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumHeight(200);
+
+    m_refreshTimer->setInterval(System::STRIP_CHART_REFRESH_INTERVAL_MS);
+    connect(m_refreshTimer, &QTimer::timeout, this, &StripChartWidget::refresh);
+}
+
+StripChartWidget::~StripChartWidget() = default;
+
+int StripChartWidget::addChannel(const QString& name, const QColor& color, double minValue, double maxValue,
+                                 int capacity)
+{
+    Channel channel;
+    channel.name = name;
+    channel.color = color;
+    channel.minValue = std::min(minValue, maxValue);
+    channel.maxValue = std::max(minValue, maxValue);
+    if (channel.maxValue - channel.minValue < 1e-9) {
+        channel.maxValue = channel.minValue + 1;
+    }
+    channel.points.setCapacity(capacity);
+    m_channels.append(channel);
+
+    // 泳道高度随通道数变化
+    m_fullRedraw = true;
+    return m_channels.size() - 1;
+}
+
+int StripChartWidget::channelCount() const
+{
+    return m_channels.size();
+}
+
+void StripChartWidget::append(int channel, qint64 timestampMs, double value)
+{
+    if (channel < 0 || channel >= m_channels.size()) return;
+
+    Channel& target = m_channels[channel];
+    target.points.append(timestampMs, value);
+    target.lastValue = value;
+    target.hasLastValue = true;
+
+    // 已绘制的列按旧量程画出，量程变化后只能整体重绘
+    if (value < target.minValue || value > target.maxValue) {
+        const double span = target.maxValue - target.minValue;
+        target.minValue = std::min(target.minValue, value - span * RANGE_MARGIN);
+        target.maxValue = std::max(target.maxValue, value + span * RANGE_MARGIN);
+        m_fullRedraw = true;
+    }
+}
+
+void StripChartWidget::clear()
+{
+    for (Channel& channel : m_channels) {
+        channel.points.clear();
+        channel.hasLastValue = false;
+        channel.hasDrawnValue = false;
+    }
+    m_renderedUntilMs = 0;
+    m_fullRedraw = true;
+    update();
+}
+
+void StripChartWidget::setMillisecondsPerColumn(int ms)
+{
+    m_msPerColumn = std::max(1, ms);
+    m_renderedUntilMs = 0;
+    m_fullRedraw = true;
+}
+
+int StripChartWidget::millisecondsPerColumn() const
+{
+    return m_msPerColumn;
+}
+
+void StripChartWidget::setRefreshInterval(int ms)
+{
+    m_refreshTimer->setInterval(std::max(1, ms));
+}
+
+qint64 StripChartWidget::lastRenderNs() const
+{
+    return m_lastRenderNs;
+}
+
+void StripChartWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(this);
+    const QRect plot = plotRect();
+
+    // 通道名称和当前值每帧重画，只有文字，开销很小
+    const QRect labels(0, 0, LABEL_WIDTH, height());
+    if (event->rect().intersects(labels)) {
+        painter.fillRect(labels, palette().window());
+        for (int i = 0; i < m_channels.size(); ++i) {
+            const Channel& channel = m_channels[i];
+            const QRect lane = laneRect(i).translated(0, plot.top());
+            const QRect text(4, lane.top(), LABEL_WIDTH - 8, lane.height());
+            painter.setPen(channel.color);
+            const QString value = channel.hasLastValue ? QString::number(channel.lastValue, 'f', 3) : QString("--");
+            painter.drawText(text, Qt::AlignLeft | Qt::AlignVCenter, channel.name + "\n" + value);
+        }
+        painter.setPen(palette().windowText().color());
+        painter.drawText(QRect(4, height() - 18, LABEL_WIDTH - 8, 16), Qt::AlignLeft | Qt::AlignVCenter,
+                         QString("%1 s/屏").arg(plot.width() * m_msPerColumn / 1000.0, 0, 'f', 1));
+    }
+
+    if (m_canvas.isNull()) {
+        painter.fillRect(plot, BACKGROUND_COLOR);
+    } else {
+        painter.drawPixmap(plot.topLeft(), m_canvas);
+    }
+}
+
+void StripChartWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    const QSize size = plotRect().size();
+    if (size.isEmpty()) {
+        m_canvas = QPixmap();
+        return;
+    }
+    m_canvas = QPixmap(size);
+    m_canvas.fill(BACKGROUND_COLOR);
+    m_fullRedraw = true;
+}
+
+void StripChartWidget::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    // 隐藏期间画布没有滚动，重新显示时整体重绘
+    m_fullRedraw = true;
+    m_refreshTimer->start();
+    refresh();
+}
+
+void StripChartWidget::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer->stop();
+}
+
+void StripChartWidget::refresh()
+{
+    if (m_canvas.isNull() || m_channels.isEmpty()) return;
+
+    const qint64 latest = latestTimestamp();
+    if (latest <= 0) return;
+
+    TRACE_SCOPE("chart", "StripChartWidget::refresh");
+    QElapsedTimer timer;
+    timer.start();
+
+    // 只画已经结束的列，最新的一列还在累积数据
+    const qint64 target = latest / m_msPerColumn * m_msPerColumn;
+    const int width = m_canvas.width();
+    const qint64 newColumns = m_renderedUntilMs > 0 ? (target - m_renderedUntilMs) / m_msPerColumn : width;
+    if (!m_fullRedraw && newColumns <= 0) {
+        update(0, 0, LABEL_WIDTH, height());
+        return;
+    }
+
+    if (m_fullRedraw || newColumns >= width) {
+        m_renderedUntilMs = target;
+        redrawAll();
+    } else {
+        // 已绘制的部分整体左移，右侧露出的列重新绘制
+        const int count = static_cast<int>(newColumns);
+        m_canvas.scroll(-count, 0, m_canvas.rect());
+        m_renderedUntilMs = target;
+        drawColumns(width - count, count, target - count * m_msPerColumn);
+    }
+
+    m_lastRenderNs = timer.nsecsElapsed();
+    update();
+}
+
+void StripChartWidget::redrawAll()
+{
+    m_fullRedraw = false;
+    for (Channel& channel : m_channels) {
+        channel.hasDrawnValue = false;
+    }
+    m_canvas.fill(BACKGROUND_COLOR);
+    const int width = m_canvas.width();
+    drawColumns(0, width, m_renderedUntilMs - static_cast<qint64>(width) * m_msPerColumn);
+}
+
+void StripChartWidget::drawColumns(int firstColumn, int count, qint64 firstColumnStartMs)
+{
+    QPainter painter(&m_canvas);
+    painter.fillRect(QRect(firstColumn, 0, count, m_canvas.height()), BACKGROUND_COLOR);
+    drawGridColumns(painter, firstColumn, count, firstColumnStartMs);
+
+    for (int i = 0; i < m_channels.size(); ++i) {
+        Channel& channel = m_channels[i];
+        const SeriesRingBuffer::View data = channel.points.view();
+        if (data.isEmpty()) continue;
+
+        const QRect lane = laneRect(i);
+        painter.setPen(QPen(channel.color, 1));
+
+        // 只二分查找一次，之后顺序向后扫描
+        int index = SeriesDecimator::lowerBound(data, firstColumnStartMs);
+        for (int column = 0; column < count; ++column) {
+            const qint64 columnEnd = firstColumnStartMs + static_cast<qint64>(column + 1) * m_msPerColumn;
+            if (index >= data.size() || data.timestampAt(index) >= columnEnd) continue;
+
+            const double first = data.valueAt(index);
+            double minimum = first;
+            double maximum = first;
+            double last = first;
+            for (; index < data.size() && data.timestampAt(index) < columnEnd; ++index) {
+                last = data.valueAt(index);
+                minimum = std::min(minimum, last);
+                maximum = std::max(maximum, last);
+            }
+
+            // 与上一个有数据的列相连（低频数据中间可能隔着空列），列内画出最小值到最大值
+            const int x = firstColumn + column;
+            if (channel.hasDrawnValue) {
+                const qint64 previous = firstColumn + (channel.drawnColumnMs - firstColumnStartMs) / m_msPerColumn;
+                painter.drawLine(static_cast<int>(previous), valueToY(channel, lane, channel.drawnValue),
+                                 x, valueToY(channel, lane, first));
+            }
+            painter.drawLine(x, valueToY(channel, lane, minimum), x, valueToY(channel, lane, maximum));
+            channel.drawnValue = last;
+            channel.drawnColumnMs = columnEnd - m_msPerColumn;
+            channel.hasDrawnValue = true;
+        }
+    }
+}
+
+void StripChartWidget::drawGridColumns(QPainter& painter, int firstColumn, int count, qint64 firstColumnStartMs)
+{
+    painter.setPen(QPen(GRID_COLOR, 1));
+
+    // 泳道分隔线和中线
+    for (int i = 0; i < m_channels.size(); ++i) {
+        const QRect lane = laneRect(i);
+        painter.drawLine(firstColumn, lane.bottom(), firstColumn + count - 1, lane.bottom());
+        painter.setPen(QPen(GRID_COLOR, 1, Qt::DotLine));
+        painter.drawLine(firstColumn, lane.center().y(), firstColumn + count - 1, lane.center().y());
+        painter.setPen(QPen(GRID_COLOR, 1));
+    }
+
+    // 每秒一条竖线，画在跨过整秒的列上
+    for (int column = 0; column < count; ++column) {
+        const qint64 start = firstColumnStartMs + static_cast<qint64>(column) * m_msPerColumn;
+        const qint64 end = start + m_msPerColumn;
+        if (start / GRID_INTERVAL_MS != (end - 1) / GRID_INTERVAL_MS || start % GRID_INTERVAL_MS == 0) {
+            painter.drawLine(firstColumn + column, 0, firstColumn + column, m_canvas.height() - 1);
+        }
+    }
+}
+
+QRect StripChartWidget::plotRect() const
+{
+    return rect().adjusted(LABEL_WIDTH, 0, 0, 0);
+}
+
+QRect StripChartWidget::laneRect(int channel) const
+{
+    // 画布坐标
+    const int height = m_canvas.isNull() ? plotRect().height() : m_canvas.height();
+    const int count = std::max(1, static_cast<int>(m_channels.size()));
+    const int top = height * channel / count;
+    const int bottom = height * (channel + 1) / count;
+    return QRect(0, top, m_canvas.isNull() ? plotRect().width() : m_canvas.width(), bottom - top);
+}
+
+int StripChartWidget::valueToY(const Channel& channel, const QRect& lane, double value) const
+{
+    const double ratio = (value - channel.minValue) / (channel.maxValue - channel.minValue);
+    const int y = lane.bottom() - 1 - static_cast<int>(ratio * (lane.height() - 3));
+    return std::clamp(y, lane.top() + 1, lane.bottom() - 1);
+}
+
+qint64 StripChartWidget::latestTimestamp() const
+{
+    qint64 latest = 0;
+    for (const Channel& channel : m_channels) {
+        const SeriesRingBuffer::View data = channel.points.view();
+        if (!data.isEmpty()) {
+            latest = std::max(latest, data.timestampAt(data.size() - 1));
+        }
+    }
+    return latest;
+}
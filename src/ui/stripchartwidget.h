@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QWidget>
+#include <QColor>
+#include <QPixmap>
+#include <QString>
+#include <QVector>
+#include "../utils/seriesringbuffer.h"
+
+class QTimer;
+
+// 高频多通道滚动曲线（示波器式条带图）
+//
+// 不经过 QtCharts：每个通道一条水平泳道，数据直接从通道的环形缓冲区读取。
+// 已绘制的内容保存在离屏 QPixmap 中，每次刷新把它左移新增的列数，只绘制右侧新出现的列，
+// 每列画出该时间段内的最小值到最大值，1 kHz 的数据也不会丢失尖峰。
+// 超出量程的值会扩大该通道的量程并整体重绘一次；窗口大小改变时同样整体重绘。
+// 滚动以数据时间为准，没有新数据时画面静止。只能在界面线程使用。
+class StripChartWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StripChartWidget(QWidget* parent = nullptr);
+    ~StripChartWidget() override;
+
+    // 返回通道序号；capacity 为保留的原始点数
+    int addChannel(const QString& name, const QColor& color, double minValue, double maxValue, int capacity);
+    int channelCount() const;
+
+    void append(int channel, qint64 timestampMs, double value);
+    void clear();
+
+    // 每个像素列代表的毫秒数
+    void setMillisecondsPerColumn(int ms);
+    int millisecondsPerColumn() const;
+    void setRefreshInterval(int ms);
+
+    // 最近一次刷新的耗时
+    qint64 lastRenderNs() const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    struct Channel {
+        QString name;
+        QColor color;
+        double minValue = 0;
+        double maxValue = 1;
+        SeriesRingBuffer points;
+        double lastValue = 0;
+        bool hasLastValue = false;
+        bool hasDrawnValue = false;
+        double drawnValue = 0;      // 上一个有数据的列的最后一个值，用于把相邻的列连成线
+        qint64 drawnColumnMs = 0;   // 该列的起始时间
+    };
+
+    void refresh();
+    void redrawAll();
+    void drawColumns(int firstColumn, int count, qint64 firstColumnStartMs);
+    void drawGridColumns(QPainter& painter, int firstColumn, int count, qint64 firstColumnStartMs);
+    QRect plotRect() const;
+    QRect laneRect(int channel) const;
+    int valueToY(const Channel& channel, const QRect& lane, double value) const;
+    qint64 latestTimestamp() const;
+
+    QVector<Channel> m_channels;
+    QPixmap m_canvas;               // 绘图区的已绘制内容
+    QTimer* m_refreshTimer;
+    int m_msPerColumn;
+    qint64 m_renderedUntilMs;       // 画布最右列的结束时间（不含），0 表示尚未绘制
+    bool m_fullRedraw;
+    qint64 m_lastRenderNs;
+};
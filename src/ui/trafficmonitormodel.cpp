@@ -0,0 +1,359 @@
+#include "trafficmonitormodel.h"
+#include "../communication/protocolparser.h"
+#include "../utils/monotonicclock.h"
+#include <QBrush>
+#include <QColor>
+#include <QFontDatabase>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+int hexValue(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') return u - '0';
+    if (u >= 'a' && u <= 'f') return u - 'a' + 10;
+    if (u >= 'A' && u <= 'F') return u - 'A' + 10;
+    return -1;
+}
+}
+
+TrafficMonitorModel::TrafficMonitorModel(int capacity, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_records(capacity)
+    , m_nextSequence(0)
+    , m_shownSequence(0)
+    , m_commandFilter(AllCommands)
+    , m_paused(false)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(System::UI_UPDATE_INTERVAL);
+    connect(&m_flushTimer, &QTimer::timeout, this, &TrafficMonitorModel::flush);
+}
+
+void TrafficMonitorModel::append(const QString& connection, TrafficDirection direction, const QByteArray& data)
+{
+    auto it = m_connectionIndex.constFind(connection);
+    if (it == m_connectionIndex.constEnd()) {
+        it = m_connectionIndex.insert(connection, static_cast<quint16>(m_connections.size()));
+        m_connections.append(connection);
+    }
+
+    Record record;
+    record.sequence = m_nextSequence++;
+    record.timestampNs = MonotonicClock::nowNs();
+    record.originalLength = data.size();
+    record.connection = it.value();
+    record.length = static_cast<quint16>(qMin<qsizetype>(data.size(), Protocol::MAX_FRAME_SIZE));
+    record.direction = direction;
+    std::memcpy(record.data, data.constData(), record.length);
+
+    // 以帧头开始的数据第 3 个字节为命令码
+    const uchar* bytes = reinterpret_cast<const uchar*>(record.data);
+    if (record.length >= 3 && ((quint16(bytes[0]) << 8) | bytes[1]) == Protocol::FRAME_HEADER) {
+        record.command = bytes[2];
+    }
+    m_records.append(record);
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void TrafficMonitorModel::clear()
+{
+    m_flushTimer.stop();
+    beginResetModel();
+    m_records.clear();
+    m_rows.clear();
+    m_shownSequence = m_nextSequence;
+    endResetModel();
+    emit rowsFlushed();
+}
+
+void TrafficMonitorModel::setPaused(bool paused)
+{
+    if (paused == m_paused) {
+        return;
+    }
+    m_paused = paused;
+    if (!m_paused) {
+        flush();
+    }
+}
+
+bool TrafficMonitorModel::isPaused() const
+{
+    return m_paused;
+}
+
+void TrafficMonitorModel::setCommandFilter(int command)
+{
+    if (command == m_commandFilter) {
+        return;
+    }
+    m_commandFilter = command;
+    rebuildRows();
+}
+
+int TrafficMonitorModel::commandFilter() const
+{
+    return m_commandFilter;
+}
+
+qint64 TrafficMonitorModel::firstSequence() const
+{
+    return m_nextSequence - m_records.size();
+}
+
+const TrafficMonitorModel::Record* TrafficMonitorModel::recordAt(int row) const
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return nullptr;
+    }
+    const qint64 offset = m_rows.at(row) - firstSequence();
+    if (offset < 0) {
+        // 已被覆盖、尚未在下一次合并时移除
+        return nullptr;
+    }
+    const RingBuffer<Record>::View records = m_records.view();
+    return &records[static_cast<int>(offset)];
+}
+
+bool TrafficMonitorModel::matches(const Record& record) const
+{
+    if (m_commandFilter == AllCommands) {
+        return true;
+    }
+    if (m_commandFilter == UnknownCommand) {
+        return record.command < 0;
+    }
+    return record.command == m_commandFilter;
+}
+
+void TrafficMonitorModel::flush()
+{
+    m_flushTimer.stop();
+
+    // 先移除已被覆盖的记录
+    const qint64 first = firstSequence();
+    int evicted = 0;
+    while (evicted < m_rows.size() && m_rows.at(evicted) < first) {
+        ++evicted;
+    }
+    if (evicted > 0) {
+        beginRemoveRows(QModelIndex(), 0, evicted - 1);
+        m_rows.remove(0, evicted);
+        endRemoveRows();
+    }
+
+    if (m_paused) {
+        return;
+    }
+
+    const qint64 start = std::max(m_shownSequence, first);
+    const RingBuffer<Record>::View records = m_records.view();
+    QList<qint64> added;
+    for (qint64 sequence = start; sequence < m_nextSequence; ++sequence) {
+        const Record& record = records[static_cast<int>(sequence - first)];
+        if (matches(record)) {
+            added.append(sequence);
+        }
+    }
+    m_shownSequence = m_nextSequence;
+
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + added.size() - 1);
+        m_rows.append(added);
+        endInsertRows();
+    }
+    if (evicted > 0 || !added.isEmpty()) {
+        emit rowsFlushed();
+    }
+}
+
+void TrafficMonitorModel::rebuildRows()
+{
+    beginResetModel();
+    m_rows.clear();
+    const qint64 first = firstSequence();
+    const qint64 end = m_paused ? std::max(m_shownSequence, first) : m_nextSequence;
+    const RingBuffer<Record>::View records = m_records.view();
+    for (qint64 sequence = first; sequence < end; ++sequence) {
+        if (matches(records[static_cast<int>(sequence - first)])) {
+            m_rows.append(sequence);
+        }
+    }
+    m_shownSequence = end;
+    endResetModel();
+    emit rowsFlushed();
+}
+
+int TrafficMonitorModel::find(const QByteArray& pattern, int fromRow, bool forward) const
+{
+    const int count = m_rows.size();
+    if (pattern.isEmpty() || count == 0) {
+        return -1;
+    }
+    const int step = forward ? 1 : count - 1;
+    int row = fromRow < 0 || fromRow >= count ? (forward ? count - 1 : 0) : fromRow;
+    for (int i = 0; i < count; ++i) {
+        row = (row + step) % count;
+        const Record* record = recordAt(row);
+        if (record && QByteArray::fromRawData(record->data, record->length).contains(pattern)) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+QByteArray TrafficMonitorModel::searchPattern(const QString& text)
+{
+    const QString trimmed = text.trimmed();
+    QByteArray bytes;
+    int high = -1;
+    bool isHex = !trimmed.isEmpty();
+    for (const QChar c : trimmed) {
+        if (c.isSpace()) {
+            if (high >= 0) {
+                isHex = false;
+                break;
+            }
+            continue;
+        }
+        const int value = hexValue(c);
+        if (value < 0) {
+            isHex = false;
+            break;
+        }
+        if (high < 0) {
+            high = value;
+        } else {
+            bytes.append(char((high << 4) | value));
+            high = -1;
+        }
+    }
+    if (isHex && high < 0) {
+        return bytes;
+    }
+    return text.toUtf8();
+}
+
+int TrafficMonitorModel::bufferedCount() const
+{
+    return m_records.size();
+}
+
+qint64 TrafficMonitorModel::totalCount() const
+{
+    return m_nextSequence;
+}
+
+int TrafficMonitorModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int TrafficMonitorModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TrafficMonitorModel::data(const QModelIndex& index, int role) const
+{
+    const Record* record = index.isValid() ? recordAt(index.row()) : nullptr;
+    if (!record) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case TimeColumn:
+            return MonotonicClock::toDateTime(MonotonicClock::toEpochMs(record->timestampNs)).toString("hh:mm:ss.zzz");
+        case ConnectionColumn:
+            return m_connections.value(record->connection);
+        case DirectionColumn:
+            return record->direction == TrafficDirection::Sent ? QStringLiteral("TX") : QStringLiteral("RX");
+        case CommandColumn:
+            if (record->command < 0) {
+                return QStringLiteral("-");
+            }
+            return QString("%1 %2").arg(record->command, 2, 16, QLatin1Char('0')).toUpper()
+                                   .arg(ProtocolParser::commandToString(static_cast<ProtocolCommand>(record->command)));
+        case LengthColumn:
+            return record->originalLength;
+        case HexColumn:
+            return hexText(*record);
+        case AsciiColumn:
+            return asciiText(*record);
+        default:
+            return QVariant();
+        }
+    case Qt::ForegroundRole:
+        return QBrush(record->direction == TrafficDirection::Sent ? QColor(0, 90, 200) : QColor(0, 130, 60));
+    case Qt::FontRole:
+        if (index.column() == HexColumn || index.column() == AsciiColumn) {
+            return QFontDatabase::systemFont(QFontDatabase::FixedFont);
+        }
+        return QVariant();
+    case Qt::TextAlignmentRole:
+        if (index.column() == LengthColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant TrafficMonitorModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case TimeColumn: return "时间";
+    case ConnectionColumn: return "连接";
+    case DirectionColumn: return "方向";
+    case CommandColumn: return "命令";
+    case LengthColumn: return "长度";
+    case HexColumn: return "十六进制";
+    case AsciiColumn: return "ASCII";
+    default: return QVariant();
+    }
+}
+
+QString TrafficMonitorModel::hexText(const Record& record)
+{
+    if (record.length == 0) {
+        return QString();
+    }
+    const bool truncated = record.originalLength > record.length;
+    QString text(record.length * 3 - 1 + (truncated ? 2 : 0), QLatin1Char(' '));
+    QChar* out = text.data();
+    for (int i = 0; i < record.length; ++i) {
+        const uchar byte = static_cast<uchar>(record.data[i]);
+        out[i * 3] = QLatin1Char(HEX_DIGITS[byte >> 4]);
+        out[i * 3 + 1] = QLatin1Char(HEX_DIGITS[byte & 0x0F]);
+    }
+    if (truncated) {
+        text[text.size() - 1] = QChar(0x2026);
+    }
+    return text;
+}
+
+QString TrafficMonitorModel::asciiText(const Record& record)
+{
+    QString text(record.length, QLatin1Char('.'));
+    QChar* out = text.data();
+    for (int i = 0; i < record.length; ++i) {
+        const uchar byte = static_cast<uchar>(record.data[i]);
+        if (byte >= 0x20 && byte < 0x7F) {
+            out[i] = QLatin1Char(char(byte));
+        }
+    }
+    return text;
+}
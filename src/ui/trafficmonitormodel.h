@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QTimer>
+#include "../utils/ringbuffer.h"
+#include "../constants.h"
+
+// 收发方向
+enum class TrafficDirection : quint8 {
+    Received = 0,
+    Sent = 1
+};
+
+// 报文监控的表格模型（通讯页）
+//
+// 收发的原始字节按记录存入定长环形缓冲区，每条记录内联保存最多 Protocol::MAX_FRAME_SIZE 字节，
+// 追加只是一次内存拷贝，记录数和内存都有上限。表格只保存通过过滤的记录序号，十六进制和 ASCII
+// 文本在视图绘制可见行时才由 data() 生成。新记录先积累，最多每 UI_UPDATE_INTERVAL 合并成一次行插入，
+// 不会每收一包就触发一次重新布局。暂停时继续记录，只是表格不再增加新行，恢复后补上仍在缓冲区中的记录；
+// 被覆盖的记录即使在暂停中也会从表格移除。按命令过滤和搜索都直接在原始字节上进行。
+class TrafficMonitorModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        TimeColumn = 0,
+        ConnectionColumn,
+        DirectionColumn,
+        CommandColumn,
+        LengthColumn,
+        HexColumn,
+        AsciiColumn,
+        ColumnCount
+    };
+
+    // 不按命令过滤
+    static constexpr int AllCommands = -1;
+    // 只显示不以帧头开始、识别不出命令码的记录
+    static constexpr int UnknownCommand = -2;
+
+    explicit TrafficMonitorModel(int capacity = System::TRAFFIC_MONITOR_RECORDS, QObject* parent = nullptr);
+
+    // 超过 Protocol::MAX_FRAME_SIZE 的数据只保留开头部分，长度列显示原始长度
+    void append(const QString& connection, TrafficDirection direction, const QByteArray& data);
+    void clear();
+
+    void setPaused(bool paused);
+    bool isPaused() const;
+
+    // command 为命令码，或 AllCommands / UnknownCommand
+    void setCommandFilter(int command);
+    int commandFilter() const;
+
+    // 从 fromRow 之后（向前搜索时为之前）开始查找数据中包含 pattern 的行，到末尾后回绕，找不到返回 -1
+    int find(const QByteArray& pattern, int fromRow, bool forward = true) const;
+    // 搜索文本：全部是十六进制字节（如 "AA 55 20"）时按字节搜索，否则按 UTF-8 文本搜索
+    static QByteArray searchPattern(const QString& text);
+
+    // 缓冲区中的记录数（不受过滤影响）和开始以来的记录总数
+    int bufferedCount() const;
+    qint64 totalCount() const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    // 合并插入行之后发出，用于滚动到底部和更新计数
+    void rowsFlushed();
+
+private:
+    struct Record {
+        qint64 sequence = 0;
+        qint64 timestampNs = 0;
+        int originalLength = 0;
+        quint16 connection = 0;
+        quint16 length = 0;                 // data 中保存的字节数
+        qint16 command = -1;                // 识别不出时为 -1
+        TrafficDirection direction = TrafficDirection::Received;
+        char data[Protocol::MAX_FRAME_SIZE];
+    };
+
+    void flush();
+    void rebuildRows();
+    bool matches(const Record& record) const;
+    const Record* recordAt(int row) const;
+    qint64 firstSequence() const;
+
+    static QString hexText(const Record& record);
+    static QString asciiText(const Record& record);
+
+    RingBuffer<Record> m_records;
+    qint64 m_nextSequence;
+    qint64 m_shownSequence;                 // 小于它的记录都已按过滤条件决定过是否显示
+    QList<qint64> m_rows;                   // 显示的记录序号，递增
+    QStringList m_connections;
+    QHash<QString, quint16> m_connectionIndex;
+    int m_commandFilter;
+    bool m_paused;
+    QTimer m_flushTimer;
+};
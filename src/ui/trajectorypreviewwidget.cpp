@@ -0,0 +1,270 @@
+#include "trajectorypreviewwidget.h"
+#include "trajectorytablemodel.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QRubberBand>
+#include <cmath>
+
+namespace {
+const int MARGIN = 12;
+const int PICK_RADIUS = 6;      // 像素
+const int DRAG_THRESHOLD = 4;   // 像素
+}
+
+TrajectoryPreviewWidget::TrajectoryPreviewWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_pathDirty(true)
+    , m_minX(0)
+    , m_maxY(0)
+    , m_scale(1)
+    , m_originX(0)
+    , m_originY(0)
+    , m_rubberBand(nullptr)
+    , m_dragging(false)
+{
+    setMinimumSize(200, 150);
+    setMouseTracking(false);
+}
+
+QSize TrajectoryPreviewWidget::sizeHint() const
+{
+    return QSize(400, 300);
+}
+
+void TrajectoryPreviewWidget::setModel(TrajectoryTableModel* model)
+{
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = model;
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::modelReset, this, &TrajectoryPreviewWidget::invalidatePath);
+        connect(m_model, &QAbstractItemModel::rowsInserted, this, &TrajectoryPreviewWidget::invalidatePath);
+        connect(m_model, &QAbstractItemModel::rowsRemoved, this, &TrajectoryPreviewWidget::invalidatePath);
+        connect(m_model, &QAbstractItemModel::dataChanged, this, &TrajectoryPreviewWidget::invalidatePath);
+    }
+    invalidatePath();
+}
+
+void TrajectoryPreviewWidget::setSelectionModel(QItemSelectionModel* selectionModel)
+{
+    if (m_selectionModel) {
+        disconnect(m_selectionModel, nullptr, this, nullptr);
+    }
+    m_selectionModel = selectionModel;
+    if (m_selectionModel) {
+        connect(m_selectionModel, &QItemSelectionModel::selectionChanged, this, [this]() { update(); });
+        connect(m_selectionModel, &QItemSelectionModel::currentChanged, this, [this]() { update(); });
+    }
+    update();
+}
+
+void TrajectoryPreviewWidget::invalidatePath()
+{
+    m_pathDirty = true;
+    update();
+}
+
+void TrajectoryPreviewWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    m_pathDirty = true;
+}
+
+void TrajectoryPreviewWidget::updateTransform()
+{
+    const QRectF bounds = m_model ? m_model->spatialIndex().bounds() : QRectF();
+    const double width = std::max(1, this->width() - 2 * MARGIN);
+    const double height = std::max(1, this->height() - 2 * MARGIN);
+
+    m_minX = bounds.left();
+    m_maxY = bounds.bottom();
+    if (bounds.width() > 0 && bounds.height() > 0) {
+        m_scale = std::min(width / bounds.width(), height / bounds.height());
+    } else if (bounds.width() > 0) {
+        m_scale = width / bounds.width();
+    } else if (bounds.height() > 0) {
+        m_scale = height / bounds.height();
+    } else {
+        m_scale = 1;
+    }
+    // 保持比例并居中
+    m_originX = MARGIN + (width - bounds.width() * m_scale) / 2;
+    m_originY = MARGIN + (height - bounds.height() * m_scale) / 2;
+}
+
+QPointF TrajectoryPreviewWidget::toScreen(double x, double y) const
+{
+    return QPointF(m_originX + (x - m_minX) * m_scale, m_originY + (m_maxY - y) * m_scale);
+}
+
+QPointF TrajectoryPreviewWidget::toWorld(const QPointF& screen) const
+{
+    return QPointF(m_minX + (screen.x() - m_originX) / m_scale, m_maxY - (screen.y() - m_originY) / m_scale);
+}
+
+void TrajectoryPreviewWidget::renderPath()
+{
+    m_pathDirty = false;
+    updateTransform();
+
+    const qreal ratio = devicePixelRatioF();
+    m_pathCache = QPixmap(size() * ratio);
+    m_pathCache.setDevicePixelRatio(ratio);
+    m_pathCache.fill(Qt::white);
+
+    const TrajectoryTableModel::Points* points = m_model ? m_model->trajectory() : nullptr;
+    const int count = m_model ? m_model->rowCount() : 0;
+    if (!points || count == 0 || points->size() < count) {
+        return;
+    }
+
+    QPainter painter(&m_pathCache);
+    painter.setRenderHint(QPainter::Antialiasing, count < 20000);
+
+    // 落在同一像素的连续点只保留一个，折线顶点数不超过路径经过的像素数
+    QPolygonF polyline;
+    polyline.reserve(std::min(count, width() * height()));
+    QPoint lastPixel(-1, -1);
+    for (int i = 0; i < count; ++i) {
+        const GlueProgram::TrajectoryPoint& point = points->at(i);
+        const QPointF screen = toScreen(point.x, point.y);
+        const QPoint pixel = screen.toPoint();
+        if (pixel != lastPixel || i == count - 1) {
+            polyline.append(screen);
+            lastPixel = pixel;
+        }
+    }
+    painter.setPen(QPen(QColor(0, 90, 200), 1));
+    painter.drawPolyline(polyline);
+
+    // 起点和终点
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 150, 60));
+    painter.drawEllipse(toScreen(points->first().x, points->first().y), 4, 4);
+    painter.setBrush(QColor(120, 120, 120));
+    painter.drawEllipse(toScreen(points->at(count - 1).x, points->at(count - 1).y), 4, 4);
+}
+
+void TrajectoryPreviewWidget::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event)
+    if (m_pathDirty || m_pathCache.size() != size() * devicePixelRatioF()) {
+        renderPath();
+    }
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_pathCache);
+    painter.setPen(QColor(200, 200, 200));
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+
+    const TrajectoryTableModel::Points* points = m_model ? m_model->trajectory() : nullptr;
+    const int count = m_model ? m_model->rowCount() : 0;
+    if (!points || count == 0 || points->size() < count || !m_selectionModel) {
+        return;
+    }
+
+    // 选中的点
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(255, 140, 0));
+    QPoint lastPixel(-1, -1);
+    const QItemSelection selection = m_selectionModel->selection();
+    for (const QItemSelectionRange& range : selection) {
+        const int last = std::min(range.bottom(), count - 1);
+        for (int i = std::max(range.top(), 0); i <= last; ++i) {
+            const QPointF screen = toScreen(points->at(i).x, points->at(i).y);
+            const QPoint pixel = screen.toPoint();
+            if (pixel != lastPixel) {
+                painter.drawRect(QRectF(screen.x() - 1.5, screen.y() - 1.5, 3, 3));
+                lastPixel = pixel;
+            }
+        }
+    }
+
+    // 当前点
+    const QModelIndex current = m_selectionModel->currentIndex();
+    if (current.isValid() && current.row() < count) {
+        const GlueProgram::TrajectoryPoint& point = points->at(current.row());
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(Qt::red, 2));
+        painter.drawEllipse(toScreen(point.x, point.y), 5, 5);
+    }
+}
+
+void TrajectoryPreviewWidget::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    m_pressPos = event->position().toPoint();
+    m_dragging = false;
+}
+
+void TrajectoryPreviewWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!(event->buttons() & Qt::LeftButton)) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+    const QPoint pos = event->position().toPoint();
+    if (!m_dragging && (pos - m_pressPos).manhattanLength() >= DRAG_THRESHOLD) {
+        m_dragging = true;
+        if (!m_rubberBand) {
+            m_rubberBand = new QRubberBand(QRubberBand::Rectangle, this);
+        }
+        m_rubberBand->show();
+    }
+    if (m_dragging) {
+        m_rubberBand->setGeometry(QRect(m_pressPos, pos).normalized());
+    }
+}
+
+void TrajectoryPreviewWidget::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+    if (!m_model || !m_selectionModel || m_model->rowCount() == 0) {
+        m_dragging = false;
+        if (m_rubberBand) {
+            m_rubberBand->hide();
+        }
+        return;
+    }
+
+    const PathIndex& index = m_model->spatialIndex();
+    const int lastColumn = TrajectoryTableModel::ColumnCount - 1;
+    if (m_dragging) {
+        m_dragging = false;
+        m_rubberBand->hide();
+
+        // 屏幕 y 向下，世界 y 向上，两个角换算后再规范化
+        const QRect area = m_rubberBand->geometry();
+        const QRectF world = QRectF(toWorld(area.topLeft()), toWorld(area.bottomRight())).normalized();
+        const QList<PathIndex::IndexRange> ranges = index.pointsIn(world);
+
+        QItemSelection selection;
+        int selected = 0;
+        for (const PathIndex::IndexRange& range : ranges) {
+            selection.select(m_model->index(range.first, 0), m_model->index(range.last, lastColumn));
+            selected += range.last - range.first + 1;
+        }
+        m_selectionModel->select(selection, QItemSelectionModel::ClearAndSelect);
+        if (!ranges.isEmpty()) {
+            m_selectionModel->setCurrentIndex(m_model->index(ranges.first().first, 0), QItemSelectionModel::NoUpdate);
+        }
+        emit regionSelected(selected);
+        return;
+    }
+
+    const QPointF world = toWorld(event->position());
+    const int row = index.nearest(world.x(), world.y(), PICK_RADIUS / m_scale);
+    if (row < 0) {
+        return;
+    }
+    m_selectionModel->setCurrentIndex(m_model->index(row, 0),
+                                      QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    emit pointPicked(row);
+}
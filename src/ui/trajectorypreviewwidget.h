@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QWidget>
+#include <QPixmap>
+#include <QPointer>
+#include <QItemSelectionModel>
+
+class QRubberBand;
+class TrajectoryTableModel;
+
+// 轨迹的 XY 平面预览（参数页轨迹编辑）
+//
+// 路径折线按当前缩放画进缓存位图，同一像素内的连续点只画一次，轨迹变化或尺寸变化时才重画；
+// 选中点和当前点每次绘制时叠加在缓存上。单击按模型的 PathIndex 拾取最近的点，拖动框选矩形内的点，
+// 结果直接写入与表格共用的选择模型，表格和预览的选中状态保持一致。
+class TrajectoryPreviewWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TrajectoryPreviewWidget(QWidget* parent = nullptr);
+
+    void setModel(TrajectoryTableModel* model);
+    void setSelectionModel(QItemSelectionModel* selectionModel);
+
+    QSize sizeHint() const override;
+
+signals:
+    void pointPicked(int row);
+    void regionSelected(int pointCount);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+private slots:
+    void invalidatePath();
+
+private:
+    void updateTransform();
+    void renderPath();
+    QPointF toScreen(double x, double y) const;
+    QPointF toWorld(const QPointF& screen) const;
+
+    QPointer<TrajectoryTableModel> m_model;
+    QPointer<QItemSelectionModel> m_selectionModel;
+
+    QPixmap m_pathCache;
+    bool m_pathDirty;
+
+    // 世界坐标到屏幕坐标：sx = m_originX + (x - m_minX) * m_scale，sy = m_originY + (m_maxY - y) * m_scale
+    double m_minX;
+    double m_maxY;
+    double m_scale;
+    double m_originX;
+    double m_originY;
+
+    QRubberBand* m_rubberBand;
+    QPoint m_pressPos;
+    bool m_dragging;
+};
@@ -0,0 +1,370 @@
+#include "trajectorytablemodel.h"
+#include <QBrush>
+#include <QColor>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+TrajectoryTableModel::TrajectoryTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_points(nullptr)
+{
+}
+
+void TrajectoryTableModel::setTrajectory(Points* points)
+{
+    beginResetModel();
+    m_points = points;
+    recalculate();
+    endResetModel();
+}
+
+void TrajectoryTableModel::resetTrajectory()
+{
+    setTrajectory(m_points);
+}
+
+const TrajectoryTableModel::Points* TrajectoryTableModel::trajectory() const
+{
+    return m_points;
+}
+
+void TrajectoryTableModel::setLimits(const TrajectoryPointLimits& limits)
+{
+    m_limits = limits;
+    if (size() == 0) {
+        return;
+    }
+    std::fill(m_issues.begin(), m_issues.end(), NoIssue);
+    m_stats.invalidCount = 0;
+    revalidate(0, size() - 1);
+    emit dataChanged(index(0, 0), index(size() - 1, ColumnCount - 1));
+}
+
+const TrajectoryPointLimits& TrajectoryTableModel::limits() const
+{
+    return m_limits;
+}
+
+int TrajectoryTableModel::size() const
+{
+    return static_cast<int>(m_issues.size());
+}
+
+void TrajectoryTableModel::recalculate()
+{
+    m_stats = TrajectoryStats();
+    m_issues.assign(m_points ? m_points->size() : 0, NoIssue);
+    m_stats.pointCount = size();
+    if (size() == 0) {
+        m_index.clear();
+        return;
+    }
+    revalidate(0, size() - 1);
+    addContributions(0, size() - 1, 1.0);
+    m_index.rebuild(*m_points);
+}
+
+void TrajectoryTableModel::revalidate(int first, int last)
+{
+    for (int i = first; i <= last; ++i) {
+        const quint8 issues = checkPoint(m_points->at(i), m_limits);
+        if ((m_issues[i] != NoIssue) != (issues != NoIssue)) {
+            m_stats.invalidCount += issues != NoIssue ? 1 : -1;
+        }
+        m_issues[i] = issues;
+    }
+}
+
+void TrajectoryTableModel::addContributions(int first, int last, double sign)
+{
+    first = std::max(first, 0);
+    last = std::min(last, size() - 1);
+    for (int i = first; i <= last; ++i) {
+        const Point& current = m_points->at(i);
+        if (current.isGluePoint) {
+            m_stats.volume += sign * current.volume;
+        }
+        if (i == 0) {
+            continue;
+        }
+        const Point& previous = m_points->at(i - 1);
+        const double dx = current.x - previous.x;
+        const double dy = current.y - previous.y;
+        const double dz = current.z - previous.z;
+        const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        double time = distance / std::max(current.speed, 1.0); // 避免除零
+        if (current.isGluePoint) {
+            time += current.dwellTime / 1000.0;
+        }
+        m_stats.distance += sign * distance;
+        m_stats.time += sign * time;
+    }
+    if (size() < 2) {
+        // 没有线段时直接归零，不留下增减的舍入误差
+        m_stats.distance = 0;
+        m_stats.time = 0;
+    }
+}
+
+void TrajectoryTableModel::insertPoints(int row, const Points& points)
+{
+    if (!m_points || points.isEmpty()) {
+        return;
+    }
+    row = std::clamp(row, 0, size());
+    const int inserted = points.size();
+
+    // 原来第 row 个点的前一个点变了，先扣除它的线段
+    addContributions(row, row, -1.0);
+
+    beginInsertRows(QModelIndex(), row, row + inserted - 1);
+    if (row == size()) {
+        m_points->append(points);
+    } else {
+        m_points->insert(row, inserted, Point());
+        std::copy(points.cbegin(), points.cend(), m_points->begin() + row);
+    }
+    m_issues.insert(m_issues.begin() + row, inserted, NoIssue);
+    m_stats.pointCount = size();
+    endInsertRows();
+
+    revalidate(row, row + inserted - 1);
+    addContributions(row, row + inserted, 1.0);
+    m_index.rebuild(*m_points);
+    emit trajectoryEdited();
+}
+
+void TrajectoryTableModel::appendPoint(const Point& point)
+{
+    insertPoints(size(), Points{point});
+}
+
+void TrajectoryTableModel::removePoints(int row, int count)
+{
+    if (!m_points || row < 0 || row >= size() || count <= 0) {
+        return;
+    }
+    count = std::min(count, size() - row);
+
+    addContributions(row, row + count, -1.0);
+    m_stats.invalidCount -= static_cast<int>(std::count_if(m_issues.begin() + row, m_issues.begin() + row + count,
+                                                           [](quint8 issues) { return issues != NoIssue; }));
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    m_points->remove(row, count);
+    m_issues.erase(m_issues.begin() + row, m_issues.begin() + row + count);
+    m_stats.pointCount = size();
+    endRemoveRows();
+
+    addContributions(row, row, 1.0);
+    m_index.rebuild(*m_points);
+    emit trajectoryEdited();
+}
+
+bool TrajectoryTableModel::setPoint(int row, const Point& point)
+{
+    if (!m_points || row < 0 || row >= size()) {
+        return false;
+    }
+
+    // 只有与这个点相连的两段线段受影响
+    addContributions(row, row + 1, -1.0);
+    const Point previous = m_points->at(row);
+    (*m_points)[row] = point;
+    addContributions(row, row + 1, 1.0);
+    revalidate(row, row);
+
+    if (previous.x != point.x || previous.y != point.y) {
+        m_index.updatePoint(row, point.x, point.y);
+    }
+    emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    emit trajectoryEdited();
+    return true;
+}
+
+const TrajectoryStats& TrajectoryTableModel::stats() const
+{
+    return m_stats;
+}
+
+quint8 TrajectoryTableModel::issuesAt(int row) const
+{
+    return row >= 0 && row < size() ? m_issues[row] : NoIssue;
+}
+
+int TrajectoryTableModel::firstInvalidRow(int fromRow) const
+{
+    if (m_stats.invalidCount == 0 || fromRow >= size()) {
+        return -1;
+    }
+    const auto it = std::find_if(m_issues.begin() + std::max(fromRow, 0), m_issues.end(),
+                                 [](quint8 issues) { return issues != NoIssue; });
+    return it == m_issues.end() ? -1 : static_cast<int>(it - m_issues.begin());
+}
+
+const PathIndex& TrajectoryTableModel::spatialIndex() const
+{
+    return m_index;
+}
+
+quint8 TrajectoryTableModel::checkPoint(const Point& point, const TrajectoryPointLimits& limits)
+{
+    quint8 issues = NoIssue;
+    if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z)) {
+        issues |= CoordinateIssue;
+    }
+    // 写成 !(在范围内) 的形式，NaN 也算超出范围
+    if (!(point.speed >= limits.minSpeed && point.speed <= limits.maxSpeed)) {
+        issues |= SpeedIssue;
+    }
+    if (point.isGluePoint) {
+        if (!(point.volume >= limits.minVolume && point.volume <= limits.maxVolume)) {
+            issues |= VolumeIssue;
+        }
+        if (point.dwellTime < limits.minDwellTime || point.dwellTime > limits.maxDwellTime) {
+            issues |= DwellTimeIssue;
+        }
+    }
+    return issues;
+}
+
+QString TrajectoryTableModel::issueText(quint8 issues)
+{
+    QStringList texts;
+    if (issues & CoordinateIssue) texts << "坐标无效";
+    if (issues & SpeedIssue) texts << "速度超出范围";
+    if (issues & VolumeIssue) texts << "胶量超出范围";
+    if (issues & DwellTimeIssue) texts << "停留时间超出范围";
+    return texts.join("、");
+}
+
+quint8 TrajectoryTableModel::columnIssue(int column)
+{
+    switch (column) {
+    case XColumn:
+    case YColumn:
+    case ZColumn:
+        return CoordinateIssue;
+    case SpeedColumn:
+        return SpeedIssue;
+    case VolumeColumn:
+        return VolumeIssue;
+    case DwellTimeColumn:
+        return DwellTimeIssue;
+    default:
+        return NoIssue;
+    }
+}
+
+int TrajectoryTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : size();
+}
+
+int TrajectoryTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TrajectoryTableModel::data(const QModelIndex& index, int role) const
+{
+    const int row = index.row();
+    if (!index.isValid() || !m_points || row >= size() || row >= m_points->size()) {
+        return QVariant();
+    }
+    const Point& point = m_points->at(row);
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        switch (index.column()) {
+        case IndexColumn: return row + 1;
+        case XColumn: return QString::number(point.x, 'f', 3);
+        case YColumn: return QString::number(point.y, 'f', 3);
+        case ZColumn: return QString::number(point.z, 'f', 3);
+        case SpeedColumn: return QString::number(point.speed, 'f', 2);
+        case VolumeColumn: return QString::number(point.volume, 'f', 3);
+        case DwellTimeColumn: return QString::number(point.dwellTime);
+        case GluePointColumn: return point.isGluePoint ? QStringLiteral("是") : QStringLiteral("否");
+        default: return QVariant();
+        }
+    case Qt::BackgroundRole:
+        if (m_issues[row] & columnIssue(index.column())) {
+            return QBrush(QColor(255, 205, 205));
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (m_issues[row] != NoIssue) {
+            return issueText(m_issues[row]);
+        }
+        return QVariant();
+    case Qt::TextAlignmentRole:
+        if (index.column() != GluePointColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return int(Qt::AlignCenter);
+    default:
+        return QVariant();
+    }
+}
+
+bool TrajectoryTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (role != Qt::EditRole || !index.isValid() || !m_points || index.row() >= size()) {
+        return false;
+    }
+
+    Point point = m_points->at(index.row());
+    bool ok = true;
+    switch (index.column()) {
+    case XColumn: point.x = value.toDouble(&ok); break;
+    case YColumn: point.y = value.toDouble(&ok); break;
+    case ZColumn: point.z = value.toDouble(&ok); break;
+    case SpeedColumn: point.speed = value.toDouble(&ok); break;
+    case VolumeColumn: point.volume = value.toDouble(&ok); break;
+    case DwellTimeColumn: point.dwellTime = value.toInt(&ok); break;
+    case GluePointColumn:
+        if (value.typeId() == QMetaType::QString) {
+            const QString text = value.toString().trimmed();
+            ok = text == "是" || text == "否";
+            point.isGluePoint = text == "是";
+        } else {
+            point.isGluePoint = value.toBool();
+        }
+        break;
+    default:
+        return false;
+    }
+    if (!ok) {
+        return false;
+    }
+    return setPoint(index.row(), point);
+}
+
+QVariant TrajectoryTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case IndexColumn: return "序号";
+    case XColumn: return "X坐标";
+    case YColumn: return "Y坐标";
+    case ZColumn: return "Z坐标";
+    case SpeedColumn: return "速度";
+    case VolumeColumn: return "胶量";
+    case DwellTimeColumn: return "停留时间";
+    case GluePointColumn: return "点胶";
+    default: return QVariant();
+    }
+}
+
+Qt::ItemFlags TrajectoryTableModel::flags(const QModelIndex& index) const
+{
+    Qt::ItemFlags flags = QAbstractTableModel::flags(index);
+    if (index.isValid() && index.column() != IndexColumn) {
+        flags |= Qt::ItemIsEditable;
+    }
+    return flags;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <vector>
+#include "parameterwidget.h"
+#include "../utils/pathindex.h"
+
+// 轨迹点的逐点校验范围（由参数页的验证规则转换而来）
+struct TrajectoryPointLimits {
+    double minSpeed = 0.1;
+    double maxSpeed = 1000.0;
+    double minVolume = 0.001;       // 只对点胶点校验
+    double maxVolume = 1000.0;
+    int minDwellTime = 1;           // 只对点胶点校验
+    int maxDwellTime = 10000;
+};
+
+// 轨迹统计，随修改增量维护
+struct TrajectoryStats {
+    int pointCount = 0;
+    int invalidCount = 0;           // 有校验问题的点数
+    double distance = 0;            // mm
+    double time = 0;                // s，移动时间加点胶点停留时间
+    double volume = 0;              // μL，点胶点胶量之和
+};
+
+// 轨迹编辑的表格模型（参数页）
+//
+// 模型不拥有数据，直接读写 setTrajectory() 关联的连续数组（当前程序的轨迹），表格视图只为可见行取数据，
+// 十万级的点不会创建任何单元格对象。每个点的校验结果按一个字节缓存，统计值按受影响的线段增减，
+// 修改一个点只重新校验这个点、重算与它相连的两段；插入和删除只处理插入删除的位置。
+// 同时维护轨迹的 XY 包围盒层次（PathIndex），供路径预览点选和框选。
+// 通过模型以外的途径整体修改轨迹后必须调用 resetTrajectory()。
+class TrajectoryTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    using Point = GlueProgram::TrajectoryPoint;
+    using Points = QList<GlueProgram::TrajectoryPoint>;
+
+    enum Column {
+        IndexColumn = 0,
+        XColumn,
+        YColumn,
+        ZColumn,
+        SpeedColumn,
+        VolumeColumn,
+        DwellTimeColumn,
+        GluePointColumn,
+        ColumnCount
+    };
+
+    // 校验问题，按位组合
+    enum Issue : quint8 {
+        NoIssue = 0x00,
+        CoordinateIssue = 0x01,     // 坐标不是有限数
+        SpeedIssue = 0x02,
+        VolumeIssue = 0x04,
+        DwellTimeIssue = 0x08
+    };
+
+    explicit TrajectoryTableModel(QObject* parent = nullptr);
+
+    // 关联轨迹数组并全量重算；points 的生命周期必须长于模型或在之前改为关联其他数组
+    void setTrajectory(Points* points);
+    void resetTrajectory();
+    const Points* trajectory() const;
+
+    // 修改范围后全量重新校验
+    void setLimits(const TrajectoryPointLimits& limits);
+    const TrajectoryPointLimits& limits() const;
+
+    // 以下修改都会发出 trajectoryEdited()
+    void insertPoints(int row, const Points& points);
+    void appendPoint(const Point& point);
+    void removePoints(int row, int count);
+    bool setPoint(int row, const Point& point);
+
+    const TrajectoryStats& stats() const;
+    quint8 issuesAt(int row) const;
+    // 从 fromRow 开始第一个有校验问题的行，没有时返回 -1
+    int firstInvalidRow(int fromRow = 0) const;
+
+    const PathIndex& spatialIndex() const;
+
+    static quint8 checkPoint(const Point& point, const TrajectoryPointLimits& limits);
+    static QString issueText(quint8 issues);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+signals:
+    // 通过模型修改轨迹之后发出（不含 setTrajectory / resetTrajectory）
+    void trajectoryEdited();
+
+private:
+    int size() const;
+    void recalculate();
+    void revalidate(int first, int last);
+    // 点 i 带来的统计量：线段 (i-1, i) 的距离和时间，以及点 i 的胶量
+    void addContributions(int first, int last, double sign);
+    static quint8 columnIssue(int column);
+
+    Points* m_points;
+    std::vector<quint8> m_issues;           // 每个点一项，长度即表格行数
+    TrajectoryStats m_stats;
+    TrajectoryPointLimits m_limits;
+    PathIndex m_index;
+};
@@ -1,18 +1,37 @@
 #include "uiupdateoptimizer.h"
 #include "../data/datacachemanager.h"
 #include "../logger/logmanager.h"
+#include "../utils/monotonicclock.h"
+#include "../utils/tracer.h"
+#include "../utils/allocationtracker.h"
+#include "../utils/framelatency.h"
+#include "../utils/workloadprofile.h"
+#include "../constants.h"
 #include <QApplication>
+#include <QScreen>
 #include <QDebug>
 #include <QJsonObject>
 #include <QRegularExpression>
 #include <QProcess>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 UIUpdateOptimizer::UIUpdateOptimizer(QObject* parent)
     : QObject(parent)
+    , m_nextSequence(0)
     , m_maxBatchSize(10)
     , m_maxQueueSize(100)
     , m_paused(false)
+    , m_configUpdateInterval(-1)
+    , m_vsyncPeriodNs(0)
+    , m_flushPeriodNs(0)
+    , m_frameDivider(1)
+    , m_frameBudgetNs(0)
+    , m_customFrameBudget(false)
+    , m_nextReadyNs(std::numeric_limits<qint64>::max())
+    , m_scheduledFrameNs(0)
+    , m_frameCount(0)
     , m_targetFPS(60)
     , m_currentFPS(0)
     , m_adaptiveMode(true)
@@ -30,8 +49,9 @@ UIUpdateOptimizer::UIUpdateOptimizer(QObject* parent)
     connect(m_optimizationTimer, &QTimer::timeout, this, &UIUpdateOptimizer::onOptimizationTimer);
     connect(m_adaptiveTimer, &QTimer::timeout, this, &UIUpdateOptimizer::onAdaptiveTuning);
     
-    // 设置定时器间隔
-    m_updateTimer->setInterval(16); // 60 FPS
+    // 设置定时器间隔；更新定时器按帧单次触发，见 scheduleNextFrame()
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setTimerType(Qt::PreciseTimer);
     m_performanceTimer->setInterval(1000); // 1秒更新性能统计
     m_optimizationTimer->setInterval(5000); // 5秒优化一次
     m_adaptiveTimer->setInterval(2000); // 2秒自适应调整
@@ -72,6 +92,9 @@ UIUpdateOptimizer::UIUpdateOptimizer(QObject* parent)
     m_metrics.updatesPerSecond = 0;
     m_metrics.droppedUpdates = 0;
     m_metrics.coalescedUpdates = 0;
+    m_metrics.deferredUpdates = 0;
+    m_metrics.overBudgetFrames = 0;
+    m_metrics.lastFrameWorkMs = 0.0;
     m_metrics.cpuUsage = 0.0;
     m_metrics.memoryUsage = 0;
     m_metrics.lastUpdate = QDateTime::currentDateTime();
@@ -89,8 +112,14 @@ UIUpdateOptimizer::UIUpdateOptimizer(QObject* parent)
     m_optimizationConfig.memoryThreshold = 1024 * 1024 * 1024; // 1GB
     m_optimizationConfig.adaptiveWindowSize = 100;
     
+    // 按主屏幕刷新率对齐刷新
+    QScreen* screen = QGuiApplication::primaryScreen();
+    setRefreshRate(screen ? screen->refreshRate() : System::UI_DEFAULT_REFRESH_RATE);
+    if (screen) {
+        connect(screen, &QScreen::refreshRateChanged, this, &UIUpdateOptimizer::setRefreshRate);
+    }
+    
     // 启动定时器
-    m_updateTimer->start();
     m_performanceTimer->start();
     m_optimizationTimer->start();
     m_adaptiveTimer->start();
@@ -128,58 +157,239 @@ UIUpdateOptimizer::~UIUpdateOptimizer()
 }
 
 void UIUpdateOptimizer::requestUpdate(const UIUpdateTask& task)
+{
+    requestUpdate(UIUpdateTask(task));
+}
+
+void UIUpdateOptimizer::requestUpdate(UIUpdateTask&& task)
 {
     if (!m_enabledTypes.value(task.type, true)) {
         return;
     }
     
-    QMutexLocker locker(&m_queueMutex);
+    if (task.timestampNs == 0) {
+        task.timestampNs = MonotonicClock::nowNs();
+    }
     
-    // 检查是否应该跳过更新
-    if (shouldSkipUpdate(task)) {
+    // 立即更新不进入队列，同一控件尚未执行的更新作废
+    if (task.immediate) {
+        {
+            QMutexLocker locker(&m_queueMutex);
+            const UIUpdateKey key = task.key();
+            m_pendingUpdates.remove(key);
+            m_lastUpdates[key] = ExecutedUpdate{task.timestampNs, task.data};
+        }
+        
+        // 回调在界面线程执行，且不持有队列锁，回调中可以再次提交更新
+        if (QThread::currentThread() == thread()) {
+            executeUpdate(task);
+        } else {
+            QMetaObject::invokeMethod(this, [this, task = std::move(task)]() {
+                executeUpdate(task);
+            }, Qt::QueuedConnection);
+        }
         return;
     }
     
-    // 检查队列大小
-    if (m_updateQueue.size() >= m_maxQueueSize) {
-        // 移除最旧的低优先级任务
-        for (int i = 0; i < m_updateQueue.size(); ++i) {
-            if (m_updateQueue[i].priority < task.priority) {
-                m_updateQueue.removeAt(i);
-                break;
+    bool earlier = false;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        earlier = enqueueUpdate(std::move(task));
+    }
+    if (earlier) {
+        requestFrame();
+    }
+}
+
+void UIUpdateOptimizer::requestImmediateUpdate(const UIUpdateTask& task)
+{
+    UIUpdateTask immediateTask = task;
+    immediateTask.immediate = true;
+    requestUpdate(std::move(immediateTask));
+}
+
+void UIUpdateOptimizer::requestBatchUpdate(const QList<UIUpdateTask>& tasks)
+{
+    const qint64 now = MonotonicClock::nowNs();
+    bool earlier = false;
+    
+    {
+        QMutexLocker locker(&m_queueMutex);
+        
+        for (const UIUpdateTask& task : tasks) {
+            if (!m_enabledTypes.value(task.type, true)) {
+                continue;
+            }
+            UIUpdateTask queued = task;
+            queued.immediate = false;
+            if (queued.timestampNs == 0) {
+                queued.timestampNs = now;
             }
+            earlier = enqueueUpdate(std::move(queued)) || earlier;
         }
     }
     
-    // 如果是立即更新
-    if (task.immediate) {
-        executeUpdate(task);
+    if (earlier) {
+        requestFrame();
+    }
+}
+
+bool UIUpdateOptimizer::enqueueUpdate(UIUpdateTask&& task)
+{
+    const UIUpdateKey key = task.key();
+    auto pending = m_pendingUpdates.find(key);
+    
+    if (pending != m_pendingUpdates.end()) {
+        // 后到的覆盖先到的，截止时间保持第一次提交时的；优先级不变时原来的堆节点仍然有效
+        m_metrics.coalescedUpdates++;
+        const bool priorityChanged = pending->task.priority != task.priority;
+        pending->task = std::move(task);
+        if (priorityChanged) {
+            pending->sequence = m_nextSequence++;
+            pushHeap(key, pending->task.priority, pending->deadlineNs, pending->sequence);
+        }
+        return false;
+    }
+    
+    if (shouldSkipUpdate(task)) {
+        m_metrics.coalescedUpdates++;
+        return false;
+    }
+    
+    // 队列满时丢弃优先级最低的一个；只有不同控件的数量超过上限时才会走到这里
+    if (m_pendingUpdates.size() >= m_maxQueueSize) {
+        auto lowest = m_pendingUpdates.end();
+        for (auto it = m_pendingUpdates.begin(); it != m_pendingUpdates.end(); ++it) {
+            if (lowest == m_pendingUpdates.end() || it->task.priority < lowest->task.priority) {
+                lowest = it;
+            }
+        }
+        m_metrics.droppedUpdates++;
+        if (lowest == m_pendingUpdates.end() || lowest->task.priority >= task.priority) {
+            return false;
+        }
+        m_pendingUpdates.erase(lowest);
+    }
+    
+    const quint64 sequence = m_nextSequence++;
+    const int priority = task.priority;
+    const qint64 deadline = deadlineNs(task);
+    const qint64 readyTime = readyTimeNs(task);
+    m_pendingUpdates.insert(key, PendingUpdate{std::move(task), sequence, deadline});
+    pushHeap(key, priority, deadline, sequence);
+    
+    // 比已安排的刷新更早可以执行时需要重新安排
+    if (readyTime < m_nextReadyNs) {
+        m_nextReadyNs = readyTime;
+        return true;
+    }
+    return false;
+}
+
+void UIUpdateOptimizer::requeueDeferred(UIUpdateTask&& task)
+{
+    // 推迟期间又有新的提交时，旧的直接作废
+    const UIUpdateKey key = task.key();
+    if (m_pendingUpdates.contains(key)) {
+        m_metrics.coalescedUpdates++;
         return;
     }
     
-    // 添加到队列
-    m_updateQueue.append(task);
+    // 保留原来的截止时间，下一帧排在同优先级新提交的更新之前
+    const quint64 sequence = m_nextSequence++;
+    const int priority = task.priority;
+    const qint64 deadline = deadlineNs(task);
+    m_pendingUpdates.insert(key, PendingUpdate{std::move(task), sequence, deadline});
+    pushHeap(key, priority, deadline, sequence);
+    m_nextReadyNs = 0;
+}
+
+qint64 UIUpdateOptimizer::readyTimeNs(const UIUpdateTask& task) const
+{
+    // 更新间隔从同一控件上一次执行算起，等待期间到达的更新只保留最新的一次
+    const int interval = m_updateIntervals.value(task.type, 100);
+    if (interval <= 0) {
+        return 0;
+    }
+    auto last = m_lastUpdates.constFind(task.key());
+    return last == m_lastUpdates.constEnd() ? 0 : last->timestampNs + qint64(interval) * 1000000;
+}
+
+qint64 UIUpdateOptimizer::deadlineNs(const UIUpdateTask& task) const
+{
+    return task.timestampNs + qint64(qMax(0, m_updateIntervals.value(task.type, 100))) * 1000000;
+}
+
+void UIUpdateOptimizer::pushHeap(const UIUpdateKey& key, int priority, qint64 deadline, quint64 sequence)
+{
+    m_priorityHeap.push_back(HeapEntry{priority, deadline, sequence, key});
+    std::push_heap(m_priorityHeap.begin(), m_priorityHeap.end());
     
-    // 记录最后更新
-    QString key = QString("%1_%2").arg(static_cast<int>(task.type)).arg(task.widgetId);
-    m_lastUpdates[key] = task;
+    // 失效节点过多时重建，均摊 O(1)
+    if (m_priorityHeap.size() > 2 * static_cast<size_t>(m_pendingUpdates.size()) + 64) {
+        compactHeap();
+    }
 }
 
-void UIUpdateOptimizer::requestImmediateUpdate(const UIUpdateTask& task)
+void UIUpdateOptimizer::compactHeap()
 {
-    UIUpdateTask immediateTask = task;
-    immediateTask.immediate = true;
-    requestUpdate(immediateTask);
+    m_priorityHeap.clear();
+    m_priorityHeap.reserve(static_cast<size_t>(m_pendingUpdates.size()));
+    for (auto it = m_pendingUpdates.cbegin(); it != m_pendingUpdates.cend(); ++it) {
+        m_priorityHeap.push_back(HeapEntry{it->task.priority, it->deadlineNs, it->sequence, it.key()});
+    }
+    std::make_heap(m_priorityHeap.begin(), m_priorityHeap.end());
 }
 
-void UIUpdateOptimizer::requestBatchUpdate(const QList<UIUpdateTask>& tasks)
+void UIUpdateOptimizer::requestFrame()
 {
-    QMutexLocker locker(&m_queueMutex);
+    if (QThread::currentThread() == thread()) {
+        scheduleNextFrame();
+    } else {
+        QMetaObject::invokeMethod(this, &UIUpdateOptimizer::scheduleNextFrame, Qt::QueuedConnection);
+    }
+}
+
+void UIUpdateOptimizer::scheduleNextFrame()
+{
+    if (m_paused) {
+        return;
+    }
     
-    for (const UIUpdateTask& task : tasks) {
-        if (m_enabledTypes.value(task.type, true)) {
-            m_updateQueue.append(task);
-        }
+    qint64 readyTime;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        readyTime = m_nextReadyNs;
+    }
+    if (readyTime == std::numeric_limits<qint64>::max()) {
+        return;
+    }
+    
+    // 取 readyTime 之后的第一个刷新周期边界
+    const qint64 now = MonotonicClock::nowNs();
+    const qint64 target = qMax(now, readyTime);
+    const qint64 frame = (target / m_flushPeriodNs + 1) * m_flushPeriodNs;
+    if (m_updateTimer->isActive() && m_scheduledFrameNs <= frame) {
+        return;
+    }
+    
+    m_scheduledFrameNs = frame;
+    m_updateTimer->start(static_cast<int>((frame - now + 999999) / 1000000));
+}
+
+qint64 UIUpdateOptimizer::estimatedCostNs(UIUpdateType type) const
+{
+    return m_callbackCostNs.value(type, 0);
+}
+
+void UIUpdateOptimizer::recordCallbackCost(UIUpdateType type, qint64 ns)
+{
+    // 指数滑动平均，权重 1/8
+    auto it = m_callbackCostNs.find(type);
+    if (it == m_callbackCostNs.end()) {
+        m_callbackCostNs.insert(type, ns);
+    } else {
+        it.value() += (ns - it.value()) / 8;
     }
 }
 
@@ -196,6 +406,27 @@ void UIUpdateOptimizer::setUpdateInterval(UIUpdateType type, int intervalMs)
     );
 }
 
+int UIUpdateOptimizer::getUpdateInterval(UIUpdateType type) const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_updateIntervals.value(type, 0);
+}
+
+void UIUpdateOptimizer::attachConfigSnapshots(ConfigSnapshotPublisher* publisher)
+{
+    m_configReader.attach(publisher);
+    m_configUpdateInterval = -1;
+}
+
+void UIUpdateOptimizer::applyConfigSnapshot()
+{
+    const int interval = m_configReader->intValue(System::CONFIG_UI_UPDATE_INTERVAL, -1);
+    if (interval > 0 && interval != m_configUpdateInterval) {
+        m_configUpdateInterval = interval;
+        setUpdateInterval(UIUpdateType::StatusBar, interval);
+    }
+}
+
 void UIUpdateOptimizer::setRenderStrategy(UIUpdateType type, RenderStrategy strategy)
 {
     QMutexLocker locker(&m_queueMutex);
@@ -225,15 +456,56 @@ void UIUpdateOptimizer::setOptimizationConfig(const ::OptimizationConfig& config
 {
     m_optimizationConfig = config;
     
-    // 根据配置调整定时器间隔
-    if (config.enableFrameRateLimit) {
-        int targetInterval = 1000 / config.maxUpdatesPerSecond;
-        m_updateTimer->setInterval(targetInterval);
-    }
+    // 根据配置调整刷新间隔
+    updateFramePeriod();
     
     LogManager::getInstance()->info("优化配置已更新", "UIUpdateOptimizer");
 }
 
+void UIUpdateOptimizer::setRefreshRate(double hz)
+{
+    if (hz <= 0) {
+        hz = System::UI_DEFAULT_REFRESH_RATE;
+    }
+    m_vsyncPeriodNs = static_cast<qint64>(1e9 / hz);
+    m_metrics.refreshRate = hz;
+    m_targetFPS = qRound(hz);
+    updateFramePeriod();
+    
+    LogManager::getInstance()->debug(QString("屏幕刷新率: %1 Hz").arg(hz, 0, 'f', 1), "UIUpdateOptimizer");
+}
+
+void UIUpdateOptimizer::setFrameBudget(double ms)
+{
+    m_customFrameBudget = ms > 0;
+    if (m_customFrameBudget) {
+        m_frameBudgetNs = static_cast<qint64>(ms * 1e6);
+    }
+    updateFramePeriod();
+}
+
+double UIUpdateOptimizer::frameBudget() const
+{
+    return m_frameBudgetNs / 1e6;
+}
+
+void UIUpdateOptimizer::updateFramePeriod()
+{
+    // 限制更新速率时取刷新周期的整数倍，保证每次刷新都落在显示帧上
+    int divider = m_frameDivider;
+    if (m_optimizationConfig.enableFrameRateLimit && m_optimizationConfig.maxUpdatesPerSecond > 0) {
+        const double refreshRate = 1e9 / m_vsyncPeriodNs;
+        divider = qMax(divider, static_cast<int>(std::ceil(refreshRate / m_optimizationConfig.maxUpdatesPerSecond)));
+    }
+    m_flushPeriodNs = m_vsyncPeriodNs * divider;
+    m_targetFPS = qMax(1, static_cast<int>(1e9 / m_flushPeriodNs));
+    
+    if (!m_customFrameBudget) {
+        m_frameBudgetNs = m_vsyncPeriodNs * System::UI_FRAME_BUDGET_PERCENT / 100;
+    }
+    m_metrics.frameBudgetMs = m_frameBudgetNs / 1e6;
+}
+
 void UIUpdateOptimizer::setMaxBatchSize(int maxSize)
 {
     m_maxBatchSize = maxSize;
@@ -244,6 +516,14 @@ void UIUpdateOptimizer::setMaxQueueSize(int maxSize)
     m_maxQueueSize = maxSize;
 }
 
+void UIUpdateOptimizer::applyWorkloadProfile(const WorkloadProfile& profile)
+{
+    setUpdateInterval(UIUpdateType::RealTimeData, profile.uiRealTimeIntervalMs);
+    setUpdateInterval(UIUpdateType::ChartData, profile.uiChartIntervalMs);
+    setUpdateInterval(UIUpdateType::StatusBar, profile.uiStatusIntervalMs);
+    setMaxBatchSize(profile.uiMaxBatchSize);
+}
+
 void UIUpdateOptimizer::enableUpdateType(UIUpdateType type, bool enabled)
 {
     m_enabledTypes[type] = enabled;
@@ -259,28 +539,33 @@ void UIUpdateOptimizer::pauseUpdates()
 void UIUpdateOptimizer::resumeUpdates()
 {
     m_paused = false;
-    m_updateTimer->start();
+    requestFrame();
     LogManager::getInstance()->info("UI更新已恢复", "UIUpdateOptimizer");
 }
 
 void UIUpdateOptimizer::clearPendingUpdates()
 {
     QMutexLocker locker(&m_queueMutex);
-    m_updateQueue.clear();
+    m_pendingUpdates.clear();
+    m_priorityHeap.clear();
     m_lastUpdates.clear();
+    m_nextReadyNs = std::numeric_limits<qint64>::max();
     LogManager::getInstance()->info("已清空待处理的UI更新", "UIUpdateOptimizer");
 }
 
 void UIUpdateOptimizer::optimizeUpdateFrequency()
 {
-    // 根据性能指标调整更新频率
-    if (m_metrics.averageUpdateTime > 16.0) { // 超过16ms（60FPS）
+    // 根据每帧回调的平均耗时调整刷新间隔（刷新周期的倍数）
+    const double vsyncMs = m_vsyncPeriodNs / 1e6;
+    if (m_metrics.averageUpdateTime > vsyncMs && m_frameDivider < System::UI_MAX_FRAME_DIVIDER) {
         // 降低更新频率
-        m_updateTimer->setInterval(qMax(32, m_updateTimer->interval() * 2));
+        m_frameDivider *= 2;
+        updateFramePeriod();
         LogManager::getInstance()->warning("UI更新频率过高，已自动降低", "UIUpdateOptimizer");
-    } else if (m_metrics.averageUpdateTime < 8.0) { // 小于8ms
+    } else if (m_metrics.averageUpdateTime < vsyncMs / 2 && m_frameDivider > 1) {
         // 提高更新频率
-        m_updateTimer->setInterval(qMax(16, m_updateTimer->interval() / 2));
+        m_frameDivider /= 2;
+        updateFramePeriod();
     }
 }
 
@@ -418,7 +703,7 @@ int UIUpdateOptimizer::calculateAdaptiveInterval(UIUpdateType type)
 int UIUpdateOptimizer::getPendingUpdateCount() const
 {
     QMutexLocker locker(&m_queueMutex);
-    return m_updateQueue.size();
+    return m_pendingUpdates.size();
 }
 
 double UIUpdateOptimizer::getAverageUpdateTime() const
@@ -434,18 +719,21 @@ int UIUpdateOptimizer::getUpdateRate() const
 void UIUpdateOptimizer::registerUpdateCallback(UIUpdateType type, const QString& widgetId, 
                                              std::function<void(const QVariant&)> callback)
 {
-    QString key = QString("%1_%2").arg(static_cast<int>(type)).arg(widgetId);
-    m_updateCallbacks[key] = callback;
+    m_updateCallbacks[UIUpdateKey{type, widgetId}] = std::move(callback);
 }
 
 void UIUpdateOptimizer::unregisterUpdateCallback(UIUpdateType type, const QString& widgetId)
 {
-    QString key = QString("%1_%2").arg(static_cast<int>(type)).arg(widgetId);
-    m_updateCallbacks.remove(key);
+    m_updateCallbacks.remove(UIUpdateKey{type, widgetId});
 }
 
 void UIUpdateOptimizer::processUpdates()
 {
+    // 帧开始是应用新配置的安全点
+    if (m_configReader.refresh()) {
+        applyConfigSnapshot();
+    }
+    
     if (m_paused) {
         return;
     }
@@ -453,37 +741,62 @@ void UIUpdateOptimizer::processUpdates()
     QElapsedTimer timer;
     timer.start();
     
-    QMutexLocker locker(&m_queueMutex);
-    
-    if (m_updateQueue.isEmpty()) {
-        return;
+    // 取出本帧的更新后释放锁再执行回调
+    QList<UIUpdateTask> batch;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        if (m_pendingUpdates.isEmpty()) {
+            return;
+        }
+        batch = takeReadyUpdates();
+    }
+    TRACE_SCOPE("ui", "UIUpdateOptimizer::processUpdates");
+    ALLOCATION_SCOPE("ui.processUpdates");
+    TRACE_COUNTER("ui", "uiBatchSize", batch.size());
+    
+    // 实际耗时超出预算时，剩下的推迟到下一帧
+    int executed = 0;
+    for (; executed < batch.size(); ++executed) {
+        const UIUpdateTask& task = batch[executed];
+        if (executed > 0 && timer.nsecsElapsed() + estimatedCostNs(task.type) > m_frameBudgetNs) {
+            break;
+        }
+        
+        QElapsedTimer callbackTimer;
+        callbackTimer.start();
+        executeUpdate(task);
+        recordCallbackCost(task.type, callbackTimer.nsecsElapsed());
     }
     
-    // 按优先级排序
-    std::sort(m_updateQueue.begin(), m_updateQueue.end(), 
-              [](const UIUpdateTask& a, const UIUpdateTask& b) {
-                  return a.priority > b.priority;
-              });
-    
-    // 批处理更新
-    processBatchUpdates();
+    const qint64 workNs = timer.nsecsElapsed();
+    const qint64 finishedNs = MonotonicClock::nowNs();
+    {
+        QMutexLocker locker(&m_queueMutex);
+        for (int i = 0; i < executed; ++i) {
+            m_lastUpdates[batch[i].key()] = ExecutedUpdate{finishedNs, batch[i].data};
+        }
+        for (int i = executed; i < batch.size(); ++i) {
+            m_metrics.deferredUpdates++;
+            requeueDeferred(std::move(batch[i]));
+        }
+    }
+    batch.erase(batch.begin() + executed, batch.end());
     
-    // 更新性能统计
-    qint64 updateTime = timer.elapsed();
-    m_metrics.totalUpdateTime += updateTime;
-    m_metrics.totalUpdates++;
-    m_metrics.averageUpdateTime = static_cast<double>(m_metrics.totalUpdateTime) / m_metrics.totalUpdates;
+    if (!batch.isEmpty()) {
+        emit batchUpdateRequired(batch);
+    }
     
-    // 帧率限制
-    if (m_optimizationConfig.enableFrameRateLimit) {
-        qint64 frameTime = m_frameTimer.elapsed();
-        if (frameTime < (1000 / m_targetFPS)) {
-            return; // 跳过此帧
-        }
-        m_frameTimer.restart();
+    // 更新性能统计（averageUpdateTime 为每帧回调的平均耗时，毫秒）
+    m_frameCount++;
+    m_metrics.lastFrameWorkMs = workNs / 1e6;
+    if (workNs > m_frameBudgetNs) {
+        m_metrics.overBudgetFrames++;
     }
+    m_metrics.totalUpdateTime += static_cast<int>(workNs / 1000000);
+    m_metrics.totalUpdates++;
+    m_metrics.averageUpdateTime += (m_metrics.lastFrameWorkMs - m_metrics.averageUpdateTime) / 16;
     
-    // 处理完成（updatesProcessed信号已移除）
+    scheduleNextFrame();
 }
 
 void UIUpdateOptimizer::onPerformanceTimer()
@@ -548,7 +861,8 @@ void UIUpdateOptimizer::checkSystemLoad()
     // 检查CPU和内存使用情况
     if (m_metrics.cpuUsage > m_optimizationConfig.cpuThreshold) {
         // 降低更新频率
-        m_updateTimer->setInterval(qMin(static_cast<int>(m_updateTimer->interval() * 1.5), 100));
+        m_frameDivider = qMin(m_frameDivider * 2, System::UI_MAX_FRAME_DIVIDER);
+        updateFramePeriod();
         LogManager::getInstance()->warning("系统CPU使用率过高，已降低UI更新频率", "UIUpdateOptimizer");
     }
     
@@ -563,81 +877,90 @@ void UIUpdateOptimizer::clearLowPriorityUpdates()
 {
     QMutexLocker locker(&m_queueMutex);
     
-    // 移除优先级低于30的更新
-    m_updateQueue.erase(
-        std::remove_if(m_updateQueue.begin(), m_updateQueue.end(),
-                      [](const UIUpdateTask& task) {
-                          return task.priority < 30;
-                      }),
-        m_updateQueue.end()
-    );
-}
-
-QList<UIUpdateTask> UIUpdateOptimizer::coalesceUpdates(const QList<UIUpdateTask>& tasks)
-{
-    QHash<QString, UIUpdateTask> coalescedMap;
-    
-    for (const UIUpdateTask& task : tasks) {
-        QString key = QString("%1_%2").arg(static_cast<int>(task.type)).arg(task.widgetId);
-        
-        // 如果已存在相同类型和ID的任务，保留最新的
-        if (!coalescedMap.contains(key) || task.timestamp > coalescedMap[key].timestamp) {
-            coalescedMap[key] = task;
+    // 移除优先级低于30的更新，堆中对应的节点出堆时丢弃
+    for (auto it = m_pendingUpdates.begin(); it != m_pendingUpdates.end();) {
+        if (it->task.priority < 30) {
+            it = m_pendingUpdates.erase(it);
+        } else {
+            ++it;
         }
     }
-    
-    return coalescedMap.values();
 }
 
-void UIUpdateOptimizer::processBatchUpdates()
+QList<UIUpdateTask> UIUpdateOptimizer::takeReadyUpdates()
 {
-    QList<UIUpdateTask> currentBatch;
-    QDateTime now = QDateTime::currentDateTime();
-    
-    // 选择要处理的更新
-    for (int i = 0; i < m_updateQueue.size() && currentBatch.size() < m_maxBatchSize; ++i) {
-        const UIUpdateTask& task = m_updateQueue[i];
+    const qint64 now = MonotonicClock::nowNs();
+    QList<UIUpdateTask> batch;
+    std::vector<HeapEntry> notReady;
+    qint64 nextReady = std::numeric_limits<qint64>::max();
+    qint64 estimated = 0;
+    
+    // 按优先级和截止时间出堆，还没到更新间隔的先放在一边；按估算耗时装满本帧预算为止
+    while (!m_priorityHeap.empty()) {
+        if (batch.size() >= m_maxBatchSize) {
+            nextReady = 0;
+            break;
+        }
         
-        // 检查更新间隔
-        int interval = m_updateIntervals.value(task.type, 100);
-        if (interval > 0 && task.timestamp.msecsTo(now) < interval) {
-            continue; // 还没到更新时间
+        std::pop_heap(m_priorityHeap.begin(), m_priorityHeap.end());
+        HeapEntry entry = std::move(m_priorityHeap.back());
+        m_priorityHeap.pop_back();
+        
+        auto pending = m_pendingUpdates.find(entry.key);
+        if (pending == m_pendingUpdates.end() || pending->sequence != entry.sequence) {
+            continue; // 已被覆盖或移除
+        }
+        const qint64 readyTime = readyTimeNs(pending->task);
+        if (readyTime > now) {
+            nextReady = qMin(nextReady, readyTime);
+            notReady.push_back(std::move(entry));
+            continue;
         }
         
-        currentBatch.append(task);
-    }
-    
-    // 移除已处理的任务
-    for (const UIUpdateTask& task : currentBatch) {
-        m_updateQueue.removeOne(task);
+        // 至少执行一个，否则耗时超过预算的回调永远没有机会执行
+        const qint64 cost = estimatedCostNs(pending->task.type);
+        if (!batch.isEmpty() && estimated + cost > m_frameBudgetNs) {
+            m_priorityHeap.push_back(std::move(entry));
+            std::push_heap(m_priorityHeap.begin(), m_priorityHeap.end());
+            m_metrics.deferredUpdates++;
+            nextReady = 0;
+            break;
+        }
+        
+        estimated += cost;
+        batch.append(std::move(pending->task));
+        m_pendingUpdates.erase(pending);
     }
     
-    // 合并相同类型的更新
-    mergeUpdates(currentBatch);
-    
-    // 执行更新
-    for (const UIUpdateTask& task : currentBatch) {
-        executeUpdate(task);
+    for (HeapEntry& entry : notReady) {
+        m_priorityHeap.push_back(std::move(entry));
+        std::push_heap(m_priorityHeap.begin(), m_priorityHeap.end());
     }
     
-    // 发送批处理信号
-    if (!currentBatch.isEmpty()) {
-        emit batchUpdateRequired(currentBatch);
-    }
+    m_nextReadyNs = m_pendingUpdates.isEmpty() ? std::numeric_limits<qint64>::max() : nextReady;
+    return batch;
 }
 
 void UIUpdateOptimizer::executeUpdate(const UIUpdateTask& task)
 {
-    // 查找回调函数
-    QString key = QString("%1_%2").arg(static_cast<int>(task.type)).arg(task.widgetId);
-    auto it = m_updateCallbacks.find(key);
-    
-    if (it != m_updateCallbacks.end()) {
-        // 执行回调
-        it.value()(task.data);
+    if (task.callback) {
+        task.callback();
     } else {
-        // 发送信号
-        emit updateRequired(task);
+        // 查找回调函数
+        auto it = m_updateCallbacks.constFind(task.key());
+        
+        if (it != m_updateCallbacks.constEnd()) {
+            // 执行回调
+            it.value()(task.data);
+        } else {
+            // 发送信号
+            emit updateRequired(task);
+        }
+    }
+    
+    // 携带接收帧数据的更新：提交 → 回调执行完
+    if (task.receivedNs > 0) {
+        FrameLatencyMonitor::getInstance()->recordSince(FrameLatencyStage::UiUpdate, task.timestampNs);
     }
 }
 
@@ -645,37 +968,19 @@ void UIUpdateOptimizer::optimizeQueue()
 {
     QMutexLocker locker(&m_queueMutex);
     
-    QDateTime now = QDateTime::currentDateTime();
-    
-    // 移除过期的低优先级任务
-    m_updateQueue.erase(
-        std::remove_if(m_updateQueue.begin(), m_updateQueue.end(), 
-                      [now](const UIUpdateTask& task) {
-                          return task.priority < 50 && 
-                                 task.timestamp.msecsTo(now) > 5000; // 5秒过期
-                      }),
-        m_updateQueue.end()
-    );
+    const qint64 now = MonotonicClock::nowNs();
+    const qint64 expireNs = 5000LL * 1000000; // 5秒过期
     
-    // 去重：移除重复的更新
-    QHash<QString, int> lastIndices;
-    for (int i = 0; i < m_updateQueue.size(); ++i) {
-        const UIUpdateTask& task = m_updateQueue[i];
-        QString key = QString("%1_%2").arg(static_cast<int>(task.type)).arg(task.widgetId);
-        
-        if (lastIndices.contains(key)) {
-            // 移除之前的任务，保留最新的
-            m_updateQueue.removeAt(lastIndices[key]);
-            // 更新索引
-            for (auto it = lastIndices.begin(); it != lastIndices.end(); ++it) {
-                if (it.value() > lastIndices[key]) {
-                    it.value()--;
-                }
-            }
-            i--; // 调整当前索引
+    // 移除过期的低优先级任务；同一控件的重复更新在提交时已经合并
+    for (auto it = m_pendingUpdates.begin(); it != m_pendingUpdates.end();) {
+        if (it->task.priority < 50 && now - it->task.timestampNs > expireNs) {
+            m_metrics.droppedUpdates++;
+            it = m_pendingUpdates.erase(it);
+        } else {
+            ++it;
         }
-        lastIndices[key] = i;
     }
+    compactHeap();
 }
 
 void UIUpdateOptimizer::updatePerformanceMetrics()
@@ -688,33 +993,19 @@ void UIUpdateOptimizer::updatePerformanceMetrics()
         m_metrics.lastUpdate = now;
     }
     
-    // 计算当前FPS
-    if (m_frameTimer.isValid()) {
-        m_currentFPS = 1000 / qMax(1, static_cast<int>(m_frameTimer.elapsed()));
-    }
+    // 计算当前FPS（统计周期内实际刷新的帧数）
+    m_currentFPS = static_cast<int>(m_frameCount * 1000 / qMax<qint64>(1, m_frameTimer.restart()));
+    m_frameCount = 0;
 }
 
 bool UIUpdateOptimizer::shouldSkipUpdate(const UIUpdateTask& task)
 {
-    QString key = QString("%1_%2").arg(static_cast<int>(task.type)).arg(task.widgetId);
-    
-    // 检查是否有相同的更新
-    if (m_lastUpdates.contains(key)) {
-        const UIUpdateTask& lastTask = m_lastUpdates[key];
-        int interval = m_updateIntervals.value(task.type, 100);
-        
-        // 如果间隔时间未到，跳过更新
-        if (interval > 0 && lastTask.timestamp.msecsTo(task.timestamp) < interval) {
-            return true;
-        }
-        
-        // 如果数据相同，跳过更新
-        if (lastTask.data == task.data) {
-            return true;
-        }
+    // 数据与最近一次执行的相同，不需要再刷新；只带回调、没有数据的更新总是执行
+    if (task.callback || !task.data.isValid()) {
+        return false;
     }
-    
-    return false;
+    auto last = m_lastUpdates.constFind(task.key());
+    return last != m_lastUpdates.constEnd() && last->data == task.data;
 }
 
 bool UIUpdateOptimizer::shouldBatchUpdate(const UIUpdateTask& task)
@@ -727,29 +1018,6 @@ bool UIUpdateOptimizer::shouldBatchUpdate(const UIUpdateTask& task)
     return true;
 }
 
-void UIUpdateOptimizer::mergeUpdates(QList<UIUpdateTask>& tasks)
-{
-    QHash<QString, int> indices;
-    
-    // 找出相同类型和ID的任务
-    for (int i = 0; i < tasks.size(); ++i) {
-        const UIUpdateTask& task = tasks[i];
-        QString key = QString("%1_%2").arg(static_cast<int>(task.type)).arg(task.widgetId);
-        
-        if (indices.contains(key)) {
-            // 合并任务，保留最新的数据
-            int oldIndex = indices[key];
-            if (task.timestamp > tasks[oldIndex].timestamp) {
-                tasks[oldIndex] = task;
-            }
-            tasks.removeAt(i);
-            i--; // 调整索引
-        } else {
-            indices[key] = i;
-        }
-    }
-}
-
 UIPerformanceMetrics UIUpdateOptimizer::getPerformanceMetrics() const
 {
     return m_metrics;
@@ -776,7 +1044,12 @@ QStringList UIUpdateOptimizer::getOptimizationSuggestions() const
         suggestions << "建议启用更新合并功能以减少CPU负载";
     }
     
-    if (m_currentFPS < m_targetFPS * 0.8) {
+    if (m_metrics.deferredUpdates > m_metrics.totalUpdates * 0.1) {
+        suggestions << "较多更新超出帧预算被推迟，建议拆分耗时的回调或降低其优先级";
+    }
+    
+    // 空闲时不刷新，帧率低不代表卡顿
+    if (getPendingUpdateCount() > 0 && m_currentFPS < m_targetFPS * 0.8) {
         suggestions << "建议启用帧率限制或使用延迟渲染策略";
     }
     
@@ -884,6 +1157,14 @@ QVariant UIUpdateOptimizer::getCachedData(const QString& key) const
     return QVariant();
 }
 
+QVariant UIUpdateOptimizer::getCachedData(const QString& key, const std::function<QVariant()>& loader) const
+{
+    if (m_cacheManager) {
+        return m_cacheManager->getOrLoad(key, loader, CacheItemType::UserData);
+    }
+    return loader ? loader() : QVariant();
+}
+
 void UIUpdateOptimizer::setCachedData(const QString& key, const QVariant& data)
 {
     if (m_cacheManager) {
@@ -11,10 +11,13 @@
 #include <QThread>
 #include <QJsonObject>
 #include <functional>
+#include <vector>
+#include "../utils/configsnapshot.h"
 
 // 前向声明
 class DataCacheManager;
 struct CacheStatistics;
+struct WorkloadProfile;
 
 // 缓存配置结构体
 struct CacheConfig {
@@ -37,6 +40,11 @@ struct UIPerformanceMetrics {
     QElapsedTimer performanceTimer;
     QAtomicInt droppedUpdates;
     QAtomicInt coalescedUpdates;
+    QAtomicInt deferredUpdates;     // 超出帧预算、推迟到下一帧的更新
+    QAtomicInt overBudgetFrames;    // 回调总耗时超出预算的帧
+    double refreshRate;             // 屏幕刷新率（Hz）
+    double frameBudgetMs;           // 每帧的回调时间预算
+    double lastFrameWorkMs;         // 最近一帧回调的实际耗时
     double cpuUsage;
     qint64 memoryUsage;
 };
@@ -69,6 +77,22 @@ enum class UIUpdateType {
     Layout
 };
 
+// 待处理更新的键：同一控件的同类更新只保留最新的一次
+struct UIUpdateKey {
+    UIUpdateType type;
+    QString widgetId;
+    
+    bool operator==(const UIUpdateKey& other) const
+    {
+        return type == other.type && widgetId == other.widgetId;
+    }
+};
+
+inline size_t qHash(const UIUpdateKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, static_cast<int>(key.type), key.widgetId);
+}
+
 // 渲染优化策略枚举
 enum class RenderStrategy {
     Immediate,      // 立即渲染
@@ -82,22 +106,25 @@ struct UIUpdateTask {
     UIUpdateType type;
     QString widgetId;
     QVariant data;
-    QDateTime timestamp;
+    qint64 timestampNs;             // 提交时间（单调时钟），由 requestUpdate() 填写
+    qint64 receivedNs;              // 数据来自接收帧时为帧的读取时刻（ProtocolFrame::receivedNs），否则为 0
     int priority;
     bool immediate;
     bool coalescing;                // 是否允许合并
     QThread* sourceThread;          // 源线程
-    std::function<void()> callback; // 回调函数
+    std::function<void()> callback; // 回调函数，设置后代替按类型注册的回调
     
     UIUpdateTask(UIUpdateType t = UIUpdateType::StatusBar, 
                 const QString& id = QString(), 
                 const QVariant& d = QVariant(),
                 int p = 0, 
                 bool imm = false)
-        : type(t), widgetId(id), data(d), timestamp(QDateTime::currentDateTime()), 
+        : type(t), widgetId(id), data(d), timestampNs(0), receivedNs(0),
           priority(p), immediate(imm), coalescing(true), sourceThread(nullptr)
     {}
     
+    UIUpdateKey key() const { return UIUpdateKey{type, widgetId}; }
+    
     bool operator==(const UIUpdateTask& other) const
     {
         return type == other.type && widgetId == other.widgetId && 
@@ -116,17 +143,30 @@ public:
     
     // 更新请求管理
     void requestUpdate(const UIUpdateTask& task);
+    void requestUpdate(UIUpdateTask&& task);
     void requestImmediateUpdate(const UIUpdateTask& task);
     void requestBatchUpdate(const QList<UIUpdateTask>& tasks);
     
     // 配置管理
     void setUpdateInterval(UIUpdateType type, int intervalMs);
+    int getUpdateInterval(UIUpdateType type) const;
     void setRenderStrategy(UIUpdateType type, RenderStrategy strategy);
     void setMaxBatchSize(int maxSize);
     void setMaxQueueSize(int maxSize);
     void enableUpdateType(UIUpdateType type, bool enabled);
     void enableCoalescing(bool enabled);
     void setOptimizationConfig(const ::OptimizationConfig& config);
+    // 工作负载配置档中的实时数据/图表/状态栏更新间隔和批大小
+    void applyWorkloadProfile(const WorkloadProfile& profile);
+    
+    // 接入 AdaptiveConfigManager 的参数快照（界面线程调用，nullptr 断开），每帧开始时应用新版本；
+    // 须在发布器析构前断开
+    void attachConfigSnapshots(ConfigSnapshotPublisher* publisher);
+    
+    // 帧调度：默认按主屏幕刷新率对齐，预算为帧周期的 UI_FRAME_BUDGET_PERCENT；ms <= 0 恢复默认预算
+    void setRefreshRate(double hz);
+    void setFrameBudget(double ms);
+    double frameBudget() const;
     
     // 性能控制
     void pauseUpdates();
@@ -156,6 +196,8 @@ public:
     void clearCache();
     void setCacheSize(qint64 size);
     QVariant getCachedData(const QString& key) const;
+    // 未命中时调用 loader 并缓存结果；多个线程同时未命中同一个键时只调用一次
+    QVariant getCachedData(const QString& key, const std::function<QVariant()>& loader) const;
     void setCachedData(const QString& key, const QVariant& data);
 
 signals:
@@ -168,21 +210,31 @@ signals:
 
 private slots:
     void processUpdates();
+    void scheduleNextFrame();
     void onPerformanceTimer();
     void onOptimizationTimer();
     void onAdaptiveTuning();
 
 private:
-    void processBatchUpdates();
+    QList<UIUpdateTask> takeReadyUpdates();
+    bool enqueueUpdate(UIUpdateTask&& task);
+    void requeueDeferred(UIUpdateTask&& task);
+    qint64 readyTimeNs(const UIUpdateTask& task) const;
+    qint64 deadlineNs(const UIUpdateTask& task) const;
+    void pushHeap(const UIUpdateKey& key, int priority, qint64 deadline, quint64 sequence);
+    void compactHeap();
     void executeUpdate(const UIUpdateTask& task);
+    void requestFrame();
+    void updateFramePeriod();
+    qint64 estimatedCostNs(UIUpdateType type) const;
+    void recordCallbackCost(UIUpdateType type, qint64 ns);
     void optimizeQueue();
     void updatePerformanceMetrics();
+    void applyConfigSnapshot();
     
     // 智能更新策略
     bool shouldSkipUpdate(const UIUpdateTask& task);
     bool shouldBatchUpdate(const UIUpdateTask& task);
-    void mergeUpdates(QList<UIUpdateTask>& tasks);
-    QList<UIUpdateTask> coalesceUpdates(const QList<UIUpdateTask>& tasks);
     void detectPerformanceBottlenecks();
     void updateSystemResourceUsage();
     int calculateAdaptiveInterval(UIUpdateType type);
@@ -197,9 +249,35 @@ private:
     QTimer* m_adaptiveTimer;
     
     // 更新队列
-    QList<UIUpdateTask> m_updateQueue;
-    QList<UIUpdateTask> m_highPriorityQueue;
-    QHash<QString, UIUpdateTask> m_lastUpdates; // 用于去重
+    // 待处理的更新按 (类型, 控件) 存在哈希表中，后到的覆盖先到的；执行顺序由另一个按优先级排列的堆决定。
+    // 覆盖或移除时不去堆里查找，旧的堆节点因序号不匹配在出堆时丢弃，堆过大时按哈希表重建。
+    struct PendingUpdate {
+        UIUpdateTask task;
+        quint64 sequence;
+        qint64 deadlineNs;          // 第一次提交的时间加上该类型的更新间隔，被覆盖时不变
+    };
+    struct HeapEntry {
+        int priority;
+        qint64 deadlineNs;
+        quint64 sequence;
+        UIUpdateKey key;
+        
+        // 优先级高的先出堆，同优先级截止时间早的先出堆
+        bool operator<(const HeapEntry& other) const
+        {
+            if (priority != other.priority) return priority < other.priority;
+            if (deadlineNs != other.deadlineNs) return deadlineNs > other.deadlineNs;
+            return sequence > other.sequence;
+        }
+    };
+    struct ExecutedUpdate {
+        qint64 timestampNs;
+        QVariant data;
+    };
+    QHash<UIUpdateKey, PendingUpdate> m_pendingUpdates;
+    std::vector<HeapEntry> m_priorityHeap;
+    quint64 m_nextSequence;
+    QHash<UIUpdateKey, ExecutedUpdate> m_lastUpdates;  // 最近一次执行，用于限频和去重
     mutable QMutex m_queueMutex;
     
     // 配置参数
@@ -211,17 +289,36 @@ private:
     int m_maxQueueSize;
     bool m_paused;
     
+    // 参数快照只在界面线程读取；只应用与上一个快照相比变化了的参数，其余途径的设置不会被覆盖
+    ConfigSnapshotReader m_configReader;
+    int m_configUpdateInterval;                 // 上次应用的 System::CONFIG_UI_UPDATE_INTERVAL，-1 表示未应用
+    
     // 性能统计
     UIPerformanceMetrics m_metrics;
     
     // 更新回调
-    QHash<QString, std::function<void(const QVariant&)>> m_updateCallbacks;
+    QHash<UIUpdateKey, std::function<void(const QVariant&)>> m_updateCallbacks;
     
     // 智能优化参数
     ::OptimizationConfig m_optimizationConfig;
     
-    // 帧率限制和自适应优化
+    // 帧调度
+    // m_updateTimer 为单次定时器，只在有待处理更新时启动，触发时间对齐到刷新周期的整数倍
+    // （Qt 定时器拿不到真实的垂直同步相位，对齐到周期网格可以保证每个显示帧最多刷新一次）。
+    // 每帧按优先级和截止时间取出更新，用各类型回调的平均耗时估算，超出预算的留到下一帧；
+    // 执行中实际耗时超出预算时，剩余的更新同样推迟。回调耗时统计只在界面线程读写。
+    qint64 m_vsyncPeriodNs;                     // 屏幕刷新周期
+    qint64 m_flushPeriodNs;                     // 刷新间隔，刷新周期的 m_frameDivider 倍
+    int m_frameDivider;
+    qint64 m_frameBudgetNs;
+    bool m_customFrameBudget;
+    qint64 m_nextReadyNs;                       // 最早可以执行的待处理更新的时间，没有待处理更新时为最大值，受 m_queueMutex 保护
+    qint64 m_scheduledFrameNs;                  // 已安排的下一次刷新时间
+    QHash<UIUpdateType, qint64> m_callbackCostNs;
+    
+    // 帧率统计和自适应优化
     QElapsedTimer m_frameTimer;
+    int m_frameCount;
     int m_targetFPS;
     int m_currentFPS;
     QList<double> m_recentUpdateTimes;
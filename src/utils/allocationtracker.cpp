@@ -0,0 +1,373 @@
+#include "allocationtracker.h"
+#include "monotonicclock.h"
+#include "../constants.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+constexpr int MAX_THREADS = System::ALLOCATION_TRACKER_MAX_THREADS;
+constexpr int MAX_SITES = System::ALLOCATION_TRACKER_MAX_SITES;
+constexpr int OVERFLOW_SITE = MAX_SITES;        // 作用域表满后的公共槽位
+constexpr int NO_SITE = -1;
+constexpr int THREAD_NAME_SIZE = 48;
+static_assert((MAX_SITES & (MAX_SITES - 1)) == 0, "ALLOCATION_TRACKER_MAX_SITES 必须是 2 的幂");
+
+// 每个线程一个槽位，只有所属线程写入计数，独占缓存行
+struct alignas(64) ThreadSlot {
+    std::atomic<qint64> count{0};
+    std::atomic<qint64> bytes{0};
+    std::atomic<bool> named{false};
+    char name[THREAD_NAME_SIZE] = {};
+};
+
+// 作用域槽位以名称指针为键，各线程共享
+struct alignas(64) SiteSlot {
+    std::atomic<const char*> site{nullptr};
+    std::atomic<qint64> count{0};
+    std::atomic<qint64> bytes{0};
+};
+
+// 分配函数里只能访问常量初始化的全局对象和线程局部变量，不能有任何会分配内存的初始化
+ThreadSlot s_threads[MAX_THREADS];
+SiteSlot s_sites[MAX_SITES + 1];
+std::atomic<int> s_nextThread{0};
+std::atomic<qint64> s_frames{0};
+
+struct ThreadState {
+    ThreadSlot* slot;
+    int site;
+};
+
+thread_local ThreadState t_state = {nullptr, NO_SITE};
+
+ThreadSlot* threadSlot()
+{
+    ThreadState& state = t_state;
+    if (!state.slot) {
+        const int index = s_nextThread.fetch_add(1, std::memory_order_relaxed);
+        state.slot = &s_threads[qMin(index, MAX_THREADS - 1)];
+    }
+    return state.slot;
+}
+
+#if defined(ALLOCATION_TRACKING)
+inline void countAllocation(size_t size)
+{
+    ThreadSlot* slot = threadSlot();
+    // 所属线程是唯一写入者，读-改-写不需要原子指令
+    slot->count.store(slot->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot->bytes.store(slot->bytes.load(std::memory_order_relaxed) + static_cast<qint64>(size), std::memory_order_relaxed);
+    
+    const int site = t_state.site;
+    if (site != NO_SITE) {
+        s_sites[site].count.fetch_add(1, std::memory_order_relaxed);
+        s_sites[site].bytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+    }
+}
+#endif
+
+int siteIndex(const char* site)
+{
+    const std::uintptr_t key = reinterpret_cast<std::uintptr_t>(site);
+    std::uintptr_t index = (key >> 3) * 0x9E3779B97F4A7C15ull;
+    for (int probe = 0; probe < MAX_SITES; ++probe, ++index) {
+        SiteSlot& slot = s_sites[index & (MAX_SITES - 1)];
+        const char* current = slot.site.load(std::memory_order_acquire);
+        if (current == site) {
+            return static_cast<int>(index & (MAX_SITES - 1));
+        }
+        if (!current) {
+            if (slot.site.compare_exchange_strong(current, site, std::memory_order_acq_rel)
+                || current == site) {
+                return static_cast<int>(index & (MAX_SITES - 1));
+            }
+        }
+    }
+    return OVERFLOW_SITE;
+}
+
+// 第一次进入作用域时记下线程名，之后不再读取 QThread
+void nameCurrentThread(ThreadSlot* slot)
+{
+    QThread* thread = QThread::currentThread();
+    QString name = thread ? thread->objectName() : QString();
+    if (name.isEmpty()) {
+        const QCoreApplication* app = QCoreApplication::instance();
+        if (app && thread && app->thread() == thread) {
+            name = QString("主线程");
+        }
+    }
+    const QByteArray utf8 = name.toUtf8().left(THREAD_NAME_SIZE - 1);
+    std::memcpy(slot->name, utf8.constData(), static_cast<size_t>(utf8.size()));
+    slot->name[utf8.size()] = '\0';
+    slot->named.store(true, std::memory_order_release);
+}
+
+bool countsBefore(const AllocationTracker::NamedCounters& a, const AllocationTracker::NamedCounters& b)
+{
+    return a.counters.count > b.counters.count;
+}
+
+}
+
+// 替换分配函数：glibc 下在可执行文件中截获 malloc 系列函数，Qt 容器（直接调用 malloc）
+// 和 operator new（libstdc++ 内部调用 malloc）都会被计入；其他平台退回到替换 operator new
+#if defined(ALLOCATION_TRACKING) && defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size)
+{
+    countAllocation(size);
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer ? 0 : ENOMEM;
+}
+}
+#elif defined(ALLOCATION_TRACKING)
+void* operator new(size_t size)
+{
+    countAllocation(size);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+bool AllocationTracker::isAvailable()
+{
+#if defined(ALLOCATION_TRACKING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationTracker::Counters AllocationTracker::current()
+{
+    Counters total;
+    const int threadCount = qMin(s_nextThread.load(std::memory_order_relaxed), MAX_THREADS);
+    for (int i = 0; i < threadCount; ++i) {
+        total.count += s_threads[i].count.load(std::memory_order_relaxed);
+        total.bytes += s_threads[i].bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+AllocationTracker::Counters AllocationTracker::currentThread()
+{
+    const ThreadSlot* slot = threadSlot();
+    Counters counters;
+    counters.count = slot->count.load(std::memory_order_relaxed);
+    counters.bytes = slot->bytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+qint64 AllocationTracker::frameCount()
+{
+    return s_frames.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::countFrames(qint64 frames)
+{
+    s_frames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+int AllocationTracker::enterScope(const char* site)
+{
+    ThreadSlot* slot = threadSlot();
+    if (!slot->named.load(std::memory_order_relaxed)) {
+        nameCurrentThread(slot);
+    }
+    
+    ThreadState& state = t_state;
+    const int previous = state.site;
+    state.site = siteIndex(site);
+    return previous;
+}
+
+void AllocationTracker::leaveScope(int previousSite)
+{
+    t_state.site = previousSite;
+}
+
+QString AllocationTracker::unscopedSiteName()
+{
+    return QString("(无作用域)");
+}
+
+AllocationTracker::Snapshot AllocationTracker::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.timestampNs = MonotonicClock::nowNs();
+    snapshot.frames = frameCount();
+    
+    const int threadCount = qMin(s_nextThread.load(std::memory_order_relaxed), MAX_THREADS);
+    snapshot.threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        const ThreadSlot& slot = s_threads[i];
+        NamedCounters thread;
+        if (slot.named.load(std::memory_order_acquire) && slot.name[0]) {
+            thread.name = QString::fromUtf8(slot.name);
+        } else {
+            thread.name = QString("线程 %1").arg(i + 1);
+        }
+        if (i == MAX_THREADS - 1 && s_nextThread.load(std::memory_order_relaxed) > MAX_THREADS) {
+            thread.name = QString("(其他线程)");
+        }
+        thread.counters.count = slot.count.load(std::memory_order_relaxed);
+        thread.counters.bytes = slot.bytes.load(std::memory_order_relaxed);
+        snapshot.total.count += thread.counters.count;
+        snapshot.total.bytes += thread.counters.bytes;
+        snapshot.threads.append(thread);
+    }
+    
+    Counters scoped;
+    for (int i = 0; i <= MAX_SITES; ++i) {
+        const SiteSlot& slot = s_sites[i];
+        const char* site = slot.site.load(std::memory_order_acquire);
+        const qint64 count = slot.count.load(std::memory_order_relaxed);
+        if (!site && (i != OVERFLOW_SITE || count == 0)) {
+            continue;
+        }
+        const QString name = site ? QString::fromUtf8(site) : QString("(其他作用域)");
+        const qint64 bytes = slot.bytes.load(std::memory_order_relaxed);
+        scoped.count += count;
+        scoped.bytes += bytes;
+        
+        // 不同翻译单元中的同名字符串常量可能是不同的指针，合并为一项
+        auto existing = std::find_if(snapshot.sites.begin(), snapshot.sites.end(),
+                                     [&name](const NamedCounters& entry) { return entry.name == name; });
+        if (existing == snapshot.sites.end()) {
+            NamedCounters entry;
+            entry.name = name;
+            existing = snapshot.sites.insert(snapshot.sites.end(), entry);
+        }
+        existing->counters.count += count;
+        existing->counters.bytes += bytes;
+    }
+    
+    // 各计数器不是同时读取的，差值可能有少量偏差
+    NamedCounters unscoped;
+    unscoped.name = unscopedSiteName();
+    unscoped.counters.count = qMax<qint64>(0, snapshot.total.count - scoped.count);
+    unscoped.counters.bytes = qMax<qint64>(0, snapshot.total.bytes - scoped.bytes);
+    snapshot.sites.append(unscoped);
+    return snapshot;
+}
+
+AllocationTracker::Window AllocationTracker::difference(const Snapshot& before, const Snapshot& after, int topSiteCount)
+{
+    Window window;
+    window.seconds = qMax<qint64>(1, after.timestampNs - before.timestampNs) / 1e9;
+    window.frames = after.frames - before.frames;
+    window.total.count = after.total.count - before.total.count;
+    window.total.bytes = after.total.bytes - before.total.bytes;
+    window.allocationsPerSecond = window.total.count / window.seconds;
+    window.bytesPerSecond = window.total.bytes / window.seconds;
+    if (window.frames > 0) {
+        window.allocationsPerFrame = static_cast<double>(window.total.count) / window.frames;
+        window.bytesPerFrame = static_cast<double>(window.total.bytes) / window.frames;
+    }
+    
+    // 线程槽位只增不减，前后两次快照按位置对齐；作用域按名称对齐（快照中同名的作用域已合并）
+    auto differences = [](const QList<NamedCounters>& first, const QList<NamedCounters>& second, bool byName) {
+        QList<NamedCounters> result;
+        for (int i = 0; i < second.size(); ++i) {
+            NamedCounters delta = second.at(i);
+            const NamedCounters* previous = nullptr;
+            if (!byName) {
+                previous = i < first.size() ? &first.at(i) : nullptr;
+            } else {
+                for (const NamedCounters& entry : first) {
+                    if (entry.name == delta.name) {
+                        previous = &entry;
+                        break;
+                    }
+                }
+            }
+            if (previous) {
+                delta.counters.count -= previous->counters.count;
+                delta.counters.bytes -= previous->counters.bytes;
+            }
+            if (delta.counters.count > 0) {
+                result.append(delta);
+            }
+        }
+        std::sort(result.begin(), result.end(), countsBefore);
+        return result;
+    };
+    
+    window.threads = differences(before.threads, after.threads, false);
+    window.topSites = differences(before.sites, after.sites, true);
+    if (topSiteCount >= 0 && window.topSites.size() > topSiteCount) {
+        window.topSites.erase(window.topSites.begin() + topSiteCount, window.topSites.end());
+    }
+    return window;
+}
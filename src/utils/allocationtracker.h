@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+// 堆分配统计 - 回答"收到一帧要分配几次内存"
+//
+// 以 ALLOCATION_TRACKING 编译时（CMake 选项 ENABLE_ALLOCATION_TRACKING，基准测试始终开启）替换全局分配函数：
+// glibc 下截获 malloc 系列函数，Qt 容器和 operator new 都会被计入；其他平台只替换 operator new。
+// 每次分配计入所在线程，以及该线程最内层的 ALLOCATION_SCOPE 作用域；计数只有 relaxed 原子操作，不加锁、不分配内存。
+// 帧数由 ALLOCATION_COUNT_FRAMES 累计（协议解析器每校验通过一帧计一次），两次快照之差给出每帧分配次数。
+// 未开启时不替换任何函数，宏展开为空，isAvailable() 返回 false。
+//
+// 作用域名必须是字符串常量，按指针区分；线程名取自第一次进入作用域时的 QThread::objectName()。
+// 线程和作用域各有固定的槽位（System::ALLOCATION_TRACKER_MAX_THREADS / MAX_SITES），超出的计入最后一个槽位
+class AllocationTracker
+{
+public:
+    struct Counters {
+        qint64 count = 0;
+        qint64 bytes = 0;
+    };
+
+    struct NamedCounters {
+        QString name;
+        Counters counters;
+    };
+
+    struct Snapshot {
+        qint64 timestampNs = 0;
+        qint64 frames = 0;
+        Counters total;
+        QList<NamedCounters> threads;
+        QList<NamedCounters> sites;     // 不在任何作用域内的分配记在 unscopedSiteName() 下
+    };
+
+    // 两次快照之间的统计
+    struct Window {
+        double seconds = 0.0;
+        qint64 frames = 0;
+        Counters total;
+        double allocationsPerFrame = 0.0;   // 本窗口没有帧时为 0
+        double bytesPerFrame = 0.0;
+        double allocationsPerSecond = 0.0;
+        double bytesPerSecond = 0.0;
+        QList<NamedCounters> topSites;      // 按分配次数降序
+        QList<NamedCounters> threads;       // 本窗口有分配的线程，按分配次数降序
+    };
+
+    static bool isAvailable();
+
+    // 进程累计值（各线程之和）
+    static Counters current();
+    static Counters currentThread();
+    static qint64 frameCount();
+
+    static void countFrames(qint64 frames);
+
+    static Snapshot snapshot();
+    static Window difference(const Snapshot& before, const Snapshot& after, int topSiteCount = 5);
+    static QString unscopedSiteName();
+
+    // ALLOCATION_SCOPE 使用：进入作用域返回外层作用域，离开时恢复
+    static int enterScope(const char* site);
+    static void leaveScope(int previousSite);
+
+private:
+    AllocationTracker() = delete;
+};
+
+// 作用域内的分配记在 site 名下，嵌套时只记最内层
+class AllocationScope
+{
+public:
+    explicit AllocationScope(const char* site) : m_previousSite(AllocationTracker::enterScope(site)) {}
+    ~AllocationScope() { AllocationTracker::leaveScope(m_previousSite); }
+
+private:
+    Q_DISABLE_COPY(AllocationScope)
+
+    int m_previousSite;
+};
+
+#if defined(ALLOCATION_TRACKING)
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+#define ALLOCATION_SCOPE(site) AllocationScope ALLOCATION_CONCAT(allocationScope_, __LINE__)(site)
+#define ALLOCATION_COUNT_FRAMES(frames) AllocationTracker::countFrames(frames)
+#else
+#define ALLOCATION_SCOPE(site) do {} while (0)
+#define ALLOCATION_COUNT_FRAMES(frames) do {} while (0)
+#endif
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// 二进制编解码 - 按指定字节序在字节缓冲区中读写整数、浮点数和定点数
+//
+// 每个字段是一次 memcpy 加一次字节交换（编译为单条 bswap/rev 指令），不分配内存、不逐字节移位。
+// 缓冲区由调用方提供（帧缓冲区、池化缓冲区或栈上数组），BinaryWriter/BinaryReader 只记录位置和越界，
+// 越界后后续读写都被忽略，最后检查一次 hasError() 即可。
+//
+// 协议约定：整数为大端序；运动/点胶帧的浮点数为发送方本机字节序（既有设备固件如此），
+// 传感器帧的浮点数为小端序。
+enum class ByteOrder {
+    BigEndian,
+    LittleEndian,
+    Native
+};
+
+namespace BinaryCodec {
+
+template <typename T>
+constexpr bool isCodecType = std::is_arithmetic<T>::value || std::is_enum<T>::value;
+
+// 与 T 同宽的无符号整数
+template <int Size> struct UnsignedOfSize;
+template <> struct UnsignedOfSize<1> { using Type = quint8; };
+template <> struct UnsignedOfSize<2> { using Type = quint16; };
+template <> struct UnsignedOfSize<4> { using Type = quint32; };
+template <> struct UnsignedOfSize<8> { using Type = quint64; };
+
+template <typename U>
+constexpr U byteSwap(U value) noexcept
+{
+    static_assert(std::is_unsigned<U>::value, "byteSwap 只用于无符号整数");
+#if defined(Q_CC_GNU) || defined(Q_CC_CLANG)
+    if constexpr (sizeof(U) == 8) {
+        return __builtin_bswap64(value);
+    } else if constexpr (sizeof(U) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(U) == 2) {
+        return __builtin_bswap16(value);
+    } else {
+        return value;
+    }
+#else
+    // MSVC 会把这种写法识别为 bswap
+    U result = 0;
+    for (size_t i = 0; i < sizeof(U); ++i) {
+        result = static_cast<U>((result << 8) | ((value >> (i * 8)) & 0xFF));
+    }
+    return result;
+#endif
+}
+
+template <ByteOrder Order>
+constexpr bool needsSwap() noexcept
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return Order == ByteOrder::BigEndian;
+#else
+    return Order == ByteOrder::LittleEndian;
+#endif
+}
+
+// 把 value 按 Order 写入 out（sizeof(T) 字节，无对齐要求）
+template <ByteOrder Order, typename T>
+inline void store(void* out, T value) noexcept
+{
+    static_assert(isCodecType<T>, "只支持算术和枚举类型");
+    using U = typename UnsignedOfSize<sizeof(T)>::Type;
+    U bits;
+    memcpy(&bits, &value, sizeof(T));
+    if constexpr (needsSwap<Order>()) {
+        bits = byteSwap(bits);
+    }
+    memcpy(out, &bits, sizeof(T));
+}
+
+// 从 in 按 Order 读出一个 T
+template <typename T, ByteOrder Order>
+inline T load(const void* in) noexcept
+{
+    static_assert(isCodecType<T>, "只支持算术和枚举类型");
+    using U = typename UnsignedOfSize<sizeof(T)>::Type;
+    U bits;
+    memcpy(&bits, in, sizeof(T));
+    if constexpr (needsSwap<Order>()) {
+        bits = byteSwap(bits);
+    }
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+// 连续 count 个值的批量读写；字节序与本机一致时就是一次 memcpy
+template <ByteOrder Order, typename T>
+inline void storeArray(void* out, const T* values, int count) noexcept
+{
+    if constexpr (!needsSwap<Order>()) {
+        memcpy(out, values, sizeof(T) * static_cast<size_t>(count));
+    } else {
+        char* bytes = static_cast<char*>(out);
+        for (int i = 0; i < count; ++i) {
+            store<Order>(bytes + i * sizeof(T), values[i]);
+        }
+    }
+}
+
+template <typename T, ByteOrder Order>
+inline void loadArray(const void* in, T* values, int count) noexcept
+{
+    if constexpr (!needsSwap<Order>()) {
+        memcpy(values, in, sizeof(T) * static_cast<size_t>(count));
+    } else {
+        const char* bytes = static_cast<const char*>(in);
+        for (int i = 0; i < count; ++i) {
+            values[i] = load<T, Order>(bytes + i * sizeof(T));
+        }
+    }
+}
+
+// 定点数：raw = round(value * scale)，超出 Int 范围时饱和，NaN 记为 0
+template <typename Int>
+constexpr Int toFixed(double value, double scale) noexcept
+{
+    static_assert(std::is_integral<Int>::value, "定点数的存储类型必须是整数");
+    const double scaled = value * scale;
+    if (!(scaled == scaled)) {
+        return 0;
+    }
+    constexpr double minValue = static_cast<double>(std::numeric_limits<Int>::min());
+    constexpr double maxValue = static_cast<double>(std::numeric_limits<Int>::max());
+    if (scaled <= minValue) {
+        return std::numeric_limits<Int>::min();
+    }
+    if (scaled >= maxValue) {
+        return std::numeric_limits<Int>::max();
+    }
+    return static_cast<Int>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+template <typename Int>
+constexpr double fromFixed(Int raw, double scale) noexcept
+{
+    static_assert(std::is_integral<Int>::value, "定点数的存储类型必须是整数");
+    return static_cast<double>(raw) / scale;
+}
+
+} // namespace BinaryCodec
+
+// 顺序写入调用方缓冲区
+class BinaryWriter
+{
+public:
+    BinaryWriter(char* data, int capacity) noexcept
+        : m_data(data), m_capacity(data ? capacity : 0), m_position(0), m_error(false) {}
+
+    template <ByteOrder Order, typename T>
+    BinaryWriter& write(T value) noexcept
+    {
+        if (reserve(static_cast<int>(sizeof(T)))) {
+            BinaryCodec::store<Order>(m_data + m_position, value);
+            m_position += static_cast<int>(sizeof(T));
+        }
+        return *this;
+    }
+
+    template <typename T> BinaryWriter& writeBig(T value) noexcept { return write<ByteOrder::BigEndian>(value); }
+    template <typename T> BinaryWriter& writeLittle(T value) noexcept { return write<ByteOrder::LittleEndian>(value); }
+    template <typename T> BinaryWriter& writeNative(T value) noexcept { return write<ByteOrder::Native>(value); }
+
+    template <ByteOrder Order, typename T>
+    BinaryWriter& writeArray(const T* values, int count) noexcept
+    {
+        const int length = static_cast<int>(sizeof(T)) * count;
+        if (count >= 0 && reserve(length)) {
+            BinaryCodec::storeArray<Order>(m_data + m_position, values, count);
+            m_position += length;
+        }
+        return *this;
+    }
+
+    template <typename Int, ByteOrder Order = ByteOrder::BigEndian>
+    BinaryWriter& writeFixed(double value, double scale) noexcept
+    {
+        return write<Order>(BinaryCodec::toFixed<Int>(value, scale));
+    }
+
+    BinaryWriter& writeBytes(const char* data, int length) noexcept
+    {
+        if (length > 0 && reserve(length)) {
+            memcpy(m_data + m_position, data, static_cast<size_t>(length));
+            m_position += length;
+        }
+        return *this;
+    }
+
+    int position() const noexcept { return m_position; }
+    int remaining() const noexcept { return m_capacity - m_position; }
+    bool hasError() const noexcept { return m_error; }
+
+private:
+    bool reserve(int length) noexcept
+    {
+        if (m_error || length > m_capacity - m_position) {
+            m_error = true;
+            return false;
+        }
+        return true;
+    }
+
+    char* m_data;
+    int m_capacity;
+    int m_position;
+    bool m_error;
+};
+
+// 顺序读取只读缓冲区，越界后读出的值为 0
+class BinaryReader
+{
+public:
+    BinaryReader(const char* data, int size) noexcept
+        : m_data(data), m_size(data ? size : 0), m_position(0), m_error(false) {}
+
+    template <typename T, ByteOrder Order>
+    T read() noexcept
+    {
+        if (!reserve(static_cast<int>(sizeof(T)))) {
+            return T();
+        }
+        const T value = BinaryCodec::load<T, Order>(m_data + m_position);
+        m_position += static_cast<int>(sizeof(T));
+        return value;
+    }
+
+    template <typename T> T readBig() noexcept { return read<T, ByteOrder::BigEndian>(); }
+    template <typename T> T readLittle() noexcept { return read<T, ByteOrder::LittleEndian>(); }
+    template <typename T> T readNative() noexcept { return read<T, ByteOrder::Native>(); }
+
+    template <typename T, ByteOrder Order>
+    bool readArray(T* values, int count) noexcept
+    {
+        const int length = static_cast<int>(sizeof(T)) * count;
+        if (count < 0 || !reserve(length)) {
+            return false;
+        }
+        BinaryCodec::loadArray<T, Order>(m_data + m_position, values, count);
+        m_position += length;
+        return true;
+    }
+
+    template <typename Int, ByteOrder Order = ByteOrder::BigEndian>
+    double readFixed(double scale) noexcept
+    {
+        return BinaryCodec::fromFixed(read<Int, Order>(), scale);
+    }
+
+    // 返回指向缓冲区内 length 字节的指针，越界时为空
+    const char* readBytes(int length) noexcept
+    {
+        if (length < 0 || !reserve(length)) {
+            return nullptr;
+        }
+        const char* bytes = m_data + m_position;
+        m_position += length;
+        return bytes;
+    }
+
+    bool skip(int length) noexcept { return readBytes(length) != nullptr; }
+
+    int position() const noexcept { return m_position; }
+    int remaining() const noexcept { return m_size - m_position; }
+    bool atEnd() const noexcept { return m_position >= m_size; }
+    bool hasError() const noexcept { return m_error; }
+
+private:
+    bool reserve(int length) noexcept
+    {
+        if (m_error || length > m_size - m_position) {
+            m_error = true;
+            return false;
+        }
+        return true;
+    }
+
+    const char* m_data;
+    int m_size;
+    int m_position;
+    bool m_error;
+};
@@ -0,0 +1,339 @@
+#include "bytescanner.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BYTESCANNER_HAS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define BYTESCANNER_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BYTESCANNER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BYTESCANNER_TARGET(isa)
+#endif
+
+namespace {
+
+using FindByteFn = int (*)(const char*, int, quint8);
+using FindPairFn = int (*)(const char*, int, quint8, quint8);
+
+struct KernelTable {
+    ScanKernel kernel;
+    FindByteFn findByte;
+    FindPairFn findPair;
+};
+
+inline int countTrailingZeros(quint32 value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// ---------------- 标量实现 ----------------
+
+int findByteScalar(const char* data, int length, quint8 value)
+{
+    if (length <= 0) return -1;
+    const void* hit = memchr(data, value, static_cast<size_t>(length));
+    return hit ? static_cast<int>(static_cast<const char*>(hit) - data) : -1;
+}
+
+int findPairScalar(const char* data, int length, quint8 first, quint8 second)
+{
+    int offset = 0;
+    while (offset < length - 1) {
+        const int hit = findByteScalar(data + offset, length - 1 - offset, first);
+        if (hit < 0) return -1;
+        offset += hit;
+        if (static_cast<quint8>(data[offset + 1]) == second) {
+            return offset;
+        }
+        ++offset;
+    }
+    return -1;
+}
+
+// ---------------- x86 SSE2 / AVX2 实现 ----------------
+
+#ifdef BYTESCANNER_HAS_X86
+
+BYTESCANNER_TARGET("sse2")
+int findByteSSE2(const char* data, int length, quint8 value)
+{
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    int i = 0;
+    for (; i + 16 <= length; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return i + countTrailingZeros(static_cast<quint32>(mask));
+        }
+    }
+    const int tail = findByteScalar(data + i, length - i, value);
+    return tail < 0 ? -1 : i + tail;
+}
+
+BYTESCANNER_TARGET("sse2")
+int findPairSSE2(const char* data, int length, quint8 first, quint8 second)
+{
+    const __m128i firstNeedle = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i secondNeedle = _mm_set1_epi8(static_cast<char>(second));
+    int i = 0;
+    // 每轮比较 data[i..i+15] 与 data[i+1..i+16]，需要17个可读字节
+    for (; i + 17 <= length; i += 16) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        const __m128i match = _mm_and_si128(_mm_cmpeq_epi8(lo, firstNeedle),
+                                            _mm_cmpeq_epi8(hi, secondNeedle));
+        const int mask = _mm_movemask_epi8(match);
+        if (mask != 0) {
+            return i + countTrailingZeros(static_cast<quint32>(mask));
+        }
+    }
+    const int tail = findPairScalar(data + i, length - i, first, second);
+    return tail < 0 ? -1 : i + tail;
+}
+
+BYTESCANNER_TARGET("avx2")
+int findByteAVX2(const char* data, int length, quint8 value)
+{
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    int i = 0;
+    for (; i + 32 <= length; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const quint32 mask = static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+        if (mask != 0) {
+            return i + countTrailingZeros(mask);
+        }
+    }
+    const int tail = findByteScalar(data + i, length - i, value);
+    return tail < 0 ? -1 : i + tail;
+}
+
+BYTESCANNER_TARGET("avx2")
+int findPairAVX2(const char* data, int length, quint8 first, quint8 second)
+{
+    const __m256i firstNeedle = _mm256_set1_epi8(static_cast<char>(first));
+    const __m256i secondNeedle = _mm256_set1_epi8(static_cast<char>(second));
+    int i = 0;
+    for (; i + 33 <= length; i += 32) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        const __m256i match = _mm256_and_si256(_mm256_cmpeq_epi8(lo, firstNeedle),
+                                               _mm256_cmpeq_epi8(hi, secondNeedle));
+        const quint32 mask = static_cast<quint32>(_mm256_movemask_epi8(match));
+        if (mask != 0) {
+            return i + countTrailingZeros(mask);
+        }
+    }
+    const int tail = findPairSSE2(data + i, length - i, first, second);
+    return tail < 0 ? -1 : i + tail;
+}
+
+bool cpuSupportsSSE2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true; // x86-64 基线指令集
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuSupportsAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    // 确认操作系统保存了YMM寄存器状态
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // BYTESCANNER_HAS_X86
+
+// ---------------- ARM NEON 实现 ----------------
+
+#ifdef BYTESCANNER_HAS_NEON
+
+// 将比较结果压缩为每字节4位的64位掩码
+inline quint64 neonMatchMask(uint8x16_t match)
+{
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(match), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+inline int countTrailingZeros64(quint64 value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+int findByteNEON(const char* data, int length, quint8 value)
+{
+    const uint8x16_t needle = vdupq_n_u8(value);
+    int i = 0;
+    for (; i + 16 <= length; i += 16) {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        const quint64 mask = neonMatchMask(vceqq_u8(chunk, needle));
+        if (mask != 0) {
+            return i + countTrailingZeros64(mask) / 4;
+        }
+    }
+    const int tail = findByteScalar(data + i, length - i, value);
+    return tail < 0 ? -1 : i + tail;
+}
+
+int findPairNEON(const char* data, int length, quint8 first, quint8 second)
+{
+    const uint8x16_t firstNeedle = vdupq_n_u8(first);
+    const uint8x16_t secondNeedle = vdupq_n_u8(second);
+    int i = 0;
+    for (; i + 17 <= length; i += 16) {
+        const uint8x16_t lo = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        const uint8x16_t hi = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i + 1));
+        const uint8x16_t match = vandq_u8(vceqq_u8(lo, firstNeedle), vceqq_u8(hi, secondNeedle));
+        const quint64 mask = neonMatchMask(match);
+        if (mask != 0) {
+            return i + countTrailingZeros64(mask) / 4;
+        }
+    }
+    const int tail = findPairScalar(data + i, length - i, first, second);
+    return tail < 0 ? -1 : i + tail;
+}
+
+#endif // BYTESCANNER_HAS_NEON
+
+const KernelTable s_scalarTable = { ScanKernel::Scalar, findByteScalar, findPairScalar };
+#ifdef BYTESCANNER_HAS_X86
+const KernelTable s_sse2Table = { ScanKernel::SSE2, findByteSSE2, findPairSSE2 };
+const KernelTable s_avx2Table = { ScanKernel::AVX2, findByteAVX2, findPairAVX2 };
+#endif
+#ifdef BYTESCANNER_HAS_NEON
+const KernelTable s_neonTable = { ScanKernel::NEON, findByteNEON, findPairNEON };
+#endif
+
+const KernelTable* tableForKernel(ScanKernel kernel)
+{
+    switch (kernel) {
+#ifdef BYTESCANNER_HAS_X86
+        case ScanKernel::SSE2: return &s_sse2Table;
+        case ScanKernel::AVX2: return &s_avx2Table;
+#endif
+#ifdef BYTESCANNER_HAS_NEON
+        case ScanKernel::NEON: return &s_neonTable;
+#endif
+        default: return &s_scalarTable;
+    }
+}
+
+std::atomic<const KernelTable*> s_activeTable{nullptr};
+
+inline const KernelTable* activeTable()
+{
+    const KernelTable* table = s_activeTable.load(std::memory_order_acquire);
+    if (Q_UNLIKELY(!table)) {
+        // 多线程同时首次调用时结果相同，重复赋值无副作用
+        table = tableForKernel(ByteScanner::detectBestKernel());
+        s_activeTable.store(table, std::memory_order_release);
+    }
+    return table;
+}
+
+} // namespace
+
+int ByteScanner::findByte(const char* data, int length, quint8 value)
+{
+    if (!data || length <= 0) return -1;
+    return activeTable()->findByte(data, length, value);
+}
+
+int ByteScanner::findPair(const char* data, int length, quint8 first, quint8 second)
+{
+    if (!data || length < 2) return -1;
+    return activeTable()->findPair(data, length, first, second);
+}
+
+ScanKernel ByteScanner::activeKernel()
+{
+    return activeTable()->kernel;
+}
+
+bool ByteScanner::isKernelSupported(ScanKernel kernel)
+{
+    switch (kernel) {
+        case ScanKernel::Scalar:
+            return true;
+#ifdef BYTESCANNER_HAS_X86
+        case ScanKernel::SSE2:
+            return cpuSupportsSSE2();
+        case ScanKernel::AVX2:
+            return cpuSupportsSSE2() && cpuSupportsAVX2();
+#endif
+#ifdef BYTESCANNER_HAS_NEON
+        case ScanKernel::NEON:
+            return true; // AArch64 基线指令集
+#endif
+        default:
+            return false;
+    }
+}
+
+bool ByteScanner::setKernel(ScanKernel kernel)
+{
+    if (!isKernelSupported(kernel)) {
+        return false;
+    }
+    s_activeTable.store(tableForKernel(kernel), std::memory_order_release);
+    return true;
+}
+
+ScanKernel ByteScanner::detectBestKernel()
+{
+    if (isKernelSupported(ScanKernel::AVX2)) return ScanKernel::AVX2;
+    if (isKernelSupported(ScanKernel::SSE2)) return ScanKernel::SSE2;
+    if (isKernelSupported(ScanKernel::NEON)) return ScanKernel::NEON;
+    return ScanKernel::Scalar;
+}
+
+QString ByteScanner::kernelToString(ScanKernel kernel)
+{
+    switch (kernel) {
+        case ScanKernel::Scalar: return "Scalar";
+        case ScanKernel::SSE2: return "SSE2";
+        case ScanKernel::AVX2: return "AVX2";
+        case ScanKernel::NEON: return "NEON";
+        default: return "Unknown";
+    }
+}
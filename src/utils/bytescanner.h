@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+
+// 扫描内核类型
+enum class ScanKernel {
+    Scalar,     // 标量实现（所有平台可用）
+    SSE2,       // x86 SSE2 (16字节/次)
+    AVX2,       // x86 AVX2 (32字节/次)
+    NEON        // ARM NEON (16字节/次)
+};
+
+// 字节模式扫描器 - 用于协议帧头/帧尾的快速定位
+// 首次调用时根据CPU能力选择最快的内核，之后无分支开销
+class ByteScanner
+{
+public:
+    // 查找单字节，返回偏移，未找到返回-1
+    static int findByte(const char* data, int length, quint8 value);
+
+    // 查找连续双字节 (first, second)，返回first所在偏移，未找到返回-1
+    static int findPair(const char* data, int length, quint8 first, quint8 second);
+
+    // 按大端序查找16位帧头，例如 Protocol::FRAME_HEADER
+    static int findHeader(const char* data, int length, quint16 header) {
+        return findPair(data, length, static_cast<quint8>(header >> 8), static_cast<quint8>(header & 0xFF));
+    }
+
+    // 内核管理
+    static ScanKernel activeKernel();
+    static bool isKernelSupported(ScanKernel kernel);
+    static bool setKernel(ScanKernel kernel);   // 用于基准测试，不支持时返回false
+    static ScanKernel detectBestKernel();
+    static QString kernelToString(ScanKernel kernel);
+
+private:
+    ByteScanner() = delete;
+};
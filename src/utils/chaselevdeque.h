@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev 工作窃取双端队列（Lê 等人按 C11 内存模型给出的版本）
+// 所有者线程在底部 push/pop（后进先出，刚放入的数据还在缓存里），其他线程在顶部 steal（先进先出）。
+// 只有 pop 和 steal 争抢最后一个元素时才用 CAS。元素须可平凡复制（通常是指针）。
+// 数组满时所有者把容量翻倍；窃取者可能还在读旧数组，旧数组留到队列析构时才释放
+template <typename T>
+class ChaseLevDeque
+{
+    static_assert(std::is_trivially_copyable<T>::value, "ChaseLevDeque 的元素须可平凡复制");
+
+public:
+    enum class StealResult {
+        Success,
+        Empty,
+        Aborted         // 与其他窃取者或所有者竞争失败，队列可能仍有元素
+    };
+
+    explicit ChaseLevDeque(int initialCapacity = 64)
+    {
+        size_t size = 2;
+        while (size < static_cast<size_t>(qMax(2, initialCapacity))) {
+            size <<= 1;
+        }
+        m_arrays.push_back(std::make_unique<Array>(size));
+        m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // 只允许所有者调用
+    void push(T value)
+    {
+        const qint64 bottom = m_bottom.load(std::memory_order_relaxed);
+        const qint64 top = m_top.load(std::memory_order_acquire);
+        Array* array = m_array.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<qint64>(array->mask)) {
+            array = grow(array, bottom, top);
+        }
+        array->store(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // 只允许所有者调用
+    bool pop(T& value)
+    {
+        const qint64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array* array = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        qint64 top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        value = array->load(bottom);
+        if (top == bottom) {
+            // 最后一个元素，与窃取者竞争
+            const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // 任意线程调用
+    StealResult steal(T& value)
+    {
+        qint64 top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const qint64 bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return StealResult::Empty;
+        }
+
+        Array* array = m_array.load(std::memory_order_acquire);
+        const T candidate = array->load(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return StealResult::Aborted;
+        }
+        value = candidate;
+        return StealResult::Success;
+    }
+
+    // 近似值，仅供统计和空闲判断
+    int sizeApprox() const
+    {
+        const qint64 bottom = m_bottom.load(std::memory_order_relaxed);
+        const qint64 top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<int>(bottom - top) : 0;
+    }
+
+private:
+    struct Array {
+        explicit Array(size_t size) : mask(size - 1), cells(new std::atomic<T>[size]) {}
+
+        T load(qint64 index) const { return cells[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed); }
+        void store(qint64 index, T value) { cells[static_cast<size_t>(index) & mask].store(value, std::memory_order_relaxed); }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> cells;
+    };
+
+    Array* grow(Array* array, qint64 bottom, qint64 top)
+    {
+        m_arrays.push_back(std::make_unique<Array>((array->mask + 1) * 2));
+        Array* grown = m_arrays.back().get();
+        for (qint64 i = top; i < bottom; ++i) {
+            grown->store(i, array->load(i));
+        }
+        m_array.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    alignas(64) std::atomic<qint64> m_top{0};
+    alignas(64) std::atomic<qint64> m_bottom{0};
+    std::atomic<Array*> m_array{nullptr};
+    std::vector<std::unique_ptr<Array>> m_arrays;      // 只由所有者修改，含已被替换的旧数组
+};
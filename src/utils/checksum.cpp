@@ -1,30 +1,13 @@
 #include "checksum.h"
+#include "crcengine.h"
 #include <QCryptographicHash>
 #include <QDebug>
 #include <cstring>
-
-// 静态成员初始化
-uint16_t EnhancedChecksum::crc16Table[256];
-uint32_t EnhancedChecksum::crc32Table[256];
-bool EnhancedChecksum::crcTablesInitialized = false;
-
-// CRC16多项式定义
-const uint16_t CRC16_IBM_POLY = 0x8005;      // x^16 + x^15 + x^2 + 1
-const uint16_t CRC16_CCITT_POLY = 0x1021;    // x^16 + x^12 + x^5 + 1
-const uint16_t CRC16_MODBUS_POLY = 0xA001;   // x^16 + x^15 + x^2 + 1 (reversed)
-
-// CRC32多项式定义
-const uint32_t CRC32_POLY = 0xEDB88320;      // IEEE 802.3 CRC32 (reversed)
-const uint32_t CRC32C_POLY = 0x82F63B78;     // Castagnoli CRC32C (reversed)
+#include <memory>
+#include <vector>
 
 ChecksumResult EnhancedChecksum::calculate(const QByteArray& data, ChecksumType type)
 {
-    if (!crcTablesInitialized) {
-        initializeCRC16Table();
-        initializeCRC32Table();
-        crcTablesInitialized = true;
-    }
-    
     switch (type) {
         case ChecksumType::Simple: {
             uint8_t result = calculateSimple(data);
@@ -80,6 +63,179 @@ ChecksumResult EnhancedChecksum::calculate(const QByteArray& data, ChecksumType
     }
 }
 
+IncrementalChecksum::IncrementalChecksum(ChecksumType type)
+    : m_type(type)
+    , m_state(0)
+{
+    switch (m_type) {
+        case ChecksumType::MD5:
+            m_hash = std::make_unique<QCryptographicHash>(QCryptographicHash::Md5);
+            break;
+        case ChecksumType::SHA1:
+            m_hash = std::make_unique<QCryptographicHash>(QCryptographicHash::Sha1);
+            break;
+        case ChecksumType::SHA256:
+            m_hash = std::make_unique<QCryptographicHash>(QCryptographicHash::Sha256);
+            break;
+        default:
+            break;
+    }
+    reset();
+}
+
+IncrementalChecksum::~IncrementalChecksum() = default;
+IncrementalChecksum::IncrementalChecksum(IncrementalChecksum&& other) noexcept = default;
+IncrementalChecksum& IncrementalChecksum::operator=(IncrementalChecksum&& other) noexcept = default;
+
+int IncrementalChecksum::length() const
+{
+    return EnhancedChecksum::getChecksumLength(m_type);
+}
+
+void IncrementalChecksum::reset()
+{
+    switch (m_type) {
+        case ChecksumType::CRC16_CCITT:
+        case ChecksumType::CRC16_MODBUS:
+            m_state = 0xFFFF;
+            break;
+        case ChecksumType::CRC32:
+        case ChecksumType::CRC32C:
+            m_state = 0xFFFFFFFF;
+            break;
+        default:
+            m_state = 0;
+            break;
+    }
+    if (m_hash) {
+        m_hash->reset();
+    }
+}
+
+void IncrementalChecksum::update(const uint8_t* data, size_t length)
+{
+    switch (m_type) {
+        case ChecksumType::Simple: {
+            uint8_t sum = static_cast<uint8_t>(m_state);
+            for (size_t i = 0; i < length; ++i) sum += data[i];
+            m_state = sum;
+            break;
+        }
+        case ChecksumType::XOR: {
+            uint8_t value = static_cast<uint8_t>(m_state);
+            for (size_t i = 0; i < length; ++i) value ^= data[i];
+            m_state = value;
+            break;
+        }
+        case ChecksumType::CRC8:
+            m_state = CRCTables::updateCRC8<0x07>(static_cast<uint8_t>(m_state), data, length);
+            break;
+        case ChecksumType::CRC16_IBM:
+            m_state = CRCEngine::updateCRC16IBM(static_cast<uint16_t>(m_state), data, length);
+            break;
+        case ChecksumType::CRC16_CCITT:
+            m_state = CRCEngine::updateCRC16CCITT(static_cast<uint16_t>(m_state), data, length);
+            break;
+        case ChecksumType::CRC16_MODBUS:
+            m_state = CRCEngine::updateCRC16Modbus(static_cast<uint16_t>(m_state), data, length);
+            break;
+        case ChecksumType::CRC32:
+            m_state = CRCEngine::updateCRC32(m_state, data, length);
+            break;
+        case ChecksumType::CRC32C:
+            m_state = CRCEngine::updateCRC32C(m_state, data, length);
+            break;
+        case ChecksumType::MD5:
+        case ChecksumType::SHA1:
+        case ChecksumType::SHA256:
+            m_hash->addData(QByteArrayView(reinterpret_cast<const char*>(data), static_cast<qsizetype>(length)));
+            break;
+    }
+}
+
+int IncrementalChecksum::finalizeTo(uint8_t* dest) const
+{
+    switch (m_type) {
+        case ChecksumType::Simple:
+        case ChecksumType::XOR:
+        case ChecksumType::CRC8:
+            dest[0] = static_cast<uint8_t>(m_state);
+            return 1;
+        case ChecksumType::CRC16_IBM:
+        case ChecksumType::CRC16_CCITT:
+        case ChecksumType::CRC16_MODBUS:
+            // 大端序，与 ChecksumUtils::uint16ToBytes 默认行为一致
+            dest[0] = static_cast<uint8_t>(m_state >> 8);
+            dest[1] = static_cast<uint8_t>(m_state);
+            return 2;
+        case ChecksumType::CRC32:
+        case ChecksumType::CRC32C: {
+            const uint32_t value = m_state ^ 0xFFFFFFFF;
+            dest[0] = static_cast<uint8_t>(value >> 24);
+            dest[1] = static_cast<uint8_t>(value >> 16);
+            dest[2] = static_cast<uint8_t>(value >> 8);
+            dest[3] = static_cast<uint8_t>(value);
+            return 4;
+        }
+        case ChecksumType::MD5:
+        case ChecksumType::SHA1:
+        case ChecksumType::SHA256: {
+            const QByteArray digest = m_hash->result();
+            memcpy(dest, digest.constData(), static_cast<size_t>(digest.size()));
+            return digest.size();
+        }
+    }
+    return 0;
+}
+
+ChecksumResult IncrementalChecksum::result() const
+{
+    QByteArray value(length(), Qt::Uninitialized);
+    if (value.isEmpty()) {
+        return ChecksumResult();
+    }
+    finalizeTo(reinterpret_cast<uint8_t*>(value.data()));
+    return ChecksumResult(m_type, value);
+}
+
+namespace {
+
+// 单次遍历时的分块大小，保证数据块停留在L1缓存中
+constexpr int MULTI_CHECKSUM_BLOCK_SIZE = 4096;
+
+inline const uint8_t* toBytes(const QByteArray& data)
+{
+    return reinterpret_cast<const uint8_t*>(data.constData());
+}
+
+} // namespace
+
+QList<ChecksumResult> EnhancedChecksum::calculateMultiple(const QByteArray& data, const QList<ChecksumType>& types)
+{
+    std::vector<IncrementalChecksum> accumulators;
+    accumulators.reserve(types.size());
+    for (ChecksumType type : types) {
+        accumulators.emplace_back(type);
+    }
+    
+    // 分块遍历数据，每块依次交给所有校验器处理
+    const uint8_t* bytes = toBytes(data);
+    const int totalSize = data.size();
+    for (int offset = 0; offset < totalSize; offset += MULTI_CHECKSUM_BLOCK_SIZE) {
+        const size_t blockLength = static_cast<size_t>(qMin(MULTI_CHECKSUM_BLOCK_SIZE, totalSize - offset));
+        for (IncrementalChecksum& accumulator : accumulators) {
+            accumulator.update(bytes + offset, blockLength);
+        }
+    }
+    
+    QList<ChecksumResult> results;
+    results.reserve(static_cast<int>(accumulators.size()));
+    for (const IncrementalChecksum& accumulator : accumulators) {
+        results.append(accumulator.result());
+    }
+    return results;
+}
+
 bool EnhancedChecksum::verify(const QByteArray& data, const ChecksumResult& expectedChecksum)
 {
     if (!expectedChecksum.isValid) {
@@ -116,6 +272,19 @@ uint8_t EnhancedChecksum::calculateXOR(const QByteArray& data)
 
 uint8_t EnhancedChecksum::calculateCRC8(const QByteArray& data, uint8_t polynomial, uint8_t init)
 {
+    // 常用多项式直接使用编译期生成的查找表
+    switch (polynomial) {
+        case 0x07: return calculateCRC8<0x07>(data, init);   // CRC-8/SMBUS
+        case 0x1D: return calculateCRC8<0x1D>(data, init);   // CRC-8/SAE-J1850
+        case 0x2F: return calculateCRC8<0x2F>(data, init);   // CRC-8/AUTOSAR
+        case 0x31: return calculateCRC8<0x31>(data, init);   // CRC-8/MAXIM
+        case 0x9B: return calculateCRC8<0x9B>(data, init);   // CRC-8/WCDMA
+        case 0xD5: return calculateCRC8<0xD5>(data, init);   // CRC-8/DVB-S2
+        default:
+            break;
+    }
+    
+    // 其他多项式逐位计算
     uint8_t crc = init;
     
     for (char byte : data) {
@@ -135,89 +304,27 @@ uint8_t EnhancedChecksum::calculateCRC8(const QByteArray& data, uint8_t polynomi
 
 uint16_t EnhancedChecksum::calculateCRC16_IBM(const QByteArray& data)
 {
-    uint16_t crc = 0x0000;
-    
-    for (char byte : data) {
-        crc ^= static_cast<uint8_t>(byte);
-        
-        for (int i = 0; i < 8; ++i) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ CRC16_IBM_POLY;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    
-    return crc;
+    return CRCEngine::updateCRC16IBM(0x0000, toBytes(data), static_cast<size_t>(data.size()));
 }
 
 uint16_t EnhancedChecksum::calculateCRC16_CCITT(const QByteArray& data)
 {
-    uint16_t crc = 0xFFFF;
-    
-    for (char byte : data) {
-        crc ^= (static_cast<uint16_t>(byte) << 8);
-        
-        for (int i = 0; i < 8; ++i) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ CRC16_CCITT_POLY;
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    
-    return crc;
+    return CRCEngine::updateCRC16CCITT(0xFFFF, toBytes(data), static_cast<size_t>(data.size()));
 }
 
 uint16_t EnhancedChecksum::calculateCRC16_Modbus(const QByteArray& data)
 {
-    uint16_t crc = 0xFFFF;
-    
-    for (char byte : data) {
-        crc ^= static_cast<uint8_t>(byte);
-        
-        for (int i = 0; i < 8; ++i) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ CRC16_MODBUS_POLY;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    
-    return crc;
+    return CRCEngine::updateCRC16Modbus(0xFFFF, toBytes(data), static_cast<size_t>(data.size()));
 }
 
 uint32_t EnhancedChecksum::calculateCRC32(const QByteArray& data)
 {
-    uint32_t crc = 0xFFFFFFFF;
-    
-    for (char byte : data) {
-        crc = crc32Table[(crc ^ static_cast<uint8_t>(byte)) & 0xFF] ^ (crc >> 8);
-    }
-    
-    return crc ^ 0xFFFFFFFF;
+    return CRCEngine::updateCRC32(0xFFFFFFFF, toBytes(data), static_cast<size_t>(data.size())) ^ 0xFFFFFFFF;
 }
 
 uint32_t EnhancedChecksum::calculateCRC32C(const QByteArray& data)
 {
-    uint32_t crc = 0xFFFFFFFF;
-    
-    for (char byte : data) {
-        crc ^= static_cast<uint8_t>(byte);
-        
-        for (int i = 0; i < 8; ++i) {
-            if (crc & 0x00000001) {
-                crc = (crc >> 1) ^ CRC32C_POLY;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    
-    return crc ^ 0xFFFFFFFF;
+    return CRCEngine::updateCRC32C(0xFFFFFFFF, toBytes(data), static_cast<size_t>(data.size())) ^ 0xFFFFFFFF;
 }
 
 QByteArray EnhancedChecksum::calculateMD5(const QByteArray& data)
@@ -325,9 +432,11 @@ EnhancedChecksum::MultiLevelChecksum EnhancedChecksum::generateMultiLevel(
 {
     MultiLevelChecksum result;
     
-    result.primary = calculate(data, primary);
-    result.secondary = calculate(data, secondary);
-    result.tertiary = calculate(data, tertiary);
+    // 三级校验在一次数据遍历中完成
+    const QList<ChecksumResult> levels = calculateMultiple(data, {primary, secondary, tertiary});
+    result.primary = levels.at(0);
+    result.secondary = levels.at(1);
+    result.tertiary = levels.at(2);
     
     result.isValid = result.primary.isValid && 
                      result.secondary.isValid && 
@@ -548,42 +657,6 @@ EnhancedChecksum::FrameIntegrityResult EnhancedChecksum::checkFrameIntegrity(
     return result;
 }
 
-// CRC表初始化
-void EnhancedChecksum::initializeCRC16Table()
-{
-    // 初始化CRC16表（这里使用Modbus多项式）
-    for (int i = 0; i < 256; ++i) {
-        uint16_t crc = i;
-        
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ CRC16_MODBUS_POLY;
-            } else {
-                crc >>= 1;
-            }
-        }
-        
-        crc16Table[i] = crc;
-    }
-}
-
-void EnhancedChecksum::initializeCRC32Table()
-{
-    for (int i = 0; i < 256; ++i) {
-        uint32_t crc = i;
-        
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 0x00000001) {
-                crc = (crc >> 1) ^ CRC32_POLY;
-            } else {
-                crc >>= 1;
-            }
-        }
-        
-        crc32Table[i] = crc;
-    }
-}
-
 // 工具函数实现
 namespace ChecksumUtils {
 
@@ -2,7 +2,13 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QList>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include "crctables.h"
+
+class QCryptographicHash;
 
 // 校验算法类型枚举
 enum class ChecksumType {
@@ -71,6 +77,35 @@ struct ChecksumResult {
     }
 };
 
+// 增量校验计算器 - 数据可分多次送入，结果与 EnhancedChecksum::calculate 一致
+// CRC/累加类校验不分配内存，哈希类校验内部持有 QCryptographicHash
+class IncrementalChecksum
+{
+public:
+    explicit IncrementalChecksum(ChecksumType type = ChecksumType::Simple);
+    ~IncrementalChecksum();
+    IncrementalChecksum(IncrementalChecksum&& other) noexcept;
+    IncrementalChecksum& operator=(IncrementalChecksum&& other) noexcept;
+    
+    ChecksumType type() const { return m_type; }
+    int length() const;     // 校验值字节数
+    
+    void reset();
+    void update(const uint8_t* data, size_t length);
+    void update(const QByteArray& data) {
+        update(reinterpret_cast<const uint8_t*>(data.constData()), static_cast<size_t>(data.size()));
+    }
+    
+    // 将校验值直接写入 dest（调用方保证至少 length() 字节），返回写入的字节数
+    int finalizeTo(uint8_t* dest) const;
+    ChecksumResult result() const;
+
+private:
+    ChecksumType m_type;
+    uint32_t m_state;                           // CRC寄存器/累加值
+    std::unique_ptr<QCryptographicHash> m_hash; // 仅哈希类校验使用
+};
+
 // 增强校验算法类
 class EnhancedChecksum
 {
@@ -78,6 +113,10 @@ public:
     // 静态方法 - 计算各种校验值
     static ChecksumResult calculate(const QByteArray& data, ChecksumType type);
     
+    // 单次遍历计算多种校验：数据按块流经缓存，每块依次送入所有请求的校验器，
+    // 结果顺序与 types 一致
+    static QList<ChecksumResult> calculateMultiple(const QByteArray& data, const QList<ChecksumType>& types);
+    
     // 验证校验值
     static bool verify(const QByteArray& data, const ChecksumResult& expectedChecksum);
     static bool verify(const QByteArray& data, ChecksumType type, const QByteArray& expectedValue);
@@ -88,6 +127,13 @@ public:
     
     // CRC校验算法
     static uint8_t calculateCRC8(const QByteArray& data, uint8_t polynomial = 0x07, uint8_t init = 0x00);
+    
+    // 编译期多项式的CRC8，查表在编译期生成，例如 calculateCRC8<0x31>(data)
+    template <uint8_t Polynomial>
+    static uint8_t calculateCRC8(const QByteArray& data, uint8_t init = 0x00) {
+        return CRCTables::updateCRC8<Polynomial>(init, reinterpret_cast<const uint8_t*>(data.constData()),
+                                                 static_cast<size_t>(data.size()));
+    }
     static uint16_t calculateCRC16_IBM(const QByteArray& data);
     static uint16_t calculateCRC16_CCITT(const QByteArray& data);
     static uint16_t calculateCRC16_Modbus(const QByteArray& data);
@@ -177,16 +223,7 @@ public:
                                                     ChecksumType checksumType = ChecksumType::CRC16_MODBUS);
 
 private:
-    // CRC查找表
-    static void initializeCRC16Table();
-    static void initializeCRC32Table();
-    static uint16_t crc16Table[256];
-    static uint32_t crc32Table[256];
-    static bool crcTablesInitialized;
-    
-    // 内部辅助方法
-    static uint16_t updateCRC16(uint16_t crc, uint8_t data, const uint16_t* table);
-    static uint32_t updateCRC32(uint32_t crc, uint8_t data);
+    // 内部辅助方法（CRC查找表均在 crctables.h 中编译期生成）
     static uint8_t reverseBits8(uint8_t value);
     static uint16_t reverseBits16(uint16_t value);
     static uint32_t reverseBits32(uint32_t value);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include "snapshotpublisher.h"
+
+// AdaptiveConfigManager 发布的参数快照，一次调整涉及的多个参数总是在同一个版本里生效
+struct ConfigSnapshot {
+    QHash<QString, QVariant> values;    // 参数名 -> 当前值
+    QDateTime publishedAt;
+
+    int intValue(const QString& name, int fallback) const
+    {
+        const auto it = values.constFind(name);
+        return it != values.constEnd() ? it->toInt() : fallback;
+    }
+
+    double doubleValue(const QString& name, double fallback) const
+    {
+        const auto it = values.constFind(name);
+        return it != values.constEnd() ? it->toDouble() : fallback;
+    }
+};
+
+using ConfigSnapshotPublisher = SnapshotPublisher<ConfigSnapshot>;
+using ConfigSnapshotReader = SnapshotReader<ConfigSnapshot>;
@@ -0,0 +1,431 @@
+#include "crcengine.h"
+#include "crctables.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CRCENGINE_HAS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CRCENGINE_HAS_ARM_CRC 1
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#if defined(__clang__)
+#define CRCENGINE_TARGET_X86(isa) __attribute__((target(isa)))
+#define CRCENGINE_TARGET_ARM __attribute__((target("crc")))
+#elif defined(__GNUC__)
+#define CRCENGINE_TARGET_X86(isa) __attribute__((target(isa)))
+#define CRCENGINE_TARGET_ARM __attribute__((target("+crc")))
+#else
+#define CRCENGINE_TARGET_X86(isa)
+#define CRCENGINE_TARGET_ARM
+#endif
+
+namespace {
+
+using CRCTables::SlicingTables;
+
+inline uint32_t load32LE(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// ---------------- 查表实现 ----------------
+
+template <typename T>
+T bytewiseReflected(const SlicingTables<T>& tables, uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length--) {
+        crc = (crc >> 8) ^ tables.t[0][(crc ^ *data++) & 0xFF];
+    }
+    return static_cast<T>(crc);
+}
+
+template <typename T>
+T slicingReflected(const SlicingTables<T>& tables, uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length >= 8) {
+        const uint32_t low = load32LE(data) ^ crc;
+        const uint32_t high = load32LE(data + 4);
+        crc = tables.t[7][low & 0xFF] ^ tables.t[6][(low >> 8) & 0xFF] ^
+              tables.t[5][(low >> 16) & 0xFF] ^ tables.t[4][low >> 24] ^
+              tables.t[3][high & 0xFF] ^ tables.t[2][(high >> 8) & 0xFF] ^
+              tables.t[1][(high >> 16) & 0xFF] ^ tables.t[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+    return bytewiseReflected(tables, crc, data, length);
+}
+
+uint16_t bytewiseNormal16(const SlicingTables<uint16_t>& tables, uint16_t crc, const uint8_t* data, size_t length)
+{
+    while (length--) {
+        crc = static_cast<uint16_t>((crc << 8) ^ tables.t[0][((crc >> 8) ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+uint16_t slicingNormal16(const SlicingTables<uint16_t>& tables, uint16_t crc, const uint8_t* data, size_t length)
+{
+    while (length >= 8) {
+        const uint8_t first = static_cast<uint8_t>(data[0] ^ (crc >> 8));
+        const uint8_t second = static_cast<uint8_t>(data[1] ^ (crc & 0xFF));
+        crc = static_cast<uint16_t>(
+            tables.t[7][first] ^ tables.t[6][second] ^ tables.t[5][data[2]] ^ tables.t[4][data[3]] ^
+            tables.t[3][data[4]] ^ tables.t[2][data[5]] ^ tables.t[1][data[6]] ^ tables.t[0][data[7]]);
+        data += 8;
+        length -= 8;
+    }
+    return bytewiseNormal16(tables, crc, data, length);
+}
+
+// ---------------- CPU特性检测 ----------------
+
+struct CpuFeatures {
+    bool sse42 = false;     // crc32 指令 (CRC32C)
+    bool pclmul = false;    // 无进位乘法 (CRC32 折叠)
+    bool armCrc = false;    // ARMv8 CRC32/CRC32C 指令
+};
+
+CpuFeatures detectCpuFeatures()
+{
+    CpuFeatures features;
+#ifdef CRCENGINE_HAS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    features.sse42 = (info[2] & (1 << 20)) != 0;
+    features.pclmul = features.sse42 && (info[2] & (1 << 1)) != 0;
+#else
+    __builtin_cpu_init();
+    features.sse42 = __builtin_cpu_supports("sse4.2");
+    features.pclmul = features.sse42 && __builtin_cpu_supports("pclmul");
+#endif
+#endif
+#ifdef CRCENGINE_HAS_ARM_CRC
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+    features.armCrc = true;
+#elif defined(__linux__) && defined(HWCAP_CRC32)
+    features.armCrc = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+#endif
+    return features;
+}
+
+const CpuFeatures& cpuFeatures()
+{
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+
+// ---------------- x86 硬件实现 ----------------
+
+#ifdef CRCENGINE_HAS_X86
+
+CRCENGINE_TARGET_X86("sse4.2")
+uint32_t crc32cSSE42(uint32_t crc, const uint8_t* data, size_t length)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+        data += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (length >= 4) {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        crc = _mm_crc32_u32(crc, value);
+        data += 4;
+        length -= 4;
+    }
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+
+// PCLMULQDQ 折叠计算 CRC32 (IEEE 802.3)
+// 参考 Intel "Fast CRC Computation Using PCLMULQDQ Instruction" 白皮书，
+// 要求 length >= 64 且为16的倍数，余下部分由调用方用查表处理
+CRCENGINE_TARGET_X86("sse4.2,pclmul")
+uint32_t crc32FoldPCLMUL(uint32_t crc, const uint8_t* data, size_t length)
+{
+    alignas(16) static const uint64_t k1k2[] = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+    alignas(16) static const uint64_t k3k4[] = { 0x01751997d0ULL, 0x00ccaa009eULL };
+    alignas(16) static const uint64_t k5k0[] = { 0x0163cd6124ULL, 0x0000000000ULL };
+    alignas(16) static const uint64_t poly[] = { 0x01db710641ULL, 0x01f7011641ULL };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    length -= 64;
+
+    // 并行折叠 4x128 位
+    while (length >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        data += 64;
+        length -= 64;
+    }
+
+    // 折叠到128位
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // 逐个折叠剩余的128位块
+    while (length >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        data += 16;
+        length -= 16;
+    }
+
+    // 128位折叠到64位
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett 约简到32位
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#endif // CRCENGINE_HAS_X86
+
+// ---------------- ARMv8 硬件实现 ----------------
+
+#ifdef CRCENGINE_HAS_ARM_CRC
+
+CRCENGINE_TARGET_ARM
+uint32_t crc32ARMv8(uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        crc = __crc32d(crc, value);
+        data += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = __crc32b(crc, *data++);
+    }
+    return crc;
+}
+
+CRCENGINE_TARGET_ARM
+uint32_t crc32cARMv8(uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        crc = __crc32cd(crc, value);
+        data += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+
+#endif // CRCENGINE_HAS_ARM_CRC
+
+std::atomic<int> s_acceleration{-1};
+
+inline CRCAcceleration currentAcceleration()
+{
+    int value = s_acceleration.load(std::memory_order_relaxed);
+    if (Q_UNLIKELY(value < 0)) {
+        value = static_cast<int>(CRCEngine::detectBestAcceleration());
+        s_acceleration.store(value, std::memory_order_relaxed);
+    }
+    return static_cast<CRCAcceleration>(value);
+}
+
+} // namespace
+
+uint16_t CRCEngine::updateCRC16Modbus(uint16_t state, const uint8_t* data, size_t length)
+{
+    if (currentAcceleration() == CRCAcceleration::Bytewise) {
+        return bytewiseReflected(CRCTables::crc16Modbus, state, data, length);
+    }
+    return slicingReflected(CRCTables::crc16Modbus, state, data, length);
+}
+
+uint16_t CRCEngine::updateCRC16IBM(uint16_t state, const uint8_t* data, size_t length)
+{
+    if (currentAcceleration() == CRCAcceleration::Bytewise) {
+        return bytewiseReflected(CRCTables::crc16IBM, state, data, length);
+    }
+    return slicingReflected(CRCTables::crc16IBM, state, data, length);
+}
+
+uint16_t CRCEngine::updateCRC16CCITT(uint16_t state, const uint8_t* data, size_t length)
+{
+    if (currentAcceleration() == CRCAcceleration::Bytewise) {
+        return bytewiseNormal16(CRCTables::crc16CCITT, state, data, length);
+    }
+    return slicingNormal16(CRCTables::crc16CCITT, state, data, length);
+}
+
+uint32_t CRCEngine::updateCRC32(uint32_t state, const uint8_t* data, size_t length)
+{
+    switch (currentAcceleration()) {
+        case CRCAcceleration::Hardware:
+#ifdef CRCENGINE_HAS_X86
+            if (cpuFeatures().pclmul && length >= 64) {
+                const size_t foldLength = length & ~static_cast<size_t>(15);
+                state = crc32FoldPCLMUL(state, data, foldLength);
+                data += foldLength;
+                length -= foldLength;
+            }
+#endif
+#ifdef CRCENGINE_HAS_ARM_CRC
+            if (cpuFeatures().armCrc) {
+                return crc32ARMv8(state, data, length);
+            }
+#endif
+            return slicingReflected(CRCTables::crc32, state, data, length);
+        case CRCAcceleration::SlicingBy8:
+            return slicingReflected(CRCTables::crc32, state, data, length);
+        case CRCAcceleration::Bytewise:
+        default:
+            return bytewiseReflected(CRCTables::crc32, state, data, length);
+    }
+}
+
+uint32_t CRCEngine::updateCRC32C(uint32_t state, const uint8_t* data, size_t length)
+{
+    switch (currentAcceleration()) {
+        case CRCAcceleration::Hardware:
+#ifdef CRCENGINE_HAS_X86
+            if (cpuFeatures().sse42) {
+                return crc32cSSE42(state, data, length);
+            }
+#endif
+#ifdef CRCENGINE_HAS_ARM_CRC
+            if (cpuFeatures().armCrc) {
+                return crc32cARMv8(state, data, length);
+            }
+#endif
+            return slicingReflected(CRCTables::crc32c, state, data, length);
+        case CRCAcceleration::SlicingBy8:
+            return slicingReflected(CRCTables::crc32c, state, data, length);
+        case CRCAcceleration::Bytewise:
+        default:
+            return bytewiseReflected(CRCTables::crc32c, state, data, length);
+    }
+}
+
+CRCAcceleration CRCEngine::acceleration()
+{
+    return currentAcceleration();
+}
+
+bool CRCEngine::setAcceleration(CRCAcceleration acceleration)
+{
+    if (!isAccelerationSupported(acceleration)) {
+        return false;
+    }
+    s_acceleration.store(static_cast<int>(acceleration), std::memory_order_relaxed);
+    return true;
+}
+
+bool CRCEngine::isAccelerationSupported(CRCAcceleration acceleration)
+{
+    switch (acceleration) {
+        case CRCAcceleration::Bytewise:
+        case CRCAcceleration::SlicingBy8:
+            return true;
+        case CRCAcceleration::Hardware: {
+            const CpuFeatures& features = cpuFeatures();
+            return features.sse42 || features.pclmul || features.armCrc;
+        }
+        default:
+            return false;
+    }
+}
+
+CRCAcceleration CRCEngine::detectBestAcceleration()
+{
+    return isAccelerationSupported(CRCAcceleration::Hardware) ? CRCAcceleration::Hardware
+                                                              : CRCAcceleration::SlicingBy8;
+}
+
+QString CRCEngine::accelerationToString(CRCAcceleration acceleration)
+{
+    switch (acceleration) {
+        case CRCAcceleration::Bytewise: return "Bytewise";
+        case CRCAcceleration::SlicingBy8: return "SlicingBy8";
+        case CRCAcceleration::Hardware: return "Hardware";
+        default: return "Unknown";
+    }
+}
+
+QString CRCEngine::hardwareDescription()
+{
+    const CpuFeatures& features = cpuFeatures();
+    QString description;
+    if (features.sse42) description += "SSE4.2 crc32 (CRC32C) ";
+    if (features.pclmul) description += "PCLMULQDQ (CRC32) ";
+    if (features.armCrc) description += "ARMv8 CRC (CRC32/CRC32C) ";
+    return description.isEmpty() ? QString("None") : description.trimmed();
+}
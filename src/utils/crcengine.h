@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+
+// CRC计算加速方式
+enum class CRCAcceleration {
+    Bytewise,       // 逐字节查表（256项）
+    SlicingBy8,     // slicing-by-8 查表，每轮处理8字节
+    Hardware        // 硬件指令：SSE4.2 crc32 / PCLMULQDQ 折叠 / ARMv8 CRC
+};
+
+// CRC计算引擎 - 为 EnhancedChecksum 提供加速的增量更新接口
+//
+// state 参数为CRC寄存器的内部值（已应用初值、未做最终异或），
+// 因此可以分块连续调用，便于单次遍历同时计算多种校验。
+// 没有硬件实现的算法（CRC16系列）在 Hardware 模式下使用 slicing-by-8。
+class CRCEngine
+{
+public:
+    static uint16_t updateCRC16Modbus(uint16_t state, const uint8_t* data, size_t length);
+    static uint16_t updateCRC16IBM(uint16_t state, const uint8_t* data, size_t length);
+    static uint16_t updateCRC16CCITT(uint16_t state, const uint8_t* data, size_t length);
+    static uint32_t updateCRC32(uint32_t state, const uint8_t* data, size_t length);
+    static uint32_t updateCRC32C(uint32_t state, const uint8_t* data, size_t length);
+
+    // 加速方式管理（启动时自动选择最快的可用实现）
+    static CRCAcceleration acceleration();
+    static bool setAcceleration(CRCAcceleration acceleration);   // 主要用于基准测试对比
+    static bool isAccelerationSupported(CRCAcceleration acceleration);
+    static CRCAcceleration detectBestAcceleration();
+    static QString accelerationToString(CRCAcceleration acceleration);
+    static QString hardwareDescription();                       // 可用的硬件CRC指令描述
+
+private:
+    CRCEngine() = delete;
+};
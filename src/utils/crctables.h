@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 编译期生成的CRC查找表
+// 所有表都是 constexpr 常量，位于只读数据段：校验计算没有初始化分支，
+// 也不存在多个通讯线程首次调用时并发建表的竞争
+namespace CRCTables {
+
+// CRC多项式定义
+constexpr uint16_t CRC16_IBM_POLY = 0x8005;      // x^16 + x^15 + x^2 + 1（按右移算法使用）
+constexpr uint16_t CRC16_CCITT_POLY = 0x1021;    // x^16 + x^12 + x^5 + 1
+constexpr uint16_t CRC16_MODBUS_POLY = 0xA001;   // x^16 + x^15 + x^2 + 1 (reversed)
+constexpr uint32_t CRC32_POLY = 0xEDB88320;      // IEEE 802.3 CRC32 (reversed)
+constexpr uint32_t CRC32C_POLY = 0x82F63B78;     // Castagnoli CRC32C (reversed)
+
+// slicing-by-8 查表：t[k][i] 表示字节 i 之后再跟 k 个零字节的CRC，t[0] 即常规256项表
+template <typename T>
+struct SlicingTables {
+    T t[8][256];
+};
+
+// CRC8 查表（MSB优先）
+struct CRC8Table {
+    uint8_t t[256];
+};
+
+// 右移（LSB优先）算法的查表生成
+template <typename T>
+constexpr SlicingTables<T> makeReflectedTables(T polynomial)
+{
+    SlicingTables<T> tables{};
+    for (int i = 0; i < 256; ++i) {
+        T crc = static_cast<T>(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ polynomial) : static_cast<T>(crc >> 1);
+        }
+        tables.t[0][i] = crc;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int i = 0; i < 256; ++i) {
+            const T previous = tables.t[k - 1][i];
+            tables.t[k][i] = static_cast<T>((previous >> 8) ^ tables.t[0][previous & 0xFF]);
+        }
+    }
+    return tables;
+}
+
+// 左移（MSB优先）16位算法的查表生成
+constexpr SlicingTables<uint16_t> makeNormalTables16(uint16_t polynomial)
+{
+    SlicingTables<uint16_t> tables{};
+    for (int i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ polynomial)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+        tables.t[0][i] = crc;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int i = 0; i < 256; ++i) {
+            const uint16_t previous = tables.t[k - 1][i];
+            tables.t[k][i] = static_cast<uint16_t>((previous << 8) ^ tables.t[0][(previous >> 8) & 0xFF]);
+        }
+    }
+    return tables;
+}
+
+constexpr CRC8Table makeCRC8Table(uint8_t polynomial)
+{
+    CRC8Table table{};
+    for (int i = 0; i < 256; ++i) {
+        uint8_t crc = static_cast<uint8_t>(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ polynomial) : static_cast<uint8_t>(crc << 1);
+        }
+        table.t[i] = crc;
+    }
+    return table;
+}
+
+inline constexpr SlicingTables<uint16_t> crc16Modbus = makeReflectedTables<uint16_t>(CRC16_MODBUS_POLY);
+inline constexpr SlicingTables<uint16_t> crc16IBM = makeReflectedTables<uint16_t>(CRC16_IBM_POLY);
+inline constexpr SlicingTables<uint16_t> crc16CCITT = makeNormalTables16(CRC16_CCITT_POLY);
+inline constexpr SlicingTables<uint32_t> crc32 = makeReflectedTables<uint32_t>(CRC32_POLY);
+inline constexpr SlicingTables<uint32_t> crc32c = makeReflectedTables<uint32_t>(CRC32C_POLY);
+
+// 任意多项式的CRC8表，每个用到的多项式在编译期实例化一次
+template <uint8_t Polynomial>
+inline constexpr CRC8Table crc8 = makeCRC8Table(Polynomial);
+
+template <uint8_t Polynomial>
+inline uint8_t updateCRC8(uint8_t crc, const uint8_t* data, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        crc = crc8<Polynomial>.t[crc ^ data[i]];
+    }
+    return crc;
+}
+
+// 编译期自检：与标准参考表的已知项比对
+static_assert(crc32.t[0][1] == 0x77073096, "CRC32 table mismatch");
+static_assert(crc32c.t[0][1] == 0xF26B8303, "CRC32C table mismatch");
+static_assert(crc16Modbus.t[0][1] == 0xC0C1, "CRC16 Modbus table mismatch");
+static_assert(crc16CCITT.t[0][1] == 0x1021, "CRC16 CCITT table mismatch");
+static_assert(crc8<0x07>.t[1] == 0x07, "CRC8 table mismatch");
+
+} // namespace CRCTables
@@ -0,0 +1,126 @@
+#include "fastlane.h"
+#include "constants.h"
+#include "logger/logmanager.h"
+#include <QCoreApplication>
+#include <QObject>
+#include <QStringList>
+
+FastLaneMonitor* FastLaneMonitor::getInstance()
+{
+    static FastLaneMonitor instance;
+    return &instance;
+}
+
+void FastLaneMonitor::record(FastLaneStage stage, qint64 latencyNs)
+{
+    const int index = static_cast<int>(stage);
+    const bool overBudget = latencyNs > Communication::FAST_LANE_LATENCY_BUDGET_US * 1000LL;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_histograms[index].record(latencyNs);
+        if (overBudget) {
+            ++m_overBudget[index];
+        }
+    }
+
+    // 日志在锁外记录，不拖慢其他阶段
+    if (overBudget) {
+        LogManager::getInstance()->warning(
+            QString("快速通道%1延迟超出预算: %2us > %3us")
+                .arg(stageName(stage))
+                .arg(latencyNs / 1000.0, 0, 'f', 1)
+                .arg(Communication::FAST_LANE_LATENCY_BUDGET_US),
+            "FastLane");
+    }
+}
+
+LatencyHistogram FastLaneMonitor::histogram(FastLaneStage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_histograms[static_cast<int>(stage)];
+}
+
+qint64 FastLaneMonitor::overBudgetCount(FastLaneStage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_overBudget[static_cast<int>(stage)];
+}
+
+qint64 FastLaneMonitor::worstCaseNs() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 worst = 0;
+    for (const LatencyHistogram& histogram : m_histograms) {
+        worst = qMax(worst, histogram.maxNs());
+    }
+    return worst;
+}
+
+bool FastLaneMonitor::withinBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    for (qint64 count : m_overBudget) {
+        if (count > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString FastLaneMonitor::report() const
+{
+    QStringList lines;
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        lines << QString("%1: %2, 超出预算=%3")
+                     .arg(stageName(static_cast<FastLaneStage>(i)))
+                     .arg(m_histograms[i].summary())
+                     .arg(m_overBudget[i]);
+    }
+    return lines.join('\n');
+}
+
+void FastLaneMonitor::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (LatencyHistogram& histogram : m_histograms) {
+        histogram.reset();
+    }
+    m_overBudget.fill(0);
+}
+
+QString FastLaneMonitor::stageName(FastLaneStage stage)
+{
+    switch (stage) {
+    case FastLaneStage::ParserDispatch: return "解析分发";
+    case FastLaneStage::WorkerDispatch: return "处理线程";
+    case FastLaneStage::Transport:      return "链路发送";
+    default:                            return "未知";
+    }
+}
+
+FastLaneCallEvent::FastLaneCallEvent(Call call)
+    : QEvent(eventType())
+    , m_call(std::move(call))
+{
+}
+
+QEvent::Type FastLaneCallEvent::eventType()
+{
+    static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+}
+
+void FastLaneCallEvent::post(QObject* receiver, Call call)
+{
+    QCoreApplication::postEvent(receiver, new FastLaneCallEvent(std::move(call)), Qt::HighEventPriority);
+}
+
+bool FastLaneCallEvent::dispatch(QEvent* event)
+{
+    if (event->type() != eventType()) {
+        return false;
+    }
+    static_cast<FastLaneCallEvent*>(event)->m_call();
+    return true;
+}
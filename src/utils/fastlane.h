@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QEvent>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <functional>
+#include "latencyhistogram.h"
+
+class QObject;
+
+// 安全指令快速通道经过的主机侧阶段
+enum class FastLaneStage {
+    ParserDispatch = 0,     // 帧校验通过 → 分发/投递完成（跳过批量投递）
+    WorkerDispatch,         // 进入 DataProcessWorker 快速队列 → 处理完成
+    Transport,              // 调用发送 → 写入并刷新到设备（跳过写合并和发送排队）
+    StageCount
+};
+
+// 快速通道延迟监控 - 记录急停/停止/暂停指令在各阶段的主机侧延迟，
+// 超出预算（Communication::FAST_LANE_LATENCY_BUDGET_US）的次数单独计数并告警。
+// 安全指令很少，记录时加锁的开销可以忽略；任意线程调用
+class FastLaneMonitor
+{
+public:
+    static FastLaneMonitor* getInstance();
+
+    void record(FastLaneStage stage, qint64 latencyNs);
+
+    LatencyHistogram histogram(FastLaneStage stage) const;
+    qint64 overBudgetCount(FastLaneStage stage) const;
+    qint64 worstCaseNs() const;                 // 所有阶段中的最大延迟
+    bool withinBudget() const;                  // 所有阶段都没有超出预算
+
+    // 每个阶段一行摘要
+    QString report() const;
+    void reset();
+
+    static QString stageName(FastLaneStage stage);
+
+private:
+    FastLaneMonitor() = default;
+
+    static constexpr int STAGE_COUNT = static_cast<int>(FastLaneStage::StageCount);
+
+    mutable QMutex m_mutex;
+    std::array<LatencyHistogram, STAGE_COUNT> m_histograms;
+    std::array<qint64, STAGE_COUNT> m_overBudget{};
+};
+
+// 快速通道调用事件：以 Qt::HighEventPriority 投递，排在目标线程已排队的普通事件
+// （排队的发送、读就绪、批量处理调用）之前执行。接收对象需在 event() 中调用 dispatch()
+class FastLaneCallEvent : public QEvent
+{
+public:
+    using Call = std::function<void()>;
+
+    explicit FastLaneCallEvent(Call call);
+
+    static QEvent::Type eventType();
+    static void post(QObject* receiver, Call call);
+
+    // 是快速通道事件时执行并返回true
+    static bool dispatch(QEvent* event);
+
+private:
+    Call m_call;
+};
@@ -0,0 +1,94 @@
+#include "framelatency.h"
+#include "metricsregistry.h"
+#include <QStringList>
+
+FrameLatencyMonitor* FrameLatencyMonitor::getInstance()
+{
+    static FrameLatencyMonitor instance;
+    return &instance;
+}
+
+FrameLatencyMonitor::FrameLatencyMonitor()
+{
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        // 标签取指标名的阶段部分，如 frameLatency.total → stage="total"
+        const QString stage = metricPrefix(static_cast<FrameLatencyStage>(i)).section('.', 1);
+        m_stageMetrics[i] = MetricsRegistry::histogram("glue_frame_latency_seconds", "接收帧各阶段的延迟",
+                                                       MetricsRegistry::label("stage", stage),
+                                                       MetricsRegistry::latencyBucketsNs());
+    }
+}
+
+void FrameLatencyMonitor::record(FrameLatencyStage stage, qint64 latencyNs)
+{
+    const int index = static_cast<int>(stage);
+    m_stageMetrics[index]->observe(latencyNs);
+    QMutexLocker locker(&m_mutex);
+    m_total[index].record(latencyNs);
+    m_window[index].record(latencyNs);
+}
+
+HdrHistogram FrameLatencyMonitor::histogram(FrameLatencyStage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_total[static_cast<int>(stage)];
+}
+
+FrameLatencyMonitor::Histograms FrameLatencyMonitor::takeWindow()
+{
+    QMutexLocker locker(&m_mutex);
+    Histograms window = m_window;
+    for (HdrHistogram& histogram : m_window) {
+        histogram.reset();
+    }
+    return window;
+}
+
+QString FrameLatencyMonitor::report() const
+{
+    QStringList lines;
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        if (m_total[i].count() > 0) {
+            lines << QString("%1: %2").arg(stageName(static_cast<FrameLatencyStage>(i)), m_total[i].summary());
+        }
+    }
+    return lines.join('\n');
+}
+
+void FrameLatencyMonitor::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        m_total[i].reset();
+        m_window[i].reset();
+    }
+}
+
+QString FrameLatencyMonitor::stageName(FrameLatencyStage stage)
+{
+    switch (stage) {
+    case FrameLatencyStage::Parse:    return "帧解析";
+    case FrameLatencyStage::Dispatch: return "投递界面";
+    case FrameLatencyStage::Worker:   return "处理线程";
+    case FrameLatencyStage::Event:    return "事件分发";
+    case FrameLatencyStage::UiUpdate: return "界面更新";
+    case FrameLatencyStage::Paint:    return "绘制";
+    case FrameLatencyStage::Total:    return "端到端";
+    default:                          return "未知";
+    }
+}
+
+QString FrameLatencyMonitor::metricPrefix(FrameLatencyStage stage)
+{
+    switch (stage) {
+    case FrameLatencyStage::Parse:    return "frameLatency.parse";
+    case FrameLatencyStage::Dispatch: return "frameLatency.dispatch";
+    case FrameLatencyStage::Worker:   return "frameLatency.worker";
+    case FrameLatencyStage::Event:    return "frameLatency.event";
+    case FrameLatencyStage::UiUpdate: return "frameLatency.uiUpdate";
+    case FrameLatencyStage::Paint:    return "frameLatency.paint";
+    case FrameLatencyStage::Total:    return "frameLatency.total";
+    default:                          return "frameLatency.unknown";
+    }
+}
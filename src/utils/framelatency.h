@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include "hdrhistogram.h"
+#include "monotonicclock.h"
+
+class MetricHistogram;
+
+// 接收帧从读取到显示经过的阶段，时间均为 MonotonicClock::nowNs()
+enum class FrameLatencyStage {
+    Parse = 0,      // 读到帧的最后一个字节（ProtocolFrame::receivedNs）→ 帧校验通过（timestampNs）
+    Dispatch,       // 校验通过 → 界面线程收到帧（含批量投递的等待和跨线程队列）
+    Worker,         // 校验通过 → DataProcessWorker 处理完该帧的任务
+    Event,          // EventCoordinator 分发携带帧数据的事件
+    UiUpdate,       // 提交到 UIUpdateOptimizer → 更新回调执行
+    Paint,          // 界面更新数值 → 显示该数值的那次绘制
+    Total,          // 读取 → 绘制
+    StageCount
+};
+
+// 端到端帧延迟监控 - 各阶段和总延迟的 HDR 直方图，累计值和周期窗口分别记录。
+// 周期窗口由 PerformanceMonitor 每次采集时取走，转换为自定义指标参与告警。任意线程调用
+class FrameLatencyMonitor
+{
+public:
+    static constexpr int STAGE_COUNT = static_cast<int>(FrameLatencyStage::StageCount);
+    using Histograms = std::array<HdrHistogram, STAGE_COUNT>;
+
+    static FrameLatencyMonitor* getInstance();
+
+    void record(FrameLatencyStage stage, qint64 latencyNs);
+    // 起点到当前时间，起点未知（<= 0）时不记录
+    void recordSince(FrameLatencyStage stage, qint64 sinceNs)
+    {
+        if (sinceNs > 0) {
+            record(stage, MonotonicClock::nowNs() - sinceNs);
+        }
+    }
+
+    HdrHistogram histogram(FrameLatencyStage stage) const;
+    // 取出上次调用以来的窗口并清零
+    Histograms takeWindow();
+
+    // 每个阶段一行摘要（累计值）
+    QString report() const;
+    void reset();
+
+    static QString stageName(FrameLatencyStage stage);
+    // 自定义指标名中的阶段部分，例如 Total → "frameLatency.total"
+    static QString metricPrefix(FrameLatencyStage stage);
+
+private:
+    FrameLatencyMonitor();
+
+    mutable QMutex m_mutex;
+    Histograms m_total;
+    Histograms m_window;
+    std::array<MetricHistogram*, STAGE_COUNT> m_stageMetrics;   // 指标端点，记录时不需要 m_mutex
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <QString>
+#include <array>
+
+// 高分辨率延迟直方图（HDR 风格）- 按2的幂分段，每段再线性细分为 SUB_BUCKET_COUNT 个子桶，
+// 任意量级的相对误差不超过 1/SUB_BUCKET_COUNT（约3%）。单位纳秒，覆盖 0 至约18分钟，
+// 记录开销为常数且无内存分配；P99.9 等尾部百分位比 LatencyHistogram 的整段分桶精确得多。
+// 非线程安全，跨线程使用时由持有者加锁
+class HdrHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_VALUE_BITS = 40;                   // 2^40ns ≈ 18分钟，更长的值按上限记录
+    static constexpr int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    static constexpr qint64 MAX_TRACKABLE_NS = (1LL << MAX_VALUE_BITS) - 1;
+
+    void record(qint64 valueNs) {
+        const qint64 clamped = qBound<qint64>(0, valueNs, MAX_TRACKABLE_NS);
+        ++m_buckets[indexOf(static_cast<quint64>(clamped))];
+        if (m_count == 0 || clamped < m_minNs) m_minNs = clamped;
+        if (clamped > m_maxNs) m_maxNs = clamped;
+        ++m_count;
+        m_totalNs += clamped;
+    }
+
+    void reset() { *this = HdrHistogram(); }
+
+    void merge(const HdrHistogram& other) {
+        if (other.m_count == 0) return;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            m_buckets[i] += other.m_buckets[i];
+        }
+        m_minNs = m_count == 0 ? other.m_minNs : qMin(m_minNs, other.m_minNs);
+        m_maxNs = qMax(m_maxNs, other.m_maxNs);
+        m_count += other.m_count;
+        m_totalNs += other.m_totalNs;
+    }
+
+    // 同一直方图两次累计快照之差（this 为较晚的快照，两次之间不能 reset），即两次快照之间记录的值。
+    // 最小/最大值无法相减，按首末非空子桶的边界估计
+    HdrHistogram since(const HdrHistogram& earlier) const {
+        HdrHistogram window;
+        int first = -1;
+        int last = -1;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            window.m_buckets[i] = m_buckets[i] - earlier.m_buckets[i];
+            if (window.m_buckets[i] != 0) {
+                if (first < 0) first = i;
+                last = i;
+            }
+        }
+        if (first < 0) return window;
+        window.m_count = m_count - earlier.m_count;
+        window.m_totalNs = m_totalNs - earlier.m_totalNs;
+        window.m_minNs = first == 0 ? 0 : upperBoundOf(first - 1) + 1;
+        window.m_maxNs = qMin(upperBoundOf(last), m_maxNs);
+        return window;
+    }
+
+    qint64 count() const { return m_count; }
+    qint64 minNs() const { return m_minNs; }
+    qint64 maxNs() const { return m_maxNs; }
+    double meanNs() const { return m_count > 0 ? static_cast<double>(m_totalNs) / m_count : 0.0; }
+
+    // 百分位值（所在子桶的上界，不超过实际最大值），percentile 取值 0-100
+    qint64 percentileNs(double percentile) const {
+        if (m_count == 0) return 0;
+        const qint64 target = qBound<qint64>(1, static_cast<qint64>(m_count * percentile / 100.0 + 0.5), m_count);
+        qint64 accumulated = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i) {
+            accumulated += m_buckets[i];
+            if (accumulated >= target) {
+                return qMin(upperBoundOf(i), m_maxNs);
+            }
+        }
+        return m_maxNs;
+    }
+
+    // 单行摘要，例如 "次数=1200, P50=812.0us, P99=1.9ms, P99.9=7.4ms, 最大=9.1ms"
+    QString summary() const {
+        return QString("次数=%1, P50=%2, P99=%3, P99.9=%4, 最大=%5")
+            .arg(m_count)
+            .arg(formatNs(percentileNs(50.0)))
+            .arg(formatNs(percentileNs(99.0)))
+            .arg(formatNs(percentileNs(99.9)))
+            .arg(formatNs(m_maxNs));
+    }
+
+    static QString formatNs(qint64 ns) {
+        if (ns < 1000) return QString("%1ns").arg(ns);
+        if (ns < 1000000) return QString("%1us").arg(ns / 1000.0, 0, 'f', 1);
+        if (ns < 1000000000) return QString("%1ms").arg(ns / 1000000.0, 0, 'f', 2);
+        return QString("%1s").arg(ns / 1000000000.0, 0, 'f', 3);
+    }
+
+private:
+    // 小于 SUB_BUCKET_COUNT 的值逐一计数；其余按最高位所在段和其后 SUB_BUCKET_BITS 位定位
+    static int indexOf(quint64 value) {
+        if (value < SUB_BUCKET_COUNT) return static_cast<int>(value);
+        const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+        const int segment = msb - SUB_BUCKET_BITS + 1;
+        const int sub = static_cast<int>(value >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT;
+        return segment * SUB_BUCKET_COUNT + sub;
+    }
+
+    static qint64 upperBoundOf(int index) {
+        if (index < SUB_BUCKET_COUNT) return index;
+        const int segment = index / SUB_BUCKET_COUNT;
+        const qint64 sub = index % SUB_BUCKET_COUNT;
+        const int shift = segment - 1;
+        return ((SUB_BUCKET_COUNT + sub + 1) << shift) - 1;
+    }
+
+    std::array<quint32, BUCKET_COUNT> m_buckets{};
+    qint64 m_count = 0;
+    qint64 m_totalNs = 0;
+    qint64 m_minNs = 0;
+    qint64 m_maxNs = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <QString>
+#include <array>
+
+// 延迟直方图 - 按2的幂微秒分桶，记录开销为常数且无内存分配
+// 第0桶为 <1us，第i桶为 [2^(i-1), 2^i) us，最后一桶收纳所有更长的延迟
+class LatencyHistogram
+{
+public:
+    static constexpr int BUCKET_COUNT = 20;     // 最后一桶起点约为 262ms
+
+    void record(qint64 latencyNs) {
+        if (latencyNs < 0) latencyNs = 0;
+        const quint64 us = static_cast<quint64>(latencyNs / 1000);
+        const int index = us == 0 ? 0 : qMin(BUCKET_COUNT - 1, 64 - static_cast<int>(qCountLeadingZeroBits(us)));
+        ++m_buckets[index];
+        ++m_count;
+        m_totalNs += latencyNs;
+        if (latencyNs > m_maxNs) m_maxNs = latencyNs;
+    }
+
+    void reset() { *this = LatencyHistogram(); }
+
+    qint64 count() const { return m_count; }
+    qint64 maxNs() const { return m_maxNs; }
+    double averageUs() const { return m_count > 0 ? m_totalNs / 1000.0 / m_count : 0.0; }
+    quint32 bucket(int index) const { return m_buckets[index]; }
+
+    // 百分位延迟（取所在桶的上界，单位us），percentile 取值 0-100
+    double percentileUs(double percentile) const {
+        if (m_count == 0) return 0.0;
+        const qint64 target = qMax<qint64>(1, static_cast<qint64>(m_count * percentile / 100.0 + 0.5));
+        qint64 accumulated = 0;
+        for (int i = 0; i < BUCKET_COUNT - 1; ++i) {
+            accumulated += m_buckets[i];
+            if (accumulated >= target) {
+                return static_cast<double>(1ULL << i);
+            }
+        }
+        return m_maxNs / 1000.0;
+    }
+
+    // 单行摘要，例如 "次数=120, 平均=3.2us, P50=4us, P99=64us, 最大=81.5us"
+    QString summary() const {
+        return QString("次数=%1, 平均=%2us, P50=%3us, P99=%4us, 最大=%5us")
+            .arg(m_count)
+            .arg(averageUs(), 0, 'f', 1)
+            .arg(percentileUs(50.0), 0, 'f', 0)
+            .arg(percentileUs(99.0), 0, 'f', 0)
+            .arg(m_maxNs / 1000.0, 0, 'f', 1);
+    }
+
+private:
+    std::array<quint32, BUCKET_COUNT> m_buckets{};
+    qint64 m_count = 0;
+    qint64 m_totalNs = 0;
+    qint64 m_maxNs = 0;
+};
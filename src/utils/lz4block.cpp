@@ -0,0 +1,198 @@
+#include "lz4block.h"
+#include <cstring>
+
+namespace {
+
+constexpr int MIN_MATCH = 4;
+constexpr int LAST_LITERALS = 5;     // 块末尾至少这么多字节为字面量
+constexpr int MF_LIMIT = 12;         // 最后一个匹配必须在块末尾这么多字节之前开始
+constexpr int MAX_DISTANCE = 65535;
+constexpr int HASH_LOG = 12;
+
+inline quint32 read32(const quint8* p)
+{
+    quint32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline quint32 hashSequence(quint32 sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// 长度字段超过 15 的部分按 255 一字节续写需要的字节数
+inline int lengthExtraBytes(int length)
+{
+    return length >= 15 ? (length - 15) / 255 + 1 : 0;
+}
+
+inline quint8* writeLengthExtra(quint8* op, int length)
+{
+    if (length >= 15) {
+        length -= 15;
+        while (length >= 255) {
+            *op++ = 255;
+            length -= 255;
+        }
+        *op++ = static_cast<quint8>(length);
+    }
+    return op;
+}
+
+// 读取续写的长度字节，越界或长度超出 limit 时返回false
+inline bool readLengthExtra(const quint8*& ip, const quint8* iend, int& length, int limit)
+{
+    quint8 byte;
+    do {
+        if (ip >= iend) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+        if (length > limit) {
+            return false;
+        }
+    } while (byte == 255);
+    return true;
+}
+
+}
+
+int Lz4Block::compress(const char* src, int size, char* dst, int capacity)
+{
+    if (size < 0 || capacity <= 0) {
+        return 0;
+    }
+
+    const quint8* const base = reinterpret_cast<const quint8*>(src);
+    const quint8* const iend = base + size;
+    const quint8* ip = base;
+    const quint8* anchor = base;
+    quint8* op = reinterpret_cast<quint8*>(dst);
+    quint8* const oend = op + capacity;
+
+    if (size > MF_LIMIT) {
+        const quint8* const mflimit = iend - MF_LIMIT;
+        const quint8* const matchlimit = iend - LAST_LITERALS;
+        quint32 table[1 << HASH_LOG] = {};
+
+        while (ip < mflimit) {
+            const quint32 sequence = read32(ip);
+            const quint32 h = hashSequence(sequence);
+            const quint8* ref = base + table[h];
+            table[h] = static_cast<quint32>(ip - base);
+
+            if (ref >= ip || ip - ref > MAX_DISTANCE || read32(ref) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            // 向前扩展到上一个序列的末尾，向后扩展到不能再匹配的位置
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                --ip;
+                --ref;
+            }
+            const quint8* matchEnd = ip + MIN_MATCH;
+            const quint8* refEnd = ref + MIN_MATCH;
+            while (matchEnd < matchlimit && *matchEnd == *refEnd) {
+                ++matchEnd;
+                ++refEnd;
+            }
+
+            const int literalLength = static_cast<int>(ip - anchor);
+            const int matchLength = static_cast<int>(matchEnd - ip) - MIN_MATCH;
+            const int required = 1 + lengthExtraBytes(literalLength) + literalLength + 2 + lengthExtraBytes(matchLength);
+            if (oend - op < required) {
+                return 0;
+            }
+
+            quint8* token = op++;
+            *token = static_cast<quint8>((qMin(literalLength, 15) << 4) | qMin(matchLength, 15));
+            op = writeLengthExtra(op, literalLength);
+            std::memcpy(op, anchor, literalLength);
+            op += literalLength;
+            const int offset = static_cast<int>(ip - ref);
+            *op++ = static_cast<quint8>(offset & 0xFF);
+            *op++ = static_cast<quint8>(offset >> 8);
+            op = writeLengthExtra(op, matchLength);
+
+            ip = matchEnd;
+            anchor = ip;
+            if (ip < mflimit) {
+                table[hashSequence(read32(ip - 2))] = static_cast<quint32>(ip - 2 - base);
+            }
+        }
+    }
+
+    // 最后一个序列只有字面量
+    const int literalLength = static_cast<int>(iend - anchor);
+    if (oend - op < 1 + lengthExtraBytes(literalLength) + literalLength) {
+        return 0;
+    }
+    *op++ = static_cast<quint8>(qMin(literalLength, 15) << 4);
+    op = writeLengthExtra(op, literalLength);
+    std::memcpy(op, anchor, literalLength);
+    op += literalLength;
+
+    return static_cast<int>(op - reinterpret_cast<quint8*>(dst));
+}
+
+bool Lz4Block::decompress(const char* src, int size, char* dst, int originalSize)
+{
+    if (size <= 0 || originalSize < 0) {
+        return false;
+    }
+
+    const quint8* ip = reinterpret_cast<const quint8*>(src);
+    const quint8* const iend = ip + size;
+    quint8* const obase = reinterpret_cast<quint8*>(dst);
+    quint8* op = obase;
+    quint8* const oend = obase + originalSize;
+
+    while (ip < iend) {
+        const quint8 token = *ip++;
+
+        int literalLength = token >> 4;
+        if (literalLength == 15 && !readLengthExtra(ip, iend, literalLength, originalSize)) {
+            return false;
+        }
+        if (literalLength > iend - ip || literalLength > oend - op) {
+            return false;
+        }
+        std::memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == iend) {
+            break;  // 最后一个序列
+        }
+
+        if (iend - ip < 2) {
+            return false;
+        }
+        const int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op - obase) {
+            return false;
+        }
+
+        int matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLengthExtra(ip, iend, matchLength, originalSize)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > oend - op) {
+            return false;
+        }
+
+        // 匹配可以与输出重叠（offset 小于长度时重复前面的字节），逐字节复制
+        const quint8* match = op - offset;
+        for (int i = 0; i < matchLength; ++i) {
+            op[i] = match[i];
+        }
+        op += matchLength;
+    }
+
+    return op == oend;
+}
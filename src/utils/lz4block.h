@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QtGlobal>
+
+// LZ4 块格式编解码（不含帧格式头）
+// 输出与 lz4 库的 LZ4_compress_default / LZ4_decompress_safe 互通，设备端可直接使用标准库解压；
+// 压缩取单路哈希表贪心匹配，速度优先，适合链路上的实时压缩
+class Lz4Block
+{
+public:
+    // 压缩 size 字节最坏情况下需要的输出空间
+    static int compressBound(int size) { return size + size / 255 + 16; }
+
+    // 压缩到 dst，返回写入的字节数，空间不足返回0
+    static int compress(const char* src, int size, char* dst, int capacity);
+
+    // 解压到 dst，输出必须恰好为 originalSize 字节；数据损坏或长度不符时返回false
+    static bool decompress(const char* src, int size, char* dst, int originalSize);
+
+private:
+    Lz4Block() = delete;
+};
@@ -0,0 +1,228 @@
+#include "metricring.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr double POSITIVE_INFINITY = std::numeric_limits<double>::infinity();
+constexpr double NEGATIVE_INFINITY = -std::numeric_limits<double>::infinity();
+}
+
+MetricRing::MetricRing(int columnCount, int capacity)
+{
+    reset(columnCount, capacity);
+}
+
+void MetricRing::reset(int columnCount, int capacity)
+{
+    m_columns = std::max(0, columnCount);
+    m_capacity = std::max(0, capacity);
+
+    const size_t cells = static_cast<size_t>(m_columns) * m_capacity;
+    m_timestamps.assign(static_cast<size_t>(m_capacity), 0);
+    m_values.assign(cells, 0.0);
+    m_before.assign(cells, 0.0);
+    m_running.assign(static_cast<size_t>(m_columns), 0.0);
+    m_minTree.assign(2 * cells, POSITIVE_INFINITY);
+    m_maxTree.assign(2 * cells, NEGATIVE_INFINITY);
+    m_head = 0;
+    m_size = 0;
+    m_sinceRebase = 0;
+}
+
+void MetricRing::setCapacity(int capacity)
+{
+    capacity = std::max(0, capacity);
+    if (capacity == m_capacity) {
+        return;
+    }
+
+    MetricRing resized(m_columns, capacity);
+    std::vector<double> row(static_cast<size_t>(m_columns));
+    for (int i = std::max(0, m_size - capacity); i < m_size; ++i) {
+        for (int column = 0; column < m_columns; ++column) {
+            row[static_cast<size_t>(column)] = valueAt(column, i);
+        }
+        resized.append(timestampAt(i), row.data());
+    }
+    *this = std::move(resized);
+}
+
+qint64 MetricRing::bytesPerSample(int columnCount)
+{
+    // 时间戳，每列的数值、累计和，以及两棵线段树各两个节点
+    return static_cast<qint64>(sizeof(qint64) + static_cast<size_t>(std::max(0, columnCount)) * 6 * sizeof(double));
+}
+
+qint64 MetricRing::memoryUsage() const
+{
+    return m_capacity * bytesPerSample(m_columns) + static_cast<qint64>(m_running.size() * sizeof(double));
+}
+
+void MetricRing::clear()
+{
+    reset(m_columns, m_capacity);
+}
+
+void MetricRing::append(qint64 timestampMs, const double* values)
+{
+    if (m_capacity == 0) {
+        return;
+    }
+
+    int target;
+    if (m_size < m_capacity) {
+        target = slot(m_size);
+        ++m_size;
+    } else {
+        target = m_head;
+        if (++m_head == m_capacity) {
+            m_head = 0;
+        }
+    }
+
+    // 槽位尚未覆盖前上一个采样仍是最新的
+    if (m_size > 1) {
+        timestampMs = std::max(timestampMs, timestampAt(m_size - 2));
+    }
+    m_timestamps[static_cast<size_t>(target)] = timestampMs;
+
+    for (int column = 0; column < m_columns; ++column) {
+        const size_t cell = columnOffset(column) + target;
+        const double value = values[column];
+        m_values[cell] = value;
+        m_before[cell] = m_running[static_cast<size_t>(column)];
+        m_running[static_cast<size_t>(column)] += value;
+        updateTrees(column, target, value);
+    }
+
+    if (++m_sinceRebase >= m_capacity) {
+        rebase();
+    }
+}
+
+int MetricRing::lowerBound(qint64 timestampMs) const
+{
+    int low = 0;
+    int high = m_size;
+    while (low < high) {
+        const int middle = low + (high - low) / 2;
+        if (timestampAt(middle) < timestampMs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+int MetricRing::upperBound(qint64 timestampMs) const
+{
+    int low = 0;
+    int high = m_size;
+    while (low < high) {
+        const int middle = low + (high - low) / 2;
+        if (timestampAt(middle) <= timestampMs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+double MetricRing::sum(int column, int begin, int end) const
+{
+    begin = std::max(begin, 0);
+    end = std::min(end, m_size);
+    if (begin >= end) {
+        return 0.0;
+    }
+    const size_t offset = columnOffset(column);
+    const size_t first = offset + slot(begin);
+    const size_t last = offset + slot(end - 1);
+    return m_before[last] + m_values[last] - m_before[first];
+}
+
+double MetricRing::average(int column, int begin, int end) const
+{
+    begin = std::max(begin, 0);
+    end = std::min(end, m_size);
+    return begin < end ? sum(column, begin, end) / (end - begin) : 0.0;
+}
+
+double MetricRing::minimum(int column, int begin, int end) const
+{
+    return queryRange(column, begin, end, true);
+}
+
+double MetricRing::maximum(int column, int begin, int end) const
+{
+    return queryRange(column, begin, end, false);
+}
+
+void MetricRing::updateTrees(int column, int slot, double value)
+{
+    double* minTree = m_minTree.data() + treeOffset(column);
+    double* maxTree = m_maxTree.data() + treeOffset(column);
+    int node = m_capacity + slot;
+    minTree[node] = value;
+    maxTree[node] = value;
+    for (node >>= 1; node >= 1; node >>= 1) {
+        minTree[node] = std::min(minTree[2 * node], minTree[2 * node + 1]);
+        maxTree[node] = std::max(maxTree[2 * node], maxTree[2 * node + 1]);
+    }
+}
+
+// 槽位 [first, last) 的最小值或最大值，自底向上的迭代线段树
+double MetricRing::queryTree(const std::vector<double>& tree, int column, int first, int last, bool minimum) const
+{
+    const double* nodes = tree.data() + treeOffset(column);
+    double result = minimum ? POSITIVE_INFINITY : NEGATIVE_INFINITY;
+    for (first += m_capacity, last += m_capacity; first < last; first >>= 1, last >>= 1) {
+        if (first & 1) {
+            const double value = nodes[first++];
+            result = minimum ? std::min(result, value) : std::max(result, value);
+        }
+        if (last & 1) {
+            const double value = nodes[--last];
+            result = minimum ? std::min(result, value) : std::max(result, value);
+        }
+    }
+    return result;
+}
+
+// 序号区间在环形槽位上最多分成两段
+double MetricRing::queryRange(int column, int begin, int end, bool minimum) const
+{
+    begin = std::max(begin, 0);
+    end = std::min(end, m_size);
+    if (begin >= end) {
+        return 0.0;
+    }
+    const std::vector<double>& tree = minimum ? m_minTree : m_maxTree;
+    const int first = slot(begin);
+    const int count = end - begin;
+    if (first + count <= m_capacity) {
+        return queryTree(tree, column, first, first + count, minimum);
+    }
+    const double head = queryTree(tree, column, first, m_capacity, minimum);
+    const double tail = queryTree(tree, column, 0, first + count - m_capacity, minimum);
+    return minimum ? std::min(head, tail) : std::max(head, tail);
+}
+
+// 以最旧的采样为基准重新计算累计和，区间和只依赖差值，结果不变
+void MetricRing::rebase()
+{
+    m_sinceRebase = 0;
+    if (m_size == 0) {
+        return;
+    }
+    for (int column = 0; column < m_columns; ++column) {
+        const size_t offset = columnOffset(column);
+        const double base = m_before[offset + m_head];
+        for (int i = 0; i < m_size; ++i) {
+            m_before[offset + slot(i)] -= base;
+        }
+        m_running[static_cast<size_t>(column)] -= base;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+
+// 定长多列指标环形缓冲区（性能监控历史）
+//
+// 每个采样为一个时间戳（毫秒）和 columnCount 个数值，各列分别存放在连续数组中，容量一次分配，
+// append() 不分配内存，满了之后覆盖最旧的采样。时间戳保持非递减（早于上一个时按上一个记录），
+// 按时间查找序号为二分查找。
+//
+// 区间查询的序号按时间顺序，0 为最旧的采样，区间为 [begin, end)：
+//   sum / average  O(1)：每个采样记录它之前的累计和，区间和为两端相减。累计和每写满一轮以最旧的采样
+//                  为基准重新归零，数值不会随运行时间无限增大而丢失精度
+//   minimum / maximum  O(log n)：每列一棵以环形槽位为叶子的线段树，append() 时更新一条路径
+// 空区间的查询结果为 0。非线程安全。
+class MetricRing
+{
+public:
+    explicit MetricRing(int columnCount = 0, int capacity = 0);
+
+    // 清空并重新分配
+    void reset(int columnCount, int capacity);
+    // 重新分配并保留最新的 min(size, capacity) 个采样
+    void setCapacity(int capacity);
+    void clear();
+
+    // 一个采样在各缓冲区中占用的字节数，用于按内存上限换算容量
+    static qint64 bytesPerSample(int columnCount);
+    qint64 memoryUsage() const;
+
+    int columnCount() const { return m_columns; }
+    int capacity() const { return m_capacity; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // values 为 columnCount 个数值
+    void append(qint64 timestampMs, const double* values);
+
+    qint64 timestampAt(int index) const { return m_timestamps[slot(index)]; }
+    double valueAt(int column, int index) const { return m_values[columnOffset(column) + slot(index)]; }
+
+    // 第一个时间戳 >= timestampMs 的序号，全部更早时返回 size()
+    int lowerBound(qint64 timestampMs) const;
+    // 第一个时间戳 > timestampMs 的序号
+    int upperBound(qint64 timestampMs) const;
+
+    double sum(int column, int begin, int end) const;
+    double average(int column, int begin, int end) const;
+    double minimum(int column, int begin, int end) const;
+    double maximum(int column, int begin, int end) const;
+
+private:
+    int slot(int index) const
+    {
+        const int position = m_head + index;
+        return position >= m_capacity ? position - m_capacity : position;
+    }
+    size_t columnOffset(int column) const { return static_cast<size_t>(column) * m_capacity; }
+    size_t treeOffset(int column) const { return static_cast<size_t>(column) * 2 * m_capacity; }
+
+    void updateTrees(int column, int slot, double value);
+    double queryTree(const std::vector<double>& tree, int column, int first, int last, bool minimum) const;
+    double queryRange(int column, int begin, int end, bool minimum) const;
+    void rebase();
+
+    int m_columns = 0;
+    int m_capacity = 0;
+    int m_head = 0;                     // 最旧的采样所在槽位
+    int m_size = 0;
+    int m_sinceRebase = 0;
+    std::vector<qint64> m_timestamps;   // [槽位]
+    std::vector<double> m_values;       // [列][槽位]
+    std::vector<double> m_before;       // [列][槽位]：该采样之前的累计和
+    std::vector<double> m_running;      // [列]：全部采样的累计和
+    std::vector<double> m_minTree;      // [列][节点]，叶子为 capacity + 槽位
+    std::vector<double> m_maxTree;
+};
@@ -0,0 +1,256 @@
+#include "metricsregistry.h"
+#include "../constants.h"
+#include <QDebug>
+#include <QMutex>
+#include <QtMath>
+
+namespace {
+
+// 指标族：注册后 name、help、type 不再修改，head 发布后读取方即可遍历
+struct MetricFamily {
+    const char* name = nullptr;
+    const char* help = nullptr;
+    int type = 0;
+    std::atomic<MetricSeries*> head{nullptr};
+    MetricSeries* tail = nullptr;               // 受 s_registerMutex 保护
+};
+
+QMutex s_registerMutex;
+MetricFamily s_families[System::METRICS_MAX_FAMILIES];
+std::atomic<int> s_familyCount{0};
+
+void appendValue(QByteArray& out, double value)
+{
+    if (qIsNaN(value)) {
+        out.append("NaN");
+    } else if (qIsInf(value)) {
+        out.append(value > 0 ? "+Inf" : "-Inf");
+    } else {
+        out.append(QByteArray::number(value, 'g', 15));
+    }
+}
+
+void appendSeriesName(QByteArray& out, const QByteArray& name, const char* suffix, const QByteArray& labels,
+                      const QByteArray& extraLabel = QByteArray())
+{
+    out.append(name);
+    out.append(suffix);
+    if (labels.isEmpty() && extraLabel.isEmpty()) {
+        return;
+    }
+    out.append('{');
+    out.append(labels);
+    if (!labels.isEmpty() && !extraLabel.isEmpty()) {
+        out.append(',');
+    }
+    out.append(extraLabel);
+    out.append('}');
+}
+
+const char* typeName(int type)
+{
+    switch (type) {
+    case 0: return "counter";
+    case 1: return "gauge";
+    default: return "histogram";
+    }
+}
+
+}
+
+void MetricCounter::render(QByteArray& out, const QByteArray& name) const
+{
+    appendSeriesName(out, name, "", labels());
+    out.append(' ');
+    out.append(QByteArray::number(value()));
+    out.append('\n');
+}
+
+void MetricGauge::render(QByteArray& out, const QByteArray& name) const
+{
+    appendSeriesName(out, name, "", labels());
+    out.append(' ');
+    appendValue(out, value());
+    out.append('\n');
+}
+
+MetricHistogram::MetricHistogram(const std::vector<qint64>& upperBoundsNs)
+    : m_boundCount(static_cast<int>(upperBoundsNs.size()))
+    , m_upperBoundsNs(new qint64[upperBoundsNs.size()])
+    , m_buckets(new std::atomic<quint64>[upperBoundsNs.size() + 1])
+{
+    for (int i = 0; i < m_boundCount; ++i) {
+        m_upperBoundsNs[i] = upperBoundsNs[i];
+    }
+    for (int i = 0; i <= m_boundCount; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::observe(qint64 valueNs)
+{
+    int index = 0;
+    while (index < m_boundCount && valueNs > m_upperBoundsNs[index]) {
+        ++index;
+    }
+    m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(valueNs, std::memory_order_relaxed);
+}
+
+void MetricHistogram::render(QByteArray& out, const QByteArray& name) const
+{
+    // 总数由各桶累加得到，与 +Inf 桶一致
+    quint64 cumulative = 0;
+    for (int i = 0; i <= m_boundCount; ++i) {
+        cumulative += m_buckets[i].load(std::memory_order_relaxed);
+        QByteArray le("le=\"");
+        if (i < m_boundCount) {
+            le.append(QByteArray::number(m_upperBoundsNs[i] / 1.0e9, 'g', 15));
+        } else {
+            le.append("+Inf");
+        }
+        le.append('"');
+        appendSeriesName(out, name, "_bucket", labels(), le);
+        out.append(' ');
+        out.append(QByteArray::number(cumulative));
+        out.append('\n');
+    }
+    appendSeriesName(out, name, "_sum", labels());
+    out.append(' ');
+    appendValue(out, m_sumNs.load(std::memory_order_relaxed) / 1.0e9);
+    out.append('\n');
+    appendSeriesName(out, name, "_count", labels());
+    out.append(' ');
+    out.append(QByteArray::number(cumulative));
+    out.append('\n');
+}
+
+const std::vector<qint64>& MetricsRegistry::latencyBucketsNs()
+{
+    static const std::vector<qint64> buckets = {
+        100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000, 25000000,
+        50000000, 100000000, 250000000, 500000000, 1000000000, 2500000000LL};
+    return buckets;
+}
+
+const std::vector<qint64>& MetricsRegistry::frameBucketsNs()
+{
+    static const std::vector<qint64> buckets = {
+        1000000, 2000000, 4000000, 8000000, 16000000, 33000000, 50000000, 100000000, 250000000};
+    return buckets;
+}
+
+MetricCounter* MetricsRegistry::counter(const char* name, const char* help, const QString& labels)
+{
+    return static_cast<MetricCounter*>(registerSeries(Type::Counter, name, help, labels,
+                                                      []() { return new MetricCounter(); }));
+}
+
+MetricGauge* MetricsRegistry::gauge(const char* name, const char* help, const QString& labels)
+{
+    return static_cast<MetricGauge*>(registerSeries(Type::Gauge, name, help, labels,
+                                                    []() { return new MetricGauge(); }));
+}
+
+MetricHistogram* MetricsRegistry::histogram(const char* name, const char* help, const QString& labels,
+                                            const std::vector<qint64>& upperBoundsNs)
+{
+    return static_cast<MetricHistogram*>(registerSeries(Type::Histogram, name, help, labels,
+                                                        [&upperBoundsNs]() { return new MetricHistogram(upperBoundsNs); }));
+}
+
+MetricSeries* MetricsRegistry::registerSeries(Type type, const char* name, const char* help, const QString& labels,
+                                              const std::function<MetricSeries*()>& create)
+{
+    const QByteArray labelBytes = labels.toUtf8();
+    QMutexLocker locker(&s_registerMutex);
+
+    const int familyCount = s_familyCount.load(std::memory_order_relaxed);
+    MetricFamily* family = nullptr;
+    for (int i = 0; i < familyCount; ++i) {
+        if (qstrcmp(s_families[i].name, name) == 0) {
+            family = &s_families[i];
+            break;
+        }
+    }
+
+    // 类型冲突或族已满时返回不挂入链表的序列：调用方照常写入，只是不导出
+    if (family && family->type != static_cast<int>(type)) {
+        qWarning() << "[MetricsRegistry] 指标类型与已注册的不一致:" << name;
+        return create();
+    }
+    if (!family) {
+        if (familyCount >= System::METRICS_MAX_FAMILIES) {
+            qWarning() << "[MetricsRegistry] 指标族已满，不导出:" << name;
+            return create();
+        }
+        family = &s_families[familyCount];
+        family->name = name;
+        family->help = help;
+        family->type = static_cast<int>(type);
+        s_familyCount.store(familyCount + 1, std::memory_order_release);
+    }
+
+    for (MetricSeries* series = family->head.load(std::memory_order_relaxed); series;
+         series = series->m_next.load(std::memory_order_relaxed)) {
+        if (series->m_labels == labelBytes) {
+            series->m_retired.store(false, std::memory_order_relaxed);
+            return series;
+        }
+    }
+
+    MetricSeries* series = create();
+    series->m_labels = labelBytes;
+    if (family->tail) {
+        family->tail->m_next.store(series, std::memory_order_release);
+    } else {
+        family->head.store(series, std::memory_order_release);
+    }
+    family->tail = series;
+    return series;
+}
+
+void MetricsRegistry::retire(const QString& labels)
+{
+    const QByteArray labelBytes = labels.toUtf8();
+    QMutexLocker locker(&s_registerMutex);
+    const int familyCount = s_familyCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < familyCount; ++i) {
+        for (MetricSeries* series = s_families[i].head.load(std::memory_order_relaxed); series;
+             series = series->m_next.load(std::memory_order_relaxed)) {
+            if (series->m_labels == labelBytes) {
+                series->m_retired.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+QString MetricsRegistry::label(const char* key, const QString& value)
+{
+    QString escaped = value;
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return QString("%1=\"%2\"").arg(QLatin1String(key), escaped);
+}
+
+QByteArray MetricsRegistry::render()
+{
+    QByteArray out;
+    out.reserve(16 * 1024);
+    const int familyCount = s_familyCount.load(std::memory_order_acquire);
+    for (int i = 0; i < familyCount; ++i) {
+        const MetricFamily& family = s_families[i];
+        MetricSeries* head = family.head.load(std::memory_order_acquire);
+        if (!head) {
+            continue;
+        }
+        const QByteArray name(family.name);
+        out.append("# HELP ").append(name).append(' ').append(family.help).append('\n');
+        out.append("# TYPE ").append(name).append(' ').append(typeName(family.type)).append('\n');
+        for (MetricSeries* series = head; series; series = series->m_next.load(std::memory_order_acquire)) {
+            if (!series->isRetired()) {
+                series->render(out, name);
+            }
+        }
+    }
+    return out;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// 指标注册表 - 以 Prometheus 文本格式导出的计数器、仪表和直方图
+//
+// 指标在组件创建时注册，得到的序列对象一直有效（进程结束前不释放），热路径只做 relaxed 原子写，
+// 不加锁、不分配内存。render() 可在任意线程调用，只做原子读，不会阻塞写入方；
+// 各序列分别读取，同一次导出中的不同序列不保证是同一时刻的值。
+// 注册和 render() 之间同样不加锁：指标族是定长数组，序列是只追加的链表，发布后不再修改。
+//
+// 同名同标签再次注册返回原有序列并恢复导出；组件销毁时 retire() 停止导出它的序列。
+// 指标族数量上限为 System::METRICS_MAX_FAMILIES，超出后注册返回不导出的序列，写入照常但不可见。
+class MetricSeries
+{
+public:
+    virtual ~MetricSeries() = default;
+
+    bool isRetired() const { return m_retired.load(std::memory_order_relaxed); }
+
+protected:
+    MetricSeries() = default;
+
+    const QByteArray& labels() const { return m_labels; }
+
+private:
+    friend class MetricsRegistry;
+
+    virtual void render(QByteArray& out, const QByteArray& name) const = 0;
+
+    QByteArray m_labels;                        // 不含花括号，如 connection="tcp1"
+    std::atomic<bool> m_retired{false};
+    std::atomic<MetricSeries*> m_next{nullptr};
+
+    Q_DISABLE_COPY(MetricSeries)
+};
+
+// 单调递增的计数；镜像已有的累计统计时用 set()，统计清零后导出值随之回落，按计数器重置处理
+class MetricCounter : public MetricSeries
+{
+public:
+    void add(qint64 delta = 1) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+    void set(qint64 value) { m_value.store(value, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    void render(QByteArray& out, const QByteArray& name) const override;
+
+    std::atomic<qint64> m_value{0};
+};
+
+// 可增可减的当前值，如队列深度、命中率
+class MetricGauge : public MetricSeries
+{
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    void render(QByteArray& out, const QByteArray& name) const override;
+
+    std::atomic<double> m_value{0.0};
+};
+
+// 耗时分布：按纳秒记录，导出为秒。桶边界在注册时确定，记录为一次线性查找和两次原子加法
+class MetricHistogram : public MetricSeries
+{
+public:
+    explicit MetricHistogram(const std::vector<qint64>& upperBoundsNs);
+
+    void observe(qint64 valueNs);
+
+private:
+    void render(QByteArray& out, const QByteArray& name) const override;
+
+    const int m_boundCount;
+    std::unique_ptr<qint64[]> m_upperBoundsNs;              // 升序，最后一个桶（+Inf）没有边界
+    std::unique_ptr<std::atomic<quint64>[]> m_buckets;      // 各桶自身的计数，导出时累加
+    std::atomic<qint64> m_sumNs{0};
+};
+
+class MetricsRegistry
+{
+public:
+    // 常用的桶边界：通信往返 100us-2.5s，界面帧 1ms-250ms
+    static const std::vector<qint64>& latencyBucketsNs();
+    static const std::vector<qint64>& frameBucketsNs();
+
+    // name 和 help 须是字符串常量；同名指标的类型和 help 以第一次注册为准
+    static MetricCounter* counter(const char* name, const char* help, const QString& labels = QString());
+    static MetricGauge* gauge(const char* name, const char* help, const QString& labels = QString());
+    static MetricHistogram* histogram(const char* name, const char* help, const QString& labels,
+                                      const std::vector<qint64>& upperBoundsNs);
+
+    // 停止导出标签完全相同的所有序列（如一条连接的全部指标）
+    static void retire(const QString& labels);
+
+    // 单个标签 key="value"，值中的反斜杠、引号和换行按格式转义
+    static QString label(const char* key, const QString& value);
+
+    // Prometheus 文本格式（0.0.4）
+    static QByteArray render();
+
+private:
+    enum class Type {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    static MetricSeries* registerSeries(Type type, const char* name, const char* help, const QString& labels,
+                                        const std::function<MetricSeries*()>& create);
+
+    MetricsRegistry() = delete;
+};
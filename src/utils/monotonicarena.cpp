@@ -0,0 +1,93 @@
+#include "monotonicarena.h"
+#include <new>
+
+namespace {
+// 块头之后的数据区按最大基本对齐开始
+constexpr std::size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+}
+
+MonotonicArena::MonotonicArena(std::size_t initialBlockSize, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream ? upstream : std::pmr::new_delete_resource())
+    , m_initialBlockSize(qMax<std::size_t>(initialBlockSize, 256))
+    , m_blocks(nullptr)
+    , m_begin(nullptr)
+    , m_cursor(nullptr)
+    , m_end(nullptr)
+    , m_usedBeforeCurrent(0)
+    , m_capacity(0)
+    , m_highWaterMark(0)
+    , m_blockCount(0)
+    , m_upstreamAllocations(0)
+    , m_scopeDepth(0)
+{
+    addBlock(m_initialBlockSize);
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    releaseBlocks();
+}
+
+void MonotonicArena::reset()
+{
+    m_highWaterMark = highWaterMark();
+    
+    if (m_blockCount > 1) {
+        // 合并为一个块：下一批同样的用量只需一个块，分配全部走快速路径
+        const std::size_t capacity = m_capacity;
+        releaseBlocks();
+        addBlock(capacity);
+    }
+    
+    m_cursor = m_begin;
+    m_usedBeforeCurrent = 0;
+}
+
+void* MonotonicArena::allocateSlow(std::size_t bytes, std::size_t alignment)
+{
+    // 当前块剩余空间不足：按已有容量倍增，保证单次分配之后的摊还开销为常数
+    m_usedBeforeCurrent += static_cast<std::size_t>(m_end - m_begin);
+    addBlock(qMax(m_capacity, bytes + alignment));
+    
+    const std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(m_cursor) + alignment - 1)
+                                   & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    m_cursor = reinterpret_cast<char*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void MonotonicArena::addBlock(std::size_t minimumBytes)
+{
+    const std::size_t headerSize = alignUp(sizeof(Block), BLOCK_ALIGNMENT);
+    const std::size_t dataSize = alignUp(qMax(minimumBytes, m_initialBlockSize), BLOCK_ALIGNMENT);
+    const std::size_t totalSize = headerSize + dataSize;
+    
+    void* memory = m_upstream->allocate(totalSize, BLOCK_ALIGNMENT);
+    Block* block = new (memory) Block{m_blocks, totalSize};
+    m_blocks = block;
+    ++m_blockCount;
+    ++m_upstreamAllocations;
+    m_capacity += dataSize;
+    
+    m_begin = static_cast<char*>(memory) + headerSize;
+    m_cursor = m_begin;
+    m_end = m_begin + dataSize;
+}
+
+void MonotonicArena::releaseBlocks()
+{
+    Block* block = m_blocks;
+    while (block) {
+        Block* next = block->next;
+        m_upstream->deallocate(block, block->size, BLOCK_ALIGNMENT);
+        block = next;
+    }
+    m_blocks = nullptr;
+    m_begin = m_cursor = m_end = nullptr;
+    m_blockCount = 0;
+    m_capacity = 0;
+}
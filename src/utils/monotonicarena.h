@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// 单调（bump pointer）内存区 - 用于一批数据处理期间的临时对象
+// 分配只移动游标，释放为空操作，整批结束后 reset() 一次性回收。
+// 实现 std::pmr::memory_resource，批内的 std::pmr 容器直接以它为分配器。
+// 上一批用到多个内存块时，reset() 把它们合并为一个同等容量的块，稳态下每批不再向上游申请内存。
+// 非线程安全，只在拥有它的线程上使用
+class MonotonicArena : public std::pmr::memory_resource
+{
+public:
+    explicit MonotonicArena(std::size_t initialBlockSize = 4096,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~MonotonicArena() override;
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    // 回收全部分配，之前分配的内存不再有效（上面的对象不会被析构）
+    void reset();
+
+    std::size_t bytesUsed() const { return m_usedBeforeCurrent + static_cast<std::size_t>(m_cursor - m_begin); }
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t highWaterMark() const { return qMax(m_highWaterMark, bytesUsed()); }    // 单批最大用量
+    int blockCount() const { return m_blockCount; }
+    qint64 upstreamAllocations() const { return m_upstreamAllocations; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        const std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(m_cursor) + alignment - 1)
+                                       & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(m_end);
+        if (aligned <= end && bytes <= end - aligned) {
+            m_cursor = reinterpret_cast<char*>(aligned + bytes);
+            return reinterpret_cast<void*>(aligned);
+        }
+        return allocateSlow(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    friend class ArenaScope;
+
+    // 每个上游内存块的头部，块按申请顺序单向链接（m_blocks 为最新的块）
+    struct Block {
+        Block* next;
+        std::size_t size;           // 含头部的总字节数
+    };
+
+    void* allocateSlow(std::size_t bytes, std::size_t alignment);
+    void addBlock(std::size_t minimumBytes);
+    void releaseBlocks();
+
+private:
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_initialBlockSize;
+    Block* m_blocks;
+    char* m_begin;                  // 当前块的数据区
+    char* m_cursor;
+    char* m_end;
+    std::size_t m_usedBeforeCurrent;    // 之前各块已用字节数（含对齐和块尾浪费）
+    std::size_t m_capacity;
+    std::size_t m_highWaterMark;
+    int m_blockCount;
+    qint64 m_upstreamAllocations;
+    int m_scopeDepth;               // ArenaScope 嵌套深度
+};
+
+// 批处理作用域 - 析构时重置内存区。可以嵌套，只有最外层作用域结束时才重置，
+// 被整批处理调用的单条处理函数可以放心使用自己的作用域
+class ArenaScope
+{
+public:
+    explicit ArenaScope(MonotonicArena& arena) : m_arena(arena) { ++m_arena.m_scopeDepth; }
+    ~ArenaScope()
+    {
+        if (--m_arena.m_scopeDepth == 0) {
+            m_arena.reset();
+        }
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    MonotonicArena& m_arena;
+};
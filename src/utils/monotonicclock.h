@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QDateTime>
+#include <chrono>
+
+// 单调时钟换算的墙钟时间 - 进程内统一的时间戳来源
+//
+// 第一次调用时记录一对 (steady_clock, 墙钟) 作为锚点，之后的时间都由 steady_clock 的增量推算。
+// 读取只是一次 steady_clock::now()，不涉及时区换算；系统时间被 NTP 或手动调整时序列也不会倒退，
+// 环形缓冲区里的时间戳始终单调，可以二分查找。与 ProtocolFrame::timestampNs 使用同一个时钟。
+//
+// 热路径上的结构（帧、任务、事件、CAN 消息、日志记录）只保存 nowNs() 的返回值，
+// 显示或落盘时再用 toEpochMs()/dateTimeAt() 换算，不在每帧构造 QDateTime。
+// 日志的会话锚点也取自这里，日志时间与帧时间可以直接比较。
+class MonotonicClock
+{
+public:
+    // steady_clock 当前时间（纳秒）
+    static qint64 nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 当前时间（自 1970 年起的毫秒）
+    static qint64 epochMs() { return toEpochMs(nowNs()); }
+
+    // 把 nowNs() 或 ProtocolFrame::timestampNs 换算为墙钟纳秒/毫秒
+    static qint64 toEpochNs(qint64 monotonicNs)
+    {
+        const Anchor& anchor = Anchor::instance();
+        return anchor.epochNs + (monotonicNs - anchor.monotonicNs);
+    }
+
+    static qint64 toEpochMs(qint64 monotonicNs) { return floorDiv(toEpochNs(monotonicNs), NS_PER_MS); }
+
+    // toEpochMs 的逆换算，用于把界面上选定的墙钟时间转为查询范围
+    static qint64 fromEpochMs(qint64 epochMs)
+    {
+        const Anchor& anchor = Anchor::instance();
+        return anchor.monotonicNs + (epochMs * NS_PER_MS - anchor.epochNs);
+    }
+
+    static QDateTime toDateTime(qint64 epochMs) { return QDateTime::fromMSecsSinceEpoch(epochMs); }
+
+    // 单调时间戳对应的本地时间，只在显示和持久化时调用
+    static QDateTime dateTimeAt(qint64 monotonicNs) { return toDateTime(toEpochMs(monotonicNs)); }
+
+    // 锚点本身，写入日志会话头，离线解码时用同样的换算
+    static qint64 anchorMonotonicNs() { return Anchor::instance().monotonicNs; }
+    static qint64 anchorEpochNs() { return Anchor::instance().epochNs; }
+
+private:
+    static constexpr qint64 NS_PER_MS = 1000000;
+
+    // 锚点之前的时间戳也向下取整，毫秒值不会在锚点两侧重复
+    static constexpr qint64 floorDiv(qint64 value, qint64 divisor)
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    struct Anchor {
+        qint64 monotonicNs;
+        qint64 epochNs;
+
+        static const Anchor& instance()
+        {
+            static const Anchor anchor{nowNs(),
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::system_clock::now().time_since_epoch()).count()};
+            return anchor;
+        }
+    };
+
+    MonotonicClock() = delete;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 有界无锁多生产者单消费者队列（Vyukov 有界队列的单消费者版本）
+// 每个槽位带序号：生产者用 CAS 抢占写入位置，写完后发布序号；
+// 唯一的消费者按顺序读取，无需 CAS。容量向上取整为2的幂，队列满时 tryPush 返回 false。
+template <typename T>
+class BoundedMpscQueue
+{
+public:
+    explicit BoundedMpscQueue(int capacity)
+    {
+        size_t size = 2;
+        while (size < static_cast<size_t>(qMax(2, capacity))) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    // 任意线程调用
+    template <typename U>
+    bool tryPush(U&& value)
+    {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;   // 队列已满
+            } else {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只允许消费者线程调用
+    bool tryPop(T& value)
+    {
+        const size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell = &m_cells[position & m_mask];
+        if (cell->sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;   // 队列为空，或生产者尚未写完
+        }
+        // 移出后槽位不再持有资源（Qt 容器和字符串移动后为空）
+        value = std::move(cell->value);
+        cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+        m_dequeuePosition.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 近似值，仅供统计和空闲判断
+    int sizeApprox() const
+    {
+        const size_t enqueued = m_enqueuePosition.load(std::memory_order_relaxed);
+        const size_t dequeued = m_dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? static_cast<int>(enqueued - dequeued) : 0;
+    }
+
+    bool isEmptyApprox() const { return sizeApprox() == 0; }
+    int capacity() const { return static_cast<int>(m_mask + 1); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_enqueuePosition{0};
+    alignas(64) std::atomic<size_t> m_dequeuePosition{0};
+};
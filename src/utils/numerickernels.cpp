@@ -0,0 +1,785 @@
+#include "numerickernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NUMERICKERNELS_HAS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define NUMERICKERNELS_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NUMERICKERNELS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NUMERICKERNELS_TARGET(isa)
+#endif
+
+namespace {
+
+struct KernelTable {
+    ScanKernel kernel;
+    double (*sum)(const double*, int);
+    double (*dot)(const double*, const double*, int);
+    double (*sumSquaredDeviations)(const double*, int, double);
+    double (*centeredDot)(const double*, const double*, int, double, double);
+    double (*squaredDistance)(const double*, const double*, int);
+    double (*rampDot)(const double*, int);                  // Σ i * x[i]
+    void (*minMax)(const double*, int, double*, double*);
+    void (*scaleShift)(const double*, int, double, double, double*);
+};
+
+// ---------------- 标量实现 ----------------
+
+double sumScalar(const double* x, int n)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) total += x[i];
+    return total;
+}
+
+double dotScalar(const double* x, const double* y, int n)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) total += x[i] * y[i];
+    return total;
+}
+
+double sumSquaredDeviationsScalar(const double* x, int n, double mean)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const double d = x[i] - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+double centeredDotScalar(const double* x, const double* y, int n, double meanX, double meanY)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) total += (x[i] - meanX) * (y[i] - meanY);
+    return total;
+}
+
+double squaredDistanceScalar(const double* x, const double* y, int n)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const double d = x[i] - y[i];
+        total += d * d;
+    }
+    return total;
+}
+
+double rampDotScalar(const double* x, int n)
+{
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) total += i * x[i];
+    return total;
+}
+
+void minMaxScalar(const double* x, int n, double* minimum, double* maximum)
+{
+    double lo = x[0], hi = x[0];
+    for (int i = 1; i < n; ++i) {
+        lo = std::min(lo, x[i]);
+        hi = std::max(hi, x[i]);
+    }
+    *minimum = lo;
+    *maximum = hi;
+}
+
+void scaleShiftScalar(const double* x, int n, double shift, double scale, double* out)
+{
+    for (int i = 0; i < n; ++i) out[i] = (x[i] - shift) * scale;
+}
+
+// ---------------- x86 SSE2 / AVX2 实现 ----------------
+// 每个函数用两个累加器隐藏加法延迟，尾部交给标量实现
+
+#ifdef NUMERICKERNELS_HAS_X86
+
+NUMERICKERNELS_TARGET("sse2")
+inline double horizontalSum(__m128d v)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+NUMERICKERNELS_TARGET("sse2")
+double sumSSE2(const double* x, int n)
+{
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(x + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(x + i + 2));
+    }
+    return horizontalSum(_mm_add_pd(acc0, acc1)) + sumScalar(x + i, n - i);
+}
+
+NUMERICKERNELS_TARGET("sse2")
+double dotSSE2(const double* x, const double* y, int n)
+{
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    return horizontalSum(_mm_add_pd(acc0, acc1)) + dotScalar(x + i, y + i, n - i);
+}
+
+NUMERICKERNELS_TARGET("sse2")
+double sumSquaredDeviationsSSE2(const double* x, int n, double mean)
+{
+    const __m128d m = _mm_set1_pd(mean);
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128d d0 = _mm_sub_pd(_mm_loadu_pd(x + i), m);
+        const __m128d d1 = _mm_sub_pd(_mm_loadu_pd(x + i + 2), m);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+    return horizontalSum(_mm_add_pd(acc0, acc1)) + sumSquaredDeviationsScalar(x + i, n - i, mean);
+}
+
+NUMERICKERNELS_TARGET("sse2")
+double centeredDotSSE2(const double* x, const double* y, int n, double meanX, double meanY)
+{
+    const __m128d mx = _mm_set1_pd(meanX), my = _mm_set1_pd(meanY);
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(x + i), mx), _mm_sub_pd(_mm_loadu_pd(y + i), my)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(x + i + 2), mx), _mm_sub_pd(_mm_loadu_pd(y + i + 2), my)));
+    }
+    return horizontalSum(_mm_add_pd(acc0, acc1)) + centeredDotScalar(x + i, y + i, n - i, meanX, meanY);
+}
+
+NUMERICKERNELS_TARGET("sse2")
+double squaredDistanceSSE2(const double* x, const double* y, int n)
+{
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128d d0 = _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i));
+        const __m128d d1 = _mm_sub_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2));
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+    return horizontalSum(_mm_add_pd(acc0, acc1)) + squaredDistanceScalar(x + i, y + i, n - i);
+}
+
+NUMERICKERNELS_TARGET("sse2")
+double rampDotSSE2(const double* x, int n)
+{
+    __m128d index = _mm_set_pd(1.0, 0.0);
+    const __m128d step = _mm_set1_pd(2.0);
+    __m128d acc = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = _mm_add_pd(acc, _mm_mul_pd(index, _mm_loadu_pd(x + i)));
+        index = _mm_add_pd(index, step);
+    }
+    double total = horizontalSum(acc);
+    for (; i < n; ++i) total += i * x[i];
+    return total;
+}
+
+NUMERICKERNELS_TARGET("sse2")
+void minMaxSSE2(const double* x, int n, double* minimum, double* maximum)
+{
+    if (n < 2) {
+        minMaxScalar(x, n, minimum, maximum);
+        return;
+    }
+    __m128d lo = _mm_loadu_pd(x), hi = lo;
+    int i = 2;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d v = _mm_loadu_pd(x + i);
+        lo = _mm_min_pd(lo, v);
+        hi = _mm_max_pd(hi, v);
+    }
+    double loValue = std::min(_mm_cvtsd_f64(lo), _mm_cvtsd_f64(_mm_unpackhi_pd(lo, lo)));
+    double hiValue = std::max(_mm_cvtsd_f64(hi), _mm_cvtsd_f64(_mm_unpackhi_pd(hi, hi)));
+    for (; i < n; ++i) {
+        loValue = std::min(loValue, x[i]);
+        hiValue = std::max(hiValue, x[i]);
+    }
+    *minimum = loValue;
+    *maximum = hiValue;
+}
+
+NUMERICKERNELS_TARGET("sse2")
+void scaleShiftSSE2(const double* x, int n, double shift, double scale, double* out)
+{
+    const __m128d s = _mm_set1_pd(shift), k = _mm_set1_pd(scale);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(x + i), s), k));
+    }
+    scaleShiftScalar(x + i, n - i, shift, scale, out + i);
+}
+
+NUMERICKERNELS_TARGET("avx2")
+inline double horizontalSum(__m256d v)
+{
+    const __m128d folded = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(folded, _mm_unpackhi_pd(folded, folded)));
+}
+
+NUMERICKERNELS_TARGET("avx2")
+double sumAVX2(const double* x, int n)
+{
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(x + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(x + i + 4));
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + sumSSE2(x + i, n - i);
+}
+
+NUMERICKERNELS_TARGET("avx2")
+double dotAVX2(const double* x, const double* y, int n)
+{
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + dotSSE2(x + i, y + i, n - i);
+}
+
+NUMERICKERNELS_TARGET("avx2")
+double sumSquaredDeviationsAVX2(const double* x, int n, double mean)
+{
+    const __m256d m = _mm256_set1_pd(mean);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), m);
+        const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), m);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(d0, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(d1, d1));
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + sumSquaredDeviationsSSE2(x + i, n - i, mean);
+}
+
+NUMERICKERNELS_TARGET("avx2")
+double centeredDotAVX2(const double* x, const double* y, int n, double meanX, double meanY)
+{
+    const __m256d mx = _mm256_set1_pd(meanX), my = _mm256_set1_pd(meanY);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), mx),
+                                                 _mm256_sub_pd(_mm256_loadu_pd(y + i), my)));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i + 4), mx),
+                                                 _mm256_sub_pd(_mm256_loadu_pd(y + i + 4), my)));
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + centeredDotSSE2(x + i, y + i, n - i, meanX, meanY);
+}
+
+NUMERICKERNELS_TARGET("avx2")
+double squaredDistanceAVX2(const double* x, const double* y, int n)
+{
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+        const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4));
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(d0, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(d1, d1));
+    }
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + squaredDistanceSSE2(x + i, y + i, n - i);
+}
+
+NUMERICKERNELS_TARGET("avx2")
+double rampDotAVX2(const double* x, int n)
+{
+    __m256d index = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+    const __m256d step = _mm256_set1_pd(4.0);
+    __m256d acc = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(index, _mm256_loadu_pd(x + i)));
+        index = _mm256_add_pd(index, step);
+    }
+    double total = horizontalSum(acc);
+    for (; i < n; ++i) total += i * x[i];
+    return total;
+}
+
+NUMERICKERNELS_TARGET("avx2")
+void minMaxAVX2(const double* x, int n, double* minimum, double* maximum)
+{
+    if (n < 4) {
+        minMaxScalar(x, n, minimum, maximum);
+        return;
+    }
+    __m256d lo = _mm256_loadu_pd(x), hi = lo;
+    int i = 4;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d v = _mm256_loadu_pd(x + i);
+        lo = _mm256_min_pd(lo, v);
+        hi = _mm256_max_pd(hi, v);
+    }
+    const __m128d lo2 = _mm_min_pd(_mm256_castpd256_pd128(lo), _mm256_extractf128_pd(lo, 1));
+    const __m128d hi2 = _mm_max_pd(_mm256_castpd256_pd128(hi), _mm256_extractf128_pd(hi, 1));
+    double loValue = std::min(_mm_cvtsd_f64(lo2), _mm_cvtsd_f64(_mm_unpackhi_pd(lo2, lo2)));
+    double hiValue = std::max(_mm_cvtsd_f64(hi2), _mm_cvtsd_f64(_mm_unpackhi_pd(hi2, hi2)));
+    for (; i < n; ++i) {
+        loValue = std::min(loValue, x[i]);
+        hiValue = std::max(hiValue, x[i]);
+    }
+    *minimum = loValue;
+    *maximum = hiValue;
+}
+
+NUMERICKERNELS_TARGET("avx2")
+void scaleShiftAVX2(const double* x, int n, double shift, double scale, double* out)
+{
+    const __m256d s = _mm256_set1_pd(shift), k = _mm256_set1_pd(scale);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), s), k));
+    }
+    scaleShiftSSE2(x + i, n - i, shift, scale, out + i);
+}
+
+#endif // NUMERICKERNELS_HAS_X86
+
+// ---------------- ARM NEON 实现 ----------------
+
+#ifdef NUMERICKERNELS_HAS_NEON
+
+double sumNEON(const double* x, int n)
+{
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vaddq_f64(acc0, vld1q_f64(x + i));
+        acc1 = vaddq_f64(acc1, vld1q_f64(x + i + 2));
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + sumScalar(x + i, n - i);
+}
+
+double dotNEON(const double* x, const double* y, int n)
+{
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vfmaq_f64(acc0, vld1q_f64(x + i), vld1q_f64(y + i));
+        acc1 = vfmaq_f64(acc1, vld1q_f64(x + i + 2), vld1q_f64(y + i + 2));
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + dotScalar(x + i, y + i, n - i);
+}
+
+double sumSquaredDeviationsNEON(const double* x, int n, double mean)
+{
+    const float64x2_t m = vdupq_n_f64(mean);
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float64x2_t d0 = vsubq_f64(vld1q_f64(x + i), m);
+        const float64x2_t d1 = vsubq_f64(vld1q_f64(x + i + 2), m);
+        acc0 = vfmaq_f64(acc0, d0, d0);
+        acc1 = vfmaq_f64(acc1, d1, d1);
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + sumSquaredDeviationsScalar(x + i, n - i, mean);
+}
+
+double centeredDotNEON(const double* x, const double* y, int n, double meanX, double meanY)
+{
+    const float64x2_t mx = vdupq_n_f64(meanX), my = vdupq_n_f64(meanY);
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vfmaq_f64(acc0, vsubq_f64(vld1q_f64(x + i), mx), vsubq_f64(vld1q_f64(y + i), my));
+        acc1 = vfmaq_f64(acc1, vsubq_f64(vld1q_f64(x + i + 2), mx), vsubq_f64(vld1q_f64(y + i + 2), my));
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + centeredDotScalar(x + i, y + i, n - i, meanX, meanY);
+}
+
+double squaredDistanceNEON(const double* x, const double* y, int n)
+{
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float64x2_t d0 = vsubq_f64(vld1q_f64(x + i), vld1q_f64(y + i));
+        const float64x2_t d1 = vsubq_f64(vld1q_f64(x + i + 2), vld1q_f64(y + i + 2));
+        acc0 = vfmaq_f64(acc0, d0, d0);
+        acc1 = vfmaq_f64(acc1, d1, d1);
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + squaredDistanceScalar(x + i, y + i, n - i);
+}
+
+double rampDotNEON(const double* x, int n)
+{
+    const double start[2] = {0.0, 1.0};
+    float64x2_t index = vld1q_f64(start);
+    const float64x2_t step = vdupq_n_f64(2.0);
+    float64x2_t acc = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        acc = vfmaq_f64(acc, index, vld1q_f64(x + i));
+        index = vaddq_f64(index, step);
+    }
+    double total = vaddvq_f64(acc);
+    for (; i < n; ++i) total += i * x[i];
+    return total;
+}
+
+void minMaxNEON(const double* x, int n, double* minimum, double* maximum)
+{
+    if (n < 2) {
+        minMaxScalar(x, n, minimum, maximum);
+        return;
+    }
+    float64x2_t lo = vld1q_f64(x), hi = lo;
+    int i = 2;
+    for (; i + 2 <= n; i += 2) {
+        const float64x2_t v = vld1q_f64(x + i);
+        lo = vminq_f64(lo, v);
+        hi = vmaxq_f64(hi, v);
+    }
+    double loValue = vminvq_f64(lo);
+    double hiValue = vmaxvq_f64(hi);
+    for (; i < n; ++i) {
+        loValue = std::min(loValue, x[i]);
+        hiValue = std::max(hiValue, x[i]);
+    }
+    *minimum = loValue;
+    *maximum = hiValue;
+}
+
+void scaleShiftNEON(const double* x, int n, double shift, double scale, double* out)
+{
+    const float64x2_t s = vdupq_n_f64(shift), k = vdupq_n_f64(scale);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        vst1q_f64(out + i, vmulq_f64(vsubq_f64(vld1q_f64(x + i), s), k));
+    }
+    scaleShiftScalar(x + i, n - i, shift, scale, out + i);
+}
+
+#endif // NUMERICKERNELS_HAS_NEON
+
+const KernelTable s_scalarTable = { ScanKernel::Scalar, sumScalar, dotScalar, sumSquaredDeviationsScalar,
+                                    centeredDotScalar, squaredDistanceScalar, rampDotScalar, minMaxScalar,
+                                    scaleShiftScalar };
+#ifdef NUMERICKERNELS_HAS_X86
+const KernelTable s_sse2Table = { ScanKernel::SSE2, sumSSE2, dotSSE2, sumSquaredDeviationsSSE2,
+                                  centeredDotSSE2, squaredDistanceSSE2, rampDotSSE2, minMaxSSE2,
+                                  scaleShiftSSE2 };
+const KernelTable s_avx2Table = { ScanKernel::AVX2, sumAVX2, dotAVX2, sumSquaredDeviationsAVX2,
+                                  centeredDotAVX2, squaredDistanceAVX2, rampDotAVX2, minMaxAVX2,
+                                  scaleShiftAVX2 };
+#endif
+#ifdef NUMERICKERNELS_HAS_NEON
+const KernelTable s_neonTable = { ScanKernel::NEON, sumNEON, dotNEON, sumSquaredDeviationsNEON,
+                                  centeredDotNEON, squaredDistanceNEON, rampDotNEON, minMaxNEON,
+                                  scaleShiftNEON };
+#endif
+
+const KernelTable* tableForKernel(ScanKernel kernel)
+{
+    switch (kernel) {
+#ifdef NUMERICKERNELS_HAS_X86
+        case ScanKernel::SSE2: return &s_sse2Table;
+        case ScanKernel::AVX2: return &s_avx2Table;
+#endif
+#ifdef NUMERICKERNELS_HAS_NEON
+        case ScanKernel::NEON: return &s_neonTable;
+#endif
+        default: return &s_scalarTable;
+    }
+}
+
+std::atomic<const KernelTable*> s_activeTable{nullptr};
+
+inline const KernelTable* activeTable()
+{
+    const KernelTable* table = s_activeTable.load(std::memory_order_acquire);
+    if (Q_UNLIKELY(!table)) {
+        // 多线程同时首次调用时结果相同，重复赋值无副作用
+        table = tableForKernel(ByteScanner::detectBestKernel());
+        s_activeTable.store(table, std::memory_order_release);
+    }
+    return table;
+}
+
+} // namespace
+
+double NumericKernels::sum(const double* x, int n)
+{
+    return n > 0 ? activeTable()->sum(x, n) : 0.0;
+}
+
+double NumericKernels::dot(const double* x, const double* y, int n)
+{
+    return n > 0 ? activeTable()->dot(x, y, n) : 0.0;
+}
+
+double NumericKernels::sumSquaredDeviations(const double* x, int n, double mean)
+{
+    return n > 0 ? activeTable()->sumSquaredDeviations(x, n, mean) : 0.0;
+}
+
+double NumericKernels::centeredDot(const double* x, const double* y, int n, double meanX, double meanY)
+{
+    return n > 0 ? activeTable()->centeredDot(x, y, n, meanX, meanY) : 0.0;
+}
+
+double NumericKernels::squaredDistance(const double* x, const double* y, int n)
+{
+    return n > 0 ? activeTable()->squaredDistance(x, y, n) : 0.0;
+}
+
+void NumericKernels::minMax(const double* x, int n, double* minimum, double* maximum)
+{
+    if (n <= 0) {
+        *minimum = 0.0;
+        *maximum = 0.0;
+        return;
+    }
+    activeTable()->minMax(x, n, minimum, maximum);
+}
+
+void NumericKernels::scaleShift(const double* x, int n, double shift, double scale, double* out)
+{
+    if (n > 0) {
+        activeTable()->scaleShift(x, n, shift, scale, out);
+    }
+}
+
+NumericKernels::Moments NumericKernels::moments(const double* x, int n)
+{
+    Moments result;
+    if (n <= 0) {
+        return result;
+    }
+    // 两遍算法：先求均值再求离差平方和，避免 Σx² - n·mean² 的相消误差
+    const KernelTable* table = activeTable();
+    result.mean = table->sum(x, n) / n;
+    result.variance = table->sumSquaredDeviations(x, n, result.mean) / n;
+    table->minMax(x, n, &result.minimum, &result.maximum);
+    return result;
+}
+
+NumericKernels::LinearFit NumericKernels::linearFit(const double* x, const double* y, int n)
+{
+    LinearFit fit;
+    if (n <= 0) {
+        return fit;
+    }
+    const KernelTable* table = activeTable();
+    const double meanX = table->sum(x, n) / n;
+    const double meanY = table->sum(y, n) / n;
+    const double sxx = table->sumSquaredDeviations(x, n, meanX);
+    fit.slope = sxx > 0.0 ? table->centeredDot(x, y, n, meanX, meanY) / sxx : 0.0;
+    fit.intercept = meanY - fit.slope * meanX;
+    return fit;
+}
+
+NumericKernels::LinearFit NumericKernels::linearTrend(const double* y, int n)
+{
+    LinearFit fit;
+    if (n <= 0) {
+        return fit;
+    }
+    const KernelTable* table = activeTable();
+    const double meanX = (n - 1) / 2.0;
+    const double meanY = table->sum(y, n) / n;
+    // x = 0..n-1：Σ(x - meanX)² = n(n² - 1)/12，Σ(x - meanX)(y - meanY) = Σ i·y - meanX·Σy
+    const double sxx = static_cast<double>(n) * (static_cast<double>(n) * n - 1.0) / 12.0;
+    if (sxx > 0.0) {
+        fit.slope = (table->rampDot(y, n) - meanX * meanY * n) / sxx;
+    }
+    fit.intercept = meanY - fit.slope * meanX;
+    return fit;
+}
+
+double NumericKernels::correlation(const double* x, const double* y, int n)
+{
+    if (n < 2) {
+        return 0.0;
+    }
+    const KernelTable* table = activeTable();
+    const double meanX = table->sum(x, n) / n;
+    const double meanY = table->sum(y, n) / n;
+    const double sxx = table->sumSquaredDeviations(x, n, meanX);
+    const double syy = table->sumSquaredDeviations(y, n, meanY);
+    if (sxx <= 0.0 || syy <= 0.0) {
+        return 0.0;
+    }
+    return table->centeredDot(x, y, n, meanX, meanY) / std::sqrt(sxx * syy);
+}
+
+void NumericKernels::zScores(const double* x, int n, double* out)
+{
+    if (n <= 0) {
+        return;
+    }
+    const KernelTable* table = activeTable();
+    const double mean = table->sum(x, n) / n;
+    const double deviation = std::sqrt(table->sumSquaredDeviations(x, n, mean) / n);
+    if (deviation > 0.0) {
+        table->scaleShift(x, n, mean, 1.0 / deviation, out);
+    } else {
+        std::fill(out, out + n, 0.0);
+    }
+}
+
+void NumericKernels::movingAverage(const double* x, int n, int window, double* out)
+{
+    if (n <= 0) {
+        return;
+    }
+    window = qMax(1, window);
+    const KernelTable* table = activeTable();
+
+    // 滑动和逐点加减，每隔一个窗口用 sum 内核重新求和，防止长序列上的舍入误差累积
+    double windowSum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        if (i >= window && i % window == 0) {
+            windowSum = table->sum(x + i - window + 1, window - 1) + x[i];
+        } else {
+            windowSum += x[i];
+            if (i >= window) {
+                windowSum -= x[i - window];
+            }
+        }
+        out[i] = windowSum / qMin(i + 1, window);
+    }
+}
+
+bool NumericKernels::leastSquares(const double* const* columns, int columnCount, const double* y, int rows,
+                                  double ridge, double* coefficients)
+{
+    if (rows <= 0 || columnCount < 0) {
+        return false;
+    }
+    const KernelTable* table = activeTable();
+    const double meanY = table->sum(y, rows) / rows;
+
+    // 中心化后的正规方程 (XcᵀXc + ridge·I)·w = Xcᵀyc，截距由均值回代
+    std::vector<double> means(static_cast<size_t>(columnCount));
+    for (int j = 0; j < columnCount; ++j) {
+        means[j] = table->sum(columns[j], rows) / rows;
+    }
+    std::vector<double> normal(static_cast<size_t>(columnCount) * columnCount);
+    for (int i = 0; i < columnCount; ++i) {
+        for (int j = i; j < columnCount; ++j) {
+            const double value = table->centeredDot(columns[i], columns[j], rows, means[i], means[j]);
+            normal[static_cast<size_t>(i) * columnCount + j] = value;
+            normal[static_cast<size_t>(j) * columnCount + i] = value;
+        }
+        normal[static_cast<size_t>(i) * columnCount + i] += ridge;
+        coefficients[i] = table->centeredDot(columns[i], y, rows, means[i], meanY);
+    }
+
+    if (!solveSymmetric(normal.data(), coefficients, columnCount)) {
+        return false;
+    }
+
+    double intercept = meanY;
+    for (int j = 0; j < columnCount; ++j) {
+        intercept -= coefficients[j] * means[j];
+    }
+    coefficients[columnCount] = intercept;
+    return true;
+}
+
+bool NumericKernels::solveSymmetric(double* a, double* b, int n)
+{
+    const KernelTable* table = activeTable();
+
+    // A = L·Lᵀ，L 写入下三角。行主序下 L 的两行前缀是连续的，内积直接用 dot 内核
+    for (int j = 0; j < n; ++j) {
+        double* rowJ = a + static_cast<size_t>(j) * n;
+        const double diagonal = rowJ[j] - (j > 0 ? table->dot(rowJ, rowJ, j) : 0.0);
+        if (!(diagonal > 0.0)) {
+            return false;
+        }
+        rowJ[j] = std::sqrt(diagonal);
+        for (int i = j + 1; i < n; ++i) {
+            double* rowI = a + static_cast<size_t>(i) * n;
+            rowI[j] = (rowI[j] - (j > 0 ? table->dot(rowI, rowJ, j) : 0.0)) / rowJ[j];
+        }
+    }
+
+    // L·z = b
+    for (int i = 0; i < n; ++i) {
+        const double* rowI = a + static_cast<size_t>(i) * n;
+        b[i] = (b[i] - (i > 0 ? table->dot(rowI, b, i) : 0.0)) / rowI[i];
+    }
+    // Lᵀ·x = z（按列访问 L，元素少，直接标量）
+    for (int i = n - 1; i >= 0; --i) {
+        double value = b[i];
+        for (int k = i + 1; k < n; ++k) {
+            value -= a[static_cast<size_t>(k) * n + i] * b[k];
+        }
+        b[i] = value / a[static_cast<size_t>(i) * n + i];
+    }
+    return true;
+}
+
+ScanKernel NumericKernels::activeKernel()
+{
+    return activeTable()->kernel;
+}
+
+bool NumericKernels::setKernel(ScanKernel kernel)
+{
+    if (!ByteScanner::isKernelSupported(kernel)) {
+        return false;
+    }
+    s_activeTable.store(tableForKernel(kernel), std::memory_order_release);
+    return true;
+}
+
+int FeatureColumns::column(const QString& name)
+{
+    auto it = m_index.constFind(name);
+    if (it != m_index.constEnd()) {
+        return it.value();
+    }
+    const int index = static_cast<int>(m_columns.size());
+    m_index.insert(name, index);
+    m_names.append(name);
+    m_columns.emplace_back();
+    return index;
+}
+
+void FeatureColumns::appendAll(const QHash<QString, double>& values)
+{
+    int expected = 0;
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        const int index = expected < columnCount() && m_names[expected] == it.key() ? expected : column(it.key());
+        m_columns[static_cast<size_t>(index)].push_back(it.value());
+        expected = index + 1;
+    }
+}
+
+void FeatureColumns::reserve(int rows)
+{
+    for (auto& values : m_columns) {
+        values.reserve(static_cast<size_t>(qMax(0, rows)));
+    }
+}
+
+void FeatureColumns::clear()
+{
+    for (auto& values : m_columns) {
+        values.clear();
+    }
+}
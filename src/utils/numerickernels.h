@@ -0,0 +1,82 @@
+#pragma once
+
+#include "bytescanner.h"
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+// 稠密数值内核 - 性能预测和智能分析模块的统计、回归计算
+// 输入为连续的 double 数组。内核类型与检测沿用 ByteScanner：首次调用时选择 AVX2/SSE2/NEON/标量实现，
+// 各实现的累加顺序不同，结果只在浮点舍入误差内一致。组合函数（moments、linearFit 等）都建立在这几个内核之上
+class NumericKernels
+{
+public:
+    struct Moments {
+        double mean = 0.0;
+        double variance = 0.0;      // 总体方差
+        double minimum = 0.0;
+        double maximum = 0.0;
+    };
+
+    struct LinearFit {
+        double slope = 0.0;
+        double intercept = 0.0;
+    };
+
+    // 基本内核
+    static double sum(const double* x, int n);
+    static double dot(const double* x, const double* y, int n);
+    static double sumSquaredDeviations(const double* x, int n, double mean);               // Σ(x - mean)²
+    static double centeredDot(const double* x, const double* y, int n, double meanX, double meanY);
+    static double squaredDistance(const double* x, const double* y, int n);                // Σ(x - y)²
+    static void minMax(const double* x, int n, double* minimum, double* maximum);
+    static void scaleShift(const double* x, int n, double shift, double scale, double* out);   // (x - shift) * scale
+
+    // 组合计算，n 为 0 时返回全零
+    static Moments moments(const double* x, int n);
+    static LinearFit linearFit(const double* x, const double* y, int n);    // x 没有变化时斜率为 0
+    static LinearFit linearTrend(const double* y, int n);                   // x 取 0..n-1，不必构造 x 数组
+    static double correlation(const double* x, const double* y, int n);     // 任一序列没有变化时为 0
+    static void zScores(const double* x, int n, double* out);               // 标准差为 0 时全为 0
+    static void movingAverage(const double* x, int n, int window, double* out);    // 前缀和实现，O(n)，前 window-1 个点取已有点的均值
+
+    // 多元最小二乘 y ≈ Σ coefficients[j] * columns[j] + coefficients[columnCount]（截距）
+    // 每个特征一列连续数组，正规方程的各项由 centeredDot 计算，ridge 加在对角线上防止列共线时矩阵奇异
+    static bool leastSquares(const double* const* columns, int columnCount, const double* y, int rows,
+                             double ridge, double* coefficients);
+
+    // 对称正定方程组 A·x = b：A 为行主序 n×n，原地 Cholesky 分解，解写回 b。A 非正定时返回 false
+    static bool solveSymmetric(double* a, double* b, int n);
+
+    // 内核管理
+    static ScanKernel activeKernel();
+    static bool setKernel(ScanKernel kernel);   // 用于基准测试，不支持时返回false
+
+private:
+    NumericKernels() = delete;
+};
+
+// 按名字取列的特征表 - 把 QHash<QString, double> 形式的数据点摊成每个特征一列的连续数组，供 NumericKernels 计算
+// 列号在第一次见到特征名时分配。相邻数据点的特征通常按相同顺序出现，appendAll 先按上一列的下一列比较名字，
+// 命中时不必计算哈希。各列长度可以不同（只有包含该特征的数据点才追加）
+class FeatureColumns
+{
+public:
+    int column(const QString& name);                 // 不存在时新建
+    int indexOf(const QString& name) const { return m_index.value(name, -1); }
+
+    void append(int column, double value) { m_columns[static_cast<size_t>(column)].push_back(value); }
+    void appendAll(const QHash<QString, double>& values);
+    void reserve(int rows);                           // 对已有的列预留空间
+    void clear();                                     // 清空数值，保留列名和容量
+
+    int columnCount() const { return static_cast<int>(m_columns.size()); }
+    const QString& name(int column) const { return m_names[column]; }
+    const std::vector<double>& values(int column) const { return m_columns[static_cast<size_t>(column)]; }
+
+private:
+    QHash<QString, int> m_index;
+    QStringList m_names;
+    std::vector<std::vector<double>> m_columns;
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// 在线学习的基础统计量 - 每个样本增量更新一次，不保留历史样本。均非线程安全
+
+// 指数加权均值和方差（West 增量公式）
+// 前 1/alpha 个样本内按 1/n 加权，结果等同于普通的总体均值和方差，之后按 alpha 指数遗忘旧样本，
+// 冷启动时不会因为从第一个样本开始加权而低估方差。每次更新 O(1)
+class ExponentialStatistics
+{
+public:
+    explicit ExponentialStatistics(double alpha = 0.05) : m_alpha(alpha) {}
+
+    void add(double value)
+    {
+        ++m_count;
+        const double weight = std::max(m_alpha, 1.0 / static_cast<double>(m_count));
+        const double delta = value - m_mean;
+        m_mean += weight * delta;
+        m_variance = (1.0 - weight) * (m_variance + weight * delta * delta);
+    }
+
+    // 与当前均值相差几个标准差，方差为 0 时返回 0
+    double zScore(double value) const
+    {
+        const double deviation = stdDeviation();
+        return deviation > 0.0 ? std::abs(value - m_mean) / deviation : 0.0;
+    }
+
+    void clear() { *this = ExponentialStatistics(m_alpha); }
+
+    qint64 count() const { return m_count; }
+    double mean() const { return m_mean; }
+    double variance() const { return m_variance; }
+    double stdDeviation() const { return std::sqrt(m_variance); }
+
+private:
+    double m_alpha;
+    qint64 m_count = 0;
+    double m_mean = 0.0;
+    double m_variance = 0.0;
+};
+
+// 指数加权的一元线性回归 y = intercept + slope * x，x 通常是时间（秒）
+// 同时维护 x、y 的加权均值和协方差，每次更新 O(1)。冷启动加权方式与 ExponentialStatistics 相同
+class ExponentialTrend
+{
+public:
+    explicit ExponentialTrend(double alpha = 0.05) : m_alpha(alpha) {}
+
+    void add(double x, double y)
+    {
+        ++m_count;
+        const double weight = std::max(m_alpha, 1.0 / static_cast<double>(m_count));
+        const double dx = x - m_meanX;
+        const double dy = y - m_meanY;
+        m_meanX += weight * dx;
+        m_meanY += weight * dy;
+        m_covarianceXX = (1.0 - weight) * (m_covarianceXX + weight * dx * dx);
+        m_covarianceXY = (1.0 - weight) * (m_covarianceXY + weight * dx * dy);
+    }
+
+    // x 没有变化（所有样本同一时刻）时斜率为 0
+    double slope() const { return m_covarianceXX > 0.0 ? m_covarianceXY / m_covarianceXX : 0.0; }
+    double intercept() const { return m_meanY - slope() * m_meanX; }
+    double predict(double x) const { return m_meanY + slope() * (x - m_meanX); }
+
+    void clear() { *this = ExponentialTrend(m_alpha); }
+
+    qint64 count() const { return m_count; }
+    double meanY() const { return m_meanY; }
+
+private:
+    double m_alpha;
+    qint64 m_count = 0;
+    double m_meanX = 0.0;
+    double m_meanY = 0.0;
+    double m_covarianceXX = 0.0;
+    double m_covarianceXY = 0.0;
+};
+
+// 带遗忘因子的递推最小二乘（RLS）多元线性回归 y = w · [x, 1]
+// 维护权重 w 和逆相关矩阵 P（维度为特征数 + 1，最后一维是截距），每个样本更新一次，O(维度²)，
+// 不做矩阵求逆。遗忘因子 lambda < 1 时有效记忆约 1/(1 - lambda) 个样本，系统特性漂移后会重新收敛。
+// 输入长期不变化时 P 会随 1/lambda 指数增大（协方差发散），对角元素超过上限即重新初始化 P，权重保留。
+// 另外按先验误差（更新前的预测误差）统计残差，explainedVariance() 即在线估计的 R²
+class RecursiveLeastSquares
+{
+public:
+    explicit RecursiveLeastSquares(int featureCount = 0, double forgettingFactor = 0.995,
+                                   double initialCovariance = 1000.0, double statisticsAlpha = 0.05)
+        : m_dimension(qMax(0, featureCount) + 1)
+        , m_lambda(qBound(0.5, forgettingFactor, 1.0))
+        , m_initialCovariance(initialCovariance)
+        , m_weights(static_cast<size_t>(m_dimension), 0.0)
+        , m_covariance(static_cast<size_t>(m_dimension) * m_dimension, 0.0)
+        , m_gain(static_cast<size_t>(m_dimension), 0.0)
+        , m_input(static_cast<size_t>(m_dimension), 1.0)
+        , m_errors(statisticsAlpha)
+        , m_targets(statisticsAlpha)
+    {
+        resetCovariance();
+    }
+
+    int featureCount() const { return m_dimension - 1; }
+
+    // features 须有 featureCount() 个元素
+    void update(const double* features, double target)
+    {
+        const int n = m_dimension;
+        std::copy(features, features + n - 1, m_input.begin());
+
+        // gain = P·x / (lambda + xᵀ·P·x)
+        double denominator = m_lambda;
+        for (int i = 0; i < n; ++i) {
+            const double* row = &m_covariance[static_cast<size_t>(i) * n];
+            double sum = 0.0;
+            for (int j = 0; j < n; ++j) {
+                sum += row[j] * m_input[j];
+            }
+            m_gain[i] = sum;
+            denominator += m_input[i] * sum;
+        }
+
+        const double error = target - dot(m_input.data());
+        m_errors.add(error);
+        m_targets.add(target);
+        ++m_updates;
+
+        // P 对称，(P - gain·xᵀP) / lambda 只算上三角再镜像
+        const double inverse = 1.0 / denominator;
+        bool diverged = false;
+        for (int i = 0; i < n; ++i) {
+            m_weights[i] += m_gain[i] * inverse * error;
+            for (int j = i; j < n; ++j) {
+                const double value = (m_covariance[static_cast<size_t>(i) * n + j] - m_gain[i] * m_gain[j] * inverse) / m_lambda;
+                m_covariance[static_cast<size_t>(i) * n + j] = value;
+                m_covariance[static_cast<size_t>(j) * n + i] = value;
+            }
+            const double diagonal = m_covariance[static_cast<size_t>(i) * n + i];
+            diverged = diverged || !(diagonal < m_initialCovariance * 1e4);
+        }
+        if (diverged) {
+            resetCovariance();
+        }
+    }
+
+    double predict(const double* features) const
+    {
+        double sum = m_weights[m_dimension - 1];
+        for (int i = 0; i < m_dimension - 1; ++i) {
+            sum += m_weights[i] * features[i];
+        }
+        return sum;
+    }
+
+    // 在线 R²：1 - 先验残差方差 / 目标方差，限制在 [0, 1]
+    double explainedVariance() const
+    {
+        const double targetVariance = m_targets.variance();
+        if (m_updates < 2 || targetVariance <= 0.0) {
+            return 0.0;
+        }
+        const double residual = m_errors.variance() + m_errors.mean() * m_errors.mean();
+        return qBound(0.0, 1.0 - residual / targetVariance, 1.0);
+    }
+
+    qint64 updates() const { return m_updates; }
+    double weight(int feature) const { return m_weights[feature]; }
+    double bias() const { return m_weights[m_dimension - 1]; }
+    double residualStdDeviation() const { return m_errors.stdDeviation(); }
+
+private:
+    double dot(const double* input) const
+    {
+        double sum = 0.0;
+        for (int i = 0; i < m_dimension; ++i) {
+            sum += m_weights[i] * input[i];
+        }
+        return sum;
+    }
+
+    void resetCovariance()
+    {
+        std::fill(m_covariance.begin(), m_covariance.end(), 0.0);
+        for (int i = 0; i < m_dimension; ++i) {
+            m_covariance[static_cast<size_t>(i) * m_dimension + i] = m_initialCovariance;
+        }
+    }
+
+    int m_dimension;
+    double m_lambda;
+    double m_initialCovariance;
+    std::vector<double> m_weights;
+    std::vector<double> m_covariance;   // 行主序 m_dimension × m_dimension
+    std::vector<double> m_gain;         // 更新用的临时向量，避免每次分配
+    std::vector<double> m_input;        // 特征加上常数 1
+    ExponentialStatistics m_errors;
+    ExponentialStatistics m_targets;
+    qint64 m_updates = 0;
+};
@@ -0,0 +1,210 @@
+#include "pathindex.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+void appendRange(QList<PathIndex::IndexRange>& ranges, int first, int last)
+{
+    if (!ranges.isEmpty() && ranges.last().last + 1 == first) {
+        ranges.last().last = last;
+    } else {
+        ranges.append({first, last});
+    }
+}
+
+}
+
+void PathIndex::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    buildTree();
+}
+
+int PathIndex::size() const
+{
+    return static_cast<int>(m_x.size());
+}
+
+bool PathIndex::isEmpty() const
+{
+    return m_x.empty();
+}
+
+QRectF PathIndex::bounds() const
+{
+    if (m_x.empty()) {
+        return QRectF();
+    }
+    return QRectF(QPointF(m_minX[1], m_minY[1]), QPointF(m_maxX[1], m_maxY[1]));
+}
+
+void PathIndex::buildTree()
+{
+    const int leafCount = (size() + LEAF_SIZE - 1) / LEAF_SIZE;
+    m_leafBase = 1;
+    while (m_leafBase < leafCount) {
+        m_leafBase *= 2;
+    }
+
+    const size_t nodes = static_cast<size_t>(m_leafBase) * 2;
+    m_minX.assign(nodes, INF);
+    m_minY.assign(nodes, INF);
+    m_maxX.assign(nodes, -INF);
+    m_maxY.assign(nodes, -INF);
+
+    for (int leaf = 0; leaf < leafCount; ++leaf) {
+        const int node = m_leafBase + leaf;
+        const int first = leaf * LEAF_SIZE;
+        const int last = std::min(first + LEAF_SIZE, size());
+        for (int i = first; i < last; ++i) {
+            m_minX[node] = std::min(m_minX[node], m_x[i]);
+            m_minY[node] = std::min(m_minY[node], m_y[i]);
+            m_maxX[node] = std::max(m_maxX[node], m_x[i]);
+            m_maxY[node] = std::max(m_maxY[node], m_y[i]);
+        }
+    }
+    for (int node = m_leafBase - 1; node >= 1; --node) {
+        m_minX[node] = std::min(m_minX[2 * node], m_minX[2 * node + 1]);
+        m_minY[node] = std::min(m_minY[2 * node], m_minY[2 * node + 1]);
+        m_maxX[node] = std::max(m_maxX[2 * node], m_maxX[2 * node + 1]);
+        m_maxY[node] = std::max(m_maxY[2 * node], m_maxY[2 * node + 1]);
+    }
+}
+
+void PathIndex::refitLeaf(int leaf)
+{
+    int node = m_leafBase + leaf;
+    const int first = leaf * LEAF_SIZE;
+    const int last = std::min(first + LEAF_SIZE, size());
+    m_minX[node] = m_minY[node] = INF;
+    m_maxX[node] = m_maxY[node] = -INF;
+    for (int i = first; i < last; ++i) {
+        m_minX[node] = std::min(m_minX[node], m_x[i]);
+        m_minY[node] = std::min(m_minY[node], m_y[i]);
+        m_maxX[node] = std::max(m_maxX[node], m_x[i]);
+        m_maxY[node] = std::max(m_maxY[node], m_y[i]);
+    }
+    for (node /= 2; node >= 1; node /= 2) {
+        m_minX[node] = std::min(m_minX[2 * node], m_minX[2 * node + 1]);
+        m_minY[node] = std::min(m_minY[2 * node], m_minY[2 * node + 1]);
+        m_maxX[node] = std::max(m_maxX[2 * node], m_maxX[2 * node + 1]);
+        m_maxY[node] = std::max(m_maxY[2 * node], m_maxY[2 * node + 1]);
+    }
+}
+
+void PathIndex::updatePoint(int index, double x, double y)
+{
+    if (index < 0 || index >= size()) {
+        return;
+    }
+    m_x[index] = x;
+    m_y[index] = y;
+    refitLeaf(index / LEAF_SIZE);
+}
+
+int PathIndex::nearest(double x, double y, double radius) const
+{
+    if (m_x.empty()) {
+        return -1;
+    }
+
+    // 深度优先，先进入离查询点更近的子节点，包围盒比当前最优距离更远的子树直接跳过
+    double best = radius * radius;
+    int bestIndex = -1;
+    auto boxDistance = [&](int node) {
+        const double dx = std::max({m_minX[node] - x, 0.0, x - m_maxX[node]});
+        const double dy = std::max({m_minY[node] - y, 0.0, y - m_maxY[node]});
+        return dx * dx + dy * dy;
+    };
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(1);
+    while (!stack.empty()) {
+        const int node = stack.back();
+        stack.pop_back();
+        if (!(boxDistance(node) <= best)) {
+            continue;
+        }
+        if (node >= m_leafBase) {
+            const int first = (node - m_leafBase) * LEAF_SIZE;
+            const int last = std::min(first + LEAF_SIZE, size());
+            for (int i = first; i < last; ++i) {
+                const double dx = m_x[i] - x;
+                const double dy = m_y[i] - y;
+                const double distance = dx * dx + dy * dy;
+                if (distance <= best) {
+                    best = distance;
+                    bestIndex = i;
+                }
+            }
+            continue;
+        }
+        const int left = 2 * node;
+        const int right = left + 1;
+        if (boxDistance(left) <= boxDistance(right)) {
+            stack.push_back(right);
+            stack.push_back(left);
+        } else {
+            stack.push_back(left);
+            stack.push_back(right);
+        }
+    }
+    return bestIndex;
+}
+
+QList<PathIndex::IndexRange> PathIndex::pointsIn(const QRectF& rect) const
+{
+    QList<IndexRange> ranges;
+    if (m_x.empty() || !rect.isValid()) {
+        return ranges;
+    }
+    const double left = rect.left();
+    const double right = rect.right();
+    const double top = rect.top();
+    const double bottom = rect.bottom();
+
+    // 节点和它覆盖的叶子区间；先压右子树，出栈顺序即序号递增
+    struct Entry {
+        int node;
+        int firstLeaf;
+        int leafCount;
+    };
+    std::vector<Entry> stack;
+    stack.reserve(64);
+    stack.push_back({1, 0, m_leafBase});
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const int node = entry.node;
+        if (m_minX[node] > right || m_maxX[node] < left || m_minY[node] > bottom || m_maxY[node] < top) {
+            continue;
+        }
+        const int first = entry.firstLeaf * LEAF_SIZE;
+        if (first >= size()) {
+            continue;
+        }
+        const int last = std::min((entry.firstLeaf + entry.leafCount) * LEAF_SIZE, size()) - 1;
+        if (m_minX[node] >= left && m_maxX[node] <= right && m_minY[node] >= top && m_maxY[node] <= bottom) {
+            // 整个子树都在矩形内
+            appendRange(ranges, first, last);
+            continue;
+        }
+        if (node >= m_leafBase) {
+            for (int i = first; i <= last; ++i) {
+                if (m_x[i] >= left && m_x[i] <= right && m_y[i] >= top && m_y[i] <= bottom) {
+                    appendRange(ranges, i, i);
+                }
+            }
+            continue;
+        }
+        const int half = entry.leafCount / 2;
+        stack.push_back({2 * node + 1, entry.firstLeaf + half, half});
+        stack.push_back({2 * node, entry.firstLeaf, half});
+    }
+    return ranges;
+}
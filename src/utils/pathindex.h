@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QList>
+#include <QRectF>
+#include <vector>
+
+// 路径点的二维包围盒层次（XY 平面）
+//
+// 路径上相邻的点在空间上也相邻，所以按序号每 LEAF_SIZE 个连续点分成一个叶子，叶子之上是隐式完全二叉树，
+// 每个节点保存子树所有点的包围盒。建立只需一遍线性扫描，移动一个点只重算所在叶子和它的祖先（O(log n)），
+// 插入或删除点会改变后面所有点的序号，需要重新 rebuild()。坐标按结构数组另存一份，查询不依赖调用方的数据。
+// 用于路径预览的点选（最近点）和框选（矩形内的点，按连续序号区间返回）。非线程安全。
+class PathIndex
+{
+public:
+    static constexpr int LEAF_SIZE = 32;
+
+    // 闭区间 [first, last]
+    struct IndexRange {
+        int first = 0;
+        int last = 0;
+    };
+
+    // Points 为支持 size() 和下标访问的容器，元素带 x、y 成员
+    template <typename Points>
+    void rebuild(const Points& points)
+    {
+        const int count = static_cast<int>(points.size());
+        m_x.resize(count);
+        m_y.resize(count);
+        for (int i = 0; i < count; ++i) {
+            m_x[i] = points[i].x;
+            m_y[i] = points[i].y;
+        }
+        buildTree();
+    }
+
+    void clear();
+    void updatePoint(int index, double x, double y);
+
+    int size() const;
+    bool isEmpty() const;
+    QRectF bounds() const;
+
+    // 距 (x, y) 不超过 radius 的最近点，没有时返回 -1
+    int nearest(double x, double y, double radius) const;
+    // 落在 rect 内（含边界）的点，按序号递增合并为连续区间
+    QList<IndexRange> pointsIn(const QRectF& rect) const;
+
+private:
+    void buildTree();
+    void refitLeaf(int leaf);
+
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+
+    // 节点 1 为根，节点 i 的子节点为 2i 和 2i+1，叶子为 [m_leafBase, 2 * m_leafBase)；空节点的包围盒为反向无穷
+    int m_leafBase = 0;
+    std::vector<double> m_minX;
+    std::vector<double> m_minY;
+    std::vector<double> m_maxX;
+    std::vector<double> m_maxY;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+// 定长环形缓冲区
+//
+// 容量在构造或 setCapacity() 时一次分配，append() 为 O(1)，满了之后覆盖最旧的元素。
+// view() 返回按插入顺序的只读视图（最多两段连续区间），支持下标和迭代器访问，不拷贝数据；
+// 视图在缓冲区下一次修改之前有效。非线程安全。数值时间序列请使用 SeriesRingBuffer。
+template <typename T>
+class RingBuffer
+{
+public:
+    // 一段连续的元素
+    struct Span {
+        const T* data = nullptr;
+        int size = 0;
+
+        const T* begin() const { return data; }
+        const T* end() const { return data + size; }
+    };
+
+    class View
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() = default;
+            const_iterator(const View* view, int index) : m_view(view), m_index(index) {}
+
+            reference operator*() const { return (*m_view)[m_index]; }
+            pointer operator->() const { return &(*m_view)[m_index]; }
+            const_iterator& operator++() { ++m_index; return *this; }
+            const_iterator operator++(int) { const_iterator previous = *this; ++m_index; return previous; }
+            bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+        private:
+            const View* m_view = nullptr;
+            int m_index = 0;
+        };
+
+        View() = default;
+        View(Span first, Span second) : m_first(first), m_second(second) {}
+
+        int size() const { return m_first.size + m_second.size; }
+        bool isEmpty() const { return size() == 0; }
+
+        // i 为插入顺序的序号，0 为最旧的元素
+        const T& operator[](int i) const
+        {
+            return i < m_first.size ? m_first.data[i] : m_second.data[i - m_first.size];
+        }
+        const T& first() const { return (*this)[0]; }
+        const T& last() const { return (*this)[size() - 1]; }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+        // 按插入顺序的两段，second 在缓冲区未回绕时为空
+        Span firstSpan() const { return m_first; }
+        Span secondSpan() const { return m_second; }
+
+    private:
+        Span m_first;
+        Span m_second;
+    };
+
+    explicit RingBuffer(int capacity = 0) { setCapacity(capacity); }
+
+    void append(const T& value)
+    {
+        if (m_capacity == 0) {
+            return;
+        }
+        int index = m_head + m_size;
+        if (index >= m_capacity) {
+            index -= m_capacity;
+        }
+        m_items[static_cast<size_t>(index)] = value;
+        if (m_size < m_capacity) {
+            ++m_size;
+        } else if (++m_head == m_capacity) {
+            m_head = 0;
+        }
+    }
+
+    void clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // 重新分配并保留最新的 min(size, capacity) 个元素
+    void setCapacity(int capacity)
+    {
+        capacity = std::max(0, capacity);
+        if (capacity == m_capacity) {
+            return;
+        }
+
+        const int keep = std::min(m_size, capacity);
+        std::vector<T> items(static_cast<size_t>(capacity));
+        const View current = view();
+        for (int i = 0; i < keep; ++i) {
+            items[static_cast<size_t>(i)] = current[m_size - keep + i];
+        }
+
+        m_items.swap(items);
+        m_capacity = capacity;
+        m_head = 0;
+        m_size = keep;
+    }
+
+    int size() const { return m_size; }
+    int capacity() const { return m_capacity; }
+    bool isEmpty() const { return m_size == 0; }
+
+    View view() const
+    {
+        const int firstSize = std::min(m_size, m_capacity - m_head);
+        const Span first{m_items.data() + m_head, firstSize};
+        const Span second{m_items.data(), m_size - firstSize};
+        return View(first, second);
+    }
+
+private:
+    std::vector<T> m_items;
+    int m_capacity = 0;
+    int m_head = 0;     // 最旧的元素
+    int m_size = 0;
+};
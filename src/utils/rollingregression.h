@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+// 滑动窗口的一元线性回归 y = intercept + slope * x，x 通常是时间（秒）
+//
+// 与 RunningStatistics 一样窗口由调用方维护：新点用 add() 加入，最旧的点离开窗口时用 removeOldest()
+// 传入它的 (x, y)。x、y 的均值和离差平方和、离差积和按双变量 Welford 公式增量更新，移除时做反向更新，
+// 不直接累加 Σx²、Σxy，x 很大（进程运行数月后的秒数）时也不会相消失去精度。
+// 每次更新和读取均为 O(1)。非线程安全
+class RollingRegression
+{
+public:
+    void add(double x, double y)
+    {
+        ++m_count;
+        const double dx = x - m_meanX;
+        m_meanX += dx / m_count;
+        const double dy = y - m_meanY;
+        m_meanY += dy / m_count;
+        m_sxx += dx * (x - m_meanX);
+        m_syy += dy * (y - m_meanY);
+        m_sxy += dx * (y - m_meanY);
+    }
+
+    // (x, y) 必须是窗口中最旧的点
+    void removeOldest(double x, double y)
+    {
+        if (m_count <= 1) {
+            clear();
+            return;
+        }
+
+        const double dx = x - m_meanX;
+        m_meanX -= dx / (m_count - 1);
+        const double dy = y - m_meanY;
+        m_meanY -= dy / (m_count - 1);
+        m_sxx = std::max(0.0, m_sxx - dx * (x - m_meanX));
+        m_syy = std::max(0.0, m_syy - dy * (y - m_meanY));
+        m_sxy -= dx * (y - m_meanY);
+        --m_count;
+    }
+
+    void clear()
+    {
+        *this = RollingRegression();
+    }
+
+    qint64 count() const { return m_count; }
+    double meanX() const { return m_meanX; }
+    double meanY() const { return m_meanY; }
+    double varianceY() const { return m_count > 1 ? m_syy / (m_count - 1) : 0.0; }    // 样本方差
+    double stdDeviationY() const { return std::sqrt(varianceY()); }
+
+    // x 没有变化（所有样本同一时刻）时斜率为 0
+    double slope() const { return m_sxx > 0.0 ? m_sxy / m_sxx : 0.0; }
+    double intercept() const { return m_meanY - slope() * m_meanX; }
+    double predict(double x) const { return m_meanY + slope() * (x - m_meanX); }
+
+private:
+    qint64 m_count = 0;
+    double m_meanX = 0.0;
+    double m_meanY = 0.0;
+    double m_sxx = 0.0;             // Σ (x - meanX)²
+    double m_syy = 0.0;             // Σ (y - meanY)²
+    double m_sxy = 0.0;             // Σ (x - meanX)(y - meanY)
+};
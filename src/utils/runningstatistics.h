@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+// 滑动窗口的增量统计量
+//
+// 窗口由调用方维护（通常是 SeriesRingBuffer）：新点用 add() 加入，最旧的点离开窗口时用 removeOldest()
+// 传入它的值。均值和方差按 Welford 算法增量更新，移除时做反向更新；最小/最大值各用一个单调队列，
+// 队首即当前窗口的极值。每次更新均摊 O(1)，读取为 O(1)。非线程安全。
+class RunningStatistics
+{
+public:
+    void add(double value)
+    {
+        ++m_count;
+        const double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+        m_sum += value;
+
+        // 队列中被新点压过的旧点永远不会再成为极值
+        const qint64 sequence = m_nextSequence++;
+        while (!m_minQueue.empty() && m_minQueue.back().value >= value) {
+            m_minQueue.pop_back();
+        }
+        m_minQueue.push_back({sequence, value});
+        while (!m_maxQueue.empty() && m_maxQueue.back().value <= value) {
+            m_maxQueue.pop_back();
+        }
+        m_maxQueue.push_back({sequence, value});
+    }
+
+    // value 必须是窗口中最旧的点
+    void removeOldest(double value)
+    {
+        if (m_count <= 1) {
+            clear();
+            return;
+        }
+
+        const double delta = value - m_mean;
+        m_mean -= delta / (m_count - 1);
+        m_m2 = std::max(0.0, m_m2 - delta * (value - m_mean));
+        m_sum -= value;
+        --m_count;
+
+        const qint64 sequence = m_firstSequence++;
+        if (!m_minQueue.empty() && m_minQueue.front().sequence == sequence) {
+            m_minQueue.pop_front();
+        }
+        if (!m_maxQueue.empty() && m_maxQueue.front().sequence == sequence) {
+            m_maxQueue.pop_front();
+        }
+    }
+
+    void clear()
+    {
+        *this = RunningStatistics();
+    }
+
+    qint64 count() const { return m_count; }
+    double mean() const { return m_mean; }
+    double sum() const { return m_sum; }
+    double variance() const { return m_count > 0 ? m_m2 / m_count : 0.0; }    // 总体方差
+    double stdDeviation() const { return std::sqrt(variance()); }
+    double minimum() const { return m_minQueue.empty() ? 0.0 : m_minQueue.front().value; }
+    double maximum() const { return m_maxQueue.empty() ? 0.0 : m_maxQueue.front().value; }
+
+private:
+    struct Entry {
+        qint64 sequence;
+        double value;
+    };
+
+    qint64 m_count = 0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;              // 与均值之差的平方和
+    double m_sum = 0.0;
+    qint64 m_firstSequence = 0;     // 窗口中最旧点的序号
+    qint64 m_nextSequence = 0;
+    std::deque<Entry> m_minQueue;   // 值严格递增
+    std::deque<Entry> m_maxQueue;   // 值严格递减
+};
@@ -0,0 +1,174 @@
+#include "seriesdecimator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 可见范围对应的序号区间 [from, to)，两侧各带一个范围外的点
+void visibleRange(const SeriesRingBuffer::View& data, qint64 startMs, qint64 endMs, int* from, int* to)
+{
+    const int lower = SeriesDecimator::lowerBound(data, startMs);
+    const int upper = endMs == std::numeric_limits<qint64>::max() ? data.size()
+                                                                  : SeriesDecimator::lowerBound(data, endMs + 1);
+    *from = std::max(0, lower - 1);
+    *to = std::min(data.size(), upper + 1);
+}
+
+QPointF pointAt(const SeriesRingBuffer::View& data, int i)
+{
+    return QPointF(static_cast<qreal>(data.timestampAt(i)), data.valueAt(i));
+}
+
+QList<QPointF> copyRange(const SeriesRingBuffer::View& data, int from, int to)
+{
+    QList<QPointF> points;
+    points.reserve(std::max(0, to - from));
+    for (int i = from; i < to; ++i) {
+        points.append(pointAt(data, i));
+    }
+    return points;
+}
+
+}
+
+int SeriesDecimator::lowerBound(const SeriesRingBuffer::View& data, qint64 timestampMs)
+{
+    int low = 0;
+    int high = data.size();
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (data.timestampAt(mid) < timestampMs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+QList<QPointF> SeriesDecimator::minMax(const SeriesRingBuffer::View& data, qint64 startMs, qint64 endMs, int columns)
+{
+    int from = 0;
+    int to = 0;
+    visibleRange(data, startMs, endMs, &from, &to);
+    if (columns <= 0 || to - from <= 2 * columns || endMs <= startMs) {
+        return copyRange(data, from, to);
+    }
+
+    QList<QPointF> points;
+    points.reserve(2 * columns + 2);
+
+    // 范围外的两个边界点单独保留，不参与分列
+    int first = from;
+    int last = to;
+    if (data.timestampAt(first) < startMs) {
+        points.append(pointAt(data, first++));
+    }
+    const bool trailing = last > first && data.timestampAt(last - 1) > endMs;
+    if (trailing) {
+        --last;
+    }
+
+    const qint64 span = endMs - startMs + 1;
+    int bucket = -1;
+    int minIndex = -1;
+    int maxIndex = -1;
+    const auto flush = [&]() {
+        if (minIndex < 0) {
+            return;
+        }
+        // 同一列内按时间先后输出，折线不会往回走
+        const int a = std::min(minIndex, maxIndex);
+        const int b = std::max(minIndex, maxIndex);
+        points.append(pointAt(data, a));
+        if (b != a) {
+            points.append(pointAt(data, b));
+        }
+    };
+
+    for (int i = first; i < last; ++i) {
+        const int column = static_cast<int>((data.timestampAt(i) - startMs) * columns / span);
+        if (column != bucket) {
+            flush();
+            bucket = column;
+            minIndex = i;
+            maxIndex = i;
+            continue;
+        }
+        const double value = data.valueAt(i);
+        if (value < data.valueAt(minIndex)) {
+            minIndex = i;
+        }
+        if (value > data.valueAt(maxIndex)) {
+            maxIndex = i;
+        }
+    }
+    flush();
+
+    if (trailing) {
+        points.append(pointAt(data, last));
+    }
+    return points;
+}
+
+QList<QPointF> SeriesDecimator::lttb(const SeriesRingBuffer::View& data, qint64 startMs, qint64 endMs, int threshold)
+{
+    int from = 0;
+    int to = 0;
+    visibleRange(data, startMs, endMs, &from, &to);
+    const int count = to - from;
+    if (threshold < 3 || count <= threshold) {
+        return copyRange(data, from, to);
+    }
+
+    // 以第一个点为原点计算面积，避免毫秒时间戳相乘损失精度
+    const qint64 origin = data.timestampAt(from);
+    const auto x = [&data, origin](int i) { return static_cast<double>(data.timestampAt(i) - origin); };
+
+    QList<QPointF> points;
+    points.reserve(threshold);
+    points.append(pointAt(data, from));
+
+    // 首尾两点固定，中间 count - 2 个点分成 threshold - 2 个桶
+    const double bucketSize = static_cast<double>(count - 2) / (threshold - 2);
+    int selected = from;
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        const int begin = from + 1 + static_cast<int>(bucket * bucketSize);
+        const int end = from + 1 + static_cast<int>((bucket + 1) * bucketSize);
+
+        // 下一个桶的均值，最后一个桶以尾点代替
+        const int nextBegin = end;
+        const int nextEnd = std::min(to, from + 1 + static_cast<int>((bucket + 2) * bucketSize));
+        double avgX = 0;
+        double avgY = 0;
+        if (bucket == threshold - 3 || nextEnd <= nextBegin) {
+            avgX = x(to - 1);
+            avgY = data.valueAt(to - 1);
+        } else {
+            for (int i = nextBegin; i < nextEnd; ++i) {
+                avgX += x(i);
+                avgY += data.valueAt(i);
+            }
+            avgX /= (nextEnd - nextBegin);
+            avgY /= (nextEnd - nextBegin);
+        }
+
+        const double ax = x(selected);
+        const double ay = data.valueAt(selected);
+        double maxArea = -1;
+        int chosen = begin;
+        for (int i = begin; i < end; ++i) {
+            const double area = std::abs((ax - avgX) * (data.valueAt(i) - ay) - (ax - x(i)) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                chosen = i;
+            }
+        }
+        points.append(pointAt(data, chosen));
+        selected = chosen;
+    }
+
+    points.append(pointAt(data, to - 1));
+    return points;
+}
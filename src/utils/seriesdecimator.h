@@ -0,0 +1,27 @@
+#pragma once
+
+#include "seriesringbuffer.h"
+#include <QList>
+#include <QPointF>
+
+// 图表绘制前的降采样
+//
+// 只处理 [startMs, endMs] 可见范围内的点，并在两侧各多取一个点，折线能画到绘图区边缘。
+// 可见点数不超过目标点数时原样返回。结果按时间顺序，x 为毫秒时间戳，可直接交给 QXYSeries::replace()。
+class SeriesDecimator
+{
+public:
+    // 按时间把可见范围等分为 columns 列（通常为绘图区像素宽度），每列保留最小值和最大值，
+    // 最多 2 * columns 个点。尖峰不会因降采样丢失，适合实时曲线
+    static QList<QPointF> minMax(const SeriesRingBuffer::View& data, qint64 startMs, qint64 endMs, int columns);
+
+    // Largest-Triangle-Three-Buckets：每个桶保留与前一个选中点、后一个桶均值构成三角形面积最大的点，
+    // 最多 threshold 个点。曲线形状保持较好，适合历史趋势
+    static QList<QPointF> lttb(const SeriesRingBuffer::View& data, qint64 startMs, qint64 endMs, int threshold);
+
+    // 第一个时间戳 >= timestampMs 的序号，全部更早时返回 size()
+    static int lowerBound(const SeriesRingBuffer::View& data, qint64 timestampMs);
+
+private:
+    SeriesDecimator() = delete;
+};
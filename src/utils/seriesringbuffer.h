@@ -0,0 +1,145 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <vector>
+
+// 定长时间序列环形缓冲区
+//
+// 时间戳（毫秒）和数值分别存放在两个连续数组中（结构数组分离），每个点 16 字节。
+// 容量在构造或 setCapacity() 时一次分配，append() 为 O(1) 且不分配内存，满了之后覆盖最旧的点。
+// view() 返回按时间顺序的只读视图，由最多两段连续区间组成，不拷贝数据；
+// 视图在缓冲区下一次修改之前有效。非线程安全。
+class SeriesRingBuffer
+{
+public:
+    // 一段连续的点
+    struct Span {
+        const qint64* timestamps = nullptr;
+        const double* values = nullptr;
+        int size = 0;
+    };
+
+    class View
+    {
+    public:
+        View() = default;
+        View(Span first, Span second) : m_first(first), m_second(second) {}
+
+        int size() const { return m_first.size + m_second.size; }
+        bool isEmpty() const { return size() == 0; }
+
+        // i 为按时间顺序的序号，0 为最旧的点
+        qint64 timestampAt(int i) const
+        {
+            return i < m_first.size ? m_first.timestamps[i] : m_second.timestamps[i - m_first.size];
+        }
+        double valueAt(int i) const
+        {
+            return i < m_first.size ? m_first.values[i] : m_second.values[i - m_first.size];
+        }
+
+        // 按时间顺序的两段，second 在缓冲区未回绕时为空
+        Span first() const { return m_first; }
+        Span second() const { return m_second; }
+
+        // visitor(timestampMs, value)，按时间顺序
+        template <typename Visitor>
+        void forEach(Visitor&& visitor) const
+        {
+            for (const Span& span : {m_first, m_second}) {
+                for (int i = 0; i < span.size; ++i) {
+                    visitor(span.timestamps[i], span.values[i]);
+                }
+            }
+        }
+
+    private:
+        Span m_first;
+        Span m_second;
+    };
+
+    explicit SeriesRingBuffer(int capacity = 0) { setCapacity(capacity); }
+
+    void append(qint64 timestampMs, double value)
+    {
+        if (m_capacity == 0) {
+            return;
+        }
+        int index = m_head + m_size;
+        if (index >= m_capacity) {
+            index -= m_capacity;
+        }
+        m_timestamps[index] = timestampMs;
+        m_values[index] = value;
+        if (m_size < m_capacity) {
+            ++m_size;
+        } else if (++m_head == m_capacity) {
+            m_head = 0;
+        }
+    }
+
+    // 覆盖最新的点（同一时刻的更新），缓冲区为空时追加
+    void replaceLast(qint64 timestampMs, double value)
+    {
+        if (m_size == 0) {
+            append(timestampMs, value);
+            return;
+        }
+        int index = m_head + m_size - 1;
+        if (index >= m_capacity) {
+            index -= m_capacity;
+        }
+        m_timestamps[index] = timestampMs;
+        m_values[index] = value;
+    }
+
+    void clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // 重新分配并保留最新的 min(size, capacity) 个点
+    void setCapacity(int capacity)
+    {
+        capacity = std::max(0, capacity);
+        if (capacity == m_capacity) {
+            return;
+        }
+
+        const int keep = std::min(m_size, capacity);
+        std::vector<qint64> timestamps(static_cast<size_t>(capacity));
+        std::vector<double> values(static_cast<size_t>(capacity));
+        const View current = view();
+        for (int i = 0; i < keep; ++i) {
+            timestamps[static_cast<size_t>(i)] = current.timestampAt(m_size - keep + i);
+            values[static_cast<size_t>(i)] = current.valueAt(m_size - keep + i);
+        }
+
+        m_timestamps.swap(timestamps);
+        m_values.swap(values);
+        m_capacity = capacity;
+        m_head = 0;
+        m_size = keep;
+    }
+
+    int size() const { return m_size; }
+    int capacity() const { return m_capacity; }
+    bool isEmpty() const { return m_size == 0; }
+
+    View view() const
+    {
+        const int firstSize = std::min(m_size, m_capacity - m_head);
+        const Span first{m_timestamps.data() + m_head, m_values.data() + m_head, firstSize};
+        const Span second{m_timestamps.data(), m_values.data(), m_size - firstSize};
+        return View(first, second);
+    }
+
+private:
+    std::vector<qint64> m_timestamps;
+    std::vector<double> m_values;
+    int m_capacity = 0;
+    int m_head = 0;     // 最旧的点
+    int m_size = 0;
+};
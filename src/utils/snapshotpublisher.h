@@ -0,0 +1,209 @@
+#pragma once
+
+#include <QDebug>
+#include <QMutex>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class SnapshotReader;
+
+// 版本化不可变快照 - 写入方构造完整的新快照后用一次原子指针交换发布，读取方无锁取得的总是某个完整版本，
+// 不会看到改了一半的多项配置。被替换的快照按静止状态（QSBR）延迟回收：每个读取方占一个槽位，记录它可能
+// 仍在使用的最旧版本，读取方在自己的安全点调用 SnapshotReader::refresh() 即表示之前的快照不再使用；
+// 所有槽位都越过某个旧版本后，下一次发布时释放它。发布之间由互斥锁串行，注册槽位和读取都不加锁。
+// 读取方须在发布器析构前 detach
+template <typename T>
+class SnapshotPublisher
+{
+public:
+    static constexpr int MAX_READERS = 32;
+
+    explicit SnapshotPublisher(T initial = T())
+    {
+        for (auto& slot : m_slots) {
+            slot.store(FREE_SLOT, std::memory_order_relaxed);
+        }
+        publish(std::move(initial));
+    }
+
+    ~SnapshotPublisher() { delete m_current.load(std::memory_order_relaxed); }
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // 发布新版本并回收不再被引用的旧版本，返回新版本号（从 1 开始递增）
+    quint64 publish(T value)
+    {
+        QMutexLocker locker(&m_writeMutex);
+        const Node* node = new Node{std::move(value), ++m_nextVersion};
+        const Node* previous = m_current.exchange(node, std::memory_order_seq_cst);
+        m_publishedVersion.store(node->version, std::memory_order_seq_cst);
+        if (previous) {
+            m_retired.emplace_back(previous);
+        }
+        reclaimLocked();
+        return node->version;
+    }
+
+    quint64 version() const { return m_publishedVersion.load(std::memory_order_acquire); }
+
+    // 当前快照的副本（加锁），供没有读取槽位的调用方使用
+    T copy() const
+    {
+        QMutexLocker locker(&m_writeMutex);
+        return m_current.load(std::memory_order_relaxed)->value;
+    }
+
+    // 已被替换、仍有读取方可能在用的旧版本数
+    int retiredCount() const
+    {
+        QMutexLocker locker(&m_writeMutex);
+        return static_cast<int>(m_retired.size());
+    }
+
+private:
+    friend class SnapshotReader<T>;
+
+    struct Node {
+        T value;
+        quint64 version;
+    };
+
+    static constexpr quint64 FREE_SLOT = 0;
+    static constexpr quint64 OFFLINE = std::numeric_limits<quint64>::max();     // 已注册但没有持有快照
+
+    int claimSlot()
+    {
+        for (int i = 0; i < MAX_READERS; ++i) {
+            quint64 expected = FREE_SLOT;
+            if (m_slots[i].compare_exchange_strong(expected, OFFLINE, std::memory_order_seq_cst)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void releaseSlot(int slot) { m_slots[slot].store(FREE_SLOT, std::memory_order_seq_cst); }
+
+    // 先在槽位登记已发布的版本再读指针：写入方扫描槽位若早于登记，读到的指针必然是扫描前已发布的版本
+    const Node* pin(int slot)
+    {
+        m_slots[slot].store(m_publishedVersion.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return m_current.load(std::memory_order_seq_cst);
+    }
+
+    void reclaimLocked()
+    {
+        quint64 oldestInUse = OFFLINE;
+        for (const auto& slot : m_slots) {
+            const quint64 version = slot.load(std::memory_order_seq_cst);
+            if (version != FREE_SLOT) {
+                oldestInUse = qMin(oldestInUse, version);
+            }
+        }
+        auto end = m_retired.begin();
+        for (auto it = m_retired.begin(); it != m_retired.end(); ++it) {
+            if ((*it)->version >= oldestInUse) {
+                *end++ = std::move(*it);
+            }
+        }
+        m_retired.erase(end, m_retired.end());
+    }
+
+    std::atomic<const Node*> m_current{nullptr};
+    std::atomic<quint64> m_publishedVersion{0};
+    std::array<std::atomic<quint64>, MAX_READERS> m_slots;     // 各读取方可能仍在使用的最旧版本
+    mutable QMutex m_writeMutex;
+    std::vector<std::unique_ptr<const Node>> m_retired;
+    quint64 m_nextVersion = 0;
+};
+
+// 快照读取方 - 只能由一个线程使用。attach 后第一次 refresh() 取得当前版本（返回 true），
+// get() 返回的快照在下一次 refresh() 或 detach() 之前保持有效，此前为 nullptr。
+// 槽位用尽时退化为在版本变化时加锁复制一份
+template <typename T>
+class SnapshotReader
+{
+public:
+    SnapshotReader() = default;
+    ~SnapshotReader() { detach(); }
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    void attach(SnapshotPublisher<T>* publisher)
+    {
+        detach();
+        if (!publisher) {
+            return;
+        }
+        m_publisher = publisher;
+        m_slot = publisher->claimSlot();
+        if (m_slot < 0) {
+            qWarning() << "[SnapshotReader] 读取槽位已用尽，改为加锁复制";
+        }
+    }
+
+    void detach()
+    {
+        if (m_publisher && m_slot >= 0) {
+            m_publisher->releaseSlot(m_slot);
+        }
+        m_publisher = nullptr;
+        m_slot = -1;
+        m_node = nullptr;
+        m_fallback.reset();
+        m_version = 0;
+    }
+
+    bool isAttached() const { return m_publisher != nullptr; }
+
+    // 安全点：放弃之前取得的快照并取最新版本，版本有变化时返回 true。版本未变时只读一次原子变量
+    bool refresh()
+    {
+        if (!m_publisher) {
+            return false;
+        }
+        const quint64 published = m_publisher->version();
+        if (published == m_version) {
+            return false;
+        }
+
+        if (m_slot < 0) {
+            m_fallback = std::make_unique<T>(m_publisher->copy());
+            m_version = published;
+            return true;
+        }
+
+        m_node = m_publisher->pin(m_slot);
+        const bool changed = m_node->version != m_version;
+        m_version = m_node->version;
+        return changed;
+    }
+
+    const T* get() const
+    {
+        if (m_node) {
+            return &m_node->value;
+        }
+        return m_fallback.get();
+    }
+
+    const T* operator->() const { return get(); }
+    quint64 version() const { return m_version; }
+
+private:
+    using Node = typename SnapshotPublisher<T>::Node;
+
+    SnapshotPublisher<T>* m_publisher = nullptr;
+    int m_slot = -1;
+    const Node* m_node = nullptr;
+    std::unique_ptr<T> m_fallback;
+    quint64 m_version = 0;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 有界无锁单生产者单消费者队列
+// 生产者只写入队尾位置、消费者只写入队头位置，两端各自缓存对端位置，
+// 队列不满/不空时 tryPush/tryPop 不读取对端的缓存行。容量向上取整为2的幂，队列满时 tryPush 返回 false
+template <typename T>
+class BoundedSpscQueue
+{
+public:
+    explicit BoundedSpscQueue(int capacity)
+    {
+        size_t size = 2;
+        while (size < static_cast<size_t>(qMax(2, capacity))) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots.reset(new T[size]);
+    }
+
+    BoundedSpscQueue(const BoundedSpscQueue&) = delete;
+    BoundedSpscQueue& operator=(const BoundedSpscQueue&) = delete;
+
+    // 只允许生产者线程调用；队列满时不移动 value
+    template <typename U>
+    bool tryPush(U&& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;   // 队列已满
+            }
+        }
+        m_slots[tail & m_mask] = std::forward<U>(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只允许消费者线程调用；value 应为空对象，移动后槽位不再持有资源
+    bool tryPop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;   // 队列为空
+            }
+        }
+        value = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值，仅供统计和唤醒判断
+    int sizeApprox() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        return tail > head ? static_cast<int>(tail - head) : 0;
+    }
+
+    bool isEmptyApprox() const { return sizeApprox() == 0; }
+    int capacity() const { return static_cast<int>(m_mask + 1); }
+
+private:
+    std::unique_ptr<T[]> m_slots;
+    size_t m_mask = 0;
+    // 生产者侧
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+    // 消费者侧
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+};
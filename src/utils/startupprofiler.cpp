@@ -0,0 +1,358 @@
+#include "startupprofiler.h"
+#include "allocationtracker.h"
+#include "monotonicclock.h"
+#include "tracer.h"
+#include "../constants.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <deque>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+std::atomic<bool> StartupProfiler::s_active{false};
+
+namespace {
+
+struct Mark {
+    const char* name;
+    qint64 offsetNs;
+};
+
+struct SessionState {
+    StartupProfiler::Session session = StartupProfiler::Session::Startup;
+    qint64 startNs = 0;
+    qint64 startEpochMs = 0;
+    StartupProfiler::Sample processBegin;
+    bool tracerOwned = false;
+    QList<StartupProfiler::Phase> phases;
+    QList<Mark> marks;
+};
+
+QMutex s_mutex;
+SessionState s_state;
+
+// 名称只增不删，deque 扩容时不移动已有元素
+QMutex s_internMutex;
+std::deque<QByteArray> s_internedNames;
+QHash<QString, const char*> s_internIndex;
+
+#ifdef Q_OS_WIN
+qint64 fileTimeNs(const FILETIME& time)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return static_cast<qint64>(value.QuadPart) * 100;
+}
+#else
+qint64 clockNs(clockid_t clock)
+{
+    timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+#endif
+
+qint64 threadCpuNs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    return fileTimeNs(kernel) + fileTimeNs(user);
+#else
+    return clockNs(CLOCK_THREAD_CPUTIME_ID);
+#endif
+}
+
+qint64 processCpuNs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    return fileTimeNs(kernel) + fileTimeNs(user);
+#else
+    return clockNs(CLOCK_PROCESS_CPUTIME_ID);
+#endif
+}
+
+// /proc/.../io 的 rchar、wchar：read/write 系统调用的字节数，含页缓存命中
+void readIoCounters(const char* path, qint64* readBytes, qint64* writtenBytes)
+{
+    *readBytes = 0;
+    *writtenBytes = 0;
+#ifdef Q_OS_LINUX
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    char buffer[512];
+    ssize_t length;
+    do {
+        length = read(fd, buffer, sizeof(buffer) - 1);
+    } while (length < 0 && errno == EINTR);
+    close(fd);
+    if (length <= 0) {
+        return;
+    }
+    buffer[length] = '\0';
+    if (const char* field = strstr(buffer, "rchar:")) {
+        *readBytes = strtoll(field + 6, nullptr, 10);
+    }
+    if (const char* field = strstr(buffer, "wchar:")) {
+        *writtenBytes = strtoll(field + 6, nullptr, 10);
+    }
+#else
+    Q_UNUSED(path);
+#endif
+}
+
+StartupProfiler::Sample sampleProcess()
+{
+    StartupProfiler::Sample sample;
+    sample.wallNs = MonotonicClock::nowNs();
+    sample.cpuNs = processCpuNs();
+    const AllocationTracker::Counters allocations = AllocationTracker::current();
+    sample.allocations = allocations.count;
+    sample.allocatedBytes = allocations.bytes;
+    readIoCounters("/proc/self/io", &sample.readBytes, &sample.writtenBytes);
+    return sample;
+}
+
+StartupProfiler::Sample difference(const StartupProfiler::Sample& begin, const StartupProfiler::Sample& end)
+{
+    StartupProfiler::Sample cost;
+    cost.wallNs = end.wallNs - begin.wallNs;
+    cost.cpuNs = end.cpuNs - begin.cpuNs;
+    cost.allocations = end.allocations - begin.allocations;
+    cost.allocatedBytes = end.allocatedBytes - begin.allocatedBytes;
+    cost.readBytes = end.readBytes - begin.readBytes;
+    cost.writtenBytes = end.writtenBytes - begin.writtenBytes;
+    return cost;
+}
+
+void writeCost(QJsonObject& object, const StartupProfiler::Sample& cost)
+{
+    object["wallMs"] = cost.wallNs / 1.0e6;
+    object["cpuMs"] = cost.cpuNs / 1.0e6;
+    object["allocations"] = cost.allocations;
+    object["allocatedBytes"] = cost.allocatedBytes;
+    object["readBytes"] = cost.readBytes;
+    object["writtenBytes"] = cost.writtenBytes;
+}
+
+const char* sessionName(StartupProfiler::Session session)
+{
+    return session == StartupProfiler::Session::Startup ? "startup" : "shutdown";
+}
+
+// 只保留最近的若干份报告（报告和跟踪文件成对删除）
+void pruneReports(const QDir& directory, const QString& prefix)
+{
+    const QStringList reports = directory.entryList({prefix + "_*.json"}, QDir::Files, QDir::Name);
+    QStringList sessions;
+    for (const QString& report : reports) {
+        if (!report.endsWith(".trace.json")) {
+            sessions.append(report);
+        }
+    }
+    for (int i = 0; i + System::STARTUP_PROFILE_KEEP < sessions.size(); ++i) {
+        directory.remove(sessions.at(i));
+        directory.remove(QString(sessions.at(i)).replace(".json", ".trace.json"));
+    }
+}
+
+}
+
+void StartupProfiler::beginSession(Session session)
+{
+    if (isActive()) {
+        finishSession();
+    }
+
+    {
+        QMutexLocker locker(&s_mutex);
+        s_state = SessionState();
+        s_state.session = session;
+        s_state.startNs = MonotonicClock::nowNs();
+        s_state.startEpochMs = QDateTime::currentMSecsSinceEpoch();
+        s_state.processBegin = sampleProcess();
+        // 用户已手动开启的跟踪不打断，也不在会话结束时关闭
+        s_state.tracerOwned = !Tracer::isEnabled();
+    }
+    if (!Tracer::isEnabled()) {
+        Tracer::setEnabled(true);
+    }
+    s_active.store(true, std::memory_order_relaxed);
+}
+
+StartupProfiler::Sample StartupProfiler::sampleThread()
+{
+    Sample sample;
+    sample.wallNs = MonotonicClock::nowNs();
+    sample.cpuNs = threadCpuNs();
+    const AllocationTracker::Counters allocations = AllocationTracker::currentThread();
+    sample.allocations = allocations.count;
+    sample.allocatedBytes = allocations.bytes;
+    readIoCounters("/proc/thread-self/io", &sample.readBytes, &sample.writtenBytes);
+    return sample;
+}
+
+void StartupProfiler::recordPhase(const char* name, const Sample& begin, const Sample& end)
+{
+    if (!isActive() || !name) {
+        return;
+    }
+    Tracer::recordSpan("startup", name, begin.wallNs, end.wallNs);
+
+    Phase phase;
+    phase.name = QString::fromUtf8(name);
+    phase.thread = QThread::currentThread()->objectName();
+    if (phase.thread.isEmpty()) {
+        phase.thread = QThread::currentThread() == QCoreApplication::instance()->thread()
+            ? QString("main") : QString("0x%1").arg(quintptr(QThread::currentThreadId()), 0, 16);
+    }
+    phase.cost = difference(begin, end);
+
+    QMutexLocker locker(&s_mutex);
+    phase.startNs = begin.wallNs - s_state.startNs;
+    s_state.phases.append(phase);
+}
+
+void StartupProfiler::mark(const char* name)
+{
+    if (!isActive()) {
+        return;
+    }
+    const qint64 nowNs = MonotonicClock::nowNs();
+    Tracer::recordSpan("startup", name, nowNs, nowNs);
+
+    QMutexLocker locker(&s_mutex);
+    s_state.marks.append(Mark{name, nowNs - s_state.startNs});
+}
+
+const char* StartupProfiler::intern(const QString& name)
+{
+    QMutexLocker locker(&s_internMutex);
+    auto it = s_internIndex.constFind(name);
+    if (it != s_internIndex.constEnd()) {
+        return it.value();
+    }
+    s_internedNames.push_back(name.toUtf8());
+    const char* interned = s_internedNames.back().constData();
+    s_internIndex.insert(name, interned);
+    return interned;
+}
+
+QList<StartupProfiler::Phase> StartupProfiler::phases()
+{
+    QMutexLocker locker(&s_mutex);
+    return s_state.phases;
+}
+
+QString StartupProfiler::finishSession(QString* error)
+{
+    if (!s_active.exchange(false, std::memory_order_relaxed)) {
+        return QString();
+    }
+
+    SessionState state;
+    {
+        QMutexLocker locker(&s_mutex);
+        state = s_state;
+        s_state.phases.clear();
+        s_state.marks.clear();
+    }
+    const Sample total = difference(state.processBegin, sampleProcess());
+
+    const QString prefix = sessionName(state.session);
+    const QString directoryPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/profiles";
+    QDir().mkpath(directoryPath);
+    const QString baseName = directoryPath + "/" + prefix + "_" +
+                             QDateTime::fromMSecsSinceEpoch(state.startEpochMs).toString("yyyyMMdd_hhmmss");
+
+    // 同一时间窗口的跟踪文件，自己开启的跟踪导出后关闭
+    QString traceError;
+    const int traceEvents = Tracer::exportChromeTrace(baseName + ".trace.json", &traceError);
+    if (state.tracerOwned) {
+        Tracer::setEnabled(false);
+    }
+
+    QJsonObject report;
+    report["session"] = prefix;
+    report["version"] = QCoreApplication::applicationVersion();
+    report["started"] = QDateTime::fromMSecsSinceEpoch(state.startEpochMs).toString(Qt::ISODateWithMs);
+    report["allocationTracking"] = AllocationTracker::isAvailable();
+    QJsonObject totals;
+    writeCost(totals, total);
+    report["total"] = totals;
+
+    QJsonArray phaseArray;
+    for (const Phase& phase : state.phases) {
+        QJsonObject object;
+        object["name"] = phase.name;
+        object["thread"] = phase.thread;
+        object["startMs"] = phase.startNs / 1.0e6;
+        writeCost(object, phase.cost);
+        phaseArray.append(object);
+    }
+    report["phases"] = phaseArray;
+
+    QJsonArray markArray;
+    for (const Mark& mark : state.marks) {
+        QJsonObject object;
+        object["name"] = QString::fromUtf8(mark.name);
+        object["atMs"] = mark.offsetNs / 1.0e6;
+        markArray.append(object);
+    }
+    report["marks"] = markArray;
+    report["traceFile"] = traceEvents >= 0 ? QFileInfo(baseName + ".trace.json").fileName() : QString();
+
+    const QString reportPath = baseName + ".json";
+    QSaveFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(report).toJson()) < 0 || !file.commit()) {
+        const QString message = QString("无法写入%1剖析报告 %2: %3").arg(prefix, reportPath, file.errorString());
+        qWarning() << "[StartupProfiler]" << message;
+        if (error) *error = message;
+        return QString();
+    }
+    if (traceEvents < 0) {
+        qWarning() << "[StartupProfiler]" << traceError;
+    }
+    pruneReports(QDir(directoryPath), prefix);
+
+    qDebug().noquote() << QString("[StartupProfiler] %1 用时 %2 ms，CPU %3 ms，%4 个阶段，报告: %5")
+                              .arg(prefix)
+                              .arg(total.wallNs / 1000000)
+                              .arg(total.cpuNs / 1000000)
+                              .arg(state.phases.size())
+                              .arg(reportPath);
+    return reportPath;
+}
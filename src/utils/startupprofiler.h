@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+// 启动/关闭阶段剖析 - 回答"启动的 6 秒花在哪里"
+//
+// 一次会话（启动或关闭）内，每个 STARTUP_PHASE 作用域记录墙钟时间、所在线程的 CPU 时间、
+// 所在线程的堆分配次数和字节数（AllocationTracker 开启时）以及所在线程的读写字节数（Linux 下取自
+// /proc/thread-self/io，其他平台为 0）。阶段按线程统计，并行执行的阶段互不串账；嵌套阶段的开销同时计入内外两层。
+// 会话期间同时开启 Tracer，阶段也作为 "startup" 类别的区间写入，finishSession() 用 Tracer::exportChromeTrace
+// 导出同一时间窗口的跟踪文件，与手动导出的格式一致。
+//
+// 报告为 JSON，写到 AppDataLocation/profiles，文件名带会话类型和时间，每种会话保留
+// System::STARTUP_PROFILE_KEEP 份，可以按版本号比较各阶段的耗时。
+// 会话之外 STARTUP_PHASE 只有一次 relaxed 原子读。
+class StartupProfiler
+{
+public:
+    enum class Session {
+        Startup,
+        Shutdown
+    };
+
+    // 线程级资源读数
+    struct Sample {
+        qint64 wallNs = 0;
+        qint64 cpuNs = 0;
+        qint64 allocations = 0;
+        qint64 allocatedBytes = 0;
+        qint64 readBytes = 0;
+        qint64 writtenBytes = 0;
+    };
+
+    struct Phase {
+        QString name;
+        QString thread;
+        qint64 startNs = 0;         // 相对会话开始
+        Sample cost;                // 结束读数减开始读数
+    };
+
+    static bool isActive() { return s_active.load(std::memory_order_relaxed); }
+
+    // 开始新会话；上一个会话尚未结束时先写出它的报告
+    static void beginSession(Session session);
+
+    // 写出报告和跟踪文件，返回报告路径，没有进行中的会话或写入失败返回空
+    static QString finishSession(QString* error = nullptr);
+
+    static Sample sampleThread();
+    static void recordPhase(const char* name, const Sample& begin, const Sample& end);
+    // 没有耗时的里程碑，如第一帧绘制、窗口显示
+    static void mark(const char* name);
+
+    // 动态生成的阶段名（页面标题、启动节点名）转为常量字符串，相同名称只保存一份，进程结束前不释放
+    // （跟踪缓冲区只保存名称指针）
+    static const char* intern(const QString& name);
+
+    static QList<Phase> phases();
+
+private:
+    static std::atomic<bool> s_active;
+
+    StartupProfiler() = delete;
+};
+
+// 作用域阶段，构造时不在会话中则析构时也不记录
+class StartupPhase
+{
+public:
+    explicit StartupPhase(const char* name)
+        : m_name(name)
+        , m_active(StartupProfiler::isActive())
+    {
+        if (m_active) {
+            m_begin = StartupProfiler::sampleThread();
+        }
+    }
+
+    explicit StartupPhase(const QString& name)
+        : m_name(nullptr)
+        , m_active(StartupProfiler::isActive())
+    {
+        if (m_active) {
+            m_name = StartupProfiler::intern(name);
+            m_begin = StartupProfiler::sampleThread();
+        }
+    }
+
+    ~StartupPhase()
+    {
+        if (m_active) {
+            StartupProfiler::recordPhase(m_name, m_begin, StartupProfiler::sampleThread());
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(StartupPhase)
+
+    const char* m_name;
+    bool m_active;
+    StartupProfiler::Sample m_begin;
+};
+
+#define STARTUP_PHASE_CONCAT_INNER(a, b) a##b
+#define STARTUP_PHASE_CONCAT(a, b) STARTUP_PHASE_CONCAT_INNER(a, b)
+#define STARTUP_PHASE(name) StartupPhase STARTUP_PHASE_CONCAT(startupPhase_, __LINE__)(name)
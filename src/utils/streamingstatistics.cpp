@@ -0,0 +1,184 @@
+#include "streamingstatistics.h"
+#include <QtMath>
+#include <algorithm>
+
+SlidingWindowStatistics::SlidingWindowStatistics(int capacity, int shortWindow, int lag, double ewmaAlpha)
+    : m_values(static_cast<size_t>(qMax(2, capacity)), 0.0)
+    , m_shortWindow(qBound(1, shortWindow, qMax(2, capacity)))
+    , m_lag(qBound(1, lag, qMax(2, capacity) - 1))
+    , m_ewmaAlpha(qBound(0.0, ewmaAlpha, 1.0))
+{
+}
+
+void SlidingWindowStatistics::add(double value)
+{
+    m_ewma = m_totalCount == 0 ? value : m_ewmaAlpha * value + (1.0 - m_ewmaAlpha) * m_ewma;
+    ++m_totalCount;
+
+    // 移出短窗口的样本在淘汰之前取，短窗口等于容量时它就是被淘汰的最旧样本
+    const double leavingShort = m_size >= m_shortWindow ? at(m_size - m_shortWindow) : 0.0;
+    m_shortSum += value - leavingShort;
+
+    if (m_size == capacity()) {
+        evictOldest();
+    }
+
+    const int index = m_size;
+    m_indexedSum += index * value;
+    if (index >= m_lag) {
+        const double lagged = at(index - m_lag);
+        m_laggedProductSum += value * lagged;
+        m_tailSum -= lagged;
+    } else {
+        m_headSum += value;
+    }
+    m_tailSum += value;
+
+    m_values[static_cast<size_t>(physicalIndex(index))] = value;
+    ++m_size;
+
+    m_sum += value;
+    const double delta = value - m_mean;
+    m_mean += delta / m_size;
+    m_m2 += delta * (value - m_mean);
+
+    if (m_evictionsSinceSync >= capacity()) {
+        resynchronize();
+    }
+}
+
+void SlidingWindowStatistics::evictOldest()
+{
+    const double oldest = at(0);
+
+    if (m_size > m_lag) {
+        const double partner = at(m_lag);
+        m_laggedProductSum -= partner * oldest;
+        m_headSum += partner - oldest;
+    } else {
+        m_headSum -= oldest;
+        m_tailSum -= oldest;
+    }
+
+    // 其余样本的序号都减 1
+    const double remainingSum = m_sum - oldest;
+    m_indexedSum -= remainingSum;
+    m_sum = remainingSum;
+
+    if (m_size > 1) {
+        const double mean = (m_mean * m_size - oldest) / (m_size - 1);
+        m_m2 = qMax(0.0, m_m2 - (oldest - m_mean) * (oldest - mean));
+        m_mean = mean;
+    } else {
+        m_mean = 0.0;
+        m_m2 = 0.0;
+    }
+
+    m_head = physicalIndex(1);
+    --m_size;
+    ++m_evictionsSinceSync;
+}
+
+void SlidingWindowStatistics::resynchronize()
+{
+    m_sum = 0.0;
+    m_indexedSum = 0.0;
+    for (int i = 0; i < m_size; ++i) {
+        const double value = at(i);
+        m_sum += value;
+        m_indexedSum += i * value;
+    }
+    m_mean = m_size > 0 ? m_sum / m_size : 0.0;
+
+    m_m2 = 0.0;
+    m_laggedProductSum = 0.0;
+    m_headSum = 0.0;
+    m_tailSum = 0.0;
+    m_shortSum = 0.0;
+    for (int i = 0; i < m_size; ++i) {
+        const double value = at(i);
+        m_m2 += (value - m_mean) * (value - m_mean);
+        if (i >= m_lag) {
+            m_laggedProductSum += value * at(i - m_lag);
+        } else {
+            m_headSum += value;
+        }
+        if (i >= m_size - m_lag) {
+            m_tailSum += value;
+        }
+        if (i >= m_size - m_shortWindow) {
+            m_shortSum += value;
+        }
+    }
+
+    m_evictionsSinceSync = 0;
+}
+
+void SlidingWindowStatistics::clear()
+{
+    *this = SlidingWindowStatistics(capacity(), m_shortWindow, m_lag, m_ewmaAlpha);
+}
+
+void SlidingWindowStatistics::setShortWindow(int shortWindow)
+{
+    m_shortWindow = qBound(1, shortWindow, capacity());
+    resynchronize();
+}
+
+void SlidingWindowStatistics::setLag(int lag)
+{
+    m_lag = qBound(1, lag, capacity() - 1);
+    resynchronize();
+}
+
+double SlidingWindowStatistics::variance() const
+{
+    return m_size > 1 ? m_m2 / m_size : 0.0;
+}
+
+double SlidingWindowStatistics::stdDeviation() const
+{
+    return qSqrt(variance());
+}
+
+double SlidingWindowStatistics::zScore(double value) const
+{
+    const double deviation = stdDeviation();
+    return deviation > 0.0 ? (value - m_mean) / deviation : 0.0;
+}
+
+double SlidingWindowStatistics::movingAverage() const
+{
+    const int count = qMin(m_size, m_shortWindow);
+    return count > 0 ? m_shortSum / count : 0.0;
+}
+
+double SlidingWindowStatistics::autocorrelation() const
+{
+    const int pairs = m_size - m_lag;
+    if (pairs < 2 || m_m2 <= 0.0) {
+        return 0.0;
+    }
+
+    // Σ(x_i - mean)(x_{i-lag} - mean) 按各部分和展开
+    const double laterSum = m_sum - m_headSum;      // i >= lag
+    const double earlierSum = m_sum - m_tailSum;    // i < size - lag
+    const double covariance = m_laggedProductSum - m_mean * (laterSum + earlierSum) + pairs * m_mean * m_mean;
+    return qBound(-1.0, covariance / m_m2, 1.0);
+}
+
+SlidingWindowStatistics::LinearTrend SlidingWindowStatistics::linearTrend() const
+{
+    LinearTrend trend;
+    if (m_size < 2) {
+        trend.intercept = m_mean;
+        return trend;
+    }
+
+    const double n = m_size;
+    const double meanIndex = (n - 1.0) / 2.0;
+    const double indexVariance = n * (n * n - 1.0) / 12.0;     // Σ (i - meanIndex)²
+    trend.slope = (m_indexedSum - meanIndex * m_sum) / indexVariance;
+    trend.intercept = m_mean - trend.slope * meanIndex;
+    return trend;
+}
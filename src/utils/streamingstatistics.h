@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+
+// 滑动窗口流式统计 - 保存最近 capacity 个样本（环形缓冲），每个新样本 O(1) 更新以下状态，读取也是 O(1)：
+//   窗口和与 Σ i·x（线性趋势，i 为窗口内序号，0 为最旧）、窗口均值和 M2（Welford 加入/移除公式）、
+//   最近 shortWindow 个样本的移动平均、整个数据流的 EWMA、滞后 lag 的自相关（Σ x_i·x_{i-lag}）。
+// 移除公式和窗口平移会累积舍入误差，每淘汰 capacity 个样本按缓冲区重新求和一次，均摊仍为 O(1)。非线程安全
+class SlidingWindowStatistics
+{
+public:
+    struct LinearTrend {
+        double slope = 0.0;
+        double intercept = 0.0;     // 对应窗口内序号 0（最旧的样本）
+    };
+
+    explicit SlidingWindowStatistics(int capacity = 1000, int shortWindow = 20, int lag = 12, double ewmaAlpha = 0.3);
+
+    void add(double value);
+    void clear();
+
+    // 修改参数后按缓冲区内的样本重建相关状态，O(capacity)
+    void setShortWindow(int shortWindow);
+    void setLag(int lag);
+
+    int capacity() const { return static_cast<int>(m_values.size()); }
+    int size() const { return m_size; }
+    qint64 totalCount() const { return m_totalCount; }
+    bool isEmpty() const { return m_size == 0; }
+
+    double last() const { return m_size > 0 ? at(m_size - 1) : 0.0; }
+    double at(int index) const { return m_values[static_cast<size_t>(physicalIndex(index))]; }    // 0 为最旧
+
+    double sum() const { return m_sum; }
+    double mean() const { return m_mean; }
+    double variance() const;                    // 总体方差，样本不足 2 个时为 0
+    double stdDeviation() const;
+    double zScore(double value) const;          // 标准差为 0 时为 0
+    double movingAverage() const;               // 最近 shortWindow 个样本（不足时取已有样本）的均值
+    double ewma() const { return m_ewma; }
+    double autocorrelation() const;             // 窗口内滞后 lag 的自相关系数 [-1, 1]，样本不足时为 0
+    LinearTrend linearTrend() const;            // 窗口内样本对序号 0..size-1 的最小二乘直线
+
+private:
+    int physicalIndex(int index) const
+    {
+        const int position = m_head + index;
+        return position >= capacity() ? position - capacity() : position;
+    }
+
+    void evictOldest();
+    void resynchronize();
+
+    std::vector<double> m_values;
+    int m_head = 0;                 // 最旧样本所在位置
+    int m_size = 0;
+    int m_shortWindow;
+    int m_lag;
+    double m_ewmaAlpha;
+
+    qint64 m_totalCount = 0;
+    int m_evictionsSinceSync = 0;
+
+    double m_sum = 0.0;
+    double m_indexedSum = 0.0;      // Σ i·x_i
+    double m_mean = 0.0;
+    double m_m2 = 0.0;              // Σ (x_i - mean)²
+    double m_shortSum = 0.0;
+    double m_ewma = 0.0;
+    double m_laggedProductSum = 0.0;    // Σ_{i>=lag} x_i·x_{i-lag}
+    double m_headSum = 0.0;         // 最旧 lag 个样本之和
+    double m_tailSum = 0.0;         // 最新 lag 个样本之和
+};
@@ -0,0 +1,330 @@
+#include "threadpolicy.h"
+#include "metricsregistry.h"
+#include "monotonicclock.h"
+#include "logger/logmanager.h"
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+namespace {
+constexpr qint64 NS_PER_MS = 1000000;
+
+// 已应用策略的线程不再重复应用（同一线程可能先后承载多个连接）
+thread_local bool t_policyApplied = false;
+
+SchedulingClass schedulingFromString(const QString& name)
+{
+    const QString lower = name.toLower();
+    if (lower == "realtime") {
+        return SchedulingClass::RealTime;
+    }
+    if (lower == "high") {
+        return SchedulingClass::High;
+    }
+    return SchedulingClass::Normal;
+}
+
+QString schedulingName(SchedulingClass scheduling)
+{
+    switch (scheduling) {
+    case SchedulingClass::High:     return "high";
+    case SchedulingClass::RealTime: return "realtime";
+    default:                        return "normal";
+    }
+}
+
+QString cpuList(quint64 mask)
+{
+    QStringList cpus;
+    for (int cpu = 0; cpu < 64; ++cpu) {
+        if (mask & (quint64(1) << cpu)) {
+            cpus << QString::number(cpu);
+        }
+    }
+    return cpus.join(',');
+}
+}
+
+ThreadPolicyConfig ThreadPolicyConfig::fromJson(const QJsonObject& object)
+{
+    ThreadPolicyConfig config;
+    config.enabled = object["enabled"].toBool(false);
+    config.timerResolutionMs = qMax(0, object["timer_resolution_ms"].toInt(0));
+    config.jitterProbeIntervalMs = qMax(0, object["jitter_probe_interval_ms"].toInt(config.jitterProbeIntervalMs));
+
+    const QJsonObject threads = object["threads"].toObject();
+    for (int i = 0; i < ROLE_COUNT; ++i) {
+        const QJsonObject thread = threads[ThreadPolicy::roleKey(static_cast<ThreadRole>(i))].toObject();
+        ThreadRolePolicy& policy = config.roles[i];
+        policy.scheduling = schedulingFromString(thread["scheduling"].toString());
+        policy.priority = qMax(0, thread["priority"].toInt(0));
+        policy.affinityMask = 0;
+        for (const QJsonValue& cpu : thread["cpus"].toArray()) {
+            const int index = cpu.toInt(-1);
+            if (index >= 0 && index < 64) {
+                policy.affinityMask |= quint64(1) << index;
+            }
+        }
+    }
+    return config;
+}
+
+ThreadPolicy* ThreadPolicy::getInstance()
+{
+    static ThreadPolicy instance;
+    return &instance;
+}
+
+ThreadPolicy::ThreadPolicy()
+    : m_timerResolutionMs(0)
+{
+    for (int i = 0; i < ROLE_COUNT; ++i) {
+        const QString role = metricPrefix(static_cast<ThreadRole>(i)).section('.', 1);
+        m_jitterMetrics[i] = MetricsRegistry::histogram("glue_thread_wakeup_jitter_seconds",
+                                                        "通讯和处理线程定时唤醒晚于预定时刻的时间",
+                                                        MetricsRegistry::label("role", role),
+                                                        MetricsRegistry::latencyBucketsNs());
+    }
+}
+
+ThreadPolicy::~ThreadPolicy()
+{
+    QMutexLocker locker(&m_mutex);
+    applyTimerResolutionLocked(0);
+}
+
+void ThreadPolicy::configure(const ThreadPolicyConfig& config)
+{
+    QMutexLocker locker(&m_mutex);
+    m_config = config;
+    applyTimerResolutionLocked(config.enabled ? config.timerResolutionMs : 0);
+
+    if (!config.enabled) {
+        return;
+    }
+    for (int i = 0; i < ROLE_COUNT; ++i) {
+        const ThreadRolePolicy& policy = config.roles[i];
+        if (policy.scheduling == SchedulingClass::Normal && policy.affinityMask == 0) {
+            continue;
+        }
+        LogManager::getInstance()->info(
+            QString("%1调度策略: %2，优先级 %3，CPU %4")
+                .arg(roleName(static_cast<ThreadRole>(i)), schedulingName(policy.scheduling))
+                .arg(policy.priority)
+                .arg(policy.affinityMask ? cpuList(policy.affinityMask) : QString("不限")),
+            "ThreadPolicy");
+    }
+}
+
+ThreadPolicyConfig ThreadPolicy::config() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_config;
+}
+
+bool ThreadPolicy::applyToCurrentThread(ThreadRole role)
+{
+    if (t_policyApplied) {
+        return true;
+    }
+    QCoreApplication* app = QCoreApplication::instance();
+    if (app && app->thread() == QThread::currentThread()) {
+        return false;
+    }
+
+    const ThreadPolicyConfig config = this->config();
+    if (!config.enabled) {
+        return true;
+    }
+    t_policyApplied = true;
+
+    const ThreadRolePolicy& policy = config.roles[static_cast<int>(role)];
+    bool ok = true;
+    if (policy.scheduling != SchedulingClass::Normal) {
+        if (!setCurrentThreadScheduling(policy.scheduling, policy.priority)) {
+            ok = false;
+            LogManager::getInstance()->warning(
+                QString("无法把%1设为 %2 调度（可能缺少权限），按默认优先级运行")
+                    .arg(roleName(role), schedulingName(policy.scheduling)),
+                "ThreadPolicy");
+        }
+    }
+    if (policy.affinityMask != 0) {
+        if (!setCurrentThreadAffinity(policy.affinityMask)) {
+            ok = false;
+            LogManager::getInstance()->warning(
+                QString("无法把%1绑定到CPU %2").arg(roleName(role), cpuList(policy.affinityMask)), "ThreadPolicy");
+        }
+    }
+
+    if (config.jitterProbeIntervalMs > 0) {
+        startJitterProbe(role, config.jitterProbeIntervalMs);
+    }
+    return ok;
+}
+
+void ThreadPolicy::recordWakeupJitter(ThreadRole role, qint64 latenessNs)
+{
+    const int index = static_cast<int>(role);
+    m_jitterMetrics[index]->observe(latenessNs);
+    QMutexLocker locker(&m_mutex);
+    m_total[index].record(latenessNs);
+    m_window[index].record(latenessNs);
+}
+
+HdrHistogram ThreadPolicy::jitterHistogram(ThreadRole role) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_total[static_cast<int>(role)];
+}
+
+ThreadPolicy::Histograms ThreadPolicy::takeJitterWindow()
+{
+    QMutexLocker locker(&m_mutex);
+    Histograms window = m_window;
+    for (HdrHistogram& histogram : m_window) {
+        histogram.reset();
+    }
+    return window;
+}
+
+QString ThreadPolicy::roleName(ThreadRole role)
+{
+    switch (role) {
+    case ThreadRole::SerialIo:    return "串口通讯线程";
+    case ThreadRole::TcpIo:       return "TCP网络线程";
+    case ThreadRole::CanIo:       return "CAN通讯线程";
+    case ThreadRole::DataProcess: return "数据处理线程";
+    default:                      return "未知线程";
+    }
+}
+
+QString ThreadPolicy::roleKey(ThreadRole role)
+{
+    switch (role) {
+    case ThreadRole::SerialIo:    return "serial";
+    case ThreadRole::TcpIo:       return "tcp";
+    case ThreadRole::CanIo:       return "can";
+    case ThreadRole::DataProcess: return "data_process";
+    default:                      return "unknown";
+    }
+}
+
+QString ThreadPolicy::metricPrefix(ThreadRole role)
+{
+    switch (role) {
+    case ThreadRole::SerialIo:    return "threadJitter.serial";
+    case ThreadRole::TcpIo:       return "threadJitter.tcp";
+    case ThreadRole::CanIo:       return "threadJitter.can";
+    case ThreadRole::DataProcess: return "threadJitter.dataProcess";
+    default:                      return "threadJitter.unknown";
+    }
+}
+
+bool ThreadPolicy::setCurrentThreadScheduling(SchedulingClass scheduling, int priority)
+{
+    if (scheduling == SchedulingClass::Normal) {
+        return true;
+    }
+#if defined(Q_OS_LINUX)
+    if (scheduling == SchedulingClass::RealTime) {
+        sched_param param{};
+        const int requested = priority > 0 ? priority : Communication::THREAD_REALTIME_DEFAULT_PRIORITY;
+        param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), requested, sched_get_priority_max(SCHED_FIFO));
+        return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+    // Linux 的 nice 值按线程生效
+    const int decrease = priority > 0 ? priority : Communication::THREAD_HIGH_DEFAULT_NICE;
+    const id_t tid = static_cast<id_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, tid, -qBound(1, decrease, 20)) == 0;
+#elif defined(Q_OS_WIN)
+    Q_UNUSED(priority)
+    const int level = scheduling == SchedulingClass::RealTime ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+    return SetThreadPriority(GetCurrentThread(), level) != 0;
+#else
+    Q_UNUSED(priority)
+    QThread::currentThread()->setPriority(scheduling == SchedulingClass::RealTime ? QThread::TimeCriticalPriority
+                                                                                   : QThread::HighestPriority);
+    return true;
+#endif
+}
+
+bool ThreadPolicy::setCurrentThreadAffinity(quint64 mask)
+{
+    if (mask == 0) {
+        return false;
+    }
+#if defined(Q_OS_LINUX)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+        if (mask & (quint64(1) << cpu)) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#elif defined(Q_OS_WIN)
+    const DWORD_PTR windowsMask = static_cast<DWORD_PTR>(mask);
+    if (windowsMask == 0) {
+        return false;   // 32 位进程只能使用前 32 个 CPU
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), windowsMask) != 0;
+#else
+    // macOS 等平台没有硬绑定接口
+    return false;
+#endif
+}
+
+void ThreadPolicy::applyTimerResolutionLocked(int resolutionMs)
+{
+    if (resolutionMs == m_timerResolutionMs) {
+        return;
+    }
+#if defined(Q_OS_WIN)
+    // timeBeginPeriod 与 timeEndPeriod 必须成对调用
+    if (m_timerResolutionMs > 0) {
+        timeEndPeriod(static_cast<UINT>(m_timerResolutionMs));
+    }
+    if (resolutionMs > 0 && timeBeginPeriod(static_cast<UINT>(resolutionMs)) != TIMERR_NOERROR) {
+        LogManager::getInstance()->warning(QString("无法把系统定时器分辨率设为 %1ms").arg(resolutionMs), "ThreadPolicy");
+        resolutionMs = 0;
+    }
+#endif
+    // 其他平台的定时器分辨率不需要调整
+    m_timerResolutionMs = resolutionMs;
+}
+
+void ThreadPolicy::startJitterProbe(ThreadRole role, int intervalMs)
+{
+    // 探测定时器属于当前线程，线程结束时随之删除
+    QTimer* probe = new QTimer();
+    probe->setTimerType(Qt::PreciseTimer);
+    probe->setInterval(intervalMs);
+    QObject::connect(QThread::currentThread(), &QThread::finished, probe, &QObject::deleteLater);
+
+    const qint64 intervalNs = qint64(intervalMs) * NS_PER_MS;
+    qint64 dueNs = MonotonicClock::nowNs() + intervalNs;
+    QObject::connect(probe, &QTimer::timeout, probe, [role, intervalNs, dueNs]() mutable {
+        const qint64 nowNs = MonotonicClock::nowNs();
+        ThreadPolicy::getInstance()->recordWakeupJitter(role, qMax<qint64>(0, nowNs - dueNs));
+        // 与 PreciseTimer 的排程一致：按原节拍推进，错过整个周期时从当前时刻重新计算
+        dueNs += intervalNs;
+        if (dueNs <= nowNs) {
+            dueNs = nowNs + intervalNs;
+        }
+    });
+    probe->start();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QString>
+#include <QJsonObject>
+#include <array>
+#include "hdrhistogram.h"
+#include "../constants.h"
+
+class MetricHistogram;
+
+// 承载实时路径的线程类别
+enum class ThreadRole {
+    SerialIo = 0,   // 串口通讯线程（CommunicationManager 工作线程、SerialWorker 所在线程）
+    TcpIo,          // TCP 专用网络线程和连接组 I/O 线程
+    CanIo,          // CanWorker 所在线程
+    DataProcess,    // DataProcessWorker 处理线程
+    RoleCount
+};
+
+enum class SchedulingClass {
+    Normal,     // 不调整
+    High,       // Linux: 降低线程 nice 值，Windows: THREAD_PRIORITY_HIGHEST
+    RealTime    // Linux: SCHED_FIFO，Windows: THREAD_PRIORITY_TIME_CRITICAL
+};
+
+struct ThreadRolePolicy {
+    SchedulingClass scheduling = SchedulingClass::Normal;
+    int priority = 0;           // RealTime 为 SCHED_FIFO 优先级，High 为 nice 降低的量；0 取默认值，Windows 忽略
+    quint64 affinityMask = 0;   // 允许运行的 CPU 位掩码，0 为不限制
+};
+
+struct ThreadPolicyConfig {
+    static constexpr int ROLE_COUNT = static_cast<int>(ThreadRole::RoleCount);
+
+    bool enabled = false;
+    int timerResolutionMs = 0;      // Windows 系统定时器分辨率（timeBeginPeriod），0 为不调整
+    int jitterProbeIntervalMs = Communication::THREAD_JITTER_PROBE_INTERVAL_MS;   // 唤醒抖动探测间隔，0 为不探测
+    std::array<ThreadRolePolicy, ROLE_COUNT> roles;
+
+    // 配置文件的 threading_policy 节，例如
+    // {"enabled": true, "timer_resolution_ms": 1,
+    //  "threads": {"serial": {"scheduling": "realtime", "priority": 60, "cpus": [2]},
+    //              "data_process": {"scheduling": "high", "cpus": [3]}}}
+    static ThreadPolicyConfig fromJson(const QJsonObject& object);
+};
+
+// 线程调度策略 - 按线程类别设置调度类别、优先级和 CPU 亲和性，并测量各类线程的唤醒抖动。
+// configure() 在通讯和处理线程启动之前调用，各线程启动后在线程内调用 applyToCurrentThread()。
+// 调整失败（如 Linux 下没有 CAP_SYS_NICE）只记录警告，线程以默认设置继续运行；
+// 主线程（界面线程）从不调整，SerialWorker 等对象留在主线程时调用无效果。
+//
+// 唤醒抖动：每个已应用策略的线程运行一个精确定时器，记录实际触发时刻晚于预定时刻的时间，
+// 即线程可运行到真正被调度之间被其他线程抢占的时间。周期窗口由 PerformanceMonitor 取走。
+class ThreadPolicy
+{
+public:
+    static constexpr int ROLE_COUNT = ThreadPolicyConfig::ROLE_COUNT;
+    using Histograms = std::array<HdrHistogram, ROLE_COUNT>;
+
+    static ThreadPolicy* getInstance();
+
+    void configure(const ThreadPolicyConfig& config);
+    ThreadPolicyConfig config() const;
+
+    // 在目标线程内调用；同一线程只应用一次，返回调度和亲和性是否都按配置设置成功
+    bool applyToCurrentThread(ThreadRole role);
+
+    void recordWakeupJitter(ThreadRole role, qint64 latenessNs);
+    HdrHistogram jitterHistogram(ThreadRole role) const;
+    // 取出上次调用以来的窗口并清零
+    Histograms takeJitterWindow();
+
+    static QString roleName(ThreadRole role);
+    // 配置文件 threads 节中的键，例如 DataProcess → "data_process"
+    static QString roleKey(ThreadRole role);
+    // 自定义指标名中的线程类别部分，例如 TcpIo → "threadJitter.tcp"
+    static QString metricPrefix(ThreadRole role);
+
+    // 作用于调用线程的平台接口
+    static bool setCurrentThreadScheduling(SchedulingClass scheduling, int priority);
+    static bool setCurrentThreadAffinity(quint64 mask);
+
+private:
+    ThreadPolicy();
+    ~ThreadPolicy();
+
+    // 调用方持有 m_mutex
+    void applyTimerResolutionLocked(int resolutionMs);
+    static void startJitterProbe(ThreadRole role, int intervalMs);
+
+    mutable QMutex m_mutex;
+    ThreadPolicyConfig m_config;
+    int m_timerResolutionMs;        // 当前生效的 timeBeginPeriod 值，0 为未调整
+    Histograms m_total;
+    Histograms m_window;
+    std::array<MetricHistogram*, ROLE_COUNT> m_jitterMetrics;  // 指标端点，记录时不需要 m_mutex
+};
@@ -0,0 +1,89 @@
+#include "tieredmetrichistory.h"
+#include <algorithm>
+#include <limits>
+
+TieredMetricHistory::TieredMetricHistory(int columnCount, qint64 memoryLimitBytes, int tierCount, int downsampleFactor)
+    : m_columnCount(qMax(1, columnCount))
+    , m_downsampleFactor(qMax(2, downsampleFactor))
+    , m_memoryLimit(qMax<qint64>(0, memoryLimitBytes))
+    , m_tiers(static_cast<size_t>(qMax(1, tierCount)))
+{
+    const int capacity = tierCapacity(m_memoryLimit);
+    for (Tier& tier : m_tiers) {
+        tier.ring.reset(m_columnCount, capacity);
+        tier.pendingSums.assign(static_cast<size_t>(m_columnCount), 0.0);
+    }
+}
+
+int TieredMetricHistory::tierCapacity(qint64 memoryLimit) const
+{
+    const qint64 rows = memoryLimit / tierCount() / MetricRing::bytesPerSample(m_columnCount);
+    return static_cast<int>(qBound<qint64>(m_downsampleFactor, rows, std::numeric_limits<int>::max() / (2 * m_columnCount)));
+}
+
+void TieredMetricHistory::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = qMax<qint64>(0, bytes);
+    const int capacity = tierCapacity(m_memoryLimit);
+    for (Tier& tier : m_tiers) {
+        tier.ring.setCapacity(capacity);
+    }
+}
+
+qint64 TieredMetricHistory::memoryUsage() const
+{
+    qint64 bytes = 0;
+    for (const Tier& tier : m_tiers) {
+        bytes += tier.ring.memoryUsage();
+        bytes += static_cast<qint64>(tier.pendingSums.size() * sizeof(double));
+    }
+    return bytes;
+}
+
+void TieredMetricHistory::append(qint64 timestamp, const double* values)
+{
+    push(0, timestamp, values);
+}
+
+void TieredMetricHistory::push(int tierIndex, qint64 timestamp, const double* values)
+{
+    Tier& tier = m_tiers[static_cast<size_t>(tierIndex)];
+
+    // 写满时 append 会覆盖最旧的样本，先把它移入下一层的待合并组，最后一层直接丢弃
+    if (tier.ring.size() == tier.ring.capacity() && tierIndex + 1 < tierCount()) {
+        Tier& next = m_tiers[static_cast<size_t>(tierIndex) + 1];
+        for (int column = 0; column < m_columnCount; ++column) {
+            next.pendingSums[static_cast<size_t>(column)] += tier.ring.valueAt(column, 0);
+        }
+        next.pendingTimestamp = tier.ring.timestampAt(0);
+        if (++next.pendingCount == m_downsampleFactor) {
+            // 下一层再移出样本时累加到更下一层的组，不会覆盖这里的均值
+            for (double& sum : next.pendingSums) {
+                sum /= m_downsampleFactor;
+            }
+            push(tierIndex + 1, next.pendingTimestamp, next.pendingSums.data());
+            std::fill(next.pendingSums.begin(), next.pendingSums.end(), 0.0);
+            next.pendingCount = 0;
+        }
+    }
+
+    tier.ring.append(timestamp, values);
+}
+
+void TieredMetricHistory::clear()
+{
+    for (Tier& tier : m_tiers) {
+        tier.ring.clear();
+        std::fill(tier.pendingSums.begin(), tier.pendingSums.end(), 0.0);
+        tier.pendingCount = 0;
+        tier.pendingTimestamp = 0;
+    }
+}
+
+void TieredMetricHistory::copyColumn(int tierIndex, int column, double* out) const
+{
+    const MetricRing& ring = tier(tierIndex);
+    for (int i = 0; i < ring.size(); ++i) {
+        out[i] = ring.valueAt(column, i);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "metricring.h"
+#include <QtGlobal>
+#include <vector>
+
+// 分层列式指标历史 - 每层是一个 MetricRing（各指标一列，共用时间戳），第 0 层保存原始样本。
+// 某层写满后，最旧的样本移出该层并累加到下一层的待合并组，每满 downsampleFactor 个取均值写入下一层
+// （时间戳取组内最后一个），最后一层写满后才丢弃最旧的样本。
+// 内存上限按层平均分配为各层容量，缓冲区只在构造和调整上限时分配，追加样本不分配内存。
+// 各层的区间均值、最值直接用 tier() 返回的 MetricRing 查询。非线程安全
+class TieredMetricHistory
+{
+public:
+    TieredMetricHistory(int columnCount, qint64 memoryLimitBytes, int tierCount = 3, int downsampleFactor = 12);
+
+    void append(qint64 timestamp, const double* values);    // values 须有 columnCount() 个元素
+    void clear();
+
+    // 重新分配各层，每层保留最新的样本，放不下的较旧样本直接丢弃
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const { return m_memoryLimit; }
+    qint64 memoryUsage() const;             // 各层缓冲区实际占用的字节数
+
+    int columnCount() const { return m_columnCount; }
+    int tierCount() const { return static_cast<int>(m_tiers.size()); }
+    int downsampleFactor() const { return m_downsampleFactor; }
+    const MetricRing& tier(int tier) const { return m_tiers[static_cast<size_t>(tier)].ring; }
+
+    // index 为 0 时是该层最旧的样本
+    int size(int tier = 0) const { return this->tier(tier).size(); }
+    int capacity(int tier = 0) const { return this->tier(tier).capacity(); }
+    bool isEmpty() const { return tier(0).isEmpty(); }
+    qint64 timestamp(int tier, int index) const { return this->tier(tier).timestampAt(index); }
+    double value(int tier, int column, int index) const { return this->tier(tier).valueAt(column, index); }
+    double latest(int column) const { return value(0, column, size(0) - 1); }    // 须非空
+    qint64 latestTimestamp() const { return timestamp(0, size(0) - 1); }
+
+    // 按时间顺序复制一列到 out（size(tier) 个元素）
+    void copyColumn(int tier, int column, double* out) const;
+
+private:
+    struct Tier {
+        MetricRing ring;
+        std::vector<double> pendingSums;    // 从上一层移入、尚未凑满一组的样本之和，凑满时原地换算为均值写入本层
+        int pendingCount = 0;
+        qint64 pendingTimestamp = 0;
+    };
+
+    int tierCapacity(qint64 memoryLimit) const;
+    void push(int tier, qint64 timestamp, const double* values);
+
+    int m_columnCount;
+    int m_downsampleFactor;
+    qint64 m_memoryLimit;
+    std::vector<Tier> m_tiers;
+};
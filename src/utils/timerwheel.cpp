@@ -0,0 +1,220 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(int slotCount, qint64 tickNs, qint64 startNs)
+    : m_freeHead(-1)
+    , m_mask(0)
+    , m_tickNs(qMax<qint64>(1, tickNs))
+    , m_currentTick(0)
+    , m_timerCount(0)
+    , m_armedCount(0)
+    , m_firingIndex(-1)
+{
+    int slots = 1;
+    while (slots < slotCount && slots < (1 << 20)) {
+        slots <<= 1;
+    }
+    m_slots.assign(slots, -1);
+    m_mask = slots - 1;
+    m_currentTick = startNs / m_tickNs;
+}
+
+TimerWheel::TimerId TimerWheel::add(Callback callback)
+{
+    int index = m_freeHead;
+    if (index >= 0) {
+        m_freeHead = m_entries[index].next;
+    } else {
+        index = int(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[index];
+    entry.callback = std::move(callback);
+    entry.prev = -1;
+    entry.next = -1;
+    entry.state = State::Idle;
+    entry.removePending = false;
+    ++m_timerCount;
+    return makeId(index, entry.generation);
+}
+
+void TimerWheel::remove(TimerId id)
+{
+    const int index = lookup(id);
+    if (index < 0) {
+        return;
+    }
+    Entry& entry = m_entries[index];
+    if (entry.state == State::Armed) {
+        unlink(index);
+    }
+    entry.state = State::Idle;
+    if (index == m_firingIndex) {
+        entry.removePending = true;
+        return;
+    }
+    release(index);
+}
+
+void TimerWheel::arm(TimerId id, qint64 delayNs, qint64 periodNs, qint64 nowNs)
+{
+    const int index = lookup(id);
+    if (index < 0) {
+        return;
+    }
+    Entry& entry = m_entries[index];
+    if (entry.state == State::Armed) {
+        unlink(index);
+    }
+
+    // 向上取整且至少晚于当前刻度，保证不会提前触发
+    entry.deadlineTick = qMax(tickFor(nowNs + qMax<qint64>(0, delayNs)), m_currentTick + 1);
+    entry.periodTicks = periodNs > 0 ? qMax<qint64>(1, (periodNs + m_tickNs - 1) / m_tickNs) : 0;
+    link(index);
+}
+
+void TimerWheel::disarm(TimerId id)
+{
+    const int index = lookup(id);
+    if (index < 0) {
+        return;
+    }
+    if (m_entries[index].state == State::Armed) {
+        unlink(index);
+    }
+    // 已在本轮到期列表中的也不再触发
+    m_entries[index].state = State::Idle;
+}
+
+bool TimerWheel::isArmed(TimerId id) const
+{
+    const int index = lookup(id);
+    return index >= 0 && m_entries[index].state == State::Armed;
+}
+
+qint64 TimerWheel::remainingNs(TimerId id, qint64 nowNs) const
+{
+    const int index = lookup(id);
+    if (index < 0 || m_entries[index].state != State::Armed) {
+        return -1;
+    }
+    return qMax<qint64>(0, m_entries[index].deadlineTick * m_tickNs - nowNs);
+}
+
+int TimerWheel::advance(qint64 nowNs)
+{
+    const qint64 targetTick = nowNs / m_tickNs;
+    if (targetTick <= m_currentTick) {
+        return 0;
+    }
+
+    // 跨过一整圈以上时每个槽位只需扫描一次
+    const qint64 steps = qMin(targetTick - m_currentTick, m_mask + 1);
+    m_due.clear();
+    for (qint64 step = 1; step <= steps; ++step) {
+        int index = m_slots[(m_currentTick + step) & m_mask];
+        while (index >= 0) {
+            Entry& entry = m_entries[index];
+            const int next = entry.next;
+            if (entry.deadlineTick <= targetTick) {
+                unlink(index);
+                entry.state = State::Due;
+                m_due.push_back({index, entry.generation});
+            }
+            index = next;
+        }
+    }
+    m_currentTick = targetTick;
+
+    // 先收集再触发：回调里启动的定时器不会在本轮被扫描到
+    int fired = 0;
+    for (size_t i = 0; i < m_due.size(); ++i) {
+        const DueTimer due = m_due[i];
+        Entry& entry = m_entries[due.index];
+        if (entry.generation != due.generation || entry.state != State::Due) {
+            continue;   // 被之前的回调停止、重新启动或移除
+        }
+        if (entry.periodTicks > 0) {
+            // 周期定时器按原节拍排下一次，落后太多时从当前刻度重新计算
+            entry.deadlineTick = qMax(entry.deadlineTick + entry.periodTicks, m_currentTick + 1);
+            link(due.index);
+        } else {
+            entry.state = State::Idle;
+        }
+
+        m_firingIndex = due.index;
+        entry.callback();
+        m_firingIndex = -1;
+        ++fired;
+
+        if (entry.removePending) {
+            release(due.index);
+        }
+    }
+    m_due.clear();
+    return fired;
+}
+
+int TimerWheel::lookup(TimerId id) const
+{
+    const quint32 index = quint32(id & 0xFFFFFFFFu);
+    if (id == InvalidTimer || index >= m_entries.size()) {
+        return -1;
+    }
+    const Entry& entry = m_entries[index];
+    if (entry.state == State::Free || entry.removePending || entry.generation != quint32(id >> 32)) {
+        return -1;
+    }
+    return int(index);
+}
+
+void TimerWheel::link(int index)
+{
+    Entry& entry = m_entries[index];
+    int& head = m_slots[entry.deadlineTick & m_mask];
+    entry.prev = -1;
+    entry.next = head;
+    if (head >= 0) {
+        m_entries[head].prev = index;
+    }
+    head = index;
+    entry.state = State::Armed;
+    ++m_armedCount;
+}
+
+void TimerWheel::unlink(int index)
+{
+    Entry& entry = m_entries[index];
+    if (entry.prev >= 0) {
+        m_entries[entry.prev].next = entry.next;
+    } else {
+        m_slots[entry.deadlineTick & m_mask] = entry.next;
+    }
+    if (entry.next >= 0) {
+        m_entries[entry.next].prev = entry.prev;
+    }
+    entry.prev = -1;
+    entry.next = -1;
+    --m_armedCount;
+}
+
+void TimerWheel::release(int index)
+{
+    Entry& entry = m_entries[index];
+    entry.callback = nullptr;
+    entry.state = State::Free;
+    entry.removePending = false;
+    // 代数递增使旧的 TimerId 失效，0 保留给 InvalidTimer
+    if (++entry.generation == 0) {
+        entry.generation = 1;
+    }
+    entry.prev = -1;
+    entry.next = m_freeHead;
+    m_freeHead = index;
+    --m_timerCount;
+}
+
+qint64 TimerWheel::tickFor(qint64 ns) const
+{
+    return (ns + m_tickNs - 1) / m_tickNs;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QtGlobal>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// 哈希时间轮 - 一个线程内的大量定时器共用一个驱动时钟（每刻度调用一次 advance），
+// 取代每个连接各自的 QTimer：启动、停止、重新启动都是 O(1) 的链表操作，不分配内存，
+// 到期检查只扫描经过的槽位。到期时间按刻度向上取整，定时器最多晚一个刻度触发，不会提前。
+// 超过一圈的到期时间留在槽位里，等绝对刻度到达时才触发。
+//
+// 只能在一个线程中使用，不加锁。回调中可以启动、停止或移除任何定时器（包括自己），
+// 不能析构时间轮本身。
+class TimerWheel
+{
+public:
+    using TimerId = quint64;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId InvalidTimer = 0;
+
+    // slotCount 向上取整为 2 的幂
+    TimerWheel(int slotCount, qint64 tickNs, qint64 startNs);
+
+    // 注册回调，返回未启动的定时器；回调只保存这一次，之后反复启动不再分配
+    TimerId add(Callback callback);
+    void remove(TimerId id);
+
+    // 从 nowNs 起 delayNs 后触发；periodNs > 0 时按该周期重复，已启动时重新计时
+    void arm(TimerId id, qint64 delayNs, qint64 periodNs, qint64 nowNs);
+    void disarm(TimerId id);
+    bool isArmed(TimerId id) const;
+    // 距下一次触发的时间，未启动时为 -1
+    qint64 remainingNs(TimerId id, qint64 nowNs) const;
+
+    // 推进到 nowNs，触发期间到期的定时器，返回触发数
+    int advance(qint64 nowNs);
+
+    qint64 tickNs() const { return m_tickNs; }
+    int timerCount() const { return m_timerCount; }
+    int armedCount() const { return m_armedCount; }
+
+private:
+    enum class State : quint8 { Free, Idle, Armed, Due };
+
+    struct Entry {
+        Callback callback;
+        qint64 deadlineTick = 0;
+        qint64 periodTicks = 0;
+        int prev = -1;
+        int next = -1;                  // 所在槽位链表；空闲时为空闲链表
+        quint32 generation = 1;
+        State state = State::Free;
+        bool removePending = false;     // 在自己的回调中被移除，回调返回后再释放
+    };
+
+    struct DueTimer {
+        int index;
+        quint32 generation;
+    };
+
+    // 有效的定时器返回下标，否则 -1
+    int lookup(TimerId id) const;
+    void link(int index);
+    void unlink(int index);
+    void release(int index);
+    qint64 tickFor(qint64 ns) const;
+
+    static TimerId makeId(int index, quint32 generation)
+    {
+        return (TimerId(generation) << 32) | TimerId(quint32(index));
+    }
+
+    std::deque<Entry> m_entries;        // 扩容时已有元素不移动，回调执行期间可以添加定时器
+    std::vector<int> m_slots;           // 各槽位链表头
+    std::vector<DueTimer> m_due;        // advance 内复用
+    int m_freeHead;
+    qint64 m_mask;
+    qint64 m_tickNs;
+    qint64 m_currentTick;               // 已处理到的刻度
+    int m_timerCount;
+    int m_armedCount;
+    int m_firingIndex;
+};
@@ -0,0 +1,244 @@
+#include "tracer.h"
+#include "../constants.h"
+#include <QCoreApplication>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+enum class TraceEventType : quint8 {
+    Span,
+    Counter
+};
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;      // Span
+    double value;           // Counter
+    TraceEventType type;
+};
+
+constexpr quint64 BUFFER_EVENTS = System::TRACE_THREAD_BUFFER_EVENTS;
+constexpr int EXPORT_CHUNK_BYTES = 1 << 20;   // 导出时攒够这么多字节写一次文件
+static_assert((BUFFER_EVENTS & (BUFFER_EVENTS - 1)) == 0, "TRACE_THREAD_BUFFER_EVENTS 必须是 2 的幂");
+
+// 单个线程的事件缓冲区：所属线程是唯一写入者，导出时只读
+struct TraceThreadBuffer {
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[BUFFER_EVENTS]};
+    std::atomic<quint64> written{0};        // 已写入的事件总数，事件写完后再递增
+    std::atomic<bool> abandoned{false};     // 所属线程已退出，清空记录时回收
+    QString threadName;
+    int threadId = 0;
+};
+
+QMutex s_buffersMutex;
+std::vector<std::shared_ptr<TraceThreadBuffer>> s_buffers;
+int s_nextThreadId = 1;
+std::atomic<qint64> s_clearedNs{0};        // 早于此时的事件视为已清空
+
+// 线程退出时标记缓冲区，事件保留到下次清空，退出的线程也能导出
+struct TraceBufferHolder {
+    std::shared_ptr<TraceThreadBuffer> buffer;
+    ~TraceBufferHolder()
+    {
+        if (buffer) {
+            buffer->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local TraceBufferHolder t_traceBuffer;
+
+TraceThreadBuffer* threadBuffer()
+{
+    if (!t_traceBuffer.buffer) {
+        auto buffer = std::make_shared<TraceThreadBuffer>();
+        QThread* thread = QThread::currentThread();
+        buffer->threadName = thread->objectName();
+        if (buffer->threadName.isEmpty()) {
+            const QCoreApplication* app = QCoreApplication::instance();
+            buffer->threadName = (app && app->thread() == thread) ? QString("主线程") : QString();
+        }
+        {
+            QMutexLocker locker(&s_buffersMutex);
+            buffer->threadId = s_nextThreadId++;
+            s_buffers.push_back(buffer);
+        }
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = QString("线程 %1").arg(buffer->threadId);
+        }
+        t_traceBuffer.buffer = std::move(buffer);
+    }
+    return t_traceBuffer.buffer.get();
+}
+
+TraceEvent& nextEvent(TraceThreadBuffer* buffer, quint64* index)
+{
+    *index = buffer->written.load(std::memory_order_relaxed);
+    return buffer->events[*index & (BUFFER_EVENTS - 1)];
+}
+
+void appendJsonString(QByteArray& out, const char* text)
+{
+    out += '"';
+    for (const char* p = text; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += char(c);
+        } else if (c < 0x20) {
+            out += QByteArray("\\u00") + QByteArray::number(c, 16).rightJustified(2, '0');
+        } else {
+            out += char(c);
+        }
+    }
+    out += '"';
+}
+
+// 微秒，保留到纳秒
+void appendMicroseconds(QByteArray& out, qint64 ns)
+{
+    out += QByteArray::number(double(ns) / 1000.0, 'f', 3);
+}
+
+}
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+void Tracer::setEnabled(bool enabled)
+{
+    if (enabled && !isEnabled()) {
+        clear();
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::clear()
+{
+    s_clearedNs.store(MonotonicClock::nowNs(), std::memory_order_relaxed);
+
+    QMutexLocker locker(&s_buffersMutex);
+    s_buffers.erase(std::remove_if(s_buffers.begin(), s_buffers.end(),
+                                   [](const std::shared_ptr<TraceThreadBuffer>& buffer) {
+                                       return buffer->abandoned.load(std::memory_order_acquire);
+                                   }),
+                    s_buffers.end());
+}
+
+void Tracer::recordSpan(const char* category, const char* name, qint64 startNs, qint64 endNs)
+{
+    TraceThreadBuffer* buffer = threadBuffer();
+    quint64 index;
+    TraceEvent& event = nextEvent(buffer, &index);
+    event.category = category;
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = endNs - startNs;
+    event.value = 0.0;
+    event.type = TraceEventType::Span;
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::recordCounter(const char* category, const char* name, double value)
+{
+    TraceThreadBuffer* buffer = threadBuffer();
+    quint64 index;
+    TraceEvent& event = nextEvent(buffer, &index);
+    event.category = category;
+    event.name = name;
+    event.startNs = MonotonicClock::nowNs();
+    event.durationNs = 0;
+    event.value = value;
+    event.type = TraceEventType::Counter;
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+int Tracer::exportChromeTrace(const QString& filePath, QString* error)
+{
+    std::vector<std::shared_ptr<TraceThreadBuffer>> buffers;
+    {
+        QMutexLocker locker(&s_buffersMutex);
+        buffers = s_buffers;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = QString("无法创建跟踪文件 %1: %2").arg(filePath, file.errorString());
+        return -1;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    const qint64 clearedNs = s_clearedNs.load(std::memory_order_relaxed);
+    std::vector<TraceEvent> events;
+    QByteArray out;
+    out.reserve(EXPORT_CHUNK_BYTES + 4096);
+    bool writeOk = true;
+    auto flush = [&]() {
+        writeOk = writeOk && file.write(out) == out.size();
+        out.clear();
+    };
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    int exported = 0;
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        const QByteArray tid = QByteArray::number(buffer->threadId);
+
+        // 先拷贝再检查写入位置：拷贝期间被覆盖或正在覆盖的槽位丢弃
+        const quint64 end = buffer->written.load(std::memory_order_acquire);
+        const quint64 begin = end > BUFFER_EVENTS ? end - BUFFER_EVENTS : 0;
+        events.clear();
+        for (quint64 i = begin; i < end; ++i) {
+            events.push_back(buffer->events[i & (BUFFER_EVENTS - 1)]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 after = buffer->written.load(std::memory_order_relaxed);
+        const quint64 valid = after >= BUFFER_EVENTS ? after - BUFFER_EVENTS + 1 : 0;
+        const size_t skip = static_cast<size_t>(std::min(end, std::max(begin, valid)) - begin);
+
+        if (!first) out += ',';
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid +
+               ",\"args\":{\"name\":";
+        appendJsonString(out, buffer->threadName.toUtf8().constData());
+        out += "}}";
+
+        for (size_t i = skip; i < events.size(); ++i) {
+            const TraceEvent& event = events[i];
+            if (event.startNs < clearedNs) {
+                continue;
+            }
+            out += ",{\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"cat\":";
+            appendJsonString(out, event.category);
+            out += ",\"ts\":";
+            appendMicroseconds(out, event.startNs);
+            if (event.type == TraceEventType::Span) {
+                out += ",\"ph\":\"X\",\"dur\":";
+                appendMicroseconds(out, event.durationNs);
+            } else {
+                out += ",\"ph\":\"C\",\"args\":{\"value\":" + QByteArray::number(event.value, 'g', 15) + '}';
+            }
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid + '}';
+            ++exported;
+            if (out.size() >= EXPORT_CHUNK_BYTES) {
+                flush();
+            }
+        }
+    }
+    out += "]}\n";
+    flush();
+
+    if (!writeOk || !file.commit()) {
+        if (error) *error = QString("写入跟踪文件 %1 失败: %2").arg(filePath, file.errorString());
+        return -1;
+    }
+    return exported;
+}
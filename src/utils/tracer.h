@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include "monotonicclock.h"
+
+// 跨模块的轻量级耗时跟踪，导出为 Chrome / Perfetto 的 JSON 跟踪格式
+//
+// TRACE_SCOPE(类别, 名称) 在作用域结束时记录一个耗时区间，TRACE_COUNTER(类别, 名称, 数值) 记录一个计数值。
+// 类别和名称必须是字符串常量，记录时只保存指针。每个线程第一次记录时分配自己的定长缓冲区
+// （System::TRACE_THREAD_BUFFER_EVENTS 个事件），写满后覆盖最旧的事件，记录时不加锁、不分配内存。
+// 关闭时 TRACE_SCOPE 只有一次 relaxed 原子读，不读取时钟，也不写入任何数据。
+//
+// exportChromeTrace() 可在任意线程调用，导出各线程缓冲区中现有的事件，导出时正在被覆盖的事件丢弃。
+// 导出的文件用 chrome://tracing 或 ui.perfetto.dev 打开。
+class Tracer
+{
+public:
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // 开启时丢弃之前的记录
+    static void setEnabled(bool enabled);
+    static void clear();
+
+    // 时间为 MonotonicClock::nowNs()
+    static void recordSpan(const char* category, const char* name, qint64 startNs, qint64 endNs);
+    static void recordCounter(const char* category, const char* name, double value);
+
+    // 返回写出的事件数，失败返回 -1
+    static int exportChromeTrace(const QString& filePath, QString* error = nullptr);
+
+private:
+    static std::atomic<bool> s_enabled;
+
+    Tracer() = delete;
+};
+
+// 作用域耗时区间，构造时未开启跟踪则析构时也不记录
+class TraceScope
+{
+public:
+    TraceScope(const char* category, const char* name)
+        : m_category(category)
+        , m_name(name)
+        , m_startNs(Tracer::isEnabled() ? MonotonicClock::nowNs() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startNs != 0) {
+            Tracer::recordSpan(m_category, m_name, m_startNs, MonotonicClock::nowNs());
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(TraceScope)
+
+    const char* m_category;
+    const char* m_name;
+    qint64 m_startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#define TRACE_COUNTER(category, name, value)                                                  \
+    do {                                                                                      \
+        if (Tracer::isEnabled()) {                                                            \
+            Tracer::recordCounter(category, name, static_cast<double>(value));                \
+        }                                                                                     \
+    } while (0)
@@ -0,0 +1,128 @@
+#include "workloadprofile.h"
+#include <QtGlobal>
+
+namespace {
+
+// 与 ConfigManager 中 Log/Level 的写法一致
+const char* const LOG_LEVEL_NAMES[] = {"Debug", "Info", "Warning", "Error", "Critical"};
+
+LogLevel parseLogLevel(const QString& text, LogLevel fallback)
+{
+    for (int i = 0; i < 5; ++i) {
+        if (text.compare(QLatin1String(LOG_LEVEL_NAMES[i]), Qt::CaseInsensitive) == 0) {
+            return static_cast<LogLevel>(i);
+        }
+    }
+    return fallback;
+}
+
+WorkloadProfile makeProfile(const QString& name, const QString& description)
+{
+    WorkloadProfile profile;
+    profile.name = name;
+    profile.description = description;
+    return profile;
+}
+
+}
+
+WorkloadProfile WorkloadProfile::fromJson(const QString& name, const QJsonObject& json,
+                                          const WorkloadProfile& base)
+{
+    WorkloadProfile profile = base;
+    profile.name = name;
+    profile.description = json["description"].toString(base.description);
+
+    const QJsonObject buffer = json["communication_buffer"].toObject();
+    profile.bufferMaxPoolSize = qMax(1, buffer["max_buffers"].toInt(base.bufferMaxPoolSize));
+    profile.bufferMagazineSize = qMax(0, buffer["magazine_size"].toInt(base.bufferMagazineSize));
+
+    const QJsonObject data = json["data_process"].toObject();
+    profile.dataBatchSize = qMax(1, data["batch_size"].toInt(base.dataBatchSize));
+    profile.dataMaxQueueSize = qMax(1, data["max_queue_size"].toInt(base.dataMaxQueueSize));
+
+    const QJsonObject ui = json["ui_update_optimizer"].toObject();
+    profile.uiRealTimeIntervalMs = qMax(0, ui["realtime_interval_ms"].toInt(base.uiRealTimeIntervalMs));
+    profile.uiChartIntervalMs = qMax(0, ui["chart_interval_ms"].toInt(base.uiChartIntervalMs));
+    profile.uiStatusIntervalMs = qMax(0, ui["status_interval_ms"].toInt(base.uiStatusIntervalMs));
+    profile.uiMaxBatchSize = qMax(1, ui["batch_size"].toInt(base.uiMaxBatchSize));
+
+    const QJsonObject log = json["log"].toObject();
+    profile.logLevel = parseLogLevel(log["level"].toString(), base.logLevel);
+
+    const QJsonObject monitor = json["performance_monitor"].toObject();
+    profile.monitorIntervalMs = qMax(100, monitor["sampling_interval_ms"].toInt(base.monitorIntervalMs));
+    return profile;
+}
+
+QJsonObject WorkloadProfile::toJson() const
+{
+    QJsonObject json;
+    json["description"] = description;
+    json["communication_buffer"] = QJsonObject{
+        {"max_buffers", bufferMaxPoolSize},
+        {"magazine_size", bufferMagazineSize}
+    };
+    json["data_process"] = QJsonObject{
+        {"batch_size", dataBatchSize},
+        {"max_queue_size", dataMaxQueueSize}
+    };
+    json["ui_update_optimizer"] = QJsonObject{
+        {"realtime_interval_ms", uiRealTimeIntervalMs},
+        {"chart_interval_ms", uiChartIntervalMs},
+        {"status_interval_ms", uiStatusIntervalMs},
+        {"batch_size", uiMaxBatchSize}
+    };
+    json["log"] = QJsonObject{{"level", QLatin1String(LOG_LEVEL_NAMES[static_cast<int>(logLevel)])}};
+    json["performance_monitor"] = QJsonObject{{"sampling_interval_ms", monitorIntervalMs}};
+    return json;
+}
+
+QList<WorkloadProfile> WorkloadProfile::builtinProfiles()
+{
+    QList<WorkloadProfile> profiles;
+
+    profiles.append(makeProfile("balanced", "均衡（各组件默认设置）"));
+
+    // 单元控制：单帧立即处理，界面按帧刷新，少写日志
+    WorkloadProfile lowLatency = makeProfile("low_latency", "低延迟单元控制");
+    lowLatency.bufferMagazineSize = 32;
+    lowLatency.dataBatchSize = 1;
+    lowLatency.dataMaxQueueSize = 500;
+    lowLatency.uiRealTimeIntervalMs = 16;
+    lowLatency.uiChartIntervalMs = 33;
+    lowLatency.uiStatusIntervalMs = 100;
+    lowLatency.uiMaxBatchSize = 20;
+    lowLatency.logLevel = LogLevel::Warning;
+    profiles.append(lowLatency);
+
+    // 数据采集：大批量、深队列，界面降频换吞吐
+    WorkloadProfile highThroughput = makeProfile("high_throughput", "高吞吐数据采集");
+    highThroughput.bufferMaxPoolSize = 5000;
+    highThroughput.bufferMagazineSize = 64;
+    highThroughput.dataBatchSize = 64;
+    highThroughput.dataMaxQueueSize = 20000;
+    highThroughput.uiRealTimeIntervalMs = 100;
+    highThroughput.uiChartIntervalMs = 250;
+    highThroughput.uiStatusIntervalMs = 500;
+    highThroughput.uiMaxBatchSize = 100;
+    highThroughput.logLevel = LogLevel::Warning;
+    highThroughput.monitorIntervalMs = 5000;
+    profiles.append(highThroughput);
+
+    // 面板机：小内存占用，界面和监控都少唤醒
+    WorkloadProfile lowPower = makeProfile("low_power", "低功耗面板机");
+    lowPower.bufferMaxPoolSize = 300;
+    lowPower.bufferMagazineSize = 8;
+    lowPower.dataBatchSize = 32;
+    lowPower.dataMaxQueueSize = 2000;
+    lowPower.uiRealTimeIntervalMs = 250;
+    lowPower.uiChartIntervalMs = 500;
+    lowPower.uiStatusIntervalMs = 1000;
+    lowPower.uiMaxBatchSize = 50;
+    lowPower.logLevel = LogLevel::Warning;
+    lowPower.monitorIntervalMs = 10000;
+    profiles.append(lowPower);
+
+    return profiles;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include "logger/logrecord.h"
+
+// 工作负载配置档 - 一组同时作用于缓冲池、数据处理、界面更新、日志和性能监控的设置，
+// 由 PerformanceConfigManager::applyWorkloadProfile() 在运行时整体切换
+struct WorkloadProfile {
+    QString name;                   // 配置档标识，如 "low_latency"
+    QString description;
+
+    // 通信缓冲池（CommunicationBufferPool）
+    int bufferMaxPoolSize = 1000;
+    int bufferMagazineSize = 16;    // 线程本地弹匣容量，0 关闭线程缓存
+
+    // 数据处理（DataProcessWorker / DataProcessShardPool）
+    int dataBatchSize = 10;
+    int dataMaxQueueSize = 1000;
+
+    // 界面更新（UIUpdateOptimizer），单位 ms
+    int uiRealTimeIntervalMs = 16;
+    int uiChartIntervalMs = 200;
+    int uiStatusIntervalMs = 100;
+    int uiMaxBatchSize = 10;
+
+    // 日志（LogManager）
+    LogLevel logLevel = LogLevel::Info;
+
+    // 性能监控（PerformanceMonitor）
+    int monitorIntervalMs = 1000;
+
+    // 缺少的字段保留 base 中的值
+    static WorkloadProfile fromJson(const QString& name, const QJsonObject& json,
+                                    const WorkloadProfile& base = WorkloadProfile());
+    QJsonObject toJson() const;
+
+    // 内置配置档：balanced（与各组件默认值一致）、low_latency、high_throughput、low_power
+    static QList<WorkloadProfile> builtinProfiles();
+};
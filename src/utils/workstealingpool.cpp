@@ -0,0 +1,254 @@
+#include "workstealingpool.h"
+#include "../constants.h"
+#include <QThread>
+
+namespace {
+// 当前线程所属的池和线程序号，用于把池内派生的任务放入本线程队列
+thread_local const WorkStealingPool* t_currentPool = nullptr;
+thread_local int t_workerIndex = -1;
+}
+
+WorkStealingPool::Worker::Worker()
+    : inbox(System::WORK_STEALING_INBOX_CAPACITY)
+{
+}
+
+WorkStealingPool::WorkStealingPool(int threadCount, const QString& name)
+    : m_pending(0)
+    , m_sleepers(0)
+    , m_nextWorker(0)
+    , m_stopping(0)
+    , m_submitted(0)
+    , m_overflowCount(0)
+{
+    const int count = qMax(1, threadCount);
+    m_workers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->randomState = 0x9E3779B9u * static_cast<quint32>(i + 1);
+    }
+
+    m_window.start();
+
+    // 所有队列就绪后再启动线程，窃取时不会访问到未构造的队列
+    for (int i = 0; i < count; ++i) {
+        QThread* thread = QThread::create([this, i]() { run(i); });
+        thread->setObjectName(QString("%1-%2").arg(name).arg(i));
+        m_workers[i]->thread = thread;
+        thread->start();
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        QMutexLocker locker(&m_sleepMutex);
+        m_stopping.storeRelease(1);
+        m_sleepCondition.wakeAll();
+    }
+
+    for (const auto& worker : m_workers) {
+        worker->thread->wait();
+        delete worker->thread;
+    }
+}
+
+void WorkStealingPool::submit(Task task, int priority, int preferredThread)
+{
+    Job* job = new Job{std::move(task), qBound(0, priority, PRIORITY_BANDS - 1)};
+    const int count = static_cast<int>(m_workers.size());
+    m_submitted.fetchAndAddRelaxed(1);
+    // 先计数再放入队列：空闲线程看到计数就不会睡眠，最多等到任务放好
+    m_pending.fetch_add(1, std::memory_order_seq_cst);
+
+    if (t_currentPool == this && (preferredThread < 0 || preferredThread % count == t_workerIndex)) {
+        // 池内派生的任务直接放入本线程的双端队列，无需同步
+        m_workers[t_workerIndex]->deques[job->priority].push(job);
+    } else {
+        const int index = preferredThread >= 0
+                              ? preferredThread % count
+                              : static_cast<int>(static_cast<quint32>(m_nextWorker.fetchAndAddRelaxed(1)) % count);
+        if (!m_workers[index]->inbox.tryPush(job)) {
+            QMutexLocker locker(&m_overflowMutex);
+            m_overflow.push_back(job);
+            m_overflowCount.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // 与 run() 中的 m_sleepers/m_pending 构成 Dekker 式检查：两边都是 seq_cst，
+    // 要么这里看到睡眠者并唤醒，要么睡眠前看到新任务
+    if (m_sleepers.load(std::memory_order_seq_cst) > 0) {
+        QMutexLocker locker(&m_sleepMutex);
+        m_sleepCondition.wakeOne();
+    }
+}
+
+void WorkStealingPool::run(int index)
+{
+    t_currentPool = this;
+    t_workerIndex = index;
+    Worker& self = *m_workers[index];
+
+    for (;;) {
+        Job* job = nullptr;
+        bool stolen = false;
+        if (takeLocal(index, job) || (stolen = steal(index, job)) || takeOverflow(job)) {
+            m_pending.fetch_sub(1, std::memory_order_seq_cst);
+
+            QElapsedTimer timer;
+            timer.start();
+            job->task();
+            delete job;
+            self.busyNs.fetchAndAddRelaxed(timer.nsecsElapsed());
+            self.executed.fetchAndAddRelaxed(1);
+            if (stolen) {
+                self.stolen.fetchAndAddRelaxed(1);
+            }
+            continue;
+        }
+
+        // 有任务但这一轮没取到：提交者尚未放好，或窃取时与其他线程冲突
+        if (m_pending.load(std::memory_order_seq_cst) > 0) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        QMutexLocker locker(&m_sleepMutex);
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        while (m_pending.load(std::memory_order_seq_cst) == 0 && !m_stopping.loadAcquire()) {
+            m_sleepCondition.wait(&m_sleepMutex);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        // 停止前先把已提交的任务执行完
+        if (m_stopping.loadAcquire() && m_pending.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    t_currentPool = nullptr;
+    t_workerIndex = -1;
+}
+
+bool WorkStealingPool::takeLocal(int index, Job*& job)
+{
+    Worker& self = *m_workers[index];
+    drainInbox(self);
+    for (int band = PRIORITY_BANDS - 1; band >= 0; --band) {
+        if (self.deques[band].pop(job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::steal(int thief, Job*& job)
+{
+    const int count = static_cast<int>(m_workers.size());
+    if (count < 2) {
+        return false;
+    }
+
+    // xorshift 随机选择起点，避免所有空闲线程同时挤在同一个受害者上
+    Worker& self = *m_workers[thief];
+    self.randomState ^= self.randomState << 13;
+    self.randomState ^= self.randomState >> 17;
+    self.randomState ^= self.randomState << 5;
+    const int start = static_cast<int>(self.randomState % static_cast<quint32>(count));
+
+    for (int band = PRIORITY_BANDS - 1; band >= 0; --band) {
+        for (int offset = 0; offset < count; ++offset) {
+            const int victim = (start + offset) % count;
+            if (victim != thief
+                && m_workers[victim]->deques[band].steal(job) == ChaseLevDeque<Job*>::StealResult::Success) {
+                return true;
+            }
+        }
+    }
+
+    // 所有者正忙于长任务时，它收件箱里的任务也可以被拿走
+    for (int offset = 0; offset < count; ++offset) {
+        const int victim = (start + offset) % count;
+        if (victim != thief && popInbox(*m_workers[victim], job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::takeOverflow(Job*& job)
+{
+    if (m_overflowCount.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    QMutexLocker locker(&m_overflowMutex);
+    if (m_overflow.empty()) {
+        return false;
+    }
+    job = m_overflow.front();
+    m_overflow.pop_front();
+    m_overflowCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void WorkStealingPool::drainInbox(Worker& worker)
+{
+    if (worker.inbox.isEmptyApprox() || worker.inboxClaimed.exchange(true, std::memory_order_acquire)) {
+        return;
+    }
+    Job* job = nullptr;
+    while (worker.inbox.tryPop(job)) {
+        worker.deques[job->priority].push(job);
+    }
+    worker.inboxClaimed.store(false, std::memory_order_release);
+}
+
+bool WorkStealingPool::popInbox(Worker& worker, Job*& job)
+{
+    if (worker.inbox.isEmptyApprox() || worker.inboxClaimed.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+    const bool popped = worker.inbox.tryPop(job);
+    worker.inboxClaimed.store(false, std::memory_order_release);
+    return popped;
+}
+
+WorkStealingPool::Statistics WorkStealingPool::statistics() const
+{
+    Statistics result;
+    {
+        QMutexLocker locker(&m_windowMutex);
+        result.windowNs = qMax<qint64>(1, m_window.nsecsElapsed());
+    }
+    result.submitted = m_submitted.loadRelaxed();
+
+    double totalUtilization = 0.0;
+    for (const auto& worker : m_workers) {
+        ThreadStatistics item;
+        item.executed = worker->executed.loadRelaxed();
+        item.stolen = worker->stolen.loadRelaxed();
+        item.busyNs = worker->busyNs.loadRelaxed();
+        item.utilization = qMin(1.0, static_cast<double>(item.busyNs) / result.windowNs);
+        item.queued = worker->inbox.sizeApprox();
+        for (const auto& deque : worker->deques) {
+            item.queued += deque.sizeApprox();
+        }
+        result.executed += item.executed;
+        result.stolen += item.stolen;
+        totalUtilization += item.utilization;
+        result.threads.append(item);
+    }
+    result.utilization = totalUtilization / m_workers.size();
+    return result;
+}
+
+void WorkStealingPool::resetStatistics()
+{
+    QMutexLocker locker(&m_windowMutex);
+    for (const auto& worker : m_workers) {
+        worker->executed.storeRelaxed(0);
+        worker->stolen.storeRelaxed(0);
+        worker->busyNs.storeRelaxed(0);
+    }
+    m_submitted.storeRelaxed(0);
+    m_window.restart();
+}
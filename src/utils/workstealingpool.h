@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "chaselevdeque.h"
+#include "mpscqueue.h"
+
+class QThread;
+
+// 工作窃取线程池 - 每个线程每个优先级一个 Chase-Lev 双端队列：自己从底部取（后进先出，缓存友好），
+// 空闲线程随机选一个线程开始，从其他线程的顶部窃取。取任务和窃取都先看高优先级，
+// 优先级只在单个线程内严格，跨线程是尽力而为。
+// 外部线程的提交放入目标线程的无锁收件箱（MPSC 队列），所有者把它转入自己的双端队列，
+// 收件箱也可以被空闲线程抢占消费；收件箱满时放入共享的溢出队列。
+// 外部提交可以指定偏好的线程（亲和性提示），否则轮流分发；池内任务派生的子任务放入当前线程的队列。
+// 适合耗时、互相独立的任务；不保证执行顺序。析构时先执行完所有已提交的任务再结束线程。
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // 优先级档数，0 最低，与 LoadBalancer::TaskPriority 一一对应
+    static constexpr int PRIORITY_BANDS = 4;
+
+    struct ThreadStatistics {
+        qint64 executed = 0;        // 执行的任务数（含窃取）
+        qint64 stolen = 0;          // 从其他线程窃取的任务数
+        qint64 busyNs = 0;          // 执行任务的累计时间
+        double utilization = 0.0;   // busyNs / 统计窗口时长
+        int queued = 0;             // 当前队列中的任务数
+    };
+
+    struct Statistics {
+        qint64 submitted = 0;
+        qint64 executed = 0;
+        qint64 stolen = 0;
+        qint64 windowNs = 0;        // 统计窗口时长（创建或上次重置以来）
+        double utilization = 0.0;   // 全部线程的平均利用率
+        QList<ThreadStatistics> threads;
+    };
+
+    explicit WorkStealingPool(int threadCount, const QString& name = QString("WorkStealingPool"));
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // 任意线程调用。priority 超出范围时取最近的一档；preferredThread 按线程数取模，小于 0 表示不指定
+    void submit(Task task, int priority = 0, int preferredThread = -1);
+
+    int threadCount() const { return static_cast<int>(m_workers.size()); }
+    int pendingCount() const { return m_pending.load(std::memory_order_acquire); }
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Job {
+        Task task;
+        int priority;
+    };
+
+    struct Worker {
+        Worker();
+
+        std::array<ChaseLevDeque<Job*>, PRIORITY_BANDS> deques;
+        BoundedMpscQueue<Job*> inbox;
+        std::atomic<bool> inboxClaimed{false};  // 收件箱同一时刻只有一个消费者（所有者或窃取者）
+        QThread* thread = nullptr;
+        quint32 randomState = 0;                // 只由所属线程使用，选择窃取起点
+        QAtomicInteger<qint64> executed{0};
+        QAtomicInteger<qint64> stolen{0};
+        QAtomicInteger<qint64> busyNs{0};
+    };
+
+    void run(int index);
+    bool takeLocal(int index, Job*& job);
+    bool steal(int thief, Job*& job);
+    bool takeOverflow(Job*& job);
+    void drainInbox(Worker& worker);
+    bool popInbox(Worker& worker, Job*& job);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<int> m_pending;             // 已提交、尚未被取走的任务数
+    std::atomic<int> m_sleepers;            // 正在（或即将）睡眠的线程数
+    QAtomicInt m_nextWorker;                // 外部提交的轮转位置
+    QAtomicInt m_stopping;
+    QAtomicInteger<qint64> m_submitted;
+
+    QMutex m_overflowMutex;
+    std::deque<Job*> m_overflow;
+    std::atomic<int> m_overflowCount;
+
+    QMutex m_sleepMutex;
+    QWaitCondition m_sleepCondition;
+
+    mutable QMutex m_windowMutex;
+    QElapsedTimer m_window;
+};
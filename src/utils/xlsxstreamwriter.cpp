@@ -0,0 +1,248 @@
+#include "xlsxstreamwriter.h"
+
+namespace {
+const char* const SHEET_HEADER =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+    "<sheetViews><sheetView workbookViewId=\"0\">"
+    "<pane ySplit=\"1\" topLeftCell=\"A2\" activePane=\"bottomLeft\" state=\"frozen\"/>"
+    "</sheetView></sheetViews><sheetData>";
+const char* const SHEET_FOOTER = "</sheetData></worksheet>";
+
+// 样式 0 为默认，样式 1 为表头粗体
+const char* const STYLES_XML =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+    "<fonts count=\"2\"><font><sz val=\"11\"/><name val=\"Calibri\"/></font>"
+    "<font><b/><sz val=\"11\"/><name val=\"Calibri\"/></font></fonts>"
+    "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill>"
+    "<fill><patternFill patternType=\"gray125\"/></fill></fills>"
+    "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+    "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+    "<cellXfs count=\"2\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+    "<xf numFmtId=\"0\" fontId=\"1\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyFont=\"1\"/></cellXfs>"
+    "</styleSheet>";
+
+const char* const ROOT_RELS_XML =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\""
+    " Target=\"xl/workbook.xml\"/></Relationships>";
+
+// 转义 XML 特殊字符，并去掉 XML 1.0 不允许的控制字符
+void appendEscaped(QByteArray& out, const QString& text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+        case '&': out.append("&amp;"); break;
+        case '<': out.append("&lt;"); break;
+        case '>': out.append("&gt;"); break;
+        case '"': out.append("&quot;"); break;
+        default:
+            if (static_cast<uchar>(c) >= 0x20 || c == '\t' || c == '\n' || c == '\r') {
+                out.append(c);
+            }
+            break;
+        }
+    }
+}
+
+bool isNumber(const QVariant& value)
+{
+    switch (value.typeId()) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 工作表名称最长 31 个字符，不能包含方括号、冒号、星号、问号和斜杠
+QString sheetName(const QString& name)
+{
+    QString result = name;
+    for (QChar& c : result) {
+        if (QStringLiteral("[]:*?/\\").contains(c)) {
+            c = QLatin1Char('_');
+        }
+    }
+    result = result.left(31);
+    return result.isEmpty() ? QStringLiteral("Sheet") : result;
+}
+}
+
+XlsxStreamWriter::XlsxStreamWriter(QIODevice* device)
+    : m_zip(device)
+    , m_sheetRows(0)
+    , m_continuation(0)
+    , m_inSheet(false)
+{
+}
+
+bool XlsxStreamWriter::beginSheet(const QString& name, const QStringList& headers)
+{
+    m_baseName = sheetName(name);
+    m_headers = headers;
+    m_continuation = 1;
+    return openSheet(m_baseName);
+}
+
+bool XlsxStreamWriter::writeRow(const QVariantList& values)
+{
+    if (!m_inSheet) {
+        m_error = "没有打开的工作表";
+        return false;
+    }
+    if (m_sheetRows >= MAX_SHEET_ROWS) {
+        const QString suffix = QString(" (%1)").arg(++m_continuation);
+        if (!endSheet() || !openSheet(m_baseName.left(31 - suffix.size()) + suffix)) {
+            return false;
+        }
+    }
+
+    m_buffer.append("<row>");
+    for (const QVariant& value : values) {
+        appendCell(value);
+    }
+    m_buffer.append("</row>");
+    ++m_sheetRows;
+    return flushBuffer(false);
+}
+
+bool XlsxStreamWriter::endSheet()
+{
+    if (!m_inSheet) {
+        return true;
+    }
+    m_inSheet = false;
+    m_buffer.append(SHEET_FOOTER);
+    return flushBuffer(true) && m_zip.endEntry();
+}
+
+bool XlsxStreamWriter::finish()
+{
+    if (!endSheet()) {
+        return false;
+    }
+    if (m_sheetNames.isEmpty() && (!openSheet("Sheet1") || !endSheet())) {
+        return false;
+    }
+
+    QByteArray contentTypes =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\""
+        " ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/styles.xml\""
+        " ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>";
+    QByteArray workbook =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+        " xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\"><sheets>";
+    QByteArray workbookRels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+
+    for (int i = 0; i < m_sheetNames.size(); ++i) {
+        const QByteArray index = QByteArray::number(i + 1);
+        contentTypes += "<Override PartName=\"/xl/worksheets/sheet" + index + ".xml\""
+            " ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+        workbook += "<sheet name=\"";
+        appendEscaped(workbook, m_sheetNames[i]);
+        workbook += "\" sheetId=\"" + index + "\" r:id=\"rId" + index + "\"/>";
+        workbookRels += "<Relationship Id=\"rId" + index + "\""
+            " Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\""
+            " Target=\"worksheets/sheet" + index + ".xml\"/>";
+    }
+    const QByteArray stylesId = QByteArray::number(m_sheetNames.size() + 1);
+    workbookRels += "<Relationship Id=\"rId" + stylesId + "\""
+        " Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>";
+    contentTypes += "</Types>";
+    workbook += "</sheets></workbook>";
+    workbookRels += "</Relationships>";
+
+    const auto writePart = [this](const QString& name, const QByteArray& data) {
+        return m_zip.beginEntry(name) && m_zip.write(data) && m_zip.endEntry();
+    };
+    return writePart("[Content_Types].xml", contentTypes)
+        && writePart("_rels/.rels", ROOT_RELS_XML)
+        && writePart("xl/workbook.xml", workbook)
+        && writePart("xl/_rels/workbook.xml.rels", workbookRels)
+        && writePart("xl/styles.xml", STYLES_XML)
+        && m_zip.finish();
+}
+
+QString XlsxStreamWriter::errorString() const
+{
+    return m_error.isEmpty() ? m_zip.errorString() : m_error;
+}
+
+bool XlsxStreamWriter::openSheet(const QString& name)
+{
+    if (m_inSheet && !endSheet()) {
+        return false;
+    }
+
+    m_sheetNames.append(name);
+    if (!m_zip.beginEntry(QString("xl/worksheets/sheet%1.xml").arg(m_sheetNames.size()))) {
+        return false;
+    }
+    m_inSheet = true;
+    m_sheetRows = 0;
+    m_buffer.append(SHEET_HEADER);
+    return appendHeader();
+}
+
+bool XlsxStreamWriter::appendHeader()
+{
+    if (m_headers.isEmpty()) {
+        return true;
+    }
+    m_buffer.append("<row>");
+    for (const QString& header : m_headers) {
+        m_buffer.append("<c t=\"inlineStr\" s=\"1\"><is><t>");
+        appendEscaped(m_buffer, header);
+        m_buffer.append("</t></is></c>");
+    }
+    m_buffer.append("</row>");
+    ++m_sheetRows;
+    return flushBuffer(false);
+}
+
+void XlsxStreamWriter::appendCell(const QVariant& value)
+{
+    // 空值写空单元格以保持列对齐
+    if (value.isNull()) {
+        m_buffer.append("<c/>");
+    } else if (isNumber(value)) {
+        if (!qIsFinite(value.toDouble())) {
+            m_buffer.append("<c/>");
+            return;
+        }
+        m_buffer.append("<c><v>");
+        m_buffer.append(value.toString().toLatin1());
+        m_buffer.append("</v></c>");
+    } else {
+        m_buffer.append("<c t=\"inlineStr\"><is><t xml:space=\"preserve\">");
+        appendEscaped(m_buffer, value.toString());
+        m_buffer.append("</t></is></c>");
+    }
+}
+
+bool XlsxStreamWriter::flushBuffer(bool force)
+{
+    if (!force && m_buffer.size() < BUFFER_BYTES) {
+        return true;
+    }
+    const bool written = m_zip.write(m_buffer);
+    m_buffer.clear();
+    return written;
+}
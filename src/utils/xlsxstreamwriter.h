@@ -0,0 +1,46 @@
+#pragma once
+
+#include "zipstreamwriter.h"
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+
+// 流式 XLSX 写入器
+//
+// 工作表 XML 按行追加到缓冲区，满 256KB 写入 ZIP 条目，内存占用与行数无关。
+// 文本使用内联字符串（不生成共享字符串表），数值类型的 QVariant 写为数字单元格。
+// 单个工作表超过 Excel 的行数上限时自动续写到 "<名称> (2)" 等新工作表并重复表头。
+// 工作簿、样式等其他部件在 finish() 时写出。
+class XlsxStreamWriter
+{
+public:
+    explicit XlsxStreamWriter(QIODevice* device);
+
+    bool beginSheet(const QString& name, const QStringList& headers);
+    bool writeRow(const QVariantList& values);
+    bool endSheet();
+    bool finish();
+
+    QString errorString() const;
+
+private:
+    static constexpr int MAX_SHEET_ROWS = 1048576;      // Excel 单表行数上限（含表头）
+    static constexpr int BUFFER_BYTES = 256 * 1024;
+
+    bool openSheet(const QString& name);
+    bool appendHeader();
+    void appendCell(const QVariant& value);
+    bool flushBuffer(bool force);
+
+    ZipStreamWriter m_zip;
+    QStringList m_sheetNames;
+    QString m_baseName;
+    QStringList m_headers;
+    QByteArray m_buffer;
+    int m_sheetRows;
+    int m_continuation;
+    bool m_inSheet;
+    QString m_error;
+};
@@ -0,0 +1,188 @@
+#include "zipstreamwriter.h"
+#include "crcengine.h"
+#include <QIODevice>
+#include <QtEndian>
+#include <limits>
+
+namespace {
+constexpr quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr quint32 END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr quint16 VERSION_NEEDED = 20;
+constexpr quint16 FLAG_UTF8_NAME = 0x0800;
+constexpr quint16 METHOD_STORED = 0;
+constexpr int LOCAL_HEADER_CRC_OFFSET = 14;     // 本地文件头中 CRC、压缩长度、原始长度的位置
+constexpr quint64 ZIP32_LIMIT = std::numeric_limits<quint32>::max();
+
+void append16(QByteArray& out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 2);
+}
+
+void append32(QByteArray& out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+}
+
+ZipStreamWriter::ZipStreamWriter(QIODevice* device)
+    : m_device(device)
+    , m_inEntry(false)
+    , m_finished(false)
+    , m_crcState(0)
+    , m_offset(0)
+{
+}
+
+bool ZipStreamWriter::beginEntry(const QString& name, const QDateTime& modified)
+{
+    if (m_finished || m_inEntry) {
+        return fail("ZIP 条目顺序错误");
+    }
+    if (m_device->isSequential()) {
+        return fail("ZIP 输出设备必须可定位");
+    }
+
+    // DOS 时间精度为 2 秒，年份从 1980 起
+    const QDate date = modified.date();
+    const QTime time = modified.time();
+    Entry entry;
+    entry.name = name.toUtf8();
+    entry.headerOffset = m_offset;
+    entry.dosTime = static_cast<quint16>((time.hour() << 11) | (time.minute() << 5) | (time.second() / 2));
+    entry.dosDate = static_cast<quint16>((qMax(date.year() - 1980, 0) << 9) | (date.month() << 5) | date.day());
+
+    // CRC 和长度先写 0，endEntry() 回写
+    QByteArray header;
+    append32(header, LOCAL_HEADER_SIGNATURE);
+    append16(header, VERSION_NEEDED);
+    append16(header, FLAG_UTF8_NAME);
+    append16(header, METHOD_STORED);
+    append16(header, entry.dosTime);
+    append16(header, entry.dosDate);
+    append32(header, 0);
+    append32(header, 0);
+    append32(header, 0);
+    append16(header, static_cast<quint16>(entry.name.size()));
+    append16(header, 0);
+    header.append(entry.name);
+    if (!writeRaw(header)) {
+        return false;
+    }
+
+    m_entries.append(entry);
+    m_crcState = 0xFFFFFFFF;
+    m_inEntry = true;
+    return true;
+}
+
+bool ZipStreamWriter::write(const char* data, qint64 length)
+{
+    if (!m_inEntry) {
+        return fail("没有打开的 ZIP 条目");
+    }
+    m_crcState = CRCEngine::updateCRC32(m_crcState, reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(length));
+    m_entries.last().size += static_cast<quint64>(length);
+    return writeRaw(QByteArray::fromRawData(data, static_cast<qsizetype>(length)));
+}
+
+bool ZipStreamWriter::endEntry()
+{
+    if (!m_inEntry) {
+        return fail("没有打开的 ZIP 条目");
+    }
+    m_inEntry = false;
+
+    Entry& entry = m_entries.last();
+    entry.crc = m_crcState ^ 0xFFFFFFFF;
+    if (entry.size > ZIP32_LIMIT) {
+        return fail("ZIP 条目超过 4GB");
+    }
+
+    QByteArray fields;
+    append32(fields, entry.crc);
+    append32(fields, static_cast<quint32>(entry.size));
+    append32(fields, static_cast<quint32>(entry.size));
+
+    const qint64 end = m_device->pos();
+    if (!m_device->seek(static_cast<qint64>(entry.headerOffset) + LOCAL_HEADER_CRC_OFFSET)
+        || m_device->write(fields) != fields.size()
+        || !m_device->seek(end)) {
+        return fail("回写 ZIP 文件头失败: " + m_device->errorString());
+    }
+    return true;
+}
+
+bool ZipStreamWriter::finish()
+{
+    if (m_inEntry && !endEntry()) {
+        return false;
+    }
+    if (m_finished) {
+        return true;
+    }
+    if (m_entries.size() > 0xFFFF) {
+        return fail("ZIP 条目过多");
+    }
+
+    const quint64 directoryOffset = m_offset;
+    QByteArray directory;
+    for (const Entry& entry : m_entries) {
+        append32(directory, CENTRAL_HEADER_SIGNATURE);
+        append16(directory, VERSION_NEEDED);
+        append16(directory, VERSION_NEEDED);
+        append16(directory, FLAG_UTF8_NAME);
+        append16(directory, METHOD_STORED);
+        append16(directory, entry.dosTime);
+        append16(directory, entry.dosDate);
+        append32(directory, entry.crc);
+        append32(directory, static_cast<quint32>(entry.size));
+        append32(directory, static_cast<quint32>(entry.size));
+        append16(directory, static_cast<quint16>(entry.name.size()));
+        append16(directory, 0);     // 扩展字段
+        append16(directory, 0);     // 注释
+        append16(directory, 0);     // 起始磁盘
+        append16(directory, 0);     // 内部属性
+        append32(directory, 0);     // 外部属性
+        append32(directory, static_cast<quint32>(entry.headerOffset));
+        directory.append(entry.name);
+    }
+
+    QByteArray end;
+    append32(end, END_OF_DIRECTORY_SIGNATURE);
+    append16(end, 0);
+    append16(end, 0);
+    append16(end, static_cast<quint16>(m_entries.size()));
+    append16(end, static_cast<quint16>(m_entries.size()));
+    append32(end, static_cast<quint32>(directory.size()));
+    append32(end, static_cast<quint32>(directoryOffset));
+    append16(end, 0);
+
+    if (!writeRaw(directory) || !writeRaw(end)) {
+        return false;
+    }
+    m_finished = true;
+    return true;
+}
+
+bool ZipStreamWriter::writeRaw(const QByteArray& data)
+{
+    if (m_device->write(data) != data.size()) {
+        return fail("写入 ZIP 失败: " + m_device->errorString());
+    }
+    m_offset += static_cast<quint64>(data.size());
+    if (m_offset > ZIP32_LIMIT) {
+        return fail("ZIP 归档超过 4GB");
+    }
+    return true;
+}
+
+bool ZipStreamWriter::fail(const QString& error)
+{
+    m_error = error;
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+class QIODevice;
+
+// 顺序写入的 ZIP 归档（存储方式，不压缩）
+//
+// 条目数据边写边计算 CRC32，不在内存中保留；条目结束时回写本地文件头中的
+// CRC 和长度，因此设备必须可定位（QFile / QSaveFile）。目录在 finish() 时写出。
+// 不支持 ZIP64：归档或单个条目超过 4GB 时写入失败。
+class ZipStreamWriter
+{
+public:
+    explicit ZipStreamWriter(QIODevice* device);
+
+    bool beginEntry(const QString& name, const QDateTime& modified = QDateTime::currentDateTime());
+    bool write(const char* data, qint64 length);
+    bool write(const QByteArray& data) { return write(data.constData(), data.size()); }
+    bool endEntry();
+    // 写出中央目录，之后不能再添加条目；不关闭设备
+    bool finish();
+
+    QString errorString() const { return m_error; }
+
+private:
+    struct Entry {
+        QByteArray name;
+        quint32 crc = 0;
+        quint64 size = 0;
+        quint64 headerOffset = 0;
+        quint16 dosTime = 0;
+        quint16 dosDate = 0;
+    };
+
+    bool writeRaw(const QByteArray& data);
+    bool fail(const QString& error);
+
+    QIODevice* m_device;
+    QList<Entry> m_entries;
+    bool m_inEntry;
+    bool m_finished;
+    quint32 m_crcState;
+    quint64 m_offset;
+    QString m_error;
+};
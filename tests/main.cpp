@@ -1,13 +1,44 @@
-#include <QCoreApplication>
+#include <QApplication>
 #include <QDebug>
 #include <QDir>
+#include <QStringList>
 
 #include "testframework.h"
-#include "test_datamodels.h"
+#include "test_checksum.h"
+#include "test_bufferpool.h"
+#include "test_livedatafeed.h"
+#include "test_performance.h"
+
+// 命令行参数:
+//   --suite=<名称>            只运行指定测试套件
+//   --skip-performance        跳过性能测试（跑单元测试时使用）
+//   --baseline=<文件>         按性能基线判定回归，超出容差的性能测试失败
+//   --update-baseline=<文件>  运行结束后按本次结果重写性能基线
 
 int main(int argc, char *argv[])
 {
-    QCoreApplication app(argc, argv);
+    // UIUpdateOptimizer 需要 QApplication
+    QApplication app(argc, argv);
+    
+    QString suiteName;
+    QString baselinePath;
+    QString updateBaselinePath;
+    bool skipPerformance = false;
+    const QStringList arguments = app.arguments().mid(1);
+    for (const QString& argument : arguments) {
+        if (argument.startsWith("--suite=")) {
+            suiteName = argument.mid(8);
+        } else if (argument == "--skip-performance") {
+            skipPerformance = true;
+        } else if (argument.startsWith("--baseline=")) {
+            baselinePath = argument.mid(11);
+        } else if (argument.startsWith("--update-baseline=")) {
+            updateBaselinePath = argument.mid(18);
+        } else {
+            qDebug() << QString("未知参数: %1").arg(argument);
+            return 2;
+        }
+    }
     
     qDebug() << "========================================";
     qDebug() << "     ATK 工业点胶设备单元测试";
@@ -17,8 +48,22 @@ int main(int argc, char *argv[])
     TestRunner* runner = TestRunner::getInstance();
     
     // 注册测试套件
-    DataModelsTest* dataModelsTest = new DataModelsTest();
-    runner->registerTestSuite(dataModelsTest, "DataModelsTest");
+    ChecksumTest* checksumTest = new ChecksumTest();
+    runner->registerTestSuite(checksumTest, "ChecksumTest");
+    
+    BufferPoolTest* bufferPoolTest = new BufferPoolTest();
+    runner->registerTestSuite(bufferPoolTest, "BufferPoolTest");
+    
+    LiveDataFeedTest* liveDataFeedTest = new LiveDataFeedTest();
+    runner->registerTestSuite(liveDataFeedTest, "LiveDataFeedTest");
+    
+    PerformanceTest* performanceTest = new PerformanceTest();
+    runner->registerTestSuite(performanceTest, "PerformanceTest");
+    
+    runner->setPerformanceTestsEnabled(!skipPerformance);
+    if (!baselinePath.isEmpty() && !runner->loadPerformanceBaseline(baselinePath)) {
+        return 1;
+    }
     
     // 连接测试信号
     QObject::connect(runner, &TestRunner::testSuiteStarted, 
@@ -31,9 +76,14 @@ int main(int argc, char *argv[])
         qDebug() << QString("测试套件完成: %1").arg(suiteName);
     });
     
-    // 运行所有测试
-    qDebug() << "开始运行所有测试用例...";
-    bool allTestsPassed = runner->runAllTests();
+    // 运行测试
+    bool allTestsPassed = false;
+    if (suiteName.isEmpty()) {
+        qDebug() << "开始运行所有测试用例...";
+        allTestsPassed = runner->runAllTests();
+    } else {
+        allTestsPassed = runner->runTestSuite(suiteName);
+    }
     
     // 生成测试报告
     QString reportPath = "test_report.txt";
@@ -51,8 +101,15 @@ int main(int argc, char *argv[])
     qDebug() << "测试详细报告:";
     qDebug() << runner->generateTextReport();
     
+    if (!updateBaselinePath.isEmpty() && !runner->updatePerformanceBaseline(updateBaselinePath)) {
+        allTestsPassed = false;
+    }
+    
     // 清理资源
-    delete dataModelsTest;
+    delete checksumTest;
+    delete bufferPoolTest;
+    delete liveDataFeedTest;
+    delete performanceTest;
     
     return allTestsPassed ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "performancebaseline.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QStringList>
+#include <QSysInfo>
+#include <algorithm>
+#include <vector>
+
+namespace {
+constexpr double DEFAULT_TOLERANCE = 0.5;
+constexpr double DEFAULT_P95_TOLERANCE_FACTOR = 2.0;
+constexpr double ALLOCATION_REGRESSION_MARGIN = 0.01;
+constexpr double MIN_SPEED_FACTOR = 0.25;     // 速度系数的范围，超出时按边界计算，避免参考负载异常时放过回归
+constexpr double MAX_SPEED_FACTOR = 4.0;
+constexpr int REFERENCE_STEPS = 1 << 16;
+constexpr int REFERENCE_RUNS = 15;
+
+QString formatNs(double ns)
+{
+    if (ns >= 1e6) {
+        return QString("%1ms").arg(ns / 1e6, 0, 'f', 2);
+    }
+    if (ns >= 1e3) {
+        return QString("%1us").arg(ns / 1e3, 0, 'f', 2);
+    }
+    return QString("%1ns").arg(ns, 0, 'f', 1);
+}
+}
+
+PerformanceBaseline::PerformanceBaseline()
+    : m_loaded(false)
+    , m_defaultTolerance(DEFAULT_TOLERANCE)
+    , m_p95ToleranceFactor(DEFAULT_P95_TOLERANCE_FACTOR)
+    , m_baselineCalibrationNs(0.0)
+    , m_measuredCalibrationNs(0.0)
+    , m_speedFactor(1.0)
+{
+}
+
+bool PerformanceBaseline::load(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QString("无法读取性能基线: %1").arg(path);
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        *error = QString("性能基线格式错误: %1 (%2)").arg(path, parseError.errorString());
+        return false;
+    }
+
+    m_path = path;
+    m_root = document.object();
+    m_defaultTolerance = m_root.value("default_tolerance").toDouble(DEFAULT_TOLERANCE);
+    m_p95ToleranceFactor = m_root.value("p95_tolerance_factor").toDouble(DEFAULT_P95_TOLERANCE_FACTOR);
+    m_baselineCalibrationNs = m_root.value("calibration_ns").toDouble(0.0);
+
+    m_metrics.clear();
+    const QJsonObject metrics = m_root.value("metrics").toObject();
+    for (auto it = metrics.constBegin(); it != metrics.constEnd(); ++it) {
+        m_metrics.insert(it.key(), it.value().toObject());
+    }
+    m_loaded = true;
+    return true;
+}
+
+void PerformanceBaseline::calibrate()
+{
+    m_measuredCalibrationNs = measureReferenceNs();
+    if (!m_loaded || m_baselineCalibrationNs <= 0.0) {
+        m_speedFactor = 1.0;
+        return;
+    }
+    m_speedFactor = qBound(MIN_SPEED_FACTOR, m_measuredCalibrationNs / m_baselineCalibrationNs, MAX_SPEED_FACTOR);
+}
+
+PerformanceBaseline::Verdict PerformanceBaseline::compare(const PerformanceResult& result) const
+{
+    Verdict verdict;
+    const auto it = m_metrics.constFind(result.name);
+    if (it == m_metrics.constEnd()) {
+        verdict.message = QString("%1: 中位数 %2，P95 %3（基线中不存在，不判定）")
+                              .arg(result.name, formatNs(result.medianNs), formatNs(result.p95Ns));
+        return verdict;
+    }
+    verdict.hasBaseline = true;
+
+    const QJsonObject& metric = it.value();
+    const double tolerance = toleranceFor(metric);
+    const double medianLimit = metric.value("median_ns").toDouble() * m_speedFactor * (1.0 + tolerance);
+    const double p95Limit = metric.value("p95_ns").toDouble() * m_speedFactor * (1.0 + tolerance * m_p95ToleranceFactor);
+
+    QStringList failures;
+    if (medianLimit > 0.0 && result.medianNs > medianLimit) {
+        failures << QString("中位数 %1 超过上限 %2").arg(formatNs(result.medianNs), formatNs(medianLimit));
+    }
+    if (p95Limit > 0.0 && result.p95Ns > p95Limit) {
+        failures << QString("P95 %1 超过上限 %2").arg(formatNs(result.p95Ns), formatNs(p95Limit));
+    }
+    if (metric.contains("allocs_per_op") && result.allocsPerOp >= 0.0) {
+        const double allocationLimit = metric.value("allocs_per_op").toDouble() + ALLOCATION_REGRESSION_MARGIN;
+        if (result.allocsPerOp > allocationLimit) {
+            failures << QString("每次操作分配 %1 次，基线 %2 次")
+                            .arg(result.allocsPerOp, 0, 'f', 2)
+                            .arg(metric.value("allocs_per_op").toDouble(), 0, 'f', 2);
+        }
+    }
+
+    verdict.regressed = !failures.isEmpty();
+    if (verdict.regressed) {
+        verdict.message = QString("%1 性能回归: %2").arg(result.name, failures.join("，"));
+    } else {
+        verdict.message = QString("%1: 中位数 %2（上限 %3），P95 %4（上限 %5）")
+                              .arg(result.name, formatNs(result.medianNs), formatNs(medianLimit),
+                                   formatNs(result.p95Ns), formatNs(p95Limit));
+    }
+    return verdict;
+}
+
+bool PerformanceBaseline::save(const QString& path, const QList<PerformanceResult>& results, QString* error) const
+{
+    QJsonObject root = m_root;
+    root["calibration_ns"] = qRound64(m_measuredCalibrationNs > 0.0 ? m_measuredCalibrationNs : measureReferenceNs());
+    if (!root.contains("default_tolerance")) {
+        root["default_tolerance"] = m_defaultTolerance;
+    }
+    if (!root.contains("p95_tolerance_factor")) {
+        root["p95_tolerance_factor"] = m_p95ToleranceFactor;
+    }
+    root["generated"] = QString("%1 %2 (%3)")
+                            .arg(QDateTime::currentDateTime().toString(Qt::ISODate),
+                                 QSysInfo::currentCpuArchitecture(), QSysInfo::prettyProductName());
+
+    QJsonObject metrics = root.value("metrics").toObject();
+    for (const PerformanceResult& result : results) {
+        QJsonObject metric = metrics.value(result.name).toObject();
+        metric["median_ns"] = qRound64(result.medianNs);
+        metric["p95_ns"] = qRound64(result.p95Ns);
+        if (result.allocsPerOp >= 0.0) {
+            metric["allocs_per_op"] = result.allocsPerOp;
+        }
+        metrics[result.name] = metric;
+    }
+    root["metrics"] = metrics;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *error = QString("无法写入性能基线: %1").arg(path);
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+double PerformanceBaseline::measureReferenceNs()
+{
+    // 依赖链上的移位和异或，只与 CPU 主频和流水线有关，不受缓存和内存带宽影响
+    std::vector<qint64> samples;
+    samples.reserve(REFERENCE_RUNS);
+    volatile quint64 sink = 0;
+    for (int run = 0; run < REFERENCE_RUNS; ++run) {
+        quint64 state = 0x9E3779B97F4A7C15ull + static_cast<quint64>(run);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < REFERENCE_STEPS; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+        }
+        samples.push_back(timer.nsecsElapsed());
+        sink = sink + state;
+    }
+    std::sort(samples.begin(), samples.end());
+    return static_cast<double>(samples[samples.size() / 2]);
+}
+
+double PerformanceBaseline::toleranceFor(const QJsonObject& metric) const
+{
+    return metric.value("tolerance").toDouble(m_defaultTolerance);
+}
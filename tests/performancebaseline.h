@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+// 性能测试结果（时间均为每次操作的纳秒数）
+struct PerformanceResult {
+    QString name;
+    qint64 opsPerRun = 0;           // 每轮计时执行的操作次数
+    int runs = 0;                   // 计时轮数（不含预热）
+    double medianNs = 0.0;
+    double p95Ns = 0.0;
+    double minNs = 0.0;
+    double allocsPerOp = -1.0;      // 未以 ALLOCATION_TRACKING 编译时为 -1
+    double bytesPerSecond = 0.0;    // 未指定每次操作字节数时为 0
+};
+
+// 性能基线 - 在参考机上用 --update-baseline 实测后检入的 tests/performance_baseline.json
+//
+// {"calibration_ns": ..., "default_tolerance": 0.5, "p95_tolerance_factor": 2.0,
+//  "metrics": {"checksum.crc16_modbus/4096": {"median_ns": ..., "p95_ns": ..., "allocs_per_op": 0}}}
+//
+// 各机器速度不同：加载后先测一段固定的整数运算参考负载，与 calibration_ns 之比作为速度系数，
+// 基线时间乘以速度系数后再放宽容差比较。中位数容差取该项的 tolerance（缺省为 default_tolerance），
+// P95 的容差再乘以 p95_tolerance_factor。每次操作分配次数与机器无关，超过基线 0.01 即为回归。
+// 基线中没有的项只报告不判定，没有 allocs_per_op 的项不判定分配；
+// save() 按本次结果重写各项数值，保留已有的容差设置。
+class PerformanceBaseline
+{
+public:
+    struct Verdict {
+        bool hasBaseline = false;
+        bool regressed = false;
+        QString message;
+    };
+
+    PerformanceBaseline();
+
+    bool load(const QString& path, QString* error);
+    bool isLoaded() const { return m_loaded; }
+    QString path() const { return m_path; }
+
+    // 测量参考负载并计算速度系数；未加载基线时系数为 1
+    void calibrate();
+    double speedFactor() const { return m_speedFactor; }
+    double measuredCalibrationNs() const { return m_measuredCalibrationNs; }
+
+    Verdict compare(const PerformanceResult& result) const;
+
+    bool save(const QString& path, const QList<PerformanceResult>& results, QString* error) const;
+
+    // 参考负载单次耗时的中位数
+    static double measureReferenceNs();
+
+private:
+    double toleranceFor(const QJsonObject& metric) const;
+
+    bool m_loaded;
+    QString m_path;
+    QJsonObject m_root;
+    QHash<QString, QJsonObject> m_metrics;
+    double m_defaultTolerance;
+    double m_p95ToleranceFactor;
+    double m_baselineCalibrationNs;
+    double m_measuredCalibrationNs;
+    double m_speedFactor;
+};
@@ -0,0 +1,105 @@
+#include "test_bufferpool.h"
+#include "../src/logger/logmanager.h"
+
+BufferPoolTest::BufferPoolTest(QObject* parent)
+    : TestBase(parent)
+{
+    // 注册测试用例
+    registerTest("testAcquireRelease", [this]() { testAcquireRelease(); });
+    
+    registerTest("testReleaseForeignBuffer", [this]() { testReleaseForeignBuffer(); });
+    registerTest("testDoubleRelease", [this]() { testDoubleRelease(); });
+    registerTest("testReleaseForeignBlock", [this]() { testReleaseForeignBlock(); });
+}
+
+void BufferPoolTest::setupTestCase()
+{
+    qDebug() << "Setting up BufferPool test suite";
+    
+    ASSERT_TRUE(CommunicationBufferPool::getInstance()->initialize());
+}
+
+void BufferPoolTest::cleanupTestCase()
+{
+    qDebug() << "Cleaning up BufferPool test suite";
+}
+
+void BufferPoolTest::testAcquireRelease()
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    const int warningsBefore = poolWarningCount();
+    
+    QByteArray* buffer = pool->acquireBuffer(1000);
+    ASSERT_TRUE(buffer != nullptr);
+    ASSERT_TRUE(buffer->size() >= 1000);
+    pool->releaseBuffer(buffer);
+    
+    ASSERT_EQ(warningsBefore, poolWarningCount());
+}
+
+void BufferPoolTest::testReleaseForeignBuffer()
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    const int releasedBefore = pool->getStatistics().totalReleased.loadRelaxed();
+    const int warningsBefore = poolWarningCount();
+    
+    QByteArray* foreign = new QByteArray(256, 'x');
+    pool->releaseBuffer(foreign);
+    
+    // 外来缓冲区保持原样，仍由调用方负责释放
+    ASSERT_EQ(256, static_cast<int>(foreign->size()));
+    delete foreign;
+    
+    ASSERT_EQ(warningsBefore + 1, poolWarningCount());
+    ASSERT_EQ(releasedBefore, pool->getStatistics().totalReleased.loadRelaxed());
+}
+
+void BufferPoolTest::testDoubleRelease()
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    
+    QByteArray* buffer = pool->acquireBuffer(512);
+    ASSERT_TRUE(buffer != nullptr);
+    pool->releaseBuffer(buffer);
+    
+    const int releasedBefore = pool->getStatistics().totalReleased.loadRelaxed();
+    const int warningsBefore = poolWarningCount();
+    pool->releaseBuffer(buffer);
+    
+    ASSERT_EQ(warningsBefore + 1, poolWarningCount());
+    ASSERT_EQ(releasedBefore, pool->getStatistics().totalReleased.loadRelaxed());
+    
+    // 重复释放没有让同一缓冲区进入空闲列表两次
+    QByteArray* first = pool->acquireBuffer(512);
+    QByteArray* second = pool->acquireBuffer(512);
+    ASSERT_TRUE(first != second);
+    pool->releaseBuffer(first);
+    pool->releaseBuffer(second);
+}
+
+void BufferPoolTest::testReleaseForeignBlock()
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+    const int warningsBefore = poolWarningCount();
+    
+    char* foreign = new char[128];
+    pool->releaseBlock(foreign);
+    delete[] foreign;
+    
+    ASSERT_EQ(warningsBefore + 1, poolWarningCount());
+}
+
+int BufferPoolTest::poolWarningCount() const
+{
+    LogManager* logManager = LogManager::getInstance();
+    logManager->flush();
+    
+    int count = 0;
+    const QList<LogEntry> entries = logManager->getLogEntries(100000);
+    for (const LogEntry& entry : entries) {
+        if (entry.level == LogLevel::Warning && entry.category == QLatin1String("CommunicationBufferPool")) {
+            ++count;
+        }
+    }
+    return count;
+}
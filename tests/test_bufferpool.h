@@ -0,0 +1,28 @@
+#pragma once
+
+#include "testframework.h"
+#include "../src/communication/communicationbufferpool.h"
+
+class BufferPoolTest : public TestBase
+{
+    Q_OBJECT
+
+public:
+    explicit BufferPoolTest(QObject* parent = nullptr);
+
+protected:
+    void setupTestCase() override;
+    void cleanupTestCase() override;
+
+private:
+    // 取用与归还
+    void testAcquireRelease();
+
+    // 非法归还只记录警告，不访问无效内存
+    void testReleaseForeignBuffer();
+    void testDoubleRelease();
+    void testReleaseForeignBlock();
+
+    // 本池记录的警告条数（等待日志写出后统计）
+    int poolWarningCount() const;
+};
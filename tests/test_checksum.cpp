@@ -0,0 +1,144 @@
+#include "test_checksum.h"
+
+ChecksumTest::ChecksumTest(QObject* parent)
+    : TestBase(parent)
+    , m_checkInput("123456789")
+    , m_originalAcceleration(CRCAcceleration::SlicingBy8)
+{
+    // 注册测试用例
+    registerTest("testCRC16CheckValues", [this]() { testCRC16CheckValues(); });
+    registerTest("testCRC32CheckValues", [this]() { testCRC32CheckValues(); });
+    registerTest("testCRC8CheckValues", [this]() { testCRC8CheckValues(); });
+    
+    registerTest("testAccelerationConsistency", [this]() { testAccelerationConsistency(); });
+    registerTest("testIncrementalUpdate", [this]() { testIncrementalUpdate(); });
+    
+    registerTest("testCalculateMultiple", [this]() { testCalculateMultiple(); });
+}
+
+void ChecksumTest::setupTestCase()
+{
+    qDebug() << "Setting up Checksum test suite";
+    
+    m_originalAcceleration = CRCEngine::acceleration();
+    
+    // 覆盖8字节主循环、16字节折叠和尾部处理的各种长度
+    m_randomData.resize(4099);
+    for (int i = 0; i < m_randomData.size(); ++i) {
+        m_randomData[i] = static_cast<char>(generateRandomInt(0, 255));
+    }
+}
+
+void ChecksumTest::cleanupTestCase()
+{
+    CRCEngine::setAcceleration(m_originalAcceleration);
+    qDebug() << "Cleaning up Checksum test suite";
+}
+
+void ChecksumTest::testCRC16CheckValues()
+{
+    ASSERT_EQ(0x4B37, static_cast<int>(EnhancedChecksum::calculateCRC16_Modbus(m_checkInput)));
+    ASSERT_EQ(0x29B1, static_cast<int>(EnhancedChecksum::calculateCRC16_CCITT(m_checkInput)));
+}
+
+void ChecksumTest::testCRC32CheckValues()
+{
+    ASSERT_EQ(0xCBF43926u, EnhancedChecksum::calculateCRC32(m_checkInput));
+    ASSERT_EQ(0xE3069283u, EnhancedChecksum::calculateCRC32C(m_checkInput));
+}
+
+void ChecksumTest::testCRC8CheckValues()
+{
+    // CRC-8/SMBUS（多项式0x07）标准校验值
+    ASSERT_EQ(0xF4, static_cast<int>(EnhancedChecksum::calculateCRC8(m_checkInput)));
+    ASSERT_EQ(0xF4, static_cast<int>(EnhancedChecksum::calculateCRC8<0x07>(m_checkInput)));
+    
+    // 编译期表与逐位计算结果一致
+    ASSERT_EQ(static_cast<int>(EnhancedChecksum::calculateCRC8(m_checkInput, 0x31, 0xFF)),
+              static_cast<int>(EnhancedChecksum::calculateCRC8<0x31>(m_checkInput, 0xFF)));
+    ASSERT_EQ(static_cast<int>(EnhancedChecksum::calculateCRC8(m_randomData, 0x4D)),
+              static_cast<int>(EnhancedChecksum::calculateCRC8<0x4D>(m_randomData)));
+}
+
+void ChecksumTest::testAccelerationConsistency()
+{
+    ASSERT_TRUE(CRCEngine::setAcceleration(CRCAcceleration::Bytewise));
+    const uint32_t crc32 = EnhancedChecksum::calculateCRC32(m_randomData);
+    const uint32_t crc32c = EnhancedChecksum::calculateCRC32C(m_randomData);
+    const uint16_t modbus = EnhancedChecksum::calculateCRC16_Modbus(m_randomData);
+    const uint16_t ccitt = EnhancedChecksum::calculateCRC16_CCITT(m_randomData);
+    const uint16_t ibm = EnhancedChecksum::calculateCRC16_IBM(m_randomData);
+    
+    for (CRCAcceleration acceleration : {CRCAcceleration::SlicingBy8, CRCAcceleration::Hardware}) {
+        if (!CRCEngine::setAcceleration(acceleration)) {
+            continue; // 当前CPU不支持
+        }
+        
+        for (int length : {0, 1, 7, 8, 63, 64, 65, 1000, m_randomData.size()}) {
+            const QByteArray slice = m_randomData.left(length);
+            CRCEngine::setAcceleration(CRCAcceleration::Bytewise);
+            const uint32_t expectedCRC32 = EnhancedChecksum::calculateCRC32(slice);
+            const uint32_t expectedCRC32C = EnhancedChecksum::calculateCRC32C(slice);
+            CRCEngine::setAcceleration(acceleration);
+            ASSERT_EQ(expectedCRC32, EnhancedChecksum::calculateCRC32(slice));
+            ASSERT_EQ(expectedCRC32C, EnhancedChecksum::calculateCRC32C(slice));
+        }
+        
+        ASSERT_EQ(crc32, EnhancedChecksum::calculateCRC32(m_randomData));
+        ASSERT_EQ(crc32c, EnhancedChecksum::calculateCRC32C(m_randomData));
+        ASSERT_EQ(static_cast<int>(modbus), static_cast<int>(EnhancedChecksum::calculateCRC16_Modbus(m_randomData)));
+        ASSERT_EQ(static_cast<int>(ccitt), static_cast<int>(EnhancedChecksum::calculateCRC16_CCITT(m_randomData)));
+        ASSERT_EQ(static_cast<int>(ibm), static_cast<int>(EnhancedChecksum::calculateCRC16_IBM(m_randomData)));
+    }
+    
+    CRCEngine::setAcceleration(m_originalAcceleration);
+}
+
+void ChecksumTest::testIncrementalUpdate()
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(m_randomData.constData());
+    const size_t total = static_cast<size_t>(m_randomData.size());
+    const size_t split = total / 3;
+    
+    uint32_t state = CRCEngine::updateCRC32(0xFFFFFFFF, bytes, split);
+    state = CRCEngine::updateCRC32(state, bytes + split, total - split);
+    ASSERT_EQ(EnhancedChecksum::calculateCRC32(m_randomData), state ^ 0xFFFFFFFF);
+    
+    uint16_t modbus = CRCEngine::updateCRC16Modbus(0xFFFF, bytes, split);
+    modbus = CRCEngine::updateCRC16Modbus(modbus, bytes + split, total - split);
+    ASSERT_EQ(static_cast<int>(EnhancedChecksum::calculateCRC16_Modbus(m_randomData)), static_cast<int>(modbus));
+    
+    // 分块送入 IncrementalChecksum 的结果与一次性计算一致
+    for (ChecksumType type : {ChecksumType::Simple, ChecksumType::CRC16_CCITT, ChecksumType::CRC32C, ChecksumType::SHA1}) {
+        IncrementalChecksum checksum(type);
+        checksum.update(bytes, split);
+        checksum.update(bytes + split, total - split);
+        ASSERT_TRUE(checksum.result() == EnhancedChecksum::calculate(m_randomData, type));
+        
+        checksum.reset();
+        checksum.update(m_randomData);
+        ASSERT_TRUE(checksum.result() == EnhancedChecksum::calculate(m_randomData, type));
+    }
+}
+
+void ChecksumTest::testCalculateMultiple()
+{
+    const QList<ChecksumType> types = {
+        ChecksumType::Simple, ChecksumType::XOR, ChecksumType::CRC8,
+        ChecksumType::CRC16_IBM, ChecksumType::CRC16_CCITT, ChecksumType::CRC16_MODBUS,
+        ChecksumType::CRC32, ChecksumType::CRC32C,
+        ChecksumType::MD5, ChecksumType::SHA1, ChecksumType::SHA256
+    };
+    
+    const QList<ChecksumResult> results = EnhancedChecksum::calculateMultiple(m_randomData, types);
+    ASSERT_EQ(types.size(), results.size());
+    
+    for (int i = 0; i < types.size(); ++i) {
+        ASSERT_TRUE(results[i] == EnhancedChecksum::calculate(m_randomData, types[i]));
+    }
+    
+    // 多级校验结果与逐个计算一致
+    EnhancedChecksum::MultiLevelChecksum multiLevel = EnhancedChecksum::generateMultiLevel(m_randomData);
+    ASSERT_TRUE(multiLevel.isValid);
+    ASSERT_TRUE(EnhancedChecksum::verifyMultiLevel(m_randomData, multiLevel));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "testframework.h"
+#include "../src/utils/checksum.h"
+#include "../src/utils/crcengine.h"
+
+class ChecksumTest : public TestBase
+{
+    Q_OBJECT
+
+public:
+    explicit ChecksumTest(QObject* parent = nullptr);
+
+protected:
+    void setupTestCase() override;
+    void cleanupTestCase() override;
+
+private:
+    // 标准校验值测试（输入 "123456789"）
+    void testCRC16CheckValues();
+    void testCRC32CheckValues();
+    void testCRC8CheckValues();
+    
+    // 加速实现一致性测试
+    void testAccelerationConsistency();
+    void testIncrementalUpdate();
+    
+    // 单次遍历多校验测试
+    void testCalculateMultiple();
+
+private:
+    QByteArray m_checkInput;
+    QByteArray m_randomData;
+    CRCAcceleration m_originalAcceleration;
+};
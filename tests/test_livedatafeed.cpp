@@ -0,0 +1,92 @@
+#include "test_livedatafeed.h"
+#include "../src/communication/livedatafeed.h"
+#include "../src/communication/protocolparser.h"
+#include <QCoreApplication>
+
+namespace {
+constexpr int FEED_CAPACITY = 16;
+
+// 与各通讯类相同的连接方式
+void connectFeed(ProtocolParser& parser)
+{
+    QObject::connect(&parser, &ProtocolParser::frameReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
+    QObject::connect(&parser, &ProtocolParser::framesReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrames, Qt::DirectConnection);
+    QObject::connect(&parser, &ProtocolParser::sampleFrameReceived,
+                     LiveDataFeed::getInstance(), &LiveDataFeed::publishFrame, Qt::DirectConnection);
+}
+}
+
+LiveDataFeedTest::LiveDataFeedTest(QObject* parent)
+    : TestBase(parent)
+{
+    // 注册测试用例
+    registerTest("testMotionFrameRecorded", [this]() { testMotionFrameRecorded(); });
+    registerTest("testGlueFrameRecorded", [this]() { testGlueFrameRecorded(); });
+}
+
+void LiveDataFeedTest::setupTestCase()
+{
+    qDebug() << "Setting up LiveDataFeed test suite";
+    
+    // 按进程号区分名称，避免与正在运行的上位机共用同一块共享内存
+    const QString name = QString("GlueDispenseLiveFeedTest_%1").arg(QCoreApplication::applicationPid());
+    m_feedStarted = LiveDataFeed::getInstance()->start(name, FEED_CAPACITY);
+}
+
+void LiveDataFeedTest::cleanupTestCase()
+{
+    qDebug() << "Cleaning up LiveDataFeed test suite";
+    
+    LiveDataFeed::getInstance()->stop();
+}
+
+void LiveDataFeedTest::testMotionFrameRecorded()
+{
+    if (!m_feedStarted) {
+        skipTest("当前平台无法创建共享内存");
+        return;
+    }
+    
+    LiveDataFeed* feed = LiveDataFeed::getInstance();
+    ProtocolParser parser;
+    connectFeed(parser);
+    
+    const quint64 sequence = feed->publishedCount();
+    parser.parseData(parser.buildMotionFrame(12.5, -3.25, 0.75, 100.0));
+    ASSERT_EQ(sequence + 1, feed->publishedCount());
+    
+    LiveFeed::LiveFeedRecord record;
+    ASSERT_TRUE(feed->readRecord(sequence, record));
+    ASSERT_EQ(static_cast<int>(LiveFeed::MotionSample), static_cast<int>(record.kind));
+    ASSERT_EQ(12.5f, record.values[0]);
+    ASSERT_EQ(-3.25f, record.values[1]);
+    ASSERT_EQ(0.75f, record.values[2]);
+    ASSERT_EQ(100.0f, record.values[3]);
+    ASSERT_TRUE(record.monotonicNs > 0);
+}
+
+void LiveDataFeedTest::testGlueFrameRecorded()
+{
+    if (!m_feedStarted) {
+        skipTest("当前平台无法创建共享内存");
+        return;
+    }
+    
+    LiveDataFeed* feed = LiveDataFeed::getInstance();
+    ProtocolParser parser;
+    connectFeed(parser);
+    
+    const quint64 sequence = feed->publishedCount();
+    parser.parseData(parser.buildGlueFrame(1.5, 0.25, 36.5, 1200));
+    ASSERT_EQ(sequence + 1, feed->publishedCount());
+    
+    LiveFeed::LiveFeedRecord record;
+    ASSERT_TRUE(feed->readRecord(sequence, record));
+    ASSERT_EQ(static_cast<int>(LiveFeed::GlueSample), static_cast<int>(record.kind));
+    ASSERT_EQ(1.5f, record.values[0]);
+    ASSERT_EQ(0.25f, record.values[1]);
+    ASSERT_EQ(36.5f, record.values[2]);
+    ASSERT_EQ(1200, static_cast<int>(record.aux));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "testframework.h"
+
+class LiveDataFeedTest : public TestBase
+{
+    Q_OBJECT
+
+public:
+    explicit LiveDataFeedTest(QObject* parent = nullptr);
+
+protected:
+    void setupTestCase() override;
+    void cleanupTestCase() override;
+
+private:
+    // 运动、点胶帧由解析器的专用处理器消费，仍须作为采样记录写入共享内存
+    void testMotionFrameRecorded();
+    void testGlueFrameRecorded();
+
+    bool m_feedStarted = false;
+};
@@ -0,0 +1,152 @@
+#include "test_performance.h"
+#include "../src/communication/protocolparser.h"
+#include "../src/communication/communicationbufferpool.h"
+#include "../src/ui/uiupdateoptimizer.h"
+#include "../src/utils/checksum.h"
+#include <QMetaObject>
+#include <QStringList>
+
+namespace {
+constexpr int PARSE_CHUNK_SIZE = 1024;          // 典型串口读取块
+constexpr int PARSE_CHUNK_COUNT = 256;
+constexpr int FRAME_PAYLOAD_SIZE = 24;
+constexpr int CHECKSUM_DATA_SIZE = 4096;
+constexpr int POOL_BUFFER_SIZE = 4096;
+constexpr int UI_WIDGET_COUNT = 256;            // 一帧内刷新的实时数据控件数
+constexpr double UI_FRAME_BUDGET_MS = 1000.0;   // 放宽帧预算，计时不受推迟逻辑影响
+
+// 由解析器自身构建帧，保证校验方式与解析路径一致
+QByteArray buildFrameStream(ProtocolParser& parser)
+{
+    QByteArray payload(FRAME_PAYLOAD_SIZE, Qt::Uninitialized);
+    for (int i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>(i * 7);
+    }
+    const QByteArray frame = parser.buildFrame(ProtocolCommand::ReadSensorData, payload);
+
+    QByteArray stream;
+    stream.reserve(PARSE_CHUNK_SIZE * PARSE_CHUNK_COUNT + frame.size());
+    while (stream.size() < PARSE_CHUNK_SIZE * PARSE_CHUNK_COUNT) {
+        stream.append(frame);
+    }
+    stream.truncate(PARSE_CHUNK_SIZE * PARSE_CHUNK_COUNT);
+    return stream;
+}
+}
+
+PerformanceTest::PerformanceTest(QObject* parent)
+    : TestBase(parent)
+{
+    registerPerformanceTest("testParserThroughput", [this]() { testParserThroughput(); });
+    registerPerformanceTest("testChecksumSpeed", [this]() { testChecksumSpeed(); });
+    registerPerformanceTest("testBufferPoolLatency", [this]() { testBufferPoolLatency(); });
+    registerPerformanceTest("testUIFlushTime", [this]() { testUIFlushTime(); });
+}
+
+void PerformanceTest::setupTestCase()
+{
+    qDebug() << "Setting up Performance test suite";
+
+    m_checksumData.resize(CHECKSUM_DATA_SIZE);
+    for (int i = 0; i < m_checksumData.size(); ++i) {
+        m_checksumData[i] = static_cast<char>(generateRandomInt(0, 255));
+    }
+
+    CommunicationBufferPool::getInstance()->initialize();
+}
+
+void PerformanceTest::cleanupTestCase()
+{
+    qDebug() << "Cleaning up Performance test suite";
+}
+
+void PerformanceTest::testParserThroughput()
+{
+    ProtocolParser parser;
+    parser.setRingBufferMode(true);
+    qint64 frames = 0;
+    parser.setFrameViewHandler([&frames](const FrameView&) {
+        ++frames;
+        return true;
+    });
+    const QByteArray stream = buildFrameStream(parser);
+
+    PerformanceOptions options;
+    options.bytesPerOp = PARSE_CHUNK_SIZE;
+    const PerformanceResult result = measurePerformance("parser.parseData/ring/1024", [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            const int chunk = static_cast<int>(i % PARSE_CHUNK_COUNT);
+            parser.parseData(QByteArray::fromRawData(stream.constData() + chunk * PARSE_CHUNK_SIZE,
+                                                     PARSE_CHUNK_SIZE));
+        }
+    }, options);
+
+    ASSERT_TRUE(frames > 0);
+    assertPerformance(result);
+}
+
+void PerformanceTest::testChecksumSpeed()
+{
+    PerformanceOptions options;
+    options.bytesPerOp = CHECKSUM_DATA_SIZE;
+
+    const PerformanceResult crc16 = measurePerformance("checksum.crc16_modbus/4096", [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            keepResult(EnhancedChecksum::calculateCRC16_Modbus(m_checksumData));
+        }
+    }, options);
+    const PerformanceResult crc32 = measurePerformance("checksum.crc32/4096", [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            keepResult(EnhancedChecksum::calculateCRC32(m_checksumData));
+        }
+    }, options);
+
+    assertPerformance(crc16);
+    assertPerformance(crc32);
+}
+
+void PerformanceTest::testBufferPoolLatency()
+{
+    CommunicationBufferPool* pool = CommunicationBufferPool::getInstance();
+
+    const PerformanceResult result = measurePerformance("bufferpool.acquire_release/4096", [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i) {
+            QByteArray* buffer = pool->acquireBuffer(POOL_BUFFER_SIZE);
+            keepResult(buffer);
+            pool->releaseBuffer(buffer);
+        }
+    });
+
+    assertPerformance(result);
+}
+
+void PerformanceTest::testUIFlushTime()
+{
+    UIUpdateOptimizer optimizer;
+    optimizer.setUpdateInterval(UIUpdateType::RealTimeData, 0);
+    optimizer.setMaxBatchSize(UI_WIDGET_COUNT);
+    optimizer.setFrameBudget(UI_FRAME_BUDGET_MS);
+
+    QStringList widgetIds;
+    qint64 executed = 0;
+    for (int i = 0; i < UI_WIDGET_COUNT; ++i) {
+        widgetIds.append(QString("sensor_%1").arg(i));
+        optimizer.registerUpdateCallback(UIUpdateType::RealTimeData, widgetIds.last(),
+                                         [&executed](const QVariant&) { ++executed; });
+    }
+
+    // 每次操作：全部控件各提交一次新数据，再执行一帧
+    qint64 round = 0;
+    const PerformanceResult result = measurePerformance("ui.flush/256", [&](qint64 iterations) {
+        for (qint64 i = 0; i < iterations; ++i, ++round) {
+            for (int widget = 0; widget < UI_WIDGET_COUNT; ++widget) {
+                optimizer.requestUpdate(UIUpdateTask(UIUpdateType::RealTimeData, widgetIds.at(widget),
+                                                     static_cast<qlonglong>(round)));
+            }
+            QMetaObject::invokeMethod(&optimizer, "processUpdates", Qt::DirectConnection);
+        }
+    });
+
+    ASSERT_TRUE(executed >= UI_WIDGET_COUNT);
+    assertPerformance(result);
+}
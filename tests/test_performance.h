@@ -0,0 +1,32 @@
+#pragma once
+
+#include "testframework.h"
+
+// 热路径性能回归测试 - 与 tests/performance_baseline.json 比较，超出容差时失败；未加载基线时只报告
+class PerformanceTest : public TestBase
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceTest(QObject* parent = nullptr);
+
+protected:
+    void setupTestCase() override;
+    void cleanupTestCase() override;
+
+private:
+    // 协议解析吞吐量（环形缓冲区模式，1KB 读取块）
+    void testParserThroughput();
+
+    // 4KB 数据的 CRC16/Modbus 与 CRC32
+    void testChecksumSpeed();
+
+    // 缓冲池取用与归还
+    void testBufferPoolLatency();
+
+    // 一帧内刷新全部实时数据控件
+    void testUIFlushTime();
+
+private:
+    QByteArray m_checksumData;
+};
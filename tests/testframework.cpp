@@ -4,12 +4,17 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
 #include <exception>
+#include "../src/utils/allocationtracker.h"
 
 // TestBase 实现
 TestBase::TestBase(QObject* parent)
     : QObject(parent)
     , m_testSkipped(false)
+    , m_performanceEnabled(true)
 {
 }
 
@@ -57,6 +62,11 @@ void TestBase::runSingleTest(const QString& testName)
     
     m_testTimer.start();
     
+    if (!m_performanceEnabled && m_performanceTests.contains(testName)) {
+        skipTest("性能测试未启用");
+        return;
+    }
+    
     try {
         setupTest();
         
@@ -205,6 +215,85 @@ void TestBase::registerTest(const QString& testName, std::function<void()> testF
     m_testFunctions[testName] = testFunc;
 }
 
+void TestBase::registerPerformanceTest(const QString& testName, std::function<void()> testFunc)
+{
+    m_performanceTests.insert(testName);
+    registerTest(testName, testFunc);
+}
+
+void TestBase::setPerformanceTestsEnabled(bool enabled)
+{
+    m_performanceEnabled = enabled;
+}
+
+PerformanceResult TestBase::measurePerformance(const QString& name, const PerformanceBody& body,
+                                               const PerformanceOptions& options)
+{
+    // 每轮操作次数翻倍直到单轮达到最短耗时，标定过程本身也起预热作用
+    const qint64 minRunNs = qint64(qMax(1, options.minRunTimeMs)) * 1000000;
+    qint64 opsPerRun = 1;
+    while (opsPerRun < (Q_INT64_C(1) << 30)) {
+        QElapsedTimer timer;
+        timer.start();
+        body(opsPerRun);
+        if (timer.nsecsElapsed() >= minRunNs) {
+            break;
+        }
+        opsPerRun *= 2;
+    }
+    
+    for (int i = 0; i < options.warmupRuns; ++i) {
+        body(opsPerRun);
+    }
+    
+    const int runs = qMax(1, options.runs);
+    QList<double> samples;
+    samples.reserve(runs);
+    // 只统计本线程的分配，日志写入线程等后台活动不影响结果
+    qint64 allocations = 0;
+    for (int i = 0; i < runs; ++i) {
+        const AllocationTracker::Counters before = AllocationTracker::currentThread();
+        QElapsedTimer timer;
+        timer.start();
+        body(opsPerRun);
+        const qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+        allocations += AllocationTracker::currentThread().count - before.count;
+        samples.append(static_cast<double>(elapsedNs) / opsPerRun);
+    }
+    std::sort(samples.begin(), samples.end());
+    
+    PerformanceResult result;
+    result.name = name;
+    result.opsPerRun = opsPerRun;
+    result.runs = runs;
+    result.medianNs = samples.at(runs / 2);
+    result.p95Ns = samples.at(qBound(0, static_cast<int>(std::ceil(runs * 0.95)) - 1, runs - 1));
+    result.minNs = samples.first();
+    result.allocsPerOp = AllocationTracker::isAvailable()
+        ? static_cast<double>(allocations) / (static_cast<double>(opsPerRun) * runs)
+        : -1.0;
+    result.bytesPerSecond = options.bytesPerOp > 0 ? options.bytesPerOp * 1e9 / result.medianNs : 0.0;
+    
+    m_performanceResults.append(result);
+    return result;
+}
+
+void TestBase::assertPerformance(const PerformanceResult& result)
+{
+    const PerformanceBaseline::Verdict verdict = TestRunner::getInstance()->performanceBaseline().compare(result);
+    qDebug() << verdict.message;
+    if (verdict.regressed) {
+        recordTestResult(m_currentTestName, TestResult::Failed, verdict.message, m_testTimer.elapsed());
+        qDebug() << QString("Test %1 FAILED: %2").arg(m_currentTestName, verdict.message);
+        throw std::runtime_error(verdict.message.toStdString());
+    }
+}
+
+QList<PerformanceResult> TestBase::getPerformanceResults() const
+{
+    return m_performanceResults;
+}
+
 void TestBase::skipTest(const QString& reason)
 {
     m_testSkipped = true;
@@ -225,6 +314,7 @@ TestRunner* TestRunner::getInstance()
 
 TestRunner::TestRunner(QObject* parent)
     : QObject(parent)
+    , m_performanceEnabled(true)
 {
 }
 
@@ -232,6 +322,7 @@ void TestRunner::registerTestSuite(TestBase* testSuite, const QString& suiteName
 {
     QString name = suiteName.isEmpty() ? testSuite->metaObject()->className() : suiteName;
     m_testSuites[name] = testSuite;
+    testSuite->setPerformanceTestsEnabled(m_performanceEnabled);
     qDebug() << QString("Registered test suite: %1").arg(name);
 }
 
@@ -309,6 +400,22 @@ QString TestRunner::generateTextReport() const
                 stream << QString("    Error: %1\n").arg(testCase.errorMessage);
             }
         }
+        
+        for (const PerformanceResult& result : testSuite->getPerformanceResults()) {
+            stream << QString("  [perf] %1: median %2 ns/op, p95 %3 ns/op, %4 ops x %5 runs")
+                      .arg(result.name)
+                      .arg(result.medianNs, 0, 'f', 1)
+                      .arg(result.p95Ns, 0, 'f', 1)
+                      .arg(result.opsPerRun)
+                      .arg(result.runs);
+            if (result.allocsPerOp >= 0.0) {
+                stream << QString(", %1 allocs/op").arg(result.allocsPerOp, 0, 'f', 2);
+            }
+            if (result.bytesPerSecond > 0.0) {
+                stream << QString(", %1 MB/s").arg(result.bytesPerSecond / (1024.0 * 1024.0), 0, 'f', 1);
+            }
+            stream << "\n";
+        }
         stream << "\n";
     }
     
@@ -326,4 +433,54 @@ bool TestRunner::saveReport(const QString& filePath) const
     stream << generateTextReport();
     
     return true;
-}
\ No newline at end of file
+}
+
+void TestRunner::setPerformanceTestsEnabled(bool enabled)
+{
+    m_performanceEnabled = enabled;
+    for (TestBase* testSuite : m_testSuites) {
+        testSuite->setPerformanceTestsEnabled(enabled);
+    }
+}
+
+bool TestRunner::loadPerformanceBaseline(const QString& filePath)
+{
+    QString error;
+    if (!m_performanceBaseline.load(filePath, &error)) {
+        qDebug() << error;
+        return false;
+    }
+    m_performanceBaseline.calibrate();
+    qDebug() << QString("性能基线: %1，参考负载 %2 ns，速度系数 %3")
+                .arg(filePath)
+                .arg(m_performanceBaseline.measuredCalibrationNs(), 0, 'f', 0)
+                .arg(m_performanceBaseline.speedFactor(), 0, 'f', 2);
+    return true;
+}
+
+const PerformanceBaseline& TestRunner::performanceBaseline() const
+{
+    return m_performanceBaseline;
+}
+
+bool TestRunner::updatePerformanceBaseline(const QString& filePath) const
+{
+    QList<PerformanceResult> results;
+    for (TestBase* testSuite : m_testSuites) {
+        results.append(testSuite->getPerformanceResults());
+    }
+    
+    // 保留目标文件中已有的容差设置；未加载过基线时参考负载在保存时测量
+    PerformanceBaseline baseline = m_performanceBaseline;
+    QString error;
+    if (baseline.path() != filePath && QFile::exists(filePath) && !baseline.load(filePath, &error)) {
+        qDebug() << error;
+        return false;
+    }
+    if (!baseline.save(filePath, results, &error)) {
+        qDebug() << error;
+        return false;
+    }
+    qDebug() << QString("已按 %1 项性能结果更新基线: %2").arg(results.size()).arg(filePath);
+    return true;
+}
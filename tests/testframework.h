@@ -10,7 +10,9 @@
 #include <QJsonObject>
 #include <QElapsedTimer>
 #include <QVariantMap>
+#include <QSet>
 #include <functional>
+#include "performancebaseline.h"
 
 // 测试结果类型
 enum class TestResult {
@@ -35,6 +37,14 @@ struct TestCase {
     {}
 };
 
+// 性能测试的计时参数
+struct PerformanceOptions {
+    int warmupRuns = 3;             // 不计入结果的预热轮数
+    int runs = 21;                  // 计时轮数，取中位数和 P95
+    int minRunTimeMs = 10;          // 每轮的最短耗时，据此标定每轮操作次数
+    qint64 bytesPerOp = 0;          // 非0时报告吞吐量
+};
+
 // 测试基础类
 class TestBase : public QObject
 {
@@ -57,6 +67,16 @@ public:
     bool waitForSignal(QObject* sender, const char* signal, int timeout = 5000);
     bool waitForCondition(std::function<bool()> condition, int timeout = 5000);
     
+    // 性能测试：body 执行 iterations 次操作；先标定每轮操作次数并预热，再计时 runs 轮
+    using PerformanceBody = std::function<void(qint64 iterations)>;
+    PerformanceResult measurePerformance(const QString& name, const PerformanceBody& body,
+                                         const PerformanceOptions& options = PerformanceOptions());
+    // 与 TestRunner 加载的性能基线比较，超出容差时测试失败
+    void assertPerformance(const PerformanceResult& result);
+    QList<PerformanceResult> getPerformanceResults() const;
+    
+    void setPerformanceTestsEnabled(bool enabled);
+    
     // 数据生成
     QString generateRandomString(int length = 10);
     int generateRandomInt(int min = 0, int max = 100);
@@ -71,6 +91,8 @@ protected:
     
     // 测试注册
     void registerTest(const QString& testName, std::function<void()> testFunc);
+    // 性能测试用例，未启用性能测试时跳过
+    void registerPerformanceTest(const QString& testName, std::function<void()> testFunc);
     void skipTest(const QString& reason = QString());
 
 private:
@@ -85,6 +107,11 @@ private:
     QString m_currentTestName;
     bool m_testSkipped;
     QElapsedTimer m_testTimer;
+    
+    // 性能测试
+    QSet<QString> m_performanceTests;
+    QList<PerformanceResult> m_performanceResults;
+    bool m_performanceEnabled;
 };
 
 // 测试运行器
@@ -105,6 +132,13 @@ public:
     // 报告生成
     QString generateTextReport() const;
     bool saveReport(const QString& filePath) const;
+    
+    // 性能测试：加载基线后 assertPerformance 才做回归判定
+    void setPerformanceTestsEnabled(bool enabled);
+    bool loadPerformanceBaseline(const QString& filePath);
+    const PerformanceBaseline& performanceBaseline() const;
+    // 按本次运行的性能结果重写基线文件
+    bool updatePerformanceBaseline(const QString& filePath) const;
 
 signals:
     void testSuiteStarted(const QString& suiteName);
@@ -118,9 +152,24 @@ private:
     
     // 测试套件管理
     QMap<QString, TestBase*> m_testSuites;
+    
+    bool m_performanceEnabled;
+    PerformanceBaseline m_performanceBaseline;
 };
 
 // 测试注册宏
 #define ASSERT_EQ(expected, actual) assertEqual(expected, actual, QString("Assert failed at %1:%2").arg(__FILE__).arg(__LINE__))
 #define ASSERT_TRUE(condition) assertTrue(condition, QString("Assert failed at %1:%2").arg(__FILE__).arg(__LINE__))
-#define ASSERT_FALSE(condition) assertFalse(condition, QString("Assert failed at %1:%2").arg(__FILE__).arg(__LINE__))
\ No newline at end of file
+#define ASSERT_FALSE(condition) assertFalse(condition, QString("Assert failed at %1:%2").arg(__FILE__).arg(__LINE__))
+
+// 防止被测结果被编译器优化掉
+template <typename T>
+inline void keepResult(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
\ No newline at end of file
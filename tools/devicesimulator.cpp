@@ -0,0 +1,330 @@
+// 设备模拟器和负载发生器
+// 模拟 N 台点胶机，通过伪终端、TCP 或虚拟 CAN 与上位机通讯：按配置的速率发送传感器、运动、点胶和心跳帧，
+// 可叠加数值噪声和帧错误（校验错、截断、插入垃圾字节），并应答上位机的控制、查询、参数和心跳命令，
+// 用来对真实的 CommunicationManager 收发链路做可重复的负载测试。同样的参数和 --seed 产生同样的数据。
+//
+// 链路（可同时使用，每台设备在每种链路上各有一个端点，设备ID从 1 开始）：
+//   --pty                 每台设备一个伪终端（仅 Unix），上位机把从端当作串口打开
+//   --pty-link=PREFIX     同时创建符号链接 PREFIX1、PREFIX2...，例如 --pty-link=/tmp/ttyGLUE
+//   --serial=PORT,PORT    使用已有串口（例如虚拟串口对的一端），按顺序分给各设备  --baud=N（默认 115200）
+//   --tcp-port=N          设备 i 监听端口 N+i-1，上位机以 TCP 客户端连接  --tcp-address=ADDR（默认所有地址）
+//   --can=IFACE           所有设备共用一个 CAN 接口，例如 vcan0  --can-plugin=NAME（默认 socketcan）
+// 设备的应答从它的所有链路发出，负载测试时每台设备通常只接一种上位机链路。
+//
+// 流量：--devices=N（默认 1） --sensor-hz --motion-hz --glue-hz --heartbeat-hz（每台设备每秒帧数）
+//       --noise=R（传感器相对噪声） --corrupt=P（每帧出错概率） --response-delay-ms=N
+//       --checksum=TYPE（与上位机的校验类型一致，默认 SIMPLE）
+// 运行：--duration=S（默认一直运行到 Ctrl+C） --seed=N --stats-interval-ms=N（默认 1000，0 不输出）
+//       --report=FILE（结束时写出 JSON 报告） --config=FILE（从 JSON 的 device_simulator 段读取默认值，
+//       键名与命令行参数相同，命令行优先）
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include <vector>
+#include "simulateddevice.h"
+#include "simulatorlinks.h"
+
+namespace {
+
+std::atomic<bool> s_interrupted{false};
+
+void onInterrupt(int)
+{
+    s_interrupted.store(true);
+}
+
+// --name=value 形式的参数，命令行优先于配置文件
+class Options
+{
+public:
+    explicit Options(const QStringList& arguments)
+    {
+        for (const QString& argument : arguments.mid(1)) {
+            if (!argument.startsWith("--")) {
+                m_unknown << argument;
+                continue;
+            }
+            const int equals = argument.indexOf('=');
+            const QString name = argument.mid(2, equals < 0 ? -1 : equals - 2);
+            m_values.insert(name, equals < 0 ? QString("1") : argument.mid(equals + 1));
+        }
+    }
+
+    bool loadConfig(const QString& path, QString* error)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            *error = QString("无法打开配置文件 %1: %2").arg(path, file.errorString());
+            return false;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            *error = QString("配置文件格式错误 %1: %2").arg(path, parseError.errorString());
+            return false;
+        }
+        const QJsonObject section = document.object().value("device_simulator").toObject();
+        for (auto it = section.constBegin(); it != section.constEnd(); ++it) {
+            if (!m_values.contains(it.key())) {
+                const QJsonValue value = it.value();
+                m_values.insert(it.key(), value.isBool() ? QString(value.toBool() ? "1" : "0")
+                                                         : value.toVariant().toString());
+            }
+        }
+        return true;
+    }
+
+    bool has(const QString& name) const { return !value(name).isEmpty() && value(name) != "0"; }
+    QString value(const QString& name, const QString& defaultValue = QString()) const
+    {
+        return m_values.value(name, defaultValue);
+    }
+    double number(const QString& name, double defaultValue) const
+    {
+        bool ok = false;
+        const double result = m_values.value(name).toDouble(&ok);
+        return ok ? result : defaultValue;
+    }
+    const QStringList& unknown() const { return m_unknown; }
+
+private:
+    QHash<QString, QString> m_values;
+    QStringList m_unknown;
+};
+
+QJsonObject statisticsToJson(const SimulatorStatistics& statistics, double seconds)
+{
+    QJsonObject json;
+    json["framesSent"] = statistics.framesSent;
+    json["bytesSent"] = statistics.bytesSent;
+    json["corruptedFrames"] = statistics.corruptedFrames;
+    json["commandsReceived"] = statistics.commandsReceived;
+    json["responsesSent"] = statistics.responsesSent;
+    json["invalidFramesReceived"] = statistics.invalidFramesReceived;
+    json["bytesReceived"] = statistics.bytesReceived;
+    json["framesPerSecond"] = seconds > 0.0 ? statistics.framesSent / seconds : 0.0;
+    json["bytesPerSecond"] = seconds > 0.0 ? statistics.bytesSent / seconds : 0.0;
+    return json;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Options options(app.arguments());
+    if (!options.unknown().isEmpty()) {
+        err << "无法识别的参数: " << options.unknown().join(' ') << "\n";
+        return 1;
+    }
+    if (options.has("config")) {
+        QString error;
+        if (!options.loadConfig(options.value("config"), &error)) {
+            err << error << "\n";
+            return 1;
+        }
+    }
+
+    SimulatorTrafficConfig traffic;
+    traffic.sensorRateHz = options.number("sensor-hz", traffic.sensorRateHz);
+    traffic.motionRateHz = options.number("motion-hz", traffic.motionRateHz);
+    traffic.glueRateHz = options.number("glue-hz", traffic.glueRateHz);
+    traffic.heartbeatRateHz = options.number("heartbeat-hz", traffic.heartbeatRateHz);
+    traffic.noiseLevel = options.number("noise", traffic.noiseLevel);
+    traffic.corruptRate = qBound(0.0, options.number("corrupt", traffic.corruptRate), 1.0);
+    traffic.responseDelayMs = static_cast<int>(options.number("response-delay-ms", traffic.responseDelayMs));
+
+    const int deviceCount = static_cast<int>(options.number("devices", 1));
+    const ChecksumType checksumType = EnhancedChecksum::stringToChecksumType(options.value("checksum", "SIMPLE"));
+    const quint64 seed = static_cast<quint64>(options.number("seed", 1));
+    const double durationSeconds = options.number("duration", 0.0);
+    const int statsIntervalMs = static_cast<int>(options.number("stats-interval-ms", 1000));
+    const QStringList serialPorts = options.value("serial").split(',', Qt::SkipEmptyParts);
+    const int tcpPort = static_cast<int>(options.number("tcp-port", 0));
+
+    if (deviceCount < 1 || deviceCount > 127) {
+        err << "--devices 必须在 1-127 之间（CAN 设备ID为 7 位）\n";
+        return 1;
+    }
+    if (!options.has("pty") && !options.has("pty-link") && serialPorts.isEmpty() && tcpPort <= 0 &&
+        !options.has("can")) {
+        err << "至少需要一种链路: --pty / --serial=PORT / --tcp-port=N / --can=IFACE\n";
+        return 1;
+    }
+    if (!serialPorts.isEmpty() && serialPorts.size() < deviceCount) {
+        err << "--serial 指定的串口少于设备数\n";
+        return 1;
+    }
+
+    std::vector<SimulatedDevice*> devices;
+    std::vector<SimulatorStreamLink*> streamLinks;
+    std::unique_ptr<CanBusLink> canLink;
+    QString error;
+
+    for (int id = 1; id <= deviceCount; ++id) {
+        auto* device = new SimulatedDevice(id, traffic, seed, &app);
+        devices.push_back(device);
+
+        if (options.has("pty") || options.has("pty-link")) {
+#ifdef Q_OS_UNIX
+            const QString linkPath = options.has("pty-link") ? options.value("pty-link") + QString::number(id) : QString();
+            streamLinks.push_back(new PtyLink(device, checksumType, linkPath, &app));
+#else
+            err << "伪终端仅支持 Unix，Windows 请使用虚拟串口对和 --serial\n";
+            return 1;
+#endif
+        }
+        if (!serialPorts.isEmpty()) {
+            streamLinks.push_back(new SerialPortLink(device, checksumType, serialPorts.at(id - 1),
+                                                     static_cast<int>(options.number("baud", 115200)), &app));
+        }
+        if (tcpPort > 0) {
+            streamLinks.push_back(new TcpServerLink(device, checksumType, options.value("tcp-address"),
+                                                    static_cast<quint16>(tcpPort + id - 1), &app));
+        }
+    }
+
+    for (SimulatorStreamLink* link : streamLinks) {
+        if (!link->open(&error)) {
+            err << error << "\n";
+            return 1;
+        }
+        out << "设备 " << link->device()->deviceId() << ": " << link->description() << "\n";
+    }
+    if (options.has("can")) {
+        canLink = std::make_unique<CanBusLink>(options.value("can-plugin", "socketcan"), options.value("can"),
+                                               traffic.corruptRate);
+        for (SimulatedDevice* device : devices) {
+            canLink->addDevice(device);
+        }
+        if (!canLink->open(&error)) {
+            err << error << "\n";
+            return 1;
+        }
+        out << "CAN: " << canLink->description() << "（设备ID 1-" << deviceCount << "）\n";
+    }
+    out.flush();
+
+    auto totals = [&]() {
+        SimulatorStatistics total;
+        for (SimulatorStreamLink* link : streamLinks) {
+            total += link->statistics();
+        }
+        if (canLink) {
+            total += canLink->statistics();
+        }
+        return total;
+    };
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (SimulatedDevice* device : devices) {
+        device->start();
+    }
+
+    // 周期输出本周期的速率
+    SimulatorStatistics lastTotals;
+    qint64 lastReportMs = 0;
+    QTimer statsTimer;
+    if (statsIntervalMs > 0) {
+        QObject::connect(&statsTimer, &QTimer::timeout, [&]() {
+            const SimulatorStatistics now = totals();
+            const qint64 nowMs = elapsed.elapsed();
+            const double seconds = (nowMs - lastReportMs) / 1000.0;
+            out << QString("[%1s] 发送 %2 帧/s %3 KB/s  注入错误 %4  收到命令 %5（无效 %6）  应答 %7\n")
+                       .arg(nowMs / 1000.0, 0, 'f', 1)
+                       .arg((now.framesSent - lastTotals.framesSent) / seconds, 0, 'f', 0)
+                       .arg((now.bytesSent - lastTotals.bytesSent) / 1024.0 / seconds, 0, 'f', 1)
+                       .arg(now.corruptedFrames - lastTotals.corruptedFrames)
+                       .arg(now.commandsReceived - lastTotals.commandsReceived)
+                       .arg(now.invalidFramesReceived - lastTotals.invalidFramesReceived)
+                       .arg(now.responsesSent - lastTotals.responsesSent);
+            out.flush();
+            lastTotals = now;
+            lastReportMs = nowMs;
+        });
+        statsTimer.start(statsIntervalMs);
+    }
+
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    QTimer stopTimer;
+    QObject::connect(&stopTimer, &QTimer::timeout, [&]() {
+        if (s_interrupted.load() || (durationSeconds > 0.0 && elapsed.elapsed() >= durationSeconds * 1000.0)) {
+            app.quit();
+        }
+    });
+    stopTimer.start(100);
+
+    app.exec();
+
+    for (SimulatedDevice* device : devices) {
+        device->stop();
+    }
+    const double seconds = elapsed.elapsed() / 1000.0;
+    const SimulatorStatistics total = totals();
+    out << QString("共运行 %1s: 发送 %2 帧 (%3 帧/s)，注入错误 %4，收到命令 %5，无效 %6，应答 %7\n")
+               .arg(seconds, 0, 'f', 1)
+               .arg(total.framesSent)
+               .arg(seconds > 0.0 ? total.framesSent / seconds : 0.0, 0, 'f', 0)
+               .arg(total.corruptedFrames)
+               .arg(total.commandsReceived)
+               .arg(total.invalidFramesReceived)
+               .arg(total.responsesSent);
+    out.flush();
+
+    if (options.has("report")) {
+        QJsonObject config;
+        config["devices"] = deviceCount;
+        config["sensorHz"] = traffic.sensorRateHz;
+        config["motionHz"] = traffic.motionRateHz;
+        config["glueHz"] = traffic.glueRateHz;
+        config["heartbeatHz"] = traffic.heartbeatRateHz;
+        config["noise"] = traffic.noiseLevel;
+        config["corrupt"] = traffic.corruptRate;
+        config["responseDelayMs"] = traffic.responseDelayMs;
+        config["checksum"] = EnhancedChecksum::checksumTypeToString(checksumType);
+        config["seed"] = QString::number(seed);
+
+        QJsonArray links;
+        for (SimulatorStreamLink* link : streamLinks) {
+            QJsonObject json = statisticsToJson(link->statistics(), seconds);
+            json["deviceId"] = link->device()->deviceId();
+            json["link"] = link->description();
+            links.append(json);
+        }
+        if (canLink) {
+            QJsonObject json = statisticsToJson(canLink->statistics(), seconds);
+            json["link"] = canLink->description();
+            links.append(json);
+        }
+
+        QJsonObject report;
+        report["durationSeconds"] = seconds;
+        report["config"] = config;
+        report["total"] = statisticsToJson(total, seconds);
+        report["links"] = links;
+
+        QFile file(options.value("report"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "无法写入报告 " << file.fileName() << ": " << file.errorString() << "\n";
+            return 1;
+        }
+        file.write(QJsonDocument(report).toJson());
+        out << "报告已写入 " << file.fileName() << "\n";
+    }
+    return 0;
+}
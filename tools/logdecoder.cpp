@@ -0,0 +1,78 @@
+// 二进制日志离线解码工具
+// 把 LogManager 在二进制模式下写出的 .blog 文件还原为与文本日志相同格式的文本；
+// 也接受后台压缩过的日志段（.qz），文本段解压后原样输出
+//
+// 用法: LogDecoder <app.blog|app.000001.log.qz> [输出文件]    未指定输出文件时写到标准输出
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include "logger/logcodec.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList arguments = app.arguments();
+
+    QTextStream err(stderr);
+    if (arguments.size() < 2) {
+        err << "用法: LogDecoder <二进制日志文件> [输出文件]\n";
+        return 1;
+    }
+
+    QFile input(arguments.at(1));
+    if (!input.open(QIODevice::ReadOnly)) {
+        err << "无法打开文件: " << input.fileName() << " (" << input.errorString() << ")\n";
+        return 1;
+    }
+
+    QFile output;
+    if (arguments.size() >= 3) {
+        output.setFileName(arguments.at(2));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            err << "无法创建文件: " << output.fileName() << " (" << output.errorString() << ")\n";
+            return 1;
+        }
+    } else if (!output.open(stdout, QIODevice::WriteOnly | QIODevice::Text)) {
+        return 1;
+    }
+
+    QByteArray data = input.readAll();
+    if (input.fileName().endsWith(".qz")) {
+        data = qUncompress(data);
+        if (data.isEmpty()) {
+            err << "解压失败: " << input.fileName() << "\n";
+            return 1;
+        }
+    }
+
+    // 文本日志段不需要解码，去掉未写入区域后原样输出
+    if (!data.startsWith(BinaryLogWriter::fileMagic())) {
+        qsizetype used = data.size();
+        while (used > 0 && data.at(used - 1) == '\0') {
+            --used;
+        }
+        output.write(data.constData(), used);
+        return 0;
+    }
+
+    QTextStream out(&output);
+    out.setEncoding(QStringConverter::Utf8);
+
+    BinaryLogReader reader(data);
+    LogEntry entry;
+    qint64 count = 0;
+    while (reader.readNext(entry)) {
+        out << LogFormatting::formatEntry(entry) << "\n";
+        ++count;
+    }
+    out.flush();
+
+    // 进程异常退出时文件末尾可能有不完整的记录，已解码的部分照常输出
+    if (reader.hasError()) {
+        err << "解码在第 " << count << " 条之后停止: " << reader.errorString() << "\n";
+        return 2;
+    }
+    err << "已解码 " << count << " 条日志\n";
+    return 0;
+}
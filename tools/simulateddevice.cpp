@@ -0,0 +1,501 @@
+#include "simulateddevice.h"
+#include "utils/crcengine.h"
+#include <QDateTime>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 点胶轨迹：以 (CENTER_X, CENTER_Y) 为圆心的圆，Z 在点胶高度附近小幅起伏
+constexpr double CENTER_X = 100.0;
+constexpr double CENTER_Y = 100.0;
+constexpr double RADIUS = 50.0;
+constexpr double DISPENSE_HEIGHT = 5.0;
+constexpr double DEFAULT_SPEED = 20.0;              // mm/s
+constexpr double DEFAULT_PRESSURE = 0.4;            // MPa
+constexpr double AMBIENT_TEMPERATURE = 25.0;        // ℃
+constexpr double FLOW_RATE = 0.002;                 // ml/s，点胶时每秒出胶量
+constexpr double PRESSURE_TIME_CONSTANT = 0.2;      // 压力一阶响应时间常数(s)
+constexpr double HOMING_SPEED = 50.0;               // mm/s
+constexpr double TWO_PI = 6.283185307179586;
+
+constexpr int TICK_INTERVAL_MS = 1;
+constexpr int SENSOR_PAYLOAD_SIZE = 32;             // 7 个 float（小端）+ 状态 + 3 字节保留
+constexpr qint64 MAX_CATCH_UP_NS = 100000000LL;     // 事件循环卡顿后最多补发 100ms 的帧
+
+// 参数条目的总长度（参数名长度 + 参数名 + 类型 + 值），格式错误返回 -1
+int parameterEntryLength(const char* data, int length)
+{
+    if (length < 2) return -1;
+    int index = 1 + static_cast<quint8>(data[0]);
+    if (index >= length) return -1;
+    const quint8 type = static_cast<quint8>(data[index++]);
+    switch (type) {
+    case Protocol::PARAM_TYPE_INT:    index += 4; break;
+    case Protocol::PARAM_TYPE_DOUBLE: index += 8; break;
+    case Protocol::PARAM_TYPE_BOOL:   index += 1; break;
+    case Protocol::PARAM_TYPE_STRING:
+        if (index >= length) return -1;
+        index += 1 + static_cast<quint8>(data[index]);
+        break;
+    default:
+        return -1;
+    }
+    return index <= length ? index : -1;
+}
+
+QString parameterEntryName(const char* data)
+{
+    return QString::fromUtf8(data + 1, static_cast<quint8>(data[0]));
+}
+
+void appendFloatLittleEndian(char* dest, double value)
+{
+    qToLittleEndian(static_cast<float>(value), dest);
+}
+
+// 位置/点胶帧的浮点为本机字节序，与 FrameWriter::writeFloat 一致
+void appendFloat(QByteArray& out, double value)
+{
+    const float f = static_cast<float>(value);
+    out.append(reinterpret_cast<const char*>(&f), sizeof(float));
+}
+
+} // namespace
+
+SimulatorStatistics& SimulatorStatistics::operator+=(const SimulatorStatistics& other)
+{
+    framesSent += other.framesSent;
+    bytesSent += other.bytesSent;
+    corruptedFrames += other.corruptedFrames;
+    commandsReceived += other.commandsReceived;
+    responsesSent += other.responsesSent;
+    invalidFramesReceived += other.invalidFramesReceived;
+    bytesReceived += other.bytesReceived;
+    return *this;
+}
+
+SimulatedDevice::SimulatedDevice(int deviceId, const SimulatorTrafficConfig& config, quint64 seed, QObject* parent)
+    : QObject(parent)
+    , m_deviceId(deviceId)
+    , m_config(config)
+    , m_random(static_cast<quint32>(seed ^ (seed >> 32)) + static_cast<quint32>(deviceId))
+    , m_lastTickNs(0)
+    , m_collecting(true)
+    , m_state(State::Running)
+    , m_phase(0.0)
+    , m_speed(DEFAULT_SPEED)
+    , m_x(CENTER_X + RADIUS)
+    , m_y(CENTER_Y)
+    , m_z(DISPENSE_HEIGHT)
+    , m_pressure(DEFAULT_PRESSURE)
+    , m_pressureSetpoint(DEFAULT_PRESSURE)
+    , m_temperature(AMBIENT_TEMPERATURE)
+    , m_volume(0.0)
+    , m_dispensing(true)
+    , m_glueTimeNs(0)
+{
+    m_sensorStream.rateHz = config.sensorRateHz;
+    m_motionStream.rateHz = config.motionRateHz;
+    m_glueStream.rateHz = config.glueRateHz;
+    m_heartbeatStream.rateHz = config.heartbeatRateHz;
+
+    // 各设备的轨迹起点错开，多台设备的数据不完全相同
+    m_phase = m_random.bounded(TWO_PI);
+
+    m_tickTimer.setTimerType(Qt::PreciseTimer);
+    m_tickTimer.setInterval(TICK_INTERVAL_MS);
+    connect(&m_tickTimer, &QTimer::timeout, this, &SimulatedDevice::onTick);
+}
+
+void SimulatedDevice::start()
+{
+    m_clock.start();
+    m_lastTickNs = 0;
+    for (Stream* stream : {&m_sensorStream, &m_motionStream, &m_glueStream, &m_heartbeatStream}) {
+        stream->nextNs = 0;
+    }
+    m_tickTimer.start();
+}
+
+void SimulatedDevice::stop()
+{
+    m_tickTimer.stop();
+}
+
+void SimulatedDevice::onTick()
+{
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    advance(nowNs - m_lastTickNs);
+    m_lastTickNs = nowNs;
+
+    for (int i = dueCount(m_sensorStream, nowNs); i > 0; --i) {
+        if (m_collecting) {
+            emit messageReady(ProtocolCommand::ReadSensorData, sensorPayload());
+        }
+    }
+    for (int i = dueCount(m_motionStream, nowNs); i > 0; --i) {
+        emit messageReady(ProtocolCommand::MoveToPosition, motionPayload());
+    }
+    for (int i = dueCount(m_glueStream, nowNs); i > 0; --i) {
+        emit messageReady(ProtocolCommand::SetGlueParameters, gluePayload());
+    }
+    for (int i = dueCount(m_heartbeatStream, nowNs); i > 0; --i) {
+        emit messageReady(ProtocolCommand::Heartbeat, QByteArray(1, static_cast<char>(Protocol::HEARTBEAT_TYPE_PING)));
+    }
+}
+
+// 自上次以来到期的帧数，按绝对时间排期，定时器抖动不会累积成速率偏差
+int SimulatedDevice::dueCount(Stream& stream, qint64 nowNs)
+{
+    if (stream.rateHz <= 0.0) {
+        return 0;
+    }
+    const qint64 periodNs = std::max<qint64>(1, static_cast<qint64>(1e9 / stream.rateHz));
+    if (nowNs - stream.nextNs > MAX_CATCH_UP_NS) {
+        stream.nextNs = nowNs - MAX_CATCH_UP_NS;
+    }
+    int count = 0;
+    while (stream.nextNs <= nowNs) {
+        stream.nextNs += periodNs;
+        ++count;
+    }
+    return count;
+}
+
+void SimulatedDevice::advance(qint64 elapsedNs)
+{
+    const double dt = elapsedNs / 1e9;
+    if (dt <= 0.0) {
+        return;
+    }
+
+    switch (m_state) {
+    case State::Running:
+        m_phase = std::fmod(m_phase + m_speed / RADIUS * dt, TWO_PI);
+        m_x = CENTER_X + RADIUS * std::cos(m_phase);
+        m_y = CENTER_Y + RADIUS * std::sin(m_phase);
+        m_z = DISPENSE_HEIGHT + 0.2 * std::sin(4.0 * m_phase);
+        break;
+    case State::Homing: {
+        // 直线回到原点，到达后停止
+        const double distance = std::sqrt(m_x * m_x + m_y * m_y + m_z * m_z);
+        const double step = HOMING_SPEED * dt;
+        if (distance <= step) {
+            m_x = m_y = m_z = 0.0;
+            m_state = State::Stopped;
+        } else {
+            const double scale = 1.0 - step / distance;
+            m_x *= scale;
+            m_y *= scale;
+            m_z *= scale;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    // 只有运行中点胶时才有压力和出胶
+    const bool flowing = m_state == State::Running && m_dispensing;
+    const double target = flowing ? m_pressureSetpoint : 0.0;
+    m_pressure += (target - m_pressure) * std::min(1.0, dt / PRESSURE_TIME_CONSTANT);
+    if (flowing) {
+        m_volume += FLOW_RATE * dt * (m_pressure / m_pressureSetpoint);
+        m_glueTimeNs += elapsedNs;
+    }
+
+    // 胶阀加热：点胶时缓慢升温，停止后回落到室温
+    const double thermalTarget = AMBIENT_TEMPERATURE + (flowing ? 5.0 : 0.0);
+    m_temperature += (thermalTarget - m_temperature) * std::min(1.0, dt / 30.0);
+}
+
+double SimulatedDevice::noise(double value)
+{
+    if (m_config.noiseLevel <= 0.0) {
+        return value;
+    }
+    // 相对噪声，零值附近加一个小的绝对噪声
+    const double amplitude = m_config.noiseLevel * (std::fabs(value) + 0.01);
+    return value + (m_random.generateDouble() * 2.0 - 1.0) * amplitude;
+}
+
+QByteArray SimulatedDevice::sensorPayload()
+{
+    const double velocity = m_state == State::Running ? m_speed : (m_state == State::Homing ? HOMING_SPEED : 0.0);
+    const double values[] = {
+        noise(m_x), noise(m_y), noise(m_z), noise(velocity), noise(m_pressure), noise(m_temperature), m_volume
+    };
+
+    QByteArray payload(SENSOR_PAYLOAD_SIZE, '\0');
+    char* data = payload.data();
+    for (double value : values) {
+        appendFloatLittleEndian(data, value);
+        data += sizeof(float);
+    }
+    *data = static_cast<char>(m_state);
+    return payload;
+}
+
+QByteArray SimulatedDevice::motionPayload() const
+{
+    QByteArray payload;
+    payload.reserve(Device::MOTION_DATA_SIZE);
+    appendFloat(payload, m_x);
+    appendFloat(payload, m_y);
+    appendFloat(payload, m_z);
+    appendFloat(payload, m_state == State::Running ? m_speed : 0.0);
+    return payload;
+}
+
+QByteArray SimulatedDevice::gluePayload() const
+{
+    QByteArray payload;
+    payload.reserve(Device::GLUE_DATA_SIZE);
+    appendFloat(payload, m_volume);
+    appendFloat(payload, m_pressure);
+    appendFloat(payload, m_temperature);
+    char time[4];
+    qToBigEndian(static_cast<quint32>(m_glueTimeNs / 1000000), time);
+    payload.append(time, 4);
+    return payload;
+}
+
+void SimulatedDevice::handleCommand(ProtocolCommand command, const QByteArray& data)
+{
+    // 上位机的响应和错误帧不需要应答
+    if (command == ProtocolCommand::Response || command == ProtocolCommand::Error) {
+        return;
+    }
+
+    if (m_config.responseDelayMs <= 0) {
+        respond(command, data);
+        return;
+    }
+    QTimer::singleShot(m_config.responseDelayMs, this, [this, command, data]() { respond(command, data); });
+}
+
+void SimulatedDevice::respond(ProtocolCommand command, const QByteArray& data)
+{
+    switch (command) {
+    case ProtocolCommand::DeviceStart:
+    case ProtocolCommand::ResumeDevice:
+        // 急停和故障必须先复位
+        if (m_state == State::EmergencyStop || m_state == State::Fault) {
+            sendError(ProtocolError::DeviceNotReady);
+            return;
+        }
+        m_state = State::Running;
+        break;
+    case ProtocolCommand::DeviceStop:
+        m_state = State::Stopped;
+        break;
+    case ProtocolCommand::PauseDevice:
+        if (m_state == State::Running) {
+            m_state = State::Paused;
+        }
+        break;
+    case ProtocolCommand::DeviceReset:
+        m_state = State::Stopped;
+        break;
+    case ProtocolCommand::HomeDevice:
+        if (m_state == State::EmergencyStop) {
+            sendError(ProtocolError::DeviceNotReady);
+            return;
+        }
+        m_state = State::Homing;
+        break;
+    case ProtocolCommand::EmergencyStop:
+        m_state = State::EmergencyStop;
+        break;
+    case ProtocolCommand::DeviceStatus:
+        sendResponse(command, QByteArray(1, static_cast<char>(m_state)));
+        return;
+
+    case ProtocolCommand::MoveToPosition:
+    case ProtocolCommand::JogMove:
+    case ProtocolCommand::SetOrigin:
+        break;
+    case ProtocolCommand::GetPosition:
+        sendResponse(command, motionPayload());
+        return;
+
+    case ProtocolCommand::StartGlue:
+        m_dispensing = true;
+        break;
+    case ProtocolCommand::StopGlue:
+        m_dispensing = false;
+        break;
+    case ProtocolCommand::SetGlueParameters:
+        if (data.size() >= Device::GLUE_DATA_SIZE) {
+            float pressure;
+            memcpy(&pressure, data.constData() + sizeof(float), sizeof(float));
+            if (pressure >= Device::MIN_PRESSURE && pressure <= Device::MAX_PRESSURE) {
+                m_pressureSetpoint = pressure;
+            }
+        }
+        break;
+    case ProtocolCommand::GetGlueParameters:
+        sendResponse(command, gluePayload());
+        return;
+
+    // 数据查询直接回传感器帧，上位机按传感器数据解析
+    case ProtocolCommand::ReadSensorData:
+    case ProtocolCommand::ReadAllSensors:
+        emit messageReady(ProtocolCommand::ReadSensorData, sensorPayload());
+        return;
+    case ProtocolCommand::StartDataCollection:
+        m_collecting = true;
+        break;
+    case ProtocolCommand::StopDataCollection:
+        m_collecting = false;
+        break;
+
+    case ProtocolCommand::ReadParameter: {
+        const QString name = data.isEmpty() ? QString() : QString::fromUtf8(data.constData() + 1,
+                                                                            std::min<int>(static_cast<quint8>(data[0]), data.size() - 1));
+        const auto it = m_parameters.constFind(name);
+        if (it == m_parameters.constEnd()) {
+            sendError(ProtocolError::InvalidParameter);
+            return;
+        }
+        sendResponse(command, it.value());
+        return;
+    }
+    case ProtocolCommand::WriteParameter:
+    case ProtocolCommand::WriteAllParameters: {
+        const QByteArray result = writeParameters(command == ProtocolCommand::WriteParameter
+                                                  ? QByteArray(1, '\1') + data : data);
+        if (result.isNull()) {
+            sendError(ProtocolError::InvalidParameter);
+            return;
+        }
+        sendResponse(command, command == ProtocolCommand::WriteAllParameters ? result : QByteArray());
+        return;
+    }
+    case ProtocolCommand::ReadAllParameters: {
+        const QByteArray result = readParameters(data);
+        if (result.isNull()) {
+            sendError(ProtocolError::InvalidParameter);
+            return;
+        }
+        sendResponse(command, result);
+        return;
+    }
+
+    case ProtocolCommand::GetDeviceInfo:
+        sendResponse(command, QString("GlueSim-%1").arg(m_deviceId).toUtf8());
+        return;
+    case ProtocolCommand::GetVersionInfo:
+        sendResponse(command, QByteArray("sim-") + AppInfo::APP_VERSION);
+        return;
+    case ProtocolCommand::SetDateTime:
+        break;
+    case ProtocolCommand::GetDateTime: {
+        char time[8];
+        qToBigEndian(QDateTime::currentMSecsSinceEpoch(), time);
+        sendResponse(command, QByteArray(time, 8));
+        return;
+    }
+
+    case ProtocolCommand::Heartbeat:
+        // 上位机心跳：时间戳原样回送，上位机据此统计往返时间
+        if (data.size() >= 9 && static_cast<quint8>(data[0]) == Protocol::HEARTBEAT_TYPE_PING) {
+            QByteArray pong = data.left(9);
+            pong[0] = static_cast<char>(Protocol::HEARTBEAT_TYPE_PONG);
+            emit messageReady(ProtocolCommand::Heartbeat, pong);
+        }
+        return;
+
+    default:
+        // 固件升级、轨迹流式下发等模拟器未实现的命令
+        sendError(ProtocolError::InvalidCommand);
+        return;
+    }
+
+    sendResponse(command, QByteArray());
+}
+
+void SimulatedDevice::sendResponse(ProtocolCommand command, const QByteArray& data)
+{
+    QByteArray response;
+    response.reserve(1 + data.size());
+    response.append(static_cast<char>(command));
+    response.append(data.left(Protocol::MAX_DATA_SIZE - 1));
+    emit messageReady(ProtocolCommand::Response, response);
+}
+
+void SimulatedDevice::sendError(ProtocolError error)
+{
+    emit messageReady(ProtocolCommand::Error, QByteArray(1, static_cast<char>(error)));
+}
+
+// 条目数(1) 条目...，成功返回参数集哈希(4)，格式错误返回空（null）
+QByteArray SimulatedDevice::writeParameters(const QByteArray& data)
+{
+    if (data.isEmpty()) {
+        return QByteArray();
+    }
+    const int count = static_cast<quint8>(data[0]);
+    QMap<QString, QByteArray> entries;
+    int index = 1;
+    for (int i = 0; i < count; ++i) {
+        const int length = parameterEntryLength(data.constData() + index, data.size() - index);
+        if (length < 0) {
+            return QByteArray();
+        }
+        entries.insert(parameterEntryName(data.constData() + index), data.mid(index, length));
+        index += length;
+    }
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        m_parameters.insert(it.key(), it.value());
+    }
+
+    QByteArray hash(4, Qt::Uninitialized);
+    qToBigEndian(parameterHash(), hash.data());
+    return hash;
+}
+
+// 标志(1) 主机参数集哈希(4) 起始序号(2) → 设备参数集哈希(4) 参数总数(2) 本帧条目...
+QByteArray SimulatedDevice::readParameters(const QByteArray& data) const
+{
+    if (data.size() < 7) {
+        return QByteArray();
+    }
+    const bool shadowValid = (static_cast<quint8>(data[0]) & 0x01) != 0;
+    const quint32 hostHash = qFromBigEndian<quint32>(data.constData() + 1);
+    const int offset = qFromBigEndian<quint16>(data.constData() + 5);
+    const quint32 hash = parameterHash();
+
+    QByteArray response(6, Qt::Uninitialized);
+    qToBigEndian(hash, response.data());
+    qToBigEndian(static_cast<quint16>(m_parameters.size()), response.data() + 4);
+    if (offset == 0 && shadowValid && hostHash == hash) {
+        return response;
+    }
+
+    // 响应数据区还要放原始命令码
+    int index = 0;
+    for (auto it = m_parameters.constBegin(); it != m_parameters.constEnd(); ++it, ++index) {
+        if (index < offset) {
+            continue;
+        }
+        if (1 + response.size() + it.value().size() > Protocol::MAX_DATA_SIZE) {
+            break;
+        }
+        response.append(it.value());
+    }
+    return response;
+}
+
+quint32 SimulatedDevice::parameterHash() const
+{
+    uint32_t state = 0xFFFFFFFF;
+    for (auto it = m_parameters.constBegin(); it != m_parameters.constEnd(); ++it) {
+        state = CRCEngine::updateCRC32C(state, reinterpret_cast<const uint8_t*>(it.value().constData()),
+                                        static_cast<size_t>(it.value().size()));
+    }
+    return state ^ 0xFFFFFFFF;
+}
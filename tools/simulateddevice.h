@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTimer>
+#include "communication/protocolparser.h"
+
+// 模拟设备的流量配置，速率为每秒帧数，0 表示不发送
+struct SimulatorTrafficConfig {
+    double sensorRateHz = 100.0;        // ReadSensorData 传感器帧
+    double motionRateHz = 10.0;         // MoveToPosition 位置帧
+    double glueRateHz = 2.0;            // SetGlueParameters 点胶数据帧
+    double heartbeatRateHz = 1.0;       // 设备主动心跳（只含心跳标识，不参与往返时间统计）
+    double noiseLevel = 0.01;           // 传感器数值的相对噪声幅度
+    double corruptRate = 0.0;           // 每帧被破坏的概率（0-1）
+    int responseDelayMs = 0;            // 命令应答延迟
+};
+
+// 模拟设备收发统计
+struct SimulatorStatistics {
+    qint64 framesSent = 0;
+    qint64 bytesSent = 0;
+    qint64 corruptedFrames = 0;         // 注入错误的帧数
+    qint64 commandsReceived = 0;        // 上位机发来的有效帧
+    qint64 responsesSent = 0;
+    qint64 invalidFramesReceived = 0;   // 上位机发来的校验失败或格式错误的帧
+    qint64 bytesReceived = 0;
+
+    SimulatorStatistics& operator+=(const SimulatorStatistics& other);
+};
+
+// 模拟点胶机 - 沿圆形点胶轨迹运动，按配置的速率产生传感器、运动、点胶和心跳帧，
+// 应答上位机的控制、查询、参数和心跳命令。只产生协议层的消息（命令码 + 数据区），
+// 由链路（伪终端/TCP/CAN）负责组帧、注入错误和收发。随机数按设备序号播种，同样的参数可重复
+class SimulatedDevice : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 与 DataMonitorWidget 的状态显示一致
+    enum class State : quint8 {
+        Stopped = 0,
+        Running = 1,
+        Paused = 2,
+        Homing = 3,
+        Fault = 4,
+        EmergencyStop = 5
+    };
+
+    SimulatedDevice(int deviceId, const SimulatorTrafficConfig& config, quint64 seed, QObject* parent = nullptr);
+
+    int deviceId() const { return m_deviceId; }
+    State state() const { return m_state; }
+    const SimulatorTrafficConfig& config() const { return m_config; }
+    QRandomGenerator& random() { return m_random; }
+
+    void start();
+    void stop();
+
+    // 链路收到并校验通过的上位机帧
+    void handleCommand(ProtocolCommand command, const QByteArray& data);
+
+    // 当前状态对应的帧数据区，格式与上位机解析一致
+    QByteArray sensorPayload();
+    QByteArray motionPayload() const;
+    QByteArray gluePayload() const;
+
+    double positionX() const { return m_x; }
+    double positionY() const { return m_y; }
+    double positionZ() const { return m_z; }
+    double pressure() const { return m_pressure; }
+    double temperature() const { return m_temperature; }
+    double glueVolume() const { return m_volume; }
+
+signals:
+    // 设备要发出的一帧
+    void messageReady(ProtocolCommand command, const QByteArray& data);
+
+private slots:
+    void onTick();
+
+private:
+    // 按固定速率发送的一路数据
+    struct Stream {
+        double rateHz = 0.0;
+        qint64 nextNs = 0;
+    };
+
+    void advance(qint64 elapsedNs);
+    int dueCount(Stream& stream, qint64 nowNs);
+    void respond(ProtocolCommand command, const QByteArray& data);
+    void sendResponse(ProtocolCommand command, const QByteArray& data);
+    void sendError(ProtocolError error);
+    QByteArray writeParameters(const QByteArray& data);
+    QByteArray readParameters(const QByteArray& data) const;
+    quint32 parameterHash() const;
+    double noise(double value);
+
+private:
+    int m_deviceId;
+    SimulatorTrafficConfig m_config;
+    QRandomGenerator m_random;
+    QTimer m_tickTimer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTickNs;
+
+    Stream m_sensorStream;
+    Stream m_motionStream;
+    Stream m_glueStream;
+    Stream m_heartbeatStream;
+    bool m_collecting;              // StopDataCollection 后停发传感器帧
+
+    State m_state;
+    double m_phase;                 // 轨迹相位（弧度）
+    double m_speed;                 // 进给速度 mm/s
+    double m_x, m_y, m_z;
+    double m_pressure;              // MPa
+    double m_pressureSetpoint;      // SetGlueParameters 设定的点胶压力
+    double m_temperature;           // ℃
+    double m_volume;                // 累计胶量 ml
+    bool m_dispensing;
+    qint64 m_glueTimeNs;            // 累计点胶时间
+    QMap<QString, QByteArray> m_parameters;     // 参数名 → 参数条目编码（按参数名升序，与上位机参数集哈希一致）
+};
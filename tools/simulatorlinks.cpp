@@ -0,0 +1,539 @@
+#include "simulatorlinks.h"
+#include "communication/framewriter.h"
+#include <QCanBus>
+#include <QCanBusDevice>
+#include <QCanBusFrame>
+#include <QFile>
+#include <QSerialPort>
+#include <QSocketNotifier>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int FRAME_PREFIX_SIZE = 4;            // 帧头(2) + 命令(1) + 长度(1)
+constexpr int MAX_GARBAGE_BYTES = 16;
+
+// CanWorker 的报文类型基址
+constexpr quint32 CAN_MOTION = 0x100;
+constexpr quint32 CAN_GLUE = 0x200;
+constexpr quint32 CAN_STATUS = 0x300;
+constexpr quint32 CAN_ALARM = 0x600;
+constexpr quint32 CAN_HEARTBEAT = 0x700;
+constexpr quint32 CAN_EMERGENCY = 0x080;
+
+qint16 toFixed(double value, double scale)
+{
+    return static_cast<qint16>(qBound(-32768.0, std::round(value * scale), 32767.0));
+}
+
+quint16 toUnsignedFixed(double value, double scale)
+{
+    return static_cast<quint16>(qBound(0.0, std::round(value * scale), 65535.0));
+}
+
+float floatAt(const QByteArray& data, int index)
+{
+    float value = 0.0f;
+    memcpy(&value, data.constData() + index * sizeof(float), sizeof(float));
+    return value;
+}
+
+float littleEndianFloatAt(const QByteArray& data, int index)
+{
+    return qFromLittleEndian<float>(data.constData() + index * sizeof(float));
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SimulatorStreamLink
+
+SimulatorStreamLink::SimulatorStreamLink(SimulatedDevice* device, ChecksumType checksumType, QObject* parent)
+    : QObject(parent)
+    , m_device(device)
+    , m_checksumType(checksumType)
+    , m_checksumLength(EnhancedChecksum::getChecksumLength(checksumType))
+{
+    connect(device, &SimulatedDevice::messageReady, this, &SimulatorStreamLink::onMessageReady);
+}
+
+QByteArray SimulatorStreamLink::encodeFrame(ProtocolCommand command, const QByteArray& data) const
+{
+    QByteArray frame(FrameWriter::requiredSize(data.size(), m_checksumType), Qt::Uninitialized);
+    FrameWriter writer(frame.data(), frame.size(), m_checksumType);
+    writer.begin(static_cast<quint8>(command), data.size());
+    writer.writeBytes(data);
+    const FrameView view = writer.finish();
+    if (view.isEmpty()) {
+        return QByteArray();
+    }
+    frame.truncate(view.size());
+    return frame;
+}
+
+void SimulatorStreamLink::corrupt(QByteArray& frame)
+{
+    QRandomGenerator& random = m_device->random();
+    switch (static_cast<Corruption>(random.bounded(3))) {
+    case Corruption::ChecksumError: {
+        // 命令码到校验之间任意一位，帧头和帧尾保持完整，上位机只能靠校验发现
+        const int index = 2 + random.bounded(frame.size() - 3);
+        frame[index] = static_cast<char>(frame[index] ^ (1 << random.bounded(8)));
+        break;
+    }
+    case Corruption::Truncated:
+        frame.chop(1 + random.bounded(frame.size() - 1));
+        break;
+    case Corruption::Garbage: {
+        QByteArray garbage(1 + random.bounded(MAX_GARBAGE_BYTES), Qt::Uninitialized);
+        for (char& byte : garbage) {
+            byte = static_cast<char>(random.bounded(256));
+        }
+        frame.prepend(garbage);
+        break;
+    }
+    }
+}
+
+void SimulatorStreamLink::onMessageReady(ProtocolCommand command, const QByteArray& data)
+{
+    if (!isConnected()) {
+        return;
+    }
+
+    QByteArray frame = encodeFrame(command, data);
+    if (frame.isEmpty()) {
+        return;
+    }
+    const double corruptRate = m_device->config().corruptRate;
+    if (corruptRate > 0.0 && m_device->random().generateDouble() < corruptRate) {
+        corrupt(frame);
+        ++m_statistics.corruptedFrames;
+    }
+
+    const qint64 written = writeBytes(frame);
+    if (written <= 0) {
+        return;
+    }
+    ++m_statistics.framesSent;
+    m_statistics.bytesSent += written;
+    if (command == ProtocolCommand::Response || command == ProtocolCommand::Error) {
+        ++m_statistics.responsesSent;
+    }
+}
+
+void SimulatorStreamLink::receiveBytes(const char* data, int length)
+{
+    m_statistics.bytesReceived += length;
+    m_receiveBuffer.append(data, length);
+    parseReceived();
+}
+
+void SimulatorStreamLink::parseReceived()
+{
+    int position = 0;
+    const int size = m_receiveBuffer.size();
+    const char* buffer = m_receiveBuffer.constData();
+
+    while (size - position >= FRAME_PREFIX_SIZE) {
+        if (static_cast<quint8>(buffer[position]) != ((Protocol::FRAME_HEADER >> 8) & 0xFF) ||
+            static_cast<quint8>(buffer[position + 1]) != (Protocol::FRAME_HEADER & 0xFF)) {
+            ++position;
+            continue;
+        }
+
+        const int dataLength = static_cast<quint8>(buffer[position + 3]);
+        const int frameSize = FrameWriter::requiredSize(dataLength, m_checksumType);
+        if (size - position < frameSize) {
+            break;
+        }
+
+        const char* frame = buffer + position;
+        IncrementalChecksum checksum(m_checksumType);
+        checksum.update(reinterpret_cast<const uint8_t*>(frame + 2), static_cast<size_t>(2 + dataLength));
+        uint8_t expected[32];
+        checksum.finalizeTo(expected);
+
+        const bool valid = static_cast<quint8>(frame[frameSize - 1]) == Protocol::FRAME_TAIL &&
+                           memcmp(expected, frame + FRAME_PREFIX_SIZE + dataLength, m_checksumLength) == 0;
+        if (!valid) {
+            // 可能是数据中恰好出现的帧头，跳过一个字节重新同步
+            ++m_statistics.invalidFramesReceived;
+            ++position;
+            continue;
+        }
+
+        ++m_statistics.commandsReceived;
+        const ProtocolCommand command = static_cast<ProtocolCommand>(static_cast<quint8>(frame[2]));
+        const QByteArray payload(frame + FRAME_PREFIX_SIZE, dataLength);
+        position += frameSize;
+        m_device->handleCommand(command, payload);
+    }
+
+    // 剩下的是不完整的帧或不足帧头长度的字节
+    m_receiveBuffer.remove(0, position);
+}
+
+// ---------------------------------------------------------------------------
+// PtyLink
+
+#ifdef Q_OS_UNIX
+PtyLink::PtyLink(SimulatedDevice* device, ChecksumType checksumType, const QString& linkPath, QObject* parent)
+    : SimulatorStreamLink(device, checksumType, parent)
+    , m_masterFd(-1)
+    , m_slaveFd(-1)
+    , m_linkPath(linkPath)
+    , m_notifier(nullptr)
+{
+}
+
+PtyLink::~PtyLink()
+{
+    delete m_notifier;
+    if (m_masterFd >= 0) ::close(m_masterFd);
+    if (m_slaveFd >= 0) ::close(m_slaveFd);
+    if (!m_linkPath.isEmpty()) {
+        QFile::remove(m_linkPath);
+    }
+}
+
+bool PtyLink::open(QString* error)
+{
+    m_masterFd = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_masterFd < 0 || ::grantpt(m_masterFd) != 0 || ::unlockpt(m_masterFd) != 0) {
+        if (error) *error = QString("创建伪终端失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    m_slavePath = QString::fromLocal8Bit(::ptsname(m_masterFd));
+
+    // 原始模式，不做回显和换行转换
+    m_slaveFd = ::open(m_slavePath.toLocal8Bit().constData(), O_RDWR | O_NOCTTY);
+    if (m_slaveFd >= 0) {
+        termios settings;
+        if (::tcgetattr(m_slaveFd, &settings) == 0) {
+            ::cfmakeraw(&settings);
+            ::tcsetattr(m_slaveFd, TCSANOW, &settings);
+        }
+    }
+
+    if (!m_linkPath.isEmpty()) {
+        QFile::remove(m_linkPath);
+        if (!QFile::link(m_slavePath, m_linkPath)) {
+            if (error) *error = QString("无法创建符号链接 %1 -> %2").arg(m_linkPath, m_slavePath);
+            return false;
+        }
+    }
+
+    m_notifier = new QSocketNotifier(m_masterFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &PtyLink::onReadable);
+    return true;
+}
+
+QString PtyLink::description() const
+{
+    return m_linkPath.isEmpty() ? m_slavePath : QString("%1 -> %2").arg(m_linkPath, m_slavePath);
+}
+
+qint64 PtyLink::writeBytes(const QByteArray& data)
+{
+    // 上位机没有及时读取时伪终端缓冲区会写满，多余的数据丢弃（相当于串口溢出）
+    const ssize_t written = ::write(m_masterFd, data.constData(), static_cast<size_t>(data.size()));
+    return written < 0 ? -1 : written;
+}
+
+void PtyLink::onReadable()
+{
+    char buffer[4096];
+    for (;;) {
+        const ssize_t length = ::read(m_masterFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        receiveBytes(buffer, static_cast<int>(length));
+    }
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// SerialPortLink
+
+SerialPortLink::SerialPortLink(SimulatedDevice* device, ChecksumType checksumType, const QString& portName,
+                               int baudRate, QObject* parent)
+    : SimulatorStreamLink(device, checksumType, parent)
+    , m_port(new QSerialPort(portName, this))
+    , m_baudRate(baudRate)
+{
+    connect(m_port, &QSerialPort::readyRead, this, &SerialPortLink::onReadyRead);
+}
+
+bool SerialPortLink::open(QString* error)
+{
+    m_port->setBaudRate(m_baudRate);
+    if (!m_port->open(QIODevice::ReadWrite)) {
+        if (error) *error = QString("无法打开串口 %1: %2").arg(m_port->portName(), m_port->errorString());
+        return false;
+    }
+    return true;
+}
+
+QString SerialPortLink::description() const
+{
+    return QString("%1 @ %2").arg(m_port->portName()).arg(m_baudRate);
+}
+
+bool SerialPortLink::isConnected() const
+{
+    return m_port->isOpen();
+}
+
+qint64 SerialPortLink::writeBytes(const QByteArray& data)
+{
+    return m_port->write(data);
+}
+
+void SerialPortLink::onReadyRead()
+{
+    const QByteArray data = m_port->readAll();
+    receiveBytes(data.constData(), data.size());
+}
+
+// ---------------------------------------------------------------------------
+// TcpServerLink
+
+TcpServerLink::TcpServerLink(SimulatedDevice* device, ChecksumType checksumType, const QString& address,
+                             quint16 port, QObject* parent)
+    : SimulatorStreamLink(device, checksumType, parent)
+    , m_server(new QTcpServer(this))
+    , m_address(address)
+    , m_port(port)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &TcpServerLink::onNewConnection);
+}
+
+bool TcpServerLink::open(QString* error)
+{
+    const QHostAddress address = m_address.isEmpty() ? QHostAddress(QHostAddress::Any) : QHostAddress(m_address);
+    if (!m_server->listen(address, m_port)) {
+        if (error) *error = QString("无法监听 TCP 端口 %1: %2").arg(m_port).arg(m_server->errorString());
+        return false;
+    }
+    return true;
+}
+
+QString TcpServerLink::description() const
+{
+    return QString("tcp://%1:%2").arg(m_address.isEmpty() ? QString("0.0.0.0") : m_address).arg(m_port);
+}
+
+bool TcpServerLink::isConnected() const
+{
+    return m_client && m_client->state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 TcpServerLink::writeBytes(const QByteArray& data)
+{
+    return m_client->write(data);
+}
+
+void TcpServerLink::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        if (m_client) {
+            m_client->disconnectFromHost();
+            m_client->deleteLater();
+        }
+        m_client = socket;
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::readyRead, this, &TcpServerLink::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void TcpServerLink::onReadyRead()
+{
+    if (!m_client) {
+        return;
+    }
+    const QByteArray data = m_client->readAll();
+    receiveBytes(data.constData(), data.size());
+}
+
+// ---------------------------------------------------------------------------
+// CanBusLink
+
+CanBusLink::CanBusLink(const QString& plugin, const QString& interfaceName, double corruptRate, QObject* parent)
+    : QObject(parent)
+    , m_plugin(plugin)
+    , m_interface(interfaceName)
+    , m_corruptRate(corruptRate)
+    , m_bus(nullptr)
+{
+}
+
+CanBusLink::~CanBusLink()
+{
+    if (m_bus) {
+        m_bus->disconnectDevice();
+    }
+}
+
+void CanBusLink::addDevice(SimulatedDevice* device)
+{
+    m_devices.insert(device->deviceId(), device);
+    connect(device, &SimulatedDevice::messageReady, this, &CanBusLink::onDeviceMessage);
+}
+
+bool CanBusLink::open(QString* error)
+{
+    QString errorString;
+    m_bus = QCanBus::instance()->createDevice(m_plugin, m_interface, &errorString);
+    if (!m_bus) {
+        if (error) *error = QString("无法创建 CAN 设备 %1/%2: %3").arg(m_plugin, m_interface, errorString);
+        return false;
+    }
+    m_bus->setParent(this);
+    connect(m_bus, &QCanBusDevice::framesReceived, this, &CanBusLink::onFramesReceived);
+    if (!m_bus->connectDevice()) {
+        if (error) *error = QString("无法连接 CAN 设备 %1/%2: %3").arg(m_plugin, m_interface, m_bus->errorString());
+        return false;
+    }
+    return true;
+}
+
+QString CanBusLink::description() const
+{
+    return QString("%1/%2").arg(m_plugin, m_interface);
+}
+
+bool CanBusLink::isConnected() const
+{
+    return m_bus && m_bus->state() == QCanBusDevice::ConnectedState;
+}
+
+void CanBusLink::send(quint32 canId, QByteArray data, QRandomGenerator& random)
+{
+    if (!isConnected()) {
+        return;
+    }
+    // 总线 CRC 会拦下传输错误，这里模拟的是设备发出了错误的数据
+    if (m_corruptRate > 0.0 && data.size() > 1 && random.generateDouble() < m_corruptRate) {
+        const int index = 1 + random.bounded(data.size() - 1);
+        data[index] = static_cast<char>(data[index] ^ (1 << random.bounded(8)));
+        ++m_statistics.corruptedFrames;
+    }
+    if (!m_bus->writeFrame(QCanBusFrame(canId, data))) {
+        return;
+    }
+    ++m_statistics.framesSent;
+    m_statistics.bytesSent += data.size();
+}
+
+void CanBusLink::onDeviceMessage(ProtocolCommand command, const QByteArray& data)
+{
+    auto* device = qobject_cast<SimulatedDevice*>(sender());
+    if (!device) {
+        return;
+    }
+    const quint32 id = static_cast<quint32>(device->deviceId());
+    QByteArray frame(8, '\0');
+    char* out = frame.data();
+
+    switch (command) {
+    case ProtocolCommand::ReadSensorData:
+        out[0] = static_cast<char>(ProtocolCommand::ReadSensorData);
+        out[1] = data.size() > 28 ? data[28] : '\0';
+        qToBigEndian(toFixed(littleEndianFloatAt(data, 0), 10.0), out + 2);
+        qToBigEndian(toFixed(littleEndianFloatAt(data, 1), 10.0), out + 4);
+        qToBigEndian(toFixed(littleEndianFloatAt(data, 2), 10.0), out + 6);
+        send(CAN_STATUS + id, frame, device->random());
+        break;
+    case ProtocolCommand::MoveToPosition:
+        out[0] = static_cast<char>(ProtocolCommand::GetPosition);
+        qToBigEndian(toFixed(floatAt(data, 0), 10.0), out + 1);
+        qToBigEndian(toFixed(floatAt(data, 1), 10.0), out + 3);
+        qToBigEndian(toFixed(floatAt(data, 2), 10.0), out + 5);
+        out[7] = static_cast<char>(qBound(0, static_cast<int>(std::round(floatAt(data, 3))), 255));
+        send(CAN_MOTION + id, frame, device->random());
+        break;
+    case ProtocolCommand::SetGlueParameters:
+        out[0] = static_cast<char>(ProtocolCommand::GetGlueParameters);
+        qToBigEndian(toUnsignedFixed(floatAt(data, 0), 100.0), out + 1);
+        qToBigEndian(toUnsignedFixed(floatAt(data, 1), 1000.0), out + 3);
+        qToBigEndian(toFixed(floatAt(data, 2), 10.0), out + 5);
+        send(CAN_GLUE + id, frame, device->random());
+        break;
+    case ProtocolCommand::Heartbeat: {
+        out[0] = static_cast<char>(ProtocolCommand::Heartbeat);
+        out[1] = static_cast<char>(device->state());
+        out[2] = static_cast<char>(m_heartbeatCounters[device->deviceId()]++);
+        frame.truncate(3);
+        send(CAN_HEARTBEAT + id, frame, device->random());
+        break;
+    }
+    case ProtocolCommand::Response:
+        out[0] = static_cast<char>(ProtocolCommand::Response);
+        memcpy(out + 1, data.constData(), std::min<size_t>(data.size(), 7));
+        frame.truncate(1 + std::min<int>(data.size(), 7));
+        send(CAN_STATUS + id, frame, device->random());
+        break;
+    case ProtocolCommand::Error:
+        out[0] = static_cast<char>(ProtocolCommand::Error);
+        out[1] = data.isEmpty() ? '\0' : data[0];
+        frame.truncate(2);
+        send(CAN_ALARM + id, frame, device->random());
+        break;
+    default:
+        break;
+    }
+    if (command == ProtocolCommand::Response || command == ProtocolCommand::Error) {
+        ++m_statistics.responsesSent;
+    }
+}
+
+void CanBusLink::onFramesReceived()
+{
+    const QList<QCanBusFrame> frames = m_bus->readAllFrames();
+    for (const QCanBusFrame& frame : frames) {
+        if (frame.frameType() != QCanBusFrame::DataFrame) {
+            continue;
+        }
+        const quint32 canId = frame.frameId();
+        const QByteArray payload = frame.payload();
+        m_statistics.bytesReceived += payload.size();
+
+        const bool emergency = (canId & 0xFF80) == CAN_EMERGENCY;
+        SimulatedDevice* device = m_devices.value(static_cast<int>(canId & (emergency ? 0x7F : 0xFF)));
+        // 其他设备（包括其他模拟设备）发出的报文
+        if (!device || (canId & 0xFF00) == CAN_STATUS || (canId & 0xFF00) == CAN_ALARM) {
+            continue;
+        }
+        ++m_statistics.commandsReceived;
+
+        if (emergency) {
+            device->handleCommand(ProtocolCommand::EmergencyStop, QByteArray());
+        } else if ((canId & 0xFF00) == CAN_HEARTBEAT) {
+            // 只应答上位机的心跳（CanWorker::sendHeartbeat 的标识 0x01），设备心跳以命令字 0x34 开头
+            if (!payload.isEmpty() && static_cast<quint8>(payload[0]) == Protocol::HEARTBEAT_TYPE_PING) {
+                emit device->messageReady(ProtocolCommand::Heartbeat,
+                                          QByteArray(1, static_cast<char>(Protocol::HEARTBEAT_TYPE_PING)));
+            }
+        } else if (!payload.isEmpty()) {
+            device->handleCommand(static_cast<ProtocolCommand>(static_cast<quint8>(payload[0])), payload.mid(1));
+        } else {
+            ++m_statistics.invalidFramesReceived;
+        }
+    }
+}
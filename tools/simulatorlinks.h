@@ -0,0 +1,183 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QPointer>
+#include <QString>
+#include "simulateddevice.h"
+#include "utils/checksum.h"
+
+class QCanBusDevice;
+class QSerialPort;
+class QSocketNotifier;
+class QTcpServer;
+class QTcpSocket;
+
+// 字节流链路（伪终端、串口、TCP）：把设备消息组成协议帧发出，按配置的概率注入错误，
+// 并从收到的字节流中解析上位机的帧交给设备应答。一个链路对应一台设备
+class SimulatorStreamLink : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 注入的错误类型
+    enum class Corruption {
+        ChecksumError,      // 翻转数据区或校验中的一位
+        Truncated,          // 丢掉帧尾部若干字节
+        Garbage             // 帧前插入随机字节
+    };
+
+    SimulatorStreamLink(SimulatedDevice* device, ChecksumType checksumType, QObject* parent = nullptr);
+
+    virtual bool open(QString* error) = 0;
+    virtual QString description() const = 0;
+    virtual bool isConnected() const = 0;
+
+    SimulatedDevice* device() const { return m_device; }
+    const SimulatorStatistics& statistics() const { return m_statistics; }
+
+protected:
+    // 子类实现实际写入，返回写入的字节数，失败返回 -1
+    virtual qint64 writeBytes(const QByteArray& data) = 0;
+    // 子类读到的数据
+    void receiveBytes(const char* data, int length);
+
+private slots:
+    void onMessageReady(ProtocolCommand command, const QByteArray& data);
+
+private:
+    QByteArray encodeFrame(ProtocolCommand command, const QByteArray& data) const;
+    void corrupt(QByteArray& frame);
+    void parseReceived();
+
+private:
+    SimulatedDevice* m_device;
+    ChecksumType m_checksumType;
+    int m_checksumLength;
+    QByteArray m_receiveBuffer;
+    SimulatorStatistics m_statistics;
+};
+
+#ifdef Q_OS_UNIX
+// 伪终端 - 上位机打开从端设备（/dev/pts/N，或 linkPath 指定的符号链接）当作串口使用
+class PtyLink : public SimulatorStreamLink
+{
+    Q_OBJECT
+
+public:
+    PtyLink(SimulatedDevice* device, ChecksumType checksumType, const QString& linkPath = QString(),
+            QObject* parent = nullptr);
+    ~PtyLink() override;
+
+    bool open(QString* error) override;
+    QString description() const override;
+    // 伪终端无法得知从端是否被打开，始终视为已连接
+    bool isConnected() const override { return m_masterFd >= 0; }
+
+protected:
+    qint64 writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onReadable();
+
+private:
+    int m_masterFd;
+    int m_slaveFd;              // 保持从端打开，上位机关闭串口时主端不会读到 EIO
+    QString m_slavePath;
+    QString m_linkPath;
+    QSocketNotifier* m_notifier;
+};
+#endif
+
+// 已有的串口（例如 com0com / tty0tty 虚拟串口对的一端，或接到上位机的实体串口）
+class SerialPortLink : public SimulatorStreamLink
+{
+    Q_OBJECT
+
+public:
+    SerialPortLink(SimulatedDevice* device, ChecksumType checksumType, const QString& portName, int baudRate,
+                   QObject* parent = nullptr);
+
+    bool open(QString* error) override;
+    QString description() const override;
+    bool isConnected() const override;
+
+protected:
+    qint64 writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onReadyRead();
+
+private:
+    QSerialPort* m_port;
+    int m_baudRate;
+};
+
+// TCP 服务端 - 上位机以 TCP 客户端方式连接，同一时刻只服务一个连接，新连接替换旧连接
+class TcpServerLink : public SimulatorStreamLink
+{
+    Q_OBJECT
+
+public:
+    TcpServerLink(SimulatedDevice* device, ChecksumType checksumType, const QString& address, quint16 port,
+                  QObject* parent = nullptr);
+
+    bool open(QString* error) override;
+    QString description() const override;
+    bool isConnected() const override;
+
+protected:
+    qint64 writeBytes(const QByteArray& data) override;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    QTcpServer* m_server;
+    QPointer<QTcpSocket> m_client;
+    QString m_address;
+    quint16 m_port;
+};
+
+// CAN 总线（例如 socketcan 的 vcan0）- 所有设备共用一条总线，按 CanWorker 的报文约定收发：
+// CAN ID = 报文类型基址 + 设备ID，data[0] 为命令字。经典 CAN 每帧只有 8 字节，设备数据按定点数压缩：
+//   0x100+ID 运动   [0x18] X(2) Y(2) Z(2) 速度(1)          坐标单位 0.1mm，速度 mm/s
+//   0x200+ID 点胶   [0x1C] 胶量(2) 压力(2) 温度(2) 保留(1)  单位 0.01ml、kPa、0.1℃
+//   0x300+ID 状态   [0x20] 状态(1) X(2) Y(2) Z(2)，或应答 [0x80] 原命令(1) 数据(≤6)
+//   0x600+ID 报警   [0xFF] 错误码(1)
+//   0x700+ID 心跳   [0x34] 状态(1) 计数(1)
+// 多字节字段均为大端。上位机的紧急停止（0x080+ID）和心跳（0x700+ID）直接处理，
+// 其他报文按 data[0] 作为协议命令码交给设备
+class CanBusLink : public QObject
+{
+    Q_OBJECT
+
+public:
+    CanBusLink(const QString& plugin, const QString& interfaceName, double corruptRate, QObject* parent = nullptr);
+    ~CanBusLink() override;
+
+    void addDevice(SimulatedDevice* device);
+    bool open(QString* error);
+    QString description() const;
+    bool isConnected() const;
+
+    const SimulatorStatistics& statistics() const { return m_statistics; }
+
+private slots:
+    void onFramesReceived();
+    void onDeviceMessage(ProtocolCommand command, const QByteArray& data);
+
+private:
+    void send(quint32 canId, QByteArray data, QRandomGenerator& random);
+
+private:
+    QString m_plugin;
+    QString m_interface;
+    double m_corruptRate;
+    QCanBusDevice* m_bus;
+    QHash<int, SimulatedDevice*> m_devices;     // 设备ID → 设备
+    QHash<int, quint8> m_heartbeatCounters;
+    SimulatorStatistics m_statistics;
+};